@@ -49,6 +49,8 @@ target_link_libraries(onnxruntime PRIVATE
     ${onnxruntime_libs}
     ${PROVIDERS_CUDA}
     ${PROVIDERS_MKLDNN}
+    ${PROVIDERS_NUPHAR}
+    ${PROVIDERS_TRT}
     onnxruntime_providers    
     onnxruntime_util
     ${onnxruntime_tvm_libs}
@@ -2,7 +2,7 @@
 # Licensed under the MIT License.
 
 set(TEST_SRC_DIR ${ONNXRUNTIME_ROOT}/test)
-set(TEST_INC_DIR ${ONNXRUNTIME_ROOT} ${eigen_INCLUDE_DIRS} ${CUDA_INCLUDE_DIRS} ${onnxruntime_CUDNN_HOME}/include)
+set(TEST_INC_DIR ${ONNXRUNTIME_ROOT} ${eigen_INCLUDE_DIRS} ${CUDA_INCLUDE_DIRS} ${onnxruntime_CUDNN_HOME}/include ${TENSORRT_INCLUDE_DIR})
 if (onnxruntime_USE_TVM)
   list(APPEND TEST_INC_DIR ${TVM_INCLUDES})
 endif()
@@ -113,6 +113,10 @@ set(onnxruntime_test_providers_src_patterns
   "${TEST_SRC_DIR}/framework/TestAllocatorManager.h"
   )
 
+if(onnxruntime_USE_TRT)
+  list(APPEND onnxruntime_test_providers_src_patterns "${TEST_SRC_DIR}/providers/trt/*")
+endif()
+
 file(GLOB onnxruntime_test_providers_src ${onnxruntime_test_providers_src_patterns})
 file(GLOB_RECURSE onnxruntime_test_providers_cpu_src
   "${TEST_SRC_DIR}/providers/cpu/*"
@@ -161,6 +165,14 @@ if(onnxruntime_USE_MKLDNN)
   list(APPEND onnxruntime_test_providers_dependencies onnxruntime_providers_mkldnn)
 endif()
 
+if(onnxruntime_USE_NUPHAR)
+  list(APPEND onnxruntime_test_providers_dependencies onnxruntime_providers_nuphar)
+endif()
+
+if(onnxruntime_USE_TRT)
+  list(APPEND onnxruntime_test_providers_dependencies onnxruntime_providers_trt)
+endif()
+
 file(GLOB_RECURSE onnxruntime_test_tvm_src
   "${ONNXRUNTIME_ROOT}/test/tvm/*.h"
   "${ONNXRUNTIME_ROOT}/test/tvm/*.cc"
@@ -175,6 +187,8 @@ set(ONNXRUNTIME_TEST_LIBS
     ${onnxruntime_libs}
     ${PROVIDERS_CUDA}
     ${PROVIDERS_MKLDNN}
+    ${PROVIDERS_NUPHAR}
+    ${PROVIDERS_TRT}
     onnxruntime_providers
     onnxruntime_util
     ${onnxruntime_tvm_libs}
@@ -406,8 +420,16 @@ install(TARGETS onnx_test_runner
         RUNTIME  DESTINATION ${CMAKE_INSTALL_BINDIR})
 
 if(onnxruntime_BUILD_BENCHMARKS AND (HAS_FILESYSTEM_H OR HAS_EXPERIMENTAL_FILESYSTEM_H))
-  add_executable(onnxruntime_benchmark ${TEST_SRC_DIR}/onnx/microbenchmark/main.cc ${TEST_SRC_DIR}/onnx/microbenchmark/modeltest.cc)
-  target_include_directories(onnxruntime_benchmark PRIVATE ${ONNXRUNTIME_ROOT} ${onnxruntime_graph_header} benchmark)
+  add_executable(onnxruntime_benchmark
+    ${TEST_SRC_DIR}/onnx/microbenchmark/main.cc
+    ${TEST_SRC_DIR}/onnx/microbenchmark/modeltest.cc
+    ${TEST_SRC_DIR}/onnx/microbenchmark/mlas.cc
+    ${TEST_SRC_DIR}/onnx/microbenchmark/cpu_kernels.cc)
+  if (onnxruntime_USE_CUDA)
+    target_sources(onnxruntime_benchmark PRIVATE ${TEST_SRC_DIR}/onnx/microbenchmark/cuda_kernels.cc)
+  endif()
+  target_include_directories(onnxruntime_benchmark PRIVATE ${ONNXRUNTIME_ROOT} ${onnxruntime_graph_header} benchmark
+                             ${CUDA_INCLUDE_DIRS} ${onnxruntime_CUDNN_HOME}/include)
   target_compile_options(onnxruntime_benchmark PRIVATE "/wd4141")
   target_link_libraries(onnxruntime_benchmark PRIVATE onnx_test_runner_common benchmark ${onnx_test_libs})
   add_dependencies(onnxruntime_benchmark ${onnxruntime_EXTERNAL_DEPENDENCIES})
@@ -449,6 +471,38 @@ if(HAS_FILESYSTEM_H OR HAS_EXPERIMENTAL_FILESYSTEM_H)
   onnxruntime_add_include_to_target(onnxruntime_perf_test gsl)
   target_link_libraries(onnxruntime_perf_test PRIVATE ${GETOPT_LIB} ${onnx_test_libs})
   set_target_properties(onnxruntime_perf_test PROPERTIES FOLDER "ONNXRuntimeTest")
+
+  # runs the cases of a benchmark suite and, with a baseline, fails on their regressions. the models of the default
+  # suite are generated into the models directory when python, onnx and numpy are available.
+  set(onnxruntime_BENCHMARK_SUITE "${onnxruntime_perf_test_src_dir}/benchmark_suite.txt" CACHE FILEPATH
+      "The benchmark suite run by the onnxruntime_benchmark_suite target")
+  set(onnxruntime_BENCHMARK_MODELS_DIR "${CMAKE_CURRENT_BINARY_DIR}/benchmark_models" CACHE PATH
+      "The directory of the models of the benchmark suite")
+  set(onnxruntime_BENCHMARK_BASELINE "" CACHE FILEPATH
+      "The results of a previous run of the benchmark suite to compare with")
+  set(onnxruntime_BENCHMARK_TOLERANCE "0.1" CACHE STRING
+      "The relative change of a benchmark measurement that counts as a regression")
+
+  set(onnxruntime_benchmark_suite_commands)
+  find_package(PythonInterp 3.4)
+  if(PYTHONINTERP_FOUND)
+    list(APPEND onnxruntime_benchmark_suite_commands
+      COMMAND ${PYTHON_EXECUTABLE} ${onnxruntime_perf_test_src_dir}/gen_benchmark_models.py
+              --output_dir ${onnxruntime_BENCHMARK_MODELS_DIR})
+  endif()
+  set(onnxruntime_benchmark_suite_args -S ${onnxruntime_BENCHMARK_SUITE})
+  if(onnxruntime_BENCHMARK_BASELINE)
+    list(APPEND onnxruntime_benchmark_suite_args
+      -b ${onnxruntime_BENCHMARK_BASELINE} -T ${onnxruntime_BENCHMARK_TOLERANCE})
+  endif()
+  add_custom_target(onnxruntime_benchmark_suite
+    ${onnxruntime_benchmark_suite_commands}
+    COMMAND onnxruntime_perf_test ${onnxruntime_benchmark_suite_args}
+            ${onnxruntime_BENCHMARK_MODELS_DIR} ${CMAKE_CURRENT_BINARY_DIR}/benchmark_results.json
+    DEPENDS onnxruntime_perf_test
+    WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+    VERBATIM)
+  set_target_properties(onnxruntime_benchmark_suite PROPERTIES FOLDER "ONNXRuntimeTest")
 endif()
 
 # shared lib
@@ -198,6 +198,42 @@ namespace Microsoft.ML.OnnxRuntime
             
         }
 
+        /// <summary>
+        /// Runs the loaded model for the given inputs, and writes the outputs specified in <paramref name="outputNames"/>
+        /// into the buffers of <paramref name="outputValues"/>, whose shapes must be those of the outputs.
+        /// Neither the inputs nor the outputs are copied, and nothing is allocated for the results.
+        /// </summary>
+        /// <param name="inputNames"></param>
+        /// <param name="inputValues"></param>
+        /// <param name="outputNames"></param>
+        /// <param name="outputValues"></param>
+        public void Run(IReadOnlyCollection<string> inputNames, IReadOnlyCollection<OrtValue> inputValues, IReadOnlyCollection<string> outputNames, IReadOnlyCollection<OrtValue> outputValues)
+        {
+            if (inputNames.Count != inputValues.Count)
+            {
+                throw new ArgumentException("The number of input names " + inputNames.Count + " does not match the number of input values " + inputValues.Count);
+            }
+            if (outputNames.Count != outputValues.Count)
+            {
+                throw new ArgumentException("The number of output names " + outputNames.Count + " does not match the number of output values " + outputValues.Count);
+            }
+
+            IntPtr[] inputValueArray = inputValues.Select(value => value.Handle).ToArray();
+            IntPtr[] outputValueArray = outputValues.Select(value => value.Handle).ToArray();
+
+            // the native Run writes into the given output values rather than creating new ones
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtRun(
+                                                this._nativeHandle,
+                                                IntPtr.Zero,
+                                                inputNames.ToArray(),
+                                                inputValueArray,
+                                                (ulong)(inputValueArray.Length),
+                                                outputNames.ToArray(),
+                                                (ulong)(outputValueArray.Length),
+                                                outputValueArray
+                                                ));
+        }
+
         //TODO: kept internal until implemented
         internal ModelMetadata ModelMetadata
         {
@@ -314,6 +314,60 @@ namespace Microsoft.ML.OnnxRuntime
 
     internal static class TensorElementTypeConverter
     {
+        public static void GetNativeTypeAndWidth(Type type, out TensorElementType elemType, out int width)
+        {
+            if (type == typeof(float))
+            {
+                elemType = TensorElementType.Float;
+                width = sizeof(float);
+            }
+            else if (type == typeof(double))
+            {
+                elemType = TensorElementType.Double;
+                width = sizeof(double);
+            }
+            else if (type == typeof(short))
+            {
+                elemType = TensorElementType.Int16;
+                width = sizeof(short);
+            }
+            else if (type == typeof(ushort))
+            {
+                elemType = TensorElementType.UInt16;
+                width = sizeof(ushort);
+            }
+            else if (type == typeof(int))
+            {
+                elemType = TensorElementType.Int32;
+                width = sizeof(int);
+            }
+            else if (type == typeof(uint))
+            {
+                elemType = TensorElementType.UInt32;
+                width = sizeof(uint);
+            }
+            else if (type == typeof(long))
+            {
+                elemType = TensorElementType.Int64;
+                width = sizeof(long);
+            }
+            else if (type == typeof(ulong))
+            {
+                elemType = TensorElementType.UInt64;
+                width = sizeof(ulong);
+            }
+            else if (type == typeof(byte))
+            {
+                elemType = TensorElementType.UInt8;
+                width = sizeof(byte);
+            }
+            else
+            {
+                elemType = TensorElementType.DataTypeMax;
+                width = 0;
+            }
+        }
+
         public static void GetTypeAndWidth(TensorElementType elemType, out Type type, out int width)
         {
             switch (elemType)
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+using System;
+using System.Buffers;
+
+
+namespace Microsoft.ML.OnnxRuntime
+{
+    /// <summary>
+    /// A native tensor over a pinned managed buffer. Unlike a NamedOnnxValue, which is converted into a native tensor
+    /// on every Run, an OrtValue is created once and can be passed to many Runs, as an input or as an output that
+    /// the Run writes its result into. The buffer stays pinned until the OrtValue is disposed.
+    /// </summary>
+    public class OrtValue : IDisposable
+    {
+        protected IntPtr _nativeHandle;
+        protected MemoryHandle _pinnedMemoryHandle;
+        private bool _disposed = false;
+
+        protected OrtValue(IntPtr nativeHandle, MemoryHandle pinnedMemoryHandle)
+        {
+            _nativeHandle = nativeHandle;
+            _pinnedMemoryHandle = pinnedMemoryHandle;
+        }
+
+        /// <summary>
+        /// Creates a tensor of the shape <paramref name="shape"/> over <paramref name="memory"/>, without copying it.
+        /// The number of elements of the shape must be the length of the memory.
+        /// </summary>
+        /// <typeparam name="T"></typeparam>
+        /// <param name="memory"></param>
+        /// <param name="shape"></param>
+        /// <returns></returns>
+        public static OrtValue CreateTensorValueFromMemory<T>(Memory<T> memory, long[] shape)
+        {
+            TensorElementType nativeElementType;
+            int width;
+            TensorElementTypeConverter.GetNativeTypeAndWidth(typeof(T), out nativeElementType, out width);
+            if (nativeElementType == TensorElementType.DataTypeMax)
+            {
+                throw new NotSupportedException("The tensor element type " + typeof(T) + " is not supported");
+            }
+
+            long size = 1;
+            ulong[] nativeShape = new ulong[shape.Length];
+            for (int i = 0; i < shape.Length; i++)
+            {
+                size *= shape[i];
+                nativeShape[i] = (ulong)shape[i];
+            }
+
+            if (size != memory.Length)
+            {
+                throw new ArgumentException("The shape has " + size + " elements but the memory has " + memory.Length);
+            }
+
+            MemoryHandle pinnedMemoryHandle = memory.Pin();
+            IntPtr nativeHandle = IntPtr.Zero;
+            try
+            {
+                IntPtr dataBufferPointer;
+                unsafe
+                {
+                    dataBufferPointer = (IntPtr)pinnedMemoryHandle.Pointer;
+                }
+
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtCreateTensorWithDataAsOrtValue(
+                    NativeMemoryAllocatorInfo.DefaultInstance.Handle,
+                    dataBufferPointer,
+                    (ulong)(memory.Length * width),
+                    nativeShape,
+                    (ulong)nativeShape.Length,
+                    nativeElementType,
+                    out nativeHandle
+                ));
+            }
+            catch (OnnxRuntimeException e)
+            {
+                pinnedMemoryHandle.Dispose();
+                throw e;
+            }
+
+            return new OrtValue(nativeHandle, pinnedMemoryHandle);
+        }
+
+        internal IntPtr Handle
+        {
+            get
+            {
+                if (_disposed)
+                {
+                    throw new ObjectDisposedException(nameof(OrtValue));
+                }
+                return _nativeHandle;
+            }
+        }
+
+        #region destructors disposers
+
+        ~OrtValue()
+        {
+            Dispose(false);
+        }
+
+        public void Dispose()
+        {
+            GC.SuppressFinalize(this);
+            Dispose(true);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            if (_disposed)
+            {
+                return;
+            }
+
+            // the native tensor refers to the buffer, so it is released before the buffer is unpinned
+            if (_nativeHandle != IntPtr.Zero)
+            {
+                NativeMethods.OrtReleaseValue(_nativeHandle);
+                _nativeHandle = IntPtr.Zero;
+            }
+            _pinnedMemoryHandle.Dispose();
+            _disposed = true;
+        }
+
+        #endregion
+    }
+}
@@ -98,6 +98,38 @@ namespace Microsoft.ML.OnnxRuntime.Tests
             }
         }
 
+        [Fact]
+        private void CanRunInferenceWithOrtValues()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+
+            using (var session = new InferenceSession(modelPath))
+            {
+                float[] inputData = LoadTensorFromFile(@"bench.in");
+                float[] outputData = new float[1000];
+                float[] expectedOutput = LoadTensorFromFile(@"bench.expected_out");
+
+                using (var input = OrtValue.CreateTensorValueFromMemory(new Memory<float>(inputData), new long[] { 1, 3, 224, 224 }))
+                using (var output = OrtValue.CreateTensorValueFromMemory(new Memory<float>(outputData), new long[] { 1, 1000, 1, 1 }))
+                {
+                    // the values are reused across runs and the results are written into outputData
+                    for (int i = 0; i < 2; i++)
+                    {
+                        Array.Clear(outputData, 0, outputData.Length);
+                        session.Run(new[] { "data_0" }, new[] { input }, new[] { "softmaxout_1" }, new[] { output });
+                        Assert.Equal(expectedOutput, outputData, new floatComparer());
+                    }
+                }
+            }
+        }
+
+        [Fact]
+        private void ThrowWrongOrtValueShape()
+        {
+            float[] data = new float[10];
+            Assert.Throws<ArgumentException>(() => OrtValue.CreateTensorValueFromMemory(new Memory<float>(data), new long[] { 2, 3 }));
+        }
+
         [Fact]
         private void ThrowWrongInputName()
         {
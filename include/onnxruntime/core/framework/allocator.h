@@ -8,11 +8,13 @@
 #include <string>
 #include <cstring>
 #include <type_traits>
+#include <unordered_map>
 
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/common/status.h"
 #include "core/framework/fence.h"
+#include "core/platform/ort_mutex.h"
 #include "core/session/onnxruntime_c_api.h"
 
 struct OrtAllocatorInfo {
@@ -187,6 +189,33 @@ class CPUAllocator : public IDeviceAllocator {
   const OrtAllocatorInfo& Info() const override;
 };
 
+// A CPUAllocator whose memory is placed on a NUMA node, so that it's local to the threads running on the node.
+class NumaCPUAllocator : public CPUAllocator {
+ public:
+  explicit NumaCPUAllocator(int numa_node) : numa_node_(numa_node) {}
+  void* Alloc(size_t size) override;
+
+ private:
+  const int numa_node_;
+};
+
+// A CPUAllocator that allocates the blocks of at least a huge page, such as the regions of an arena, on huge pages,
+// explicit ones if the OS has them reserved and transparent ones otherwise, so that the tensors in them take fewer TLB
+// entries. It falls back to the CPUAllocator if the OS has no huge pages to give. The memory is placed on numa_node
+// unless it's -1.
+class HugePageCPUAllocator : public CPUAllocator {
+ public:
+  explicit HugePageCPUAllocator(int numa_node = -1) : numa_node_(numa_node) {}
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+ private:
+  const int numa_node_;
+  OrtMutex mutex_;
+  // the blocks on huge pages, and their sizes
+  std::unordered_map<void*, size_t> huge_page_blocks_;
+};
+
 using AllocatorPtr = std::shared_ptr<IAllocator>;
 
 }  // namespace onnxruntime
@@ -6,6 +6,9 @@
 /**
    this header should include all the headers that are required to build a custom op so that
    custom op developers don't have to worry about which headers to include, etc.
+   A kernel should run its work with OpKernelContext::ParallelFor, on the intra-op threads of the session, and take
+   its temporaries from OpKernelContext::GetScratchBuffer or GetTempSpaceAllocator, which allocate from the arena of
+   the session, rather than start threads or call malloc on each Compute.
 */
 #include "core/framework/op_kernel.h"
 
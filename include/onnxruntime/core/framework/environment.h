@@ -9,6 +9,10 @@
 #include "core/common/status.h"
 
 namespace onnxruntime {
+class IArenaAllocator;
+class TaskThreadPool;
+struct ArenaConfig;
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -30,6 +34,64 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Set the number of threads in the process-wide intra-op thread pool.
+     The pool is created on first use so this must be called before then, i.e. before the first InferenceSession
+     that uses it is created.
+     @param num_threads Number of threads in the pool. 0 uses std::thread::hardware_concurrency().
+  */
+  static Status SetIntraOpThreadPoolSize(int num_threads);
+
+  /**
+     Set how long an idle worker of the process-wide intra-op thread pool, and of the thread pools created for the
+     sessions after the call, spins before it blocks, trading CPU time for the latency of waking it for the next task.
+     @param spin_us The spin duration in microseconds. 0, the default, blocks right away.
+  */
+  static Status SetIntraOpThreadPoolSpinDuration(int spin_us);
+  static int GetIntraOpThreadPoolSpinDuration();
+
+  /**
+     Keep the workers of the process-wide intra-op thread pool spinning rather than blocking for duration_us
+     microseconds from now, e.g. ahead of a burst of back-to-back Runs.
+  */
+  static Status KeepIntraOpThreadPoolHot(int duration_us);
+
+  /**
+     Get the process-wide intra-op thread pool, creating it if needed.
+     The pool is shared by MLAS (and hence the Conv/Gemm/MatMul kernels that use it) and by the ParallelExecutor
+     of every session that doesn't request its own pool, so that multiple sessions in one process don't
+     oversubscribe the cores.
+     @returns nullptr if no environment has been initialized.
+  */
+  static TaskThreadPool* GetIntraOpThreadPool();
+
+  /**
+     Make GetIntraOpThreadPool, and so MLAS, use pool on the calling thread in place of the process-wide pool, e.g.
+     for the runs of a session with an intra-op pool of its own. nullptr reverts to the process-wide pool.
+     @returns The pool the calling thread used before.
+  */
+  static TaskThreadPool* SetCurrentThreadIntraOpThreadPool(TaskThreadPool* pool);
+
+  /**
+     Create an intra-op thread pool with a thread for each CPU of a NUMA node, which are restricted to run on the
+     CPUs of the node and use the pool as their intra-op pool.
+     @returns nullptr if the CPUs of the node can't be determined.
+  */
+  static std::unique_ptr<TaskThreadPool> CreateNumaIntraOpThreadPool(int numa_node);
+
+  /**
+     Set the configuration of the process-wide CPU arena. The arena is created on first use so this must be called
+     before then, i.e. before the first InferenceSession that uses it is initialized.
+  */
+  static Status SetSharedCpuArenaConfig(const ArenaConfig& config);
+
+  /**
+     Get the process-wide CPU arena, creating it if needed. The sessions that enable
+     SessionOptions::use_shared_cpu_arena allocate from it in place of a CPU arena of their own, so that the memory
+     the idle ones have freed is used by the others.
+  */
+  static std::shared_ptr<IArenaAllocator> GetSharedCpuArena();
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
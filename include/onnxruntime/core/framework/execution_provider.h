@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "core/common/status.h"
 #include "core/framework/tensor.h"
@@ -16,6 +18,7 @@ class Node;
 namespace onnxruntime {
 
 struct ComputeCapability;
+class IFence;
 class KernelRegistry;
 class KernelRegistryManager;
 
@@ -36,6 +39,25 @@ struct NodeComputeInfo {
   DestroyFunctionStateFunc release_state_func;
 };
 
+/**
+   Times the work a provider queues on its device, which a kernel only launches. Used by the executor when
+   profiling to record how long the work of a node took on the device.
+*/
+class IDeviceTimer {
+ public:
+  virtual ~IDeviceTimer() = default;
+
+  /**
+     Marks the end of the timed work, which is the work queued since the timer was created.
+  */
+  virtual common::Status Stop() = 0;
+
+  /**
+     Waits until the device has done the timed work and returns how long it took.
+  */
+  virtual common::Status GetElapsedMicroSeconds(long long& elapsed) = 0;
+};
+
 class IExecutionProvider {
  public:
   virtual ~IExecutionProvider() = default;
@@ -95,6 +117,25 @@ class IExecutionProvider {
   virtual common::Status CopyTensor(const Tensor& src, Tensor& dst,
                                     int exec_queue_id) const;
 
+  /**
+     Copy each tensor in src to the tensor at the same index in dst on specified exec queue,
+     e.g. the tensors of a copy node with several inputs. A provider may batch the copies.
+     The default implementation copies them one by one with CopyTensor.
+  */
+  virtual common::Status CopyTensors(const std::vector<const Tensor*>& src, const std::vector<Tensor*>& dst,
+                                     int exec_queue_id) const;
+
+  /**
+     Copy a tensor in CPU memory to a tensor allocated by this execution provider
+     without waiting for the copy to complete. The provider signals completion
+     through dst_fence, which consumers of dst wait on before reading it, and
+     keeps whatever it needs to finish the copy alive until then. The caller may
+     reuse src as soon as this returns.
+     The default implementation performs a blocking CopyTensor.
+  */
+  virtual common::Status CopyTensorFromHostAsync(const Tensor& src, Tensor& dst,
+                                                 IFence& dst_fence) const;
+
   /**
      Returns an opaque handle whose exact type varies based on the provider
      and is interpreted accordingly by the corresponding kernel implementation.
@@ -133,8 +174,71 @@ class IExecutionProvider {
   */
   virtual common::Status OnRunEnd();
 
+  /**
+     Returns true if the provider can capture the device work submitted during a
+     Run into a graph and replay it in later Runs. The session only uses graph
+     capture when every node is assigned to this provider and all feeds and
+     fetches already live on its device, so a replay reads and writes the same
+     buffers as the captured Run.
+  */
+  virtual bool IsGraphCaptureEnabled() const;
+
+  /**
+     Called after OnRunStart for a Run whose device work should be captured
+     rather than executed. Any previously captured graph is released.
+  */
+  virtual common::Status BeginGraphCapture();
+
+  /**
+     Called before OnRunEnd once the captured Run has submitted all its work.
+     The provider ends the capture and launches the captured graph so that the
+     Run still produces its outputs.
+  */
+  virtual common::Status EndGraphCapture();
+
+  /**
+     Called between OnRunStart and OnRunEnd instead of executing the nodes when
+     the Run matches the captured one. Launches the captured graph.
+  */
+  virtual common::Status ReplayGraph();
+
+  /**
+     Releases the captured graph and the device buffers kept for its replays,
+     e.g. before the arenas are shrunk. A later Run is captured again.
+  */
+  virtual common::Status ReleaseGraph();
+
+  /**
+     Returns a timer of the work queued on the execution queue with queue_id from now on, or nullptr if the provider
+     doesn't queue work that runs after the kernel launching it returns. The timer is stopped once a node has
+     launched its work and read once the Run has launched all of it, so reading it doesn't wait for the device
+     at every node.
+  */
+  virtual std::unique_ptr<IDeviceTimer> CreateDeviceTimer(int queue_id) const;
+
+  /**
+     Returns the ids of the execution queues the nodes whose kernels run on queue 0 may be spread over, starting with
+     0, so that the independent branches of a graph run concurrently on the device. A parallel execution assigns the
+     branches to them, and the values used across them get fences.
+  */
+  virtual std::vector<int> GetComputeQueueIds() const;
+
+  /**
+     Called by the executor on the thread that runs a node assigned to another compute queue than the queue of its
+     kernel, with that queue before the kernel runs and with 0 once it has run, so that the kernel queues its work
+     on the queue of the node.
+  */
+  virtual void SetComputeQueue(int queue_id) const;
+
   void InsertAllocator(AllocatorPtr allocator);
 
+  /**
+     Replaces the allocator of the id and mem_type of allocator->Info(), e.g. with one an application shares with
+     other sessions and frameworks. Called before the session is initialized, so that nothing has been allocated
+     from the allocator replaced.
+  */
+  virtual void ReplaceAllocator(AllocatorPtr allocator);
+
   /**
   Given a list of fused_node, return create_state/compute/release_state func for each node.
   */
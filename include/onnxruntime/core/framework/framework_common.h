@@ -20,4 +20,12 @@ using InputDefList = std::vector<const onnxruntime::NodeArg*>;
 using OutputDefList = std::vector<const onnxruntime::NodeArg*>;
 
 using NameMLValMap = std::unordered_map<std::string, MLValue>;
+
+// Counters for a session's memory pattern cache.
+struct MemoryPatternCacheStats {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t evictions = 0;
+  size_t entries = 0;
+};
 }  // namespace onnxruntime
@@ -3,7 +3,12 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+#include <unordered_map>
+
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 class KernelRegistry {
@@ -16,6 +21,11 @@ class KernelRegistry {
 
   Status Register(KernelCreateInfo&& create_info);
 
+  // Register a kernel of op_name whose definition is only built by build_create_info once a node of the op is
+  // looked up, so that the kernels of the ops no model uses never are. Their errors, such as a conflict with another
+  // kernel, are found then too.
+  void Register(const char* op_name, BuildKernelCreateInfoFn build_create_info);
+
   // Mainly for provide debug info
   std::vector<std::string> GetAllRegisteredOpNames() const;
 
@@ -29,20 +39,38 @@ class KernelRegistry {
                       std::unique_ptr<OpKernel>& op_kernel) const;
 
   // Check if an execution provider can create kernel for a node and return
-  // the kernel if so
+  // the kernel if so. The result is cached by the domain, op type, since version,
+  // provider and argument types of the node, so that the kernel defs of the op are
+  // only verified for the first node of each signature.
   const KernelCreateInfo* TryFindKernel(const onnxruntime::Node& node,
                                         onnxruntime::ProviderType exec_provider) const;
 
  private:
   // Check if the node's input/outpuData/attributes are compatible with this
   // kernel_def, If so, the kernel defined by the kernel_def is used to
-  // execute this node. exec_provider is used to match kernel when node has no provider
+  // execute this node. exec_provider is used to match kernel when node has no provider.
+  // The reason of a mismatch is written to error_str unless it's null.
   static bool VerifyKernelDef(const onnxruntime::Node& node,
                               const KernelDef& kernel_def,
-                              std::string& error_str,
+                              std::string* error_str,
                               onnxruntime::ProviderType exec_provider = "");
 
-  // Kernel create function map from op name to kernel creation info.
-  KernelCreateMap kernel_creator_fn_map_;
+  const KernelCreateInfo* FindKernel(const onnxruntime::Node& node,
+                                     onnxruntime::ProviderType exec_provider,
+                                     std::vector<std::string>* error_strs) const;
+
+  // the callers hold kernel_creator_mutex_
+  Status RegisterBuilt(KernelCreateInfo&& create_info) const;
+  void BuildDeferredKernels(const std::string& op_name) const;
+
+  // Kernel create function map from op name to kernel creation info, which the deferred kernels of an op are added
+  // to when they are built.
+  mutable OrtMutex kernel_creator_mutex_;
+  mutable KernelCreateMap kernel_creator_fn_map_;
+  mutable std::multimap<std::string, BuildKernelCreateInfoFn> deferred_kernels_;
+
+  // the results of TryFindKernel by the signature of the node, including the nodes no kernel matches
+  mutable OrtMutex kernel_lookup_mutex_;
+  mutable std::unordered_map<std::string, const KernelCreateInfo*> kernel_lookup_cache_;
 };
 }  // namespace onnxruntime
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <utility>
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/framework/allocator.h"
@@ -28,10 +30,30 @@ class MLValue {
     type_ = type;
   }
 
+  void Init(std::shared_ptr<void> data, MLDataType type) {
+    data_ = std::move(data);
+    type_ = type;
+  }
+
+  // An MLValue of the object of `type` at `data`, which is part of the data of this one, e.g. an element of a
+  // sequence. It shares the ownership of this one's data instead of copying the object.
+  MLValue MakeView(void* data, MLDataType type) const {
+    MLValue view;
+    view.data_ = std::shared_ptr<void>(data_, data);
+    view.type_ = type;
+    view.fence_ = fence_;
+    return view;
+  }
+
   bool IsAllocated() const {
     return data_ && type_;
   }
 
+  // true if another MLValue refers to the same data, e.g. a fetch that is an initializer or a feed
+  bool IsShared() const {
+    return data_.use_count() > 1;
+  }
+
   template <typename T>
   const T& Get() const {
     ORT_ENFORCE(DataTypeImpl::GetType<T>() == type_, DataTypeImpl::GetType<T>(), " != ", type_);
@@ -23,6 +23,7 @@ namespace onnxruntime {
 class ExecutionFrame;
 class OpKernelContext;
 class OpKernelWrapper;
+class TaskThreadPool;
 
 class OpKernel {
  public:
@@ -65,7 +66,7 @@ class OpKernelContext {
                            const OpKernel* kernel,
                            const logging::Logger& logger);
 
-  virtual ~OpKernelContext() = default;
+  virtual ~OpKernelContext();
 
   /**
   Return the number of inputs for a variadic argument.
@@ -121,6 +122,31 @@ class OpKernelContext {
    */
   Status GetTempSpaceAllocator(AllocatorPtr* output) const;
 
+  /**
+  Return a buffer of at least 'bytes' bytes the kernel can use as scratch space until Compute returns, on the default
+  memory of device 0. Once the session has generated a memory pattern for the input shapes the buffer is a block of
+  that pattern, so a kernel that needs temporaries on every Run doesn't call the allocator.
+  A kernel has one scratch buffer per Compute. A later call for no more bytes returns the same buffer, so a kernel
+  needing several temporaries asks for their total size once.
+  */
+  void* GetScratchBuffer(size_t bytes);
+
+  /**
+  Run fn(begin, end) on consecutive ranges that cover [0, total), on the intra-op thread pool of the session and the
+  calling thread, and return once all of them have completed. Each range has at least min_per_range items, so
+  fewer ranges than threads are used for a small total, and none but [0, total) on the calling thread if the session
+  has no pool. This lets a kernel, e.g. a custom op loaded from a library, scale with the threads the session
+  already has rather than starting its own.
+  An exception thrown by fn is rethrown once all the ranges have completed. The ranges that haven't started when
+  the Run terminates are skipped, as the Run fails once the kernel returns.
+  */
+  void ParallelFor(int64_t total, int64_t min_per_range, const std::function<void(int64_t, int64_t)>& fn) const;
+
+  /**
+  The number of ranges ParallelFor splits a large total into, e.g. to allocate a scratch buffer for each.
+  */
+  int NumParallelRanges() const;
+
   /**
   Return the fence of current node's input.
   @param index The index of the input.
@@ -153,6 +179,10 @@ class OpKernelContext {
   const MLValue* GetImplicitInputMLValue(int index) const;
   MLValue* GetOutputMLValue(int index);
 
+  // Release the scratch buffer before the context is destroyed. trace_free is false for a release that isn't at a
+  // fixed point of the execution, which a memory pattern generated from the trace couldn't rely on.
+  void ReleaseScratchBuffer(bool trace_free);
+
  private:
   Status GetOrCreateOutputMLValue(int index, MLValue*& value);
 
@@ -168,6 +198,14 @@ class OpKernelContext {
   int node_input_start_index_{-1};
   int node_implicit_input_start_index_{-1};
   int node_output_start_index_{-1};
+
+  // the intra-op thread pool of the session on the thread running the kernel, which the context carries so that
+  // a kernel in a library with its own copy of the framework uses the pool of the session
+  TaskThreadPool* thread_pool_{nullptr};
+
+  BufferUniquePtr scratch_buffer_;
+  size_t scratch_bytes_{0};
+  bool has_scratch_buffer_{false};
 };
 
 // Fetching output tensor without shape is not allowed except when it already exists
@@ -197,6 +235,9 @@ struct KernelCreateInfo {
 
 using KernelCreateMap = std::multimap<std::string, KernelCreateInfo>;
 
+// builds the KernelCreateInfo of a kernel, such as a BuildKernelCreateInfo specialization
+using BuildKernelCreateInfoFn = KernelCreateInfo (*)();
+
 // Forward declarations for the non-specialized BuildKernelCreateInfo method.
 template <typename T>
 KernelCreateInfo BuildKernelCreateInfo();
@@ -7,6 +7,7 @@
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/op_node_proto_helper.h"
+#include "core/framework/weight_compression.h"
 #include "core/graph/graph_viewer.h"
 #include "gsl/span"
 #include "gsl/gsl_util"
@@ -41,6 +42,17 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
 
   bool TryGetConstantInput(int input_index, const Tensor** constant_input_value) const;
 
+  // true if the session freezes its input shapes and the shape of the input is inferred to be fixed, which every
+  // Run then feeds the kernel with. a kernel can prepare for the shape at construction.
+  bool TryGetStaticInputShape(int input_index, TensorShape& shape) const;
+
+  // true if the session enables autotuning, so a kernel that has several implementations for the static shapes of
+  // its inputs may time them at construction and keep the fastest, which it records in KernelTuningCache
+  bool IsKernelAutotuningEnabled() const;
+
+  // how the session has a kernel store a constant matrix it multiplies by. see WeightCompression.
+  WeightCompression GetWeightCompression() const;
+
   common::Status GetFusedFuncs(ComputeFunc* compute, CreateFunctionStateFunc* create, DestroyFunctionStateFunc* release) const;
 
  private:
@@ -6,8 +6,13 @@
 
 #include <string>
 #include <atomic>
+#include <functional>
 #include "core/session/onnxruntime_c_api.h"
 
+namespace onnxruntime {
+class MLValue;
+}
+
 /**
  * Configuration information for a single Run.
  */
@@ -18,6 +23,36 @@ struct OrtRunOptions {
   /// set to 'true' to terminate any currently executing Run() calls that are using this
   /// OrtRunOptions instance. the individual calls will exit gracefully and return an error status.
   bool terminate = false;
+
+  /// terminate the Run as if terminate had been set once this many milliseconds have passed since it started, e.g.
+  /// when the request it computes has missed its deadline. 0 means no deadline.
+  int64_t timeout_ms = 0;
+
+  /// maximum number of intra-op threads this Run() may use, both for parallelizing individual kernels (MLAS) and
+  /// for nodes run concurrently by the parallel executor. 0 means no limit beyond the size of the thread pool.
+  int intra_op_thread_limit = 0;
+
+  /// the priority of the work of this Run() on the thread pools it shares with other Runs and sessions: > 0 for
+  /// latency-critical requests, which the pools serve first and which the Runs of a lower priority let go first
+  /// between their nodes, 0 for normal requests and < 0 for background work that only runs when nothing else is
+  /// waiting.
+  int priority = 0;
+
+  /// profile one in every profiling_sampling_interval Runs of the session, counting all of its Runs. the nodes of
+  /// a profiled Run are timed and its profile is written to a file of its own, whether or not the session profiles
+  /// its Runs. 1 profiles this Run. 0 doesn't profile it.
+  unsigned profiling_sampling_interval = 0;
+  /// prefix of the file the profile of a Run is written to, which is followed by the run_tag if there is one and the
+  /// number of the Run in the session. It can include a directory path.
+  std::string profile_file_prefix = "onnxruntime_run_profile";
+
+  /// called once for each output of a Run with its index in the output names and its value as soon as the value is
+  /// final, so a caller can start on the outputs that are ready while the others are computed. the outputs of CPU
+  /// nodes are reported as their nodes finish, possibly on threads of the intra-op thread pool and for several
+  /// outputs at the same time, the others once the Run has completed. a Run that fails may have reported some of
+  /// its outputs. the value is only valid during the call and must not be changed.
+  std::function<void(size_t output_index, const onnxruntime::MLValue& value)> output_ready_callback;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 
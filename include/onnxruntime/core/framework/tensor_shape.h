@@ -5,6 +5,9 @@
 #include <iosfwd>
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <cstring>
 #include "onnxruntime_config.h"
@@ -14,27 +17,115 @@ class TensorShapeProto;
 }
 
 namespace onnxruntime {
+// A read-only view of contiguous dimensions, such as those of a TensorShape or a std::vector<int64_t>, which code
+// that only reads the dimensions can take instead of a std::vector to not copy them. It converts to a
+// std::vector<int64_t> where one is needed, which copies the dimensions.
+class TensorDims {
+ public:
+  using value_type = int64_t;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using const_pointer = const int64_t*;
+  using pointer = const_pointer;
+  using const_reference = const int64_t&;
+  using reference = const_reference;
+  using const_iterator = const int64_t*;
+  using iterator = const_iterator;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using reverse_iterator = const_reverse_iterator;
+
+  TensorDims() = default;
+  TensorDims(const int64_t* data, size_t size) noexcept : data_(data), size_(size) {}
+  TensorDims(const std::vector<int64_t>& dims) noexcept : data_(dims.data()), size_(dims.size()) {}
+
+  const int64_t* data() const noexcept { return data_; }
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  const int64_t& operator[](size_t idx) const { return data_[idx]; }
+
+  const int64_t& at(size_t idx) const {
+    if (idx >= size_) {
+      throw std::out_of_range("TensorDims index out of range");
+    }
+    return data_[idx];
+  }
+
+  const int64_t& front() const { return data_[0]; }
+  const int64_t& back() const { return data_[size_ - 1]; }
+
+  const_iterator begin() const noexcept { return data_; }
+  const_iterator end() const noexcept { return data_ + size_; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  std::vector<int64_t> ToVector() const { return std::vector<int64_t>(begin(), end()); }
+  operator std::vector<int64_t>() const { return ToVector(); }
+
+ private:
+  const int64_t* data_{nullptr};
+  size_t size_{0};
+};
+
+inline bool operator==(const TensorDims& lhs, const TensorDims& rhs) noexcept {
+  return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+inline bool operator!=(const TensorDims& lhs, const TensorDims& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
 #ifdef __GNUC__
 #pragma GCC diagnostic push
 #ifdef HAS_NULL_DEREFERENCE
 #pragma GCC diagnostic ignored "-Wnull-dereference"
 #endif
 #endif
-class TensorShape : private std::vector<int64_t> {
-  // TODO - Use a custom STL allocator to avoid heap allocations in the common case.
+class TensorShape {
   // We use negative numbers for unknown symbolic dimension. Each negative
   // number represents a unique symbolic dimension.
-  // Private inheritance is used to prevent ambiguity of element versus dimension size
+  // The dimensions are stored in the shape itself for up to kSmallBufferSize of them, so that the shapes of most
+  // tensors don't allocate, and on the heap for more.
  public:
+  static constexpr size_t kSmallBufferSize = 6;
+
   TensorShape() = default;
 
-  TensorShape(const TensorShape& /*other*/) = default;
-  TensorShape& operator=(const TensorShape& /*other*/) = default;
+  TensorShape(const TensorShape& other) : TensorShape(other.dims_.data(), other.dims_.size()) {}
 
-  TensorShape(TensorShape&& /*other*/) = default;
-  TensorShape& operator=(TensorShape&& /*other*/) = default;
+  TensorShape& operator=(const TensorShape& other) {
+    if (this != &other) {
+      Assign(other.dims_.data(), other.dims_.size());
+    }
+    return *this;
+  }
 
-  TensorShape(const int64_t* dimension_sizes, size_t dimension_count);
+  TensorShape(TensorShape&& other) noexcept {
+    *this = std::move(other);
+  }
+
+  TensorShape& operator=(TensorShape&& other) noexcept {
+    if (this == &other) {
+      return *this;
+    }
+    if (other.allocated_buffer_) {
+      allocated_buffer_ = std::move(other.allocated_buffer_);
+      dims_ = TensorDims(allocated_buffer_.get(), other.dims_.size());
+    } else {
+      allocated_buffer_.reset();
+      std::copy(other.dims_.begin(), other.dims_.end(), small_buffer_);
+      dims_ = TensorDims(small_buffer_, other.dims_.size());
+    }
+    // a moved from shape is empty, as a moved from std::vector is
+    other.dims_ = TensorDims(other.small_buffer_, 0);
+    return *this;
+  }
+
+  TensorShape(const int64_t* dimension_sizes, size_t dimension_count) {
+    Assign(dimension_sizes, dimension_count);
+  }
 
   TensorShape(const std::vector<int64_t>& dims);
 
@@ -42,21 +133,21 @@ class TensorShape : private std::vector<int64_t> {
 
   TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end);
 
+  TensorShape(const TensorDims& dims);
+
   /**
      Return the dimension specified by <idx>.
   */
   const int64_t& operator[](size_t idx) const {
-    return std::vector<int64_t>::operator[](static_cast<int>(idx));
+    return dims_[idx];
   }
 
   int64_t& operator[](size_t idx) {
-    return std::vector<int64_t>::operator[](static_cast<int>(idx));
+    return MutableData()[idx];
   }
 
   bool operator==(const TensorShape& other) const noexcept {
-    auto thisVector = static_cast<const std::vector<int64_t>*>(this);
-    auto otherVector = static_cast<const std::vector<int64_t>*>(&other);
-    return *thisVector == *otherVector;
+    return dims_ == other.dims_;
   }
 
   bool operator!=(const TensorShape& other) const noexcept {
@@ -64,20 +155,25 @@ class TensorShape : private std::vector<int64_t> {
   }
 
   size_t NumDimensions() const noexcept {
-    return size();
+    return dims_.size();
   }
 
   /**
      Copy dims into an array with given size
   */
   void CopyDims(int64_t* dims, size_t num_dims) const {
-    memcpy(dims, data(), sizeof(value_type) * std::min(num_dims, NumDimensions()));
+    memcpy(dims, dims_.data(), sizeof(int64_t) * std::min(num_dims, NumDimensions()));
   }
 
   /**
-     Return underlying vector representation.
+     Return a view of the dimensions, which is valid as long as the shape isn't changed or destroyed.
   */
-  const std::vector<int64_t>& GetDims() const { return *this; }
+  const TensorDims& GetDims() const { return dims_; }
+
+  /**
+     Return a copy of the dimensions.
+  */
+  std::vector<int64_t> GetDimsAsVector() const { return dims_.ToVector(); }
 
   /**
    * Return the total number of elements. Returns 1 for an empty (rank 0) TensorShape.
@@ -127,13 +223,39 @@ class TensorShape : private std::vector<int64_t> {
      empty shape or 1D shape (1) is regarded as scalar tensor
   */
   bool IsScalar() const {
-    return size() == 0 || (size() == 1 && at(0) == 1);
+    return dims_.size() == 0 || (dims_.size() == 1 && dims_[0] == 1);
+  }
+
+  /**
+     Return a TensorShape of the dimensions, which are copied.
+  */
+  static TensorShape ReinterpretBaseType(const std::vector<int64_t>& dimensions) {
+    return TensorShape(dimensions);
+  }
+
+ private:
+  int64_t* MutableData() {
+    return allocated_buffer_ ? allocated_buffer_.get() : small_buffer_;
   }
 
-  static const TensorShape& ReinterpretBaseType(const std::vector<int64_t>& dimensions) {
-    static_assert(sizeof(TensorShape) == sizeof(std::vector<int64_t>), "Size of TensorShape prevents safe casting from vector");
-    return *static_cast<const TensorShape*>(&dimensions);
+  // makes the shape dimension_count dimensions long and copies dimension_sizes into them
+  void Assign(const int64_t* dimension_sizes, size_t dimension_count) {
+    if (dimension_count <= kSmallBufferSize) {
+      allocated_buffer_.reset();
+    } else if (!allocated_buffer_ || dims_.size() != dimension_count) {
+      allocated_buffer_.reset(new int64_t[dimension_count]);
+    }
+    int64_t* data = MutableData();
+    if (dimension_count > 0) {
+      memmove(data, dimension_sizes, sizeof(int64_t) * dimension_count);
+    }
+    dims_ = TensorDims(data, dimension_count);
   }
+
+  int64_t small_buffer_[kSmallBufferSize]{};
+  std::unique_ptr<int64_t[]> allocated_buffer_;
+  // the dimensions in small_buffer_ or allocated_buffer_
+  TensorDims dims_{small_buffer_, 0};
 };
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace onnxruntime {
+
+// How the float kernels that multiply by a constant matrix, e.g. the B of MatMul and Gemm, store it:
+//   - kNone: as the float initializer, packed for MLAS.
+//   - kFloat16: as half-precision floats, which MLAS converts to float as it packs each panel of a GEMM.
+//   - kInt8: as 8-bit integers with a scale for each output channel, the largest magnitude of its column divided by
+//     127, which MLAS dequantizes as it packs each panel of a GEMM.
+// The outputs stay float. The products are approximated: the kernels read a half or a quarter of the bytes of the
+// float matrix, for the models whose GEMMs are bound by memory bandwidth, e.g. at small batch sizes.
+enum class WeightCompression {
+  kNone = 0,
+  kFloat16 = 1,
+  kInt8 = 2
+};
+
+}  // namespace onnxruntime
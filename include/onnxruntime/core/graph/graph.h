@@ -365,7 +365,7 @@ class Node {
             const std::string& description,
             const std::vector<NodeArg*>& input_args,
             const std::vector<NodeArg*>& output_args,
-            const NodeAttributes* attributes,
+            NodeAttributes&& attributes,
             const std::string& domain);
 
   // create a Graph instance for an attribute that contains a GraphProto
@@ -432,6 +432,10 @@ class Node {
 
   // Graph instances for subgraphs that are owned by this Node
   std::vector<std::unique_ptr<Graph>> subgraphs_;
+
+  // The input and output definitions, their types and shapes, and the initializers of the inputs, that the outputs
+  // were last inferred from. Resolve skips inferring the outputs again while they and the attributes are unchanged.
+  std::string inferred_types_signature_;
 };
 
 /**
@@ -479,6 +483,10 @@ class Graph {
   /** Gets all the initializer tensors in this Graph. */
   const InitializedTensorSet& GetAllInitializedTensors() const noexcept;
 
+  /** Frees the data of the initializer tensor with the provided name, e.g. once it has been copied into a Tensor.
+  The name, type and shape of the initializer are kept. Can be called concurrently for different tensors. */
+  void ReleaseInitializedTensorData(const std::string& tensor_name);
+
   /** Removes all initializer tensors from this Graph and releases the memory they were using. */
   void CleanAllInitializedTensors() noexcept;
 
@@ -778,6 +786,15 @@ class Graph {
   Node& AddNode(const ONNX_NAMESPACE::NodeProto& node_proto,
                 const ArgNameToTypeMap& name_to_type);
 
+  // Add a node that takes ownership of <attributes>, so that they are not copied again.
+  Node& AddNode(const std::string& name,
+                const std::string& op_type,
+                const std::string& description,
+                const std::vector<NodeArg*>& input_args,
+                const std::vector<NodeArg*>& output_args,
+                NodeAttributes&& attributes,
+                const std::string& domain);
+
   Version IrVersion() const noexcept {
     return ir_version_;
   }
@@ -859,6 +876,9 @@ class Graph {
 
   common::Status InferAndVerifyTypeMatch(Node& node, const ONNX_NAMESPACE::OpSchema& op);
 
+  // the signature of what the types and shapes of the outputs of node are inferred from
+  std::string InferredTypesSignature(const Node& node) const;
+
   // perform type and shape inferencing on the subgraph and Resolve to validate
   static common::Status InferAndVerifySubgraphTypes(const Node& node, Graph& subgraph,
                                                     const std::vector<const ONNX_NAMESPACE::TypeProto*>& input_types,
@@ -915,6 +935,11 @@ class Graph {
   InitializedTensorSet name_to_initial_tensor_;
   std::vector<int> removed_initializer_indexes_;
 
+  // the version of each initializer added since the graph was loaded, from a counter of the graph, so that the
+  // signatures of the nodes that read an initializer change when it is replaced by one of the same name
+  std::unordered_map<std::string, int64_t> initializer_versions_;
+  int64_t last_initializer_version_ = 0;
+
   Type graph_type_ = Type::Main;
 
   IOnnxRuntimeOpSchemaCollectionPtr schema_registry_;
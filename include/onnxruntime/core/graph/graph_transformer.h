@@ -104,14 +104,19 @@ class RuleBasedGraphTransformer : public GraphTransformer {
 /**
 @class TopDownRuleBasedTransformer
 
-This is a rule-based Graph transformer that applies rules by performing top-down passes of the Graph.
+This is a rule-based Graph transformer that applies rules by performing a top-down pass of the Graph.
+Only the rules registered for the op type of a node are tried on it. When a rule rewrites the graph, the node, its
+producers and consumers from before the rewrite, and any nodes the rule added are queued and tried again, so a
+single Apply reaches the point where no rule matches without further passes over the whole graph.
+Rules must keep the edges of the nodes they edit up to date (see the helpers in core/graph/graph_utils.h), as they
+are matched on before the graph is resolved again, and must only report a modification if they changed the graph.
 */
 class TopDownRuleBasedTransformer : public RuleBasedGraphTransformer {
  public:
   TopDownRuleBasedTransformer(const std::string& name, const std::string& desc)
       : RuleBasedGraphTransformer(name, desc) {}
 
-  // Performs a single top-down traversal of the graph and applies all registered rules.
+  // Performs a top-down traversal of the graph and applies all registered rules until none of them matches.
   common::Status Apply(Graph& graph, bool& modified) const override;
 };
 
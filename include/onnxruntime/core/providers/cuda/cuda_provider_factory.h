@@ -12,6 +12,42 @@ extern "C" {
  */
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessionOptions* options, int device_id);
 
+/**
+ * \param device_id cuda device id, starts from zero.
+ * \param compute_stream cudaStream_t that all kernels of the session run on, or null to let the
+ *        provider create its own non-blocking stream. The stream must belong to device_id and
+ *        must outlive the session; it is not destroyed by the session.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProviderWithStream_CUDA, _In_ OrtSessionOptions* options, int device_id, _In_opt_ void* compute_stream);
+
+/**
+ * Same as OrtSessionOptionsAppendExecutionProviderWithStream_CUDA, and additionally captures the
+ * kernels of a Run into a CUDA graph that later Runs replay. Graph replay is only used when all
+ * nodes run on CUDA and the Run binds its inputs and outputs to CUDA buffers through IOBinding;
+ * a Run that binds the same buffers and shapes twice in a row is captured, and later Runs with
+ * those buffers replay the graph. Requires CUDA 10.1 or later.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProviderWithGraphCapture_CUDA, _In_ OrtSessionOptions* options, int device_id, _In_opt_ void* compute_stream);
+
+/**
+ * \param device_id cuda device id, starts from zero.
+ * \param num_compute_streams number of streams kernels run on. With parallel execution
+ *        (SessionOptions.enable_sequential_execution off), the independent branches of the
+ *        graph are spread over them so that they overlap on the device, and the values passed
+ *        between the streams are synchronized with CUDA events. 1 for a single stream.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProviderWithComputeStreams_CUDA, _In_ OrtSessionOptions* options, int device_id, int num_compute_streams);
+
+/**
+ * For a session that many threads run at once.
+ * \param device_id cuda device id, starts from zero.
+ * \param context_pool_size number of contexts of cuBLAS and cuDNN handles created with the provider, which the
+ *        concurrent Runs check out without taking a lock, rather than each creating the handles of its own.
+ * \param max_concurrent_runs number of Runs that may execute on the device at once. Further Runs wait for one of them
+ *        to finish, in the order they started, rather than oversubscribe the device. 0 for no limit.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProviderWithContextPool_CUDA, _In_ OrtSessionOptions* options, int device_id, int context_pool_size, int max_concurrent_runs);
+
 #ifdef __cplusplus
 }
 #endif
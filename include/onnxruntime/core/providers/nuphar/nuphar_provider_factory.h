@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/onnxruntime_c_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \param device_id the CPU the compiled subgraphs run on, which is 0.
+ * \param settings comma separated "key:value" pairs, which may be empty:
+ *   nuphar_cache_path: an existing folder the compiled subgraphs are cached in over processes.
+ *   nuphar_target: the TVM target the subgraphs are compiled for, by default an LLVM target of the host ISA.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_Nuphar, _In_ OrtSessionOptions* options, int device_id,
+               _In_ const char* settings);
+
+#ifdef __cplusplus
+}
+#endif
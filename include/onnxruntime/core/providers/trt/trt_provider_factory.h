@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/onnxruntime_c_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The TensorRT provider runs the subgraphs TensorRT supports. Append the CUDA provider after it for the rest.
+ * \param device_id cuda device id, starts from zero.
+ * \param settings comma separated "key:value" pairs, which may be empty:
+ *   trt_engine_cache_path: an existing folder the engines are cached in over processes.
+ *   trt_fp16_enable: 1 to let TensorRT run layers in fp16 where the GPU is fast at it.
+ *   trt_int8_enable: 1 to let TensorRT run layers in int8, with the scales of trt_int8_calibration_table.
+ *   trt_int8_calibration_table: the calibration table TensorRT wrote for the model.
+ *   trt_max_workspace_size: the bytes of device memory a layer may use for scratch space, 1 GB by default.
+ *   trt_min_subgraph_size: the number of nodes of the smallest subgraph TensorRT runs, 1 by default.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_TRT, _In_ OrtSessionOptions* options, int device_id,
+               _In_ const char* settings);
+
+#ifdef __cplusplus
+}
+#endif
@@ -143,6 +143,9 @@ ORT_RUNTIME_CLASS(RunOptions);
 ORT_RUNTIME_CLASS(TypeInfo);
 ORT_RUNTIME_CLASS(TensorTypeAndShapeInfo);
 ORT_RUNTIME_CLASS(SessionOptions);
+ORT_RUNTIME_CLASS(IoBinding);
+ORT_RUNTIME_CLASS(SessionMetrics);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 // When passing in an allocator to any ORT function, be sure that the allocator object
 // is not destroyed until the last allocated object using it is freed.
@@ -172,6 +175,29 @@ ORT_API_STATUS(OrtInitializeWithCustomLogger, OrtLoggingFunction logging_functio
                _In_ const char* logid,
                _Out_ OrtEnv** out);
 
+/**
+ * Set the number of threads in the intra-op thread pool shared by every session created from this OrtEnv.
+ * MLAS based kernels and the parallel executor (unless OrtSetSessionThreadPoolSize is used) run on this pool.
+ * Must be called before the first session is created.
+ * \param num_threads 0 to use the number of hardware threads.
+ */
+ORT_API_STATUS(OrtSetIntraOpThreadPoolSize, _Inout_ OrtEnv* env, int num_threads);
+
+/**
+ * Set how long an idle thread of the intra-op thread pool spins before it blocks, so the tasks of sub-millisecond
+ * Runs don't each pay for waking a sleeping thread, at the cost of the CPU time the spinning uses. Applies to the
+ * pool of the OrtEnv and to the pools of the sessions created with OrtSetSessionNumaNode or OrtSetSessionThreadPoolSize
+ * after the call.
+ * \param spin_us the spin duration in microseconds. 0 (the default) blocks right away.
+ */
+ORT_API_STATUS(OrtSetIntraOpThreadPoolSpinDuration, _Inout_ OrtEnv* env, int spin_us);
+
+/**
+ * Keep the threads of the intra-op thread pool spinning rather than blocking for duration_us microseconds from now,
+ * e.g. ahead of a burst of back-to-back Runs.
+ */
+ORT_API_STATUS(OrtKeepIntraOpThreadPoolHot, _Inout_ OrtEnv* env, int duration_us);
+
 // TODO: document the path separator convention? '/' vs '\'
 // TODO: should specify the access characteristics of model_path. Is this read only during the
 // execution of OrtCreateSession, or does the OrtSession retain a handle to the file/directory
@@ -186,6 +212,94 @@ ORT_API_STATUS(OrtRun, _Inout_ OrtSession* sess,
                _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
                _In_ const char* const* output_names, size_t output_names_len, _Out_ OrtValue** output);
 
+/**
+ * Invoked when an OrtRunAsync call completes.
+ * \param outputs on success an array of num_outputs newly created values in the order of the requested output names.
+ *   The callback owns each value and must free it with OrtReleaseValue. The array itself is only valid during the call.
+ * \param status NULL on success, otherwise the error. The callback owns it and must free it with OrtReleaseStatus.
+ */
+typedef void(ORT_API_CALL* OrtRunAsyncCallbackFn)(_Inout_opt_ void* user_data, _In_opt_ OrtValue** outputs,
+                                                  size_t num_outputs, _In_opt_ OrtStatus* status);
+
+/**
+ * Schedule a run on the session's thread pool and return without waiting for it.
+ * callback is invoked on a pool thread once the run has completed. The callback must not release the session.
+ * run_options (if not NULL) and the data of the input values must remain valid until callback is invoked.
+ * Releasing the session waits for any runs that are still in progress.
+ * \return NULL if the run was scheduled. Errors from the run itself are passed to callback.
+ */
+ORT_API_STATUS(OrtRunAsync, _Inout_ OrtSession* sess,
+               _In_opt_ OrtRunOptions* run_options,
+               _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len,
+               _In_ OrtRunAsyncCallbackFn callback, _Inout_opt_ void* user_data);
+
+/**
+ * Validate and resolve a fixed set of input and output names of a session once, for runs with OrtRunPrepared that
+ * take the values in the order of the names without looking them up or validating them by name.
+ * \param out should be freed by OrtReleasePreparedRun after use, and before sess is released
+ */
+ORT_API_STATUS(OrtPrepareRun, _Inout_ OrtSession* sess,
+               _In_ const char* const* input_names, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len, _Out_ OrtPreparedRun** out);
+
+/**
+ * Run the session as OrtRun does, with the names prepared by OrtPrepareRun. run_options may be NULL.
+ * \param input in the order of the prepared input names. input_len must be their number.
+ * \param output in the order of the prepared output names. output_len must be their number.
+ */
+ORT_API_STATUS(OrtRunPrepared, _Inout_ OrtSession* sess, _In_opt_ OrtRunOptions* run_options,
+               _In_ const OrtPreparedRun* prepared_run, _In_ const OrtValue* const* input, size_t input_len,
+               _Inout_ OrtValue** output, size_t output_len);
+
+/**
+ * Bind the inputs and outputs of a session once and run it with them repeatedly, without allocating outputs or
+ * copying them to and from the device on every run.
+ * \param out should be freed by OrtReleaseIoBinding after use, and before sess is released
+ */
+ORT_API_STATUS(OrtCreateIoBinding, _Inout_ OrtSession* sess, _Out_ OrtIoBinding** out);
+
+/**
+ * Bind an input to a value. A value that isn't where the node consuming the input expects it is copied there once,
+ * when it is bound, rather than on every run. The copy may be asynchronous: call OrtSynchronizeBoundInputs before
+ * running. Binding an input again replaces the value.
+ */
+ORT_API_STATUS(OrtBindInput, _Inout_ OrtIoBinding* binding, _In_ const char* name, _In_ const OrtValue* value);
+
+/**
+ * Bind an output to a value allocated by the caller, which every run writes to.
+ * Binding an output again replaces the previous binding.
+ */
+ORT_API_STATUS(OrtBindOutput, _Inout_ OrtIoBinding* binding, _In_ const char* name, _In_ const OrtValue* value);
+
+/**
+ * Bind an output to a device. Every run allocates the output with the session's allocator for info and leaves it on
+ * the device instead of copying it to CPU memory, e.g. to feed it to another run on the device.
+ * \param info e.g. created with OrtCreateAllocatorInfo("Cuda", OrtArenaAllocator, 0, OrtMemTypeDefault).
+ *             ORT_INVALID_ARGUMENT is returned if the session doesn't have an allocator for it.
+ */
+ORT_API_STATUS(OrtBindOutputToDevice, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+               _In_ const OrtAllocatorInfo* info);
+
+// Wait for the asynchronous copies of the bound inputs to complete.
+ORT_API_STATUS(OrtSynchronizeBoundInputs, _Inout_ OrtIoBinding* binding);
+
+// Wait for the device to finish writing the bound outputs, before reading them outside of ORT.
+ORT_API_STATUS(OrtSynchronizeBoundOutputs, _Inout_ OrtIoBinding* binding);
+
+// Run the session with the bound inputs, writing the bound outputs. run_options may be NULL.
+ORT_API_STATUS(OrtRunWithBinding, _Inout_ OrtSession* sess, _In_opt_ OrtRunOptions* run_options,
+               _Inout_ OrtIoBinding* binding);
+
+/**
+ * Get the outputs of the last run with the binding, in the order they were first bound.
+ * \param output_len must be the number of bound outputs.
+ * \param output set to newly created values that share the buffers of the outputs. Each should be freed by
+ *               OrtReleaseValue after use. The next run writes to the values of outputs bound with OrtBindOutput, and
+ *               allocates new ones for outputs bound with OrtBindOutputToDevice.
+ */
+ORT_API_STATUS(OrtGetBoundOutputs, _In_ OrtIoBinding* binding, _Out_ OrtValue** output, size_t output_len);
+
 /**
  * \return A pointer of the newly created object. The pointer should be freed by OrtReleaseSessionOptions after use
  */
@@ -213,15 +327,142 @@ ORT_API(void, OrtDisableMemPattern, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtEnableCpuMemArena, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options);
 
+// Allocate the regions of the CPU memory arena on huge pages, explicit ones if the OS has them reserved and
+// transparent ones otherwise, so that the initializers and tensors in them take fewer TLB entries. The regions are
+// allocated on regular pages if the OS has no huge pages to give.
+ORT_API(void, OrtEnableCpuHugePages, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableCpuHugePages, _In_ OrtSessionOptions* options);
+
+// Allocate at the location of the Info() of allocator, e.g. a memory pool the application shares with other sessions
+// and frameworks, from allocator in place of the allocator of the execution provider there. An arena is put over
+// the allocator if the type of its Info() is OrtArenaAllocator, and it's used as it is if the type is
+// OrtDeviceAllocator. The allocator and its Info() must outlive the sessions created with the options.
+ORT_API(void, OrtAppendSessionAllocator, _In_ OrtSessionOptions* options, _In_ OrtAllocator* allocator);
+
+// Run the float MatMul, Gemm, Conv and ConvTranspose nodes assigned to the CUDA execution provider, and the
+// element-wise ops that follow them, in float16 so that they use tensor cores. Numerically sensitive ops such as
+// Softmax, reductions and normalizations stay in float. Casts are inserted at the boundaries of the float16 regions.
+// Has no effect when the CUDA execution provider is not appended to the options.
+ORT_API(void, OrtEnableFp16MixedPrecision, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableFp16MixedPrecision, _In_ OrtSessionOptions* options);
+
+// Replace chains of element-wise nodes (Add, Sub, Mul, Div and unary math and activation ops) assigned to the CUDA
+// execution provider with a single kernel, so that the intermediate tensors are not written to device memory.
+// Has no effect when the CUDA execution provider is not appended to the options.
+ORT_API(void, OrtEnableElementwiseFusion, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableElementwiseFusion, _In_ OrtSessionOptions* options);
+
+// Move the nodes assigned to the CUDA execution provider to CPU where a cost model of their kernels and of the copies
+// between CPU and device memory estimates that it saves time, e.g. the small shape computations of a graph.
+// profile_file may be a profile a session of the same model wrote with OrtEnableProfiling and sequential execution,
+// whose kernel times calibrate the cost model, or null for the default costs.
+// Has no effect when the CUDA execution provider is not appended to the options.
+ORT_API(void, OrtEnableCostBasedPlacement, _In_ OrtSessionOptions* options, _In_opt_ const char* profile_file);
+ORT_API(void, OrtDisableCostBasedPlacement, _In_ OrtSessionOptions* options);
+
+typedef enum OrtArenaExtendStrategy {
+  ORT_ARENA_EXTEND_NEXT_POWER_OF_TWO,  // double the size of each new region
+  ORT_ARENA_EXTEND_SAME_AS_REQUESTED,  // allocate a region that fits the allocation only
+  ORT_ARENA_EXTEND_FIXED_INCREMENT,    // allocate regions of extend_increment_bytes, or larger if needed
+} OrtArenaExtendStrategy;
+
+// Configure the CPU memory arena the session creates when no CPU execution provider is appended to the options.
+// \param max_mem upper limit on the memory the arena allocates. 0 for no limit.
+// \param initial_chunk_size_bytes size of the first region the arena allocates.
+// \param extend_increment_bytes region size for ORT_ARENA_EXTEND_FIXED_INCREMENT. ignored otherwise.
+ORT_API_STATUS(OrtSetSessionCpuArenaConfig, _In_ OrtSessionOptions* options, size_t max_mem,
+               OrtArenaExtendStrategy extend_strategy, size_t initial_chunk_size_bytes,
+               size_t extend_increment_bytes);
+
+// Configure the process-wide CPU memory arena that the sessions created with OrtEnableSharedCpuArena share. Must be
+// called before the first of them is created. The parameters are those of OrtSetSessionCpuArenaConfig.
+ORT_API_STATUS(OrtSetSharedCpuArenaConfig, _Inout_ OrtEnv* env, size_t max_mem,
+               OrtArenaExtendStrategy extend_strategy, size_t initial_chunk_size_bytes,
+               size_t extend_increment_bytes);
+
+// Allocate the CPU memory of the session from the process-wide CPU memory arena instead of an arena of its own, so
+// that the memory idle sessions have freed is used by the others, e.g. for many small models in one process.
+// \param session_max_mem upper limit on the memory the session has in use in the arena. 0 for no limit.
+ORT_API(void, OrtEnableSharedCpuArena, _In_ OrtSessionOptions* options, size_t session_max_mem);
+ORT_API(void, OrtDisableSharedCpuArena, _In_ OrtSessionOptions* options);
+
+// Leave the partitioning, the creation of the kernels and the loading of the initializers to the first Run of the
+// session instead of OrtCreateSession, e.g. for the rarely used models of a host of many.
+ORT_API(void, OrtEnableLazySessionInitialization, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableLazySessionInitialization, _In_ OrtSessionOptions* options);
+
+// Log the statistics of every memory arena used by the session at INFO level after this many Runs. 0 to disable.
+ORT_API_STATUS(OrtSetSessionAllocatorStatsLogInterval, _In_ OrtSessionOptions* options, int num_runs);
+
+// Count the calls, time and output bytes of the nodes of each op type for every Run of the session, to be read
+// with OrtGetSessionMetrics.
+ORT_API(void, OrtEnableMetrics, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableMetrics, _In_ OrtSessionOptions* options);
+
+// count the hardware events of the thread computing each node, with perf_event on Linux, in the profile and the metrics
+ORT_API(void, OrtEnableHardwareCounters, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableHardwareCounters, _In_ OrtSessionOptions* options);
+
+/**
+ * Return the outputs of a recent Run with the same inputs and outputs instead of running the model again, for
+ * models whose outputs only depend on their inputs. Only Runs whose inputs and outputs are all tensors in CPU
+ * memory are cached.
+ * \param max_entries the most Runs kept. 0 for no limit.
+ * \param max_bytes the most bytes of inputs and outputs kept.
+ * \param ttl_ms how long the outputs of a Run are returned for after it. 0 for as long as they are kept.
+ */
+ORT_API_STATUS(OrtEnableResultCache, _In_ OrtSessionOptions* options, size_t max_entries, size_t max_bytes,
+               int64_t ttl_ms);
+ORT_API(void, OrtDisableResultCache, _In_ OrtSessionOptions* options);
+
+/**
+ * Bind an input of the model to a fixed value when the session is created, so that the nodes that only depend on
+ * the fixed inputs and the initializers are computed once. Runs can't feed the input, which the session no longer
+ * counts among its inputs. The value must be a tensor in CPU memory, and is copied.
+ */
+ORT_API_STATUS(OrtAddConstantInput, _In_ OrtSessionOptions* options, _In_ const char* input_name,
+               _In_ const OrtValue* value);
+
 // < logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid);
 
 // < applies to session load, initialization, etc
 ORT_API(void, OrtSetSessionLogVerbosityLevel, _In_ OrtSessionOptions* options, uint32_t session_log_verbosity_level);
 
-// How many threads in the session thread pool.
+// How many threads in the session thread pool. By default the session uses the OrtEnv's intra-op thread pool.
 ORT_API(int, OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options, int session_thread_pool_size);
 
+// Run the session on a NUMA node: its intra-op work runs on threads pinned to the CPUs of the node and the arena of
+// the default CPU execution provider is allocated on the node. Returns -1 if numa_node is negative.
+ORT_API(int, OrtSetSessionNumaNode, _In_ OrtSessionOptions* options, int numa_node);
+
+// Graph transformations applied to the model before it is partitioned between the execution providers:
+// 0: none.
+// 1: basic. Removal of redundant nodes such as Identity, duplicates of other nodes and Transposes that cancel, and
+//    constant folding of the nodes of constant inputs.
+// 2 (default): extended. Also folds BatchNormalization, Mul and Add into Conv, and MatMul and Add into Gemm.
+// 3: all. Also fuses activations into Conv and Gemm and converts Conv and pooling to the NCHWc layout, which only
+//    run on the CPU execution provider, and fuses the layer normalization, GELU and attention of transformer models
+//    into ops the CPU and CUDA execution providers run.
+// Returns -1 if the level is not one of these.
+ORT_API(int, OrtSetSessionGraphOptimizationLevel, _In_ OrtSessionOptions* options, uint32_t graph_optimization_level);
+
+typedef enum OrtWeightCompression {
+  ORT_WEIGHT_COMPRESSION_NONE,     // the constant weights stay float
+  ORT_WEIGHT_COMPRESSION_FLOAT16,  // half-precision floats
+  ORT_WEIGHT_COMPRESSION_INT8,     // 8-bit integers with a scale for each output channel
+} OrtWeightCompression;
+
+// How the float MatMul and Gemm kernels of the CPU execution provider store a constant B. They convert it to float
+// as they multiply, which reads a half or a quarter of the bytes of the float B at the cost of approximating the
+// product, for models bound by memory bandwidth at small batch sizes. The outputs stay float.
+ORT_API_STATUS(OrtSetWeightCompression, _In_ OrtSessionOptions* options, OrtWeightCompression compression);
+
+// Write the model to this file once the session has transformed and partitioned it. A session created from the file
+// assigns the nodes to the same execution providers, which must be registered with it, and skips the graph
+// transformations. Session creation fails for models with subgraphs or with nodes compiled by a provider.
+ORT_API(void, OrtSetOptimizedModelFilePath, _In_ OrtSessionOptions* options, _In_ const char* optimized_model_filepath);
+
 /**
   * To use additional providers, you must build ORT with the extra providers enabled. Then call one of these
   * functions to enable them in the session:
@@ -238,6 +479,80 @@ ORT_API(void, OrtAppendCustomOpLibPath, _In_ OrtSessionOptions* options, const c
 ORT_API_STATUS(OrtSessionGetInputCount, _In_ const OrtSession* sess, _Out_ size_t* out);
 ORT_API_STATUS(OrtSessionGetOutputCount, _In_ const OrtSession* sess, _Out_ size_t* out);
 
+// Return the arena memory that isn't in use by the session to the device, e.g. after a burst of large requests.
+// Memory will be allocated again if later Runs need it.
+ORT_API_STATUS(OrtSessionShrinkMemoryArenas, _Inout_ OrtSession* sess);
+
+// Run the session once on a background thread with inputs of zeros, of the shapes the model declares with 1 for
+// their symbolic dimensions, so that the first request doesn't pay for the lazy initialization, the growth of the
+// arenas or the creation of device primitives. Returns once the Run is scheduled. Its failure is logged.
+ORT_API_STATUS(OrtSessionWarmup, _Inout_ OrtSession* sess);
+
+// Free the memory of an idle session while keeping its optimized graph and kernels: its initializers on devices are
+// copied to host memory and freed on the devices, and its memory arenas are shrunk. Must not be called while the
+// session runs. OrtSessionRestore, or the next Run, copies the initializers back.
+ORT_API_STATUS(OrtSessionEvict, _Inout_ OrtSession* sess);
+ORT_API_STATUS(OrtSessionRestore, _Inout_ OrtSession* sess);
+
+typedef struct OrtAllocatorStats {
+  int64_t num_allocs;             // number of allocations
+  int64_t bytes_in_use;           // bytes currently allocated
+  int64_t max_bytes_in_use;       // peak bytes_in_use
+  int64_t total_allocated_bytes;  // bytes the arena has allocated from the device
+  int64_t max_alloc_size;         // largest single allocation
+  int64_t bytes_limit;            // upper limit on total_allocated_bytes. 0 if unknown
+  int64_t free_bytes_in_bins;     // bytes allocated from the device that are free for reuse
+  int64_t largest_free_chunk;     // largest allocation that can be made without allocating from the device
+  int64_t num_extends;            // number of regions the arena has allocated from the device
+} OrtAllocatorStats;
+
+/**
+ * Get the statistics of a memory arena used by the session.
+ * \param info location of the arena, e.g. created with OrtCreateCpuAllocatorInfo(OrtArenaAllocator, OrtMemTypeDefault)
+ *             for the CPU arena. ORT_INVALID_ARGUMENT is returned if the session doesn't have an arena for it.
+ */
+ORT_API_STATUS(OrtGetAllocatorStats, _In_ const OrtSession* sess, _In_ const OrtAllocatorInfo* info,
+               _Out_ OrtAllocatorStats* out);
+
+typedef struct OrtResultCacheStats {
+  uint64_t num_hits;       // Runs that returned cached outputs
+  uint64_t num_misses;     // cacheable Runs that ran the model
+  uint64_t num_evictions;  // Runs evicted for the limits or their ttl
+  size_t num_entries;      // Runs cached
+  size_t num_bytes;        // bytes of the inputs and outputs cached
+} OrtResultCacheStats;
+
+/**
+ * Get the statistics of the result cache of a session created with OrtEnableResultCache.
+ * ORT_FAIL is returned if the result cache isn't enabled.
+ */
+ORT_API_STATUS(OrtGetResultCacheStats, _In_ const OrtSession* sess, _Out_ OrtResultCacheStats* out);
+
+typedef struct OrtOpMetrics {
+  const char* op_type;     // valid until the OrtSessionMetrics it was read from is released
+  uint64_t num_calls;      // number of nodes of the op type run
+  uint64_t total_time_us;  // time spent in the kernels, which for a device is the time to queue their work
+  uint64_t p50_time_us;    // median time of a call, within 25%
+  uint64_t p99_time_us;    // 99th percentile of the time of a call, within 25%
+  uint64_t output_bytes;   // bytes of the tensors the nodes output
+  // the hardware events of the threads computing the nodes, which are 0 unless OrtEnableHardwareCounters is set
+  uint64_t cycles;
+  uint64_t instructions;
+  uint64_t llc_misses;   // last level cache read misses
+  uint64_t dtlb_misses;  // data TLB read misses
+} OrtOpMetrics;
+
+/**
+ * Get a snapshot of the metrics of a session created with OrtEnableMetrics, which may be taken while it runs.
+ * ORT_FAIL is returned if the metrics aren't enabled.
+ * \param out should be freed by OrtReleaseSessionMetrics after use
+ */
+ORT_API_STATUS(OrtGetSessionMetrics, _In_ const OrtSession* sess, _Out_ OrtSessionMetrics** out);
+ORT_API_STATUS(OrtSessionMetricsGetOpCount, _In_ const OrtSessionMetrics* metrics, _Out_ size_t* out);
+ORT_API_STATUS(OrtSessionMetricsGetOp, _In_ const OrtSessionMetrics* metrics, size_t index, _Out_ OrtOpMetrics* out);
+// the number of regions the memory arenas of the session have allocated from the device
+ORT_API_STATUS(OrtSessionMetricsGetArenaExtendCount, _In_ const OrtSessionMetrics* metrics, _Out_ int64_t* out);
+
 /**
  * \param out  should be freed by OrtReleaseTypeInfo after use
  */
@@ -267,10 +582,48 @@ ORT_API_STATUS(OrtRunOptionsSetRunTag, _In_ OrtRunOptions*, _In_ const char* run
 ORT_API(unsigned int, OrtRunOptionsGetRunLogVerbosityLevel, _In_ OrtRunOptions*);
 ORT_API(const char*, OrtRunOptionsGetRunTag, _In_ OrtRunOptions*);
 
+// Limit the number of intra-op threads a Run using this instance may use, so that one large request can't take
+// the whole thread pool. This bounds both the threads used inside a kernel and the nodes run concurrently by the
+// parallel executor. 0 (the default) means no limit.
+ORT_API_STATUS(OrtRunOptionsSetIntraOpThreadLimit, _In_ OrtRunOptions*, int thread_limit);
+ORT_API(int, OrtRunOptionsGetIntraOpThreadLimit, _In_ OrtRunOptions*);
+
+// Set the priority of a Run using this instance on the thread pools it shares with other Runs: > 0 for
+// latency-critical requests, which are served first and which the Runs of a lower priority let go first between
+// their nodes, 0 (the default) for normal requests and < 0 for background work run when nothing else is waiting.
+ORT_API(void, OrtRunOptionsSetPriority, _In_ OrtRunOptions*, int priority);
+ORT_API(int, OrtRunOptionsGetPriority, _In_ OrtRunOptions*);
+
+/**
+ * Invoked once for each output of a Run as soon as its value is final.
+ * \param output_index the index of the output in the output names of the Run.
+ * \param value the output, which is only valid during the call and must not be changed or released.
+ */
+typedef void(ORT_API_CALL* OrtOutputReadyCallbackFn)(_Inout_opt_ void* user_data, size_t output_index,
+                                                     _In_ const OrtValue* value);
+
+// Set a callback that a Run using this instance invokes for each of its outputs as soon as the output is final, so
+// the work on the outputs that are ready can start while the others are computed. The outputs of nodes run on the
+// CPU are reported as their nodes finish, possibly on intra-op pool threads and for several outputs at the same time,
+// the others once the Run has completed. A Run that fails may have reported some of its outputs. NULL removes it.
+ORT_API(void, OrtRunOptionsSetOutputReadyCallback, _In_ OrtRunOptions*, _In_opt_ OrtOutputReadyCallbackFn callback,
+        _Inout_opt_ void* user_data);
+
+// Profile one in every sampling_interval Runs of a session using this instance, writing the profile of each such
+// Run to a file of its own named after profile_file_prefix, the run tag and the number of the Run in the session.
+// 1 profiles every Run. 0 disables it.
+ORT_API_STATUS(OrtRunOptionsEnableProfiling, _In_ OrtRunOptions*, _In_ const char* profile_file_prefix,
+               unsigned int sampling_interval);
+
 // Set a flag so that any running OrtRun* calls that are using this instance of OrtRunOptions
 // will exit as soon as possible if the flag is true.
 ORT_API(void, OrtRunOptionsSetTerminate, _In_ OrtRunOptions*, _In_ int flag);
 
+// Make any OrtRun* call using this instance exit as if the terminate flag had been set once timeout_ms milliseconds
+// have passed since it started, for a request that is useless after its deadline. 0 (the default) means no deadline.
+ORT_API_STATUS(OrtRunOptionsSetTimeout, _In_ OrtRunOptions*, int64_t timeout_ms);
+ORT_API(int64_t, OrtRunOptionsGetTimeout, _In_ OrtRunOptions*);
+
 /**
  * Create a tensor from an allocator. OrtReleaseValue will also release the buffer inside the output value
  * \param out Should be freed by calling OrtReleaseValue
@@ -304,6 +657,17 @@ ORT_API(int, OrtIsTensor, _In_ const OrtValue* value);
  * \param s_len length of s
  */
 ORT_API_STATUS(OrtFillStringTensor, _In_ OrtValue* value, _In_ const char* const* s, size_t s_len);
+/**
+ * Fills a string tensor from the layout OrtGetStringTensorContent produces, so the strings need no terminating
+ * '\0' and no array of pointers to them, and may contain '\0'.
+ * \param value A tensor created from OrtCreateTensor... function.
+ * \param s the contents of all strings back to back. Each string is NOT null-terminated.
+ * \param s_len total data length
+ * \param offsets the offset of each string in s. A string ends where the next one starts, the last one at s_len.
+ * \param offsets_len length of offsets, at least the number of elements of the tensor
+ */
+ORT_API_STATUS(OrtFillStringTensorFromContent, _In_ OrtValue* value, _In_ const void* s, size_t s_len,
+               _In_ const size_t* offsets, size_t offsets_len);
 /**
  * \param value A tensor created from OrtCreateTensor... function.
  * \param len total data length, not including the trailing '\0' chars.
@@ -369,6 +733,32 @@ ORT_API_STATUS(OrtGetTypeInfo, _In_ const OrtValue* value, OrtTypeInfo** out);
 
 ORT_API(enum ONNXType, OrtGetValueType, _In_ const OrtValue* value);
 
+/**
+ * The number of elements of a sequence, or of entries of a map
+ */
+ORT_API_STATUS(OrtGetValueCount, _In_ const OrtValue* value, _Out_ size_t* out);
+
+/**
+ * Get the element at index of a sequence of tensors or of maps. It's a view that shares the element with the
+ * sequence instead of copying it, and which stays valid after the sequence is released.
+ * \param out Should be freed by OrtReleaseValue after use
+ */
+ORT_API_STATUS(OrtGetValue, _In_ const OrtValue* value, size_t index, _Out_ OrtValue** out);
+
+/**
+ * Get the elements of a sequence of float, int64 or double without copying them.
+ * The pointer is only valid until the backing OrtValue is free'd.
+ */
+ORT_API_STATUS(OrtGetSequenceData, _In_ const OrtValue* value, _Out_ const void** out);
+
+/**
+ * Get the keys and the values of a map in the order of the keys, each an array of the key or value type of the map,
+ * where a string is a const char* to the string in the map, which is only valid until the OrtValue is free'd.
+ * \param keys, values Either may be NULL to skip it
+ * \param count length of keys and values, at least the number of entries, get it from OrtGetValueCount
+ */
+ORT_API_STATUS(OrtGetMapEntries, _In_ const OrtValue* value, _Out_ void* keys, _Out_ void* values, size_t count);
+
 typedef enum OrtAllocatorType {
   OrtDeviceAllocator = 0,
   OrtArenaAllocator = 1
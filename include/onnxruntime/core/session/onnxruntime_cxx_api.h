@@ -87,6 +87,14 @@ class SessionOptionsWrapper {
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableMemPattern)
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableCpuMemArena)
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableCpuMemArena)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableFp16MixedPrecision)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableFp16MixedPrecision)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableElementwiseFusion)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableElementwiseFusion)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableCostBasedPlacement)
+  void EnableCostBasedPlacement(_In_opt_ const char* profile_file = nullptr) {
+    OrtEnableCostBasedPlacement(value.get(), profile_file);
+  }
   void EnableProfiling(_In_ const char* profile_file_prefix) {
     OrtEnableProfiling(value.get(), profile_file_prefix);
   }
@@ -100,6 +108,12 @@ class SessionOptionsWrapper {
   void SetSessionThreadPoolSize(int session_thread_pool_size) {
     OrtSetSessionThreadPoolSize(value.get(), session_thread_pool_size);
   }
+  void SetSessionGraphOptimizationLevel(uint32_t graph_optimization_level) {
+    OrtSetSessionGraphOptimizationLevel(value.get(), graph_optimization_level);
+  }
+  void SetOptimizedModelFilePath(const char* optimized_model_filepath) {
+    OrtSetOptimizedModelFilePath(value.get(), optimized_model_filepath);
+  }
 
   SessionOptionsWrapper clone() const {
     OrtSessionOptions* p = OrtCloneSessionOptions(value.get());
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/attention.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// the number of scores each range of rows masked in parallel adds to at least
+constexpr int64_t kMinMaskElementsPerRange = 16 * 1024;
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    Attention,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Attention<float>);
+
+template <>
+Status Attention<float>::Compute(OpKernelContext* context) const {
+  const Tensor* Q = context->Input<Tensor>(0);
+  const Tensor* K_transposed = context->Input<Tensor>(1);
+  const Tensor* V = context->Input<Tensor>(2);
+  const Tensor* mask = context->Input<Tensor>(3);
+
+  if (Q->Shape().NumDimensions() < 2 || K_transposed->Shape().NumDimensions() < 2 ||
+      V->Shape().NumDimensions() < 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Attention inputs must have at least 2 dimensions");
+  }
+
+  MatMulComputeHelper scores_helper;
+  ORT_RETURN_IF_ERROR(scores_helper.Compute(Q->Shape(), K_transposed->Shape()));
+  const TensorShape& scores_shape = scores_helper.OutputShape();
+  MatMulComputeHelper output_helper;
+  ORT_RETURN_IF_ERROR(output_helper.Compute(scores_shape, V->Shape()));
+
+  std::vector<int64_t> mask_offsets;
+  int64_t mask_column_stride = 0;
+  if (mask != nullptr) {
+    ORT_RETURN_IF_ERROR(ComputeMaskOffsets(scores_shape, mask->Shape(), mask_offsets, mask_column_stride));
+  }
+
+  Tensor* Y = context->Output(0, output_helper.OutputShape());
+  float* y_data = Y->template MutableData<float>();
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+  if (scores_shape.Size() == 0) {
+    // the rows of the scores are empty, so are the sums of the output
+    std::memset(y_data, 0, static_cast<size_t>(Y->Shape().Size()) * sizeof(float));
+    return Status::OK();
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  BufferUniquePtr scores_buffer(alloc->Alloc(sizeof(float) * static_cast<size_t>(scores_shape.Size())),
+                                BufferDeleter(alloc));
+  float* scores = static_cast<float*>(scores_buffer.get());
+
+  MlasSgemmBatch(
+      CblasNoTrans,
+      CblasNoTrans,
+      static_cast<size_t>(scores_helper.M()),
+      static_cast<size_t>(scores_helper.N()),
+      static_cast<size_t>(scores_helper.K()),
+      scale_,
+      Q->template Data<float>(),
+      static_cast<size_t>(scores_helper.K()),
+      scores_helper.LeftOffsets().data(),
+      K_transposed->template Data<float>(),
+      static_cast<size_t>(scores_helper.N()),
+      scores_helper.RightOffsets().data(),
+      /* beta */ 0.0f,
+      scores,
+      static_cast<size_t>(scores_helper.N()),
+      scores_helper.OutputOffsets().data(),
+      scores_helper.OutputOffsets().size());
+
+  const int64_t row_size = scores_shape[scores_shape.NumDimensions() - 1];
+  const int64_t row_count = scores_shape.Size() / row_size;
+  if (mask != nullptr) {
+    const float* mask_data = mask->template Data<float>();
+    const int64_t min_rows = std::max<int64_t>(1, kMinMaskElementsPerRange / row_size);
+    context->ParallelFor(row_count, min_rows, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        float* row_scores = scores + row * row_size;
+        const float* row_mask = mask_data + mask_offsets[static_cast<size_t>(row)];
+        for (int64_t j = 0; j < row_size; ++j) {
+          row_scores[j] += row_mask[j * mask_column_stride];
+        }
+      }
+    });
+  }
+
+  MlasComputeSoftmax(scores, scores, static_cast<size_t>(row_count), static_cast<size_t>(row_size), false);
+
+  MlasSgemmBatch(
+      CblasNoTrans,
+      CblasNoTrans,
+      static_cast<size_t>(output_helper.M()),
+      static_cast<size_t>(output_helper.N()),
+      static_cast<size_t>(output_helper.K()),
+      /* alpha */ 1.0f,
+      scores,
+      static_cast<size_t>(output_helper.K()),
+      output_helper.LeftOffsets().data(),
+      V->template Data<float>(),
+      static_cast<size_t>(output_helper.N()),
+      output_helper.RightOffsets().data(),
+      /* beta */ 0.0f,
+      y_data,
+      static_cast<size_t>(output_helper.N()),
+      output_helper.OutputOffsets().data(),
+      output_helper.OutputOffsets().size());
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
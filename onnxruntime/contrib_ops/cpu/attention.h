@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// the attributes of Attention and the broadcasting of its mask, shared with the CUDA kernel
+class AttentionBase {
+ protected:
+  AttentionBase(const OpKernelInfo& info) {
+    scale_ = info.GetAttrOrDefault<float>("scale", 1.0f);
+  }
+
+  // the offset into the mask of each row of the scores, and the distance between the mask elements of a row, which
+  // is 0 when the mask broadcasts along the rows
+  static Status ComputeMaskOffsets(const TensorShape& scores_shape, const TensorShape& mask_shape,
+                                   std::vector<int64_t>& row_offsets, int64_t& column_stride) {
+    const size_t rank = scores_shape.NumDimensions();
+    const size_t mask_rank = mask_shape.NumDimensions();
+    if (mask_rank > rank) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Attention mask of rank ", mask_rank,
+                             " does not broadcast to the scores of rank ", rank);
+    }
+
+    // the strides of the mask along the dims of the scores, 0 where it broadcasts
+    std::vector<int64_t> strides(rank, 0);
+    int64_t stride = 1;
+    for (size_t i = 0; i < mask_rank; ++i) {
+      const size_t mask_axis = mask_rank - 1 - i;
+      const size_t axis = rank - 1 - i;
+      if (mask_shape[mask_axis] != 1) {
+        if (mask_shape[mask_axis] != scores_shape[axis]) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Attention mask ", mask_shape,
+                                 " does not broadcast to the scores ", scores_shape);
+        }
+        strides[axis] = stride;
+      }
+      stride *= mask_shape[mask_axis];
+    }
+    column_stride = strides[rank - 1];
+
+    const int64_t row_count = scores_shape.SizeToDimension(rank - 1);
+    row_offsets.resize(static_cast<size_t>(row_count));
+    std::vector<int64_t> index(rank - 1, 0);
+    int64_t offset = 0;
+    for (int64_t row = 0; row < row_count; ++row) {
+      row_offsets[static_cast<size_t>(row)] = offset;
+      // the next row index, like an odometer over the leading dims
+      for (size_t axis = rank - 1; axis > 0; --axis) {
+        if (++index[axis - 1] < scores_shape[axis - 1]) {
+          offset += strides[axis - 1];
+          break;
+        }
+        offset -= (index[axis - 1] - 1) * strides[axis - 1];
+        index[axis - 1] = 0;
+      }
+    }
+    return Status::OK();
+  }
+
+  float scale_;
+};
+
+template <typename T>
+class Attention final : public OpKernel, public AttentionBase {
+ public:
+  Attention(const OpKernelInfo& info) : OpKernel(info), AttentionBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -3,23 +3,26 @@
 
 #include "bahdanau_attention.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
+#include "core/mlas/inc/mlas.h"
 
 #include <stdexcept>
 #include <memory.h>
 
 using onnxruntime::rnn::detail::Allocate;
+using onnxruntime::rnn::detail::ExecuteLambdaInParallel;
 
 namespace onnxruntime {
 namespace contrib {
 
 template <typename T>
-BahdanauAttention<T>::BahdanauAttention(AllocatorPtr allocator, const logging::Logger& logger,
+BahdanauAttention<T>::BahdanauAttention(AllocatorPtr allocator, const OpKernelContext& context,
                                         int batch_size, int max_memory_step, int memory_depth,
                                         int query_depth, int attn_depth, bool normalize)
-    : allocator_(allocator), logger_(logger), batch_size_(batch_size), max_memory_steps_(max_memory_step), memory_depth_(memory_depth), query_depth_(query_depth), attn_depth_(attn_depth), normalize_(normalize) {
+    : allocator_(allocator), context_(context), logger_(context.Logger()), batch_size_(batch_size), max_memory_steps_(max_memory_step), memory_depth_(memory_depth), query_depth_(query_depth), attn_depth_(attn_depth), normalize_(normalize) {
   values_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * memory_depth_, values_ptr_, true);
   keys_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * attn_depth_, keys_ptr_, true);
   processed_query_ = Allocate(allocator_, batch_size_ * attn_depth_, processed_query_ptr_, true);
+  attn_hidden_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * attn_depth_, attn_hidden_ptr_, true);
   mem_seq_lengths_ = Allocate(allocator_, batch_size_, mem_seq_lengths_ptr_, true);
 
   ORT_ENFORCE(!normalize_, "not support normalize yet.");
@@ -79,30 +82,6 @@ void BahdanauAttention<T>::PrepareMemory(
                                keys_.data(), attn_depth_, &CPUMathUtil::Instance());
 }
 
-template <typename T>
-static void SoftmaxInplace(const gsl::span<T>& alignments) {
-  T* x = alignments.data();
-  size_t len = alignments.size();
-
-  double sum = 0.0;
-
-  for (size_t i = 0; i < len; i++) {
-    T e = exp(x[i]);
-    sum += e;
-    x[i] = e;
-  }
-
-  if (sum == 0.0) {
-    for (size_t i = 0; i < len; i++) {
-      x[i] = static_cast<T>(1.0 / len);
-    }
-  } else {
-    for (size_t i = 0; i < len; i++) {
-      x[i] = static_cast<T>(x[i] / sum);
-    }
-  }
-}
-
 /**
   * Args:
   *     queries: Tensor, shape `[batch_size_, query_depth_]` to compare to keys.
@@ -121,27 +100,37 @@ void BahdanauAttention<T>::Compute(
                                query_layer_weights_.data(), attn_depth_, T{0.0},
                                processed_query_.data(), attn_depth_, &CPUMathUtil::Instance());
 
-  std::fill(aligns.begin(), aligns.end(), T{});
+  // tanh(keys[step] + query) of the memory steps of every batch, split between the threads like the LSTM gates
+  ExecuteLambdaInParallel(
+      context_, "BahdanauAttention scores",
+      [&](int b) {
+        const T* keys = keys_.data() + b * max_memory_steps_ * attn_depth_;
+        const T* query = processed_query_.data() + b * attn_depth_;
+        T* hidden = attn_hidden_.data() + b * max_memory_steps_ * attn_depth_;
+
+        int mem_steps = mem_seq_lengths_[b];
+        for (int step = 0; step < mem_steps; step++) {
+          for (int i = 0; i < attn_depth_; i++) {
+            hidden[step * attn_depth_ + i] = keys[step * attn_depth_ + i] + query[i];
+          }
+        }
+        MlasComputeTanh(hidden, hidden, static_cast<size_t>(mem_steps) * attn_depth_);
+      },
+      batch_size_, 1, logger_);
 
   // return math_ops.reduce_sum(v * math_ops.tanh(keys + processed_query), [2])
+  // as one GEMM over the memory steps of the whole batch. the steps past the memory of a batch are masked below.
+  math::GemmEx<T, CPUMathUtil>(CblasNoTrans, CblasNoTrans,
+                               batch_size_ * max_memory_steps_, 1, attn_depth_, T{1.0},
+                               attn_hidden_.data(), attn_depth_,
+                               attention_v_.data(), 1, T{0.0},
+                               aligns.data(), 1, &CPUMathUtil::Instance());
+
   for (int b = 0; b < batch_size_; b++) {
     T* alignments = aligns.data() + b * max_memory_steps_;
-    const T* keys = keys_.data() + b * max_memory_steps_ * attn_depth_;
-    const T* query = processed_query_.data() + b * attn_depth_;
-
     int mem_steps = mem_seq_lengths_[b];
-    for (int step = 0; step < mem_steps; step++) {
-      const T* keys_on_step = keys + step * attn_depth_;
-      T* dest = alignments + step;
-
-      // reduce_sum(v * tanh(keys[step] + query)) on last dimension
-      *dest = T(0.0);
-      for (int i = 0; i < attn_depth_; i++) {
-        *dest += (attention_v_[i] * tanh(keys_on_step[i] + query[i]));
-      }
-    }
-
-    SoftmaxInplace(gsl::span<T>{alignments, mem_steps});
+    MlasComputeSoftmax(alignments, alignments, 1, static_cast<size_t>(mem_steps), false);
+    std::fill(alignments + mem_steps, alignments + max_memory_steps_, T{});
 
     // Calculate the context
     auto outspan = output.subspan(b * memory_depth_);
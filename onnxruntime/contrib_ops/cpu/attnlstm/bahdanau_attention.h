@@ -17,7 +17,7 @@ class BahdanauAttention : public IAttentionMechanism<T> {
  public:
   BahdanauAttention(
       AllocatorPtr allocator,
-      const logging::Logger& logger,
+      const OpKernelContext& context,
       int batch_size,
       int max_memory_step,
       int memory_depth,
@@ -52,6 +52,7 @@ class BahdanauAttention : public IAttentionMechanism<T> {
 
  private:
   AllocatorPtr allocator_;
+  const OpKernelContext& context_;
   const logging::Logger& logger_;
 
   int batch_size_;
@@ -73,6 +74,10 @@ class BahdanauAttention : public IAttentionMechanism<T> {
   IAllocatorUniquePtr<T> processed_query_ptr_;
   gsl::span<T> processed_query_;
 
+  // tanh(keys + processed query) of every memory step, shape `[batch_size_, max_memory_step_, attn_depth_]`
+  IAllocatorUniquePtr<T> attn_hidden_ptr_;
+  gsl::span<T> attn_hidden_;
+
   IAllocatorUniquePtr<int> mem_seq_lengths_ptr_;
   gsl::span<int> mem_seq_lengths_;
 
@@ -229,7 +229,7 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
                                                  last_cell_size_per_direction);
 
     auto fam = std::make_unique<BahdanauAttention<T>>(
-        alloc, logger, batch_size, max_memory_step, memory_depth, query_depth, am_attn_size, false);
+        alloc, context, batch_size, max_memory_step, memory_depth, query_depth, am_attn_size, false);
     fam->SetWeights(
         FirstHalfSpan(am_v_weights.DataAsSpan<T>()),
         FirstHalfSpan(am_query_layer_weights.DataAsSpan<T>()),
@@ -241,17 +241,17 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
     faw->SetWeights(FirstHalfSpan(attn_layer_weights_span));
 
     auto fw = std::make_unique<UniDirectionalAttnLstm<T>>(
-        alloc, logger,
+        alloc, context,
         seq_length, batch_size, input_size,
         hidden_size_, Direction::kForward, input_forget_, *faw,
         bias_1, peephole_weights_1, initial_hidden_1, initial_cell_1,
         activation_funcs_.Entries()[0],
         activation_funcs_.Entries()[1],
         activation_funcs_.Entries()[2],
-        clip_, ttp_);
+        clip_);
 
     auto bam = std::make_unique<BahdanauAttention<T>>(
-        alloc, logger, batch_size, max_memory_step, memory_depth, query_depth, am_attn_size, false);
+        alloc, context, batch_size, max_memory_step, memory_depth, query_depth, am_attn_size, false);
     bam->SetWeights(
         SecondHalfSpan(am_v_weights.DataAsSpan<T>()),
         SecondHalfSpan(am_query_layer_weights.DataAsSpan<T>()),
@@ -263,21 +263,24 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
     baw->SetWeights(SecondHalfSpan(attn_layer_weights_span));
 
     auto bw = std::make_unique<UniDirectionalAttnLstm<T>>(
-        alloc, logger,
+        alloc, context,
         seq_length, batch_size, input_size,
         hidden_size_, Direction::kReverse, input_forget_, *baw,
         bias_2, peephole_weights_2, initial_hidden_2, initial_cell_2,
         activation_funcs_.Entries()[3],
         activation_funcs_.Entries()[4],
         activation_funcs_.Entries()[5],
-        clip_, ttp_);
+        clip_);
 
-    fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
-    bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2, output_2, hidden_output_2, last_cell_2);
+    onnxruntime::rnn::detail::ExecuteDirectionsInParallel(
+        context,
+        [&]() { fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1, last_cell_1); },
+        [&]() { bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2, output_2, hidden_output_2, last_cell_2); },
+        logger);
 
   } else {
     auto fam = std::make_unique<BahdanauAttention<T>>(
-        alloc, logger, batch_size, max_memory_step, memory_depth, query_depth, am_attn_size, false);
+        alloc, context, batch_size, max_memory_step, memory_depth, query_depth, am_attn_size, false);
     fam->SetWeights(
         am_v_weights.DataAsSpan<T>(),
         am_query_layer_weights.DataAsSpan<T>(),
@@ -289,14 +292,14 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
     faw->SetWeights(attn_layer_weights_span);
 
     auto fw = std::make_unique<UniDirectionalAttnLstm<T>>(
-        alloc, logger,
+        alloc, context,
         seq_length, batch_size, input_size,
         hidden_size_, direction_, input_forget_, *faw,
         bias_1, peephole_weights_1, initial_hidden_1, initial_cell_1,
         activation_funcs_.Entries()[0],
         activation_funcs_.Entries()[1],
         activation_funcs_.Entries()[2],
-        clip_, ttp_);
+        clip_);
 
     fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
   }
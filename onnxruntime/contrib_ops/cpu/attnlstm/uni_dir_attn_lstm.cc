@@ -29,7 +29,7 @@ namespace detail {
 
 template <typename T>
 UniDirectionalAttnLstm<T>::UniDirectionalAttnLstm(AllocatorPtr allocator,
-                                                  const logging::Logger& logger,
+                                                  const OpKernelContext& context,
                                                   const int seq_length,
                                                   const int batch_size,
                                                   const int input_size,
@@ -44,14 +44,10 @@ UniDirectionalAttnLstm<T>::UniDirectionalAttnLstm(AllocatorPtr allocator,
                                                   const ActivationFuncs::Entry& activation_func_f,
                                                   const ActivationFuncs::Entry& activation_func_g,
                                                   const ActivationFuncs::Entry& activation_func_h,
-                                                  const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                                                  Eigen::NonBlockingThreadPool& ttp)
-#else
-                                                  TaskThreadPool& ttp)
-#endif
+                                                  const float clip)
     : allocator_(allocator),
-      logger_(logger),
+      context_(context),
+      logger_(context.Logger()),
       seq_length_(seq_length),
       batch_size_(batch_size),
       input_size_(input_size),
@@ -61,8 +57,7 @@ UniDirectionalAttnLstm<T>::UniDirectionalAttnLstm(AllocatorPtr allocator,
       clip_(clip),
       use_bias_(!bias.empty()),
       use_peepholes_(!peephole_weights.empty()),
-      attention_wrapper_(attention_wrapper),
-      ttp_(ttp) {
+      attention_wrapper_(attention_wrapper) {
   activation_f_ = {deepcpu::ActivationFuncByName(activation_func_f.name),
                    activation_func_f.alpha,
                    activation_func_f.beta};
@@ -476,10 +471,8 @@ void UniDirectionalAttnLstm<T>::GateComputations(span_T_iter& out, span_T_iter&
 
 template <typename T>
 void UniDirectionalAttnLstm<T>::SetNumThreads() {
-  int threads = std::thread::hardware_concurrency() - 1;
-
-  if (threads < 1)
-    threads = 1;
+  // the threads of the intra-op thread pool and the calling thread
+  int threads = context_.NumParallelRanges();
 
   int hmt = threads;
   batch_parallel_ = false;
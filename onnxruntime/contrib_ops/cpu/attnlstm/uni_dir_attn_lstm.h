@@ -35,7 +35,7 @@ template <typename T>
 class UniDirectionalAttnLstm {
  public:
   UniDirectionalAttnLstm(AllocatorPtr allocator,
-                         const logging::Logger& logger,
+                         const OpKernelContext& context,
                          const int seq_length,
                          const int batch_size,
                          const int input_size,
@@ -50,12 +50,7 @@ class UniDirectionalAttnLstm {
                          const ActivationFuncs::Entry& activation_func_f,
                          const ActivationFuncs::Entry& activation_func_g,
                          const ActivationFuncs::Entry& activation_func_h,
-                         const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                         Eigen::NonBlockingThreadPool& ttp);
-#else
-                         TaskThreadPool& ttp);
-#endif
+                         const float clip);
 
   void Compute(const gsl::span<const T>& inputs,
                const gsl::span<const int>& sequence_lengths,
@@ -98,6 +93,7 @@ class UniDirectionalAttnLstm {
   void LoadBias(const gsl::span<const T>& WbRb_values);
 
   AllocatorPtr allocator_;
+  const OpKernelContext& context_;
   const logging::Logger& logger_;
 
   int seq_length_;
@@ -154,12 +150,6 @@ class UniDirectionalAttnLstm {
   ActivationInfo<deepcpu::LstmMergeGatesFuncPtr> activation_h_;
 
   AttentionWrapper<T>& attention_wrapper_;
-
-#ifdef USE_EIGEN_THREADPOOL
-  Eigen::NonBlockingThreadPool& ttp_;
-#else
-  TaskThreadPool& ttp_;
-#endif
 };
 
 }  // namespace detail
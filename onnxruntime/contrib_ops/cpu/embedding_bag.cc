@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/embedding_bag.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", {DataTypeImpl::GetTensorType<float>(),
+                              DataTypeImpl::GetTensorType<MLFloat16>(),
+                              DataTypeImpl::GetTensorType<uint8_t>()})
+        .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag);
+
+namespace {
+
+// loads a row into the cache while the previous row of the bag is accumulated, as the rows of the bags are scattered
+// over a table that is usually much larger than the cache
+inline void PrefetchRow(const void* row, size_t row_bytes) {
+#if defined(__GNUC__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+  const char* bytes = static_cast<const char*>(row);
+  for (size_t offset = 0; offset < row_bytes; offset += 64) {
+#if defined(__GNUC__)
+    __builtin_prefetch(bytes + offset);
+#else
+    _mm_prefetch(bytes + offset, _MM_HINT_T0);
+#endif
+  }
+#else
+  ORT_UNUSED_PARAMETER(row);
+  ORT_UNUSED_PARAMETER(row_bytes);
+#endif
+}
+
+// the rows of a table, which AddRow adds to the float sum of a bag
+template <typename T>
+struct EmbeddingTable {
+  const T* data;
+  int64_t width;
+
+  void AddRow(int64_t row, EigenVectorMap<float>& sum) const {
+    sum += ConstEigenVectorMap<float>(data + row * width, width);
+  }
+};
+
+template <>
+struct EmbeddingTable<MLFloat16> {
+  const MLFloat16* data;
+  int64_t width;
+
+  void AddRow(int64_t row, EigenVectorMap<float>& sum) const {
+    const auto* half_row = reinterpret_cast<const Eigen::half*>(data + row * width);
+    sum += ConstEigenVectorMap<Eigen::half>(half_row, width).template cast<float>();
+  }
+};
+
+template <>
+struct EmbeddingTable<uint8_t> {
+  const uint8_t* data;
+  int64_t width;
+  const float* scales;
+  const float* biases;
+
+  void AddRow(int64_t row, EigenVectorMap<float>& sum) const {
+    sum.array() += ConstEigenVectorMap<uint8_t>(data + row * width, width).template cast<float>().array() *
+                       scales[row] +
+                   biases[row];
+  }
+};
+
+// the number of table elements each range of bags pooled in parallel accumulates at least, on average
+constexpr int64_t kMinEmbeddingElementsPerRange = 16 * 1024;
+
+// bag b is the indices [bag_offsets[b], bag_offsets[b + 1]), the bags are pooled in parallel on the intra-op pool of
+// context
+template <typename T, typename Tind>
+void PoolBags(const OpKernelContext* context, const EmbeddingTable<T>& table, const Tind* indices,
+              const std::vector<int64_t>& bag_offsets, bool mean, float* output) {
+  const int64_t num_bags = static_cast<int64_t>(bag_offsets.size()) - 1;
+  if (num_bags <= 0) {
+    return;
+  }
+  const size_t row_bytes = static_cast<size_t>(table.width) * sizeof(T);
+  const int64_t bag_elements = std::max<int64_t>(1, bag_offsets.back() / num_bags * table.width);
+
+  const int64_t min_bags = std::max<int64_t>(1, kMinEmbeddingElementsPerRange / bag_elements);
+  context->ParallelFor(num_bags, min_bags, [&](int64_t first_bag, int64_t last_bag) {
+    for (int64_t bag = first_bag; bag < last_bag; bag++) {
+      EigenVectorMap<float> sum(output + bag * table.width, table.width);
+      sum.setZero();
+
+      const int64_t begin = bag_offsets[bag];
+      const int64_t end = bag_offsets[bag + 1];
+      for (int64_t i = begin; i < end; i++) {
+        if (i + 1 < end) {
+          PrefetchRow(table.data + static_cast<int64_t>(indices[i + 1]) * table.width, row_bytes);
+        }
+        table.AddRow(static_cast<int64_t>(indices[i]), sum);
+      }
+
+      if (mean && end > begin) {
+        sum *= 1.0f / static_cast<float>(end - begin);
+      }
+    }
+  });
+}
+
+}  // namespace
+
+EmbeddingBag::EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+  const std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+  ORT_ENFORCE(mode == "sum" || mode == "mean", "Invalid mode of EmbeddingBag: ", mode);
+  mean_ = mode == "mean";
+}
+
+template <typename Tind>
+Status EmbeddingBag::ComputeImpl(OpKernelContext* context) const {
+  const Tensor* data = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* lengths = context->Input<Tensor>(2);
+  const TensorShape& data_shape = data->Shape();
+  const TensorShape& indices_shape = indices->Shape();
+
+  if (data_shape.NumDimensions() < 1 || indices_shape.NumDimensions() < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "EmbeddingBag data and indices must have a rank of at least 1");
+  }
+
+  const int64_t num_rows = data_shape[0];
+  const int64_t width = data_shape.SizeFromDimension(1);
+  const int64_t num_indices = indices_shape.Size();
+  const Tind* index_data = indices->template Data<Tind>();
+  for (int64_t i = 0; i < num_indices; ++i) {
+    if (index_data[i] < 0 || index_data[i] >= num_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices element out of data bounds, idx=", index_data[i],
+                             " data_dim=", num_rows);
+    }
+  }
+
+  std::vector<int64_t> bag_offsets;
+  std::vector<int64_t> output_dims;
+  if (lengths != nullptr) {
+    if (indices_shape.NumDimensions() != 1 || lengths->Shape().NumDimensions() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "EmbeddingBag with lengths requires 1-D indices and lengths");
+    }
+    const int64_t num_bags = lengths->Shape()[0];
+    const Tind* length_data = lengths->template Data<Tind>();
+    bag_offsets.resize(static_cast<size_t>(num_bags) + 1, 0);
+    for (int64_t bag = 0; bag < num_bags; ++bag) {
+      if (length_data[bag] < 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "EmbeddingBag lengths must not be negative, got ",
+                               length_data[bag]);
+      }
+      bag_offsets[bag + 1] = bag_offsets[bag] + static_cast<int64_t>(length_data[bag]);
+    }
+    if (bag_offsets.back() != num_indices) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "EmbeddingBag lengths sum to ", bag_offsets.back(),
+                             " instead of the number of indices ", num_indices);
+    }
+    output_dims.push_back(num_bags);
+  } else {
+    // the bags are the last dim of the indices
+    const size_t bag_axis = indices_shape.NumDimensions() - 1;
+    const int64_t bag_size = indices_shape[bag_axis];
+    const int64_t num_bags = indices_shape.SizeToDimension(bag_axis);
+    bag_offsets.resize(static_cast<size_t>(num_bags) + 1);
+    for (int64_t bag = 0; bag <= num_bags; ++bag) {
+      bag_offsets[bag] = bag * bag_size;
+    }
+    output_dims.assign(indices_shape.GetDims().begin(), indices_shape.GetDims().end() - 1);
+  }
+  output_dims.insert(output_dims.end(), data_shape.GetDims().begin() + 1, data_shape.GetDims().end());
+
+  Tensor* output = context->Output(0, TensorShape(output_dims));
+  float* output_data = output->template MutableData<float>();
+
+  if (data->DataType() == DataTypeImpl::GetType<float>()) {
+    PoolBags(context, EmbeddingTable<float>{data->template Data<float>(), width}, index_data, bag_offsets, mean_,
+             output_data);
+  } else if (data->DataType() == DataTypeImpl::GetType<MLFloat16>()) {
+    PoolBags(context, EmbeddingTable<MLFloat16>{data->template Data<MLFloat16>(), width}, index_data, bag_offsets,
+             mean_, output_data);
+  } else {
+    const Tensor* scales = context->Input<Tensor>(3);
+    const Tensor* biases = context->Input<Tensor>(4);
+    if (scales == nullptr || biases == nullptr || scales->Shape().Size() != num_rows ||
+        biases->Shape().Size() != num_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "EmbeddingBag of a uint8 table requires scales and biases with one value per row");
+    }
+    EmbeddingTable<uint8_t> table{data->template Data<uint8_t>(), width, scales->template Data<float>(),
+                                  biases->template Data<float>()};
+    PoolBags(context, table, index_data, bag_offsets, mean_, output_data);
+  }
+
+  return Status::OK();
+}
+
+Status EmbeddingBag::Compute(OpKernelContext* context) const {
+  MLDataType index_type = context->Input<Tensor>(1)->DataType();
+  if (index_type == DataTypeImpl::GetType<int32_t>()) {
+    return ComputeImpl<int32_t>(context);
+  }
+  if (index_type == DataTypeImpl::GetType<int64_t>()) {
+    return ComputeImpl<int64_t>(context);
+  }
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in EmbeddingBag.");
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/feature_pipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+// the number of values the rows of each range of a parallel FeaturePipeline hold at least
+constexpr int64_t kMinPipelineValuesPerRange = 16 * 1024;
+}  // namespace
+
+ONNX_OPERATOR_KERNEL_EX(
+    FeaturePipeline,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FeaturePipeline);
+
+FeaturePipeline::FeaturePipeline(const OpKernelInfo& info) : OpKernel(info) {
+  const std::vector<std::string> steps = info.GetAttrsOrDefault<std::string>("steps");
+  const std::vector<std::string> norms = info.GetAttrsOrDefault<std::string>("norms");
+  const std::vector<float> step_values = info.GetAttrsOrDefault<float>("step_values");
+  const std::vector<int64_t> step_value_counts = info.GetAttrsOrDefault<int64_t>("step_value_counts");
+  ORT_ENFORCE(!steps.empty() && steps.size() == step_value_counts.size(),
+              "Each of the steps must have a count of step_values.");
+  if (info.GetAttrs<int64_t>("inputdimensions", input_dimensions_).IsOK()) {
+    ORT_ENFORCE(!input_dimensions_.empty(), "inputdimensions must not be empty.");
+    total_dimensions_ = std::accumulate(input_dimensions_.cbegin(), input_dimensions_.cend(), 0LL);
+  }
+
+  size_t next_value = 0;
+  size_t next_norm = 0;
+  for (size_t i = 0; i < steps.size(); ++i) {
+    const size_t count = static_cast<size_t>(step_value_counts[i]);
+    ORT_ENFORCE(step_value_counts[i] >= 0 && next_value + count <= step_values.size(),
+                "step_value_counts exceed the step_values.");
+    const float* values = step_values.data() + next_value;
+    next_value += count;
+
+    Step step;
+    if (steps[i] == "Imputer") {
+      ORT_ENFORCE(count >= 2, "An Imputer step needs a replaced value and imputed values.");
+      step.type = StepType::Imputer;
+      step.value = values[0];
+      step.values.assign(values + 1, values + count);
+    } else if (steps[i] == "Scaler") {
+      ORT_ENFORCE(count >= 2 && count % 2 == 0, "A Scaler step needs as many offsets as scales.");
+      step.type = StepType::Scaler;
+      step.values.assign(values, values + count / 2);
+      step.scales.assign(values + count / 2, values + count);
+    } else if (steps[i] == "Normalizer") {
+      ORT_ENFORCE(count == 0 && next_norm < norms.size(), "A Normalizer step needs a norm.");
+      step.type = StepType::Normalizer;
+      step.norm = ml::MakeNormalize(norms[next_norm++]);
+    } else if (steps[i] == "Binarizer") {
+      ORT_ENFORCE(count == 1, "A Binarizer step needs a threshold.");
+      step.type = StepType::Binarizer;
+      step.value = values[0];
+    } else {
+      ORT_THROW("Unsupported step ", steps[i]);
+    }
+    steps_.push_back(std::move(step));
+  }
+}
+
+bool FeaturePipeline::RunSteps(float* row, int64_t features) const {
+  bool is_valid = true;
+  for (const Step& step : steps_) {
+    switch (step.type) {
+      case StepType::Imputer: {
+        const float replaced = step.value;
+        const bool per_feature = static_cast<int64_t>(step.values.size()) == features;
+        const float* imputed = step.values.data();
+        if (std::isnan(replaced)) {
+          for (int64_t i = 0; i < features; ++i) {
+            row[i] = std::isnan(row[i]) ? imputed[per_feature ? i : 0] : row[i];
+          }
+        } else if (per_feature) {
+          for (int64_t i = 0; i < features; ++i) {
+            row[i] = row[i] == replaced ? imputed[i] : row[i];
+          }
+        } else {
+          for (int64_t i = 0; i < features; ++i) {
+            row[i] = row[i] == replaced ? imputed[0] : row[i];
+          }
+        }
+        break;
+      }
+      case StepType::Scaler: {
+        const float* offset = step.values.data();
+        const float* scale = step.scales.data();
+        if (static_cast<int64_t>(step.values.size()) == features) {
+          for (int64_t i = 0; i < features; ++i) {
+            row[i] = (row[i] - offset[i]) * scale[i];
+          }
+        } else {
+          for (int64_t i = 0; i < features; ++i) {
+            row[i] = (row[i] - offset[0]) * scale[0];
+          }
+        }
+        break;
+      }
+      case StepType::Normalizer: {
+        float norm = 0.f;
+        if (step.norm == ml::NORMALIZE::NMAX) {
+          norm = std::numeric_limits<float>::lowest();
+          for (int64_t i = 0; i < features; ++i) {
+            norm = std::max(norm, row[i]);
+          }
+        } else if (step.norm == ml::NORMALIZE::L1) {
+          for (int64_t i = 0; i < features; ++i) {
+            norm += std::abs(row[i]);
+          }
+        } else {
+          for (int64_t i = 0; i < features; ++i) {
+            norm += row[i] * row[i];
+          }
+        }
+        if (norm == 0.f) {
+          break;
+        }
+        if (step.norm == ml::NORMALIZE::L2) {
+          for (int64_t i = 0; i < features; ++i) {
+            const float x = std::sqrt(row[i] * row[i] / norm);
+            row[i] = row[i] < 0 ? -x : x;
+          }
+        } else {
+          for (int64_t i = 0; i < features; ++i) {
+            row[i] = row[i] / norm;
+          }
+        }
+        break;
+      }
+      case StepType::Binarizer: {
+        const float threshold = step.value;
+        for (int64_t i = 0; i < features; ++i) {
+          is_valid = is_valid && !std::isnan(row[i]);
+          row[i] = row[i] > threshold ? 1.f : 0.f;
+        }
+        break;
+      }
+    }
+  }
+  return is_valid;
+}
+
+Status FeaturePipeline::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  ORT_ENFORCE(X != nullptr);
+  const auto& x_dims = X->Shape().GetDims();
+  if (x_dims.empty() || (input_dimensions_.empty() && x_dims.size() > 2)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The features must be of rank 1 or 2.");
+  }
+
+  // the rows of every input, as FeatureVectorizer assumes
+  const int64_t rows = x_dims.size() == 1 ? 1 : x_dims[0];
+  int64_t features = 0;
+  Tensor* Y = nullptr;
+  std::vector<const Tensor*> inputs;
+  if (input_dimensions_.empty()) {
+    features = x_dims.back();
+    Y = context->Output(0, X->Shape());
+  } else {
+    const int input_count = context->NumVariadicInputs(0);
+    if (input_count != static_cast<int>(input_dimensions_.size())) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Number of inputs (", input_count,
+                             ") does not match number of inputdimensions values (", input_dimensions_.size(), ").");
+    }
+    for (int i = 0; i < input_count; ++i) {
+      const Tensor* input = context->Input<Tensor>(i);
+      const auto& dims = input->Shape().GetDims();
+      if (dims.empty() || (dims.size() == 1 ? 1 : dims[0]) != rows) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", i, " doesn't have the ", rows, " rows of X.");
+      }
+      inputs.push_back(input);
+    }
+    features = total_dimensions_;
+    Y = context->Output(0, TensorShape({rows, features}));
+  }
+
+  for (const Step& step : steps_) {
+    if (step.type == StepType::Scaler && step.values.size() != 1 &&
+        static_cast<int64_t>(step.values.size()) != features) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Either both scale and offset can be of feature size (",
+                             features, ") or 1");
+    }
+  }
+
+  const float* x_data = X->Data<float>();
+  float* y_data = Y->MutableData<float>();
+  std::atomic<bool> is_valid{true};
+  auto run_rows = [&](int64_t begin, int64_t end) {
+    for (int64_t n = begin; n < end; ++n) {
+      float* row = y_data + n * features;
+      if (inputs.empty()) {
+        std::copy_n(x_data + n * features, features, row);
+      } else {
+        // copies the features of each input, truncated or padded with 0 to its inputdimensions
+        float* out = row;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+          const TensorShape& shape = inputs[i]->Shape();
+          const int64_t input_size = shape.NumDimensions() == 1 ? shape[0] : shape.SizeFromDimension(1);
+          const int64_t copied = std::min(input_size, input_dimensions_[i]);
+          std::copy_n(inputs[i]->Data<float>() + n * input_size, copied, out);
+          std::fill(out + copied, out + input_dimensions_[i], 0.f);
+          out += input_dimensions_[i];
+        }
+      }
+      if (!RunSteps(row, features)) {
+        is_valid = false;
+      }
+    }
+  };
+
+  const int64_t min_rows = std::max<int64_t>(1, kMinPipelineValuesPerRange / std::max<int64_t>(1, features));
+  context->ParallelFor(rows, min_rows, run_rows);
+
+  if (!is_valid) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The input of a Binarizer step is NaN.");
+  }
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/ml_common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Runs the fused Imputer, Scaler, Normalizer and Binarizer steps of a converted scikit-learn pipeline one row at a
+// time, in the output row, with the results of the separate ai.onnx.ml kernels.
+class FeaturePipeline final : public OpKernel {
+ public:
+  explicit FeaturePipeline(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  enum class StepType {
+    Imputer,
+    Scaler,
+    Normalizer,
+    Binarizer
+  };
+
+  struct Step {
+    StepType type;
+    // the imputed values of an Imputer, the offsets of a Scaler
+    std::vector<float> values;
+    // the scales of a Scaler
+    std::vector<float> scales;
+    // the replaced value of an Imputer, the threshold of a Binarizer
+    float value{0.f};
+    ml::NORMALIZE norm{ml::NORMALIZE::NMAX};
+  };
+
+  // runs the steps on a row of features in place, false if a Binarizer found a NaN
+  bool RunSteps(float* row, int64_t features) const;
+
+  std::vector<Step> steps_;
+  // the features of each input, a single input when empty
+  std::vector<int64_t> input_dimensions_;
+  int64_t total_dimensions_{0};
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -3,9 +3,18 @@
 
 #include "contrib_ops/cpu/gather_nd.h"
 
+#include <algorithm>
+#include <atomic>
+
 namespace onnxruntime {
 namespace contrib     {
 
+namespace {
+// the index tuples and the bytes of the slices below which a range is not worth a thread
+constexpr int64_t kMinGatherIndicesPerRange = 16 * 1024;
+constexpr int64_t kMinGatherBytesPerRange = 16 * 1024;
+}
+
 ONNX_OPERATOR_KERNEL_EX(
     GatherND,
     kMSDomain,
@@ -43,21 +52,18 @@ Status GatherNDBase::PrepareForCompute(OpKernelContext* context, Prepare& p) con
                input_shape.GetDims().begin() + last_indice_dimension,
                input_shape.GetDims().end());
   auto output_tensor = context->Output(0,TensorShape(shape));
-  std::vector<int64_t> element_counts(last_indice_dimension, 0LL); // Number of elements for each input dimension
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < last_indice_dimension; ++i) {
-    element_counts[i] = input_shape.SizeFromDimension(i + 1);
+  // the number of elements of a step along each indexed dim of the input
+  std::vector<int64_t> element_counts(last_indice_dimension, 0LL);
+  for (int64_t i = last_indice_dimension - 1; i >= 0; --i) {
+    element_counts[i] = i == last_indice_dimension - 1 ? input_shape.SizeFromDimension(last_indice_dimension)
+                                                        : element_counts[i + 1] * input_shape[i + 1];
   }
 
-  int64_t err_indice = 0;
   p.element_bytes    = input_tensor->DataType()->Size();
   p.element_to_copy  = input_shape.SizeFromDimension(last_indice_dimension);
   p.bytes_to_copy    = p.element_bytes * p.element_to_copy;
   auto indice_offset = indice_tensor->Data<Tind>();
-  auto offset_count  = indice_shape.Size() / last_indice_dimension; // Times to copy
+  auto offset_count  = indice_shape.SizeToDimension(indice_shape.NumDimensions() - 1); // Times to copy
   p.element_offsets.assign(offset_count, 0LL);
 
   if (input_tensor->DataType() == DataTypeImpl::GetType<std::string>()) {
@@ -68,20 +74,37 @@ Status GatherNDBase::PrepareForCompute(OpKernelContext* context, Prepare& p) con
     p.output_base     = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
   }
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < offset_count; ++i) {
-    for (int64_t j = 0; j < last_indice_dimension; ++j) {
-      auto indice = *(indice_offset + i * last_indice_dimension + j);
-      if (indice < 0 || indice >= input_shape[j]) {
-        err_indice = indice;
+  // the first invalid index tuple that a range found, if any
+  std::atomic<int64_t> err_tuple{offset_count};
+  const int64_t dims = static_cast<int64_t>(last_indice_dimension);
+  context->ParallelFor(offset_count, std::max<int64_t>(1, kMinGatherIndicesPerRange / std::max<int64_t>(1, dims)),
+                       [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const Tind* tuple = indice_offset + i * dims;
+      uint64_t offset = 0;
+      for (int64_t j = 0; j < dims; ++j) {
+        const int64_t indice = static_cast<int64_t>(tuple[j]);
+        if (indice < 0 || indice >= input_shape[j]) {
+          int64_t expected = err_tuple.load();
+          while (i < expected && !err_tuple.compare_exchange_weak(expected, i)) {
+          }
+          return;
+        }
+        offset += static_cast<uint64_t>(indice * element_counts[j]);
+      }
+      p.element_offsets[i] = offset;
+    }
+  });
+
+  if (err_tuple.load() < offset_count) {
+    const Tind* tuple = indice_offset + err_tuple.load() * dims;
+    for (int64_t j = 0; j < dims; ++j) {
+      if (tuple[j] < 0 || tuple[j] >= input_shape[j]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid indice found, indice = ", tuple[j]);
       }
-      p.element_offsets[i] += indice * element_counts[j];
     }
   }
-  return err_indice == 0 ? Status::OK() :
-    ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid indice found, indice = ", err_indice);
+  return Status::OK();
 }
 
 template Status GatherNDBase::PrepareForCompute<int32_t>(OpKernelContext*, Prepare&) const;
@@ -89,32 +112,37 @@ template Status GatherNDBase::PrepareForCompute<int64_t>(OpKernelContext*, Prepa
 
 Status GatherND::Compute(OpKernelContext* context) const {
   Prepare p;
-  ORT_RETURN_IF_ERROR(context->Input<Tensor>(1)->DataType() == DataTypeImpl::GetType<int32_t>() ? 
+  ORT_RETURN_IF_ERROR(context->Input<Tensor>(1)->DataType() == DataTypeImpl::GetType<int32_t>() ?
                               PrepareForCompute<int32_t>(context, p) : PrepareForCompute<int64_t>(context, p));
-  return nullptr == p.input_str_base ? GatherNumber(p) : GatherString(p);
+  return nullptr == p.input_str_base ? GatherNumber(context, p) : GatherString(context, p);
 }
 
-Status GatherND::GatherNumber(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    memcpy(p.output_base + i * p.bytes_to_copy,
-           p.input_base + p.element_offsets[i] * p.element_bytes,
-           p.bytes_to_copy);
-  }
+Status GatherND::GatherNumber(OpKernelContext* context, const Prepare& p) const {
+  // each slice is contiguous in the input and the output
+  const int64_t slice_bytes = std::max<int64_t>(1, static_cast<int64_t>(p.bytes_to_copy));
+  context->ParallelFor(static_cast<int64_t>(p.element_offsets.size()),
+                       std::max<int64_t>(1, kMinGatherBytesPerRange / slice_bytes),
+                       [&p](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      memcpy(p.output_base + i * p.bytes_to_copy,
+             p.input_base + p.element_offsets[i] * p.element_bytes,
+             p.bytes_to_copy);
+    }
+  });
   return Status::OK();
 }
 
-Status GatherND::GatherString(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
-      p.output_str_base[i * p.element_to_copy + j] = p.input_str_base[p.element_offsets[i] + j];
+Status GatherND::GatherString(OpKernelContext* context, const Prepare& p) const {
+  const int64_t slice_elements = std::max<int64_t>(1, static_cast<int64_t>(p.element_to_copy));
+  context->ParallelFor(static_cast<int64_t>(p.element_offsets.size()),
+                       std::max<int64_t>(1, kMinGatherIndicesPerRange / slice_elements),
+                       [&p](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      std::copy(p.input_str_base + p.element_offsets[i],
+                p.input_str_base + p.element_offsets[i] + p.element_to_copy,
+                p.output_str_base + i * p.element_to_copy);
     }
-  }
+  });
   return Status::OK();
 }
 
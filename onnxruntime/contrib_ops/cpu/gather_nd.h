@@ -32,6 +32,7 @@ protected:
                element_offsets (0) {}
   }; // struct Prepare
 
+  // computes the offset of the slice of each index tuple in parallel, from the element counts of the input dims
   template<typename Tind>
   Status PrepareForCompute(OpKernelContext* context, Prepare& p) const;
 }; // class GatherNDBase
@@ -41,8 +42,8 @@ public:
   explicit GatherND(const OpKernelInfo& info) : OpKernel(info) {}
   Status Compute(OpKernelContext* context) const override;
 private:
-  Status GatherNumber(const Prepare& p) const;
-  Status GatherString(const Prepare& p) const;
+  Status GatherNumber(OpKernelContext* context, const Prepare& p) const;
+  Status GatherString(OpKernelContext* context, const Prepare& p) const;
 };
 
 } // namespace contrib
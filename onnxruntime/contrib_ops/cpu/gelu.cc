@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/gelu.h"
+
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    Gelu,
+    1,
+    float,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Gelu<float>);
+
+template <>
+Status Gelu<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  Tensor* Y = context->Output(0, X->Shape());
+
+  // a single pass that evaluates erf with the vectorized MLAS kernels
+  MlasComputeGelu(X->template Data<float>(), Y->template MutableData<float>(), static_cast<size_t>(X->Shape().Size()));
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/image_preprocess.h"
+
+#include <algorithm>
+
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+// the output values below which a range is not worth a thread
+constexpr int64_t kMinPreprocessValuesPerRange = 16 * 1024;
+}  // namespace
+
+ONNX_OPERATOR_KERNEL_EX(
+    ImagePreprocess,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<float>()),
+    ImagePreprocess);
+
+ImagePreprocess::ImagePreprocess(const OpKernelInfo& info) : OpKernel(info), ImagePreprocessBase(info) {
+  table_channels_ = std::max(scale_.size(), bias_.size());
+  table_.resize(table_channels_ * 256);
+  for (size_t c = 0; c < table_channels_; ++c) {
+    const float scale = scale_[scale_.size() == 1 ? 0 : c];
+    const float bias = bias_[bias_.size() == 1 ? 0 : c];
+    for (int value = 0; value < 256; ++value) {
+      table_[c * 256 + value] = static_cast<float>(value) * scale + bias;
+    }
+  }
+}
+
+Status ImagePreprocess::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  Region region;
+  ORT_RETURN_IF_ERROR(ComputeRegion(*X, region));
+
+  const int64_t channels = region.channels;
+  const int64_t block_size = nchwc_ ? static_cast<int64_t>(MlasNchwcGetBlockSize()) : 1;
+  const int64_t padded_channels = (channels + block_size - 1) / block_size * block_size;
+  Tensor* Y = context->Output(0, TensorShape({region.batch, nchwc_ ? padded_channels : channels, region.out_height,
+                                              region.out_width}));
+
+  const uint8_t* x_data = X->Data<uint8_t>();
+  float* y_data = Y->MutableData<float>();
+  const int64_t out_height = region.out_height;
+  const int64_t out_width = region.out_width;
+  const int64_t plane_size = out_height * out_width;
+  const float* table = table_.data();
+  const bool shared_table = table_channels_ == 1;
+
+  // each range converts whole rows of the images, reading the pixels of a row once and writing them to the planes
+  // of their channels, or to the blocks of channels in the NCHWc format
+  const int64_t rows = region.batch * out_height;
+  const int64_t row_size = std::max<int64_t>(1, out_width * padded_channels);
+  const int64_t min_rows = std::max<int64_t>(1, kMinPreprocessValuesPerRange / row_size);
+  context->ParallelFor(rows, min_rows, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      const int64_t n = row / out_height;
+      const int64_t h = row % out_height;
+      const uint8_t* x = x_data + ((n * region.height + region.top + h) * region.width + region.left) * channels;
+      if (!nchwc_) {
+        for (int64_t c = 0; c < channels; ++c) {
+          const float* channel_table = table + (shared_table ? 0 : c * 256);
+          float* y = y_data + (n * channels + c) * plane_size + h * out_width;
+          for (int64_t w = 0; w < out_width; ++w) {
+            y[w] = channel_table[x[w * channels + c]];
+          }
+        }
+        continue;
+      }
+
+      const int64_t blocks = padded_channels / block_size;
+      for (int64_t block = 0; block < blocks; ++block) {
+        float* y = y_data + ((n * blocks + block) * plane_size + h * out_width) * block_size;
+        const int64_t block_channels = std::min(block_size, channels - block * block_size);
+        for (int64_t w = 0; w < out_width; ++w) {
+          const uint8_t* pixel = x + w * channels + block * block_size;
+          float* out = y + w * block_size;
+          for (int64_t i = 0; i < block_channels; ++i) {
+            out[i] = table[(shared_table ? 0 : (block * block_size + i) * 256) + pixel[i]];
+          }
+          // the padding channels are zero, like those ReorderInput adds
+          std::fill(out + block_channels, out + block_size, 0.0f);
+        }
+      }
+    }
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
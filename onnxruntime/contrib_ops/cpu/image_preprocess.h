@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// the attributes of ImagePreprocess, shared with the CUDA kernel
+class ImagePreprocessBase {
+ protected:
+  ImagePreprocessBase(const OpKernelInfo& info)
+      : scale_(info.GetAttrsOrDefault<float>("scale", {1.0f})),
+        bias_(info.GetAttrsOrDefault<float>("bias", {0.0f})),
+        border_(info.GetAttrsOrDefault<int64_t>("border")),
+        crop_size_(info.GetAttrsOrDefault<int64_t>("crop_size")),
+        nchwc_(info.GetAttrOrDefault<int64_t>("nchwc", 0) != 0) {
+    ORT_ENFORCE(!scale_.empty() && !bias_.empty(), "ImagePreprocess scale and bias must not be empty.");
+    ORT_ENFORCE(border_.empty() || border_.size() == 4, "ImagePreprocess border needs four elements.");
+    ORT_ENFORCE(crop_size_.empty() || (crop_size_.size() == 2 && !border_.empty()),
+                "ImagePreprocess crop_size needs two elements and a border.");
+  }
+
+  // the region of the NHWC images that is kept
+  struct Region {
+    int64_t batch;
+    int64_t height;
+    int64_t width;
+    int64_t channels;
+    int64_t top;
+    int64_t left;
+    int64_t out_height;
+    int64_t out_width;
+  };
+
+  // the region of X, after checking it against the border, the crop size and the channels of scale and bias
+  Status ComputeRegion(const Tensor& X, Region& region) const {
+    const auto& dims = X.Shape().GetDims();
+    if (dims.size() != 4) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "ImagePreprocess input is expected to have four dimensions corresponding to [N,H,W,C], "
+                             "got ", dims.size());
+    }
+    region.batch = dims[0];
+    region.height = dims[1];
+    region.width = dims[2];
+    region.channels = dims[3];
+    region.top = border_.empty() ? 0 : border_[1];
+    region.left = border_.empty() ? 0 : border_[0];
+    int64_t bottom_limit = border_.empty() ? region.height : region.height - border_[3];
+    int64_t right_limit = border_.empty() ? region.width : region.width - border_[2];
+    if (!crop_size_.empty()) {
+      bottom_limit = region.top + crop_size_[0];
+      right_limit = region.left + crop_size_[1];
+    }
+    if (region.top < 0 || region.left < 0 || bottom_limit < region.top || right_limit < region.left ||
+        bottom_limit > region.height || right_limit > region.width) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "ImagePreprocess border and crop_size select a region ",
+                             "outside of the input images: ", X.Shape().ToString());
+    }
+    region.out_height = bottom_limit - region.top;
+    region.out_width = right_limit - region.left;
+
+    for (const auto* values : {&scale_, &bias_}) {
+      if (values->size() != 1 && static_cast<int64_t>(values->size()) != region.channels) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "ImagePreprocess scale and bias must have one element ",
+                               "or one for each of the ", region.channels, " channels.");
+      }
+    }
+    return Status::OK();
+  }
+
+  const std::vector<float> scale_;
+  const std::vector<float> bias_;
+  const std::vector<int64_t> border_;     // (left, top, right, bottom)
+  const std::vector<int64_t> crop_size_;  // (height, width)
+  const bool nchwc_;
+};
+
+class ImagePreprocess final : public OpKernel, public ImagePreprocessBase {
+ public:
+  ImagePreprocess(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // the float value of each uint8 value for each channel of scale and bias, so a pixel converts with a load
+  std::vector<float> table_;
+  size_t table_channels_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
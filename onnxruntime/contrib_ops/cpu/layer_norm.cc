@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/layer_norm.h"
+
+#include <algorithm>
+
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// the number of elements each range of slices normalized in parallel holds at least
+constexpr int64_t kMinLayerNormElementsPerRange = 16 * 1024;
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    LayerNormalization,
+    1,
+    float,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    LayerNorm<float>);
+
+template <typename T>
+Status LayerNorm<T>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* scale = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+
+  int64_t slice_count = 0;
+  int64_t slice_size = 0;
+  ORT_RETURN_IF_ERROR(ComputeSliceSize(*X, *scale, bias, slice_count, slice_size));
+
+  Tensor* Y = context->Output(0, X->Shape());
+  if (slice_size == 0) {
+    return Status::OK();
+  }
+
+  const T* x_data = X->template Data<T>();
+  T* y_data = Y->template MutableData<T>();
+  ConstEigenVectorArrayMap<T> scale_array(scale->template Data<T>(), slice_size);
+
+  const int64_t min_slices = std::max<int64_t>(1, kMinLayerNormElementsPerRange / slice_size);
+  context->ParallelFor(slice_count, min_slices, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      ConstEigenVectorArrayMap<T> x(x_data + i * slice_size, slice_size);
+      EigenVectorArrayMap<T> y(y_data + i * slice_size, slice_size);
+
+      // the variance is the mean of the squared deviations, which has no cancellation unlike E(x^2) - E(x)^2
+      const T mean = x.mean();
+      y = x - mean;
+      const T variance = y.square().mean();
+      y *= scale_array / std::sqrt(variance + static_cast<T>(epsilon_));
+      if (bias != nullptr) {
+        y += ConstEigenVectorArrayMap<T>(bias->template Data<T>(), slice_size);
+      }
+    }
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
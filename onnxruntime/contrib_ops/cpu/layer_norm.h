@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// the attributes of LayerNormalization, shared with the CUDA kernel
+class LayerNormBase {
+ protected:
+  LayerNormBase(const OpKernelInfo& info) {
+    axis_ = info.GetAttrOrDefault<int64_t>("axis", -1);
+    epsilon_ = info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+  }
+
+  // the number of normalized slices and their size, after checking the sizes of the scale and the bias
+  Status ComputeSliceSize(const Tensor& X, const Tensor& scale, const Tensor* bias,
+                          int64_t& slice_count, int64_t& slice_size) const {
+    const TensorShape& x_shape = X.Shape();
+    const int64_t rank = static_cast<int64_t>(x_shape.NumDimensions());
+    if (axis_ < -rank || axis_ >= rank) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "LayerNormalization axis ", axis_,
+                             " is out of range for an input of rank ", rank);
+    }
+    const auto axis = static_cast<size_t>(HandleNegativeAxis(axis_, rank));
+    slice_count = x_shape.SizeToDimension(axis);
+    slice_size = x_shape.SizeFromDimension(axis);
+
+    if (scale.Shape().Size() != slice_size || (bias != nullptr && bias->Shape().Size() != slice_size)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "LayerNormalization Scale and B must have the size of the normalized slices, ",
+                             slice_size);
+    }
+    return Status::OK();
+  }
+
+  int64_t axis_;
+  float epsilon_;
+};
+
+template <typename T>
+class LayerNorm final : public OpKernel, public LayerNormBase {
+ public:
+  LayerNorm(const OpKernelInfo& info) : OpKernel(info), LayerNormBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
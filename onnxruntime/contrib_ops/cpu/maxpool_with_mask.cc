@@ -3,9 +3,45 @@
 
 #include "maxpool_with_mask.h"
 
+#include <algorithm>
+#include <limits>
+
+#include "core/mlas/inc/mlas.h"
+
 namespace onnxruntime {
 namespace contrib {
 
+namespace {
+// the input elements below which a range of channels is not worth a thread
+constexpr int64_t kMinPoolElementsPerRange = 16 * 1024;
+
+enum class MaskKind {
+  // no element is masked
+  kNone,
+  // the masked elements of each row are at its end, so stopping a row at its first one skips just the masked ones
+  kTrailing,
+  kOther,
+};
+
+// the kind of the mask of a channel, whose rows are along the innermost pooled dim. the loops of 2-D and 3-D pooling
+// never check the first element of a channel.
+MaskKind GetMaskKind(const int32_t* mask, int64_t size, int64_t row_size, bool check_first) {
+  MaskKind kind = MaskKind::kNone;
+  for (int64_t row = 0; row < size; row += row_size) {
+    bool masked = false;
+    for (int64_t i = row; i < row + row_size; ++i) {
+      if (mask[i] == 0 && (i != 0 || check_first)) {
+        masked = true;
+        kind = MaskKind::kTrailing;
+      } else if (masked) {
+        return MaskKind::kOther;
+      }
+    }
+  }
+  return kind;
+}
+}  // namespace
+
 ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
     MaxpoolWithMask,
     1,
@@ -14,5 +50,215 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
         .TypeConstraint("X", DataTypeImpl::GetTensorType<float>()),
     MaxpoolWithMask);
 
+Status MaxpoolWithMask::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* M = context->Input<Tensor>(1);
+
+  const TensorShape& x_shape = X->Shape();
+  const TensorShape& m_shape = M->Shape();
+  ORT_RETURN_IF_NOT(x_shape.NumDimensions() >= 3, "Input dimension cannot be less than 3.");
+
+  //TODO: fix this checker later
+  //ONNXRUNTIME_RETURN_IF_NOT((x_shape[2] == m_shape[2]) && (x_shape[3] == m_shape[3]), " Input shape and mask shape mismatch: ", x_shape, " vs ", m_shape);
+
+  const size_t pooling_dims = kernel_shape_.size();
+  if (pooling_dims < 1 || pooling_dims > 3) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Unsupported pooling size : ");
+  }
+
+  PoolShape shape;
+  shape.pads = pads_;
+  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(x_shape, x_shape[1], &shape.pads);
+  Tensor* Y = context->Output(0, TensorShape(output_dims));
+
+  const float* X_data = X->template Data<float>();
+  const int32_t* M_data = M->template Data<int32_t>();
+  float* Y_data = Y->template MutableData<float>();
+
+  shape.height = x_shape[2];
+  shape.width = pooling_dims > 1 ? x_shape[3] : 1;
+  shape.depth = pooling_dims > 2 ? x_shape[4] : 1;
+  shape.pooled_height = output_dims[2];
+  shape.pooled_width = pooling_dims > 1 ? output_dims[3] : 1;
+  shape.pooled_depth = pooling_dims > 2 ? output_dims[4] : 1;
+  shape.total_mask_channels = m_shape[0] * m_shape[1];
+
+  const int64_t total_channels = x_shape[0] * x_shape[1];
+  const int64_t x_step = shape.height * shape.width * shape.depth;
+  const int64_t y_step = shape.pooled_height * shape.pooled_width * shape.pooled_depth;
+
+  // the mask offsets of the channels repeat after total_mask_channels channels, so those cover every mask
+  const int64_t row_size = pooling_dims == 1 ? shape.height : pooling_dims == 2 ? shape.width : shape.depth;
+  MaskKind mask_kind = MaskKind::kNone;
+  for (int64_t c = 0; c < std::min(total_channels, shape.total_mask_channels) && mask_kind != MaskKind::kOther;
+       ++c) {
+    const int32_t* m_d = M_data + (c * x_step) % shape.total_mask_channels;
+    mask_kind = std::max(mask_kind, GetMaskKind(m_d, x_step, row_size, pooling_dims == 1));
+  }
+
+  // with the masked elements of each row at its end, the pooling is a max pooling that skips them, which MLAS runs
+  // vectorized on a copy of the channels that replaces them by the lowest value
+  std::vector<int64_t> pool_input_shape(x_shape.GetDims().begin() + 1, x_shape.GetDims().end());
+  std::vector<int64_t> pool_output_shape(output_dims.begin() + 1, output_dims.end());
+  pool_input_shape[0] = 1;
+  pool_output_shape[0] = 1;
+  context->ParallelFor(total_channels, std::max<int64_t>(1, kMinPoolElementsPerRange / std::max<int64_t>(1, x_step)),
+                       [&](int64_t begin, int64_t end) {
+    if (mask_kind == MaskKind::kOther) {
+      PoolScalar(X_data, M_data, Y_data, shape, begin, end);
+      return;
+    }
+
+    const float* input = X_data + begin * x_step;
+    std::vector<float> masked_input;
+    if (mask_kind == MaskKind::kTrailing) {
+      masked_input.resize(static_cast<size_t>((end - begin) * x_step));
+      for (int64_t c = begin; c < end; ++c) {
+        const float* x_d = X_data + c * x_step;
+        const int32_t* m_d = M_data + (c * x_step) % shape.total_mask_channels;
+        float* masked_d = masked_input.data() + (c - begin) * x_step;
+        for (int64_t i = 0; i < x_step; ++i) {
+          masked_d[i] = m_d[i] != 0 || (i == 0 && pooling_dims != 1) ? x_d[i] : std::numeric_limits<float>::lowest();
+        }
+      }
+      input = masked_input.data();
+    }
+
+    // the channels of the range are pooled as the batch of their input shape
+    std::vector<int64_t> input_shape(pool_input_shape);
+    std::vector<int64_t> output_shape(pool_output_shape);
+    input_shape.insert(input_shape.begin(), end - begin);
+    output_shape.insert(output_shape.begin(), end - begin);
+    MlasPool(MlasMaximumPooling,
+             pooling_dims,
+             input_shape.data(),
+             kernel_shape_.data(),
+             shape.pads.data(),
+             strides_.data(),
+             output_shape.data(),
+             input,
+             Y_data + begin * y_step);
+  });
+
+  return Status::OK();
+}
+
+void MaxpoolWithMask::PoolScalar(const float* X_data, const int32_t* M_data, float* Y_data, const PoolShape& shape,
+                                 int64_t begin, int64_t end) const {
+  const std::vector<int64_t>& kernel_shape = kernel_shape_;
+  const std::vector<int64_t>& pads = shape.pads;
+  const int64_t height = shape.height;
+  const int64_t width = shape.width;
+  const int64_t depth = shape.depth;
+  const int64_t pooled_height = shape.pooled_height;
+  const int64_t pooled_width = shape.pooled_width;
+  const int64_t pooled_depth = shape.pooled_depth;
+  const int64_t total_mask_channels = shape.total_mask_channels;
+
+  switch (kernel_shape.size()) {
+    case 1: {
+      int64_t x_step = height;
+      int64_t y_step = pooled_height;
+      for (int64_t c = begin; c < end; ++c) {
+        const float* x_d = X_data + c * x_step;
+        const int32_t* m_d = M_data + (c * x_step) % total_mask_channels;
+        float* y_d = Y_data + c * y_step;
+        for (int64_t ph = 0; ph < pooled_height; ++ph) {
+          int64_t hstart = ph * stride_h() - pads[0];
+          int64_t hend = std::min(hstart + kernel_shape[0], height);
+          hstart = std::max(hstart, static_cast<int64_t>(0));
+          float Yh = std::numeric_limits<float>::lowest();
+          for (int64_t h = hstart; h < hend; ++h) {
+            if (h >= 0 && m_d[h] == 0) break;  // if mask == 0, stop
+            if (x_d[h] > Yh) {
+              Yh = x_d[h];
+            }
+          }
+          y_d[ph] = Yh;
+        }
+      }
+
+      break;
+    }
+
+    case 2: {
+      int64_t x_step = height * width;
+      int64_t y_step = pooled_height * pooled_width;
+      for (int64_t c = begin; c < end; ++c) {
+        const float* x_d = X_data + c * x_step;
+        const int32_t* m_d = M_data + (c * x_step) % total_mask_channels;
+        float* y_d = Y_data + c * y_step;
+
+        for (int64_t ph = 0; ph < pooled_height; ++ph) {
+          int64_t hstart = ph * stride_h() - pads[0];
+          int64_t hend = std::min(hstart + kernel_shape[0], height);
+          hstart = std::max(hstart, static_cast<int64_t>(0));
+          for (int64_t pw = 0; pw < pooled_width; ++pw) {
+            int64_t wstart = pw * stride_w() - pads[1];
+            int64_t wend = std::min(wstart + kernel_shape[1], width);
+            wstart = std::max(wstart, static_cast<int64_t>(0));
+            const int64_t pool_index = ph * pooled_width + pw;
+            float Yh = std::numeric_limits<float>::lowest();
+            for (int64_t h = hstart; h < hend; ++h) {
+              for (int64_t w = wstart; w < wend; ++w) {
+                const int64_t input_index = h * width + w;
+                if (input_index > 0 && m_d[input_index] == 0) break;  // if mask == 0, break
+                if (x_d[input_index] > Yh) {
+                  Yh = x_d[input_index];
+                }
+              }
+            }
+            y_d[pool_index] = Yh;
+          }
+        }
+      }
+      break;
+    }
+    case 3: {
+      int64_t x_step = height * width * depth;
+      int64_t y_step = pooled_height * pooled_width * pooled_depth;
+      for (int64_t c = begin; c < end; ++c) {
+        const float* x_d = X_data + c * x_step;
+        const int32_t* m_d = M_data + (c * x_step) % total_mask_channels;
+        float* y_d = Y_data + c * y_step;
+
+        for (int64_t ph = 0; ph < pooled_height; ++ph) {
+          int64_t hstart = ph * stride_h() - pads[0];
+          int64_t hend = std::min(hstart + kernel_shape[0], height);
+          hstart = std::max(hstart, static_cast<int64_t>(0));
+          for (int64_t pw = 0; pw < pooled_width; ++pw) {
+            int64_t wstart = pw * stride_w() - pads[1];
+            int64_t wend = std::min(wstart + kernel_shape[1], width);
+            wstart = std::max(wstart, static_cast<int64_t>(0));
+            for (int64_t pd = 0; pd < pooled_depth; ++pd) {
+              int64_t dstart = pd * stride_d() - pads[2];
+              int64_t dend = std::min(dstart + kernel_shape[2], depth);
+              dstart = std::max(dstart, static_cast<int64_t>(0));
+              const int64_t pool_index =
+                  ph * pooled_width * pooled_depth + pw * pooled_depth + pd;
+              float Yh = std::numeric_limits<float>::lowest();
+              for (int64_t h = hstart; h < hend; ++h) {
+                for (int64_t w = wstart; w < wend; ++w) {
+                  for (int64_t d = dstart; d < dend; ++d) {
+                    const int64_t input_index = h * width * depth + w * depth + d;
+                    if (input_index > 0 && m_d[input_index] == 0) break;  // if mask == 0, break
+                    if (x_d[input_index] > Yh) {
+                      Yh = x_d[input_index];
+                    }
+                  }
+                }
+              }
+              y_d[pool_index] = Yh;
+            }
+          }
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
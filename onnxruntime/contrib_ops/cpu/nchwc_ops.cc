@@ -0,0 +1,253 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "nchwc_ops.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+
+int64_t RoundUpToBlockSize(int64_t channels) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  return (channels + block_size - 1) / block_size * block_size;
+}
+
+// Reorder an OIHW filter into the buffer used by MlasNchwcConv.
+void ReorderFilter(const Tensor& W, float* buffer) {
+  MlasReorderFilter(W.Shape().GetDims().data(), W.Data<float>(), buffer);
+}
+
+// Copy the bias into a buffer padded with zeroes to the blocked channel count.
+void PadBias(const Tensor& B, int64_t padded_channels, float* buffer) {
+  const int64_t channels = B.Shape().Size();
+  const float* bias = B.Data<float>();
+  std::copy(bias, bias + channels, buffer);
+  std::fill(buffer + channels, buffer + padded_channels, 0.0f);
+}
+
+}  // namespace
+
+ONNX_OPERATOR_KERNEL_EX(
+    ReorderInput,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    ReorderInput);
+
+ONNX_OPERATOR_KERNEL_EX(
+    ReorderOutput,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    ReorderOutput);
+
+ONNX_OPERATOR_KERNEL_EX(
+    NchwcConv,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcConv);
+
+ONNX_OPERATOR_KERNEL_EX(
+    NchwcMaxPool,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcPool);
+
+ONNX_OPERATOR_KERNEL_EX(
+    NchwcAveragePool,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcPool);
+
+Status ReorderInput::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "ReorderInput requires a 4D input. X: ", X_shape.ToString());
+
+  std::vector<int64_t> Y_dims(X_shape.GetDims());
+  Y_dims[1] = RoundUpToBlockSize(X_shape[1]);
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+
+  MlasReorderInput(X_shape.GetDims().data(), X->Data<float>(), Y->MutableData<float>());
+
+  return Status::OK();
+}
+
+Status ReorderOutput::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "ReorderOutput requires a 4D input. X: ", X_shape.ToString());
+  ORT_RETURN_IF_NOT(RoundUpToBlockSize(channels_) == X_shape[1],
+                    "ReorderOutput channels is not compatible with X. channels: ", channels_,
+                    " X: ", X_shape.ToString());
+
+  std::vector<int64_t> Y_dims(X_shape.GetDims());
+  Y_dims[1] = channels_;
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+
+  MlasReorderOutput(Y_dims.data(), X->Data<float>(), Y->MutableData<float>());
+
+  return Status::OK();
+}
+
+NchwcConv::NchwcConv(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
+  activation_ = info.GetAttrOrDefault<std::string>("activation", "");
+  alpha_ = info.GetAttrOrDefault("alpha", 0.01f);
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+
+  const Tensor* W;
+  if (info.TryGetConstantInput(1, &W) && W->Shape().NumDimensions() == 4) {
+    const int64_t filter_size = RoundUpToBlockSize(W->Shape()[0]) * RoundUpToBlockSize(W->Shape()[1]) *
+                                W->Shape()[2] * W->Shape()[3];
+    reordered_W_ = BufferUniquePtr(alloc->Alloc(sizeof(float) * filter_size), BufferDeleter(alloc));
+    ReorderFilter(*W, static_cast<float*>(reordered_W_.get()));
+  }
+
+  const Tensor* B;
+  if (info.TryGetConstantInput(2, &B) && B->Shape().NumDimensions() == 1) {
+    const int64_t padded_channels = RoundUpToBlockSize(B->Shape()[0]);
+    padded_B_ = BufferUniquePtr(alloc->Alloc(sizeof(float) * padded_channels), BufferDeleter(alloc));
+    PadBias(*B, padded_channels, static_cast<float*>(padded_B_.get()));
+  }
+}
+
+Status NchwcConv::Compute(OpKernelContext* context) const {
+  size_t num_inputs = OpKernel::Node().InputDefs().size();
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
+
+  const auto& X_shape = X->Shape();
+  const auto& W_shape = W->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4 && W_shape.NumDimensions() == 4,
+                    "NchwcConv requires 4D inputs. X: ", X_shape.ToString(), " W: ", W_shape.ToString());
+  ORT_RETURN_IF_NOT(group_ == 1, "NchwcConv requires group to be 1. group: ", group_);
+  ORT_RETURN_IF_NOT(RoundUpToBlockSize(W_shape[1]) == X_shape[1],
+                    "Input channels C is not compatible with kernel channels.",
+                    " X: ", X_shape.ToString(), " W: ", W_shape.ToString());
+
+  const int64_t M = W_shape[0];
+  const int64_t padded_M = RoundUpToBlockSize(M);
+
+  if (B != nullptr && (B->Shape().NumDimensions() != 1 || B->Shape()[0] != M)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Bias is not compatible with W. B: ", B->Shape().ToString(),
+                           " W: ", W_shape.ToString());
+  }
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(ComputeKernelShape(W_shape, kernel_shape));
+
+  std::vector<int64_t> pads(pads_);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  std::vector<int64_t> dilations(dilations_);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  std::vector<int64_t> strides(strides_);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  std::vector<int64_t> Y_dims;
+  Y_dims.insert(Y_dims.begin(), {X_shape[0], padded_M});
+  TensorShape input_shape = X_shape.Slice(2);
+  ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+
+  MLAS_ACTIVATION Activation;
+  if (activation_.empty()) {
+    Activation.ActivationKind = MlasIdentityActivation;
+  } else if (activation_ == "Relu") {
+    Activation.ActivationKind = MlasReluActivation;
+  } else if (activation_ == "LeakyRelu") {
+    Activation.ActivationKind = MlasLeakyReluActivation;
+    Activation.alpha = alpha_;
+  } else if (activation_ == "Tanh") {
+    Activation.ActivationKind = MlasTanhActivation;
+  } else if (activation_ == "Sigmoid") {
+    Activation.ActivationKind = MlasLogisticActivation;
+  } else {
+    ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation_);
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // Reorder the filter and pad the bias here if they weren't constant at
+  // construction.
+  const float* filter_data = static_cast<const float*>(reordered_W_.get());
+  BufferUniquePtr filter_buffer;
+  if (filter_data == nullptr) {
+    const int64_t filter_size = padded_M * X_shape[1] * W_shape[2] * W_shape[3];
+    filter_buffer = BufferUniquePtr(alloc->Alloc(sizeof(float) * filter_size), BufferDeleter(alloc));
+    ReorderFilter(*W, static_cast<float*>(filter_buffer.get()));
+    filter_data = static_cast<const float*>(filter_buffer.get());
+  }
+
+  const float* bias_data = static_cast<const float*>(padded_B_.get());
+  BufferUniquePtr bias_buffer;
+  if (bias_data == nullptr && B != nullptr) {
+    bias_buffer = BufferUniquePtr(alloc->Alloc(sizeof(float) * padded_M), BufferDeleter(alloc));
+    PadBias(*B, padded_M, static_cast<float*>(bias_buffer.get()));
+    bias_data = static_cast<const float*>(bias_buffer.get());
+  }
+
+  MlasNchwcConv(X_shape.GetDims().data(),
+                kernel_shape.data(),
+                dilations.data(),
+                pads.data(),
+                strides.data(),
+                Y_dims.data(),
+                X->Data<float>(),
+                filter_data,
+                bias_data,
+                Y->MutableData<float>(),
+                &Activation);
+
+  return Status::OK();
+}
+
+Status NchwcPool::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "NchwcPool requires a 4D input. X: ", X_shape.ToString());
+  ORT_RETURN_IF_NOT(kernel_shape_.size() == 2, "NchwcPool requires a 2D kernel.");
+
+  std::vector<int64_t> pads = pads_;
+  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(X_shape, X_shape[1], &pads);
+  Tensor* Y = context->Output(0, TensorShape(output_dims));
+
+  MlasNchwcPool(kind_,
+                X_shape.GetDims().data(),
+                kernel_shape_.data(),
+                nullptr,
+                pads.data(),
+                strides_.data(),
+                output_dims.data(),
+                X->Data<float>(),
+                Y->MutableData<float>());
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
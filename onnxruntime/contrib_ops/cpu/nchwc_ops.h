@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/nn/conv_base.h"
+#include "core/providers/cpu/nn/pool_base.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// The NCHWc operators work on tensors that store the channels in blocks of
+// MlasNchwcGetBlockSize() elements. The shape of a blocked tensor is the NCHW
+// shape with the channel count rounded up to a multiple of the block size.
+
+class ReorderInput : public OpKernel {
+ public:
+  ReorderInput(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class ReorderOutput : public OpKernel {
+ public:
+  ReorderOutput(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttr<int64_t>("channels", &channels_).IsOK());
+    ORT_ENFORCE(channels_ > 0, "invalid channel count");
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t channels_;
+};
+
+class NchwcConv : public OpKernel, public ConvBase {
+ public:
+  NchwcConv(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // W reordered to the NCHWc filter layout and B padded to the blocked
+  // output channel count, if they are constant initializers
+  BufferUniquePtr reordered_W_;
+  BufferUniquePtr padded_B_;
+};
+
+class NchwcPool : public OpKernel, public PoolBase {
+ public:
+  NchwcPool(const OpKernelInfo& info) : OpKernel(info), PoolBase(info) {
+    if (op_name_ == "NchwcMaxPool") {
+      kind_ = MlasMaximumPooling;
+    } else if (info.GetAttrOrDefault<int64_t>("count_include_pad", 0) != 0) {
+      kind_ = MlasAveragePoolingIncludePad;
+    } else {
+      kind_ = MlasAveragePoolingExcludePad;
+    }
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  MLAS_POOLING_KIND kind_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -12,7 +12,8 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #include "contrib_ops/cpu/non_max_suppression.h"
-#include <queue>
+#include <algorithm>
+#include <vector>
 
 namespace onnxruntime {
 namespace contrib {
@@ -26,51 +27,77 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
         .TypeConstraint("T2", DataTypeImpl::GetTensorType<int32_t>()),
     NonMaxSuppression<float>);
 
+namespace {
+
+// the selected boxes are compared with a candidate this many at a time, between the checks for an early exit
+constexpr int64_t kIOUBlockSize = 16;
+
+// the corners and areas of boxes, in arrays that the IOU of one box with all of them is vectorized over
 template <typename T>
-void NonMaxSuppression<T>::MaxMin(const T& lhs, const T& rhs, T& min, T& max) const {
-  if (lhs >= rhs) {
-    min = rhs;
-    max = lhs;
-  } else {
-    min = lhs;
-    max = rhs;
+struct BoxArrays {
+  std::vector<T> y_min;
+  std::vector<T> x_min;
+  std::vector<T> y_max;
+  std::vector<T> x_max;
+  std::vector<T> area;
+
+  explicit BoxArrays(size_t capacity) {
+    y_min.reserve(capacity);
+    x_min.reserve(capacity);
+    y_max.reserve(capacity);
+    x_max.reserve(capacity);
+    area.reserve(capacity);
   }
-}
 
-template <typename T>
-bool NonMaxSuppression<T>::SuppressByIOU(const T* boxes_data, int32_t box_index1, int32_t box_index2) const {
-  T x1_min, y1_min, x1_max, y1_max, x2_min, y2_min, x2_max, y2_max;
-  // boxes data [y1, x1, y2, x2],
-  MaxMin(boxes_data[4 * box_index1 + 1], boxes_data[4 * box_index1 + 3], x1_min, x1_max);
-  MaxMin(boxes_data[4 * box_index1 + 0], boxes_data[4 * box_index1 + 2], y1_min, y1_max);
-  MaxMin(boxes_data[4 * box_index2 + 1], boxes_data[4 * box_index2 + 3], x2_min, x2_max);
-  MaxMin(boxes_data[4 * box_index2 + 0], boxes_data[4 * box_index2 + 2], y2_min, y2_max);
-
-  const T intersection_x_min = std::max(x1_min, x2_min);
-  const T intersection_y_min = std::max(y1_min, y2_min);
-  const T intersection_x_max = std::min(x1_max, x2_max);
-  const T intersection_y_max = std::min(y1_max, y2_max);
-
-  const T intersection_area = std::max(intersection_x_max - intersection_x_min, static_cast<T>(0.0)) *
-                              std::max(intersection_y_max - intersection_y_min, static_cast<T>(0.0));
-
-  if (intersection_area <= static_cast<T>(0.0)) {
-    return false;
+  // box is [y1, x1, y2, x2], of corners in either order
+  void Add(const T* box) {
+    y_min.push_back(std::min(box[0], box[2]));
+    x_min.push_back(std::min(box[1], box[3]));
+    y_max.push_back(std::max(box[0], box[2]));
+    x_max.push_back(std::max(box[1], box[3]));
+    area.push_back((x_max.back() - x_min.back()) * (y_max.back() - y_min.back()));
   }
 
-  const T area1 = (x1_max - x1_min) * (y1_max - y1_min);
-  const T area2 = (x2_max - x2_min) * (y2_max - y2_min);
-  const T union_area = area1 + area2 - intersection_area;
+  int64_t Size() const { return static_cast<int64_t>(area.size()); }
+};
 
-  if (area1 <= static_cast<T>(0.0) || area2 <= static_cast<T>(0.0) || union_area <= static_cast<T>(0.0)) {
+// whether the IOU of box with any of boxes is over iou_threshold. boxes of no area or no intersection don't suppress
+template <typename T>
+bool SuppressByIOU(const T* box, const BoxArrays<T>& boxes, float iou_threshold) {
+  const T y_min = std::min(box[0], box[2]);
+  const T x_min = std::min(box[1], box[3]);
+  const T y_max = std::max(box[0], box[2]);
+  const T x_max = std::max(box[1], box[3]);
+  const T area = (x_max - x_min) * (y_max - y_min);
+  if (area <= static_cast<T>(0.0)) {
     return false;
   }
 
-  const T intersection_over_union = intersection_area / union_area;
-
-  return intersection_over_union > iou_threshold_;
+  const int64_t num_boxes = boxes.Size();
+  for (int64_t start = 0; start < num_boxes; start += kIOUBlockSize) {
+    const int64_t end = std::min(start + kIOUBlockSize, num_boxes);
+    int suppressed = 0;
+    for (int64_t i = start; i < end; ++i) {
+      const T intersection_area = std::max(std::min(x_max, boxes.x_max[i]) - std::max(x_min, boxes.x_min[i]),
+                                           static_cast<T>(0.0)) *
+                                  std::max(std::min(y_max, boxes.y_max[i]) - std::max(y_min, boxes.y_min[i]),
+                                           static_cast<T>(0.0));
+      const T union_area = area + boxes.area[i] - intersection_area;
+      // the division of the boxes that don't count is discarded by the conditions
+      suppressed |= static_cast<int>(intersection_area > static_cast<T>(0.0)) &
+                    static_cast<int>(boxes.area[i] > static_cast<T>(0.0)) &
+                    static_cast<int>(union_area > static_cast<T>(0.0)) &
+                    static_cast<int>(intersection_area / union_area > iou_threshold);
+    }
+    if (suppressed != 0) {
+      return true;
+    }
+  }
+  return false;
 }
 
+}  // namespace
+
 template <typename T>
 Status NonMaxSuppression<T>::Compute(OpKernelContext* ctx) const {
   const Tensor* boxes = ctx->Input<Tensor>(0);
@@ -102,38 +129,31 @@ Status NonMaxSuppression<T>::Compute(OpKernelContext* ctx) const {
     int32_t index;
   };
 
-  auto LessCompare = [](const ScoreIndexPair& lhs, const ScoreIndexPair& rhs) {
-    return lhs.score < rhs.score;
-  };
-
-  // Filter by score_threshold_
-  std::priority_queue<ScoreIndexPair, std::deque<ScoreIndexPair>, decltype(LessCompare)> sorted_scores_with_index(LessCompare);
+  // Filter by score_threshold_, and sort by descending score, ties in the order of the boxes
+  std::vector<ScoreIndexPair> sorted_scores_with_index;
   for (int32_t i = 0; i < num_boxes; ++i) {
     if (static_cast<float>(scores_data[i]) > score_threshold_) {
-      sorted_scores_with_index.emplace(ScoreIndexPair({scores_data[i], i}));
+      sorted_scores_with_index.push_back(ScoreIndexPair({scores_data[i], i}));
     }
   }
+  std::stable_sort(sorted_scores_with_index.begin(), sorted_scores_with_index.end(),
+                   [](const ScoreIndexPair& lhs, const ScoreIndexPair& rhs) { return lhs.score > rhs.score; });
 
   int num_of_selected = 0;
   std::vector<int32_t> selected_index(max_output_size_, 0);
-  ScoreIndexPair next_top_score;
-
-  // Get the next box with top score, filter by iou_threshold_
-  while (num_of_selected < max_output_size_ && !sorted_scores_with_index.empty()) {
-    next_top_score = sorted_scores_with_index.top();
-    sorted_scores_with_index.pop();
-
-    bool selected = true;
-    // Check with existing boxes, suppress if exceed the IOU (Intersection Over Union) threshold
-    for (int i = num_of_selected - 1; i >= 0; --i) {
-      if (SuppressByIOU(boxes_data, selected_index[i], next_top_score.index)) {
-        selected = false;
-        break;
-      }
+  BoxArrays<T> selected_boxes(
+      static_cast<size_t>(std::min<int64_t>(max_output_size_, sorted_scores_with_index.size())));
+
+  // Take the boxes by score until there are max_output_size_, skipping those whose IOU (Intersection Over Union)
+  // with a selected box exceeds iou_threshold_
+  for (const auto& candidate : sorted_scores_with_index) {
+    if (num_of_selected >= max_output_size_) {
+      break;
     }
-
-    if (selected) {
-      selected_index[num_of_selected] = next_top_score.index;
+    const T* box = boxes_data + 4 * candidate.index;
+    if (!SuppressByIOU(box, selected_boxes, iou_threshold_)) {
+      selected_index[num_of_selected] = candidate.index;
+      selected_boxes.Add(box);
       ++num_of_selected;
     }
   }
@@ -5,10 +5,40 @@
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/providers/cpu/tensor/cast_op.h"
 #include "core/providers/common.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 namespace contrib {
 
+namespace {
+
+// the number of elements converted by a single MLAS call, the chunks are converted in parallel
+constexpr size_t kQuantizeChunkSize = 16 * 1024;
+
+// converts the num_blocks blocks of block_size elements, block b with the scale and zero point at
+// (b % broadcast_dim) * stride, by convert(input, output, count, scale, zero_point) on chunks of the blocks on the
+// intra-op pool of ctx
+template <typename TIn, typename TOut, typename TZeroPoint, typename TConvert>
+void ConvertBlocks(const OpKernelContext* ctx, const TIn* input, TOut* output, int64_t num_blocks, int64_t broadcast_dim,
+                   size_t block_size, size_t stride, const float* scale, const TZeroPoint* zero_point,
+                   TConvert convert) {
+  const int64_t chunks_per_block = static_cast<int64_t>((block_size + kQuantizeChunkSize - 1) / kQuantizeChunkSize);
+  const int64_t num_chunks = num_blocks * chunks_per_block;
+
+  ctx->ParallelFor(num_chunks, 1, [&](int64_t first, int64_t last) {
+    for (int64_t chunk = first; chunk < last; chunk++) {
+      const int64_t block = chunk / chunks_per_block;
+      const size_t begin = static_cast<size_t>(chunk % chunks_per_block) * kQuantizeChunkSize;
+      const size_t count = std::min(kQuantizeChunkSize, block_size - begin);
+      const size_t offset = static_cast<size_t>(block) * block_size + begin;
+      const size_t bd = static_cast<size_t>(block % broadcast_dim) * stride;
+      convert(input + offset, output + offset, count, scale[bd], zero_point[bd]);
+    }
+  });
+}
+
+}  // namespace
+
 ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
     DequantizeLinear,
     1,
@@ -67,23 +97,20 @@ Status DequantizeLinear<T>::Compute(OpKernelContext* ctx) const {
   const T* input = x.template Data<T>();
   float* output = y.template MutableData<float>();
 
-  for (size_t n = 0; n < N; n++) {
-    const float* current_scale = scale;
-    const T* current_zero_point = zero_point;
-
-    for (size_t bd = 0; bd < static_cast<size_t>(broadcastDim); bd++) {
-      auto zp = static_cast<const int>(*current_zero_point);
-      auto sc = *current_scale;
-
-      for (size_t bs = 0; bs < block_size; bs++) {
-        *output++ = static_cast<float>(static_cast<const int>(*input++) - zp) * sc;
-      }
-
-      current_scale += stride;
-      current_zero_point += stride;
-    }
+  int64_t num_blocks = static_cast<int64_t>(N) * broadcastDim;
+  int64_t broadcast_dim = broadcastDim;
+  if (!has_axis_) {
+    // the scalar scale and zero point apply to the whole tensor as a single block
+    block_size = static_cast<size_t>(x_shape.Size());
+    num_blocks = 1;
+    broadcast_dim = 1;
   }
 
+  ConvertBlocks(ctx, input, output, num_blocks, broadcast_dim, block_size, stride, scale, zero_point,
+                [](const T* in, float* out, size_t count, float sc, T zp) {
+                  MlasDequantizeLinear(in, out, count, sc, zp);
+                });
+
   return Status::OK();
 }
 
@@ -99,14 +126,6 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
         .TypeConstraint("y", DataTypeImpl::GetTensorType<uint8_t>()),
     QuantizeLinear<float>);
 
-// clamp doesn't exist in the version of <algorithm> that we're using, so
-// make a local one.
-static float clamp(float v, float lo, float hi) {
-  if (v < lo) return lo;
-  if (v > hi) return hi;
-  return v;
-}
-
 template <>
 // formula is Y = X / Scale + ZeroPoint
 Status QuantizeLinear<float>::Compute(OpKernelContext* ctx) const {
@@ -141,23 +160,20 @@ Status QuantizeLinear<float>::Compute(OpKernelContext* ctx) const {
   const float* input = x.template Data<float>();
   uint8_t* output = y.template MutableData<uint8_t>();
 
-  for (size_t n = 0; n < N; n++) {
-    const float* current_scale = scale;
-    const uint8_t* current_zero_point = zero_point;
-
-    for (size_t bd = 0; bd < static_cast<size_t>(broadcastDim); bd++) {
-      float zp = *current_zero_point;
-      auto sc = *current_scale;
-
-      for (size_t bs = 0; bs < block_size; bs++) {
-        *output++ = static_cast<uint8_t>(clamp(std::round(static_cast<float>(*input++) / sc) + zp, 0.0f, float(UINT8_MAX)));
-      }
-
-      current_scale += stride;
-      current_zero_point += stride;
-    }
+  int64_t num_blocks = static_cast<int64_t>(N) * broadcastDim;
+  int64_t broadcast_dim = broadcastDim;
+  if (!has_axis_) {
+    // the scalar scale and zero point apply to the whole tensor as a single block
+    block_size = static_cast<size_t>(x_shape.Size());
+    num_blocks = 1;
+    broadcast_dim = 1;
   }
 
+  ConvertBlocks(ctx, input, output, num_blocks, broadcast_dim, block_size, stride, scale, zero_point,
+                [](const float* in, uint8_t* out, size_t count, float sc, uint8_t zp) {
+                  MlasQuantizeLinear(in, out, count, sc, zp);
+                });
+
   return Status::OK();
 }
 }  // namespace contrib
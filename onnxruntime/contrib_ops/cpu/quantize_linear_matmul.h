@@ -10,6 +10,11 @@
 namespace onnxruntime {
 namespace contrib {
 
+// the fixed point multiplier in Q31 format and the right shift that requantize by fp_multiplier
+void QuantizeMultiplier(float fp_multiplier, std::int32_t* integer_multiplier, int* right_shift);
+
+void ScaleAndZeropointPairValidationHelper(const Tensor* scale, const Tensor* zeropoint);
+
 template <typename T1, typename T2, typename T3>
 class QLinearMatMul final : public OpKernel {
  public:
@@ -24,6 +24,8 @@ namespace onnxruntime {
 namespace contrib {
 const int64_t EXPECTED_NUM_ROI_DIMS = 2;
 const int64_t EXPECTED_SECOND_ROI_DIM = 5;
+// the number of outputs the ROIs of each range of a parallel ROIAlign pool at least
+constexpr int64_t kMinRoiAlignOutputsPerRange = 16 * 1024;
 
 #define ADD_TYPED_ROIALIGN_OP(data_type)                                  \
   ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(                                      \
@@ -148,6 +150,7 @@ void pre_calc_for_bilinear_interpolate(
 
 template <typename T>
 void ROIAlignForward(
+    const OpKernelContext* context,
     int64_t nthreads,
     const T* bottom_data,
     float spatial_scale,
@@ -162,106 +165,111 @@ void ROIAlignForward(
     T* top_data,
     const std::string& mode) {
   int64_t n_rois = nthreads / channels / pooled_width / pooled_height;
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int n = 0; n < n_rois; n++) {
-    int64_t index_n = n * channels * pooled_width * pooled_height;
-
-    const T* offset_bottom_rois = bottom_rois + n * roi_cols;
-    const T roi_batch_ind = offset_bottom_rois[0];
-    offset_bottom_rois++;
-
-    // Do not using rounding; this implementation detail is critical
-    T roi_start_w = offset_bottom_rois[0] * spatial_scale;
-    T roi_start_h = offset_bottom_rois[1] * spatial_scale;
-    T roi_end_w = offset_bottom_rois[2] * spatial_scale;
-    T roi_end_h = offset_bottom_rois[3] * spatial_scale;
-
-    // Force malformed ROIs to be 1x1
-    T roi_width = std::max(roi_end_w - roi_start_w, (T)1.);
-    T roi_height = std::max(roi_end_h - roi_start_h, (T)1.);
-    T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
-    T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
-
-    // We use roi_bin_grid to sample the grid and mimic integral
-    int64_t roi_bin_grid_h = (sampling_ratio > 0)
-                                 ? sampling_ratio
-                                 : static_cast<int64_t>(ceil(roi_height / pooled_height));  // e.g., = 2
-    int64_t roi_bin_grid_w =
-        (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(ceil(roi_width / pooled_width));
-
-    // We do average (integral) pooling inside a bin
-    const int64_t count = roi_bin_grid_h * roi_bin_grid_w;  // e.g. = 4
-
-    // we want to precalculate indices and weights shared by all channels,
-    // this is the key point of optimization
-    std::vector<PreCalc<T>> pre_calc(
-        roi_bin_grid_h * roi_bin_grid_w * pooled_width * pooled_height);
-    pre_calc_for_bilinear_interpolate(
-        height,
-        width,
-        pooled_height,
-        pooled_width,
-        roi_bin_grid_h,
-        roi_bin_grid_w,
-        roi_start_h,
-        roi_start_w,
-        bin_size_h,
-        bin_size_w,
-        roi_bin_grid_h,
-        roi_bin_grid_w,
-        pre_calc);
-
-    for (int64_t c = 0; c < channels; c++) {
-      int64_t index_n_c = index_n + c * pooled_width * pooled_height;
-      const T* offset_bottom_data =
-          bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
-      int64_t pre_calc_index = 0;
-
-      for (int64_t ph = 0; ph < pooled_height; ph++) {
-        for (int64_t pw = 0; pw < pooled_width; pw++) {
-          int64_t index = index_n_c + ph * pooled_width + pw;
-
-          T output_val = 0.;
-          if (mode == "avg") {  // avg pooling
-            for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
-              for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                PreCalc<T> pc = pre_calc[pre_calc_index];
-                output_val += pc.w1 * offset_bottom_data[pc.pos1] +
-                              pc.w2 * offset_bottom_data[pc.pos2] +
-                              pc.w3 * offset_bottom_data[pc.pos3] +
-                              pc.w4 * offset_bottom_data[pc.pos4];
-
-                pre_calc_index += 1;
+  const bool is_avg = mode == "avg";
+
+  // the interpolation table of each ROI is computed into the vector of its thread
+  auto compute_rois = [&](int64_t roi_begin, int64_t roi_end) {
+    std::vector<PreCalc<T>> pre_calc;
+    for (int64_t n = roi_begin; n < roi_end; n++) {
+      int64_t index_n = n * channels * pooled_width * pooled_height;
+
+      const T* offset_bottom_rois = bottom_rois + n * roi_cols;
+      const T roi_batch_ind = offset_bottom_rois[0];
+      offset_bottom_rois++;
+
+      // Do not using rounding; this implementation detail is critical
+      T roi_start_w = offset_bottom_rois[0] * spatial_scale;
+      T roi_start_h = offset_bottom_rois[1] * spatial_scale;
+      T roi_end_w = offset_bottom_rois[2] * spatial_scale;
+      T roi_end_h = offset_bottom_rois[3] * spatial_scale;
+
+      // Force malformed ROIs to be 1x1
+      T roi_width = std::max(roi_end_w - roi_start_w, (T)1.);
+      T roi_height = std::max(roi_end_h - roi_start_h, (T)1.);
+      T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
+      T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
+
+      // We use roi_bin_grid to sample the grid and mimic integral
+      int64_t roi_bin_grid_h = (sampling_ratio > 0)
+                                   ? sampling_ratio
+                                   : static_cast<int64_t>(ceil(roi_height / pooled_height));  // e.g., = 2
+      int64_t roi_bin_grid_w =
+          (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(ceil(roi_width / pooled_width));
+
+      // We do average (integral) pooling inside a bin
+      const int64_t count = roi_bin_grid_h * roi_bin_grid_w;  // e.g. = 4
+
+      // we want to precalculate indices and weights shared by all channels,
+      // this is the key point of optimization
+      pre_calc.resize(roi_bin_grid_h * roi_bin_grid_w * pooled_width * pooled_height);
+      pre_calc_for_bilinear_interpolate(
+          height,
+          width,
+          pooled_height,
+          pooled_width,
+          roi_bin_grid_h,
+          roi_bin_grid_w,
+          roi_start_h,
+          roi_start_w,
+          bin_size_h,
+          bin_size_w,
+          roi_bin_grid_h,
+          roi_bin_grid_w,
+          pre_calc);
+
+      for (int64_t c = 0; c < channels; c++) {
+        int64_t index_n_c = index_n + c * pooled_width * pooled_height;
+        const T* offset_bottom_data =
+            bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
+        int64_t pre_calc_index = 0;
+
+        for (int64_t ph = 0; ph < pooled_height; ph++) {
+          for (int64_t pw = 0; pw < pooled_width; pw++) {
+            int64_t index = index_n_c + ph * pooled_width + pw;
+
+            T output_val = 0.;
+            if (is_avg) {  // avg pooling
+              for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
+                for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
+                  PreCalc<T> pc = pre_calc[pre_calc_index];
+                  output_val += pc.w1 * offset_bottom_data[pc.pos1] +
+                                pc.w2 * offset_bottom_data[pc.pos2] +
+                                pc.w3 * offset_bottom_data[pc.pos3] +
+                                pc.w4 * offset_bottom_data[pc.pos4];
+
+                  pre_calc_index += 1;
+                }
               }
-            }
-            output_val /= count;
-          } else {  // max pooling
-            bool max_flag = false;
-            for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
-              for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                PreCalc<T> pc = pre_calc[pre_calc_index];
-                if (!max_flag) {
-                  output_val = pc.w1 * offset_bottom_data[pc.pos1];
-                  max_flag = true;
-                } else {
-                  output_val = std::max(std::max(std::max(output_val, pc.w2 * offset_bottom_data[pc.pos2]),
-                                                 pc.w3 * offset_bottom_data[pc.pos3]),
-                                        pc.w4 * offset_bottom_data[pc.pos4]);
+              output_val /= count;
+            } else {  // max pooling
+              bool max_flag = false;
+              for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
+                for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
+                  PreCalc<T> pc = pre_calc[pre_calc_index];
+                  if (!max_flag) {
+                    output_val = pc.w1 * offset_bottom_data[pc.pos1];
+                    max_flag = true;
+                  } else {
+                    output_val = std::max(std::max(std::max(output_val, pc.w2 * offset_bottom_data[pc.pos2]),
+                                                   pc.w3 * offset_bottom_data[pc.pos3]),
+                                          pc.w4 * offset_bottom_data[pc.pos4]);
+                  }
+
+                  pre_calc_index += 1;
                 }
-
-                pre_calc_index += 1;
               }
             }
-          }
 
-          top_data[index] = output_val;
-        }  // for pw
-      }    // for ph
-    }      // for c
-  }        // for n
+            top_data[index] = output_val;
+          }  // for pw
+        }    // for ph
+      }      // for c
+    }        // for n
+  };
+
+  // ROIs are split between the threads of the intra-op thread pool when there are enough
+  const int64_t outputs_per_roi = std::max<int64_t>(1, channels * pooled_width * pooled_height);
+  context->ParallelFor(n_rois, std::max<int64_t>(1, kMinRoiAlignOutputsPerRange / outputs_per_roi), compute_rois);
 }
 }  // namespace
 
@@ -292,6 +300,7 @@ Status ROIAlign<T>::Compute(OpKernelContext* context) const {
   auto& Y = *context->Output(0, {rois_dims[0], x_dims[1], pooled_h_, pooled_w_});
   int64_t output_size = Y.Shape().Size();
   ROIAlignForward<T>(
+      context,
       output_size,
       X_ptr->Data<T>(),
       spatial_scale_,
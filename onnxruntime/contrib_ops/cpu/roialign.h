@@ -8,10 +8,10 @@
 
 namespace onnxruntime {
 namespace contrib {
-template <typename T>
-class ROIAlign final : public OpKernel {
- public:
-  explicit ROIAlign(const OpKernelInfo& info) : OpKernel(info) {
+// attributes shared by the CPU and CUDA kernels
+class ROIAlignBase {
+ protected:
+  explicit ROIAlignBase(const OpKernelInfo& info) {
     // mode
     std::string mode_tmp;
     if (info.GetAttr<std::string>("mode", &mode_tmp).IsOK()) {
@@ -48,15 +48,21 @@ class ROIAlign final : public OpKernel {
     }
   }
 
-  Status Compute(OpKernelContext* context) const override;
-
- private:
   std::string mode_{"avg"};
   int64_t pooled_h_{1};
   int64_t pooled_w_{1};
   int64_t sampling_ratio_{0};
   float spatial_scale_{1.0f};
+};
 
+template <typename T>
+class ROIAlign final : public OpKernel, public ROIAlignBase {
+ public:
+  explicit ROIAlign(const OpKernelInfo& info) : OpKernel(info), ROIAlignBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ROIAlign);
 };
 }  // namespace contrib
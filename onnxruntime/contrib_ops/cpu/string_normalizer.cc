@@ -5,6 +5,7 @@
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/common/utf8_util.h"
 
 #ifdef _MSC_VER
 #include <locale.h>
@@ -103,12 +104,43 @@ const std::string default_locale("en_US.UTF-8");
 
 #endif
 
+// whether the locale changes the case of every ASCII char as the C locale does. it doesn't for e.g. the
+// dotted and dotless i of Turkish.
+bool IsAsciiCaseChange(const Locale& loc) {
+  for (wchar_t ch = 0; ch < 0x80; ++ch) {
+    std::wstring lower(1, ch);
+    std::wstring upper(1, ch);
+    loc.ChangeCase(StringNormalizer::LOWER, lower);
+    loc.ChangeCase(StringNormalizer::UPPER, upper);
+    const wchar_t expected_lower = (ch >= L'A' && ch <= L'Z') ? static_cast<wchar_t>(ch + (L'a' - L'A')) : ch;
+    const wchar_t expected_upper = (ch >= L'a' && ch <= L'z') ? static_cast<wchar_t>(ch - (L'a' - L'A')) : ch;
+    if (lower[0] != expected_lower || upper[0] != expected_upper) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsAscii(const std::string& s) {
+  return utf8_util::is_ascii(s.data(), s.size());
+}
+
+// changes the case of the ASCII string s in place, without branches so the compiler vectorizes the loop
+void ChangeAsciiCase(StringNormalizer::CaseAction caseaction, std::string& s) {
+  assert(caseaction != StringNormalizer::NONE);
+  const char first = caseaction == StringNormalizer::LOWER ? 'A' : 'a';
+  for (auto& ch : s) {
+    ch ^= static_cast<char>((static_cast<unsigned char>(ch - first) < 26) << 5);
+  }
+}
+
 template <class ForwardIter>
 Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
                       const Locale& loc,
                       std::wstring_convert<std::codecvt_utf8<wchar_t>>& converter,
                       size_t N, size_t C,
-                      StringNormalizer::CaseAction caseaction) {
+                      StringNormalizer::CaseAction caseaction,
+                      bool ascii_case_change) {
   std::vector<int64_t> output_dims;
   if (N == 1) {
     output_dims.push_back(1);
@@ -132,7 +164,12 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
   size_t output_idx = 0;
   while (first != end) {
     auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
+    if ((caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) &&
+        ascii_case_change && IsAscii(s)) {
+      std::string& output = *(output_data + output_idx);
+      output = static_cast<const std::string&>(s);
+      ChangeAsciiCase(caseaction, output);
+    } else if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
       std::wstring wstr = converter.from_bytes(s);
       if (wstr == wconv_error) {
         return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
@@ -158,7 +195,8 @@ using namespace string_normalizer;
 StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
                                                                is_case_sensitive_(true),
                                                                casechangeaction_(NONE),
-                                                               compare_caseaction_(NONE) {
+                                                               compare_caseaction_(NONE),
+                                                               ascii_case_change_(false) {
   int64_t iscasesensitive = 0;
   Status status = info.GetAttr("is_case_sensitive", &iscasesensitive);
   ORT_ENFORCE(status.IsOK(), "attribute is_case_sensitive is not set");
@@ -183,7 +221,9 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
   }
 
   locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
+  locale_ = std::make_unique<Locale>(locale_name_);
+  const Locale& locale = *locale_;
+  ascii_case_change_ = IsAsciiCaseChange(locale);
   std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
 
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
@@ -198,10 +238,15 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
       locale.ChangeCase(compare_caseaction_, wstr);
       auto p = wstopwords_.insert(wstr);
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
+      cased_stopwords_.insert(converter.to_bytes(wstr));
     }
   }
 }
 
+// Make Locale definition available for destruction
+StringNormalizer::~StringNormalizer() {
+}
+
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   using namespace string_normalizer;
 
@@ -230,7 +275,7 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   }
 
   Status status;
-  Locale locale(locale_name_);
+  const Locale& locale = *locale_;
   std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
   auto const input_data = X->template Data<std::string>();
   using StrRef = std::reference_wrapper<const std::string>;
@@ -248,10 +293,11 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
         ++first;
       }
       status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
-                              N, filtered_strings.size(), casechangeaction_);
+                              N, filtered_strings.size(), casechangeaction_, ascii_case_change_);
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, casechangeaction_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, casechangeaction_,
+                              ascii_case_change_);
     }
   } else {
     if (!wstopwords_.empty()) {
@@ -266,6 +312,19 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
       auto const last = input_data + C;
       while (first != last) {
         const std::string& s = *first;
+        if (ascii_case_change_ && IsAscii(s)) {
+          std::string cased(s);
+          ChangeAsciiCase(compare_caseaction_, cased);
+          if (0 == cased_stopwords_.count(cased)) {
+            if (casechangeaction_ == NONE) {
+              filtered_orignal_strings.push_back(std::cref(s));
+            } else {
+              filtered_cased_strings.push_back(std::move(cased));
+            }
+          }
+          ++first;
+          continue;
+        }
         std::wstring wstr = converter.from_bytes(s);
         if (wstr == wconv_error) {
           return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
@@ -283,14 +342,15 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
       }
       if (casechangeaction_ == NONE) {
         status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
+                                N, filtered_orignal_strings.size(), NONE, ascii_case_change_);
       } else {
         status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
+                                N, filtered_cased_strings.size(), NONE, ascii_case_change_);
       }
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, casechangeaction_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, casechangeaction_,
+                              ascii_case_change_);
     }
   }
   return status;
@@ -6,12 +6,17 @@
 #include "core/framework/op_kernel.h"
 
 #include <locale>
+#include <memory>
 #include <string>
 #include <unordered_set>
 
 namespace onnxruntime {
 namespace contrib {
 
+namespace string_normalizer {
+class Locale;
+}  // namespace string_normalizer
+
 class StringNormalizer : public OpKernel {
  public:
   enum CaseAction {
@@ -21,7 +26,7 @@ class StringNormalizer : public OpKernel {
   };
 
   explicit StringNormalizer(const OpKernelInfo& info);
-  ~StringNormalizer() = default;
+  ~StringNormalizer();
 
   Status Compute(OpKernelContext* ctx) const override;
 
@@ -30,9 +35,16 @@ class StringNormalizer : public OpKernel {
   CaseAction casechangeaction_;
   CaseAction compare_caseaction_;  // used for case-insensitive compare
   std::string locale_name_;
+  // created once, as creating a locale is expensive
+  std::unique_ptr<string_normalizer::Locale> locale_;
+  // whether the locale changes the case of ASCII chars to ASCII chars as the C locale does, so ASCII
+  // strings can change case without a conversion to wide chars
+  bool ascii_case_change_;
   // Either if these are populated but not both
   std::unordered_set<std::string> stopwords_;
   std::unordered_set<std::wstring> wstopwords_;
+  // wstopwords_ back in utf8, for the ASCII strings that change case without a conversion
+  std::unordered_set<std::string> cased_stopwords_;
 };
 
 }  // namespace contrib
@@ -7,9 +7,14 @@
 #include "core/framework/tensor.h"
 
 #include "core/common/utf8_util.h"
+#include "core/platform/ort_mutex.h"
 
+#include <algorithm>
 #include <codecvt>
+#include <cstdint>
+#include <cstring>
 #include <locale>
+#include <set>
 
 namespace onnxruntime {
 namespace contrib {
@@ -188,12 +193,134 @@ struct SearchValue {
   }
 };
 
+struct Match {
+  int priority_;
+  size_t offset_;
+  size_t size_;
+  // create a conflict for overlapping matches
+  // thus if they overlap neither is less than the other
+  // and they are considered equal
+  bool operator<(const Match& o) const {
+    return (offset_ + size_) <= o.offset_;
+  }
+};
+
+// A token as a range of chars of the string it is in
+struct Token {
+  size_t offset_;
+  size_t size_;
+};
+
+// Appends the tokens of str between the matches of the separators in tst
+template <class CharT>
+void FindTokens(const TernarySearchTree<CharT, SearchValue>& tst, const CharT* str, size_t len,
+                size_t mincharnum, std::vector<Token>& tokens) {
+  std::set<Match> matches;
+  const CharT* s = str;
+  size_t len_remaining = len;
+  size_t offset = 0;
+  while (len_remaining > 0) {
+    const auto* val = tst.get(s, len_remaining);
+    if (val != nullptr) {
+      auto p = matches.insert({val->priority_, offset, val->w_len});
+      while (!p.second && val->priority_ < p.first->priority_) {
+        // if overlapping matches of the same pattern(priority), then
+        // the earlier match naturally wins
+        matches.erase(p.first);
+        p = matches.insert({val->priority_, offset, val->w_len});
+      }
+    }
+    ++s;
+    ++offset;
+    --len_remaining;
+  }
+
+  offset = 0;
+  for (const auto& m : matches) {
+    assert(m.offset_ >= offset);
+    size_t sz = (m.offset_ - offset);
+    if (sz > 0 && sz >= mincharnum) {
+      tokens.push_back({offset, sz});
+    }
+    offset = m.offset_ + m.size_;
+  }
+  assert(offset <= len);
+  if (offset < len) {
+    tokens.push_back({offset, len - offset});
+  }
+}
+
+const uint64_t kLowBytes = 0x0101010101010101ULL;
+const uint64_t kHighBits = 0x8080808080808080ULL;
+
+// Separators that are checked for 8 bytes at a time
+const size_t kMaxWordSeparators = 8;
+
+// Appends the tokens of the ASCII string s between the single char separators,
+// and returns false if s isn't ASCII. Words of 8 bytes that contain none of the
+// separators are skipped without looking at their bytes.
+bool FindCharSeparatorTokens(const std::vector<char>& separators, const bool* is_separator,
+                             const std::string& s, size_t mincharnum, std::vector<Token>& tokens) {
+  const char* data = s.data();
+  const size_t len = s.size();
+  size_t offset = 0;
+  auto check_char = [&](size_t idx) {
+    if (is_separator[static_cast<unsigned char>(data[idx])]) {
+      const size_t sz = idx - offset;
+      if (sz > 0 && sz >= mincharnum) {
+        tokens.push_back({offset, sz});
+      }
+      offset = idx + 1;
+    }
+  };
+
+  size_t idx = 0;
+  for (; idx + sizeof(uint64_t) <= len; idx += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + idx, sizeof(word));
+    if ((word & kHighBits) != 0) {
+      return false;
+    }
+    bool has_separator = separators.size() > kMaxWordSeparators;
+    for (size_t i = 0; i < separators.size() && !has_separator; ++i) {
+      // a zero byte where the word has the separator
+      const uint64_t x = word ^ (kLowBytes * static_cast<unsigned char>(separators[i]));
+      has_separator = ((x - kLowBytes) & ~x & kHighBits) != 0;
+    }
+    if (has_separator) {
+      for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+        check_char(idx + i);
+      }
+    }
+  }
+  for (; idx < len; ++idx) {
+    if (static_cast<unsigned char>(data[idx]) >= 0x80) {
+      return false;
+    }
+    check_char(idx);
+  }
+  if (offset < len) {
+    tokens.push_back({offset, len - offset});
+  }
+  return true;
+}
+
+// the number of input bytes the rows of each range of a parallel tokenization hold at least
+constexpr int64_t kMinTokenizeBytesPerRange = 8 * 1024;
+
 }  // namespace tokenizer_details
 
 using namespace tokenizer_details;
 
 struct Tokenizer::SearchData {
   TernarySearchTree<wchar_t, SearchValue> tst_;
+  // When all separators are ASCII, ASCII strings are searched for them byte by byte
+  // without a conversion to wide chars, and when they are all single chars, the
+  // strings are scanned for them without a search tree.
+  bool ascii_separators_ = true;
+  TernarySearchTree<char, SearchValue> ascii_tst_;
+  std::vector<char> separator_chars_;
+  bool is_separator_char_[128] = {};
 };
 
 Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
@@ -231,8 +358,20 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
       ORT_ENFORCE(wsep != wconv_error, "Separator strings contains invalid utf8 chars");
       bool result = sd->tst_.put(wsep.c_str(), wsep.length(), {wsep.length(), priority});
       ORT_ENFORCE(result, "duplicate separator detected");
+      if (sd->ascii_separators_ && utf8_util::is_ascii(sep.data(), sep.size())) {
+        sd->ascii_tst_.put(sep.data(), sep.size(), {sep.size(), priority});
+      } else {
+        sd->ascii_separators_ = false;
+      }
       ++priority;
     }
+    if (sd->ascii_separators_ &&
+        std::all_of(separators.cbegin(), separators.cend(), [](const std::string& sep) { return sep.size() == 1; })) {
+      for (const auto& sep : separators) {
+        sd->separator_chars_.push_back(sep[0]);
+        sd->is_separator_char_[static_cast<unsigned char>(sep[0])] = true;
+      }
+    }
     search_data_.swap(sd);
   }
 }
@@ -295,7 +434,7 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
       assert(result);
       (void)result;
       assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
+      (output_data + output_index)->assign(s.data() + token_idx, tlen);
       ++output_index;
       token_idx += tlen;
       ++tokens;
@@ -319,82 +458,92 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
 Status Tokenizer::SeparatorTokenize(OpKernelContext* ctx,
                                     size_t N, size_t C,
                                     const std::vector<int64_t>& input_dims) const {
-  struct Match {
-    int priority_;
-    size_t offset_;
-    size_t size_;
-    // create a conflict for overlapping matches
-    // thus if they overlap neither is less than the other
-    // and they are considered equal
-    bool operator<(const Match& o) const {
-      return (offset_ + size_) <= o.offset_;
-    }
-  };
-
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
-  // Scan all strings and attempt to find separators in them
-  // collect all the output tokens here
-  size_t max_tokens = 0;
-  std::vector<std::vector<std::wstring>> tokenized_strings;
-  tokenized_strings.reserve(N * C);
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    std::wstring wstr = converter.from_bytes(s);
-    if (wstr == wconv_error) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Invalid utf8 chars in the input: " + s);
-    }
+  const size_t num_rows = N * C;
+  const SearchData& sd = *search_data_;
+  const size_t mincharnum = static_cast<size_t>(mincharnum_);
 
-    std::set<Match> matches;
-    const wchar_t* ws = wstr.c_str();
-    size_t len_remaining = wstr.length();
-    size_t offset = 0;
-    while (len_remaining > 0) {
-      const auto* val = search_data_->tst_.get(ws, len_remaining);
-      if (val != nullptr) {
-        auto p = matches.insert({val->priority_, offset, val->w_len});
-        while (!p.second && val->priority_ < p.first->priority_) {
-          // if overlapping matches of the same pattern(priority), then
-          // the earlier match naturally wins
-          matches.erase(p.first);
-          p = matches.insert({val->priority_, offset, val->w_len});
-        }
+  // Scan all strings and attempt to find separators in them
+  // collect all the output tokens here as byte ranges of the input strings,
+  // so they are copied once, straight into the output
+  std::vector<std::vector<Token>> row_tokens(num_rows);
+  auto tokenize_rows = [&](size_t begin, size_t end) -> Status {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
+    // the byte offset in the input string of every wide char, and of its end
+    std::vector<size_t> byte_offsets;
+    for (size_t row = begin; row < end; ++row) {
+      const auto& s = input_data[row];
+      auto& tokens = row_tokens[row];
+      if (!sd.separator_chars_.empty() &&
+          FindCharSeparatorTokens(sd.separator_chars_, sd.is_separator_char_, s, mincharnum, tokens)) {
+        continue;
+      }
+      tokens.clear();
+      if (sd.ascii_separators_ && utf8_util::is_ascii(s.data(), s.size())) {
+        // bytes are chars
+        FindTokens(sd.ascii_tst_, s.data(), s.size(), mincharnum, tokens);
+        continue;
       }
-      ++ws;
-      ++offset;
-      --len_remaining;
-    }
 
-    // Tokenize
-    tokenized_strings.emplace_back();
-    auto& row_tokens = tokenized_strings.back();
-    row_tokens.reserve(matches.size() + 1);
-    ws = wstr.c_str();
-    offset = 0;
-    for (const auto& m : matches) {
-      assert(m.offset_ >= offset);
-      size_t sz = (m.offset_ - offset);
-      if (sz > 0 && sz >= size_t(mincharnum_)) {
-        row_tokens.emplace_back(ws, sz);
+      std::wstring wstr = converter.from_bytes(s);
+      if (wstr == wconv_error) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Invalid utf8 chars in the input: " + s);
+      }
+
+      // every utf8 char converts to one wide char
+      byte_offsets.resize(wstr.length() + 1);
+      size_t byte_offset = 0;
+      for (size_t i = 0; i < wstr.length(); ++i) {
+        byte_offsets[i] = byte_offset;
+        size_t char_bytes = 0;
+        bool result = utf8_bytes(static_cast<unsigned char>(s[byte_offset]), char_bytes);
+        assert(result);
+        (void)result;
+        byte_offset += char_bytes;
+      }
+      assert(byte_offset == s.size());
+      byte_offsets[wstr.length()] = byte_offset;
+
+      FindTokens(sd.tst_, wstr.c_str(), wstr.length(), mincharnum, tokens);
+      for (auto& token : tokens) {
+        const size_t token_end = byte_offsets[token.offset_ + token.size_];
+        token.offset_ = byte_offsets[token.offset_];
+        token.size_ = token_end - token.offset_;
       }
-      offset = m.offset_ + m.size_;
-      ws = wstr.c_str() + offset;
-    }
-    assert(offset <= wstr.length());
-    if (offset < wstr.length()) {
-      row_tokens.emplace_back(ws, wstr.length() - offset);
     }
+    return Status::OK();
+  };
 
-    size_t tokens = row_tokens.size();
-    if (mark_) {
-      tokens += 2;  // Start/end markers as separate tokens
+  // Rows are split between the threads of the intra-op thread pool
+  // when there is enough text to make it worthwhile
+  size_t total_bytes = 0;
+  for (size_t row = 0; row < num_rows; ++row) {
+    total_bytes += input_data[row].size();
+  }
+  const int64_t rows = static_cast<int64_t>(num_rows);
+  const int64_t min_rows = std::max<int64_t>(
+      1, rows * kMinTokenizeBytesPerRange / std::max<int64_t>(1, static_cast<int64_t>(total_bytes)));
+  // the error of the first invalid row, as without threads
+  Status status;
+  int64_t status_row = rows;
+  OrtMutex status_mutex;
+  ctx->ParallelFor(rows, min_rows, [&](int64_t begin, int64_t end) {
+    Status range_status = tokenize_rows(static_cast<size_t>(begin), static_cast<size_t>(end));
+    if (!range_status.IsOK()) {
+      std::lock_guard<OrtMutex> lock(status_mutex);
+      if (begin < status_row) {
+        status_row = begin;
+        status = range_status;
+      }
     }
-    max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
+  });
+  ORT_RETURN_IF_ERROR(status);
+
+  size_t max_tokens = 0;
+  for (const auto& tokens : row_tokens) {
+    max_tokens = std::max(max_tokens, tokens.size() + mark_ * 2);
   }
 
   std::vector<int64_t> output_dims(input_dims);
@@ -413,37 +562,35 @@ Status Tokenizer::SeparatorTokenize(OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
 
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  for (auto& row : tokenized_strings) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (auto& token : row) {
-      *(output_data + output_index) = converter.to_bytes(token);
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+  auto output_rows = [&](size_t begin, size_t end) {
+    for (size_t row = begin; row < end; ++row) {
+      const auto& s = input_data[row];
+      const auto& tokens = row_tokens[row];
+      size_t output_index = row * max_tokens;
+      if (mark_) {
+        (output_data + output_index)->assign(&start_text, 1);
+        ++output_index;
+      }
+      // Output tokens for this row
+      for (const auto& token : tokens) {
+        (output_data + output_index)->assign(s.data() + token.offset_, token.size_);
+        ++output_index;
+      }
+      if (mark_) {
+        (output_data + output_index)->assign(&end_text, 1);
+        ++output_index;
+      }
+      const size_t pads = max_tokens - (mark_ * 2) - tokens.size();
+      for (size_t p = 0; p < pads; ++p) {
+        *(output_data + output_index) = pad_value_;
+        ++output_index;
+      }
+      assert(output_index == (row + 1) * max_tokens);
     }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-  }
+  };
+  ctx->ParallelFor(rows, min_rows, [&output_rows](int64_t begin, int64_t end) {
+    output_rows(static_cast<size_t>(begin), static_cast<size_t>(end));
+  });
   return Status::OK();
 }
 
@@ -10,6 +10,11 @@
 namespace onnxruntime {
 namespace contrib {
 
+namespace {
+// the number of convolution values the words of each range of a parallel max pool cover at least
+constexpr int64_t kMinPooledValuesPerRange = 16 * 1024;
+}  // namespace
+
 void WordConvEmbedding::CharEmbeddingLookup(
     const int* seq_ptr,
     const float* char_embedding_weight_p,
@@ -33,6 +38,7 @@ void WordConvEmbedding::CharEmbeddingLookup(
 
 //input : [sequence_length, word_length, char_embedding_size]
 void WordConvEmbedding::ComputeConvMaxPoolWithActivation(
+    const OpKernelContext* context,
     AllocatorPtr allocator,
     const float* input,
     const float* weights,
@@ -44,62 +50,58 @@ void WordConvEmbedding::ComputeConvMaxPoolWithActivation(
     int64_t filter_width,
     int64_t num_filters,
     float* output) const {
-  int64_t input_word_size = word_len * char_embedding_size;
   int64_t unfolded_width = word_len - filter_width + 1;
   int64_t unfolded_kernal_size = filter_width * char_embedding_size;
-  int64_t unfolded_segment_size = unfolded_width * unfolded_kernal_size;
-  int64_t conv_res_segment_size = unfolded_width * num_filters;
-  int64_t memcpy_size = unfolded_kernal_size * sizeof(float);
-
-  auto input_unfolded_buffer_p = IAllocator::MakeUniquePtr<float>(allocator, seq_len * unfolded_segment_size);
-  auto conv_result_p = IAllocator::MakeUniquePtr<float>(allocator, seq_len * conv_res_segment_size);
-  auto conv_activation_result_p = IAllocator::MakeUniquePtr<float>(allocator, seq_len * conv_res_segment_size);
-
-  for (int64_t word_inx = 0; word_inx < seq_len; word_inx++) {
-    if (words_len_ptr[word_inx] <= 0) continue;
-
-    const float* current_word_input = input + word_inx * input_word_size;
-    float* current_word_unfolded_buffer_p = input_unfolded_buffer_p.get() + word_inx * unfolded_segment_size;
-    float* conv_buf_p = conv_result_p.get() + word_inx * conv_res_segment_size;
-    float* pactivationbuf = conv_activation_result_p.get() + word_inx * conv_res_segment_size;
-    float* pres = output + word_inx * num_filters;
-
-    // Unfolding from pin to pufbuf.
-    float* tmp_unfolded_buffer_ptr = current_word_unfolded_buffer_p;
-    for (int64_t unfolded_inx = 0; unfolded_inx < unfolded_width; unfolded_inx++) {
-      memcpy(tmp_unfolded_buffer_ptr, current_word_input, memcpy_size);
-      current_word_input += char_embedding_size;
-      tmp_unfolded_buffer_ptr += unfolded_kernal_size;
-    }
 
-    math::GemmEx<float, CPUMathUtil>(
-        CblasNoTrans, CblasTrans,
-        static_cast<int>(unfolded_width), static_cast<int>(num_filters), static_cast<int>(unfolded_kernal_size), 1.0f,
-        current_word_unfolded_buffer_p, static_cast<int>(unfolded_kernal_size),
-        weights, static_cast<int>(unfolded_kernal_size), 0.0f,
-        conv_buf_p, static_cast<int>(num_filters), &CPUMathUtil::Instance());
+  // The windows of the convolution are the rows of filter_width * char_embedding_size floats starting at every
+  // char of the input, which overlap, so the input is read in place as a matrix of leading dimension
+  // char_embedding_size instead of being unfolded. One GEMM convolves all the words, the windows that span
+  // two words are computed and ignored.
+  int64_t conv_rows = seq_len * word_len - filter_width + 1;
+  IAllocatorUniquePtr<float> conv_result_p;
+  if (unfolded_width > 0) {
+    conv_result_p = IAllocator::MakeUniquePtr<float>(allocator, conv_rows * num_filters);
+    MlasSgemm(CblasNoTrans, CblasTrans,
+              static_cast<size_t>(conv_rows), static_cast<size_t>(num_filters),
+              static_cast<size_t>(unfolded_kernal_size), 1.0f,
+              input, static_cast<size_t>(char_embedding_size),
+              weights, static_cast<size_t>(unfolded_kernal_size), 0.0f,
+              conv_result_p.get(), static_cast<size_t>(num_filters));
+  }
+
+  // tanh is increasing and the bias is the same for every window of a filter, so the max pooling is done on the
+  // convolution, and only the pooled values are biased and activated
+  auto pool_words = [&](int64_t begin, int64_t end) {
+    for (int64_t word_inx = begin; word_inx < end; word_inx++) {
+      if (words_len_ptr[word_inx] <= 0) continue;
 
-    for (int64_t unfolded_inx = 0; unfolded_inx < unfolded_width; unfolded_inx++)
+      float* pres = output + word_inx * num_filters;
       for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
-        conv_buf_p[unfolded_inx * num_filters + filter_inx] += bias[filter_inx];
+        pres[filter_inx] = -1.0f * 1e12f;
+      }
+      if (unfolded_width <= 0) continue;
+
+      const float* conv_buf_p = conv_result_p.get() + word_inx * word_len * num_filters;
+      for (int64_t unfolded_inx = 0; unfolded_inx < unfolded_width; unfolded_inx++) {
+        if (unfolded_inx > 0 && unfolded_inx > (words_len_ptr[word_inx] - filter_width)) break;
+        const float* pcur = conv_buf_p + unfolded_inx * num_filters;
+        for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
+          pres[filter_inx] = std::max(pcur[filter_inx], pres[filter_inx]);
+        }
       }
 
-    MlasComputeTanh(conv_buf_p, pactivationbuf, unfolded_width * num_filters);
-
-    // Max pooling.
-    for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
-      pres[filter_inx] = -1.0f * 1e12f;
-    }
-
-    for (int64_t unfolded_inx = 0; unfolded_inx < unfolded_width; unfolded_inx++) {
-      if (unfolded_inx > 0 && unfolded_inx > (words_len_ptr[word_inx] - filter_width)) break;
-      float* pcur = pactivationbuf + unfolded_inx * num_filters;
       for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
-        pres[filter_inx] = std::max(pcur[filter_inx], pres[filter_inx]);
+        pres[filter_inx] += bias[filter_inx];
       }
+      MlasComputeTanh(pres, pres, static_cast<size_t>(num_filters));
     }
-  }
+  };
+
+  // the words are split between the threads of the intra-op thread pool when there are enough
+  const int64_t values_per_word = std::max<int64_t>(1, word_len * num_filters);
+  context->ParallelFor(seq_len, std::max<int64_t>(1, kMinPooledValuesPerRange / values_per_word), pool_words);
 }
+
 void WordConvEmbedding::CalculateLengthOfEachWordInSequence(
     const int* seq_ptr,
     int* words_len_ptr,
@@ -191,6 +193,7 @@ Status WordConvEmbedding::Compute(OpKernelContext* ctx) const {
                       chars_embeddings_ptr.get());
 
   ComputeConvMaxPoolWithActivation(
+      context,
       alloc,
       chars_embeddings_ptr.get(),
       w_conv.Data<float>(),
@@ -27,6 +27,7 @@ class WordConvEmbedding final : public OpKernel {
       const int* words_len_ptr,
       float* dst) const;
   void ComputeConvMaxPoolWithActivation(
+      const OpKernelContext* context,
       AllocatorPtr allocator,
       const float* input,
       const float* weights,
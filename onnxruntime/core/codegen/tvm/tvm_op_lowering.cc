@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/codegen/tvm/tvm_op_lowering.h"
+
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <topi/broadcast.h>
+#include <topi/elemwise.h>
+#include <topi/nn.h>
+#include <topi/reduction.h>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace tvm_codegen {
+
+namespace {
+
+using UnaryLowering = std::function<tvm::Tensor(const onnxruntime::Node&, const tvm::Tensor&)>;
+using BinaryLowering = std::function<tvm::Tensor(const tvm::Tensor&, const tvm::Tensor&)>;
+
+float GetFloatAttribute(const onnxruntime::Node& node, const std::string& name, float default_value) {
+  auto it = node.GetAttributes().find(name);
+  return it != node.GetAttributes().end() ? it->second.f() : default_value;
+}
+
+const std::unordered_map<std::string, UnaryLowering>& UnaryLowerings() {
+  static const std::unordered_map<std::string, UnaryLowering> lowerings{
+      {"Abs", [](const onnxruntime::Node&, const tvm::Tensor& x) { return topi::abs(x); }},
+      {"Neg", [](const onnxruntime::Node&, const tvm::Tensor& x) { return topi::negative(x); }},
+      {"Exp", [](const onnxruntime::Node&, const tvm::Tensor& x) { return topi::exp(x); }},
+      {"Log", [](const onnxruntime::Node&, const tvm::Tensor& x) { return topi::log(x); }},
+      {"Sqrt", [](const onnxruntime::Node&, const tvm::Tensor& x) { return topi::sqrt(x); }},
+      {"Sigmoid", [](const onnxruntime::Node&, const tvm::Tensor& x) { return topi::sigmoid(x); }},
+      {"Tanh", [](const onnxruntime::Node&, const tvm::Tensor& x) { return topi::tanh(x); }},
+      {"Identity", [](const onnxruntime::Node&, const tvm::Tensor& x) { return topi::identity(x); }},
+      {"Relu", [](const onnxruntime::Node&, const tvm::Tensor& x) { return topi::relu<float>(x); }},
+      {"LeakyRelu", [](const onnxruntime::Node& node, const tvm::Tensor& x) {
+         return topi::leaky_relu(x, GetFloatAttribute(node, "alpha", 0.01f));
+       }},
+      {"Clip", [](const onnxruntime::Node& node, const tvm::Tensor& x) {
+         const float min = GetFloatAttribute(node, "min", std::numeric_limits<float>::lowest());
+         const float max = GetFloatAttribute(node, "max", std::numeric_limits<float>::max());
+         return topi::clip(x, tvm::make_const(x->dtype, min), tvm::make_const(x->dtype, max));
+       }},
+      {"Reciprocal", [](const onnxruntime::Node&, const tvm::Tensor& x) {
+         return tvm::compute(x->shape, [&x](const tvm::Array<tvm::Var>& i) {
+           return tvm::make_const(x->dtype, 1) / x(i);
+         });
+       }},
+  };
+  return lowerings;
+}
+
+const std::unordered_map<std::string, BinaryLowering>& BinaryLowerings() {
+  static const std::unordered_map<std::string, BinaryLowering> lowerings{
+      {"Add", [](const tvm::Tensor& a, const tvm::Tensor& b) { return topi::add(a, b); }},
+      {"Sub", [](const tvm::Tensor& a, const tvm::Tensor& b) { return topi::subtract(a, b); }},
+      {"Mul", [](const tvm::Tensor& a, const tvm::Tensor& b) { return topi::multiply(a, b); }},
+      {"Div", [](const tvm::Tensor& a, const tvm::Tensor& b) { return topi::divide(a, b); }},
+      {"Pow", [](const tvm::Tensor& a, const tvm::Tensor& b) { return topi::power(a, b); }},
+      // Max and Min of two inputs
+      {"Max", [](const tvm::Tensor& a, const tvm::Tensor& b) { return topi::maximum(a, b); }},
+      {"Min", [](const tvm::Tensor& a, const tvm::Tensor& b) { return topi::minimum(a, b); }},
+  };
+  return lowerings;
+}
+
+bool IsReduction(const std::string& op_type) {
+  return op_type == "ReduceSum" || op_type == "ReduceMean" || op_type == "ReduceMax" || op_type == "ReduceMin";
+}
+
+tvm::Tensor LowerReduction(const onnxruntime::Node& node, const tvm::Tensor& x) {
+  const auto& attributes = node.GetAttributes();
+  auto keepdims_attr = attributes.find("keepdims");
+  const bool keepdims = keepdims_attr == attributes.end() || keepdims_attr->second.i() != 0;
+
+  // all the axes if there are none
+  const int64_t rank = static_cast<int64_t>(x->shape.size());
+  std::vector<int64_t> axis_values;
+  auto axes_attr = attributes.find("axes");
+  if (axes_attr != attributes.end() && axes_attr->second.ints_size() > 0) {
+    for (auto axis : axes_attr->second.ints()) {
+      axis_values.push_back(axis < 0 ? axis + rank : axis);
+    }
+  } else {
+    for (int64_t axis = 0; axis < rank; axis++) {
+      axis_values.push_back(axis);
+    }
+  }
+  tvm::Array<tvm::Expr> axes;
+  for (auto axis : axis_values) {
+    ORT_ENFORCE(axis >= 0 && axis < rank, "Invalid axis ", axis, " of ", node.OpType());
+    axes.push_back(tvm::make_const(tvm::Int(32), axis));
+  }
+
+  const std::string& op_type = node.OpType();
+  if (op_type == "ReduceMax") {
+    return topi::max(x, axes, keepdims);
+  }
+  if (op_type == "ReduceMin") {
+    return topi::min(x, axes, keepdims);
+  }
+  tvm::Tensor sum = topi::sum(x, axes, keepdims);
+  if (op_type == "ReduceSum") {
+    return sum;
+  }
+  tvm::Expr count = tvm::make_const(x->dtype, 1);
+  for (auto axis : axis_values) {
+    count = count * tvm::cast(x->dtype, x->shape[static_cast<size_t>(axis)]);
+  }
+  return topi::divide(sum, count);
+}
+
+}  // namespace
+
+bool CanLowerToTVM(const onnxruntime::Node& node) {
+  if (node.Domain() != kOnnxDomain && node.Domain() != kOnnxDomainAlias) {
+    return false;
+  }
+  const std::string& op_type = node.OpType();
+  const size_t num_inputs = node.InputDefs().size();
+  if (UnaryLowerings().count(op_type) != 0 || IsReduction(op_type)) {
+    return num_inputs == 1;
+  }
+  return BinaryLowerings().count(op_type) != 0 && num_inputs == 2;
+}
+
+bool IsReductionNode(const onnxruntime::Node& node) {
+  return IsReduction(node.OpType());
+}
+
+tvm::Tensor LowerToTVM(const onnxruntime::Node& node, const std::vector<tvm::Tensor>& inputs) {
+  const std::string& op_type = node.OpType();
+  auto unary = UnaryLowerings().find(op_type);
+  if (unary != UnaryLowerings().end()) {
+    ORT_ENFORCE(inputs.size() == 1, op_type, " takes one input.");
+    return unary->second(node, inputs[0]);
+  }
+  if (IsReduction(op_type)) {
+    ORT_ENFORCE(inputs.size() == 1, op_type, " takes one input.");
+    return LowerReduction(node, inputs[0]);
+  }
+  auto binary = BinaryLowerings().find(op_type);
+  ORT_ENFORCE(binary != BinaryLowerings().end(), op_type, " can't be lowered to TVM.");
+  ORT_ENFORCE(inputs.size() == 2, op_type, " takes two inputs.");
+  return binary->second(inputs[0], inputs[1]);
+}
+
+}  // namespace tvm_codegen
+}  // namespace onnxruntime
@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <tvm/tvm.h>
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+namespace tvm_codegen {
+
+// Whether LowerToTVM computes the node, which is an elementwise operator, broadcasting its inputs as numpy does, or
+// a reduction. The types and the shapes of its inputs are left to the caller to check.
+bool CanLowerToTVM(const onnxruntime::Node& node);
+
+// Whether the node reduces its input, so that its tensor expression isn't inlined into its consumers.
+bool IsReductionNode(const onnxruntime::Node& node);
+
+// The tensor expression of the output of the node, computed on the tensor expressions of its inputs.
+tvm::Tensor LowerToTVM(const onnxruntime::Node& node, const std::vector<tvm::Tensor>& inputs);
+
+}  // namespace tvm_codegen
+}  // namespace onnxruntime
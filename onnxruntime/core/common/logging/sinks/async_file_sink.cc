@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/logging/sinks/async_file_sink.h"
+
+#include <mutex>
+
+#include "core/common/logging/sinks/ostream_sink.h"
+
+namespace onnxruntime {
+namespace logging {
+
+AsyncFileSink::AsyncFileSink(const std::string& filename, bool append, bool filter_user_data,
+                             size_t max_buffered_messages)
+    : file_{filename, std::ios::out | (append ? std::ios::app : std::ios::trunc)},
+      filter_user_data_{filter_user_data},
+      max_buffered_messages_{max_buffered_messages},
+      writer_{&AsyncFileSink::WriteMessages, this} {
+}
+
+AsyncFileSink::~AsyncFileSink() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    stop_ = true;
+  }
+  messages_available_.notify_one();
+  writer_.join();
+}
+
+void AsyncFileSink::SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) {
+  if (filter_user_data_ && message.DataType() == DataType::USER) {
+    return;
+  }
+
+  // the message is formatted by the logging thread, as the capture doesn't outlive the call
+  std::string line = FormatLogLine(timestamp, logger_id, message);
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (messages_.size() < max_buffered_messages_) {
+      messages_.push_back(std::move(line));
+    } else {
+      ++dropped_messages_;
+    }
+  }
+  messages_available_.notify_one();
+}
+
+void AsyncFileSink::WriteMessages() {
+  std::vector<std::string> messages;
+  for (;;) {
+    size_t dropped_messages;
+    bool stop;
+    {
+      std::unique_lock<OrtMutex> lock(mutex_);
+      messages_available_.wait(lock, [this]() { return stop_ || !messages_.empty() || dropped_messages_ != 0; });
+      // the buffers are swapped so that the loggers append to the one written last time, which is already allocated
+      messages.swap(messages_);
+      dropped_messages = dropped_messages_;
+      dropped_messages_ = 0;
+      stop = stop_;
+    }
+
+    for (const auto& message : messages) {
+      file_ << message << "\n";
+    }
+    if (dropped_messages != 0) {
+      file_ << dropped_messages << " log messages were dropped as they were logged faster than written.\n";
+    }
+    file_.flush();
+    messages.clear();
+
+    if (stop) {
+      break;
+    }
+  }
+}
+
+}  // namespace logging
+}  // namespace onnxruntime
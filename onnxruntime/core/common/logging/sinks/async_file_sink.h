@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/logging/capture.h"
+#include "core/common/logging/isink.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace logging {
+/// <summary>
+/// ISink that writes to a file from a thread of its own, so that the threads logging never wait for the file.
+/// </summary>
+/// <seealso cref="ISink" />
+class AsyncFileSink : public ISink {
+ public:
+  /// <summary>
+  /// Initializes a new instance of the <see cref="AsyncFileSink" /> class.
+  /// </summary>
+  /// <param name="filename">The filename to write to.</param>
+  /// <param name="append">If set to <c>true</c> [append to file]. Otherwise truncate.</param>
+  /// <param name="filter_user_data">If set to <c>true</c> [removes user data].</param>
+  /// <param name="max_buffered_messages">The number of messages waiting to be written above which further messages
+  /// are dropped rather than buffered, until the file catches up. A line in the file counts the dropped messages.
+  /// </param>
+  AsyncFileSink(const std::string& filename, bool append, bool filter_user_data,
+                size_t max_buffered_messages = 16384);
+
+  /// <summary>
+  /// Writes the buffered messages and stops the thread writing them.
+  /// </summary>
+  ~AsyncFileSink() override;
+
+ private:
+  void SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) override;
+
+  void WriteMessages();
+
+  std::ofstream file_;
+  const bool filter_user_data_;
+  const size_t max_buffered_messages_;
+
+  OrtMutex mutex_;
+  OrtCondVar messages_available_;
+  std::vector<std::string> messages_;
+  size_t dropped_messages_ = 0;
+  bool stop_ = false;
+
+  std::thread writer_;
+};
+}  // namespace logging
+}  // namespace onnxruntime
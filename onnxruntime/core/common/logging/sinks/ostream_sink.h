@@ -12,6 +12,11 @@
 
 namespace onnxruntime {
 namespace logging {
+/// <summary>
+/// Formats a message as the line the sinks write, without the trailing new line.
+/// </summary>
+std::string FormatLogLine(const Timestamp& timestamp, const std::string& logger_id, const Capture& message);
+
 /// <summary>
 /// A std::ostream based ISink
 /// </summary>
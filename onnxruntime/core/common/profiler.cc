@@ -3,10 +3,48 @@
 
 #include "profiler.h"
 
+#include <array>
+
 namespace onnxruntime {
 namespace profiling {
 using namespace std::chrono;
 
+constexpr size_t Profiler::max_num_events_;
+constexpr size_t Profiler::max_num_event_args_;
+
+static std::atomic<uint64_t> next_profiler_id{1};
+
+Profiler::Profiler() noexcept : id_(next_profiler_id++) {}
+
+uint32_t Profiler::ThreadEventBuffer::Intern(const std::string& name) {
+  auto entry = name_ids.find(name);
+  if (entry != name_ids.end()) {
+    return entry->second;
+  }
+
+  auto id = static_cast<uint32_t>(names.size());
+  names.push_back(&name_ids.emplace(name, id).first->first);
+  return id;
+}
+
+Profiler::ThreadEventBuffer& Profiler::GetThreadEventBuffer() {
+  // the buffer of the profiler this thread recorded to last
+  static thread_local std::pair<uint64_t, ThreadEventBuffer*> cached_buffer{0, nullptr};
+  if (cached_buffer.first == id_) {
+    return *cached_buffer.second;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& buffer = thread_buffers_[std::this_thread::get_id()];
+  if (buffer == nullptr) {
+    buffer = std::make_unique<ThreadEventBuffer>();
+    buffer->tid = logging::GetThreadId();
+  }
+
+  cached_buffer = {id_, buffer.get()};
+  return *buffer;
+}
+
 ::onnxruntime::TimePoint profiling::Profiler::StartTime() const {
   return std::chrono::high_resolution_clock::now();
 }
@@ -36,25 +74,89 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
                                      TimePoint& start_time,
                                      const std::initializer_list<std::pair<std::string, std::string>>& event_args,
                                      bool /*sync_gpu*/) {
-  long long dur = TimeDiffMicroSeconds(start_time);
+  //TODO: sync_gpu if needed. device work is timed by the executor with the IDeviceTimer of its provider.
+  RecordEvent(category, event_name, start_time, TimeDiffMicroSeconds(start_time), event_args);
+}
+
+void Profiler::EndTimeAndRecordCountedEvent(
+    EventCategory category,
+    const std::string& event_name,
+    TimePoint& start_time,
+    const HardwareCounterValues& hardware_events,
+    const std::initializer_list<std::pair<std::string, std::string>>& event_args) {
+  RecordEvent(category, event_name, start_time, TimeDiffMicroSeconds(start_time), &hardware_events, event_args);
+}
+
+void Profiler::RecordEvent(EventCategory category,
+                           const std::string& event_name,
+                           const TimePoint& start_time,
+                           long long duration_us,
+                           const std::initializer_list<std::pair<std::string, std::string>>& event_args) {
+  RecordEvent(category, event_name, start_time, duration_us, nullptr, event_args);
+}
+
+// the args the hardware events of an event are written to
+static const char* const hardware_event_names_[] = {"cycles", "instructions", "llc_misses", "dtlb_misses"};
+
+static std::array<uint64_t, 4> HardwareEventValues(const HardwareCounterValues& hardware_events) {
+  return {{hardware_events.cycles, hardware_events.instructions, hardware_events.llc_misses,
+           hardware_events.dtlb_misses}};
+}
+
+void Profiler::RecordEvent(EventCategory category,
+                           const std::string& event_name,
+                           const TimePoint& start_time,
+                           long long duration_us,
+                           const HardwareCounterValues* hardware_events,
+                           const std::initializer_list<std::pair<std::string, std::string>>& event_args) {
+  long long dur = duration_us;
   long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
 
-  EventRecord event(category, logging::GetProcessId(),
-                    logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
   if (profile_with_logger_) {
-    custom_logger_->SendProfileEvent(event);
-  } else {
-    //TODO: sync_gpu if needed.
-    std::lock_guard<OrtMutex> lock(mutex_);
-    if (events_.size() < max_num_events_) {
-      events_.emplace_back(event);
-    } else {
-      if (session_logger_ && !max_events_reached) {
-        LOGS(*session_logger_, ERROR)
-            << "Maximum number of events reached, could not record profile event.";
-        max_events_reached = true;
+    std::unordered_map<std::string, std::string> args{event_args.begin(), event_args.end()};
+    if (hardware_events != nullptr) {
+      const auto values = HardwareEventValues(*hardware_events);
+      for (size_t i = 0; i < values.size(); ++i) {
+        args[hardware_event_names_[i]] = std::to_string(values[i]);
       }
     }
+    EventRecord event(category, logging::GetProcessId(), logging::GetThreadId(), event_name, ts, dur,
+                      std::move(args));
+    custom_logger_->SendProfileEvent(event);
+    return;
+  }
+
+  auto& buffer = GetThreadEventBuffer();
+  std::lock_guard<OrtMutex> lock(buffer.mutex);
+
+  ThreadEvent event;
+  event.ts = ts;
+  event.dur = dur;
+  event.name = buffer.Intern(event_name);
+  event.num_args = 0;
+  for (const auto& event_arg : event_args) {
+    if (event.num_args == max_num_event_args_) break;
+    event.args[event.num_args][0] = buffer.Intern(event_arg.first);
+    event.args[event.num_args][1] = buffer.Intern(event_arg.second);
+    ++event.num_args;
+  }
+  event.cat = category;
+  // the counts are kept as numbers rather than interned, since they hardly repeat
+  event.has_hardware_events = hardware_events != nullptr;
+  if (event.has_hardware_events) {
+    event.hardware_events = *hardware_events;
+  }
+
+  if (buffer.events.size() < max_num_events_) {
+    buffer.events.push_back(event);
+    return;
+  }
+
+  buffer.events[buffer.next] = event;
+  buffer.next = (buffer.next + 1) % max_num_events_;
+  if (session_logger_ && !max_events_reached.exchange(true)) {
+    LOGS(*session_logger_, WARNING)
+        << "Maximum number of events of a thread reached, overwriting its oldest profile events.";
   }
 }
 
@@ -67,26 +169,62 @@ std::string Profiler::EndProfiling() {
     return std::string();
   }
   std::lock_guard<OrtMutex> lock(mutex_);
+
+  // the events of each thread from its oldest one
+  struct ThreadEvents {
+    ThreadEventBuffer* buffer;
+    std::unique_lock<OrtMutex> lock;
+    size_t num_written;
+  };
+  std::vector<ThreadEvents> threads;
+  size_t num_events = 0;
+  for (auto& entry : thread_buffers_) {
+    ThreadEventBuffer& buffer = *entry.second;
+    threads.push_back(ThreadEvents{&buffer, std::unique_lock<OrtMutex>(buffer.mutex), 0});
+    num_events += buffer.events.size();
+  }
+
+  const auto pid = logging::GetProcessId();
   profile_stream_ << "[\n";
 
-  for (size_t i = 0; i < events_.size(); ++i) {
-    auto& rec = events_[i];
+  // merge the events of the threads in the order they ended. each thread recorded its events in that order.
+  for (size_t i = 0; i < num_events; ++i) {
+    ThreadEvents* next_thread = nullptr;
+    const ThreadEvent* next_event = nullptr;
+    for (auto& thread : threads) {
+      const auto& events = thread.buffer->events;
+      if (thread.num_written == events.size()) continue;
+      const ThreadEvent& event = events[(thread.buffer->next + thread.num_written) % events.size()];
+      if (next_event == nullptr || event.ts + event.dur < next_event->ts + next_event->dur) {
+        next_thread = &thread;
+        next_event = &event;
+      }
+    }
+    ++next_thread->num_written;
+
+    const auto& rec = *next_event;
+    const auto& names = next_thread->buffer->names;
     profile_stream_ << R"({"cat" : ")" << event_categor_names_[rec.cat] << "\",";
-    profile_stream_ << "\"pid\" :" << rec.pid << ",";
-    profile_stream_ << "\"tid\" :" << rec.tid << ",";
+    profile_stream_ << "\"pid\" :" << pid << ",";
+    profile_stream_ << "\"tid\" :" << next_thread->buffer->tid << ",";
     profile_stream_ << "\"dur\" :" << rec.dur << ",";
     profile_stream_ << "\"ts\" :" << rec.ts << ",";
     profile_stream_ << R"("ph" : "X",)";
-    profile_stream_ << R"("name" :")" << rec.name << "\",";
+    profile_stream_ << R"("name" :")" << *names[rec.name] << "\",";
     profile_stream_ << "\"args\" : {";
-    bool is_first_arg = true;
-    for (std::pair<std::string, std::string> event_arg : rec.args) {
-      if (!is_first_arg) profile_stream_ << ",";
-      profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
-      is_first_arg = false;
+    for (uint32_t arg = 0; arg < rec.num_args; ++arg) {
+      if (arg != 0) profile_stream_ << ",";
+      profile_stream_ << "\"" << *names[rec.args[arg][0]] << "\" : \"" << *names[rec.args[arg][1]] << "\"";
+    }
+    if (rec.has_hardware_events) {
+      const auto values = HardwareEventValues(rec.hardware_events);
+      for (size_t arg = 0; arg < values.size(); ++arg) {
+        if (arg != 0 || rec.num_args != 0) profile_stream_ << ",";
+        profile_stream_ << "\"" << hardware_event_names_[arg] << "\" : " << values[arg];
+      }
     }
     profile_stream_ << "}";
-    if (i == events_.size() - 1) {
+    if (i == num_events - 1) {
       profile_stream_ << "}\n";
     } else {
       profile_stream_ << "},\n";
@@ -94,6 +232,14 @@ std::string Profiler::EndProfiling() {
   }
   profile_stream_ << "]\n";
   profile_stream_.close();
+
+  // the buffers are kept for the threads that cached them
+  for (auto& thread : threads) {
+    thread.buffer->events.clear();
+    thread.buffer->next = 0;
+    thread.buffer->name_ids.clear();
+    thread.buffer->names.clear();
+  }
   enabled_ = false;  // will not collect profile after writing.
   return profile_stream_file_;
 }
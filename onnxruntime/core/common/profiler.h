@@ -2,10 +2,17 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <thread>
 #include <tuple>
 #include <initializer_list>
+#include <unordered_map>
+#include <vector>
+#include "core/platform/hardware_counters.h"
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
 
@@ -16,12 +23,14 @@ namespace profiling {
 /**
  * Main class for profiling. It continues to accumulate events and produce
  * a corresponding "complete event (X)" in "chrome tracing" format.
+ * Each thread records its events to a buffer of its own, with the names interned, so recording an event neither
+ * allocates nor waits for other threads. The buffers are merged by EndProfiling.
  */
 class Profiler {
  public:
   /// turned off by default.
   /// Even this function is marked as noexcept, the code inside it may throw exceptions
-  Profiler() noexcept {};  //NOLINT
+  Profiler() noexcept;  //NOLINT
 
   /*
   Initializes Profiler with the session logger to log framework specific messages
@@ -49,7 +58,7 @@ class Profiler {
 
   /*
   Record a single event. Time is measured till the call of this function from
-  the start_time.
+  the start_time. Only the first max_num_event_args_ event_args are recorded.
   */
   void EndTimeAndRecordEvent(EventCategory category,
                              const std::string& event_name,
@@ -57,6 +66,26 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  /*
+  Record a single event like EndTimeAndRecordEvent, with the hardware events counted while it ran, which are
+  written to its args as numbers.
+  */
+  void EndTimeAndRecordCountedEvent(EventCategory category,
+                                    const std::string& event_name,
+                                    TimePoint& start_time,
+                                    const HardwareCounterValues& hardware_events,
+                                    const std::initializer_list<std::pair<std::string, std::string>>& event_args = {});
+
+  /*
+  Record a single event that took duration_us microseconds from the start_time, such as work measured on a device,
+  instead of the time till the call of this function.
+  */
+  void RecordEvent(EventCategory category,
+                   const std::string& event_name,
+                   const TimePoint& start_time,
+                   long long duration_us,
+                   const std::initializer_list<std::pair<std::string, std::string>>& event_args = {});
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -66,6 +95,47 @@ class Profiler {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Profiler);
 
+  static constexpr size_t max_num_events_ = 1000000;
+  static constexpr size_t max_num_event_args_ = 4;
+
+  // an event as recorded by a thread, with the ids its strings are interned with by the thread
+  struct ThreadEvent {
+    long long ts;
+    long long dur;
+    uint32_t name;
+    uint32_t num_args;
+    uint32_t args[max_num_event_args_][2];
+    EventCategory cat;
+    bool has_hardware_events;
+    HardwareCounterValues hardware_events;
+  };
+
+  // the events recorded by a thread. only that thread records to it, so its mutex is only waited for while
+  // EndProfiling reads the events.
+  struct ThreadEventBuffer {
+    OrtMutex mutex;
+    unsigned int tid;
+    // a ring of max_num_events_ events once it is full, in which the next event overwrites the oldest one at next
+    std::vector<ThreadEvent> events;
+    size_t next{0};
+    std::unordered_map<std::string, uint32_t> name_ids;
+    std::vector<const std::string*> names;  // the keys of name_ids by id
+
+    uint32_t Intern(const std::string& name);
+  };
+
+  ThreadEventBuffer& GetThreadEventBuffer();
+
+  void RecordEvent(EventCategory category,
+                   const std::string& event_name,
+                   const TimePoint& start_time,
+                   long long duration_us,
+                   const HardwareCounterValues* hardware_events,
+                   const std::initializer_list<std::pair<std::string, std::string>>& event_args);
+
+  // identifies the profiler to the thread_local cache of the buffer of a thread, which outlives the profiler
+  const uint64_t id_;
+
   // Mutex controlling access to profiler data
   OrtMutex mutex_;
   bool enabled_{false};
@@ -74,9 +144,8 @@ class Profiler {
   const logging::Logger* session_logger_{nullptr};
   const logging::Logger* custom_logger_{nullptr};
   TimePoint profiling_start_time_;
-  std::vector<EventRecord> events_;
-  bool max_events_reached{false};
-  static constexpr size_t max_num_events_ = 1000000;
+  std::unordered_map<std::thread::id, std::unique_ptr<ThreadEventBuffer>> thread_buffers_;
+  std::atomic<bool> max_events_reached{false};
   bool profile_with_logger_{false};
 };
 
@@ -41,15 +41,36 @@ Example of that usage:
     throw;
   }
 
+Callers that don't need a future (e.g. the ParallelExecutor, which tracks completion itself) should use
+Schedule, which avoids the packaged_task/future allocations. Schedule matches the Eigen ThreadPool API
+so code can be written once for both USE_EIGEN_THREADPOOL configurations.
+
+Scheduling is work-stealing: every worker owns a deque. Tasks submitted from a worker thread go to the
+front of that worker's deque so dependent work stays on the same core, tasks submitted from outside the
+pool are distributed round-robin, and an idle worker steals from the back of the other deques before
+going to sleep.
+
+Every task carries the priority of the thread that submitted it (see ScopedPriority), and a worker runs a task
+with that priority, so the tasks a task spawns (e.g. the nodes and MLAS work of a ParallelExecutor Run) inherit it.
+Tasks of the latency-critical class (priority > 0) go to a shared queue the workers serve before their deques, and
+tasks of the background class (priority < 0) to a shared queue they only serve when there is nothing else to run.
+
+An idle worker spins for the spin duration (see SetSpinDuration), pausing and then yielding, before it blocks, and
+keeps spinning while KeepWorkersHot asks it to, so the tasks of a Run that follow each other closely don't each pay
+for waking a sleeping thread.
 */
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <utility>
 
@@ -57,42 +78,107 @@ Example of that usage:
 #include "core/common/logging/logging.h"
 #include "core/platform/ort_mutex.h"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#endif
+
 namespace onnxruntime {
 
 class TaskThreadPool {
  private:
   struct task_element_t {
-    bool run_with_id;
+    enum class Kind { kFunction,
+                      kNoId,
+                      kWithId };
+
+    Kind kind;
+    int priority = 0;
+    std::function<void()> fn;
     std::packaged_task<void()> no_id;
     std::packaged_task<void(std::size_t)> with_id;
 
-    task_element_t(task_element_t&& other) {
-      run_with_id = other.run_with_id;
+    task_element_t() : kind(Kind::kFunction) {}
+
+    task_element_t(task_element_t&& other) noexcept
+        : kind(other.kind),
+          priority(other.priority),
+          fn(std::move(other.fn)),
+          no_id(std::move(other.no_id)),
+          with_id(std::move(other.with_id)) {}
+
+    task_element_t& operator=(task_element_t&& other) noexcept {
+      kind = other.kind;
+      priority = other.priority;
+      fn = std::move(other.fn);
       no_id = std::move(other.no_id);
       with_id = std::move(other.with_id);
+      return *this;
     }
 
+    explicit task_element_t(std::function<void()>&& f)
+        : kind(Kind::kFunction), fn(std::move(f)) {}
+
     explicit task_element_t(std::packaged_task<void()>&& f)
-        : run_with_id(false), no_id(std::move(f)) {}
+        : kind(Kind::kNoId), no_id(std::move(f)) {}
 
     explicit task_element_t(std::packaged_task<void(std::size_t)>&& f)
-        : run_with_id(true), with_id(std::move(f)) {}
+        : kind(Kind::kWithId), with_id(std::move(f)) {}
   };
 
-  std::queue<task_element_t> tasks_;
+  // Per-worker deque. The owner pushes and pops at the front, thieves take from the back.
+  // Each deque has its own lock so submissions from different workers never contend.
+  struct WorkerQueue {
+    OrtMutex mutex;
+    std::deque<task_element_t> tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
   std::vector<std::thread> threads_;
+
+  // the FIFO queues of the latency-critical and background tasks, shared by all workers. tasks that need the index
+  // of a worker (RunTaskWithID) always go to the deques as a thread outside the pool may run these.
+  WorkerQueue high_queue_;
+  WorkerQueue background_queue_;
+
+  // mutex_ is only used to put idle workers to sleep and to wait for completion,
+  // never on the submit/pop fast path.
   OrtMutex mutex_;
   OrtCondVar condition_;
   OrtCondVar completed_;
-  bool running_;
-  bool complete_;
-  std::size_t available_;
+  std::atomic<bool> running_;
+  std::atomic<std::size_t> queued_;       // tasks sitting in a deque
+  std::atomic<std::size_t> outstanding_;  // tasks queued or running
+  std::atomic<std::size_t> sleepers_;     // workers blocked on condition_
+  std::atomic<std::size_t> high_queued_;        // tasks sitting in high_queue_
+  std::atomic<std::size_t> background_queued_;  // tasks sitting in background_queue_
+  std::atomic<std::size_t> next_queue_;
+  std::atomic<int64_t> spin_us_;       // how long an idle worker spins before it blocks
+  std::atomic<int64_t> hot_until_ns_;  // the steady_clock time until which idle workers spin rather than block
   std::size_t total_;
+  std::function<void(std::size_t)> on_thread_start_;
 
  public:
   /// @brief Constructor.
-  explicit TaskThreadPool(std::size_t pool_size)
-      : threads_(pool_size), running_(true), complete_(true), available_(pool_size), total_(pool_size) {
+  /// @param on_thread_start Called by every worker, with its index, before it runs any task, e.g. to set the
+  /// affinity of the thread.
+  explicit TaskThreadPool(std::size_t pool_size, std::function<void(std::size_t)> on_thread_start = nullptr)
+      : threads_(pool_size),
+        running_(true),
+        queued_(0),
+        outstanding_(0),
+        sleepers_(0),
+        high_queued_(0),
+        background_queued_(0),
+        next_queue_(0),
+        spin_us_(0),
+        hot_until_ns_(0),
+        total_(pool_size),
+        on_thread_start_(std::move(on_thread_start)) {
+    queues_.reserve(pool_size);
+    for (std::size_t i = 0; i < pool_size; ++i) {
+      queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+
     for (std::size_t i = 0; i < pool_size; ++i) {
       threads_[i] = std::thread(std::bind(&TaskThreadPool::MainLoop, this, i));
     }
@@ -118,86 +204,419 @@ class TaskThreadPool {
     }
   }
 
-  void RunTask(std::packaged_task<void()>&& task) {
-    std::unique_lock<OrtMutex> lock(mutex_);
+  /// @brief Schedule fn to run on the pool. fn must not throw.
+  void Schedule(std::function<void()> fn) {
+    Push(task_element_t(std::move(fn)));
+  }
 
-    // Set task and signal condition variable so that a worker thread will
-    // wake up and use the task.
-    tasks_.push(task_element_t(std::move(task)));
-    complete_ = false;
-    condition_.notify_one();
+  void RunTask(std::packaged_task<void()>&& task) {
+    Push(task_element_t(std::move(task)));
   }
 
   void RunTaskWithID(std::packaged_task<void(std::size_t)>&& task) {
-    std::unique_lock<OrtMutex> lock(mutex_);
-
-    // Set task and signal condition variable so that a worker thread will
-    // wake up and use the task.
-    tasks_.push(task_element_t(std::move(task)));
-    complete_ = false;
-    condition_.notify_one();
+    Push(task_element_t(std::move(task)));
   }
 
   /// @brief Wait for queue to be empty
   void WaitWorkComplete() {
     std::unique_lock<OrtMutex> lock(mutex_);
-    while (!complete_)
+    while (outstanding_ != 0)
       completed_.wait(lock);
   }
 
+  /// @brief Run fn(i) for every i in [0, iterations) and return once all iterations have completed.
+  /// The calling thread runs iterations too and only waits for iterations other threads have already started,
+  /// so this is safe to call from a task running on this pool (e.g. an MLAS kernel inside a ParallelExecutor node).
+  /// fn must not throw.
+  void ParallelFor(int32_t iterations, const std::function<void(int32_t)>& fn) {
+    if (iterations <= 0) {
+      return;
+    }
+
+    if (iterations == 1 || total_ == 0) {
+      for (int32_t i = 0; i < iterations; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    // shared with the helper tasks, which may only get to run after this call has returned.
+    // a late helper finds no iterations left and never touches fn.
+    struct ParallelForState {
+      const std::function<void(int32_t)>* fn;
+      int32_t iterations;
+      std::atomic<int32_t> next{0};
+      std::atomic<int32_t> remaining;
+      OrtMutex mutex;
+      OrtCondVar done;
+    };
+
+    auto state = std::make_shared<ParallelForState>();
+    state->fn = &fn;
+    state->iterations = iterations;
+    state->remaining = iterations;
+
+    auto run_iterations = [state]() {
+      for (int32_t i = state->next++; i < state->iterations; i = state->next++) {
+        (*state->fn)(i);
+        if (--state->remaining == 0) {
+          std::lock_guard<OrtMutex> lock(state->mutex);
+          state->done.notify_all();
+        }
+      }
+    };
+
+    const std::size_t helpers = std::min(static_cast<std::size_t>(iterations - 1), total_);
+    for (std::size_t i = 0; i < helpers; ++i) {
+      Schedule(run_iterations);
+    }
+
+    run_iterations();
+
+    std::unique_lock<OrtMutex> lock(state->mutex);
+    while (state->remaining != 0) {
+      state->done.wait(lock);
+    }
+  }
+
+  /// @brief Run one queued task on the calling worker thread.
+  /// Lets a task that has to wait for other work on this pool (e.g. a ParallelExecutor started from an async Run)
+  /// make progress instead of blocking a worker the work may need.
+  /// @return false if the caller is not a worker of this pool or there was nothing to run.
+  bool RunPendingTask() {
+    const int self = CurrentThreadId();
+    if (self < 0) {
+      return false;
+    }
+
+    task_element_t task;
+    if (!TryPop(self, task)) {
+      return false;
+    }
+
+    --queued_;
+    RunAndComplete(task, self);
+    return true;
+  }
+
+  /// @brief Whether tasks of a higher priority class than priority are queued.
+  bool HasHigherPriorityTasks(int priority) const {
+    if (priority > 0) {
+      return false;
+    }
+    return priority == 0 ? high_queued_ > 0 : queued_ > background_queued_;
+  }
+
+  /// @brief Run the queued tasks of a higher priority class than the calling thread's on the calling thread, so
+  /// work of a lower priority lets them go first at a point where it can pause (e.g. between the nodes of a Run).
+  /// A thread outside the pool only runs latency-critical tasks, a worker any task of a higher class.
+  /// @return the number of tasks run.
+  std::size_t RunHigherPriorityTasks() {
+    const int priority = CurrentPriority();
+    const int self = CurrentThreadId();
+    std::size_t count = 0;
+    task_element_t task;
+    while (HasHigherPriorityTasks(priority) && TryPop(self, task, PriorityClass(priority))) {
+      --queued_;
+      RunAndComplete(task, static_cast<std::size_t>(self < 0 ? 0 : self));
+      // destruct the task before looking for the next one, as MainLoop does
+      task = task_element_t();
+      ++count;
+    }
+    return count;
+  }
+
+  /// @brief The priority of the work the calling thread submits: > 0 for latency-critical work, 0 for normal work
+  /// and < 0 for background work.
+  static int CurrentPriority() {
+    return CurrentPriorityRef();
+  }
+
+  /// @brief Sets the priority of the work the calling thread submits for the lifetime of the object, restoring the
+  /// previous priority on destruction.
+  class ScopedPriority {
+   public:
+    explicit ScopedPriority(int priority) : previous_(CurrentPriorityRef()) {
+      CurrentPriorityRef() = priority;
+    }
+
+    ~ScopedPriority() {
+      CurrentPriorityRef() = previous_;
+    }
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedPriority);
+
+    const int previous_;
+  };
+
+  /// @brief Let an idle worker spin for up to spin_duration, pausing and then yielding, before it blocks, so a task
+  /// submitted soon after it ran out of work starts without the latency of waking a sleeping thread.
+  /// 0, the default, blocks right away.
+  void SetSpinDuration(std::chrono::microseconds spin_duration) {
+    spin_us_ = std::max<int64_t>(0, spin_duration.count());
+  }
+
+  std::chrono::microseconds GetSpinDuration() const {
+    return std::chrono::microseconds(spin_us_.load());
+  }
+
+  /// @brief Keep the workers spinning rather than blocking when idle for duration from now, waking the blocked ones,
+  /// e.g. between back-to-back Runs whose tasks must start right away. Extends, and never shortens, an earlier call.
+  void KeepWorkersHot(std::chrono::microseconds duration) {
+    const int64_t hot_until = SteadyNowNs() + std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    int64_t current = hot_until_ns_.load();
+    while (current < hot_until && !hot_until_ns_.compare_exchange_weak(current, hot_until)) {
+    }
+
+    if (sleepers_ > 0) {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      condition_.notify_all();
+    }
+  }
+
+  /// @brief Number of worker threads in the pool.
+  int NumThreads() const { return static_cast<int>(total_); }
+
+  /// @brief Index of the calling worker thread in [0, NumThreads()), or -1 if the caller is not a
+  /// worker of this pool.
+  int CurrentThreadId() const {
+    const auto& worker = CurrentWorker();
+    return worker.first == this ? static_cast<int>(worker.second) : -1;
+  }
+
+  /// @brief The pool the calling thread is a worker of, or nullptr.
+  static TaskThreadPool* CurrentThreadPool() {
+    return CurrentWorker().first;
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(TaskThreadPool);
 
-  /// @brief Entry point for pool threads.
-  void MainLoop(std::size_t index) {
-    while (running_) {
-      // Wait on condition variable while the task is empty and
-      // the pool is still running.
-      std::unique_lock<OrtMutex> lock(mutex_);
-      while (tasks_.empty() && running_) {
-        condition_.wait(lock);
+  static std::pair<TaskThreadPool*, std::size_t>& CurrentWorker() {
+    static thread_local std::pair<TaskThreadPool*, std::size_t> worker{nullptr, 0};
+    return worker;
+  }
+
+  static int& CurrentPriorityRef() {
+    static thread_local int priority = 0;
+    return priority;
+  }
+
+  // the classes, 1 for latency-critical, 0 for normal and -1 for background, the priorities fall into
+  static int PriorityClass(int priority) {
+    return priority > 0 ? 1 : (priority < 0 ? -1 : 0);
+  }
+
+  static int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  bool IsHot() const {
+    return hot_until_ns_.load(std::memory_order_relaxed) > SteadyNowNs();
+  }
+
+  // a hint to the core that the thread is spinning, which saves power and lets the other hyper-thread run
+  static void CpuRelax() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+  }
+
+  // the pauses an idle worker spins with before it yields its core on every further check for a task
+  static constexpr int kSpinPauses = 64;
+
+  // spins until a task is queued, for the spin duration or while the workers are kept hot. returns whether a task
+  // was queued.
+  bool SpinForTask() {
+    const int64_t spin_us = spin_us_.load(std::memory_order_relaxed);
+    const int64_t hot_until = hot_until_ns_.load(std::memory_order_relaxed);
+    const int64_t now = SteadyNowNs();
+    const int64_t deadline = std::max(now + spin_us * 1000, hot_until);
+    if (deadline <= now) {
+      return false;
+    }
+
+    for (int spins = 0; running_; ++spins) {
+      if (queued_ > 0) {
+        return true;
       }
+      if (spins < kSpinPauses) {
+        CpuRelax();
+        continue;
+      }
+      // KeepWorkersHot may have moved the deadline
+      if (SteadyNowNs() >= std::max(deadline, hot_until_ns_.load(std::memory_order_relaxed))) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+    return queued_ > 0;
+  }
 
-      // If pool is no longer running, break out of loop.
-      if (!running_) break;
+  // a class below every task, so TryPop returns any task
+  static constexpr int kAnyClass = -2;
 
-      // Copy task locally and remove from the queue.  This is
-      // done within its own scope so that the task object is
-      // destructed immediately after running the task.  This is
-      // useful in the event that the function contains
-      // shared_ptr arguments bound via bind.
+  void Push(task_element_t&& task) {
+    if (total_ == 0) {
+      // no workers to hand the task to so run it inline.
+      Execute(task, 0);
+      return;
+    }
+
+    ++outstanding_;
+
+    task.priority = CurrentPriority();
+    const int priority_class = task.kind == task_element_t::Kind::kWithId ? 0 : PriorityClass(task.priority);
+    const int self = CurrentThreadId();
+    if (priority_class != 0) {
+      auto& queue = priority_class > 0 ? high_queue_ : background_queue_;
       {
-        auto task = std::move(tasks_.front());
-        tasks_.pop();
-        // Decrement count, indicating thread is no longer available.
-        --available_;
-
-        lock.unlock();
-
-        // Run the task.
-        try {
-          if (task.run_with_id) {
-            task.with_id(index);
-          } else {
-            task.no_id();
-          }
-        } catch (const std::exception& /*ex*/) {
-          // LOGS_DEFAULT(ERROR) << "Exception running TaskThreadPool task: " << ex.what();
-          throw;
+        std::lock_guard<OrtMutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+      }
+      ++(priority_class > 0 ? high_queued_ : background_queued_);
+    } else if (self >= 0) {
+      // keep work spawned by a worker local to that worker. LIFO order runs the most recently
+      // readied (and most likely cache-hot) task next.
+      auto& queue = *queues_[self];
+      std::lock_guard<OrtMutex> lock(queue.mutex);
+      queue.tasks.push_front(std::move(task));
+    } else {
+      auto& queue = *queues_[next_queue_++ % total_];
+      std::lock_guard<OrtMutex> lock(queue.mutex);
+      queue.tasks.push_back(std::move(task));
+    }
+
+    // queued_ is incremented after the push so a worker that observes queued_ > 0 can find the task.
+    ++queued_;
+
+    // sleepers_ is incremented by a worker before it re-checks queued_, so either the worker sees our
+    // task or we see the worker and wake it.
+    if (sleepers_ > 0) {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      condition_.notify_one();
+    }
+  }
+
+  static bool PopFront(WorkerQueue& queue, task_element_t& task) {
+    std::lock_guard<OrtMutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+  }
+
+  // pops a task of a higher class than above_class: the latency-critical tasks first, then the tasks of the deques
+  // of the worker index and of the others, then the background tasks. a thread outside the pool (index < 0) only
+  // takes tasks of the shared queues.
+  bool TryPop(int index, task_element_t& task, int above_class = kAnyClass) {
+    if (above_class < 1 && high_queued_ > 0 && PopFront(high_queue_, task)) {
+      --high_queued_;
+      return true;
+    }
+
+    if (above_class < 0 && index >= 0) {
+      if (PopFront(*queues_[index], task)) {
+        return true;
+      }
+
+      for (std::size_t i = 1; i < total_; ++i) {
+        auto& victim = *queues_[(index + i) % total_];
+        std::lock_guard<OrtMutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+          task = std::move(victim.tasks.back());
+          victim.tasks.pop_back();
+          return true;
         }
+      }
+    }
+
+    if (above_class < -1 && background_queued_ > 0 && PopFront(background_queue_, task)) {
+      --background_queued_;
+      return true;
+    }
+
+    return false;
+  }
+
+  static void Execute(task_element_t& task, std::size_t index) {
+    switch (task.kind) {
+      case task_element_t::Kind::kFunction:
+        task.fn();
+        break;
+      case task_element_t::Kind::kNoId:
+        task.no_id();
+        break;
+      case task_element_t::Kind::kWithId:
+        task.with_id(index);
+        break;
+    }
+  }
+
+  void RunAndComplete(task_element_t& task, std::size_t index) {
+    // the tasks that this one submits inherit its priority
+    ScopedPriority priority(task.priority);
+    try {
+      Execute(task, index);
+    } catch (const std::exception& /*ex*/) {
+      // LOGS_DEFAULT(ERROR) << "Exception running TaskThreadPool task: " << ex.what();
+      throw;
+    }
 
-        // Update status of empty, maybe
-        // Need to recover the lock first
-        lock.lock();
+    if (--outstanding_ == 0) {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      completed_.notify_all();
+    }
+  }
 
-        // Increment count, indicating thread is available.
-        ++available_;
-        if (tasks_.empty() && available_ == total_) {
-          complete_ = true;
-          completed_.notify_one();
+  /// @brief Entry point for pool threads.
+  void MainLoop(std::size_t index) {
+    CurrentWorker() = {this, index};
+    if (on_thread_start_) {
+      on_thread_start_(index);
+    }
+
+    while (true) {
+      // The task is scoped to the loop body so that it is destructed immediately after running.
+      // This is useful in the event that the function contains shared_ptr arguments bound via bind.
+      {
+        task_element_t task;
+        if (TryPop(static_cast<int>(index), task)) {
+          --queued_;
+          RunAndComplete(task, index);
+          continue;
         }
       }
-    }  // while running_
+
+      // If pool is no longer running and there is nothing left to do, break out of loop.
+      if (!running_) break;
+
+      // A task may be between being pushed and queued_ being incremented, or may have been stolen by
+      // another worker which hasn't decremented queued_ yet. Either way re-scan rather than sleep.
+      if (queued_ > 0) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      if (SpinForTask()) {
+        continue;
+      }
+
+      // Wait on condition variable while there are no queued tasks, the pool is still running and the workers
+      // aren't to be kept hot.
+      std::unique_lock<OrtMutex> lock(mutex_);
+      ++sleepers_;
+      while (queued_ == 0 && running_ && !IsHot()) {
+        condition_.wait(lock);
+      }
+      --sleepers_;
+    }  // while
   }
 };
 
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+
 #include "core/common/common.h"
 
 namespace onnxruntime {
@@ -31,6 +34,22 @@ inline bool utf8_bytes(unsigned char ch, size_t& len) {
   return false;
 }
 
+// Returns true if all chars are ASCII, which makes them valid utf8
+// with one byte per char. Tests 8 bytes at a time.
+inline bool is_ascii(const char* s, size_t len) {
+  uint64_t bits = 0;
+  size_t idx = 0;
+  for (; idx + sizeof(uint64_t) <= len; idx += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, s + idx, sizeof(word));
+    bits |= word;
+  }
+  for (; idx < len; ++idx) {
+    bits |= static_cast<unsigned char>(s[idx]);
+  }
+  return (bits & 0x8080808080808080ULL) == 0;
+}
+
 inline bool utf8_validate(const unsigned char* s, size_t len, size_t& utf8_chars) {
   size_t utf8_len = 0;
   size_t idx = 0;
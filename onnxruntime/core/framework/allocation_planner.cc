@@ -58,6 +58,7 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.alloc_kind == AllocKind::kReuse && elt_plan.reuse_if_same_size) out << " if same size";
 
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
@@ -131,11 +132,24 @@ class PlannerImpl {
     const onnxruntime::NodeArg* p_def_site;  // the (unique) NodeArg corresponding to the MLValue
     int usecount = 0;                        // static reference-count
     MLValueIndex reused_buffer_index;        // index of original buffer to reuse
+    // the values that reuse this (original) buffer only if they have its size when the graph is run. a value that
+    // doesn't gets a buffer of its own, which is freed with this buffer.
+    std::vector<MLValueIndex> size_checked_reuses;
+    // for parallel execution: the steps of the execution plan whose nodes use a value in this (original) buffer
+    std::vector<size_t> users;
+    // the providers and the queues of the nodes that read or write the value, a null provider standing for the
+    // caller, which feeds or fetches it
+    std::vector<std::pair<const IExecutionProvider*, int>> queues;
   };
 
   // ml_value_info_ is indexed by an MLValueIndex
   std::vector<MLValueInfo> ml_value_info_;
 
+  // for parallel execution, which runs a node once the nodes it has input edges from have run:
+  // ancestors_[i][j] is true if the node at step j of the execution plan is always done when the node at step i
+  // starts, because there is a path of edges from the former to the latter
+  std::vector<std::vector<bool>> ancestors_;
+
   // FreeBufferInfo is used to track information about ml-values whose buffers are
   // free to be reused.
   struct FreeBufferInfo {
@@ -169,6 +183,14 @@ class PlannerImpl {
     return AllocPlan(Index(name));
   }
 
+  void AddQueue(MLValueIndex n, const IExecutionProvider* provider, int queue_id) {
+    auto& queues = ml_value_info_.at(n).queues;
+    auto queue = std::make_pair(provider, queue_id);
+    if (std::find(queues.begin(), queues.end(), queue) == queues.end()) {
+      queues.push_back(queue);
+    }
+  }
+
   // Initialize state for a given ml-value at its definition site:
   void ProcessDef(MLValueIndex id, const onnxruntime::NodeArg* p_def_site) {
     MLValueInfo& info = ml_value_info_.at(id);
@@ -177,10 +199,14 @@ class PlannerImpl {
     info.p_def_site = p_def_site;
   }
 
-  void Reuse(MLValueIndex reused, MLValueIndex reused_for) {
+  void Reuse(MLValueIndex reused, MLValueIndex reused_for, bool if_same_size = false) {
     ORT_ENFORCE(reused != reused_for);
     // find original buffer underlying ml-value we want to reuse:
     MLValueIndex original = Buffer(reused);
+    // a value that reuses the buffer only if it has its size may have a buffer of its own when the graph is run,
+    // so a value that reuses it in turn may only have the original buffer if it has its size too
+    const auto& reused_plan = AllocPlan(reused);
+    if (reused_plan.alloc_kind == AllocKind::kReuse && reused_plan.reuse_if_same_size) if_same_size = true;
     // record that the new buffer will reuse that original buffer
     Buffer(reused_for) = original;
     // adjust original buffer's usecount
@@ -190,10 +216,15 @@ class PlannerImpl {
     auto& symplan = AllocPlan(reused_for);
     symplan.alloc_kind = AllocKind::kReuse;
     symplan.reused_buffer = original;
+    symplan.reuse_if_same_size = if_same_size;
+    if (if_same_size) ml_value_info_.at(original).size_checked_reuses.push_back(reused_for);
   }
 
-  // Find if there exists some input tensor that we can use in-place for output_arg
-  bool FindReusableInput(const onnxruntime::Node& node, int output_arg_num, MLValueIndex* reusable_input) {
+  // Find if there exists some input tensor that we can use in-place for output_arg.
+  // *if_same_size is set if the input may only be used if it turns out to have the size of output_arg when the
+  // graph is run, because the shape of either isn't known.
+  bool FindReusableInput(const onnxruntime::Node& node, size_t program_counter, int output_arg_num,
+                         MLValueIndex* reusable_input, bool* if_same_size) {
     auto p_output_arg = node.OutputDefs()[output_arg_num];
     auto p_opkernel_def = utils::GetKernelDef(kernel_registry_, node);
 
@@ -201,6 +232,8 @@ class PlannerImpl {
     // planner would have returned an error status earlier on.
     ORT_ENFORCE(nullptr != p_opkernel_def);
 
+    *if_same_size = false;
+
     const std::vector<std::pair<int, int>>& alias_map = p_opkernel_def->Alias();
     auto& input_args = node.InputDefs();
     for (auto pair : alias_map) {
@@ -216,6 +249,10 @@ class PlannerImpl {
       }
     }
 
+    // an input that can only be used if its size matches, in case no input is known to match
+    bool found_if_same_size = false;
+    MLValueIndex reusable_if_same_size = 0;
+
     const std::vector<std::pair<int, int>>& inplace_map = p_opkernel_def->MayInplace();
     for (auto pair : inplace_map) {
       if (pair.second == output_arg_num) {
@@ -224,34 +261,49 @@ class PlannerImpl {
           if (p_input_arg->Exists()) {
             auto input_arg_index = Index(p_input_arg->Name());
             auto original = Buffer(input_arg_index);
-            if (1 == UseCount(original)) {
+            if (1 == UseCount(original) && UsersRunBefore(original, program_counter)) {
               if (SameSize(*p_input_arg, *p_output_arg)) {
                 // we can reuse this input since it is its last use and permitted for in-place update
                 *reusable_input = input_arg_index;  // or original; both should be okay
                 return true;
               }
+
+              if (!found_if_same_size && MayHaveSameSize(*p_input_arg, *p_output_arg)) {
+                found_if_same_size = true;
+                reusable_if_same_size = input_arg_index;
+              }
             }
           }
         }
       }
     }
+
+    if (found_if_same_size) {
+      *reusable_input = reusable_if_same_size;
+      *if_same_size = true;
+      return true;
+    }
+
     return false;
   }
 
-  bool SameShape(const TensorShapeProto& shape1, const TensorShapeProto& shape2) {
-    // TODO: This should probably be defined to be the equality operator on TensorShapeProto.
-    int rank1 = shape1.dim_size();
-    if (shape2.dim_size() != rank1) return false;
-    for (int i = 0; i < rank1; i++) {
-      const auto& val1 = shape1.dim(i);
-      const auto& val2 = shape2.dim(i);
-      if (val1.has_dim_value() && val2.has_dim_value() && (val1.dim_value() == val2.dim_value()))
-        continue;  // same known dimension
-      if (val1.has_dim_param() && val2.has_dim_param() && (val1.dim_param() == val2.dim_param()))
-        continue;  // same unknown dimension
-      return false;
+  // whether a dimension of the shape is neither a known value nor a named parameter
+  static bool HasUnknownDim(const TensorShapeProto& shape) {
+    for (const auto& dim : shape.dim()) {
+      if (!dim.has_dim_value() && !dim.has_dim_param()) return true;
     }
-    return true;
+    return false;
+  }
+
+  // whether two values that aren't known to have the same size may turn out to when the graph is run, which is
+  // the case if they have the same element size and shape inference left the shape of either (partly) unknown.
+  // values with different dimension parameters are taken to have different sizes.
+  bool MayHaveSameSize(const onnxruntime::NodeArg& arg1, const onnxruntime::NodeArg& arg2) {
+    if (IsNonTensor(arg1) || IsNonTensor(arg2)) return false;
+    if (GetElementSize(arg1.Type()) != GetElementSize(arg2.Type())) return false;
+    auto p_shape1 = context_.GetShape(arg1);
+    auto p_shape2 = context_.GetShape(arg2);
+    return (nullptr == p_shape1) || (nullptr == p_shape2) || HasUnknownDim(*p_shape1) || HasUnknownDim(*p_shape2);
   }
 
   /*! \brief Given a tensor-type, return the size of an element of the tensor.
@@ -265,57 +317,102 @@ class PlannerImpl {
     return elt_type->Size();
   }
 
-  bool SameSize(const TensorShapeProto& shape1, const DataType& ptype1,
-                const TensorShapeProto& shape2, const DataType& ptype2) {
-    return (GetElementSize(ptype1) == GetElementSize(ptype2)) && SameShape(shape1, shape2);
+  bool IsStringTensor(const DataType& tensor_type) {
+    const TypeProto& type_proto = ONNX_NAMESPACE::Utils::DataTypeUtils::ToTypeProto(tensor_type);
+    return type_proto.tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING;
+  }
 
-    /* TODO: we can improve this if the concrete shapes are known for both as below.
-       Unclear whether this is worthwhile though.
-    if (KnownSize(p_shape1) && KnownSize(p_shape2)) {
-      // Comparison of statically-known size
-      auto size1 = NumElements(p_shape1) * EltSize(ptype1);
-      auto size2 = NumElements(p_shape2) * EltSize(ptype2);
-      return size1 == size2;
-    } else {
-      // Comparison of statically-unknown size buffers
-      return SameElementSize(ptype1, ptype2) && SameShape(shape1, shape2);
+  // the size in bytes of a tensor as a product of a number and the dimension parameters of its shape, e.g.
+  // 4 * batch * seq for a float tensor of shape (batch, seq) or (seq, 1, batch), so that sizes can be compared
+  // when the parameters are only known when the graph is run
+  struct SymbolicSize {
+    int64_t bytes;
+    // sorted, with a parameter repeated for each dimension it names
+    std::vector<std::string> params;
+  };
+
+  // false if a dimension of the shape is neither a value nor a parameter
+  static bool GetSymbolicSize(const TensorShapeProto& shape, size_t element_size, SymbolicSize& size) {
+    size.bytes = static_cast<int64_t>(element_size);
+    size.params.clear();
+    for (const auto& dim : shape.dim()) {
+      if (dim.has_dim_value()) {
+        size.bytes *= dim.dim_value();
+      } else if (dim.has_dim_param()) {
+        size.params.push_back(dim.dim_param());
+      } else {
+        return false;
+      }
     }
-    */
+    std::sort(size.params.begin(), size.params.end());
+    return true;
   }
 
+  // whether two values have the same element size and the same number of elements, whatever values the dimension
+  // parameters take, so that one can be written in place of the other
   bool SameSize(const onnxruntime::NodeArg& arg1, const onnxruntime::NodeArg& arg2) {
     if ((!arg1.Exists()) || (!arg2.Exists())) return false;
     auto p_shape1 = context_.GetShape(arg1);
     auto p_shape2 = context_.GetShape(arg2);
     // If the shapes are unknown, we conservatively assume they may be of different size.
     if ((nullptr == p_shape1) || (nullptr == p_shape2)) return false;
-    return SameSize(*p_shape1, arg1.Type(), *p_shape2, arg2.Type());
+    size_t element_size = GetElementSize(arg1.Type());
+    if (element_size != GetElementSize(arg2.Type()) || IsStringTensor(arg1.Type()) != IsStringTensor(arg2.Type())) {
+      return false;
+    }
+    SymbolicSize size1, size2;
+    return GetSymbolicSize(*p_shape1, element_size, size1) && GetSymbolicSize(*p_shape2, element_size, size2) &&
+           size1.bytes == size2.bytes && size1.params == size2.params;
   }
 
-  // Find if freelist contains a buffer of the same size as output_arg
-  bool FindReusableTensor(const onnxruntime::NodeArg& output_arg, MLValueIndex* reusable_tensor) {
+  // Find the smallest buffer in the freelist that is at least as large as output_arg, whatever values the
+  // dimension parameters take. A buffer is only known to be as large if its size is a multiple of the same
+  // parameters (a parameter may be 0). The buffers of strings, which are constructed in place, are only reused for
+  // strings of the same size.
+  bool FindReusableTensor(const onnxruntime::NodeArg& output_arg, size_t program_counter,
+                          MLValueIndex* reusable_tensor) {
     auto p_required_buffer_shape = context_.GetShape(output_arg);
     if (nullptr == p_required_buffer_shape) return false;
     auto required_buffer_type = output_arg.Type();
     auto& required_allocator_info = AllocPlan(output_arg.Name()).location;
+    const bool required_strings = IsStringTensor(required_buffer_type);
+    SymbolicSize required_size;
+    if (!GetSymbolicSize(*p_required_buffer_shape, GetElementSize(required_buffer_type), required_size)) return false;
 
+    auto best_fit = freelist_.end();
+    int64_t best_fit_bytes = 0;
+    SymbolicSize available_size;
     for (auto it = freelist_.begin(); it != freelist_.end(); ++it) {
       auto reusable = it->ml_value;
+      // the buffer may be the caller's buffer for a graph output, which must not be written after the output is
+      if (AllocPlan(reusable).aliased_output >= 0) continue;
+      if (!UsersRunBefore(reusable, program_counter)) continue;
       auto p_node_arg = ml_value_info_.at(reusable).p_def_site;
       auto& available_allocator_info = AllocPlan(p_node_arg->Name()).location;
       if (!(available_allocator_info == required_allocator_info)) continue;
       auto p_available_buffer_shape = context_.GetShape(*p_node_arg);
-      if (nullptr != p_available_buffer_shape) {
-        auto available_buffer_type = p_node_arg->Type();
-        if (SameSize(*p_available_buffer_shape, available_buffer_type,
-                     *p_required_buffer_shape, required_buffer_type)) {
-          *reusable_tensor = reusable;
-          freelist_.erase(it);
-          return true;
-        }
+      if (nullptr == p_available_buffer_shape) continue;
+      auto available_buffer_type = p_node_arg->Type();
+      if (IsStringTensor(available_buffer_type) != required_strings ||
+          !GetSymbolicSize(*p_available_buffer_shape, GetElementSize(available_buffer_type), available_size) ||
+          available_size.params != required_size.params) {
+        continue;
+      }
+      if (available_size.bytes < required_size.bytes ||
+          (required_strings && available_size.bytes != required_size.bytes)) {
+        continue;
+      }
+      // the most recently freed of the smallest buffers, whose memory is the most likely to be in cache
+      if (best_fit == freelist_.end() || available_size.bytes < best_fit_bytes) {
+        best_fit = it;
+        best_fit_bytes = available_size.bytes;
+        if (best_fit_bytes == required_size.bytes) break;
       }
     }
-    return false;
+    if (best_fit == freelist_.end()) return false;
+    *reusable_tensor = best_fit->ml_value;
+    freelist_.erase(best_fit);
+    return true;
   }
 
   void Initialize(size_t num_graph_nodes, size_t num_ml_values) {
@@ -335,12 +432,14 @@ class PlannerImpl {
     for (auto graph_input : graph_viewer_.GetInputs()) {
       MLValueIndex index = Index(graph_input->Name());
       ProcessDef(index, graph_input);
+      AddQueue(index, nullptr, 0);
       UseCount(index)++;  // Models caller's usage post-inference; ensures it will not be reused.
     }
 
     for (auto node_arg : outer_scope_node_args_) {
       MLValueIndex index = Index(node_arg->Name());
       ProcessDef(index, node_arg);
+      AddQueue(index, nullptr, 0);
       UseCount(index)++;  // ensure will not be re-used as this graph does not own the buffer
     }
 
@@ -349,6 +448,7 @@ class PlannerImpl {
       const auto& initializer_name = pair.first;
       MLValueIndex index = Index(initializer_name);
       ProcessDef(index, graph_viewer_.GetNodeArg(pair.first));
+      AddQueue(index, nullptr, 0);
       UseCount(initializer_name)++;
     }
 
@@ -401,24 +501,51 @@ class PlannerImpl {
           }
         }
       }
-      // if sync is needed, mark allocation plan as create_fence_if_async=true
-      // note that the input arg may come from an execution provider (i.e. CPU) that does not support async,
-      // in which case create_fence_if_async would be ignored when creating MLValue
-      if (p_kernelDef->ExecQueueId() != 0) {
-        pnode->ForEachDef([this](const onnxruntime::NodeArg& arg, bool /*is_input*/) {
-          MLValueIndex index = Index(arg.Name());
-          AllocPlan(index).create_fence_if_async = true;
-        });
-      }
+      // the queues a value is used on decide whether it needs a fence, see GenerateFencePlan
+      const int queue_id = plan_.node_exec_queue_ids.empty() ? p_kernelDef->ExecQueueId()
+                                                             : plan_.node_exec_queue_ids[step.node_index];
+      pnode->ForEachDef([this, exec_provider, queue_id](const onnxruntime::NodeArg& arg, bool /*is_input*/) {
+        AddQueue(Index(arg.Name()), exec_provider, queue_id);
+      });
     }
 
     for (auto graph_output : graph_viewer_.GetOutputs()) {
       UseCount(graph_output->Name())++;  // Models caller's usage post-inference; ensures it will not be reused.
+      AddQueue(Index(graph_output->Name()), nullptr, 0);
     }
 
     return Status::OK();
   }
 
+  // Marks the values to create a fence for, if their providers support async execution: those in a buffer that a
+  // node running on another queue than the default one uses, and that is used on more than one queue of a provider
+  // or by the caller. The nodes of a single queue run in order, so a buffer that only they use needs no fence, and
+  // neither does one on the default queues only, which the executors run synchronously. Reused buffers share a
+  // fence, so the queues are gathered over all the values in a buffer.
+  void GenerateFencePlan() {
+    std::vector<std::vector<std::pair<const IExecutionProvider*, int>>> buffer_queues(ml_value_info_.size());
+    for (size_t n = 0; n < ml_value_info_.size(); ++n) {
+      const auto& queues = ml_value_info_[n].queues;
+      if (queues.empty()) continue;
+      auto& merged = buffer_queues.at(Buffer(static_cast<MLValueIndex>(n)));
+      for (const auto& queue : queues) {
+        if (std::find(merged.begin(), merged.end(), queue) == merged.end()) {
+          merged.push_back(queue);
+        }
+      }
+    }
+
+    for (size_t n = 0; n < ml_value_info_.size(); ++n) {
+      if (ml_value_info_[n].queues.empty()) continue;
+      const auto& queues = buffer_queues[Buffer(static_cast<MLValueIndex>(n))];
+      const bool async = std::any_of(queues.begin(), queues.end(),
+                                     [](const std::pair<const IExecutionProvider*, int>& queue) {
+                                       return queue.second != 0;
+                                     });
+      AllocPlan(static_cast<MLValueIndex>(n)).create_fence_if_async = async && queues.size() > 1;
+    }
+  }
+
   void GeneratePlanForWeights() {
     auto& weights = graph_viewer_.GetAllInitializedTensors();
 
@@ -448,6 +575,44 @@ class PlannerImpl {
     }
   }
 
+  // A graph output computed by a node that aliases its input to the output, e.g. a Reshape, is a copy of the input
+  // unless the input is written to the buffer of the output. Mark the inputs that only the aliasing node consumes
+  // so that the execution frame writes them to the caller's buffer for the output when there is one.
+  void PlanAliasedOutputs() {
+    auto& graph_outputs = graph_viewer_.GetOutputs();
+
+    for (const auto& step : plan_.execution_plan) {
+      auto pnode = graph_viewer_.GetNode(step.node_index);
+      auto p_opkernel_def = utils::GetKernelDef(kernel_registry_, *pnode);
+      auto& input_args = pnode->InputDefs();
+      auto& output_args = pnode->OutputDefs();
+
+      for (auto pair : p_opkernel_def->Alias()) {
+        if (pair.first < 0 || static_cast<size_t>(pair.first) >= input_args.size() ||
+            pair.second < 0 || static_cast<size_t>(pair.second) >= output_args.size()) {
+          continue;
+        }
+
+        auto p_input_arg = input_args[pair.first];
+        auto p_output_arg = output_args[pair.second];
+        if (!p_input_arg->Exists() || !p_output_arg->Exists() || IsNonTensor(*p_input_arg) ||
+            std::find(graph_outputs.begin(), graph_outputs.end(), p_output_arg) == graph_outputs.end()) {
+          continue;
+        }
+
+        // the input must be computed by a node, and used by the aliasing node only: the use count of a node output
+        // includes its definition. graph inputs, initializers and outer scope values have a plan already.
+        auto input_index = Index(p_input_arg->Name());
+        auto& input_plan = AllocPlan(input_index);
+        if (input_plan.alloc_kind != AllocKind::kAllocate || UseCount(input_index) != 2) {
+          continue;
+        }
+
+        input_plan.aliased_output = Index(p_output_arg->Name());
+      }
+    }
+  }
+
   void ComputeReusePlan() {
     std::vector<SequentialExecutionPlan::NodeExecutionPlan>& execution_plan{plan_.execution_plan};
 
@@ -473,6 +638,7 @@ class PlannerImpl {
     }
 
     GeneratePlanForWeights();
+    PlanAliasedOutputs();
 
     for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
       SequentialExecutionPlan::NodeExecutionPlan step = execution_plan[program_counter];
@@ -486,17 +652,18 @@ class PlannerImpl {
         auto current = Index(node_output->Name());
         AllocPlan(current).value_type = utils::GetMLDataType(*node_output);
         MLValueIndex reused;
+        bool reuse_if_same_size;
         if (std::find(graph_outputs.begin(), graph_outputs.end(), node_output) != graph_outputs.end()) {
           // node_output is graph's output, so we can't reuse intermedia buffer
           AllocPlan(current).alloc_kind = AllocKind::kAllocateOutput;
         } else if (IsNonTensor(*node_output)) {
           // we do not try sharing-optimization for non-tensors
           AllocPlan(current).alloc_kind = AllocKind::kAllocate;
-        } else if (FindReusableInput(*pnode, output_arg_num, &reused)) {
+        } else if (FindReusableInput(*pnode, program_counter, output_arg_num, &reused, &reuse_if_same_size)) {
           // Reuse one of this node's input buffers as the output buffer (for in-place update)
-          Reuse(reused, current);
-        } else if (!context_.EnableParallelExecution() && FindReusableTensor(*node_output, &reused)) {
-          // Reuse an available (dead) buffer for this output, this is only for sequential execution.
+          Reuse(reused, current, reuse_if_same_size);
+        } else if (FindReusableTensor(*node_output, program_counter, &reused)) {
+          // Reuse an available (dead) buffer for this output
           Reuse(reused, current);
         } else {
           // otherwise: allocate a new buffer for this output
@@ -532,6 +699,133 @@ class PlannerImpl {
             freelist_.push_front(FreeBufferInfo(original, program_counter));
         }
       }
+
+      if (context_.EnableParallelExecution()) {
+        pnode->ForEachDef([this, program_counter](const onnxruntime::NodeArg& arg, bool /*is_input*/) {
+          ml_value_info_.at(Buffer(Index(arg.Name()))).users.push_back(program_counter);
+        });
+      }
+    }
+  }
+
+  // spreads the branches of the graph over the compute queues of the providers that have more than one, for a
+  // parallel execution. a node continues on the compute queue of the first node it has an input edge from that is of
+  // its provider and that no other node has continued from, so that a chain of nodes stays on one queue and the
+  // values it passes on need no fences. any other node, e.g. a root or a branch that forks off, takes the next queue
+  // of its provider in turn.
+  void AssignComputeQueues() {
+    struct ProviderQueues {
+      std::vector<int> ids;
+      size_t next;
+    };
+    std::unordered_map<const IExecutionProvider*, ProviderQueues> provider_queues;
+    auto& queue_ids = plan_.node_exec_queue_ids;
+    queue_ids.assign(graph_viewer_.MaxNodeIndex(), 0);
+    std::vector<bool> continued(graph_viewer_.MaxNodeIndex(), false);
+    bool spread = false;
+
+    for (const auto& step : plan_.execution_plan) {
+      auto pnode = graph_viewer_.GetNode(step.node_index);
+      auto p_kernel_def = utils::GetKernelDef(kernel_registry_, *pnode);
+      auto exec_provider = execution_providers_.Get(*pnode);
+      // ComputeUseCounts reports the nodes without a kernel
+      if (p_kernel_def == nullptr || exec_provider == nullptr) continue;
+
+      int& queue_id = queue_ids[step.node_index];
+      queue_id = p_kernel_def->ExecQueueId();
+      if (queue_id != 0) continue;
+
+      auto it = provider_queues.find(exec_provider);
+      if (it == provider_queues.end()) {
+        it = provider_queues.emplace(exec_provider, ProviderQueues{exec_provider->GetComputeQueueIds(), 0}).first;
+      }
+      auto& queues = it->second;
+      if (queues.ids.size() < 2) continue;
+      spread = true;
+
+      bool found = false;
+      for (auto edge = pnode->InputEdgesBegin(), end = pnode->InputEdgesEnd(); edge != end && !found; ++edge) {
+        const auto& input_node = edge->GetNode();
+        const int input_queue_id = queue_ids[input_node.Index()];
+        if (!continued[input_node.Index()] && execution_providers_.Get(input_node) == exec_provider &&
+            std::find(queues.ids.cbegin(), queues.ids.cend(), input_queue_id) != queues.ids.cend()) {
+          continued[input_node.Index()] = true;
+          queue_id = input_queue_id;
+          found = true;
+        }
+      }
+      if (!found) {
+        queue_id = queues.ids[queues.next];
+        queues.next = (queues.next + 1) % queues.ids.size();
+      }
+    }
+
+    if (!spread) queue_ids.clear();
+  }
+
+  void ComputeAncestors() {
+    const auto& execution_plan = plan_.execution_plan;
+    const size_t num_steps = execution_plan.size();
+
+    std::unordered_map<onnxruntime::NodeIndex, size_t> step_of_node;
+    for (size_t step = 0; step < num_steps; ++step) {
+      step_of_node[execution_plan[step].node_index] = step;
+    }
+
+    // the steps are in topological order, so the ancestors of the nodes a node has input edges from are known
+    ancestors_.assign(num_steps, std::vector<bool>(num_steps, false));
+    for (size_t step = 0; step < num_steps; ++step) {
+      auto pnode = graph_viewer_.GetNode(execution_plan[step].node_index);
+      auto& ancestors = ancestors_[step];
+      for (auto it = pnode->InputEdgesBegin(), end = pnode->InputEdgesEnd(); it != end; ++it) {
+        auto input_step = step_of_node.find(it->GetNode().Index());
+        if (input_step == step_of_node.cend()) continue;
+        ancestors[input_step->second] = true;
+        const auto& input_ancestors = ancestors_[input_step->second];
+        for (size_t i = 0; i < num_steps; ++i) {
+          if (input_ancestors[i]) ancestors[i] = true;
+        }
+      }
+    }
+  }
+
+  // whether every node that used a value in the buffer is done when the node at the step starts. a sequential
+  // execution runs the nodes in the order of the steps, so that is the case for any use planned so far. a parallel
+  // one runs nodes the graph doesn't order concurrently, so the nodes must be ancestors of the node at the step.
+  bool UsersRunBefore(MLValueIndex original, size_t program_counter) {
+    if (!context_.EnableParallelExecution()) return true;
+
+    const auto& ancestors = ancestors_.at(program_counter);
+    const auto& users = ml_value_info_.at(original).users;
+    return std::all_of(users.cbegin(), users.cend(), [&ancestors](size_t user) { return ancestors[user]; });
+  }
+
+  // the parallel executor can't free ml-values at fixed steps as the sequential one does. it releases a buffer once
+  // every node that uses a value in it has run, counting the uses down from plan_.buffer_use_counts.
+  void GenerateParallelReleasePlan() {
+    auto& buffer_use_counts = plan_.buffer_use_counts;
+    buffer_use_counts.assign(plan_.allocation_plan.size(), 0);
+
+    for (const auto& step : plan_.execution_plan) {
+      graph_viewer_.GetNode(step.node_index)->ForEachDef([this, &buffer_use_counts](const onnxruntime::NodeArg& arg,
+                                                                                      bool /*is_input*/) {
+        auto index = Index(arg.Name());
+        ++buffer_use_counts[Buffer(index)];
+        // a value that reuses a buffer only if it has its size may have a buffer of its own
+        const auto& value_plan = AllocPlan(index);
+        if (value_plan.alloc_kind == AllocKind::kReuse && value_plan.reuse_if_same_size) {
+          ++buffer_use_counts[index];
+        }
+      });
+    }
+
+    // the buffers of graph inputs, graph outputs and initializers are never released
+    for (size_t i = 0, end = buffer_use_counts.size(); i < end; ++i) {
+      auto alloc_kind = plan_.allocation_plan[i].alloc_kind;
+      if (alloc_kind == AllocKind::kPreExisting || alloc_kind == AllocKind::kAllocateOutput ||
+          alloc_kind == AllocKind::kAllocateStatically) {
+        buffer_use_counts[i] = 0;
+      }
     }
   }
 
@@ -559,6 +853,12 @@ class PlannerImpl {
         plan_.execution_plan[prev_dealloc_point].free_from_index = current;
       }
       current++;
+
+      // a value that didn't have the size of the buffer it was to reuse has a buffer of its own
+      for (auto size_checked_reuse : ml_value_info_.at(it->ml_value).size_checked_reuses) {
+        plan_.to_be_freed.push_back(size_checked_reuse);
+        current++;
+      }
     }
 
     if (has_prev_dealloc_point)
@@ -586,15 +886,31 @@ Status PlannerImpl::CreatePlan() {
     plan_.execution_plan.emplace_back(n);
   }
 
+  if (context_.EnableParallelExecution()) {
+    AssignComputeQueues();
+  }
+
   // compute use counts for all ml-values
   ORT_RETURN_IF_ERROR(ComputeUseCounts());
 
+  // a buffer is only reused by a node the nodes that used it before are ancestors of in a parallel execution
+  if (context_.EnableParallelExecution()) {
+    ComputeAncestors();
+  }
+
   // determine sharing/reuse among ml-values
   ComputeReusePlan();
 
+  // create fences only for the buffers used across queues
+  GenerateFencePlan();
+
   // convert information in the freelist_ into a deallocation plan in required format
   GenerateDeallocationPlan();
 
+  if (context_.EnableParallelExecution()) {
+    GenerateParallelReleasePlan();
+  }
+
   return Status::OK();
 }
 
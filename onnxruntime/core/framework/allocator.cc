@@ -3,6 +3,8 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/allocatormgr.h"
+#include "core/common/logging/logging.h"
+#include "core/platform/env.h"
 #include <cstdlib>
 #include <sstream>
 #include <cstdlib>
@@ -36,6 +38,53 @@ void CPUAllocator::Free(void* p) {
 #endif
 }
 
+void* NumaCPUAllocator::Alloc(size_t size) {
+  void* p = CPUAllocator::Alloc(size);
+  // before the pages are touched, so that they're allocated on the node rather than moved there
+  auto status = Env::Default().BindMemoryToNumaNode(p, size, numa_node_);
+  if (!status.IsOK()) {
+    LOGS_DEFAULT(WARNING) << "The memory can't be placed on NUMA node " << numa_node_ << ": " << status.ErrorMessage();
+  }
+  return p;
+}
+
+void* HugePageCPUAllocator::Alloc(size_t size) {
+  // smaller blocks would waste most of their page
+  constexpr size_t kMinHugePageBlockSize = 2 * 1024 * 1024;
+  void* p = size >= kMinHugePageBlockSize ? Env::Default().AllocateHugePages(size) : nullptr;
+  if (p == nullptr) {
+    p = CPUAllocator::Alloc(size);
+  } else {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    huge_page_blocks_[p] = size;
+  }
+  if (numa_node_ >= 0 && p != nullptr) {
+    auto status = Env::Default().BindMemoryToNumaNode(p, size, numa_node_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "The memory can't be placed on NUMA node " << numa_node_ << ": "
+                            << status.ErrorMessage();
+    }
+  }
+  return p;
+}
+
+void HugePageCPUAllocator::Free(void* p) {
+  size_t size = 0;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = huge_page_blocks_.find(p);
+    if (it != huge_page_blocks_.end()) {
+      size = it->second;
+      huge_page_blocks_.erase(it);
+    }
+  }
+  if (size != 0) {
+    Env::Default().FreeHugePages(p, size);
+  } else {
+    CPUAllocator::Free(p);
+  }
+}
+
 const OrtAllocatorInfo& CPUAllocator::Info() const {
   static constexpr OrtAllocatorInfo cpuAllocatorInfo(CPU, OrtAllocatorType::OrtDeviceAllocator);
   return cpuAllocatorInfo;
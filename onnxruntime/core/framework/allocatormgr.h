@@ -16,7 +16,9 @@ struct DeviceAllocatorRegistrationInfo {
   size_t max_mem;
 };
 
-AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0);
+// arena_config is used if the device allocator allows an arena. a non-zero max_mem in it further limits the arena.
+AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0,
+                             const ArenaConfig& arena_config = ArenaConfig());
 
 class DeviceAllocatorRegistry {
  public:
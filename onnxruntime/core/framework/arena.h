@@ -3,12 +3,75 @@
 
 #pragma once
 
+#include <sstream>
 #include <string>
 
 #include "core/common/common.h"
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
+// How an arena grows when it needs more memory for an allocation.
+enum class ArenaExtendStrategy {
+  kNextPowerOfTwo,   // double the size of each new region
+  kSameAsRequested,  // allocate a region that fits the allocation only
+  kFixedIncrement,   // allocate regions of extend_increment_bytes, or larger if the allocation needs it
+};
+
+// Configuration for arenas that allocate their memory in regions from a device allocator.
+struct ArenaConfig {
+  // upper limit on the memory the arena allocates from the device. 0 for the device allocator's limit.
+  size_t max_mem = 0;
+  ArenaExtendStrategy extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo;
+  // size of the first region. also the size the regions start growing from again after a Shrink.
+  size_t initial_chunk_size_bytes = 1 << 20;
+  // region size for kFixedIncrement
+  size_t extend_increment_bytes = 1 << 20;
+};
+
+// Runtime statistics collected by an allocator.
+struct AllocatorStats {
+  int64_t num_allocs;             // Number of allocations.
+  int64_t bytes_in_use;           // Number of bytes in use.
+  int64_t total_allocated_bytes;  // The total number of allocated bytes by the allocator.
+  int64_t max_bytes_in_use;       // The maximum bytes in use.
+  int64_t max_alloc_size;         // The max single allocation seen.
+                                  // The upper limit what the allocator can allocate, if such a limit
+                                  // is known. Certain allocator may return 0 to indicate the limit is
+                                  // unknown.
+  int64_t bytes_limit;
+  int64_t free_bytes_in_bins;  // Allocated bytes that are free for reuse.
+  int64_t largest_free_chunk;  // The largest allocation that can be made without allocating more memory.
+  int64_t num_extends;         // Number of regions allocated from the device.
+
+  AllocatorStats() { Clear(); }
+
+  void Clear() {
+    this->num_allocs = 0;
+    this->bytes_in_use = 0;
+    this->max_bytes_in_use = 0;
+    this->max_alloc_size = 0;
+    this->bytes_limit = 0;
+    this->total_allocated_bytes = 0;
+    this->free_bytes_in_bins = 0;
+    this->largest_free_chunk = 0;
+    this->num_extends = 0;
+  }
+
+  std::string DebugString() const {
+    std::ostringstream ss;
+    ss << "Limit:           " << this->bytes_limit << "\n"
+       << "InUse:          " << this->bytes_in_use << "\n"
+       << "TotalAllocated: " << this->total_allocated_bytes << "\n"
+       << "MaxInUse:       " << this->max_bytes_in_use << "\n"
+       << "NumAllocs:      " << this->num_allocs << "\n"
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "FreeInBins:     " << this->free_bytes_in_bins << "\n"
+       << "LargestFree:    " << this->largest_free_chunk << "\n"
+       << "NumExtends:     " << this->num_extends << "\n";
+    return ss.str();
+  }
+};
+
 // The interface for arena which manage memory allocations
 // Arena will hold a pool of pre-allocate memories and manage their lifecycle.
 // Need an underline IResourceAllocator to allocate memories.
@@ -26,6 +89,10 @@ class IArenaAllocator : public IAllocator {
   void Free(void* p) override = 0;
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
+  // Return memory that isn't in use to the device allocator, if the arena holds any.
+  virtual common::Status Shrink() { return common::Status::OK(); }
+  // Get the runtime statistics, if the arena collects any.
+  virtual void GetStats(AllocatorStats* stats) { stats->Clear(); }
   const OrtAllocatorInfo& Info() const override = 0;
   // allocate host pinned memory?
 };
@@ -3,14 +3,24 @@
 
 #include "core/framework/bfc_arena.h"
 
+#include <thread>
+
 namespace onnxruntime {
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
-    : device_allocator_(std::move(resource_allocator)),
+                   size_t total_memory,
+                   const ArenaConfig& config)
+    : extend_strategy_(config.extend_strategy),
+      extend_increment_bytes_(RoundedBytes(std::max<size_t>(config.extend_increment_bytes, 1))),
+      device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
       info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
-  curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
+  if (config.max_mem != 0) {
+    total_memory = std::min(total_memory, config.max_mem);
+  }
+
+  initial_chunk_size_bytes_ = RoundedBytes(std::min(total_memory, std::max<size_t>(config.initial_chunk_size_bytes, 1)));
+  curr_region_allocation_bytes_ = initial_chunk_size_bytes_;
 
   // Allocate the requested amount of memory.
   memory_limit_ = total_memory;
@@ -32,6 +42,10 @@ BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  for (auto& shard : cache_shards_) {
+    shard.free_chunks.resize(CacheSizeClass(kMaxCachedAllocationSize) + 1);
+  }
 }
 
 BFCArena::~BFCArena() {
@@ -64,13 +78,29 @@ bool BFCArena::Extend(size_t rounded_bytes) {
     return false;
   }
 
-  // If curr_region_allocation_bytes_ is not enough to satisfy the
-  // allocation, keep multiplying by a power of two until that is
-  // sufficient.
   bool increased_allocation = false;
-  while (rounded_bytes > curr_region_allocation_bytes_) {
-    curr_region_allocation_bytes_ *= 2;
-    increased_allocation = true;
+  switch (extend_strategy_) {
+    case ArenaExtendStrategy::kNextPowerOfTwo:
+      // If curr_region_allocation_bytes_ is not enough to satisfy the
+      // allocation, keep multiplying by a power of two until that is
+      // sufficient.
+      while (rounded_bytes > curr_region_allocation_bytes_) {
+        curr_region_allocation_bytes_ *= 2;
+        increased_allocation = true;
+      }
+      break;
+    case ArenaExtendStrategy::kSameAsRequested:
+      // the first region is the initial chunk size so that small
+      // allocations don't each get their own region.
+      curr_region_allocation_bytes_ = region_manager_.regions().empty()
+                                          ? std::max(initial_chunk_size_bytes_, rounded_bytes)
+                                          : rounded_bytes;
+      break;
+    case ArenaExtendStrategy::kFixedIncrement:
+      curr_region_allocation_bytes_ = std::max(
+          region_manager_.regions().empty() ? initial_chunk_size_bytes_ : extend_increment_bytes_,
+          rounded_bytes);
+      break;
   }
 
   // Try allocating.
@@ -94,7 +124,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
     return false;
   }
 
-  if (!increased_allocation) {
+  if (extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo && !increased_allocation) {
     // Increase the region size of the next required allocation.
     curr_region_allocation_bytes_ *= 2;
   }
@@ -103,6 +133,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
                      << " bytes.";
 
   stats_.total_allocated_bytes += bytes;
+  ++stats_.num_extends;
   LOGS_DEFAULT(INFO) << "Total allocated bytes: "
                      << stats_.total_allocated_bytes;
 
@@ -176,6 +207,7 @@ void* BFCArena::Reserve(size_t size) {
   stats_.max_alloc_size = std::max<size_t>(stats_.max_alloc_size, size);
   stats_.max_bytes_in_use = std::max<size_t>(stats_.max_bytes_in_use, stats_.bytes_in_use);
   stats_.total_allocated_bytes += size;
+  UpdateBytesInUse(static_cast<int64_t>(size));
   return ptr;
 }
 
@@ -205,39 +237,203 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   // bytes, and always allocate multiples of kMinAllocationSize bytes
   // so all memory addresses are nicely byte aligned.
   size_t rounded_bytes = RoundedBytes(num_bytes);
+  const bool cacheable = rounded_bytes <= kMaxCachedAllocationSize;
+
+  if (cacheable) {
+    std::pair<void*, size_t> chunk{nullptr, 0};
+    {
+      CacheShard& shard = CacheShardForCurrentThread();
+      std::lock_guard<OrtMutex> lock(shard.mutex);
+      auto& free_chunks = shard.free_chunks[CacheSizeClass(rounded_bytes)];
+      if (!free_chunks.empty()) {
+        chunk = free_chunks.back();
+        free_chunks.pop_back();
+        shard.cached_bytes -= chunk.second;
+      }
+    }
+
+    if (chunk.first != nullptr) {
+      TrackCacheableChunk(chunk.first, rounded_bytes, chunk.second);
+      ++num_cached_allocs_;
+      UpdateBytesInUse(static_cast<int64_t>(chunk.second));
+      return chunk.first;
+    }
+  }
+
+  size_t chunk_size = 0;
+  void* ptr = AllocateFromBins(rounded_bytes, num_bytes, &chunk_size);
+  if (ptr == nullptr) {
+    // the chunks in the caches may be enough once they are coalesced
+    ReleaseCachedChunks();
+    ptr = AllocateFromBins(rounded_bytes, num_bytes, &chunk_size);
+  }
+
+  if (ptr == nullptr) {
+    // We searched all bins for an existing free chunk to use and
+    // couldn't find one.  This means we must have run out of memory,
+    // Dump the memory log for analysis.
+    if (dump_log_on_failure) {
+      std::lock_guard<OrtMutex> lock(lock_);
+      LOGS_DEFAULT(WARNING) << "BFC Arena ran out of memory trying "
+                            << "to allocate " << num_bytes
+                            << ".  Current allocation summary follows.";
+      DumpMemoryLog(rounded_bytes);
+    }
+    return nullptr;
+  }
+
+  UpdateBytesInUse(static_cast<int64_t>(chunk_size));
+
+  if (cacheable) {
+    TrackCacheableChunk(ptr, rounded_bytes, chunk_size);
+  }
 
+  return ptr;
+}
+
+void* BFCArena::AllocateFromBins(size_t rounded_bytes, size_t num_bytes, size_t* chunk_size) {
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
   std::lock_guard<OrtMutex> lock(lock_);
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-  if (ptr != nullptr) {
-    return ptr;
-  }
 
   // Try to extend
-  if (Extend(rounded_bytes)) {
+  if (ptr == nullptr && Extend(rounded_bytes)) {
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-    if (ptr != nullptr) {
-      return ptr;
+  }
+
+  if (ptr != nullptr) {
+    *chunk_size = ChunkFromHandle(region_manager_.get_handle(ptr))->size;
+  }
+
+  return ptr;
+}
+
+BFCArena::CacheShard& BFCArena::CacheShardForCurrentThread() {
+  // round robin rather than hashing the thread id, which may give every thread the same shard.
+  static std::atomic<size_t> next_shard{0};
+  static thread_local size_t shard = next_shard++ % kNumCacheShards;
+  return cache_shards_[shard];
+}
+
+void BFCArena::TrackCacheableChunk(const void* p, size_t rounded_bytes, size_t chunk_size) {
+  CacheShard& shard = CacheShardForPtr(p);
+  std::lock_guard<OrtMutex> lock(shard.mutex);
+  shard.in_use[p] = std::make_pair(rounded_bytes, chunk_size);
+}
+
+bool BFCArena::FreeToCache(void* p) {
+  size_t rounded_bytes = 0;
+  size_t chunk_size = 0;
+  {
+    CacheShard& shard = CacheShardForPtr(p);
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    auto entry = shard.in_use.find(p);
+    if (entry == shard.in_use.end()) {
+      return false;
     }
+
+    rounded_bytes = entry->second.first;
+    chunk_size = entry->second.second;
+    shard.in_use.erase(entry);
   }
 
-  // We searched all bins for an existing free chunk to use and
-  // couldn't find one.  This means we must have run out of memory,
-  // Dump the memory log for analysis.
-  if (dump_log_on_failure) {
-    LOGS_DEFAULT(WARNING) << "BFC Arena ran out of memory trying "
-                          << "to allocate " << num_bytes
-                          << ".  Current allocation summary follows.";
-    DumpMemoryLog(rounded_bytes);
+  CacheShard& shard = CacheShardForCurrentThread();
+  std::lock_guard<OrtMutex> lock(shard.mutex);
+  if (shard.cached_bytes + chunk_size > kMaxCachedBytesPerShard) {
+    return false;
+  }
+
+  shard.free_chunks[CacheSizeClass(rounded_bytes)].emplace_back(p, chunk_size);
+  shard.cached_bytes += chunk_size;
+  UpdateBytesInUse(-static_cast<int64_t>(chunk_size));
+  return true;
+}
+
+void BFCArena::ReleaseCachedChunks() {
+  std::vector<void*> chunks;
+  for (auto& shard : cache_shards_) {
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    for (auto& free_chunks : shard.free_chunks) {
+      for (const auto& chunk : free_chunks) {
+        chunks.push_back(chunk.first);
+      }
+      free_chunks.clear();
+    }
+    shard.cached_bytes = 0;
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* p : chunks) {
+    DeallocateRawInternal(p);
+  }
+}
+
+Status BFCArena::Shrink() {
+  ReleaseCachedChunks();
+
+  std::lock_guard<OrtMutex> lock(lock_);
+
+  // a region with no chunks in use has been coalesced into a single free chunk
+  std::vector<void*> free_regions;
+  for (const auto& region : region_manager_.regions()) {
+    const Chunk* c = ChunkFromHandle(region_manager_.get_handle(region.ptr()));
+    if (!c->in_use() && c->next == kInvalidChunkHandle) {
+      free_regions.push_back(region.ptr());
+    }
+  }
+
+  size_t released_bytes = 0;
+  for (void* ptr : free_regions) {
+    ChunkHandle h = region_manager_.get_handle(ptr);
+    const size_t size = ChunkFromHandle(h)->size;
+
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(ptr);
+    device_allocator_->Free(ptr);
+
+    stats_.total_allocated_bytes -= size;
+    released_bytes += size;
+  }
+
+  if (!free_regions.empty()) {
+    // start growing from the initial size again rather than from the size that was needed before
+    curr_region_allocation_bytes_ = initial_chunk_size_bytes_;
+    started_backpedal_ = false;
+
+    LOGS_DEFAULT(INFO) << "Shrink released " << free_regions.size() << " regions of "
+                       << released_bytes << " bytes. Total allocated bytes: " << stats_.total_allocated_bytes;
+  }
+
+  return Status::OK();
+}
+
+void BFCArena::UpdateBytesInUse(int64_t delta) {
+  const int64_t bytes_in_use = bytes_in_use_.fetch_add(delta, std::memory_order_relaxed) + delta;
+  if (delta > 0) {
+    int64_t max_bytes_in_use = max_bytes_in_use_.load(std::memory_order_relaxed);
+    while (bytes_in_use > max_bytes_in_use &&
+           !max_bytes_in_use_.compare_exchange_weak(max_bytes_in_use, bytes_in_use, std::memory_order_relaxed)) {
+    }
   }
-  return nullptr;
 }
 
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+  stats->bytes_in_use = bytes_in_use_;
+  stats->max_bytes_in_use = max_bytes_in_use_;
+  stats->num_allocs += num_cached_allocs_;
+
+  for (BinNum b = 0; b < kNumBins; b++) {
+    for (ChunkHandle h : BinFromIndex(b)->free_chunks) {
+      const int64_t size = static_cast<int64_t>(ChunkFromHandle(h)->size);
+      stats->free_bytes_in_bins += size;
+      stats->largest_free_chunk = std::max(stats->largest_free_chunk, size);
+    }
+  }
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -328,25 +524,33 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (FreeToCache(p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
     device_allocator_->Free(it->first);
     stats_.bytes_in_use -= it->second;
     stats_.total_allocated_bytes -= it->second;
+    UpdateBytesInUse(-static_cast<int64_t>(it->second));
     reserved_chunks_.erase(it);
   } else {
-    DeallocateRawInternal(p);
+    UpdateBytesInUse(-static_cast<int64_t>(DeallocateRawInternal(p)));
   }
 }
 
-void BFCArena::DeallocateRawInternal(void* ptr) {
+size_t BFCArena::DeallocateRawInternal(void* ptr) {
   // Find the chunk from the ptr.
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
+  const size_t size = ChunkFromHandle(h)->size;
 
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
+  return size;
 }
 
 // Merges h1 and h2 when Chunk(h1)->next is h2 and Chunk(h2)->prev is c1.
@@ -16,9 +16,12 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -38,41 +41,6 @@ namespace onnxruntime {
 #endif
 #endif
 
-// Runtime statistics collected by an allocator.
-struct AllocatorStats {
-  int64_t num_allocs;             // Number of allocations.
-  int64_t bytes_in_use;           // Number of bytes in use.
-  int64_t total_allocated_bytes;  // The total number of allocated bytes by the allocator.
-  int64_t max_bytes_in_use;       // The maximum bytes in use.
-  int64_t max_alloc_size;         // The max single allocation seen.
-                                  // The upper limit what the allocator can allocate, if such a limit
-                                  // is known. Certain allocator may return 0 to indicate the limit is
-                                  // unknown.
-  int64_t bytes_limit;
-
-  AllocatorStats() { Clear(); }
-
-  void Clear() {
-    this->num_allocs = 0;
-    this->bytes_in_use = 0;
-    this->max_bytes_in_use = 0;
-    this->max_alloc_size = 0;
-    this->bytes_limit = 0;
-    this->total_allocated_bytes = 0;
-  }
-
-  std::string DebugString() const {
-    std::ostringstream ss;
-    ss << "Limit:           " << this->bytes_limit << "\n"
-       << "InUse:          " << this->bytes_in_use << "\n"
-       << "TotalAllocated: " << this->total_allocated_bytes << "\n"
-       << "MaxInUse:       " << this->max_bytes_in_use << "\n"
-       << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
-    return ss.str();
-  }
-};
-
 // A memory allocator that implements a 'best-fit with coalescing'
 // algorithm.  This is essentially a very simple version of Doug Lea's
 // malloc (dlmalloc).
@@ -81,9 +49,16 @@ struct AllocatorStats {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// Small freed chunks are kept in caches in front of the bins so that the
+// common small, short-lived allocations don't need the arena lock. A cached
+// chunk is still in use as far as the bins are concerned, so it isn't
+// coalesced until the caches are released by ReleaseCachedChunks, which
+// also happens before an allocation fails for lack of memory.
 class BFCArena : public IArenaAllocator {
  public:
-  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory);
+  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory,
+           const ArenaConfig& config = ArenaConfig());
 
   ~BFCArena() override;
 
@@ -97,8 +72,12 @@ class BFCArena : public IArenaAllocator {
 
   void* Reserve(size_t size) override;
 
+  // Release the chunks held by the small allocation caches, then return every
+  // region that has no chunks in use to the device allocator.
+  Status Shrink() override;
+
   size_t Used() const override {
-    return stats_.bytes_in_use;
+    return static_cast<size_t>(bytes_in_use_.load(std::memory_order_relaxed));
   }
 
   size_t Max() const override {
@@ -114,15 +93,61 @@ class BFCArena : public IArenaAllocator {
     return device_allocator_->CreateFence(session_state);
   }
 
-  void GetStats(AllocatorStats* stats);
+  void GetStats(AllocatorStats* stats) override;
+
+  // Return the chunks held by the small allocation caches to the bins so
+  // they can be coalesced.
+  void ReleaseCachedChunks();
 
+  // The requested size of a chunk reused from the small allocation caches is
+  // that of the allocation the chunk was first handed out for, which has the
+  // same rounded size.
   size_t RequestedSize(const void* ptr);
 
   size_t AllocatedSize(const void* ptr);
 
  private:
   void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
-  void DeallocateRawInternal(void* ptr);
+  void* AllocateFromBins(size_t rounded_bytes, size_t num_bytes, size_t* chunk_size);
+  // Returns the size of the freed chunk.
+  size_t DeallocateRawInternal(void* ptr);
+
+  // Small allocation caches. Freed chunks of up to kMaxCachedAllocationSize
+  // are cached by rounded size in the shard of the freeing thread, and
+  // allocations look in the shard of the allocating thread, so threads
+  // mostly use different shards and the shard locks are rarely contended.
+  // As Free is only given a pointer, the sizes of the cacheable chunks that
+  // are handed out are tracked in a shard picked by the chunk address.
+  static const size_t kNumCacheShards = 16;
+  static const size_t kMaxCachedAllocationSize = 16 * 1024;
+  static const size_t kMaxCachedBytesPerShard = 1024 * 1024;
+
+  struct CacheShard {
+    OrtMutex mutex;
+    // free chunks by size class, each with the chunk size. used by the threads assigned to the shard.
+    std::vector<std::vector<std::pair<void*, size_t>>> free_chunks;
+    size_t cached_bytes = 0;
+    // rounded size and chunk size of the cacheable chunks that are handed out, for the chunk addresses
+    // assigned to the shard.
+    std::unordered_map<const void*, std::pair<size_t, size_t>> in_use;
+  };
+
+  static size_t CacheSizeClass(size_t rounded_bytes) {
+    return rounded_bytes / kMinAllocationSize - 1;
+  }
+
+  CacheShard& CacheShardForPtr(const void* p) {
+    return cache_shards_[(reinterpret_cast<std::uintptr_t>(p) >> kMinAllocationBits) % kNumCacheShards];
+  }
+
+  CacheShard& CacheShardForCurrentThread();
+
+  void TrackCacheableChunk(const void* p, size_t rounded_bytes, size_t chunk_size);
+
+  // Returns true if p was cached, false if it wasn't a cacheable chunk or the shard is full.
+  bool FreeToCache(void* p);
+
+  void UpdateBytesInUse(int64_t delta);
 
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
@@ -306,6 +331,13 @@ class BFCArena : public IArenaAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr, "Could not find Region for ", ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -402,6 +434,9 @@ class BFCArena : public IArenaAllocator {
 
   // Structures immutable after construction
   size_t memory_limit_ = 0;
+  ArenaExtendStrategy extend_strategy_;
+  size_t initial_chunk_size_bytes_;
+  size_t extend_increment_bytes_;
 
   int Log2FloorNonZeroSlow(uint64_t n) {
     int r = 0;
@@ -476,6 +511,15 @@ class BFCArena : public IArenaAllocator {
 
   AllocatorStats stats_;
 
+  // bytes_in_use and max_bytes_in_use in stats_ count cached chunks as in
+  // use, and num_allocs in stats_ only counts allocations from the bins.
+  // These hold the values GetStats reports, and are updated without the lock.
+  std::atomic<int64_t> bytes_in_use_{0};
+  std::atomic<int64_t> max_bytes_in_use_{0};
+  std::atomic<int64_t> num_cached_allocs_{0};
+
+  CacheShard cache_shards_[kNumCacheShards];
+
   OrtAllocatorInfo info_;
 
   std::unordered_map<void*, size_t> reserved_chunks_;
@@ -0,0 +1,376 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/cost_based_placement_transformer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <unordered_set>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/data_types.h"
+#include "core/framework/kernel_registry.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+namespace {
+
+const std::string kDeviceTimeSuffix = "_device_time";
+const std::string kKernelTimeSuffix = "_kernel_time";
+
+// the value of the field key of an event in a profile, which EndProfiling writes one per line
+bool FindField(const std::string& line, const std::string& key, std::string& value) {
+  const std::string field = "\"" + key + "\" :";
+  auto pos = line.find(field);
+  if (pos == std::string::npos)
+    return false;
+  pos = line.find_first_not_of(' ', pos + field.size());
+  if (pos == std::string::npos)
+    return false;
+
+  if (line[pos] == '"') {
+    auto end = line.find('"', pos + 1);
+    if (end == std::string::npos)
+      return false;
+    value = line.substr(pos + 1, end - pos - 1);
+  } else {
+    auto end = line.find_first_of(",}", pos);
+    if (end == std::string::npos)
+      return false;
+    value = line.substr(pos, end - pos);
+  }
+  return true;
+}
+
+bool RemoveSuffix(std::string& name, const std::string& suffix) {
+  if (name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+    return false;
+  name.resize(name.size() - suffix.size());
+  return true;
+}
+
+struct TotalTime {
+  double us = 0;
+  int count = 0;
+
+  void Add(double time_us) {
+    us += time_us;
+    ++count;
+  }
+  double Average() const { return us / count; }
+};
+
+// the size of the tensor of arg, or false if its type or shape isn't known statically
+bool TryGetTensorBytes(const NodeArg& arg, size_t& bytes) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  if (type == nullptr || !type->has_tensor_type() || shape == nullptr)
+    return false;
+
+  size_t size = DataTypeImpl::TypeFromProto(*type)->AsTensorType()->GetElementType()->Size();
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value() || dim.dim_value() < 0)
+      return false;
+    size *= static_cast<size_t>(dim.dim_value());
+  }
+  bytes = size;
+  return true;
+}
+
+// the size of the inputs and outputs of node, or false if one isn't known statically
+bool TryGetNodeBytes(const Node& node, size_t& bytes) {
+  bytes = 0;
+  auto add_bytes = [&bytes](const NodeArg& arg) {
+    size_t arg_bytes = 0;
+    if (arg.Exists() && !TryGetTensorBytes(arg, arg_bytes))
+      return false;
+    bytes += arg_bytes;
+    return true;
+  };
+  for (const auto* arg : node.InputDefs()) {
+    if (!add_bytes(*arg))
+      return false;
+  }
+  for (const auto* arg : node.OutputDefs()) {
+    if (!add_bytes(*arg))
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+Status PlacementCostModel::LoadProfile(const std::string& profile_file) {
+  std::ifstream profile(profile_file);
+  if (!profile)
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Failed to open the profile ", profile_file);
+
+  std::unordered_map<std::string, TotalTime> device_nodes;
+  std::unordered_map<std::string, TotalTime> device_ops;
+  std::unordered_set<std::string> device_node_names;
+  // the op type and kernel time of each node
+  std::unordered_map<std::string, std::pair<std::string, TotalTime>> kernel_nodes;
+
+  std::string line, category, name, duration, op_name, provider;
+  while (std::getline(profile, line)) {
+    if (!FindField(line, "cat", category) || category != "Node" || !FindField(line, "name", name) ||
+        !FindField(line, "dur", duration) || !FindField(line, "op_name", op_name))
+      continue;
+    const double time_us = std::strtod(duration.c_str(), nullptr);
+
+    if (RemoveSuffix(name, kDeviceTimeSuffix)) {
+      if (!FindField(line, "provider", provider))
+        continue;
+      device_nodes[TimeKey(provider, name)].Add(time_us);
+      device_ops[TimeKey(provider, op_name)].Add(time_us);
+      device_node_names.insert(name);
+    } else if (RemoveSuffix(name, kKernelTimeSuffix)) {
+      auto& kernel_node = kernel_nodes[name];
+      kernel_node.first = op_name;
+      kernel_node.second.Add(time_us);
+    }
+  }
+
+  for (const auto& device_node : device_nodes) {
+    node_times_us[device_node.first] = device_node.second.Average();
+  }
+  for (const auto& device_op : device_ops) {
+    op_times_us[device_op.first] = device_op.second.Average();
+  }
+
+  // the kernel time of a device node is the time of its launch
+  std::unordered_map<std::string, TotalTime> cpu_ops;
+  for (const auto& kernel_node : kernel_nodes) {
+    if (device_node_names.count(kernel_node.first))
+      continue;
+    const auto& total = kernel_node.second.second;
+    node_times_us[TimeKey(kCpuExecutionProvider, kernel_node.first)] = total.Average();
+    auto& cpu_op = cpu_ops[TimeKey(kCpuExecutionProvider, kernel_node.second.first)];
+    cpu_op.us += total.us;
+    cpu_op.count += total.count;
+  }
+  for (const auto& cpu_op : cpu_ops) {
+    op_times_us[cpu_op.first] = cpu_op.second.Average();
+  }
+  return Status::OK();
+}
+
+double PlacementCostModel::KernelTime(const Node& node, const ProviderType& provider, size_t bytes) const {
+  auto it = node_times_us.find(TimeKey(provider, node.Name()));
+  if (it != node_times_us.end())
+    return it->second;
+  it = op_times_us.find(TimeKey(provider, node.OpType()));
+  if (it != op_times_us.end())
+    return it->second;
+
+  if (provider == kCpuExecutionProvider)
+    return cpu_node_us + cpu_us_per_byte * bytes;
+  return device_node_us + device_us_per_byte * bytes;
+}
+
+double PlacementCostModel::NodeTime(const Node& node) const {
+  size_t bytes = 0;
+  auto add_bytes = [&bytes](const NodeArg& arg) {
+    size_t arg_bytes = 0;
+    if (arg.Exists() && TryGetTensorBytes(arg, arg_bytes))
+      bytes += arg_bytes;
+  };
+  for (const auto* arg : node.InputDefs()) {
+    add_bytes(*arg);
+  }
+  for (const auto* arg : node.OutputDefs()) {
+    add_bytes(*arg);
+  }
+  const auto& provider = node.GetExecutionProviderType();
+  return KernelTime(node, provider.empty() ? kCpuExecutionProvider : provider, bytes);
+}
+
+bool PlacementCostModel::IsNodeTimeKnown(const Node& node) const {
+  const auto& provider_type = node.GetExecutionProviderType();
+  const ProviderType& provider = provider_type.empty() ? kCpuExecutionProvider : provider_type;
+  if (node_times_us.count(TimeKey(provider, node.Name())) || op_times_us.count(TimeKey(provider, node.OpType())))
+    return true;
+  if (!node.ImplicitInputDefs().empty())
+    return false;
+
+  auto is_static = [](const NodeArg* arg) {
+    size_t arg_bytes = 0;
+    return !arg->Exists() || TryGetTensorBytes(*arg, arg_bytes);
+  };
+  return std::all_of(node.InputDefs().cbegin(), node.InputDefs().cend(), is_static) &&
+         std::all_of(node.OutputDefs().cbegin(), node.OutputDefs().cend(), is_static);
+}
+
+const KernelDef* CostBasedPlacementTransformer::FindKernelDef(const onnxruntime::Node& node) const {
+  for (auto* registry : kernels_registries_) {
+    const auto* kernel_create_info = registry->TryFindKernel(node, provider_type_);
+    if (kernel_create_info != nullptr)
+      return kernel_create_info->kernel_def.get();
+  }
+  return nullptr;
+}
+
+bool CostBasedPlacementTransformer::HasCpuKernel(onnxruntime::Node& node) const {
+  // the kernels are matched to the provider of the node
+  const auto provider = node.GetExecutionProviderType();
+  node.SetExecutionProviderType(kCpuExecutionProvider);
+  bool found = false;
+  for (auto* registry : kernels_registries_) {
+    if (registry->TryFindKernel(node, kCpuExecutionProvider) != nullptr) {
+      found = true;
+      break;
+    }
+  }
+  node.SetExecutionProviderType(provider);
+  return found;
+}
+
+double CostBasedPlacementTransformer::PlacementCost(const onnxruntime::Graph& graph,
+                                                    const std::vector<onnxruntime::Node*>& cluster,
+                                                    const std::unordered_map<NodeIndex, size_t>& node_bytes,
+                                                    const onnxruntime::ProviderType& placement) const {
+  std::unordered_set<NodeIndex> members;
+  for (const auto* node : cluster) {
+    members.insert(node->Index());
+  }
+
+  // where an input or output of a node is, with the cluster at placement. the nodes of the other providers are
+  // taken to use CPU memory.
+  auto location = [&](const Node& node, bool is_input, int index) -> ProviderType {
+    const auto& provider = members.count(node.Index()) ? placement : node.GetExecutionProviderType();
+    if (provider != provider_type_)
+      return kCpuExecutionProvider;
+    const auto* kernel_def = FindKernelDef(node);
+    const size_t arg_index = static_cast<size_t>(index);
+    if (kernel_def != nullptr &&
+        MemTypeOnCpuExplicitly(is_input ? kernel_def->InputMemoryType(arg_index)
+                                        : kernel_def->OutputMemoryType(arg_index)))
+      return kCpuExecutionProvider;
+    return provider_type_;
+  };
+
+  double cost = 0;
+  // an arg is copied once to each location that reads it
+  std::set<std::pair<const NodeArg*, ProviderType>> copies;
+  auto add_copy = [&](const NodeArg& arg, const ProviderType& from, const ProviderType& to) {
+    size_t bytes = 0;
+    if (from != to && copies.emplace(&arg, to).second && TryGetTensorBytes(arg, bytes))
+      cost += cost_model_.CopyTime(bytes);
+  };
+
+  const auto& graph_inputs = graph.GetInputs();
+  const auto& graph_outputs = graph.GetOutputs();
+  for (const auto* node : cluster) {
+    cost += cost_model_.KernelTime(*node, placement, node_bytes.at(node->Index()));
+
+    for (auto it = node->InputEdgesBegin(); it != node->InputEdgesEnd(); ++it) {
+      const auto& source = it->GetNode();
+      add_copy(*source.OutputDefs()[it->GetSrcArgIndex()], location(source, false, it->GetSrcArgIndex()),
+               location(*node, true, it->GetDstArgIndex()));
+    }
+    for (auto it = node->OutputEdgesBegin(); it != node->OutputEdgesEnd(); ++it) {
+      const auto& destination = it->GetNode();
+      if (!members.count(destination.Index())) {
+        add_copy(*node->OutputDefs()[it->GetSrcArgIndex()], location(*node, false, it->GetSrcArgIndex()),
+                 location(destination, true, it->GetDstArgIndex()));
+      }
+    }
+
+    // the graph inputs are fed, and the outputs fetched, on CPU
+    const auto& inputs = node->InputDefs();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (std::find(graph_inputs.cbegin(), graph_inputs.cend(), inputs[i]) != graph_inputs.cend())
+        add_copy(*inputs[i], kCpuExecutionProvider, location(*node, true, static_cast<int>(i)));
+    }
+    const auto& outputs = node->OutputDefs();
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      if (std::find(graph_outputs.cbegin(), graph_outputs.cend(), outputs[i]) != graph_outputs.cend())
+        add_copy(*outputs[i], location(*node, false, static_cast<int>(i)), kCpuExecutionProvider);
+    }
+  }
+  return cost;
+}
+
+Status CostBasedPlacementTransformer::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  // the nodes that may be moved, with the size of their inputs and outputs
+  std::unordered_map<NodeIndex, size_t> candidate_bytes;
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  for (auto index : order) {
+    auto* node = graph.GetNode(index);
+    if (node == nullptr)
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT);
+
+    if (node->GetExecutionProviderType() != provider_type_ || !node->GetAttributeNameToMutableSubgraphMap().empty())
+      continue;
+
+    size_t bytes = 0;
+    if (!TryGetNodeBytes(*node, bytes) || !HasCpuKernel(*node))
+      continue;
+    // a node that runs on CPU for longer than the copies of its inputs and outputs can't save time there
+    if (cost_model_.KernelTime(*node, kCpuExecutionProvider, bytes) >=
+        cost_model_.KernelTime(*node, provider_type_, bytes) + cost_model_.CopyTime(bytes))
+      continue;
+    candidate_bytes[index] = bytes;
+  }
+  if (candidate_bytes.empty())
+    return Status::OK();
+
+  // group the connected candidates
+  std::unordered_map<NodeIndex, NodeIndex> parents;
+  for (const auto& candidate : candidate_bytes) {
+    parents[candidate.first] = candidate.first;
+  }
+  auto find_root = [&parents](NodeIndex index) {
+    while (parents[index] != index) {
+      parents[index] = parents[parents[index]];
+      index = parents[index];
+    }
+    return index;
+  };
+  for (const auto& candidate : candidate_bytes) {
+    const auto* node = graph.GetNode(candidate.first);
+    for (auto it = node->OutputEdgesBegin(); it != node->OutputEdgesEnd(); ++it) {
+      const auto destination = it->GetNode().Index();
+      if (candidate_bytes.count(destination))
+        parents[find_root(destination)] = find_root(candidate.first);
+    }
+  }
+
+  // the clusters in the topological order of their first node, so a cluster is placed after its producers
+  std::vector<std::vector<Node*>> clusters;
+  std::unordered_map<NodeIndex, size_t> cluster_indices;
+  for (auto index : order) {
+    if (!candidate_bytes.count(index))
+      continue;
+    auto inserted = cluster_indices.emplace(find_root(index), clusters.size());
+    if (inserted.second)
+      clusters.emplace_back();
+    clusters[inserted.first->second].push_back(graph.GetNode(index));
+  }
+
+  size_t num_moved = 0;
+  for (const auto& cluster : clusters) {
+    if (PlacementCost(graph, cluster, candidate_bytes, kCpuExecutionProvider) <
+        PlacementCost(graph, cluster, candidate_bytes, provider_type_)) {
+      for (auto* node : cluster) {
+        node->SetExecutionProviderType(kCpuExecutionProvider);
+      }
+      num_moved += cluster.size();
+    }
+  }
+
+  if (num_moved > 0) {
+    LOGS_DEFAULT(INFO) << "Moved " << num_moved << " nodes from " << provider_type_ << " to "
+                       << kCpuExecutionProvider << " by their cost.";
+    modified = true;
+  }
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/graph/graph_transformer.h"
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+// The costs, in microseconds, that the placement between the CPU and a device weighs.
+// The defaults model a discrete GPU on PCIe.
+struct PlacementCostModel {
+  // a kernel without a measured time costs node_us plus us_per_byte for each byte of its inputs and outputs
+  double cpu_node_us = 1.0;
+  double cpu_us_per_byte = 0.0005;      // 2 GB/s
+  double device_node_us = 10.0;         // the launch, and the executor's fences and synchronization
+  double device_us_per_byte = 0.00001;  // 100 GB/s
+
+  // a copy between the CPU and the device, including its synchronization
+  double copy_us = 15.0;
+  double copy_us_per_byte = 0.0002;  // 5 GB/s
+
+  // the measured time of a kernel, keyed by TimeKey of its provider and node name, or of its provider and op type
+  static std::string TimeKey(const ProviderType& provider, const std::string& name) { return provider + '\n' + name; }
+  std::unordered_map<std::string, double> node_times_us;
+  std::unordered_map<std::string, double> op_times_us;
+
+  // reads the average time of each node and op type from a profile a session of the same model wrote with
+  // SessionOptions::enable_profiling. the device time of a node is taken from its _device_time events, and its
+  // kernel time is the time of a CPU kernel if it has none, so the profile of a session with a device must be taken
+  // with sequential execution.
+  Status LoadProfile(const std::string& profile_file);
+
+  double KernelTime(const Node& node, const ProviderType& provider, size_t bytes) const;
+  // the kernel time of node on the provider it's assigned to, counting the bytes of the args of static sizes
+  double NodeTime(const Node& node) const;
+  // whether NodeTime of node is a measured time or counts the bytes of all of its args, rather than an estimate
+  // that leaves out args of dynamic sizes or the subgraphs the node runs
+  bool IsNodeTimeKnown(const Node& node) const;
+  double CopyTime(size_t bytes) const { return copy_us + copy_us_per_byte * bytes; }
+};
+
+// Moves the nodes an execution provider has been assigned to the CPU where the cost model estimates that running
+// them there, and the copies between the CPU and the device that follow from it, take less time, e.g. the small
+// shape computations between a Shape node and the Reshape that reads the shape on CPU.
+// The nodes considered are the ones with a CPU kernel whose inputs and outputs have static sizes and would run on
+// the CPU for less than the copies they may save. Connected nodes are moved together, so a chain of them isn't split
+// by a copy, and the graph inputs and outputs are placed on CPU.
+// Must run after partitioning and before the transformers that depend on the placement as well as the insertion of
+// the casts and copies.
+class CostBasedPlacementTransformer : public onnxruntime::GraphTransformer {
+ public:
+  CostBasedPlacementTransformer(const std::string& name, onnxruntime::ProviderType provider_type,
+                                PlacementCostModel cost_model)
+      : onnxruntime::GraphTransformer(name, "Transformer to place the nodes of an execution provider by their cost"),
+        provider_type_(provider_type),
+        cost_model_(std::move(cost_model)) {
+  }
+
+  void AddKernelRegistries(const std::vector<const KernelRegistry*>& kernels) {
+    for (auto* kernel : kernels) {
+      if (kernel)
+        kernels_registries_.push_back(kernel);
+    }
+  }
+
+  void AddKernelRegistry(const KernelRegistry& kernel) {
+    kernels_registries_.push_back(&kernel);
+  }
+
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+
+ private:
+  const KernelDef* FindKernelDef(const onnxruntime::Node& node) const;
+  bool HasCpuKernel(onnxruntime::Node& node) const;
+  // the time of the nodes of a cluster with them placed at placement, and of the copies to and from them
+  double PlacementCost(const onnxruntime::Graph& graph, const std::vector<onnxruntime::Node*>& cluster,
+                       const std::unordered_map<NodeIndex, size_t>& node_bytes,
+                       const onnxruntime::ProviderType& placement) const;
+
+  onnxruntime::ProviderType provider_type_;
+  PlacementCostModel cost_model_;
+  std::vector<const KernelRegistry*> kernels_registries_;
+};
+}  // namespace onnxruntime
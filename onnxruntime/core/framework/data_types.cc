@@ -3,6 +3,7 @@
 
 #include "core/framework/data_types.h"
 #include "core/framework/tensor.h"
+#include "core/framework/tensor_seq.h"
 #include "core/graph/onnx_protobuf.h"
 
 #ifdef __GNUC__
@@ -696,6 +697,8 @@ ORT_REGISTER_NON_ONNX_TYPE(uint32_t);
 ORT_REGISTER_NON_ONNX_TYPE(uint64_t);
 ORT_REGISTER_NON_ONNX_TYPE(MLFloat16);
 ORT_REGISTER_NON_ONNX_TYPE(BFloat16);
+// a seq(tensor(float)) is the VectorFloat of the ML ops, so a sequence of tensors has no TypeProto
+ORT_REGISTER_NON_ONNX_TYPE(TensorSeq);
 
 const std::vector<MLDataType>& DataTypeImpl::AllFixedSizeTensorTypes() {
   static std::vector<MLDataType> all_fixed_size_tensor_types =
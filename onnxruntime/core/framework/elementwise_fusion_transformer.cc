@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/elementwise_fusion_transformer.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+namespace {
+
+// limits of the FusedElementwise kernels
+constexpr size_t kMaxFusedInputs = 8;
+constexpr size_t kMaxFusedNodes = 16;
+
+bool IsFusableOp(const Node& node) {
+  static const std::vector<std::pair<std::string, ONNX_NAMESPACE::OperatorSetVersion>> ops = {
+      {"Add", 7}, {"Sub", 7}, {"Mul", 7}, {"Div", 7}, {"Abs", 6}, {"Neg", 6}, {"Reciprocal", 6}, {"Sqrt", 6},
+      {"Exp", 6}, {"Log", 6}, {"Relu", 6}, {"Sigmoid", 6}, {"Tanh", 6}};
+  return std::any_of(ops.cbegin(), ops.cend(), [&node](const std::pair<std::string, OperatorSetVersion>& op) {
+    return utils::IsSupportedOptypeVersionAndDomain(node, op.first, op.second);
+  });
+}
+
+int32_t FloatElemType(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (!arg.Exists() || type == nullptr || !type->has_tensor_type())
+    return TensorProto_DataType_UNDEFINED;
+  const auto elem_type = type->tensor_type().elem_type();
+  if (elem_type != TensorProto_DataType_FLOAT && elem_type != TensorProto_DataType_FLOAT16 &&
+      elem_type != TensorProto_DataType_DOUBLE)
+    return TensorProto_DataType_UNDEFINED;
+  return elem_type;
+}
+
+// number of distinct args read by a group of nodes that are not produced inside it
+size_t CountGroupInputs(const std::vector<Node*>& nodes) {
+  std::unordered_set<const NodeArg*> produced;
+  for (auto* node : nodes) {
+    produced.insert(node->OutputDefs()[0]);
+  }
+  std::unordered_set<const NodeArg*> inputs;
+  for (auto* node : nodes) {
+    for (auto* input : node->InputDefs()) {
+      if (!produced.count(input))
+        inputs.insert(input);
+    }
+  }
+  return inputs.size();
+}
+
+}  // namespace
+
+Status ElementwiseFusionTransformer::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::unordered_map<NodeIndex, size_t> positions;
+  std::unordered_map<const NodeArg*, NodeIndex> producers;
+  std::unordered_map<const NodeArg*, std::vector<NodeIndex>> consumers;
+  for (size_t i = 0; i < order.size(); ++i) {
+    const auto* node = graph.GetNode(order[i]);
+    positions[node->Index()] = i;
+    for (auto* output : node->OutputDefs()) {
+      producers[output] = node->Index();
+    }
+    for (auto* input : node->InputDefs()) {
+      consumers[input].push_back(node->Index());
+    }
+    for (auto* input : node->ImplicitInputDefs()) {
+      consumers[input].push_back(node->Index());
+    }
+  }
+  const auto& graph_outputs = graph.GetOutputs();
+  const std::unordered_set<const NodeArg*> graph_output_set(graph_outputs.cbegin(), graph_outputs.cend());
+
+  auto is_fusable = [this](const Node& node, int32_t elem_type) {
+    if (node.GetExecutionProviderType() != provider_type_ || !IsFusableOp(node) ||
+        FloatElemType(*node.OutputDefs()[0]) != elem_type)
+      return false;
+    const auto& inputs = node.InputDefs();
+    return std::all_of(inputs.cbegin(), inputs.cend(),
+                       [elem_type](const NodeArg* input) { return FloatElemType(*input) == elem_type; });
+  };
+
+  bool fused = false;
+  // grow each group backwards from its last node, so that only the last node's output leaves the group
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    Node* root = graph.GetNode(*it);
+    if (root == nullptr)
+      continue;
+    const int32_t elem_type = FloatElemType(*root->OutputDefs()[0]);
+    if (elem_type == TensorProto_DataType_UNDEFINED || !is_fusable(*root, elem_type))
+      continue;
+
+    std::vector<Node*> nodes{root};
+    std::unordered_set<NodeIndex> group{root->Index()};
+    bool grown = true;
+    while (grown && nodes.size() < kMaxFusedNodes) {
+      grown = false;
+      for (size_t n = 0; n < nodes.size() && nodes.size() < kMaxFusedNodes; ++n) {
+        for (auto* input : nodes[n]->InputDefs()) {
+          auto producer_it = producers.find(input);
+          if (producer_it == producers.end() || group.count(producer_it->second) || graph_output_set.count(input))
+            continue;
+          Node* producer = graph.GetNode(producer_it->second);
+          if (producer == nullptr || !is_fusable(*producer, elem_type))
+            continue;
+          const auto& input_consumers = consumers[input];
+          if (!std::all_of(input_consumers.cbegin(), input_consumers.cend(),
+                           [&group](NodeIndex consumer) { return group.count(consumer) > 0; }))
+            continue;
+
+          nodes.push_back(producer);
+          if (CountGroupInputs(nodes) > kMaxFusedInputs) {
+            nodes.pop_back();
+            continue;
+          }
+          group.insert(producer->Index());
+          grown = true;
+        }
+      }
+    }
+    if (nodes.size() < 2)
+      continue;
+
+    std::sort(nodes.begin(), nodes.end(),
+              [&positions](const Node* a, const Node* b) { return positions[a->Index()] < positions[b->Index()]; });
+
+    // operand of each arg in the fused node: the index of an input, or the number of inputs plus the index of a step
+    std::unordered_map<const NodeArg*, int64_t> steps;
+    for (size_t s = 0; s < nodes.size(); ++s) {
+      steps[nodes[s]->OutputDefs()[0]] = static_cast<int64_t>(s);
+    }
+    std::vector<NodeArg*> fused_inputs;
+    std::unordered_map<const NodeArg*, int64_t> input_indices;
+    for (auto* node : nodes) {
+      for (auto* input : node->MutableInputDefs()) {
+        if (!steps.count(input) && !input_indices.count(input)) {
+          input_indices[input] = static_cast<int64_t>(fused_inputs.size());
+          fused_inputs.push_back(input);
+        }
+      }
+    }
+
+    std::vector<std::string> ops;
+    std::vector<int64_t> operands;
+    const int64_t num_inputs = static_cast<int64_t>(fused_inputs.size());
+    for (auto* node : nodes) {
+      ops.push_back(node->OpType());
+      const auto& inputs = node->InputDefs();
+      for (size_t i = 0; i < 2; ++i) {
+        if (i >= inputs.size()) {
+          operands.push_back(-1);
+        } else {
+          auto step_it = steps.find(inputs[i]);
+          operands.push_back(step_it != steps.end() ? num_inputs + step_it->second : input_indices[inputs[i]]);
+        }
+      }
+    }
+
+    NodeArg* output = root->MutableOutputDefs()[0];
+    const std::string name = graph.GenerateNodeName("FusedElementwise_" + root->Name());
+    for (auto* node : nodes) {
+      graph.RemoveNode(node->Index());
+    }
+
+    auto& fused_node = graph.AddNode(name, "FusedElementwise", "fused element-wise ops", fused_inputs,
+                                     std::vector<NodeArg*>{output}, nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("operands", operands);
+    fused_node.SetExecutionProviderType(provider_type_);
+    fused = true;
+  }
+
+  if (fused) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/graph/graph_transformer.h"
+#include "core/common/common.h"
+
+namespace onnxruntime {
+// Replaces each chain of element-wise nodes an execution provider has been assigned with a FusedElementwise node,
+// which evaluates the chain in one kernel instead of reading and writing every intermediate tensor.
+// The fused ops are Add, Sub, Mul and Div with broadcasting and the unary math and activation ops without
+// attributes. A chain grows backwards from its last node through producers whose outputs are only read inside the
+// chain, so it can reuse intermediate results (e.g. x * Sigmoid(x)) and the fused node has a single output.
+// Must run after partitioning. The execution provider must register FusedElementwise kernels.
+class ElementwiseFusionTransformer : public onnxruntime::GraphTransformer {
+ public:
+  ElementwiseFusionTransformer(const std::string& name, onnxruntime::ProviderType provider_type)
+      : onnxruntime::GraphTransformer(name, "Transformer to fuse chains of element-wise ops"),
+        provider_type_(provider_type) {
+  }
+
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+
+ private:
+  onnxruntime::ProviderType provider_type_;
+};
+}  // namespace onnxruntime
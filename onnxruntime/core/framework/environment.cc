@@ -2,10 +2,19 @@
 // Licensed under the MIT License.
 
 #include "core/framework/environment.h"
+
+#include <chrono>
+#include <limits>
+#include <thread>
+
+#include "core/common/task_thread_pool.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/bfc_arena.h"
 #include "core/graph/constants.h"
 #include "core/graph/contrib_ops/contrib_defs.h"
 #include "core/graph/op.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
 #include "onnx/defs/operator_sets.h"
 #include "onnx/defs/operator_sets-ml.h"
 
@@ -17,6 +26,29 @@ std::once_flag schemaRegistrationOnceFlag;
 
 std::atomic<bool> Environment::is_initialized_{false};
 
+namespace {
+OrtMutex intra_op_thread_pool_mutex;
+int intra_op_thread_pool_size = 0;                        // GUARDED_BY(intra_op_thread_pool_mutex)
+std::atomic<int> intra_op_thread_pool_spin_us{0};
+std::unique_ptr<TaskThreadPool> intra_op_thread_pool;     // GUARDED_BY(intra_op_thread_pool_mutex)
+std::atomic<TaskThreadPool*> intra_op_thread_pool_ptr{nullptr};
+// the pool used in place of the process-wide one on this thread
+thread_local TaskThreadPool* current_thread_intra_op_thread_pool = nullptr;
+
+OrtMutex shared_cpu_arena_mutex;
+ArenaConfig shared_cpu_arena_config;                 // GUARDED_BY(shared_cpu_arena_mutex)
+std::shared_ptr<IArenaAllocator> shared_cpu_arena;  // GUARDED_BY(shared_cpu_arena_mutex)
+
+void MLASCALL MlasExecuteThreadedOnIntraOpPool(void* thread_pool, PMLAS_THREADED_ROUTINE threaded_routine,
+                                               void* context, int32_t iterations) {
+  auto* pool = current_thread_intra_op_thread_pool != nullptr ? current_thread_intra_op_thread_pool
+                                                              : static_cast<TaskThreadPool*>(thread_pool);
+  pool->ParallelFor(iterations, [threaded_routine, context](int32_t index) {
+    threaded_routine(context, index);
+  });
+}
+}  // namespace
+
 Status Environment::Create(std::unique_ptr<Environment>& environment) {
   environment = std::unique_ptr<Environment>(new Environment());
   auto status = environment->Initialize();
@@ -71,26 +103,37 @@ Status Environment::Initialize() {
     // Register MemCpy schema;
 
     // These ops are internal-only, so register outside of onnx
+    // a copy node copies each of its inputs to the output at the same index, so that the copies in the same
+    // direction of the outputs of a node are batched
+    auto propagate_shapes_and_types = [](InferenceContext& ctx) {
+      for (size_t i = 0; i < ctx.getNumInputs(); ++i) {
+        propagateElemTypeFromInputToOutput(ctx, i, i);
+        if (hasInputShape(ctx, i)) {
+          propagateShapeFromInputToOutput(ctx, i, i);
+        }
+      }
+    };
+
     ORT_ATTRIBUTE_UNUSED ONNX_OPERATOR_SCHEMA(MemcpyFromHost)
-        .Input(0, "X", "input", "T")
-        .Output(0, "Y", "output", "T")
+        .Input(0, "X", "inputs", "T", OpSchema::Variadic, false)
+        .Output(0, "Y", "outputs", "T", OpSchema::Variadic, false)
         .TypeConstraint(
             "T",
             OpSchema::all_tensor_types(),
             "Constrain to any tensor type. If the dtype attribute is not provided this must be a valid output type.")
-        .TypeAndShapeInferenceFunction(propagateShapeAndTypeFromFirstInput)
+        .TypeAndShapeInferenceFunction(propagate_shapes_and_types)
         .SetDoc(R"DOC(
 Internal copy node
 )DOC");
 
     ORT_ATTRIBUTE_UNUSED ONNX_OPERATOR_SCHEMA(MemcpyToHost)
-        .Input(0, "X", "input", "T")
-        .Output(0, "Y", "output", "T")
+        .Input(0, "X", "inputs", "T", OpSchema::Variadic, false)
+        .Output(0, "Y", "outputs", "T", OpSchema::Variadic, false)
         .TypeConstraint(
             "T",
             OpSchema::all_tensor_types(),
             "Constrain to any tensor type. If the dtype attribute is not provided this must be a valid output type.")
-        .TypeAndShapeInferenceFunction(propagateShapeAndTypeFromFirstInput)
+        .TypeAndShapeInferenceFunction(propagate_shapes_and_types)
         .SetDoc(R"DOC(
 Internal copy node
 )DOC");
@@ -105,7 +148,145 @@ Internal copy node
   return status;
 }
 
+Status Environment::SetIntraOpThreadPoolSize(int num_threads) {
+  if (num_threads < 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid intra-op thread pool size: ", num_threads);
+  }
+
+  std::lock_guard<OrtMutex> lock(intra_op_thread_pool_mutex);
+  if (intra_op_thread_pool) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "The intra-op thread pool has already been created with ", intra_op_thread_pool->NumThreads(),
+                           " threads. Its size must be set before the first session is created.");
+  }
+
+  intra_op_thread_pool_size = num_threads;
+  return Status::OK();
+}
+
+Status Environment::SetIntraOpThreadPoolSpinDuration(int spin_us) {
+  if (spin_us < 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid intra-op thread pool spin duration: ", spin_us);
+  }
+
+  std::lock_guard<OrtMutex> lock(intra_op_thread_pool_mutex);
+  intra_op_thread_pool_spin_us = spin_us;
+  if (intra_op_thread_pool) {
+    intra_op_thread_pool->SetSpinDuration(std::chrono::microseconds(spin_us));
+  }
+  return Status::OK();
+}
+
+int Environment::GetIntraOpThreadPoolSpinDuration() {
+  return intra_op_thread_pool_spin_us;
+}
+
+Status Environment::KeepIntraOpThreadPoolHot(int duration_us) {
+  if (duration_us < 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid duration to keep the intra-op thread pool hot: ",
+                           duration_us);
+  }
+
+  auto* pool = GetIntraOpThreadPool();
+  if (pool != nullptr) {
+    pool->KeepWorkersHot(std::chrono::microseconds(duration_us));
+  }
+  return Status::OK();
+}
+
+TaskThreadPool* Environment::GetIntraOpThreadPool() {
+  if (current_thread_intra_op_thread_pool != nullptr) {
+    return current_thread_intra_op_thread_pool;
+  }
+
+  auto* pool = intra_op_thread_pool_ptr.load();
+  if (pool != nullptr || !is_initialized_) {
+    return pool;
+  }
+
+  std::lock_guard<OrtMutex> lock(intra_op_thread_pool_mutex);
+  if (!intra_op_thread_pool) {
+    int num_threads = intra_op_thread_pool_size == 0 ? static_cast<int>(std::thread::hardware_concurrency())
+                                                     : intra_op_thread_pool_size;
+    intra_op_thread_pool = std::make_unique<TaskThreadPool>(std::max(num_threads, 1));
+    intra_op_thread_pool->SetSpinDuration(std::chrono::microseconds(intra_op_thread_pool_spin_us.load()));
+
+    // route all MLAS threading through the pool. ParallelFor runs iterations on the calling thread as well as the
+    // workers, so MLAS may use as many threads as the pool has.
+    MlasSetThreadPool(MlasExecuteThreadedOnIntraOpPool, intra_op_thread_pool.get(), intra_op_thread_pool->NumThreads());
+    intra_op_thread_pool_ptr = intra_op_thread_pool.get();
+  }
+
+  return intra_op_thread_pool.get();
+}
+
+TaskThreadPool* Environment::SetCurrentThreadIntraOpThreadPool(TaskThreadPool* pool) {
+  auto* previous = current_thread_intra_op_thread_pool;
+  current_thread_intra_op_thread_pool = pool;
+  return previous;
+}
+
+std::unique_ptr<TaskThreadPool> Environment::CreateNumaIntraOpThreadPool(int numa_node) {
+  std::vector<int> cpus = Env::Default().GetNumaNodeCpus(numa_node);
+  if (cpus.empty()) {
+    return nullptr;
+  }
+
+  auto pool = std::make_unique<TaskThreadPool>(cpus.size(), [cpus, numa_node](std::size_t) {
+    auto status = Env::Default().SetCurrentThreadAffinity(cpus);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "The threads of NUMA node " << numa_node << " can't be pinned to it: "
+                            << status.ErrorMessage();
+    }
+    // the MLAS work the tasks of the pool start stays on the node
+    auto* pool = TaskThreadPool::CurrentThreadPool();
+    SetCurrentThreadIntraOpThreadPool(pool);
+    MlasSetThreadLimit(pool->NumThreads());
+  });
+  pool->SetSpinDuration(std::chrono::microseconds(intra_op_thread_pool_spin_us.load()));
+  return pool;
+}
+
+Status Environment::SetSharedCpuArenaConfig(const ArenaConfig& config) {
+  std::lock_guard<OrtMutex> lock(shared_cpu_arena_mutex);
+  if (shared_cpu_arena) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "The shared CPU arena has already been created. Its configuration must be set before the "
+                           "first session that uses it is initialized.");
+  }
+
+  shared_cpu_arena_config = config;
+  return Status::OK();
+}
+
+std::shared_ptr<IArenaAllocator> Environment::GetSharedCpuArena() {
+  std::lock_guard<OrtMutex> lock(shared_cpu_arena_mutex);
+  if (!shared_cpu_arena) {
+    shared_cpu_arena = std::make_shared<BFCArena>(std::make_unique<CPUAllocator>(), std::numeric_limits<size_t>::max(),
+                                                  shared_cpu_arena_config);
+  }
+
+  return shared_cpu_arena;
+}
+
 Environment::~Environment() {
+  {
+    std::lock_guard<OrtMutex> lock(intra_op_thread_pool_mutex);
+    if (intra_op_thread_pool) {
+      MlasSetThreadPool(nullptr, nullptr, 1);
+      intra_op_thread_pool_ptr = nullptr;
+      intra_op_thread_pool.reset();
+    }
+    intra_op_thread_pool_size = 0;
+  }
+
+  {
+    // the sessions that use the arena hold it until they're destroyed
+    std::lock_guard<OrtMutex> lock(shared_cpu_arena_mutex);
+    shared_cpu_arena.reset();
+    shared_cpu_arena_config = ArenaConfig();
+  }
+
   ::google::protobuf::ShutdownProtobufLibrary();
 }
 
@@ -3,18 +3,55 @@
 
 #include "core/framework/execution_frame.h"
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
 #include "core/framework/mem_pattern_planner.h"
 #include "core/framework/ml_value_patterns_planner.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/tensor_pool.h"
 #include "core/framework/utils.h"
 
 using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
+// resolves the names of the feeds, and of the outputs if there are fetches, to their MLValue indices
+static void ResolveFeedsAndFetches(const MLValueNameIdxMap& mlvalue_idx_map,
+                                   const std::unordered_map<std::string, MLValue>& feeds,
+                                   const std::vector<std::string>& output_names,
+                                   const std::vector<MLValue>& fetches,
+                                   std::vector<int>& feed_mlvalue_idxs,
+                                   std::vector<MLValue>& feed_values,
+                                   std::vector<int>& fetch_mlvalue_idxs) {
+  feed_mlvalue_idxs.reserve(feeds.size());
+  feed_values.reserve(feeds.size());
+  for (const auto& feed : feeds) {
+    int mlvalue_idx;
+    Status status = mlvalue_idx_map.GetIdx(feed.first, mlvalue_idx);
+    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+    feed_mlvalue_idxs.push_back(mlvalue_idx);
+    feed_values.push_back(feed.second);
+  }
+
+  if (!fetches.empty()) {
+    // should've already verified this much before when Run() starts
+    ORT_ENFORCE(output_names.size() == fetches.size(),
+                "output_names vector size: " + std::to_string(output_names.size()) +
+                    " does not match that of fetches vector: " + std::to_string(fetches.size()));
+
+    fetch_mlvalue_idxs.reserve(output_names.size());
+    for (const auto& oname : output_names) {
+      int mlvalue_idx;
+      Status status = mlvalue_idx_map.GetIdx(oname, mlvalue_idx);
+      ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+      fetch_mlvalue_idxs.push_back(mlvalue_idx);
+    }
+  }
+}
+
 ExecutionFrame::ExecutionFrame(const std::unordered_map<std::string, MLValue>& feeds,
                                const std::vector<std::string>& output_names,
                                const std::vector<MLValue>& fetches,
@@ -22,43 +59,114 @@ ExecutionFrame::ExecutionFrame(const std::unordered_map<std::string, MLValue>& f
                                const SessionState& session_state)
     : session_state_(session_state),
       mem_patterns_(nullptr),
-      planner_(nullptr) {
+      planner_(nullptr),
+      tensor_pool_(std::make_shared<TensorPool>()) {
+  auto* graph = session_state.GetGraphViewer();
+  ORT_ENFORCE(graph);
+
+  std::vector<int> feed_mlvalue_idxs;
+  std::vector<MLValue> feed_values;
+  std::vector<int> fetch_mlvalue_idxs;
+  ResolveFeedsAndFetches(session_state_.GetMLValueNameIdxMap(), feeds, output_names, fetches,
+                         feed_mlvalue_idxs, feed_values, fetch_mlvalue_idxs);
+
+  Init(*graph, feed_mlvalue_idxs, feed_values, fetch_mlvalue_idxs, fetches, fetch_allocators);
+  InitMemoryPatterns(feed_values);
+}
+
+ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
+                               const std::vector<MLValue>& feeds,
+                               const std::vector<int>& fetch_mlvalue_idxs,
+                               const std::vector<MLValue>& fetches,
+                               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                               const SessionState& session_state)
+    : session_state_(session_state),
+      mem_patterns_(nullptr),
+      planner_(nullptr),
+      tensor_pool_(std::make_shared<TensorPool>()) {
   auto* graph = session_state.GetGraphViewer();
   ORT_ENFORCE(graph);
-  Init(*graph, feeds, output_names, fetches, fetch_allocators);
+  Init(*graph, feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators);
+  InitMemoryPatterns(feeds);
+}
+
+void ExecutionFrame::Reset(const std::unordered_map<std::string, MLValue>& feeds,
+                           const std::vector<std::string>& output_names,
+                           const std::vector<MLValue>& fetches,
+                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  std::vector<int> feed_mlvalue_idxs;
+  std::vector<MLValue> feed_values;
+  std::vector<int> fetch_mlvalue_idxs;
+  ResolveFeedsAndFetches(session_state_.GetMLValueNameIdxMap(), feeds, output_names, fetches,
+                         feed_mlvalue_idxs, feed_values, fetch_mlvalue_idxs);
+
+  Reset(feed_mlvalue_idxs, feed_values, fetch_mlvalue_idxs, fetches, fetch_allocators);
+}
+
+void ExecutionFrame::Reset(const std::vector<int>& feed_mlvalue_idxs,
+                           const std::vector<MLValue>& feeds,
+                           const std::vector<int>& fetch_mlvalue_idxs,
+                           const std::vector<MLValue>& fetches,
+                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  // node_offsets_ and node_values_ only depend on the graph so are kept as is.
+  ClearValues();
+  InitValues(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators);
+  InitMemoryPatterns(feeds);
+}
 
+void ExecutionFrame::ClearValues() {
+  std::fill(all_values_.begin(), all_values_.end(), MLValue());
+  output_indices_.clear();
+  custom_allocators_.clear();
+}
+
+void ExecutionFrame::InitMemoryPatterns(const std::vector<MLValue>& feeds) {
   // If the session enable memory pattern optimization
   // and we have execution plan generated, try to setup
   // memory pattern optimization.
-  if (session_state.GetEnableMemoryPattern() &&
-      session_state.GetExecutionPlan()) {
-    std::vector<TensorShape> input_shapes;
-    bool all_tensors = true;
+  bool all_tensors = session_state_.GetEnableMemoryPattern() && session_state_.GetExecutionPlan();
+  std::vector<TensorShape> input_shapes;
+  if (all_tensors) {
+    input_shapes.reserve(feeds.size());
     for (const auto& feed : feeds) {
-      if (!(feed.second.IsTensor())) {
+      if (!(feed.IsTensor())) {
         all_tensors = false;
         break;
       }
-      auto& tensor = feed.second.Get<Tensor>();
+      auto& tensor = feed.Get<Tensor>();
       input_shapes.push_back(tensor.Shape());
     }
-    // if there is some traditional ml value type in inputs
-    // disable the memory pattern optimization.
-    if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
-      // if no existing patterns, generate one in this executionframe
-      if (!mem_patterns_) {
-        planner_ = std::make_unique<MLValuePatternPlanner>(*session_state.GetExecutionPlan());
-      } else {
-        // pre-allocate the big chunk requested in memory pattern.
-        // all the internal kernel's input/output tensors will be allocated on these buffer.
-        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
-          ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
-          AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
-          void* buffer = mem_patterns_->patterns[i].PeakSize() > 0 ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize()) : nullptr;
-          buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
-        }
+  }
+
+  // a frame reused with the same input shapes as its previous Run can keep using the memory pattern buffers.
+  if (all_tensors && mem_patterns_ && !mem_patterns_overflowed_ && input_shapes == input_shapes_) {
+    return;
+  }
+
+  mem_patterns_ = nullptr;
+  mem_patterns_overflowed_ = false;
+  planner_.reset();
+  buffers_.clear();
+  input_shapes_.clear();
+
+  // if there is some traditional ml value type in inputs
+  // disable the memory pattern optimization.
+  if (all_tensors) {
+    mem_patterns_ = session_state_.GetMemoryPatternGroup(input_shapes);
+    // if no existing patterns, generate one in this executionframe
+    if (!mem_patterns_) {
+      planner_ = std::make_unique<MLValuePatternPlanner>(*session_state_.GetExecutionPlan());
+    } else {
+      // pre-allocate the big chunk requested in memory pattern.
+      // all the internal kernel's input/output tensors will be allocated on these buffer.
+      for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
+        ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
+        AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
+        void* buffer = mem_patterns_->patterns[i].PeakSize() > 0 ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize()) : nullptr;
+        buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
       }
+
+      input_shapes_ = std::move(input_shapes);
     }
   }
 }
@@ -116,16 +224,18 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(int mlvalue_inde
       // if block not found, fall back to default behavior
       if (block) {
         auto it = buffers_.find(location);
-        // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        // if the block is not correct, log message then fall back to default behavior.
+        // the block may be larger than needed if the pattern was generated for larger input shapes in the same bucket.
+        if (it != buffers_.end() && size <= block->size_) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               p_mlvalue, static_cast<void*>(static_cast<char*>(buffer) + block->offset_),
               element_type, location, shape);
           return status;
         }
-        if (block->size_ != size) {
-          LOGS_DEFAULT(WARNING) << "For mlvalue with index: " << mlvalue_index << ", block in memory pattern size is: "
+        if (block->size_ < size) {
+          mem_patterns_overflowed_ = true;
+          LOGS_DEFAULT(VERBOSE) << "For mlvalue with index: " << mlvalue_index << ", block in memory pattern size is: "
                                 << block->size_ << " but the actually size is: " << size << ", fall back to default allocation behavior";
         } else if (it == buffers_.end()) {
           LOGS_DEFAULT(WARNING) << "For mlvalue with index: " << mlvalue_index << ", block not found in target loation. "
@@ -136,15 +246,8 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(int mlvalue_inde
   }
   //no memory pattern, or the pattern is not correct.
   void* buffer = size == 0 ? nullptr : alloc->Alloc(size);
-  std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type,
-                                                              shape,
-                                                              buffer,
-                                                              location,
-                                                              alloc);
-
-  p_mlvalue->Init(p_tensor.release(),
-                  DataTypeImpl::GetType<Tensor>(),
-                  DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  p_mlvalue->Init(tensor_pool_->MakeTensor(element_type, shape, buffer, location, alloc),
+                  DataTypeImpl::GetType<Tensor>());
 
   // trace the memory allocation.
   // don't trace the memory allocation on string tensors, as it need
@@ -190,6 +293,16 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(int mlvalue_index_
   auto* reuse_tensor = p_mlvalue_reuse->GetMutable<Tensor>();
   void* reuse_buffer = reuse_tensor->MutableDataRaw();
 
+  // the buffer is only known to be as large as the value it holds, which may be smaller than the plan expected
+  // when the shapes are only known at run time
+  const int64_t reuse_size = reuse_tensor->Shape().Size() * static_cast<int64_t>(reuse_tensor->DataType()->Size());
+  const int64_t required_size = shape.Size() * static_cast<int64_t>(element_type->Size());
+  if (required_size > reuse_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Buffer of ", reuse_size, " bytes of mlvalue ", mlvalue_index_reuse,
+                           " is too small for the ", required_size, " bytes of mlvalue ", mlvalue_index_to_allocate,
+                           " that reuses it.");
+  }
+
   // create fence on reused mlvalue if needed
   // TODO: differentiate reuse and alias, by add AllocKind::kAlias?
   if (create_fence && p_mlvalue_reuse->Fence() == nullptr) {
@@ -210,13 +323,8 @@ Status ExecutionFrame::AllocateTensorWithPreAllocateBufferHelper(MLValue* p_mlva
   if (p_mlvalue->IsAllocated()) {
     return Status::OK();
   }
-  std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type,
-                                                              shape,
-                                                              pBuffer,
-                                                              location);
-  p_mlvalue->Init(p_tensor.release(),
-                  DataTypeImpl::GetType<Tensor>(),
-                  DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  p_mlvalue->Init(tensor_pool_->MakeTensor(element_type, shape, pBuffer, location),
+                  DataTypeImpl::GetType<Tensor>());
 
   return Status::OK();
 }
@@ -255,6 +363,27 @@ Status AllocateTraditionalMLValue(MLValue* p_mlvalue,
 }
 
 // This method is not thread safe!
+// whether the tensor in value has the size in bytes of a tensor of element_type and shape
+static bool HasSameSize(const MLValue& value, const DataTypeImpl* element_type, const TensorShape& shape) {
+  const auto& tensor = value.Get<Tensor>();
+  return tensor.Shape().Size() * tensor.DataType()->Size() == shape.Size() * element_type->Size();
+}
+
+// whether a value can be written to the buffer of a graph output the caller of Run provided. the caller may
+// describe the location of its buffer with another allocator type than the plan, e.g. a device allocator for CPU memory.
+static bool IsUsableOutputBuffer(const MLValue& output, const DataTypeImpl* element_type,
+                                 const OrtAllocatorInfo& location, const TensorShape& shape) {
+  if (!output.IsAllocated() || !output.IsTensor() || element_type == DataTypeImpl::GetType<std::string>()) {
+    return false;
+  }
+
+  const auto& tensor = output.Get<Tensor>();
+  const auto& output_location = tensor.Location();
+  return strcmp(output_location.name, location.name) == 0 && output_location.id == location.id &&
+         output_location.mem_type == location.mem_type &&
+         tensor.DataType() == element_type && tensor.Shape().Size() == shape.Size();
+}
+
 Status ExecutionFrame::AllocateAsPerAllocationPlan(int mlvalue_index,
                                                    const MLValueAllocationParameters& parameters) {
   if (mlvalue_index < 0 || mlvalue_index >= all_values_.size())
@@ -286,6 +415,18 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(int mlvalue_index,
   // tensors
   auto ml_data_type = static_cast<const TensorTypeBase*>(ml_type)->GetElementType();
 
+  // write the value to the caller's buffer for the graph output it becomes, so that the output isn't a copy of it
+  if (per_alloc_plan.aliased_output >= 0 &&
+      IsUsableOutputBuffer(all_values_[per_alloc_plan.aliased_output], ml_data_type, alloc_info,
+                           parameters.GetTensorShape())) {
+    return AllocateMLValueTensorPreAllocateBuffer(mlvalue_index,
+                                                  per_alloc_plan.aliased_output,
+                                                  ml_data_type,
+                                                  alloc_info,
+                                                  parameters.GetTensorShape(),
+                                                  per_alloc_plan.create_fence_if_async);
+  }
+
   AllocKind alloc_kind = per_alloc_plan.alloc_kind;
   switch (alloc_kind) {
     // Right now for kAllocate and kAllocateOutput we are using same approach.
@@ -301,6 +442,16 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(int mlvalue_index,
     }
     case AllocKind::kReuse: {
       int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
+      if (per_alloc_plan.reuse_if_same_size &&
+          !HasSameSize(all_values_[reuse_mlvalue_index], ml_data_type, parameters.GetTensorShape())) {
+        ORT_RETURN_IF_ERROR(AllocateMLValueTensorSelfOwnBuffer(mlvalue_index,
+                                                               ml_data_type,
+                                                               alloc_info,
+                                                               parameters.GetTensorShape(),
+                                                               per_alloc_plan.create_fence_if_async));
+        break;
+      }
+
       ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBuffer(mlvalue_index,
                                                                  reuse_mlvalue_index,
                                                                  ml_data_type,
@@ -320,8 +471,9 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(int mlvalue_index,
 }
 
 void ExecutionFrame::Init(const onnxruntime::GraphViewer& graph,
-                          const std::unordered_map<std::string, MLValue>& feeds,
-                          const std::vector<std::string>& output_names,
+                          const std::vector<int>& feed_mlvalue_idxs,
+                          const std::vector<MLValue>& feeds,
+                          const std::vector<int>& fetch_mlvalue_idxs,
                           const std::vector<MLValue>& fetches,
                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
   // 1. resize the node_offsets and all_value_ vector
@@ -330,50 +482,10 @@ void ExecutionFrame::Init(const onnxruntime::GraphViewer& graph,
   auto max_node_index = graph.MaxNodeIndex();
   node_offsets_.resize(max_node_index);
 
-  auto& mlvalue_idx_map = session_state_.GetMLValueNameIdxMap();
-
-  all_values_.resize(mlvalue_idx_map.MaxIdx() + 1);
-
-  // 2. handle the weights.
-  for (const auto& entry : session_state_.GetInitializedTensors()) {
-    auto mlvalue_index = entry.first;
-    all_values_[mlvalue_index] = entry.second;  // this copy should be cheap
-  }
-
-  // 3. handle feed in values
-  for (const auto& feed : feeds) {
-    int mlvalue_idx;
-    Status status = mlvalue_idx_map.GetIdx(feed.first, mlvalue_idx);
-    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
-    // we are sharing the underline tensor/object for MLValue
-    all_values_[mlvalue_idx] = feed.second;
-  }
-
-  // 4. Handle non-empty output vector
-  if (!fetches.empty()) {
-    // should've already verified this much before when Run() starts
-    ORT_ENFORCE(output_names.size() == fetches.size(),
-                "output_names vector size: " + std::to_string(output_names.size()) +
-                    " does not match that of fetches vector: " + std::to_string(fetches.size()));
-
-    // setup output_indices_, we dont' want to generate mem plan on output tensors.
-    output_indices_.reserve(output_names.size());
-    auto idx = 0;
-    for (const auto& oname : output_names) {
-      int mlvalue_idx;
-      Status status = mlvalue_idx_map.GetIdx(oname, mlvalue_idx);
-      ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
-      all_values_[mlvalue_idx] = fetches.at(idx);
-      output_indices_.push_back(mlvalue_idx);
-
-      auto custom_alloc_entry = fetch_allocators.find(idx);
-      if (custom_alloc_entry != fetch_allocators.cend()) {
-        custom_allocators_[mlvalue_idx] = custom_alloc_entry->second;
-      }
+  all_values_.resize(session_state_.GetMLValueNameIdxMap().MaxIdx() + 1);
 
-      ++idx;
-    }
-  }
+  // 2 - 4. initializers, feeds and fetches
+  InitValues(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators);
 
   // 5. set node args
   std::size_t total_def_count{};
@@ -402,6 +514,45 @@ void ExecutionFrame::Init(const onnxruntime::GraphViewer& graph,
   }
 }
 
+void ExecutionFrame::InitValues(const std::vector<int>& feed_mlvalue_idxs,
+                                const std::vector<MLValue>& feeds,
+                                const std::vector<int>& fetch_mlvalue_idxs,
+                                const std::vector<MLValue>& fetches,
+                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  // 2. handle the weights.
+  for (const auto& entry : session_state_.GetInitializedTensors()) {
+    auto mlvalue_index = entry.first;
+    all_values_[mlvalue_index] = entry.second;  // this copy should be cheap
+  }
+
+  // 3. handle feed in values
+  ORT_ENFORCE(feed_mlvalue_idxs.size() == feeds.size());
+  for (size_t idx = 0, end = feeds.size(); idx < end; ++idx) {
+    // we are sharing the underline tensor/object for MLValue
+    all_values_[feed_mlvalue_idxs[idx]] = feeds[idx];
+  }
+
+  // 4. Handle non-empty output vector
+  if (!fetches.empty()) {
+    ORT_ENFORCE(fetch_mlvalue_idxs.size() == fetches.size(),
+                "fetch_mlvalue_idxs vector size: " + std::to_string(fetch_mlvalue_idxs.size()) +
+                    " does not match that of fetches vector: " + std::to_string(fetches.size()));
+
+    // setup output_indices_, we dont' want to generate mem plan on output tensors.
+    output_indices_.reserve(fetch_mlvalue_idxs.size());
+    for (size_t idx = 0, end = fetches.size(); idx < end; ++idx) {
+      int mlvalue_idx = fetch_mlvalue_idxs[idx];
+      all_values_[mlvalue_idx] = fetches[idx];
+      output_indices_.push_back(mlvalue_idx);
+
+      auto custom_alloc_entry = fetch_allocators.find(idx);
+      if (custom_alloc_entry != fetch_allocators.cend()) {
+        custom_allocators_[mlvalue_idx] = custom_alloc_entry->second;
+      }
+    }
+  }
+}
+
 void ExecutionFrame::SetupNodeArg(const onnxruntime::NodeArg* arg) {
   ORT_ENFORCE(arg);
   auto& name = arg->Name();
@@ -442,6 +593,67 @@ void ExecutionFrame::TraceFree(int mlvalue_idx) {
   }
 }
 
+// the index a scratch buffer of the node is traced with, which can't collide with an MLValue index
+static int ScratchBufferPatternIndex(onnxruntime::NodeIndex node_index) {
+  return -static_cast<int>(node_index) - 1;
+}
+
+Status ExecutionFrame::AllocateScratchBuffer(onnxruntime::NodeIndex node_index,
+                                             const OrtAllocatorInfo& location,
+                                             size_t size,
+                                             BufferUniquePtr& buffer) {
+  // keep the blocks aligned as the ones of the tensors
+  size_t aligned_size;
+  if (!IAllocator::CalcMemSizeForArrayWithAlignment<64>(size, 1, &aligned_size)) {
+    return Status(ONNXRUNTIME, FAIL, "size overflow");
+  }
+
+  const int pattern_index = ScratchBufferPatternIndex(node_index);
+  if (mem_patterns_) {
+    auto pattern = mem_patterns_->GetPatterns(location);
+    auto block = pattern != nullptr ? pattern->GetBlock(pattern_index) : nullptr;
+    if (block) {
+      auto it = buffers_.find(location);
+      if (it != buffers_.end() && aligned_size <= block->size_) {
+        // the memory pattern buffer owns it
+        buffer = BufferUniquePtr(static_cast<char*>(it->second.get()) + block->offset_, BufferDeleter());
+        return Status::OK();
+      }
+      if (block->size_ < aligned_size) {
+        mem_patterns_overflowed_ = true;
+        LOGS_DEFAULT(VERBOSE) << "For the scratch buffer of node " << node_index << ", block in memory pattern size is: "
+                              << block->size_ << " but the actually size is: " << aligned_size
+                              << ", fall back to default allocation behavior";
+      }
+    }
+  }
+
+  auto alloc = GetAllocator(location);
+  if (!alloc) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to get allocator for location: ", location.ToString());
+  }
+  buffer = BufferUniquePtr(aligned_size == 0 ? nullptr : alloc->Alloc(aligned_size), BufferDeleter(alloc));
+
+  if (planner_) {
+    auto status = planner_->TraceAllocation(location, pattern_index, aligned_size);
+    if (!status.IsOK())
+      LOGS(session_state_.Logger(), WARNING) << "TraceAllocation for the scratch buffer of node " << node_index
+                                             << " size=" << aligned_size << " failed: " << status.ErrorMessage();
+  }
+
+  return Status::OK();
+}
+
+void ExecutionFrame::TraceScratchBufferFree(onnxruntime::NodeIndex node_index, const OrtAllocatorInfo& location) {
+  if (planner_) {
+    auto status = planner_->TraceFree(location, ScratchBufferPatternIndex(node_index));
+    if (!status.IsOK()) {
+      LOGS(session_state_.Logger(), WARNING) << "TraceFree for the scratch buffer of node " << node_index
+                                             << " failed: " << status.ErrorMessage();
+    }
+  }
+}
+
 // generate memory pattern based on the tracing of memory allocation/free in current execution
 // return error if the planner is not setup.
 Status ExecutionFrame::GeneratePatterns(MemoryPatternGroup* out) const {
@@ -509,12 +721,14 @@ Status ExecutionFrame::GetOrCreateNodeOutputMLValue(int index,
   return Status::OK();
 }
 
-Status ExecutionFrame::ReleaseMLValue(int mlvalue_idx) {
+Status ExecutionFrame::ReleaseMLValue(int mlvalue_idx, bool trace_free) {
   if (mlvalue_idx < 0 || static_cast<size_t>(mlvalue_idx) >= all_values_.size()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid index ", mlvalue_idx);
   }
   all_values_[mlvalue_idx] = MLValue();
-  TraceFree(mlvalue_idx);
+  if (trace_free) {
+    TraceFree(mlvalue_idx);
+  }
   return Status::OK();
 }
 
@@ -18,6 +18,7 @@ namespace onnxruntime {
 
 class SessionState;
 class MLValuePatternPlanner;
+class TensorPool;
 struct MemoryPatternGroup;
 
 struct MLValueAllocationParameters {
@@ -46,8 +47,32 @@ class ExecutionFrame {
                  const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                  const SessionState& session_state);
 
+  // feeds and fetches given by their MLValue indices, as resolved once by a FeedsFetchesManager for the graph
+  ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
+                 const std::vector<MLValue>& feeds,
+                 const std::vector<int>& fetch_mlvalue_idxs,
+                 const std::vector<MLValue>& fetches,
+                 const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                 const SessionState& session_state);
+
   ~ExecutionFrame();
 
+  // Prepare a frame from a previous Run for a new Run, avoiding the cost of constructing a new one.
+  // If the input shapes match the previous Run the memory pattern buffers are reused as is.
+  void Reset(const std::unordered_map<std::string, MLValue>& feeds,
+             const std::vector<std::string>& output_names,
+             const std::vector<MLValue>& fetches,
+             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  void Reset(const std::vector<int>& feed_mlvalue_idxs,
+             const std::vector<MLValue>& feeds,
+             const std::vector<int>& fetch_mlvalue_idxs,
+             const std::vector<MLValue>& fetches,
+             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  // Release all the values held by the frame. The memory pattern buffers are kept for a later Reset.
+  void ClearValues();
+
   Status AllocateMLValueTensorSelfOwnBuffer(int mlvalue_index,
                                             MLDataType element_type,
                                             const OrtAllocatorInfo& location,
@@ -100,6 +125,12 @@ class ExecutionFrame {
     return node_offsets_[index];
   }
 
+  // the ml-value index the index into the node arguments maps to, or -1 for an unused optional input/output
+  int GetNodeInputOrOutputMLValueIndex(int index) const {
+    ORT_ENFORCE(index >= 0 && static_cast<size_t>(index) < node_values_.size());
+    return node_values_[index];
+  }
+
   // Return nullptr if index map to an value that is an unused optional input/output
   const MLValue* GetNodeInputOrOutputMLValue(int index) const;
   MLValue* GetMutableNodeInputOrOutputMLValue(int index);
@@ -113,7 +144,20 @@ class ExecutionFrame {
 
   AllocatorPtr GetAllocator(const OrtAllocatorInfo& info);
 
-  Status ReleaseMLValue(int mlvalue_idx);
+  // trace_free is false for a release that isn't at a fixed point of the execution, which a memory pattern
+  // generated from the trace couldn't rely on.
+  Status ReleaseMLValue(int mlvalue_idx, bool trace_free = true);
+
+  // Allocate the scratch buffer of a node's kernel at location, in the block the memory pattern reserved for it if
+  // there is one. The allocation is traced with the node, so the pattern generated from this Run reserves it.
+  // This method is thread safe for different nodes.
+  Status AllocateScratchBuffer(onnxruntime::NodeIndex node_index,
+                               const OrtAllocatorInfo& location,
+                               size_t size,
+                               BufferUniquePtr& buffer);
+
+  // Trace that the scratch buffer of the node was released, at a fixed point of the execution.
+  void TraceScratchBufferFree(onnxruntime::NodeIndex node_index, const OrtAllocatorInfo& location);
 
   const SessionState& GetSessionState() const {
     return session_state_;
@@ -125,6 +169,11 @@ class ExecutionFrame {
     return planner_ != nullptr;
   }
 
+  // true if the cached memory pattern used by this frame was too small for some of the values in this Run
+  bool MemoryPatternOverflowed() const {
+    return mem_patterns_overflowed_;
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFrame);
 
@@ -141,11 +190,20 @@ class ExecutionFrame {
                                                   bool create_fence);
 
   void Init(const onnxruntime::GraphViewer& graph,
-            const std::unordered_map<std::string, MLValue>& feeds,
-            const std::vector<std::string>& output_names,
+            const std::vector<int>& feed_mlvalue_idxs,
+            const std::vector<MLValue>& feeds,
+            const std::vector<int>& fetch_mlvalue_idxs,
             const std::vector<MLValue>& fetches,
             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
 
+  void InitValues(const std::vector<int>& feed_mlvalue_idxs,
+                  const std::vector<MLValue>& feeds,
+                  const std::vector<int>& fetch_mlvalue_idxs,
+                  const std::vector<MLValue>& fetches,
+                  const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  void InitMemoryPatterns(const std::vector<MLValue>& feeds);
+
   void SetupNodeArg(const onnxruntime::NodeArg* arg);
 
   Status AllocateTensorWithPreAllocateBufferHelper(MLValue* p_mlvalue,
@@ -186,7 +244,11 @@ class ExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
+
+  // set if a value didn't fit in its block from mem_patterns_. the pattern was generated for smaller input shapes
+  // in the same bucket.
+  bool mem_patterns_overflowed_ = false;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -198,5 +260,11 @@ class ExecutionFrame {
 
   // Big chunks on different locations that will be used by mem_pattern.
   std::map<OrtAllocatorInfo, BufferUniquePtr> buffers_;
+
+  // Input shapes mem_patterns_ was looked up with, so a reset with the same shapes can skip the lookup.
+  std::vector<TensorShape> input_shapes_;
+
+  // The storage of the Tensor objects of the values, reused across the runs of the frame.
+  std::shared_ptr<TensorPool> tensor_pool_;
 };
 }  // namespace onnxruntime
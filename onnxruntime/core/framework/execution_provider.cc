@@ -49,12 +49,56 @@ common::Status IExecutionProvider::CopyTensor(const Tensor& src,
   return CopyTensor(src, dst);
 }
 
+common::Status IExecutionProvider::CopyTensors(const std::vector<const Tensor*>& src,
+                                               const std::vector<Tensor*>& dst,
+                                               int exec_queue_id) const {
+  ORT_ENFORCE(src.size() == dst.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    ORT_RETURN_IF_ERROR(CopyTensor(*src[i], *dst[i], exec_queue_id));
+  }
+  return Status::OK();
+}
+
+common::Status IExecutionProvider::CopyTensorFromHostAsync(const Tensor& src,
+                                                           Tensor& dst,
+                                                           IFence& dst_fence) const {
+  ORT_UNUSED_PARAMETER(dst_fence);
+  return CopyTensor(src, dst);
+}
+
 common::Status IExecutionProvider::Sync() const { return Status::OK(); };
 
 common::Status IExecutionProvider::OnRunStart() { return Status::OK(); }
 
 common::Status IExecutionProvider::OnRunEnd() { return Status::OK(); }
 
+bool IExecutionProvider::IsGraphCaptureEnabled() const { return false; }
+
+common::Status IExecutionProvider::BeginGraphCapture() {
+  return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
+}
+
+common::Status IExecutionProvider::EndGraphCapture() {
+  return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
+}
+
+common::Status IExecutionProvider::ReplayGraph() {
+  return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
+}
+
+common::Status IExecutionProvider::ReleaseGraph() { return Status::OK(); }
+
+std::unique_ptr<IDeviceTimer> IExecutionProvider::CreateDeviceTimer(int /*queue_id*/) const {
+  return nullptr;
+}
+
+std::vector<int> IExecutionProvider::GetComputeQueueIds() const {
+  return {0};
+}
+
+void IExecutionProvider::SetComputeQueue(int /*queue_id*/) const {
+}
+
 void IExecutionProvider::InsertAllocator(AllocatorPtr allocator) {
   const OrtAllocatorInfo& info = allocator->Info();
   const int key = MakeKey(info.id, info.mem_type);
@@ -65,6 +109,11 @@ void IExecutionProvider::InsertAllocator(AllocatorPtr allocator) {
   allocators_.insert(iter, {key, allocator});
 }
 
+void IExecutionProvider::ReplaceAllocator(AllocatorPtr allocator) {
+  const OrtAllocatorInfo& info = allocator->Info();
+  allocators_[MakeKey(info.id, info.mem_type)] = allocator;
+}
+
 common::Status IExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& /*fused_node*/,
                                            std::vector<NodeComputeInfo>& /*node_compute_funcs*/) {
   return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
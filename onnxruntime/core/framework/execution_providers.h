@@ -4,6 +4,7 @@
 #pragma once
 
 // #include <map>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -52,6 +53,23 @@ class ExecutionProviders {
     return Status::OK();
   }
 
+  // Replaces the allocator of the provider that allocates at the name, id and mem_type of allocator->Info().
+  common::Status ReplaceAllocator(AllocatorPtr allocator) {
+    const OrtAllocatorInfo& info = allocator->Info();
+    for (auto it = allocator_idx_map_.begin(); it != allocator_idx_map_.end(); ++it) {
+      const OrtAllocatorInfo& replaced_info = it->first;
+      if (replaced_info.id == info.id && replaced_info.mem_type == info.mem_type &&
+          strcmp(replaced_info.name, info.name) == 0) {
+        const size_t provider_idx = it->second;
+        exec_providers_[provider_idx]->ReplaceAllocator(allocator);
+        allocator_idx_map_.erase(it);
+        allocator_idx_map_.insert({info, provider_idx});
+        return Status::OK();
+      }
+    }
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "No execution provider allocates at ", info, ".");
+  }
+
   const IExecutionProvider* Get(const onnxruntime::Node& node) const {
     return Get(node.GetExecutionProviderType());
   }
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/feeds_fetches_manager.h"
+
+#include "core/framework/execution_providers.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+common::Status FeedsFetchesManager::Create(const std::vector<std::string>& feed_names,
+                                           const std::vector<std::string>& output_names,
+                                           const SessionState& session_state,
+                                           std::unique_ptr<FeedsFetchesManager>& feeds_fetches_manager) {
+  std::unique_ptr<FeedsFetchesManager> manager{new FeedsFetchesManager(feed_names, output_names)};
+
+  const auto& mlvalue_name_idx_map = session_state.GetMLValueNameIdxMap();
+
+  manager->feeds_mlvalue_idxs_.resize(feed_names.size());
+  for (size_t i = 0, end = feed_names.size(); i < end; ++i) {
+    ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(feed_names[i], manager->feeds_mlvalue_idxs_[i]));
+  }
+
+  manager->fetches_mlvalue_idxs_.resize(output_names.size());
+  for (size_t i = 0, end = output_names.size(); i < end; ++i) {
+    ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(output_names[i], manager->fetches_mlvalue_idxs_[i]));
+  }
+
+  // every value is in CPU memory if the CPU execution provider is the only one, so nothing is ever copied
+  bool cpu_only = true;
+  for (const auto& provider : session_state.GetExecutionProviders()) {
+    if (provider->Type() != onnxruntime::kCpuExecutionProvider) {
+      cpu_only = false;
+      break;
+    }
+  }
+
+  manager->device_copies_may_be_needed_ = !cpu_only;
+
+  feeds_fetches_manager = std::move(manager);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
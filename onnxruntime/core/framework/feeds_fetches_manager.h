@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+
+namespace onnxruntime {
+class SessionState;
+
+/**
+  * The feeds and fetches of a graph that is executed repeatedly with the same feed and output names, such as the
+  * subgraph of a Loop or Scan node for every iteration. The names are resolved to their MLValue indices once, so an
+  * execution passes the feeds and fetches as vectors in the order of the names, with no lookups by name.
+  *
+  * Whether an execution may need to copy a feed or fetch across devices is also decided once. It can't when the
+  * graph only runs on the CPU execution provider, and the executions of such a graph go straight to the executor.
+  */
+class FeedsFetchesManager {
+ public:
+  static common::Status Create(const std::vector<std::string>& feed_names,
+                               const std::vector<std::string>& output_names,
+                               const SessionState& session_state,
+                               std::unique_ptr<FeedsFetchesManager>& feeds_fetches_manager);
+
+  const std::vector<std::string>& GetFeedNames() const { return feed_names_; }
+  const std::vector<std::string>& GetOutputNames() const { return output_names_; }
+  const std::vector<int>& GetFeedsMLValueIdxs() const { return feeds_mlvalue_idxs_; }
+  const std::vector<int>& GetFetchesMLValueIdxs() const { return fetches_mlvalue_idxs_; }
+
+  // true if the feeds and fetches may have to be copied across devices
+  bool DeviceCopiesMayBeNeeded() const { return device_copies_may_be_needed_; }
+
+ private:
+  FeedsFetchesManager(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names)
+      : feed_names_{feed_names}, output_names_{output_names} {}
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FeedsFetchesManager);
+
+  std::vector<std::string> feed_names_;
+  std::vector<std::string> output_names_;
+  std::vector<int> feeds_mlvalue_idxs_;
+  std::vector<int> fetches_mlvalue_idxs_;
+  bool device_copies_may_be_needed_ = true;
+};
+
+}  // namespace onnxruntime
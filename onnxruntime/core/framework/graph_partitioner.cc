@@ -7,6 +7,7 @@
 #include "core/graph/function.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/compute_capability.h"
+#include "core/framework/cost_based_placement_transformer.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/kernel_registry.h"
@@ -201,4 +202,38 @@ Status GraphPartitioner::Partition(onnxruntime::Graph& graph, bool export_dll, F
 
   return Status::OK();
 }
+Status GraphPartitioner::PartitionIntoStages(const GraphViewer& graph_viewer, size_t num_stages,
+                                             const PlacementCostModel& cost_model,
+                                             std::vector<std::vector<NodeIndex>>& stages) {
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  if (num_stages == 0 || order.size() < num_stages) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "A graph of ", order.size(),
+                           " nodes can't be split into ", num_stages, " stages.");
+  }
+
+  std::vector<double> times;
+  times.reserve(order.size());
+  double total_time = 0.0;
+  for (auto index : order) {
+    times.push_back(cost_model.NodeTime(*graph_viewer.GetNode(index)));
+    total_time += times.back();
+  }
+
+  // cut the range of a stage once it reaches its share of the time, leaving a node for each remaining stage
+  stages.assign(num_stages, {});
+  double time = 0.0;
+  size_t stage = 0;
+  for (size_t i = 0; i < order.size(); ++i) {
+    const size_t remaining_nodes = order.size() - i;
+    const size_t remaining_stages = num_stages - stage;
+    if (!stages[stage].empty() && stage + 1 < num_stages &&
+        (remaining_nodes < remaining_stages || time >= total_time * (stage + 1) / num_stages)) {
+      ++stage;
+    }
+    stages[stage].push_back(order[i]);
+    time += times[i];
+  }
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -13,6 +13,7 @@ namespace onnxruntime {
 class ExecutionProviders;
 class KernelRegistryManager;
 class SessionState;
+struct PlacementCostModel;
 
 class GraphPartitioner {
  public:
@@ -24,6 +25,15 @@ class GraphPartitioner {
 
   Status Partition(onnxruntime::Graph& graph, bool export_dll, FuncManager* func_mgr) const;
 
+  // Splits the nodes of a graph into num_stages stages that run one after the other, e.g. on different devices.
+  // Each stage is a range of the topological order, so the values a stage reads are graph inputs, initializers or
+  // outputs of the stages before it, and the ranges are cut where the estimated times of cost_model are about
+  // equal. The stages are returned in their order, with the nodes of each in topological order.
+  // Returns INVALID_ARGUMENT if the graph has fewer nodes than stages.
+  static Status PartitionIntoStages(const GraphViewer& graph_viewer, size_t num_stages,
+                                    const PlacementCostModel& cost_model,
+                                    std::vector<std::vector<NodeIndex>>& stages);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphPartitioner);
 
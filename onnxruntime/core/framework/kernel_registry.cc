@@ -114,10 +114,14 @@ class TypeBindingResolver {
 };  // namespace
 
 std::vector<std::string> KernelRegistry::GetAllRegisteredOpNames() const {
-  std::vector<std::string> ret(kernel_creator_fn_map_.size());
-  size_t i = 0;
+  std::lock_guard<OrtMutex> lock(kernel_creator_mutex_);
+  std::vector<std::string> ret;
+  ret.reserve(kernel_creator_fn_map_.size() + deferred_kernels_.size());
   for (const auto& kvp : kernel_creator_fn_map_) {
-    ret[i++] = kvp.first;
+    ret.push_back(kvp.first);
+  }
+  for (const auto& kvp : deferred_kernels_) {
+    ret.push_back(kvp.first);
   }
   return ret;
 }
@@ -134,16 +138,17 @@ std::vector<std::string> KernelRegistry::GetAllRegisteredOpNames() const {
 // type specification of the corresponding op, which is done before this check.
 bool KernelRegistry::VerifyKernelDef(const onnxruntime::Node& node,
                                      const KernelDef& kernel_def,
-                                     std::string& error_str,
+                                     std::string* error_str,
                                      onnxruntime::ProviderType exec_provider) {
   // check if domain matches
   if (node.Domain() != kernel_def.Domain()) {
+    if (error_str == nullptr) return false;
     std::ostringstream ostr;
     ostr << "Op: " << node.OpType()
          << " Domain mismatch: "
          << " Expected: " << kernel_def.Domain()
          << " Actual: " << node.Domain();
-    error_str = ostr.str();
+    *error_str = ostr.str();
     return false;
   }
 
@@ -151,12 +156,13 @@ bool KernelRegistry::VerifyKernelDef(const onnxruntime::Node& node,
   const auto& node_provider = node.GetExecutionProviderType();
   const auto& expected_provider = (node_provider.empty() ? exec_provider : node_provider);
   if (expected_provider != kernel_def.Provider()) {
+    if (error_str == nullptr) return false;
     std::ostringstream ostr;
     ostr << "Op: " << node.OpType()
          << " Execution provider mismatch."
          << " Expected: " << expected_provider
          << " Actual: " << kernel_def.Provider();
-    error_str = ostr.str();
+    *error_str = ostr.str();
     return false;
   }
 
@@ -179,13 +185,14 @@ bool KernelRegistry::VerifyKernelDef(const onnxruntime::Node& node,
   bool valid_version = kernel_start_version == node_since_version  // the idea case this branch should be kernel_start_version >= node_version && kernel_start_version <= until_version
                        || (kernel_start_version < node_since_version && kernel_end_version != INT_MAX && kernel_end_version >= node_since_version);
   if (!valid_version) {
+    if (error_str == nullptr) return false;
     std::ostringstream ostr;
     ostr << "Op: " << node.OpType()
          << " Version mismatch."
          << " node_version: " << node_since_version
          << " kernel start version: " << kernel_start_version
          << " kernel_end_version: " << kernel_end_version;
-    error_str = ostr.str();
+    *error_str = ostr.str();
     return false;
   }
 
@@ -215,9 +222,9 @@ bool KernelRegistry::VerifyKernelDef(const onnxruntime::Node& node,
         !std::any_of(allowed_types.begin(), allowed_types.end(),
                      [actual_type, &node, &error_str](const DataTypeImpl* expected_type) {
                        bool rc = expected_type->IsCompatible(*actual_type);  // for easier debugging
-                       if (!rc) {
+                       if (!rc && error_str != nullptr) {
                          // TODO print type information as well
-                         error_str = "Op: " + node.OpType() + " Incompatible types.";
+                         *error_str = "Op: " + node.OpType() + " Incompatible types.";
                        }
                        return rc;
                      })) {
@@ -233,6 +240,31 @@ Status KernelRegistry::Register(KernelDefBuilder& kernel_builder,
 }
 
 Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
+  Status status;
+  {
+    std::lock_guard<OrtMutex> lock(kernel_creator_mutex_);
+    // the deferred kernels of the op were registered first, so they are checked for conflicts first
+    BuildDeferredKernels(create_info.kernel_def->OpName());
+    status = RegisterBuilt(std::move(create_info));
+  }
+  if (status.IsOK()) {
+    // a node may match the new kernel
+    std::lock_guard<OrtMutex> lock(kernel_lookup_mutex_);
+    kernel_lookup_cache_.clear();
+  }
+  return status;
+}
+
+void KernelRegistry::Register(const char* op_name, BuildKernelCreateInfoFn build_create_info) {
+  {
+    std::lock_guard<OrtMutex> lock(kernel_creator_mutex_);
+    deferred_kernels_.emplace(op_name, build_create_info);
+  }
+  std::lock_guard<OrtMutex> lock(kernel_lookup_mutex_);
+  kernel_lookup_cache_.clear();
+}
+
+Status KernelRegistry::RegisterBuilt(KernelCreateInfo&& create_info) const {
   auto& op_name = create_info.kernel_def->OpName();
 
   // Check op version conflicts.
@@ -258,6 +290,20 @@ Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
   return Status::OK();
 }
 
+void KernelRegistry::BuildDeferredKernels(const std::string& op_name) const {
+  auto range = deferred_kernels_.equal_range(op_name);
+  for (auto i = range.first; i != range.second; ++i) {
+    KernelCreateInfo create_info = i->second();
+    ORT_ENFORCE(create_info.kernel_def->OpName() == op_name, "The kernel of ", create_info.kernel_def->OpName(),
+                " was registered for op ", op_name);
+    Status status = RegisterBuilt(std::move(create_info));
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(ERROR) << status.ErrorMessage();
+    }
+  }
+  deferred_kernels_.erase(range.first, range.second);
+}
+
 Status KernelRegistry::CreateKernel(const onnxruntime::Node& node,
                                     const IExecutionProvider& execution_provider,
                                     const SessionState& session_state,
@@ -280,25 +326,89 @@ static std::string ToString(const std::vector<std::string>& error_strs) {
   return ostr.str();
 }
 
-const KernelCreateInfo* KernelRegistry::TryFindKernel(const onnxruntime::Node& node,
-                                                      onnxruntime::ProviderType exec_provider) const {
+// The key of the kernel lookup cache: the domain, op type, since version and provider of the node, and the types
+// of its arguments grouped by formal parameter, which are all VerifyKernelDef depends on.
+static std::string KernelLookupKey(const onnxruntime::Node& node, onnxruntime::ProviderType exec_provider) {
+  const auto& node_provider = node.GetExecutionProviderType();
+  std::string key;
+  key.reserve(128);
+  key.append(node.Domain()).push_back('\n');
+  key.append(node.OpType()).push_back('\n');
+  key.append(std::to_string(node.Op() != nullptr ? node.Op()->since_version() : -1)).push_back('\n');
+  key.append(node_provider.empty() ? exec_provider : node_provider).push_back('\n');
+  for (auto count : node.InputArgCount()) {
+    key.append(std::to_string(count)).push_back(',');
+  }
+  auto append_types = [&key](const std::vector<NodeArg*>& defs) {
+    key.push_back('\n');
+    for (const auto* def : defs) {
+      if (def->Exists() && def->Type() != nullptr) {
+        key.append(*def->Type());
+      }
+      key.push_back(',');
+    }
+  };
+  append_types(node.InputDefs());
+  append_types(node.OutputDefs());
+  return key;
+}
+
+const KernelCreateInfo* KernelRegistry::FindKernel(const onnxruntime::Node& node,
+                                                   onnxruntime::ProviderType exec_provider,
+                                                   std::vector<std::string>* error_strs) const {
+  // the entries of the map are never removed, so the result stays valid once the lock is released
+  std::lock_guard<OrtMutex> lock(kernel_creator_mutex_);
+  BuildDeferredKernels(node.OpType());
   auto range = kernel_creator_fn_map_.equal_range(node.OpType());
-  std::vector<std::string> error_strs;
   for (auto i = range.first; i != range.second; ++i) {
     if (!i->second.status.IsOK()) {
-      LOGS_DEFAULT(ERROR) << "Failed to create kernel for op: " << node.OpType()
-                          << " since it was ill-formed during registration";
+      // logged once, rather than again along with the errors
+      if (error_strs == nullptr) {
+        LOGS_DEFAULT(ERROR) << "Failed to create kernel for op: " << node.OpType()
+                            << " since it was ill-formed during registration";
+      }
       continue;
     }
     std::string error_str;
-    if (VerifyKernelDef(node, *i->second.kernel_def, error_str, exec_provider)) {
+    if (VerifyKernelDef(node, *i->second.kernel_def, error_strs != nullptr ? &error_str : nullptr, exec_provider)) {
       return &i->second;
     }
-    error_strs.push_back(error_str);
+    if (error_strs != nullptr) {
+      error_strs->push_back(error_str);
+    }
   }
-  LOGS_DEFAULT(INFO) << node.OpType() << " kernel is not supported in " << exec_provider
-                     << " Encountered following errors: " << ToString(error_strs);
   return nullptr;
 }
 
+const KernelCreateInfo* KernelRegistry::TryFindKernel(const onnxruntime::Node& node,
+                                                      onnxruntime::ProviderType exec_provider) const {
+  const std::string key = KernelLookupKey(node, exec_provider);
+  const KernelCreateInfo* kernel_create_info = nullptr;
+  bool found = false;
+  {
+    std::lock_guard<OrtMutex> lock(kernel_lookup_mutex_);
+    auto cached = kernel_lookup_cache_.find(key);
+    if (cached != kernel_lookup_cache_.end()) {
+      kernel_create_info = cached->second;
+      found = true;
+    }
+  }
+  if (!found) {
+    kernel_create_info = FindKernel(node, exec_provider, nullptr);
+    std::lock_guard<OrtMutex> lock(kernel_lookup_mutex_);
+    kernel_lookup_cache_.emplace(key, kernel_create_info);
+  }
+
+  // the reasons of the mismatches are only put together for the log
+  if (kernel_create_info == nullptr &&
+      logging::LoggingManager::DefaultLogger().OutputIsEnabled(logging::Severity::kINFO,
+                                                               logging::DataType::SYSTEM)) {
+    std::vector<std::string> error_strs;
+    FindKernel(node, exec_provider, &error_strs);
+    LOGS_DEFAULT(INFO) << node.OpType() << " kernel is not supported in " << exec_provider
+                       << " Encountered following errors: " << ToString(error_strs);
+  }
+  return kernel_create_info;
+}
+
 }  // namespace onnxruntime
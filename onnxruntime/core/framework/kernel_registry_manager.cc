@@ -13,13 +13,18 @@ Status KernelRegistryManager::CreateKernel(const onnxruntime::Node& node,
                                            const IExecutionProvider& execution_provider,
                                            const SessionState& session_state,
                                            /*out*/ std::unique_ptr<OpKernel>& op_kernel) const {
-  std::lock_guard<OrtMutex> lock(lock_);
-  if (kernel_registries_.empty()) {
+  // the kernels are constructed without holding the lock, so that sessions can create them in parallel
+  std::list<std::shared_ptr<KernelRegistry>> kernel_registries;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    kernel_registries = kernel_registries_;
+  }
+  if (kernel_registries.empty()) {
     return Status(ONNXRUNTIME, FAIL, "Kernel not found.");
   }
 
   Status status;
-  for (auto& registry : kernel_registries_) {
+  for (auto& registry : kernel_registries) {
     status = registry->CreateKernel(node, execution_provider, session_state, op_kernel);
     if (status.IsOK()) {
       return status;
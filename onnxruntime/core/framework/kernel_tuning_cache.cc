@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_tuning_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(_M_AMD64) || defined(_M_IX86)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace onnxruntime {
+
+namespace {
+
+// first line of a cache file. bump the version if the line format changes.
+const char* const kCacheFileHeader = "kernel_tuning_cache 1";
+
+// the CPU model and the number of logical processors, which the timings of the implementations depend on
+std::string GetHostKey() {
+  std::string brand;
+#if defined(_M_AMD64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  // the brand string is in the registers of the extended leaves 0x80000002 to 0x80000004
+  unsigned int registers[12] = {};
+  for (unsigned int leaf = 0; leaf < 3; ++leaf) {
+#if defined(_M_AMD64) || defined(_M_IX86)
+    int values[4];
+    __cpuid(values, static_cast<int>(0x80000002 + leaf));
+    memcpy(registers + leaf * 4, values, sizeof(values));
+#else
+    __get_cpuid(0x80000002 + leaf, registers + leaf * 4, registers + leaf * 4 + 1, registers + leaf * 4 + 2,
+                registers + leaf * 4 + 3);
+#endif
+  }
+  brand.assign(reinterpret_cast<const char*>(registers), strnlen(reinterpret_cast<const char*>(registers),
+                                                                  sizeof(registers)));
+#endif
+  if (brand.empty()) {
+    brand = "cpu";
+  }
+  return brand + " threads=" + std::to_string(std::thread::hardware_concurrency());
+}
+
+}  // namespace
+
+KernelTuningCache& KernelTuningCache::Instance() {
+  static KernelTuningCache instance;
+  return instance;
+}
+
+std::string KernelTuningCache::MakeKey(const char* kernel,
+                                       const std::vector<std::pair<const char*, std::vector<int64_t>>>& attributes) {
+  static const std::string host_key = GetHostKey();
+
+  std::ostringstream key;
+  key << kernel << '|' << host_key;
+  for (const auto& attribute : attributes) {
+    key << '|' << attribute.first << '=';
+    for (size_t i = 0; i < attribute.second.size(); ++i) {
+      key << (i == 0 ? "" : ",") << attribute.second[i];
+    }
+  }
+  return key.str();
+}
+
+bool KernelTuningCache::Find(const std::string& key, int64_t& decision) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  decision = it->second;
+  return true;
+}
+
+void KernelTuningCache::Insert(const std::string& key, int64_t decision) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  entries_[key] = decision;
+}
+
+Status KernelTuningCache::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return Status::OK();
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != kCacheFileHeader) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unrecognized kernel tuning cache file: ", path);
+  }
+
+  // each line holds the key followed by the decision, separated by a tab
+  std::unordered_map<std::string, int64_t> entries;
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    auto separator = line.find('\t');
+    std::istringstream value(separator == std::string::npos ? std::string() : line.substr(separator + 1));
+    int64_t decision;
+    if (!(value >> decision)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Malformed entry in kernel tuning cache file: ", path);
+    }
+    entries[line.substr(0, separator)] = decision;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& entry : entries) {
+    entries_.insert(entry);
+  }
+  return Status::OK();
+}
+
+Status KernelTuningCache::Save(const std::string& path) const {
+  std::ostringstream contents;
+  contents << kCacheFileHeader << '\n';
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    for (const auto& entry : entries_) {
+      contents << entry.first << '\t' << entry.second << '\n';
+    }
+  }
+
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  file << contents.str();
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write kernel tuning cache file: ", path);
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
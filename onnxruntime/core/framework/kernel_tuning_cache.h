@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Process wide cache of the implementations kernels chose by timing them for a problem when a session that enables
+// SessionOptions::enable_kernel_autotuning created them, e.g. the MLAS convolution algorithm of a Conv, shared by all
+// sessions. A key describes the problem (kernel, shapes and attributes) together with the CPU, so entries loaded
+// from a file written by another process are only used on matching hardware.
+class KernelTuningCache final {
+ public:
+  static KernelTuningCache& Instance();
+
+  // the key of a problem of kernel with the attributes, e.g. the shapes, appended as "|name=dims"
+  static std::string MakeKey(const char* kernel,
+                             const std::vector<std::pair<const char*, std::vector<int64_t>>>& attributes);
+
+  bool Find(const std::string& key, int64_t& decision) const;
+
+  void Insert(const std::string& key, int64_t decision);
+
+  // merges the entries of a file written by Save. a missing file is not an error.
+  Status Load(const std::string& path);
+
+  Status Save(const std::string& path) const;
+
+ private:
+  KernelTuningCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelTuningCache);
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<std::string, int64_t> entries_;  // GUARDED_BY(mutex_)
+};
+
+}  // namespace onnxruntime
@@ -11,9 +11,15 @@ Memcpy::Memcpy(const OpKernelInfo& info)
 }
 
 Status Memcpy::Compute(OpKernelContext* ctx) const {
-  const auto* X = ctx->Input<Tensor>(0);
-  Tensor* Y = ctx->Output(0, X->Shape());
-  Status retval = provider_->CopyTensor(*X, *Y, Info().GetKernelDef().ExecQueueId());
+  // a copy node may copy several tensors in the same direction, which the provider can batch
+  std::vector<const Tensor*> src;
+  std::vector<Tensor*> dst;
+  for (int i = 0; i < ctx->InputCount(); ++i) {
+    const auto* X = ctx->Input<Tensor>(i);
+    src.push_back(X);
+    dst.push_back(ctx->Output(i, X->Shape()));
+  }
+  Status retval = provider_->CopyTensors(src, dst, Info().GetKernelDef().ExecQueueId());
   return retval;
 }
 
@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mixed_precision_transformer.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/framework/kernel_registry.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/framework/tensorutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/mlas/inc/mlas.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+namespace {
+
+// ops that do the bulk of the math and are always run in float16. cuBLAS and cuDNN use tensor ops for them.
+const std::unordered_set<std::string> kComputeOps = {"MatMul", "Gemm", "Conv", "ConvTranspose"};
+
+// ops that are safe in float16 and run in float16 when one of their inputs is produced in float16,
+// which avoids a Cast between a compute op and the activation, bias add or reshape that follows it.
+const std::unordered_set<std::string> kFollowerOps = {
+    "Relu", "LeakyRelu", "Sigmoid", "Tanh", "Add", "Sub", "Mul", "Sum",
+    "MaxPool", "AveragePool", "GlobalAveragePool", "GlobalMaxPool",
+    "Transpose", "Pad", "Tile", "Concat", "Reshape", "Flatten", "Squeeze", "Unsqueeze", "Identity"};
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return arg.Exists() && type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+NodeArg& CreateFloat16Arg(Graph& graph, const NodeArg& arg) {
+  TypeProto type = *arg.TypeAsProto();
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(arg.Name() + "_fp16"), &type);
+}
+
+void AddCast(Graph& graph, NodeArg& input, NodeArg& output, TensorProto_DataType to_type,
+             const ProviderType& provider_type) {
+  auto& cast_node = graph.AddNode(graph.GenerateNodeName(output.Name() + "_cast"), "Cast",
+                                  "cast node at the boundary of a float16 region",
+                                  std::vector<NodeArg*>{&input}, std::vector<NodeArg*>{&output});
+  cast_node.AddAttribute("to", static_cast<int64_t>(to_type));
+  cast_node.SetExecutionProviderType(provider_type);
+}
+
+// adds a float16 copy of a float initializer
+Status AddFloat16Initializer(Graph& graph, const TensorProto& tensor_proto, const std::string& name) {
+  int64_t count = 1;
+  for (auto dim : utils::GetTensorShapeFromTensorProto(tensor_proto)) {
+    count *= dim;
+  }
+
+  std::vector<float> data(static_cast<size_t>(count));
+  ORT_RETURN_IF_ERROR(utils::TensorUtils::UnpackTensor(tensor_proto, data.data(), count));
+  std::vector<unsigned short> half_data(data.size());
+  MlasConvertFloatToHalfBuffer(data.data(), half_data.data(), data.size());
+
+  TensorProto half_proto;
+  half_proto.set_name(name);
+  half_proto.set_data_type(TensorProto_DataType_FLOAT16);
+  *half_proto.mutable_dims() = tensor_proto.dims();
+  // float16 values are stored as their bit patterns in int32_data
+  for (auto value : half_data) {
+    half_proto.add_int32_data(value);
+  }
+  graph.AddInitializedTensor(half_proto);
+  return Status::OK();
+}
+
+}  // namespace
+
+bool MixedPrecisionTransformer::HasKernel(const onnxruntime::Node& node) const {
+  for (auto* registry : kernels_registries_) {
+    if (registry->TryFindKernel(node, provider_type_) != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Status MixedPrecisionTransformer::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  // float16 version of each float arg that a converted node reads or writes
+  std::unordered_map<const NodeArg*, NodeArg*> float16_args;
+  // float args whose producer was converted, in the order they were converted
+  std::vector<NodeArg*> converted_outputs;
+  std::unordered_set<const NodeArg*> converted_output_set;
+  // float initializers copied to float16
+  std::vector<const NodeArg*> converted_initializers;
+  bool converted = false;
+
+  GraphViewer graph_viewer(graph);
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto* node = graph.GetNode(index);
+    if (node == nullptr)
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT);
+
+    if (node->GetExecutionProviderType() != provider_type_)
+      continue;
+
+    if (kComputeOps.count(node->OpType()) == 0) {
+      if (kFollowerOps.count(node->OpType()) == 0)
+        continue;
+      auto& inputs = node->InputDefs();
+      if (std::none_of(inputs.cbegin(), inputs.cend(),
+                       [&](const NodeArg* input) { return converted_output_set.count(input) > 0; }))
+        continue;
+    }
+
+    std::map<const NodeArg*, NodeArg*> replacement_defs;
+    std::vector<NodeArg*> new_inputs;
+    std::vector<NodeArg*> new_outputs;
+    for (auto* input : node->MutableInputDefs()) {
+      if (!IsFloatTensor(*input) || replacement_defs.count(input))
+        continue;
+      auto it = float16_args.find(input);
+      if (it != float16_args.end()) {
+        replacement_defs[input] = it->second;
+      } else {
+        replacement_defs[input] = &CreateFloat16Arg(graph, *input);
+        new_inputs.push_back(input);
+      }
+    }
+    for (auto* output : node->MutableOutputDefs()) {
+      if (!IsFloatTensor(*output))
+        continue;
+      replacement_defs[output] = &CreateFloat16Arg(graph, *output);
+      new_outputs.push_back(output);
+    }
+    if (replacement_defs.empty())
+      continue;
+
+    node->ReplaceDefs(replacement_defs);
+    if (!HasKernel(*node)) {
+      // no float16 kernel for this node, so leave it in float
+      std::map<const NodeArg*, NodeArg*> original_defs;
+      for (const auto& replacement : replacement_defs) {
+        original_defs[replacement.second] = const_cast<NodeArg*>(replacement.first);
+      }
+      node->ReplaceDefs(original_defs);
+      continue;
+    }
+
+    // feed the float inputs that are not produced in float16
+    for (auto* input : new_inputs) {
+      auto* half_input = replacement_defs[input];
+      const TensorProto* tensor_proto = nullptr;
+      // external data is only read when the session state is initialized, so it is cast when the graph runs
+      if (graph.GetInitializedTensor(input->Name(), tensor_proto) && !utils::HasExternalData(*tensor_proto)) {
+        ORT_RETURN_IF_ERROR(AddFloat16Initializer(graph, *tensor_proto, half_input->Name()));
+        converted_initializers.push_back(input);
+      } else {
+        AddCast(graph, *input, *half_input, TensorProto_DataType_FLOAT16, provider_type_);
+      }
+      float16_args[input] = half_input;
+    }
+
+    for (auto* output : new_outputs) {
+      float16_args[output] = replacement_defs[output];
+      converted_outputs.push_back(output);
+      converted_output_set.insert(output);
+    }
+    converted = true;
+  }
+
+  if (!converted)
+    return Status::OK();
+  modified = true;
+
+  // float args still read by nodes that stayed in float
+  std::unordered_set<const NodeArg*> float_consumed;
+  for (auto& node : graph.Nodes()) {
+    for (auto* input : node.InputDefs()) {
+      float_consumed.insert(input);
+    }
+    for (auto* input : node.ImplicitInputDefs()) {
+      float_consumed.insert(input);
+    }
+  }
+  for (auto* output : graph.GetOutputs()) {
+    float_consumed.insert(output);
+  }
+
+  // cast the region outputs back to float where they are still needed
+  for (auto* output : converted_outputs) {
+    if (float_consumed.count(output)) {
+      AddCast(graph, *float16_args[output], *output, TensorProto_DataType_FLOAT, provider_type_);
+    }
+  }
+
+  // drop the float initializers that were only read by converted nodes
+  for (auto* initializer : converted_initializers) {
+    if (!float_consumed.count(initializer)) {
+      graph.RemoveInitializedTensor(initializer->Name());
+    }
+  }
+
+  return graph.Resolve();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/graph/graph_viewer.h"
+#include "core/graph/graph_transformer.h"
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+// Runs the float nodes an execution provider has been assigned in float16.
+// MatMul, Gemm, Conv and ConvTranspose are always converted. Element-wise and data movement ops are converted only
+// when they consume the output of a converted node, so that a region of float16 nodes grows from the compute ops.
+// Numerically sensitive ops such as Softmax, reductions and normalizations stay in float.
+// Float inputs of a region are cast to float16 (initializers are converted in place) and outputs read by float nodes
+// or the graph are cast back, so casts are only placed at the region boundaries.
+// Must run after partitioning and before InsertCastTransformer, which removes adjacent Cast pairs.
+class MixedPrecisionTransformer : public onnxruntime::GraphTransformer {
+ public:
+  MixedPrecisionTransformer(const std::string& name, onnxruntime::ProviderType provider_type)
+      : onnxruntime::GraphTransformer(name, "Transformer to run float nodes of an execution provider in float16"),
+        provider_type_(provider_type) {
+  }
+
+  void AddKernelRegistries(const std::vector<const KernelRegistry*>& kernels) {
+    for (auto* kernel : kernels) {
+      if (kernel)
+        kernels_registries_.push_back(kernel);
+    }
+  }
+
+  void AddKernelRegistry(const KernelRegistry& kernel) {
+    kernels_registries_.push_back(&kernel);
+  }
+
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+
+ private:
+  bool HasKernel(const onnxruntime::Node& node) const;
+
+  onnxruntime::ProviderType provider_type_;
+  std::vector<const KernelRegistry*> kernels_registries_;
+};
+}  // namespace onnxruntime
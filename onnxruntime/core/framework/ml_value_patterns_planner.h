@@ -18,26 +18,34 @@ class MLValuePatternPlanner {
   explicit MLValuePatternPlanner(const SequentialExecutionPlan& execution_plan);
 
   common::Status TraceAllocation(int ml_value_idx, size_t size) {
-    auto location = execution_planner_.allocation_plan[ml_value_idx].location;
+    return TraceAllocation(execution_planner_.allocation_plan[ml_value_idx].location, ml_value_idx, size);
+  }
+
+  // trace a buffer at location that isn't an MLValue of the plan, such as the scratch buffer of a kernel. index
+  // must not collide with an MLValue index.
+  common::Status TraceAllocation(const OrtAllocatorInfo& location, int index, size_t size) {
     auto it = planner_map_.find(location);
     if (it == planner_map_.end()) {
       return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT);
     }
 
     std::lock_guard<OrtMutex> lock(lock_);
-    it->second->TraceAllocation(ml_value_idx, size);
+    it->second->TraceAllocation(index, size);
     return common::Status::OK();
   }
 
   common::Status TraceFree(int ml_value_index) {
-    auto location = execution_planner_.allocation_plan[ml_value_index].location;
+    return TraceFree(execution_planner_.allocation_plan[ml_value_index].location, ml_value_index);
+  }
+
+  common::Status TraceFree(const OrtAllocatorInfo& location, int index) {
     auto it = planner_map_.find(location);
     if (it == planner_map_.end()) {
       return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT);
     }
 
     std::lock_guard<OrtMutex> lock(lock_);
-    it->second->TraceFree(ml_value_index);
+    it->second->TraceFree(index);
     return common::Status::OK();
   }
 
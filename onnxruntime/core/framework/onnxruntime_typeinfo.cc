@@ -6,6 +6,7 @@
 #include <cassert>
 #include "onnxruntime_typeinfo.h"
 #include "core/framework/tensor.h"
+#include "core/framework/tensor_seq.h"
 #include "core/graph/onnx_protobuf.h"
 
 using onnxruntime::BFloat16;
@@ -49,7 +50,7 @@ OrtStatus* OrtTypeInfo::FromDataTypeImpl(const onnxruntime::DataTypeImpl* input,
     *out = new OrtTypeInfo(ONNX_TYPE_MAP, nullptr);
     return nullptr;
   }
-  if (input == DataTypeImpl::GetType<onnxruntime::VectorString>() || input == DataTypeImpl::GetType<onnxruntime::VectorFloat>() || input == DataTypeImpl::GetType<onnxruntime::VectorInt64>() || input == DataTypeImpl::GetType<onnxruntime::VectorDouble>() || input == DataTypeImpl::GetType<onnxruntime::VectorMapStringToFloat>() || input == DataTypeImpl::GetType<onnxruntime::VectorMapInt64ToFloat>()) {
+  if (input == DataTypeImpl::GetType<onnxruntime::VectorString>() || input == DataTypeImpl::GetType<onnxruntime::VectorFloat>() || input == DataTypeImpl::GetType<onnxruntime::VectorInt64>() || input == DataTypeImpl::GetType<onnxruntime::VectorDouble>() || input == DataTypeImpl::GetType<onnxruntime::VectorMapStringToFloat>() || input == DataTypeImpl::GetType<onnxruntime::VectorMapInt64ToFloat>() || input == DataTypeImpl::GetType<onnxruntime::TensorSeq>()) {
     *out = new OrtTypeInfo(ONNX_TYPE_SEQUENCE, nullptr);
     return nullptr;
   }
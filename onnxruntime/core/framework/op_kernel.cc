@@ -2,9 +2,15 @@
 // Licensed under the MIT License.
 
 #include "core/framework/op_kernel.h"
+
+#include <algorithm>
+#include <exception>
+#include "core/common/task_thread_pool.h"
+#include "core/framework/environment.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
 #include "core/graph/op.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/common/logging/logging.h"
 using namespace ::onnxruntime::common;
 namespace onnxruntime {
@@ -14,7 +20,8 @@ OpKernelContext::OpKernelContext(ExecutionFrame* frame,
                                  const logging::Logger& logger)
     : execution_frame_(frame),
       kernel_(kernel),
-      logger_(&logger) {
+      logger_(&logger),
+      thread_pool_(Environment::GetIntraOpThreadPool()) {
   ORT_ENFORCE(frame != nullptr, "Execution frame was null");
   ORT_ENFORCE(kernel != nullptr, "OpKernel was null");
 
@@ -23,6 +30,10 @@ OpKernelContext::OpKernelContext(ExecutionFrame* frame,
   node_output_start_index_ = node_implicit_input_start_index_ + ImplicitInputCount();
 }
 
+OpKernelContext::~OpKernelContext() {
+  ReleaseScratchBuffer(false);
+}
+
 Tensor* OpKernelContext::Output(int index, const TensorShape& shape) {
   if (index < 0 || index >= OutputCount())
     return nullptr;
@@ -56,6 +67,81 @@ Status OpKernelContext::GetTempSpaceAllocator(AllocatorPtr* output) const {
   return Status::OK();
 }
 
+void* OpKernelContext::GetScratchBuffer(size_t bytes) {
+  if (has_scratch_buffer_) {
+    ORT_ENFORCE(bytes <= scratch_bytes_, "The scratch buffer of ", scratch_bytes_,
+                " bytes was already allocated for this Compute. ", bytes, " bytes were requested.");
+    return scratch_buffer_.get();
+  }
+
+  const auto& location = kernel_->Allocator(0, OrtMemTypeDefault);
+  Status status = execution_frame_->AllocateScratchBuffer(GetNodeIndex(), location, bytes, scratch_buffer_);
+  ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+  scratch_bytes_ = bytes;
+  has_scratch_buffer_ = true;
+  return scratch_buffer_.get();
+}
+
+int OpKernelContext::NumParallelRanges() const {
+  if (thread_pool_ == nullptr) {
+    return 1;
+  }
+  int num_ranges = thread_pool_->NumThreads() + 1;
+  const int32_t thread_limit = MlasGetThreadLimit();
+  if (thread_limit > 0) {
+    num_ranges = std::min(num_ranges, static_cast<int>(thread_limit));
+  }
+  return num_ranges;
+}
+
+void OpKernelContext::ParallelFor(int64_t total, int64_t min_per_range,
+                                  const std::function<void(int64_t, int64_t)>& fn) const {
+  if (total <= 0) {
+    return;
+  }
+  const int64_t num_ranges = std::min<int64_t>(NumParallelRanges(), total / std::max<int64_t>(min_per_range, 1));
+  if (num_ranges <= 1) {
+    fn(0, total);
+    return;
+  }
+
+  // the ranges that haven't started once the Run terminates are skipped, like the blocks of MLAS operations
+  const MLAS_CANCELLATION* cancellation = MlasGetCancellation();
+
+  // the pool doesn't propagate exceptions, so the first one is rethrown once every range has completed
+  std::exception_ptr exception;
+  OrtMutex exception_mutex;
+  thread_pool_->ParallelFor(static_cast<int32_t>(num_ranges), [&](int32_t i) {
+    if (cancellation != nullptr && cancellation->IsCancelled(cancellation->Context)) {
+      return;
+    }
+    try {
+      fn(total * i / num_ranges, total * (i + 1) / num_ranges);
+    } catch (...) {
+      std::lock_guard<OrtMutex> lock(exception_mutex);
+      if (!exception) {
+        exception = std::current_exception();
+      }
+    }
+  });
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+void OpKernelContext::ReleaseScratchBuffer(bool trace_free) {
+  if (!has_scratch_buffer_) {
+    return;
+  }
+
+  scratch_buffer_.reset();
+  scratch_bytes_ = 0;
+  has_scratch_buffer_ = false;
+  if (trace_free) {
+    execution_frame_->TraceScratchBufferFree(GetNodeIndex(), kernel_->Allocator(0, OrtMemTypeDefault));
+  }
+}
+
 MLDataType OpKernelContext::InputType(int index) const {
   int input_arg_index = GetInputArgIndex(index);
   const MLValue* p_ml_value = execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index);
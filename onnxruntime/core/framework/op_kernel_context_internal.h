@@ -4,6 +4,8 @@
 #pragma once
 
 #include "core/framework/op_kernel.h"
+#include "core/framework/run_termination.h"
+#include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
 
 // onnxruntime internal OpKernelContext derived class to provide additional
@@ -18,10 +20,11 @@ class OpKernelContextInternal : public OpKernelContext {
                                    const OpKernel& kernel,
                                    const logging::Logger& logger,
                                    const std::vector<NodeArg*>& implicit_inputs,
-                                   const bool& terminate_flag)
+                                   const RunTermination& termination)
       : OpKernelContext(&frame, &kernel, logger),
+        kernel_{kernel},
         implicit_inputs_{implicit_inputs},
-        terminate_flag_{terminate_flag} {
+        termination_{termination} {
   }
 
   const SessionState* SubgraphSessionState(const std::string& attribute_name) {
@@ -36,6 +39,47 @@ class OpKernelContextInternal : public OpKernelContext {
     return OpKernelContext::GetOutputMLValue(index);
   }
 
+  void ReleaseScratchBuffer(bool trace_free) {
+    OpKernelContext::ReleaseScratchBuffer(trace_free);
+  }
+
+  // true if the allocation plan doesn't put any other value in the buffer of output 'index', e.g. for an in-place
+  // update by a later node. the output can then be set to an MLValue the kernel didn't allocate.
+  bool OutputBufferIsShareable(int index) const {
+    if (index < 0 || index >= OutputCount()) {
+      return false;
+    }
+
+    const auto& session_state = GetSessionState();
+    const auto* plan = session_state.GetExecutionPlan();
+    int mlvalue_idx;
+    if (plan == nullptr ||
+        !session_state.GetMLValueNameIdxMap().GetIdx(kernel_.Node().OutputDefs()[index]->Name(), mlvalue_idx).IsOK()) {
+      return false;
+    }
+
+    for (const auto& value_plan : plan->allocation_plan) {
+      if (value_plan.alloc_kind == AllocKind::kReuse && value_plan.reused_buffer == mlvalue_idx) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // the bytes of the tensors the kernel has output
+  size_t OutputTensorBytes() {
+    size_t bytes = 0;
+    for (int index = 0; index < OutputCount(); ++index) {
+      const MLValue* p_mlvalue = GetOutputMLValue(index);
+      if (p_mlvalue != nullptr && p_mlvalue->IsAllocated() && p_mlvalue->IsTensor()) {
+        bytes += p_mlvalue->Get<Tensor>().Size();
+      }
+    }
+
+    return bytes;
+  }
+
   std::unordered_map<std::string, const MLValue*> GetImplicitInputs() const {
     // we need to convert implicit_inputs_ to a name to MLValue map so it can be used in the ExecutionFrame
     // for a subgraph (the index numbers will be different there).
@@ -48,11 +92,12 @@ class OpKernelContextInternal : public OpKernelContext {
     return implicit_inputs_map;
   }
 
-  const bool& GetTerminateFlag() const noexcept { return terminate_flag_; }
+  const RunTermination& GetTermination() const noexcept { return termination_; }
 
  private:
+  const OpKernel& kernel_;
   const std::vector<NodeArg*>& implicit_inputs_;
-  const bool& terminate_flag_;
+  const RunTermination& termination_;
 };
 
 }  // namespace onnxruntime
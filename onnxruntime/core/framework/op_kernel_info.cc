@@ -66,6 +66,36 @@ bool OpKernelInfo::TryGetConstantInput(int input_index, const Tensor** constant_
   return true;
 }
 
+bool OpKernelInfo::IsKernelAutotuningEnabled() const {
+  return session_state_.GetEnableKernelAutotuning();
+}
+
+WeightCompression OpKernelInfo::GetWeightCompression() const {
+  return session_state_.GetWeightCompression();
+}
+
+bool OpKernelInfo::TryGetStaticInputShape(int input_index, TensorShape& shape) const {
+  if (!session_state_.GetInputShapesFrozen() ||
+      input_index < 0 || input_index >= gsl::narrow_cast<int>(node_.InputDefs().size())) {
+    return false;
+  }
+  const auto* shape_proto = node_.InputDefs()[input_index]->Shape();
+  if (shape_proto == nullptr) {
+    return false;
+  }
+
+  std::vector<int64_t> dims;
+  dims.reserve(shape_proto->dim_size());
+  for (const auto& dim : shape_proto->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+    dims.push_back(dim.dim_value());
+  }
+  shape = TensorShape(dims);
+  return true;
+}
+
 common::Status OpKernelInfo::GetFusedFuncs(ComputeFunc* compute, CreateFunctionStateFunc* create, DestroyFunctionStateFunc* release) const {
   auto* funcs_mgr = session_state_.GetFuncMgr();
   return funcs_mgr->GetFuncs(node_.Name(), compute, create, release);
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/output_ready_notifier.h"
+
+#include <algorithm>
+#include <cstring>
+#include "core/framework/execution_frame.h"
+#include "core/framework/mlvalue_name_idx_map.h"
+#include "core/framework/tensor.h"
+#include "core/graph/constants.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+OutputReadyNotifier::OutputReadyNotifier(const Callback& callback, size_t num_outputs)
+    : callback_(callback), num_outputs_(num_outputs), notified_(std::make_unique<std::atomic<bool>[]>(num_outputs)) {
+  for (size_t i = 0; i < num_outputs_; ++i) {
+    notified_[i].store(false, std::memory_order_relaxed);
+  }
+}
+
+void OutputReadyNotifier::NotifyNodeOutputs(const Node& node, const MLValueNameIdxMap& name_idx_map,
+                                            const ExecutionFrame& frame, const std::vector<int>& fetch_mlvalue_idxs) {
+  if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+    return;
+  }
+
+  for (const auto* output_def : node.OutputDefs()) {
+    int mlvalue_idx;
+    if (!output_def->Exists() || !name_idx_map.GetIdx(output_def->Name(), mlvalue_idx).IsOK()) {
+      continue;
+    }
+
+    // the same value may be fetched more than once
+    for (size_t i = 0, end = std::min(fetch_mlvalue_idxs.size(), num_outputs_); i < end; ++i) {
+      if (fetch_mlvalue_idxs[i] != mlvalue_idx) {
+        continue;
+      }
+      const MLValue& value = frame.GetMLValue(mlvalue_idx);
+      if (!value.IsAllocated() || (value.IsTensor() && strcmp(value.Get<Tensor>().Location().name, CPU) != 0)) {
+        continue;
+      }
+      Notify(i, value);
+    }
+  }
+}
+
+void OutputReadyNotifier::NotifyRemaining(const std::vector<MLValue>& fetches) {
+  for (size_t i = 0, end = std::min(fetches.size(), num_outputs_); i < end; ++i) {
+    if (!notified_[i].load(std::memory_order_acquire)) {
+      Notify(i, fetches[i]);
+    }
+  }
+}
+
+void OutputReadyNotifier::Notify(size_t output_index, const MLValue& value) {
+  if (!notified_[output_index].exchange(true, std::memory_order_acq_rel)) {
+    callback_(output_index, value);
+  }
+}
+
+}  // namespace onnxruntime
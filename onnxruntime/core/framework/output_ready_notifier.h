@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "core/common/common.h"
+#include "core/framework/ml_value.h"
+
+namespace onnxruntime {
+
+class ExecutionFrame;
+class MLValueNameIdxMap;
+class Node;
+
+/**
+  * Reports each output of a Run once to the output_ready_callback of its RunOptions, as soon as its value is final.
+  * The executors report the outputs that a node of the CPU execution provider has put in CPU memory once the node
+  * has run. The work of the other providers may still be queued on their devices and their outputs may yet be
+  * copied across devices, so those, and the outputs that no node produces, are reported once the Run has completed.
+  */
+class OutputReadyNotifier {
+ public:
+  using Callback = std::function<void(size_t output_index, const MLValue& value)>;
+
+  // callback must outlive the notifier
+  OutputReadyNotifier(const Callback& callback, size_t num_outputs);
+
+  // reports the outputs of node, which has just run with frame, that are fetched as the outputs with
+  // fetch_mlvalue_idxs. it may be called for different nodes at the same time.
+  void NotifyNodeOutputs(const Node& node, const MLValueNameIdxMap& name_idx_map, const ExecutionFrame& frame,
+                         const std::vector<int>& fetch_mlvalue_idxs);
+
+  // reports the outputs that haven't been yet with the fetches of the completed Run
+  void NotifyRemaining(const std::vector<MLValue>& fetches);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OutputReadyNotifier);
+
+  void Notify(size_t output_index, const MLValue& value);
+
+  const Callback& callback_;
+  const size_t num_outputs_;
+  std::unique_ptr<std::atomic<bool>[]> notified_;
+};
+
+}  // namespace onnxruntime
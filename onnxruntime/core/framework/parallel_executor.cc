@@ -3,8 +3,11 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
+#include <deque>
 #include <memory>
+#include <sstream>
 #include <thread>
 #include <vector>
 #include "core/common/common.h"
@@ -15,18 +18,126 @@
 #endif
 
 #include "core/framework/allocation_planner.h"
+#include "core/framework/cost_based_placement_transformer.h"
+#include "core/framework/environment.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/hardware_counters.h"
+#include "core/framework/utils.h"
 
 namespace onnxruntime {
 
-ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_{terminate_flag} {
+namespace {
+// runs the kernel of a node on the compute queue the node was assigned to, for a provider that isn't null
+class ScopedComputeQueue {
+ public:
+  ScopedComputeQueue(const IExecutionProvider* provider, int queue_id) : provider_(provider) {
+    if (provider_ != nullptr) provider_->SetComputeQueue(queue_id);
+  }
+
+  ~ScopedComputeQueue() {
+    if (provider_ != nullptr) provider_->SetComputeQueue(0);
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedComputeQueue);
+
+  const IExecutionProvider* const provider_;
+};
+
+// orders the nodes by their priority, the one with the lower index first if they are equal so the order is
+// deterministic. a heap with this order has the highest priority node at the top.
+struct LowerPriority {
+  const SessionState& session_state;
+
+  bool operator()(size_t a, size_t b) const {
+    const double priority_a = session_state.GetNodePriority(a);
+    const double priority_b = session_state.GetNodePriority(b);
+    return priority_a < priority_b || (priority_a == priority_b && a > b);
+  }
+};
+}  // namespace
+
+std::vector<double> ParallelExecutor::ComputeNodePriorities(const GraphViewer& graph_viewer,
+                                                            const PlacementCostModel& cost_model) {
+  std::vector<double> priorities(graph_viewer.MaxNodeIndex(), 0.0);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const auto* node = graph_viewer.GetNode(*it);
+    if (node == nullptr)
+      continue;
+
+    double successors_rank = 0.0;
+    for (auto edge = node->OutputEdgesBegin(); edge != node->OutputEdgesEnd(); ++edge) {
+      successors_rank = std::max(successors_rank, priorities[edge->GetNode().Index()]);
+    }
+    priorities[*it] = cost_model.NodeTime(*node) + successors_rank;
+  }
+  return priorities;
+}
+
+constexpr double ParallelExecutor::kMaxClusteredNodeUs;
+constexpr double ParallelExecutor::kMaxClusterUs;
+
+std::vector<NodeIndex> ParallelExecutor::ComputeNodeClusters(const GraphViewer& graph_viewer,
+                                                             const PlacementCostModel& cost_model) {
+  std::vector<NodeIndex> clusters(graph_viewer.MaxNodeIndex());
+  for (NodeIndex i = 0; i < clusters.size(); ++i) {
+    clusters[i] = i;
+  }
+  // the time of the nodes that joined each cluster
+  std::vector<double> cluster_times(graph_viewer.MaxNodeIndex(), 0.0);
+
+  for (auto node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    const auto* node = graph_viewer.GetNode(node_index);
+    if (node == nullptr || !cost_model.IsNodeTimeKnown(*node))
+      continue;
+    const double time = cost_model.NodeTime(*node);
+    if (time > kMaxClusteredNodeUs)
+      continue;
+
+    // the node may join the cluster of any producer it fits in, the one named after the first node for a
+    // deterministic choice. the task of the producer that finishes last runs it, whether or not it's that one.
+    NodeIndex cluster = node_index;
+    for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+      const NodeIndex producer_cluster = clusters[edge->GetNode().Index()];
+      if (producer_cluster < cluster && cluster_times[producer_cluster] + time <= kMaxClusterUs) {
+        cluster = producer_cluster;
+      }
+    }
+    if (cluster != node_index) {
+      clusters[node_index] = cluster;
+      cluster_times[cluster] += time;
+    }
+  }
+  return clusters;
+}
+
+void ParallelExecutor::SortByPriority(std::vector<size_t>& node_indices, const SessionState& session_state) {
+  LowerPriority lower_priority{session_state};
+  std::sort(node_indices.begin(), node_indices.end(),
+            [&lower_priority](size_t a, size_t b) { return lower_priority(b, a); });
+}
+
+ParallelExecutor::ParallelExecutor(const SessionState& session_state, const RunTermination& termination,
+                                   int intra_op_thread_limit, profiling::Profiler* run_profiler,
+                                   OutputReadyNotifier* output_ready)
+    : out_standings_(0),
+      intra_op_thread_limit_(intra_op_thread_limit),
+      termination_{termination},
+      run_profiler_{run_profiler},
+      output_ready_{output_ready} {
   auto graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer->MaxNodeIndex());
+  node_refs_ = std::make_unique<std::atomic<size_t>[]>(graph_viewer->MaxNodeIndex());
   for (auto& node : graph_viewer->Nodes()) {
-    node_refs_[node.Index()] = node.GetInputEdgesCount();
+    node_refs_[node.Index()].store(node.GetInputEdgesCount(), std::memory_order_relaxed);
+  }
+
+  const auto& buffer_use_counts = session_state.GetExecutionPlan()->buffer_use_counts;
+  buffer_refs_ = std::make_unique<std::atomic<int>[]>(buffer_use_counts.size());
+  for (size_t i = 0, end = buffer_use_counts.size(); i < end; ++i) {
+    buffer_refs_[i].store(buffer_use_counts[i], std::memory_order_relaxed);
   }
 }
 
@@ -37,33 +148,79 @@ Status ParallelExecutor::Execute(const SessionState& session_state,
                                  const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                                  const logging::Logger& logger) {
   TimePoint tp;
-  bool f_profiler_enabled = session_state.Profiler().FEnabled();
+  profiling::Profiler& profiler = run_profiler_ != nullptr ? *run_profiler_ : session_state.Profiler();
+  bool f_profiler_enabled = profiler.FEnabled();
   if (f_profiler_enabled) {
-    tp = session_state.Profiler().StartTime();
+    tp = profiler.StartTime();
   }
 
-  root_frame_ = std::make_unique<ExecutionFrame>(feeds, output_names, fetches, fetch_allocators, session_state);
-  //std::cout << "start nodes:" << std::endl;
-  for (auto node_index : session_state.GetGraphViewer()->GetRootNodes()) {
-    auto p_op_kernel = session_state.GetKernel(node_index);
-    if (!p_op_kernel)
-      continue;
+  root_frame_ = session_state.AcquireExecutionFrame(feeds, output_names, fetches, fetch_allocators);
+  if (output_ready_ != nullptr) {
+    const auto& name_idx_map = session_state.GetMLValueNameIdxMap();
+    fetch_mlvalue_idxs_.resize(output_names.size());
+    for (size_t i = 0, end = output_names.size(); i < end; ++i) {
+      ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(output_names[i], fetch_mlvalue_idxs_[i]));
+    }
+  }
 
-    //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
+  // the thread pool runs its tasks in the order they are scheduled, so schedule the critical path first
+  std::vector<size_t> root_nodes;
+  for (auto node_index : session_state.GetGraphViewer()->GetRootNodes()) {
+    if (session_state.GetKernel(node_index) != nullptr)
+      root_nodes.push_back(node_index);
+  }
+  SortByPriority(root_nodes, session_state);
+  for (auto node_index : root_nodes) {
     EnqueueNode(node_index, session_state, logger);
   }
 
   // Wait for finish.
+#ifndef USE_EIGEN_THREADPOOL
+  // if Execute itself is running on a pool worker (e.g. an async Run) blocking here could leave no worker free to
+  // run our nodes, so help by running queued tasks until they are done.
+  auto* thread_pool = session_state.GetThreadPool();
+  if (thread_pool->CurrentThreadId() >= 0) {
+    while (out_standings_ > 0) {
+      if (!thread_pool->RunPendingTask()) {
+        std::unique_lock<OrtMutex> lock(complete_mutex_);
+        if (out_standings_ > 0) complete_cv_.wait_for(lock, std::chrono::microseconds(100));
+      }
+    }
+  }
+#endif
   {
     std::unique_lock<OrtMutex> lock(complete_mutex_);
     while (out_standings_ > 0) complete_cv_.wait(lock);
   }
 
+  if (!errors_.empty()) {
+    if (errors_.size() == 1)
+      return errors_.front();
+
+    std::ostringstream ss;
+    ss << "Multiple errors were found.";
+    for (const auto& status : errors_) {
+      ss << '\n'
+         << status;
+    }
+    return Status(ONNXRUNTIME, FAIL, ss.str());
+  }
+
+  // the fetches are not returned once the Run terminated, even if every node finished
+  Status termination_status = termination_.Check();
+  if (!termination_status.IsOK()) {
+    LOGS(logger, WARNING) << termination_status.ErrorMessage();
+    return termination_status;
+  }
+
   VLOGS(logger, 1) << "Fetching output.";
   ORT_RETURN_IF_ERROR(
       FetchOutput(session_state.GetMLValueNameIdxMap(), *root_frame_, output_names, fetches, logger));
 
-  if (root_frame_->HasPlan()) {
+  // the nodes on different compute queues may use values at the same time on the device that the pattern would
+  // place in the same memory as their uses on the host don't overlap
+  const bool spreads_compute_queues = !session_state.GetExecutionPlan()->node_exec_queue_ids.empty();
+  if (!spreads_compute_queues && (root_frame_->HasPlan() || root_frame_->MemoryPatternOverflowed())) {
     std::vector<TensorShape> input_shapes;
     bool all_tensors = true;
     for (const auto& feed : feeds) {
@@ -75,7 +232,10 @@ Status ParallelExecutor::Execute(const SessionState& session_state,
       input_shapes.push_back(tensor.Shape());
     }
 
-    if (all_tensors) {
+    if (all_tensors && root_frame_->MemoryPatternOverflowed()) {
+      // the cached pattern is too small for some input shapes in its bucket, so have the next Run re-plan it.
+      session_state.InvalidateMemoryPatternGroup(input_shapes);
+    } else if (all_tensors) {
       auto mem_patterns = std::make_unique<MemoryPatternGroup>();
       ORT_RETURN_IF_ERROR(root_frame_->GeneratePatterns(mem_patterns.get()));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
@@ -83,7 +243,7 @@ Status ParallelExecutor::Execute(const SessionState& session_state,
   }
 
   if (f_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
+    profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
   }
   return Status::OK();
 }
@@ -91,12 +251,32 @@ Status ParallelExecutor::Execute(const SessionState& session_state,
 void ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                     const SessionState& session_state,
                                     const logging::Logger& logger) {
+  // apply the Run's thread limit to any MLAS operations in kernels run by this task
+  utils::ScopedIntraOpThreadLimit thread_limit(intra_op_thread_limit_);
+  ScopedRunTermination termination(termination_);
+
+  Status status;
   try {
     RunNodeAsyncInternal(p_node_index, session_state, logger);
+    return;
+  } catch (const std::exception& ex) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
   } catch (...) {
-    FinishNodeRun();
-    throw;
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "Unknown exception running node.");
   }
+
+  {
+    std::lock_guard<OrtMutex> lock(error_mutex_);
+    errors_.push_back(status);
+  }
+
+  // hand this task's slot to a deferred node so it still runs and Execute can complete
+  size_t pending_node_index;
+  if (TakePendingNode(pending_node_index, session_state)) {
+    ScheduleNode(pending_node_index, session_state, logger);
+  }
+
+  FinishNodeRun();
 }
 
 void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
@@ -109,16 +289,30 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
   auto graph_viewer = session_state.GetGraphViewer();
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
-  bool f_profiler_enabled = session_state.Profiler().FEnabled();
+  profiling::Profiler& profiler = run_profiler_ != nullptr ? *run_profiler_ : session_state.Profiler();
+  bool f_profiler_enabled = profiler.FEnabled();
+  std::vector<size_t> ready_nodes;
+  // ready nodes of the cluster of the nodes this task runs, which it runs after its current node
+  std::deque<size_t> cluster_nodes;
   // Avoid context switching if possible.
   while (keep_running) {
     // TODO: Convert RunNodeAsync return Status.
     // to also handle exception propagation
-    if (terminate_flag_) {
-      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
-      ORT_THROW("Exiting due to terminate flag being set to true.");
+    Status termination_status = termination_.Check();
+    if (!termination_status.IsOK()) {
+      LOGS(logger, WARNING) << termination_status.ErrorMessage();
+      ORT_THROW(termination_status.ErrorMessage());
     }
 
+    // let the more urgent work other Runs queued on the thread pools go first
+    TaskThreadPool* intra_op_pool = Environment::GetIntraOpThreadPool();
+    utils::RunHigherPriorityTasks(intra_op_pool);
+#ifndef USE_EIGEN_THREADPOOL
+    if (session_state.GetThreadPool() != intra_op_pool) {
+      utils::RunHigherPriorityTasks(session_state.GetThreadPool());
+    }
+#endif
+
     auto p_op_kernel = session_state.GetKernel(node_index);
 
     // if a kernel has been added in the session state, it better be NON-null.
@@ -129,13 +323,19 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
 
     OpKernelContextInternal op_kernel_context(*root_frame_, *p_op_kernel, logger,
                                               p_op_kernel->Node().ImplicitInputDefs(),
-                                              terminate_flag_);
+                                              termination_);
 
     if (f_profiler_enabled) {
-      sync_time_begin = session_state.Profiler().StartTime();
+      sync_time_begin = profiler.StartTime();
     }
     // sync before compute
-    int queue_id = p_op_kernel->KernelDef().ExecQueueId();
+    const auto& node_exec_queue_ids = session_state.GetExecutionPlan()->node_exec_queue_ids;
+    const int kernel_queue_id = p_op_kernel->KernelDef().ExecQueueId();
+    const int queue_id = node_exec_queue_ids.empty() ? kernel_queue_id : node_exec_queue_ids[node_index];
+    const IExecutionProvider* compute_queue_provider = nullptr;
+    if (queue_id != kernel_queue_id) {
+      compute_queue_provider = session_state.GetExecutionProviders().Get(p_op_kernel->Node());
+    }
 
     for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
       Fence_t fence = op_kernel_context.InputFence(input_index);
@@ -167,29 +367,75 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
     }
 
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_fence_before",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                     p_op_kernel->Node().Name() + "_fence_before",
+                                     sync_time_begin,
+                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
 
-      kernel_begin_time = session_state.Profiler().StartTime();
+      kernel_begin_time = profiler.StartTime();
     }
 
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << p_op_kernel->Node().Name();
 
+    // the metrics of the session are updated for every Run, unlike the profile
+    auto* op_counters = session_state.GetOpCounters(node_index);
+    TimePoint metrics_begin_time;
+    if (op_counters != nullptr) {
+      metrics_begin_time = std::chrono::high_resolution_clock::now();
+    }
+    // the hardware events of the thread while the kernel computes
+    const bool count_hardware_events =
+        session_state.GetEnableHardwareCounters() && (f_profiler_enabled || op_counters != nullptr);
+    HardwareCounterValues hardware_events;
+    if (count_hardware_events) {
+      hardware_events = HardwareCounters::ForCurrentThread().Read();
+    }
     // Execute the kernel.
-    auto status = p_op_kernel->Compute(&op_kernel_context);
+    Status status;
+    {
+      ScopedComputeQueue compute_queue(compute_queue_provider, queue_id);
+      status = p_op_kernel->Compute(&op_kernel_context);
+    }
     if (!status.IsOK()) {
-      ORT_THROW("Compute failed for node: ", graph_viewer->GetNode(node_index)->Name());
+      ORT_THROW("Compute failed for node: ", graph_viewer->GetNode(node_index)->Name(), ". ", status.ErrorMessage());
+    }
+    // a kernel whose MLAS operations stopped once the Run terminated returns OK with outputs it didn't finish
+    termination_status = termination_.Check();
+    if (!termination_status.IsOK()) {
+      LOGS(logger, WARNING) << termination_status.ErrorMessage();
+      ORT_THROW(termination_status.ErrorMessage());
+    }
+    if (count_hardware_events) {
+      hardware_events = HardwareCounters::ForCurrentThread().Read() - hardware_events;
+    }
+    if (op_counters != nullptr) {
+      op_counters->Record(std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::high_resolution_clock::now() - metrics_begin_time)
+                              .count(),
+                          op_kernel_context.OutputTensorBytes(), hardware_events);
     }
+    auto* calibration = session_state.GetCalibration();
+    if (calibration != nullptr && QuantizationCalibration::IsCalibrated(p_op_kernel->Node().OpType())) {
+      calibration->Record(p_op_kernel->Node().InputDefs()[0]->Name(), op_kernel_context.GetInputMLValue(0));
+      calibration->Record(p_op_kernel->Node().OutputDefs()[0]->Name(), op_kernel_context.GetOutputMLValue(0));
+    }
+
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      if (count_hardware_events) {
+        profiler.EndTimeAndRecordCountedEvent(profiling::NODE_EVENT,
+                                              p_op_kernel->Node().Name() + "_kernel_time",
+                                              kernel_begin_time,
+                                              hardware_events,
+                                              {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      } else {
+        profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                       p_op_kernel->Node().Name() + "_kernel_time",
+                                       kernel_begin_time,
+                                       {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      }
 
-      sync_time_begin = session_state.Profiler().StartTime();
+      sync_time_begin = profiler.StartTime();
     }
     // sync after compute for outputs
     for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
@@ -213,36 +459,64 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
       }
     }
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_fence_after",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                     p_op_kernel->Node().Name() + "_fence_after",
+                                     sync_time_begin,
+                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
     }
     //std::cout << "Run async node finish: " << p_node_index << std::endl;
 
+    if (output_ready_ != nullptr) {
+      output_ready_->NotifyNodeOutputs(p_op_kernel->Node(), session_state.GetMLValueNameIdxMap(), *root_frame_,
+                                       fetch_mlvalue_idxs_);
+    }
+
+    ReleaseNodeValues(p_op_kernel->Node(), *session_state.GetExecutionPlan());
+
     keep_running = false;
 
     // Checking which output nodes ready for running.
-    {
-      auto begin = p_op_kernel->Node().OutputEdgesBegin();
-      auto end = p_op_kernel->Node().OutputEdgesEnd();
-
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
-      for (auto it = begin; it != end; it++) {
-        auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
-          }
-        }
+    // The dependency counters are atomic so no lock is needed. The ready successors of the cluster of the node are
+    // cheap ones this thread runs next. Otherwise the ready successor on the critical path, the one of the highest
+    // priority, is run inline on this thread. The others are scheduled in the order of their priorities and will
+    // be picked up by idle workers.
+    ready_nodes.clear();
+    for (auto it = p_op_kernel->Node().OutputEdgesBegin(), end = p_op_kernel->Node().OutputEdgesEnd(); it != end;
+         ++it) {
+      auto idx = (*it).GetNode().Index();
+      if (node_refs_[idx].fetch_sub(1) == 1) {
+        ready_nodes.push_back(idx);
+      }
+    }
+
+    if (!ready_nodes.empty()) {
+      SortByPriority(ready_nodes, session_state);
+      const auto cluster = session_state.GetNodeCluster(node_index);
+      auto in_cluster = [&session_state, cluster](size_t idx) { return session_state.GetNodeCluster(idx) == cluster; };
+      auto others = std::stable_partition(ready_nodes.begin(), ready_nodes.end(), in_cluster);
+      cluster_nodes.insert(cluster_nodes.end(), ready_nodes.begin(), others);
+      ready_nodes.erase(ready_nodes.begin(), others);
+    }
 
-        // std::cout << "handle output, current name: " << p_op_kernel->Node().Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
+    if (!cluster_nodes.empty()) {
+      for (auto idx : ready_nodes) {
+        EnqueueNode(idx, session_state, logger);
+      }
+      node_index = cluster_nodes.front();
+      cluster_nodes.pop_front();
+      keep_running = true;
+    } else if (!ready_nodes.empty()) {
+      for (size_t i = 1; i < ready_nodes.size(); ++i) {
+        EnqueueNode(ready_nodes[i], session_state, logger);
       }
+      node_index = ready_nodes.front();
+      keep_running = true;
+      TakeHigherPriorityPendingNode(node_index, session_state);
+    } else if (TakePendingNode(node_index, session_state)) {
+      // at the end of the chain run the deferred node of the highest priority. the deferred node was counted in
+      // out_standings_ when it was enqueued so release the count for the node that just finished.
+      keep_running = true;
+      FinishNodeRun();
     }
   }
 
@@ -250,23 +524,104 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
 }
 
 void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
-  {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    out_standings_++;
+  ++out_standings_;
+
+  if (intra_op_thread_limit_ > 0) {
+    std::lock_guard<OrtMutex> lock(pending_mutex_);
+    if (active_tasks_ >= intra_op_thread_limit_) {
+      pending_nodes_.push_back(p_node_index);
+      std::push_heap(pending_nodes_.begin(), pending_nodes_.end(), LowerPriority{session_state});
+      return;
+    }
+
+    ++active_tasks_;
   }
 
-#ifdef USE_EIGEN_THREADPOOL
+  ScheduleNode(p_node_index, session_state, logger);
+}
+
+void ParallelExecutor::ScheduleNode(size_t p_node_index, const SessionState& session_state,
+                                    const logging::Logger& logger) {
+  // Schedule doesn't allocate a future for the task, and RunNodeAsync records any failure in errors_.
   session_state.GetThreadPool()->Schedule([this, p_node_index, &session_state, &logger]() {
-    try {
-      ParallelExecutor::RunNodeAsync(p_node_index, std::cref(session_state), std::cref(logger));
-    } catch (...) {
-      // catch node processing failure exceptions here to prevent app crash.
-    }
+    ParallelExecutor::RunNodeAsync(p_node_index, session_state, logger);
   });
-#else
-  std::packaged_task<void()> task{std::bind(&ParallelExecutor::RunNodeAsync, this, p_node_index, std::cref(session_state), std::cref(logger))};
-  session_state.GetThreadPool()->RunTask(std::move(task));
-#endif
+}
+
+bool ParallelExecutor::TakePendingNode(size_t& node_index, const SessionState& session_state) {
+  if (intra_op_thread_limit_ <= 0) {
+    return false;
+  }
+
+  std::lock_guard<OrtMutex> lock(pending_mutex_);
+  if (pending_nodes_.empty()) {
+    --active_tasks_;
+    return false;
+  }
+
+  std::pop_heap(pending_nodes_.begin(), pending_nodes_.end(), LowerPriority{session_state});
+  node_index = pending_nodes_.back();
+  pending_nodes_.pop_back();
+  return true;
+}
+
+void ParallelExecutor::TakeHigherPriorityPendingNode(size_t& node_index, const SessionState& session_state) {
+  if (intra_op_thread_limit_ <= 0) {
+    return;
+  }
+
+  // the deferred nodes and the running tasks are counted in out_standings_ alike, so the exchange keeps the count
+  LowerPriority lower_priority{session_state};
+  std::lock_guard<OrtMutex> lock(pending_mutex_);
+  if (pending_nodes_.empty() || !lower_priority(node_index, pending_nodes_.front())) {
+    return;
+  }
+
+  std::pop_heap(pending_nodes_.begin(), pending_nodes_.end(), lower_priority);
+  std::swap(node_index, pending_nodes_.back());
+  std::push_heap(pending_nodes_.begin(), pending_nodes_.end(), lower_priority);
+}
+
+void ParallelExecutor::ReleaseNodeValues(const onnxruntime::Node& node, const SequentialExecutionPlan& plan) {
+  if (buffer_refs_ == nullptr || plan.buffer_use_counts.empty()) {
+    return;
+  }
+
+  // the node's values are inputs, implicit inputs and outputs in that order from the node's first argument
+  const int first_arg = root_frame_->GetFirstArgIndex(node.Index());
+  const int num_args = static_cast<int>(node.InputDefs().size() + node.ImplicitInputDefs().size() +
+                                        node.OutputDefs().size());
+  for (int arg = first_arg; arg < first_arg + num_args; ++arg) {
+    const int mlvalue_idx = root_frame_->GetNodeInputOrOutputMLValueIndex(arg);
+    if (mlvalue_idx < 0) {
+      continue;
+    }
+
+    const auto& value_plan = plan.allocation_plan[mlvalue_idx];
+    if (value_plan.alloc_kind == AllocKind::kReuse) {
+      // the value may have a buffer of its own if it didn't have the size of the one it was planned to reuse
+      if (value_plan.reuse_if_same_size) {
+        ReleaseBufferUse(mlvalue_idx, plan);
+      }
+      ReleaseBufferUse(value_plan.reused_buffer, plan);
+    } else {
+      ReleaseBufferUse(mlvalue_idx, plan);
+    }
+  }
+}
+
+void ParallelExecutor::ReleaseBufferUse(int mlvalue_idx, const SequentialExecutionPlan& plan) {
+  if (plan.buffer_use_counts[mlvalue_idx] == 0) {
+    return;
+  }
+
+  if (buffer_refs_[mlvalue_idx].fetch_sub(1) == 1) {
+    // frees aren't traced as they depend on the order the nodes ran in, which may differ in the next Run
+    auto status = root_frame_->ReleaseMLValue(mlvalue_idx, false);
+    if (!status.IsOK()) {
+      ORT_THROW("Failed to release the value ", mlvalue_idx, ". ", status.ErrorMessage());
+    }
+  }
 }
 
 Status ParallelExecutor::FetchOutput(const MLValueNameIdxMap& name_idx_map,
@@ -3,8 +3,10 @@
 
 #pragma once
 
-#include <vector>
+#include <atomic>
 #include <condition_variable>
+#include <memory>
+#include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
 #include "core/common/logging/logging.h"
@@ -12,17 +14,31 @@
 #include "core/framework/iexecutor.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/ml_value.h"
+#include "core/framework/output_ready_notifier.h"
+#include "core/framework/run_termination.h"
 #include "core/framework/session_state.h"
 #include "core/graph/graph_viewer.h"
 
 namespace onnxruntime {
 
 class ExecutionFrame;
+struct PlacementCostModel;
 
 class ParallelExecutor : public IExecutor {
  public:
-  ParallelExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
-  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false);
+  ParallelExecutor(const RunTermination& termination = RunTermination::Never())
+      : out_standings_(0), termination_{termination} {}
+
+  /**
+    @param intra_op_thread_limit Maximum number of thread pool tasks used to run nodes concurrently, which is
+    also applied to the MLAS operations run by each node. 0 for no limit.
+    @param run_profiler The profiler of a Run that is profiled on its own, which records the events instead of the
+    profiler of the session. nullptr for the latter.
+    @param output_ready The notifier the outputs are reported to as their nodes finish. nullptr for none.
+  */
+  ParallelExecutor(const SessionState& session_state, const RunTermination& termination = RunTermination::Never(),
+                   int intra_op_thread_limit = 0, profiling::Profiler* run_profiler = nullptr,
+                   OutputReadyNotifier* output_ready = nullptr);
 
   common::Status Execute(const SessionState& session_state,
                          const NameMLValMap& feeds,
@@ -31,6 +47,30 @@ class ParallelExecutor : public IExecutor {
                          const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                          const logging::Logger& logger) override;
 
+  /**
+    Computes the priority the nodes of a graph are dispatched by, indexed by node index: the upward rank of the
+    node, i.e. its estimated time plus the largest rank of its successors, which is the time of the longest path
+    from the node to the end of the graph. The times are the kernel times of cost_model, which are measured ones if
+    it was loaded from a profile.
+  */
+  static std::vector<double> ComputeNodePriorities(const GraphViewer& graph_viewer,
+                                                   const PlacementCostModel& cost_model);
+
+  /**
+    Computes the clusters of cheap nodes a thread pool task runs one after the other, indexed by node index, as the
+    index of the first node of the cluster of each node. A node whose time by cost_model is known and small joins the
+    cluster of a producer, as long as the cheap nodes of the cluster take little time in total, so a task that runs
+    a node runs the cheap successors it makes ready itself rather than scheduling a task for each. The other nodes
+    are clusters of their own, so the heavy branches of the graph still run in parallel.
+  */
+  static std::vector<NodeIndex> ComputeNodeClusters(const GraphViewer& graph_viewer,
+                                                    const PlacementCostModel& cost_model);
+
+  // the largest time, in microseconds, of a node that may join the cluster of a producer, about the time of the
+  // round trip through the thread pool it saves, and of the nodes that join a cluster in total
+  static constexpr double kMaxClusteredNodeUs = 5.0;
+  static constexpr double kMaxClusterUs = 25.0;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelExecutor);
 
@@ -39,6 +79,24 @@ class ParallelExecutor : public IExecutor {
 
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  void ScheduleNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
+
+  // called when a chain of nodes run by a thread pool task ends. returns true with the next node to run
+  // if nodes were deferred due to the thread limit, otherwise releases the task's slot.
+  bool TakePendingNode(size_t& node_index, const SessionState& session_state);
+
+  // exchanges the node a task is about to run for the highest priority deferred node if that one has a higher
+  // priority
+  void TakeHigherPriorityPendingNode(size_t& node_index, const SessionState& session_state);
+
+  // orders the ready nodes from the highest priority to the lowest
+  static void SortByPriority(std::vector<size_t>& node_indices, const SessionState& session_state);
+
+  // counts down the uses of the buffers of the values of the node that has run, releasing those that aren't used
+  // by any other node
+  void ReleaseNodeValues(const onnxruntime::Node& node, const SequentialExecutionPlan& plan);
+  void ReleaseBufferUse(int mlvalue_idx, const SequentialExecutionPlan& plan);
+
   Status FetchOutput(const MLValueNameIdxMap& name_idx_map,
                      ExecutionFrame& frame,
                      const std::vector<std::string>& output_names,
@@ -46,25 +104,43 @@ class ParallelExecutor : public IExecutor {
                      const logging::Logger& logger);
 
   void FinishNodeRun() {
-    bool finished = false;
-    {
-      //Because we have a mutex here, it's not possible another thread is doing the test("while (out_standings_ > 0)"
+    if (--out_standings_ == 0) {
+      // take the lock so the notification can't be lost between Execute checking out_standings_ and waiting.
       std::lock_guard<OrtMutex> lock(complete_mutex_);
-      finished = --out_standings_ == 0;
-    }
-    if (finished) {
-      //std::cout << "all out standing nodes are completed." << std::endl;
       complete_cv_.notify_all();
     }
   }
 
-  std::unique_ptr<ExecutionFrame> root_frame_;
-  std::vector<size_t> node_refs_;
-  OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+  SessionState::ExecutionFramePtr root_frame_;
+
+  // number of input edges of each node that are yet to be satisfied. a node is ready when this reaches 0.
+  std::unique_ptr<std::atomic<size_t>[]> node_refs_;
+
+  // number of uses of each buffer by nodes that are yet to run, from the plan's buffer_use_counts. the buffer is
+  // released when this reaches 0.
+  std::unique_ptr<std::atomic<int>[]> buffer_refs_;
+
+  std::atomic<int> out_standings_;
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
 
-  const bool& terminate_flag_;
+  // nodes that became ready while intra_op_thread_limit_ tasks were already active. they are run by the
+  // next task that finishes its chain, highest priority first, so pending_nodes_ is a heap ordered by the
+  // priorities of the session state. active_tasks_ and pending_nodes_ are only used if there is a limit.
+  int intra_op_thread_limit_ = 0;
+  int active_tasks_ = 0;  // protected by pending_mutex_
+  std::vector<size_t> pending_nodes_;
+  OrtMutex pending_mutex_;
+
+  // errors from nodes run on the thread pool. reported by Execute once all outstanding nodes have finished.
+  std::vector<Status> errors_;
+  OrtMutex error_mutex_;
+
+  const RunTermination& termination_;
+  profiling::Profiler* const run_profiler_ = nullptr;
+
+  // the MLValue indices of the fetches, which are only resolved if there is an output_ready_ notifier
+  OutputReadyNotifier* const output_ready_ = nullptr;
+  std::vector<int> fetch_mlvalue_idxs_;
 };
 }  // namespace onnxruntime
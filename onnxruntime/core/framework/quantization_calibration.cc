@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/quantization_calibration.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+bool QuantizationCalibration::IsCalibrated(const std::string& op_type) {
+  return op_type == "Conv" || op_type == "MatMul" || op_type == "Gemm";
+}
+
+void QuantizationCalibration::Record(const std::string& name, const MLValue* value) {
+  if (value == nullptr || !value->IsAllocated() || !value->IsTensor()) {
+    return;
+  }
+  const Tensor& tensor = value->Get<Tensor>();
+  if (tensor.DataType() != DataTypeImpl::GetType<float>() || strcmp(tensor.Location().name, CPU) != 0 ||
+      tensor.Shape().Size() == 0) {
+    return;
+  }
+
+  // the range of the tensor is found before the lock is taken, so that concurrent Runs only wait for the merge
+  const float* data = tensor.Data<float>();
+  const auto range = std::minmax_element(data, data + tensor.Shape().Size());
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto inserted = ranges_.emplace(name, std::make_pair(*range.first, *range.second));
+  if (!inserted.second) {
+    auto& existing = inserted.first->second;
+    existing.first = std::min(existing.first, *range.first);
+    existing.second = std::max(existing.second, *range.second);
+  }
+}
+
+QuantizationRanges QuantizationCalibration::GetRanges() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return ranges_;
+}
+
+}  // namespace onnxruntime
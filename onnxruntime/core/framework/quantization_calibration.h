@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/common/common.h"
+#include "core/framework/ml_value.h"
+#include "core/graph/quantization_transformer.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// The ranges of the float values read and produced by the nodes QuantizationTransformer quantizes, recorded by the
+// executors of a session for every Run. The ranges over a sample dataset are the calibration from which another
+// session, which loads the same model with the same graph optimization level, quantizes the model.
+class QuantizationCalibration {
+ public:
+  QuantizationCalibration() = default;
+
+  // whether the input 0 and the output 0 of a node of op_type are recorded
+  static bool IsCalibrated(const std::string& op_type);
+
+  // extend the range of the value name by the elements of value, which is skipped unless it's a float tensor in CPU
+  // memory
+  void Record(const std::string& name, const MLValue* value);
+
+  // a snapshot of the ranges, which may be taken while values are recorded
+  QuantizationRanges GetRanges() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(QuantizationCalibration);
+
+  mutable OrtMutex mutex_;
+  QuantizationRanges ranges_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/result_cache.h"
+
+#include <cstring>
+#include <iterator>
+#include <memory>
+
+#include "core/framework/data_types.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+// the tensors of a cached Run are copied with memcpy, so must be fixed size types in CPU memory
+static bool IsCacheableTensor(const MLValue& value) {
+  if (!value.IsTensor()) {
+    return false;
+  }
+  const auto& tensor = value.Get<Tensor>();
+  return strcmp(tensor.Location().name, CPU) == 0 && tensor.DataType() != DataTypeImpl::GetType<std::string>();
+}
+
+template <typename T>
+static void AppendValue(const T& value, std::string& key) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// the size of a string before it, so that the strings of a key can't run into each other
+static void AppendString(const std::string& value, std::string& key) {
+  AppendValue(static_cast<uint64_t>(value.size()), key);
+  key.append(value);
+}
+
+ResultCache::ResultCache(const ResultCacheConfig& config)
+    : config_{config}, allocator_{std::make_shared<CPUAllocator>()} {
+}
+
+bool ResultCache::AppendFeed(const std::string& name, const MLValue& feed, std::string& key) const {
+  if (!IsCacheableTensor(feed)) {
+    return false;
+  }
+
+  const auto& tensor = feed.Get<Tensor>();
+  if (key.size() + tensor.Size() > config_.max_bytes) {
+    return false;
+  }
+
+  AppendString(name, key);
+  // the types are singletons
+  AppendValue(tensor.DataType(), key);
+  const auto& dims = tensor.Shape().GetDims();
+  AppendValue(static_cast<uint64_t>(dims.size()), key);
+  for (auto dim : dims) {
+    AppendValue(dim, key);
+  }
+  key.append(static_cast<const char*>(tensor.DataRaw()), tensor.Size());
+  return true;
+}
+
+void ResultCache::AppendOutputNames(const std::vector<std::string>& output_names, std::string& key) {
+  AppendValue(static_cast<uint64_t>(output_names.size()), key);
+  for (const auto& name : output_names) {
+    AppendString(name, key);
+  }
+}
+
+// FNV-1a over 8 bytes at a time like FlatStringMap, which keeps up with the copy of the feeds into the key
+uint64_t ResultCache::Hash(const std::string& key) {
+  const uint64_t kPrime = 0x100000001b3ULL;
+  const char* data = key.data();
+  const size_t size = key.size();
+  uint64_t hash = 0xcbf29ce484222325ULL ^ size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kPrime;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * kPrime;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+MLValue ResultCache::Copy(const MLValue& fetch) const {
+  const auto& tensor = fetch.Get<Tensor>();
+  const size_t size = tensor.Size();
+  void* buffer = size != 0 ? allocator_->Alloc(size) : nullptr;
+  if (size != 0) {
+    std::memcpy(buffer, tensor.DataRaw(), size);
+  }
+  auto copy = std::make_unique<Tensor>(tensor.DataType(), tensor.Shape(), buffer, allocator_->Info(), allocator_);
+  return MLValue{copy.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+bool ResultCache::Find(const std::string& key, std::vector<MLValue>& fetches) {
+  const uint64_t hash = Hash(key);
+  std::vector<MLValue> cached;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto found = entries_by_hash_.find(hash);
+    if (found == entries_by_hash_.end() || found->second->key != key) {
+      ++num_misses_;
+      return false;
+    }
+
+    auto entry = found->second;
+    if (config_.ttl_ms > 0 && std::chrono::steady_clock::now() >= entry->expiry) {
+      Erase(entry);
+      ++num_evictions_;
+      ++num_misses_;
+      return false;
+    }
+
+    entries_.splice(entries_.begin(), entries_, entry);
+    ++num_hits_;
+    // the tensors stay alive while they are copied, even if the entry is evicted meanwhile
+    cached = entry->fetches;
+  }
+
+  if (config_.share_fetches) {
+    fetches = std::move(cached);
+    return true;
+  }
+
+  fetches.clear();
+  fetches.reserve(cached.size());
+  for (const auto& fetch : cached) {
+    fetches.push_back(Copy(fetch));
+  }
+  return true;
+}
+
+void ResultCache::Insert(const std::string& key, const std::vector<MLValue>& fetches) {
+  size_t num_bytes = key.size();
+  for (const auto& fetch : fetches) {
+    if (!IsCacheableTensor(fetch)) {
+      return;
+    }
+    num_bytes += fetch.Get<Tensor>().Size();
+  }
+  if (num_bytes > config_.max_bytes) {
+    return;
+  }
+
+  Entry entry;
+  entry.hash = Hash(key);
+  entry.key = key;
+  entry.num_bytes = num_bytes;
+  entry.expiry = std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.ttl_ms);
+  // the caller keeps its fetches, which it may write to unless they are shared
+  if (config_.share_fetches) {
+    entry.fetches = fetches;
+  } else {
+    entry.fetches.reserve(fetches.size());
+    for (const auto& fetch : fetches) {
+      entry.fetches.push_back(Copy(fetch));
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto found = entries_by_hash_.find(entry.hash);
+  if (found != entries_by_hash_.end()) {
+    Erase(found->second);
+  }
+
+  num_bytes_ += entry.num_bytes;
+  entries_.push_front(std::move(entry));
+  entries_by_hash_[entries_.front().hash] = entries_.begin();
+
+  while ((config_.max_entries != 0 && entries_.size() > config_.max_entries) || num_bytes_ > config_.max_bytes) {
+    Erase(std::prev(entries_.end()));
+    ++num_evictions_;
+  }
+}
+
+void ResultCache::Erase(Entries::iterator entry) {
+  num_bytes_ -= entry->num_bytes;
+  entries_by_hash_.erase(entry->hash);
+  entries_.erase(entry);
+}
+
+ResultCache::Stats ResultCache::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return Stats{num_hits_, num_misses_, num_evictions_, entries_.size(), num_bytes_};
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+struct ResultCacheConfig {
+  // the most Runs kept. 0 for no limit.
+  size_t max_entries = 1024;
+  // the most bytes of feeds and fetches kept. a Run with more is not cached.
+  size_t max_bytes = 64 << 20;
+  // how long the fetches of a Run are returned for after it. 0 for as long as they are kept.
+  int64_t ttl_ms = 60 * 1000;
+  // return the cached tensors themselves rather than copies, which the callers must not write to
+  bool share_fetches = false;
+};
+
+/**
+  * The fetches of the latest Runs of a session, returned to a Run with the same feeds and outputs instead of
+  * running the graph again, for models whose outputs only depend on their inputs and that see duplicate requests.
+  *
+  * A Run is looked up by a hash of the names, types, shapes and data of its feeds and the names of its outputs,
+  * and the whole key is compared on a hit. Only Runs all of whose feeds and fetches are tensors in CPU memory are
+  * cached. The least recently used Runs are evicted once the limits of the config are reached.
+  */
+class ResultCache {
+ public:
+  struct Stats {
+    uint64_t num_hits;
+    uint64_t num_misses;
+    uint64_t num_evictions;  // the Runs evicted for the limits or their ttl
+    size_t num_entries;
+    size_t num_bytes;
+  };
+
+  explicit ResultCache(const ResultCacheConfig& config);
+
+  // Append a feed of a Run to its key, whose feeds must always be appended in the same order.
+  // false if the feed can't be cached, which leaves key partially appended.
+  bool AppendFeed(const std::string& name, const MLValue& feed, std::string& key) const;
+
+  // Append the outputs a Run asks for to its key, once its feeds are appended.
+  static void AppendOutputNames(const std::vector<std::string>& output_names, std::string& key);
+
+  // The fetches of the latest Run with key, if it's cached and its ttl hasn't passed.
+  bool Find(const std::string& key, std::vector<MLValue>& fetches);
+
+  // Keep the fetches of a Run with key, unless they can't be cached or are over the limits.
+  void Insert(const std::string& key, const std::vector<MLValue>& fetches);
+
+  Stats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ResultCache);
+
+  struct Entry {
+    uint64_t hash;
+    std::string key;
+    std::vector<MLValue> fetches;
+    size_t num_bytes;
+    std::chrono::steady_clock::time_point expiry;
+  };
+  using Entries = std::list<Entry>;
+
+  static uint64_t Hash(const std::string& key);
+
+  // a copy of the tensor of fetch in CPU memory of the cache
+  MLValue Copy(const MLValue& fetch) const;
+
+  // requires mutex_ to be held
+  void Erase(Entries::iterator entry);
+
+  const ResultCacheConfig config_;
+  // the copies outlive the Runs and the arenas of the session
+  AllocatorPtr allocator_;
+
+  mutable OrtMutex mutex_;
+  // the most recently used first
+  Entries entries_;
+  // by the hash of their key. a Run with the hash of a cached one replaces it.
+  std::unordered_map<uint64_t, Entries::iterator> entries_by_hash_;
+  size_t num_bytes_ = 0;
+  uint64_t num_hits_ = 0;
+  uint64_t num_misses_ = 0;
+  uint64_t num_evictions_ = 0;
+};
+
+}  // namespace onnxruntime
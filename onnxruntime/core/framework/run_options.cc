@@ -32,3 +32,53 @@ ORT_API(const char*, OrtRunOptionsGetRunTag, _In_ OrtRunOptions* options) {
 ORT_API(void, OrtRunOptionsSetTerminate, _In_ OrtRunOptions* options, bool value) {
   options->terminate = value;
 }
+
+ORT_API_STATUS_IMPL(OrtRunOptionsSetTimeout, _In_ OrtRunOptions* options, int64_t timeout_ms) {
+  if (timeout_ms < 0)
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "timeout_ms must be 0 (no deadline) or positive");
+  options->timeout_ms = timeout_ms;
+  return nullptr;
+}
+
+ORT_API(int64_t, OrtRunOptionsGetTimeout, _In_ OrtRunOptions* options) {
+  return options->timeout_ms;
+}
+
+ORT_API_STATUS_IMPL(OrtRunOptionsSetIntraOpThreadLimit, _In_ OrtRunOptions* options, int thread_limit) {
+  if (thread_limit < 0)
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "thread_limit must be 0 (no limit) or positive");
+  options->intra_op_thread_limit = thread_limit;
+  return nullptr;
+}
+
+ORT_API(int, OrtRunOptionsGetIntraOpThreadLimit, _In_ OrtRunOptions* options) {
+  return options->intra_op_thread_limit;
+}
+
+ORT_API(void, OrtRunOptionsSetPriority, _In_ OrtRunOptions* options, int priority) {
+  options->priority = priority;
+}
+
+ORT_API(int, OrtRunOptionsGetPriority, _In_ OrtRunOptions* options) {
+  return options->priority;
+}
+
+ORT_API(void, OrtRunOptionsSetOutputReadyCallback, _In_ OrtRunOptions* options,
+        _In_opt_ OrtOutputReadyCallbackFn callback, _Inout_opt_ void* user_data) {
+  if (callback == nullptr) {
+    options->output_ready_callback = nullptr;
+    return;
+  }
+  options->output_ready_callback = [callback, user_data](size_t output_index, const onnxruntime::MLValue& value) {
+    callback(user_data, output_index, reinterpret_cast<const OrtValue*>(&value));
+  };
+}
+
+ORT_API_STATUS_IMPL(OrtRunOptionsEnableProfiling, _In_ OrtRunOptions* options, _In_ const char* profile_file_prefix,
+                    unsigned int sampling_interval) {
+  if (profile_file_prefix == nullptr || *profile_file_prefix == '\0')
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "profile_file_prefix must not be empty");
+  options->profile_file_prefix = profile_file_prefix;
+  options->profiling_sampling_interval = sampling_interval;
+  return nullptr;
+}
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/run_termination.h"
+
+namespace onnxruntime {
+
+RunTermination::RunTermination(const bool& terminate_flag, int64_t timeout_ms)
+    : terminate_flag_{&terminate_flag},
+      has_deadline_{timeout_ms > 0},
+      deadline_{std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms)},
+      mlas_cancellation_{&RunTermination::IsTerminatedCallback, this} {
+}
+
+const RunTermination& RunTermination::Never() {
+  static const bool never_terminate = false;
+  static const RunTermination never(never_terminate, 0);
+  return never;
+}
+
+Status RunTermination::Check() const {
+  if (*terminate_flag_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+  }
+  if (has_deadline_ && std::chrono::steady_clock::now() >= deadline_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to the deadline of the Run having passed.");
+  }
+  return Status::OK();
+}
+
+bool MLASCALL RunTermination::IsTerminatedCallback(void* termination) {
+  return static_cast<const RunTermination*>(termination)->IsTerminated();
+}
+
+ScopedRunTermination::ScopedRunTermination(const RunTermination& termination)
+    : previous_cancellation_{MlasGetCancellation()} {
+  MlasSetCancellation(&termination.mlas_cancellation_);
+}
+
+ScopedRunTermination::~ScopedRunTermination() {
+  MlasSetCancellation(previous_cancellation_);
+}
+
+}  // namespace onnxruntime
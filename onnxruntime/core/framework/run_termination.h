@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+/**
+  * Whether a Run has to stop, once the terminate flag of its RunOptions is set or its deadline has passed.
+  * It is checked by the executors between nodes, by Loop and Scan between iterations, and by MLAS operations and
+  * OpKernelContext::ParallelFor between blocks of work on threads with a ScopedRunTermination.
+  */
+class RunTermination {
+ public:
+  /**
+    * @param timeout_ms the deadline in milliseconds from now. 0 for none.
+    */
+  RunTermination(const bool& terminate_flag, int64_t timeout_ms);
+
+  // a Run that never terminates
+  static const RunTermination& Never();
+
+  bool IsTerminated() const {
+    return *terminate_flag_ || (has_deadline_ && std::chrono::steady_clock::now() >= deadline_);
+  }
+
+  // OK, or the FAIL status that says why the Run has to stop
+  common::Status Check() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunTermination);
+
+  static bool MLASCALL IsTerminatedCallback(void* termination);
+
+  friend class ScopedRunTermination;
+
+  const bool* terminate_flag_;
+  bool has_deadline_;
+  std::chrono::steady_clock::time_point deadline_;
+  MLAS_CANCELLATION mlas_cancellation_;
+};
+
+// Makes the MLAS operations started from the current thread stop between blocks of work once the Run terminates,
+// for the lifetime of the object, restoring the previous cancellation on destruction.
+class ScopedRunTermination {
+ public:
+  explicit ScopedRunTermination(const RunTermination& termination);
+  ~ScopedRunTermination();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedRunTermination);
+
+  const MLAS_CANCELLATION* previous_cancellation_;
+};
+
+}  // namespace onnxruntime
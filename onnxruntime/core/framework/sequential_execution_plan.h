@@ -33,7 +33,15 @@ struct SequentialExecutionPlan {
     // reused_buffer is valid only if alloc_kind == kReuse. It indicates
     // which MLValue's buffer must be reused for this MLValue.
     MLValueIndex reused_buffer{0};
-    // if the value is used in async kernel, a fence object would be created
+    // valid only if alloc_kind == kReuse. the reuse was planned without knowing the sizes of the values, for an
+    // in-place update whose input shape isn't known before the graph is run. the buffer is only reused if it has
+    // the size the value needs, and the value gets a buffer of its own otherwise.
+    bool reuse_if_same_size{false};
+    // the graph output the value becomes through an aliasing node such as Reshape, or -1. the value is written to
+    // the buffer the caller of Run provides for that output if there is one, which the aliasing node then leaves as
+    // it is instead of copying the value to it.
+    MLValueIndex aliased_output{-1};
+    // if the value is used in async kernel on a queue and also elsewhere, a fence object would be created
     // note the fence object would be shared between MLValues reusing the same buffer
     bool create_fence_if_async{false};
 
@@ -66,6 +74,16 @@ struct SequentialExecutionPlan {
 
   // to_be_freed: vector elements represent indices of ml-values to be freed (as described above)
   std::vector<MLValueIndex> to_be_freed;
+
+  // used by a parallel execution, which releases a buffer once the nodes that use the values in it have run instead
+  // of freeing it at a step. indexed by MLValueIndex: the number of uses of the buffer of the ml-value, or 0 if the
+  // buffer isn't released.
+  std::vector<int> buffer_use_counts;
+
+  // used by a parallel execution. indexed by NodeIndex: the execution queue the node runs on, which spreads the
+  // independent branches of the graph over the compute queues of the providers that have more than one. empty if
+  // every node runs on the queue of its kernel.
+  std::vector<int> node_exec_queue_ids;
 };
 
 // Output details of an execution plan:
@@ -9,56 +9,116 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
+#include "core/framework/environment.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/utils.h"
+#include "core/platform/hardware_counters.h"
 
 namespace onnxruntime {
 
-static Status FetchOutput(const MLValueNameIdxMap& name_idx_map,
-                          ExecutionFrame& frame,
-                          const std::vector<std::string>& output_names,
+static Status FetchOutput(ExecutionFrame& frame,
+                          const std::vector<int>& fetch_mlvalue_idxs,
                           std::vector<MLValue>& fetches,
                           const logging::Logger& logger);
 
 static Status ReleaseNodeMLValues(ExecutionFrame& frame,
                                   const SequentialExecutionPlan& seq_exec_plan,
-                                  const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
+                                  const SessionState::NodeExecutionStep& step,
                                   const logging::Logger& logger);
 
+// the work a kernel queued on a device when profiling, which is timed once all nodes have been launched
+struct DeviceTiming {
+  const OpKernel* op_kernel;
+  TimePoint launch_time;
+  std::unique_ptr<IDeviceTimer> timer;
+};
+
+static Status RecordDeviceTimings(profiling::Profiler& profiler, std::vector<DeviceTiming>& device_timings);
+
+static Status CheckTermination(const RunTermination& termination, const logging::Logger& logger) {
+  Status status = termination.Check();
+  if (!status.IsOK()) {
+    LOGS(logger, WARNING) << status.ErrorMessage();
+  }
+  return status;
+}
+
 Status SequentialExecutor::Execute(const SessionState& session_state,
                                    const NameMLValMap& feeds,
                                    const std::vector<std::string>& output_names,
                                    std::vector<MLValue>& fetches,
                                    const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                                    const logging::Logger& logger) {
-  bool f_profiler_enabled = session_state.Profiler().FEnabled();
+  const MLValueNameIdxMap& name_idx_map = session_state.GetMLValueNameIdxMap();
+
+  std::vector<int> feed_mlvalue_idxs;
+  std::vector<MLValue> feed_values;
+  feed_mlvalue_idxs.reserve(feeds.size());
+  feed_values.reserve(feeds.size());
+  for (const auto& feed : feeds) {
+    int mlvalue_idx;
+    ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(feed.first, mlvalue_idx));
+    feed_mlvalue_idxs.push_back(mlvalue_idx);
+    feed_values.push_back(feed.second);
+  }
+
+  std::vector<int> fetch_mlvalue_idxs;
+  fetch_mlvalue_idxs.reserve(output_names.size());
+  for (const auto& oname : output_names) {
+    int mlvalue_idx;
+    ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(oname, mlvalue_idx));
+    fetch_mlvalue_idxs.push_back(mlvalue_idx);
+  }
+
+  return Execute(session_state, feed_mlvalue_idxs, feed_values, fetch_mlvalue_idxs, fetches, fetch_allocators,
+                 logger);
+}
+
+Status SequentialExecutor::Execute(const SessionState& session_state,
+                                   const std::vector<int>& feed_mlvalue_idxs,
+                                   const std::vector<MLValue>& feeds,
+                                   const std::vector<int>& fetch_mlvalue_idxs,
+                                   std::vector<MLValue>& fetches,
+                                   const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                                   const logging::Logger& logger) {
+  profiling::Profiler& profiler = run_profiler_ != nullptr ? *run_profiler_ : session_state.Profiler();
+  bool f_profiler_enabled = profiler.FEnabled();
   TimePoint tp;
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
 
   if (f_profiler_enabled) {
-    tp = session_state.Profiler().StartTime();
+    tp = profiler.StartTime();
   }
 
-  ExecutionFrame frame{feeds, output_names, fetches, fetch_allocators, session_state};
+  std::vector<DeviceTiming> device_timings;
+
+  // the MLAS operations of the kernels stop between blocks of work once the Run terminates
+  ScopedRunTermination mlas_termination(termination_);
+
+  auto frame_ptr = session_state.AcquireExecutionFrame(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                                       fetch_allocators);
+  ExecutionFrame& frame = *frame_ptr;
 
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
-  const auto& exec_plan_vec = seq_exec_plan.execution_plan;
-  VLOGS(logger, 1) << "Size of execution plan vector: " << exec_plan_vec.size();
+  // the kernels, providers and fences of the nodes are resolved once per session state rather than once per Run
+  const auto& exec_steps = session_state.GetNodeExecutionSteps();
+  VLOGS(logger, 1) << "Size of execution plan vector: " << exec_steps.size();
 
   // uncomment the line below to dump execution plan
   //std::cout << std::make_pair(p_seq_exec_plan, &session_state) << "\n";
 
-  for (const auto& node_exec_plan : exec_plan_vec) {
-    if (terminate_flag_) {
-      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
-    }
+  for (const auto& step : exec_steps) {
+    ORT_RETURN_IF_ERROR(CheckTermination(termination_, logger));
+
+    // let the more urgent work other Runs queued on the intra-op pool go first
+    utils::RunHigherPriorityTasks(Environment::GetIntraOpThreadPool());
 
-    auto node_index = node_exec_plan.node_index;
-    auto p_op_kernel = session_state.GetKernel(node_index);
+    auto node_index = step.node_index;
+    auto p_op_kernel = step.kernel;
 
     // if a kernel has been added in the session state, it better be NON-null.
     if (p_op_kernel == nullptr)
@@ -68,15 +128,15 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
     // construct OpKernelContext
     // TODO: log kernel inputs?
     OpKernelContextInternal op_kernel_context(frame, *p_op_kernel, logger, p_op_kernel->Node().ImplicitInputDefs(),
-                                              terminate_flag_);
+                                              termination_);
     // TODO: log kernel outputs?
     if (f_profiler_enabled) {
-      sync_time_begin = session_state.Profiler().StartTime();
+      sync_time_begin = profiler.StartTime();
     }
 
     // sync before compute
-    int queue_id = p_op_kernel->KernelDef().ExecQueueId();
-    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+    int queue_id = step.exec_queue_id;
+    for (int input_index = 0; step.may_have_fences && input_index < op_kernel_context.InputCount(); ++input_index) {
       Fence_t fence = op_kernel_context.InputFence(input_index);
       if (fence) {
         auto execution_provider_type = p_op_kernel->Node().GetExecutionProviderType();
@@ -87,7 +147,8 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
       }
     }
 
-    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+    for (int input_index = 0; step.may_have_fences && input_index < op_kernel_context.ImplicitInputCount();
+         ++input_index) {
       Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
       if (fence) {
         auto execution_provider_type = p_op_kernel->Node().GetExecutionProviderType();
@@ -98,7 +159,8 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
       }
     }
 
-    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+    for (int output_index = 0; step.may_have_fences && output_index < op_kernel_context.OutputCount();
+         ++output_index) {
       Fence_t fence = op_kernel_context.OutputFence(output_index);
       if (fence) {
         fence->BeforeUsingAsOutput(p_op_kernel->Node().GetExecutionProviderType(), queue_id);
@@ -106,43 +168,93 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
     }
 
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_fence_before",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                     p_op_kernel->Node().Name() + "_fence_before",
+                                     sync_time_begin,
+                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
 
       // call compute on the kernel
       VLOGS(logger, 1) << "Computing kernel: " << p_op_kernel->Node().Name();
 
-      kernel_begin_time = session_state.Profiler().StartTime();
+      kernel_begin_time = profiler.StartTime();
+
+      // a kernel of a provider such as CUDA returns once it has launched its work, so time the work on the device
+      auto device_timer = step.provider->CreateDeviceTimer(queue_id);
+      if (device_timer != nullptr) {
+        device_timings.push_back(DeviceTiming{p_op_kernel, kernel_begin_time, std::move(device_timer)});
+      }
+    }
+    // the metrics of the session are updated for every Run, unlike the profile
+    auto* op_counters = session_state.GetOpCounters(node_index);
+    TimePoint metrics_begin_time;
+    if (op_counters != nullptr) {
+      metrics_begin_time = std::chrono::high_resolution_clock::now();
+    }
+    // the hardware events of the thread while the kernel computes
+    const bool count_hardware_events =
+        session_state.GetEnableHardwareCounters() && (f_profiler_enabled || op_counters != nullptr);
+    HardwareCounterValues hardware_events;
+    if (count_hardware_events) {
+      hardware_events = HardwareCounters::ForCurrentThread().Read();
     }
     ORT_RETURN_IF_ERROR(p_op_kernel->Compute(&op_kernel_context));
+    op_kernel_context.ReleaseScratchBuffer(true);
+    // a kernel whose MLAS operations stopped once the Run terminated returns OK with outputs it didn't finish
+    ORT_RETURN_IF_ERROR(CheckTermination(termination_, logger));
+    if (count_hardware_events) {
+      hardware_events = HardwareCounters::ForCurrentThread().Read() - hardware_events;
+    }
+    if (op_counters != nullptr) {
+      op_counters->Record(std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::high_resolution_clock::now() - metrics_begin_time)
+                              .count(),
+                          op_kernel_context.OutputTensorBytes(), hardware_events);
+    }
+    auto* calibration = session_state.GetCalibration();
+    if (calibration != nullptr && QuantizationCalibration::IsCalibrated(p_op_kernel->Node().OpType())) {
+      calibration->Record(p_op_kernel->Node().InputDefs()[0]->Name(), op_kernel_context.GetInputMLValue(0));
+      calibration->Record(p_op_kernel->Node().OutputDefs()[0]->Name(), op_kernel_context.GetOutputMLValue(0));
+    }
 
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      if (!device_timings.empty() && device_timings.back().op_kernel == p_op_kernel) {
+        ORT_RETURN_IF_ERROR(device_timings.back().timer->Stop());
+      }
+
+      if (count_hardware_events) {
+        profiler.EndTimeAndRecordCountedEvent(profiling::NODE_EVENT,
+                                              p_op_kernel->Node().Name() + "_kernel_time",
+                                              kernel_begin_time,
+                                              hardware_events,
+                                              {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      } else {
+        profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                       p_op_kernel->Node().Name() + "_kernel_time",
+                                       kernel_begin_time,
+                                       {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      }
 
-      sync_time_begin = session_state.Profiler().StartTime();
+      sync_time_begin = profiler.StartTime();
     }
 
     // sync after compute for outputs
-    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+    for (int input_index = 0; step.may_have_fences && input_index < op_kernel_context.InputCount(); ++input_index) {
       Fence_t fence = op_kernel_context.InputFence(input_index);
       if (fence) {
         fence->AfterUsedAsInput(queue_id);
       }
     }
 
-    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+    for (int input_index = 0; step.may_have_fences && input_index < op_kernel_context.ImplicitInputCount();
+         ++input_index) {
       Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
       if (fence) {
         fence->AfterUsedAsInput(queue_id);
       }
     }
 
-    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+    for (int output_index = 0; step.may_have_fences && output_index < op_kernel_context.OutputCount();
+         ++output_index) {
       Fence_t fence = op_kernel_context.OutputFence(output_index);
       if (fence) {
         fence->AfterUsedAsOutput(queue_id);
@@ -150,33 +262,47 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
     }
 
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_fence_after",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+      profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                     p_op_kernel->Node().Name() + "_fence_after",
+                                     sync_time_begin,
+                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+    }
+
+    if (output_ready_ != nullptr) {
+      output_ready_->NotifyNodeOutputs(p_op_kernel->Node(), session_state.GetMLValueNameIdxMap(), frame,
+                                       fetch_mlvalue_idxs);
     }
 
     // free ml-values corresponding to this node
     VLOGS(logger, 1) << "Releasing node ML values after computing kernel: " << p_op_kernel->Node().Name();
-    ORT_RETURN_IF_ERROR(ReleaseNodeMLValues(frame, seq_exec_plan, node_exec_plan, logger));
+    ORT_RETURN_IF_ERROR(ReleaseNodeMLValues(frame, seq_exec_plan, step, logger));
   }
 
+  // the fetches of a Run, or of the subgraph of a Loop, Scan or If node, are not returned once the Run terminated
+  ORT_RETURN_IF_ERROR(CheckTermination(termination_, logger));
   VLOGS(logger, 1) << "Fetching output.";
-  ORT_RETURN_IF_ERROR(FetchOutput(session_state.GetMLValueNameIdxMap(), frame, output_names, fetches, logger));
+  ORT_RETURN_IF_ERROR(FetchOutput(frame, fetch_mlvalue_idxs, fetches, logger));
 
-  if (frame.HasPlan()) {
+  if (!device_timings.empty()) {
+    ORT_RETURN_IF_ERROR(RecordDeviceTimings(profiler, device_timings));
+  }
+
+  if (frame.HasPlan() || frame.MemoryPatternOverflowed()) {
     std::vector<TensorShape> input_shapes;
     bool all_tensors = true;
     for (const auto& feed : feeds) {
-      if (!(feed.second.IsTensor())) {
+      if (!(feed.IsTensor())) {
         all_tensors = false;
         break;
       }
-      auto& tensor = feed.second.Get<Tensor>();
+      auto& tensor = feed.Get<Tensor>();
       input_shapes.push_back(tensor.Shape());
     }
 
-    if (all_tensors) {
+    if (all_tensors && frame.MemoryPatternOverflowed()) {
+      // the cached pattern is too small for some input shapes in its bucket, so have the next Run re-plan it.
+      session_state.InvalidateMemoryPatternGroup(input_shapes);
+    } else if (all_tensors) {
       auto mem_patterns = std::make_unique<MemoryPatternGroup>();
       ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
@@ -184,32 +310,43 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
   }
 
   if (f_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
+    profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
   }
 
   return Status::OK();
 }
 
-static Status FetchOutput(const MLValueNameIdxMap& name_idx_map,
-                          ExecutionFrame& frame,
-                          const std::vector<std::string>& output_names,
+static Status RecordDeviceTimings(profiling::Profiler& profiler, std::vector<DeviceTiming>& device_timings) {
+  // the copies inserted between providers by transformer_memcpy are nodes of the Memcpy ops, which are recorded
+  // with their op_name like the other nodes
+  for (auto& device_timing : device_timings) {
+    long long elapsed = 0;
+    ORT_RETURN_IF_ERROR(device_timing.timer->GetElapsedMicroSeconds(elapsed));
+    const auto& node = device_timing.op_kernel->Node();
+    profiler.RecordEvent(profiling::NODE_EVENT, node.Name() + "_device_time", device_timing.launch_time, elapsed,
+                         {{"op_name", device_timing.op_kernel->KernelDef().OpName()},
+                          {"provider", node.GetExecutionProviderType()}});
+  }
+  return Status::OK();
+}
+
+static Status FetchOutput(ExecutionFrame& frame,
+                          const std::vector<int>& fetch_mlvalue_idxs,
                           std::vector<MLValue>& fetches,
                           const logging::Logger& logger) {
   if (fetches.empty()) {
-    fetches.resize(output_names.size());
+    fetches.resize(fetch_mlvalue_idxs.size());
   } else {
     // this should've been checked before already
-    ORT_ENFORCE(output_names.size() == fetches.size(),
-                "output_names vector size: " + std::to_string(output_names.size()) +
+    ORT_ENFORCE(fetch_mlvalue_idxs.size() == fetches.size(),
+                "fetch_mlvalue_idxs vector size: " + std::to_string(fetch_mlvalue_idxs.size()) +
                     " does not match that of fetches vector: " + std::to_string(fetches.size()));
   }
 
   auto idx = 0;
 
-  for (const auto& oname : output_names) {
-    VLOGS(logger, 1) << "Attempting to fetch output with name: " << oname;
-    int mlvalue_index;
-    ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(oname, mlvalue_index));
+  for (int mlvalue_index : fetch_mlvalue_idxs) {
+    VLOGS(logger, 1) << "Attempting to fetch output with MLValue index: " << mlvalue_index;
     const MLValue& output_mlvalue = frame.GetMLValue(mlvalue_index);
     VLOGS(logger, 1) << "Copying fetched MLValue to output vector";
     fetches[idx++] = output_mlvalue;
@@ -221,9 +358,9 @@ static Status FetchOutput(const MLValueNameIdxMap& name_idx_map,
 
 static Status ReleaseNodeMLValues(ExecutionFrame& frame,
                                   const SequentialExecutionPlan& seq_exec_plan,
-                                  const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
+                                  const SessionState::NodeExecutionStep& step,
                                   const logging::Logger& logger) {
-  for (auto i = node_exec_plan.free_from_index; i <= node_exec_plan.free_to_index; ++i) {
+  for (auto i = step.free_from_index; i <= step.free_to_index; ++i) {
     auto mlvalue_idx = seq_exec_plan.to_be_freed[i];
     VLOGS(logger, 1) << "Releasing mlvalue with index: " << mlvalue_idx;
     ORT_RETURN_IF_ERROR(frame.ReleaseMLValue(mlvalue_idx));
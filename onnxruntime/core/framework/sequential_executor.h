@@ -10,13 +10,22 @@
 #include "core/framework/iexecutor.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/ml_value.h"
+#include "core/framework/output_ready_notifier.h"
+#include "core/framework/run_termination.h"
 #include "core/framework/session_state.h"
 #include "core/graph/graph_viewer.h"
 
 namespace onnxruntime {
 class SequentialExecutor : public IExecutor {
  public:
-  SequentialExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
+  /**
+    @param run_profiler The profiler of a Run that is profiled on its own, which records the events instead of the
+    profiler of the session. nullptr for the latter.
+    @param output_ready The notifier the outputs are reported to as their nodes finish. nullptr for none.
+  */
+  SequentialExecutor(const RunTermination& termination = RunTermination::Never(),
+                     profiling::Profiler* run_profiler = nullptr, OutputReadyNotifier* output_ready = nullptr)
+      : termination_{termination}, run_profiler_{run_profiler}, output_ready_{output_ready} {}
 
   common::Status Execute(const SessionState& session_state,
                          const NameMLValMap& feeds,
@@ -25,8 +34,20 @@ class SequentialExecutor : public IExecutor {
                          const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                          const logging::Logger& logger) override;
 
+  // Execute with the feeds and fetches given by their MLValue indices, as resolved once by a FeedsFetchesManager
+  // for a graph that is executed repeatedly.
+  common::Status Execute(const SessionState& session_state,
+                         const std::vector<int>& feed_mlvalue_idxs,
+                         const std::vector<MLValue>& feeds,
+                         const std::vector<int>& fetch_mlvalue_idxs,
+                         std::vector<MLValue>& fetches,
+                         const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                         const logging::Logger& logger);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
-  const bool& terminate_flag_;
+  const RunTermination& termination_;
+  profiling::Profiler* const run_profiler_;
+  OutputReadyNotifier* const output_ready_;
 };
 }  // namespace onnxruntime
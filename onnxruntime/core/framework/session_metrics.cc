@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/session_metrics.h"
+
+#include <cmath>
+#include <limits>
+
+namespace onnxruntime {
+
+constexpr int SessionMetrics::OpCounters::kNumBuckets;
+
+SessionMetrics::OpCounters::OpCounters(const std::string& op_type) : op_type_(op_type) {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+int SessionMetrics::OpCounters::BucketOf(uint64_t duration_us) {
+  if (duration_us < 4) {
+    return static_cast<int>(duration_us);
+  }
+
+  // the highest bit set, and the 2 bits below it
+  int exponent = 2;
+  while ((duration_us >> (exponent + 1)) != 0) {
+    ++exponent;
+  }
+
+  return 4 * (exponent - 1) + static_cast<int>((duration_us >> (exponent - 2)) & 3);
+}
+
+uint64_t SessionMetrics::OpCounters::BucketUpperBound(int bucket) {
+  if (bucket < 4) {
+    return static_cast<uint64_t>(bucket);
+  }
+
+  const int exponent = bucket / 4 + 1;
+  const uint64_t mantissa = 4 + bucket % 4;
+  if (exponent == 63 && mantissa == 7) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  return ((mantissa + 1) << (exponent - 2)) - 1;
+}
+
+void SessionMetrics::OpCounters::Record(long long duration_us, size_t output_bytes,
+                                        const HardwareCounterValues& hardware_events) {
+  const uint64_t duration = duration_us > 0 ? static_cast<uint64_t>(duration_us) : 0;
+  num_calls_.fetch_add(1, std::memory_order_relaxed);
+  total_time_us_.fetch_add(duration, std::memory_order_relaxed);
+  output_bytes_.fetch_add(output_bytes, std::memory_order_relaxed);
+  cycles_.fetch_add(hardware_events.cycles, std::memory_order_relaxed);
+  instructions_.fetch_add(hardware_events.instructions, std::memory_order_relaxed);
+  llc_misses_.fetch_add(hardware_events.llc_misses, std::memory_order_relaxed);
+  dtlb_misses_.fetch_add(hardware_events.dtlb_misses, std::memory_order_relaxed);
+  buckets_[BucketOf(duration)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t SessionMetrics::OpCounters::Percentile(const std::array<uint64_t, kNumBuckets>& buckets, double fraction) {
+  uint64_t num_calls = 0;
+  for (auto count : buckets) {
+    num_calls += count;
+  }
+
+  if (num_calls == 0) {
+    return 0;
+  }
+
+  const auto rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(num_calls)));
+  uint64_t num_counted = 0;
+  for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+    num_counted += buckets[bucket];
+    if (num_counted >= rank && num_counted > 0) {
+      return BucketUpperBound(bucket);
+    }
+  }
+
+  return BucketUpperBound(kNumBuckets - 1);
+}
+
+SessionMetrics::OpCounters& SessionMetrics::RegisterOpType(const std::string& op_type) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto entry = op_counters_by_type_.find(op_type);
+  if (entry != op_counters_by_type_.end()) {
+    return *entry->second;
+  }
+
+  op_counters_.emplace_back(op_type);
+  op_counters_by_type_[op_type] = &op_counters_.back();
+  return op_counters_.back();
+}
+
+std::vector<SessionMetrics::OpMetrics> SessionMetrics::GetOpMetrics() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  std::vector<OpMetrics> op_metrics;
+  op_metrics.reserve(op_counters_.size());
+
+  for (const auto& counters : op_counters_) {
+    std::array<uint64_t, OpCounters::kNumBuckets> buckets;
+    for (int bucket = 0; bucket < OpCounters::kNumBuckets; ++bucket) {
+      buckets[bucket] = counters.buckets_[bucket].load(std::memory_order_relaxed);
+    }
+
+    op_metrics.push_back(OpMetrics{counters.op_type_,
+                                   counters.num_calls_.load(std::memory_order_relaxed),
+                                   counters.total_time_us_.load(std::memory_order_relaxed),
+                                   OpCounters::Percentile(buckets, 0.5),
+                                   OpCounters::Percentile(buckets, 0.99),
+                                   counters.output_bytes_.load(std::memory_order_relaxed),
+                                   counters.cycles_.load(std::memory_order_relaxed),
+                                   counters.instructions_.load(std::memory_order_relaxed),
+                                   counters.llc_misses_.load(std::memory_order_relaxed),
+                                   counters.dtlb_misses_.load(std::memory_order_relaxed)});
+  }
+
+  return op_metrics;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/hardware_counters.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Counters of the nodes the executors of a session run, aggregated by op type. Unlike profiling they are kept for
+// every Run and are cheap to update: the op types are registered when the session is initialized, after which a
+// node is recorded with a few relaxed atomic additions and no lock.
+class SessionMetrics {
+ public:
+  // the counters of one op type
+  class OpCounters {
+   public:
+    explicit OpCounters(const std::string& op_type);
+
+    // record a call of a node that took duration_us and produced outputs of output_bytes, with the hardware events
+    // counted while it ran if the session counts them
+    void Record(long long duration_us, size_t output_bytes,
+                const HardwareCounterValues& hardware_events = HardwareCounterValues{});
+
+    const std::string& OpType() const { return op_type_; }
+
+   private:
+    friend class SessionMetrics;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OpCounters);
+
+    // the durations are counted in buckets of 4 per power of 2, which bounds the error of a percentile to 25%
+    static constexpr int kNumBuckets = 256;
+    static int BucketOf(uint64_t duration_us);
+    static uint64_t BucketUpperBound(int bucket);
+
+    // the duration that fraction of the calls counted in buckets took at most
+    static uint64_t Percentile(const std::array<uint64_t, kNumBuckets>& buckets, double fraction);
+
+    const std::string op_type_;
+    std::atomic<uint64_t> num_calls_{0};
+    std::atomic<uint64_t> total_time_us_{0};
+    std::atomic<uint64_t> output_bytes_{0};
+    std::atomic<uint64_t> cycles_{0};
+    std::atomic<uint64_t> instructions_{0};
+    std::atomic<uint64_t> llc_misses_{0};
+    std::atomic<uint64_t> dtlb_misses_{0};
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets_;
+  };
+
+  // a snapshot of the counters of an op type
+  struct OpMetrics {
+    std::string op_type;
+    uint64_t num_calls;
+    uint64_t total_time_us;
+    uint64_t p50_time_us;
+    uint64_t p99_time_us;
+    uint64_t output_bytes;
+    // the totals of the hardware events, which are 0 unless the session counts them
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t llc_misses;
+    uint64_t dtlb_misses;
+  };
+
+  SessionMetrics() = default;
+
+  // get the counters of op_type, adding them if they don't exist. called while the session is initialized.
+  OpCounters& RegisterOpType(const std::string& op_type);
+
+  // a snapshot of the counters of the op types, which may be taken while nodes are recorded
+  std::vector<OpMetrics> GetOpMetrics() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionMetrics);
+
+  mutable OrtMutex mutex_;
+  // a deque so that the counters handed out stay where they are
+  std::deque<OpCounters> op_counters_;
+  std::unordered_map<std::string, OpCounters*> op_counters_by_type_;
+};
+
+}  // namespace onnxruntime
@@ -3,15 +3,20 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
 #include <sstream>
+#include <thread>
 
 #include "core/common/logging/logging.h"
+#include "core/framework/execution_frame.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/utils.h"
 
 using namespace ::onnxruntime::common;
 namespace onnxruntime {
 
+SessionState::~SessionState() = default;
+
 void SessionState::SetGraphViewer(std::unique_ptr<onnxruntime::GraphViewer> graph_viewer) {
   ORT_ENFORCE(nullptr != graph_viewer);
   graph_viewer_ = std::move(graph_viewer);
@@ -34,6 +39,54 @@ void SessionState::AddKernel(onnxruntime::NodeIndex node_id, std::unique_ptr<OpK
   session_kernels_[node_id] = std::move(p_kernel);
 }
 
+// true if the value a node reads or writes can have a fence: one the plan creates a fence for because it's used
+// across queues, one sharing the buffer and the fence of such a value, or one the caller provides
+static bool MayHaveFence(const SequentialExecutionPlan& plan, int mlvalue_idx) {
+  if (mlvalue_idx < 0 || static_cast<size_t>(mlvalue_idx) >= plan.allocation_plan.size()) {
+    return true;
+  }
+  const auto& value_plan = plan.allocation_plan[mlvalue_idx];
+  // the feeds, outer scope values and fetches come with the fences of the caller
+  if (value_plan.create_fence_if_async || value_plan.alloc_kind == AllocKind::kPreExisting ||
+      value_plan.alloc_kind == AllocKind::kAllocateOutput) {
+    return true;
+  }
+  return value_plan.alloc_kind == AllocKind::kReuse &&
+         plan.allocation_plan[value_plan.reused_buffer].create_fence_if_async;
+}
+
+const std::vector<SessionState::NodeExecutionStep>& SessionState::GetNodeExecutionSteps() const {
+  std::call_once(node_execution_steps_flag_, [this]() {
+    ORT_ENFORCE(p_seq_exec_plan_ != nullptr, "The execution plan has not been created.");
+    const auto& plan = *p_seq_exec_plan_;
+    node_execution_steps_.reserve(plan.execution_plan.size());
+    for (const auto& node_exec_plan : plan.execution_plan) {
+      NodeExecutionStep step;
+      step.node_index = node_exec_plan.node_index;
+      step.kernel = GetKernel(node_exec_plan.node_index);
+      step.provider = nullptr;
+      step.exec_queue_id = 0;
+      step.may_have_fences = true;
+      step.free_from_index = node_exec_plan.free_from_index;
+      step.free_to_index = node_exec_plan.free_to_index;
+      if (step.kernel != nullptr) {
+        const auto& node = step.kernel->Node();
+        step.provider = execution_providers_.Get(node);
+        step.exec_queue_id = step.kernel->KernelDef().ExecQueueId();
+        step.may_have_fences = false;
+        node.ForEachDef([this, &plan, &step](const NodeArg& def, bool /*is_input*/) {
+          int mlvalue_idx;
+          if (!mlvalue_name_idx_map_.GetIdx(def.Name(), mlvalue_idx).IsOK() || MayHaveFence(plan, mlvalue_idx)) {
+            step.may_have_fences = true;
+          }
+        });
+      }
+      node_execution_steps_.push_back(step);
+    }
+  });
+  return node_execution_steps_;
+}
+
 void SessionState::SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan) {
   p_seq_exec_plan_ = std::move(p_seq_exec_plan);
 }
@@ -51,6 +104,14 @@ const std::unordered_map<int, MLValue>& SessionState::GetInitializedTensors() co
   return initialized_tensors_;
 }
 
+void SessionState::AddMappedMemory(Env::MappedMemoryPtr mapped_memory) {
+  mapped_memories_.push_back(std::move(mapped_memory));
+}
+
+void SessionState::AddSharedInitializer(std::shared_ptr<const Tensor> tensor) {
+  shared_initializers_.push_back(std::move(tensor));
+}
+
 SessionState& SessionState::SetLogger(const logging::Logger& logger) {
   logger_ = &logger;
   return *this;
@@ -70,38 +131,190 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) {
   return *profiler_;
 }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<TensorShape>& shapes) {
-  int64_t key = 0;
+void SessionState::SetMetrics(SessionMetrics& metrics) {
+  node_op_counters_.clear();
+  for (const auto& kernel : session_kernels_) {
+    if (kernel.first >= node_op_counters_.size()) {
+      node_op_counters_.resize(kernel.first + 1, nullptr);
+    }
+
+    node_op_counters_[kernel.first] = &metrics.RegisterOpType(kernel.second->Node().OpType());
+  }
+}
+
+SessionState::MemoryPatternsKey SessionState::CalculateMemoryPatternsKey(
+    const std::vector<TensorShape>& shapes) const {
+  MemoryPatternsKey key;
   for (auto& shape : shapes) {
-    for (auto dim : shape.GetDims())
-      key ^= dim;
+    key.push_back(static_cast<int64_t>(shape.NumDimensions()));
+    for (auto dim : shape.GetDims()) {
+      auto bucket = std::lower_bound(mem_patterns_dim_buckets_.cbegin(), mem_patterns_dim_buckets_.cend(), dim);
+      key.push_back(bucket != mem_patterns_dim_buckets_.cend() ? *bucket : dim);
+    }
   }
   return key;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const {
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
+    const std::vector<TensorShape>& input_shapes) const {
+  MemoryPatternsKey key = CalculateMemoryPatternsKey(input_shapes);
+
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
   auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end())
+  if (it == mem_patterns_.end()) {
+    ++mem_patterns_stats_.misses;
     return nullptr;
+  }
 
-  return it->second.get();
+  mem_patterns_lru_.splice(mem_patterns_lru_.begin(), mem_patterns_lru_, it->second.lru_entry);
+  if (it->second.replan) {
+    ++mem_patterns_stats_.misses;
+    return nullptr;
+  }
+
+  ++mem_patterns_stats_.hits;
+  return it->second.patterns;
+}
+
+// true if every location in current has a pattern at least as large in candidate
+static bool IsAtLeastAsLarge(const MemoryPatternGroup& candidate, const MemoryPatternGroup& current) {
+  for (size_t i = 0; i < current.locations.size(); i++) {
+    const auto* pattern = candidate.GetPatterns(current.locations[i]);
+    if (pattern == nullptr || pattern->PeakSize() < current.patterns[i].PeakSize()) {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
                                                    std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shape);
+  MemoryPatternsKey key = CalculateMemoryPatternsKey(input_shape);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   auto it = mem_patterns_.find(key);
   if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+    if (mem_patterns_capacity_ > 0 && mem_patterns_.size() >= mem_patterns_capacity_) {
+      mem_patterns_.erase(mem_patterns_lru_.back());
+      mem_patterns_lru_.pop_back();
+      ++mem_patterns_stats_.evictions;
+    }
+
+    mem_patterns_lru_.push_front(key);
+    mem_patterns_[key] = MemoryPatternCacheEntry{std::move(mem_patterns), mem_patterns_lru_.begin()};
+  } else if (it->second.replan && IsAtLeastAsLarge(*mem_patterns, *it->second.patterns)) {
+    it->second.patterns = std::move(mem_patterns);
+    it->second.replan = false;
   }
 
   return Status::OK();
 }
 
+void SessionState::InvalidateMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const {
+  MemoryPatternsKey key = CalculateMemoryPatternsKey(input_shapes);
+
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  auto it = mem_patterns_.find(key);
+  if (it != mem_patterns_.end()) {
+    it->second.replan = true;
+  }
+}
+
+void SessionState::SetMemoryPatternCacheOptions(size_t capacity, const std::vector<int64_t>& dim_buckets) {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  mem_patterns_capacity_ = capacity;
+  mem_patterns_dim_buckets_ = dim_buckets;
+  std::sort(mem_patterns_dim_buckets_.begin(), mem_patterns_dim_buckets_.end());
+
+  // existing keys were calculated with the old buckets
+  mem_patterns_.clear();
+  mem_patterns_lru_.clear();
+}
+
+MemoryPatternCacheStats SessionState::GetMemoryPatternCacheStats() const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  MemoryPatternCacheStats stats = mem_patterns_stats_;
+  stats.entries = mem_patterns_.size();
+  return stats;
+}
+
+std::unique_ptr<ExecutionFrame> SessionState::TakeCachedExecutionFrame() const {
+  std::unique_ptr<ExecutionFrame> frame;
+  std::lock_guard<OrtMutex> lock(cached_frames_lock_);
+  if (!cached_frames_.empty()) {
+    frame = std::move(cached_frames_.back());
+    cached_frames_.pop_back();
+  }
+
+  return frame;
+}
+
+void SessionState::ReleaseCachedExecutionFrames() const {
+  // the frames are destroyed outside the lock
+  std::vector<std::unique_ptr<ExecutionFrame>> frames;
+  {
+    std::lock_guard<OrtMutex> lock(cached_frames_lock_);
+    frames.swap(cached_frames_);
+  }
+  frames.clear();
+
+  for (const auto& node_subgraphs : subgraph_session_states_) {
+    for (const auto& subgraph : node_subgraphs.second) {
+      subgraph.second->ReleaseCachedExecutionFrames();
+    }
+  }
+}
+
+SessionState::ExecutionFramePtr SessionState::MakeExecutionFramePtr(std::unique_ptr<ExecutionFrame> frame) const {
+  // returns the frame to the cache, dropping any references it holds so feeds, fetches and intermediate values
+  // are not kept alive. enough frames are kept for each hardware thread to be running a Run.
+  auto release_frame = [this](ExecutionFrame* frame) {
+    std::unique_ptr<ExecutionFrame> owned_frame{frame};
+    owned_frame->ClearValues();
+
+    static const size_t max_cached_frames = std::max(std::thread::hardware_concurrency(), 1u);
+    std::lock_guard<OrtMutex> lock(cached_frames_lock_);
+    if (cached_frames_.size() < max_cached_frames) {
+      cached_frames_.push_back(std::move(owned_frame));
+    }
+  };
+
+  return ExecutionFramePtr{frame.release(), release_frame};
+}
+
+SessionState::ExecutionFramePtr SessionState::AcquireExecutionFrame(
+    const NameMLValMap& feeds,
+    const std::vector<std::string>& output_names,
+    const std::vector<MLValue>& fetches,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const {
+  std::unique_ptr<ExecutionFrame> frame = TakeCachedExecutionFrame();
+  if (frame) {
+    frame->Reset(feeds, output_names, fetches, fetch_allocators);
+  } else {
+    frame = std::make_unique<ExecutionFrame>(feeds, output_names, fetches, fetch_allocators, *this);
+  }
+
+  return MakeExecutionFramePtr(std::move(frame));
+}
+
+SessionState::ExecutionFramePtr SessionState::AcquireExecutionFrame(
+    const std::vector<int>& feed_mlvalue_idxs,
+    const std::vector<MLValue>& feeds,
+    const std::vector<int>& fetch_mlvalue_idxs,
+    const std::vector<MLValue>& fetches,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const {
+  std::unique_ptr<ExecutionFrame> frame = TakeCachedExecutionFrame();
+  if (frame) {
+    frame->Reset(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators);
+  } else {
+    frame = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                             fetch_allocators, *this);
+  }
+
+  return MakeExecutionFramePtr(std::move(frame));
+}
+
 void SessionState::SetEnableMemoryPattern(bool flag) {
   enable_mem_pattern_ = flag;
 }
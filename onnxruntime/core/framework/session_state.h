@@ -3,7 +3,11 @@
 
 #pragma once
 
+#include <functional>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include "gsl/gsl_util"
@@ -14,12 +18,17 @@
 #include "core/common/profiler.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_providers.h"
+#include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/mlvalue_name_idx_map.h"
+#include "core/framework/quantization_calibration.h"
+#include "core/framework/session_metrics.h"
+#include "core/framework/weight_compression.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/fuse_nodes_funcs.h"
+#include "core/platform/env.h"
 
 #ifdef USE_EIGEN_THREADPOOL
 #include <unsupported/Eigen/CXX11/ThreadPool>
@@ -27,6 +36,7 @@
 
 namespace onnxruntime {
 
+class ExecutionFrame;
 class ExecutionProviders;
 class KernelDef;
 class OpKernel;
@@ -45,6 +55,8 @@ class SessionState {
       : execution_providers_{execution_providers} {
   }
 
+  ~SessionState();
+
   // Graph viewer.
   void SetGraphViewer(std::unique_ptr<onnxruntime::GraphViewer> graph_viewer);
   const onnxruntime::GraphViewer* GetGraphViewer() const;
@@ -56,6 +68,24 @@ class SessionState {
 
   void AddKernel(onnxruntime::NodeIndex node_id, std::unique_ptr<OpKernel> p_kernel);
 
+  // what the SequentialExecutor needs to run a node of the execution plan, resolved once for the session
+  struct NodeExecutionStep {
+    onnxruntime::NodeIndex node_index;
+    const OpKernel* kernel;
+    // the provider of the node, which times the work the node queues on its device when profiling
+    const IExecutionProvider* provider;
+    int exec_queue_id;
+    // false if none of the values the node reads or writes can have a fence, so they aren't looked up
+    bool may_have_fences;
+    // the range of SequentialExecutionPlan::to_be_freed to release after the node has run
+    int free_from_index;
+    int free_to_index;
+  };
+
+  // the steps of the nodes of the execution plan, in its order. created on the first call, which
+  // SessionStateInitializer makes once the kernels have been created.
+  const std::vector<NodeExecutionStep>& GetNodeExecutionSteps() const;
+
   const ExecutionProviders& GetExecutionProviders() const noexcept { return execution_providers_; }
 
   const MLValueNameIdxMap& GetMLValueNameIdxMap() const noexcept { return mlvalue_name_idx_map_; }
@@ -74,6 +104,16 @@ class SessionState {
   */
   const std::unordered_map<int, MLValue>& GetInitializedTensors() const;
 
+  /**
+  * Keeps the file data mapped for the initialized tensors that read it in place.
+  */
+  void AddMappedMemory(Env::MappedMemoryPtr mapped_memory);
+
+  /**
+  * Keeps the tensor shared with other sessions alive for the initialized tensor that reads its data.
+  */
+  void AddSharedInitializer(std::shared_ptr<const Tensor> tensor);
+
   // execution plan
   void SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan);
   const SequentialExecutionPlan* GetExecutionPlan() const;
@@ -100,10 +140,59 @@ class SessionState {
   */
   profiling::Profiler& Profiler() const;
 
+  /**
+  Set the metrics the executors update for the nodes of this session state. The op types of the kernels
+  are registered with them, so it's called once the kernels have been added.
+  */
+  void SetMetrics(SessionMetrics& metrics);
+
+  /**
+  Get the counters of the op type of a node, or nullptr if the session doesn't collect metrics.
+  */
+  SessionMetrics::OpCounters* GetOpCounters(onnxruntime::NodeIndex node_index) const {
+    return node_index < node_op_counters_.size() ? node_op_counters_[node_index] : nullptr;
+  }
+
+  /**
+  Set the priorities the parallel executor dispatches the ready nodes of this session state by, indexed by node
+  index. See ParallelExecutor::ComputeNodePriorities.
+  */
+  void SetNodePriorities(std::vector<double> priorities) { node_priorities_ = std::move(priorities); }
+
+  /**
+  Get the priority of a node, which is 0 for all nodes if no priorities were set.
+  */
+  double GetNodePriority(onnxruntime::NodeIndex node_index) const {
+    return node_index < node_priorities_.size() ? node_priorities_[node_index] : 0.0;
+  }
+
+  /**
+  Set the clusters of cheap nodes the parallel executor runs in one thread pool task, as the index of the node the
+  cluster of each node is named after, indexed by node index. See ParallelExecutor::ComputeNodeClusters.
+  */
+  void SetNodeClusters(std::vector<onnxruntime::NodeIndex> clusters) { node_clusters_ = std::move(clusters); }
+
+  /**
+  Get the cluster of a node, which is the node itself if no clusters were set.
+  */
+  onnxruntime::NodeIndex GetNodeCluster(onnxruntime::NodeIndex node_index) const {
+    return node_index < node_clusters_.size() ? node_clusters_[node_index] : node_index;
+  }
+
+  /**
+  Set the calibration the executors record the ranges of the values of the nodes of this session state in.
+  */
+  void SetCalibration(QuantizationCalibration& calibration) { calibration_ = &calibration; }
+
+  /**
+  Get the calibration, or nullptr if the session doesn't calibrate.
+  */
+  QuantizationCalibration* GetCalibration() const { return calibration_; }
+
   /**
   Get cached memory pattern based on input shapes
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes. 
@@ -112,6 +201,26 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Mark the cached memory pattern for the given input shapes as too small, because a Run with input shapes in the
+  same bucket needed larger blocks than it provides. Runs in the bucket generate new patterns until one that is
+  at least as large as the current one replaces it.
+  Const as it's an internal cache update only.
+  */
+  void InvalidateMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
+
+  /**
+  Configure the memory pattern cache.
+  @param capacity Maximum number of cached patterns. The least recently used pattern is evicted when full.
+                  0 for no limit.
+  @param dim_buckets Ascending boundaries that each input dimension is rounded up to when looking up a pattern,
+                     so that inputs with similar shapes share a pattern. A dimension larger than the last
+                     boundary is used as is. Empty to key patterns on the exact input shapes.
+  */
+  void SetMemoryPatternCacheOptions(size_t capacity, const std::vector<int64_t>& dim_buckets);
+
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
   /**
   Set enable memory pattern flag
   */
@@ -122,6 +231,54 @@ class SessionState {
   */
   bool GetEnableMemoryPattern() const;
 
+  /**
+  Set if every Run feeds the graph inputs with the shapes the graph declares, which are all fixed, so that the
+  kernels can prepare for the shapes their inputs are inferred to have when they are created.
+  */
+  void SetInputShapesFrozen(bool flag) { input_shapes_frozen_ = flag; }
+  bool GetInputShapesFrozen() const { return input_shapes_frozen_; }
+
+  // whether the kernels time the implementations they have for the static shapes of their inputs when they are
+  // created, keeping the fastest in KernelTuningCache
+  void SetEnableKernelAutotuning(bool flag) { enable_kernel_autotuning_ = flag; }
+  bool GetEnableKernelAutotuning() const { return enable_kernel_autotuning_; }
+
+  // how the kernels created for the session store the constant matrices they multiply by
+  void SetWeightCompression(WeightCompression compression) { weight_compression_ = compression; }
+  WeightCompression GetWeightCompression() const { return weight_compression_; }
+
+  // whether the executors count the hardware events of the thread computing each node when they profile it or
+  // update its metrics
+  void SetEnableHardwareCounters(bool flag) { enable_hardware_counters_ = flag; }
+  bool GetEnableHardwareCounters() const { return enable_hardware_counters_; }
+
+  using ExecutionFramePtr = std::unique_ptr<ExecutionFrame, std::function<void(ExecutionFrame*)>>;
+
+  /**
+  Get an ExecutionFrame for a Run. A frame released by a previous Run is reset and reused if one is available,
+  which avoids rebuilding the frame and, if the input shapes match, re-allocating the memory pattern buffers.
+  The frame is returned to the cache when the pointer is destroyed so it must not outlive this SessionState.
+  Const as it's an internal cache update only.
+  */
+  ExecutionFramePtr AcquireExecutionFrame(const NameMLValMap& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          const std::vector<MLValue>& fetches,
+                                          const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const;
+
+  // feeds and fetches given by their MLValue indices, as resolved once by a FeedsFetchesManager
+  ExecutionFramePtr AcquireExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
+                                          const std::vector<MLValue>& feeds,
+                                          const std::vector<int>& fetch_mlvalue_idxs,
+                                          const std::vector<MLValue>& fetches,
+                                          const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const;
+
+  /**
+  Destroy the frames cached for reuse by later Runs, here and in the subgraph session states, which frees the
+  memory pattern buffers they hold to the allocators. Frames in use by a Run are cached again once it completes.
+  Const as it's an internal cache update only.
+  */
+  void ReleaseCachedExecutionFrames() const;
+
   struct NodeInfo {
     NodeInfo(size_t index0, const onnxruntime::Node* p_node0, const KernelCreateInfo* kci0)
         : index(index0),
@@ -171,24 +328,64 @@ class SessionState {
   // cache of the constructed kernels to avoid spending construction
   // time per executor
   std::unordered_map<onnxruntime::NodeIndex, std::unique_ptr<OpKernel>> session_kernels_;
+  mutable std::vector<NodeExecutionStep> node_execution_steps_;
+  mutable std::once_flag node_execution_steps_flag_;
   std::unique_ptr<onnxruntime::GraphViewer> graph_viewer_;
 
   const ExecutionProviders& execution_providers_;  // owned by InferenceSession
   MLValueNameIdxMap mlvalue_name_idx_map_;
 
+  // the file data and shared tensors read by initialized tensors, declared first so they are released after them
+  std::vector<Env::MappedMemoryPtr> mapped_memories_;
+  std::vector<std::shared_ptr<const Tensor>> shared_initializers_;
   // initialized tensorset
   std::unordered_map<int, MLValue> initialized_tensors_;  // key is mlvalue_index
   std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan_ = nullptr;
 
   const logging::Logger* logger_;
   profiling::Profiler* profiler_;
+  // indexed by node index. empty if the session doesn't collect metrics.
+  std::vector<SessionMetrics::OpCounters*> node_op_counters_;
+  // indexed by node index. empty unless the session runs the parallel executor.
+  std::vector<double> node_priorities_;
+  std::vector<onnxruntime::NodeIndex> node_clusters_;
+  QuantizationCalibration* calibration_ = nullptr;
 
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_ = true;
+  bool input_shapes_frozen_ = false;
+  bool enable_kernel_autotuning_ = false;
+  WeightCompression weight_compression_ = WeightCompression::kNone;
+  bool enable_hardware_counters_ = false;
+  // key for mem_patterns_. the rank and bucketed dims of each input shape.
+  using MemoryPatternsKey = std::vector<int64_t>;
+  MemoryPatternsKey CalculateMemoryPatternsKey(const std::vector<TensorShape>& shapes) const;
+
+  struct MemoryPatternCacheEntry {
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+    std::list<MemoryPatternsKey>::iterator lru_entry;
+    bool replan = false;
+  };
+
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  // entries are shared with the frames using them so eviction doesn't invalidate a pattern that is in use.
+  mutable std::map<MemoryPatternsKey, MemoryPatternCacheEntry> mem_patterns_;
+  // keys of mem_patterns_, most recently used first
+  mutable std::list<MemoryPatternsKey> mem_patterns_lru_;
+  mutable MemoryPatternCacheStats mem_patterns_stats_;
+  size_t mem_patterns_capacity_ = 0;
+  std::vector<int64_t> mem_patterns_dim_buckets_;
+
+  // frames from completed Runs available for reuse. one is needed per concurrent Run.
+  mutable OrtMutex cached_frames_lock_;
+  mutable std::vector<std::unique_ptr<ExecutionFrame>> cached_frames_;
+
+  // a frame from cached_frames_, or nullptr if there is none
+  std::unique_ptr<ExecutionFrame> TakeCachedExecutionFrame() const;
+  // the pointer returned by AcquireExecutionFrame, which releases the frame to cached_frames_
+  ExecutionFramePtr MakeExecutionFramePtr(std::unique_ptr<ExecutionFrame> frame) const;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
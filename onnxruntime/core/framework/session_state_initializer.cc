@@ -8,7 +8,9 @@
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/common/task_thread_pool.h"
 
+#include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_transformer.h"
 #include "core/graph/graph_transformer_mgr.h"
@@ -20,6 +22,7 @@
 #include "core/framework/mlvalue_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_cache.h"
 #include "core/framework/tensorutils.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/transformer_memcpy.h"
@@ -27,24 +30,41 @@
 
 namespace onnxruntime {
 
+#ifdef USE_EIGEN_THREADPOOL
+using InitializationThreadPool = Eigen::NonBlockingThreadPool;
+#else
+using InitializationThreadPool = TaskThreadPool;
+#endif
+
 static common::Status SaveMLValueNameIndexMapping(const onnxruntime::Graph& graph,
                                                   MLValueNameIdxMap& mlvalue_name_idx_map,
                                                   const logging::Logger& logger);
 
 using SaveTensorFunc = std::function<void(int idx, const onnxruntime::MLValue&)>;
 
-static common::Status SaveInitializedTensors(const onnxruntime::Graph& graph,
+// save the memory that initialized tensors read without owning it
+struct SaveBorrowedMemoryFuncs {
+  std::function<void(Env::MappedMemoryPtr)> save_mapped_memory;
+  // empty if the initializers are not shared with other sessions
+  std::function<void(std::shared_ptr<const Tensor>)> save_shared_tensor;
+};
+
+static common::Status SaveInitializedTensors(onnxruntime::Graph& graph,
+                                             const std::string& model_dir,
                                              bool enable_memory_pattern,
                                              const SequentialExecutionPlan& execution_plan,
                                              const ExecutionProviders& exec_providers,
                                              const MLValueNameIdxMap& mlvalue_name_idx_map,
                                              std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
                                              const SaveTensorFunc& save_tensor_func,
+                                             const SaveBorrowedMemoryFuncs& save_borrowed_memory_funcs,
+                                             InitializationThreadPool* thread_pool,
                                              const logging::Logger& logger);
 
 static common::Status SaveKernels(const ExecutionProviders& execution_providers,
                                   SessionState& session_state,
                                   const KernelRegistryManager& custom_registry_manager,
+                                  InitializationThreadPool* thread_pool,
                                   const logging::Logger& logger);
 
 static common::Status SaveInputOutputNamesToNodeMapping(const onnxruntime::Graph& graph,
@@ -55,11 +75,13 @@ static common::Status SaveInputOutputNamesToNodeMapping(const onnxruntime::Graph
 SessionStateInitializer::SessionStateInitializer(onnxruntime::Graph& graph,
                                                  SessionState& session_state,
                                                  const ExecutionProviders& providers,
-                                                 KernelRegistryManager& kernel_registry_manager)
+                                                 KernelRegistryManager& kernel_registry_manager,
+                                                 const std::string& model_dir)
     : graph_{graph},
       session_state_{session_state},
       execution_providers_{providers},
       kernel_registry_manager_{kernel_registry_manager},
+      model_dir_{model_dir},
       logger_{session_state.Logger()} {
 }
 
@@ -106,28 +128,62 @@ common::Status SessionStateInitializer::CreatePlan(const std::vector<NodeArg*>&
 
 common::Status SessionStateInitializer::InitializeAndSave(bool enable_memory_pattern,
                                                           std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
-                                                          const std::vector<NodeArg*>* implicit_inputs) {
+                                                          const std::vector<NodeArg*>* implicit_inputs,
+                                                          bool share_initializers,
+                                                          bool parallel_initialization) {
   const auto* exec_plan_ptr = session_state_.GetExecutionPlan();
   ORT_ENFORCE(exec_plan_ptr, "Execution plan was not found in SessionState. CreatePlan must be called first.");
 
   const auto& exec_plan{*exec_plan_ptr};
   const auto& mlvalue_name_idx_map{session_state_.GetMLValueNameIdxMap()};
 
+  InitializationThreadPool* thread_pool = parallel_initialization ? session_state_.GetThreadPool() : nullptr;
+  auto& profiler = session_state_.Profiler();
+
+  // the initialized tensors are saved from the threads of thread_pool
+  OrtMutex save_mutex;
+
   // lambda to save initialized tensors into SessionState directly
-  auto add_initialized_tensor = [this](int idx, const onnxruntime::MLValue& value) {
+  auto add_initialized_tensor = [this, &save_mutex](int idx, const onnxruntime::MLValue& value) {
+    std::lock_guard<OrtMutex> lock(save_mutex);
     session_state_.AddInitializedTensor(idx, value);
   };
 
-  ORT_RETURN_IF_ERROR(SaveInitializedTensors(graph_, enable_memory_pattern, exec_plan,
+  SaveBorrowedMemoryFuncs save_borrowed_memory_funcs;
+  save_borrowed_memory_funcs.save_mapped_memory = [this, &save_mutex](Env::MappedMemoryPtr mapped_memory) {
+    std::lock_guard<OrtMutex> lock(save_mutex);
+    session_state_.AddMappedMemory(std::move(mapped_memory));
+  };
+  if (share_initializers) {
+    save_borrowed_memory_funcs.save_shared_tensor = [this, &save_mutex](std::shared_ptr<const Tensor> tensor) {
+      std::lock_guard<OrtMutex> lock(save_mutex);
+      session_state_.AddSharedInitializer(std::move(tensor));
+    };
+  }
+
+  auto tp = profiler.StartTime();
+  ORT_RETURN_IF_ERROR(SaveInitializedTensors(graph_, model_dir_, enable_memory_pattern, exec_plan,
                                              execution_providers_, mlvalue_name_idx_map, weights_buffers,
-                                             add_initialized_tensor, logger_));
+                                             add_initialized_tensor, save_borrowed_memory_funcs, thread_pool,
+                                             logger_));
+  if (profiler.FEnabled()) {
+    profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "initializer_loading", tp);
+  }
 
   graph_.CleanAllInitializedTensors();  // remove weights from the graph now to save memory
 
-  ORT_RETURN_IF_ERROR(SaveKernels(execution_providers_, session_state_, kernel_registry_manager_, logger_));
+  tp = profiler.StartTime();
+  ORT_RETURN_IF_ERROR(SaveKernels(execution_providers_, session_state_, kernel_registry_manager_, thread_pool,
+                                  logger_));
+  if (profiler.FEnabled()) {
+    profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "kernel_creation", tp);
+  }
   ORT_RETURN_IF_ERROR(SaveInputOutputNamesToNodeMapping(graph_, kernel_registry_manager_, session_state_,
                                                         implicit_inputs));
 
+  // resolve the steps of the executor now, rather than in the first Run
+  session_state_.GetNodeExecutionSteps();
+
   return Status::OK();
 }
 
@@ -185,27 +241,118 @@ common::Status SaveMLValueNameIndexMapping(const onnxruntime::Graph& graph,
   return Status::OK();
 }
 
+// runs fn(i) for every i in [0, iterations), on thread_pool and the calling thread if there is a thread_pool.
+// returns the error of the first iteration that failed.
+static common::Status RunIterations(InitializationThreadPool* thread_pool, size_t iterations,
+                                    const std::function<common::Status(size_t)>& fn) {
+  std::vector<Status> statuses(iterations);
+  auto run_iteration = [&fn, &statuses](size_t i) {
+    try {
+      statuses[i] = fn(i);
+    } catch (const std::exception& ex) {
+      statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+  };
+
+  if (thread_pool == nullptr || iterations < 2) {
+    for (size_t i = 0; i < iterations; ++i) {
+      run_iteration(i);
+    }
+  } else {
+#ifdef USE_EIGEN_THREADPOOL
+    Eigen::Barrier barrier(static_cast<unsigned int>(iterations));
+    for (size_t i = 0; i < iterations; ++i) {
+      thread_pool->Schedule([&run_iteration, &barrier, i]() {
+        run_iteration(i);
+        barrier.Notify();
+      });
+    }
+    barrier.Wait();
+#else
+    thread_pool->ParallelFor(static_cast<int32_t>(iterations),
+                             [&run_iteration](int32_t i) { run_iteration(static_cast<size_t>(i)); });
+#endif
+  }
+
+  for (auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
+static bool IsCpuLocation(const OrtAllocatorInfo& alloc_info) {
+  return strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput;
+}
+
+static bool IsShared(const ONNX_NAMESPACE::TensorProto& tensor_proto, const SaveBorrowedMemoryFuncs& funcs) {
+  return funcs.save_shared_tensor && SharedInitializerCache::IsShareable(tensor_proto);
+}
+
+// initializers on CPU with external data read the mapped file, and shared ones the buffer of another session, so
+// they need no buffer of their own
+static bool ReadsBorrowedMemory(const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtAllocatorInfo& alloc_info,
+                                const SaveBorrowedMemoryFuncs& funcs) {
+  return IsCpuLocation(alloc_info) && (utils::HasExternalData(tensor_proto) || IsShared(tensor_proto, funcs));
+}
+
 common::Status DeserializeTensorProto(const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                      const std::string& model_dir,
                                       const OrtAllocatorInfo& alloc_info,
                                       const ExecutionProviders& exec_providers,
-                                      MLValue& mlvalue, void* preallocated, size_t preallocated_size) {
+                                      MLValue& mlvalue, void* preallocated, size_t preallocated_size,
+                                      const SaveBorrowedMemoryFuncs& save_borrowed_memory_funcs) {
   auto alloc_ptr = utils::GetAllocator(exec_providers, alloc_info);
   if (!alloc_ptr) {
     return Status(common::ONNXRUNTIME, common::FAIL, "Failed to get allocator for alloc_info: " + alloc_info.ToString());
   }
 
-  if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
-    // deserialize directly to CPU tensor
-    return utils::TensorProtoToMLValue(tensor_proto, alloc_ptr, preallocated, preallocated_size, mlvalue);
+  const bool has_external_data = utils::HasExternalData(tensor_proto);
+  if (IsCpuLocation(alloc_info)) {
+    if (IsShared(tensor_proto, save_borrowed_memory_funcs)) {
+      std::shared_ptr<const Tensor> shared_tensor;
+      ORT_RETURN_IF_ERROR(SharedInitializerCache::Instance().GetTensor(tensor_proto, shared_tensor));
+      // no deleter, the buffer is freed with the shared tensor
+      auto p_tensor = std::make_unique<Tensor>(shared_tensor->DataType(), shared_tensor->Shape(),
+                                               const_cast<void*>(shared_tensor->DataRaw()), alloc_ptr->Info());
+      save_borrowed_memory_funcs.save_shared_tensor(std::move(shared_tensor));
+      mlvalue.Init(p_tensor.release(),
+                   DataTypeImpl::GetType<Tensor>(),
+                   DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+      return Status::OK();
+    }
+
+    if (!has_external_data) {
+      // deserialize directly to CPU tensor
+      return utils::TensorProtoToMLValue(tensor_proto, alloc_ptr, preallocated, preallocated_size, mlvalue);
+    }
+
+    std::unique_ptr<Tensor> p_mapped_tensor;
+    Env::MappedMemoryPtr mapped_memory;
+    ORT_RETURN_IF_ERROR(utils::GetTensorFromExternalData(tensor_proto, model_dir, alloc_ptr, &p_mapped_tensor,
+                                                         mapped_memory));
+    if (mapped_memory) {
+      save_borrowed_memory_funcs.save_mapped_memory(std::move(mapped_memory));
+    }
+    mlvalue.Init(p_mapped_tensor.release(),
+                 DataTypeImpl::GetType<Tensor>(),
+                 DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    return Status::OK();
   }
 
   std::unique_ptr<Tensor> p_tensor;
   // deserialize to CPU first for non-CPU allocator, then alloc and copy
   AllocatorPtr deserialize_alloc_ptr;
+  // external data is read from the mapped file, which is unmapped once it has been copied
+  Env::MappedMemoryPtr mapped_memory;
   std::unique_ptr<Tensor> p_deserialize_tensor;
   deserialize_alloc_ptr = exec_providers.Get(kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
-  ORT_RETURN_IF_ERROR(utils::GetTensorFromTensorProto(tensor_proto, &p_deserialize_tensor,
-                                                      deserialize_alloc_ptr));
+  if (has_external_data) {
+    ORT_RETURN_IF_ERROR(utils::GetTensorFromExternalData(tensor_proto, model_dir, deserialize_alloc_ptr,
+                                                         &p_deserialize_tensor, mapped_memory));
+  } else {
+    ORT_RETURN_IF_ERROR(utils::GetTensorFromTensorProto(tensor_proto, &p_deserialize_tensor,
+                                                        deserialize_alloc_ptr));
+  }
   const IExecutionProvider* provider = exec_providers.Get(alloc_info);
   ORT_ENFORCE(provider != nullptr);
   p_tensor = std::make_unique<Tensor>(
@@ -243,12 +390,15 @@ static common::Status PlanTensor(MLValuePatternPlanner& planner, const MLValueNa
   return planner.TraceAllocation(mlvalue_index, len);
 }
 
-common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
+common::Status SaveInitializedTensorsWithMemPattern(Graph& graph,
+                                                    const std::string& model_dir,
                                                     const SequentialExecutionPlan& execution_plan,
                                                     const ExecutionProviders& exec_providers,
                                                     const MLValueNameIdxMap& mlvalue_name_idx_map,
                                                     std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
                                                     const SaveTensorFunc& save_tensor_func,
+                                                    const SaveBorrowedMemoryFuncs& save_borrowed_memory_funcs,
+                                                    InitializationThreadPool* thread_pool,
                                                     const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
 
@@ -259,6 +409,12 @@ common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
   //1. first plan the memory
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   for (const auto& entry : initialized_tensor_set) {
+    int mlvalue_index;
+    ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(entry.first, mlvalue_index));
+    if (ReadsBorrowedMemory(*entry.second, execution_plan.allocation_plan[mlvalue_index].location,
+                            save_borrowed_memory_funcs)) {
+      continue;
+    }
     //string/complex64/complex128 tensors will be skipped
     ORT_RETURN_IF_ERROR(PlanTensor(planner, mlvalue_name_idx_map, entry.first, *entry.second));
   }
@@ -281,36 +437,41 @@ common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
   }
 
   //3. create weight tensors based on weights buffer
+  std::vector<const InitializedTensorSet::value_type*> entries;
   for (const auto& entry : initialized_tensor_set) {
-    const std::string& name = entry.first;
+    entries.push_back(&entry);
+  }
+  ORT_RETURN_IF_ERROR(RunIterations(thread_pool, entries.size(), [&](size_t i) {
+    const std::string& name = entries[i]->first;
     int mlvalue_index;
     ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(name, mlvalue_index));
-    const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
+    const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entries[i]->second);
 
     auto& location = execution_plan.allocation_plan[mlvalue_index].location;
-    auto it = weights_buffers.find(location);
-    if (it == weights_buffers.end())
-      return Status(common::ONNXRUNTIME, common::FAIL, "Weight buffer not found");
-
-    auto pattern = mem_patterns.GetPatterns(location);
-    if (pattern == nullptr)
-      return Status(common::ONNXRUNTIME, common::FAIL, "mem pattern not found");
-    auto block = pattern->GetBlock(mlvalue_index);
-    MLValue mlvalue;
-    // if block is not found, means this mlvalue is not traced
-    // fall back to allocate separate buffer.
-
-    // if it->second.get() is null, then fall back to the block not found case
-    if (it->second == nullptr) {
-      block = nullptr;
-    }
-    Status st;
-    if (!block) {
-      st = DeserializeTensorProto(tensor_proto, location, exec_providers, mlvalue, nullptr, 0);
-    } else {
-      st = DeserializeTensorProto(tensor_proto, location, exec_providers, mlvalue,
-                                  (uint8_t*)it->second.get() + block->offset_, block->size_);
+    const MemoryBlock* block = nullptr;
+    void* preallocated = nullptr;
+    if (!ReadsBorrowedMemory(tensor_proto, location, save_borrowed_memory_funcs)) {
+      auto it = weights_buffers.find(location);
+      if (it == weights_buffers.end())
+        return Status(common::ONNXRUNTIME, common::FAIL, "Weight buffer not found");
+
+      auto pattern = mem_patterns.GetPatterns(location);
+      if (pattern == nullptr)
+        return Status(common::ONNXRUNTIME, common::FAIL, "mem pattern not found");
+      // if block is not found, means this mlvalue is not traced
+      // fall back to allocate separate buffer.
+
+      // if it->second.get() is null, then fall back to the block not found case
+      if (it->second != nullptr) {
+        block = pattern->GetBlock(mlvalue_index);
+      }
+      if (block) {
+        preallocated = static_cast<uint8_t*>(it->second.get()) + block->offset_;
+      }
     }
+    MLValue mlvalue;
+    Status st = DeserializeTensorProto(tensor_proto, model_dir, location, exec_providers, mlvalue, preallocated,
+                                       block ? block->size_ : 0, save_borrowed_memory_funcs);
     if (!st.IsOK()) {
       std::ostringstream oss;
       oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
@@ -318,58 +479,75 @@ common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
     }
 
     save_tensor_func(mlvalue_index, mlvalue);
+    graph.ReleaseInitializedTensorData(name);
 
     VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << mlvalue_index;
-  }
+    return Status::OK();
+  }));
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
   return common::Status::OK();
 }
 
-common::Status SaveInitializedTensorsWithSeperateBuffer(const onnxruntime::Graph& graph,
+common::Status SaveInitializedTensorsWithSeperateBuffer(onnxruntime::Graph& graph,
+                                                        const std::string& model_dir,
                                                         const SequentialExecutionPlan& execution_plan,
                                                         const ExecutionProviders& exec_providers,
                                                         const MLValueNameIdxMap& mlvalue_name_idx_map,
                                                         const SaveTensorFunc& save_tensor_func,
+                                                        const SaveBorrowedMemoryFuncs& save_borrowed_memory_funcs,
+                                                        InitializationThreadPool* thread_pool,
                                                         const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
 
   ORT_ENFORCE(mlvalue_name_idx_map.MaxIdx() > 0, "MLValue indexes should have been populated.");
 
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
+  std::vector<const InitializedTensorSet::value_type*> entries;
   for (const auto& entry : initialized_tensor_set) {
-    const std::string& name = entry.first;
+    entries.push_back(&entry);
+  }
+  ORT_RETURN_IF_ERROR(RunIterations(thread_pool, entries.size(), [&](size_t i) {
+    const std::string& name = entries[i]->first;
     int mlvalue_index;
     ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(name, mlvalue_index));
     VLOGS(logger, 1) << "About to add weight with name: " << name << " and index: " << mlvalue_index;
     auto& location = execution_plan.allocation_plan[mlvalue_index].location;
     MLValue mlvalue;
-    ORT_RETURN_IF_ERROR(DeserializeTensorProto(*(entry.second), location, exec_providers, mlvalue, nullptr, 0));
+    ORT_RETURN_IF_ERROR(DeserializeTensorProto(*(entries[i]->second), model_dir, location, exec_providers, mlvalue,
+                                               nullptr, 0, save_borrowed_memory_funcs));
     save_tensor_func(mlvalue_index, mlvalue);
+    graph.ReleaseInitializedTensorData(name);
     VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << mlvalue_index;
-  }
+    return Status::OK();
+  }));
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
   return common::Status::OK();
 }
 
-common::Status SaveInitializedTensors(const onnxruntime::Graph& graph,
+common::Status SaveInitializedTensors(onnxruntime::Graph& graph,
+                                      const std::string& model_dir,
                                       bool enable_memory_pattern,
                                       const SequentialExecutionPlan& execution_plan,
                                       const ExecutionProviders& exec_providers,
                                       const MLValueNameIdxMap& mlvalue_name_idx_map,
                                       std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
                                       const SaveTensorFunc& save_tensor_func,
+                                      const SaveBorrowedMemoryFuncs& save_borrowed_memory_funcs,
+                                      InitializationThreadPool* thread_pool,
                                       const logging::Logger& logger) {
   // if we enable the memory pattern and already have the execution plan
   // go with mem pattern approach, which will allocate a big chunk for all
   // the weights.
   if (enable_memory_pattern) {
-    return SaveInitializedTensorsWithMemPattern(graph, execution_plan, exec_providers,
-                                                mlvalue_name_idx_map, weights_buffers, save_tensor_func, logger);
+    return SaveInitializedTensorsWithMemPattern(graph, model_dir, execution_plan, exec_providers,
+                                                mlvalue_name_idx_map, weights_buffers, save_tensor_func,
+                                                save_borrowed_memory_funcs, thread_pool, logger);
   }
-  return SaveInitializedTensorsWithSeperateBuffer(graph, execution_plan, exec_providers,
-                                                  mlvalue_name_idx_map, save_tensor_func, logger);
+  return SaveInitializedTensorsWithSeperateBuffer(graph, model_dir, execution_plan, exec_providers,
+                                                  mlvalue_name_idx_map, save_tensor_func, save_borrowed_memory_funcs,
+                                                  thread_pool, logger);
 }
 
 static common::Status CreateOpKernelInternal(const onnxruntime::Node& node,
@@ -409,14 +587,23 @@ static common::Status CreateOpKernel(const onnxruntime::Node& node,
 common::Status SaveKernels(const ExecutionProviders& execution_providers,
                            SessionState& session_state,
                            const KernelRegistryManager& custom_registry_manager,
+                           InitializationThreadPool* thread_pool,
                            const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving kernels.";
 
+  std::vector<const onnxruntime::Node*> nodes;
   for (auto& node : session_state.GetGraphViewer()->Nodes()) {
-    // construct and save the kernels
-    std::unique_ptr<OpKernel> op_kernel;
-    ORT_RETURN_IF_ERROR(CreateOpKernel(node, execution_providers, session_state, custom_registry_manager, op_kernel, logger));
-    session_state.AddKernel(node.Index(), std::move(op_kernel));
+    nodes.push_back(&node);
+  }
+
+  // construct the kernels, which only read the session state, then save them
+  std::vector<std::unique_ptr<OpKernel>> op_kernels(nodes.size());
+  ORT_RETURN_IF_ERROR(RunIterations(thread_pool, nodes.size(), [&](size_t i) {
+    return CreateOpKernel(*nodes[i], execution_providers, session_state, custom_registry_manager, op_kernels[i],
+                          logger);
+  }));
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    session_state.AddKernel(nodes[i]->Index(), std::move(op_kernels[i]));
   }
 
   LOGS(logger, INFO) << "Done saving kernels.";
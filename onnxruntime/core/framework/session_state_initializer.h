@@ -3,6 +3,7 @@
 
 #pragma once
 #include <map>
+#include <string>
 
 #include "core/framework/allocator.h"
 #include "core/framework/tensor.h"
@@ -25,7 +26,8 @@ class SessionStateInitializer {
   SessionStateInitializer(onnxruntime::Graph& graph,
                           SessionState& session_state,
                           const ExecutionProviders& providers,
-                          KernelRegistryManager& kernel_registry_manager);
+                          KernelRegistryManager& kernel_registry_manager,
+                          const std::string& model_dir = {});
 
   // First perform any transformations and create the execution plan
   common::Status CreatePlan(const std::vector<NodeArg*>& outer_scope_node_args,
@@ -33,9 +35,14 @@ class SessionStateInitializer {
 
   // initialize tensors, and save. save kernels and input/output node mappings
   // @param enable_memory_pattern
+  // @param share_initializers see SessionOptions::share_initializers
+  // @param parallel_initialization deserialize the initializers and create the kernels on the thread pool of the
+  // session state
   common::Status InitializeAndSave(bool enable_memory_pattern,
                                    std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
-                                   const std::vector<NodeArg*>* implicit_inputs = nullptr);
+                                   const std::vector<NodeArg*>* implicit_inputs = nullptr,
+                                   bool share_initializers = false,
+                                   bool parallel_initialization = false);
 
  private:
   onnxruntime::Graph& graph_;
@@ -43,6 +50,8 @@ class SessionStateInitializer {
 
   const ExecutionProviders& execution_providers_;
   KernelRegistryManager& kernel_registry_manager_;
+  // the directory the locations of external initializer data are relative to
+  const std::string model_dir_;
   const logging::Logger& logger_;
 };
 }  // namespace onnxruntime
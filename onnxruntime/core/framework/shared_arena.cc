@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_arena.h"
+
+#include <algorithm>
+
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+
+SharedArenaAllocator::SharedArenaAllocator(ArenaPtr arena, size_t max_mem)
+    : arena_(std::move(arena)), max_mem_(max_mem) {
+  ORT_ENFORCE(arena_ != nullptr);
+  stats_.bytes_limit = static_cast<int64_t>(max_mem_);
+}
+
+SharedArenaAllocator::~SharedArenaAllocator() {
+  // the session frees everything it allocated before its allocator goes, but the shared arena outlives it
+  for (const auto& allocation : allocations_) {
+    arena_->Free(allocation.first);
+  }
+}
+
+bool SharedArenaAllocator::Account(size_t size) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (max_mem_ != 0 && static_cast<size_t>(stats_.bytes_in_use) + size > max_mem_) {
+    LOGS_DEFAULT(WARNING) << "The session can't allocate " << size << " bytes of the shared arena, as it has "
+                          << stats_.bytes_in_use << " of its limit of " << max_mem_ << " bytes in use.";
+    return false;
+  }
+  stats_.bytes_in_use += static_cast<int64_t>(size);
+  return true;
+}
+
+void* SharedArenaAllocator::Track(void* p, size_t size) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (p == nullptr) {
+    stats_.bytes_in_use -= static_cast<int64_t>(size);
+    return nullptr;
+  }
+  allocations_[p] = size;
+  ++stats_.num_allocs;
+  stats_.max_bytes_in_use = std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
+  stats_.max_alloc_size = std::max(stats_.max_alloc_size, static_cast<int64_t>(size));
+  return p;
+}
+
+void* SharedArenaAllocator::Alloc(size_t size) {
+  if (size == 0 || !Account(size)) {
+    return nullptr;
+  }
+  return Track(arena_->Alloc(size), size);
+}
+
+void* SharedArenaAllocator::Reserve(size_t size) {
+  if (size == 0 || !Account(size)) {
+    return nullptr;
+  }
+  return Track(arena_->Reserve(size), size);
+}
+
+void SharedArenaAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = allocations_.find(p);
+    ORT_ENFORCE(it != allocations_.end(), "The memory wasn't allocated by this session.");
+    stats_.bytes_in_use -= static_cast<int64_t>(it->second);
+    allocations_.erase(it);
+  }
+  arena_->Free(p);
+}
+
+size_t SharedArenaAllocator::Used() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return static_cast<size_t>(stats_.bytes_in_use);
+}
+
+size_t SharedArenaAllocator::Max() const {
+  return max_mem_ != 0 ? max_mem_ : arena_->Max();
+}
+
+common::Status SharedArenaAllocator::Shrink() {
+  return arena_->Shrink();
+}
+
+void SharedArenaAllocator::GetStats(AllocatorStats* stats) {
+  AllocatorStats arena_stats;
+  arena_->GetStats(&arena_stats);
+  std::lock_guard<OrtMutex> lock(mutex_);
+  *stats = stats_;
+  stats->total_allocated_bytes = arena_stats.total_allocated_bytes;
+  stats->free_bytes_in_bins = arena_stats.free_bytes_in_bins;
+  stats->largest_free_chunk = arena_stats.largest_free_chunk;
+  stats->num_extends = arena_stats.num_extends;
+}
+
+}  // namespace onnxruntime
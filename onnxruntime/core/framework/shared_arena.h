@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/arena.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+  * The allocator of a session over an arena that the sessions of a process share, e.g. hundreds of small models,
+  * so that the memory one session frees is reused by the others and the arena grows to the peak of the sessions
+  * together rather than to the sum of their peaks.
+  *
+  * It accounts for the memory the session has in use, which GetStats reports, and fails the allocations that would
+  * take it over max_mem unless that's 0.
+  */
+class SharedArenaAllocator : public IArenaAllocator {
+ public:
+  SharedArenaAllocator(ArenaPtr arena, size_t max_mem);
+  ~SharedArenaAllocator() override;
+
+  void* Alloc(size_t size) override;
+  void* Reserve(size_t size) override;
+  void Free(void* p) override;
+
+  // the bytes the session has in use
+  size_t Used() const override;
+  // the limit of the session, or of the shared arena if the session has none
+  size_t Max() const override;
+
+  // returns the memory no session has in use to the device
+  common::Status Shrink() override;
+
+  // the allocations of the session, and the memory of the shared arena
+  void GetStats(AllocatorStats* stats) override;
+
+  const OrtAllocatorInfo& Info() const override {
+    return arena_->Info();
+  }
+
+  FencePtr CreateFence(const SessionState* session_state) override {
+    return arena_->CreateFence(session_state);
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedArenaAllocator);
+
+  // accounts for size bytes of the session before they're allocated. false if they'd exceed max_mem_.
+  bool Account(size_t size);
+  // records p, or reverts the accounting of size if p is null
+  void* Track(void* p, size_t size);
+
+  const ArenaPtr arena_;
+  const size_t max_mem_;
+
+  mutable OrtMutex mutex_;
+  // the allocations of the session and their sizes
+  std::unordered_map<void*, size_t> allocations_;  // GUARDED_BY(mutex_)
+  AllocatorStats stats_;                           // GUARDED_BY(mutex_)
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <sstream>
+
+#include "core/framework/tensorprotoutils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+SharedInitializerCache& SharedInitializerCache::Instance() {
+  // never destroyed, as the last sessions may free their tensors during static destruction
+  static SharedInitializerCache* cache = new SharedInitializerCache();
+  return *cache;
+}
+
+SharedInitializerCache::SharedInitializerCache() : allocator_{std::make_shared<CPUAllocator>()} {
+}
+
+bool SharedInitializerCache::IsShareable(const TensorProto& tensor_proto) {
+  return tensor_proto.has_raw_data() && tensor_proto.data_type() != TensorProto_DataType_STRING;
+}
+
+common::Status SharedInitializerCache::GetTensor(const TensorProto& tensor_proto,
+                                                 std::shared_ptr<const Tensor>& tensor) {
+  const std::string& raw_data = tensor_proto.raw_data();
+  std::ostringstream key;
+  key << tensor_proto.name() << ':' << tensor_proto.data_type() << ':';
+  for (auto dim : tensor_proto.dims()) {
+    key << dim << ',';
+  }
+  key << ':' << std::hash<std::string>{}(raw_data);
+  const std::string key_str = key.str();
+
+  // the tensors are released after the lock, as the release of the last reference to one locks the cache
+  std::vector<std::shared_ptr<const Tensor>> live_tensors{std::move(tensor)};
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& entries = tensors_[key_str];
+  for (auto it = entries.begin(); it != entries.end();) {
+    auto cached = it->lock();
+    if (cached == nullptr) {
+      // the sessions that used it are gone
+      it = entries.erase(it);
+      continue;
+    }
+    if (cached->Size() == raw_data.size() && std::memcmp(cached->DataRaw(), raw_data.data(), raw_data.size()) == 0) {
+      tensor = cached;
+      return Status::OK();
+    }
+    live_tensors.push_back(std::move(cached));
+    ++it;
+  }
+
+  std::unique_ptr<Tensor> p_tensor;
+  const auto status = utils::GetTensorFromTensorProto(tensor_proto, &p_tensor, allocator_);
+  if (!status.IsOK()) {
+    if (entries.empty()) {
+      tensors_.erase(key_str);
+    }
+    return status;
+  }
+  // the key goes with the last tensor of it, so the keys of the models that were unloaded don't accumulate
+  tensor = std::shared_ptr<const Tensor>(p_tensor.release(), [this, key_str](const Tensor* released) {
+    delete released;
+    ReleaseKey(key_str);
+  });
+  entries.push_back(tensor);
+  return Status::OK();
+}
+
+void SharedInitializerCache::ReleaseKey(const std::string& key) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto entries = tensors_.find(key);
+  if (entries == tensors_.end()) {
+    return;
+  }
+  auto& tensors = entries->second;
+  tensors.erase(std::remove_if(tensors.begin(), tensors.end(),
+                               [](const std::weak_ptr<const Tensor>& cached) { return cached.expired(); }),
+                tensors.end());
+  if (tensors.empty()) {
+    tensors_.erase(entries);
+  }
+}
+
+size_t SharedInitializerCache::NumKeys() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return tensors_.size();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+  * The CPU tensors of the initializers that the sessions of a process share, e.g. replicas of a model per NUMA node
+  * or per tenant. A tensor stays cached as long as a session holds it, so the last session that uses it frees it.
+  *
+  * Tensors are looked up by the name, type, shape and a hash of the data of the initializer, and the data is
+  * compared on a hit, so sessions of different models only share the initializers that are really the same.
+  * The key of an initializer is removed with its last tensor.
+  * The shared buffers must not be written to.
+  */
+class SharedInitializerCache {
+ public:
+  static SharedInitializerCache& Instance();
+
+  // Whether the tensor of tensor_proto can be shared. Only raw data is, as the initializers of real models are
+  // stored in it; the data stored in the typed fields of a TensorProto is usually small.
+  static bool IsShareable(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+  // The tensor of the shareable tensor_proto: the one cached for the same initializer, or a new tensor that is
+  // cached for the next sessions.
+  common::Status GetTensor(const ONNX_NAMESPACE::TensorProto& tensor_proto, std::shared_ptr<const Tensor>& tensor);
+
+  // The number of keys that a tensor is cached for.
+  size_t NumKeys();
+
+ private:
+  SharedInitializerCache();
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerCache);
+
+  // drops the entries of key whose tensors were released, and key once it has none
+  void ReleaseKey(const std::string& key);
+
+  // the tensors outlive the sessions and their allocators
+  AllocatorPtr allocator_;
+
+  OrtMutex mutex_;
+  // key is the name, type, shape and data hash. tensors with a hash collision share a key.
+  std::unordered_map<std::string, std::vector<std::weak_ptr<const Tensor>>> tensors_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/static_mem_pattern_planner.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+
+#include "core/framework/allocator.h"
+#include "core/framework/mldata_type_utils.h"
+#include "core/framework/mlvalue_name_idx_map.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+MemoryPattern StaticMemPatternPlanner::GenerateMemPattern() const {
+  // the largest values first, and of the same size the earliest
+  std::vector<size_t> order(values_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return values_[a].size > values_[b].size ||
+           (values_[a].size == values_[b].size && values_[a].first_step < values_[b].first_step);
+  });
+
+  MemoryPattern pattern;
+  std::vector<size_t> offsets(values_.size(), 0);
+  // the values placed so far, sorted by their offset
+  std::vector<size_t> placed;
+  for (auto i : order) {
+    const auto& value = values_[i];
+    if (value.size == 0) {
+      pattern.patterns_[value.index] = MemoryBlock(0, 0);
+      continue;
+    }
+
+    // the smallest gap that fits between the blocks of the values alive at the same time, or after the last one
+    size_t current = 0;
+    size_t waste_bytes = std::numeric_limits<size_t>::max();
+    bool found = false;
+    size_t best_offset = 0;
+    for (auto j : placed) {
+      const auto& other = values_[j];
+      if (other.first_step > value.last_step || value.first_step > other.last_step) {
+        continue;
+      }
+      if (offsets[j] >= current) {
+        auto gap = offsets[j] - current;
+        if (gap >= value.size && (gap - value.size) < waste_bytes) {
+          found = true;
+          waste_bytes = gap - value.size;
+          best_offset = current;
+        }
+      }
+      current = std::max(current, offsets[j] + other.size);
+    }
+    if (!found) {
+      best_offset = current;
+    }
+
+    offsets[i] = best_offset;
+    auto position = std::upper_bound(placed.begin(), placed.end(), best_offset,
+                                     [&offsets](size_t offset, size_t j) { return offset < offsets[j]; });
+    placed.insert(position, i);
+    pattern.patterns_[value.index] = MemoryBlock(best_offset, value.size);
+    pattern.peak_size_ = std::max(pattern.peak_size_, best_offset + value.size);
+  }
+
+  return pattern;
+}
+
+// the size of the buffer of a tensor of a static shape, as the execution frame allocates it, or false if the
+// value isn't such a tensor
+static bool GetStaticTensorSize(const NodeArg& arg, size_t& size) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  if (type == nullptr || !type->has_tensor_type() || shape == nullptr) {
+    return false;
+  }
+
+  int64_t len = 1;
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value() || dim.dim_value() < 0) {
+      return false;
+    }
+    len *= dim.dim_value();
+  }
+
+  const TensorTypeBase* tensor_type = utils::GetMLDataType(arg)->AsTensorType();
+  if (tensor_type == nullptr) {
+    return false;
+  }
+  MLDataType element_type = tensor_type->GetElementType();
+  // the strings are constructed in their buffers, which the memory patterns don't support
+  if (element_type == DataTypeImpl::GetType<std::string>()) {
+    return false;
+  }
+  return IAllocator::CalcMemSizeForArrayWithAlignment<64>(static_cast<size_t>(len), element_type->Size(), &size);
+}
+
+common::Status GenerateStaticMemPatterns(const GraphViewer& graph_viewer, const SequentialExecutionPlan& plan,
+                                         const MLValueNameIdxMap& mlvalue_name_idx_map,
+                                         std::unique_ptr<MemoryPatternGroup>& patterns) {
+  patterns.reset();
+  const size_t num_values = plan.allocation_plan.size();
+  const size_t num_steps = plan.execution_plan.size();
+  if (num_steps == 0) {
+    return Status::OK();
+  }
+
+  // a value lives from the step of the node that outputs it to the step it's freed after, or to the end
+  std::vector<const NodeArg*> defs(num_values, nullptr);
+  std::vector<size_t> first_steps(num_values, 0);
+  std::vector<size_t> last_steps(num_values, num_steps - 1);
+  for (size_t step = 0; step < num_steps; ++step) {
+    const auto& node_plan = plan.execution_plan[step];
+    const auto* node = graph_viewer.GetNode(node_plan.node_index);
+    ORT_ENFORCE(node != nullptr);
+    for (const auto* output : node->OutputDefs()) {
+      int index;
+      if (!output->Exists() || !mlvalue_name_idx_map.GetIdx(output->Name(), index).IsOK() ||
+          static_cast<size_t>(index) >= num_values || defs[index] != nullptr) {
+        continue;
+      }
+      defs[index] = output;
+      first_steps[index] = step;
+    }
+    for (int i = node_plan.free_from_index; i <= node_plan.free_to_index; ++i) {
+      last_steps[plan.to_be_freed[i]] = step;
+    }
+  }
+
+  std::map<OrtAllocatorInfo, StaticMemPatternPlanner> planners;
+  for (size_t index = 0; index < num_values; ++index) {
+    const auto& value_plan = plan.allocation_plan[index];
+    if (value_plan.alloc_kind != AllocKind::kAllocate) {
+      continue;
+    }
+    size_t size;
+    if (defs[index] == nullptr || !GetStaticTensorSize(*defs[index], size)) {
+      return Status::OK();
+    }
+    planners[value_plan.location].AddValue(static_cast<int>(index), size, first_steps[index], last_steps[index]);
+  }
+
+  patterns = std::make_unique<MemoryPatternGroup>();
+  for (const auto& planner : planners) {
+    patterns->locations.push_back(planner.first);
+    patterns->patterns.push_back(planner.second.GenerateMemPattern());
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
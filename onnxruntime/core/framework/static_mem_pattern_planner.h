@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "core/common/status.h"
+#include "core/framework/mem_pattern.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class MLValueNameIdxMap;
+struct SequentialExecutionPlan;
+
+// StaticMemPatternPlanner plans a memory pattern from the lifetimes of the values, which are known ahead of a run
+// for a graph of static shapes. Unlike MemPatternPlanner, which places each block when it's traced in the order
+// of execution, it places the largest blocks first, each at the offset that fits it best among the blocks of the
+// values alive at the same time, which usually gives a smaller peak.
+class StaticMemPatternPlanner {
+ public:
+  StaticMemPatternPlanner() = default;
+
+  // adds a value of size bytes, allocated by the step first_step of the execution plan and freed after last_step
+  void AddValue(int ml_value_idx, size_t size, size_t first_step, size_t last_step) {
+    values_.push_back({ml_value_idx, size, first_step, last_step});
+  }
+
+  MemoryPattern GenerateMemPattern() const;
+
+ private:
+  struct ValueLifetime {
+    int index;
+    size_t size;
+    size_t first_step;
+    size_t last_step;
+  };
+
+  std::vector<ValueLifetime> values_;
+};
+
+// Generates the memory patterns of the values the plan of a sequential execution allocates, for each location,
+// if all of them are tensors of static shapes; otherwise patterns is left null, so that the patterns are traced
+// in the first run.
+common::Status GenerateStaticMemPatterns(const GraphViewer& graph_viewer, const SequentialExecutionPlan& plan,
+                                         const MLValueNameIdxMap& mlvalue_name_idx_map,
+                                         std::unique_ptr<MemoryPatternGroup>& patterns);
+
+}  // namespace onnxruntime
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/tensor_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace onnxruntime {
+
+constexpr size_t TensorPool::kSlotsPerSlab;
+
+size_t TensorPool::NumSlots() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return slabs_.size() * kSlotsPerSlab;
+}
+
+size_t TensorPool::NumSlotsInUse() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_slots_in_use_;
+}
+
+void* TensorPool::AllocateSlot(size_t size) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (slot_size_ == 0) {
+      const size_t alignment = alignof(std::max_align_t);
+      slot_size_ = (std::max(size, sizeof(void*)) + alignment - 1) / alignment * alignment;
+    }
+
+    if (size <= slot_size_) {
+      if (free_slots_ == nullptr) {
+        slabs_.emplace_back(new char[slot_size_ * kSlotsPerSlab]);
+        char* slab = slabs_.back().get();
+        for (size_t i = kSlotsPerSlab; i > 0; --i) {
+          void* slot = slab + (i - 1) * slot_size_;
+          *static_cast<void**>(slot) = free_slots_;
+          free_slots_ = slot;
+        }
+      }
+
+      void* slot = free_slots_;
+      free_slots_ = *static_cast<void**>(slot);
+      ++num_slots_in_use_;
+      return slot;
+    }
+  }
+
+  return ::operator new(size);
+}
+
+void TensorPool::FreeSlot(void* p, size_t size) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (size <= slot_size_) {
+      *static_cast<void**>(p) = free_slots_;
+      free_slots_ = p;
+      --num_slots_in_use_;
+      return;
+    }
+  }
+
+  ::operator delete(p);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/tensor.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+  * The storage of the Tensor objects an ExecutionFrame creates for the values of its runs, together with the control
+  * blocks of the shared_ptrs the MLValues hold them by, so that a run doesn't allocate them on the heap for each node
+  * output. They're created in the slots of slabs, and a slot is reused by the next value once its value is released,
+  * so that the pool of a frame reused across runs stops allocating after the first run.
+  *
+  * A value may outlive the frame, e.g. a fetch, so each slot in use keeps the pool alive. It's thread safe.
+  */
+class TensorPool : public std::enable_shared_from_this<TensorPool> {
+ public:
+  // the allocator std::allocate_shared allocates the slots with
+  template <typename T>
+  class Allocator {
+   public:
+    using value_type = T;
+
+    explicit Allocator(std::shared_ptr<TensorPool> pool) : pool_(std::move(pool)) {}
+
+    template <typename U>
+    Allocator(const Allocator<U>& other) : pool_(other.pool_) {}
+
+    T* allocate(size_t n) {
+      return static_cast<T*>(pool_->AllocateSlot(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+      pool_->FreeSlot(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const Allocator<U>& other) const {
+      return pool_ == other.pool_;
+    }
+
+    template <typename U>
+    bool operator!=(const Allocator<U>& other) const {
+      return pool_ != other.pool_;
+    }
+
+   private:
+    template <typename U>
+    friend class Allocator;
+
+    std::shared_ptr<TensorPool> pool_;
+  };
+
+  TensorPool() = default;
+
+  // creates a Tensor of the arguments of a Tensor constructor in a slot. the pool must be held by a shared_ptr.
+  template <typename... Args>
+  std::shared_ptr<Tensor> MakeTensor(Args&&... args) {
+    return std::allocate_shared<Tensor>(Allocator<Tensor>(shared_from_this()), std::forward<Args>(args)...);
+  }
+
+  // the slots of the slabs, and how many of them are in use
+  size_t NumSlots() const;
+  size_t NumSlotsInUse() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(TensorPool);
+
+  static constexpr size_t kSlotsPerSlab = 64;
+
+  // the slot size is that of the first allocation, as all of them are for the same type. a larger one is
+  // allocated on the heap.
+  void* AllocateSlot(size_t size);
+  void FreeSlot(void* p, size_t size);
+
+  mutable OrtMutex mutex_;
+  size_t slot_size_ = 0;
+  std::vector<std::unique_ptr<char[]>> slabs_;
+  // the free slots, each of which holds the next one
+  void* free_slots_ = nullptr;
+  size_t num_slots_in_use_ = 0;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/tensor_seq.h"
+
+#include <memory>
+
+namespace onnxruntime {
+
+namespace {
+// the alignment of the tensors in a buffer shared by a sequence, so that each starts at a cache line
+const size_t kTensorAlignment = 64;
+}  // namespace
+
+void TensorSeq::Add(const MLValue& value) {
+  ORT_ENFORCE(value.IsTensor(), "a sequence of tensors can only hold tensors");
+  MLDataType elem_type = value.Get<Tensor>().DataType();
+  if (elem_type_ == nullptr) {
+    elem_type_ = elem_type;
+  }
+  ORT_ENFORCE(elem_type == elem_type_, "a sequence of ", elem_type_, " tensors can't hold a ", elem_type, " tensor");
+  tensors_.push_back(value);
+}
+
+void TensorSeq::AddTensors(const std::vector<TensorShape>& shapes, const AllocatorPtr& allocator) {
+  ORT_ENFORCE(elem_type_ != nullptr, "the element type of the sequence isn't known");
+  ORT_ENFORCE(allocator != nullptr);
+  auto tensor_type = DataTypeImpl::GetType<Tensor>();
+  auto delete_tensor = tensor_type->GetDeleteFunc();
+  const size_t elem_size = elem_type_->Size();
+  tensors_.reserve(tensors_.size() + shapes.size());
+
+  if (elem_type_ == DataTypeImpl::GetType<std::string>()) {
+    for (const auto& shape : shapes) {
+      void* data = allocator->AllocArray(static_cast<size_t>(shape.Size()), elem_size);
+      ORT_ENFORCE(data != nullptr || shape.Size() == 0, "failed to allocate a tensor of shape ", shape);
+      tensors_.emplace_back(new Tensor(elem_type_, shape, data, allocator->Info(), allocator), tensor_type,
+                            delete_tensor);
+    }
+    return;
+  }
+
+  std::vector<size_t> offsets;
+  offsets.reserve(shapes.size());
+  size_t total = 0;
+  for (const auto& shape : shapes) {
+    size_t bytes;
+    ORT_ENFORCE(IAllocator::CalcMemSizeForArrayWithAlignment<kTensorAlignment>(static_cast<size_t>(shape.Size()),
+                                                                               elem_size, &bytes),
+                "the size of a tensor of shape ", shape, " overflows");
+    offsets.push_back(total);
+    ORT_ENFORCE(total + bytes >= total, "the size of the tensors of the sequence overflows");
+    total += bytes;
+  }
+
+  void* data = total == 0 ? nullptr : allocator->Alloc(total);
+  ORT_ENFORCE(data != nullptr || total == 0, "failed to allocate ", total, " bytes for a sequence of tensors");
+  std::shared_ptr<void> buffer(data, [allocator](void* p) {
+    if (p != nullptr)
+      allocator->Free(p);
+  });
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    auto* tensor = new Tensor(elem_type_, shapes[i], static_cast<char*>(data) + offsets[i], allocator->Info());
+    // the tensor views its slice of the buffer, which each tensor keeps alive
+    MLValue value;
+    value.Init(std::shared_ptr<void>(tensor, [buffer, delete_tensor](void* p) { delete_tensor(p); }), tensor_type);
+    tensors_.push_back(std::move(value));
+  }
+}
+
+}  // namespace onnxruntime
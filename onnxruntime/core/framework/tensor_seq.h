@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+/**
+  * A sequence of tensors of one element type, e.g. the values of a tensor Loop or Scan produces in each iteration.
+  * The elements are tensor MLValues, so a tensor is added by sharing its buffer instead of copying it, and the
+  * elements of a sequence allocated at once are tensors in the slices of one buffer of the allocator, an arena
+  * buffer on the CPU. An element keeps its buffer alive, so it may outlive the sequence.
+  */
+class TensorSeq {
+ public:
+  explicit TensorSeq(MLDataType elem_type = nullptr) noexcept : elem_type_(elem_type) {}
+
+  // the element type of the tensors, or nullptr if any type is accepted by the first Add
+  MLDataType DataType() const noexcept { return elem_type_; }
+
+  size_t Size() const noexcept { return tensors_.size(); }
+
+  const Tensor& Get(size_t i) const {
+    return GetValue(i).Get<Tensor>();
+  }
+
+  Tensor& GetMutable(size_t i) {
+    ORT_ENFORCE(i < tensors_.size(), "index ", i, " is out of the range of a sequence of ", tensors_.size());
+    return *tensors_[i].GetMutable<Tensor>();
+  }
+
+  // the MLValue of the i-th tensor, which shares its buffer
+  const MLValue& GetValue(size_t i) const {
+    ORT_ENFORCE(i < tensors_.size(), "index ", i, " is out of the range of a sequence of ", tensors_.size());
+    return tensors_[i];
+  }
+
+  // Appends the tensor of `value`, sharing its buffer.
+  void Add(const MLValue& value);
+
+  // Appends tensors of `shapes`, all of them in one buffer allocated by `allocator` for the sequence rather than a
+  // buffer each. String tensors are allocated one by one, as their strings are objects.
+  void AddTensors(const std::vector<TensorShape>& shapes, const AllocatorPtr& allocator);
+
+ private:
+  MLDataType elem_type_;
+  std::vector<MLValue> tensors_;
+};
+
+}  // namespace onnxruntime
@@ -8,35 +8,36 @@
 
 namespace onnxruntime {
 
-TensorShape::TensorShape(const std::vector<int64_t>& dims) : std::vector<int64_t>(dims) {
-}
+constexpr size_t TensorShape::kSmallBufferSize;
 
-TensorShape::TensorShape(const std::initializer_list<int64_t>& dims) : std::vector<int64_t>(dims) {
+TensorShape::TensorShape(const std::vector<int64_t>& dims) {
+  Assign(dims.data(), dims.size());
 }
 
-TensorShape::TensorShape(const int64_t* dimension_sizes, size_t dimension_count) : std::vector<int64_t>(dimension_count) {
-  for (size_t i = 0; i < dimension_count; ++i) {
-    (*this)[i] = dimension_sizes[i];
-  }
+TensorShape::TensorShape(const std::initializer_list<int64_t>& dims) {
+  Assign(dims.begin(), dims.size());
 }
 
-
 TensorShape::TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end) {
-  assign(dims.begin() + start, dims.begin() + end);
+  Assign(dims.data() + start, end - start);
+}
+
+TensorShape::TensorShape(const TensorDims& dims) {
+  Assign(dims.data(), dims.size());
 }
 
 /**
  * Return the total number of elements. Returns 1 for an empty (rank 0) TensorShape.
  */
 int64_t TensorShape::Size() const {
-  size_t arraySize = size();
+  size_t arraySize = dims_.size();
   int64_t size = SizeHelper(0, arraySize);
   //should we cache the size? as multiple operation may be expensive.
   return size;
 }
 
 int64_t TensorShape::SizeToDimension(size_t dimension) const {
-  const size_t num_dims = size();
+  const size_t num_dims = dims_.size();
   ORT_ENFORCE(dimension <= num_dims,
                       "Invalid dimension of ", dimension, " for SizeFromDimension. Tensor has ",
                       num_dims, " dimensions.");
@@ -46,7 +47,7 @@ int64_t TensorShape::SizeToDimension(size_t dimension) const {
 }
 
 int64_t TensorShape::SizeFromDimension(size_t dimension) const {
-  const size_t num_dims = size();
+  const size_t num_dims = dims_.size();
   ORT_ENFORCE(dimension <= num_dims,
                       "Invalid dimension of ", dimension, " for SizeFromDimension. Tensor has ",
                       num_dims, " dimensions.");
@@ -56,13 +57,13 @@ int64_t TensorShape::SizeFromDimension(size_t dimension) const {
 }
 
 TensorShape TensorShape::Slice(size_t dimstart, size_t dimend) const {
-  ORT_ENFORCE(dimstart <= dimend && dimend <= size(),
+  ORT_ENFORCE(dimstart <= dimend && dimend <= dims_.size(),
                       "Invalid tensor shape slice argument.");
-  return TensorShape(*this, dimstart, dimend);
+  return TensorShape(dims_.data() + dimstart, dimend - dimstart);
 }
 
 TensorShape TensorShape::Slice(size_t dimstart) const {
-  return Slice(dimstart, size());
+  return Slice(dimstart, dims_.size());
 }
 
 // output dimensions
@@ -71,7 +72,7 @@ std::string TensorShape::ToString() const {
 
   result.append("{");
   bool first = true;
-  for (auto dim : (*this)) {
+  for (auto dim : dims_) {
     if (!first) {
       result.append(",");
     }
@@ -88,8 +89,8 @@ int64_t TensorShape::SizeHelper(size_t start, size_t end) const {
   // Must return 1 for an empty sequence
   int64_t size = 1;
   for (size_t i = start; i < end; i++) {
-    if ((*this)[i] < 0) return -1;
-    size *= (*this)[i];
+    if (dims_[i] < 0) return -1;
+    size *= dims_[i];
   }
   return size;
 }
@@ -3,6 +3,8 @@
 
 #include "core/framework/tensorprotoutils.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include "core/graph/onnx_protobuf.h"
 #include "core/common/logging/logging.h"
@@ -214,6 +216,97 @@ common::Status GetTensorFromTensorProto(const TensorProto& tensor_proto,
   }
 }
 
+#define CASE_ELEMENT_TYPE(X, Y)                                        \
+  case ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_##X: \
+    element_type = DataTypeImpl::GetType<Y>();                         \
+    break;
+
+static bool ParseExternalDataSize(const std::string& value, size_t& size) {
+  char* end = nullptr;
+  const unsigned long long parsed = std::strtoull(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0') {
+    return false;
+  }
+  size = static_cast<size_t>(parsed);
+  return true;
+}
+
+common::Status GetTensorFromExternalData(const TensorProto& tensor_proto, const std::string& model_dir,
+                                         AllocatorPtr allocator, std::unique_ptr<Tensor>* p_tensor,
+                                         Env::MappedMemoryPtr& mapped_memory) {
+  MLDataType element_type = nullptr;
+  switch (tensor_proto.data_type()) {
+    CASE_ELEMENT_TYPE(FLOAT, float);
+    CASE_ELEMENT_TYPE(DOUBLE, double);
+    CASE_ELEMENT_TYPE(BOOL, bool);
+    CASE_ELEMENT_TYPE(INT8, int8_t);
+    CASE_ELEMENT_TYPE(INT16, int16_t);
+    CASE_ELEMENT_TYPE(INT32, int32_t);
+    CASE_ELEMENT_TYPE(INT64, int64_t);
+    CASE_ELEMENT_TYPE(UINT8, uint8_t);
+    CASE_ELEMENT_TYPE(UINT16, uint16_t);
+    CASE_ELEMENT_TYPE(UINT32, uint32_t);
+    CASE_ELEMENT_TYPE(UINT64, uint64_t);
+    CASE_ELEMENT_TYPE(FLOAT16, MLFloat16);
+    CASE_ELEMENT_TYPE(BFLOAT16, BFloat16);
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Initialized tensor ", tensor_proto.name(),
+                             " has external data of unsupported type: ", tensor_proto.data_type());
+  }
+
+  std::string location;
+  size_t offset = 0;
+  size_t length = 0;
+  bool has_length = false;
+  for (const auto& entry : tensor_proto.external_data()) {
+    bool valid = true;
+    if (entry.key() == "location") {
+      location = entry.value();
+    } else if (entry.key() == "offset") {
+      valid = ParseExternalDataSize(entry.value(), offset);
+    } else if (entry.key() == "length") {
+      has_length = true;
+      valid = ParseExternalDataSize(entry.value(), length);
+    }
+    if (!valid) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "Invalid ", entry.key(), " of the external data of ",
+                             tensor_proto.name(), ": ", entry.value());
+    }
+  }
+  if (location.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The external data of ", tensor_proto.name(),
+                           " has no location");
+  }
+
+  TensorShape tensor_shape{GetTensorShapeFromTensorProto(tensor_proto)};
+  size_t bytes = 0;
+  if (tensor_shape.Size() < 0 ||
+      !IAllocator::CalcMemSizeForArray(static_cast<size_t>(tensor_shape.Size()), element_type->Size(), &bytes)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid shape ", tensor_shape, " of ", tensor_proto.name());
+  }
+  if (has_length && length != bytes) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The external data of ", tensor_proto.name(), " has ", length,
+                           " bytes, expected ", bytes);
+  }
+
+  const std::string path = model_dir.empty() ? location : model_dir + "/" + location;
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(path, offset, bytes, mapped_memory));
+
+  void* data = mapped_memory.get();
+  if (reinterpret_cast<uintptr_t>(data) % element_type->Size() != 0) {
+    // kernels read the elements in place, so an offset that isn't a multiple of the element size costs a copy
+    void* buffer = allocator->Alloc(bytes);
+    std::memcpy(buffer, data, bytes);
+    mapped_memory.reset();
+    *p_tensor = std::make_unique<Tensor>(element_type, tensor_shape, buffer, allocator->Info(), allocator);
+    return Status::OK();
+  }
+
+  // no deleter, the pages are unmapped with mapped_memory
+  *p_tensor = std::make_unique<Tensor>(element_type, tensor_shape, data, allocator->Info());
+  return Status::OK();
+}
+
 TensorProto::DataType GetTensorProtoType(const Tensor& tensor) {
   auto tensor_type = tensor.DataType();
   TensorProto::DataType dtype = TensorProto_DataType_UNDEFINED;
@@ -248,5 +341,33 @@ TensorProto::DataType GetTensorProtoType(const Tensor& tensor) {
   return dtype;
 }
 
+Status TensorToTensorProto(const Tensor& tensor, const std::string& name, TensorProto& tensor_proto) {
+  if (strcmp(tensor.Location().name, CPU) != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The data of ", name, " is not in CPU memory.");
+  }
+
+  tensor_proto.Clear();
+  tensor_proto.set_name(name);
+  for (auto dim : tensor.Shape().GetDims()) {
+    tensor_proto.add_dims(dim);
+  }
+
+  if (tensor.DataType() == DataTypeImpl::GetType<std::string>()) {
+    tensor_proto.set_data_type(TensorProto_DataType_STRING);
+    for (const auto& str : tensor.DataAsSpan<std::string>()) {
+      tensor_proto.add_string_data(str);
+    }
+    return Status::OK();
+  }
+
+  const auto dtype = GetTensorProtoType(tensor);
+  if (dtype == TensorProto_DataType_UNDEFINED) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The type of ", name, " has no TensorProto type.");
+  }
+  tensor_proto.set_data_type(dtype);
+  tensor_proto.set_raw_data(tensor.DataRaw(), tensor.Size());
+  return Status::OK();
+}
+
 }  // namespace utils
 }  // namespace onnxruntime
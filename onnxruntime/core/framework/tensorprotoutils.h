@@ -10,6 +10,7 @@
 #include "core/framework/allocator.h"
 #include "core/framework/ml_value.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
 
 namespace ONNX_NAMESPACE {
 class TensorProto;
@@ -25,5 +26,17 @@ std::vector<int64_t> GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::Te
 common::Status TensorProtoToMLValue(const ONNX_NAMESPACE::TensorProto& input, AllocatorPtr allocator, void* preallocated,
                                     size_t preallocated_size, MLValue& value);
 ONNX_NAMESPACE::TensorProto::DataType GetTensorProtoType(const Tensor& tensor);
+
+// Copies the data of tensor, which has to be in CPU memory, into tensor_proto, with its name, type and dims.
+common::Status TensorToTensorProto(const Tensor& tensor, const std::string& name,
+                                   ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+// Maps the external data of tensor_proto, whose location is relative to model_dir, into memory and creates a tensor
+// that reads the mapped pages, which must outlive it. The tensor has the allocator info of allocator, which has to
+// be a CPU allocator. Data that isn't aligned to the element size is copied into a buffer of allocator instead, and
+// mapped_memory is then empty.
+common::Status GetTensorFromExternalData(const ONNX_NAMESPACE::TensorProto& tensor_proto, const std::string& model_dir,
+                                         AllocatorPtr allocator, std::unique_ptr<Tensor>* p_tensor,
+                                         Env::MappedMemoryPtr& mapped_memory);
 }  // namespace utils
 }  // namespace onnxruntime
@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "transformer_memcpy.h"
+
+#include <algorithm>
+
 #include "core/framework/kernel_registry_manager.h"
+#include "core/graph/constants.h"
 
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
@@ -27,13 +31,22 @@ considered to be non-provider here.)
 
 Note that every ml-value is computed at a unique point (either provider or non-provider),
 but it may be referenced and used at multiple points (by both provider and non-provider).
+So X is copied once for all the provider nodes that reference it.
+
+Before (1), the Constant nodes that are referenced by provider nodes are turned into initializers,
+so that their values are copied to the provider once when the session is initialized rather than
+in every run.
+
+After (3), the copies in the same direction of the outputs of the same node are merged into one
+copy node, which copies them together once the node has run. Copy nodes of the same value in the
+same direction, e.g. ones the graph already had, are merged into one.
 
 This transformer does not currently optimize copies between, e.g., two different GPU devices, etc.
 
 */
 
 bool TransformerMemcpyImpl::ModifyGraph(const KernelRegistryManager& kernel_registries) {
-  bool modified = false;
+  bool modified = HoistConstants();
   // find defs that require copy
   for (auto& node : graph_.Nodes()) {
     //don't need to do node placement here now, onnxruntime will do it according to registered kernels.
@@ -61,6 +74,113 @@ bool TransformerMemcpyImpl::ModifyGraph(const KernelRegistryManager& kernel_regi
       modified = true;
     }
 
+  if (BatchCopies())
+    modified = true;
+
+  return modified;
+}
+
+static void RemoveNodeAndOutputEdges(onnxruntime::Graph& graph, onnxruntime::Node& node) {
+  std::vector<onnxruntime::Node::EdgeEnd> output_edges(node.OutputEdgesBegin(), node.OutputEdgesEnd());
+  for (const auto& edge : output_edges) {
+    graph.RemoveEdge(node.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+  }
+  graph.RemoveNode(node.Index());
+}
+
+bool TransformerMemcpyImpl::HoistConstants() {
+  std::vector<onnxruntime::Node*> constant_nodes;
+  for (auto& node : graph_.Nodes()) {
+    if (node.OpType() != "Constant" || (node.Domain() != kOnnxDomain && node.Domain() != kOnnxDomainAlias) ||
+        node.GetExecutionProviderType() == provider_ || graph_.IsNodeOutputsInGraphOutputs(node))
+      continue;
+
+    const auto& attributes = node.GetAttributes();
+    auto value = attributes.find("value");
+    if (value == attributes.end() || !value->second.has_t())
+      continue;
+
+    bool provider_consumer = false;
+    for (auto it = node.OutputNodesBegin(); it != node.OutputNodesEnd(); ++it) {
+      if ((*it).GetExecutionProviderType() == provider_)
+        provider_consumer = true;
+    }
+    if (!provider_consumer)
+      continue;
+
+    TensorProto tensor_proto = value->second.t();
+    *(tensor_proto.mutable_name()) = node.OutputDefs()[0]->Name();
+    graph_.AddInitializedTensor(tensor_proto);
+    constant_nodes.push_back(&node);
+  }
+
+  for (auto* node : constant_nodes) {
+    RemoveNodeAndOutputEdges(graph_, *node);
+  }
+  return !constant_nodes.empty();
+}
+
+bool TransformerMemcpyImpl::BatchCopies() {
+  std::map<const onnxruntime::NodeArg*, onnxruntime::NodeIndex, NodeArgCompare> producers;
+  for (auto& node : graph_.Nodes()) {
+    for (auto* arg : node.OutputDefs()) {
+      if (arg->Exists())
+        producers[arg] = node.Index();
+    }
+  }
+
+  // the copy nodes of the provider by direction and by the producer of their input, ordered by index
+  std::map<std::pair<std::string, onnxruntime::NodeIndex>, std::vector<onnxruntime::Node*>> groups;
+  for (auto& node : graph_.Nodes()) {
+    if (node.GetExecutionProviderType() != provider_ ||
+        (node.OpType() != "MemcpyFromHost" && node.OpType() != "MemcpyToHost") || node.InputDefs().size() != 1)
+      continue;
+    auto producer = producers.find(node.InputDefs()[0]);
+    if (producer != producers.end())
+      groups[std::make_pair(node.OpType(), producer->second)].push_back(&node);
+  }
+
+  const auto& graph_outputs = graph_.GetOutputs();
+  bool modified = false;
+  for (const auto& group : groups) {
+    const auto& copy_nodes = group.second;
+    if (copy_nodes.size() < 2)
+      continue;
+
+    std::vector<onnxruntime::NodeArg*> inputs;
+    std::vector<onnxruntime::NodeArg*> outputs;
+    // the outputs of the copies of a value already copied, which the consumers read from the first copy instead
+    std::map<const onnxruntime::NodeArg*, onnxruntime::NodeArg*> replacements;
+    for (auto* copy_node : copy_nodes) {
+      auto* input = copy_node->MutableInputDefs()[0];
+      auto* output = copy_node->MutableOutputDefs()[0];
+      auto copied = std::find(inputs.begin(), inputs.end(), input);
+      if (copied != inputs.end() &&
+          std::find(graph_outputs.cbegin(), graph_outputs.cend(), output) == graph_outputs.cend()) {
+        replacements[output] = outputs[copied - inputs.begin()];
+      } else {
+        inputs.push_back(input);
+        outputs.push_back(output);
+      }
+    }
+
+    std::set<const onnxruntime::Node*> copy_node_set(copy_nodes.cbegin(), copy_nodes.cend());
+    if (!replacements.empty()) {
+      for (auto& node : graph_.Nodes()) {
+        if (!copy_node_set.count(&node))
+          node.ReplaceDefs(replacements);
+      }
+    }
+    for (auto* copy_node : copy_nodes) {
+      RemoveNodeAndOutputEdges(graph_, *copy_node);
+    }
+
+    const auto& op_name = group.first.first;
+    auto& new_node = graph_.AddNode(graph_.GenerateNodeName("Memcpy"), op_name, "Copy from/to host memory",
+                                    inputs, outputs);
+    new_node.SetExecutionProviderType(provider_);
+    modified = true;
+  }
   return modified;
 }
 
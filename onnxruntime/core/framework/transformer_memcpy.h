@@ -23,6 +23,10 @@ class TransformerMemcpyImpl {
   void BuildDefsMapping(const onnxruntime::NodeArg* arg, const KernelRegistryManager& kernel_registries);
   void AddCopyNode(onnxruntime::NodeArg* arg, bool is_input);
   void ProcessInitializers();
+  // turns the Constant nodes read by provider nodes into initializers
+  bool HoistConstants();
+  // merges the copy nodes in the same direction of the outputs of a node
+  bool BatchCopies();
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(TransformerMemcpyImpl);
@@ -3,16 +3,23 @@
 
 #include "core/framework/utils.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "core/graph/graph_viewer.h"
 
+#include "core/common/task_thread_pool.h"
+#include "core/framework/environment.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/execution_providers.h"
+#include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/parallel_executor.h"
 #include "core/framework/session_state.h"
 #include "core/framework/sequential_executor.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 namespace utils {
@@ -159,7 +166,19 @@ common::Status CopyOneInputAcrossDevices(const SessionState& session_state,
 
   // our CPU exec provider doesn't support copy from GPU->CPU
   if (required_provider_type != onnxruntime::kCpuExecutionProvider) {
-    ORT_RETURN_IF_ERROR(required_provider->CopyTensor(input_tensor, *new_tensor));
+    // copy host memory asynchronously when the device tracks the copy with a fence, so that nodes consuming
+    // other inputs can start while this input is still in flight. the consumers of the input wait on the fence.
+    FencePtr fence;
+    if (input_provider_type == onnxruntime::kCpuExecutionProvider || input_tensor_loc.mem_type != OrtMemTypeDefault) {
+      fence = required_provider->GetAllocator(target_device_id, OrtMemTypeDefault)->CreateFence(&session_state);
+    }
+
+    if (fence) {
+      new_mlvalue.SetFence(fence);
+      ORT_RETURN_IF_ERROR(required_provider->CopyTensorFromHostAsync(input_tensor, *new_tensor, *fence));
+    } else {
+      ORT_RETURN_IF_ERROR(required_provider->CopyTensor(input_tensor, *new_tensor));
+    }
   } else {
     ORT_RETURN_IF_ERROR(p_input_provider->CopyTensor(input_tensor, *new_tensor));
   }
@@ -350,6 +369,12 @@ common::Status CopyOutputsAcrossDevices(const SessionState& session_state,
       continue;
     }
 
+    // the fetch may still be written asynchronously, e.g. a graph input that is also a graph output
+    Fence_t fetched_fence = fetched_mlvalue.Fence();
+    if (fetched_fence) {
+      fetched_fence->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, 0);
+    }
+
     // our CPU exec provider doesn't support copy from GPU->CPU
     if (fetched_provider_type != onnxruntime::kCpuExecutionProvider) {
       ORT_RETURN_IF_ERROR(p_fetched_provider->CopyTensor(fetched_tensor, *p_output_tensor));
@@ -367,11 +392,14 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             std::vector<MLValue>& fetches,
                             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                             bool sequential_execution,
-                            const bool& terminate_flag,
-                            const logging::Logger& logger) {
-  // TODO: Would be better to check upfront whether there was a need to copy inputs/outputs across devices,
-  // especially when a subgraph is repeatedly executed in a Scan or Loop node. If we checked once and no copy was
-  // needed we can skip everything here apart from the Execute call.
+                            const RunTermination& termination,
+                            const logging::Logger& logger,
+                            int intra_op_thread_limit,
+                            profiling::Profiler* run_profiler,
+                            OutputReadyNotifier* output_ready) {
+  // graphs that are executed repeatedly, such as the subgraph of a Scan or Loop node, check once whether a copy
+  // across devices can be needed with a FeedsFetchesManager, and skip everything here apart from the Execute call
+  // if it can't.
 
   NameMLValMap device_feeds;
   ORT_RETURN_IF_ERROR(utils::CopyInputsAcrossDevices(session_state, feeds, device_feeds));
@@ -379,12 +407,23 @@ common::Status ExecuteGraph(const SessionState& session_state,
   std::vector<MLValue> device_fetches;
   ORT_RETURN_IF_ERROR(utils::MatchOutputsWithProviders(session_state, output_names, fetches, device_fetches));
 
+  // a value the nodes produce isn't final if it is yet to be copied to a fetch the caller provided on a device
+  if (output_ready != nullptr) {
+    for (const auto& fetch : fetches) {
+      if (fetch.IsAllocated() && fetch.IsTensor() && strcmp(fetch.Get<Tensor>().Location().name, CPU) != 0) {
+        output_ready = nullptr;
+        break;
+      }
+    }
+  }
+
   std::unique_ptr<IExecutor> p_exec;
 
   if (sequential_execution) {
-    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag));
+    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(termination, run_profiler, output_ready));
   } else {
-    p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
+    p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, termination, intra_op_thread_limit,
+                                                             run_profiler, output_ready));
   }
 
   ORT_RETURN_IF_ERROR(p_exec->Execute(session_state, device_feeds, output_names, device_fetches, fetch_allocators, logger));
@@ -393,5 +432,87 @@ common::Status ExecuteGraph(const SessionState& session_state,
   return Status::OK();
 }
 
+common::Status ExecuteGraph(const SessionState& session_state,
+                            const FeedsFetchesManager& feeds_fetches_manager,
+                            const std::vector<MLValue>& feeds,
+                            std::vector<MLValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                            bool sequential_execution,
+                            const RunTermination& termination,
+                            const logging::Logger& logger,
+                            int intra_op_thread_limit,
+                            profiling::Profiler* run_profiler,
+                            OutputReadyNotifier* output_ready) {
+  const auto& feed_names = feeds_fetches_manager.GetFeedNames();
+  ORT_RETURN_IF_NOT(feeds.size() == feed_names.size(), "Expected ", feed_names.size(), " feeds. Got ", feeds.size());
+
+  if (sequential_execution && !feeds_fetches_manager.DeviceCopiesMayBeNeeded()) {
+    SequentialExecutor executor{termination, run_profiler, output_ready};
+    return executor.Execute(session_state, feeds_fetches_manager.GetFeedsMLValueIdxs(), feeds,
+                            feeds_fetches_manager.GetFetchesMLValueIdxs(), fetches, fetch_allocators, logger);
+  }
+
+  NameMLValMap feeds_by_name;
+  feeds_by_name.reserve(feeds.size());
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    feeds_by_name[feed_names[i]] = feeds[i];
+  }
+
+  return ExecuteGraph(session_state, feeds_by_name, feeds_fetches_manager.GetOutputNames(), fetches,
+                      fetch_allocators, sequential_execution, termination, logger, intra_op_thread_limit,
+                      run_profiler, output_ready);
+}
+
+void RunHigherPriorityTasks(TaskThreadPool* pool) {
+  if (pool == nullptr || !pool->HasHigherPriorityTasks(TaskThreadPool::CurrentPriority())) {
+    return;
+  }
+
+  // the tasks belong to other Runs, which mustn't stop when this one terminates or be held to its limits
+  const MLAS_CANCELLATION* cancellation = MlasGetCancellation();
+  const int32_t thread_limit = MlasGetThreadLimit();
+  TaskThreadPool* intra_op_pool = Environment::SetCurrentThreadIntraOpThreadPool(nullptr);
+  MlasSetCancellation(nullptr);
+  MlasSetThreadLimit(0);
+
+  pool->RunHigherPriorityTasks();
+
+  Environment::SetCurrentThreadIntraOpThreadPool(intra_op_pool);
+  MlasSetThreadLimit(thread_limit);
+  MlasSetCancellation(cancellation);
+}
+
+ScopedIntraOpThreadLimit::ScopedIntraOpThreadLimit(int thread_limit) {
+  if (thread_limit > 0) {
+    previous_limit_ = MlasGetThreadLimit();
+    MlasSetThreadLimit(thread_limit);
+    applied_ = true;
+  }
+}
+
+ScopedIntraOpThreadLimit::~ScopedIntraOpThreadLimit() {
+  if (applied_) {
+    MlasSetThreadLimit(previous_limit_);
+  }
+}
+
+ScopedIntraOpThreadPool::ScopedIntraOpThreadPool(TaskThreadPool* pool) {
+  if (pool != nullptr) {
+    previous_pool_ = Environment::SetCurrentThreadIntraOpThreadPool(pool);
+    previous_limit_ = MlasGetThreadLimit();
+    // the pool's threads and the calling thread, unless a lower limit has been set
+    int limit = pool->NumThreads() + 1;
+    MlasSetThreadLimit(previous_limit_ > 0 ? std::min(previous_limit_, limit) : limit);
+    applied_ = true;
+  }
+}
+
+ScopedIntraOpThreadPool::~ScopedIntraOpThreadPool() {
+  if (applied_) {
+    MlasSetThreadLimit(previous_limit_);
+    Environment::SetCurrentThreadIntraOpThreadPool(previous_pool_);
+  }
+}
+
 }  // namespace utils
 }  // namespace onnxruntime
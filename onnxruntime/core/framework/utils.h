@@ -8,16 +8,20 @@
 #include "core/framework/data_types.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
+#include "core/framework/run_termination.h"
 #include "core/framework/session_state.h"
 
 namespace onnxruntime {
 class ExecutionProviders;
+class FeedsFetchesManager;
 class Graph;
 class KernelDef;
 class KernelRegistryManager;
 class IExecutionProvider;
 class MLValue;
 class Node;
+class OutputReadyNotifier;
+class TaskThreadPool;
 class Tensor;
 
 namespace logging {
@@ -57,14 +61,69 @@ common::Status CopyOutputsAcrossDevices(const SessionState& session_state,
                                         std::vector<MLValue>& fetches,
                                         std::vector<MLValue>& user_fetches);
 
+// run_profiler records the events of the execution instead of the profiler of the session if it isn't nullptr,
+// for a Run that is profiled on its own. output_ready, if it isn't nullptr, is notified of the fetches produced by
+// the nodes as they finish, apart from those that are copied to a fetch the caller provided on another device.
 common::Status ExecuteGraph(const SessionState& session_state,
                             const NameMLValMap& feeds,
                             const std::vector<std::string>& output_names,
                             std::vector<MLValue>& fetches,
                             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                             bool sequential_execution,
-                            const bool& terminate_flag,
-                            const logging::Logger& logger);
+                            const RunTermination& termination,
+                            const logging::Logger& logger,
+                            int intra_op_thread_limit = 0,
+                            profiling::Profiler* run_profiler = nullptr,
+                            OutputReadyNotifier* output_ready = nullptr);
+
+// Execute a graph that is executed repeatedly, such as the subgraph of a Loop or Scan node or a prepared Run.
+// feeds and fetches are in the order of the feed and output names of feeds_fetches_manager. If it found that no
+// device copies can be needed, a sequential execution goes to the executor with the pre-resolved MLValue indices.
+common::Status ExecuteGraph(const SessionState& session_state,
+                            const FeedsFetchesManager& feeds_fetches_manager,
+                            const std::vector<MLValue>& feeds,
+                            std::vector<MLValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                            bool sequential_execution,
+                            const RunTermination& termination,
+                            const logging::Logger& logger,
+                            int intra_op_thread_limit = 0,
+                            profiling::Profiler* run_profiler = nullptr,
+                            OutputReadyNotifier* output_ready = nullptr);
+
+// Limits the number of threads MLAS operations started from the current thread may use for the lifetime of the
+// object, restoring the previous limit on destruction. A limit of 0 leaves the current limit unchanged.
+class ScopedIntraOpThreadLimit {
+ public:
+  explicit ScopedIntraOpThreadLimit(int thread_limit);
+  ~ScopedIntraOpThreadLimit();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedIntraOpThreadLimit);
+
+  int previous_limit_ = 0;
+  bool applied_ = false;
+};
+
+// Makes MLAS operations and the kernels started from the current thread use pool as their intra-op thread pool, with
+// as many threads as it has, for the lifetime of the object. A null pool leaves the current pool unchanged.
+class ScopedIntraOpThreadPool {
+ public:
+  explicit ScopedIntraOpThreadPool(TaskThreadPool* pool);
+  ~ScopedIntraOpThreadPool();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedIntraOpThreadPool);
+
+  TaskThreadPool* previous_pool_ = nullptr;
+  int previous_limit_ = 0;
+  bool applied_ = false;
+};
+
+// Runs the queued tasks of pool with a higher priority class than the Run on the calling thread, without the Run's
+// MLAS cancellation, thread limit and intra-op pool, so a Run lets the more urgent work of other Runs go first
+// between its nodes. A null pool is ignored.
+void RunHigherPriorityTasks(TaskThreadPool* pool);
 
 #define DispatchOnTensorType(tensor_type, function, ...)      \
   if (tensor_type == DataTypeImpl::GetType<float>())          \
@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/attention_fusion.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// a float tensor of a known rank of at least 2, as the Attention kernels take
+bool IsMatrixInput(const NodeArg& arg) {
+  return arg.Type() != nullptr && *arg.Type() == "tensor(float)" && arg.Shape() != nullptr &&
+         arg.Shape()->dim_size() >= 2;
+}
+
+bool IsSameDim(const TensorShapeProto_Dimension& a, const TensorShapeProto_Dimension& b) {
+  return (a.has_dim_value() && b.has_dim_value() && a.dim_value() == b.dim_value()) ||
+         (a.has_dim_param() && b.has_dim_param() && a.dim_param() == b.dim_param());
+}
+
+// the mask must broadcast to the scores without changing their shape, which the kernels don't support
+bool IsMaskOf(const NodeArg& mask, const NodeArg& scores) {
+  const TensorShapeProto* mask_shape = mask.Shape();
+  const TensorShapeProto* scores_shape = scores.Shape();
+  if (mask.Type() == nullptr || *mask.Type() != "tensor(float)" || mask_shape == nullptr ||
+      scores_shape == nullptr || mask_shape->dim_size() > scores_shape->dim_size()) {
+    return false;
+  }
+  const int offset = scores_shape->dim_size() - mask_shape->dim_size();
+  for (int i = 0; i < mask_shape->dim_size(); ++i) {
+    const auto& dim = mask_shape->dim(i);
+    if (!(dim.has_dim_value() && dim.dim_value() == 1) && !IsSameDim(dim, scores_shape->dim(offset + i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the MatMul of Q and K_transposed that computes the scores read by consumer, through an optional Mul or Div by a
+// scalar initializer whose factor is returned in scale
+Node* GetScoresMatMul(Graph& graph, Node* producer, const Node& consumer, float& scale, Node*& scale_node) {
+  if (producer == nullptr || utils::GetOnlyConsumer(graph, *producer) != &consumer) {
+    return nullptr;
+  }
+  scale = 1.0f;
+  scale_node = nullptr;
+  if (utils::IsSupportedOptypeVersionAndDomain(*producer, "Mul", 7) ||
+      utils::IsSupportedOptypeVersionAndDomain(*producer, "Div", 7)) {
+    if (producer->InputDefs().size() != 2) {
+      return nullptr;
+    }
+    // the constant of a Div is its divisor
+    const bool is_div = producer->OpType() == "Div";
+    float constant = 0.0f;
+    int scale_input = 1;
+    if (!utils::GetScalarInitializerValue(graph, *producer->InputDefs()[1], constant)) {
+      scale_input = 0;
+      if (is_div || !utils::GetScalarInitializerValue(graph, *producer->InputDefs()[0], constant)) {
+        return nullptr;
+      }
+    }
+    if (is_div && constant == 0.0f) {
+      return nullptr;
+    }
+    scale = is_div ? 1.0f / constant : constant;
+    scale_node = producer;
+    producer = utils::GetInputNode(graph, *producer, 1 - scale_input);
+    if (producer == nullptr || utils::GetOnlyConsumer(graph, *producer) != scale_node) {
+      return nullptr;
+    }
+  }
+
+  if (!utils::IsSupportedOptypeVersionAndDomain(*producer, "MatMul", 1) ||
+      !IsMatrixInput(*producer->InputDefs()[0]) || !IsMatrixInput(*producer->InputDefs()[1])) {
+    return nullptr;
+  }
+  return producer;
+}
+
+}  // namespace
+
+bool FuseAttention::SatisfyCondition(const Node& node) {
+  if (!utils::IsSupportedOptypeVersionAndDomain(node, "Softmax", 1)) {
+    return false;
+  }
+  // the Softmax of opset 1 defaults to axis 1 and normalizes the flattened trailing dims
+  auto& attributes = node.GetAttributes();
+  auto axis = attributes.find("axis");
+  const TensorShapeProto* shape = node.InputDefs()[0]->Shape();
+  if (axis == attributes.end() || shape == nullptr || shape->dim_size() < 2) {
+    return false;
+  }
+  return axis->second.i() == -1 || axis->second.i() == shape->dim_size() - 1;
+}
+
+Status FuseAttention::Apply(Graph& graph, Node& node, bool& modified) {
+  // the probabilities are only read by the MatMul with V
+  Node* output_matmul = utils::GetOnlyConsumer(graph, node);
+  if (output_matmul == nullptr || !utils::IsSupportedOptypeVersionAndDomain(*output_matmul, "MatMul", 1) ||
+      output_matmul->InputDefs()[0] != node.OutputDefs()[0] || !IsMatrixInput(*output_matmul->InputDefs()[1])) {
+    return Status::OK();
+  }
+
+  // walk up from the Softmax to the MatMul of Q and K_transposed, the mask is added to either input of an Add
+  Node* add_mask = nullptr;
+  int mask_input = -1;
+  Node* scale_node = nullptr;
+  float scale = 1.0f;
+  Node* producer = utils::GetInputNode(graph, node, 0);
+  Node* qk_matmul = GetScoresMatMul(graph, producer, node, scale, scale_node);
+  if (qk_matmul == nullptr && producer != nullptr && utils::IsSupportedOptypeVersionAndDomain(*producer, "Add", 7) &&
+      producer->InputDefs().size() == 2 && utils::GetOnlyConsumer(graph, *producer) == &node) {
+    for (int i = 0; i < 2 && qk_matmul == nullptr; ++i) {
+      qk_matmul = GetScoresMatMul(graph, utils::GetInputNode(graph, *producer, i), *producer, scale, scale_node);
+      if (qk_matmul != nullptr && !IsMaskOf(*producer->InputDefs()[1 - i], *producer->OutputDefs()[0])) {
+        qk_matmul = nullptr;
+      }
+      mask_input = 1 - i;
+    }
+    add_mask = producer;
+  }
+  if (qk_matmul == nullptr) {
+    return Status::OK();
+  }
+
+  std::vector<NodeArg*> inputs{qk_matmul->MutableInputDefs()[0], qk_matmul->MutableInputDefs()[1],
+                               output_matmul->MutableInputDefs()[1]};
+  if (add_mask != nullptr) {
+    inputs.push_back(add_mask->MutableInputDefs()[mask_input]);
+  }
+  Node& attention = graph.AddNode(graph.GenerateNodeName("Attention"),
+                                  "Attention",
+                                  "fused attention of " + node.Name(),
+                                  inputs,
+                                  output_matmul->MutableOutputDefs(),
+                                  nullptr,
+                                  kMSDomain);
+  attention.AddAttribute("scale", scale);
+
+  utils::ReplaceNodeInput(graph, attention, 0, *qk_matmul, 0);
+  utils::ReplaceNodeInput(graph, attention, 1, *qk_matmul, 1);
+  utils::ReplaceNodeInput(graph, attention, 2, *output_matmul, 1);
+  if (add_mask != nullptr) {
+    utils::ReplaceNodeInput(graph, attention, 3, *add_mask, mask_input);
+  }
+  utils::MoveOutputEdges(graph, *output_matmul, attention);
+
+  // consumers first, so no edge is left to a removed node
+  for (Node* removed : {output_matmul, &node, add_mask, scale_node, qk_matmul}) {
+    if (removed != nullptr) {
+      graph.RemoveNode(removed->Index());
+    }
+  }
+  modified = true;
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/rewrite_rule.h"
+
+namespace onnxruntime {
+
+// Rewrite rule that replaces the scaled dot product attention of exported transformer models,
+// MatMul(Softmax(Add(Mul(MatMul(Q, K_transposed), scale), mask)), V), with an Attention. The scale may also be a
+// Div, and the Mul or Div and the Add of the mask are optional. It is triggered by the Softmax, which has to be
+// over the last axis. The keys have to be transposed already, which exporters do with a Transpose before the MatMul.
+class FuseAttention : public RewriteRule {
+ public:
+  FuseAttention() noexcept : RewriteRule("FuseAttention", "Fuse the nodes of a scaled dot product attention") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+}  // namespace onnxruntime
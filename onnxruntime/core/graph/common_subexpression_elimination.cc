@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/common_subexpression_elimination.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+namespace {
+
+// ops whose outputs differ from run to run even for the same inputs
+const std::unordered_set<std::string> kNondeterministicOps = {
+    "RandomNormal", "RandomUniform", "RandomNormalLike", "RandomUniformLike", "Multinomial"};
+
+bool IsDeterministic(const Node& node) {
+  return kNondeterministicOps.count(node.OpType()) == 0 && node.GetAttributeNameToMutableSubgraphMap().empty();
+}
+
+// a duplicate must be removable: its consumers read its outputs as explicit inputs, which can be replaced,
+// while the names used by subgraphs and graph outputs can't
+bool CanRemove(const Graph& graph, const Node& node) {
+  if (graph.IsNodeOutputsInGraphOutputs(node)) {
+    return false;
+  }
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() >= static_cast<int>(it->GetNode().InputDefs().size())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the op, attributes and inputs of the node, which are the same for the nodes that compute the same value.
+// the attributes are sorted by name, as their map is unordered.
+std::string GetValueKey(const Node& node) {
+  std::string key = node.Domain() + '\0' + node.OpType() + '\0' + std::to_string(node.OutputDefs().size());
+
+  std::vector<const AttributeProto*> attributes;
+  for (const auto& entry : node.GetAttributes()) {
+    attributes.push_back(&entry.second);
+  }
+  std::sort(attributes.begin(), attributes.end(),
+            [](const AttributeProto* a, const AttributeProto* b) { return a->name() < b->name(); });
+  for (const AttributeProto* attribute : attributes) {
+    key += '\0';
+    key += attribute->SerializeAsString();
+  }
+
+  // the NodeArg names are unique in the graph, and empty for missing optional inputs
+  for (const NodeArg* input_def : node.InputDefs()) {
+    key += '\0';
+    key += input_def->Exists() ? input_def->Name() : std::string();
+  }
+  return key;
+}
+
+// makes the consumers of duplicate read the outputs of original, and removes duplicate
+void MergeInto(Graph& graph, Node& duplicate, Node& original) {
+  const std::vector<Node::EdgeEnd> output_edges(duplicate.OutputEdgesBegin(), duplicate.OutputEdgesEnd());
+  for (const auto& edge : output_edges) {
+    Node& consumer = *graph.GetNode(edge.GetNode().Index());
+    graph.RemoveEdge(duplicate.Index(), consumer.Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+    consumer.MutableInputDefs()[edge.GetDstArgIndex()] = original.MutableOutputDefs()[edge.GetSrcArgIndex()];
+    graph.AddEdge(original.Index(), consumer.Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+  }
+  graph.RemoveNode(duplicate.Index());
+}
+
+}  // namespace
+
+Status CommonSubexpressionElimination::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  GraphViewer graph_viewer(graph);
+  // copied, as the order is invalidated by the nodes removed below
+  const std::vector<NodeIndex> order = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the first node computing each value
+  std::unordered_map<std::string, NodeIndex> values;
+  for (NodeIndex index : order) {
+    Node* node = graph.GetNode(index);
+    if (node == nullptr || !IsDeterministic(*node)) {
+      continue;
+    }
+
+    // the inputs of the node already refer to the outputs of the nodes kept, so its key is final
+    auto result = values.emplace(GetValueKey(*node), index);
+    if (result.second || !CanRemove(graph, *node)) {
+      continue;
+    }
+
+    MergeInto(graph, *node, *graph.GetNode(result.first->second));
+    modified = true;
+  }
+
+  if (modified) {
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+// Merges the nodes that compute the same value: the same op and domain with the same attributes on the same
+// inputs, e.g. a Cast or Shape of one tensor in several branches. The consumers of a duplicate read the outputs of
+// the first such node instead. As the consumers are visited in topological order, the nodes that only become
+// duplicates once their inputs are merged are merged too.
+// Nondeterministic ops, nodes with subgraphs and nodes that produce graph outputs are never removed.
+class CommonSubexpressionElimination : public onnxruntime::GraphTransformer {
+ public:
+  CommonSubexpressionElimination() noexcept
+      : onnxruntime::GraphTransformer("CommonSubexpressionElimination", "Merge nodes that compute the same value") {}
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+};
+
+}  // namespace onnxruntime
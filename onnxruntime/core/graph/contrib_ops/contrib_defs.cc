@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <numeric>
+
 #include "core/graph/constants.h"
 #include "core/graph/contrib_ops/attn_lstm_schema_defs.h"
 #include "core/graph/contrib_ops/contrib_defs.h"
@@ -219,6 +221,16 @@ void convPoolShapeInference(
   }
 }
 
+void nchwcShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, bool use_dilation, bool require_kernel_shape) {
+  ONNX_NAMESPACE::convPoolTypeAndShapeInference(ctx, use_dilation, require_kernel_shape);
+
+  // The blocked channel count depends on the NCHWc block size of the platform,
+  // so it is left unknown.
+  if (hasNInputShapes(ctx, 1) && ctx.getOutputType(0)->tensor_type().shape().dim_size() > 1) {
+    ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape()->mutable_dim(1)->clear_dim_value();
+  }
+}
+
 void RegisterContribSchemas() {
   ONNX_CONTRIB_OPERATOR_SCHEMA(SampleOp)
       .SetDomain(kMSDomain)
@@ -336,6 +348,121 @@ activation.)DOC")
         ONNX_NAMESPACE::convPoolTypeAndShapeInference(ctx, false, true);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ReorderInput)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+For internal use. Reorders a 4D tensor from the NCHW format to the blocked NCHWc format. The channel
+count is padded with zeroes to a multiple of the block size.)DOC")
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("Input tensor must have rank 4.");
+        }
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < input_shape.dim_size(); i++) {
+          auto* dim = output_shape->add_dim();
+          if (i != 1) {
+            *dim = input_shape.dim(i);
+          }
+        }
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ReorderOutput)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+For internal use. Reorders a 4D tensor from the blocked NCHWc format to the NCHW format. The padding
+channels beyond the channels attribute are discarded.)DOC")
+      .Attr("channels", "The number of channels of the output tensor.", AttributeProto::INT)
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("Input tensor must have rank 4.");
+        }
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < input_shape.dim_size(); i++) {
+          auto* dim = output_shape->add_dim();
+          if (i != 1) {
+            *dim = input_shape.dim(i);
+          } else {
+            dim->set_dim_value(getAttribute(ctx, "channels", 0));
+          }
+        }
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcConv)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+For internal use. The NchwcConv operator is the same as FusedConv besides the input X and the output Y
+are 4D tensors in the blocked NCHWc format. W and B have the same shapes as for Conv.)DOC")
+      .Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"))
+      .Attr("kernel_shape", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("dilations", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("strides", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("pads", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("group", "", AttributeProto::INT, static_cast<int64_t>(1))
+      .Attr("activation", "", AttributeProto::STRING, OPTIONAL)
+      .Attr("alpha", "", AttributeProto::FLOAT, OPTIONAL)
+      .Input(0, "X", "", "T")
+      .Input(1, "W", "", "T")
+      .Input(2, "B", "", "T", OpSchema::Optional)
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        nchwcShapeInference(ctx, true, false);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcMaxPool)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+For internal use. The NchwcMaxPool operator is the same as MaxPool besides the input X and the output Y
+are 4D tensors in the blocked NCHWc format.)DOC")
+      .Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"))
+      .Attr("kernel_shape", "", AttributeProto::INTS)
+      .Attr("pads", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("strides", "", AttributeProto::INTS, OPTIONAL)
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        nchwcShapeInference(ctx, false, true);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcAveragePool)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+For internal use. The NchwcAveragePool operator is the same as AveragePool besides the input X and the
+output Y are 4D tensors in the blocked NCHWc format.)DOC")
+      .Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"))
+      .Attr("kernel_shape", "", AttributeProto::INTS)
+      .Attr("pads", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("strides", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("count_include_pad", "", AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        nchwcShapeInference(ctx, false, true);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(FusedGemm)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -426,6 +553,33 @@ activation and leaky_relu_alpha.)DOC")
         }
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedElementwise)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+For internal use. Evaluates a chain of element-wise ops with multidirectional broadcasting in one pass.
+Operand i of an op refers to input i when i is less than the number of inputs, otherwise to the result of
+op (i - number of inputs). The result of the last op is the output.)DOC")
+      .Attr("ops", "Op types of the fused nodes in evaluation order.", AttributeProto::STRINGS)
+      .Attr("operands", "Two operands for each op. The second operand of a unary op is -1.", AttributeProto::INTS)
+      .Input(0, "inputs", "", "T", OpSchema::Variadic)
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float16)", "tensor(float)", "tensor(double)"},
+                      "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, static_cast<int>(ctx.getNumInputs()))) {
+          return;
+        }
+        ONNX_NAMESPACE::TensorShapeProto output_shape = getInputShape(ctx, 0);
+        for (size_t i = 1; i < ctx.getNumInputs(); ++i) {
+          ONNX_NAMESPACE::TensorShapeProto shape;
+          bidirectionalBroadcastShapeInference(output_shape, getInputShape(ctx, i), shape);
+          output_shape = shape;
+        }
+        *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape() = output_shape;
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ExpandDims)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1180,6 +1334,215 @@ Example 4:
   the value of the sampled locations are computed directly
   through bilinear interpolation.)DOC");
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(LayerNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Normalizes each slice of the input over the dimensions from axis to the last one, to zero mean and unit variance,
+then scales and shifts it: Y = (X - mean) / sqrt(variance + epsilon) * Scale + B.
+The fusion of the ReduceMean, Sub, Pow, ReduceMean, Add, Sqrt, Div, Mul and Add nodes of exported models.)DOC")
+      .Attr("axis", "The first normalized dimension. Negative values count from the back.", AttributeProto::INT,
+            static_cast<int64_t>(-1))
+      .Attr("epsilon", "The value added to the variance to avoid a division by zero.", AttributeProto::FLOAT, 1e-5f)
+      .Input(0, "X", "Input data tensor.", "T")
+      .Input(1, "Scale", "Scale, with as many elements as a normalized slice of X.", "T")
+      .Input(2, "B", "Bias, with as many elements as a normalized slice of X.", "T", OpSchema::Optional)
+      .Output(0, "Y", "Output data tensor of the shape of X.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Gelu)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Gaussian error linear unit: Y = 0.5 * X * (1 + erf(X / sqrt(2))).
+The fusion of the Div, Erf, Add, Mul and Mul nodes of exported models.)DOC")
+      .Input(0, "X", "Input data tensor.", "T")
+      .Output(0, "Y", "Output data tensor of the shape of X.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Attention)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Scaled dot product attention: Y = MatMul(Softmax(scale * MatMul(Q, K_transposed) + mask), V), with the softmax over
+the last dimension. The leading dimensions broadcast like in MatMul, e.g. over the batch and the heads.
+The fusion of the MatMul, Mul or Div, Add, Softmax and MatMul nodes of exported models.)DOC")
+      .Attr("scale", "The factor of the dot products.", AttributeProto::FLOAT, 1.0f)
+      .Input(0, "Q", "The queries, of shape (..., sequence_length, head_size).", "T")
+      .Input(1, "K_transposed", "The transposed keys, of shape (..., head_size, kv_sequence_length).", "T")
+      .Input(2, "V", "The values, of shape (..., kv_sequence_length, v_head_size).", "T")
+      .Input(3, "mask",
+             "Added to the scaled dot products, which it must broadcast to without changing their shape, e.g. "
+             "(batch_size, 1, 1, kv_sequence_length) with large negative values for the padding.",
+             "T", OpSchema::Optional)
+      .Output(0, "Y", "The attention output, of shape (..., sequence_length, v_head_size).", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 2)) {
+          return;
+        }
+        auto& q_shape = getInputShape(ctx, 0);
+        auto& v_shape = getInputShape(ctx, 2);
+        if (q_shape.dim_size() < 2 || q_shape.dim_size() != v_shape.dim_size()) {
+          return;
+        }
+        ONNX_NAMESPACE::TensorShapeProto output_shape = q_shape;
+        *output_shape.mutable_dim(q_shape.dim_size() - 1) = v_shape.dim(v_shape.dim_size() - 1);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(EmbeddingBag)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Pooled embedding lookup: the sum or the mean of the rows of data selected by each bag of indices, computed without
+gathering the rows into an intermediate tensor. The bags are the last dimension of indices or, when lengths is given,
+consecutive runs of lengths[i] of the 1-D indices.
+The fusion of a Gather over axis 0 and a ReduceSum or ReduceMean over the last dimension of its indices.
+The rows are accumulated and returned in float. A float16 table halves the memory read, and a uint8 table quarters
+it with rows quantized row-wise: row r is scales[r] * data[r] + biases[r].)DOC")
+      .Attr("mode", "How the rows of a bag are combined, 'sum' or 'mean'. The mean of an empty bag is 0.",
+            AttributeProto::STRING, std::string("sum"))
+      .Input(0, "data", "The table, of rank r >= 1, whose rows are indexed by its first dimension.", "T")
+      .Input(1, "indices", "The rows of the bags, in [0, data.shape[0]). Of rank q >= 1, or 1 with lengths.", "Tind")
+      .Input(2, "lengths", "The number of indices of each bag, of shape (num_bags), which sum to the number of indices.",
+             "Tind", OpSchema::Optional)
+      .Input(3, "scales", "The scales of the rows of a uint8 table, of shape (data.shape[0]).", "tensor(float)",
+             OpSchema::Optional)
+      .Input(4, "biases", "The biases of the rows of a uint8 table, of shape (data.shape[0]).", "tensor(float)",
+             OpSchema::Optional)
+      .Output(0, "output",
+              "The pooled rows, of shape indices.shape[:-1] + data.shape[1:], or (num_bags) + data.shape[1:] with "
+              "lengths.",
+              "tensor(float)")
+      .TypeConstraint("T", {"tensor(float)", "tensor(float16)", "tensor(uint8)"},
+                      "Constrain the table to float, or to float16 and row-wise quantized uint8 storage.")
+      .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices and lengths to integer types.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ctx.getOutputType(0)->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto::FLOAT);
+        const bool has_lengths = ctx.getNumInputs() > 2 && ctx.getInputType(2) != nullptr;
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, has_lengths ? 2 : 1)) {
+          return;
+        }
+        auto& data_shape = getInputShape(ctx, 0);
+        auto& bags_shape = getInputShape(ctx, has_lengths ? 2 : 1);
+        if (data_shape.dim_size() < 1 || bags_shape.dim_size() < 1) {
+          fail_shape_inference("data and indices of EmbeddingBag must have a rank of at least 1.");
+        }
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        // the lengths are one per bag, the last dim of the indices is the bags
+        for (int i = 0; i < bags_shape.dim_size() - (has_lengths ? 0 : 1); ++i) {
+          *output_shape.add_dim() = bags_shape.dim(i);
+        }
+        for (int i = 1; i < data_shape.dim_size(); ++i) {
+          *output_shape.add_dim() = data_shape.dim(i);
+        }
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FeaturePipeline)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+The fusion of a chain of the ai.onnx.ml preprocessing ops Imputer, Scaler, Normalizer and Binarizer, optionally led by
+a FeatureVectorizer, which runs all the steps on a row while it is in cache instead of writing a tensor per step.
+The rows are the last dimension of a 1-D or 2-D X, or with inputdimensions the rows FeatureVectorizer concatenates
+from the inputs. The parameters of each step are step_value_counts[i] consecutive step_values:
+  Imputer: replaced_value_float followed by imputed_value_floats
+  Scaler: offset followed by scale
+  Binarizer: threshold
+  Normalizer: none, its norm is the next of norms
+Per-feature parameters are either of the row length or of length 1.)DOC")
+      .Attr("steps", "The ops of the chain after the FeatureVectorizer, in order.", AttributeProto::STRINGS)
+      .Attr("step_values", "The parameters of the steps, concatenated.", AttributeProto::FLOATS, OPTIONAL)
+      .Attr("step_value_counts", "The number of step_values of each step.", AttributeProto::INTS)
+      .Attr("norms", "The norm of each Normalizer step, 'MAX', 'L1' or 'L2'.", AttributeProto::STRINGS, OPTIONAL)
+      .Attr("inputdimensions", "The features of each input, as of a FeatureVectorizer. Without it X is one input.",
+            AttributeProto::INTS, OPTIONAL)
+      .Input(0, "X", "The features, or with inputdimensions the inputs of the FeatureVectorizer.", "T",
+             OpSchema::Variadic)
+      .Output(0, "Y", "The preprocessed features.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain the features to float.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        std::vector<int64_t> input_dimensions;
+        if (!getRepeatedAttribute(ctx, "inputdimensions", input_dimensions)) {
+          if (hasInputShape(ctx, 0)) {
+            propagateShapeFromInputToOutput(ctx, 0, 0);
+          }
+          return;
+        }
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        if (hasInputShape(ctx, 0) && getInputShape(ctx, 0).dim_size() > 1) {
+          *output_shape.add_dim() = getInputShape(ctx, 0).dim(0);
+        } else {
+          output_shape.add_dim()->set_dim_value(1);
+        }
+        output_shape.add_dim()->set_dim_value(
+            std::accumulate(input_dimensions.begin(), input_dimensions.end(), static_cast<int64_t>(0)));
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ImagePreprocess)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Converts uint8 images in the NHWC layout to normalized float images in the NCHW layout in one pass:
+Y[n, c, h, w] = X[n, top + h, left + w, c] * scale[c] + bias[c].
+The region of the images that is kept is selected by border and crop_size like in Crop.
+The fusion of the Cast, Sub, Div, Mul, Add, ImageScaler, Transpose and Crop nodes at the input of vision models.)DOC")
+      .Attr("scale", "The factor of each channel, or a single one for all.", AttributeProto::FLOATS, OPTIONAL)
+      .Attr("bias", "The offset of each channel, or a single one for all.", AttributeProto::FLOATS, OPTIONAL)
+      .Attr("border", "The borders removed from the images: (left, top, right, bottom).", AttributeProto::INTS,
+            OPTIONAL)
+      .Attr("crop_size", "The size of the kept region from the top left border: (height, width).",
+            AttributeProto::INTS, OPTIONAL)
+      .Attr("nchwc", "For internal use. Whether Y is in the blocked NCHWc format of the CPU execution provider.",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(0, "X", "The images, of shape (N, H, W, C).", "T1")
+      .Output(0, "Y", "The normalized images, of shape (N, C, H', W').", "T2")
+      .TypeConstraint("T1", {"tensor(uint8)"}, "Constrain the images to uint8.")
+      .TypeConstraint("T2", {"tensor(float)"}, "Constrain the normalized images to float.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ctx.getOutputType(0)->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto::FLOAT);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("Input tensor must have rank 4.");
+        }
+        std::vector<int64_t> border;
+        std::vector<int64_t> crop_size;
+        const bool has_border = getRepeatedAttribute(ctx, "border", border);
+        const bool has_crop_size = getRepeatedAttribute(ctx, "crop_size", crop_size);
+        if ((has_border && border.size() != 4) || (has_crop_size && (!has_border || crop_size.size() != 2))) {
+          fail_shape_inference("border needs four elements and crop_size two, which apply from the border.");
+        }
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        *output_shape.add_dim() = input_shape.dim(0);
+        auto* channels = output_shape.add_dim();
+        auto* nchwc_attr = ctx.getAttribute("nchwc");
+        if (nchwc_attr == nullptr || nchwc_attr->i() == 0) {
+          // padded to the block size in the NCHWc format
+          *channels = input_shape.dim(3);
+        }
+        for (int i = 0; i < 2; ++i) {
+          auto* dim = output_shape.add_dim();
+          if (has_crop_size) {
+            dim->set_dim_value(crop_size[i]);
+          } else if (input_shape.dim(1 + i).has_dim_value()) {
+            // border is (left, top, right, bottom) and the dims are (height, width)
+            const int64_t removed = has_border ? border[1 - i] + border[3 - i] : 0;
+            dim->set_dim_value(input_shape.dim(1 + i).dim_value() - removed);
+          }
+        }
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
 #ifdef MICROSOFT_INTERNAL
   // register internal ops
   RegisterInternalSchemas();
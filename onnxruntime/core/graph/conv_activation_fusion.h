@@ -4,13 +4,28 @@
 #pragma once
 
 #include "core/graph/graph_transformer.h"
+#include "core/graph/rewrite_rule.h"
 
 namespace onnxruntime {
 
-class ConvActivationFusion : public onnxruntime::GraphTransformer {
+// Rewrite rule that replaces a Conv and the activation following it with a FusedConv.
+class FuseConvActivation : public RewriteRule {
  public:
-  ConvActivationFusion() noexcept : onnxruntime::GraphTransformer("ConvActivationFusion", "Fusing Activation into Conv") {}
-  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+  FuseConvActivation() noexcept : RewriteRule("FuseConvActivation", "Fuse Activation into Conv") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+// Applies FuseConvActivation on its own; the default transformers combine it with the other rules of their level.
+class ConvActivationFusion : public onnxruntime::TopDownRuleBasedTransformer {
+ public:
+  ConvActivationFusion()
+      : onnxruntime::TopDownRuleBasedTransformer("ConvActivationFusion", "Fusing Activation into Conv") {
+    Register("Conv", std::make_unique<FuseConvActivation>());
+  }
 };
 
 }  // namespace onnxruntime
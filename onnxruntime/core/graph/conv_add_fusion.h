@@ -4,13 +4,28 @@
 #pragma once
 
 #include "core/graph/graph_transformer.h"
+#include "core/graph/rewrite_rule.h"
 
 namespace onnxruntime {
 
-class ConvAddFusion : public onnxruntime::GraphTransformer {
-public:
-  ConvAddFusion() noexcept : onnxruntime::GraphTransformer("ConvAddFusion", "Fusing Add into Conv") {}
-  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+// Rewrite rule for a Conv that folds the Add of a per-channel initializer following it into its bias.
+class FuseConvAdd : public RewriteRule {
+ public:
+  FuseConvAdd() noexcept : RewriteRule("FuseConvAdd", "Fuse Add into Conv") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+// Applies FuseConvAdd on its own; the default transformers combine it with the other rules of their level.
+class ConvAddFusion : public onnxruntime::TopDownRuleBasedTransformer {
+ public:
+  ConvAddFusion()
+      : onnxruntime::TopDownRuleBasedTransformer("ConvAddFusion", "Fusing Add into Conv") {
+    Register("Conv", std::make_unique<FuseConvAdd>());
+  }
 };
 
 }  // namespace onnxruntime
@@ -4,12 +4,28 @@
 #pragma once
 
 #include "core/graph/graph_transformer.h"
+#include "core/graph/rewrite_rule.h"
 
 namespace onnxruntime {
 
-class ConvBNFusion : public onnxruntime::GraphTransformer {
+// Rewrite rule for a Conv that folds the BatchNormalization following it into its weights and bias.
+class FuseConvBN : public RewriteRule {
  public:
-  ConvBNFusion() noexcept : onnxruntime::GraphTransformer("ConvBNFusion", "Fusing BN into Conv") {}
-  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+  FuseConvBN() noexcept : RewriteRule("FuseConvBN", "Fuse BatchNormalization into Conv") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+// Applies FuseConvBN on its own; the default transformers combine it with the other rules of their level.
+class ConvBNFusion : public onnxruntime::TopDownRuleBasedTransformer {
+ public:
+  ConvBNFusion()
+      : onnxruntime::TopDownRuleBasedTransformer("ConvBNFusion", "Fusing BN into Conv") {
+    Register("Conv", std::make_unique<FuseConvBN>());
+  }
 };
+
 }  // namespace onnxruntime
@@ -2,14 +2,30 @@
 // Licensed under the MIT License.
 
 #pragma once
+
 #include "core/graph/graph_transformer.h"
+#include "core/graph/rewrite_rule.h"
 
 namespace onnxruntime {
 
-class ConvMulFusion : public onnxruntime::GraphTransformer {
+// Rewrite rule for a Conv that folds the Mul of a per-channel initializer following it into its weights and bias.
+class FuseConvMul : public RewriteRule {
+ public:
+  FuseConvMul() noexcept : RewriteRule("FuseConvMul", "Fuse Mul into Conv") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+// Applies FuseConvMul on its own; the default transformers combine it with the other rules of their level.
+class ConvMulFusion : public onnxruntime::TopDownRuleBasedTransformer {
  public:
-  ConvMulFusion() noexcept : onnxruntime::GraphTransformer("ConvMulFusion", "Fusing Mul into Conv") {}
-  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+  ConvMulFusion()
+      : onnxruntime::TopDownRuleBasedTransformer("ConvMulFusion", "Fusing Mul into Conv") {
+    Register("Conv", std::make_unique<FuseConvMul>());
+  }
 };
 
 }  // namespace onnxruntime
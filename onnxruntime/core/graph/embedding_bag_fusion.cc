@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/embedding_bag_fusion.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+bool FuseEmbeddingBag::SatisfyCondition(const Node& node) {
+  if (!utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSum", 1) &&
+      !utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", 1)) {
+    return false;
+  }
+  // keepdims defaults to 1
+  auto& attributes = node.GetAttributes();
+  auto keepdims = attributes.find("keepdims");
+  auto axes = attributes.find("axes");
+  return keepdims != attributes.end() && keepdims->second.i() == 0 && axes != attributes.end() &&
+         axes->second.ints_size() == 1 && node.GetInputEdgesCount() == 1;
+}
+
+Status FuseEmbeddingBag::Apply(Graph& graph, Node& node, bool& modified) {
+  Node* gather = utils::GetInputNode(graph, node, 0);
+  if (gather == nullptr || !utils::IsSupportedOptypeVersionAndDomain(*gather, "Gather", 1) ||
+      utils::GetOnlyConsumer(graph, *gather) != &node) {
+    return Status::OK();
+  }
+  auto& gather_attributes = gather->GetAttributes();
+  auto gather_axis = gather_attributes.find("axis");
+  if (gather_axis != gather_attributes.end() && gather_axis->second.i() != 0) {
+    return Status::OK();
+  }
+
+  const NodeArg* data = gather->InputDefs()[0];
+  const TensorShapeProto* data_shape = data->Shape();
+  const TensorShapeProto* indices_shape = gather->InputDefs()[1]->Shape();
+  if (data->Type() == nullptr || *data->Type() != "tensor(float)" || indices_shape == nullptr ||
+      indices_shape->dim_size() < 1) {
+    return Status::OK();
+  }
+
+  // the gathered rows are of shape indices.shape + data.shape[1:], so the bags are the last axis of the indices
+  int64_t axis = node.GetAttributes().at("axes").ints(0);
+  if (axis < 0) {
+    if (data_shape == nullptr) {
+      return Status::OK();
+    }
+    axis += indices_shape->dim_size() + data_shape->dim_size() - 1;
+  }
+  if (axis != indices_shape->dim_size() - 1) {
+    return Status::OK();
+  }
+
+  Node& bag = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                            "EmbeddingBag",
+                            "fused pooled lookup of " + gather->Name(),
+                            gather->MutableInputDefs(),
+                            node.MutableOutputDefs(),
+                            nullptr,
+                            kMSDomain);
+  bag.AddAttribute("mode", std::string(node.OpType() == "ReduceMean" ? "mean" : "sum"));
+  for (int input = 0; input < 2; ++input) {
+    utils::ReplaceNodeInput(graph, bag, input, *gather, input);
+  }
+  utils::MoveOutputEdges(graph, node, bag);
+
+  // the consumer first, so no edge is left to a removed node
+  graph.RemoveNode(node.Index());
+  graph.RemoveNode(gather->Index());
+  modified = true;
+  return Status::OK();
+}
+}  // namespace onnxruntime
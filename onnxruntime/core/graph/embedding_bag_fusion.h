@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/rewrite_rule.h"
+
+namespace onnxruntime {
+
+// Rewrite rule that replaces the pooled embedding lookups of recommendation models, ReduceSum or ReduceMean of
+// Gather(table, indices) over the last axis of the indices, with an EmbeddingBag that doesn't gather the rows into an
+// intermediate tensor. It is triggered by the reduction, which must not keep the reduced dim, and the Gather must be
+// over axis 0 of a float table.
+class FuseEmbeddingBag : public RewriteRule {
+ public:
+  FuseEmbeddingBag() noexcept : RewriteRule("FuseEmbeddingBag", "Fuse the Gather and reduction of a pooled lookup") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+}  // namespace onnxruntime
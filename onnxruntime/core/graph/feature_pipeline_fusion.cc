@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/feature_pipeline_fusion.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// the fused steps are the ops the FeaturePipeline kernel implements, with the attributes their own kernels accept
+bool IsFusableStep(const Node& node) {
+  const NodeAttributes& attributes = node.GetAttributes();
+  auto floats = [&attributes](const std::string& name) {
+    auto attr = attributes.find(name);
+    return attr == attributes.end() ? 0 : attr->second.floats_size();
+  };
+
+  if (utils::IsSupportedOptypeVersionAndDomain(node, "Imputer", 1, kMLDomain)) {
+    auto int64s = attributes.find("imputed_value_int64s");
+    return floats("imputed_value_floats") > 0 && (int64s == attributes.end() || int64s->second.ints_size() == 0);
+  }
+  if (utils::IsSupportedOptypeVersionAndDomain(node, "Scaler", 1, kMLDomain)) {
+    return floats("scale") > 0 && floats("scale") == floats("offset");
+  }
+  if (utils::IsSupportedOptypeVersionAndDomain(node, "Normalizer", 1, kMLDomain)) {
+    auto norm = attributes.find("norm");
+    return norm == attributes.end() || norm->second.s() == "MAX" || norm->second.s() == "L1" ||
+           norm->second.s() == "L2";
+  }
+  return utils::IsSupportedOptypeVersionAndDomain(node, "Binarizer", 1, kMLDomain);
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  return arg.Type() != nullptr && *arg.Type() == "tensor(float)";
+}
+
+// the rows of the steps are the last dim of a 1-D or 2-D input
+bool IsMatrix(const NodeArg& arg) {
+  const TensorShapeProto* shape = arg.Shape();
+  return shape != nullptr && shape->dim_size() >= 1 && shape->dim_size() <= 2;
+}
+
+bool IsFeatureVectorizer(const Node& node) {
+  return utils::IsSupportedOptypeVersionAndDomain(node, "FeatureVectorizer", 1, kMLDomain);
+}
+}  // namespace
+
+bool FuseFeaturePipeline::SatisfyCondition(const Node& node) {
+  if (IsFeatureVectorizer(node)) {
+    for (const NodeArg* input : node.InputDefs()) {
+      if (!IsFloatTensor(*input)) {
+        return false;
+      }
+    }
+    return node.GetAttributes().count("inputdimensions") != 0;
+  }
+  return IsFusableStep(node) && IsFloatTensor(*node.InputDefs()[0]) && IsMatrix(*node.InputDefs()[0]);
+}
+
+Status FuseFeaturePipeline::Apply(Graph& graph, Node& node, bool& modified) {
+  std::vector<Node*> chain{&node};
+  for (Node* next = utils::GetOnlyConsumer(graph, node); next != nullptr && IsFusableStep(*next) &&
+                                                          next->InputDefs()[0] == chain.back()->OutputDefs()[0];
+       next = utils::GetOnlyConsumer(graph, *next)) {
+    chain.push_back(next);
+  }
+  if (chain.size() < 2) {
+    return Status::OK();
+  }
+
+  std::vector<std::string> steps;
+  std::vector<std::string> norms;
+  std::vector<float> step_values;
+  std::vector<int64_t> step_value_counts;
+  for (size_t i = IsFeatureVectorizer(node) ? 1 : 0; i < chain.size(); ++i) {
+    const Node& step = *chain[i];
+    const NodeAttributes& attributes = step.GetAttributes();
+    auto add_floats = [&attributes, &step_values](const std::string& name) {
+      const auto& values = attributes.at(name).floats();
+      step_values.insert(step_values.end(), values.begin(), values.end());
+    };
+    auto add_float = [&attributes, &step_values](const std::string& name, float default_value) {
+      auto attr = attributes.find(name);
+      step_values.push_back(attr == attributes.end() ? default_value : attr->second.f());
+    };
+
+    const size_t values_begin = step_values.size();
+    if (step.OpType() == "Imputer") {
+      add_float("replaced_value_float", 0.f);
+      add_floats("imputed_value_floats");
+    } else if (step.OpType() == "Scaler") {
+      add_floats("offset");
+      add_floats("scale");
+    } else if (step.OpType() == "Normalizer") {
+      auto norm = attributes.find("norm");
+      norms.push_back(norm == attributes.end() ? "MAX" : norm->second.s());
+    } else {
+      // the default of the Binarizer kernel
+      add_float("threshold", 1.f);
+    }
+    steps.push_back(step.OpType());
+    step_value_counts.push_back(static_cast<int64_t>(step_values.size() - values_begin));
+  }
+
+  Node& pipeline = graph.AddNode(graph.GenerateNodeName("FeaturePipeline"),
+                                 "FeaturePipeline",
+                                 "fused preprocessing of " + node.Name(),
+                                 node.MutableInputDefs(),
+                                 chain.back()->MutableOutputDefs(),
+                                 nullptr,
+                                 kMSDomain);
+  if (IsFeatureVectorizer(node)) {
+    pipeline.AddAttribute("inputdimensions", node.GetAttributes().at("inputdimensions"));
+  }
+  pipeline.AddAttribute("steps", steps);
+  pipeline.AddAttribute("norms", norms);
+  pipeline.AddAttribute("step_values", step_values);
+  pipeline.AddAttribute("step_value_counts", step_value_counts);
+  for (int input = 0; input < static_cast<int>(node.InputDefs().size()); ++input) {
+    utils::ReplaceNodeInput(graph, pipeline, input, node, input);
+  }
+  utils::MoveOutputEdges(graph, *chain.back(), pipeline);
+
+  // the consumers first, so no edge is left to a removed node
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+    graph.RemoveNode((*it)->Index());
+  }
+  modified = true;
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/rewrite_rule.h"
+
+namespace onnxruntime {
+
+// Rewrite rule that replaces the preprocessing of converted scikit-learn pipelines, chains of the ai.onnx.ml
+// Imputer, Scaler, Normalizer and Binarizer optionally led by a FeatureVectorizer, with a FeaturePipeline that runs
+// all the steps on a row while it is in cache instead of writing an intermediate tensor per step. It is triggered by
+// the first node of a chain of at least two float ops, each the only consumer of the one before.
+class FuseFeaturePipeline : public RewriteRule {
+ public:
+  FuseFeaturePipeline() noexcept
+      : RewriteRule("FuseFeaturePipeline", "Fuse a chain of preprocessing ops into one pass over the rows") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/gelu_fusion.h"
+
+#include <cmath>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// the constants of exported models are rounded
+bool IsClose(float value, float expected) {
+  return std::abs(value - expected) <= 1e-4f * std::abs(expected);
+}
+
+// a binary node of op_type that reads value and a single float initializer close to constant. the value of a Div
+// has to be the dividend.
+bool HasConstantOperand(const Graph& graph, const Node& node, const char* op_type, const NodeArg* value,
+                        float constant) {
+  if (!utils::IsSupportedOptypeVersionAndDomain(node, op_type, 7) || node.InputDefs().size() != 2) {
+    return false;
+  }
+  const NodeArg* other = nullptr;
+  if (node.InputDefs()[0] == value) {
+    other = node.InputDefs()[1];
+  } else if (node.InputDefs()[1] == value && node.OpType() != "Div") {
+    other = node.InputDefs()[0];
+  } else {
+    return false;
+  }
+  float operand = 0.0f;
+  return utils::GetScalarInitializerValue(graph, *other, operand) && IsClose(operand, constant);
+}
+
+}  // namespace
+
+bool FuseGelu::SatisfyCondition(const Node& node) {
+  const NodeArg* input = node.InputDefs()[0];
+  return utils::IsSupportedOptypeVersionAndDomain(node, "Erf", 9) && input->Type() != nullptr &&
+         *input->Type() == "tensor(float)" && node.GetInputEdgesCount() == 1;
+}
+
+Status FuseGelu::Apply(Graph& graph, Node& node, bool& modified) {
+  // X / sqrt(2) or X * (1 / sqrt(2))
+  Node* scale = utils::GetInputNode(graph, node, 0);
+  if (scale == nullptr || utils::GetOnlyConsumer(graph, *scale) != &node || scale->InputDefs().size() != 2) {
+    return Status::OK();
+  }
+  NodeArg* x = scale->MutableInputDefs()[0];
+  if (!HasConstantOperand(graph, *scale, "Div", x, 1.41421356f) &&
+      !HasConstantOperand(graph, *scale, "Mul", x, 0.70710678f)) {
+    // X may also be the second input of the Mul
+    x = scale->MutableInputDefs()[1];
+    if (!HasConstantOperand(graph, *scale, "Mul", x, 0.70710678f)) {
+      return Status::OK();
+    }
+  }
+
+  // erf(...) + 1
+  Node* add = utils::GetOnlyConsumer(graph, node);
+  if (add == nullptr || !HasConstantOperand(graph, *add, "Add", node.OutputDefs()[0], 1.0f)) {
+    return Status::OK();
+  }
+
+  // the product with X and 0.5, in either order
+  Node* mul = utils::GetOnlyConsumer(graph, *add);
+  if (mul == nullptr || !utils::IsSupportedOptypeVersionAndDomain(*mul, "Mul", 7) || mul->InputDefs().size() != 2) {
+    return Status::OK();
+  }
+  const NodeArg* other = mul->InputDefs()[0] == add->OutputDefs()[0] ? mul->InputDefs()[1] : mul->InputDefs()[0];
+  Node* last = nullptr;
+  Node* half = nullptr;
+  if (other == x) {
+    last = utils::GetOnlyConsumer(graph, *mul);
+    if (last == nullptr || !HasConstantOperand(graph, *last, "Mul", mul->OutputDefs()[0], 0.5f)) {
+      return Status::OK();
+    }
+  } else {
+    half = utils::GetInputNode(graph, *mul, mul->InputDefs()[0] == other ? 0 : 1);
+    if (half == nullptr || utils::GetOnlyConsumer(graph, *half) != mul ||
+        !HasConstantOperand(graph, *half, "Mul", x, 0.5f)) {
+      return Status::OK();
+    }
+    last = mul;
+  }
+
+  Node& gelu = graph.AddNode(graph.GenerateNodeName("Gelu"),
+                             "Gelu",
+                             "fused GELU of " + node.Name(),
+                             {x},
+                             last->MutableOutputDefs(),
+                             nullptr,
+                             kMSDomain);
+  const int x_input = scale->InputDefs()[0] == x ? 0 : 1;
+  utils::ReplaceNodeInput(graph, gelu, 0, *scale, x_input);
+  utils::MoveOutputEdges(graph, *last, gelu);
+
+  // consumers first, so no edge is left to a removed node
+  if (last != mul) {
+    graph.RemoveNode(last->Index());
+  }
+  graph.RemoveNode(mul->Index());
+  if (half != nullptr) {
+    graph.RemoveNode(half->Index());
+  }
+  for (Node* removed : {add, &node, scale}) {
+    graph.RemoveNode(removed->Index());
+  }
+  modified = true;
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/rewrite_rule.h"
+
+namespace onnxruntime {
+
+// Rewrite rule that replaces the decomposed GELU of exported transformer models with a Gelu. It is triggered by the
+// Erf of Mul(Mul(X, Add(Erf(Div(X, sqrt(2))), 1)), 0.5), and also matches Mul(Mul(X, 0.5), Add(...)) and a
+// Mul by 1 / sqrt(2) instead of the Div.
+class FuseGelu : public RewriteRule {
+ public:
+  FuseGelu() noexcept : RewriteRule("FuseGelu", "Fuse the nodes of a GELU") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+}  // namespace onnxruntime
@@ -4,13 +4,28 @@
 #pragma once
 
 #include "core/graph/graph_transformer.h"
+#include "core/graph/rewrite_rule.h"
 
 namespace onnxruntime {
 
-class GemmActivationFusion : public onnxruntime::GraphTransformer {
+// Rewrite rule that replaces a Gemm and the activation following it with a FusedGemm.
+class FuseGemmActivation : public RewriteRule {
  public:
-  GemmActivationFusion() noexcept : onnxruntime::GraphTransformer("GemmActivationFusion", "Fusing Activation into Gemm") {}
-  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+  FuseGemmActivation() noexcept : RewriteRule("FuseGemmActivation", "Fuse Activation into Gemm") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+// Applies FuseGemmActivation on its own; the default transformers combine it with the other rules of their level.
+class GemmActivationFusion : public onnxruntime::TopDownRuleBasedTransformer {
+ public:
+  GemmActivationFusion()
+      : onnxruntime::TopDownRuleBasedTransformer("GemmActivationFusion", "Fusing Activation into Gemm") {
+    Register("Gemm", std::make_unique<FuseGemmActivation>());
+  }
 };
 
 }  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #pragma warning(disable : 4244)
 #endif
 
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <numeric>
@@ -353,7 +354,7 @@ void Node::Init(const std::string& name,
                 const std::string& description,
                 const std::vector<NodeArg*>& input_args,
                 const std::vector<NodeArg*>& output_args,
-                const NodeAttributes* attributes,
+                NodeAttributes&& attributes,
                 const std::string& domain) {
   name_ = name;
   op_type_ = op_type;
@@ -370,13 +371,11 @@ void Node::Init(const std::string& name,
   // information.
   definitions_.input_arg_count.assign(input_args.size(), 1);
 
-  if (attributes) {
-    attributes_ = *attributes;
+  attributes_ = std::move(attributes);
 
-    for (auto& name_to_attr : attributes_) {
-      if (name_to_attr.second.has_g()) {
-        CreateSubgraph(name_to_attr.first);
-      }
+  for (auto& name_to_attr : attributes_) {
+    if (name_to_attr.second.has_g()) {
+      CreateSubgraph(name_to_attr.first);
     }
   }
 }
@@ -408,6 +407,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 
 void Node::AddAttribute(const std::string& attr_name, const AttributeProto& value) {
   graph_->SetGraphResolveNeeded();
+  inferred_types_signature_.clear();
   graph_->SetGraphProtoSyncNeeded();
   attributes_[attr_name] = value;
 }
@@ -416,6 +416,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inferred_types_signature_.clear();                                       \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -427,6 +428,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inferred_types_signature_.clear();                                       \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -439,6 +441,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
                           const std::vector<type>& values) { \
     graph_->SetGraphResolveNeeded();                         \
     graph_->SetGraphProtoSyncNeeded();                       \
+    inferred_types_signature_.clear();                       \
     AttributeProto a;                                        \
     a.set_name(attr_name);                                   \
     a.set_type(enumType);                                    \
@@ -450,6 +453,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 
 void Node::AddAttribute(const std::string& attr_name, const GraphProto& value) {
   graph_->SetGraphResolveNeeded();
+  inferred_types_signature_.clear();
   graph_->SetGraphProtoSyncNeeded();
   AttributeProto a;
   a.set_name(attr_name);
@@ -472,6 +476,7 @@ ADD_LIST_ATTR_IMPL(GraphProto, AttributeProto_AttributeType::AttributeProto_Attr
 
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
+  inferred_types_signature_.clear();
   graph_->SetGraphProtoSyncNeeded();
   return attributes_.erase(attr_name) > 0;
 }
@@ -620,11 +625,12 @@ Graph::Graph(GraphProto* graph_proto,
 
   // these are all empty unless we received a graph_proto as input
   if (graph_proto != nullptr) {
-    // Copy constant nodes _value to name_to_initial_tensor_
-    for (auto& node : graph_proto_->node()) {
+    // Move constant nodes _value to name_to_initial_tensor_. the nodes are removed below, so their values are
+    // swapped into the initializers rather than copied.
+    for (auto& node : *graph_proto_->mutable_node()) {
       if (node.op_type() == kConstant) {
         const gsl::not_null<TensorProto*> tensor{graph_proto_->add_initializer()};
-        *tensor = node.attribute(0).t();
+        tensor->Swap(node.mutable_attribute(0)->mutable_t());
         *(tensor->mutable_name()) = node.output(0);
 
         // we remove the node and add it as an initializer, but still need it to appear in the
@@ -685,7 +691,7 @@ Graph::Graph(GraphProto* graph_proto,
       }
     }
 
-    for (auto node_proto : graph_proto_->node()) {
+    for (const auto& node_proto : graph_proto_->node()) {
       AddNode(node_proto, name_to_type_map);
     }
   }
@@ -1377,6 +1383,50 @@ Status Graph::InferAndVerifySubgraphTypes(const Node& node, Graph& subgraph,
   return Status::OK();
 }
 
+std::string Graph::InferredTypesSignature(const Node& node) const {
+  // the pointers identify the NodeArgs and their interned types, and a version each initializer. the address of an
+  // initializer doesn't identify it, as one that replaces it under the same name may be allocated where it was.
+  std::string signature;
+  auto append_pointer = [&signature](const void* pointer) {
+    signature += std::to_string(reinterpret_cast<uintptr_t>(pointer));
+    signature += ',';
+  };
+  auto append_shape = [&signature](const NodeArg& def) {
+    const auto* shape = def.Shape();
+    if (shape != nullptr) {
+      for (const auto& dim : shape->dim()) {
+        signature += dim.has_dim_value() ? std::to_string(dim.dim_value()) : "?" + dim.dim_param();
+        signature += ' ';
+      }
+    }
+    signature += ';';
+  };
+
+  for (const auto* input_def : node.InputDefs()) {
+    append_pointer(input_def);
+    append_pointer(input_def->Type());
+    if (name_to_initial_tensor_.find(input_def->Name()) == name_to_initial_tensor_.cend()) {
+      signature += '-';
+    } else {
+      // initializers of the loaded model have no version
+      auto version = initializer_versions_.find(input_def->Name());
+      signature += std::to_string(version != initializer_versions_.cend() ? version->second : 0);
+    }
+    signature += ',';
+    append_shape(*input_def);
+  }
+
+  // the types and shapes of the outputs are part of it too, so that a transformer that edits them has them inferred
+  signature += '|';
+  for (const auto* output_def : node.OutputDefs()) {
+    append_pointer(output_def);
+    append_pointer(output_def->Type());
+    append_shape(*output_def);
+  }
+
+  return signature;
+}
+
 // Implementation of type-inference and type-checking for a single node
 GSL_SUPPRESS(f .23)  // spurious warning about inferred_type never being checked for null
 Status Graph::InferAndVerifyTypeMatch(Node& node, const OpSchema& op) {
@@ -1628,8 +1678,6 @@ Status Graph::VerifyNodeAndOpMatch() {
     // Node verification.
     auto& node = *GetNode(node_index);
 
-    NodeProto node_proto;
-    node.ToProto(node_proto);
     auto& node_name = node.Name();
     auto& domain = node.Domain();
 
@@ -1642,6 +1690,8 @@ Status Graph::VerifyNodeAndOpMatch() {
     }
 
     if (!node.Op()) {
+      NodeProto node_proto;
+      node.ToProto(node_proto);
       try {
         checker::check_node(node_proto, ctx, lsc);
       } catch (const std::exception& ex) {
@@ -1697,11 +1747,22 @@ Status Graph::VerifyNodeAndOpMatch() {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
+    // the outputs are inferred again only when what they were inferred from changed, which after a graph
+    // transformation is the nodes it changed and the nodes downstream of them whose input shapes changed.
+    // nodes with subgraphs are always inferred, as the subgraphs infer their outputs.
+    const bool has_subgraphs = !node.MutableSubgraphs().empty();
+    if (has_subgraphs || node.inferred_types_signature_.empty() ||
+        node.inferred_types_signature_ != InferredTypesSignature(node)) {
+      node.inferred_types_signature_.clear();
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
+      if (!has_subgraphs) {
+        node.inferred_types_signature_ = InferredTypesSignature(node);
+      }
+    }
 
     // Accumulate output names of the iterated Node
-    for (auto& output_name : node_proto.output()) {
-      lsc.output_names.insert(output_name);
+    for (const auto* output_def : node.OutputDefs()) {
+      lsc.output_names.insert(output_def->Name());
     }
   }
 
@@ -1886,6 +1947,7 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   const gsl::not_null<TensorProto*> tensor_added{graph_proto_->add_initializer()};
   *(tensor_added) = tensor;
   name_to_initial_tensor_[tensor.name()] = tensor_added;
+  initializer_versions_[tensor.name()] = ++last_initializer_version_;
 
   if (!GraphLoadedFromModelFile(graph_proto_)) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs will add it to the graph inputs
@@ -1906,6 +1968,7 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   auto iter = name_to_initial_tensor_.find(tensor_name);
   if (name_to_initial_tensor_.end() != iter) {
     name_to_initial_tensor_.erase(tensor_name);
+    initializer_versions_.erase(tensor_name);
     SetGraphProtoSyncNeeded();
     SetGraphResolveNeeded();
   }
@@ -1921,8 +1984,24 @@ bool Graph::GetInitializedTensor(const std::string& tensor_name, const TensorPro
   return true;
 }
 
+void Graph::ReleaseInitializedTensorData(const std::string& tensor_name) {
+  auto iter = name_to_initial_tensor_.find(tensor_name);
+  if (name_to_initial_tensor_.end() == iter) {
+    return;
+  }
+
+  // clearing the data fields keeps their memory, so the data is swapped out into a proto that is destroyed
+  TensorProto stripped;
+  stripped.set_name(iter->second->name());
+  stripped.set_data_type(iter->second->data_type());
+  *stripped.mutable_dims() = iter->second->dims();
+  // the proto is the initializer of graph_proto_, so it needs no sync
+  const_cast<TensorProto*>(iter->second)->Swap(&stripped);
+}
+
 void Graph::CleanAllInitializedTensors() noexcept {
   name_to_initial_tensor_.clear();
+  initializer_versions_.clear();
   removed_initializer_indexes_.clear();
 
   // Clearing RepeatedPtrFields does not free objects' memory. The memory is retained
@@ -1997,7 +2076,7 @@ Node& Graph::AddNode(const NodeProto& node_proto,
                  node_proto.doc_string(),
                  input_defs,
                  output_defs,
-                 &attributes,
+                 std::move(attributes),
                  node_proto.domain());
 }
 
@@ -2035,6 +2114,17 @@ Node& Graph::AddNode(const std::string& name,
                      const std::vector<NodeArg*>& output_args,
                      const NodeAttributes* attributes,
                      const std::string& domain) {
+  return AddNode(name, op_type, description, input_args, output_args,
+                 attributes != nullptr ? NodeAttributes(*attributes) : NodeAttributes(), domain);
+}
+
+Node& Graph::AddNode(const std::string& name,
+                     const std::string& op_type,
+                     const std::string& description,
+                     const std::vector<NodeArg*>& input_args,
+                     const std::vector<NodeArg*>& output_args,
+                     NodeAttributes&& attributes,
+                     const std::string& domain) {
   std::vector<NodeArg*> inputs, outputs;
   inputs.resize(input_args.size());
   outputs.resize(output_args.size());
@@ -2048,7 +2138,7 @@ Node& Graph::AddNode(const std::string& name,
   }
 
   const gsl::not_null<Node*> node = AllocateNode();
-  node->Init(name, op_type, description, inputs, outputs, attributes, domain);
+  node->Init(name, op_type, description, inputs, outputs, std::move(attributes), domain);
   if (0 != op_type.compare(kNoOp)) {
     graph_proto_sync_needed_ = true;
   }
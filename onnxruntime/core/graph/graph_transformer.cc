@@ -3,15 +3,13 @@
 
 #include "core/graph/graph_transformer.h"
 
+#include <deque>
+
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
 Status RuleBasedGraphTransformer::Register(const std::string& op_type, std::unique_ptr<RewriteRule> rule) {
-  if (HasRules(op_type)) {
-    op_to_rules_[op_type] = std::vector<std::unique_ptr<RewriteRule>>();
-  }
-
   op_to_rules_[op_type].push_back(std::move(rule));
   return Status::OK();
 }
@@ -21,11 +19,32 @@ Status TopDownRuleBasedTransformer::Apply(Graph& graph, bool& modified) const {
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
 
+  // the nodes to try the rules on, starting with all of them in topological order
+  std::deque<NodeIndex> worklist(order.cbegin(), order.cend());
+  std::vector<bool> queued(graph.MaxNodeIndex(), false);
   for (NodeIndex i : order) {
-    auto node = graph.GetNode(i);
-    if (!node) {
-      return Status(ONNXRUNTIME, INVALID_ARGUMENT);
+    queued[i] = true;
+  }
+  auto enqueue = [&worklist, &queued](NodeIndex i) {
+    if (i >= queued.size()) {
+      queued.resize(i + 1, false);
+    }
+    if (!queued[i]) {
+      queued[i] = true;
+      worklist.push_back(i);
     }
+  };
+
+  std::vector<NodeIndex> neighbors;
+  while (!worklist.empty()) {
+    const NodeIndex i = worklist.front();
+    worklist.pop_front();
+    queued[i] = false;
+
+    // the node may have been removed by a rule applied to another node
+    auto node = graph.GetNode(i);
+    if (!node)
+      continue;
 
     // Get the rules that should be fired for this node.
     const std::vector<std::unique_ptr<RewriteRule>>* rules = GetRewriteRules(node->OpType());
@@ -33,7 +52,31 @@ Status TopDownRuleBasedTransformer::Apply(Graph& graph, bool& modified) const {
       continue;
 
     for (const auto& rule : *rules) {
-      ORT_RETURN_IF_ERROR(rule->CheckConditionAndApply(graph, *node, modified));
+      neighbors.clear();
+      for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+        neighbors.push_back(it->Index());
+      }
+      for (auto it = node->OutputNodesBegin(); it != node->OutputNodesEnd(); ++it) {
+        neighbors.push_back(it->Index());
+      }
+      const auto first_new_index = static_cast<NodeIndex>(graph.MaxNodeIndex());
+
+      bool rule_modified = false;
+      ORT_RETURN_IF_ERROR(rule->CheckConditionAndApply(graph, *node, rule_modified));
+      if (!rule_modified)
+        continue;
+
+      // the node may be gone now, so the remaining rules are tried when it is dequeued again
+      modified = true;
+      enqueue(i);
+      for (NodeIndex neighbor : neighbors) {
+        enqueue(neighbor);
+      }
+      for (NodeIndex new_index = first_new_index; new_index < static_cast<NodeIndex>(graph.MaxNodeIndex());
+           ++new_index) {
+        enqueue(new_index);
+      }
+      break;
     }
   }
 
@@ -2,11 +2,81 @@
 // Licensed under the MIT License.
 
 #include "core/graph/graph_transformer_mgr.h"
+#include "core/graph/attention_fusion.h"
+#include "core/graph/common_subexpression_elimination.h"
+#include "core/graph/conv_activation_fusion.h"
+#include "core/graph/conv_add_fusion.h"
+#include "core/graph/conv_bn_fusion.h"
+#include "core/graph/conv_mul_fusion.h"
+#include "core/graph/embedding_bag_fusion.h"
+#include "core/graph/feature_pipeline_fusion.h"
+#include "core/graph/gelu_fusion.h"
+#include "core/graph/gemm_activation_fusion.h"
+#include "core/graph/identity_elimination.h"
+#include "core/graph/image_preprocess_fusion.h"
+#include "core/graph/layer_norm_fusion.h"
+#include "core/graph/loop_unrolling.h"
+#include "core/graph/matmul_add_fusion.h"
+#include "core/graph/nchwc_transformer.h"
+#include "core/graph/qlinear_fusion.h"
+#include "core/graph/symbolic_shape_folding.h"
+#include "core/graph/transpose_optimizer.h"
+#include "core/graph/unsqueeze_elimination.h"
 using namespace onnxruntime;
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
+void GraphTransformerManager::RegisterDefaultTransformers(TransformerLevel level) {
+  // the rules of a level are combined in one transformer, which looks each node up by op type and revisits the
+  // neighbours of what a rule changed, so the rules reach their fixed point in a single Apply
+  if (level >= TransformerLevel::Basic) {
+    auto rule_transformer = std::make_unique<TopDownRuleBasedTransformer>("EliminationTransformer",
+                                                                          "Eliminate redundant nodes");
+    rule_transformer->Register("Identity", std::make_unique<EliminateIdentity>());
+    rule_transformer->Register("Unsqueeze", std::make_unique<EliminateUnsqueeze>());
+    transformers_.push_back(std::move(rule_transformer));
+    // before TransposeOptimizer, so the Transposes of a tensor in several branches are one it can cancel
+    transformers_.push_back(std::make_unique<CommonSubexpressionElimination>());
+    // before TransposeOptimizer, which removes the Reshapes whose folded shape turns out to be their input shape
+    transformers_.push_back(std::make_unique<SymbolicShapeFolding>());
+    transformers_.push_back(std::make_unique<TransposeOptimizer>());
+  }
+
+  if (level >= TransformerLevel::Extended) {
+    // first, so the fusions apply to the nodes of the unrolled iterations
+    transformers_.push_back(std::make_unique<LoopUnrolling>());
+    auto rule_transformer = std::make_unique<TopDownRuleBasedTransformer>("FusionTransformer",
+                                                                          "Fuse nodes into their producers");
+    // BatchNormalization is folded before Mul and Add, whose initializers it may follow
+    rule_transformer->Register("Conv", std::make_unique<FuseConvBN>());
+    rule_transformer->Register("Conv", std::make_unique<FuseConvMul>());
+    rule_transformer->Register("Conv", std::make_unique<FuseConvAdd>());
+    rule_transformer->Register("MatMul", std::make_unique<FuseMatMulAdd>());
+    if (level >= TransformerLevel::All) {
+      // last for Conv, as the FusedConv it produces is not matched by the other rules
+      rule_transformer->Register("Conv", std::make_unique<FuseConvActivation>());
+      rule_transformer->Register("Gemm", std::make_unique<FuseGemmActivation>());
+      rule_transformer->Register("ReduceMean", std::make_unique<FuseLayerNorm>());
+      rule_transformer->Register("Erf", std::make_unique<FuseGelu>());
+      rule_transformer->Register("Softmax", std::make_unique<FuseAttention>());
+      rule_transformer->Register("ReduceSum", std::make_unique<FuseEmbeddingBag>());
+      rule_transformer->Register("ReduceMean", std::make_unique<FuseEmbeddingBag>());
+      rule_transformer->Register("QuantizeLinear", std::make_unique<FuseQLinear>());
+      rule_transformer->Register("Cast", std::make_unique<FuseImagePreprocess>());
+      for (const char* op_type : {"FeatureVectorizer", "Imputer", "Scaler", "Normalizer", "Binarizer"}) {
+        rule_transformer->Register(op_type, std::make_unique<FuseFeaturePipeline>());
+      }
+    }
+    transformers_.push_back(std::move(rule_transformer));
+  }
+
+  if (level >= TransformerLevel::All) {
+    // after the activation fusions, as it converts the FusedConv nodes they produce
+    transformers_.push_back(std::make_unique<NchwcTransformer>());
+  }
+}
+
 Status GraphTransformerManager::ApplyAll(Graph& graph) const {
   for (unsigned step = 0; step < steps_; ++step) {
     bool changed = false;
@@ -4,14 +4,16 @@
 #pragma once
 
 #include "core/graph/graph_transformer.h"
+#include "core/graph/transformer_level.h"
 
 namespace onnxruntime {
-// Manages a list of graph transformers. It is initialized with a list of graph
-// transformers. Each inference session can further register additional ones.
+// Manages a list of graph transformers. It is initialized with the default graph
+// transformers of the given level. Each inference session can further register additional ones.
 class GraphTransformerManager {
  public:
-  explicit GraphTransformerManager(unsigned steps) noexcept : steps_(steps) {
-    // TODO: Register default transformers.
+  explicit GraphTransformerManager(unsigned steps, TransformerLevel level = TransformerLevel::None)
+      : steps_(steps) {
+    RegisterDefaultTransformers(level);
   }
 
   // Register a graph transformer.
@@ -26,6 +28,8 @@ class GraphTransformerManager {
 
  private:
   GraphTransformerManager() = default;
+  void RegisterDefaultTransformers(TransformerLevel level);
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphTransformerManager);
 
   std::vector<std::unique_ptr<GraphTransformer>> transformers_;
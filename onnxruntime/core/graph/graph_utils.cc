@@ -1,5 +1,6 @@
 
 #include "core/graph/graph_utils.h"
+#include "core/graph/initializer.h"
 
 namespace onnxruntime {
 
@@ -9,7 +10,8 @@ bool IsSupportedOptypeVersionAndDomain(const Node& node,
                                        const std::string& op_type,
                                        ONNX_NAMESPACE::OperatorSetVersion version,
                                        const std::string& domain) {
-  if (node.OpType() != op_type ||
+  // nodes added since the graph was resolved have no schema yet
+  if (node.OpType() != op_type || node.Op() == nullptr ||
       node.Op()->Deprecated() || node.Op()->SinceVersion() != version ||
       (!node.Domain().empty() && node.Domain() != domain)) {
     return false;
@@ -17,6 +19,86 @@ bool IsSupportedOptypeVersionAndDomain(const Node& node,
   return true;
 }
 
+bool CanRemoveNode(Graph& graph, const Node& node) {
+  if (graph.IsNodeOutputsInGraphOutputs(node)) {
+    return false;
+  }
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (it->GetSrcArgIndex() != 0 || it->GetDstArgIndex() >= static_cast<int>(it->GetNode().InputDefs().size())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ReplaceNodeInput(Graph& graph, Node& node, int input_index, Node& source, int source_input_index) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == input_index) {
+      graph.RemoveEdge(it->GetNode().Index(), node.Index(), it->GetSrcArgIndex(), input_index);
+      break;
+    }
+  }
+
+  node.MutableInputDefs()[input_index] = source.MutableInputDefs()[source_input_index];
+  for (auto it = source.InputEdgesBegin(); it != source.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == source_input_index) {
+      graph.AddEdge(it->GetNode().Index(), node.Index(), it->GetSrcArgIndex(), input_index);
+      break;
+    }
+  }
+  graph.SetGraphResolveNeeded();
+}
+
+void RemoveNodeAndForwardInput(Graph& graph, Node& node) {
+  const std::vector<Node::EdgeEnd> output_edges(node.OutputEdgesBegin(), node.OutputEdgesEnd());
+  for (const auto& edge : output_edges) {
+    ReplaceNodeInput(graph, *graph.GetNode(edge.GetNode().Index()), edge.GetDstArgIndex(), node, 0);
+  }
+  graph.RemoveNode(node.Index());
+}
+
+void MoveOutputEdges(Graph& graph, Node& from, Node& to) {
+  const std::vector<Node::EdgeEnd> output_edges(from.OutputEdgesBegin(), from.OutputEdgesEnd());
+  for (const auto& edge : output_edges) {
+    graph.RemoveEdge(from.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+    graph.AddEdge(to.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+  }
+}
+
+Node* GetInputNode(Graph& graph, const Node& node, int input_index) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == input_index) {
+      return graph.GetNode(it->GetNode().Index());
+    }
+  }
+  return nullptr;
+}
+
+Node* GetOnlyConsumer(Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node)) {
+    return nullptr;
+  }
+  return graph.GetNode(node.OutputNodesBegin()->Index());
+}
+
+bool GetScalarInitializerValue(const Graph& graph, const NodeArg& arg, float& value) {
+  const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+  if (!graph.GetInitializedTensor(arg.Name(), tensor_proto) || HasExternalData(*tensor_proto) ||
+      tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    return false;
+  }
+  Initializer initializer(tensor_proto);
+  if (initializer.size() != 1) {
+    return false;
+  }
+  value = *initializer.data<float>();
+  return true;
+}
+
+bool HasExternalData(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  return tensor_proto.data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL;
+}
+
 Status ForAllMutableSubgraphs(Graph& graph, std::function<Status(Graph&)> func) {
   Status status = Status::OK();
 
@@ -15,6 +15,35 @@ bool IsSupportedOptypeVersionAndDomain(const Node& node,
                                        const std::string& domain = kOnnxDomainAlias);
 
 Status ForAllMutableSubgraphs(Graph& main_graph, std::function<Status(Graph&)> func);
+
+// The helpers below keep the edges of the graph up to date as they edit it, so that rewrite rules can keep matching
+// nodes by their edges before the graph is resolved again.
+
+// Whether node can be removed by making the consumers of its output 0 read another value: the output is not a graph
+// output and is only read through explicit inputs, which unlike the outer scope values of subgraphs can be replaced.
+bool CanRemoveNode(Graph& graph, const Node& node);
+
+// Makes input input_index of node read the value of input source_input_index of source.
+void ReplaceNodeInput(Graph& graph, Node& node, int input_index, Node& source, int source_input_index);
+
+// Removes node, making the consumers of its output 0 read its input 0 instead. Requires CanRemoveNode.
+void RemoveNodeAndForwardInput(Graph& graph, Node& node);
+
+// Moves the output edges of from to to, which has taken over the output defs of from.
+void MoveOutputEdges(Graph& graph, Node& from, Node& to);
+
+// The node that produces input input_index of node, nullptr for graph inputs and initializers.
+Node* GetInputNode(Graph& graph, const Node& node, int input_index);
+
+// The only node that reads the outputs of node, nullptr if there are several or they are graph outputs.
+Node* GetOnlyConsumer(Graph& graph, const Node& node);
+
+// Whether arg is an initializer holding a single float, e.g. the exponent of a Pow, and its value.
+bool GetScalarInitializerValue(const Graph& graph, const NodeArg& arg, float& value);
+
+// Whether the data of tensor_proto is stored in a file next to the model rather than in the proto itself.
+// The data is only read when the session state is initialized, so transformers leave such initializers alone.
+bool HasExternalData(const ONNX_NAMESPACE::TensorProto& tensor_proto);
 Status ForAllSubgraphs(Graph& main_graph, std::function<Status(Graph&)> func);
 
 }  // namespace utils
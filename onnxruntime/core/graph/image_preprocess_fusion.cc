@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/image_preprocess_fusion.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// the per-channel affine transform y = x * scale[c] + bias[c] of the fused chain
+struct ChannelTransform {
+  std::vector<float> scale;
+  std::vector<float> bias;
+};
+
+// the values of a float initializer that broadcasts one value to all the channels or one to each: a scalar, or the
+// last of the dims of an NHWC tensor, or the dim before the last two of an NCHW tensor, with the other dims 1
+bool GetChannelValues(const Graph& graph, const NodeArg& arg, int64_t channels, bool nchw,
+                      std::vector<float>& values) {
+  const TensorProto* tensor_proto = nullptr;
+  if (!graph.GetInitializedTensor(arg.Name(), tensor_proto) || utils::HasExternalData(*tensor_proto) ||
+      tensor_proto->data_type() != TensorProto_DataType_FLOAT || tensor_proto->dims_size() > 4) {
+    return false;
+  }
+  const int channel_axis = tensor_proto->dims_size() - (nchw ? 3 : 1);
+  for (int i = 0; i < tensor_proto->dims_size(); ++i) {
+    if (tensor_proto->dims(i) != 1 && (i != channel_axis || tensor_proto->dims(i) != channels)) {
+      return false;
+    }
+  }
+  Initializer initializer(tensor_proto);
+  const float* data = initializer.data<float>();
+  values.resize(static_cast<size_t>(channels));
+  for (int64_t c = 0; c < channels; ++c) {
+    values[c] = data[initializer.size() == 1 ? 0 : c];
+  }
+  return true;
+}
+
+bool IsNhwcToNchwTranspose(const Node& node) {
+  if (!utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", 1)) {
+    return false;
+  }
+  auto perm = node.GetAttributes().find("perm");
+  if (perm == node.GetAttributes().end()) {
+    return false;
+  }
+  const auto& ints = perm->second.ints();
+  return ints.size() == 4 && ints[0] == 0 && ints[1] == 3 && ints[2] == 1 && ints[3] == 2;
+}
+
+// folds an elementwise Add, Sub, Mul or Div by a per-channel initializer into transform. the value of a Div has to
+// be the dividend.
+bool FoldArithmetic(const Graph& graph, const Node& node, const NodeArg* value, int64_t channels, bool nchw,
+                    ChannelTransform& transform) {
+  static const std::vector<std::string> op_types{"Add", "Sub", "Mul", "Div"};
+  if (std::find(op_types.begin(), op_types.end(), node.OpType()) == op_types.end() ||
+      !utils::IsSupportedOptypeVersionAndDomain(node, node.OpType(), 7) || node.InputDefs().size() != 2) {
+    return false;
+  }
+  const bool value_first = node.InputDefs()[0] == value;
+  if (!value_first && (node.InputDefs()[1] != value || node.OpType() == "Div")) {
+    return false;
+  }
+  std::vector<float> k;
+  if (!GetChannelValues(graph, *node.InputDefs()[value_first ? 1 : 0], channels, nchw, k)) {
+    return false;
+  }
+
+  for (int64_t c = 0; c < channels; ++c) {
+    float& scale = transform.scale[c];
+    float& bias = transform.bias[c];
+    if (node.OpType() == "Add") {
+      bias += k[c];
+    } else if (node.OpType() == "Sub" && value_first) {
+      bias -= k[c];
+    } else if (node.OpType() == "Sub") {
+      scale = -scale;
+      bias = k[c] - bias;
+    } else if (node.OpType() == "Mul") {
+      scale *= k[c];
+      bias *= k[c];
+    } else {
+      scale /= k[c];
+      bias /= k[c];
+    }
+  }
+  return true;
+}
+
+// folds an ImageScaler of the NCHW tensor into transform
+bool FoldImageScaler(const Node& node, int64_t channels, ChannelTransform& transform) {
+  if (!utils::IsSupportedOptypeVersionAndDomain(node, "ImageScaler", 1)) {
+    return false;
+  }
+  const NodeAttributes& attributes = node.GetAttributes();
+  auto scale_attr = attributes.find("scale");
+  auto bias_attr = attributes.find("bias");
+  const float scale = scale_attr == attributes.end() ? 1.0f : scale_attr->second.f();
+  if (bias_attr != attributes.end() && bias_attr->second.floats_size() != channels) {
+    return false;
+  }
+  for (int64_t c = 0; c < channels; ++c) {
+    transform.scale[c] *= scale;
+    transform.bias[c] = transform.bias[c] * scale +
+                        (bias_attr == attributes.end() ? 0.0f : bias_attr->second.floats(static_cast<int>(c)));
+  }
+  return true;
+}
+
+bool IsFusableCrop(const Node& node) {
+  if (!utils::IsSupportedOptypeVersionAndDomain(node, "Crop", 1)) {
+    return false;
+  }
+  auto border = node.GetAttributes().find("border");
+  auto scale = node.GetAttributes().find("scale");
+  return border != node.GetAttributes().end() && border->second.ints_size() == 4 &&
+         (scale == node.GetAttributes().end() || scale->second.ints_size() == 2);
+}
+
+// the attribute values of a transform: a single value when all the channels share it
+std::vector<float> Compact(const std::vector<float>& values) {
+  if (std::all_of(values.begin(), values.end(), [&values](float value) { return value == values[0]; })) {
+    return {values[0]};
+  }
+  return values;
+}
+
+}  // namespace
+
+bool FuseImagePreprocess::SatisfyCondition(const Node& node) {
+  if (!utils::IsSupportedOptypeVersionAndDomain(node, "Cast", 6) &&
+      !utils::IsSupportedOptypeVersionAndDomain(node, "Cast", 9)) {
+    return false;
+  }
+  auto to = node.GetAttributes().find("to");
+  if (to == node.GetAttributes().end() || to->second.i() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+  const NodeArg* input = node.InputDefs()[0];
+  const TensorShapeProto* shape = input->Shape();
+  return input->Type() != nullptr && *input->Type() == "tensor(uint8)" && shape != nullptr &&
+         shape->dim_size() == 4 && shape->dim(3).has_dim_value() && shape->dim(3).dim_value() > 0;
+}
+
+Status FuseImagePreprocess::Apply(Graph& graph, Node& node, bool& modified) {
+  const int64_t channels = node.InputDefs()[0]->Shape()->dim(3).dim_value();
+  ChannelTransform transform{std::vector<float>(channels, 1.0f), std::vector<float>(channels, 0.0f)};
+
+  // the chain ends at the last node that can be folded, which has to follow the Transpose
+  std::vector<Node*> chain{&node};
+  bool nchw = false;
+  const Node* crop = nullptr;
+  for (Node* next = utils::GetOnlyConsumer(graph, node); next != nullptr; next = utils::GetOnlyConsumer(graph, *next)) {
+    const NodeArg* value = chain.back()->OutputDefs()[0];
+    if (IsNhwcToNchwTranspose(*next) && !nchw && next->InputDefs()[0] == value) {
+      nchw = true;
+    } else if (nchw && crop == nullptr && IsFusableCrop(*next) && next->InputDefs()[0] == value) {
+      crop = next;
+    } else if (!(nchw && next->InputDefs()[0] == value && FoldImageScaler(*next, channels, transform)) &&
+               !FoldArithmetic(graph, *next, value, channels, nchw, transform)) {
+      break;
+    }
+    chain.push_back(next);
+  }
+  if (!nchw) {
+    return Status::OK();
+  }
+
+  Node& fused = graph.AddNode(graph.GenerateNodeName("ImagePreprocess"),
+                              "ImagePreprocess",
+                              "fused image preprocessing of " + node.Name(),
+                              node.MutableInputDefs(),
+                              chain.back()->MutableOutputDefs(),
+                              nullptr,
+                              kMSDomain);
+  fused.AddAttribute("scale", Compact(transform.scale));
+  fused.AddAttribute("bias", Compact(transform.bias));
+  if (crop != nullptr) {
+    // the border and the (height, width) scale of a Crop are the border and crop_size of ImagePreprocess
+    const NodeAttributes& attributes = crop->GetAttributes();
+    const auto& border = attributes.at("border").ints();
+    fused.AddAttribute("border", std::vector<int64_t>(border.begin(), border.end()));
+    auto scale = attributes.find("scale");
+    if (scale != attributes.end()) {
+      fused.AddAttribute("crop_size", std::vector<int64_t>(scale->second.ints().begin(), scale->second.ints().end()));
+    }
+  }
+  utils::ReplaceNodeInput(graph, fused, 0, node, 0);
+  utils::MoveOutputEdges(graph, *chain.back(), fused);
+
+  // the consumers first, so no edge is left to a removed node
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+    graph.RemoveNode((*it)->Index());
+  }
+  modified = true;
+  return Status::OK();
+}
+}  // namespace onnxruntime
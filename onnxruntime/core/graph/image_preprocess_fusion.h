@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/rewrite_rule.h"
+
+namespace onnxruntime {
+
+// Rewrite rule that replaces the preprocessing of uint8 NHWC images, a Cast to float followed by per-channel Add,
+// Sub, Mul and Div by initializers, a Transpose to NCHW and optionally an ImageScaler and a Crop, with an
+// ImagePreprocess that reads each pixel once and writes the normalized NCHW planes instead of a float tensor per
+// step. It is triggered by the Cast, and each node of the chain has to be the only consumer of the one before.
+class FuseImagePreprocess : public RewriteRule {
+ public:
+  FuseImagePreprocess() noexcept
+      : RewriteRule("FuseImagePreprocess", "Fuse the normalization and transpose of uint8 images") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+}  // namespace onnxruntime
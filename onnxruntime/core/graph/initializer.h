@@ -15,7 +15,9 @@ namespace onnxruntime {
 class Initializer final {
  public:
   static bool IsSupportedDataType(const ONNX_NAMESPACE::TensorProto* tensor_proto) {
+    // external data is only read when the session state is initialized
     return !(tensor_proto == nullptr ||
+             tensor_proto->data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL ||
              (tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
               tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_DOUBLE));
   }
@@ -44,6 +46,20 @@ class Initializer final {
     }
   }
 
+  // copies bytes of data in any data type, e.g. a tensor computed by a kernel
+  Initializer(ONNX_NAMESPACE::TensorProto_DataType data_type,
+              const std::string& name,
+              const std::vector<int64_t>& dims,
+              const void* data,
+              size_t bytes) : size_(0) {
+    data_type_ = data_type;
+    name_ = name;
+    dims_.assign(dims.cbegin(), dims.cend());
+
+    size_ = std::accumulate(dims_.begin(), dims_.end(), static_cast<int64_t>(1), std::multiplies<int64_t>{});
+    raw_data_.assign(static_cast<const char*>(data), bytes);
+  }
+
   Initializer(const ONNX_NAMESPACE::TensorProto* tensor_proto) : size_(0) {
     data_type_ = tensor_proto->data_type();
     if (tensor_proto->has_name()) {
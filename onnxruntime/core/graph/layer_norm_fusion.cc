@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/layer_norm_fusion.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// a ReduceMean over the last axis of its input that keeps the dims
+bool IsLastAxisMean(const Node& node) {
+  if (!utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", 1)) {
+    return false;
+  }
+  auto& attributes = node.GetAttributes();
+  auto keepdims = attributes.find("keepdims");
+  if (keepdims != attributes.end() && keepdims->second.i() != 1) {
+    return false;
+  }
+  auto axes = attributes.find("axes");
+  const TensorShapeProto* shape = node.InputDefs()[0]->Shape();
+  if (axes == attributes.end() || axes->second.ints_size() != 1 || shape == nullptr) {
+    return false;
+  }
+  const int64_t axis = axes->second.ints(0);
+  return axis == -1 || axis == shape->dim_size() - 1;
+}
+
+// the input of a binary node that is not the value, -1 if value is not one of its inputs
+int GetOtherInput(const Node& node, const NodeArg* value) {
+  if (node.InputDefs().size() != 2) {
+    return -1;
+  }
+  if (node.InputDefs()[0] == value) {
+    return 1;
+  }
+  return node.InputDefs()[1] == value ? 0 : -1;
+}
+
+// an initializer with one element per element of the normalized dim, so it doesn't broadcast the output
+bool IsSliceInitializer(const Graph& graph, const NodeArg& arg, int64_t slice_size) {
+  const TensorProto* tensor_proto = nullptr;
+  return graph.GetInitializedTensor(arg.Name(), tensor_proto) && tensor_proto->dims_size() == 1 &&
+         tensor_proto->dims(0) == slice_size;
+}
+
+}  // namespace
+
+bool FuseLayerNorm::SatisfyCondition(const Node& node) {
+  const NodeArg& x = *node.InputDefs()[0];
+  const TensorShapeProto* shape = x.Shape();
+  return IsLastAxisMean(node) && x.Type() != nullptr && *x.Type() == "tensor(float)" && shape->dim_size() > 0 &&
+         shape->dim(shape->dim_size() - 1).has_dim_value();
+}
+
+Status FuseLayerNorm::Apply(Graph& graph, Node& node, bool& modified) {
+  NodeArg* x = node.MutableInputDefs()[0];
+  const TensorShapeProto* shape = x->Shape();
+  const int64_t slice_size = shape->dim(shape->dim_size() - 1).dim_value();
+
+  // X - mean
+  Node* sub = utils::GetOnlyConsumer(graph, node);
+  if (sub == nullptr || !utils::IsSupportedOptypeVersionAndDomain(*sub, "Sub", 7) || sub->InputDefs()[0] != x ||
+      sub->InputDefs()[1] != node.OutputDefs()[0] || graph.IsNodeOutputsInGraphOutputs(*sub) ||
+      sub->GetOutputEdgesCount() != 2) {
+    return Status::OK();
+  }
+
+  // the deviation is read by the Pow of the variance and by the Div that normalizes it
+  Node* pow = nullptr;
+  Node* div = nullptr;
+  for (auto it = sub->OutputNodesBegin(); it != sub->OutputNodesEnd(); ++it) {
+    Node* consumer = graph.GetNode(it->Index());
+    if (utils::IsSupportedOptypeVersionAndDomain(*consumer, "Pow", 7)) {
+      pow = consumer;
+    } else if (utils::IsSupportedOptypeVersionAndDomain(*consumer, "Div", 7)) {
+      div = consumer;
+    }
+  }
+  float exponent = 0.0f;
+  if (pow == nullptr || div == nullptr || pow->InputDefs()[0] != sub->OutputDefs()[0] ||
+      !utils::GetScalarInitializerValue(graph, *pow->InputDefs()[1], exponent) || exponent != 2.0f ||
+      div->InputDefs()[0] != sub->OutputDefs()[0]) {
+    return Status::OK();
+  }
+
+  // sqrt(mean of the squares + epsilon)
+  Node* variance = utils::GetOnlyConsumer(graph, *pow);
+  if (variance == nullptr || !IsLastAxisMean(*variance)) {
+    return Status::OK();
+  }
+  Node* add_epsilon = utils::GetOnlyConsumer(graph, *variance);
+  float epsilon = 0.0f;
+  int epsilon_input = add_epsilon == nullptr ? -1 : GetOtherInput(*add_epsilon, variance->OutputDefs()[0]);
+  if (epsilon_input < 0 || !utils::IsSupportedOptypeVersionAndDomain(*add_epsilon, "Add", 7) ||
+      !utils::GetScalarInitializerValue(graph, *add_epsilon->InputDefs()[epsilon_input], epsilon)) {
+    return Status::OK();
+  }
+  Node* sqrt = utils::GetOnlyConsumer(graph, *add_epsilon);
+  if (sqrt == nullptr || !utils::IsSupportedOptypeVersionAndDomain(*sqrt, "Sqrt", 6) ||
+      utils::GetOnlyConsumer(graph, *sqrt) != div || div->InputDefs()[1] != sqrt->OutputDefs()[0]) {
+    return Status::OK();
+  }
+
+  // * scale + bias
+  Node* mul = utils::GetOnlyConsumer(graph, *div);
+  const int scale_input = mul == nullptr ? -1 : GetOtherInput(*mul, div->OutputDefs()[0]);
+  if (scale_input < 0 || !utils::IsSupportedOptypeVersionAndDomain(*mul, "Mul", 7) ||
+      !IsSliceInitializer(graph, *mul->InputDefs()[scale_input], slice_size)) {
+    return Status::OK();
+  }
+  Node* add_bias = utils::GetOnlyConsumer(graph, *mul);
+  const int bias_input = add_bias == nullptr ? -1 : GetOtherInput(*add_bias, mul->OutputDefs()[0]);
+  if (bias_input < 0 || !utils::IsSupportedOptypeVersionAndDomain(*add_bias, "Add", 7) ||
+      !IsSliceInitializer(graph, *add_bias->InputDefs()[bias_input], slice_size)) {
+    return Status::OK();
+  }
+
+  Node& layer_norm = graph.AddNode(graph.GenerateNodeName("LayerNorm"),
+                                   "LayerNormalization",
+                                   "fused layer normalization of " + node.Name(),
+                                   {x, mul->MutableInputDefs()[scale_input], add_bias->MutableInputDefs()[bias_input]},
+                                   add_bias->MutableOutputDefs(),
+                                   nullptr,
+                                   kMSDomain);
+  layer_norm.AddAttribute("axis", static_cast<int64_t>(-1));
+  layer_norm.AddAttribute("epsilon", epsilon);
+
+  utils::ReplaceNodeInput(graph, layer_norm, 0, node, 0);
+  utils::MoveOutputEdges(graph, *add_bias, layer_norm);
+
+  // consumers first, so no edge is left to a removed node
+  for (Node* removed : {add_bias, mul, div, sqrt, add_epsilon, variance, pow, sub, &node}) {
+    graph.RemoveNode(removed->Index());
+  }
+  modified = true;
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/rewrite_rule.h"
+
+namespace onnxruntime {
+
+// Rewrite rule that replaces the decomposed layer normalization of exported transformer models,
+// Add(Mul(Div(Sub(X, ReduceMean(X)), Sqrt(Add(ReduceMean(Pow(Sub(...), 2)), epsilon))), scale), bias), with a
+// LayerNormalization over the last axis. It is triggered by the first ReduceMean.
+class FuseLayerNorm : public RewriteRule {
+ public:
+  FuseLayerNorm() noexcept : RewriteRule("FuseLayerNorm", "Fuse the nodes of a layer normalization") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/loop_unrolling.h"
+
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+namespace {
+
+bool IsOnnxDomain(const std::string& domain) {
+  return domain == kOnnxDomain || domain == kOnnxDomainAlias;
+}
+
+// the value of an initializer holding a single int64
+bool GetInt64Scalar(const Graph& graph, const std::string& name, int64_t& value) {
+  const TensorProto* tensor_proto = nullptr;
+  if (!graph.GetInitializedTensor(name, tensor_proto) || tensor_proto->data_type() != TensorProto_DataType_INT64 ||
+      utils::HasExternalData(*tensor_proto)) {
+    return false;
+  }
+  if (tensor_proto->has_raw_data()) {
+    if (tensor_proto->raw_data().size() != sizeof(int64_t)) {
+      return false;
+    }
+    std::memcpy(&value, tensor_proto->raw_data().data(), sizeof(int64_t));
+    return true;
+  }
+  if (tensor_proto->int64_data_size() != 1) {
+    return false;
+  }
+  value = tensor_proto->int64_data(0);
+  return true;
+}
+
+// whether name is an initializer holding a single true
+bool IsTrueInitializer(const Graph& graph, const std::string& name) {
+  const TensorProto* tensor_proto = nullptr;
+  if (!graph.GetInitializedTensor(name, tensor_proto) || tensor_proto->data_type() != TensorProto_DataType_BOOL ||
+      utils::HasExternalData(*tensor_proto)) {
+    return false;
+  }
+  if (tensor_proto->has_raw_data()) {
+    return tensor_proto->raw_data().size() == 1 && tensor_proto->raw_data()[0] != 0;
+  }
+  return tensor_proto->int32_data_size() == 1 && tensor_proto->int32_data(0) != 0;
+}
+
+bool HasSubgraph(const Node& node) {
+  for (auto& attribute : node.GetAttributes()) {
+    if (attribute.second.type() == AttributeProto_AttributeType_GRAPH ||
+        attribute.second.type() == AttributeProto_AttributeType_GRAPHS) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// the node of graph that produces name, nullptr for its inputs and initializers
+const Node* GetProducer(const Graph& graph, const std::string& name) {
+  for (auto& node : graph.Nodes()) {
+    for (auto* output : node.OutputDefs()) {
+      if (output->Name() == name) {
+        return &node;
+      }
+    }
+  }
+  return nullptr;
+}
+
+NodeArg& AddInitializer(Graph& graph, TensorProto& tensor_proto, const std::string& base_name) {
+  tensor_proto.set_name(graph.GenerateNodeArgName(base_name));
+  graph.AddInitializedTensor(tensor_proto);
+  // the type is inferred from the initializer when the graph is resolved
+  return graph.GetOrCreateNodeArg(tensor_proto.name(), nullptr);
+}
+
+// Copies the body of loop into graph for each iteration. The values of the body are looked up by name: the inputs,
+// initializers and node outputs of the body map to their copies in the current iteration, all other names are the
+// outer scope values the body reads from graph.
+class LoopUnroller {
+ public:
+  LoopUnroller(Graph& graph, Node& loop, const Graph& body) : graph_(graph), loop_(loop), body_(body) {}
+
+  // whether the loop can be unrolled in at most max_nodes nodes, and its trip count
+  bool CanUnroll(int64_t max_nodes, int64_t& trip_count);
+
+  void Unroll(int64_t trip_count);
+
+ private:
+  NodeArg* Lookup(const std::string& name);
+
+  Graph& graph_;
+  Node& loop_;
+  const Graph& body_;
+  std::vector<NodeIndex> body_order_;
+  std::unordered_map<std::string, NodeArg*> values_;
+};
+
+bool LoopUnroller::CanUnroll(int64_t max_nodes, int64_t& trip_count) {
+  auto& loop_inputs = loop_.InputDefs();
+  if (loop_inputs.size() < 2 || !loop_inputs[0]->Exists() ||
+      !GetInt64Scalar(graph_, loop_inputs[0]->Name(), trip_count) || trip_count < 1 ||
+      (loop_inputs[1]->Exists() && !IsTrueInitializer(graph_, loop_inputs[1]->Name()))) {
+    return false;
+  }
+
+  auto& body_inputs = body_.GetInputsIncludingInitializers();
+  auto& body_outputs = body_.GetOutputs();
+  const size_t num_carried = loop_inputs.size() - 2;
+  if (body_inputs.size() != 2 + num_carried || body_outputs.size() < 1 + num_carried ||
+      loop_.OutputDefs().size() != body_outputs.size() - 1) {
+    return false;
+  }
+
+  // the condition stays true if the body passes it through, possibly by Identity nodes, or outputs a true initializer
+  std::string cond_out = body_outputs[0]->Name();
+  for (const Node* producer = GetProducer(body_, cond_out); producer != nullptr && producer->OpType() == "Identity";
+       producer = GetProducer(body_, cond_out)) {
+    cond_out = producer->InputDefs()[0]->Name();
+  }
+  if (cond_out != body_inputs[1]->Name() && !IsTrueInitializer(body_, cond_out)) {
+    return false;
+  }
+
+  GraphViewer body_viewer(body_);
+  body_order_ = body_viewer.GetNodesInTopologicalOrder();
+  if (static_cast<int64_t>(body_order_.size()) > max_nodes / trip_count) {
+    return false;
+  }
+
+  // every name the body does not define must be an outer scope value of graph
+  std::unordered_set<std::string> defined;
+  for (auto* input : body_inputs) {
+    defined.insert(input->Name());
+  }
+  for (auto& initializer : body_.GetAllInitializedTensors()) {
+    defined.insert(initializer.first);
+  }
+  for (NodeIndex index : body_order_) {
+    const Node& node = *body_.GetNode(index);
+    if (HasSubgraph(node)) {
+      return false;
+    }
+    for (auto* input : node.InputDefs()) {
+      if (input->Exists() && defined.count(input->Name()) == 0 && graph_.GetNodeArg(input->Name()) == nullptr) {
+        return false;
+      }
+    }
+    for (auto* output : node.OutputDefs()) {
+      defined.insert(output->Name());
+    }
+  }
+  for (auto* output : body_outputs) {
+    if (defined.count(output->Name()) == 0 && graph_.GetNodeArg(output->Name()) == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+NodeArg* LoopUnroller::Lookup(const std::string& name) {
+  auto it = values_.find(name);
+  if (it != values_.end()) {
+    return it->second;
+  }
+  if (name.empty()) {
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+  return graph_.GetNodeArg(name);
+}
+
+void LoopUnroller::Unroll(int64_t trip_count) {
+  auto& body_inputs = body_.GetInputsIncludingInitializers();
+  auto& body_outputs = body_.GetOutputs();
+  const size_t num_carried = loop_.InputDefs().size() - 2;
+  const size_t num_scans = body_outputs.size() - 1 - num_carried;
+
+  // the initializers of the body are shared by the iterations, the iteration number is one for each of them.
+  // the ones that end up unused are removed when the graph is resolved. like the ones the Loop kernel feeds, the
+  // iteration number and the condition have the shape {1}.
+  std::unordered_map<std::string, NodeArg*> initializers;
+  for (auto& initializer : body_.GetAllInitializedTensors()) {
+    TensorProto tensor_proto(*initializer.second);
+    initializers[initializer.first] = &AddInitializer(graph_, tensor_proto, initializer.first);
+  }
+  TensorProto cond_proto;
+  cond_proto.set_data_type(TensorProto_DataType_BOOL);
+  cond_proto.add_dims(1);
+  cond_proto.add_int32_data(1);
+  NodeArg& cond = AddInitializer(graph_, cond_proto, loop_.Name() + "_cond");
+
+  std::vector<NodeArg*> carried(loop_.MutableInputDefs().begin() + 2, loop_.MutableInputDefs().end());
+  std::vector<std::vector<NodeArg*>> scans(num_scans);
+  for (int64_t iteration = 0; iteration < trip_count; ++iteration) {
+    values_ = initializers;
+    TensorProto iteration_proto;
+    iteration_proto.set_data_type(TensorProto_DataType_INT64);
+    iteration_proto.add_dims(1);
+    iteration_proto.add_int64_data(iteration);
+    values_[body_inputs[0]->Name()] = &AddInitializer(graph_, iteration_proto, loop_.Name() + "_iteration");
+    values_[body_inputs[1]->Name()] = &cond;
+    for (size_t i = 0; i < num_carried; ++i) {
+      values_[body_inputs[2 + i]->Name()] = carried[i];
+    }
+
+    for (NodeIndex index : body_order_) {
+      const Node& node = *body_.GetNode(index);
+      std::vector<NodeArg*> inputs;
+      for (auto* input : node.InputDefs()) {
+        inputs.push_back(Lookup(input->Name()));
+      }
+      std::vector<NodeArg*> outputs;
+      for (auto* output : node.OutputDefs()) {
+        NodeArg* copy = &graph_.GetOrCreateNodeArg(
+            output->Exists() ? graph_.GenerateNodeArgName(output->Name()) : output->Name(), nullptr);
+        values_[output->Name()] = copy;
+        outputs.push_back(copy);
+      }
+      graph_.AddNode(graph_.GenerateNodeName(node.Name()), node.OpType(), node.Description(), inputs, outputs,
+                     &node.GetAttributes(), node.Domain());
+    }
+
+    for (size_t i = 0; i < num_carried; ++i) {
+      carried[i] = Lookup(body_outputs[1 + i]->Name());
+    }
+    for (size_t i = 0; i < num_scans; ++i) {
+      scans[i].push_back(Lookup(body_outputs[1 + num_carried + i]->Name()));
+    }
+  }
+
+  // the consumers of the loop outputs are connected to the nodes below when the graph is resolved
+  const std::vector<NodeArg*> loop_outputs = loop_.MutableOutputDefs();
+  const std::string loop_name = loop_.Name();
+  const std::vector<Node::EdgeEnd> output_edges(loop_.OutputEdgesBegin(), loop_.OutputEdgesEnd());
+  for (auto& edge : output_edges) {
+    graph_.RemoveEdge(loop_.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+  }
+  graph_.RemoveNode(loop_.Index());
+
+  for (size_t i = 0; i < num_carried; ++i) {
+    if (loop_outputs[i]->Exists()) {
+      graph_.AddNode(graph_.GenerateNodeName(loop_name + "_final"), "Identity", "final loop carried value",
+                     {carried[i]}, {loop_outputs[i]});
+    }
+  }
+  for (size_t i = 0; i < num_scans; ++i) {
+    NodeArg* scan_output = loop_outputs[num_carried + i];
+    if (!scan_output->Exists()) {
+      continue;
+    }
+    std::vector<NodeArg*> slices;
+    for (NodeArg* value : scans[i]) {
+      NodeArg* slice = &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(scan_output->Name()), nullptr);
+      graph_.AddNode(graph_.GenerateNodeName(loop_name + "_scan"), "Unsqueeze", "scan output of an iteration",
+                     {value}, {slice})
+          .AddAttribute("axes", std::vector<int64_t>{0});
+      slices.push_back(slice);
+    }
+    graph_.AddNode(graph_.GenerateNodeName(loop_name + "_scan"), "Concat", "scan output", slices, {scan_output})
+        .AddAttribute("axis", int64_t{0});
+  }
+}
+
+}  // namespace
+
+Status LoopUnrolling::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  GraphViewer graph_viewer(graph);
+  // copied, as the order is invalidated by the nodes added and removed below
+  const std::vector<NodeIndex> order = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (NodeIndex index : order) {
+    Node* node = graph.GetNode(index);
+    if (node == nullptr || node->OpType() != "Loop" || !IsOnnxDomain(node->Domain())) {
+      continue;
+    }
+    const Graph* body = node->GetGraphAttribute("body");
+    int64_t trip_count = 0;
+    if (body != nullptr) {
+      LoopUnroller unroller(graph, *node, *body);
+      if (unroller.CanUnroll(max_unrolled_nodes_, trip_count)) {
+        unroller.Unroll(trip_count);
+        modified = true;
+      }
+    }
+  }
+
+  if (modified) {
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
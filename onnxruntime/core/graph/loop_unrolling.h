@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+// Copies the body of a Loop into the graph once per iteration when its trip count is an initializer, so the
+// iterations run without invoking the subgraph and the other transformers and the memory planner see across them.
+// The loop must run for the whole trip count: its condition is absent or a true initializer, and the body passes its
+// condition input through or outputs a true initializer. Bodies that contain subgraphs are kept, as are loops whose
+// unrolled copies would exceed max_unrolled_nodes nodes. The final loop carried values are produced by Identity
+// nodes and each scan output is the Concat of the values of the iterations, each unsqueezed to add the loop axis.
+class LoopUnrolling : public onnxruntime::GraphTransformer {
+ public:
+  static constexpr int64_t kDefaultMaxUnrolledNodes = 64;
+
+  explicit LoopUnrolling(int64_t max_unrolled_nodes = kDefaultMaxUnrolledNodes) noexcept
+      : onnxruntime::GraphTransformer("LoopUnrolling", "Unroll Loop nodes with a constant trip count"),
+        max_unrolled_nodes_(max_unrolled_nodes) {}
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+
+ private:
+  const int64_t max_unrolled_nodes_;
+};
+
+}  // namespace onnxruntime
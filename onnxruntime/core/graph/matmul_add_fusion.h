@@ -4,13 +4,28 @@
 #pragma once
 
 #include "core/graph/graph_transformer.h"
+#include "core/graph/rewrite_rule.h"
 
 namespace onnxruntime {
 
-class MatMulAddFusion : public onnxruntime::GraphTransformer {
+// Rewrite rule that replaces a 2D MatMul and the Add following it with a Gemm.
+class FuseMatMulAdd : public RewriteRule {
  public:
-  MatMulAddFusion() noexcept : onnxruntime::GraphTransformer("MatMulAddFusion", "Fusing MatMul and Add into Gemm") {}
-  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+  FuseMatMulAdd() noexcept : RewriteRule("FuseMatMulAdd", "Fuse MatMul and Add into Gemm") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+// Applies FuseMatMulAdd on its own; the default transformers combine it with the other rules of their level.
+class MatMulAddFusion : public onnxruntime::TopDownRuleBasedTransformer {
+ public:
+  MatMulAddFusion()
+      : onnxruntime::TopDownRuleBasedTransformer("MatMulAddFusion", "Fusing MatMul and Add into Gemm") {
+    Register("MatMul", std::make_unique<FuseMatMulAdd>());
+  }
 };
 
 }  // namespace onnxruntime
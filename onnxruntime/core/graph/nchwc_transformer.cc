@@ -0,0 +1,320 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/nchwc_transformer.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloatTensor(const NodeArg* arg) {
+  const TypeProto* type = arg->TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool HasSingleOutput(const Node& node) {
+  const auto& output_defs = node.OutputDefs();
+  for (size_t i = 1; i < output_defs.size(); i++) {
+    if (output_defs[i]->Exists()) {
+      return false;
+    }
+  }
+  return !output_defs.empty();
+}
+
+bool IsBlockedActivation(const Node& node) {
+  return utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", 6) ||
+         utils::IsSupportedOptypeVersionAndDomain(node, "Relu", 6) ||
+         utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", 6) ||
+         utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", 6);
+}
+
+class NchwcTransformerImpl {
+ public:
+  NchwcTransformerImpl(Graph& graph) noexcept : graph_(graph) {}
+
+  void Transform(Node& node);
+  bool Finalize();
+
+ private:
+  // A tensor in the NCHWc format that replaces a tensor in the NCHW format.
+  struct NchwcArgument {
+    NodeArg* nchwc_arg_;
+    // Number of channels of the NCHW tensor, before padding to the block size.
+    int64_t channels_;
+  };
+
+  NodeArg* NewNchwcArgument(const NodeArg* arg);
+  NodeArg* GetNchwcInput(Node& node, int input_index, int64_t channels);
+  NodeArg* CreateNchwcOutput(NodeArg* output_arg, int64_t channels);
+  void RemoveNode(Node& node);
+
+  void TransformConv(Node& node);
+  void TransformPool(Node& node);
+  void TransformActivation(Node& node);
+
+  Graph& graph_;
+
+  // Maps a tensor in the NCHW format to its NCHWc replacement.
+  std::unordered_map<const NodeArg*, NchwcArgument> nchwc_args_;
+
+  // ReorderOutput nodes added for converted nodes and ImagePreprocess nodes
+  // replaced by copies that produce the NCHWc format. Those whose output ends
+  // up unused are removed by Finalize.
+  std::deque<NodeIndex> reorder_outputs_;
+
+  bool modified_ = false;
+};
+
+NodeArg* NchwcTransformerImpl::NewNchwcArgument(const NodeArg* arg) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  return &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(arg->Name() + "_nchwc"), &type);
+}
+
+NodeArg* NchwcTransformerImpl::GetNchwcInput(Node& node, int input_index, int64_t channels) {
+  NodeArg* input_arg = node.MutableInputDefs()[input_index];
+  auto it = nchwc_args_.find(input_arg);
+  if (it != nchwc_args_.end()) {
+    return it->second.nchwc_arg_;
+  }
+
+  NodeArg* nchwc_arg = NewNchwcArgument(input_arg);
+  nchwc_args_[input_arg] = NchwcArgument{nchwc_arg, channels};
+
+  // An ImagePreprocess writes the NCHWc format directly from its uint8 input,
+  // so a copy of it replaces the ReorderInput of its NCHW output.
+  Node* producer = utils::GetInputNode(graph_, node, input_index);
+  if (producer != nullptr && producer->OpType() == "ImagePreprocess" && producer->Domain() == kMSDomain) {
+    const auto& attributes = producer->GetAttributes();
+    auto nchwc_attr = attributes.find("nchwc");
+    if (nchwc_attr == attributes.end() || nchwc_attr->second.i() == 0) {
+      Node& preprocess = graph_.AddNode(graph_.GenerateNodeName("NchwcImagePreprocess"),
+                                        "ImagePreprocess",
+                                        "Preprocess " + producer->InputDefs()[0]->Name() + " to NCHWc",
+                                        producer->MutableInputDefs(),
+                                        std::vector<NodeArg*>{nchwc_arg},
+                                        &attributes,
+                                        kMSDomain);
+      preprocess.AddAttribute("nchwc", static_cast<int64_t>(1));
+      reorder_outputs_.push_back(producer->Index());
+      return nchwc_arg;
+    }
+  }
+
+  graph_.AddNode(graph_.GenerateNodeName("ReorderInput"),
+                 "ReorderInput",
+                 "Reorder " + input_arg->Name() + " to NCHWc",
+                 std::vector<NodeArg*>{input_arg},
+                 std::vector<NodeArg*>{nchwc_arg},
+                 nullptr,
+                 kMSDomain);
+  return nchwc_arg;
+}
+
+NodeArg* NchwcTransformerImpl::CreateNchwcOutput(NodeArg* output_arg, int64_t channels) {
+  NodeArg* nchwc_arg = NewNchwcArgument(output_arg);
+  Node& reorder_output = graph_.AddNode(graph_.GenerateNodeName("ReorderOutput"),
+                                        "ReorderOutput",
+                                        "Reorder " + output_arg->Name() + " from NCHWc",
+                                        std::vector<NodeArg*>{nchwc_arg},
+                                        std::vector<NodeArg*>{output_arg},
+                                        nullptr,
+                                        kMSDomain);
+  reorder_output.AddAttribute("channels", channels);
+  reorder_outputs_.push_back(reorder_output.Index());
+
+  nchwc_args_[output_arg] = NchwcArgument{nchwc_arg, channels};
+  return nchwc_arg;
+}
+
+void NchwcTransformerImpl::RemoveNode(Node& node) {
+  // The output edges are rebuilt from the ReorderOutput nodes when the graph
+  // is resolved.
+  Node::EdgeSet output_edges;
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    output_edges.insert(*it);
+  }
+  for (auto& output_edge : output_edges) {
+    graph_.RemoveEdge(node.Index(), output_edge.GetNode().Index(),
+                      output_edge.GetSrcArgIndex(), output_edge.GetDstArgIndex());
+  }
+
+  graph_.RemoveNode(node.Index());
+  modified_ = true;
+}
+
+void NchwcTransformerImpl::TransformConv(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  if (!IsFloatTensor(input_defs[0]) || !HasSingleOutput(node)) {
+    return;
+  }
+
+  // The filter must be a constant so that the kernel reorders it once.
+  const TensorProto* conv_W_tensor_proto = nullptr;
+  if (!graph_.GetInitializedTensor(input_defs[1]->Name(), conv_W_tensor_proto) ||
+      conv_W_tensor_proto->data_type() != TensorProto_DataType_FLOAT ||
+      conv_W_tensor_proto->dims_size() != 4) {
+    return;
+  }
+
+  const auto& attributes = node.GetAttributes();
+  auto group_attr = attributes.find("group");
+  if (group_attr != attributes.end() && group_attr->second.i() != 1) {
+    return;
+  }
+
+  std::vector<NodeArg*> nchwc_inputs(input_defs);
+  nchwc_inputs[0] = GetNchwcInput(node, 0, conv_W_tensor_proto->dims(1));
+
+  NodeArg* nchwc_output = CreateNchwcOutput(output_defs[0], conv_W_tensor_proto->dims(0));
+
+  graph_.AddNode(graph_.GenerateNodeName("NchwcConv_" + node.Name()),
+                 "NchwcConv",
+                 "NCHWc " + node.Name(),
+                 nchwc_inputs,
+                 std::vector<NodeArg*>{nchwc_output},
+                 &attributes,
+                 kMSDomain);
+
+  RemoveNode(node);
+}
+
+void NchwcTransformerImpl::TransformPool(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Only convert pooling operations whose input is already blocked, since a
+  // standalone pooling operation would need to reorder both of its tensors.
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end() || !HasSingleOutput(node)) {
+    return;
+  }
+
+  const auto& attributes = node.GetAttributes();
+  auto kernel_shape_attr = attributes.find("kernel_shape");
+  if (kernel_shape_attr == attributes.end() || kernel_shape_attr->second.ints_size() != 2) {
+    return;
+  }
+  auto storage_order_attr = attributes.find("storage_order");
+  if (storage_order_attr != attributes.end() && storage_order_attr->second.i() != 0) {
+    return;
+  }
+
+  NodeAttributes nchwc_attributes;
+  for (const auto& attr : attributes) {
+    if (attr.first != "storage_order") {
+      nchwc_attributes.insert(attr);
+    }
+  }
+
+  const int64_t channels = it->second.channels_;
+  NodeArg* nchwc_input = it->second.nchwc_arg_;
+  NodeArg* nchwc_output = CreateNchwcOutput(output_defs[0], channels);
+
+  graph_.AddNode(graph_.GenerateNodeName("Nchwc" + node.OpType() + "_" + node.Name()),
+                 "Nchwc" + node.OpType(),
+                 "NCHWc " + node.Name(),
+                 std::vector<NodeArg*>{nchwc_input},
+                 std::vector<NodeArg*>{nchwc_output},
+                 &nchwc_attributes,
+                 kMSDomain);
+
+  RemoveNode(node);
+}
+
+void NchwcTransformerImpl::TransformActivation(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // The activation is applied to the padding channels too, but those don't
+  // contribute to the following convolutions and are dropped by ReorderOutput.
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+
+  const int64_t channels = it->second.channels_;
+  NodeArg* nchwc_input = it->second.nchwc_arg_;
+  NodeArg* nchwc_output = CreateNchwcOutput(output_defs[0], channels);
+
+  graph_.AddNode(graph_.GenerateNodeName(node.Name() + "_nchwc"),
+                 node.OpType(),
+                 "NCHWc " + node.Name(),
+                 std::vector<NodeArg*>{nchwc_input},
+                 std::vector<NodeArg*>{nchwc_output},
+                 &node.GetAttributes(),
+                 node.Domain());
+
+  RemoveNode(node);
+}
+
+void NchwcTransformerImpl::Transform(Node& node) {
+  if (utils::IsSupportedOptypeVersionAndDomain(node, "Conv", 1) ||
+      utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", 1, kMSDomain)) {
+    TransformConv(node);
+  } else if (utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", 1) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", 8) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", 7)) {
+    TransformPool(node);
+  } else if (IsBlockedActivation(node)) {
+    TransformActivation(node);
+  }
+}
+
+bool NchwcTransformerImpl::Finalize() {
+  // Collect the tensors that are still consumed in the NCHW format.
+  std::unordered_set<const NodeArg*> consumed_args;
+  for (auto& node : graph_.Nodes()) {
+    for (const auto* input_def : node.InputDefs()) {
+      consumed_args.insert(input_def);
+    }
+    for (const auto* input_def : node.ImplicitInputDefs()) {
+      consumed_args.insert(input_def);
+    }
+  }
+  for (const auto* output : graph_.GetOutputs()) {
+    consumed_args.insert(output);
+  }
+
+  for (auto index : reorder_outputs_) {
+    Node* reorder_output = graph_.GetNode(index);
+    if (consumed_args.count(reorder_output->OutputDefs()[0]) == 0) {
+      graph_.RemoveNode(index);
+    }
+  }
+
+  return modified_;
+}
+
+}  // namespace
+
+Status NchwcTransformer::Apply(Graph& graph, bool& modified) const {
+  NchwcTransformerImpl impl(graph);
+  GraphViewer graph_viewer(graph);
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto node = graph.GetNode(index);
+    if (node != nullptr) {
+      impl.Transform(*node);
+    }
+  }
+
+  if (impl.Finalize()) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+// Transformer that converts 2D float Conv, FusedConv, MaxPool and AveragePool nodes to the NCHWc
+// contrib operators, which keep activations in the blocked channel layout used by the MLAS direct
+// convolution kernels. Unary activations between converted nodes run on the blocked tensors.
+// ReorderInput nodes are inserted where a blocked tensor is first needed and ReorderOutput nodes
+// where the NCHW tensor is still consumed, so consecutive converted nodes don't reorder.
+// Run ConvActivationFusion first so that activations following a convolution are fused.
+class NchwcTransformer : public onnxruntime::GraphTransformer {
+ public:
+  NchwcTransformer() noexcept : onnxruntime::GraphTransformer("NchwcTransformer", "Convert Conv and Pool nodes to the NCHWc format") {}
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+};
+
+}  // namespace onnxruntime
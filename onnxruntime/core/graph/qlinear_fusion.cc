@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/qlinear_fusion.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/initializer.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsPerTensor(const Node& node) {
+  return node.GetAttributes().find("axis") == node.GetAttributes().end();
+}
+
+// the DequantizeLinear that produces input input_index of node, if it dequantizes a uint8 value per tensor for node
+// alone, nullptr otherwise
+Node* GetDequantizeLinearInput(Graph& graph, const Node& node, int input_index) {
+  Node* dequantize = utils::GetInputNode(graph, node, input_index);
+  if (dequantize == nullptr ||
+      !utils::IsSupportedOptypeVersionAndDomain(*dequantize, "DequantizeLinear", 1, kMSDomain) ||
+      !IsPerTensor(*dequantize) || utils::GetOnlyConsumer(graph, *dequantize) != &node) {
+    return nullptr;
+  }
+  const NodeArg* x = dequantize->InputDefs()[0];
+  return x->Type() != nullptr && *x->Type() == "tensor(uint8)" ? dequantize : nullptr;
+}
+
+// adds an initializer of bias quantized to int32 by the scale x_scale * w_scale, the scale of the int32 product of
+// the quantized input and weight. returns nullptr if the bias or scales aren't initializers or the bias doesn't fit.
+NodeArg* AddQuantizedBias(Graph& graph, const NodeArg& bias, const NodeArg& x_scale, const NodeArg& w_scale) {
+  float x_scale_value = 0.f;
+  float w_scale_value = 0.f;
+  const TensorProto* bias_tensor_proto = nullptr;
+  if (!utils::GetScalarInitializerValue(graph, x_scale, x_scale_value) ||
+      !utils::GetScalarInitializerValue(graph, w_scale, w_scale_value) ||
+      !graph.GetInitializedTensor(bias.Name(), bias_tensor_proto) ||
+      !Initializer::IsSupportedDataType(bias_tensor_proto) ||
+      bias_tensor_proto->data_type() != TensorProto_DataType_FLOAT || bias_tensor_proto->dims_size() != 1) {
+    return nullptr;
+  }
+
+  const float scale = x_scale_value * w_scale_value;
+  if (!(scale > 0.f)) {
+    return nullptr;
+  }
+
+  Initializer bias_values(bias_tensor_proto);
+  TensorProto quantized_tensor_proto;
+  quantized_tensor_proto.set_name(graph.GenerateNodeArgName(bias.Name() + "_quantized"));
+  quantized_tensor_proto.set_data_type(TensorProto_DataType_INT32);
+  quantized_tensor_proto.add_dims(bias_tensor_proto->dims(0));
+  for (int64_t i = 0; i < bias_values.size(); ++i) {
+    const double value = std::round(static_cast<double>(bias_values.data<float>()[i]) / scale);
+    if (!(std::abs(value) <= static_cast<double>(std::numeric_limits<int32_t>::max()))) {
+      return nullptr;
+    }
+    quantized_tensor_proto.add_int32_data(static_cast<int32_t>(value));
+  }
+  graph.AddInitializedTensor(quantized_tensor_proto);
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(bias_tensor_proto->dims(0));
+  return &graph.GetOrCreateNodeArg(quantized_tensor_proto.name(), &type);
+}
+
+}  // namespace
+
+bool FuseQLinear::SatisfyCondition(const Node& node) {
+  return utils::IsSupportedOptypeVersionAndDomain(node, "QuantizeLinear", 1, kMSDomain) && IsPerTensor(node) &&
+         node.GetInputEdgesCount() > 0;
+}
+
+Status FuseQLinear::Apply(Graph& graph, Node& node, bool& modified) {
+  Node* op = utils::GetInputNode(graph, node, 0);
+  if (op == nullptr || utils::GetOnlyConsumer(graph, *op) != &node) {
+    return Status::OK();
+  }
+  const bool is_conv = utils::IsSupportedOptypeVersionAndDomain(*op, "Conv", 1);
+  if (!is_conv && !utils::IsSupportedOptypeVersionAndDomain(*op, "MatMul", 1) &&
+      !utils::IsSupportedOptypeVersionAndDomain(*op, "MatMul", 9)) {
+    return Status::OK();
+  }
+
+  Node* dequantize_x = GetDequantizeLinearInput(graph, *op, 0);
+  Node* dequantize_w = GetDequantizeLinearInput(graph, *op, 1);
+  if (dequantize_x == nullptr || dequantize_w == nullptr) {
+    return Status::OK();
+  }
+
+  NodeArg* bias = nullptr;
+  auto& op_inputs = op->MutableInputDefs();
+  if (is_conv && op_inputs.size() > 2 && op_inputs[2]->Exists()) {
+    bias = AddQuantizedBias(graph, *op_inputs[2], *dequantize_x->InputDefs()[1], *dequantize_w->InputDefs()[1]);
+    if (bias == nullptr) {
+      return Status::OK();
+    }
+  }
+
+  // x, x_scale, x_zero_point, w, w_scale, w_zero_point, y_scale, y_zero_point and the optional bias
+  std::vector<NodeArg*> inputs;
+  for (Node* source : {dequantize_x, dequantize_w}) {
+    inputs.insert(inputs.end(), source->MutableInputDefs().begin(), source->MutableInputDefs().begin() + 3);
+  }
+  inputs.push_back(node.MutableInputDefs()[1]);
+  inputs.push_back(node.MutableInputDefs()[2]);
+  if (bias != nullptr) {
+    inputs.push_back(bias);
+  }
+
+  const std::string op_type = is_conv ? "QLinearConv" : "QLinearMatMul";
+  Node& fused = graph.AddNode(graph.GenerateNodeName(op_type),
+                              op_type,
+                              "fused quantized " + op->Name(),
+                              inputs,
+                              node.MutableOutputDefs(),
+                              is_conv ? &op->GetAttributes() : nullptr,
+                              kMSDomain);
+  for (int input = 0; input < 3; ++input) {
+    utils::ReplaceNodeInput(graph, fused, input, *dequantize_x, input);
+    utils::ReplaceNodeInput(graph, fused, input + 3, *dequantize_w, input);
+  }
+  utils::ReplaceNodeInput(graph, fused, 6, node, 1);
+  utils::ReplaceNodeInput(graph, fused, 7, node, 2);
+  utils::MoveOutputEdges(graph, node, fused);
+
+  // the consumers first, so no edge is left to a removed node
+  graph.RemoveNode(node.Index());
+  graph.RemoveNode(op->Index());
+  graph.RemoveNode(dequantize_x->Index());
+  graph.RemoveNode(dequantize_w->Index());
+  modified = true;
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/rewrite_rule.h"
+
+namespace onnxruntime {
+
+// Rewrite rule that replaces the DequantizeLinear -> Conv/MatMul -> QuantizeLinear chains of a quantized model with a
+// QLinearConv or QLinearMatMul, which compute in 8 bit integers instead of converting the values to and from float.
+// It is triggered by the QuantizeLinear. The inputs must be uint8 dequantized by a per tensor scale and zero point for
+// the Conv or MatMul alone. The bias of a Conv must be a float initializer, which is quantized to int32 by the
+// product of the input and weight scales, so those must be initializers too.
+class FuseQLinear : public RewriteRule {
+ public:
+  FuseQLinear() noexcept : RewriteRule("FuseQLinear", "Fuse a Conv or MatMul between quantize and dequantize ops") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,428 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/quantization_transformer.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/initializer.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <unordered_set>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloatTensor(const NodeArg* arg) {
+  const TypeProto* type = arg->TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool HasSingleOutput(const Node& node) {
+  const auto& output_defs = node.OutputDefs();
+  for (size_t i = 1; i < output_defs.size(); i++) {
+    if (output_defs[i]->Exists()) {
+      return false;
+    }
+  }
+  return !output_defs.empty();
+}
+
+// the float initializer arg, or nullptr
+const TensorProto* GetFloatInitializer(const Graph& graph, const NodeArg* arg) {
+  const TensorProto* tensor_proto = nullptr;
+  if (!graph.GetInitializedTensor(arg->Name(), tensor_proto) || !Initializer::IsSupportedDataType(tensor_proto) ||
+      tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return nullptr;
+  }
+  return tensor_proto;
+}
+
+// the scale and zero point that map the range extended to include 0 onto [0, 255], so that 0 is quantized exactly.
+// returns false for a range that isn't finite.
+bool ComputeQuantizationParameters(float min, float max, float& scale, uint8_t& zero_point) {
+  min = std::min(min, 0.f);
+  max = std::max(max, 0.f);
+  scale = (max - min) / 255.f;
+  if (!std::isfinite(scale)) {
+    return false;
+  }
+  if (scale == 0.f) {
+    // all the values are 0
+    scale = 1.f;
+  }
+  zero_point = static_cast<uint8_t>(std::min(255.f, std::max(0.f, std::round(-min / scale))));
+  return true;
+}
+
+uint8_t QuantizeValue(float value, float scale, uint8_t zero_point) {
+  const float quantized = std::round(value / scale) + zero_point;
+  return static_cast<uint8_t>(std::min(255.f, std::max(0.f, quantized)));
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  auto it = node.GetAttributes().find(name);
+  return it != node.GetAttributes().end() ? it->second.i() : default_value;
+}
+
+float GetFloatAttribute(const Node& node, const std::string& name, float default_value) {
+  auto it = node.GetAttributes().find(name);
+  return it != node.GetAttributes().end() ? it->second.f() : default_value;
+}
+
+class QuantizationTransformerImpl {
+ public:
+  QuantizationTransformerImpl(Graph& graph, const QuantizationRanges& ranges) noexcept
+      : graph_(graph), ranges_(ranges) {}
+
+  void Transform(Node& node);
+  bool Finalize();
+
+ private:
+  // A value quantized per tensor to uint8.
+  struct QuantizedArgument {
+    // nullptr until a node produces or reads the quantized value
+    NodeArg* quantized_arg_;
+    NodeArg* scale_;
+    NodeArg* zero_point_;
+    float scale_value_;
+  };
+
+  NodeArg* AddInitializer(TensorProto& tensor_proto, const std::string& base_name);
+  NodeArg* NewQuantizedArgument(const NodeArg* arg);
+  QuantizedArgument NewQuantizationParameters(const std::string& base_name, float scale, uint8_t zero_point);
+  bool CanQuantize(const NodeArg* arg) const;
+  QuantizedArgument* GetQuantizationParameters(const NodeArg* arg);
+  QuantizedArgument* GetQuantizedInput(NodeArg* input_arg);
+  QuantizedArgument* CreateQuantizedOutput(NodeArg* output_arg);
+  QuantizedArgument AddQuantizedWeight(const TensorProto& weight_tensor_proto, const std::vector<int64_t>& dims,
+                                       bool transpose);
+  NodeArg* AddQuantizedBias(const TensorProto& bias_tensor_proto, float scale);
+  NodeArg* AddReshape(NodeArg* input_arg, const std::vector<int64_t>& shape, NodeArg* output_arg);
+  void RemoveNode(Node& node);
+
+  Graph& graph_;
+  const QuantizationRanges& ranges_;
+
+  // Maps a float tensor to its quantized replacement.
+  std::unordered_map<const NodeArg*, QuantizedArgument> quantized_args_;
+
+  // DequantizeLinear nodes added for quantized nodes. Those whose output ends
+  // up unused are removed by Finalize.
+  std::deque<NodeIndex> dequantize_outputs_;
+
+  bool modified_ = false;
+};
+
+NodeArg* QuantizationTransformerImpl::AddInitializer(TensorProto& tensor_proto, const std::string& base_name) {
+  tensor_proto.set_name(graph_.GenerateNodeArgName(base_name));
+  graph_.AddInitializedTensor(tensor_proto);
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(tensor_proto.data_type());
+  for (auto dim : tensor_proto.dims()) {
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  return &graph_.GetOrCreateNodeArg(tensor_proto.name(), &type);
+}
+
+NodeArg* QuantizationTransformerImpl::NewQuantizedArgument(const NodeArg* arg) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  return &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(arg->Name() + "_quantized"), &type);
+}
+
+QuantizationTransformerImpl::QuantizedArgument QuantizationTransformerImpl::NewQuantizationParameters(
+    const std::string& base_name, float scale, uint8_t zero_point) {
+  TensorProto scale_tensor_proto;
+  scale_tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  scale_tensor_proto.add_float_data(scale);
+
+  TensorProto zero_point_tensor_proto;
+  zero_point_tensor_proto.set_data_type(TensorProto_DataType_UINT8);
+  zero_point_tensor_proto.add_int32_data(zero_point);
+
+  return QuantizedArgument{nullptr, AddInitializer(scale_tensor_proto, base_name + "_scale"),
+                           AddInitializer(zero_point_tensor_proto, base_name + "_zero_point"), scale};
+}
+
+bool QuantizationTransformerImpl::CanQuantize(const NodeArg* arg) const {
+  if (quantized_args_.count(arg) != 0) {
+    return true;
+  }
+  auto range = ranges_.find(arg->Name());
+  float scale;
+  uint8_t zero_point;
+  return range != ranges_.end() &&
+         ComputeQuantizationParameters(range->second.first, range->second.second, scale, zero_point);
+}
+
+// the quantization parameters of arg, which are added on first use. requires CanQuantize.
+QuantizationTransformerImpl::QuantizedArgument* QuantizationTransformerImpl::GetQuantizationParameters(
+    const NodeArg* arg) {
+  auto it = quantized_args_.find(arg);
+  if (it != quantized_args_.end()) {
+    return &it->second;
+  }
+
+  const auto& range = ranges_.at(arg->Name());
+  float scale;
+  uint8_t zero_point;
+  ComputeQuantizationParameters(range.first, range.second, scale, zero_point);
+  return &quantized_args_.emplace(arg, NewQuantizationParameters(arg->Name(), scale, zero_point)).first->second;
+}
+
+QuantizationTransformerImpl::QuantizedArgument* QuantizationTransformerImpl::GetQuantizedInput(NodeArg* input_arg) {
+  QuantizedArgument* quantized = GetQuantizationParameters(input_arg);
+  if (quantized->quantized_arg_ == nullptr) {
+    quantized->quantized_arg_ = NewQuantizedArgument(input_arg);
+    graph_.AddNode(graph_.GenerateNodeName("QuantizeLinear"),
+                   "QuantizeLinear",
+                   "Quantize " + input_arg->Name(),
+                   std::vector<NodeArg*>{input_arg, quantized->scale_, quantized->zero_point_},
+                   std::vector<NodeArg*>{quantized->quantized_arg_},
+                   nullptr,
+                   kMSDomain);
+  }
+  return quantized;
+}
+
+QuantizationTransformerImpl::QuantizedArgument* QuantizationTransformerImpl::CreateQuantizedOutput(
+    NodeArg* output_arg) {
+  QuantizedArgument* quantized = GetQuantizationParameters(output_arg);
+  quantized->quantized_arg_ = NewQuantizedArgument(output_arg);
+  Node& dequantize = graph_.AddNode(graph_.GenerateNodeName("DequantizeLinear"),
+                                    "DequantizeLinear",
+                                    "Dequantize " + output_arg->Name(),
+                                    std::vector<NodeArg*>{quantized->quantized_arg_, quantized->scale_,
+                                                          quantized->zero_point_},
+                                    std::vector<NodeArg*>{output_arg},
+                                    nullptr,
+                                    kMSDomain);
+  dequantize_outputs_.push_back(dequantize.Index());
+  return quantized;
+}
+
+QuantizationTransformerImpl::QuantizedArgument QuantizationTransformerImpl::AddQuantizedWeight(
+    const TensorProto& weight_tensor_proto, const std::vector<int64_t>& dims, bool transpose) {
+  Initializer weight(&weight_tensor_proto);
+  const float* data = weight.data<float>();
+  const int64_t size = weight.size();
+  const auto range = std::minmax_element(data, data + size);
+
+  float scale;
+  uint8_t zero_point;
+  if (size == 0 || !ComputeQuantizationParameters(*range.first, *range.second, scale, zero_point)) {
+    scale = 1.f;
+    zero_point = 0;
+  }
+
+  // a transposed weight is the [N, K] transpose of a [K, N] matrix
+  const int64_t rows = transpose ? weight.dims()[0] : 1;
+  const int64_t columns = transpose ? weight.dims()[1] : size;
+  std::string quantized_data(static_cast<size_t>(size), '\0');
+  for (int64_t row = 0; row < rows; ++row) {
+    for (int64_t column = 0; column < columns; ++column) {
+      const int64_t index = transpose ? column * rows + row : column;
+      quantized_data[index] = static_cast<char>(QuantizeValue(data[row * columns + column], scale, zero_point));
+    }
+  }
+
+  TensorProto quantized_tensor_proto;
+  quantized_tensor_proto.set_data_type(TensorProto_DataType_UINT8);
+  for (auto dim : dims) {
+    quantized_tensor_proto.add_dims(dim);
+  }
+  quantized_tensor_proto.set_raw_data(quantized_data);
+
+  QuantizedArgument quantized = NewQuantizationParameters(weight_tensor_proto.name(), scale, zero_point);
+  quantized.quantized_arg_ = AddInitializer(quantized_tensor_proto, weight_tensor_proto.name() + "_quantized");
+  return quantized;
+}
+
+NodeArg* QuantizationTransformerImpl::AddQuantizedBias(const TensorProto& bias_tensor_proto, float scale) {
+  Initializer bias(&bias_tensor_proto);
+  TensorProto quantized_tensor_proto;
+  quantized_tensor_proto.set_data_type(TensorProto_DataType_INT32);
+  quantized_tensor_proto.add_dims(bias.size());
+  for (int64_t i = 0; i < bias.size(); ++i) {
+    const double value = std::round(static_cast<double>(bias.data<float>()[i]) / scale);
+    const double bound = static_cast<double>(std::numeric_limits<int32_t>::max());
+    quantized_tensor_proto.add_int32_data(static_cast<int32_t>(std::min(bound, std::max(-bound, value))));
+  }
+  return AddInitializer(quantized_tensor_proto, bias_tensor_proto.name() + "_quantized");
+}
+
+NodeArg* QuantizationTransformerImpl::AddReshape(NodeArg* input_arg, const std::vector<int64_t>& shape,
+                                                 NodeArg* output_arg) {
+  TensorProto shape_tensor_proto;
+  shape_tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  shape_tensor_proto.add_dims(static_cast<int64_t>(shape.size()));
+  for (auto dim : shape) {
+    shape_tensor_proto.add_int64_data(dim);
+  }
+  NodeArg* shape_arg = AddInitializer(shape_tensor_proto, input_arg->Name() + "_shape");
+
+  graph_.AddNode(graph_.GenerateNodeName("Reshape"),
+                 "Reshape",
+                 "Reshape " + input_arg->Name(),
+                 std::vector<NodeArg*>{input_arg, shape_arg},
+                 std::vector<NodeArg*>{output_arg});
+  return output_arg;
+}
+
+void QuantizationTransformerImpl::RemoveNode(Node& node) {
+  // The output edges are rebuilt from the DequantizeLinear nodes when the
+  // graph is resolved.
+  Node::EdgeSet output_edges;
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    output_edges.insert(*it);
+  }
+  for (auto& output_edge : output_edges) {
+    graph_.RemoveEdge(node.Index(), output_edge.GetNode().Index(),
+                      output_edge.GetSrcArgIndex(), output_edge.GetDstArgIndex());
+  }
+
+  graph_.RemoveNode(node.Index());
+  modified_ = true;
+}
+
+void QuantizationTransformerImpl::Transform(Node& node) {
+  const bool is_conv = utils::IsSupportedOptypeVersionAndDomain(node, "Conv", 1);
+  const bool is_matmul = utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", 1) ||
+                         utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", 9);
+  const bool is_gemm = utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", 7) ||
+                       utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", 9);
+  if (!is_conv && !is_matmul && !is_gemm) {
+    return;
+  }
+
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+  if (!IsFloatTensor(input_defs[0]) || !HasSingleOutput(node) || !CanQuantize(input_defs[0]) ||
+      !CanQuantize(output_defs[0])) {
+    return;
+  }
+
+  // The weight and the bias must be constants so that they're quantized once.
+  const TensorProto* weight_tensor_proto = GetFloatInitializer(graph_, input_defs[1]);
+  if (weight_tensor_proto == nullptr || (!is_conv && weight_tensor_proto->dims_size() != 2)) {
+    return;
+  }
+  const TensorProto* bias_tensor_proto = nullptr;
+  if (!is_matmul && input_defs.size() > 2 && input_defs[2]->Exists()) {
+    bias_tensor_proto = GetFloatInitializer(graph_, input_defs[2]);
+    if (bias_tensor_proto == nullptr) {
+      return;
+    }
+  }
+
+  std::vector<int64_t> weight_dims(weight_tensor_proto->dims().begin(), weight_tensor_proto->dims().end());
+  bool transpose_weight = false;
+  if (is_gemm) {
+    // y = x * w + bias as a 1x1 convolution of the rows of x, which takes the weight as [N, K]
+    if (GetIntAttribute(node, "transA", 0) != 0 || GetFloatAttribute(node, "alpha", 1.f) != 1.f ||
+        (bias_tensor_proto != nullptr && GetFloatAttribute(node, "beta", 1.f) != 1.f)) {
+      return;
+    }
+    transpose_weight = GetIntAttribute(node, "transB", 0) == 0;
+    if (transpose_weight) {
+      std::swap(weight_dims[0], weight_dims[1]);
+    }
+    if (bias_tensor_proto != nullptr) {
+      int64_t bias_size = 1;
+      for (auto dim : bias_tensor_proto->dims()) {
+        bias_size *= dim;
+      }
+      if (bias_size != weight_dims[0]) {
+        return;
+      }
+    }
+    weight_dims.push_back(1);
+    weight_dims.push_back(1);
+  } else if (bias_tensor_proto != nullptr && bias_tensor_proto->dims_size() != 1) {
+    return;
+  }
+
+  QuantizedArgument* x = GetQuantizedInput(input_defs[0]);
+  QuantizedArgument w = AddQuantizedWeight(*weight_tensor_proto, weight_dims, transpose_weight);
+  QuantizedArgument* y = CreateQuantizedOutput(output_defs[0]);
+
+  NodeArg* x_input = x->quantized_arg_;
+  NodeArg* y_output = y->quantized_arg_;
+  if (is_gemm) {
+    x_input = AddReshape(x_input, {0, -1, 1, 1}, NewQuantizedArgument(input_defs[0]));
+    y_output = NewQuantizedArgument(output_defs[0]);
+    AddReshape(y_output, {0, -1}, y->quantized_arg_);
+  }
+
+  std::vector<NodeArg*> quantized_inputs{x_input, x->scale_, x->zero_point_,
+                                         w.quantized_arg_, w.scale_, w.zero_point_,
+                                         y->scale_, y->zero_point_};
+  if (bias_tensor_proto != nullptr) {
+    quantized_inputs.push_back(AddQuantizedBias(*bias_tensor_proto, x->scale_value_ * w.scale_value_));
+  }
+
+  const std::string op_type = is_matmul ? "QLinearMatMul" : "QLinearConv";
+  graph_.AddNode(graph_.GenerateNodeName(op_type + "_" + node.Name()),
+                 op_type,
+                 "quantized " + node.Name(),
+                 quantized_inputs,
+                 std::vector<NodeArg*>{y_output},
+                 is_conv ? &node.GetAttributes() : nullptr,
+                 kMSDomain);
+
+  RemoveNode(node);
+}
+
+bool QuantizationTransformerImpl::Finalize() {
+  // Collect the tensors that are still consumed in float.
+  std::unordered_set<const NodeArg*> consumed_args;
+  for (auto& node : graph_.Nodes()) {
+    for (const auto* input_def : node.InputDefs()) {
+      consumed_args.insert(input_def);
+    }
+    for (const auto* input_def : node.ImplicitInputDefs()) {
+      consumed_args.insert(input_def);
+    }
+  }
+  for (const auto* output : graph_.GetOutputs()) {
+    consumed_args.insert(output);
+  }
+
+  for (auto index : dequantize_outputs_) {
+    Node* dequantize = graph_.GetNode(index);
+    if (consumed_args.count(dequantize->OutputDefs()[0]) == 0) {
+      graph_.RemoveNode(index);
+    }
+  }
+
+  return modified_;
+}
+
+}  // namespace
+
+Status QuantizationTransformer::Apply(Graph& graph, bool& modified) const {
+  QuantizationTransformerImpl impl(graph, ranges_);
+  GraphViewer graph_viewer(graph);
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto node = graph.GetNode(index);
+    if (node != nullptr) {
+      impl.Transform(*node);
+    }
+  }
+
+  if (impl.Finalize()) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+// The range [min, max] of the float values of each tensor, by name.
+using QuantizationRanges = std::unordered_map<std::string, std::pair<float, float>>;
+
+// Transformer that quantizes the float Conv, MatMul and Gemm nodes whose input and output have a range, e.g. one
+// calibrated by a session with SessionOptions::enable_quantization_calibration, to QLinearConv and QLinearMatMul
+// nodes that compute in uint8. Each value is quantized per tensor, by the scale and zero point that map its range
+// extended to include 0 onto [0, 255]. The weights and biases must be initializers, which are quantized by their own
+// range and by the product of the input and weight scales respectively. A Gemm must have transA = 0 and alpha = 1 and
+// becomes a 1x1 QLinearConv between Reshapes, so that its bias is added to the int32 product.
+// QuantizeLinear nodes are inserted where a quantized value is first needed and DequantizeLinear nodes where the
+// float value is still consumed, so consecutive quantized nodes exchange uint8 tensors.
+class QuantizationTransformer : public onnxruntime::GraphTransformer {
+ public:
+  explicit QuantizationTransformer(const QuantizationRanges& ranges)
+      : onnxruntime::GraphTransformer("QuantizationTransformer", "Quantize Conv, MatMul and Gemm nodes to uint8"),
+        ranges_(ranges) {}
+
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+
+ private:
+  const QuantizationRanges ranges_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,417 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/symbolic_shape_folding.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+namespace {
+
+bool IsOnnxDomain(const std::string& domain) {
+  return domain == kOnnxDomain || domain == kOnnxDomainAlias;
+}
+
+bool GetInt64Values(const TensorProto& tensor_proto, std::vector<int64_t>& values) {
+  if (tensor_proto.data_type() != TensorProto_DataType_INT64 || utils::HasExternalData(tensor_proto)) {
+    return false;
+  }
+  if (tensor_proto.has_raw_data()) {
+    values.resize(tensor_proto.raw_data().size() / sizeof(int64_t));
+    std::memcpy(values.data(), tensor_proto.raw_data().data(), values.size() * sizeof(int64_t));
+  } else {
+    values.assign(tensor_proto.int64_data().cbegin(), tensor_proto.int64_data().cend());
+  }
+  return true;
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  auto& attributes = node.GetAttributes();
+  auto attr = attributes.find(name);
+  return attr != attributes.end() ? attr->second.i() : default_value;
+}
+
+bool GetIntsAttribute(const Node& node, const std::string& name, std::vector<int64_t>& values) {
+  auto& attributes = node.GetAttributes();
+  auto attr = attributes.find(name);
+  if (attr == attributes.end()) {
+    return false;
+  }
+  values.assign(attr->second.ints().cbegin(), attr->second.ints().cend());
+  return true;
+}
+
+// an element of a shape tensor: a value, the dim axis of tensor, whose dim_param is symbol if it has one, or unknown
+struct SymbolicDim {
+  enum Kind { kUnknown, kValue, kDimOf };
+
+  Kind kind = kUnknown;
+  int64_t value = 0;
+  const NodeArg* tensor = nullptr;
+  int64_t axis = 0;
+  std::string symbol;
+
+  static SymbolicDim Value(int64_t value) {
+    SymbolicDim dim;
+    dim.kind = kValue;
+    dim.value = value;
+    return dim;
+  }
+
+  bool IsValue(int64_t v) const { return kind == kValue && value == v; }
+};
+
+// the elements of an int64 tensor of rank 0 or 1
+struct SymbolicValue {
+  bool scalar = false;
+  std::vector<SymbolicDim> elements;
+};
+
+// x op y, keeping the dim of a tensor through the identities of the op
+SymbolicDim Combine(const std::string& op_type, const SymbolicDim& x, const SymbolicDim& y) {
+  if (x.kind == SymbolicDim::kValue && y.kind == SymbolicDim::kValue) {
+    if (op_type == "Add") return SymbolicDim::Value(x.value + y.value);
+    if (op_type == "Sub") return SymbolicDim::Value(x.value - y.value);
+    if (op_type == "Mul") return SymbolicDim::Value(x.value * y.value);
+    if (y.value != 0) return SymbolicDim::Value(x.value / y.value);
+    return SymbolicDim();
+  }
+  if ((op_type == "Mul" || op_type == "Div") && y.IsValue(1)) return x;
+  if (op_type == "Mul" && x.IsValue(1)) return y;
+  if ((op_type == "Add" || op_type == "Sub") && y.IsValue(0)) return x;
+  if (op_type == "Add" && x.IsValue(0)) return y;
+  return SymbolicDim();
+}
+
+// Computes the elements of the int64 tensors that shape arithmetic produces from initializers and the dims of other
+// tensors. The results are kept for each NodeArg, as the chains of several Reshapes often share nodes.
+class ShapeEvaluator {
+ public:
+  explicit ShapeEvaluator(Graph& graph) : graph_(graph) {}
+
+  // the elements of input input_index of node, nullptr if their number is not known
+  const SymbolicValue* Evaluate(const Node& node, int input_index);
+
+ private:
+  bool EvaluateNode(const Node& node, SymbolicValue& result);
+  bool EvaluateSlice(const Node& node, SymbolicValue& result);
+  bool GetConstantInput(const Node& node, int input_index, std::vector<int64_t>& values) const;
+
+  Graph& graph_;
+  // nullptr for the values that are not computable
+  std::unordered_map<const NodeArg*, std::unique_ptr<SymbolicValue>> values_;
+};
+
+bool ShapeEvaluator::GetConstantInput(const Node& node, int input_index, std::vector<int64_t>& values) const {
+  const TensorProto* tensor_proto = nullptr;
+  return static_cast<int>(node.InputDefs().size()) > input_index && node.InputDefs()[input_index]->Exists() &&
+         graph_.GetInitializedTensor(node.InputDefs()[input_index]->Name(), tensor_proto) &&
+         GetInt64Values(*tensor_proto, values);
+}
+
+const SymbolicValue* ShapeEvaluator::Evaluate(const Node& node, int input_index) {
+  const NodeArg* arg = node.InputDefs()[input_index];
+  auto it = values_.find(arg);
+  if (it != values_.end()) {
+    return it->second.get();
+  }
+
+  auto result = std::make_unique<SymbolicValue>();
+  bool computed = false;
+  const TensorProto* tensor_proto = nullptr;
+  std::vector<int64_t> values;
+  if (graph_.GetInitializedTensor(arg->Name(), tensor_proto)) {
+    computed = tensor_proto->dims_size() <= 1 && GetInt64Values(*tensor_proto, values);
+    result->scalar = tensor_proto->dims_size() == 0;
+    for (auto value : values) {
+      result->elements.push_back(SymbolicDim::Value(value));
+    }
+  } else {
+    const Node* producer = utils::GetInputNode(graph_, node, input_index);
+    computed = producer != nullptr && producer->OutputDefs()[0] == arg && EvaluateNode(*producer, *result);
+  }
+
+  if (!computed) {
+    result.reset();
+  }
+  return (values_[arg] = std::move(result)).get();
+}
+
+bool ShapeEvaluator::EvaluateSlice(const Node& node, SymbolicValue& result) {
+  std::vector<int64_t> starts, ends, axes{0}, steps{1};
+  if (node.Op() != nullptr && node.Op()->since_version() >= 10) {
+    if (!GetConstantInput(node, 1, starts) || !GetConstantInput(node, 2, ends) ||
+        (node.InputDefs().size() > 3 && node.InputDefs()[3]->Exists() && !GetConstantInput(node, 3, axes)) ||
+        (node.InputDefs().size() > 4 && node.InputDefs()[4]->Exists() && !GetConstantInput(node, 4, steps))) {
+      return false;
+    }
+  } else if (!GetIntsAttribute(node, "starts", starts) || !GetIntsAttribute(node, "ends", ends)) {
+    return false;
+  } else {
+    GetIntsAttribute(node, "axes", axes);
+  }
+  if (starts.size() != 1 || ends.size() != 1 || axes.size() != 1 || (axes[0] != 0 && axes[0] != -1) ||
+      steps.size() != 1 || steps[0] != 1) {
+    return false;
+  }
+
+  const SymbolicValue* input = Evaluate(node, 0);
+  if (input == nullptr || input->scalar) {
+    return false;
+  }
+  const int64_t size = static_cast<int64_t>(input->elements.size());
+  auto clamp = [size](int64_t index) {
+    if (index < 0) {
+      index += size;
+    }
+    return std::max<int64_t>(0, std::min(index, size));
+  };
+  const int64_t start = clamp(starts[0]);
+  const int64_t end = clamp(ends[0]);
+  for (int64_t i = start; i < end; ++i) {
+    result.elements.push_back(input->elements[i]);
+  }
+  return true;
+}
+
+bool ShapeEvaluator::EvaluateNode(const Node& node, SymbolicValue& result) {
+  if (!IsOnnxDomain(node.Domain())) {
+    return false;
+  }
+  const std::string& op_type = node.OpType();
+
+  if (op_type == "Shape") {
+    const NodeArg* tensor = node.InputDefs()[0];
+    const TensorShapeProto* shape = tensor->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+    for (int i = 0; i < shape->dim_size(); ++i) {
+      SymbolicDim dim;
+      if (shape->dim(i).has_dim_value()) {
+        dim = SymbolicDim::Value(shape->dim(i).dim_value());
+      } else {
+        dim.kind = SymbolicDim::kDimOf;
+        dim.tensor = tensor;
+        dim.axis = i;
+        dim.symbol = shape->dim(i).dim_param();
+      }
+      result.elements.push_back(dim);
+    }
+    return true;
+  }
+
+  if (op_type == "Identity" ||
+      (op_type == "Cast" && GetIntAttribute(node, "to", 0) == TensorProto_DataType_INT64)) {
+    const SymbolicValue* input = Evaluate(node, 0);
+    if (input == nullptr) {
+      return false;
+    }
+    result = *input;
+    return true;
+  }
+
+  if (op_type == "Unsqueeze" || op_type == "Squeeze") {
+    // only the conversions between a scalar and a vector of one element
+    std::vector<int64_t> axes{0};
+    GetIntsAttribute(node, "axes", axes);
+    const SymbolicValue* input = Evaluate(node, 0);
+    if (input == nullptr || input->elements.size() != 1 || axes.size() != 1 || (axes[0] != 0 && axes[0] != -1) ||
+        input->scalar != (op_type == "Unsqueeze")) {
+      return false;
+    }
+    result.elements = input->elements;
+    result.scalar = op_type == "Squeeze";
+    return true;
+  }
+
+  if (op_type == "Gather") {
+    const int64_t axis = GetIntAttribute(node, "axis", 0);
+    const TensorProto* indices_proto = nullptr;
+    std::vector<int64_t> indices;
+    if ((axis != 0 && axis != -1) || !graph_.GetInitializedTensor(node.InputDefs()[1]->Name(), indices_proto) ||
+        indices_proto->dims_size() > 1 || !GetInt64Values(*indices_proto, indices)) {
+      return false;
+    }
+    const SymbolicValue* data = Evaluate(node, 0);
+    if (data == nullptr || data->scalar) {
+      return false;
+    }
+    const int64_t size = static_cast<int64_t>(data->elements.size());
+    for (auto index : indices) {
+      if (index < 0) {
+        index += size;
+      }
+      if (index < 0 || index >= size) {
+        return false;
+      }
+      result.elements.push_back(data->elements[index]);
+    }
+    result.scalar = indices_proto->dims_size() == 0;
+    return true;
+  }
+
+  if (op_type == "Concat") {
+    const int64_t axis = GetIntAttribute(node, "axis", 0);
+    if (axis != 0 && axis != -1) {
+      return false;
+    }
+    for (int i = 0; i < static_cast<int>(node.InputDefs().size()); ++i) {
+      const SymbolicValue* input = Evaluate(node, i);
+      if (input == nullptr || input->scalar) {
+        return false;
+      }
+      result.elements.insert(result.elements.end(), input->elements.cbegin(), input->elements.cend());
+    }
+    return true;
+  }
+
+  if (op_type == "Slice") {
+    return EvaluateSlice(node, result);
+  }
+
+  if (op_type == "Add" || op_type == "Sub" || op_type == "Mul" || op_type == "Div") {
+    const SymbolicValue* x = Evaluate(node, 0);
+    const SymbolicValue* y = Evaluate(node, 1);
+    if (x == nullptr || y == nullptr) {
+      return false;
+    }
+    const size_t x_size = x->elements.size();
+    const size_t y_size = y->elements.size();
+    if (x_size != y_size && x_size != 1 && y_size != 1) {
+      return false;
+    }
+    for (size_t i = 0; i < std::max(x_size, y_size); ++i) {
+      result.elements.push_back(Combine(op_type, x->elements[x_size == 1 ? 0 : i], y->elements[y_size == 1 ? 0 : i]));
+    }
+    result.scalar = x->scalar && y->scalar;
+    return true;
+  }
+
+  return false;
+}
+
+// whether dim, the element index of the shape of a Reshape, is the dim at the same position of its data input
+bool CopiesDim(const NodeArg& data, size_t index, const SymbolicDim& dim) {
+  if (dim.kind != SymbolicDim::kDimOf) {
+    return false;
+  }
+  if (dim.tensor == &data && dim.axis == static_cast<int64_t>(index)) {
+    return true;
+  }
+  const TensorShapeProto* shape = data.Shape();
+  return !dim.symbol.empty() && shape != nullptr && static_cast<int>(index) < shape->dim_size() &&
+         shape->dim(static_cast<int>(index)).dim_param() == dim.symbol;
+}
+
+// the shape that makes reshape compute the same shape as value by itself, with 0 for the dims it copies and -1 for
+// a single dim it infers
+bool GetReshapeShape(const Node& reshape, const SymbolicValue& value, std::vector<int64_t>& shape) {
+  const NodeArg& data = *reshape.InputDefs()[0];
+  bool has_inferred_dim = false;
+  for (auto& dim : value.elements) {
+    if (dim.IsValue(-1)) {
+      has_inferred_dim = true;
+    }
+  }
+  for (size_t i = 0; i < value.elements.size(); ++i) {
+    const SymbolicDim& dim = value.elements[i];
+    if (dim.kind == SymbolicDim::kValue) {
+      shape.push_back(dim.value);
+    } else if (CopiesDim(data, i, dim)) {
+      shape.push_back(0);
+    } else if (!has_inferred_dim) {
+      has_inferred_dim = true;
+      shape.push_back(-1);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// removes node and the nodes it reads from, as long as their outputs are not read
+void RemoveUnusedChain(Graph& graph, NodeIndex index) {
+  Node* node = graph.GetNode(index);
+  if (node == nullptr || node->GetOutputEdgesCount() != 0 || graph.IsNodeOutputsInGraphOutputs(*node)) {
+    return;
+  }
+  std::vector<NodeIndex> producers;
+  for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+    producers.push_back((*it).Index());
+  }
+  graph.RemoveNode(index);
+  for (NodeIndex producer : producers) {
+    RemoveUnusedChain(graph, producer);
+  }
+}
+
+bool FoldReshapeShape(Graph& graph, ShapeEvaluator& evaluator, Node& reshape) {
+  const TensorProto* shape_proto = nullptr;
+  if (reshape.InputDefs().size() < 2 || graph.GetInitializedTensor(reshape.InputDefs()[1]->Name(), shape_proto)) {
+    return false;
+  }
+  Node* producer = utils::GetInputNode(graph, reshape, 1);
+  const SymbolicValue* value = evaluator.Evaluate(reshape, 1);
+  std::vector<int64_t> shape;
+  if (producer == nullptr || value == nullptr || value->scalar || !GetReshapeShape(reshape, *value, shape)) {
+    return false;
+  }
+
+  TensorProto new_shape_proto;
+  new_shape_proto.set_name(graph.GenerateNodeArgName(reshape.InputDefs()[1]->Name() + "_folded"));
+  new_shape_proto.set_data_type(TensorProto_DataType_INT64);
+  new_shape_proto.add_dims(static_cast<int64_t>(shape.size()));
+  for (auto dim : shape) {
+    new_shape_proto.add_int64_data(dim);
+  }
+  graph.AddInitializedTensor(new_shape_proto);
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(static_cast<int64_t>(shape.size()));
+  NodeArg& new_shape_arg = graph.GetOrCreateNodeArg(new_shape_proto.name(), &type);
+
+  for (auto it = reshape.InputEdgesBegin(); it != reshape.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == 1) {
+      graph.RemoveEdge(producer->Index(), reshape.Index(), it->GetSrcArgIndex(), 1);
+      break;
+    }
+  }
+  reshape.MutableInputDefs()[1] = &new_shape_arg;
+  RemoveUnusedChain(graph, producer->Index());
+  return true;
+}
+
+}  // namespace
+
+Status SymbolicShapeFolding::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  GraphViewer graph_viewer(graph);
+  // copied, as the order is invalidated by the nodes removed below
+  const std::vector<NodeIndex> order = graph_viewer.GetNodesInTopologicalOrder();
+
+  ShapeEvaluator evaluator(graph);
+  for (NodeIndex index : order) {
+    Node* node = graph.GetNode(index);
+    if (node != nullptr && node->OpType() == "Reshape" && IsOnnxDomain(node->Domain()) &&
+        FoldReshapeShape(graph, evaluator, *node)) {
+      modified = true;
+    }
+  }
+
+  if (modified) {
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+// Replaces the shape arithmetic that computes the shape input of a Reshape at run time, e.g. the
+// Shape -> Gather -> Unsqueeze -> Concat chains that models exported with a dynamic batch size use, by an initializer.
+// The elements of the computed shape are tracked symbolically: an element is a value, the dim of a tensor (named by
+// its axis and dim_param) or unknown. An element that copies the dim at the same position of the data input becomes
+// 0, and a single unknown element becomes -1, so the Reshape computes the same shape by itself. The nodes of the
+// chain that are no longer read are removed. Re-resolving the graph then propagates the dim_params through the
+// Reshape, as ONNX shape inference copies the input dims that a 0 selects.
+// A shape with more than one element that is neither a value nor such a copy keeps its chain.
+class SymbolicShapeFolding : public onnxruntime::GraphTransformer {
+ public:
+  SymbolicShapeFolding() noexcept
+      : onnxruntime::GraphTransformer("SymbolicShapeFolding", "Fold the shape arithmetic of Reshape targets") {}
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace onnxruntime {
+
+// Tiers of the graph transformations every session applies before partitioning.
+// Each tier includes the transformations of the tiers below it.
+enum class TransformerLevel : int {
+  // no transformations besides the ones registered by the application
+  None = 0,
+  // semantics preserving eliminations of redundant nodes (Identity, Unsqueeze of initializers, nodes that compute
+  // the same value, Transposes and Reshapes that cancel), the folding of the shape arithmetic of Reshape targets
+  // into shapes with 0 and -1, and the folding of nodes whose inputs are all constant, which the session registers
+  // as it needs the CPU kernels
+  Basic = 1,
+  // unrolling of Loops with a constant trip count and a small body, and the folding of BatchNormalization, Mul and
+  // Add into Conv and of MatMul and Add into Gemm.
+  // the unrolled and fused nodes are standard ONNX ops that every execution provider can run.
+  Extended = 2,
+  // fusions into contrib ops that only the CPU execution provider implements (FusedConv, FusedGemm and the
+  // NCHWc layout), so nodes another provider could run may move to the CPU, and the fusion of the layer
+  // normalization, GELU and attention of transformer models and of the normalization and transpose of uint8 images
+  // into contrib ops of the CPU and CUDA providers
+  All = 3,
+};
+
+}  // namespace onnxruntime
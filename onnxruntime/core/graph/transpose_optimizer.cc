@@ -0,0 +1,274 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/transpose_optimizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+namespace {
+
+// ops that compute each output element from the input elements at the same position, so they give the same result
+// in any layout
+const std::unordered_set<std::string> kElementwiseOps = {
+    "Abs", "Neg", "Relu", "LeakyRelu", "Sigmoid", "HardSigmoid", "Tanh", "Elu", "Selu", "Softsign", "Softplus",
+    "Exp", "Log", "Sqrt", "Reciprocal", "Floor", "Ceil", "Clip", "Cast", "Not",
+    "Add", "Sub", "Mul", "Div", "Pow", "PRelu"};
+
+bool IsOnnxDomain(const std::string& domain) {
+  return domain == kOnnxDomain || domain == kOnnxDomainAlias;
+}
+
+bool IsOnnxNode(const Node& node, const char* op_type) {
+  return node.OpType() == op_type && IsOnnxDomain(node.Domain());
+}
+
+bool HasSingleConsumer(Graph& graph, const Node& node) {
+  return node.GetOutputEdgesCount() == 1 && !graph.IsNodeOutputsInGraphOutputs(node);
+}
+
+void RemoveIfUnused(Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() == 0 && !graph.IsNodeOutputsInGraphOutputs(node)) {
+    graph.RemoveNode(node.Index());
+  }
+}
+
+// removes a node whose output equals its first input, making its consumers read that input
+bool Bypass(Graph& graph, Node& node) {
+  if (!utils::CanRemoveNode(graph, node)) {
+    return false;
+  }
+  utils::RemoveNodeAndForwardInput(graph, node);
+  return true;
+}
+
+bool GetInt64Values(const TensorProto& tensor_proto, std::vector<int64_t>& values) {
+  if (tensor_proto.data_type() != TensorProto_DataType_INT64 || utils::HasExternalData(tensor_proto)) {
+    return false;
+  }
+  if (tensor_proto.has_raw_data()) {
+    values.resize(tensor_proto.raw_data().size() / sizeof(int64_t));
+    std::memcpy(values.data(), tensor_proto.raw_data().data(), values.size() * sizeof(int64_t));
+  } else {
+    values.assign(tensor_proto.int64_data().cbegin(), tensor_proto.int64_data().cend());
+  }
+  return true;
+}
+
+// the permutation of a Transpose, which reverses the dims if it has no perm attribute
+bool GetPerm(const Node& node, std::vector<int64_t>& perm) {
+  auto& attributes = node.GetAttributes();
+  auto perm_attr = attributes.find("perm");
+  if (perm_attr != attributes.end()) {
+    perm.assign(perm_attr->second.ints().cbegin(), perm_attr->second.ints().cend());
+    return true;
+  }
+
+  const TensorShapeProto* shape = node.InputDefs()[0]->Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+  for (int i = shape->dim_size() - 1; i >= 0; --i) {
+    perm.push_back(i);
+  }
+  return true;
+}
+
+bool IsIdentity(const std::vector<int64_t>& perm) {
+  for (size_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// dim i of the output of a Transpose with perm is dim perm[i] of its input
+void PermuteShape(NodeArg& arg, const std::vector<int64_t>& perm) {
+  const TensorShapeProto* shape = arg.Shape();
+  if (shape == nullptr || shape->dim_size() != static_cast<int>(perm.size())) {
+    return;
+  }
+  TensorShapeProto permuted;
+  for (int64_t axis : perm) {
+    *permuted.add_dim() = shape->dim(static_cast<int>(axis));
+  }
+  arg.SetShape(permuted);
+}
+
+bool IsSingleElementInitializer(const Graph& graph, const NodeArg& arg, size_t rank) {
+  const TensorProto* tensor_proto = nullptr;
+  if (!graph.GetInitializedTensor(arg.Name(), tensor_proto) || static_cast<size_t>(tensor_proto->dims_size()) > rank) {
+    return false;
+  }
+  for (auto dim : tensor_proto->dims()) {
+    if (dim != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the input of an element-wise node that carries the layout, or -1 if there isn't exactly one.
+// the other inputs must broadcast the same in every layout of the given rank.
+int GetLayoutInput(const Graph& graph, const Node& node, size_t rank) {
+  if (kElementwiseOps.count(node.OpType()) == 0 || !IsOnnxDomain(node.Domain()) || node.OutputDefs().size() != 1) {
+    return -1;
+  }
+
+  int layout_input = -1;
+  for (int i = 0; i < static_cast<int>(node.InputDefs().size()); ++i) {
+    const NodeArg& input_def = *node.InputDefs()[i];
+    if (!input_def.Exists() || IsSingleElementInitializer(graph, input_def, rank)) {
+      continue;
+    }
+    if (layout_input != -1) {
+      return -1;
+    }
+    layout_input = i;
+  }
+  return layout_input;
+}
+
+// makes a Transpose read the input of the Transpose before it, possibly across a chain of element-wise nodes
+bool MergeTransposes(Graph& graph, Node& transpose) {
+  std::vector<int64_t> perm;
+  if (!GetPerm(transpose, perm)) {
+    return false;
+  }
+
+  // the element-wise nodes in between, from the last one, and the inputs that carry the layout through them
+  std::vector<Node*> chain;
+  std::vector<int> chain_inputs;
+  Node* current = &transpose;
+  int input_index = 0;
+  Node* first = nullptr;
+  while (true) {
+    Node* producer = utils::GetInputNode(graph, *current, input_index);
+    if (producer == nullptr) {
+      return false;
+    }
+    if (IsOnnxNode(*producer, "Transpose")) {
+      first = producer;
+      break;
+    }
+
+    // the nodes of the chain change layout, so nothing else may read their outputs
+    const int layout_input = GetLayoutInput(graph, *producer, perm.size());
+    if (layout_input < 0 || !HasSingleConsumer(graph, *producer)) {
+      return false;
+    }
+    chain.push_back(producer);
+    chain_inputs.push_back(layout_input);
+    current = producer;
+    input_index = layout_input;
+  }
+
+  std::vector<int64_t> first_perm;
+  if (!GetPerm(*first, first_perm) || first_perm.size() != perm.size()) {
+    return false;
+  }
+
+  // the chain now runs in the layout of the input of the first Transpose
+  std::vector<int64_t> inverse_perm(first_perm.size());
+  for (size_t i = 0; i < first_perm.size(); ++i) {
+    inverse_perm[first_perm[i]] = static_cast<int64_t>(i);
+  }
+  for (Node* node : chain) {
+    PermuteShape(*node->MutableOutputDefs()[0], inverse_perm);
+  }
+
+  Node& head = chain.empty() ? transpose : *chain.back();
+  utils::ReplaceNodeInput(graph, head, chain.empty() ? 0 : chain_inputs.back(), *first, 0);
+
+  std::vector<int64_t> composed_perm(perm.size());
+  for (size_t i = 0; i < perm.size(); ++i) {
+    composed_perm[i] = first_perm[perm[i]];
+  }
+  transpose.AddAttribute("perm", composed_perm);
+
+  RemoveIfUnused(graph, *first);
+  return true;
+}
+
+// makes a Reshape read the input of the Reshape before it
+bool MergeReshapes(Graph& graph, Node& reshape) {
+  Node* producer = utils::GetInputNode(graph, reshape, 0);
+  const TensorProto* shape_proto = nullptr;
+  if (producer == nullptr || !IsOnnxNode(*producer, "Reshape") || reshape.InputDefs().size() < 2 ||
+      !graph.GetInitializedTensor(reshape.InputDefs()[1]->Name(), shape_proto)) {
+    return false;
+  }
+
+  // a 0 copies the dim of the input, which differs between the two inputs
+  std::vector<int64_t> shape;
+  if (!GetInt64Values(*shape_proto, shape) || std::find(shape.cbegin(), shape.cend(), 0) != shape.cend()) {
+    return false;
+  }
+
+  utils::ReplaceNodeInput(graph, reshape, 0, *producer, 0);
+  RemoveIfUnused(graph, *producer);
+  return true;
+}
+
+bool HasSameStaticShape(const NodeArg& a, const NodeArg& b) {
+  const TensorShapeProto* a_shape = a.Shape();
+  const TensorShapeProto* b_shape = b.Shape();
+  if (a_shape == nullptr || b_shape == nullptr || a_shape->dim_size() != b_shape->dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < a_shape->dim_size(); ++i) {
+    if (!a_shape->dim(i).has_dim_value() || !b_shape->dim(i).has_dim_value() ||
+        a_shape->dim(i).dim_value() != b_shape->dim(i).dim_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Status TransposeOptimizer::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  GraphViewer graph_viewer(graph);
+  // copied, as the order is invalidated by the nodes removed below
+  const std::vector<NodeIndex> order = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (NodeIndex index : order) {
+    Node* node = graph.GetNode(index);
+    if (node == nullptr) {
+      continue;
+    }
+
+    if (IsOnnxNode(*node, "Transpose")) {
+      if (MergeTransposes(graph, *node)) {
+        modified = true;
+      }
+      std::vector<int64_t> perm;
+      if (GetPerm(*node, perm) && IsIdentity(perm) && Bypass(graph, *node)) {
+        modified = true;
+      }
+    } else if (IsOnnxNode(*node, "Reshape")) {
+      if (MergeReshapes(graph, *node)) {
+        modified = true;
+      }
+      if (HasSameStaticShape(*node->InputDefs()[0], *node->OutputDefs()[0]) && Bypass(graph, *node)) {
+        modified = true;
+      }
+    }
+  }
+
+  if (modified) {
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+// Removes the layout shuffles of models converted from NHWC frameworks.
+// A Transpose that follows another Transpose reads the input of the first one with the composed permutation, also
+// when a chain of element-wise ops is in between: the first Transpose is then removed and the element-wise ops run
+// in the input layout. Binary element-wise ops are only crossed when the other input is an initializer with a
+// single element, which broadcasts the same in every layout.
+// A Reshape that follows another Reshape reads the input of the first one, unless its shape copies dims with 0.
+// Transposes with an identity permutation and Reshapes to the shape of their input are removed.
+class TransposeOptimizer : public onnxruntime::GraphTransformer {
+ public:
+  TransposeOptimizer() noexcept
+      : onnxruntime::GraphTransformer("TransposeOptimizer", "Cancel and merge Transpose and Reshape nodes") {}
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+};
+
+}  // namespace onnxruntime
@@ -4,13 +4,28 @@
 #pragma once
 
 #include "core/graph/graph_transformer.h"
+#include "core/graph/rewrite_rule.h"
 
 namespace onnxruntime {
 
-class UnsqueezeElimination : public onnxruntime::GraphTransformer {
+// Rewrite rule that removes an Unsqueeze of an initializer by reshaping the initializer.
+class EliminateUnsqueeze : public RewriteRule {
  public:
-  UnsqueezeElimination() noexcept : onnxruntime::GraphTransformer("EliminateUnsqueeze", "Eliminate unsequeeze node") {}
-  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+  EliminateUnsqueeze() noexcept : RewriteRule("EliminateUnsqueeze", "Eliminate unsqueeze node") {}
+
+ private:
+  bool SatisfyCondition(const Node& node) override;
+
+  Status Apply(Graph& graph, Node& node, bool& modified) override;
+};
+
+// Applies EliminateUnsqueeze on its own; the default transformers combine it with the other rules of their level.
+class UnsqueezeElimination : public onnxruntime::TopDownRuleBasedTransformer {
+ public:
+  UnsqueezeElimination()
+      : onnxruntime::TopDownRuleBasedTransformer("UnsqueezeElimination", "Eliminate unsequeeze node") {
+    Register("Unsqueeze", std::make_unique<EliminateUnsqueeze>());
+  }
 };
 
 }  // namespace onnxruntime
@@ -75,6 +75,20 @@ MlasActivation(
 //
 // Single precision matrix/matrix multiply routine.
 //
+// The optional epilogue is the output stage of the operation. It is applied
+// to each block of matrix C as soon as the block has been accumulated, while
+// the block is still in the cache, which avoids a separate pass over matrix C.
+// The addend and column bias are added first, then the row bias is added and
+// the activation is applied.
+//
+
+struct MLAS_SGEMM_EPILOGUE {
+    const MLAS_ACTIVATION* Activation;
+    const float* RowBias;
+    const float* ColumnBias;
+    const float* Addend;
+    size_t ldaddend;
+};
 
 void
 MLASCALL
@@ -91,9 +105,303 @@ MlasSgemm(
     size_t ldb,
     float beta,
     float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
+    );
+
+//
+// Single precision matrix/matrix multiply routine using a matrix B of
+// half-precision floats, such as a weight stored as float16. Each panel of
+// matrix B is converted to single precision as it is packed, so the full
+// matrix is never expanded.
+//
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const unsigned short* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
+    );
+
+//
+// Single precision matrix/matrix multiply routine using a matrix B of 8-bit
+// integers and a scale for each column of matrix C, such as a weight quantized
+// per output channel. Each panel of matrix B is dequantized to single
+// precision as it is packed, so the full matrix is never expanded.
+//
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int8_t* B,
+    size_t ldb,
+    const float* ScaleB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
+    );
+
+// Single precision matrix/matrix multiply routines using a matrix B that is
+// packed once and reused across calls, such as a constant weight.
+//
+// N.B. The packed buffer must be aligned to 64 bytes.
+//
+
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSgemmPacked(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
+    );
+
+//
+// Single precision matrix/matrix multiply routines using a matrix B with
+// blocks of zeros, such as a pruned weight. Matrix B is packed once into strips
+// of 16 columns, of which only the blocks of 16 rows with a nonzero element are
+// kept, so the blocks of zeros are neither stored nor multiplied.
+//
+// N.B. The packed buffer must be aligned to 64 bytes.
+//
+
+float
+MLASCALL
+MlasSgemmBlockSparseDensity(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+size_t
+MLASCALL
+MlasSgemmPackBlockSparseBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+void
+MLASCALL
+MlasSgemmPackBlockSparseB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSgemmBlockSparse(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
+    );
+
+//
+// Batched single precision matrix/matrix multiply routine. Each operation of
+// the batch shares the same dimensions and locates its matrices by an element
+// offset from the base addresses.
+//
+
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const size_t* OffsetsA,
+    const float* B,
+    size_t ldb,
+    const size_t* OffsetsB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const size_t* OffsetsC,
+    size_t BatchCount
+    );
+
+//
+// Single precision matrix/vector multiply routine.
+//
+// y = alpha * op(A) * x + beta * y, where A has M rows and N columns.
+//
+
+void
+MLASCALL
+MlasSgemv(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* x,
+    float beta,
+    float* y
+    );
+
+//
+// Quantized integer matrix/matrix multiply routines.
+//
+// C = (A - offa) * (B - offb), where A is unsigned 8-bit and B is either
+// unsigned or signed 8-bit. C is stored as 32-bit integers.
+//
+
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
     size_t ldc
     );
 
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc
+    );
+
+//
+// Requantizes a matrix of 32-bit integers to unsigned 8-bit integers using a
+// fixed point multiplier and right shift, optionally adding a per row bias
+// first. Rounding and saturation match the gemmlowp output pipeline.
+//
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    int32_t Multiplier,
+    int32_t RightShift,
+    uint8_t ZeroPoint
+    );
+
+//
+// Linear quantization routines. The quantized value of an element is the
+// element divided by the scale, rounded to nearest with halfway cases away
+// from zero, plus the zero point, saturated to the range of the output type.
+//
+
+void
+MLASCALL
+MlasQuantizeLinear(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    );
+
 //
 // Convolution routines.
 //
@@ -102,6 +410,8 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
+    MlasConvAlgorithmDepthwise,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -129,6 +439,16 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t OutputTileSize;
+            size_t TileCountHeight;
+            size_t TileCountWidth;
+            size_t TileBlockSize;
+            int32_t TargetThreadCount;
+        } Winograd;
+        struct {
+            int32_t TargetThreadCount;
+        } Depthwise;
     } u;
 };
 
@@ -151,6 +471,20 @@ MlasConvPrepare(
     size_t* WorkingBufferSize
     );
 
+//
+// Overrides the algorithm MlasConvPrepare selected, e.g. to time the
+// algorithms that can perform a convolution. Returns false if the algorithm
+// can't perform the convolution.
+//
+
+bool
+MLASCALL
+MlasConvPrepareAlgorithm(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_CONV_ALGORITHM Algorithm,
+    size_t* WorkingBufferSize
+    );
+
 void
 MLASCALL
 MlasConv(
@@ -162,6 +496,31 @@ MlasConv(
     float* Output
     );
 
+//
+// The Winograd convolution algorithm consumes a transformed filter. The
+// caller transforms a constant filter once and passes the transformed filter
+// to MlasConv when MlasConvPrepare selects MlasConvAlgorithmWinograd.
+//
+
+size_t
+MLASCALL
+MlasConvWinogradGetTransformedFilterSize(
+    size_t Dimensions,
+    size_t GroupCount,
+    size_t InputChannels,
+    const int64_t* KernelShape,
+    size_t FilterCount
+    );
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* TransformedFilter
+    );
+
 //
 // Pooling routines.
 //
@@ -186,6 +545,75 @@ MlasPool(
     float* Output
     );
 
+//
+// Blocked channel (NCHWc) routines.
+//
+// Tensors in the NCHWc format store the channels in blocks of the size
+// returned by MlasNchwcGetBlockSize, with the channel count padded to a
+// multiple of the block size. The shapes passed to MlasNchwcConv and
+// MlasNchwcPool use the padded channel counts.
+//
+
+size_t
+MLASCALL
+MlasNchwcGetBlockSize(
+    void
+    );
+
+void
+MLASCALL
+MlasReorderInput(
+    const int64_t* InputShape,
+    const float* S,
+    float* D
+    );
+
+void
+MLASCALL
+MlasReorderOutput(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D
+    );
+
+void
+MLASCALL
+MlasReorderFilter(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    );
+
+void
+MLASCALL
+MlasNchwcConv(
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation
+    );
+
+void
+MLASCALL
+MlasNchwcPool(
+    MLAS_POOLING_KIND PoolingKind,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output
+    );
+
 //
 // Miscellaneous compute routines.
 //
@@ -206,6 +634,145 @@ MlasComputeTanh(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeErf(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeGelu(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+//
+// Computes the softmax or log softmax function for each of the N rows of D
+// elements. Rows are distributed across threads.
+//
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    );
+
+//
+// Transposes each of BatchCount matrices of M rows and N columns of 32-bit
+// elements. Tiles of rows are distributed across threads.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t BatchCount,
+    size_t M,
+    size_t N
+    );
+
+//
+// Threading routines.
+//
+// By default, MLAS uses the Windows thread pool or OpenMP, if available, to
+// parallelize operations. The host may instead supply its own thread pool so
+// that all MLAS operations share the threads used by the rest of the process.
+//
+
+typedef
+void
+(MLAS_THREADED_ROUTINE)(
+    void* Context,
+    int32_t Index
+    );
+
+typedef MLAS_THREADED_ROUTINE* PMLAS_THREADED_ROUTINE;
+
+typedef
+void
+(MLASCALL MLAS_EXECUTE_THREADED_CALLBACK)(
+    void* ThreadPool,
+    PMLAS_THREADED_ROUTINE ThreadedRoutine,
+    void* Context,
+    int32_t Iterations
+    );
+
+typedef MLAS_EXECUTE_THREADED_CALLBACK* PMLAS_EXECUTE_THREADED_CALLBACK;
+
+void
+MLASCALL
+MlasSetThreadPool(
+    PMLAS_EXECUTE_THREADED_CALLBACK ExecuteThreadedCallback,
+    void* ThreadPool,
+    int32_t MaximumThreadCount
+    );
+
+//
+// The number of threads used by operations started from the calling thread
+// may be further limited, for example to bound the share of the thread pool
+// used by a single request. A limit of zero removes the limit.
+//
+
+void
+MLASCALL
+MlasSetThreadLimit(
+    int32_t ThreadLimit
+    );
+
+int32_t
+MLASCALL
+MlasGetThreadLimit(
+    void
+    );
+
+//
+// Operations started from the calling thread may be cancelled, for example
+// once the request they compute has missed its deadline. The callback is
+// polled between the blocks of threaded work, and the blocks that remain once
+// it returns true are skipped, leaving the output of the operation undefined.
+// Supply nullptr to remove the cancellation.
+//
+
+typedef
+bool
+(MLASCALL MLAS_CANCELLATION_CALLBACK)(
+    void* Context
+    );
+
+struct MLAS_CANCELLATION {
+    MLAS_CANCELLATION_CALLBACK* IsCancelled;
+    void* Context;
+};
+
+void
+MLASCALL
+MlasSetCancellation(
+    const MLAS_CANCELLATION* Cancellation
+    );
+
+const MLAS_CANCELLATION*
+MLASCALL
+MlasGetCancellation(
+    void
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -218,3 +785,11 @@ MlasConvertHalfToFloatBuffer(
     float* Destination,
     size_t Count
     );
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
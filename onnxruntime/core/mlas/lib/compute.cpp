@@ -0,0 +1,541 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements routines to compute the exponential, error and
+    GELU functions and the softmax function for a set of rows.
+
+    The kernels are templated in compute.h. The implementation below targets
+    the base instruction set (typically SSE2) while the kernel modules target
+    newer instruction sets (such as AVX2 and AVX512F).
+
+--*/
+
+#include "compute.h"
+
+//
+// Define the constants for the exponential and error functions.
+//
+
+const MLAS_EXP_CONSTANTS MlasExpConstants = {
+    -103.9720840454f,
+    88.7762626647950f,
+    12582912.0f,
+    1.44269504088896341f,
+    -6.93145752e-1f,
+    -1.42860677e-6f,
+    1.378059387e-03f,
+    8.373124525e-03f,
+    4.166953638e-02f,
+    1.666647196e-01f,
+    4.999998510e-01f,
+    1.0f,
+    1.0f,
+    -126.0f,
+    127.0f,
+};
+
+const MLAS_ERF_CONSTANTS MlasErfConstants = {
+    1.0f,
+    3.925f,
+    1.128379167e+00f,
+    -3.761263890e-01f,
+    1.128379167e-01f,
+    -2.686617065e-02f,
+    5.223977625e-03f,
+    -8.548327023e-04f,
+    1.205533298e-04f,
+    -1.492565036e-05f,
+    1.646211437e-06f,
+    -1.636584469e-07f,
+    0.3275911f,
+    0.254829592f,
+    -0.284496736f,
+    1.421413741f,
+    -1.453152027f,
+    1.061405429f,
+};
+
+//
+// Define the vector operations for the four element vector type.
+//
+
+struct MLAS_COMPUTE_VECTOR_FLOAT32X4 {
+
+    typedef MLAS_FLOAT32X4 Type;
+
+    static constexpr size_t Lanes = 4;
+
+    static MLAS_FLOAT32X4 Zero() { return MlasZeroFloat32x4(); }
+
+    static MLAS_FLOAT32X4 Load(const float* p) { return MlasLoadFloat32x4(p); }
+
+    static void Store(float* p, MLAS_FLOAT32X4 v) { MlasStoreFloat32x4(p, v); }
+
+    static MLAS_FLOAT32X4 Broadcast(float f) { return MlasBroadcastFloat32x4(f); }
+
+    static MLAS_FLOAT32X4 Add(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b) { return MlasAddFloat32x4(a, b); }
+
+    static MLAS_FLOAT32X4 Subtract(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b) { return MlasSubtractFloat32x4(a, b); }
+
+    static MLAS_FLOAT32X4 Multiply(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b) { return MlasMultiplyFloat32x4(a, b); }
+
+    static MLAS_FLOAT32X4 MultiplyAdd(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b, MLAS_FLOAT32X4 c)
+    {
+        return MlasMultiplyAddFloat32x4(a, b, c);
+    }
+
+    static MLAS_FLOAT32X4 Divide(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b) { return MlasDivideFloat32x4(a, b); }
+
+    static MLAS_FLOAT32X4 Maximum(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b) { return MlasMaximumFloat32x4(a, b); }
+
+    static MLAS_FLOAT32X4 Minimum(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b) { return MlasMinimumFloat32x4(a, b); }
+
+#if defined(MLAS_NEON_INTRINSICS)
+
+    static float32x4_t Abs(float32x4_t v) { return vabsq_f32(v); }
+
+    static float32x4_t CopySign(float32x4_t m, float32x4_t s)
+    {
+        uint32x4_t SignMask = vdupq_n_u32(0x80000000);
+        return vbslq_f32(SignMask, s, m);
+    }
+
+    static float32x4_t BlendLessThan(float32x4_t a, float32x4_t b, float32x4_t x, float32x4_t y)
+    {
+        return vbslq_f32(vcltq_f32(a, b), x, y);
+    }
+
+    static float32x4_t PowerOf2(float32x4_t v)
+    {
+        int32x4_t Exponent = vaddq_s32(vcvtq_s32_f32(v), vdupq_n_s32(127));
+        return vreinterpretq_f32_s32(vshlq_n_s32(Exponent, 23));
+    }
+
+    static float ReduceAdd(float32x4_t v)
+    {
+        float32x2_t Pair = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpadd_f32(Pair, Pair), 0);
+    }
+
+    static float ReduceMaximum(float32x4_t v)
+    {
+        float32x2_t Pair = vmax_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpmax_f32(Pair, Pair), 0);
+    }
+
+#elif defined(MLAS_SSE2_INTRINSICS)
+
+    static __m128 Abs(__m128 v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+
+    static __m128 CopySign(__m128 m, __m128 s) { return _mm_or_ps(m, _mm_and_ps(_mm_set1_ps(-0.0f), s)); }
+
+    static __m128 BlendLessThan(__m128 a, __m128 b, __m128 x, __m128 y)
+    {
+        __m128 Mask = _mm_cmplt_ps(a, b);
+        return _mm_or_ps(_mm_and_ps(Mask, x), _mm_andnot_ps(Mask, y));
+    }
+
+    static __m128 PowerOf2(__m128 v)
+    {
+        __m128i Exponent = _mm_add_epi32(_mm_cvtps_epi32(v), _mm_set1_epi32(127));
+        return _mm_castsi128_ps(_mm_slli_epi32(Exponent, 23));
+    }
+
+    static float ReduceAdd(__m128 v)
+    {
+        v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+        return _mm_cvtss_f32(v);
+    }
+
+    static float ReduceMaximum(__m128 v)
+    {
+        v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+        v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+        return _mm_cvtss_f32(v);
+    }
+
+#endif
+};
+
+void
+MLASCALL
+MlasExpKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnaryKernel<MLAS_COMPUTE_VECTOR_FLOAT32X4,
+        MlasComputeExpVector<MLAS_COMPUTE_VECTOR_FLOAT32X4>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasErfKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the error function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnaryKernel<MLAS_COMPUTE_VECTOR_FLOAT32X4,
+        MlasComputeErfVector<MLAS_COMPUTE_VECTOR_FLOAT32X4>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasGeluKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the GELU function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnaryKernel<MLAS_COMPUTE_VECTOR_FLOAT32X4,
+        MlasComputeGeluVector<MLAS_COMPUTE_VECTOR_FLOAT32X4>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasSoftmaxKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the softmax function.
+
+Arguments:
+
+    See MlasComputeSoftmaxKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeSoftmaxKernel<MLAS_COMPUTE_VECTOR_FLOAT32X4>(Input, Output, N, D, LogSoftmax);
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ExpKernelRoutine(Input, Output, N);
+#else
+    MlasExpKernel(Input, Output, N);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeErf(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the error function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ErfKernelRoutine(Input, Output, N);
+#else
+    MlasErfKernel(Input, Output, N);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeGelu(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the GELU function, x * 0.5 * (1 + erf(x / sqrt(2))).
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.GeluKernelRoutine(Input, Output, N);
+#else
+    MlasGeluKernel(Input, Output, N);
+#endif
+}
+
+//
+// Define the parameters to execute segments of a softmax operation on worker
+// threads.
+//
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    int32_t TargetThreadCount;
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+    bool LogSoftmax;
+};
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SOFTMAX_WORK_BLOCK* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    //
+    // Partition the rows across the threads.
+    //
+
+    const size_t N = WorkBlock->N;
+    const size_t D = WorkBlock->D;
+
+    const size_t RowsPerThread = N / WorkBlock->TargetThreadCount;
+    const size_t RowsExtra = N % WorkBlock->TargetThreadCount;
+
+    size_t StartN;
+    size_t CountN;
+
+    if (uint32_t(Index) < RowsExtra) {
+        StartN = (RowsPerThread + 1) * Index;
+        CountN = RowsPerThread + 1;
+    } else {
+        StartN = RowsPerThread * Index + RowsExtra;
+        CountN = RowsPerThread;
+    }
+
+    const float* Input = WorkBlock->Input + StartN * D;
+    float* Output = WorkBlock->Output + StartN * D;
+
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.SoftmaxKernelRoutine(Input, Output, CountN, D, WorkBlock->LogSoftmax);
+#else
+    MlasSoftmaxKernel(Input, Output, CountN, D, WorkBlock->LogSoftmax);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function for each row of
+    a matrix.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of elements per row.
+
+    LogSoftmax - Supplies true if the log softmax function is computed, else
+        false if the softmax function is computed.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.LogSoftmax = LogSoftmax;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Limit the number of threads to the number of rows.
+    //
+
+    const double Complexity = double(N) * double(D);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SOFTMAX_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SOFTMAX_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= N) {
+        TargetThreadCount = int32_t(N);
+    }
+
+    if (TargetThreadCount <= 1) {
+        TargetThreadCount = 1;
+    }
+
+    WorkBlock.TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount);
+}
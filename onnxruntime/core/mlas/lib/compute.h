@@ -0,0 +1,606 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.h
+
+Abstract:
+
+    This module contains the constants and the templated kernels for the
+    exponential, error function and softmax routines.
+
+    The kernels are parameterized by the vector type, so that the same
+    algorithms are compiled for each instruction set extension in its own
+    module. Besides the arithmetic operations, the vector type supplies the
+    bitwise and reduction operations used by the kernels:
+
+        Abs(v) - Clears the sign of each element.
+
+        CopySign(m, s) - Combines the magnitude of m with the sign of s, where
+            the elements of m are not negative.
+
+        BlendLessThan(a, b, x, y) - Selects x where a < b, else y.
+
+        PowerOf2(v) - Computes 2^v for integral elements in [-126, 127].
+
+        ReduceAdd(v), ReduceMaximum(v) - Reduces the elements to a scalar.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <cmath>
+
+//
+// Define the constants for the exponential function.
+//
+// The argument is reduced to r = x - m * ln2, where m = round(x / ln2), and
+// exp(r) is evaluated with a minimax polynomial. The result is scaled by 2^m
+// as two factors, so that both factors are normal numbers for the results
+// that are subnormal or that are close to overflowing.
+//
+
+struct MLAS_EXP_CONSTANTS {
+    float LowerRange;
+    float UpperRange;
+    float RoundingBias;
+    float Log2Reciprocal;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_5;
+    float poly_6;
+    float MinimumExponent;
+    float MaximumExponent;
+};
+
+extern const MLAS_EXP_CONSTANTS MlasExpConstants;
+
+//
+// Define the constants for the error function.
+//
+// For |x| < 1, the error function is evaluated with its Maclaurin series
+// truncated to ten terms. Otherwise, the approximation 7.1.26 from
+// Abramowitz and Stegun is used:
+//
+//     erf(x) = 1 - (a1 * t + a2 * t^2 + ... + a5 * t^5) * exp(-x^2)
+//
+// where t = 1 / (1 + p * x). Both have an absolute error below 2e-7.
+//
+
+struct MLAS_ERF_CONSTANTS {
+    float SmallRange;
+    float UpperAbsRange;
+    float c_0;
+    float c_1;
+    float c_2;
+    float c_3;
+    float c_4;
+    float c_5;
+    float c_6;
+    float c_7;
+    float c_8;
+    float c_9;
+    float p;
+    float a_1;
+    float a_2;
+    float a_3;
+    float a_4;
+    float a_5;
+};
+
+extern const MLAS_ERF_CONSTANTS MlasErfConstants;
+
+template<typename Vector>
+inline
+typename Vector::Type
+MlasComputeExpVector(
+    typename Vector::Type Value
+    )
+{
+    const MLAS_EXP_CONSTANTS& c = MlasExpConstants;
+
+    Value = Vector::Maximum(Vector::Broadcast(c.LowerRange), Value);
+    Value = Vector::Minimum(Vector::Broadcast(c.UpperRange), Value);
+
+    //
+    // Round the exponent to the nearest integer by adding and subtracting a
+    // bias that shifts the fraction out of the mantissa.
+    //
+
+    typename Vector::Type RoundingBias = Vector::Broadcast(c.RoundingBias);
+    typename Vector::Type m = Vector::Subtract(Vector::MultiplyAdd(Value,
+        Vector::Broadcast(c.Log2Reciprocal), RoundingBias), RoundingBias);
+
+    Value = Vector::MultiplyAdd(m, Vector::Broadcast(c.Log2High), Value);
+    Value = Vector::MultiplyAdd(m, Vector::Broadcast(c.Log2Low), Value);
+
+    typename Vector::Type p = Vector::Broadcast(c.poly_0);
+    p = Vector::MultiplyAdd(p, Value, Vector::Broadcast(c.poly_1));
+    p = Vector::MultiplyAdd(p, Value, Vector::Broadcast(c.poly_2));
+    p = Vector::MultiplyAdd(p, Value, Vector::Broadcast(c.poly_3));
+    p = Vector::MultiplyAdd(p, Value, Vector::Broadcast(c.poly_4));
+    p = Vector::MultiplyAdd(p, Value, Vector::Broadcast(c.poly_5));
+    p = Vector::MultiplyAdd(p, Value, Vector::Broadcast(c.poly_6));
+
+    typename Vector::Type Normal = Vector::Minimum(Vector::Maximum(m,
+        Vector::Broadcast(c.MinimumExponent)), Vector::Broadcast(c.MaximumExponent));
+    typename Vector::Type Overflow = Vector::Subtract(m, Normal);
+
+    p = Vector::Multiply(p, Vector::PowerOf2(Overflow));
+    p = Vector::Multiply(p, Vector::PowerOf2(Normal));
+
+    return p;
+}
+
+template<typename Vector>
+inline
+typename Vector::Type
+MlasComputeErfVector(
+    typename Vector::Type Value
+    )
+{
+    const MLAS_ERF_CONSTANTS& c = MlasErfConstants;
+
+    typename Vector::Type One = Vector::Broadcast(1.0f);
+    typename Vector::Type AbsValue = Vector::Abs(Value);
+
+    //
+    // Evaluate the truncated Maclaurin series for the small range.
+    //
+
+    typename Vector::Type ValueSquared = Vector::Multiply(Value, Value);
+
+    typename Vector::Type s = Vector::Broadcast(c.c_9);
+    s = Vector::MultiplyAdd(s, ValueSquared, Vector::Broadcast(c.c_8));
+    s = Vector::MultiplyAdd(s, ValueSquared, Vector::Broadcast(c.c_7));
+    s = Vector::MultiplyAdd(s, ValueSquared, Vector::Broadcast(c.c_6));
+    s = Vector::MultiplyAdd(s, ValueSquared, Vector::Broadcast(c.c_5));
+    s = Vector::MultiplyAdd(s, ValueSquared, Vector::Broadcast(c.c_4));
+    s = Vector::MultiplyAdd(s, ValueSquared, Vector::Broadcast(c.c_3));
+    s = Vector::MultiplyAdd(s, ValueSquared, Vector::Broadcast(c.c_2));
+    s = Vector::MultiplyAdd(s, ValueSquared, Vector::Broadcast(c.c_1));
+    s = Vector::MultiplyAdd(s, ValueSquared, Vector::Broadcast(c.c_0));
+    s = Vector::Multiply(s, Value);
+
+    //
+    // Evaluate the rational approximation for the large range. The input is
+    // clamped to the range where the result rounds to one.
+    //
+
+    typename Vector::Type x = Vector::Minimum(AbsValue, Vector::Broadcast(c.UpperAbsRange));
+    typename Vector::Type t = Vector::Divide(One, Vector::MultiplyAdd(x, Vector::Broadcast(c.p), One));
+
+    typename Vector::Type q = Vector::Broadcast(c.a_5);
+    q = Vector::MultiplyAdd(q, t, Vector::Broadcast(c.a_4));
+    q = Vector::MultiplyAdd(q, t, Vector::Broadcast(c.a_3));
+    q = Vector::MultiplyAdd(q, t, Vector::Broadcast(c.a_2));
+    q = Vector::MultiplyAdd(q, t, Vector::Broadcast(c.a_1));
+    q = Vector::Multiply(q, t);
+
+    typename Vector::Type e = MlasComputeExpVector<Vector>(
+        Vector::Multiply(Vector::Subtract(Vector::Zero(), x), x));
+
+    typename Vector::Type l = Vector::CopySign(Vector::Subtract(One, Vector::Multiply(q, e)), Value);
+
+    return Vector::BlendLessThan(AbsValue, Vector::Broadcast(c.SmallRange), s, l);
+}
+
+template<typename Vector>
+inline
+typename Vector::Type
+MlasComputeGeluVector(
+    typename Vector::Type Value
+    )
+{
+    //
+    // Compute x * 0.5 * (1 + erf(x / sqrt(2))).
+    //
+
+    typename Vector::Type e = MlasComputeErfVector<Vector>(
+        Vector::Multiply(Value, Vector::Broadcast(0.707106781f)));
+
+    return Vector::Multiply(Vector::Multiply(Value, Vector::Broadcast(0.5f)),
+        Vector::Add(Vector::Broadcast(1.0f), e));
+}
+
+template<typename Vector, typename Vector::Type (*Operation)(typename Vector::Type)>
+void
+MlasComputeUnaryKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine applies an elementwise operation to a buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= Vector::Lanes) {
+
+        Vector::Store(Output, Operation(Vector::Load(Input)));
+
+        Input += Vector::Lanes;
+        Output += Vector::Lanes;
+        N -= Vector::Lanes;
+    }
+
+    //
+    // Process the remaining elements through a vector sized buffer.
+    //
+
+    if (N > 0) {
+
+        float Buffer[Vector::Lanes] = { 0 };
+
+        std::copy_n(Input, N, Buffer);
+
+        Vector::Store(Buffer, Operation(Vector::Load(Buffer)));
+
+        std::copy_n(Buffer, N, Output);
+    }
+}
+
+template<typename Vector>
+float
+MlasReduceMaximumKernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the maximum value of a buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value.
+
+--*/
+{
+    float Maximum = -std::numeric_limits<float>::infinity();
+
+    if (N >= Vector::Lanes) {
+
+        typename Vector::Type Maximum0 = Vector::Load(Input);
+        typename Vector::Type Maximum1 = Maximum0;
+        typename Vector::Type Maximum2 = Maximum0;
+        typename Vector::Type Maximum3 = Maximum0;
+
+        Input += Vector::Lanes;
+        N -= Vector::Lanes;
+
+        //
+        // Use independent accumulators to hide the latency of the maximum.
+        //
+
+        while (N >= Vector::Lanes * 4) {
+
+            Maximum0 = Vector::Maximum(Maximum0, Vector::Load(Input));
+            Maximum1 = Vector::Maximum(Maximum1, Vector::Load(Input + Vector::Lanes));
+            Maximum2 = Vector::Maximum(Maximum2, Vector::Load(Input + Vector::Lanes * 2));
+            Maximum3 = Vector::Maximum(Maximum3, Vector::Load(Input + Vector::Lanes * 3));
+
+            Input += Vector::Lanes * 4;
+            N -= Vector::Lanes * 4;
+        }
+
+        while (N >= Vector::Lanes) {
+
+            Maximum0 = Vector::Maximum(Maximum0, Vector::Load(Input));
+
+            Input += Vector::Lanes;
+            N -= Vector::Lanes;
+        }
+
+        Maximum0 = Vector::Maximum(Vector::Maximum(Maximum0, Maximum1),
+            Vector::Maximum(Maximum2, Maximum3));
+
+        Maximum = Vector::ReduceMaximum(Maximum0);
+    }
+
+    while (N > 0) {
+
+        Maximum = (std::max)(Maximum, *Input);
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Maximum;
+}
+
+template<typename Vector>
+float
+MlasComputeSumExpKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential of each element of a buffer offset
+    by the negative of its maximum value and returns the sum of the
+    exponentials.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the buffer to store the exponentials.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the negative of the maximum value of the input
+        buffer.
+
+Return Value:
+
+    Returns the sum of the exponentials.
+
+--*/
+{
+    typename Vector::Type Offset = Vector::Broadcast(NegativeMaximum);
+    typename Vector::Type Accumulator0 = Vector::Zero();
+    typename Vector::Type Accumulator1 = Vector::Zero();
+
+    while (N >= Vector::Lanes * 2) {
+
+        typename Vector::Type Value0 = MlasComputeExpVector<Vector>(
+            Vector::Add(Vector::Load(Input), Offset));
+        typename Vector::Type Value1 = MlasComputeExpVector<Vector>(
+            Vector::Add(Vector::Load(Input + Vector::Lanes), Offset));
+
+        Accumulator0 = Vector::Add(Accumulator0, Value0);
+        Accumulator1 = Vector::Add(Accumulator1, Value1);
+
+        if (Output != nullptr) {
+            Vector::Store(Output, Value0);
+            Vector::Store(Output + Vector::Lanes, Value1);
+            Output += Vector::Lanes * 2;
+        }
+
+        Input += Vector::Lanes * 2;
+        N -= Vector::Lanes * 2;
+    }
+
+    if (N >= Vector::Lanes) {
+
+        typename Vector::Type Value = MlasComputeExpVector<Vector>(
+            Vector::Add(Vector::Load(Input), Offset));
+
+        Accumulator0 = Vector::Add(Accumulator0, Value);
+
+        if (Output != nullptr) {
+            Vector::Store(Output, Value);
+            Output += Vector::Lanes;
+        }
+
+        Input += Vector::Lanes;
+        N -= Vector::Lanes;
+    }
+
+    float Sum = Vector::ReduceAdd(Vector::Add(Accumulator0, Accumulator1));
+
+    //
+    // Process the remaining elements through a vector sized buffer.
+    //
+
+    if (N > 0) {
+
+        float Buffer[Vector::Lanes] = { 0 };
+
+        std::copy_n(Input, N, Buffer);
+
+        Vector::Store(Buffer, MlasComputeExpVector<Vector>(
+            Vector::Add(Vector::Load(Buffer), Offset)));
+
+        for (size_t n = 0; n < N; n++) {
+            Sum += Buffer[n];
+        }
+
+        if (Output != nullptr) {
+            std::copy_n(Buffer, N, Output);
+        }
+    }
+
+    return Sum;
+}
+
+template<typename Vector>
+void
+MlasComputeSoftmaxOutputKernel(
+    float* Output,
+    size_t N,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine scales the exponentials of a softmax row by the reciprocal
+    of their sum.
+
+Arguments:
+
+    Output - Supplies the exponentials and receives the softmax output.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the reciprocal of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    typename Vector::Type ScaleVector = Vector::Broadcast(Scale);
+
+    while (N >= Vector::Lanes) {
+
+        Vector::Store(Output, Vector::Multiply(Vector::Load(Output), ScaleVector));
+
+        Output += Vector::Lanes;
+        N -= Vector::Lanes;
+    }
+
+    while (N > 0) {
+
+        *Output *= Scale;
+
+        Output += 1;
+        N -= 1;
+    }
+}
+
+template<typename Vector>
+void
+MlasComputeLogSoftmaxOutputKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Offset
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the output of a log softmax row.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Offset - Supplies the negative of the sum of the maximum value and the
+        logarithm of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    typename Vector::Type OffsetVector = Vector::Broadcast(Offset);
+
+    while (N >= Vector::Lanes) {
+
+        Vector::Store(Output, Vector::Add(Vector::Load(Input), OffsetVector));
+
+        Input += Vector::Lanes;
+        Output += Vector::Lanes;
+        N -= Vector::Lanes;
+    }
+
+    while (N > 0) {
+
+        *Output = *Input + Offset;
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+template<typename Vector>
+void
+MlasComputeSoftmaxKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function for a set of
+    rows.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of elements per row.
+
+    LogSoftmax - Supplies true if the log softmax function is computed, else
+        false if the softmax function is computed.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N > 0) {
+
+        const float Maximum = MlasReduceMaximumKernel<Vector>(Input, D);
+        const float NegativeMaximum = -Maximum;
+
+        if (LogSoftmax) {
+
+            //
+            // Compute the sum of the exponentials without storing them.
+            //
+
+            float Sum = MlasComputeSumExpKernel<Vector>(Input, nullptr, D, NegativeMaximum);
+
+            MlasComputeLogSoftmaxOutputKernel<Vector>(Input, Output, D,
+                NegativeMaximum - std::log(Sum));
+
+        } else {
+
+            float Sum = MlasComputeSumExpKernel<Vector>(Input, Output, D, NegativeMaximum);
+
+            MlasComputeSoftmaxOutputKernel<Vector>(Output, D, 1.0f / Sum);
+        }
+
+        Input += D;
+        Output += D;
+        N -= 1;
+    }
+}
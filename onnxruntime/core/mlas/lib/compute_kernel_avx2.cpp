@@ -0,0 +1,193 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the kernels for the exponential, error, GELU and
+    softmax functions with AVX2 and FMA3 instructions.
+
+    This module must be compiled with AVX2 and FMA3 code generation enabled.
+
+--*/
+
+#include "compute.h"
+
+//
+// Define the vector operations for the eight element vector type.
+//
+
+struct MLAS_COMPUTE_VECTOR_AVX2 {
+
+    typedef __m256 Type;
+
+    static constexpr size_t Lanes = 8;
+
+    static __m256 Zero() { return _mm256_setzero_ps(); }
+
+    static __m256 Load(const float* p) { return _mm256_loadu_ps(p); }
+
+    static void Store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+
+    static __m256 Broadcast(float f) { return _mm256_set1_ps(f); }
+
+    static __m256 Add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+
+    static __m256 Subtract(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+
+    static __m256 Multiply(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+
+    static __m256 MultiplyAdd(__m256 a, __m256 b, __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+
+    static __m256 Divide(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+
+    static __m256 Maximum(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+
+    static __m256 Minimum(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+
+    static __m256 Abs(__m256 v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+
+    static __m256 CopySign(__m256 m, __m256 s) { return _mm256_or_ps(m, _mm256_and_ps(_mm256_set1_ps(-0.0f), s)); }
+
+    static __m256 BlendLessThan(__m256 a, __m256 b, __m256 x, __m256 y)
+    {
+        return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ));
+    }
+
+    static __m256 PowerOf2(__m256 v)
+    {
+        __m256i Exponent = _mm256_add_epi32(_mm256_cvtps_epi32(v), _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(Exponent, 23));
+    }
+
+    static float ReduceAdd(__m256 v)
+    {
+        __m128 r = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+        r = _mm_add_ss(r, _mm_shuffle_ps(r, r, 1));
+        return _mm_cvtss_f32(r);
+    }
+
+    static float ReduceMaximum(__m256 v)
+    {
+        __m128 r = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        r = _mm_max_ps(r, _mm_movehl_ps(r, r));
+        r = _mm_max_ss(r, _mm_shuffle_ps(r, r, 1));
+        return _mm_cvtss_f32(r);
+    }
+};
+
+void
+MLASCALL
+MlasExpKernelAvx2(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel for the exponential function.
+
+Arguments:
+
+    See MlasExpKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnaryKernel<MLAS_COMPUTE_VECTOR_AVX2,
+        MlasComputeExpVector<MLAS_COMPUTE_VECTOR_AVX2>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasErfKernelAvx2(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel for the error function.
+
+Arguments:
+
+    See MlasErfKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnaryKernel<MLAS_COMPUTE_VECTOR_AVX2,
+        MlasComputeErfVector<MLAS_COMPUTE_VECTOR_AVX2>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasGeluKernelAvx2(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel for the GELU function.
+
+Arguments:
+
+    See MlasGeluKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnaryKernel<MLAS_COMPUTE_VECTOR_AVX2,
+        MlasComputeGeluVector<MLAS_COMPUTE_VECTOR_AVX2>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasSoftmaxKernelAvx2(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel for the softmax function.
+
+Arguments:
+
+    See MlasComputeSoftmaxKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeSoftmaxKernel<MLAS_COMPUTE_VECTOR_AVX2>(Input, Output, N, D, LogSoftmax);
+}
@@ -0,0 +1,203 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernels for the exponential, error, GELU and
+    softmax functions with AVX512F instructions.
+
+    This module must be compiled with AVX512F code generation enabled.
+
+--*/
+
+#include "compute.h"
+
+//
+// GCC 12 reports the self initialized placeholder values used by the AVX512F
+// intrinsics as uninitialized (GCC bug 105593).
+//
+
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ == 12)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+//
+// Define the vector operations for the sixteen element vector type.
+//
+
+struct MLAS_COMPUTE_VECTOR_AVX512F {
+
+    typedef __m512 Type;
+
+    static constexpr size_t Lanes = 16;
+
+    static __m512 Zero() { return _mm512_setzero_ps(); }
+
+    static __m512 Load(const float* p) { return _mm512_loadu_ps(p); }
+
+    static void Store(float* p, __m512 v) { _mm512_storeu_ps(p, v); }
+
+    static __m512 Broadcast(float f) { return _mm512_set1_ps(f); }
+
+    static __m512 Add(__m512 a, __m512 b) { return _mm512_add_ps(a, b); }
+
+    static __m512 Subtract(__m512 a, __m512 b) { return _mm512_sub_ps(a, b); }
+
+    static __m512 Multiply(__m512 a, __m512 b) { return _mm512_mul_ps(a, b); }
+
+    static __m512 MultiplyAdd(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+
+    static __m512 Divide(__m512 a, __m512 b) { return _mm512_div_ps(a, b); }
+
+    static __m512 Maximum(__m512 a, __m512 b) { return _mm512_max_ps(a, b); }
+
+    static __m512 Minimum(__m512 a, __m512 b) { return _mm512_min_ps(a, b); }
+
+    //
+    // The floating point bitwise instructions require AVX512DQ, so use the
+    // integer forms.
+    //
+
+    static __m512 Abs(__m512 v)
+    {
+        return _mm512_castsi512_ps(_mm512_and_epi32(_mm512_castps_si512(v), _mm512_set1_epi32(0x7FFFFFFF)));
+    }
+
+    static __m512 CopySign(__m512 m, __m512 s)
+    {
+        __m512i Sign = _mm512_and_epi32(_mm512_castps_si512(s), _mm512_set1_epi32(int32_t(0x80000000)));
+        return _mm512_castsi512_ps(_mm512_or_epi32(_mm512_castps_si512(m), Sign));
+    }
+
+    static __m512 BlendLessThan(__m512 a, __m512 b, __m512 x, __m512 y)
+    {
+        return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), y, x);
+    }
+
+    static __m512 PowerOf2(__m512 v)
+    {
+        __m512i Exponent = _mm512_add_epi32(_mm512_cvtps_epi32(v), _mm512_set1_epi32(127));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(Exponent, 23));
+    }
+
+    static float ReduceAdd(__m512 v) { return _mm512_reduce_add_ps(v); }
+
+    static float ReduceMaximum(__m512 v) { return _mm512_reduce_max_ps(v); }
+};
+
+void
+MLASCALL
+MlasExpKernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel for the exponential function.
+
+Arguments:
+
+    See MlasExpKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnaryKernel<MLAS_COMPUTE_VECTOR_AVX512F,
+        MlasComputeExpVector<MLAS_COMPUTE_VECTOR_AVX512F>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasErfKernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel for the error function.
+
+Arguments:
+
+    See MlasErfKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnaryKernel<MLAS_COMPUTE_VECTOR_AVX512F,
+        MlasComputeErfVector<MLAS_COMPUTE_VECTOR_AVX512F>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasGeluKernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel for the GELU function.
+
+Arguments:
+
+    See MlasGeluKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnaryKernel<MLAS_COMPUTE_VECTOR_AVX512F,
+        MlasComputeGeluVector<MLAS_COMPUTE_VECTOR_AVX512F>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasSoftmaxKernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel for the softmax function.
+
+Arguments:
+
+    See MlasComputeSoftmaxKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeSoftmaxKernel<MLAS_COMPUTE_VECTOR_AVX512F>(Input, Output, N, D, LogSoftmax);
+}
@@ -528,6 +528,8 @@ Return Value:
     const size_t OutputSize = Parameters->OutputSize;
     const size_t K = Parameters->K;
 
+    MLAS_SGEMM_EPILOGUE Epilogue = { Parameters->Activation, Bias, nullptr, nullptr, 0 };
+
     //
     // Compute the strides to step through slices of the local segment.
     //
@@ -590,19 +592,17 @@ Return Value:
                     SegmentStartN + n, CountN);
             }
 
+            //
+            // Apply the activation with optional bias as part of the final
+            // slice along the K dimension.
+            //
+
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
                 CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                SegmentOutput, OutputSize, (k + CountK == K) ? &Epilogue : nullptr);
 
             beta = 1.0f;
         }
-
-        //
-        // Apply the activation with optional bias.
-        //
-
-        MlasActivation(Parameters->Activation, SegmentOutput, Bias, FilterCount,
-            SegmentOutput, CountN, OutputSize);
     }
 }
 
@@ -713,167 +713,372 @@ Return Value:
         const float* filter = WorkBlock->Filter + group * FilterGroupSize;
         float* output = WorkBlock->Output + bg * OutputGroupSize;
 
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
         //
-        // Invoke the non-threaded GEMM directly with the input tensor.
+        // Invoke the non-threaded GEMM directly with the input tensor and
+        // apply the activation with optional bias to the output tiles.
         //
 
+        MLAS_SGEMM_EPILOGUE Epilogue = { Parameters->Activation, bias, nullptr, nullptr, 0 };
+
         MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
             OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
-            output, OutputSize);
+            output, OutputSize, &Epilogue);
+    }
+}
 
-        //
-        // Apply the activation with optional bias.
-        //
+//
+// Define the Winograd minimal filtering transforms F(m x m, 3 x 3), where m is
+// the output tile size. Each output tile is computed from an input tile of
+// (m + 2) x (m + 2) elements:
+//
+//     Y = AT * [(G * g * GT) . (BT * d * B)] * A
+//
+// The filter transform G is only applied once per filter, so it is stored as
+// a matrix. The input and output transforms are applied to every tile and are
+// expanded to avoid multiplying by the zero and unit elements of BT and AT.
+//
 
-        const float* bias = WorkBlock->Bias;
+template<size_t OutputTileSize>
+struct MLAS_CONV_WINOGRAD_TRANSFORM;
 
-        if (bias != nullptr) {
-            bias += group * FilterCount;
-        }
+template<>
+struct MLAS_CONV_WINOGRAD_TRANSFORM<2>
+{
+    static constexpr size_t InputTileSize = 4;
+
+    static const float G[4][3];
+
+    //
+    // BT = [ 1  0 -1  0 ]
+    //      [ 0  1  1  0 ]
+    //      [ 0 -1  1  0 ]
+    //      [ 0  1  0 -1 ]
+    //
 
-        MlasActivation(Parameters->Activation, output, bias, FilterCount, output,
-            OutputSize, OutputSize);
+    static
+    inline
+    void
+    TransformInput(
+        const float* d,
+        size_t dStride,
+        float* v,
+        size_t vStride
+        )
+    {
+        const float d0 = d[0 * dStride];
+        const float d1 = d[1 * dStride];
+        const float d2 = d[2 * dStride];
+        const float d3 = d[3 * dStride];
+
+        v[0 * vStride] = d0 - d2;
+        v[1 * vStride] = d1 + d2;
+        v[2 * vStride] = d2 - d1;
+        v[3 * vStride] = d1 - d3;
     }
-}
 
-inline
-bool
-MlasConvTryMultithread(
-    const MLAS_CONV_PARAMETERS* Parameters,
-    const float* Input,
-    const float* Filter,
-    const float* Bias,
-    float* WorkingBuffer,
-    float* Output
-    )
-/*++
+    //
+    // AT = [ 1  1  1  0 ]
+    //      [ 0  1 -1 -1 ]
+    //
 
-Routine Description:
+    static
+    inline
+    void
+    TransformOutput(
+        const float* m,
+        size_t mStride,
+        float* y,
+        size_t yStride
+        )
+    {
+        const float m0 = m[0 * mStride];
+        const float m1 = m[1 * mStride];
+        const float m2 = m[2 * mStride];
+        const float m3 = m[3 * mStride];
+
+        y[0 * yStride] = m0 + m1 + m2;
+        y[1 * yStride] = m1 - m2 - m3;
+    }
+};
 
-    This routine attempts to launch a convolution operation across multiple
-    threads.
+const float MLAS_CONV_WINOGRAD_TRANSFORM<2>::G[4][3] = {
+    { 1.0f,  0.0f,  0.0f },
+    { 0.5f,  0.5f,  0.5f },
+    { 0.5f, -0.5f,  0.5f },
+    { 0.0f,  0.0f,  1.0f },
+};
 
-Arguments:
+template<>
+struct MLAS_CONV_WINOGRAD_TRANSFORM<4>
+{
+    static constexpr size_t InputTileSize = 6;
 
-    Parameters - Supplies the structure that contains the convolution
-        parameters.
+    static const float G[6][3];
 
-    Input - Supplies the input tensor.
+    //
+    // BT = [ 4  0 -5  0  1  0 ]
+    //      [ 0 -4 -4  1  1  0 ]
+    //      [ 0  4 -4 -1  1  0 ]
+    //      [ 0 -2 -1  2  1  0 ]
+    //      [ 0  2 -1 -2  1  0 ]
+    //      [ 0  4  0 -5  0  1 ]
+    //
 
-    Filter - Supplies the filter tensor.
+    static
+    inline
+    void
+    TransformInput(
+        const float* d,
+        size_t dStride,
+        float* v,
+        size_t vStride
+        )
+    {
+        const float d0 = d[0 * dStride];
+        const float d1 = d[1 * dStride];
+        const float d2 = d[2 * dStride];
+        const float d3 = d[3 * dStride];
+        const float d4 = d[4 * dStride];
+        const float d5 = d[5 * dStride];
+
+        const float t0 = d4 - 4.0f * d2;
+        const float t1 = d3 - 4.0f * d1;
+        const float t2 = d4 - d2;
+        const float t3 = 2.0f * (d3 - d1);
+
+        v[0 * vStride] = 4.0f * d0 - 5.0f * d2 + d4;
+        v[1 * vStride] = t0 + t1;
+        v[2 * vStride] = t0 - t1;
+        v[3 * vStride] = t2 + t3;
+        v[4 * vStride] = t2 - t3;
+        v[5 * vStride] = 4.0f * d1 - 5.0f * d3 + d5;
+    }
 
-    Bias - Optionally supplies the bias vector.
+    //
+    // AT = [ 1  1  1  1  1  0 ]
+    //      [ 0  1 -1  2 -2  0 ]
+    //      [ 0  1  1  4  4  0 ]
+    //      [ 0  1 -1  8 -8  1 ]
+    //
 
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+    static
+    inline
+    void
+    TransformOutput(
+        const float* m,
+        size_t mStride,
+        float* y,
+        size_t yStride
+        )
+    {
+        const float m0 = m[0 * mStride];
+        const float m1 = m[1 * mStride];
+        const float m2 = m[2 * mStride];
+        const float m3 = m[3 * mStride];
+        const float m4 = m[4 * mStride];
+        const float m5 = m[5 * mStride];
+
+        const float s12 = m1 + m2;
+        const float d12 = m1 - m2;
+        const float s34 = m3 + m4;
+        const float d34 = m3 - m4;
+
+        y[0 * yStride] = m0 + s12 + s34;
+        y[1 * yStride] = d12 + 2.0f * d34;
+        y[2 * yStride] = s12 + 4.0f * s34;
+        y[3 * yStride] = d12 + 8.0f * d34 + m5;
+    }
+};
 
-    Output - Supplies the output tensor.
+const float MLAS_CONV_WINOGRAD_TRANSFORM<4>::G[6][3] = {
+    {  1.0f / 4.0f,   0.0f,          0.0f        },
+    { -1.0f / 6.0f,  -1.0f / 6.0f,  -1.0f / 6.0f },
+    { -1.0f / 6.0f,   1.0f / 6.0f,  -1.0f / 6.0f },
+    {  1.0f / 24.0f,  1.0f / 12.0f,  1.0f / 6.0f },
+    {  1.0f / 24.0f, -1.0f / 12.0f,  1.0f / 6.0f },
+    {  0.0f,          0.0f,          1.0f        },
+};
+
+//
+// Define the maximum number of tiles that are transformed as a block and then
+// multiplied by the transformed filter as a set of GEMMs.
+//
+
+#define MLAS_CONV_WINOGRAD_TILE_BLOCK_SIZE              32
+
+//
+// Define the number of elements to pad each matrix of the transformed input
+// and output. The transforms access all of the matrices for each tile, so
+// matrices spaced at a power of two would alias to the same cache sets.
+//
+
+#define MLAS_CONV_WINOGRAD_MATRIX_PADDING               16
+
+//
+// Define the minimum number of tiles per image to use the Winograd algorithm.
+// The transformed filter is larger than the filter, so the GEMMs must have
+// enough columns to amortize loading it.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_TILE_COUNT           16
+
+size_t
+MlasConvWinogradGetOutputTileSize(
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the Winograd output tile size for a 3x3 convolution
+    with the supplied channel counts.
+
+    The input and output transforms scale with the channel counts while the
+    GEMMs scale with their product, so convolutions with few channels are
+    better served by the GEMM based algorithms. The larger output tile needs
+    fewer multiplies per output element, but its transforms are more
+    expensive and it is only used once the GEMMs dominate.
+
+Arguments:
+
+    InputChannels - Supplies the number of input channels.
+
+    FilterCount - Supplies the number of filters.
 
 Return Value:
 
-    Returns true if the operation was completed across multiple threads, else
-    false if the operation should fall back to a single thread.
+    Returns the output tile size or zero if the Winograd algorithm should not
+    be used.
 
 --*/
 {
+    if (InputChannels < 16 || FilterCount < 16) {
+        return 0;
+    }
 
-#if defined(MLAS_HAS_THREADING_SUPPORT)
+    if (InputChannels >= 32 && FilterCount >= 32) {
+        return 4;
+    }
 
-    MLAS_CONV_WORK_BLOCK WorkBlock;
+    return 2;
+}
 
-    const size_t OutputSize = Parameters->OutputSize;
-    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+template<size_t OutputTileSize>
+void
+MlasConvWinogradTransformFilterTemplate(
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
 
-    if (ThreadStrideN >= OutputSize) {
-        return false;
-    }
+Routine Description:
 
-    //
-    // Initialize the common fields of the work block.
-    //
+    This routine transforms each 3x3 kernel of the filter tensor to the
+    Winograd domain (G * g * GT).
 
-    WorkBlock.Parameters = Parameters;
-    WorkBlock.Input = Input;
-    WorkBlock.Filter = Filter;
-    WorkBlock.Bias = Bias;
-    WorkBlock.WorkingBuffer = WorkingBuffer;
-    WorkBlock.Output = Output;
+    The transformed filter is stored as a set of InputTileSize^2 matrices of
+    FilterCount rows by InputChannels columns, ready to be used as the A
+    operand of the GEMMs.
 
-    //
-    // Segment the operation across multiple threads.
-    //
+Arguments:
 
-    int32_t Index = 0;
-    size_t SegmentCountN;
+    InputChannels - Supplies the number of input channels.
 
-    for (size_t SegmentStartN = 0; SegmentStartN < OutputSize; SegmentStartN += SegmentCountN) {
+    FilterCount - Supplies the number of filters.
 
-        SegmentCountN = OutputSize - SegmentStartN;
+    Filter - Supplies the filter tensor in OIHW format.
 
-        if (SegmentCountN > ThreadStrideN) {
-            SegmentCountN = ThreadStrideN;
-        }
+    TransformedFilter - Supplies the buffer to receive the transformed filter.
 
-        WorkBlock.Segments[Index].StartN = SegmentStartN;
-        WorkBlock.Segments[Index].CountN = SegmentCountN;
+Return Value:
 
-        Index++;
-    }
+    None.
 
-    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index);
+--*/
+{
+    typedef MLAS_CONV_WINOGRAD_TRANSFORM<OutputTileSize> Transform;
 
-    return true;
+    constexpr size_t InputTileSize = Transform::InputTileSize;
 
-#else
+    const size_t MatrixStride = FilterCount * InputChannels;
 
-    //
-    // No threading implementation is available.
-    //
+    for (size_t f = 0; f < FilterCount; f++) {
 
-    MLAS_UNREFERENCED_PARAMETER(Parameters);
-    MLAS_UNREFERENCED_PARAMETER(Input);
-    MLAS_UNREFERENCED_PARAMETER(Filter);
-    MLAS_UNREFERENCED_PARAMETER(Bias);
-    MLAS_UNREFERENCED_PARAMETER(WorkingBuffer);
-    MLAS_UNREFERENCED_PARAMETER(Output);
+        for (size_t c = 0; c < InputChannels; c++) {
 
-    return false;
+            const float* g = Filter + (f * InputChannels + c) * 9;
+            float Gg[InputTileSize][3];
 
-#endif
+            for (size_t i = 0; i < InputTileSize; i++) {
+                for (size_t j = 0; j < 3; j++) {
+                    Gg[i][j] = Transform::G[i][0] * g[0 * 3 + j] +
+                        Transform::G[i][1] * g[1 * 3 + j] + Transform::G[i][2] * g[2 * 3 + j];
+                }
+            }
+
+            float* u = TransformedFilter + f * InputChannels + c;
 
+            for (size_t i = 0; i < InputTileSize; i++) {
+                for (size_t j = 0; j < InputTileSize; j++) {
+                    u[(i * InputTileSize + j) * MatrixStride] = Gg[i][0] * Transform::G[j][0] +
+                        Gg[i][1] * Transform::G[j][1] + Gg[i][2] * Transform::G[j][2];
+                }
+            }
+        }
+    }
 }
 
+template<size_t OutputTileSize>
 void
-MLASCALL
-MlasConv(
+MlasConvWinogradOperation(
     const MLAS_CONV_PARAMETERS* Parameters,
     const float* Input,
     const float* Filter,
     const float* Bias,
     float* WorkingBuffer,
-    float* Output
+    float* Output,
+    size_t TileStart,
+    size_t TileCount
     )
 /*++
 
 Routine Description:
 
-    This routine implements the convolution operation.
+    This routine computes a block of output tiles of one image using the
+    Winograd algorithm.
+
+    The input tiles are transformed to InputTileSize^2 matrices, each of which
+    is multiplied by the matching matrix of the transformed filter. The
+    products are transformed back to the output tiles, the activation is
+    applied and the tiles are scattered to the output tensor.
 
 Arguments:
 
     Parameters - Supplies the structure that contains the convolution
         parameters.
 
-    Input - Supplies the input tensor.
+    Input - Supplies the input tensor for the image.
 
-    Filter - Supplies the filter tensor.
+    Filter - Supplies the transformed filter.
 
     Bias - Optionally supplies the bias vector.
 
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+    WorkingBuffer - Supplies the working buffer for this block of tiles.
 
-    Output - Supplies the output tensor.
+    Output - Supplies the output tensor for the image.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
 
 Return Value:
 
@@ -881,145 +1086,1134 @@ Return Value:
 
 --*/
 {
-    const size_t FilterCount = Parameters->FilterCount;
-    const size_t OutputSize = Parameters->OutputSize;
-    const size_t K = Parameters->K;
+    typedef MLAS_CONV_WINOGRAD_TRANSFORM<OutputTileSize> Transform;
 
-    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
-    const size_t OutputGroupSize = FilterCount * OutputSize;
-    const size_t FilterGroupSize = FilterCount * K;
+    constexpr size_t InputTileSize = Transform::InputTileSize;
+    constexpr size_t TransformSize = InputTileSize * InputTileSize;
+    constexpr size_t OutputTileElements = OutputTileSize * OutputTileSize;
 
-    const size_t BatchCount = Parameters->BatchCount;
-    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TileCountWidth = Parameters->u.Winograd.TileCountWidth;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
 
-    const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
+    const size_t InputMatrixStride = InputChannels * TileBlockSize + MLAS_CONV_WINOGRAD_MATRIX_PADDING;
+    const size_t OutputMatrixStride = FilterCount * TileBlockSize + MLAS_CONV_WINOGRAD_MATRIX_PADDING;
 
-#if defined(MLAS_HAS_THREADING_SUPPORT)
+    float* TransformedInput = WorkingBuffer;
+    float* TransformedOutput = TransformedInput + TransformSize * InputMatrixStride;
+    float* OutputBuffer = TransformedOutput + TransformSize * OutputMatrixStride;
 
     //
-    // Schedule batches of GEMMs across multiple threads.
+    // Transform the input tiles (BT * d * B). The tiles are the inner loop so
+    // that the stores to each matrix of the transformed input are sequential.
     //
 
-    if (Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) {
+    for (size_t c = 0; c < InputChannels; c++) {
 
-        const size_t BatchGroupCount = BatchCount * GroupCount;
+        const float* input = Input + c * InputSize;
+        float* v = TransformedInput + c * TileBlockSize;
 
-        int32_t TargetThreadCount = MlasPlatform.GetMaximumThreadCount();
+        for (size_t t = 0; t < TileCount; t++) {
 
-        if (size_t(TargetThreadCount) >= BatchGroupCount) {
-            TargetThreadCount = int32_t(BatchGroupCount);
-        }
+            const size_t ty = (TileStart + t) / TileCountWidth;
+            const size_t tx = (TileStart + t) % TileCountWidth;
 
-        MLAS_CONV_WORK_BLOCK WorkBlock;
+            //
+            // Compute the origin of the input tile using unsigned arithmetic:
+            // an origin inside the top or left padding wraps around and fails
+            // the bounds checks below.
+            //
 
-        WorkBlock.Parameters = Parameters;
-        WorkBlock.Input = Input;
-        WorkBlock.Filter = Filter;
-        WorkBlock.Bias = Bias;
-        WorkBlock.WorkingBuffer = nullptr;
-        WorkBlock.Output = Output;
-        WorkBlock.TargetThreadCount = TargetThreadCount;
+            const size_t OriginY = ty * OutputTileSize - PaddingTop;
+            const size_t OriginX = tx * OutputTileSize - PaddingLeft;
 
-        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount);
+            const bool InteriorTile = (ty * OutputTileSize >= PaddingTop) &&
+                (tx * OutputTileSize >= PaddingLeft) &&
+                (OriginY + InputTileSize <= InputHeight) &&
+                (OriginX + InputTileSize <= InputWidth);
 
-        return;
-    }
+            float d[InputTileSize][InputTileSize];
 
-#endif
+            if (InteriorTile) {
 
-    //
-    // Iterate over each batch and group.
-    //
+                const float* row = input + OriginY * InputWidth + OriginX;
 
-    for (size_t batch = 0; batch < BatchCount; batch++) {
+                for (size_t i = 0; i < InputTileSize; i++) {
+                    for (size_t j = 0; j < InputTileSize; j++) {
+                        d[i][j] = row[i * InputWidth + j];
+                    }
+                }
 
-        const float* filter = Filter;
-        const float* bias = Bias;
+            } else {
 
-        for (size_t group = 0; group < GroupCount; group++) {
+                for (size_t i = 0; i < InputTileSize; i++) {
+                    for (size_t j = 0; j < InputTileSize; j++) {
+                        const size_t y = OriginY + i;
+                        const size_t x = OriginX + j;
+                        d[i][j] = (y < InputHeight && x < InputWidth) ? input[y * InputWidth + x] : 0.0f;
+                    }
+                }
+            }
 
-            //
-            // Dispatch the convolution.
-            //
+            float BTd[InputTileSize][InputTileSize];
 
-            switch (Algorithm) {
+            for (size_t j = 0; j < InputTileSize; j++) {
+                Transform::TransformInput(&d[0][j], InputTileSize, &BTd[0][j], InputTileSize);
+            }
 
-                case MlasConvAlgorithmGemmDirect:
-                {
-                    //
-                    // Invoke the threaded GEMM directly with the input tensor.
-                    //
+            for (size_t i = 0; i < InputTileSize; i++) {
+                Transform::TransformInput(&BTd[i][0], 1,
+                    v + i * InputTileSize * InputMatrixStride + t, InputMatrixStride);
+            }
+        }
+    }
 
-                    MlasSgemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
-                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
-                        Output, OutputSize);
+    //
+    // Multiply each matrix of the transformed input by the matching matrix of
+    // the transformed filter.
+    //
 
-                    //
-                    // Apply the activation with optional bias.
-                    //
+    const size_t FilterMatrixStride = FilterCount * InputChannels;
 
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount, Output,
-                        OutputSize, OutputSize);
+    for (size_t n = 0; n < TransformSize; n++) {
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCount, InputChannels,
+            1.0f, Filter + n * FilterMatrixStride, InputChannels,
+            TransformedInput + n * InputMatrixStride, TileBlockSize, 0.0f,
+            TransformedOutput + n * OutputMatrixStride, TileBlockSize, nullptr);
+    }
 
-                    break;
-                }
+    //
+    // Transform the products to the output tiles (AT * m * A).
+    //
 
-                case MlasConvAlgorithmExpandThenGemm:
-                {
-                    //
-                    // Expand the input tensor to the working buffer and then invoke the
-                    // threaded GEMM.
-                    //
+    const size_t OutputBufferStride = TileBlockSize * OutputTileElements;
 
-                    if (Parameters->Dimensions == 2) {
-                        MlasConvIm2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
-                    } else {
-                        MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
-                    }
+    for (size_t f = 0; f < FilterCount; f++) {
 
-                    MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize);
+        for (size_t t = 0; t < TileCount; t++) {
 
+            const float* m = TransformedOutput + f * TileBlockSize + t;
+            float ATm[OutputTileSize][InputTileSize];
+
+            for (size_t j = 0; j < InputTileSize; j++) {
+                Transform::TransformOutput(m + j * OutputMatrixStride,
+                    InputTileSize * OutputMatrixStride, &ATm[0][j], InputTileSize);
+            }
+
+            float* y = OutputBuffer + f * OutputBufferStride + t * OutputTileElements;
+
+            for (size_t i = 0; i < OutputTileSize; i++) {
+                Transform::TransformOutput(&ATm[i][0], 1, y + i * OutputTileSize, 1);
+            }
+        }
+    }
+
+    //
+    // Apply the activation with optional bias.
+    //
+
+    MlasActivation(Parameters->Activation, OutputBuffer, Bias, FilterCount, OutputBuffer,
+        TileCount * OutputTileElements, OutputBufferStride);
+
+    //
+    // Scatter the output tiles to the output tensor, dropping the elements
+    // of the tiles that extend past the output shape.
+    //
+
+    const size_t OutputSize = Parameters->OutputSize;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        float* output = Output + f * OutputSize;
+
+        for (size_t t = 0; t < TileCount; t++) {
+
+            const size_t oy = ((TileStart + t) / TileCountWidth) * OutputTileSize;
+            const size_t ox = ((TileStart + t) % TileCountWidth) * OutputTileSize;
+
+            const size_t CountY = std::min(OutputTileSize, OutputHeight - oy);
+            const size_t CountX = std::min(OutputTileSize, OutputWidth - ox);
+
+            const float* y = OutputBuffer + f * OutputBufferStride + t * OutputTileElements;
+
+            for (size_t i = 0; i < CountY; i++) {
+                for (size_t j = 0; j < CountX; j++) {
+                    output[(oy + i) * OutputWidth + (ox + j)] = y[i * OutputTileSize + j];
+                }
+            }
+        }
+    }
+}
+
+//
+// Define the parameters to execute segments of a Winograd convolution
+// operation on worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* WorkingBuffer;
+    float* Output;
+};
+
+size_t
+MlasConvWinogradGetWorkingBufferSizePerThread(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of working buffer elements required by
+    each thread for the Winograd algorithm.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+Return Value:
+
+    Returns the number of working buffer elements.
+
+--*/
+{
+    const size_t OutputTileSize = Parameters->u.Winograd.OutputTileSize;
+    const size_t InputTileSize = OutputTileSize + 2;
+    const size_t TransformSize = InputTileSize * InputTileSize;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+
+    const size_t InputMatrixStride = Parameters->InputChannels * TileBlockSize +
+        MLAS_CONV_WINOGRAD_MATRIX_PADDING;
+    const size_t OutputMatrixStride = Parameters->FilterCount * TileBlockSize +
+        MLAS_CONV_WINOGRAD_MATRIX_PADDING;
+
+    return TransformSize * (InputMatrixStride + OutputMatrixStride) +
+        OutputTileSize * OutputTileSize * TileBlockSize * Parameters->FilterCount;
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    Winograd convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t TileCount = Parameters->u.Winograd.TileCountHeight *
+        Parameters->u.Winograd.TileCountWidth;
+    const size_t TileBlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
+
+    //
+    // Compute the range of tile blocks to use for this thread.
+    //
+
+    const size_t TotalWork = Parameters->BatchCount * TileBlockCount;
+    const size_t TargetThreadCount = size_t(Parameters->u.Winograd.TargetThreadCount);
+
+    const size_t WorkPerThread = TotalWork / TargetThreadCount;
+    const size_t WorkPerThreadExtra = TotalWork % TargetThreadCount;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        WorkIndex = (WorkPerThread + 1) * Index;
+        WorkRemaining = WorkPerThread + 1;
+    } else {
+        WorkIndex = WorkPerThread * Index + WorkPerThreadExtra;
+        WorkRemaining = WorkPerThread;
+    }
+
+    float* WorkingBuffer = WorkBlock->WorkingBuffer +
+        Index * MlasConvWinogradGetWorkingBufferSizePerThread(Parameters);
+
+    const size_t InputImageSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputImageSize = Parameters->FilterCount * Parameters->OutputSize;
+
+    while (WorkRemaining > 0) {
+
+        const size_t batch = WorkIndex / TileBlockCount;
+        const size_t TileStart = (WorkIndex % TileBlockCount) * TileBlockSize;
+        const size_t CountTiles = std::min(TileBlockSize, TileCount - TileStart);
+
+        const float* input = WorkBlock->Input + batch * InputImageSize;
+        float* output = WorkBlock->Output + batch * OutputImageSize;
+
+        if (Parameters->u.Winograd.OutputTileSize == 4) {
+            MlasConvWinogradOperation<4>(Parameters, input, WorkBlock->Filter,
+                WorkBlock->Bias, WorkingBuffer, output, TileStart, CountTiles);
+        } else {
+            MlasConvWinogradOperation<2>(Parameters, input, WorkBlock->Filter,
+                WorkBlock->Bias, WorkingBuffer, output, TileStart, CountTiles);
+        }
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+//
+// Define the largest kernel of the depthwise algorithm, whose filter taps are
+// broadcast to vectors held on the stack.
+//
+
+#define MLAS_CONV_DEPTHWISE_MAXIMUM_KERNEL_SIZE         25
+
+void
+MlasConvDepthwiseRow(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float Bias,
+    float* Output,
+    size_t oh
+    )
+/*++
+
+Routine Description:
+
+    This routine computes one output row of one channel of a depthwise
+    convolution, where each group has a single input channel and filter.
+
+    The outputs whose kernel window lies inside the input width are computed
+    four at a time with a broadcast filter tap per kernel position when the
+    stride width is one. The outputs along the padded edges are computed with
+    bounds checks.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input channel.
+
+    Filter - Supplies the filter of the channel.
+
+    Bias - Supplies the bias of the channel.
+
+    Output - Supplies the output channel.
+
+    oh - Supplies the output row to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t HeightShapeIndex = 0;
+    constexpr size_t WidthShapeIndex = 1;
+
+    const size_t InputHeight = Parameters->InputShape[HeightShapeIndex];
+    const size_t InputWidth = Parameters->InputShape[WidthShapeIndex];
+    const size_t OutputWidth = Parameters->OutputShape[WidthShapeIndex];
+
+    const size_t KernelHeight = Parameters->KernelShape[HeightShapeIndex];
+    const size_t KernelWidth = Parameters->KernelShape[WidthShapeIndex];
+
+    const size_t PaddingLeftY = Parameters->Padding[HeightShapeIndex];
+    const size_t PaddingLeftX = Parameters->Padding[WidthShapeIndex];
+
+    const size_t StrideHeight = Parameters->StrideShape[HeightShapeIndex];
+    const size_t StrideWidth = Parameters->StrideShape[WidthShapeIndex];
+
+    float* output = Output + oh * OutputWidth;
+
+    //
+    // Compute the range of kernel rows that lie inside the input height.
+    //
+
+    const ptrdiff_t ihOrigin = ptrdiff_t(oh * StrideHeight) - ptrdiff_t(PaddingLeftY);
+
+    size_t khStart = 0;
+    size_t khEnd = KernelHeight;
+
+    if (ihOrigin < 0) {
+        khStart = std::min(size_t(-ihOrigin), KernelHeight);
+    }
+
+    if (ihOrigin + ptrdiff_t(KernelHeight) > ptrdiff_t(InputHeight)) {
+        khEnd = size_t(std::max(ptrdiff_t(InputHeight) - ihOrigin, ptrdiff_t(khStart)));
+    }
+
+    //
+    // Compute the range of outputs whose kernel window lies inside the input
+    // width.
+    //
+
+    size_t owInteriorStart = (PaddingLeftX + StrideWidth - 1) / StrideWidth;
+    size_t owInteriorEnd = 0;
+
+    if (InputWidth + PaddingLeftX >= KernelWidth) {
+        owInteriorEnd = std::min((InputWidth + PaddingLeftX - KernelWidth) / StrideWidth + 1, OutputWidth);
+    }
+
+    if (owInteriorStart > owInteriorEnd) {
+        owInteriorStart = owInteriorEnd;
+    }
+
+    auto ComputeEdgeOutput = [&](size_t ow) {
+
+        const ptrdiff_t iwOrigin = ptrdiff_t(ow * StrideWidth) - ptrdiff_t(PaddingLeftX);
+
+        float Accumulator = Bias;
+
+        for (size_t kh = khStart; kh < khEnd; kh++) {
+
+            const float* input = Input + (ihOrigin + ptrdiff_t(kh)) * ptrdiff_t(InputWidth);
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const ptrdiff_t iw = iwOrigin + ptrdiff_t(kw);
+
+                if (iw >= 0 && iw < ptrdiff_t(InputWidth)) {
+                    Accumulator += input[iw] * Filter[kh * KernelWidth + kw];
+                }
+            }
+        }
+
+        output[ow] = Accumulator;
+    };
+
+    for (size_t ow = 0; ow < owInteriorStart; ow++) {
+        ComputeEdgeOutput(ow);
+    }
+
+    size_t ow = owInteriorStart;
+
+    if (StrideWidth == 1) {
+
+        MLAS_FLOAT32X4 FilterVector[MLAS_CONV_DEPTHWISE_MAXIMUM_KERNEL_SIZE];
+
+        for (size_t k = khStart * KernelWidth; k < khEnd * KernelWidth; k++) {
+            FilterVector[k] = MlasBroadcastFloat32x4(Filter[k]);
+        }
+
+        const MLAS_FLOAT32X4 BiasVector = MlasBroadcastFloat32x4(Bias);
+
+        for (; ow + 4 <= owInteriorEnd; ow += 4) {
+
+            MLAS_FLOAT32X4 Accumulator = BiasVector;
+
+            for (size_t kh = khStart; kh < khEnd; kh++) {
+
+                const float* input = Input + (ihOrigin + ptrdiff_t(kh)) * ptrdiff_t(InputWidth) +
+                    (ow - PaddingLeftX);
+
+                for (size_t kw = 0; kw < KernelWidth; kw++) {
+                    Accumulator = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(input + kw),
+                        FilterVector[kh * KernelWidth + kw], Accumulator);
+                }
+            }
+
+            MlasStoreFloat32x4(output + ow, Accumulator);
+        }
+    }
+
+    for (; ow < owInteriorEnd; ow++) {
+
+        const float* input = Input + ow * StrideWidth - PaddingLeftX;
+
+        float Accumulator = Bias;
+
+        for (size_t kh = khStart; kh < khEnd; kh++) {
+
+            const float* row = input + (ihOrigin + ptrdiff_t(kh)) * ptrdiff_t(InputWidth);
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+                Accumulator += row[kw] * Filter[kh * KernelWidth + kw];
+            }
+        }
+
+        output[ow] = Accumulator;
+    }
+
+    for (ow = owInteriorEnd; ow < OutputWidth; ow++) {
+        ComputeEdgeOutput(ow);
+    }
+
+    //
+    // Apply the activation to the row while it's still in the cache.
+    //
+
+    MlasActivation(Parameters->Activation, output, nullptr, 1, output, OutputWidth, OutputWidth);
+}
+
+void
+MlasConvDepthwiseThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of output
+    rows of a depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+
+    //
+    // Compute the range of output rows over all batches and channels to use
+    // for this thread.
+    //
+
+    const size_t TotalWork = Parameters->BatchCount * GroupCount * OutputHeight;
+    const size_t TargetThreadCount = size_t(WorkBlock->TargetThreadCount);
+
+    const size_t WorkPerThread = TotalWork / TargetThreadCount;
+    const size_t WorkPerThreadExtra = TotalWork % TargetThreadCount;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        WorkIndex = (WorkPerThread + 1) * Index;
+        WorkRemaining = WorkPerThread + 1;
+    } else {
+        WorkIndex = WorkPerThread * Index + WorkPerThreadExtra;
+        WorkRemaining = WorkPerThread;
+    }
+
+    const size_t K = Parameters->K;
+
+    while (WorkRemaining > 0) {
+
+        const size_t BatchGroup = WorkIndex / OutputHeight;
+        const size_t oh = WorkIndex % OutputHeight;
+        const size_t group = BatchGroup % GroupCount;
+
+        const float Bias = (WorkBlock->Bias != nullptr) ? WorkBlock->Bias[group] : 0.0f;
+
+        MlasConvDepthwiseRow(Parameters,
+            WorkBlock->Input + BatchGroup * Parameters->InputSize,
+            WorkBlock->Filter + group * K,
+            Bias,
+            WorkBlock->Output + BatchGroup * Parameters->OutputSize,
+            oh);
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+inline
+bool
+MlasConvTryMultithread(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to launch a convolution operation across multiple
+    threads.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+Return Value:
+
+    Returns true if the operation was completed across multiple threads, else
+    false if the operation should fall back to a single thread.
+
+--*/
+{
+
+#if defined(MLAS_HAS_THREADING_SUPPORT)
+
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+
+    if (ThreadStrideN >= OutputSize) {
+        return false;
+    }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+    size_t SegmentCountN;
+
+    for (size_t SegmentStartN = 0; SegmentStartN < OutputSize; SegmentStartN += SegmentCountN) {
+
+        SegmentCountN = OutputSize - SegmentStartN;
+
+        if (SegmentCountN > ThreadStrideN) {
+            SegmentCountN = ThreadStrideN;
+        }
+
+        WorkBlock.Segments[Index].StartN = SegmentStartN;
+        WorkBlock.Segments[Index].CountN = SegmentCountN;
+
+        Index++;
+    }
+
+    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index);
+
+    return true;
+
+#else
+
+    //
+    // No threading implementation is available.
+    //
+
+    MLAS_UNREFERENCED_PARAMETER(Parameters);
+    MLAS_UNREFERENCED_PARAMETER(Input);
+    MLAS_UNREFERENCED_PARAMETER(Filter);
+    MLAS_UNREFERENCED_PARAMETER(Bias);
+    MLAS_UNREFERENCED_PARAMETER(WorkingBuffer);
+    MLAS_UNREFERENCED_PARAMETER(Output);
+
+    return false;
+
+#endif
+
+}
+
+void
+MLASCALL
+MlasConv(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor. If MlasConvPrepare selected the
+        Winograd algorithm, this is the filter transformed by
+        MlasConvWinogradTransformFilter.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = FilterCount * K;
+
+    const size_t BatchCount = Parameters->BatchCount;
+    const size_t GroupCount = Parameters->GroupCount;
+
+    const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
+
+    //
+    // Schedule blocks of Winograd tiles across multiple threads. The Winograd
+    // algorithm is only selected for a single group, so all batches are
+    // handled by this operation.
+    //
+
+    //
+    // Schedule the output rows of every batch and channel of a depthwise
+    // convolution across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmDepthwise) {
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = Parameters->u.Depthwise.TargetThreadCount;
+
+        MlasExecuteThreaded(MlasConvDepthwiseThreaded, &WorkBlock,
+            Parameters->u.Depthwise.TargetThreadCount);
+
+        return;
+    }
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+
+        MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = WorkingBuffer;
+        WorkBlock.Output = Output;
+
+        MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock,
+            Parameters->u.Winograd.TargetThreadCount);
+
+        return;
+    }
+
+#if defined(MLAS_HAS_THREADING_SUPPORT)
+
+    //
+    // Schedule batches of GEMMs across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) {
+
+        const size_t BatchGroupCount = BatchCount * GroupCount;
+
+        int32_t TargetThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+        if (size_t(TargetThreadCount) >= BatchGroupCount) {
+            TargetThreadCount = int32_t(BatchGroupCount);
+        }
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = TargetThreadCount;
+
+        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount);
+
+        return;
+    }
+
+#endif
+
+    //
+    // Iterate over each batch and group.
+    //
+
+    for (size_t batch = 0; batch < BatchCount; batch++) {
+
+        const float* filter = Filter;
+        const float* bias = Bias;
+
+        for (size_t group = 0; group < GroupCount; group++) {
+
+            if (MlasIsCancelled()) {
+                return;
+            }
+
+            MLAS_SGEMM_EPILOGUE Epilogue = { Parameters->Activation, bias, nullptr, nullptr, 0 };
+
+            //
+            // Dispatch the convolution.
+            //
+
+            switch (Algorithm) {
+
+                case MlasConvAlgorithmGemmDirect:
+                {
+                    //
+                    // Invoke the threaded GEMM directly with the input tensor
+                    // and apply the activation with optional bias.
+                    //
+
+                    MlasSgemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
+                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
+                        Output, OutputSize, &Epilogue);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmExpandThenGemm:
+                {
+                    //
+                    // Expand the input tensor to the working buffer and then invoke the
+                    // threaded GEMM.
+                    //
+
+                    if (Parameters->Dimensions == 2) {
+                        MlasConvIm2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
+                    } else {
+                        MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
+                    }
+
+                    MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
+                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize, &Epilogue);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmExpandThenGemmSegmented:
+                {
+                    //
+                    // Attempt to launch the convolution across multiple threads or fall
+                    // back to a single thread.
+                    //
+
+                    if (!MlasConvTryMultithread(Parameters, Input, filter, bias, WorkingBuffer,
+                        Output)) {
+                        MlasConvOperation(Parameters, Input, filter, bias, WorkingBuffer,
+                            Output, 0, OutputSize);
+                    }
+
+                    break;
+                }
+
+                case MlasConvAlgorithmWinograd:
+                case MlasConvAlgorithmDepthwise:
+                {
                     //
-                    // Apply the activation with optional bias.
+                    // The Winograd and depthwise algorithms were dispatched
+                    // above.
                     //
 
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount, Output,
-                        OutputSize, OutputSize);
+                    break;
+                }
+            }
+
+            //
+            // Advance the buffer pointers.
+            //
+
+            if (bias != nullptr) {
+                bias += FilterCount;
+            }
+
+            filter += FilterGroupSize;
+            Input += InputGroupSize;
+            Output += OutputGroupSize;
+        }
+    }
+}
+
+static
+bool
+MlasConvPrepareWinograd(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t MinimumTileCount,
+    size_t* WorkingBufferSize
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a convolution operation with the Winograd
+    algorithm, for a 3x3 convolution with unit strides and dilations.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    MinimumTileCount - Supplies the number of output tiles below which the
+        Winograd algorithm isn't selected.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+Return Value:
+
+    Returns true if the Winograd algorithm was selected, else false.
+
+--*/
+{
+    const size_t Dimensions = Parameters->Dimensions;
+    const size_t BatchCount = Parameters->BatchCount;
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+
+    bool AllStridesAreOne = true;
+    bool AllDilationsAreOne = true;
+
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+        AllStridesAreOne &= (Parameters->StrideShape[dim] == 1);
+        AllDilationsAreOne &= (Parameters->DilationShape[dim] == 1);
+    }
+
+    const size_t OutputTileSize = (Dimensions == 2 && GroupCount == 1 &&
+        AllStridesAreOne && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3) ?
+        MlasConvWinogradGetOutputTileSize(InputChannels, FilterCount) : 0;
 
-                    break;
-                }
+    const size_t TileCountHeight = (OutputTileSize != 0) ?
+        (Parameters->OutputShape[0] + OutputTileSize - 1) / OutputTileSize : 0;
+    const size_t TileCountWidth = (OutputTileSize != 0) ?
+        (Parameters->OutputShape[1] + OutputTileSize - 1) / OutputTileSize : 0;
+    const size_t TileCount = TileCountHeight * TileCountWidth;
 
-                case MlasConvAlgorithmExpandThenGemmSegmented:
-                {
-                    //
-                    // Attempt to launch the convolution across multiple threads or fall
-                    // back to a single thread.
-                    //
+    if (TileCount == 0 || TileCount < MinimumTileCount) {
+        return false;
+    }
 
-                    if (!MlasConvTryMultithread(Parameters, Input, filter, bias, WorkingBuffer,
-                        Output)) {
-                        MlasConvOperation(Parameters, Input, filter, bias, WorkingBuffer,
-                            Output, 0, OutputSize);
-                    }
+    size_t TileBlockSize = MLAS_CONV_WINOGRAD_TILE_BLOCK_SIZE;
 
-                    break;
-                }
-            }
+    if (TileBlockSize > TileCount) {
+        TileBlockSize = TileCount;
+    }
 
-            //
-            // Advance the buffer pointers.
-            //
+    const size_t TileBlockCount = BatchCount *
+        ((TileCount + TileBlockSize - 1) / TileBlockSize);
 
-            if (bias != nullptr) {
-                bias += FilterCount;
-            }
+    //
+    // Compute the number of target threads given the complexity of the
+    // element wise products.
+    //
 
-            filter += FilterGroupSize;
-            Input += InputGroupSize;
-            Output += OutputGroupSize;
+    const size_t InputTileSize = OutputTileSize + 2;
+
+    int32_t TargetThreadCount;
+    double Complexity = double(FilterCount) * double(InputChannels) *
+        double(BatchCount * TileCount) * double(InputTileSize * InputTileSize);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= TileBlockCount) {
+        TargetThreadCount = int32_t(TileBlockCount);
+    }
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->u.Winograd.OutputTileSize = OutputTileSize;
+    Parameters->u.Winograd.TileCountHeight = TileCountHeight;
+    Parameters->u.Winograd.TileCountWidth = TileCountWidth;
+    Parameters->u.Winograd.TileBlockSize = TileBlockSize;
+    Parameters->u.Winograd.TargetThreadCount = TargetThreadCount;
+
+    *WorkingBufferSize = TargetThreadCount *
+        MlasConvWinogradGetWorkingBufferSizePerThread(Parameters);
+
+    return true;
+}
+
+static
+void
+MlasConvPrepareExpandThenGemm(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a convolution operation that expands the input
+    tensor and then invokes the threaded GEMM.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    //
+    // The filter count is larger than the output dimensions, so perform the
+    // full matrix expansion and then invoke the threaded GEMM.
+    //
+
+    Parameters->Algorithm = MlasConvAlgorithmExpandThenGemm;
+
+    *WorkingBufferSize = OutputSize * K;
+}
+
+static
+void
+MlasConvPrepareExpandThenGemmSegmented(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a convolution operation that expands segments of
+    the input tensor across multiple threads.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    //
+    // Segment the operation across multiple threads by slicing the N
+    // dimension (see MlasSgemmTryMultithread).
+    //
+    // Compute the number of target threads given the complexity of the
+    // convolution operation. Small requests should run using the single
+    // threaded path.
+    //
+
+    int32_t TargetThreadCount;
+    double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Compute the thread stride for slicing the N dimension.
+    //
+
+    size_t StrideN = OutputSize / TargetThreadCount;
+
+    if ((StrideN * TargetThreadCount) != OutputSize) {
+        StrideN++;
+    }
+
+    if (TargetThreadCount > 1) {
+
+        StrideN = (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        if (StrideN >= OutputSize) {
+            TargetThreadCount = 1;
+        } else if (StrideN * (TargetThreadCount - 1) >= OutputSize) {
+            TargetThreadCount--;
         }
     }
+
+    Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
+    Parameters->u.ExpandThenGemmSegmented.ThreadStrideN = StrideN;
+
+    *WorkingBufferSize = TargetThreadCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
 }
 
 void
@@ -1179,30 +2373,25 @@ Return Value:
         }
     }
 
-    if (FilterCount > OutputSize) {
-
-        //
-        // The filter count is larger than the output dimensions, so perform the
-        // full matrix expansion and then invoke the threaded GEMM.
-        //
-
-        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemm;
-
-        *WorkingBufferSize = OutputSize * K;
+    //
+    // Detect a depthwise 3x3 or 5x5 convolution, where each group has a single
+    // input channel and filter, which would otherwise be computed as a GEMM
+    // of a single row per group.
+    //
 
-    } else {
+    if (Dimensions == 2 && GroupCount > 1 && InputChannels == 1 && FilterCount == 1 &&
+        AllDilationsAreOne && Parameters->KernelShape[0] == Parameters->KernelShape[1] &&
+        (Parameters->KernelShape[0] == 3 || Parameters->KernelShape[0] == 5)) {
 
-        //
-        // Segment the operation across multiple threads by slicing the N
-        // dimension (see MlasSgemmTryMultithread).
         //
         // Compute the number of target threads given the complexity of the
-        // convolution operation. Small requests should run using the single
-        // threaded path.
+        // convolution operation. The work is split by output rows.
         //
 
+        const size_t TotalRows = BatchCount * GroupCount * Parameters->OutputShape[0];
+
         int32_t TargetThreadCount;
-        double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+        double Complexity = double(BatchCount * GroupCount) * double(OutputSize) * double(K);
 
         if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
             TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
@@ -1216,30 +2405,199 @@ Return Value:
             TargetThreadCount = MaximumThreadCount;
         }
 
+        if (size_t(TargetThreadCount) >= TotalRows) {
+            TargetThreadCount = int32_t(TotalRows);
+        }
+
+        Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+        Parameters->u.Depthwise.TargetThreadCount = TargetThreadCount;
+
+        return;
+    }
+
+    //
+    // Detect a 3x3 convolution with unit strides and dilations that has enough
+    // channels to benefit from the Winograd algorithm.
+    //
+
+    if (MlasConvPrepareWinograd(Parameters, MLAS_CONV_WINOGRAD_MINIMUM_TILE_COUNT, WorkingBufferSize)) {
+        return;
+    }
+
+    if (FilterCount > OutputSize) {
+
         //
-        // Compute the thread stride for slicing the N dimension.
+        // The filter count is larger than the output dimensions, so perform the
+        // full matrix expansion and then invoke the threaded GEMM.
         //
 
-        size_t StrideN = OutputSize / TargetThreadCount;
+        MlasConvPrepareExpandThenGemm(Parameters, WorkingBufferSize);
 
-        if ((StrideN * TargetThreadCount) != OutputSize) {
-            StrideN++;
-        }
+    } else {
+
+        MlasConvPrepareExpandThenGemmSegmented(Parameters, WorkingBufferSize);
+    }
+}
+
+bool
+MLASCALL
+MlasConvPrepareAlgorithm(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_CONV_ALGORITHM Algorithm,
+    size_t* WorkingBufferSize
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares the parameters computed by MlasConvPrepare to perform
+    the convolution operation with the supplied algorithm instead of the one
+    MlasConvPrepare selected, e.g. to time the algorithms for a shape.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    Algorithm - Supplies the algorithm to perform the convolution operation
+        with. The direct GEMM and depthwise algorithms can only be kept if
+        MlasConvPrepare selected them.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
 
-        if (TargetThreadCount > 1) {
+Return Value:
+
+    Returns true if the algorithm can perform the convolution operation, else
+    false and the parameters are unchanged.
 
-            StrideN = (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+--*/
+{
+    switch (Algorithm) {
 
-            if (StrideN >= OutputSize) {
-                TargetThreadCount = 1;
-            } else if (StrideN * (TargetThreadCount - 1) >= OutputSize) {
-                TargetThreadCount--;
+        case MlasConvAlgorithmGemmDirect:
+        case MlasConvAlgorithmDepthwise:
+        {
+            if (Parameters->Algorithm != Algorithm) {
+                return false;
             }
+
+            *WorkingBufferSize = 0;
+            return true;
+        }
+
+        case MlasConvAlgorithmWinograd:
+        {
+            return MlasConvPrepareWinograd(Parameters, 1, WorkingBufferSize);
+        }
+
+        case MlasConvAlgorithmExpandThenGemm:
+        {
+            MlasConvPrepareExpandThenGemm(Parameters, WorkingBufferSize);
+            return true;
+        }
+
+        case MlasConvAlgorithmExpandThenGemmSegmented:
+        {
+            MlasConvPrepareExpandThenGemmSegmented(Parameters, WorkingBufferSize);
+            return true;
         }
+    }
+
+    return false;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradGetTransformedFilterSize(
+    size_t Dimensions,
+    size_t GroupCount,
+    size_t InputChannels,
+    const int64_t* KernelShape,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of elements of the transformed filter
+    used by the Winograd algorithm for the supplied filter, if MlasConvPrepare
+    may select the Winograd algorithm for this filter.
+
+    MlasConvPrepare additionally requires unit strides and dilations and an
+    output shape that is at least the size of an output tile.
+
+Arguments:
+
+    Dimensions - Supplies the number of dimensions.
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    KernelShape - Supplies the shape of the kernel.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the number of elements of the transformed filter or zero if the
+    Winograd algorithm is never selected for this filter.
+
+--*/
+{
+    if (Dimensions != 2 || GroupCount != 1 || KernelShape[0] != 3 || KernelShape[1] != 3) {
+        return 0;
+    }
+
+    const size_t OutputTileSize = MlasConvWinogradGetOutputTileSize(InputChannels, FilterCount);
+
+    if (OutputTileSize == 0) {
+        return 0;
+    }
+
+    const size_t InputTileSize = OutputTileSize + 2;
+
+    return InputTileSize * InputTileSize * InputChannels * FilterCount;
+}
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a 3x3 filter for use by the Winograd algorithm.
+
+Arguments:
+
+    InputChannels - Supplies the number of input channels.
+
+    FilterCount - Supplies the number of filters.
 
-        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
-        Parameters->u.ExpandThenGemmSegmented.ThreadStrideN = StrideN;
+    Filter - Supplies the filter tensor in OIHW format.
 
-        *WorkingBufferSize = TargetThreadCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+    TransformedFilter - Supplies the buffer to receive the transformed filter,
+        sized to the number of elements returned by
+        MlasConvWinogradGetTransformedFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (MlasConvWinogradGetOutputTileSize(InputChannels, FilterCount) == 4) {
+        MlasConvWinogradTransformFilterTemplate<4>(InputChannels, FilterCount, Filter,
+            TransformedFilter);
+    } else {
+        MlasConvWinogradTransformFilterTemplate<2>(InputChannels, FilterCount, Filter,
+            TransformedFilter);
     }
 }
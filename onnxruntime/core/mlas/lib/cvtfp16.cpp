@@ -0,0 +1,419 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvtfp16.cpp
+
+Abstract:
+
+    This module implements routines to convert between half-precision and
+    single-precision floating point buffers.
+
+    The MSVC x64 build implements MlasConvertHalfToFloatKernel in assembly
+    (amd64/cvtfp16a.asm), so the C++ version is excluded from that build.
+    The x64 builds select the F16C kernels (cvtfp16_kernel_f16c.cpp) when the
+    processor supports them.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the bit fields of a half-precision float shifted to the positions of
+// the corresponding bit fields of a single-precision float.
+//
+
+#define MLAS_FP16_EXPONENT_MASK         (0x7C00 << 13)
+#define MLAS_FP16_EXPONENT_ADJUST       ((127 - 15) << 23)
+#define MLAS_FP16_MAGIC_DENORMAL        0x38800000
+
+#if !defined(_M_AMD64)
+
+inline
+float
+MlasConvertHalfToFloat(
+    unsigned short Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a half-precision float to a single-precision float.
+
+    The exponent and mantissa are shifted into place and the exponent is
+    rebiased. Infinities and NaNs receive a second adjustment so that their
+    exponent ends up all ones. Denormals are renormalized by subtracting a
+    magic value that has the exponent of the smallest normal number.
+
+Arguments:
+
+    Value - Supplies the half-precision float.
+
+Return Value:
+
+    Returns the single-precision float.
+
+--*/
+{
+    uint32_t Bits = uint32_t(Value & 0x7FFF) << 13;
+    const uint32_t Exponent = Bits & MLAS_FP16_EXPONENT_MASK;
+
+    Bits += MLAS_FP16_EXPONENT_ADJUST;
+
+    if (Exponent == MLAS_FP16_EXPONENT_MASK) {
+        Bits += MLAS_FP16_EXPONENT_ADJUST;
+    } else if (Exponent == 0) {
+        Bits += 1 << 23;
+        float Normalized;
+        memcpy(&Normalized, &Bits, sizeof(Normalized));
+        const uint32_t MagicBits = MLAS_FP16_MAGIC_DENORMAL;
+        float Magic;
+        memcpy(&Magic, &MagicBits, sizeof(Magic));
+        Normalized -= Magic;
+        memcpy(&Bits, &Normalized, sizeof(Bits));
+    }
+
+    Bits |= uint32_t(Value & 0x8000) << 16;
+
+    float Result;
+    memcpy(&Result, &Bits, sizeof(Result));
+    return Result;
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernel(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half-precision floats to the
+    destination buffer of single-precision floats.
+
+    This implementation uses SSE2 instructions where available.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer of half-precision
+        floats.
+
+    Destination - Supplies the address of the destination buffer of
+        single-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128i MaskSign = _mm_set1_epi32(0x7FFF);
+    const __m128i ExponentMask = _mm_set1_epi32(MLAS_FP16_EXPONENT_MASK);
+    const __m128i ExponentAdjust = _mm_set1_epi32(MLAS_FP16_EXPONENT_ADJUST);
+    const __m128i NormalizeAdjust = _mm_set1_epi32(1 << 23);
+    const __m128 MagicDenormal = _mm_castsi128_ps(_mm_set1_epi32(MLAS_FP16_MAGIC_DENORMAL));
+
+    while (Count >= 4) {
+
+        __m128i Value = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)Source),
+            _mm_setzero_si128());
+
+        __m128i Bits = _mm_slli_epi32(_mm_and_si128(Value, MaskSign), 13);
+        __m128i Exponent = _mm_and_si128(Bits, ExponentMask);
+
+        Bits = _mm_add_epi32(Bits, ExponentAdjust);
+
+        //
+        // Adjust the exponent again for infinities and NaNs.
+        //
+
+        __m128i IsSpecial = _mm_cmpeq_epi32(Exponent, ExponentMask);
+        Bits = _mm_add_epi32(Bits, _mm_and_si128(IsSpecial, ExponentAdjust));
+
+        //
+        // Renormalize denormals and zeroes.
+        //
+
+        __m128i IsDenormal = _mm_cmpeq_epi32(Exponent, _mm_setzero_si128());
+        __m128 Normalized = _mm_sub_ps(
+            _mm_castsi128_ps(_mm_add_epi32(Bits, NormalizeAdjust)), MagicDenormal);
+        Bits = _mm_or_si128(_mm_and_si128(IsDenormal, _mm_castps_si128(Normalized)),
+            _mm_andnot_si128(IsDenormal, Bits));
+
+        Bits = _mm_or_si128(Bits, _mm_slli_epi32(_mm_andnot_si128(MaskSign, Value), 16));
+
+        _mm_storeu_ps(Destination, _mm_castsi128_ps(Bits));
+
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+#endif
+
+    while (Count > 0) {
+        *Destination++ = MlasConvertHalfToFloat(*Source++);
+        Count -= 1;
+    }
+}
+
+#endif
+
+inline
+unsigned short
+MlasConvertFloatToHalf(
+    float Float
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single-precision float to a half-precision float.
+
+    Values are rounded to the nearest even half-precision value. Values too
+    large for half-precision become infinities and NaNs remain NaNs.
+
+Arguments:
+
+    Float - Supplies the single-precision float.
+
+Return Value:
+
+    Returns the half-precision float.
+
+--*/
+{
+    uint32_t Bits;
+    memcpy(&Bits, &Float, sizeof(Bits));
+
+    const uint32_t Sign = (Bits >> 16) & 0x8000;
+    const uint32_t Magnitude = Bits & 0x7FFFFFFF;
+
+    uint32_t Value;
+
+    if (Magnitude >= 0x7F800000) {
+
+        //
+        // Infinity or NaN. Keep a quiet NaN bit so that truncating the
+        // mantissa does not produce an infinity.
+        //
+
+        Value = (Magnitude > 0x7F800000) ? 0x7E00 : 0x7C00;
+
+    } else if (Magnitude >= 0x477FF000) {
+
+        //
+        // The value rounds to a magnitude larger than the maximum
+        // half-precision value.
+        //
+
+        Value = 0x7C00;
+
+    } else if (Magnitude < 0x38800000) {
+
+        //
+        // The value is a denormal or zero in half-precision. Adding the
+        // value to 0.5 shifts the mantissa into the low bits with the
+        // floating point unit applying round to nearest even.
+        //
+
+        float Denormal;
+        memcpy(&Denormal, &Magnitude, sizeof(Denormal));
+        Denormal += 0.5f;
+        uint32_t Shifted;
+        memcpy(&Shifted, &Denormal, sizeof(Shifted));
+        Value = Shifted - 0x3F000000;
+
+    } else {
+
+        //
+        // Rebias the exponent and round the mantissa to nearest even.
+        //
+
+        const uint32_t MantissaOdd = (Magnitude >> 13) & 1;
+        Value = (Magnitude - MLAS_FP16_EXPONENT_ADJUST + 0xFFF + MantissaOdd) >> 13;
+    }
+
+    return (unsigned short)(Value | Sign);
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernel(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single-precision floats to the
+    destination buffer of half-precision floats.
+
+    This implementation uses SSE2 instructions where available.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer of single-precision
+        floats.
+
+    Destination - Supplies the address of the destination buffer of
+        half-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128i MaskMagnitude = _mm_set1_epi32(0x7FFFFFFF);
+    const __m128i Infinity = _mm_set1_epi32(0x7F800000);
+    const __m128i Overflow = _mm_set1_epi32(0x477FF000 - 1);
+    const __m128i SmallestNormal = _mm_set1_epi32(0x38800000);
+    const __m128i ExponentAdjust = _mm_set1_epi32(0xFFF - MLAS_FP16_EXPONENT_ADJUST);
+    const __m128i One = _mm_set1_epi32(1);
+    const __m128i HalfInfinity = _mm_set1_epi32(0x7C00);
+    const __m128i HalfQuietNaN = _mm_set1_epi32(0x7E00);
+    const __m128 DenormalShift = _mm_set1_ps(0.5f);
+    const __m128i DenormalAdjust = _mm_set1_epi32(0x3F000000);
+
+    while (Count >= 4) {
+
+        __m128i Bits = _mm_loadu_si128((const __m128i*)Source);
+        __m128i Magnitude = _mm_and_si128(Bits, MaskMagnitude);
+
+        //
+        // Compute the value of each of the cases of the scalar conversion
+        // and select the one that applies to each element. The magnitudes
+        // are positive, so the signed comparisons order them correctly.
+        //
+
+        __m128i MantissaOdd = _mm_and_si128(_mm_srli_epi32(Magnitude, 13), One);
+        __m128i Value = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(Magnitude, ExponentAdjust), MantissaOdd), 13);
+
+        __m128i Denormal = _mm_sub_epi32(
+            _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(Magnitude), DenormalShift)), DenormalAdjust);
+        __m128i IsDenormal = _mm_cmplt_epi32(Magnitude, SmallestNormal);
+        Value = _mm_or_si128(_mm_and_si128(IsDenormal, Denormal), _mm_andnot_si128(IsDenormal, Value));
+
+        __m128i IsOverflow = _mm_cmpgt_epi32(Magnitude, Overflow);
+        Value = _mm_or_si128(_mm_and_si128(IsOverflow, HalfInfinity), _mm_andnot_si128(IsOverflow, Value));
+
+        __m128i IsNaN = _mm_cmpgt_epi32(Magnitude, Infinity);
+        Value = _mm_or_si128(_mm_and_si128(IsNaN, HalfQuietNaN), _mm_andnot_si128(IsNaN, Value));
+
+        Value = _mm_or_si128(Value, _mm_and_si128(_mm_srli_epi32(Bits, 16), _mm_set1_epi32(0x8000)));
+
+        //
+        // Sign extend the 16-bit values so that the signed saturation of
+        // the pack keeps their bits.
+        //
+
+        Value = _mm_srai_epi32(_mm_slli_epi32(Value, 16), 16);
+        _mm_storel_epi64((__m128i*)Destination, _mm_packs_epi32(Value, Value));
+
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+#endif
+
+    while (Count > 0) {
+        *Destination++ = MlasConvertFloatToHalf(*Source++);
+        Count -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half-precision floats to the
+    destination buffer of single-precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer of half-precision
+        floats.
+
+    Destination - Supplies the address of the destination buffer of
+        single-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertHalfToFloatRoutine(Source, Destination, Count);
+#else
+    MlasConvertHalfToFloatKernel(Source, Destination, Count);
+#endif
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single-precision floats to the
+    destination buffer of half-precision floats.
+
+    Values are rounded to the nearest even half-precision value. Values too
+    large for half-precision become infinities and NaNs remain NaNs.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer of single-precision
+        floats.
+
+    Destination - Supplies the address of the destination buffer of
+        half-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertFloatToHalfRoutine(Source, Destination, Count);
+#else
+    MlasConvertFloatToHalfKernel(Source, Destination, Count);
+#endif
+}
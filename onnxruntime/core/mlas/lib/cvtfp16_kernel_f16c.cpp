@@ -0,0 +1,134 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvtfp16_kernel_f16c.cpp
+
+Abstract:
+
+    This module implements the kernels to convert between half-precision and
+    single-precision floating point buffers with F16C instructions.
+
+    This module must be compiled with AVX and F16C code generation enabled.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernelF16C(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half-precision floats to the
+    destination buffer of single-precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer of half-precision
+        floats.
+
+    Destination - Supplies the address of the destination buffer of
+        single-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 8) {
+
+        __m256 Float = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)Source));
+        _mm256_storeu_ps(Destination, Float);
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        //
+        // Convert the remaining elements through a vector sized buffer.
+        //
+
+        unsigned short HalfBuffer[8] = { 0 };
+        float FloatBuffer[8];
+
+        memcpy(HalfBuffer, Source, Count * sizeof(unsigned short));
+        _mm256_storeu_ps(FloatBuffer, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)HalfBuffer)));
+        memcpy(Destination, FloatBuffer, Count * sizeof(float));
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernelF16C(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single-precision floats to the
+    destination buffer of half-precision floats.
+
+    Values are rounded to the nearest even half-precision value. Values too
+    large for half-precision become infinities and NaNs remain NaNs.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer of single-precision
+        floats.
+
+    Destination - Supplies the address of the destination buffer of
+        half-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 8) {
+
+        __m128i Half = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)Destination, Half);
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        //
+        // Convert the remaining elements through a vector sized buffer.
+        //
+
+        float FloatBuffer[8] = { 0 };
+        unsigned short HalfBuffer[8];
+
+        memcpy(FloatBuffer, Source, Count * sizeof(float));
+        _mm_storeu_si128((__m128i*)HalfBuffer,
+            _mm256_cvtps_ph(_mm256_loadu_ps(FloatBuffer), _MM_FROUND_TO_NEAREST_INT));
+        memcpy(Destination, HalfBuffer, Count * sizeof(unsigned short));
+    }
+}
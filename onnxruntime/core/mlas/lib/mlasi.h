@@ -22,6 +22,7 @@ Abstract:
 #include <memory.h>
 #include <algorithm>
 #include <limits>
+#include <type_traits>
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -82,12 +83,18 @@ Abstract:
 #if defined(_OPENMP)
 #include <omp.h>
 #define MLAS_USE_OPENMP
-#define MLAS_HAS_THREADING_SUPPORT
 #elif defined(_WIN32)
 #define MLAS_USE_WIN32_THREADPOOL
-#define MLAS_HAS_THREADING_SUPPORT
 #endif
 
+//
+// A thread pool may be supplied by the host through MlasSetThreadPool on any
+// platform, so threading support is always compiled in. Operations fall back
+// to a single thread when GetMaximumThreadCount returns one.
+//
+
+#define MLAS_HAS_THREADING_SUPPORT
+
 //
 // Define the maximum number of threads supported by this implementation.
 //
@@ -112,6 +119,18 @@ Abstract:
 
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
 
+//
+// Define the strides to step through slices of the input matrices for the
+// quantized integer matrix/matrix multiply operation (QGEMM).
+//
+// The 8-bit inputs are widened to 16-bit with the zero point subtracted, so
+// the K stride is in elements and must be even.
+//
+
+#define MLAS_QGEMM_STRIDEM                          16
+#define MLAS_QGEMM_STRIDEN                          128
+#define MLAS_QGEMM_STRIDEK                          256
+
 //
 // Define the prototypes of the platform optimized routines.
 //
@@ -176,6 +195,80 @@ void
 
 typedef MLAS_TANH_KERNEL_ROUTINE* PMLAS_TANH_KERNEL_ROUTINE;
 
+typedef
+void
+(MLASCALL MLAS_COMPUTE_UNARY_KERNEL_ROUTINE)(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+typedef MLAS_COMPUTE_UNARY_KERNEL_ROUTINE* PMLAS_COMPUTE_UNARY_KERNEL_ROUTINE;
+
+typedef
+void
+(MLASCALL MLAS_SOFTMAX_KERNEL_ROUTINE)(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    );
+
+typedef MLAS_SOFTMAX_KERNEL_ROUTINE* PMLAS_SOFTMAX_KERNEL_ROUTINE;
+
+typedef
+size_t
+(MLASCALL MLAS_QGEMM_KERNEL_ROUTINE)(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    );
+
+typedef MLAS_QGEMM_KERNEL_ROUTINE* PMLAS_QGEMM_KERNEL_ROUTINE;
+
+struct MLAS_NCHWC_WORK_BLOCK;
+
+typedef
+void
+(MLASCALL MLAS_NCHWC_CONV_ROW_ROUTINE)(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t FilterCount,
+    size_t oh
+    );
+
+typedef MLAS_NCHWC_CONV_ROW_ROUTINE* PMLAS_NCHWC_CONV_ROW_ROUTINE;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_HALF_TO_FLOAT_ROUTINE)(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_HALF_TO_FLOAT_ROUTINE* PMLAS_CONVERT_HALF_TO_FLOAT_ROUTINE;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_FLOAT_TO_HALF_ROUTINE)(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_FLOAT_TO_HALF_ROUTINE* PMLAS_CONVERT_FLOAT_TO_HALF_ROUTINE;
+
 extern "C" {
 
     MLAS_SGEMM_KERNEL_ROUTINE MlasSgemmKernelZero;
@@ -210,6 +303,43 @@ extern "C" {
     MLAS_TANH_KERNEL_ROUTINE MlasTanhKernelFma3;
 #endif
 
+    MLAS_COMPUTE_UNARY_KERNEL_ROUTINE MlasExpKernel;
+    MLAS_COMPUTE_UNARY_KERNEL_ROUTINE MlasErfKernel;
+    MLAS_COMPUTE_UNARY_KERNEL_ROUTINE MlasGeluKernel;
+    MLAS_SOFTMAX_KERNEL_ROUTINE MlasSoftmaxKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_COMPUTE_UNARY_KERNEL_ROUTINE MlasExpKernelAvx2;
+    MLAS_COMPUTE_UNARY_KERNEL_ROUTINE MlasErfKernelAvx2;
+    MLAS_COMPUTE_UNARY_KERNEL_ROUTINE MlasGeluKernelAvx2;
+    MLAS_SOFTMAX_KERNEL_ROUTINE MlasSoftmaxKernelAvx2;
+    MLAS_COMPUTE_UNARY_KERNEL_ROUTINE MlasExpKernelAvx512F;
+    MLAS_COMPUTE_UNARY_KERNEL_ROUTINE MlasErfKernelAvx512F;
+    MLAS_COMPUTE_UNARY_KERNEL_ROUTINE MlasGeluKernelAvx512F;
+    MLAS_SOFTMAX_KERNEL_ROUTINE MlasSoftmaxKernelAvx512F;
+#endif
+
+    MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernelAvx2;
+    MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernelAvx512BW;
+    MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernelAvx512Vnni;
+#elif defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_ARM)
+    MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernelNeon;
+#endif
+
+    MLAS_NCHWC_CONV_ROW_ROUTINE MlasNchwcConvRowKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_NCHWC_CONV_ROW_ROUTINE MlasNchwcConvRowKernelAvx2;
+    MLAS_NCHWC_CONV_ROW_ROUTINE MlasNchwcConvRowKernelAvx512F;
+#endif
+
+    MLAS_CONVERT_HALF_TO_FLOAT_ROUTINE MlasConvertHalfToFloatKernel;
+    MLAS_CONVERT_FLOAT_TO_HALF_ROUTINE MlasConvertFloatToHalfKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CONVERT_HALF_TO_FLOAT_ROUTINE MlasConvertHalfToFloatKernelF16C;
+    MLAS_CONVERT_FLOAT_TO_HALF_ROUTINE MlasConvertFloatToHalfKernelF16C;
+#endif
+
 }
 
 //
@@ -231,6 +361,27 @@ extern "C" {
 #endif
 #endif
 
+//
+// Define the target number of per-thread elements before using another thread
+// to compute additional rows of a softmax operation.
+//
+
+#define MLAS_SOFTMAX_THREAD_COMPLEXITY              (64 * 1024)
+
+//
+// Define the target number of per-thread input elements reduced before using
+// another thread to compute additional channels of a pooling operation.
+//
+
+#define MLAS_POOL_THREAD_COMPLEXITY                 (64 * 1024)
+
+//
+// Define the target number of per-thread elements before using another thread
+// to transpose additional tiles of rows of a transpose operation.
+//
+
+#define MLAS_TRANSPOSE_THREAD_COMPLEXITY            (64 * 1024)
+
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
@@ -249,7 +400,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     );
 
 //
@@ -271,42 +423,87 @@ struct MLAS_PLATFORM {
     PMLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE TransposePackB16x4Routine;
     PMLAS_LOGISTIC_KERNEL_ROUTINE LogisticKernelRoutine;
     PMLAS_TANH_KERNEL_ROUTINE TanhKernelRoutine;
+    PMLAS_COMPUTE_UNARY_KERNEL_ROUTINE ExpKernelRoutine;
+    PMLAS_COMPUTE_UNARY_KERNEL_ROUTINE ErfKernelRoutine;
+    PMLAS_COMPUTE_UNARY_KERNEL_ROUTINE GeluKernelRoutine;
+    PMLAS_SOFTMAX_KERNEL_ROUTINE SoftmaxKernelRoutine;
+    PMLAS_QGEMM_KERNEL_ROUTINE QgemmKernelRoutine;
+    PMLAS_NCHWC_CONV_ROW_ROUTINE NchwcConvRowRoutine;
+    size_t NchwcBlockSize;
+    PMLAS_CONVERT_HALF_TO_FLOAT_ROUTINE ConvertHalfToFloatRoutine;
+    PMLAS_CONVERT_FLOAT_TO_HALF_ROUTINE ConvertFloatToHalfRoutine;
 #endif
 
 #if defined(MLAS_USE_WIN32_THREADPOOL)
     int32_t MaximumThreadCount;
 #endif
 
+    PMLAS_EXECUTE_THREADED_CALLBACK ExecuteThreadedCallback;
+    void* ThreadPool;
+    int32_t ThreadPoolMaximumThreadCount;
+
     int32_t
     GetMaximumThreadCount(
         void
-        )
-    {
+        );
+};
+
+extern MLAS_PLATFORM MlasPlatform;
+
+//
+// Stores the thread limit for operations started from the current thread (see
+// MlasSetThreadLimit).
+//
+
+extern thread_local int32_t MlasThreadLimit;
+
+//
+// Stores the cancellation of operations started from the current thread (see
+// MlasSetCancellation).
+//
+
+extern thread_local const MLAS_CANCELLATION* MlasCancellation;
+
+inline
+bool
+MlasIsCancelled(
+    void
+    )
+{
+    return MlasCancellation != nullptr && MlasCancellation->IsCancelled(MlasCancellation->Context);
+}
+
+inline
+int32_t
+MLAS_PLATFORM::GetMaximumThreadCount(
+    void
+    )
+{
+    int32_t ThreadCount;
+
+    if (ExecuteThreadedCallback != nullptr) {
+        ThreadCount = ThreadPoolMaximumThreadCount;
+    } else {
 #if defined(MLAS_USE_OPENMP)
-        return (omp_get_num_threads() == 1) ? omp_get_max_threads() : 1;
+        ThreadCount = (omp_get_num_threads() == 1) ? omp_get_max_threads() : 1;
 #elif defined(MLAS_USE_WIN32_THREADPOOL)
-        return MaximumThreadCount;
+        ThreadCount = MaximumThreadCount;
 #else
-        return 1;
+        ThreadCount = 1;
 #endif
     }
-};
 
-extern MLAS_PLATFORM MlasPlatform;
+    if (MlasThreadLimit > 0 && MlasThreadLimit < ThreadCount) {
+        ThreadCount = MlasThreadLimit;
+    }
+
+    return ThreadCount;
+}
 
 //
 // Threading support.
 //
 
-typedef
-void
-(MLAS_THREADED_ROUTINE)(
-    void* Context,
-    int32_t Index
-    );
-
-typedef MLAS_THREADED_ROUTINE* PMLAS_THREADED_ROUTINE;
-
 void
 MlasExecuteThreaded(
     PMLAS_THREADED_ROUTINE ThreadedRoutine,
@@ -43,6 +43,15 @@ Return Value:
 --*/
 {
 
+    //
+    // Default to the built in threading support until the host supplies a
+    // thread pool.
+    //
+
+    this->ExecuteThreadedCallback = nullptr;
+    this->ThreadPool = nullptr;
+    this->ThreadPoolMaximumThreadCount = 1;
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
     //
@@ -55,6 +64,15 @@ Return Value:
     this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
     this->LogisticKernelRoutine = MlasLogisticKernel;
     this->TanhKernelRoutine = MlasTanhKernel;
+    this->ExpKernelRoutine = MlasExpKernel;
+    this->ErfKernelRoutine = MlasErfKernel;
+    this->GeluKernelRoutine = MlasGeluKernel;
+    this->SoftmaxKernelRoutine = MlasSoftmaxKernel;
+    this->QgemmKernelRoutine = MlasQgemmKernel;
+    this->NchwcConvRowRoutine = MlasNchwcConvRowKernel;
+    this->NchwcBlockSize = 8;
+    this->ConvertHalfToFloatRoutine = MlasConvertHalfToFloatKernel;
+    this->ConvertFloatToHalfRoutine = MlasConvertFloatToHalfKernel;
 #endif
 
     //
@@ -106,14 +124,41 @@ Return Value:
                 if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
                     this->KernelZeroRoutine = MlasSgemmKernelZeroAvx512F;
                     this->KernelAddRoutine = MlasSgemmKernelAddAvx512F;
+                    this->NchwcConvRowRoutine = MlasNchwcConvRowKernelAvx512F;
+                    this->NchwcBlockSize = 16;
+                    this->ExpKernelRoutine = MlasExpKernelAvx512F;
+                    this->ErfKernelRoutine = MlasErfKernelAvx512F;
+                    this->GeluKernelRoutine = MlasGeluKernelAvx512F;
+                    this->SoftmaxKernelRoutine = MlasSoftmaxKernelAvx512F;
                 } else {
                     this->KernelZeroRoutine = MlasSgemmKernelZeroFma3;
                     this->KernelAddRoutine = MlasSgemmKernelAddFma3;
+                    this->NchwcConvRowRoutine = MlasNchwcConvRowKernelAvx2;
+                    this->NchwcBlockSize = 8;
+                    this->ExpKernelRoutine = MlasExpKernelAvx2;
+                    this->ErfKernelRoutine = MlasErfKernelAvx2;
+                    this->GeluKernelRoutine = MlasGeluKernelAvx2;
+                    this->SoftmaxKernelRoutine = MlasSoftmaxKernelAvx2;
                 }
 
                 this->LogisticKernelRoutine = MlasLogisticKernelFma3;
                 this->TanhKernelRoutine = MlasTanhKernelFma3;
 
+                //
+                // Check if the processor supports AVX512BW (and optionally
+                // AVX512_VNNI) for the quantized integer kernels.
+                //
+
+                if (((Cpuid7[1] & 0x40010000) == 0x40010000) && ((xcr0 & 0xE0) == 0xE0)) {
+                    if ((Cpuid7[2] & 0x800) != 0) {
+                        this->QgemmKernelRoutine = MlasQgemmKernelAvx512Vnni;
+                    } else {
+                        this->QgemmKernelRoutine = MlasQgemmKernelAvx512BW;
+                    }
+                } else {
+                    this->QgemmKernelRoutine = MlasQgemmKernelAvx2;
+                }
+
             } else {
 
                 this->KernelZeroRoutine = MlasSgemmKernelZeroAvx;
@@ -124,6 +169,16 @@ Return Value:
             this->KernelM1TransposeBRoutine = MlasSgemmKernelM1TransposeBAvx;
             this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Avx;
 
+            //
+            // Check if the processor supports the F16C feature for the
+            // half-precision conversions.
+            //
+
+            if ((Cpuid1[2] & 0x20000000) != 0) {
+                this->ConvertHalfToFloatRoutine = MlasConvertHalfToFloatKernelF16C;
+                this->ConvertFloatToHalfRoutine = MlasConvertFloatToHalfKernelF16C;
+            }
+
 #endif
 
         }
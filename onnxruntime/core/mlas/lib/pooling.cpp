@@ -21,15 +21,7 @@ Abstract:
 // threads.
 //
 
-struct MLAS_WORK_BLOCK {
-    MLAS_POOLING_KIND PoolingKind;
-    size_t InputShape[3];
-    size_t InputSize;
-    size_t OutputShape[3];
-    int64_t KernelShape[3];
-    int64_t Padding[6];
-    int64_t StrideShape[3];
-};
+struct MLAS_WORK_BLOCK;
 
 //
 // Define the prototype of the pooling kernel routine.
@@ -46,6 +38,22 @@ void
 
 typedef MLAS_POOL_KERNEL_ROUTINE* PMLAS_POOL_KERNEL_ROUTINE;
 
+struct MLAS_WORK_BLOCK {
+    MLAS_POOLING_KIND PoolingKind;
+    size_t InputShape[3];
+    size_t InputSize;
+    size_t OutputShape[3];
+    size_t OutputSize;
+    int64_t KernelShape[3];
+    int64_t Padding[6];
+    int64_t StrideShape[3];
+    PMLAS_POOL_KERNEL_ROUTINE PoolKernelRoutine;
+    int32_t TargetThreadCount;
+    size_t TotalChannelCount;
+    const float* Input;
+    float* Output;
+};
+
 //
 // Define the number of elements to allocate on the stack for the reduction
 // buffer in the vectorized kernels.
@@ -1171,6 +1179,58 @@ static const PMLAS_POOL_KERNEL_ROUTINE MlasPoolVectorKernels[][2] =
     },
 };
 
+void
+MlasPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_WORK_BLOCK* WorkBlock = (MLAS_WORK_BLOCK*)Context;
+
+    //
+    // Partition the channels across the threads.
+    //
+
+    const size_t TotalChannelCount = WorkBlock->TotalChannelCount;
+
+    const size_t ChannelsPerThread = TotalChannelCount / WorkBlock->TargetThreadCount;
+    const size_t ChannelsExtra = TotalChannelCount % WorkBlock->TargetThreadCount;
+
+    size_t StartChannel;
+    size_t ChannelCount;
+
+    if (uint32_t(Index) < ChannelsExtra) {
+        StartChannel = (ChannelsPerThread + 1) * Index;
+        ChannelCount = ChannelsPerThread + 1;
+    } else {
+        StartChannel = ChannelsPerThread * Index + ChannelsExtra;
+        ChannelCount = ChannelsPerThread;
+    }
+
+    const float* Input = WorkBlock->Input + StartChannel * WorkBlock->InputSize;
+    float* Output = WorkBlock->Output + StartChannel * WorkBlock->OutputSize;
+
+    WorkBlock->PoolKernelRoutine(WorkBlock, ChannelCount, Input, Output);
+}
+
 void
 MLASCALL
 MlasPool(
@@ -1278,6 +1338,7 @@ Return Value:
     }
 
     WorkBlock.InputSize = InputSize;
+    WorkBlock.OutputSize = OutputSize;
 
     //
     // Determine which pooling kernel routine to use.
@@ -1316,20 +1377,49 @@ Return Value:
     }
 
     //
-    // Execute the pooling kernel routine.
+    // Compute the number of target threads given the complexity of the
+    // operation. Limit the number of threads to the number of channels.
     //
 
-#if defined(MLAS_USE_OPENMP)
+    int64_t KernelSize = 1;
 
-    #pragma omp parallel for
-    for (int64_t c = 0; c < int64_t(TotalChannelCount); c++) {
-        PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize);
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+        KernelSize *= WorkBlock.KernelShape[dim];
     }
 
-#else
+    const double Complexity = double(TotalChannelCount) * double(OutputSize) * double(KernelSize);
 
-    PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
+    int32_t TargetThreadCount;
 
-#endif
+    if (Complexity < double(MLAS_POOL_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_POOL_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= TotalChannelCount) {
+        TargetThreadCount = int32_t(TotalChannelCount);
+    }
+
+    if (TargetThreadCount <= 1) {
+        TargetThreadCount = 1;
+    }
+
+    //
+    // Execute the pooling kernel routine.
+    //
+
+    WorkBlock.PoolKernelRoutine = PoolKernelRoutine;
+    WorkBlock.TargetThreadCount = TargetThreadCount;
+    WorkBlock.TotalChannelCount = TotalChannelCount;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
 
+    MlasExecuteThreaded(MlasPoolThreaded, &WorkBlock, TargetThreadCount);
 }
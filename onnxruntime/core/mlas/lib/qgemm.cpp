@@ -0,0 +1,791 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm.cpp
+
+Abstract:
+
+    This module implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+    The 8-bit inputs are widened to 16-bit with the zero point subtracted as
+    they are packed. Each pair of elements along the K dimension is then
+    multiplied and accumulated to 32-bit with a single multiply-add
+    instruction (pmaddwd or vpdpwssd), so unsigned and signed inputs with any
+    zero point are computed exactly without any correction terms.
+
+--*/
+
+#include "mlasi.h"
+
+#include <type_traits>
+
+//
+// Define the parameters to execute segments of a QGEMM operation on worker
+// threads.
+//
+
+struct MLAS_QGEMM_WORK_BLOCK {
+    size_t K;
+    size_t lda;
+    size_t ldb;
+    size_t ldc;
+    int32_t offa;
+    int32_t offb;
+    bool BIsSigned;
+    struct SEGMENT {
+        size_t M;
+        size_t N;
+        const uint8_t* A;
+        const void* B;
+        int32_t* C;
+    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+};
+
+size_t
+MLASCALL
+MlasQgemmKernel(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been widened to
+        16-bit with the zero point subtracted.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasQgemmCopyPackB.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of columns from matrix A and the
+        number of pairs of rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(CountM);
+    MLAS_UNREFERENCED_PARAMETER(lda);
+    MLAS_UNREFERENCED_PARAMETER(ldc);
+
+    //
+    // Process a single row of matrix A in a loop.
+    //
+
+    while (CountN > 0) {
+
+        int32_t Accumulators[16] = { 0 };
+
+        const int16_t* a = A;
+        const int16_t* b = B;
+
+        for (size_t k = 0; k < PairCountK; k++) {
+
+            const int32_t a0 = a[0];
+            const int32_t a1 = a[1];
+
+            for (size_t n = 0; n < 16; n++) {
+                Accumulators[n] += a0 * int32_t(b[n * 2]) + a1 * int32_t(b[n * 2 + 1]);
+            }
+
+            a += 2;
+            b += 32;
+        }
+
+        size_t CountNBlock = (CountN < 16) ? CountN : 16;
+
+        for (size_t n = 0; n < CountNBlock; n++) {
+            C[n] = ZeroMode ? Accumulators[n] : C[n] + Accumulators[n];
+        }
+
+        B += PairCountK * 32;
+        C += CountNBlock;
+        CountN -= CountNBlock;
+    }
+
+    return 1;
+}
+
+void
+MlasQgemmCopyPackA(
+    int16_t* D,
+    const uint8_t* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK,
+    int32_t offa
+    )
+/*++
+
+Routine Description:
+
+    This routine copies elements from the source matrix to the destination
+    buffer, widening each element to 16-bit and subtracting the zero point.
+
+    Each row of the destination buffer is padded to an even number of
+    elements with zeroes.
+
+Arguments:
+
+    D - Supplies the address of the destination buffer.
+
+    A - Supplies the address of the source matrix.
+
+    lda - Supplies the number of elements per row of the source matrix.
+
+    CountM - Supplies the number of rows of the source matrix to copy.
+
+    CountK - Supplies the number of columns of the source matrix to copy.
+
+    offa - Supplies the zero point of the source matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedCountK = (CountK + 1) & ~size_t(1);
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        for (size_t k = 0; k < CountK; k++) {
+            D[k] = int16_t(int32_t(A[k]) - offa);
+        }
+
+        if (AlignedCountK != CountK) {
+            D[CountK] = 0;
+        }
+
+        D += AlignedCountK;
+        A += lda;
+    }
+}
+
+template<typename BType>
+void
+MlasQgemmCopyPackB(
+    int16_t* D,
+    const BType* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    int32_t offb
+    )
+/*++
+
+Routine Description:
+
+    This routine copies elements from the source matrix to the destination
+    packed buffer, widening each element to 16-bit and subtracting the zero
+    point.
+
+    Columns of 16 elements from the source matrix are unrolled to be
+    physically contiguous, with the elements of each pair of rows interleaved
+    for the multiply-add instructions. Any remaining columns less than 16
+    elements wide and any odd row are zero-padded.
+
+Arguments:
+
+    D - Supplies the address of the destination packed buffer.
+
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    CountN - Supplies the number of columns of the source matrix to copy.
+
+    CountK - Supplies the number of rows of the source matrix to copy.
+
+    offb - Supplies the zero point of the source matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountN > 0) {
+
+        size_t CountNBlock = (CountN < 16) ? CountN : 16;
+
+        const BType* b = B;
+
+        for (size_t k = 0; k < CountK; k += 2) {
+
+            const bool HasSecondRow = (k + 1) < CountK;
+
+            for (size_t n = 0; n < 16; n++) {
+
+                if (n < CountNBlock) {
+                    D[n * 2] = int16_t(int32_t(b[n]) - offb);
+                    D[n * 2 + 1] = HasSecondRow ? int16_t(int32_t(b[n + ldb]) - offb) : 0;
+                } else {
+                    D[n * 2] = 0;
+                    D[n * 2 + 1] = 0;
+                }
+            }
+
+            D += 32;
+            b += ldb * 2;
+        }
+
+        B += CountNBlock;
+        CountN -= CountNBlock;
+    }
+}
+
+template<typename BType>
+void
+MlasQgemmOperation(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    int32_t offa,
+    const BType* B,
+    size_t ldb,
+    int32_t offb,
+    int32_t* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(int16_t PanelA[MLAS_QGEMM_STRIDEM * MLAS_QGEMM_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(int16_t PanelB[MLAS_QGEMM_STRIDEN * MLAS_QGEMM_STRIDEK], 64);
+
+    //
+    // Handle the degenerate case of an empty inner dimension.
+    //
+
+    if (K == 0) {
+
+        for (size_t m = 0; m < M; m++) {
+            std::fill_n(C + m * ldc, N, 0);
+        }
+
+        return;
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_QGEMM_KERNEL_ROUTINE QgemmKernelRoutine = MlasPlatform.QgemmKernelRoutine;
+#elif defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_ARM)
+    PMLAS_QGEMM_KERNEL_ROUTINE QgemmKernelRoutine = MlasQgemmKernelNeon;
+#else
+    PMLAS_QGEMM_KERNEL_ROUTINE QgemmKernelRoutine = MlasQgemmKernel;
+#endif
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+    size_t CountM;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = MLAS_QGEMM_STRIDEN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = MLAS_QGEMM_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            const size_t PairCountK = (CountK + 1) / 2;
+
+            MlasQgemmCopyPackB(PanelB, B + n + k * ldb, ldb, CountN, CountK, offb);
+
+            //
+            // Step through each slice of matrix A along the M dimension.
+            //
+
+            for (size_t m = 0; m < M; m += CountM) {
+
+                CountM = MLAS_QGEMM_STRIDEM;
+
+                if (CountM > (M - m)) {
+                    CountM = M - m;
+                }
+
+                MlasQgemmCopyPackA(PanelA, A + k + m * lda, lda, CountM, CountK, offa);
+
+                const int16_t* pa = PanelA;
+                int32_t* c = C + n + m * ldc;
+
+                size_t RowsRemaining = CountM;
+                size_t RowsHandled;
+
+                do {
+
+                    RowsHandled = QgemmKernelRoutine(pa, PanelB, c, PairCountK,
+                        RowsRemaining, CountN, PairCountK * 2, ldc, k == 0);
+
+                    pa += PairCountK * 2 * RowsHandled;
+                    c += ldc * RowsHandled;
+
+                    RowsRemaining -= RowsHandled;
+
+                } while (RowsRemaining > 0);
+            }
+        }
+    }
+}
+
+void
+MlasQgemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    QGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_QGEMM_WORK_BLOCK* WorkBlock = (MLAS_QGEMM_WORK_BLOCK*)Context;
+
+    MLAS_QGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    if (WorkBlock->BIsSigned) {
+        MlasQgemmOperation(Segment->M, Segment->N, WorkBlock->K, Segment->A,
+            WorkBlock->lda, WorkBlock->offa, (const int8_t*)Segment->B,
+            WorkBlock->ldb, WorkBlock->offb, Segment->C, WorkBlock->ldc);
+    } else {
+        MlasQgemmOperation(Segment->M, Segment->N, WorkBlock->K, Segment->A,
+            WorkBlock->lda, WorkBlock->offa, (const uint8_t*)Segment->B,
+            WorkBlock->ldb, WorkBlock->offb, Segment->C, WorkBlock->ldc);
+    }
+}
+
+template<typename BType>
+void
+MlasQgemmDispatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    int32_t offa,
+    const BType* B,
+    size_t ldb,
+    int32_t offb,
+    int32_t* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine runs the quantized integer matrix/matrix multiply operation
+    (QGEMM) across multiple threads or falls back to a single thread based on
+    the dimensions and system configuration.
+
+Arguments:
+
+    See MlasQgemmOperation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_QGEMM_WORK_BLOCK WorkBlock;
+    int32_t TargetThreadCount;
+
+    //
+    // Compute the number of target threads given the complexity of the QGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    double Complexity = double(M) * double(N) * double(K);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasQgemmOperation(M, N, K, A, lda, offa, B, ldb, offb, C, ldc);
+        return;
+    }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldb = ldb;
+    WorkBlock.ldc = ldc;
+    WorkBlock.offa = offa;
+    WorkBlock.offb = offb;
+    WorkBlock.BIsSigned = std::is_signed<BType>::value;
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+
+    if (N > M) {
+
+        size_t StrideN = N / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != N) {
+            StrideN++;
+        }
+
+        StrideN = (StrideN + 15) & ~size_t(15);
+
+        for (size_t CountN, n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            WorkBlock.Segments[Index].M = M;
+            WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].A = A;
+            WorkBlock.Segments[Index].B = B + n;
+            WorkBlock.Segments[Index].C = C + n;
+
+            Index++;
+        }
+
+    } else {
+
+        size_t StrideM = M / TargetThreadCount;
+
+        if ((StrideM * TargetThreadCount) != M) {
+            StrideM++;
+        }
+
+        for (size_t CountM, m = 0; m < M; m += CountM) {
+
+            CountM = StrideM;
+
+            if (CountM > (M - m)) {
+                CountM = M - m;
+            }
+
+            WorkBlock.Segments[Index].M = CountM;
+            WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].A = A + m * lda;
+            WorkBlock.Segments[Index].B = B;
+            WorkBlock.Segments[Index].C = C + m * ldc;
+
+            Index++;
+        }
+    }
+
+    MlasExecuteThreaded(MlasQgemmOperationThreaded, &WorkBlock, Index);
+}
+
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) for an unsigned matrix B.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasQgemmDispatch(M, N, K, A, lda, offa, B, ldb, offb, C, ldc);
+}
+
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) for a signed matrix B.
+
+Arguments:
+
+    See the unsigned variant of MlasQgemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasQgemmDispatch(M, N, K, A, lda, offa, B, ldb, offb, C, ldc);
+}
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    int32_t Multiplier,
+    int32_t RightShift,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes the output of a QGEMM operation to unsigned
+    8-bit integers.
+
+    Each element is multiplied by the fixed point multiplier with a saturating
+    rounding doubling high multiply, divided by two to the power of the right
+    shift with rounding to nearest, offset by the zero point and saturated to
+    the range of the output type.
+
+Arguments:
+
+    Input - Supplies the address of the input matrix with N columns.
+
+    Output - Supplies the address of the output matrix with N columns.
+
+    Bias - Optionally supplies the address of a bias vector with M elements
+        that is added to each row of the input matrix.
+
+    M - Supplies the number of rows of the matrices.
+
+    N - Supplies the number of columns of the matrices.
+
+    Multiplier - Supplies the fixed point multiplier in Q31 format.
+
+    RightShift - Supplies the number of bits to shift right after the
+        multiply. A negative value shifts left.
+
+    ZeroPoint - Supplies the zero point of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const int32_t LeftShift = (RightShift < 0) ? -RightShift : 0;
+    const int32_t Shift = (RightShift > 0) ? RightShift : 0;
+
+    const int32_t Mask = int32_t((int64_t(1) << Shift) - 1);
+    const int64_t Nudge = int64_t(1) << 30;
+
+    for (size_t m = 0; m < M; m++) {
+
+        const int32_t RowBias = (Bias != nullptr) ? Bias[m] : 0;
+
+        for (size_t n = 0; n < N; n++) {
+
+            int64_t Value = int64_t(Input[n] + RowBias) * (int64_t(1) << LeftShift);
+
+            if (Value > std::numeric_limits<int32_t>::max()) {
+                Value = std::numeric_limits<int32_t>::max();
+            } else if (Value < std::numeric_limits<int32_t>::min()) {
+                Value = std::numeric_limits<int32_t>::min();
+            }
+
+            //
+            // Saturating rounding doubling high multiply.
+            //
+
+            int32_t HighMul;
+
+            if (Value == std::numeric_limits<int32_t>::min() &&
+                Multiplier == std::numeric_limits<int32_t>::min()) {
+                HighMul = std::numeric_limits<int32_t>::max();
+            } else {
+                int64_t Product = Value * int64_t(Multiplier);
+                int64_t Rounded = Product + ((Product >= 0) ? Nudge : (1 - Nudge));
+                HighMul = int32_t(Rounded / (int64_t(1) << 31));
+            }
+
+            //
+            // Rounding divide by a power of two.
+            //
+
+            const int32_t Remainder = HighMul & Mask;
+            const int32_t Threshold = (Mask >> 1) + ((HighMul < 0) ? 1 : 0);
+
+            int32_t Result = (HighMul >> Shift) + ((Remainder > Threshold) ? 1 : 0);
+
+            Result += int32_t(ZeroPoint);
+
+            if (Result < 0) {
+                Result = 0;
+            } else if (Result > 255) {
+                Result = 255;
+            }
+
+            Output[n] = uint8_t(Result);
+        }
+
+        Input += N;
+        Output += N;
+    }
+}
@@ -0,0 +1,209 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using AVX2 instructions.
+
+    This module must be compiled with AVX2 code generation enabled.
+
+--*/
+
+#include "mlasi.h"
+
+template<size_t RowCount>
+inline
+void
+MlasQgemmKernelAvx2Rows(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of up to four rows of matrix C. Each loop
+    iteration produces 16 columns for each row by multiplying and adding
+    pairs of 16-bit elements from matrix A and matrix B.
+
+Arguments:
+
+    See MlasQgemmKernelAvx2.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m256i ColumnIndices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    while (CountN > 0) {
+
+        __m256i Accumulators[RowCount][2];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r][0] = _mm256_setzero_si256();
+            Accumulators[r][1] = _mm256_setzero_si256();
+        }
+
+        const int16_t* a = A;
+        const int16_t* b = B;
+
+        for (size_t k = 0; k < PairCountK; k++) {
+
+            __m256i BElements0 = _mm256_load_si256((const __m256i*)&b[0]);
+            __m256i BElements1 = _mm256_load_si256((const __m256i*)&b[16]);
+
+            for (size_t r = 0; r < RowCount; r++) {
+
+                int32_t APair;
+                memcpy(&APair, &a[r * lda], sizeof(APair));
+
+                __m256i ABroadcast = _mm256_set1_epi32(APair);
+
+                Accumulators[r][0] = _mm256_add_epi32(Accumulators[r][0],
+                    _mm256_madd_epi16(ABroadcast, BElements0));
+                Accumulators[r][1] = _mm256_add_epi32(Accumulators[r][1],
+                    _mm256_madd_epi16(ABroadcast, BElements1));
+            }
+
+            a += 2;
+            b += 32;
+        }
+
+        if (CountN >= 16) {
+
+            for (size_t r = 0; r < RowCount; r++) {
+
+                int32_t* c = C + r * ldc;
+
+                if (!ZeroMode) {
+                    Accumulators[r][0] = _mm256_add_epi32(Accumulators[r][0],
+                        _mm256_loadu_si256((const __m256i*)&c[0]));
+                    Accumulators[r][1] = _mm256_add_epi32(Accumulators[r][1],
+                        _mm256_loadu_si256((const __m256i*)&c[8]));
+                }
+
+                _mm256_storeu_si256((__m256i*)&c[0], Accumulators[r][0]);
+                _mm256_storeu_si256((__m256i*)&c[8], Accumulators[r][1]);
+            }
+
+        } else {
+
+            //
+            // Store the partial block of columns using masks derived from the
+            // remaining column count.
+            //
+
+            __m256i CountNVector = _mm256_set1_epi32(int32_t(CountN));
+            __m256i Mask0 = _mm256_cmpgt_epi32(CountNVector, ColumnIndices);
+            __m256i Mask1 = _mm256_cmpgt_epi32(CountNVector,
+                _mm256_add_epi32(ColumnIndices, _mm256_set1_epi32(8)));
+
+            for (size_t r = 0; r < RowCount; r++) {
+
+                int32_t* c = C + r * ldc;
+
+                if (!ZeroMode) {
+                    Accumulators[r][0] = _mm256_add_epi32(Accumulators[r][0],
+                        _mm256_maskload_epi32(&c[0], Mask0));
+                    Accumulators[r][1] = _mm256_add_epi32(Accumulators[r][1],
+                        _mm256_maskload_epi32(&c[8], Mask1));
+                }
+
+                _mm256_maskstore_epi32(&c[0], Mask0, Accumulators[r][0]);
+                _mm256_maskstore_epi32(&c[8], Mask1, Accumulators[r][1]);
+            }
+
+            break;
+        }
+
+        B += PairCountK * 32;
+        C += 16;
+        CountN -= 16;
+    }
+}
+
+size_t
+MLASCALL
+MlasQgemmKernelAvx2(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been widened to
+        16-bit with the zero point subtracted.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasQgemmCopyPackB.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of columns from matrix A and the
+        number of pairs of rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    size_t RowsHandled;
+
+    if (CountM >= 4) {
+        MlasQgemmKernelAvx2Rows<4>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 4;
+    } else if (CountM >= 2) {
+        MlasQgemmKernelAvx2Rows<2>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 2;
+    } else {
+        MlasQgemmKernelAvx2Rows<1>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 1;
+    }
+
+    return RowsHandled;
+}
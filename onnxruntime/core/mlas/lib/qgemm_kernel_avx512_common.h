@@ -0,0 +1,190 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_avx512_common.h
+
+Abstract:
+
+    This module contains the common kernel implementation for the quantized
+    integer matrix/matrix multiply operation (QGEMM) using AVX512 instructions.
+
+    The kernel is parameterized by the instruction sequence used to multiply
+    and accumulate the pairs of 16-bit elements, so that the AVX512BW and
+    AVX512_VNNI kernels share the same blocking and store logic.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+namespace {
+
+template<size_t RowCount, typename MultiplyAccumulate>
+inline
+void
+MlasQgemmKernelAvx512Rows(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of up to eight rows of matrix C. Each loop
+    iteration produces 16 columns for each row by multiplying and adding
+    pairs of 16-bit elements from matrix A and matrix B.
+
+Arguments:
+
+    See MlasQgemmKernelAvx512.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountN > 0) {
+
+        __m512i Accumulators[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r] = _mm512_setzero_si512();
+        }
+
+        const int16_t* a = A;
+        const int16_t* b = B;
+
+        for (size_t k = 0; k < PairCountK; k++) {
+
+            __m512i BElements = _mm512_load_si512((const __m512i*)b);
+
+            for (size_t r = 0; r < RowCount; r++) {
+
+                int32_t APair;
+                memcpy(&APair, &a[r * lda], sizeof(APair));
+
+                Accumulators[r] = MultiplyAccumulate::Apply(Accumulators[r],
+                    _mm512_set1_epi32(APair), BElements);
+            }
+
+            a += 2;
+            b += 32;
+        }
+
+        //
+        // Store the block of columns, masking off any columns beyond the
+        // remaining column count.
+        //
+
+        __mmask16 Mask = (CountN >= 16) ? __mmask16(0xFFFF) :
+            __mmask16((1u << CountN) - 1);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            int32_t* c = C + r * ldc;
+
+            if (!ZeroMode) {
+                Accumulators[r] = _mm512_add_epi32(Accumulators[r],
+                    _mm512_maskz_loadu_epi32(Mask, c));
+            }
+
+            _mm512_mask_storeu_epi32(c, Mask, Accumulators[r]);
+        }
+
+        if (CountN < 16) {
+            break;
+        }
+
+        B += PairCountK * 32;
+        C += 16;
+        CountN -= 16;
+    }
+}
+
+template<typename MultiplyAccumulate>
+inline
+size_t
+MlasQgemmKernelAvx512(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been widened to
+        16-bit with the zero point subtracted.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasQgemmCopyPackB.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of columns from matrix A and the
+        number of pairs of rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    size_t RowsHandled;
+
+    if (CountM >= 8) {
+        MlasQgemmKernelAvx512Rows<8, MultiplyAccumulate>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 8;
+    } else if (CountM >= 4) {
+        MlasQgemmKernelAvx512Rows<4, MultiplyAccumulate>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 4;
+    } else if (CountM >= 2) {
+        MlasQgemmKernelAvx512Rows<2, MultiplyAccumulate>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 2;
+    } else {
+        MlasQgemmKernelAvx512Rows<1, MultiplyAccumulate>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 1;
+    }
+
+    return RowsHandled;
+}
+
+}  // namespace
@@ -0,0 +1,66 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_avx512bw.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using AVX512BW instructions.
+
+    This module must be compiled with AVX512BW code generation enabled.
+
+--*/
+
+#include "qgemm_kernel_avx512_common.h"
+
+//
+// Multiply the pairs of 16-bit elements with vpmaddwd and accumulate the
+// products with vpaddd.
+//
+
+struct MLAS_QGEMM_MULTIPLY_ACCUMULATE_BW {
+    static inline __m512i Apply(__m512i Accumulator, __m512i APair, __m512i BElements)
+    {
+        return _mm512_add_epi32(Accumulator, _mm512_madd_epi16(APair, BElements));
+    }
+};
+
+size_t
+MLASCALL
+MlasQgemmKernelAvx512BW(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    See MlasQgemmKernelAvx512.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    return MlasQgemmKernelAvx512<MLAS_QGEMM_MULTIPLY_ACCUMULATE_BW>(A, B, C,
+        PairCountK, CountM, CountN, lda, ldc, ZeroMode);
+}
@@ -0,0 +1,65 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_avx512vnni.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using AVX512_VNNI instructions.
+
+    This module must be compiled with AVX512_VNNI code generation enabled.
+
+--*/
+
+#include "qgemm_kernel_avx512_common.h"
+
+//
+// Multiply and accumulate the pairs of 16-bit elements with a single vpdpwssd.
+//
+
+struct MLAS_QGEMM_MULTIPLY_ACCUMULATE_VNNI {
+    static inline __m512i Apply(__m512i Accumulator, __m512i APair, __m512i BElements)
+    {
+        return _mm512_dpwssd_epi32(Accumulator, APair, BElements);
+    }
+};
+
+size_t
+MLASCALL
+MlasQgemmKernelAvx512Vnni(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    See MlasQgemmKernelAvx512.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    return MlasQgemmKernelAvx512<MLAS_QGEMM_MULTIPLY_ACCUMULATE_VNNI>(A, B, C,
+        PairCountK, CountM, CountN, lda, ldc, ZeroMode);
+}
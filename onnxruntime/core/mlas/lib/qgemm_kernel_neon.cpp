@@ -0,0 +1,255 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using NEON instructions.
+
+    The packed matrix B interleaves the elements of each pair of rows, so the
+    widening multiply-accumulate instructions leave a partial sum for each
+    element of a pair in adjacent lanes. The pairs are combined with a
+    pairwise add when the block of columns is stored.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the maximum number of rows of matrix C computed per iteration. The
+// accumulators for a row occupy eight vector registers, so ARM32 with sixteen
+// quad registers is limited to a single row.
+//
+
+#if defined(MLAS_NEON64_INTRINSICS)
+#define MLAS_QGEMM_NEON_MAXIMUM_ROWS                2
+#else
+#define MLAS_QGEMM_NEON_MAXIMUM_ROWS                1
+#endif
+
+inline
+int32x4_t
+MlasQgemmReducePairsNeon(
+    int32x4_t Accumulator0,
+    int32x4_t Accumulator1
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the adjacent pairs of partial sums from two accumulators
+    to produce the sums for four columns.
+
+Arguments:
+
+    Accumulator0 - Supplies the partial sums for the first two columns.
+
+    Accumulator1 - Supplies the partial sums for the second two columns.
+
+Return Value:
+
+    Returns the sums for four columns.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vpaddq_s32(Accumulator0, Accumulator1);
+#else
+    return vcombine_s32(
+        vpadd_s32(vget_low_s32(Accumulator0), vget_high_s32(Accumulator0)),
+        vpadd_s32(vget_low_s32(Accumulator1), vget_high_s32(Accumulator1)));
+#endif
+}
+
+template<size_t RowCount>
+inline
+void
+MlasQgemmKernelNeonRows(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of up to two rows of matrix C. Each loop
+    iteration produces 16 columns for each row by multiplying and adding
+    pairs of 16-bit elements from matrix A and matrix B.
+
+Arguments:
+
+    See MlasQgemmKernelNeon.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountN > 0) {
+
+        int32x4_t Accumulators[RowCount][8];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            for (size_t i = 0; i < 8; i++) {
+                Accumulators[r][i] = vdupq_n_s32(0);
+            }
+        }
+
+        const int16_t* a = A;
+        const int16_t* b = B;
+
+        for (size_t k = 0; k < PairCountK; k++) {
+
+            int16x8_t BElements[4];
+
+            for (size_t i = 0; i < 4; i++) {
+                BElements[i] = vld1q_s16(&b[i * 8]);
+            }
+
+            for (size_t r = 0; r < RowCount; r++) {
+
+                int32_t APair;
+                memcpy(&APair, &a[r * lda], sizeof(APair));
+
+                int16x4_t ABroadcast = vreinterpret_s16_s32(vdup_n_s32(APair));
+
+                for (size_t i = 0; i < 4; i++) {
+                    Accumulators[r][i * 2] = vmlal_s16(Accumulators[r][i * 2],
+                        ABroadcast, vget_low_s16(BElements[i]));
+                    Accumulators[r][i * 2 + 1] = vmlal_s16(Accumulators[r][i * 2 + 1],
+                        ABroadcast, vget_high_s16(BElements[i]));
+                }
+            }
+
+            a += 2;
+            b += 32;
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            int32x4_t Sums[4];
+
+            for (size_t i = 0; i < 4; i++) {
+                Sums[i] = MlasQgemmReducePairsNeon(Accumulators[r][i * 2],
+                    Accumulators[r][i * 2 + 1]);
+            }
+
+            int32_t* c = C + r * ldc;
+
+            if (CountN >= 16) {
+
+                for (size_t i = 0; i < 4; i++) {
+                    if (!ZeroMode) {
+                        Sums[i] = vaddq_s32(Sums[i], vld1q_s32(&c[i * 4]));
+                    }
+                    vst1q_s32(&c[i * 4], Sums[i]);
+                }
+
+            } else {
+
+                //
+                // Store the partial block of columns through a temporary
+                // buffer.
+                //
+
+                int32_t Buffer[16];
+
+                for (size_t i = 0; i < 4; i++) {
+                    vst1q_s32(&Buffer[i * 4], Sums[i]);
+                }
+
+                for (size_t n = 0; n < CountN; n++) {
+                    c[n] = ZeroMode ? Buffer[n] : c[n] + Buffer[n];
+                }
+            }
+        }
+
+        if (CountN < 16) {
+            break;
+        }
+
+        B += PairCountK * 32;
+        C += 16;
+        CountN -= 16;
+    }
+}
+
+size_t
+MLASCALL
+MlasQgemmKernelNeon(
+    const int16_t* A,
+    const int16_t* B,
+    int32_t* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been widened to
+        16-bit with the zero point subtracted.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasQgemmCopyPackB.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of columns from matrix A and the
+        number of pairs of rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    size_t RowsHandled;
+
+    if (MLAS_QGEMM_NEON_MAXIMUM_ROWS >= 2 && CountM >= 2) {
+        MlasQgemmKernelNeonRows<2>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 2;
+    } else {
+        MlasQgemmKernelNeonRows<1>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 1;
+    }
+
+    return RowsHandled;
+}
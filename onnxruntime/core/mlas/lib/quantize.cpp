@@ -0,0 +1,346 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    quantize.cpp
+
+Abstract:
+
+    This module implements the linear quantization of single precision
+    floating point buffers to 8-bit integers and the linear dequantization of
+    8-bit integers to single precision floating point buffers.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the range that a quotient is clamped to before rounding. Any value
+// outside of this range saturates the output for every zero point, so the
+// clamp keeps the conversion to 32-bit integers exact without changing the
+// result.
+//
+
+#define MLAS_QUANTIZE_MINIMUM_QUOTIENT              -512.0f
+#define MLAS_QUANTIZE_MAXIMUM_QUOTIENT              512.0f
+
+inline
+uint8_t
+MlasQuantizeValue(
+    float Value,
+    float Scale,
+    int32_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes a single value.
+
+Arguments:
+
+    Value - Supplies the value to quantize.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    Returns the quantized value.
+
+--*/
+{
+    float Quotient = Value / Scale;
+
+    //
+    // The comparisons are ordered so that a NaN quotient becomes the maximum,
+    // as it does in the vector path.
+    //
+
+    Quotient = (Quotient < MLAS_QUANTIZE_MAXIMUM_QUOTIENT) ? Quotient : MLAS_QUANTIZE_MAXIMUM_QUOTIENT;
+    Quotient = (Quotient > MLAS_QUANTIZE_MINIMUM_QUOTIENT) ? Quotient : MLAS_QUANTIZE_MINIMUM_QUOTIENT;
+
+    //
+    // Round halfway cases away from zero.
+    //
+
+    int32_t Integer = int32_t(Quotient);
+    const float Fraction = Quotient - float(Integer);
+
+    if (Fraction >= 0.5f) {
+        Integer++;
+    } else if (Fraction <= -0.5f) {
+        Integer--;
+    }
+
+    Integer += ZeroPoint;
+
+    if (Integer < 0) {
+        Integer = 0;
+    } else if (Integer > 255) {
+        Integer = 255;
+    }
+
+    return uint8_t(Integer);
+}
+
+void
+MLASCALL
+MlasQuantizeLinear(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes a buffer of single precision floating point
+    values to unsigned 8-bit integers.
+
+    Each value is divided by the scale, rounded to the nearest integer with
+    halfway cases rounded away from zero, offset by the zero point and
+    saturated to the range of the output type.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to quantize.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128 ScaleVector = _mm_set1_ps(Scale);
+    const __m128 MinimumVector = _mm_set1_ps(MLAS_QUANTIZE_MINIMUM_QUOTIENT);
+    const __m128 MaximumVector = _mm_set1_ps(MLAS_QUANTIZE_MAXIMUM_QUOTIENT);
+    const __m128 PositiveHalfVector = _mm_set1_ps(0.5f);
+    const __m128 NegativeHalfVector = _mm_set1_ps(-0.5f);
+    const __m128i ZeroPointVector = _mm_set1_epi32(ZeroPoint);
+
+    while (N >= 16) {
+
+        __m128i Integers[4];
+
+        for (size_t i = 0; i < 4; i++) {
+
+            __m128 Quotient = _mm_div_ps(_mm_loadu_ps(Input + i * 4), ScaleVector);
+
+            //
+            // The minimum returns its second operand for a NaN quotient, so a
+            // NaN quotient becomes the maximum.
+            //
+
+            Quotient = _mm_min_ps(Quotient, MaximumVector);
+            Quotient = _mm_max_ps(Quotient, MinimumVector);
+
+            //
+            // Round halfway cases away from zero by adjusting the truncated
+            // quotient by the sign of the fraction. The compares leave -1 in
+            // the lanes that are adjusted.
+            //
+
+            __m128i Integer = _mm_cvttps_epi32(Quotient);
+            const __m128 Fraction = _mm_sub_ps(Quotient, _mm_cvtepi32_ps(Integer));
+
+            Integer = _mm_sub_epi32(Integer, _mm_castps_si128(_mm_cmpge_ps(Fraction, PositiveHalfVector)));
+            Integer = _mm_add_epi32(Integer, _mm_castps_si128(_mm_cmple_ps(Fraction, NegativeHalfVector)));
+
+            Integers[i] = _mm_add_epi32(Integer, ZeroPointVector);
+        }
+
+        //
+        // The integers fit in 16 bits, so the saturating packs clamp them to
+        // the range of the output type.
+        //
+
+        __m128i Packed = _mm_packus_epi16(_mm_packs_epi32(Integers[0], Integers[1]),
+            _mm_packs_epi32(Integers[2], Integers[3]));
+
+        _mm_storeu_si128((__m128i*)Output, Packed);
+
+        Input += 16;
+        Output += 16;
+        N -= 16;
+    }
+
+#endif
+
+    for (size_t n = 0; n < N; n++) {
+        Output[n] = MlasQuantizeValue(Input[n], Scale, ZeroPoint);
+    }
+}
+
+template<typename T>
+void
+MlasDequantizeLinearKernel(
+    const T* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    T ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a buffer of 8-bit integers to single precision
+    floating point values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to dequantize.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128 ScaleVector = _mm_set1_ps(Scale);
+    const __m128i ZeroPointVector = _mm_set1_epi32(ZeroPoint);
+
+    while (N >= 16) {
+
+        const __m128i Bytes = _mm_loadu_si128((const __m128i*)Input);
+
+        //
+        // Widen the bytes to 32-bit integers. Signed bytes are duplicated
+        // into both halves of the wider element and then shifted back down
+        // to extend the sign.
+        //
+
+        __m128i Words[2];
+        __m128i Integers[4];
+
+        if (std::is_signed<T>::value) {
+            Words[0] = _mm_srai_epi16(_mm_unpacklo_epi8(Bytes, Bytes), 8);
+            Words[1] = _mm_srai_epi16(_mm_unpackhi_epi8(Bytes, Bytes), 8);
+        } else {
+            Words[0] = _mm_unpacklo_epi8(Bytes, _mm_setzero_si128());
+            Words[1] = _mm_unpackhi_epi8(Bytes, _mm_setzero_si128());
+        }
+
+        for (size_t i = 0; i < 2; i++) {
+            Integers[i * 2 + 0] = _mm_srai_epi32(_mm_unpacklo_epi16(Words[i], Words[i]), 16);
+            Integers[i * 2 + 1] = _mm_srai_epi32(_mm_unpackhi_epi16(Words[i], Words[i]), 16);
+        }
+
+        for (size_t i = 0; i < 4; i++) {
+            __m128 Value = _mm_cvtepi32_ps(_mm_sub_epi32(Integers[i], ZeroPointVector));
+            _mm_storeu_ps(Output + i * 4, _mm_mul_ps(Value, ScaleVector));
+        }
+
+        Input += 16;
+        Output += 16;
+        N -= 16;
+    }
+
+#endif
+
+    for (size_t n = 0; n < N; n++) {
+        Output[n] = float(int32_t(Input[n]) - int32_t(ZeroPoint)) * Scale;
+    }
+}
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a buffer of unsigned 8-bit integers to single
+    precision floating point values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to dequantize.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasDequantizeLinearKernel<uint8_t>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a buffer of signed 8-bit integers to single
+    precision floating point values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to dequantize.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasDequantizeLinearKernel<int8_t>(Input, Output, N, Scale, ZeroPoint);
+}
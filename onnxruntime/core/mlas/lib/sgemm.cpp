@@ -40,15 +40,51 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    const float* PackedB;
+    size_t AlignedN;
+    bool BIsHalf;
+    const float* ScaleB;
+    const MLAS_SGEMM_EPILOGUE* Epilogue;
     struct SEGMENT {
         size_t M;
         size_t N;
+        size_t StartM;
+        size_t StartN;
         const float* A;
-        const float* B;
+        const void* B;
         float* C;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
+//
+// Define the parameters to execute a batch of SGEMM operations on worker
+// threads. Each batch entry is split into blocks along the M dimension and
+// the blocks of all entries are distributed across the threads.
+//
+
+struct MLAS_SGEMM_BATCH_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    float beta;
+    const float* A;
+    size_t lda;
+    const size_t* OffsetsA;
+    const float* B;
+    size_t ldb;
+    const size_t* OffsetsB;
+    float* C;
+    size_t ldc;
+    const size_t* OffsetsC;
+    size_t StrideM;
+    size_t BlocksPerBatch;
+    size_t TotalBlocks;
+    int32_t ThreadCount;
+};
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
 //
@@ -773,56 +809,34 @@ Return Value:
 }
 
 void
-MlasSgemmOperation(
-    CBLAS_TRANSPOSE TransA,
-    CBLAS_TRANSPOSE TransB,
-    size_t M,
-    size_t N,
-    size_t K,
-    float alpha,
-    const float* A,
-    size_t lda,
-    const float* B,
+MlasSgemmCopyPackB(
+    float* D,
+    const unsigned short* B,
     size_t ldb,
-    float beta,
-    float* C,
-    size_t ldc
+    size_t CountX,
+    size_t CountY
     )
 /*++
 
 Routine Description:
 
-    This routine implements the single precision matrix/matrix multiply
-    operation (SGEMM).
-
-Arguments:
-
-    TransA - Supplies the transpose operation for matrix A.
-
-    TransB - Supplies the transpose operation for matrix B.
-
-    M - Supplies the number of rows of matrix A and matrix C.
-
-    N - Supplies the number of columns of matrix B and matrix C.
-
-    K - Supplies the number of columns of matrix A and the number of rows of
-        matrix B.
+    This routine converts elements from the source matrix of half-precision
+    floats to the destination packed buffer.
 
-    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
-
-    A - Supplies the address of matrix A.
+    Blocks of up to 16x16 elements are converted to a local buffer and then
+    copied to the packed layout (see the single precision MlasSgemmCopyPackB).
 
-    lda - Supplies the first dimension of matrix A.
+Arguments:
 
-    B - Supplies the address of matrix B.
+    D - Supplies the address of the destination packed buffer.
 
-    ldb - Supplies the first dimension of matrix B.
+    B - Supplies the address of the source matrix.
 
-    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+    ldb - Supplies the number of elements per row of the source matrix.
 
-    C - Supplies the address of matrix C.
+    CountX - Supplies the number of columns of the source matrix to copy.
 
-    ldc - Supplies the first dimension of matrix C.
+    CountY - Supplies the number of rows of the source matrix to copy.
 
 Return Value:
 
@@ -830,224 +844,185 @@ Return Value:
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
-    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
-
-    //
-    // Handle the special case of a small M. The data from matrix B is not
-    // referenced multiple times, so using a local packed buffer is a wasted
-    // memory copy.
-    //
-
-    if (M == 1 && TransA == CblasNoTrans && alpha == 1.0f && (beta == 0.0f || beta == 1.0f)) {
-
-#if defined(MLAS_TARGET_AMD64)
-
-        PMLAS_SGEMM_KERNEL_M1_ROUTINE SgemmKernelM1Routine;
-
-        if (TransB == CblasNoTrans) {
-            SgemmKernelM1Routine = MlasPlatform.KernelM1Routine;
-        } else {
-            SgemmKernelM1Routine = MlasPlatform.KernelM1TransposeBRoutine;
-        }
-
-        if (SgemmKernelM1Routine != nullptr) {
-            SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
-            return;
-        }
+    MLAS_DECLSPEC_ALIGN(float Buffer[16 * 16], 16 * sizeof(float));
 
-#endif
-
-    }
+    for (size_t x = 0; x < CountX; x += 16) {
 
-    //
-    // Compute the strides to step through slices of the input matrices.
-    //
-    // Expand the N stride if K is small or expand the K stride if N is small
-    // for better utilization of the B panel. Avoid changing the K stride if
-    // the A panel needs to be used for transposing.
-    //
+        const size_t CountBlockX = (std::min)(CountX - x, size_t(16));
 
-    uint32_t StrideN = MLAS_SGEMM_STRIDEN;
-    uint32_t StrideK = MLAS_SGEMM_STRIDEK;
+        for (size_t y = 0; y < CountY; y += 16) {
 
-    if (N >= K) {
+            const size_t CountBlockY = (std::min)(CountY - y, size_t(16));
 
-        while (StrideK / 2 >= K) {
-            StrideN *= 2;
-            StrideK /= 2;
-        }
+            for (size_t yy = 0; yy < CountBlockY; yy++) {
+                MlasConvertHalfToFloatBuffer(B + (y + yy) * ldb + x, Buffer + yy * 16,
+                    CountBlockX);
+            }
 
-    } else if (TransA == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, Buffer, 16, CountBlockX, CountBlockY);
 
-        while (StrideN > 16 && StrideN / 2 >= N) {
-            StrideK *= 2;
-            StrideN /= 2;
+            D += 16 * CountBlockY;
         }
     }
+}
 
-    //
-    // Step through each slice of matrix B along the N dimension.
-    //
-
-    size_t CountN;
-    size_t CountK;
+void
+MlasSgemmTransposePackB(
+    float* D,
+    const unsigned short* B,
+    size_t ldb,
+    size_t CountY,
+    size_t CountX
+    )
+/*++
 
-    for (size_t n = 0; n < N; n += CountN) {
+Routine Description:
 
-        CountN = StrideN;
+    This routine converts and transposes elements from the source matrix of
+    half-precision floats to the destination packed buffer.
 
-        if (CountN > (N - n)) {
-            CountN = N - n;
-        }
+    Blocks of up to 16x16 elements are converted to a local buffer and then
+    transposed to the packed layout (see the single precision
+    MlasSgemmTransposePackB).
 
-        //
-        // Multiply the output matrix by beta as needed.
-        //
+Arguments:
 
-        if (beta != 0.0f && beta != 1.0f) {
-            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
-        }
+    D - Supplies the address of the destination packed buffer.
 
-        //
-        // Step through each slice of matrix B along the K dimension.
-        //
+    B - Supplies the address of the source matrix.
 
-        for (size_t k = 0; k < K; k += CountK) {
+    ldb - Supplies the number of elements per row of the source matrix.
 
-            CountK = StrideK;
+    CountY - Supplies the number of rows of the source matrix to transpose.
 
-            if (CountK > (K - k)) {
-                CountK = K - k;
-            }
+    CountX - Supplies the number of columns of the source matrix to transpose.
 
-            //
-            // Copy or transpose a panel of matrix B to a local packed buffer.
-            //
+Return Value:
 
-            if (TransB == CblasNoTrans) {
-                MlasSgemmCopyPackB(PanelB, B + n + k * ldb, ldb, CountN, CountK);
-            } else {
-                MlasSgemmTransposePackB(PanelB, B + k + n * ldb, ldb, CountN, CountK);
-            }
+    None.
 
-            //
-            // Select the kernel routine to use for this panel.
-            //
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Buffer[16 * 16], 16 * sizeof(float));
 
-            bool UseKernelZeroRoutine = (k == 0 && beta == 0.0f);
+    for (size_t y = 0; y < CountY; y += 16) {
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-            PMLAS_SGEMM_KERNEL_ROUTINE SgemmKernelRoutine =
-                UseKernelZeroRoutine ? MlasPlatform.KernelZeroRoutine : MlasPlatform.KernelAddRoutine;
-#endif
+        const size_t CountBlockY = (std::min)(CountY - y, size_t(16));
 
-            //
-            // Step through each slice of matrix A along the M dimension.
-            //
+        for (size_t x = 0; x < CountX; x += 16) {
 
-            float* c = C + n;
+            const size_t CountBlockX = (std::min)(CountX - x, size_t(16));
 
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
+            for (size_t yy = 0; yy < CountBlockY; yy++) {
+                MlasConvertHalfToFloatBuffer(B + (y + yy) * ldb + x, Buffer + yy * 16,
+                    CountBlockX);
+            }
 
-            if (TransA == CblasNoTrans) {
+            MlasSgemmTransposePackB(D, Buffer, 16, CountBlockY, CountBlockX);
 
-                const float* a = A + k;
+            D += 16 * CountBlockX;
+        }
+    }
+}
 
-                //
-                // Step through the rows of matrix A.
-                //
+void
+MlasSgemmCopyPackB(
+    float* D,
+    const int8_t* B,
+    size_t ldb,
+    const float* Scale,
+    size_t CountX,
+    size_t CountY
+    )
+/*++
 
-                do {
+Routine Description:
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = SgemmKernelRoutine(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-#else
-                    if (UseKernelZeroRoutine) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
+    This routine dequantizes elements from the source matrix of 8-bit integers
+    to the destination packed buffer.
 
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
+    Blocks of up to 16x16 elements are dequantized to a local buffer and then
+    copied to the packed layout (see the single precision MlasSgemmCopyPackB).
 
-                    RowsRemaining -= RowsHandled;
+Arguments:
 
-                } while (RowsRemaining > 0);
+    D - Supplies the address of the destination packed buffer.
 
-            } else {
+    B - Supplies the address of the source matrix.
 
-                const float* a = A + k * lda;
+    ldb - Supplies the number of elements per row of the source matrix.
 
-                do {
+    Scale - Supplies the scale of each column of the source matrix.
 
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
+    CountX - Supplies the number of columns of the source matrix to copy.
 
-                    size_t RowsTransposed = RowsRemaining;
+    CountY - Supplies the number of rows of the source matrix to copy.
 
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
+Return Value:
 
-                    RowsRemaining -= RowsTransposed;
+    None.
 
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Buffer[16 * 16], 16 * sizeof(float));
 
-                    a += RowsTransposed;
+    for (size_t x = 0; x < CountX; x += 16) {
 
-                    //
-                    // Step through the rows of the local buffer.
-                    //
+        const size_t CountBlockX = (std::min)(CountX - x, size_t(16));
 
-                    const float* pa = PanelA;
+        for (size_t y = 0; y < CountY; y += 16) {
 
-                    do {
+            const size_t CountBlockY = (std::min)(CountY - y, size_t(16));
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = SgemmKernelRoutine(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-#else
-                        if (UseKernelZeroRoutine) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
-#endif
+            for (size_t yy = 0; yy < CountBlockY; yy++) {
 
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
+                const int8_t* b = B + (y + yy) * ldb + x;
 
-                        RowsTransposed -= RowsHandled;
+                for (size_t xx = 0; xx < CountBlockX; xx++) {
+                    Buffer[yy * 16 + xx] = float(b[xx]) * Scale[x + xx];
+                }
+            }
 
-                    } while (RowsTransposed > 0);
+            MlasSgemmCopyPackB(D, Buffer, 16, CountBlockX, CountBlockY);
 
-                } while (RowsRemaining > 0);
-            }
+            D += 16 * CountBlockY;
         }
     }
 }
 
 void
-MlasSgemmOperationThreaded(
-    void* Context,
-    int32_t Index
+MlasSgemmTransposePackB(
+    float* D,
+    const int8_t* B,
+    size_t ldb,
+    const float* Scale,
+    size_t CountY,
+    size_t CountX
     )
 /*++
 
 Routine Description:
 
-    This routine is invoked from a worker thread to execute a segment of a
-    SGEMM operation.
+    This routine dequantizes and transposes elements from the source matrix of
+    8-bit integers to the destination packed buffer.
+
+    Blocks of up to 16x16 elements are dequantized to a local buffer and then
+    transposed to the packed layout (see the single precision
+    MlasSgemmTransposePackB).
 
 Arguments:
 
-    Context - Supplies the pointer to the context for the threaded operation.
+    D - Supplies the address of the destination packed buffer.
 
-    Index - Supplies the current index of the threaded operation.
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    Scale - Supplies the scale of each row of the source matrix.
+
+    CountY - Supplies the number of rows of the source matrix to transpose.
+
+    CountX - Supplies the number of columns of the source matrix to transpose.
 
 Return Value:
 
@@ -1055,248 +1030,2318 @@ Return Value:
 
 --*/
 {
-    MLAS_SGEMM_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_WORK_BLOCK*)Context;
+    MLAS_DECLSPEC_ALIGN(float Buffer[16 * 16], 16 * sizeof(float));
 
-    MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+    for (size_t y = 0; y < CountY; y += 16) {
+
+        const size_t CountBlockY = (std::min)(CountY - y, size_t(16));
+
+        for (size_t x = 0; x < CountX; x += 16) {
+
+            const size_t CountBlockX = (std::min)(CountX - x, size_t(16));
 
-    MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
-        Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
-        Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+            for (size_t yy = 0; yy < CountBlockY; yy++) {
+
+                const int8_t* b = B + (y + yy) * ldb + x;
+                const float scale = Scale[y + yy];
+
+                for (size_t xx = 0; xx < CountBlockX; xx++) {
+                    Buffer[yy * 16 + xx] = float(b[xx]) * scale;
+                }
+            }
+
+            MlasSgemmTransposePackB(D, Buffer, 16, CountBlockY, CountBlockX);
+
+            D += 16 * CountBlockX;
+        }
+    }
 }
 
+template<typename BType>
 inline
-bool
-MlasSgemmTryMultithread(
-    CBLAS_TRANSPOSE TransA,
+void
+MlasSgemmPackPanelB(
     CBLAS_TRANSPOSE TransB,
-    size_t M,
-    size_t N,
-    size_t K,
-    float alpha,
-    const float* A,
-    size_t lda,
-    const float* B,
+    float* PanelB,
+    const BType* B,
     size_t ldb,
-    float beta,
-    float* C,
-    size_t ldc
+    const float* ScaleB,
+    size_t n,
+    size_t k,
+    size_t CountN,
+    size_t CountK
     )
 /*++
 
 Routine Description:
 
-    This routine attempts to launch a single precision matrix/matrix multiply
-    operation (SGEMM) across multiple threads.
+    This routine copies or transposes a panel of matrix B to a packed buffer,
+    converting elements that are half-precision floats.
 
 Arguments:
 
-    TransA - Supplies the transpose operation for matrix A.
-
     TransB - Supplies the transpose operation for matrix B.
 
-    M - Supplies the number of rows of matrix A and matrix C.
+    PanelB - Supplies the address of the destination packed buffer.
 
-    N - Supplies the number of columns of matrix B and matrix C.
+    B - Supplies the address of matrix B.
 
-    K - Supplies the number of columns of matrix A and the number of rows of
-        matrix B.
+    ldb - Supplies the first dimension of matrix B.
 
-    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+    ScaleB - Unused for matrices of floats.
+
+    n - Supplies the first column of matrix C of the panel.
+
+    k - Supplies the first row of matrix B, before transposing, of the panel.
+
+    CountN - Supplies the number of columns of matrix C of the panel.
+
+    CountK - Supplies the number of rows of matrix B of the panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(ScaleB);
+
+    if (TransB == CblasNoTrans) {
+        MlasSgemmCopyPackB(PanelB, B + n + k * ldb, ldb, CountN, CountK);
+    } else {
+        MlasSgemmTransposePackB(PanelB, B + k + n * ldb, ldb, CountN, CountK);
+    }
+}
+
+inline
+void
+MlasSgemmPackPanelB(
+    CBLAS_TRANSPOSE TransB,
+    float* PanelB,
+    const int8_t* B,
+    size_t ldb,
+    const float* ScaleB,
+    size_t n,
+    size_t k,
+    size_t CountN,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a panel of matrix B of 8-bit integers to a packed
+    buffer, scaling the elements of each column of matrix C by ScaleB.
+
+Arguments:
+
+    See the templated variant of MlasSgemmPackPanelB.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (TransB == CblasNoTrans) {
+        MlasSgemmCopyPackB(PanelB, B + n + k * ldb, ldb, ScaleB + n, CountN, CountK);
+    } else {
+        MlasSgemmTransposePackB(PanelB, B + k + n * ldb, ldb, ScaleB + n, CountN, CountK);
+    }
+}
+
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t ldc,
+    size_t StartM,
+    size_t CountM,
+    size_t StartN,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the output stage of a SGEMM operation to a block of
+    matrix C that has been completely accumulated.
+
+Arguments:
+
+    Epilogue - Supplies the output stage to apply.
+
+    C - Supplies the address of the block of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    StartM - Supplies the row of matrix C at the start of the block.
+
+    CountM - Supplies the number of rows of the block.
+
+    StartN - Supplies the column of matrix C at the start of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* ColumnBias = Epilogue->ColumnBias;
+    const float* Addend = Epilogue->Addend;
+
+    if (ColumnBias != nullptr || Addend != nullptr) {
+
+        if (ColumnBias != nullptr) {
+            ColumnBias += StartN;
+        }
+
+        if (Addend != nullptr) {
+            Addend += StartM * Epilogue->ldaddend + StartN;
+        }
+
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            if (Addend != nullptr) {
+
+                for (size_t n = 0; n < CountN; n++) {
+                    c[n] += Addend[n];
+                }
+
+                Addend += Epilogue->ldaddend;
+            }
+
+            if (ColumnBias != nullptr) {
+
+                for (size_t n = 0; n < CountN; n++) {
+                    c[n] += ColumnBias[n];
+                }
+            }
+
+            c += ldc;
+        }
+    }
+
+    //
+    // Apply the activation with the optional row bias.
+    //
+
+    const float* RowBias = Epilogue->RowBias;
+
+    if (RowBias != nullptr) {
+        RowBias += StartM;
+    }
+
+    if (Epilogue->Activation != nullptr) {
+        MlasActivation(Epilogue->Activation, C, RowBias, CountM, C, CountN, ldc);
+    } else if (RowBias != nullptr) {
+        MLAS_ACTIVATION IdentityActivation;
+        IdentityActivation.ActivationKind = MlasIdentityActivation;
+        MlasActivation(&IdentityActivation, C, RowBias, CountM, C, CountN, ldc);
+    }
+}
+
+const MLAS_SGEMM_EPILOGUE*
+MlasSgemmOffsetEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN,
+    MLAS_SGEMM_EPILOGUE* SegmentEpilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine rebases the output stage of a SGEMM operation to a segment
+    of matrix C that starts at the supplied row and column.
+
+Arguments:
+
+    Epilogue - Optionally supplies the output stage of the operation.
+
+    StartM - Supplies the row of matrix C at the start of the segment.
+
+    StartN - Supplies the column of matrix C at the start of the segment.
+
+    SegmentEpilogue - Supplies the storage for the rebased output stage.
+
+Return Value:
+
+    Returns the output stage for the segment or nullptr if the operation has
+    no output stage.
+
+--*/
+{
+    if (Epilogue == nullptr) {
+        return nullptr;
+    }
+
+    *SegmentEpilogue = *Epilogue;
+
+    if (SegmentEpilogue->RowBias != nullptr) {
+        SegmentEpilogue->RowBias += StartM;
+    }
+
+    if (SegmentEpilogue->ColumnBias != nullptr) {
+        SegmentEpilogue->ColumnBias += StartN;
+    }
+
+    if (SegmentEpilogue->Addend != nullptr) {
+        SegmentEpilogue->Addend += StartM * SegmentEpilogue->ldaddend + StartN;
+    }
+
+    return SegmentEpilogue;
+}
+
+void
+MlasSgemmMultiplyPanel(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartN
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of matrix A by a packed panel of matrix B
+    and accumulates or stores the result to a slice of matrix C.
+
+    If this is the last slice along the K dimension, the output stage is
+    applied to each set of rows as the kernel completes them, while the rows
+    are still in the cache.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the packed panel and matrix C.
+
+    CountK - Supplies the number of columns of the slice of matrix A and the
+        number of rows of the packed panel.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of the slice of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+    Epilogue - Optionally supplies the output stage to apply to the slice of
+        matrix C.
+
+    StartN - Supplies the column of matrix C at the start of the slice, used
+        to locate the column elements of the output stage.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+
+    //
+    // Select the kernel routine to use for this panel.
+    //
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+    PMLAS_SGEMM_KERNEL_ROUTINE SgemmKernelRoutine =
+        ZeroMode ? MlasPlatform.KernelZeroRoutine : MlasPlatform.KernelAddRoutine;
+#endif
+
+    //
+    // Step through each slice of matrix A along the M dimension.
+    //
+
+    float* c = C;
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+
+    if (TransA == CblasNoTrans) {
+
+        const float* a = A;
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = SgemmKernelRoutine(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, c, ldc, M - RowsRemaining,
+                    RowsHandled, StartN, CountN);
+            }
+
+            c += ldc * RowsHandled;
+            a += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        const float* a = A;
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+            a += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                RowsHandled = SgemmKernelRoutine(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                if (Epilogue != nullptr) {
+                    MlasSgemmApplyEpilogue(Epilogue, c, ldc,
+                        M - RowsRemaining - RowsTransposed, RowsHandled, StartN, CountN);
+                }
+
+                c += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
+template<typename BType>
+void
+MlasSgemmCopyPackBAndMultiply(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const BType* B,
+    size_t ldb,
+    const float* ScaleB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) by copying panels of matrix B to a local packed buffer.
+
+    Matrix B is either single precision floats, half-precision floats or 8-bit
+    integers scaled by ScaleB that are converted as each panel is packed.
+
+Arguments:
+
+    See MlasSgemmOperation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    //
+    // Compute the strides to step through slices of the input matrices.
+    //
+    // Expand the N stride if K is small or expand the K stride if N is small
+    // for better utilization of the B panel. Avoid changing the K stride if
+    // the A panel needs to be used for transposing.
+    //
+
+    uint32_t StrideN = MLAS_SGEMM_STRIDEN;
+    uint32_t StrideK = MLAS_SGEMM_STRIDEK;
+
+    if (N >= K) {
+
+        while (StrideK / 2 >= K) {
+            StrideN *= 2;
+            StrideK /= 2;
+        }
+
+    } else if (TransA == CblasNoTrans) {
+
+        while (StrideN > 16 && StrideN / 2 >= N) {
+            StrideK *= 2;
+            StrideN /= 2;
+        }
+    }
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        if (MlasIsCancelled()) {
+            return;
+        }
+
+        CountN = StrideN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = StrideK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            //
+            // Copy or transpose a panel of matrix B to a local packed buffer.
+            //
+
+            MlasSgemmPackPanelB(TransB, PanelB, B, ldb, ScaleB, n, k, CountN, CountK);
+
+            const float* a = A + ((TransA == CblasNoTrans) ? k : k * lda);
+
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha, a, lda,
+                PanelB, C + n, ldc, k == 0 && beta == 0.0f,
+                (k + CountK == K) ? Epilogue : nullptr, n);
+        }
+    }
+}
+
+void
+MlasSgemmOperation(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM).
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Epilogue - Optionally supplies the output stage to apply to matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Handle the special case of a small M. The data from matrix B is not
+    // referenced multiple times, so using a local packed buffer is a wasted
+    // memory copy.
+    //
+
+    if (M == 1 && TransA == CblasNoTrans && alpha == 1.0f && (beta == 0.0f || beta == 1.0f)) {
+
+#if defined(MLAS_TARGET_AMD64)
+
+        PMLAS_SGEMM_KERNEL_M1_ROUTINE SgemmKernelM1Routine;
+
+        if (TransB == CblasNoTrans) {
+            SgemmKernelM1Routine = MlasPlatform.KernelM1Routine;
+        } else {
+            SgemmKernelM1Routine = MlasPlatform.KernelM1TransposeBRoutine;
+        }
+
+        if (SgemmKernelM1Routine != nullptr) {
+
+            SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 1, 0, N);
+            }
+
+            return;
+        }
+
+#endif
+
+    }
+
+    MlasSgemmCopyPackBAndMultiply(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, nullptr,
+        beta, C, ldc, Epilogue);
+}
+
+void
+MlasSgemmOperation(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const unsigned short* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B of half-precision floats.
+
+Arguments:
+
+    See the single precision variant of MlasSgemmOperation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSgemmCopyPackBAndMultiply(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, nullptr,
+        beta, C, ldc, Epilogue);
+}
+
+void
+MlasSgemmOperation(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int8_t* B,
+    size_t ldb,
+    const float* ScaleB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B of 8-bit integers and a scale for each
+    column of matrix C.
+
+Arguments:
+
+    ScaleB - Supplies the scale of each column of matrix C.
+
+    See the single precision variant of MlasSgemmOperation for the others.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSgemmCopyPackBAndMultiply(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, ScaleB,
+        beta, C, ldc, Epilogue);
+}
+
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t StartN,
+    size_t CountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B that was packed by MlasSgemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    StartN - Supplies the starting column of the packed matrix B to compute.
+        This must be a multiple of 16.
+
+    CountN - Supplies the number of columns of the packed matrix B and matrix C
+        to compute.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    AlignedN - Supplies the number of columns of the packed matrix B rounded
+        up to a multiple of 16.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C at column StartN.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Epilogue - Optionally supplies the output stage to apply to matrix C,
+        relative to column StartN.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Step through each slice of matrix B along the N dimension. The packed
+    // buffer stores each slice of MLAS_SGEMM_STRIDEK rows of matrix B as
+    // contiguous panels of 16 columns, so a panel of any width along the N
+    // dimension is addressable without copying.
+    //
+
+    size_t StrideN = MLAS_SGEMM_STRIDEN;
+    size_t CountNSlice;
+    size_t CountK;
+
+    for (size_t n = 0; n < CountN; n += CountNSlice) {
+
+        if (MlasIsCancelled()) {
+            return;
+        }
+
+        CountNSlice = StrideN;
+
+        if (CountNSlice > (CountN - n)) {
+            CountNSlice = CountN - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountNSlice, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = MLAS_SGEMM_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            const float* PanelB = PackedB + k * AlignedN + (StartN + n) * CountK;
+            const float* a = A + ((TransA == CblasNoTrans) ? k : k * lda);
+
+            MlasSgemmMultiplyPanel(TransA, M, CountNSlice, CountK, alpha, a, lda,
+                PanelB, C + n, ldc, k == 0 && beta == 0.0f,
+                (k + CountK == K) ? Epilogue : nullptr, n);
+        }
+    }
+}
+
+void
+MlasSgemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    SGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_WORK_BLOCK*)Context;
+
+    MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    MLAS_SGEMM_EPILOGUE SegmentEpilogue;
+
+    const MLAS_SGEMM_EPILOGUE* Epilogue = MlasSgemmOffsetEpilogue(WorkBlock->Epilogue,
+        Segment->StartM, Segment->StartN, &SegmentEpilogue);
+
+    if (WorkBlock->PackedB != nullptr) {
+        MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M, Segment->StartN,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            WorkBlock->PackedB, WorkBlock->AlignedN, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc, Epilogue);
+        return;
+    }
+
+    if (WorkBlock->ScaleB != nullptr) {
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            (const int8_t*)Segment->B, WorkBlock->ldb, WorkBlock->ScaleB + Segment->StartN,
+            WorkBlock->beta, Segment->C, WorkBlock->ldc, Epilogue);
+    } else if (WorkBlock->BIsHalf) {
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            (const unsigned short*)Segment->B, WorkBlock->ldb, WorkBlock->beta,
+            Segment->C, WorkBlock->ldc, Epilogue);
+    } else {
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            (const float*)Segment->B, WorkBlock->ldb, WorkBlock->beta,
+            Segment->C, WorkBlock->ldc, Epilogue);
+    }
+}
+
+template<typename BType>
+inline
+bool
+MlasSgemmTryMultithread(
+    MLAS_SGEMM_WORK_BLOCK* WorkBlock,
+    size_t M,
+    size_t N,
+    const float* A,
+    const BType* B,
+    float* C
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to launch a single precision matrix/matrix multiply
+    operation (SGEMM) across multiple threads.
+
+Arguments:
+
+    WorkBlock - Supplies the work block with the common fields of the
+        operation initialized. The segments are filled in by this routine.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. This is ignored if the work block
+        references a packed matrix B.
+
+    C - Supplies the address of matrix C.
+
+Return Value:
+
+    Returns true if the operation was completed across multiple threads, else
+    false if the operation should fall back to a single thread.
+
+--*/
+{
+
+#if defined(MLAS_HAS_THREADING_SUPPORT)
+
+    int32_t TargetThreadCount;
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    double Complexity = double(M) * double(N) * double(WorkBlock->K);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        return false;
+    }
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+
+    if (N > M) {
+
+        size_t StrideN = N / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != N) {
+            StrideN++;
+        }
+
+        StrideN =
+            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        size_t pldb = (WorkBlock->TransB == CblasNoTrans) ? 1 : WorkBlock->ldb;
+
+        for (size_t CountN, n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            WorkBlock->Segments[Index].M = M;
+            WorkBlock->Segments[Index].N = CountN;
+            WorkBlock->Segments[Index].StartM = 0;
+            WorkBlock->Segments[Index].StartN = n;
+            WorkBlock->Segments[Index].A = A;
+            WorkBlock->Segments[Index].B = (B != nullptr) ? B + n * pldb : nullptr;
+            WorkBlock->Segments[Index].C = C + n;
+
+            Index++;
+        }
+
+    } else {
+
+        size_t StrideM = M / TargetThreadCount;
+
+        if ((StrideM * TargetThreadCount) != M) {
+            StrideM++;
+        }
+
+        size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+
+        for (size_t CountM, m = 0; m < M; m += CountM) {
+
+            CountM = StrideM;
+
+            if (CountM > (M - m)) {
+                CountM = M - m;
+            }
+
+            WorkBlock->Segments[Index].M = CountM;
+            WorkBlock->Segments[Index].N = N;
+            WorkBlock->Segments[Index].StartM = m;
+            WorkBlock->Segments[Index].StartN = 0;
+            WorkBlock->Segments[Index].A = A + m * plda;
+            WorkBlock->Segments[Index].B = B;
+            WorkBlock->Segments[Index].C = C + m * WorkBlock->ldc;
+
+            Index++;
+        }
+    }
+
+    MlasExecuteThreaded(MlasSgemmOperationThreaded, WorkBlock, Index);
+
+    return true;
+
+#else
+
+    //
+    // No threading implementation is available.
+    //
+
+    MLAS_UNREFERENCED_PARAMETER(WorkBlock);
+    MLAS_UNREFERENCED_PARAMETER(M);
+    MLAS_UNREFERENCED_PARAMETER(N);
+    MLAS_UNREFERENCED_PARAMETER(A);
+    MLAS_UNREFERENCED_PARAMETER(B);
+    MLAS_UNREFERENCED_PARAMETER(C);
+
+    return false;
+
+#endif
+
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM).
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Epilogue - Optionally supplies the output stage to apply to matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_WORK_BLOCK WorkBlock;
+
+    //
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
+    //
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldb = ldb;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.PackedB = nullptr;
+    WorkBlock.AlignedN = 0;
+    WorkBlock.BIsHalf = false;
+    WorkBlock.ScaleB = nullptr;
+    WorkBlock.Epilogue = Epilogue;
+
+    if (!MlasSgemmTryMultithread(&WorkBlock, M, N, A, B, C)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc,
+            Epilogue);
+    }
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const unsigned short* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B of half-precision floats.
+
+Arguments:
+
+    See the single precision variant of MlasSgemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldb = ldb;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.PackedB = nullptr;
+    WorkBlock.AlignedN = 0;
+    WorkBlock.BIsHalf = true;
+    WorkBlock.ScaleB = nullptr;
+    WorkBlock.Epilogue = Epilogue;
+
+    if (!MlasSgemmTryMultithread(&WorkBlock, M, N, A, B, C)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc,
+            Epilogue);
+    }
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int8_t* B,
+    size_t ldb,
+    const float* ScaleB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B of 8-bit integers, where the element of
+    matrix B used for column n of matrix C is multiplied by ScaleB[n].
+
+Arguments:
+
+    ScaleB - Supplies the scale of each column of matrix C.
+
+    See the single precision variant of MlasSgemm for the others.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldb = ldb;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.PackedB = nullptr;
+    WorkBlock.AlignedN = 0;
+    WorkBlock.BIsHalf = false;
+    WorkBlock.ScaleB = ScaleB;
+    WorkBlock.Epilogue = Epilogue;
+
+    if (!MlasSgemmTryMultithread(&WorkBlock, M, N, A, B, C)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, ScaleB, beta, C, ldc,
+            Epilogue);
+    }
+}
+
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the size in bytes of the buffer required to pack
+    matrix B with MlasSgemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    return AlignedN * K * sizeof(float);
+}
+
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B into the layout consumed by the SGEMM kernels
+    so that a matrix B that is reused across many operations, such as a
+    constant weight, is only packed once.
+
+    Each slice of MLAS_SGEMM_STRIDEK rows of matrix B is stored as panels of
+    16 columns with any remaining columns zero-padded.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        MlasSgemmPackBSize bytes and aligned to 64 bytes.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    float* D = (float*)PackedB;
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + k, ldb, N, CountK);
+        }
+
+        D += AlignedN * CountK;
+    }
+}
+
+void
+MLASCALL
+MlasSgemmPacked(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B that was packed by MlasSgemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Epilogue - Optionally supplies the output stage to apply to matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_WORK_BLOCK WorkBlock;
+
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = CblasNoTrans;
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldb = 0;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.PackedB = (const float*)PackedB;
+    WorkBlock.AlignedN = AlignedN;
+    WorkBlock.BIsHalf = false;
+    WorkBlock.ScaleB = nullptr;
+    WorkBlock.Epilogue = Epilogue;
+
+    if (!MlasSgemmTryMultithread(&WorkBlock, M, N, A, (const float*)nullptr, C)) {
+        MlasSgemmPackedOperation(TransA, M, 0, N, K, alpha, A, lda,
+            (const float*)PackedB, AlignedN, beta, C, ldc, Epilogue);
+    }
+}
+
+void
+MlasSgemmBatchThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    blocks of a batch of SGEMM operations.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_BATCH_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_BATCH_WORK_BLOCK*)Context;
+
+    //
+    // Compute the range of blocks handled by this thread.
+    //
+
+    const size_t ThreadCount = size_t(WorkBlock->ThreadCount);
+    const size_t BlocksPerThread = WorkBlock->TotalBlocks / ThreadCount;
+    const size_t BlocksExtra = WorkBlock->TotalBlocks % ThreadCount;
+
+    size_t BlockStart;
+    size_t BlockEnd;
+
+    if (size_t(Index) < BlocksExtra) {
+        BlockStart = (BlocksPerThread + 1) * Index;
+        BlockEnd = BlockStart + BlocksPerThread + 1;
+    } else {
+        BlockStart = BlocksPerThread * Index + BlocksExtra;
+        BlockEnd = BlockStart + BlocksPerThread;
+    }
+
+    const size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+
+    for (size_t Block = BlockStart; Block < BlockEnd; Block++) {
+
+        const size_t Batch = Block / WorkBlock->BlocksPerBatch;
+        const size_t m = (Block % WorkBlock->BlocksPerBatch) * WorkBlock->StrideM;
+
+        size_t CountM = WorkBlock->StrideM;
+
+        if (CountM > (WorkBlock->M - m)) {
+            CountM = WorkBlock->M - m;
+        }
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, CountM,
+            WorkBlock->N, WorkBlock->K, WorkBlock->alpha,
+            WorkBlock->A + WorkBlock->OffsetsA[Batch] + m * plda, WorkBlock->lda,
+            WorkBlock->B + WorkBlock->OffsetsB[Batch], WorkBlock->ldb,
+            WorkBlock->beta,
+            WorkBlock->C + WorkBlock->OffsetsC[Batch] + m * WorkBlock->ldc,
+            WorkBlock->ldc, nullptr);
+    }
+}
+
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const size_t* OffsetsA,
+    const float* B,
+    size_t ldb,
+    const size_t* OffsetsB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const size_t* OffsetsC,
+    size_t BatchCount
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of single precision matrix/matrix multiply
+    operations (SGEMM) that share the same dimensions, such as the slices of a
+    MatMul with broadcast batch dimensions.
+
+    The batch is executed as a single threaded dispatch, so a batch of small
+    operations is parallelized across the batch rather than each operation
+    running on a single thread.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the base address of the A matrices.
+
+    lda - Supplies the first dimension of matrix A.
+
+    OffsetsA - Supplies the element offset of matrix A from the base address
+        for each operation of the batch.
+
+    B - Supplies the base address of the B matrices.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    OffsetsB - Supplies the element offset of matrix B from the base address
+        for each operation of the batch.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the base address of the C matrices.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    OffsetsC - Supplies the element offset of matrix C from the base address
+        for each operation of the batch.
+
+    BatchCount - Supplies the number of operations in the batch.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (BatchCount == 0 || M == 0 || N == 0) {
+        return;
+    }
+
+    //
+    // A single operation is better split along the larger of the M and N
+    // dimensions by the standard path.
+    //
+
+    if (BatchCount == 1) {
+        MlasSgemm(TransA, TransB, M, N, K, alpha, A + OffsetsA[0], lda,
+            B + OffsetsB[0], ldb, beta, C + OffsetsC[0], ldc);
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // entire batch.
+    //
+
+    int32_t TargetThreadCount;
+
+    double Complexity = double(M) * double(N) * double(K) * double(BatchCount);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+
+        for (size_t Batch = 0; Batch < BatchCount; Batch++) {
+            MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A + OffsetsA[Batch],
+                lda, B + OffsetsB[Batch], ldb, beta, C + OffsetsC[Batch], ldc, nullptr);
+        }
+
+        return;
+    }
+
+    //
+    // Split each operation along the M dimension only if there are fewer
+    // operations than threads.
+    //
+
+    MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+
+    size_t BlocksPerBatch = (size_t(TargetThreadCount) + BatchCount - 1) / BatchCount;
+
+    if (BlocksPerBatch > M) {
+        BlocksPerBatch = M;
+    }
+
+    size_t StrideM = (M + BlocksPerBatch - 1) / BlocksPerBatch;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.OffsetsA = OffsetsA;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.OffsetsB = OffsetsB;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.OffsetsC = OffsetsC;
+    WorkBlock.StrideM = StrideM;
+    WorkBlock.BlocksPerBatch = (M + StrideM - 1) / StrideM;
+    WorkBlock.TotalBlocks = WorkBlock.BlocksPerBatch * BatchCount;
+
+    if (size_t(TargetThreadCount) > WorkBlock.TotalBlocks) {
+        TargetThreadCount = int32_t(WorkBlock.TotalBlocks);
+    }
+
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasSgemmBatchThreaded, &WorkBlock, TargetThreadCount);
+}
+
+void
+MLASCALL
+MlasSgemv(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* x,
+    float beta,
+    float* y
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/vector multiply
+    operation (SGEMV).
+
+    The operation is executed as a SGEMM of a single row, so that it is split
+    across threads along the output vector and uses the kernels specialized
+    for a single row of matrix A where available.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A.
+
+    N - Supplies the number of columns of matrix A.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMV definition).
 
     A - Supplies the address of matrix A.
 
-    lda - Supplies the first dimension of matrix A.
+    lda - Supplies the first dimension of matrix A.
+
+    x - Supplies the address of vector x, which has N elements if TransA is
+        CblasNoTrans, else M elements.
+
+    beta - Supplies the scaler beta multiplier (see SGEMV definition).
+
+    y - Supplies the address of vector y, which has M elements if TransA is
+        CblasNoTrans, else N elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // y^T = x^T * A^T is a single row SGEMM with matrix A as matrix B.
+    //
+
+    if (TransA == CblasNoTrans) {
+        MlasSgemm(CblasNoTrans, CblasTrans, 1, M, N, alpha, x, N, A, lda, beta, y, M);
+    } else {
+        MlasSgemm(CblasNoTrans, CblasNoTrans, 1, N, M, alpha, x, M, A, lda, beta, y, N);
+    }
+}
+
+//
+// Define the layout of a matrix B packed by MlasSgemmPackBlockSparseB. The
+// columns of matrix B are split into strips of 16 columns and the rows of each
+// strip into blocks of 16 rows. Each run of consecutive blocks with a nonzero
+// element, of up to MLAS_SGEMM_STRIDEK rows, is kept in the packed layout of
+// MlasSgemmCopyPackB, and the blocks of zeros are dropped.
+//
+
+#define MLAS_SGEMM_SPARSE_BLOCK_K                   16
+
+struct MLAS_SGEMM_BLOCK_SPARSE_HEADER {
+    size_t N;
+    size_t K;
+    size_t RunCount;
+    size_t DataOffset;
+    size_t DataCount;
+};
+
+struct MLAS_SGEMM_BLOCK_SPARSE_STRIP {
+    size_t RunBegin;
+    size_t RunEnd;
+    size_t DataOffset;
+};
+
+struct MLAS_SGEMM_BLOCK_SPARSE_RUN {
+    size_t StartK;
+    size_t CountK;
+};
+
+template<typename RunCallback>
+void
+MlasSgemmForEachBlockSparseRun(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    RunCallback Callback
+    )
+/*++
+
+Routine Description:
+
+    This routine finds the runs of blocks of matrix B with a nonzero element
+    and calls Callback(Strip, StartK, CountK) for each, in order.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    Callback - Supplies the routine called for each run.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < N; n += 16) {
+
+        const size_t CountN = (std::min)(N - n, size_t(16));
+        const size_t Strip = n / 16;
+
+        size_t RunStartK = 0;
+        size_t RunCountK = 0;
+
+        for (size_t k = 0; k < K; k += MLAS_SGEMM_SPARSE_BLOCK_K) {
+
+            const size_t CountK = (std::min)(K - k, size_t(MLAS_SGEMM_SPARSE_BLOCK_K));
+
+            bool IsNonzero = false;
+
+            for (size_t kk = 0; kk < CountK && !IsNonzero; kk++) {
+                for (size_t nn = 0; nn < CountN; nn++) {
+                    const float b = (TransB == CblasNoTrans) ? B[(k + kk) * ldb + n + nn] : B[(n + nn) * ldb + k + kk];
+                    if (b != 0.0f) {
+                        IsNonzero = true;
+                        break;
+                    }
+                }
+            }
+
+            if (IsNonzero && RunCountK + CountK <= MLAS_SGEMM_STRIDEK) {
+                if (RunCountK == 0) {
+                    RunStartK = k;
+                }
+                RunCountK += CountK;
+                continue;
+            }
+
+            if (RunCountK > 0) {
+                Callback(Strip, RunStartK, RunCountK);
+            }
+
+            RunStartK = k;
+            RunCountK = IsNonzero ? CountK : 0;
+        }
+
+        if (RunCountK > 0) {
+            Callback(Strip, RunStartK, RunCountK);
+        }
+    }
+}
+
+inline
+size_t
+MlasSgemmBlockSparseDataOffset(
+    size_t StripCount,
+    size_t RunCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the offset of the packed blocks from the start of a
+    block sparse matrix B, after the header, the strips and the runs, which
+    keeps the blocks aligned to 64 bytes as the SGEMM kernels require.
+
+--*/
+{
+    const size_t Offset = sizeof(MLAS_SGEMM_BLOCK_SPARSE_HEADER) +
+        StripCount * sizeof(MLAS_SGEMM_BLOCK_SPARSE_STRIP) +
+        RunCount * sizeof(MLAS_SGEMM_BLOCK_SPARSE_RUN);
+
+    return (Offset + 63) & ~size_t(63);
+}
+
+float
+MLASCALL
+MlasSgemmBlockSparseDensity(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the fraction of the blocks of matrix B that have a
+    nonzero element and are kept by MlasSgemmPackBlockSparseB.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the fraction of the rows of the strips of matrix B that are kept.
+
+--*/
+{
+    if (N == 0 || K == 0) {
+        return 1.0f;
+    }
+
+    size_t NonzeroK = 0;
 
-    B - Supplies the address of matrix B.
+    MlasSgemmForEachBlockSparseRun(TransB, N, K, B, ldb,
+        [&](size_t, size_t, size_t CountK) { NonzeroK += CountK; });
 
-    ldb - Supplies the first dimension of matrix B.
+    const size_t StripCount = (N + 15) / 16;
 
-    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+    return float(double(NonzeroK) / (double(StripCount) * double(K)));
+}
 
-    C - Supplies the address of matrix C.
+size_t
+MLASCALL
+MlasSgemmPackBlockSparseBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
 
-    ldc - Supplies the first dimension of matrix C.
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B with
+    MlasSgemmPackBlockSparseB.
+
+Arguments:
+
+    See MlasSgemmBlockSparseDensity.
 
 Return Value:
 
-    Returns true if the operation was completed across multiple threads, else
-    false if the operation should fall back to a single thread.
+    Returns the number of bytes for the packed matrix B.
 
 --*/
 {
+    size_t RunCount = 0;
+    size_t NonzeroK = 0;
 
-#if defined(MLAS_HAS_THREADING_SUPPORT)
+    MlasSgemmForEachBlockSparseRun(TransB, N, K, B, ldb,
+        [&](size_t, size_t, size_t CountK) { RunCount++; NonzeroK += CountK; });
 
-    MLAS_SGEMM_WORK_BLOCK WorkBlock;
-    int32_t TargetThreadCount;
+    const size_t StripCount = (N + 15) / 16;
 
-    //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
-    //
+    const size_t DataOffset = MlasSgemmBlockSparseDataOffset(StripCount, RunCount);
 
-    double Complexity = double(M) * double(N) * double(K);
+    return DataOffset + NonzeroK * 16 * sizeof(float);
+}
 
-    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
-        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-    } else {
-        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
-    }
+void
+MLASCALL
+MlasSgemmPackBlockSparseB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
 
-    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+Routine Description:
 
-    if (TargetThreadCount >= MaximumThreadCount) {
-        TargetThreadCount = MaximumThreadCount;
+    This routine packs the blocks of matrix B that have a nonzero element in
+    the layout multiplied by MlasSgemmBlockSparse.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the buffer of the size returned by
+        MlasSgemmPackBlockSparseBSize, aligned to 64 bytes.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t StripCount = (N + 15) / 16;
+
+    size_t RunCount = 0;
+
+    MlasSgemmForEachBlockSparseRun(TransB, N, K, B, ldb,
+        [&](size_t, size_t, size_t) { RunCount++; });
+
+    const size_t DataOffset = MlasSgemmBlockSparseDataOffset(StripCount, RunCount);
+
+    MLAS_SGEMM_BLOCK_SPARSE_HEADER* Header = (MLAS_SGEMM_BLOCK_SPARSE_HEADER*)PackedB;
+    MLAS_SGEMM_BLOCK_SPARSE_STRIP* Strips = (MLAS_SGEMM_BLOCK_SPARSE_STRIP*)(Header + 1);
+    MLAS_SGEMM_BLOCK_SPARSE_RUN* Runs = (MLAS_SGEMM_BLOCK_SPARSE_RUN*)(Strips + StripCount);
+    float* Data = (float*)((uint8_t*)PackedB + DataOffset);
+
+    Header->N = N;
+    Header->K = K;
+    Header->RunCount = RunCount;
+    Header->DataOffset = DataOffset;
+
+    for (size_t Strip = 0; Strip < StripCount; Strip++) {
+        Strips[Strip].RunBegin = 0;
+        Strips[Strip].RunEnd = 0;
+        Strips[Strip].DataOffset = 0;
     }
 
-    if (TargetThreadCount == 1) {
-        return false;
+    size_t Run = 0;
+    size_t Offset = 0;
+    size_t NextStrip = 0;
+
+    MlasSgemmForEachBlockSparseRun(TransB, N, K, B, ldb,
+        [&](size_t Strip, size_t StartK, size_t CountK) {
+
+            //
+            // Start the strips up to this one, which leaves those without a
+            // run empty.
+            //
+
+            while (NextStrip <= Strip) {
+                Strips[NextStrip].RunBegin = Run;
+                Strips[NextStrip].RunEnd = Run;
+                Strips[NextStrip].DataOffset = Offset;
+                NextStrip++;
+            }
+
+            const size_t n = Strip * 16;
+            const size_t CountN = (std::min)(N - n, size_t(16));
+
+            if (TransB == CblasNoTrans) {
+                MlasSgemmCopyPackB(Data + Offset, B + n + StartK * ldb, ldb, CountN, CountK);
+            } else {
+                MlasSgemmTransposePackB(Data + Offset, B + StartK + n * ldb, ldb, CountN, CountK);
+            }
+
+            Runs[Run].StartK = StartK;
+            Runs[Run].CountK = CountK;
+            Run++;
+            Strips[Strip].RunEnd = Run;
+            Offset += CountK * 16;
+        });
+
+    while (NextStrip < StripCount) {
+        Strips[NextStrip].RunBegin = Run;
+        Strips[NextStrip].RunEnd = Run;
+        Strips[NextStrip].DataOffset = Offset;
+        NextStrip++;
     }
 
-    //
-    // Initialize the common fields of the work block.
-    //
+    Header->DataCount = Offset;
+}
 
-    WorkBlock.TransA = TransA;
-    WorkBlock.TransB = TransB;
-    WorkBlock.K = K;
-    WorkBlock.lda = lda;
-    WorkBlock.ldb = ldb;
-    WorkBlock.ldc = ldc;
-    WorkBlock.alpha = alpha;
-    WorkBlock.beta = beta;
+void
+MlasSgemmBlockSparseOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t StartStrip,
+    size_t EndStrip,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
 
-    //
-    // Segment the operation across multiple threads.
-    //
+Routine Description:
 
-    int32_t Index = 0;
+    This routine multiplies matrix A by a range of the strips of a block
+    sparse matrix B.
 
-    if (N > M) {
+Arguments:
 
-        size_t StrideN = N / TargetThreadCount;
+    StartStrip - Supplies the first strip of 16 columns of matrix C to compute.
 
-        if ((StrideN * TargetThreadCount) != N) {
-            StrideN++;
-        }
+    EndStrip - Supplies the strip after the last one to compute.
 
-        StrideN =
-            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+    See MlasSgemmBlockSparse for the others.
 
-        size_t pldb = (TransB == CblasNoTrans) ? 1 : ldb;
+Return Value:
 
-        for (size_t CountN, n = 0; n < N; n += CountN) {
+    None.
 
-            CountN = StrideN;
+--*/
+{
+    const MLAS_SGEMM_BLOCK_SPARSE_HEADER* Header = (const MLAS_SGEMM_BLOCK_SPARSE_HEADER*)PackedB;
+    const MLAS_SGEMM_BLOCK_SPARSE_STRIP* Strips = (const MLAS_SGEMM_BLOCK_SPARSE_STRIP*)(Header + 1);
+    const MLAS_SGEMM_BLOCK_SPARSE_RUN* Runs =
+        (const MLAS_SGEMM_BLOCK_SPARSE_RUN*)(Strips + (Header->N + 15) / 16);
+    const float* Data = (const float*)((const uint8_t*)PackedB + Header->DataOffset);
 
-            if (CountN > (N - n)) {
-                CountN = N - n;
-            }
+    for (size_t Strip = StartStrip; Strip < EndStrip; Strip++) {
 
-            WorkBlock.Segments[Index].M = M;
-            WorkBlock.Segments[Index].N = CountN;
-            WorkBlock.Segments[Index].A = A;
-            WorkBlock.Segments[Index].B = B + n * pldb;
-            WorkBlock.Segments[Index].C = C + n;
+        if (MlasIsCancelled()) {
+            return;
+        }
 
-            Index++;
+        const size_t n = Strip * 16;
+        const size_t CountN = (std::min)(Header->N - n, size_t(16));
+        float* c = C + n;
+
+        const size_t RunBegin = Strips[Strip].RunBegin;
+        const size_t RunEnd = Strips[Strip].RunEnd;
+
+        //
+        // A strip of zeros leaves beta times matrix C.
+        //
+
+        if (beta == 0.0f) {
+            if (RunBegin == RunEnd) {
+                for (size_t m = 0; m < M; m++) {
+                    std::fill_n(c + m * ldc, CountN, 0.0f);
+                }
+            }
+        } else if (beta != 1.0f) {
+            MlasSgemmMultiplyBeta(c, M, CountN, ldc, beta);
         }
 
-    } else {
+        const float* PanelB = Data + Strips[Strip].DataOffset;
 
-        size_t StrideM = M / TargetThreadCount;
+        for (size_t Run = RunBegin; Run < RunEnd; Run++) {
 
-        if ((StrideM * TargetThreadCount) != M) {
-            StrideM++;
+            const size_t StartK = Runs[Run].StartK;
+            const size_t CountK = Runs[Run].CountK;
+
+            const float* a = A + ((TransA == CblasNoTrans) ? StartK : StartK * lda);
+
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha, a, lda, PanelB, c, ldc,
+                Run == RunBegin && beta == 0.0f, (Run + 1 == RunEnd) ? Epilogue : nullptr, n);
+
+            PanelB += CountK * 16;
         }
 
-        size_t plda = (TransA == CblasNoTrans) ? lda : 1;
+        if (RunBegin == RunEnd && Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, c, ldc, 0, M, n, CountN);
+        }
+    }
+}
 
-        for (size_t CountM, m = 0; m < M; m += CountM) {
+//
+// Define the parameters to execute a block sparse SGEMM operation on worker
+// threads. The strips are split into ranges of about the same number of
+// nonzero blocks.
+//
 
-            CountM = StrideM;
+struct MLAS_SGEMM_BLOCK_SPARSE_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    size_t M;
+    float alpha;
+    const float* A;
+    size_t lda;
+    const void* PackedB;
+    float beta;
+    float* C;
+    size_t ldc;
+    const MLAS_SGEMM_EPILOGUE* Epilogue;
+    int32_t ThreadCount;
+};
 
-            if (CountM > (M - m)) {
-                CountM = M - m;
-            }
+size_t
+MlasSgemmBlockSparseFindStrip(
+    const MLAS_SGEMM_BLOCK_SPARSE_STRIP* Strips,
+    size_t StripCount,
+    size_t DataOffset
+    )
+/*++
 
-            WorkBlock.Segments[Index].M = CountM;
-            WorkBlock.Segments[Index].N = N;
-            WorkBlock.Segments[Index].A = A + m * plda;
-            WorkBlock.Segments[Index].B = B;
-            WorkBlock.Segments[Index].C = C + m * ldc;
+Routine Description:
 
-            Index++;
+    This routine finds the first strip whose packed data starts at or after
+    DataOffset.
+
+--*/
+{
+    size_t Low = 0;
+    size_t High = StripCount;
+
+    while (Low < High) {
+        const size_t Middle = (Low + High) / 2;
+        if (Strips[Middle].DataOffset < DataOffset) {
+            Low = Middle + 1;
+        } else {
+            High = Middle;
         }
     }
 
-    MlasExecuteThreaded(MlasSgemmOperationThreaded, &WorkBlock, Index);
+    return Low;
+}
 
-    return true;
+void
+MlasSgemmBlockSparseThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
 
-#else
+Routine Description:
 
-    //
-    // No threading implementation is available.
-    //
+    This routine is invoked from a worker thread to execute a range of the
+    strips of a block sparse SGEMM operation.
 
-    MLAS_UNREFERENCED_PARAMETER(TransA);
-    MLAS_UNREFERENCED_PARAMETER(TransB);
-    MLAS_UNREFERENCED_PARAMETER(M);
-    MLAS_UNREFERENCED_PARAMETER(N);
-    MLAS_UNREFERENCED_PARAMETER(K);
-    MLAS_UNREFERENCED_PARAMETER(alpha);
-    MLAS_UNREFERENCED_PARAMETER(A);
-    MLAS_UNREFERENCED_PARAMETER(lda);
-    MLAS_UNREFERENCED_PARAMETER(B);
-    MLAS_UNREFERENCED_PARAMETER(ldb);
-    MLAS_UNREFERENCED_PARAMETER(beta);
-    MLAS_UNREFERENCED_PARAMETER(C);
-    MLAS_UNREFERENCED_PARAMETER(ldc);
+Arguments:
 
-    return false;
+    Context - Supplies the pointer to the context for the threaded operation.
 
-#endif
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SGEMM_BLOCK_SPARSE_WORK_BLOCK* WorkBlock = (const MLAS_SGEMM_BLOCK_SPARSE_WORK_BLOCK*)Context;
+
+    const MLAS_SGEMM_BLOCK_SPARSE_HEADER* Header = (const MLAS_SGEMM_BLOCK_SPARSE_HEADER*)WorkBlock->PackedB;
+    const MLAS_SGEMM_BLOCK_SPARSE_STRIP* Strips = (const MLAS_SGEMM_BLOCK_SPARSE_STRIP*)(Header + 1);
+
+    const size_t StripCount = (Header->N + 15) / 16;
+    const size_t DataCount = Header->DataCount;
+    const size_t ThreadCount = size_t(WorkBlock->ThreadCount);
+
+    //
+    // Each thread computes the strips whose blocks start in its share of the
+    // packed data. The strips of zeros at the end go to the last thread.
+    //
 
+    const size_t StartStrip =
+        MlasSgemmBlockSparseFindStrip(Strips, StripCount, DataCount * size_t(Index) / ThreadCount);
+    const size_t EndStrip = (size_t(Index) + 1 == ThreadCount) ? StripCount :
+        MlasSgemmBlockSparseFindStrip(Strips, StripCount, DataCount * (size_t(Index) + 1) / ThreadCount);
+
+    MlasSgemmBlockSparseOperation(WorkBlock->TransA, WorkBlock->M, StartStrip, EndStrip,
+        WorkBlock->alpha, WorkBlock->A, WorkBlock->lda, WorkBlock->PackedB, WorkBlock->beta,
+        WorkBlock->C, WorkBlock->ldc, WorkBlock->Epilogue);
 }
 
 void
 MLASCALL
-MlasSgemm(
+MlasSgemmBlockSparse(
     CBLAS_TRANSPOSE TransA,
-    CBLAS_TRANSPOSE TransB,
     size_t M,
     size_t N,
     size_t K,
     float alpha,
     const float* A,
     size_t lda,
-    const float* B,
-    size_t ldb,
+    const void* PackedB,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
 Routine Description:
 
     This routine implements the single precision matrix/matrix multiply
-    operation (SGEMM).
+    operation (SGEMM) using a matrix B packed by MlasSgemmPackBlockSparseB,
+    which only multiplies the blocks of matrix B with a nonzero element.
 
 Arguments:
 
     TransA - Supplies the transpose operation for matrix A.
 
-    TransB - Supplies the transpose operation for matrix B.
-
     M - Supplies the number of rows of matrix A and matrix C.
 
-    N - Supplies the number of columns of matrix B and matrix C.
+    N - Supplies the number of columns of matrix B and matrix C, which must be
+        the N matrix B was packed with.
 
     K - Supplies the number of columns of matrix A and the number of rows of
-        matrix B.
+        matrix B, which must be the K matrix B was packed with.
 
     alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
 
@@ -1304,9 +3349,7 @@ Arguments:
 
     lda - Supplies the first dimension of matrix A.
 
-    B - Supplies the address of matrix B.
-
-    ldb - Supplies the first dimension of matrix B.
+    PackedB - Supplies the address of the packed matrix B.
 
     beta - Supplies the scaler beta multiplier (see SGEMM definition).
 
@@ -1314,18 +3357,68 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Optionally supplies the output stage to apply to matrix C.
+
 Return Value:
 
     None.
 
 --*/
 {
+    MLAS_UNREFERENCED_PARAMETER(K);
+
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    const MLAS_SGEMM_BLOCK_SPARSE_HEADER* Header = (const MLAS_SGEMM_BLOCK_SPARSE_HEADER*)PackedB;
+
+    const size_t StripCount = (N + 15) / 16;
+
     //
-    // Try to run the operation across multiple threads or fall back to a
-    // single thread based on the GEMM parameters and system configuration.
+    // Compute the number of target threads given the complexity of the
+    // nonzero blocks, which are 16 columns wide.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc)) {
-        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    double Complexity = double(M) * double(Header->DataCount);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > StripCount) {
+        TargetThreadCount = int32_t(StripCount);
+    }
+
+    if (TargetThreadCount <= 1) {
+        MlasSgemmBlockSparseOperation(TransA, M, 0, StripCount, alpha, A, lda, PackedB, beta, C, ldc,
+            Epilogue);
+        return;
     }
+
+    MLAS_SGEMM_BLOCK_SPARSE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.M = M;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.PackedB = PackedB;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.Epilogue = Epilogue;
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasSgemmBlockSparseThreaded, &WorkBlock, TargetThreadCount);
 }
@@ -0,0 +1,810 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc.cpp
+
+Abstract:
+
+    This module implements the single precision operations using the NCHWc
+    blocking format.
+
+    The NCHWc format stores the channels of an image in blocks of
+    BlockSize elements, with the channels of a block stored
+    contiguously for each spatial position. Convolutions then operate directly
+    on the blocked tensors without expanding the input into a column buffer,
+    and consecutive convolution and pooling operations avoid reordering their
+    inputs and outputs.
+
+--*/
+
+#include "snchwc.h"
+
+//
+// Define the vector operations for the portable convolution kernel.
+//
+
+struct MLAS_NCHWC_VECTOR_FLOAT32X4 {
+
+    typedef MLAS_FLOAT32X4 Type;
+
+    static constexpr size_t Lanes = 4;
+
+    static MLAS_FLOAT32X4 Zero() { return MlasZeroFloat32x4(); }
+
+    static MLAS_FLOAT32X4 Load(const float* p) { return MlasLoadFloat32x4(p); }
+
+    static void Store(float* p, MLAS_FLOAT32X4 v) { MlasStoreFloat32x4(p, v); }
+
+    static MLAS_FLOAT32X4 Broadcast(const float* p) { return MlasBroadcastFloat32x4(p); }
+
+    static MLAS_FLOAT32X4 MultiplyAdd(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b, MLAS_FLOAT32X4 c)
+    {
+        return MlasMultiplyAddFloat32x4(a, b, c);
+    }
+};
+
+size_t
+MLASCALL
+MlasNchwcGetBlockSize(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of channels in a block of the NCHWc
+    format.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the number of channels in a block.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    return MlasPlatform.NchwcBlockSize;
+#else
+    return 8;
+#endif
+}
+
+void
+MLASCALL
+MlasReorderInput(
+    const int64_t* InputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an input tensor from the NCHW format to the NCHWc
+    format. The channel count is padded to a multiple of the block size with
+    zeroes.
+
+Arguments:
+
+    InputShape - Supplies the shape of the source tensor in NCHW format.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t BatchCount = size_t(InputShape[0]);
+    const size_t InputChannels = size_t(InputShape[1]);
+    const size_t InputSize = size_t(InputShape[2]) * size_t(InputShape[3]);
+
+    for (size_t n = 0; n < BatchCount; n++) {
+
+        for (size_t c = 0; c < InputChannels; c += BlockSize) {
+
+            const size_t ChannelsThisBlock =
+                std::min(InputChannels - c, size_t(BlockSize));
+
+            for (size_t i = 0; i < InputSize; i++) {
+
+                size_t bc = 0;
+
+                for (; bc < ChannelsThisBlock; bc++) {
+                    D[bc] = S[bc * InputSize + i];
+                }
+
+                for (; bc < BlockSize; bc++) {
+                    D[bc] = 0.0f;
+                }
+
+                D += BlockSize;
+            }
+
+            S += ChannelsThisBlock * InputSize;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderOutput(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an output tensor from the NCHWc format to the NCHW
+    format. The padding channels of the source tensor are discarded.
+
+Arguments:
+
+    OutputShape - Supplies the shape of the destination tensor in NCHW format.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t BatchCount = size_t(OutputShape[0]);
+    const size_t OutputChannels = size_t(OutputShape[1]);
+    const size_t OutputSize = size_t(OutputShape[2]) * size_t(OutputShape[3]);
+
+    for (size_t n = 0; n < BatchCount; n++) {
+
+        for (size_t c = 0; c < OutputChannels; c += BlockSize) {
+
+            const size_t ChannelsThisBlock =
+                std::min(OutputChannels - c, size_t(BlockSize));
+
+            for (size_t bc = 0; bc < ChannelsThisBlock; bc++) {
+
+                const float* s = S + bc;
+
+                for (size_t i = 0; i < OutputSize; i++) {
+                    D[i] = s[i * BlockSize];
+                }
+
+                D += OutputSize;
+            }
+
+            S += BlockSize * OutputSize;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderFilter(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a convolution filter from the OIHW format to the
+    blocked format used by MlasNchwcConv. Within each pair of output and input
+    channel blocks, each kernel position stores the input channels of the
+    block with the output channels of the block contiguous for each input
+    channel. The channel counts are padded to a multiple of the block size
+    with zeroes.
+
+Arguments:
+
+    FilterShape - Supplies the shape of the source filter in OIHW format.
+
+    S - Supplies the address of the source filter.
+
+    D - Supplies the address of the destination filter.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t OutputChannels = size_t(FilterShape[0]);
+    const size_t InputChannels = size_t(FilterShape[1]);
+    const size_t KernelSize = size_t(FilterShape[2]) * size_t(FilterShape[3]);
+
+    for (size_t o = 0; o < OutputChannels; o += BlockSize) {
+
+        const size_t OutputChannelsThisBlock =
+            std::min(OutputChannels - o, size_t(BlockSize));
+
+        for (size_t i = 0; i < InputChannels; i += BlockSize) {
+
+            const size_t InputChannelsThisBlock =
+                std::min(InputChannels - i, size_t(BlockSize));
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                for (size_t bi = 0; bi < BlockSize; bi++) {
+
+                    for (size_t bo = 0; bo < BlockSize; bo++) {
+
+                        if (bi < InputChannelsThisBlock && bo < OutputChannelsThisBlock) {
+                            D[bo] = S[((o + bo) * InputChannels + (i + bi)) * KernelSize + k];
+                        } else {
+                            D[bo] = 0.0f;
+                        }
+                    }
+
+                    D += BlockSize;
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasNchwcConvRowKernel(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t FilterCount,
+    size_t oh
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of a set of output channel blocks using the
+    portable four element vector type. The block size is eight channels.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the address of the input image in NCHWc format.
+
+    Filter - Supplies the address of the filter for the first output channel
+        block.
+
+    Bias - Optionally supplies the address of the bias for the first output
+        channel block.
+
+    Output - Supplies the address of the output row of the first output
+        channel block.
+
+    FilterCount - Supplies the number of output channel blocks to compute.
+
+    oh - Supplies the output row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasNchwcConvRow<MLAS_NCHWC_VECTOR_FLOAT32X4, 8, 2>(WorkBlock, Input, Filter, Bias, Output,
+        FilterCount, oh);
+}
+
+void
+MlasNchwcPoolRow(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    float* Output,
+    size_t oh
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of a single channel block of a pooling
+    operation.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the pooling parameters.
+
+    Input - Supplies the address of the input channel block.
+
+    Output - Supplies the address of the output row.
+
+    oh - Supplies the output row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputHeight = WorkBlock->InputHeight;
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t KernelHeight = WorkBlock->KernelHeight;
+    const size_t KernelWidth = WorkBlock->KernelWidth;
+    const size_t BlockSize = WorkBlock->BlockSize;
+    const size_t BlockVectors = BlockSize / 4;
+    const MLAS_POOLING_KIND PoolingKind = WorkBlock->PoolingKind;
+
+    const MLAS_FLOAT32X4 InitialVector = (PoolingKind == MlasMaximumPooling) ?
+        MlasBroadcastFloat32x4(std::numeric_limits<float>::lowest()) : MlasZeroFloat32x4();
+
+    for (size_t ow = 0; ow < WorkBlock->OutputWidth; ow++) {
+
+        MLAS_FLOAT32X4 Reductions[MLAS_NCHWC_MAXIMUM_BLOCK_SIZE / 4];
+
+        for (size_t v = 0; v < BlockVectors; v++) {
+            Reductions[v] = InitialVector;
+        }
+
+        size_t ValidCount = 0;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const size_t ih = oh * WorkBlock->StrideHeight + kh * WorkBlock->DilationHeight -
+                WorkBlock->PaddingTop;
+
+            if (ih >= InputHeight) {
+                continue;
+            }
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const size_t iw = ow * WorkBlock->StrideWidth + kw * WorkBlock->DilationWidth -
+                    WorkBlock->PaddingLeft;
+
+                if (iw >= InputWidth) {
+                    continue;
+                }
+
+                const float* x = Input + (ih * InputWidth + iw) * BlockSize;
+
+                for (size_t v = 0; v < BlockVectors; v++) {
+
+                    MLAS_FLOAT32X4 InputVector = MlasLoadFloat32x4(x + v * 4);
+
+                    if (PoolingKind == MlasMaximumPooling) {
+                        Reductions[v] = MlasMaximumFloat32x4(Reductions[v], InputVector);
+                    } else {
+                        Reductions[v] = MlasAddFloat32x4(Reductions[v], InputVector);
+                    }
+                }
+
+                ValidCount++;
+            }
+        }
+
+        if (PoolingKind != MlasMaximumPooling) {
+
+            const size_t Divisor = (PoolingKind == MlasAveragePoolingIncludePad) ?
+                KernelHeight * KernelWidth : ValidCount;
+
+            MLAS_FLOAT32X4 Scale = MlasBroadcastFloat32x4(1.0f / float(Divisor));
+
+            for (size_t v = 0; v < BlockVectors; v++) {
+                Reductions[v] = MlasMultiplyFloat32x4(Reductions[v], Scale);
+            }
+        }
+
+        for (size_t v = 0; v < BlockVectors; v++) {
+            MlasStoreFloat32x4(Output + ow * BlockSize + v * 4, Reductions[v]);
+        }
+    }
+}
+
+void
+MlasNchwcThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc convolution or pooling operation.
+
+    The operation is partitioned by the rows of the output tensor across all
+    images and output channel blocks.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock = (const MLAS_NCHWC_WORK_BLOCK*)Context;
+
+    const size_t OutputHeight = WorkBlock->OutputHeight;
+    const size_t OutputChannelBlocks = WorkBlock->OutputChannelBlocks;
+
+    //
+    // Convolutions compute sets of output channel blocks together to share
+    // the loads of the input, while pooling operations compute each channel
+    // block separately.
+    //
+
+    const bool IsConvolution = (WorkBlock->Filter != nullptr);
+    const size_t FilterSetSize = IsConvolution ? MLAS_NCHWC_FILTER_SET_SIZE : 1;
+    const size_t FilterSetCount = (OutputChannelBlocks + FilterSetSize - 1) / FilterSetSize;
+    const size_t TotalRows = WorkBlock->BatchCount * FilterSetCount * OutputHeight;
+
+    const size_t BlockSize = WorkBlock->BlockSize;
+    const size_t InputSize = WorkBlock->InputHeight * WorkBlock->InputWidth;
+    const size_t OutputSize = OutputHeight * WorkBlock->OutputWidth;
+    const size_t OutputRowSize = WorkBlock->OutputWidth * BlockSize;
+    const size_t TargetThreadCount = size_t(WorkBlock->TargetThreadCount);
+
+    //
+    // Compute the range of rows for this thread.
+    //
+
+    const size_t RowsPerThread = TotalRows / TargetThreadCount;
+    const size_t RowsExtra = TotalRows % TargetThreadCount;
+
+    size_t RowStart;
+    size_t RowEnd;
+
+    if (size_t(Index) < RowsExtra) {
+        RowStart = (RowsPerThread + 1) * size_t(Index);
+        RowEnd = RowStart + RowsPerThread + 1;
+    } else {
+        RowStart = RowsPerThread * size_t(Index) + RowsExtra;
+        RowEnd = RowStart + RowsPerThread;
+    }
+
+    for (size_t Row = RowStart; Row < RowEnd; Row++) {
+
+        const size_t oh = Row % OutputHeight;
+        const size_t FilterSet = (Row / OutputHeight) % FilterSetCount;
+        const size_t n = Row / (OutputHeight * FilterSetCount);
+
+        const size_t ob = FilterSet * FilterSetSize;
+        const size_t FilterCount = std::min(FilterSetSize, OutputChannelBlocks - ob);
+
+        float* Output = WorkBlock->Output +
+            ((n * OutputChannelBlocks + ob) * OutputSize * BlockSize) + oh * OutputRowSize;
+
+        if (IsConvolution) {
+
+            const float* Input = WorkBlock->Input +
+                n * WorkBlock->InputChannelBlocks * InputSize * BlockSize;
+            const float* Filter = WorkBlock->Filter + ob * WorkBlock->InputChannelBlocks *
+                WorkBlock->KernelHeight * WorkBlock->KernelWidth *
+                BlockSize * BlockSize;
+            const float* Bias = (WorkBlock->Bias != nullptr) ?
+                WorkBlock->Bias + ob * BlockSize : nullptr;
+
+#if defined(MLAS_TARGET_AMD64)
+            MlasPlatform.NchwcConvRowRoutine(WorkBlock, Input, Filter, Bias, Output,
+                FilterCount, oh);
+#else
+            MlasNchwcConvRowKernel(WorkBlock, Input, Filter, Bias, Output, FilterCount, oh);
+#endif
+
+            for (size_t f = 0; f < FilterCount; f++) {
+                MlasActivation(WorkBlock->Activation, Output, nullptr, 1, Output,
+                    OutputRowSize, OutputRowSize);
+                Output += OutputSize * BlockSize;
+            }
+
+        } else {
+
+            const float* Input = WorkBlock->Input +
+                (n * OutputChannelBlocks + ob) * InputSize * BlockSize;
+
+            MlasNchwcPoolRow(WorkBlock, Input, Output, oh);
+        }
+    }
+}
+
+void
+MlasNchwcPrepareWorkBlock(
+    MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape
+    )
+/*++
+
+Routine Description:
+
+    This routine initializes the shape parameters of the work block and
+    selects the number of threads for the operation.
+
+Arguments:
+
+    WorkBlock - Supplies the structure to initialize.
+
+    InputShape - Supplies the shape of the input tensor in NCHWc format.
+
+    KernelShape - Supplies the shape of the kernel.
+
+    DilationShape - Optionally supplies the dilation of the kernel.
+
+    Padding - Supplies the padding of the input tensor.
+
+    StrideShape - Supplies the stride of the kernel.
+
+    OutputShape - Supplies the shape of the output tensor in NCHWc format.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    WorkBlock->BlockSize = BlockSize;
+    WorkBlock->BatchCount = size_t(InputShape[0]);
+    WorkBlock->InputChannelBlocks = size_t(InputShape[1]) / BlockSize;
+    WorkBlock->InputHeight = size_t(InputShape[2]);
+    WorkBlock->InputWidth = size_t(InputShape[3]);
+    WorkBlock->OutputChannelBlocks = size_t(OutputShape[1]) / BlockSize;
+    WorkBlock->OutputHeight = size_t(OutputShape[2]);
+    WorkBlock->OutputWidth = size_t(OutputShape[3]);
+    WorkBlock->KernelHeight = size_t(KernelShape[0]);
+    WorkBlock->KernelWidth = size_t(KernelShape[1]);
+    WorkBlock->DilationHeight = (DilationShape != nullptr) ? size_t(DilationShape[0]) : 1;
+    WorkBlock->DilationWidth = (DilationShape != nullptr) ? size_t(DilationShape[1]) : 1;
+    WorkBlock->PaddingTop = size_t(Padding[0]);
+    WorkBlock->PaddingLeft = size_t(Padding[1]);
+    WorkBlock->StrideHeight = size_t(StrideShape[0]);
+    WorkBlock->StrideWidth = size_t(StrideShape[1]);
+
+    //
+    // Compute the range of output columns whose kernel window lies entirely
+    // within the input width.
+    //
+
+    const size_t StrideWidth = WorkBlock->StrideWidth;
+    const size_t PaddingLeft = WorkBlock->PaddingLeft;
+    const size_t KernelExtent = (WorkBlock->KernelWidth - 1) * WorkBlock->DilationWidth + 1;
+
+    size_t OutputWidthStart = (PaddingLeft + StrideWidth - 1) / StrideWidth;
+    size_t OutputWidthEnd = 0;
+
+    if (WorkBlock->InputWidth + PaddingLeft >= KernelExtent) {
+        OutputWidthEnd = (WorkBlock->InputWidth + PaddingLeft - KernelExtent) / StrideWidth + 1;
+    }
+
+    OutputWidthEnd = std::min(OutputWidthEnd, WorkBlock->OutputWidth);
+    OutputWidthStart = std::min(OutputWidthStart, OutputWidthEnd);
+
+    WorkBlock->OutputWidthStart = OutputWidthStart;
+    WorkBlock->OutputWidthEnd = OutputWidthEnd;
+}
+
+void
+MlasNchwcExecute(
+    MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    double Complexity
+    )
+/*++
+
+Routine Description:
+
+    This routine runs a NCHWc convolution or pooling operation across multiple
+    threads or on the calling thread based on the complexity of the operation.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the operation
+        parameters.
+
+    Complexity - Supplies the number of multiply-adds or reductions in the
+        operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterSetSize = (WorkBlock->Filter != nullptr) ? MLAS_NCHWC_FILTER_SET_SIZE : 1;
+    const size_t FilterSetCount = (WorkBlock->OutputChannelBlocks + FilterSetSize - 1) /
+        FilterSetSize;
+    const size_t TotalRows = WorkBlock->BatchCount * FilterSetCount * WorkBlock->OutputHeight;
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > TotalRows) {
+        TargetThreadCount = int32_t(TotalRows);
+    }
+
+    if (TargetThreadCount <= 1) {
+        WorkBlock->TargetThreadCount = 1;
+        MlasNchwcThreaded(WorkBlock, 0);
+        return;
+    }
+
+    WorkBlock->TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasNchwcThreaded, WorkBlock, TargetThreadCount);
+}
+
+void
+MLASCALL
+MlasNchwcConv(
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a two dimensional convolution directly on tensors
+    in the NCHWc format, without expanding the input into a column buffer.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor in NCHWc format. The
+        channel count is a multiple of the block size.
+
+    KernelShape - Supplies the height and width of the kernel.
+
+    DilationShape - Supplies the dilation of the kernel.
+
+    Padding - Supplies the top, left, bottom and right padding of the input
+        tensor.
+
+    StrideShape - Supplies the stride of the kernel.
+
+    OutputShape - Supplies the shape of the output tensor in NCHWc format. The
+        channel count is a multiple of the block size.
+
+    Input - Supplies the address of the input tensor.
+
+    Filter - Supplies the address of the filter, reordered by
+        MlasReorderFilter.
+
+    Bias - Optionally supplies the address of the bias vector, padded to the
+        output channel count.
+
+    Output - Supplies the address of the output tensor.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_NCHWC_WORK_BLOCK WorkBlock;
+
+    MlasNchwcPrepareWorkBlock(&WorkBlock, InputShape, KernelShape, DilationShape,
+        Padding, StrideShape, OutputShape);
+
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.Activation = Activation;
+    WorkBlock.PoolingKind = MlasMaximumPooling;
+
+    double Complexity = double(OutputShape[0]) * double(OutputShape[1]) *
+        double(OutputShape[2]) * double(OutputShape[3]) * double(InputShape[1]) *
+        double(KernelShape[0]) * double(KernelShape[1]);
+
+    MlasNchwcExecute(&WorkBlock, Complexity);
+}
+
+void
+MLASCALL
+MlasNchwcPool(
+    MLAS_POOLING_KIND PoolingKind,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a two dimensional pooling operation directly on
+    tensors in the NCHWc format.
+
+Arguments:
+
+    PoolingKind - Supplies the kind of pooling operation to perform.
+
+    InputShape - Supplies the shape of the input tensor in NCHWc format.
+
+    KernelShape - Supplies the height and width of the kernel.
+
+    DilationShape - Optionally supplies the dilation of the kernel.
+
+    Padding - Supplies the top, left, bottom and right padding of the input
+        tensor.
+
+    StrideShape - Supplies the stride of the kernel.
+
+    OutputShape - Supplies the shape of the output tensor in NCHWc format.
+
+    Input - Supplies the address of the input tensor.
+
+    Output - Supplies the address of the output tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_NCHWC_WORK_BLOCK WorkBlock;
+
+    MlasNchwcPrepareWorkBlock(&WorkBlock, InputShape, KernelShape, DilationShape,
+        Padding, StrideShape, OutputShape);
+
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = nullptr;
+    WorkBlock.Bias = nullptr;
+    WorkBlock.Output = Output;
+    WorkBlock.Activation = nullptr;
+    WorkBlock.PoolingKind = PoolingKind;
+
+    double Complexity = double(OutputShape[0]) * double(OutputShape[1]) *
+        double(OutputShape[2]) * double(OutputShape[3]) *
+        double(KernelShape[0]) * double(KernelShape[1]);
+
+    MlasNchwcExecute(&WorkBlock, Complexity);
+}
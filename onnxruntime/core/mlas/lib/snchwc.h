@@ -0,0 +1,344 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc.h
+
+Abstract:
+
+    This module contains the common definitions and the templated convolution
+    kernel for the single precision operations using the NCHWc blocking
+    format.
+
+    The kernel is parameterized by the vector type, so that the same blocking
+    logic is compiled for each instruction set extension in its own module.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+//
+// Define the maximum number of channels in a block of the NCHWc format.
+//
+
+#define MLAS_NCHWC_MAXIMUM_BLOCK_SIZE           16
+
+//
+// Define the number of output channel blocks that are computed together by
+// a convolution kernel.
+//
+
+#define MLAS_NCHWC_FILTER_SET_SIZE              4
+
+//
+// Define the parameters to execute segments of a NCHWc convolution or pooling
+// operation on worker threads.
+//
+
+struct MLAS_NCHWC_WORK_BLOCK {
+    size_t BlockSize;
+    size_t BatchCount;
+    size_t InputChannelBlocks;
+    size_t InputHeight;
+    size_t InputWidth;
+    size_t OutputChannelBlocks;
+    size_t OutputHeight;
+    size_t OutputWidth;
+    size_t KernelHeight;
+    size_t KernelWidth;
+    size_t DilationHeight;
+    size_t DilationWidth;
+    size_t PaddingTop;
+    size_t PaddingLeft;
+    size_t StrideHeight;
+    size_t StrideWidth;
+    size_t OutputWidthStart;
+    size_t OutputWidthEnd;
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* Output;
+    const MLAS_ACTIVATION* Activation;
+    MLAS_POOLING_KIND PoolingKind;
+    int32_t TargetThreadCount;
+};
+
+namespace {
+
+template<typename Vector, size_t BlockSize, size_t OutputCount, size_t FilterCount, bool CheckBounds>
+inline
+void
+MlasNchwcConvOutputs(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t oh,
+    size_t ow
+    )
+/*++
+
+Routine Description:
+
+    This routine computes one or more horizontally adjacent output positions
+    for a set of output channel blocks. Each load of the filter is shared by
+    all of the output positions and each broadcast of the input is shared by
+    all of the output channel blocks.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the address of the input image in NCHWc format.
+
+    Filter - Supplies the address of the filter for the first output channel
+        block.
+
+    Bias - Optionally supplies the address of the bias for the first output
+        channel block.
+
+    Output - Supplies the address of the first output position of the first
+        output channel block.
+
+    oh - Supplies the output row.
+
+    ow - Supplies the first output column.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    typedef typename Vector::Type VectorType;
+
+    constexpr size_t BlockVectors = BlockSize / Vector::Lanes;
+
+    const size_t InputHeight = WorkBlock->InputHeight;
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t KernelHeight = WorkBlock->KernelHeight;
+    const size_t KernelWidth = WorkBlock->KernelWidth;
+    const size_t InputStrideWidth = WorkBlock->StrideWidth * BlockSize;
+    const size_t InputSize = InputHeight * InputWidth;
+    const size_t OutputSize = WorkBlock->OutputHeight * WorkBlock->OutputWidth;
+    const size_t FilterBlockSize = KernelHeight * KernelWidth * BlockSize * BlockSize;
+    const size_t FilterStride = WorkBlock->InputChannelBlocks * FilterBlockSize;
+
+    VectorType Accumulators[FilterCount][OutputCount][BlockVectors];
+
+    for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t v = 0; v < BlockVectors; v++) {
+
+            VectorType BiasVector = (Bias != nullptr) ?
+                Vector::Load(Bias + f * BlockSize + v * Vector::Lanes) : Vector::Zero();
+
+            for (size_t o = 0; o < OutputCount; o++) {
+                Accumulators[f][o][v] = BiasVector;
+            }
+        }
+    }
+
+    for (size_t ib = 0; ib < WorkBlock->InputChannelBlocks; ib++) {
+
+        const float* InputBlock = Input + ib * InputSize * BlockSize;
+        const float* FilterBlock = Filter + ib * FilterBlockSize;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const size_t ih = oh * WorkBlock->StrideHeight + kh * WorkBlock->DilationHeight -
+                WorkBlock->PaddingTop;
+
+            //
+            // The unsigned compare also rejects rows in the top padding.
+            //
+
+            if (ih >= InputHeight) {
+                continue;
+            }
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const size_t iw = ow * WorkBlock->StrideWidth + kw * WorkBlock->DilationWidth -
+                    WorkBlock->PaddingLeft;
+
+                if (CheckBounds && iw >= InputWidth) {
+                    continue;
+                }
+
+                const float* x = InputBlock + (ih * InputWidth + iw) * BlockSize;
+                const float* w = FilterBlock + (kh * KernelWidth + kw) * BlockSize * BlockSize;
+
+                for (size_t bi = 0; bi < BlockSize; bi++) {
+
+                    VectorType FilterVectors[FilterCount][BlockVectors];
+
+                    for (size_t f = 0; f < FilterCount; f++) {
+                        for (size_t v = 0; v < BlockVectors; v++) {
+                            FilterVectors[f][v] = Vector::Load(w + f * FilterStride + v * Vector::Lanes);
+                        }
+                    }
+
+                    for (size_t o = 0; o < OutputCount; o++) {
+
+                        VectorType InputVector = Vector::Broadcast(x + o * InputStrideWidth + bi);
+
+                        for (size_t f = 0; f < FilterCount; f++) {
+                            for (size_t v = 0; v < BlockVectors; v++) {
+                                Accumulators[f][o][v] = Vector::MultiplyAdd(InputVector,
+                                    FilterVectors[f][v], Accumulators[f][o][v]);
+                            }
+                        }
+                    }
+
+                    w += BlockSize;
+                }
+            }
+        }
+    }
+
+    for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t o = 0; o < OutputCount; o++) {
+            for (size_t v = 0; v < BlockVectors; v++) {
+                Vector::Store(Output + f * OutputSize * BlockSize + o * BlockSize +
+                    v * Vector::Lanes, Accumulators[f][o][v]);
+            }
+        }
+    }
+}
+
+template<typename Vector, size_t BlockSize, size_t OutputCount, size_t FilterCount>
+inline
+void
+MlasNchwcConvRowFilterSet(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t oh
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of a set of output channel blocks. The output
+    positions that read the left or right padding are computed individually
+    with bounds checks, and the interior positions are computed in groups of
+    OutputCount that share each load of the filter.
+
+Arguments:
+
+    See MlasNchwcConvOutputs.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t OutputWidth = WorkBlock->OutputWidth;
+    const size_t OutputWidthStart = WorkBlock->OutputWidthStart;
+    const size_t OutputWidthEnd = WorkBlock->OutputWidthEnd;
+
+    size_t ow = 0;
+
+    for (; ow < OutputWidthStart; ow++) {
+        MlasNchwcConvOutputs<Vector, BlockSize, 1, FilterCount, true>(WorkBlock, Input, Filter,
+            Bias, Output + ow * BlockSize, oh, ow);
+    }
+
+    for (; ow + OutputCount <= OutputWidthEnd; ow += OutputCount) {
+        MlasNchwcConvOutputs<Vector, BlockSize, OutputCount, FilterCount, false>(WorkBlock, Input,
+            Filter, Bias, Output + ow * BlockSize, oh, ow);
+    }
+
+    for (; ow < OutputWidthEnd; ow++) {
+        MlasNchwcConvOutputs<Vector, BlockSize, 1, FilterCount, false>(WorkBlock, Input, Filter,
+            Bias, Output + ow * BlockSize, oh, ow);
+    }
+
+    for (; ow < OutputWidth; ow++) {
+        MlasNchwcConvOutputs<Vector, BlockSize, 1, FilterCount, true>(WorkBlock, Input, Filter,
+            Bias, Output + ow * BlockSize, oh, ow);
+    }
+}
+
+template<typename Vector, size_t BlockSize, size_t OutputCount>
+inline
+void
+MlasNchwcConvRow(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t FilterCount,
+    size_t oh
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of up to MLAS_NCHWC_FILTER_SET_SIZE output
+    channel blocks.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the address of the input image in NCHWc format.
+
+    Filter - Supplies the address of the filter for the first output channel
+        block.
+
+    Bias - Optionally supplies the address of the bias for the first output
+        channel block.
+
+    Output - Supplies the address of the output row of the first output
+        channel block.
+
+    FilterCount - Supplies the number of output channel blocks to compute.
+
+    oh - Supplies the output row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static_assert(MLAS_NCHWC_FILTER_SET_SIZE == 4, "unexpected filter set size");
+
+    switch (FilterCount) {
+        case 1:
+            MlasNchwcConvRowFilterSet<Vector, BlockSize, OutputCount, 1>(WorkBlock, Input,
+                Filter, Bias, Output, oh);
+            break;
+
+        case 2:
+            MlasNchwcConvRowFilterSet<Vector, BlockSize, OutputCount, 2>(WorkBlock, Input,
+                Filter, Bias, Output, oh);
+            break;
+
+        case 3:
+            MlasNchwcConvRowFilterSet<Vector, BlockSize, OutputCount, 3>(WorkBlock, Input,
+                Filter, Bias, Output, oh);
+            break;
+
+        default:
+            MlasNchwcConvRowFilterSet<Vector, BlockSize, OutputCount, 4>(WorkBlock, Input,
+                Filter, Bias, Output, oh);
+            break;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,73 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision convolution
+    operation using the NCHWc blocking format with AVX2 and FMA3 instructions.
+
+    This module must be compiled with AVX2 and FMA3 code generation enabled.
+
+--*/
+
+#include "snchwc.h"
+
+//
+// Define the vector operations for the eight element vector type.
+//
+
+struct MLAS_NCHWC_VECTOR_AVX2 {
+
+    typedef __m256 Type;
+
+    static constexpr size_t Lanes = 8;
+
+    static __m256 Zero() { return _mm256_setzero_ps(); }
+
+    static __m256 Load(const float* p) { return _mm256_loadu_ps(p); }
+
+    static void Store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+
+    static __m256 Broadcast(const float* p) { return _mm256_broadcast_ss(p); }
+
+    static __m256 MultiplyAdd(__m256 a, __m256 b, __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+};
+
+void
+MLASCALL
+MlasNchwcConvRowKernelAvx2(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t FilterCount,
+    size_t oh
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of a single output channel block. The block
+    size is eight channels.
+
+Arguments:
+
+    See MlasNchwcConvRowKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasNchwcConvRow<MLAS_NCHWC_VECTOR_AVX2, 8, 3>(WorkBlock, Input, Filter, Bias, Output,
+        FilterCount, oh);
+}
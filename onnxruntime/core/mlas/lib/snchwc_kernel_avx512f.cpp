@@ -0,0 +1,73 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision convolution
+    operation using the NCHWc blocking format with AVX512F instructions.
+
+    This module must be compiled with AVX512F code generation enabled.
+
+--*/
+
+#include "snchwc.h"
+
+//
+// Define the vector operations for the sixteen element vector type.
+//
+
+struct MLAS_NCHWC_VECTOR_AVX512F {
+
+    typedef __m512 Type;
+
+    static constexpr size_t Lanes = 16;
+
+    static __m512 Zero() { return _mm512_setzero_ps(); }
+
+    static __m512 Load(const float* p) { return _mm512_loadu_ps(p); }
+
+    static void Store(float* p, __m512 v) { _mm512_storeu_ps(p, v); }
+
+    static __m512 Broadcast(const float* p) { return _mm512_set1_ps(*p); }
+
+    static __m512 MultiplyAdd(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+void
+MLASCALL
+MlasNchwcConvRowKernelAvx512F(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t FilterCount,
+    size_t oh
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of a single output channel block. The block
+    size is sixteen channels.
+
+Arguments:
+
+    See MlasNchwcConvRowKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasNchwcConvRow<MLAS_NCHWC_VECTOR_AVX512F, 16, 6>(WorkBlock, Input, Filter, Bias, Output,
+        FilterCount, oh);
+}
@@ -16,6 +16,66 @@ Abstract:
 
 #include "mlasi.h"
 
+//
+// Stores the thread limit for operations started from the current thread.
+//
+
+thread_local int32_t MlasThreadLimit = 0;
+
+//
+// Stores the cancellation of operations started from the current thread.
+//
+
+thread_local const MLAS_CANCELLATION* MlasCancellation = nullptr;
+
+//
+// Define the parameters to execute threaded work that polls the cancellation
+// of the thread that started it before each iteration.
+//
+
+struct MLAS_CANCELLABLE_WORK_BLOCK {
+    PMLAS_THREADED_ROUTINE ThreadedRoutine;
+    void* Context;
+    const MLAS_CANCELLATION* Cancellation;
+};
+
+void
+MlasCancellableThreadedRoutine(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine executes one iteration of a batch of threaded work unless its
+    operation has been cancelled. The cancellation is applied to the executing
+    thread for the iteration, so the routine may poll it between blocks too.
+
+Arguments:
+
+    Context - Supplies the pointer to the parameters for the operation.
+
+    Index - Supplies the index of the iteration.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CANCELLABLE_WORK_BLOCK* WorkBlock = (MLAS_CANCELLABLE_WORK_BLOCK*)Context;
+
+    const MLAS_CANCELLATION* PreviousCancellation = MlasCancellation;
+    MlasCancellation = WorkBlock->Cancellation;
+
+    if (!MlasIsCancelled()) {
+        WorkBlock->ThreadedRoutine(WorkBlock->Context, Index);
+    }
+
+    MlasCancellation = PreviousCancellation;
+}
+
 #if defined(MLAS_USE_WIN32_THREADPOOL)
 
 //
@@ -76,6 +136,14 @@ MlasExecuteThreaded(
     int32_t Iterations
     )
 {
+    //
+    // Skip the work of an operation that has been cancelled.
+    //
+
+    if (MlasIsCancelled()) {
+        return;
+    }
+
     //
     // Execute the routine directly if only one iteration is specified.
     //
@@ -85,6 +153,29 @@ MlasExecuteThreaded(
         return;
     }
 
+    //
+    // Poll the cancellation before each of the iterations.
+    //
+
+    MLAS_CANCELLABLE_WORK_BLOCK CancellableWorkBlock;
+
+    if (MlasCancellation != nullptr) {
+        CancellableWorkBlock.ThreadedRoutine = ThreadedRoutine;
+        CancellableWorkBlock.Context = Context;
+        CancellableWorkBlock.Cancellation = MlasCancellation;
+        ThreadedRoutine = MlasCancellableThreadedRoutine;
+        Context = &CancellableWorkBlock;
+    }
+
+    //
+    // Use the thread pool supplied by the host if one has been registered.
+    //
+
+    if (MlasPlatform.ExecuteThreadedCallback != nullptr) {
+        MlasPlatform.ExecuteThreadedCallback(MlasPlatform.ThreadPool, ThreadedRoutine, Context, Iterations);
+        return;
+    }
+
 #if defined(MLAS_USE_WIN32_THREADPOOL)
 
     //
@@ -137,3 +228,153 @@ MlasExecuteThreaded(
         ThreadedRoutine(Context, tid);
     }
 }
+
+void
+MLASCALL
+MlasSetThreadPool(
+    PMLAS_EXECUTE_THREADED_CALLBACK ExecuteThreadedCallback,
+    void* ThreadPool,
+    int32_t MaximumThreadCount
+    )
+/*++
+
+Routine Description:
+
+    This routine registers a thread pool supplied by the host that is used to
+    execute all threaded work in place of the built in threading support.
+
+    The routine is not synchronized with operations that are in progress, so
+    it should be called before any other MLAS routine or once all operations
+    have completed.
+
+Arguments:
+
+    ExecuteThreadedCallback - Supplies the routine that executes the supplied
+        threaded routine for the specified number of iterations and returns
+        once all iterations have completed. Supply nullptr to revert to the
+        built in threading support.
+
+    ThreadPool - Supplies an opaque pointer passed to ExecuteThreadedCallback.
+
+    MaximumThreadCount - Supplies the maximum number of threads, including the
+        calling thread, that may execute iterations concurrently.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (MaximumThreadCount < 1) {
+        MaximumThreadCount = 1;
+    }
+
+    MlasPlatform.ExecuteThreadedCallback = ExecuteThreadedCallback;
+    MlasPlatform.ThreadPool = ThreadPool;
+    MlasPlatform.ThreadPoolMaximumThreadCount = MaximumThreadCount;
+}
+
+void
+MLASCALL
+MlasSetThreadLimit(
+    int32_t ThreadLimit
+    )
+/*++
+
+Routine Description:
+
+    This routine sets the maximum number of threads that operations started
+    from the calling thread may use. The limit only lowers the thread count
+    otherwise used by the library.
+
+Arguments:
+
+    ThreadLimit - Supplies the maximum number of threads, including the calling
+        thread. Supply zero to remove the limit.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasThreadLimit = (ThreadLimit > 0) ? ThreadLimit : 0;
+}
+
+int32_t
+MLASCALL
+MlasGetThreadLimit(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the thread limit set by MlasSetThreadLimit for the
+    calling thread.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the maximum number of threads for operations started from the
+    calling thread, or zero if there is no limit.
+
+--*/
+{
+    return MlasThreadLimit;
+}
+
+void
+MLASCALL
+MlasSetCancellation(
+    const MLAS_CANCELLATION* Cancellation
+    )
+/*++
+
+Routine Description:
+
+    This routine sets the cancellation of operations started from the calling
+    thread, which is polled between the blocks of their threaded work.
+
+Arguments:
+
+    Cancellation - Supplies the cancellation, which must remain valid until it
+        is replaced. Supply nullptr to remove the cancellation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasCancellation = Cancellation;
+}
+
+const MLAS_CANCELLATION*
+MLASCALL
+MlasGetCancellation(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the cancellation set by MlasSetCancellation for the
+    calling thread.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the cancellation of operations started from the calling thread, or
+    nullptr if there is none.
+
+--*/
+{
+    return MlasCancellation;
+}
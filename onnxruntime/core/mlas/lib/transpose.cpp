@@ -0,0 +1,319 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transpose.cpp
+
+Abstract:
+
+    This module implements the transpose of a batch of matrices of 32-bit
+    elements.
+
+    The matrices are transposed in tiles that keep the rows read from the
+    input and the rows written to the output in the cache, each tile by 4x4
+    blocks that are transposed in registers.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows and columns of a tile.
+//
+
+#define MLAS_TRANSPOSE_TILE_SIZE                    16
+
+//
+// Define the parameters to execute segments of a transpose operation on
+// worker threads.
+//
+
+struct MLAS_TRANSPOSE_WORK_BLOCK {
+    int32_t TargetThreadCount;
+    const uint32_t* Input;
+    uint32_t* Output;
+    size_t BatchCount;
+    size_t M;
+    size_t N;
+};
+
+inline
+void
+MlasTranspose4x4Block(
+    const uint32_t* Input,
+    size_t InputStride,
+    uint32_t* Output,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a 4x4 block of elements.
+
+Arguments:
+
+    Input - Supplies the first element of the block in the input.
+
+    InputStride - Supplies the number of elements between the rows of the
+        input.
+
+    Output - Supplies the first element of the block in the output.
+
+    OutputStride - Supplies the number of elements between the rows of the
+        output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    //
+    // The elements are only moved, so any 32-bit type may go through the
+    // single precision shuffles.
+    //
+
+    __m128 a = _mm_loadu_ps(reinterpret_cast<const float*>(&Input[InputStride * 0]));
+    __m128 b = _mm_loadu_ps(reinterpret_cast<const float*>(&Input[InputStride * 1]));
+    __m128 c = _mm_loadu_ps(reinterpret_cast<const float*>(&Input[InputStride * 2]));
+    __m128 d = _mm_loadu_ps(reinterpret_cast<const float*>(&Input[InputStride * 3]));
+
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+
+    _mm_storeu_ps(reinterpret_cast<float*>(&Output[OutputStride * 0]), a);
+    _mm_storeu_ps(reinterpret_cast<float*>(&Output[OutputStride * 1]), b);
+    _mm_storeu_ps(reinterpret_cast<float*>(&Output[OutputStride * 2]), c);
+    _mm_storeu_ps(reinterpret_cast<float*>(&Output[OutputStride * 3]), d);
+
+#elif defined(MLAS_NEON_INTRINSICS)
+
+    uint32x4_t a = vld1q_u32(&Input[InputStride * 0]);
+    uint32x4_t b = vld1q_u32(&Input[InputStride * 1]);
+    uint32x4_t c = vld1q_u32(&Input[InputStride * 2]);
+    uint32x4_t d = vld1q_u32(&Input[InputStride * 3]);
+
+    uint32x4x2_t ac = vzipq_u32(a, c);
+    uint32x4x2_t bd = vzipq_u32(b, d);
+    uint32x4x2_t low = vzipq_u32(ac.val[0], bd.val[0]);
+    uint32x4x2_t high = vzipq_u32(ac.val[1], bd.val[1]);
+
+    vst1q_u32(&Output[OutputStride * 0], low.val[0]);
+    vst1q_u32(&Output[OutputStride * 1], low.val[1]);
+    vst1q_u32(&Output[OutputStride * 2], high.val[0]);
+    vst1q_u32(&Output[OutputStride * 3], high.val[1]);
+
+#endif
+}
+
+void
+MlasTransposeTile(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N,
+    size_t RowCount,
+    size_t ColumnCount
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a tile of a matrix.
+
+Arguments:
+
+    Input - Supplies the first element of the tile in the input matrix.
+
+    Output - Supplies the first element of the tile in the output matrix.
+
+    M - Supplies the number of rows of the input matrix.
+
+    N - Supplies the number of columns of the input matrix.
+
+    RowCount - Supplies the number of rows of the tile.
+
+    ColumnCount - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t i = 0;
+
+    for (; i + 4 <= RowCount; i += 4) {
+
+        size_t j = 0;
+
+        for (; j + 4 <= ColumnCount; j += 4) {
+            MlasTranspose4x4Block(&Input[i * N + j], N, &Output[j * M + i], M);
+        }
+
+        for (; j < ColumnCount; j++) {
+            for (size_t k = 0; k < 4; k++) {
+                Output[j * M + i + k] = Input[(i + k) * N + j];
+            }
+        }
+    }
+
+    for (; i < RowCount; i++) {
+        for (size_t j = 0; j < ColumnCount; j++) {
+            Output[j * M + i] = Input[i * N + j];
+        }
+    }
+}
+
+void
+MlasTransposeThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    transpose operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_TRANSPOSE_WORK_BLOCK* WorkBlock = (MLAS_TRANSPOSE_WORK_BLOCK*)Context;
+
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+
+    //
+    // Partition the tiles of rows of the matrices across the threads.
+    //
+
+    const size_t RowTiles = (M + MLAS_TRANSPOSE_TILE_SIZE - 1) / MLAS_TRANSPOSE_TILE_SIZE;
+    const size_t TotalRowTiles = WorkBlock->BatchCount * RowTiles;
+
+    const size_t TilesPerThread = TotalRowTiles / WorkBlock->TargetThreadCount;
+    const size_t TilesExtra = TotalRowTiles % WorkBlock->TargetThreadCount;
+
+    size_t StartTile;
+    size_t CountTiles;
+
+    if (uint32_t(Index) < TilesExtra) {
+        StartTile = (TilesPerThread + 1) * Index;
+        CountTiles = TilesPerThread + 1;
+    } else {
+        StartTile = TilesPerThread * Index + TilesExtra;
+        CountTiles = TilesPerThread;
+    }
+
+    for (size_t t = StartTile; t < StartTile + CountTiles; t++) {
+
+        const size_t Batch = t / RowTiles;
+        const size_t Row = (t % RowTiles) * MLAS_TRANSPOSE_TILE_SIZE;
+        const size_t RowCount = std::min<size_t>(MLAS_TRANSPOSE_TILE_SIZE, M - Row);
+
+        const uint32_t* Input = WorkBlock->Input + Batch * M * N;
+        uint32_t* Output = WorkBlock->Output + Batch * M * N;
+
+        for (size_t Column = 0; Column < N; Column += MLAS_TRANSPOSE_TILE_SIZE) {
+
+            const size_t ColumnCount = std::min<size_t>(MLAS_TRANSPOSE_TILE_SIZE, N - Column);
+
+            MlasTransposeTile(&Input[Row * N + Column], &Output[Column * M + Row], M, N, RowCount, ColumnCount);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t BatchCount,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes each of a batch of matrices of 32-bit elements.
+
+Arguments:
+
+    Input - Supplies the input buffer, which holds BatchCount matrices of M
+        rows and N columns.
+
+    Output - Supplies the output buffer, which receives BatchCount matrices of
+        N rows and M columns. The buffer must not overlap the input buffer.
+
+    BatchCount - Supplies the number of matrices.
+
+    M - Supplies the number of rows of an input matrix.
+
+    N - Supplies the number of columns of an input matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_TRANSPOSE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.BatchCount = BatchCount;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Limit the number of threads to the number of tiles of rows.
+    //
+
+    const double Complexity = double(BatchCount) * double(M) * double(N);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_TRANSPOSE_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_TRANSPOSE_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    const size_t TotalRowTiles = BatchCount * ((M + MLAS_TRANSPOSE_TILE_SIZE - 1) / MLAS_TRANSPOSE_TILE_SIZE);
+
+    if (size_t(TargetThreadCount) >= TotalRowTiles) {
+        TargetThreadCount = int32_t(TotalRowTiles);
+    }
+
+    if (TargetThreadCount <= 1) {
+        TargetThreadCount = 1;
+    }
+
+    WorkBlock.TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasTransposeThreaded, &WorkBlock, TargetThreadCount);
+}
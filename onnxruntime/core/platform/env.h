@@ -109,9 +109,46 @@ class Env {
   virtual common::Status FileOpenWr(const std::string& path, /*out*/ int& fd) const = 0;
   //Mainly for use with protobuf library
   virtual common::Status FileClose(int fd) const = 0;
+
+  // the deleter unmaps the memory
+  using MappedMemoryPtr = std::unique_ptr<char[], std::function<void(char*)>>;
+
+  // Maps length bytes of the file at path, from offset on, read-only into memory. The pages are loaded on demand
+  // and shared with the file cache and with other processes that map the file. offset doesn't have to be a
+  // multiple of the page size.
+  virtual common::Status MapFileIntoMemory(const std::string& path, size_t offset, size_t length,
+                                           MappedMemoryPtr& mapped_memory) const = 0;
   //This functions is always successful. It can't fail.
   virtual PIDType GetSelfPid() const = 0;
 
+  // The number of NUMA nodes of the host, which are numbered from 0. 1 if the host isn't NUMA or they can't be
+  // determined.
+  virtual int GetNumaNodeCount() const { return 1; }
+
+  // The logical CPUs of a NUMA node, or none if they can't be determined.
+  virtual std::vector<int> GetNumaNodeCpus(int /*numa_node*/) const { return {}; }
+
+  // Restricts the calling thread to run on the given logical CPUs.
+  virtual common::Status SetCurrentThreadAffinity(const std::vector<int>& /*cpus*/) const {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Thread affinity is not supported on this platform.");
+  }
+
+  // Places the pages of size bytes from address on on the memory of a NUMA node, including the ones already touched.
+  // The pages only partially in the range are left as they are. The memory of other nodes is used once the node is
+  // out of memory.
+  virtual common::Status BindMemoryToNumaNode(void* /*address*/, size_t /*size*/, int /*numa_node*/) const {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "NUMA memory binding is not supported on this platform.");
+  }
+
+  // Allocates size bytes, rounded up to a multiple of the huge page size, on huge pages: explicit ones if any are
+  // available, otherwise pages the OS may back with transparent huge pages. The memory is aligned to the huge page
+  // size and zeroed. Returns nullptr if the platform has no such allocation, in which case the caller falls back to
+  // regular pages.
+  virtual void* AllocateHugePages(size_t /*size*/) const { return nullptr; }
+
+  // Frees memory returned by AllocateHugePages, given the size it was allocated with.
+  virtual void FreeHugePages(void* /*address*/, size_t /*size*/) const {}
+
   // \brief Load a dynamic library.
   //
   // Pass "library_filename" to a platform-specific mechanism for dynamically
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+// counts of hardware events, e.g. those of the thread that computed a node
+struct HardwareCounterValues {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t llc_misses = 0;   // last level cache read misses
+  uint64_t dtlb_misses = 0;  // data TLB read misses
+};
+
+inline HardwareCounterValues operator-(const HardwareCounterValues& end, const HardwareCounterValues& begin) {
+  HardwareCounterValues values;
+  values.cycles = end.cycles - begin.cycles;
+  values.instructions = end.instructions - begin.instructions;
+  values.llc_misses = end.llc_misses - begin.llc_misses;
+  values.dtlb_misses = end.dtlb_misses - begin.dtlb_misses;
+  return values;
+}
+
+/**
+ * The hardware performance counters of a thread, counted with perf_event on Linux in user mode only.
+ * They count the events of the thread itself, so the work a kernel hands to the threads of a thread pool is not
+ * included. An event the platform, the CPU or the perf_event_paranoid setting don't allow to count reads as 0.
+ */
+class HardwareCounters {
+ public:
+  // the counters of the calling thread, opened the first time the thread calls this
+  static const HardwareCounters& ForCurrentThread();
+
+  // false if none of the events can be counted
+  bool Available() const { return !events_.empty(); }
+
+  // the events counted on the thread since its counters were opened
+  HardwareCounterValues Read() const;
+
+  ~HardwareCounters();
+
+ private:
+  HardwareCounters();
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(HardwareCounters);
+
+  // the counters are opened as a group that is read at once, led by the first counter that could be opened
+  int group_fd_ = -1;
+  std::vector<int> fds_;
+  // the value each counter of the group is read into, in the order they joined it
+  std::vector<uint64_t HardwareCounterValues::*> events_;
+};
+
+}  // namespace onnxruntime
@@ -19,9 +19,17 @@ limitations under the License.
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <dlfcn.h>
+#include <sys/mman.h>
+#include <stdlib.h>
 #include <string.h>
+#include <fstream>
 #include <thread>
 #include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
 
 #include "core/platform/env.h"
 #include "core/common/common.h"
@@ -30,6 +38,43 @@ namespace onnxruntime {
 
 namespace {
 
+// Parses a list of the form "0-3,8,10-11" used by the sysfs files of the NUMA nodes. Returns false if it's malformed.
+bool ParseCpuList(const std::string& list, std::vector<int>& values) {
+  values.clear();
+  size_t pos = 0;
+  while (pos < list.size() && list[pos] != '\n') {
+    char* end;
+    long first = strtol(list.c_str() + pos, &end, 10);
+    if (end == list.c_str() + pos || first < 0) return false;
+    long last = first;
+    pos = end - list.c_str();
+    if (pos < list.size() && list[pos] == '-') {
+      last = strtol(list.c_str() + pos + 1, &end, 10);
+      if (end == list.c_str() + pos + 1 || last < first) return false;
+      pos = end - list.c_str();
+    }
+    for (long value = first; value <= last; ++value) {
+      values.push_back(static_cast<int>(value));
+    }
+    if (pos < list.size() && list[pos] == ',') ++pos;
+  }
+  return true;
+}
+
+#ifdef __linux__
+// the size of the huge pages of x86-64, and of arm64 with 4 KB pages
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+#endif
+
+bool ReadCpuListFile(const std::string& path, std::vector<int>& values) {
+  std::ifstream file(path);
+  std::string list;
+  if (!file || !std::getline(file, list)) {
+    return false;
+  }
+  return ParseCpuList(list, values);
+}
+
 class StdThread : public Thread {
  public:
   StdThread(std::function<void()> fn)
@@ -95,6 +140,122 @@ class PosixEnv : public Env {
     return getpid();
   }
 
+  int GetNumaNodeCount() const override {
+    std::vector<int> nodes;
+    if (!ReadCpuListFile("/sys/devices/system/node/online", nodes) || nodes.empty()) {
+      return 1;
+    }
+    return nodes.back() + 1;
+  }
+
+  std::vector<int> GetNumaNodeCpus(int numa_node) const override {
+    std::vector<int> cpus;
+    if (numa_node < 0 ||
+        !ReadCpuListFile("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist", cpus)) {
+      cpus.clear();
+    }
+    return cpus;
+  }
+
+  common::Status SetCurrentThreadAffinity(const std::vector<int>& cpus) const override {
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : cpus) {
+      if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid CPU ", cpu);
+      }
+      CPU_SET(cpu, &cpu_set);
+    }
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (result != 0) {
+      return common::Status(common::SYSTEM, result, MakeString("Failed to set the thread affinity: ", strerror(result)));
+    }
+    return Status::OK();
+#else
+    return Env::SetCurrentThreadAffinity(cpus);
+#endif
+  }
+
+  common::Status BindMemoryToNumaNode(void* address, size_t size, int numa_node) const override {
+#if defined(__linux__) && defined(SYS_mbind)
+    // the values of <numaif.h>, which is part of libnuma rather than of the C library
+    constexpr int kMpolPreferred = 1;
+    constexpr unsigned kMpolMfMove = 1 << 1;
+    constexpr int kNodeMaskBits = 8 * sizeof(unsigned long);
+    if (numa_node < 0 || numa_node >= kNodeMaskBits) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid NUMA node ", numa_node);
+    }
+
+    const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(address) + page_size - 1) & ~(page_size - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(address) + size) & ~(page_size - 1);
+    if (end <= begin) {
+      return Status::OK();
+    }
+
+    // the kernel reads one bit less than the count it's given
+    unsigned long node_mask = 1UL << numa_node;
+    if (syscall(SYS_mbind, begin, end - begin, kMpolPreferred, &node_mask, kNodeMaskBits + 1, kMpolMfMove) != 0) {
+      return common::Status(common::SYSTEM, errno, MakeString("Failed to bind memory to NUMA node ", numa_node, ": ",
+                                                              strerror(errno)));
+    }
+    return Status::OK();
+#else
+    return Env::BindMemoryToNumaNode(address, size, numa_node);
+#endif
+  }
+
+  void* AllocateHugePages(size_t size) const override {
+#ifdef __linux__
+    const size_t huge_page_size = kHugePageSize;
+    const size_t rounded_size = (size + huge_page_size - 1) & ~(huge_page_size - 1);
+    if (rounded_size == 0) {
+      return nullptr;
+    }
+
+    // explicit huge pages exist only if the administrator has reserved some
+    void* address = mmap(nullptr, rounded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                         -1, 0);
+    if (address != MAP_FAILED) {
+      return address;
+    }
+
+    // otherwise a range aligned to the huge page size, which the kernel backs with transparent huge pages if they're
+    // enabled. the unaligned ends of a larger mapping are unmapped.
+    char* mapping = static_cast<char*>(mmap(nullptr, rounded_size + huge_page_size, PROT_READ | PROT_WRITE,
+                                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (mapping == MAP_FAILED) {
+      return nullptr;
+    }
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(mapping);
+    const uintptr_t aligned = (begin + huge_page_size - 1) & ~(huge_page_size - 1);
+    char* aligned_mapping = reinterpret_cast<char*>(aligned);
+    if (aligned != begin) {
+      munmap(mapping, aligned - begin);
+    }
+    const size_t tail = huge_page_size - (aligned - begin);
+    if (tail != 0) {
+      munmap(aligned_mapping + rounded_size, tail);
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(aligned_mapping, rounded_size, MADV_HUGEPAGE);
+#endif
+    return aligned_mapping;
+#else
+    return Env::AllocateHugePages(size);
+#endif
+  }
+
+  void FreeHugePages(void* address, size_t size) const override {
+#ifdef __linux__
+    const size_t rounded_size = (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    munmap(address, rounded_size);
+#else
+    Env::FreeHugePages(address, size);
+#endif
+  }
+
   common::Status FileOpenRd(const std::string& path, /*out*/ int& fd) const override {
     fd = open(path.c_str(), O_RDONLY);
     if (0 > fd) {
@@ -119,6 +280,45 @@ class PosixEnv : public Env {
     return Status::OK();
   }
 
+  common::Status MapFileIntoMemory(const std::string& path, size_t offset, size_t length,
+                                   MappedMemoryPtr& mapped_memory) const override {
+    mapped_memory = MappedMemoryPtr(nullptr, [](char*) {});
+    if (length == 0) {
+      return Status::OK();
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (0 > fd) {
+      return common::Status(common::SYSTEM, errno, MakeString("Failed to open ", path, ": ", strerror(errno)));
+    }
+
+    // the pages past the end of the file can't be read
+    struct stat file_stat;
+    if (0 != fstat(fd, &file_stat) || static_cast<size_t>(file_stat.st_size) < offset ||
+        static_cast<size_t>(file_stat.st_size) - offset < length) {
+      close(fd);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The file ", path, " has no ", length,
+                             " bytes at offset ", offset);
+    }
+
+    // mmap takes an offset aligned to the page size
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t mapped_offset = offset - offset % page_size;
+    const size_t mapped_length = length + offset % page_size;
+    void* mapped_base = mmap(nullptr, mapped_length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(mapped_offset));
+    const int mmap_errno = errno;
+    close(fd);
+    if (mapped_base == MAP_FAILED) {
+      return common::Status(common::SYSTEM, mmap_errno,
+                            MakeString("Failed to map ", length, " bytes at offset ", offset, " of ", path, ": ",
+                                       strerror(mmap_errno)));
+    }
+
+    mapped_memory = MappedMemoryPtr(static_cast<char*>(mapped_base) + offset % page_size,
+                                    [mapped_base, mapped_length](char*) { munmap(mapped_base, mapped_length); });
+    return Status::OK();
+  }
+
   common::Status LoadDynamicLibrary(const std::string& library_filename, void** handle) const override {
     char* error_str = dlerror();  // clear any old error_str
     *handle = dlopen(library_filename.c_str(), RTLD_NOW | RTLD_LOCAL);
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/hardware_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace onnxruntime {
+
+#ifdef __linux__
+
+static int OpenCounter(uint32_t type, uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // user mode only, which a perf_event_paranoid of 2 still allows
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // the calling thread on any CPU
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+static constexpr uint64_t CacheReadMiss(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+HardwareCounters::HardwareCounters() {
+  struct Event {
+    uint32_t type;
+    uint64_t config;
+    uint64_t HardwareCounterValues::*value;
+  };
+  static const Event events[] = {
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, &HardwareCounterValues::cycles},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, &HardwareCounterValues::instructions},
+      {PERF_TYPE_HW_CACHE, CacheReadMiss(PERF_COUNT_HW_CACHE_LL), &HardwareCounterValues::llc_misses},
+      {PERF_TYPE_HW_CACHE, CacheReadMiss(PERF_COUNT_HW_CACHE_DTLB), &HardwareCounterValues::dtlb_misses},
+  };
+
+  for (const auto& event : events) {
+    const int fd = OpenCounter(event.type, event.config, group_fd_);
+    if (fd < 0) {
+      continue;
+    }
+    if (group_fd_ < 0) {
+      group_fd_ = fd;
+    }
+    fds_.push_back(fd);
+    events_.push_back(event.value);
+  }
+}
+
+HardwareCounters::~HardwareCounters() {
+  for (int fd : fds_) {
+    close(fd);
+  }
+}
+
+HardwareCounterValues HardwareCounters::Read() const {
+  HardwareCounterValues values;
+  if (events_.empty()) {
+    return values;
+  }
+
+  // the number of counters of the group, followed by their values
+  uint64_t buffer[1 + 4];
+  const ssize_t num_read = read(group_fd_, buffer, sizeof(buffer));
+  if (num_read < static_cast<ssize_t>(sizeof(uint64_t) * (1 + events_.size())) || buffer[0] != events_.size()) {
+    return values;
+  }
+  for (size_t i = 0; i < events_.size(); ++i) {
+    values.*events_[i] = buffer[1 + i];
+  }
+  return values;
+}
+
+#else
+
+HardwareCounters::HardwareCounters() = default;
+
+HardwareCounters::~HardwareCounters() = default;
+
+HardwareCounterValues HardwareCounters::Read() const {
+  return HardwareCounterValues{};
+}
+
+#endif
+
+const HardwareCounters& HardwareCounters::ForCurrentThread() {
+  static thread_local HardwareCounters counters;
+  return counters;
+}
+
+}  // namespace onnxruntime
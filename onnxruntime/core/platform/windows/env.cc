@@ -83,6 +83,20 @@ class WindowsEnv : public Env {
     return GetCurrentProcessId();
   }
 
+  void* AllocateHugePages(size_t size) const override {
+    // large pages require the SeLockMemoryPrivilege, without which the allocation fails
+    const size_t large_page_size = GetLargePageMinimum();
+    if (large_page_size == 0) {
+      return nullptr;
+    }
+    const size_t rounded_size = (size + large_page_size - 1) / large_page_size * large_page_size;
+    return VirtualAlloc(nullptr, rounded_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+  }
+
+  void FreeHugePages(void* address, size_t /*size*/) const override {
+    VirtualFree(address, 0, MEM_RELEASE);
+  }
+
   EnvThread* CreateThread(std::function<void()> fn) const override {
     return new StdThread(fn);
   }
@@ -134,6 +148,55 @@ class WindowsEnv : public Env {
     return Status::OK();
   }
 
+  common::Status MapFileIntoMemory(const std::string& path, size_t offset, size_t length,
+                                   MappedMemoryPtr& mapped_memory) const override {
+    mapped_memory = MappedMemoryPtr(nullptr, [](char*) {});
+    if (length == 0) {
+      return Status::OK();
+    }
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_READONLY, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      return common::Status(common::SYSTEM, static_cast<int>(GetLastError()), MakeString("Failed to open ", path));
+    }
+
+    // the pages past the end of the file can't be read
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || static_cast<uint64_t>(file_size.QuadPart) < offset ||
+        static_cast<uint64_t>(file_size.QuadPart) - offset < length) {
+      CloseHandle(file);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The file ", path, " has no ", length,
+                             " bytes at offset ", offset);
+    }
+    HANDLE file_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const DWORD mapping_error = GetLastError();
+    CloseHandle(file);
+    if (file_mapping == nullptr) {
+      return common::Status(common::SYSTEM, static_cast<int>(mapping_error), MakeString("Failed to map ", path));
+    }
+
+    // MapViewOfFile takes an offset aligned to the allocation granularity
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    const size_t granularity = static_cast<size_t>(system_info.dwAllocationGranularity);
+    const uint64_t mapped_offset = offset - offset % granularity;
+    const size_t mapped_length = length + offset % granularity;
+    void* mapped_base = MapViewOfFile(file_mapping, FILE_MAP_READ, static_cast<DWORD>(mapped_offset >> 32),
+                                      static_cast<DWORD>(mapped_offset & 0xFFFFFFFF), mapped_length);
+    const DWORD view_error = GetLastError();
+    // the view keeps the mapping alive
+    CloseHandle(file_mapping);
+    if (mapped_base == nullptr) {
+      return common::Status(common::SYSTEM, static_cast<int>(view_error),
+                            MakeString("Failed to map ", length, " bytes at offset ", offset, " of ", path));
+    }
+
+    mapped_memory = MappedMemoryPtr(static_cast<char*>(mapped_base) + offset % granularity,
+                                    [mapped_base](char*) { UnmapViewOfFile(mapped_base); });
+    return Status::OK();
+  }
+
   virtual Status LoadDynamicLibrary(const std::string& library_filename, void** handle) const override {
     *handle = ::LoadLibraryA(library_filename.c_str());
     if (!handle)
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/hardware_counters.h"
+
+namespace onnxruntime {
+
+// the counters of a thread aren't available to user mode on Windows, so none of the events are counted
+
+HardwareCounters::HardwareCounters() = default;
+
+HardwareCounters::~HardwareCounters() = default;
+
+HardwareCounterValues HardwareCounters::Read() const {
+  return HardwareCounterValues{};
+}
+
+const HardwareCounters& HardwareCounters::ForCurrentThread() {
+  static thread_local HardwareCounters counters;
+  return counters;
+}
+
+}  // namespace onnxruntime
@@ -3,6 +3,9 @@
 
 #include "core/providers/cpu/controlflow/if.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "core/framework/execution_frame.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -70,6 +73,9 @@ class IfImpl {
  private:
   Status AllocateOutputTensors();
 
+  // set If output 'index' to the subgraph initializer in 'value'
+  Status SetOutputFromInitializer(int index, const MLValue& value);
+
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
   const GraphViewer& subgraph_;
@@ -80,7 +86,8 @@ class IfImpl {
 
   enum class AllocationType {
     Delayed,  // allocation of If output will be done by subgraph execution
-    IfOutput
+    IfOutput,
+    Initializer  // subgraph output is an initializer of the subgraph, which the If output will share if it can
   };
 
   // track where the fetches provided to subgraph execution were allocated.
@@ -142,7 +149,18 @@ Status IfImpl::AllocateOutputTensors() {
   Status status = Status::OK();
   int index = 0;
 
+  auto& mlvalue_name_idx_map = session_state_.GetMLValueNameIdxMap();
+  auto& initializers = session_state_.GetInitializedTensors();
+
   for (auto& graph_output : subgraph_.GetOutputs()) {
+    // no node of the subgraph writes a constant output, so there's nothing to allocate for it
+    int mlvalue_idx;
+    if (mlvalue_name_idx_map.GetIdx(graph_output->Name(), mlvalue_idx).IsOK() && initializers.count(mlvalue_idx)) {
+      outputs_.push_back({AllocationType::Initializer, {}});
+      ++index;
+      continue;
+    }
+
     auto* graph_output_shape = graph_output->Shape();
     if (!graph_output_shape) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Subgraph must have the shape set for all outputs but ",
@@ -217,10 +235,47 @@ Status IfImpl::Execute() {
   }
 
   status = utils::ExecuteGraph(session_state_, feeds, subgraph_output_names_, fetches, fetch_allocators,
-                               /*sequential_execution*/ true, context_.GetTerminateFlag(), context_.Logger());
+                               /*sequential_execution*/ true, context_.GetTermination(), context_.Logger());
   ORT_RETURN_IF_ERROR(status);
 
+  // the subgraph wrote every other output straight to the If output
+  for (int i = 0; i < num_outputs_; ++i) {
+    if (outputs_[i].first == AllocationType::Initializer) {
+      ORT_RETURN_IF_ERROR(SetOutputFromInitializer(i, fetches[i]));
+    }
+  }
+
   return status;
 }
 
+Status IfImpl::SetOutputFromInitializer(int index, const MLValue& value) {
+  MLValue* output = context_.GetOutputMLValue(index);
+  if (output == nullptr) {
+    // unused optional output
+    return Status::OK();
+  }
+
+  // hand the initializer to the parent graph unless the output was already allocated, e.g. by the caller of a
+  // Run that provided it, or the buffer of the output is going to be written by another node
+  if (!output->IsAllocated() && context_.OutputBufferIsShareable(index)) {
+    *output = value;
+    return Status::OK();
+  }
+
+  const auto& source = value.Get<Tensor>();
+  auto* target = context_.Output(index, source.Shape());
+  if (!target) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create output tensor for If output ", index);
+  }
+
+  if (source.DataType() == DataTypeImpl::GetType<std::string>()) {
+    const auto* source_strings = source.Data<std::string>();
+    std::copy(source_strings, source_strings + source.Shape().Size(), target->MutableData<std::string>());
+  } else {
+    memcpy(target->MutableDataRaw(), source.DataRaw(), source.Size());
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -11,6 +11,7 @@
 
 #include "core/providers/cpu/controlflow/loop.h"
 
+#include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/sequential_executor.h"
@@ -99,8 +100,8 @@ class LoopImpl {
   Status Execute();
 
  private:
-  NameMLValMap CreateInitialFeeds();
-  void UpdateFeeds(const std::vector<MLValue>& last_output, NameMLValMap& next_input);
+  std::vector<MLValue> CreateInitialFeeds();
+  void UpdateFeeds(const std::vector<MLValue>& last_output, std::vector<MLValue>& next_input);
 
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<MLValue>& per_iteration_output, int output_index);
@@ -121,9 +122,13 @@ class LoopImpl {
   MLValue iter_num_mlvalue_;
   MLValue condition_mlvalue_;
 
-  std::vector<std::string> subgraph_input_names_;
+  // the subgraph inputs followed by the implicit inputs, in the order of the feeds for every iteration
+  std::vector<std::string> feed_names_;
   std::vector<std::string> subgraph_output_names_;
 
+  // the feeds and fetches of the subgraph resolved once for all the iterations
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+
   // collection of MLValue outputs from each loop iteration for the loop outputs.
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<MLValue>> loop_output_tensors_;
@@ -208,9 +213,13 @@ Status LoopImpl::Initialize() {
   condition_mlvalue_ = MakeScalarMLValue<bool>(allocator, condition_);
   iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(allocator, 0);
 
-  subgraph_input_names_.reserve(num_subgraph_inputs_);
+  feed_names_.reserve(num_subgraph_inputs_ + implicit_inputs_.size());
   for (size_t i = 0; i < num_subgraph_inputs_; ++i) {
-    subgraph_input_names_.push_back(subgraph_inputs[i]->Name());
+    feed_names_.push_back(subgraph_inputs[i]->Name());
+  }
+
+  for (auto& entry : implicit_inputs_) {
+    feed_names_.push_back(entry.first);
   }
 
   subgraph_output_names_.reserve(num_subgraph_outputs);
@@ -223,39 +232,41 @@ Status LoopImpl::Initialize() {
     subgraph_output_names_.push_back(output->Name());
   }
 
+  status = FeedsFetchesManager::Create(feed_names_, subgraph_output_names_, session_state_, feeds_fetches_manager_);
+
   return status;
 }
 
-NameMLValMap LoopImpl::CreateInitialFeeds() {
-  NameMLValMap feeds;
+std::vector<MLValue> LoopImpl::CreateInitialFeeds() {
+  std::vector<MLValue> feeds;
 
-  feeds.reserve(num_subgraph_inputs_ + implicit_inputs_.size());
+  feeds.reserve(feed_names_.size());
 
-  feeds[subgraph_input_names_[0]] = iter_num_mlvalue_;
-  feeds[subgraph_input_names_[1]] = condition_mlvalue_;
+  feeds.push_back(iter_num_mlvalue_);
+  feeds.push_back(condition_mlvalue_);
 
   // populate loop carried var inputs which conveniently start at slot 2 in both the Loop and subgraph inputs
   for (int i = 2; i < num_subgraph_inputs_; ++i) {
-    feeds[subgraph_input_names_[i]] = *context_.GetInputMLValue(i);
+    feeds.push_back(*context_.GetInputMLValue(i));
   }
 
-  // pass in implicit inputs as feeds.
+  // pass in implicit inputs as feeds, in the order they were added to feed_names_.
   for (auto& entry : implicit_inputs_) {
     ORT_ENFORCE(entry.second, "All implicit inputs should have MLValue instances by now. ",
                 entry.first, " did not.");
-    feeds[entry.first] = *entry.second;
+    feeds.push_back(*entry.second);
   }
 
   return feeds;
 }
 
-void LoopImpl::UpdateFeeds(const std::vector<MLValue>& last_output, NameMLValMap& next_input) {
+void LoopImpl::UpdateFeeds(const std::vector<MLValue>& last_output, std::vector<MLValue>& next_input) {
   // last_output: cond, loop vars..., loop output...
-  // next_input: iter_num, cond, loop_vars. iter_num is re-used
+  // next_input: iter_num, cond, loop_vars, implicit inputs. iter_num and the implicit inputs are re-used
 
-  // simple copy for cond and loop carried vars.
+  // the loop carried vars are passed on by reference, so their data isn't copied.
   for (int i = 1; i < num_subgraph_inputs_; ++i) {
-    next_input[subgraph_input_names_[i]] = last_output[i - 1];  // skip iter_num in input
+    next_input[i] = last_output[i - 1];  // skip iter_num in input
   }
 
   // save loop outputs as we have to concatenate at the end
@@ -305,12 +316,15 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<MLValue>& per_iteration_outpu
 Status LoopImpl::Execute() {
   auto status = Status::OK();
 
-  NameMLValMap feeds{CreateInitialFeeds()};
+  std::vector<MLValue> feeds{CreateInitialFeeds()};
   std::vector<MLValue> fetches;
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
+    // stop between the iterations once the Run terminates, even if the subgraph has no nodes
+    ORT_RETURN_IF_ERROR(context_.GetTermination().Check());
+
     if (iter_num_value != 0) {
       UpdateFeeds(fetches, feeds);
       fetches.clear();
@@ -319,8 +333,8 @@ Status LoopImpl::Execute() {
     // loop carried variables can change shape across iterations, and we don't know how many iterations
     // there will be to allocate loop outputs upfront. due to that we can't use a custom fetch allocator
     // for any outputs
-    status = utils::ExecuteGraph(session_state_, feeds, subgraph_output_names_, fetches, {},
-                                 /*sequential_execution*/ true, context_.GetTerminateFlag(), context_.Logger());
+    status = utils::ExecuteGraph(session_state_, *feeds_fetches_manager_, feeds, fetches, {},
+                                 /*sequential_execution*/ true, context_.GetTermination(), context_.Logger());
     ORT_RETURN_IF_ERROR(status);
 
     condition_mlvalue_ = fetches[0];
@@ -356,7 +370,7 @@ Status LoopImpl::Execute() {
     // no iterations.
     // copy input loop carried vars to output.
     for (int i = 0; i < num_loop_carried_vars_; ++i) {
-      copy_tensor_from_mlvalue_to_output(feeds[subgraph_input_names_[i + 2]], i);  // skip iter# and cond
+      copy_tensor_from_mlvalue_to_output(feeds[i + 2], i);  // skip iter# and cond
     }
 
     // create empty outputs for loop outputs
@@ -11,6 +11,8 @@
 #include "core/providers/cpu/controlflow/scan.h"
 #include "core/providers/cpu/controlflow/scan_utils.h"
 
+#include "core/common/task_thread_pool.h"
+#include "core/framework/environment.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/session_state.h"
@@ -105,6 +107,10 @@ class Scan8Impl {
   Status AllocateOutputTensors();
   Status CreateLoopStateVariables(std::vector<std::vector<LoopStateVariable>>& loop_state_variables);
 
+  // run the subgraph over the sequence of batch entry b
+  Status ExecuteBatch(int64_t b, std::vector<LoopStateVariable>& loop_state_variables,
+                      std::vector<std::unique_ptr<OutputIterator>>& output_iterators);
+
   using ConstTensorSlicerIterators = std::vector<MLValueTensorSlicer<const MLValue>::Iterator>;
   using MutableTensorSlicerIterators = std::vector<MLValueTensorSlicer<MLValue>::Iterator>;
 
@@ -150,10 +156,6 @@ Status Scan<8>::Compute(OpKernelContext* ctx) const {
   auto* session_state = ctx_internal->SubgraphSessionState("body");
   ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'body' attribute.");
 
-  // TODO:
-  //       Consider how usage of ExecutionFrame and SequentialExecutor can be optimized
-  //         - initial implementation is focused on making it work, rather than optimizing.
-
   Scan8Impl scan_impl{*ctx_internal, *session_state, num_scan_inputs_, input_directions_};
 
   auto status = scan_impl.Initialize();
@@ -376,6 +378,50 @@ Status Scan8Impl::CreateLoopStateVariables(std::vector<std::vector<LoopStateVari
   return status;
 }
 
+Status Scan8Impl::ExecuteBatch(int64_t b, std::vector<LoopStateVariable>& loop_state_variables,
+                               std::vector<std::unique_ptr<OutputIterator>>& output_iterators) {
+  auto sequence_len = sequence_lens_[b];
+
+  // Setup input MLValue streams
+  std::vector<MLValueTensorSlicer<const MLValue>::Iterator> scan_input_stream_iterators;
+  scan_input_stream_iterators.reserve(num_variadic_inputs_ - num_loop_state_variables_);
+
+  for (int i = num_loop_state_variables_, end = num_variadic_inputs_; i < end; ++i) {
+    const auto& mlvalue = GetSubgraphInputMLValue(context_, i);
+
+    // forward
+    if (directions_[i - num_loop_state_variables_] == static_cast<int64_t>(ScanDirection::kForward)) {
+      // the iterator is self contained, so we don't need to keep the MLValueTensorSlicer instance around
+      scan_input_stream_iterators.push_back(MLValueTensorSlicer<const MLValue>::Create(mlvalue, 1, b).begin());
+    } else {  // reverse
+      scan_input_stream_iterators.push_back(MLValueTensorSlicer<const MLValue>::Create(mlvalue, 1, b).rbegin());
+      // need to skip past the empty entries at the end of the input if sequence length is short
+      auto offset = max_sequence_len_ - sequence_len;
+      if (offset > 0) {
+        // reverse iterator so += moves backwards through the input
+        scan_input_stream_iterators.back() += offset;
+      }
+    }
+  }
+
+  // Call the subgraph for each item in the sequence
+  auto status = IterateSequence(context_, session_state_, subgraph_, loop_state_variables,
+                                scan_input_stream_iterators, sequence_len, num_loop_state_variables_,
+                                num_variadic_inputs_, num_variadic_outputs_, implicit_inputs_,
+                                subgraph_output_names_, output_iterators);
+
+  // zero out any remaining values in the sequence
+  for (int64_t i = sequence_len; i < max_sequence_len_; ++i) {
+    for (int output = num_loop_state_variables_; output < num_variadic_outputs_; ++output) {
+      auto& iterator = *output_iterators[output];
+      iterator.ZeroOutCurrent();
+      ++iterator;
+    }
+  }
+
+  return status;
+}
+
 Status Scan8Impl::Execute() {
   Status status = Status::OK();
 
@@ -384,47 +430,53 @@ Status Scan8Impl::Execute() {
   status = CreateLoopStateVariables(batch_loop_state_variables);
   ORT_RETURN_IF_ERROR(status);
 
-  for (int64_t b = 0; b < batch_size_; ++b) {
-    auto sequence_len = sequence_lens_[b];
-
-    // Setup input MLValue streams
-    std::vector<MLValueTensorSlicer<const MLValue>::Iterator> scan_input_stream_iterators;
-    scan_input_stream_iterators.reserve(num_variadic_inputs_ - num_loop_state_variables_);
-
-    for (int i = num_loop_state_variables_, end = num_variadic_inputs_; i < end; ++i) {
-      const auto& mlvalue = GetSubgraphInputMLValue(context_, i);
-
-      // forward
-      if (directions_[i - num_loop_state_variables_] == static_cast<int64_t>(ScanDirection::kForward)) {
-        // the iterator is self contained, so we don't need to keep the MLValueTensorSlicer instance around
-        scan_input_stream_iterators.push_back(MLValueTensorSlicer<const MLValue>::Create(mlvalue, 1, b).begin());
-      } else {  // reverse
-        scan_input_stream_iterators.push_back(MLValueTensorSlicer<const MLValue>::Create(mlvalue, 1, b).rbegin());
-        // need to skip past the empty entries at the end of the input if sequence length is short
-        auto offset = max_sequence_len_ - sequence_len;
-        if (offset > 0) {
-          // reverse iterator so += moves backwards through the input
-          scan_input_stream_iterators.back() += offset;
-        }
-      }
+  if (batch_size_ <= 0) {
+    return status;
+  }
+
+  // the first batch entry allocates the scan outputs that have a symbolic dimension in the subgraph, so it
+  // runs on its own. every batch entry after that writes to its own slice of the outputs.
+  status = ExecuteBatch(0, batch_loop_state_variables[0], output_iterators_);
+  ORT_RETURN_IF_ERROR(status);
+
+  if (batch_size_ < 2) {
+    return status;
+  }
+
+  // the loop state variables were sliced by CreateLoopStateVariables so only the scan outputs need an iterator
+  // for each batch entry
+  std::vector<std::vector<std::unique_ptr<OutputIterator>>> batch_output_iterators(batch_size_);
+  for (int64_t b = 1; b < batch_size_; ++b) {
+    auto& output_iterators = batch_output_iterators[b];
+    output_iterators.resize(num_variadic_outputs_);
+    for (int output = num_loop_state_variables_; output < num_variadic_outputs_; ++output) {
+      ORT_RETURN_IF_ERROR(output_iterators_[output]->CreateBatchIterator(b, output_iterators[output]));
     }
+  }
 
-    // Call the subgraph for each item in the sequence
-    status = IterateSequence(context_, session_state_, subgraph_, batch_loop_state_variables[b],
-                             scan_input_stream_iterators, sequence_len, num_loop_state_variables_,
-                             num_variadic_inputs_, num_variadic_outputs_, implicit_inputs_,
-                             subgraph_output_names_, output_iterators_);
-
-    // zero out any remaining values in the sequence
-    for (int64_t i = sequence_len; i < max_sequence_len_; ++i) {
-      for (int output = num_loop_state_variables_; output < num_variadic_outputs_; ++output) {
-        auto& iterator = *output_iterators_[output];
-        iterator.ZeroOutCurrent();
-        ++iterator;
-      }
+  // the batch entries are independent, so they are processed on the intra-op thread pool if there is one.
+  // a task of the pool must not throw, so every batch entry returns its error in a Status.
+  std::vector<Status> statuses(batch_size_);
+  auto execute_batch = [this, &batch_loop_state_variables, &batch_output_iterators, &statuses](int64_t b) {
+    try {
+      statuses[b] = ExecuteBatch(b, batch_loop_state_variables[b], batch_output_iterators[b]);
+    } catch (const std::exception& ex) {
+      statuses[b] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
     }
+  };
 
-    ORT_RETURN_IF_ERROR(status);
+  TaskThreadPool* pool = Environment::GetIntraOpThreadPool();
+  if (pool == nullptr) {
+    for (int64_t b = 1; b < batch_size_; ++b) {
+      execute_batch(b);
+    }
+  } else {
+    pool->ParallelFor(gsl::narrow<int32_t>(batch_size_ - 1),
+                      [&execute_batch](int32_t i) { execute_batch(static_cast<int64_t>(i) + 1); });
+  }
+
+  for (auto& batch_status : statuses) {
+    ORT_RETURN_IF_ERROR(batch_status);
   }
 
   return status;
@@ -13,6 +13,7 @@
 
 #include "gsl/gsl_algorithm"
 
+#include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/sequential_executor.h"
@@ -120,31 +121,46 @@ Status IterateSequence(OpKernelContextInternal& context,
                 "num_variadic_inputs matched the subgraph inputs or required inputs.");
   }
 
-  NameMLValMap feeds;
+  // the feeds are the subgraph inputs followed by the implicit inputs.
+  // the ordering of the Scan inputs should match the ordering of the subgraph inputs.
+  std::vector<std::string> feed_names;
+  std::vector<MLValue> feeds;
   std::vector<MLValue> fetches;
   std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  feed_names.reserve(num_variadic_inputs + implicit_inputs.size());
+  feeds.resize(num_variadic_inputs);
   feeds.reserve(num_variadic_inputs + implicit_inputs.size());
   fetches.resize(num_variadic_outputs);
 
+  for (int input = 0; input < num_variadic_inputs; ++input) {
+    feed_names.push_back((*graph_inputs)[input]->Name());
+  }
+
   // pass in implicit inputs as feeds.
   for (auto& entry : implicit_inputs) {
     ORT_ENFORCE(entry.second, "All implicit inputs should have MLValue instances by now. ", entry.first, " did not.");
-    feeds[entry.first] = *entry.second;
+    feed_names.push_back(entry.first);
+    feeds.push_back(*entry.second);
   }
 
+  // resolve the feeds and fetches once for all the iterations
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+  ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, subgraph_output_names, session_state,
+                                                  feeds_fetches_manager));
+
   int64_t seq_no = 0;
   for (; seq_no < seq_length; ++seq_no) {
-    for (int input = 0; input < num_variadic_inputs; ++input) {
-      // the ordering of the Scan inputs should match the ordering of the subgraph inputs
-      auto name = (*graph_inputs)[input]->Name();
+    // stop between the iterations once the Run terminates, even if the subgraph has no nodes
+    ORT_RETURN_IF_ERROR(context.GetTermination().Check());
 
+    for (int input = 0; input < num_variadic_inputs; ++input) {
       if (input < num_loop_state_variables) {
         // add loop state variable input
-        feeds[name] = loop_state_variables[input].Input();
+        feeds[input] = loop_state_variables[input].Input();
       } else {
         // add sliced input
         auto& iterator = scan_input_stream_iterators[input - num_loop_state_variables];
-        feeds[name] = *iterator;
+        feeds[input] = *iterator;
 
         ++iterator;
       }
@@ -178,8 +194,8 @@ Status IterateSequence(OpKernelContextInternal& context,
     }
 
     // Create Executor and run graph.
-    status = utils::ExecuteGraph(session_state, feeds, subgraph_output_names, fetches, fetch_allocators,
-                                 /*sequential_execution*/ true, context.GetTerminateFlag(), context.Logger());
+    status = utils::ExecuteGraph(session_state, *feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                                 /*sequential_execution*/ true, context.GetTermination(), context.Logger());
     ORT_RETURN_IF_ERROR(status);
 
     // cycle the LoopStateVariable input/output in preparation for the next iteration
@@ -448,6 +464,27 @@ Status OutputIterator::AllocateSubgraphOutput(const TensorShape& shape, MLValue&
   return Status::OK();
 }
 
+Status OutputIterator::CreateBatchIterator(int64_t batch, std::unique_ptr<OutputIterator>& iterator) const {
+  ORT_ENFORCE(is_v8_ && !is_loop_state_var_, "Only the v8 scan outputs have a slice per batch entry.");
+  ORT_ENFORCE(is_concrete_shape_, "The final output must be allocated before iterating a batch entry.");
+
+  if (batch < 0 || batch >= final_shape_[0]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Batch entry ", batch, " is not in the output with shape ",
+                           final_shape_);
+  }
+
+  // the copy shares the final output. it gets the slicer of the batch entry, and iterates over its sequence only.
+  iterator.reset(new OutputIterator(*this));
+  auto& batch_iterator = *iterator;
+
+  batch_iterator.slicer_iterators_.assign(1, slicer_iterators_[batch]);
+  batch_iterator.cur_slicer_iterator_ = batch_iterator.slicer_iterators_.begin();
+  batch_iterator.cur_iteration_ = batch * final_shape_[1];
+  batch_iterator.num_iterations_ = batch_iterator.cur_iteration_ + final_shape_[1];
+
+  return Status::OK();
+}
+
 MLValue& OutputIterator::operator*() {
   ORT_ENFORCE(cur_iteration_ < num_iterations_);
   ORT_ENFORCE(is_concrete_shape_,
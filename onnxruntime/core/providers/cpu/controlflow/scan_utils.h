@@ -86,6 +86,10 @@ class OutputIterator {
     return iterator->Initialize();
   }
 
+  // create an iterator over the slice of a v8 scan output for one batch entry, so the batch entries can be
+  // processed concurrently. the final output must have been allocated.
+  Status CreateBatchIterator(int64_t batch, std::unique_ptr<OutputIterator>& iterator) const;
+
   MLValue& operator*();
   OutputIterator& operator++();
 
@@ -13,9 +13,14 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
-
-  explicit CPUExecutionProviderInfo(bool use_arena)
-      : create_arena(use_arena) {}
+  ArenaConfig arena_config;
+  // the NUMA node the memory is allocated on, or -1 for any
+  int numa_node{-1};
+  // whether the blocks of at least a huge page, such as the regions of the arena, are allocated on huge pages
+  bool use_huge_pages{false};
+
+  explicit CPUExecutionProviderInfo(bool use_arena, const ArenaConfig& config = ArenaConfig())
+      : create_arena(use_arena), arena_config(config) {}
   CPUExecutionProviderInfo() = default;
 };
 
@@ -25,7 +30,19 @@ using FuseRuleFn = std::function<void(const onnxruntime::GraphViewer&, std::vect
 class CPUExecutionProvider : public IExecutionProvider {
  public:
   explicit CPUExecutionProvider(const CPUExecutionProviderInfo& info) {
-    DeviceAllocatorRegistrationInfo device_info({OrtMemTypeDefault, [](int) { return std::make_unique<CPUAllocator>(); }, std::numeric_limits<size_t>::max()});
+    const int numa_node = info.numa_node;
+    const bool use_huge_pages = info.use_huge_pages;
+    DeviceAllocatorRegistrationInfo device_info({OrtMemTypeDefault,
+                                                 [numa_node, use_huge_pages](int) -> std::unique_ptr<IDeviceAllocator> {
+                                                   if (use_huge_pages) {
+                                                     return std::make_unique<HugePageCPUAllocator>(numa_node);
+                                                   }
+                                                   if (numa_node >= 0) {
+                                                     return std::make_unique<NumaCPUAllocator>(numa_node);
+                                                   }
+                                                   return std::make_unique<CPUAllocator>();
+                                                 },
+                                                 std::numeric_limits<size_t>::max()});
 #ifdef USE_JEMALLOC
     ORT_UNUSED_PARAMETER(info);
     //JEMalloc already has memory pool, so just use device allocator.
@@ -34,7 +51,7 @@ class CPUExecutionProvider : public IExecutionProvider {
             std::make_unique<DummyArena>(device_info.factory(0))));
 #else
     if (info.create_arena)
-      InsertAllocator(CreateAllocator(device_info));
+      InsertAllocator(CreateAllocator(device_info, 0, info.arena_config));
     else
       InsertAllocator(
           std::shared_ptr<IArenaAllocator>(
@@ -2,7 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/element_wise_ops.h"
-#include <unsupported/Eigen/SpecialFunctions>
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
 
@@ -10,99 +11,99 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Add,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Add<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Add,
     7,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
     Add<int32_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Add,
     7,
     int64_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
     Add<int64_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sub,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sub<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sub,
     7,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
     Sub<int32_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sub,
     7,
     int64_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
     Sub<int64_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Mul,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Mul<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Mul,
     7,
     double,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Mul<double>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Mul,
     7,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
     Mul<int32_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Mul,
     7,
     int64_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
     Mul<int64_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Div,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Div<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Div,
     7,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
     Div<int32_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Div,
     7,
     int64_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()),
     Div<int64_t>);
 
-#define REG_ABS_KERNEL(TYPE)                                                       \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
-      Abs,                                                                         \
-      6,                                                                           \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+#define REG_ABS_KERNEL(TYPE)                                                                        \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                                   \
+      Abs,                                                                                          \
+      6,                                                                                            \
+      TYPE,                                                                                         \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       Abs<TYPE>);
 
 REG_ABS_KERNEL(float)
@@ -120,123 +121,123 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Neg,
     6,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Neg<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Neg,
     6,
     int8_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int8_t>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int8_t>()),
     Neg<int8_t>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Neg,
     6,
     int32_t,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
     Neg<int32_t>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Floor,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Floor<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Ceil,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Ceil<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Reciprocal,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Reciprocal<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Sqrt,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sqrt<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Pow,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Pow<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Exp,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Exp<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Log,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Log<float>);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Sum,
     6, 7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sum_6<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Sum,
     8,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sum_8<float>);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Min,
     6, 7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Min_6<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Min,
     8,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Min_8<float>);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Max,
     6, 7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Max_6<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Max,
     8,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Max_8<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Not,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<bool>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<bool>()),
     Not);
 
 ONNX_CPU_OPERATOR_KERNEL(
     And,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<bool>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<bool>()),
     And);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Or,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<bool>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<bool>()),
     Or);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Xor,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<bool>()),
+    KernelDefBuilder().MayInplace(0, 0).MayInplace(1, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<bool>()),
     Xor);
 
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
@@ -291,31 +292,31 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Mean,
     6, 7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Mean_6<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Mean,
     8,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Mean_8<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Affine,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Affine<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Scale,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Scale<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Erf,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Erf<float>);
 
 template <typename T>
@@ -685,7 +686,7 @@ class Sin final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Sin,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sin<float>);
 
 template <typename T>
@@ -705,7 +706,7 @@ class Cos final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Cos,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Cos<float>);
 
 template <typename T>
@@ -725,7 +726,7 @@ class Tan final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Tan,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Tan<float>);
 
 template <typename T>
@@ -745,7 +746,7 @@ class Asin final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Asin,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Asin<float>);
 
 template <typename T>
@@ -765,7 +766,7 @@ class Acos final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Acos,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Acos<float>);
 
 template <typename T>
@@ -785,7 +786,7 @@ class Atan final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Atan,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Atan<float>);
 
 template <typename T>
@@ -805,7 +806,7 @@ class Sinh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Sinh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sinh<float>);
 
 template <typename T>
@@ -825,7 +826,7 @@ class Cosh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Cosh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Cosh<float>);
 
 template <typename T>
@@ -857,7 +858,7 @@ class Asinh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Asinh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Asinh<float>);
 
 template <typename T>
@@ -889,7 +890,7 @@ class Acosh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Acosh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Acosh<float>);
 
 template <typename T>
@@ -921,7 +922,7 @@ class Atanh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Atanh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Atanh<float>);
 
 template <>
@@ -946,35 +947,32 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     PRelu,
     7,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     PRelu<float>);
 
-// This is a special case version of TBroadcaster just for Expand that only has a shape as the second parameter
+// rows of the outermost axis are expanded in parallel with at least this many output elements in each range
+constexpr int64_t kMinExpandElementsPerRange = 16 * 1024;
+
+// expands the input in the axes from axis on into output, where the input dims are 1 or the output dims, and
+// returns the end of the output written. a dim of 1 is repeated by doubling memcpy of the expanded inner axes.
 template <typename T>
-struct TBroadcasterExpand {
-  TBroadcasterExpand(const Tensor& input, const std::vector<int64_t>& shape)
-      : input_tensor_(input),
-        broadcaster_(input.Shape().GetDims(), shape) {
+static T* ExpandAxes(const T* input, T* output, const std::vector<int64_t>& input_dims,
+                     const std::vector<int64_t>& output_dims, const TensorPitches& input_pitches, size_t axis) {
+  if (axis == input_dims.size() - 1) {
+    if (input_dims[axis] == 1) {
+      std::fill_n(output, output_dims[axis], *input);
+    } else {
+      memcpy(output, input, input_dims[axis] * sizeof(T));
+    }
+    return output + output_dims[axis];
   }
 
-  TensorShape GetOutputShape() const { return TensorShape(broadcaster_.output_shape_); }
-  size_t GetSpanSize() const { return span_size_; }
-
-  bool IsInput0Scalar() const { return broadcaster_.iterator1_.deltas_.front() == 0; }
-
-  T NextScalar() { return *Next(); }
-
-  ConstEigenVectorMap<T> NextEigen() { return ConstEigenVectorMap<T>(Next(), span_size_); }
-
- private:
-  const T* Next() { return input_ + broadcaster_.iterator1_.AdvanceBy(span_size_); }
-
-  const Tensor& input_tensor_;
-  Broadcaster broadcaster_;
-  size_t span_size_{broadcaster_.GetSpanSize()};
-
-  const T* input_{input_tensor_.template Data<T>()};
-};
+  T* block = output;
+  for (int64_t i = 0; i < input_dims[axis]; i++) {
+    output = ExpandAxes(input + i * input_pitches[axis], output, input_dims, output_dims, input_pitches, axis + 1);
+  }
+  return RepeatBlock(block, output - block, input_dims[axis] == 1 ? output_dims[axis] : 1);
+}
 
 template <typename T>
 Status Expand_8<T>::Compute(OpKernelContext* context) const {
@@ -985,19 +983,50 @@ Status Expand_8<T>::Compute(OpKernelContext* context) const {
   const int64_t* p_shape = tensor_shape.template Data<int64_t>();
   std::vector<int64_t> shape{p_shape, p_shape + tensor_shape.Shape().Size()};
 
-  TBroadcasterExpand<T> bc(*context->Input<Tensor>(0), shape);
-  TBroadcastOutput<T> output(bc.GetSpanSize(), *context->Output(0, bc.GetOutputShape()));
+  // broadcast the input and the shape against each other, aligned on their innermost axes
+  auto& input_tensor = *context->Input<Tensor>(0);
+  const auto& dims = input_tensor.Shape().GetDims();
+  const size_t rank = std::max(dims.size(), shape.size());
+  std::vector<int64_t> input_dims(rank - dims.size(), 1);
+  input_dims.insert(input_dims.end(), dims.begin(), dims.end());
+  shape.insert(shape.begin(), rank - shape.size(), 1);
+  std::vector<int64_t> output_dims(rank);
+  for (size_t axis = 0; axis < rank; axis++) {
+    if (input_dims[axis] != shape[axis] && input_dims[axis] != 1 && shape[axis] != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expand: the shape ", TensorShape(shape),
+                             " can't be broadcast with the input shape ", input_tensor.Shape());
+    }
+    output_dims[axis] = input_dims[axis] == 1 ? shape[axis] : input_dims[axis];
+  }
 
-  // This doesn't use BroadcastLoop since there is no second tensor, just duplicating the first
-  if (bc.IsInput0Scalar()) {
-    // Input0 being a scalar is the only special case here, since we're duplicating a single value
-    while (output)
-      output.NextEigenOutput().array() = bc.NextScalar();
-  } else {
-    // Input1 being a scalar doesn't matter (as there's no actual input1). We're still duplicating Input0 in the same sized chunks
-    while (output)
-      output.NextEigenOutput() = bc.NextEigen();
+  auto& output_tensor = *context->Output(0, TensorShape(output_dims));
+  if (output_tensor.Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const T* input = input_tensor.template Data<T>();
+  T* output = output_tensor.template MutableData<T>();
+  if (rank == 0) {
+    *output = *input;
+    return Status::OK();
   }
+  if (rank == 1) {
+    ExpandAxes(input, output, input_dims, output_dims, TensorPitches(input_dims), 0);
+    return Status::OK();
+  }
+
+  // the rows of the outermost axis are expanded in the other axes in parallel, each into its own block of the first
+  // repeat of the outermost axis, which is then repeated if the input has a single row
+  TensorPitches input_pitches(input_dims);
+  TensorPitches output_pitches(output_dims);
+  const int64_t row_size = output_pitches[0];
+  const int64_t min_rows = std::max<int64_t>(1, kMinExpandElementsPerRange / row_size);
+  context->ParallelFor(input_dims[0], min_rows, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      ExpandAxes(input + row * input_pitches[0], output + row * row_size, input_dims, output_dims, input_pitches, 1);
+    }
+  });
+  RepeatBlock(output, input_dims[0] * row_size, input_dims[0] == 1 ? output_dims[0] : 1);
   return Status::OK();
 }
 
@@ -1036,7 +1065,7 @@ Status Erf<float>::Compute(OpKernelContext* context) const {
   ORT_ENFORCE(X_ptr != nullptr);
   auto& X = *X_ptr;
   auto& Y = *context->Output(0, X.Shape());
-  EigenMap<float>(Y) = EigenMap<float>(X).array().erf();
+  MlasComputeErf(X.template Data<float>(), Y.template MutableData<float>(), static_cast<size_t>(X.Shape().Size()));
 
   return Status::OK();
 }
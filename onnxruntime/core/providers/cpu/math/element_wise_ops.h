@@ -349,6 +349,20 @@ struct BroadcastIterator {
     return index;
   }
 
+  // Positions the iterator at the element of the output at offset, as if AdvanceBy had been called up to it
+  void Seek(size_t offset) {
+    auto count = static_cast<ptrdiff_t>(offset);
+    ptrdiff_t index = deltas_[0] * count;
+    counters_[0] = count % counts_[0];
+    count /= counts_[0];
+    for (size_t counterIndex = 1; counterIndex < counters_.size(); counterIndex++) {
+      index += deltas_[counterIndex] * count;
+      counters_[counterIndex] = count % counts_[counterIndex];
+      count /= counts_[counterIndex];
+    }
+    index_ = static_cast<size_t>(index);
+  }
+
   void Init(int64_t axis, int64_t largest) {
     ORT_ENFORCE(axis == 1 || axis == largest, "Attempting to broadcast an axis by a dimension other than 1. ", axis, " by ", largest);
 
@@ -393,7 +407,7 @@ struct BroadcastIterator {
 };
 
 struct Broadcaster {
-  Broadcaster(const std::vector<int64_t>& shape1, const std::vector<int64_t>& shape2) {
+  Broadcaster(const TensorDims& shape1, const TensorDims& shape2) {
     size_t dimension_count_max = std::max(shape1.size(), shape2.size());
     size_t dimension_count_min = std::min(shape1.size(), shape2.size());
     output_shape_.resize(dimension_count_max);
@@ -489,6 +503,18 @@ struct TBroadcaster {
         input_tensor1_(input1) {
   }
 
+  // A copy of other positioned at the element of the output at offset, that returns spans of span_size. The offset
+  // must be at the start of a span of other, and span_size either other's span size or at most the rest of the
+  // output when it is a single span.
+  TBroadcaster(const TBroadcaster& other, size_t offset, size_t span_size)
+      : input_tensor0_(other.input_tensor0_),
+        input_tensor1_(other.input_tensor1_),
+        broadcaster_(other.broadcaster_),
+        span_size_(span_size) {
+    broadcaster_.iterator1_.Seek(offset);
+    broadcaster_.iterator2_.Seek(offset);
+  }
+
   TensorShape GetOutputShape() const { return TensorShape(broadcaster_.output_shape_); }
   size_t GetSpanSize() const { return span_size_; }
 
@@ -525,6 +551,13 @@ struct TBroadcastOutput {
     output_end_ = output_ + tensor.Shape().Size();
   }
 
+  // An output over the elements [start_offset, end_offset) of tensor
+  TBroadcastOutput(size_t span_size, Tensor& tensor, int64_t start_offset, int64_t end_offset)
+      : span_size_(span_size) {
+    output_ = tensor.template MutableData<T>() + start_offset;
+    output_end_ = tensor.template MutableData<T>() + end_offset;
+  }
+
   operator bool() const {
     return output_ != output_end_;
   }
@@ -585,11 +618,49 @@ void BroadcastLoop(TBroadcaster& bc, Output& output, Input0Scalar input0scalar,
   }
 }
 
+// Outputs of more than this many elements are split into blocks of about this many elements that are computed in
+// parallel
+constexpr int64_t kParallelBroadcastBlockSize = 16 * 1024;
+
+// BroadcastLoop over the whole of output_tensor, in parallel for large outputs. A block is a run of whole spans, or
+// a part of the span when the output is a single span, since the inputs are then each a scalar or of the output's
+// size and can be split anywhere.
+template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
+void ParallelBroadcastLoop(TBroadcaster<TInput>& bc, Tensor& output_tensor, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const int64_t output_size = output_tensor.Shape().Size();
+  const auto span_size = static_cast<int64_t>(bc.GetSpanSize());
+  const bool single_span = span_size >= output_size;
+
+  int64_t block_size = output_size;
+  if (output_size > kParallelBroadcastBlockSize) {
+    block_size = single_span ? kParallelBroadcastBlockSize
+                             : std::max<int64_t>(1, kParallelBroadcastBlockSize / span_size) * span_size;
+  }
+
+  const int64_t block_count = block_size > 0 ? (output_size + block_size - 1) / block_size : 0;
+  if (block_count <= 1) {
+    TBroadcastOutput<TOutput> output(bc.GetSpanSize(), output_tensor);
+    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    return;
+  }
+
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int64_t block = 0; block < block_count; block++) {
+    const int64_t start = block * block_size;
+    const int64_t end = std::min(start + block_size, output_size);
+
+    TBroadcaster<TInput> block_bc(bc, static_cast<size_t>(start), static_cast<size_t>(single_span ? end - start : span_size));
+    TBroadcastOutput<TOutput> output(block_bc.GetSpanSize(), output_tensor, start, end);
+    BroadcastLoop(block_bc, output, input0scalar, input1scalar, general);
+  }
+}
+
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
 Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
   TBroadcaster<TInput> bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
-  TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *context.Output(0, bc.GetOutputShape()));
-  BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+  ParallelBroadcastLoop<TInput, TOutput>(bc, *context.Output(0, bc.GetOutputShape()), input0scalar, input1scalar, general);
 
   return Status::OK();
 }
@@ -626,9 +697,7 @@ Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scala
       p_output = tempOutput.get();
     }
 
-    TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *p_output);
-
-    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    ParallelBroadcastLoop<TInput, TOutput>(bc, *p_output, input0scalar, input1scalar, general);
 
     tempInput = std::move(tempOutput);
   }
@@ -7,6 +7,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/providers/cpu/math/sgemm_prepack.h"
 #include "gemm_helper.h"
 
 namespace onnxruntime {
@@ -27,6 +28,17 @@ class Gemm : public OpKernel {
 
     ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+
+    // pack a constant W once rather than on every Compute, skipping its blocks of zeros if it's sparse,
+    // or compress it if the session asks to
+    const Tensor* W;
+    if (info.TryGetConstantInput(1, &W)) {
+      auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+      if (!CompressSgemmB(*W, trans_B_, info.GetWeightCompression(), alloc, compressed_W_) &&
+          !PrePackBlockSparseSgemmB(*W, trans_B_, alloc, sparse_W_)) {
+        PrePackSgemmB(*W, trans_B_, alloc, packed_W_);
+      }
+    }
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -47,6 +59,33 @@ class Gemm : public OpKernel {
       return Status::OK();
     T_Y* y_data = Y->template MutableData<T_Y>();
 
+    // apply the bias and the activation in the output stage of the SGEMM, while each block of Y
+    // is still in the cache, rather than in separate passes over Y
+    MLAS_ACTIVATION activation;
+    MLAS_SGEMM_EPILOGUE epilogue;
+    if (K > 0 && GetSgemmEpilogue(*B, N, activation, epilogue)) {
+      const size_t lda = static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M);
+      if (compressed_W_) {
+        CompressedSgemm(trans_A_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                        alpha_, X->template Data<T_X>(), lda, compressed_W_, 0.0f, y_data,
+                        static_cast<size_t>(N), &epilogue);
+      } else if (sparse_W_) {
+        MlasSgemmBlockSparse(trans_A_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                             alpha_, X->template Data<T_X>(), lda, sparse_W_.get(), 0.0f, y_data,
+                             static_cast<size_t>(N), &epilogue);
+      } else if (packed_W_) {
+        MlasSgemmPacked(trans_A_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                        alpha_, X->template Data<T_X>(), lda, packed_W_.get(), 0.0f, y_data,
+                        static_cast<size_t>(N), &epilogue);
+      } else {
+        MlasSgemm(trans_A_, trans_B_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                  alpha_, X->template Data<T_X>(), lda, W->template Data<T_W>(),
+                  static_cast<size_t>(trans_B_ == CblasNoTrans ? N : K), 0.0f, y_data,
+                  static_cast<size_t>(N), &epilogue);
+      }
+      return Status::OK();
+    }
+
     //bias
     // Todo: we might should move this part into math::gemm to let eigen
     // have better chance to further optimize it.
@@ -95,18 +134,41 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T_X, CPUMathUtil>(
-        trans_A_,
-        trans_B_,
-        M,
-        N,
-        K,
-        alpha_,
-        X->template Data<T_X>(),
-        W->template Data<T_W>(),
-        beta_,
-        y_data,
-        &CPUMathUtil::Instance());
+    if (compressed_W_) {
+      CompressedSgemm(trans_A_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                      alpha_, X->template Data<T_X>(), static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+                      compressed_W_, beta_, y_data, static_cast<size_t>(N));
+    } else if (sparse_W_) {
+      MlasSgemmBlockSparse(trans_A_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                           alpha_, X->template Data<T_X>(), static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+                           sparse_W_.get(), beta_, y_data, static_cast<size_t>(N));
+    } else if (packed_W_) {
+      MlasSgemmPacked(
+          trans_A_,
+          static_cast<size_t>(M),
+          static_cast<size_t>(N),
+          static_cast<size_t>(K),
+          alpha_,
+          X->template Data<T_X>(),
+          static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+          packed_W_.get(),
+          beta_,
+          y_data,
+          static_cast<size_t>(N));
+    } else {
+      math::Gemm<T_X, CPUMathUtil>(
+          trans_A_,
+          trans_B_,
+          M,
+          N,
+          K,
+          alpha_,
+          X->template Data<T_X>(),
+          W->template Data<T_W>(),
+          beta_,
+          y_data,
+          &CPUMathUtil::Instance());
+    }
 
     FuseActivation<T_Y>(activation_, y_data, M * N, leaky_relu_alpha_);
 
@@ -114,10 +176,68 @@ class Gemm : public OpKernel {
   }
 
  private:
+  // Describe the bias and the activation as the output stage of the MLAS SGEMM. This is possible
+  // if beta is 1, B broadcasts along a single dimension of Y or matches Y, and MLAS implements
+  // the activation. Returns false if they must be applied separately.
+  bool GetSgemmEpilogue(const Tensor& B, int64_t N, MLAS_ACTIVATION& activation,
+                        MLAS_SGEMM_EPILOGUE& epilogue) const {
+    if (beta_ != 1.0f) {
+      return false;
+    }
+
+    if (activation_.empty()) {
+      activation.ActivationKind = MlasIdentityActivation;
+    } else if (activation_ == "Relu") {
+      activation.ActivationKind = MlasReluActivation;
+    } else if (activation_ == "LeakyRelu") {
+      activation.ActivationKind = MlasLeakyReluActivation;
+      activation.alpha = leaky_relu_alpha_;
+    } else if (activation_ == "Tanh") {
+      activation.ActivationKind = MlasTanhActivation;
+    } else if (activation_ == "Sigmoid") {
+      activation.ActivationKind = MlasLogisticActivation;
+    } else {
+      return false;
+    }
+
+    epilogue.Activation = &activation;
+    epilogue.RowBias = nullptr;
+    epilogue.ColumnBias = nullptr;
+    epilogue.Addend = nullptr;
+    epilogue.ldaddend = 0;
+
+    const auto& b_shape = B.Shape();
+    const float* b_data = B.template Data<T_B>();
+    if (b_shape.Size() == 1) {
+      // B is a scalar
+      return false;
+    } else if (b_shape.NumDimensions() == 1 || (b_shape.NumDimensions() == 2 && b_shape[0] == 1)) {
+      // B is (N,) or (1, N)
+      epilogue.ColumnBias = b_data;
+    } else if (b_shape.NumDimensions() == 2 && b_shape[1] == 1) {
+      // B is (M, 1)
+      epilogue.RowBias = b_data;
+    } else if (b_shape.NumDimensions() == 2) {
+      // B is (M, N)
+      epilogue.Addend = b_data;
+      epilogue.ldaddend = static_cast<size_t>(N);
+    } else {
+      return false;
+    }
+
+    return true;
+  }
+
   CBLAS_TRANSPOSE trans_A_;
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
+  // W in the MLAS SGEMM layout if it's a constant initializer
+  BufferUniquePtr packed_W_;
+  // W in the MLAS block sparse SGEMM layout if it's such an initializer that is mostly blocks of zeros
+  BufferUniquePtr sparse_W_;
+  // W as float16 or int8 if the session compresses the constant weights
+  CompressedSgemmB compressed_W_;
 
 protected:
   // For fused gemm + activation
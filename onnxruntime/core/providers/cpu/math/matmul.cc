@@ -3,8 +3,7 @@
 
 #include "core/providers/cpu/math/matmul.h"
 
-#include "core/util/math.h"
-#include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
 #include "matmul_helper.h"
 
 namespace onnxruntime {
@@ -26,22 +25,96 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
 
   Tensor* Y = ctx->Output(0, helper.OutputShape());
 
-  // TODO: replace it with GemmBatch for performance, it's OK for now as GemmBatch unrolls as well
-  for (int i = 0; i < helper.OutputOffsets().size(); i++) {
-    math::Gemm<float, CPUMathUtil>(
-        CblasNoTrans,
-        CblasNoTrans,
-        static_cast<int>(helper.M()),
-        static_cast<int>(helper.N()),
-        static_cast<int>(helper.K()),
-        /* alpha */ 1.0f,
-        left_X->template Data<float>() + helper.LeftOffsets()[i],
-        right_X->template Data<float>() + helper.RightOffsets()[i],
-        /* beta */ 0.0f,
-        Y->template MutableData<float>() + helper.OutputOffsets()[i],
-        &CPUMathUtil::Instance());
+  // a packed, sparse or compressed B is 2D so every output shares it and only the offsets into A and Y vary
+  if (compressed_B_) {
+    if (helper.M() == 0 || helper.N() == 0) {
+      return Status::OK();
+    }
+
+    for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+      CompressedSgemm(
+          CblasNoTrans,
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          /* alpha */ 1.0f,
+          left_X->template Data<float>() + helper.LeftOffsets()[i],
+          static_cast<size_t>(helper.K()),
+          compressed_B_,
+          /* beta */ 0.0f,
+          Y->template MutableData<float>() + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()));
+    }
+
+    return Status::OK();
+  }
+
+  if (sparse_B_) {
+    if (helper.M() == 0 || helper.N() == 0) {
+      return Status::OK();
+    }
+
+    for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+      MlasSgemmBlockSparse(
+          CblasNoTrans,
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          /* alpha */ 1.0f,
+          left_X->template Data<float>() + helper.LeftOffsets()[i],
+          static_cast<size_t>(helper.K()),
+          sparse_B_.get(),
+          /* beta */ 0.0f,
+          Y->template MutableData<float>() + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()));
+    }
+
+    return Status::OK();
   }
 
+  if (packed_B_) {
+    if (helper.M() == 0 || helper.N() == 0) {
+      return Status::OK();
+    }
+
+    for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+      MlasSgemmPacked(
+          CblasNoTrans,
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          /* alpha */ 1.0f,
+          left_X->template Data<float>() + helper.LeftOffsets()[i],
+          static_cast<size_t>(helper.K()),
+          packed_B_.get(),
+          /* beta */ 0.0f,
+          Y->template MutableData<float>() + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()));
+    }
+
+    return Status::OK();
+  }
+
+  // all the slices share M, N and K so run them as a single batch that is threaded across the slices
+  MlasSgemmBatch(
+      CblasNoTrans,
+      CblasNoTrans,
+      static_cast<size_t>(helper.M()),
+      static_cast<size_t>(helper.N()),
+      static_cast<size_t>(helper.K()),
+      /* alpha */ 1.0f,
+      left_X->template Data<float>(),
+      static_cast<size_t>(helper.K()),
+      helper.LeftOffsets().data(),
+      right_X->template Data<float>(),
+      static_cast<size_t>(helper.N()),
+      helper.RightOffsets().data(),
+      /* beta */ 0.0f,
+      Y->template MutableData<float>(),
+      static_cast<size_t>(helper.N()),
+      helper.OutputOffsets().data(),
+      helper.OutputOffsets().size());
+
   return Status::OK();
 }
 
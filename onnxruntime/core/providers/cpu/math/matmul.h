@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/sgemm_prepack.h"
 
 namespace onnxruntime {
 
@@ -13,9 +14,27 @@ class MatMul final : public OpKernel {
  public:
   MatMul(const OpKernelInfo& info)
       : OpKernel(info) {
+    // pack a constant B once rather than on every Compute, skipping its blocks of zeros if it's sparse,
+    // or compress it if the session asks to
+    const Tensor* B;
+    if (info.TryGetConstantInput(1, &B)) {
+      auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+      if (!CompressSgemmB(*B, CblasNoTrans, info.GetWeightCompression(), alloc, compressed_B_) &&
+          !PrePackBlockSparseSgemmB(*B, CblasNoTrans, alloc, sparse_B_)) {
+        PrePackSgemmB(*B, CblasNoTrans, alloc, packed_B_);
+      }
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // B in the MLAS SGEMM layout if it's a constant 2D float initializer
+  BufferUniquePtr packed_B_;
+  // B in the MLAS block sparse SGEMM layout if it's such an initializer that is mostly blocks of zeros
+  BufferUniquePtr sparse_B_;
+  // B as float16 or int8 if the session compresses the constant weights
+  CompressedSgemmB compressed_B_;
 };
 
 }  // namespace onnxruntime
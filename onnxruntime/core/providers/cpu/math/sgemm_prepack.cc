@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/sgemm_prepack.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+
+bool PrePackBlockSparseSgemmB(const Tensor& B, CBLAS_TRANSPOSE trans_b, const AllocatorPtr& alloc,
+                              BufferUniquePtr& packed_b) {
+  if (alloc == nullptr ||
+      B.DataType() != DataTypeImpl::GetType<float>() ||
+      B.Shape().NumDimensions() != 2 ||
+      strcmp(B.Location().name, CPU) != 0) {
+    return false;
+  }
+
+  const size_t ldb = static_cast<size_t>(B.Shape()[1]);
+  const size_t K = static_cast<size_t>(trans_b == CblasNoTrans ? B.Shape()[0] : B.Shape()[1]);
+  const size_t N = static_cast<size_t>(trans_b == CblasNoTrans ? B.Shape()[1] : B.Shape()[0]);
+  if (K == 0 || N == 0) {
+    return false;
+  }
+
+  const float* b = B.Data<float>();
+  if (MlasSgemmBlockSparseDensity(trans_b, N, K, b, ldb) > kBlockSparseSgemmMaxDensity) {
+    return false;
+  }
+
+  void* buffer = alloc->Alloc(MlasSgemmPackBlockSparseBSize(trans_b, N, K, b, ldb));
+  packed_b = BufferUniquePtr(buffer, BufferDeleter(alloc));
+  MlasSgemmPackBlockSparseB(trans_b, N, K, b, ldb, buffer);
+  return true;
+}
+
+bool CompressSgemmB(const Tensor& B, CBLAS_TRANSPOSE trans_b, WeightCompression compression,
+                    const AllocatorPtr& alloc, CompressedSgemmB& compressed) {
+  if (compression == WeightCompression::kNone ||
+      alloc == nullptr ||
+      B.DataType() != DataTypeImpl::GetType<float>() ||
+      B.Shape().NumDimensions() != 2 ||
+      strcmp(B.Location().name, CPU) != 0) {
+    return false;
+  }
+
+  const size_t rows = static_cast<size_t>(B.Shape()[0]);
+  const size_t cols = static_cast<size_t>(B.Shape()[1]);
+  const size_t N = trans_b == CblasNoTrans ? cols : rows;
+  if (rows == 0 || cols == 0) {
+    return false;
+  }
+
+  const float* b = B.Data<float>();
+  const size_t count = rows * cols;
+
+  if (compression == WeightCompression::kFloat16) {
+    void* buffer = alloc->Alloc(count * sizeof(unsigned short));
+    compressed.data = BufferUniquePtr(buffer, BufferDeleter(alloc));
+    MlasConvertFloatToHalfBuffer(b, static_cast<unsigned short*>(buffer), count);
+  } else {
+    // symmetric per channel: the scale of column n of the product maps the largest magnitude of B for it to 127
+    void* scale_buffer = alloc->Alloc(N * sizeof(float));
+    compressed.scales = BufferUniquePtr(scale_buffer, BufferDeleter(alloc));
+    float* scales = static_cast<float*>(scale_buffer);
+    std::fill_n(scales, N, 0.0f);
+    for (size_t r = 0; r < rows; ++r) {
+      for (size_t c = 0; c < cols; ++c) {
+        float& scale = scales[trans_b == CblasNoTrans ? c : r];
+        scale = std::max(scale, std::fabs(b[r * cols + c]));
+      }
+    }
+    for (size_t n = 0; n < N; ++n) {
+      scales[n] = scales[n] == 0.0f ? 1.0f : scales[n] / 127.0f;
+    }
+
+    void* buffer = alloc->Alloc(count * sizeof(int8_t));
+    compressed.data = BufferUniquePtr(buffer, BufferDeleter(alloc));
+    int8_t* data = static_cast<int8_t*>(buffer);
+    for (size_t r = 0; r < rows; ++r) {
+      for (size_t c = 0; c < cols; ++c) {
+        const float q = std::round(b[r * cols + c] / scales[trans_b == CblasNoTrans ? c : r]);
+        data[r * cols + c] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, q)));
+      }
+    }
+  }
+
+  compressed.compression = compression;
+  compressed.trans_b = trans_b;
+  compressed.ldb = cols;
+  return true;
+}
+
+void CompressedSgemm(CBLAS_TRANSPOSE trans_a, size_t M, size_t N, size_t K, float alpha, const float* A, size_t lda,
+                     const CompressedSgemmB& B, float beta, float* C, size_t ldc,
+                     const MLAS_SGEMM_EPILOGUE* epilogue) {
+  if (B.compression == WeightCompression::kFloat16) {
+    MlasSgemm(trans_a, B.trans_b, M, N, K, alpha, A, lda, static_cast<const unsigned short*>(B.data.get()), B.ldb,
+              beta, C, ldc, epilogue);
+  } else {
+    MlasSgemm(trans_a, B.trans_b, M, N, K, alpha, A, lda, static_cast<const int8_t*>(B.data.get()), B.ldb,
+              static_cast<const float*>(B.scales.get()), beta, C, ldc, epilogue);
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstring>
+
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/framework/weight_compression.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+/**
+  * Pack a constant 2D float B matrix into the MLAS SGEMM layout so it isn't repacked by every Compute.
+  * The packed buffer can be passed to MlasSgemmPacked in place of B.
+  * @param B matrix with shape {K, N}, or {N, K} if trans_b is CblasTrans.
+  * @param alloc allocator for the packed buffer. it must be 64 byte aligned, which all the CPU allocators are.
+  * @param packed_b set to the packed buffer, or left empty if B can't be packed.
+  * @return true if B was packed.
+  */
+inline bool PrePackSgemmB(const Tensor& B, CBLAS_TRANSPOSE trans_b, const AllocatorPtr& alloc,
+                          BufferUniquePtr& packed_b) {
+  if (alloc == nullptr ||
+      B.DataType() != DataTypeImpl::GetType<float>() ||
+      B.Shape().NumDimensions() != 2 ||
+      strcmp(B.Location().name, CPU) != 0) {
+    return false;
+  }
+
+  const size_t ldb = static_cast<size_t>(B.Shape()[1]);
+  const size_t K = static_cast<size_t>(trans_b == CblasNoTrans ? B.Shape()[0] : B.Shape()[1]);
+  const size_t N = static_cast<size_t>(trans_b == CblasNoTrans ? B.Shape()[1] : B.Shape()[0]);
+  if (K == 0 || N == 0) {
+    return false;
+  }
+
+  void* buffer = alloc->Alloc(MlasSgemmPackBSize(N, K));
+  packed_b = BufferUniquePtr(buffer, BufferDeleter(alloc));
+  MlasSgemmPackB(trans_b, N, K, B.Data<float>(), ldb, buffer);
+  return true;
+}
+
+/**
+  * Pack a constant 2D float B matrix, such as a pruned weight, into the MLAS block sparse SGEMM layout if at most
+  * kBlockSparseSgemmMaxDensity of it is in 16x16 blocks with a nonzero element, so that the blocks of zeros are
+  * skipped. The packed buffer can be passed to MlasSgemmBlockSparse in place of B.
+  * @param B matrix with shape {K, N}, or {N, K} if trans_b is CblasTrans.
+  * @param packed_b set to the packed buffer, or left empty if B isn't sparse enough or can't be packed.
+  * @return true if B was packed.
+  */
+bool PrePackBlockSparseSgemmB(const Tensor& B, CBLAS_TRANSPOSE trans_b, const AllocatorPtr& alloc,
+                              BufferUniquePtr& packed_b);
+
+// below this the blocks skipped make up for the dense kernel multiplying shorter runs of each strip
+constexpr float kBlockSparseSgemmMaxDensity = 0.5f;
+
+/**
+  * A constant 2D float B matrix stored as float16 or as int8 with a scale for each column of the product, which
+  * MlasSgemm converts to float as it packs each panel, so that a GEMM reads fewer bytes of B.
+  */
+struct CompressedSgemmB {
+  WeightCompression compression = WeightCompression::kNone;
+  CBLAS_TRANSPOSE trans_b = CblasNoTrans;
+  size_t ldb = 0;
+  BufferUniquePtr data;
+  // the scale of each of the N columns of the product for kInt8
+  BufferUniquePtr scales;
+
+  explicit operator bool() const { return compression != WeightCompression::kNone; }
+};
+
+/**
+  * Compress a constant 2D float B matrix as compression requests, e.g. with OpKernelInfo::GetWeightCompression().
+  * @param B matrix with shape {K, N}, or {N, K} if trans_b is CblasTrans.
+  * @param compressed set to the compressed matrix, or left empty if B isn't compressed.
+  * @return true if B was compressed.
+  */
+bool CompressSgemmB(const Tensor& B, CBLAS_TRANSPOSE trans_b, WeightCompression compression,
+                    const AllocatorPtr& alloc, CompressedSgemmB& compressed);
+
+/**
+  * C = alpha * op(A) * B + beta * C with a compressed B of N columns and K rows, optionally with an MLAS epilogue.
+  */
+void CompressedSgemm(CBLAS_TRANSPOSE trans_a, size_t M, size_t N, size_t K, float alpha, const float* A, size_t lda,
+                     const CompressedSgemmB& B, float beta, float* C, size_t ldc,
+                     const MLAS_SGEMM_EPILOGUE* epilogue = nullptr);
+
+}  // namespace onnxruntime
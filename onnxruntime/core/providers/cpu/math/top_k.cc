@@ -20,7 +20,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
 #include "core/util/math_cpuonly.h"
-#include <queue>
+#include <algorithm>
 using namespace std;
 namespace onnxruntime {
 // spec https://github.com/onnx/onnx/blob/master/docs/Operators.md#TopK
@@ -49,17 +49,87 @@ template <typename T>
 using ConstEigenMatrixMapRowMajor = Eigen::Map<
     const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>;
 
+// orders the larger value first, and of equal values the smaller index first
 template <typename T>
 struct ValueCmp {
   bool operator()(
       const pair<T, int64_t>& lhs,
-      const pair<T, int64_t>& rhs) {
+      const pair<T, int64_t>& rhs) const {
     return (
         lhs.first > rhs.first ||
         (lhs.first == rhs.first && lhs.second < rhs.second));
   }
 };
 
+// the number of input elements each range of rows selected in parallel holds at least
+constexpr int64_t kMinTopKElementsPerRange = 64 * 1024;
+
+// a heap of the k largest elements is faster than a partial sort of the whole row while k is this small a
+// fraction of the row
+constexpr int64_t kTopKHeapRatio = 16;
+
+// the largest element of the row, as ArgMax, which the vectorized max finds before a scan for its first index
+template <typename T>
+void SelectTop1(const T* row, int64_t cols, T* value, int64_t* index) {
+  const T max_value = ConstEigenVectorMap<T>(row, cols).maxCoeff();
+  const T* max_element = std::find(row, row + cols, max_value);
+  if (max_element == row + cols) {
+    // the row has a NaN, which the scan skips
+    max_element = row;
+    for (const T* element = row + 1; element < row + cols; ++element) {
+      if (*element > *max_element) {
+        max_element = element;
+      }
+    }
+  }
+  *value = *max_element;
+  *index = max_element - row;
+}
+
+// the k largest elements of the row in descending order, by keeping them in a min-heap whose top is the smallest
+template <typename T>
+void SelectTopKByHeap(const T* row, int64_t cols, int64_t k, T* values, int64_t* indices) {
+  vector<pair<T, int64_t>> heap;
+  heap.reserve(k);
+  for (int64_t j = 0; j < k; ++j) {
+    heap.emplace_back(row[j], j);
+  }
+  make_heap(heap.begin(), heap.end(), ValueCmp<T>());
+
+  for (int64_t j = k; j < cols; ++j) {
+    // a later element equal to the top has a larger index, so only a larger value replaces it
+    if (row[j] > heap.front().first) {
+      pop_heap(heap.begin(), heap.end(), ValueCmp<T>());
+      heap.back() = {row[j], j};
+      push_heap(heap.begin(), heap.end(), ValueCmp<T>());
+    }
+  }
+
+  sort_heap(heap.begin(), heap.end(), ValueCmp<T>());
+  for (int64_t j = 0; j < k; ++j) {
+    values[j] = heap[j].first;
+    indices[j] = heap[j].second;
+  }
+}
+
+// the k largest elements of the row in descending order, by a partial selection of the row and a sort of the k
+template <typename T>
+void SelectTopKByPartition(const T* row, int64_t cols, int64_t k, T* values, int64_t* indices) {
+  vector<pair<T, int64_t>> elements(cols);
+  for (int64_t j = 0; j < cols; ++j) {
+    elements[j] = {row[j], j};
+  }
+
+  if (k < cols) {
+    nth_element(elements.begin(), elements.begin() + (k - 1), elements.end(), ValueCmp<T>());
+  }
+  sort(elements.begin(), elements.begin() + k, ValueCmp<T>());
+  for (int64_t j = 0; j < k; ++j) {
+    values[j] = elements[j].first;
+    indices[j] = elements[j].second;
+  }
+}
+
 template <>
 Status TopK<float>::Compute(OpKernelContext* p_op_kernel_context) const {
   const Tensor* X = p_op_kernel_context->Input<Tensor>(0);
@@ -95,34 +165,24 @@ Status TopK<float>::Compute(OpKernelContext* p_op_kernel_context) const {
   auto Indices_map = EigenMatrixMapRowMajor<int64_t>(
       Indices->template MutableData<int64_t>(), linear_shape[0], k_);
 
-  // Sort preserving Indices
-  for (int64_t i = 0; i < linear_shape[0]; ++i) {
-    // Build a min-heap, the heap element is pair of (value, idx)
-    // the top of the heap is the smallest value
-    priority_queue<
-        pair<float, int64_t>,
-        vector<pair<float, int64_t>>,
-        ValueCmp<float>>
-        min_heap;
-
-    // Maintain the size of heap to be less or equal to k_, so the
-    // heap will hold the k_ largest Values
-    for (int64_t j = 0; j < linear_shape[1]; ++j) {
-      const auto value = input_map(i, j);
-      if (min_heap.size() < k_ || value > min_heap.top().first) {
-        min_heap.push({value, j});
+  const int64_t rows = linear_shape[0];
+  const int64_t cols = linear_shape[1];
+  const int64_t k = static_cast<int64_t>(k_);
+  const int64_t min_rows = std::max<int64_t>(1, kMinTopKElementsPerRange / std::max<int64_t>(1, cols));
+  p_op_kernel_context->ParallelFor(rows, min_rows, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const float* row = input_map.data() + i * cols;
+      float* values = Values_map.data() + i * k;
+      int64_t* indices = Indices_map.data() + i * k;
+      if (k == 1) {
+        SelectTop1(row, cols, values, indices);
+      } else if (k * kTopKHeapRatio <= cols) {
+        SelectTopKByHeap(row, cols, k, values, indices);
+      } else {
+        SelectTopKByPartition(row, cols, k, values, indices);
       }
-      if (min_heap.size() > k_) {
-        min_heap.pop();
-      }
-    }
-    for (int64_t j = 0; j < k_; ++j) {
-      auto& pqElem = min_heap.top();
-      Values_map(i, k_ - j - 1) = pqElem.first;
-      Indices_map(i, k_ - j - 1) = pqElem.second;
-      min_heap.pop();
     }
-  }
+  });
 
   // Reshape output tensors to [a_1, a_2, ..., a_n, k]
   auto out_dims = in_dims;
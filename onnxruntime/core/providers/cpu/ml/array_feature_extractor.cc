@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/array_feature_extractor.h"
+#include <algorithm>
+#include "core/providers/cpu/ml/ml_common.h"
 
 /**
 https://github.com/onnx/onnx/blob/master/onnx/defs/traditionalml/defs.cc
@@ -30,6 +32,12 @@ using namespace ::onnxruntime::common;
 using namespace std;
 namespace onnxruntime {
 namespace ml {
+
+namespace {
+// the values below which the rows are gathered on one thread
+const int64_t kMinParallelGatheredValues = 16 * 1024;
+}  // namespace
+
 #define REG_ARRAYFEATUREEXTRACTOR(in_type)                                            \
   ONNX_CPU_OPERATOR_TYPED_ML_KERNEL(                                                  \
       ArrayFeatureExtractor,                                                          \
@@ -93,13 +101,25 @@ common::Status ArrayFeatureExtractorOp<T>::Compute(OpKernelContext* context) con
   T* z_data = Z->template MutableData<T>();
 
   const int64_t x_size_until_last_dim = x_shape.SizeToDimension(x_num_dims - 1);
-  for (int64_t i = 0; i < x_size_until_last_dim; ++i) {
-    for (int64_t j = 0; j < num_indices; ++j) {
-      *z_data++ = x_data[y_data[j]];
-    }
-    x_data += stride;
+  // a run of consecutive indices, the usual slice of features, is copied as a block from each row
+  bool consecutive = true;
+  for (int64_t j = 1; j < num_indices && consecutive; ++j) {
+    consecutive = y_data[j] == y_data[0] + j;
   }
-
+  RunRowsInParallel(x_size_until_last_dim, num_indices, kMinParallelGatheredValues,
+                    [&](int64_t row_begin, int64_t row_end) {
+                      for (int64_t i = row_begin; i < row_end; ++i) {
+                        const T* x_row = x_data + i * stride;
+                        T* z_row = z_data + i * num_indices;
+                        if (consecutive) {
+                          std::copy_n(x_row + y_data[0], num_indices, z_row);
+                        } else {
+                          for (int64_t j = 0; j < num_indices; ++j) {
+                            z_row[j] = x_row[y_data[j]];
+                          }
+                        }
+                      }
+                    });
   return Status::OK();
 }
 
@@ -3,7 +3,10 @@
 
 #include "core/providers/cpu/ml/cast_map.h"
 #include <algorithm>
+#include <exception>
+#include <utility>
 #include <gsl/span>
+#include "core/platform/ort_mutex.h"
 using namespace ::onnxruntime::common;
 
 namespace {
@@ -43,6 +46,11 @@ std::string Cast<float, std::string>(const float& from) {
 namespace onnxruntime {
 namespace ml {
 
+namespace {
+// the entries below which a map is cast on one thread
+const int64_t kMinParallelCastEntries = 4 * 1024;
+}  // namespace
+
 ONNX_CPU_OPERATOR_ML_KERNEL(
     CastMap,
     1,
@@ -103,42 +111,59 @@ Status CastMap::ComputeImpl(OpKernelContext& context, TTo pad_value) const {
 
   int64_t num_dims = map_form_ == PACK_MAP::DENSE ? gsl::narrow_cast<int64_t>(X.size()) : max_map_;
 
-  // create a span for the output
   Tensor* Y = context.Output(0, TensorShape({1, num_dims}));
-  auto out = gsl::make_span(Y->template MutableData<TTo>(), Y->Shape().Size());
-  auto out_iter = out.begin();
-
-  // for each item in the entry, use the template specialized Cast function to convert
-  if (map_form_ == PACK_MAP::DENSE) {
-    // dense map is a straight copy
-    std::for_each(X.cbegin(), X.cend(),
-                  [&out_iter](const typename InputMap::value_type& entry) {
-                    *out_iter = Cast<TFrom, TTo>(entry.second);
-                    ++out_iter;
-                  });
-  } else {
-    // sparse map puts pad_value in all entries that aren't present in the input, up to map_max_
-    auto cur_input = X.cbegin(), end_input = X.cend();
-    auto out_end = out.end();
-    int64_t cur_idx = 0;
+  TTo* out = Y->template MutableData<TTo>();
 
+  // a dense map is a straight copy. a sparse map puts each entry at its key, up to max_map_, and pad_value in all
+  // the others
+  auto cur_input = X.cbegin(), end_input = X.cend();
+  if (map_form_ == PACK_MAP::SPARSE) {
     ORT_ENFORCE(cur_input == end_input || cur_input->first >= 0,
                 "Negative index values are not permitted. First entry in map has index value of ", cur_input->first);
-
-    // for each output value, see if we have an input value, if not use the pad value
-    while (out_iter < out_end) {
-      if (cur_input != end_input && cur_input->first == cur_idx) {
-        *out_iter = Cast<TFrom, TTo>(cur_input->second);
-        ++cur_input;
-      } else {
-        *out_iter = pad_value;
+    std::fill_n(out, num_dims, pad_value);
+  }
+  auto output_index = [this](int64_t position, const typename InputMap::value_type& entry) {
+    return map_form_ == PACK_MAP::DENSE ? position : entry.first;
+  };
+
+  if (static_cast<int64_t>(X.size()) < kMinParallelCastEntries) {
+    for (int64_t position = 0; cur_input != end_input; ++cur_input, ++position) {
+      const int64_t index = output_index(position, *cur_input);
+      if (index >= num_dims) {
+        break;
       }
-
-      ++out_iter;
-      ++cur_idx;
+      out[index] = Cast<TFrom, TTo>(cur_input->second);
     }
+    return Status::OK();
   }
 
+  // the entries of a large map, as the features of a whole document, are cast in parallel, which for strings are
+  // parsed or formatted
+  std::vector<std::pair<int64_t, const TFrom*>> entries;
+  entries.reserve(X.size());
+  for (int64_t position = 0; cur_input != end_input; ++cur_input, ++position) {
+    const int64_t index = output_index(position, *cur_input);
+    if (index >= num_dims) {
+      break;
+    }
+    entries.emplace_back(index, &cur_input->second);
+  }
+  std::exception_ptr cast_error;
+  OrtMutex cast_error_mutex;
+  RunRowsInParallel(static_cast<int64_t>(entries.size()), 1, kMinParallelCastEntries,
+                    [&](int64_t begin, int64_t end) {
+                      try {
+                        for (int64_t i = begin; i < end; ++i) {
+                          out[entries[i].first] = Cast<TFrom, TTo>(*entries[i].second);
+                        }
+                      } catch (...) {
+                        std::lock_guard<OrtMutex> lock(cast_error_mutex);
+                        cast_error = std::current_exception();
+                      }
+                    });
+  if (cast_error) {
+    std::rethrow_exception(cast_error);
+  }
   return Status::OK();
 }
 
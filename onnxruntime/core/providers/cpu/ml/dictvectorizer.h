@@ -2,10 +2,15 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/flat_string_map.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -16,11 +21,38 @@ class DictVectorizerOp final : public OpKernel {
     //In some stupid models, the vocabulary could have duplicated elements.
     //We must support that, otherwise some tests will be break.
     ORT_ENFORCE(info.GetAttrs(std::is_same<AttrType, std::string>::value ? "string_vocabulary" : "int64_vocabulary", vocabulary_).IsOK());
+
+    // the positions of a key are chained from the first one, so duplicated keys get the value of the key too
+    // last_positions is indexed by the first position of a key
+    next_positions_.assign(vocabulary_.size(), kNoPosition);
+    std::vector<size_t> last_positions(vocabulary_.size());
+    for (size_t i = 0, end = vocabulary_.size(); i < end; ++i) {
+      const size_t* first = FindPosition(first_positions_, vocabulary_[i]);
+      if (first == nullptr) {
+        InsertPosition(first_positions_, vocabulary_[i], i);
+        last_positions[i] = i;
+      } else {
+        next_positions_[last_positions[*first]] = i;
+        last_positions[*first] = i;
+      }
+    }
   }
   common::Status Compute(OpKernelContext* ctx) const override {
     auto map = ctx->Input<std::map<AttrType, TargetType> >(0);
     auto Y = ctx->Output(0, TensorShape({1, static_cast<int64_t>(vocabulary_.size())}));
     auto* y_data = Y->template MutableData<TargetType>();
+    if (map->size() < vocabulary_.size()) {
+      // look up the few keys of the input instead of every key of the vocabulary
+      //Any keys not present in the input dictionary, will be zero in the output array
+      std::fill(y_data, y_data + vocabulary_.size(), TargetType());
+      for (const auto& entry : *map) {
+        const size_t* first = FindPosition(first_positions_, entry.first);
+        for (size_t i = first == nullptr ? kNoPosition : *first; i != kNoPosition; i = next_positions_[i]) {
+          y_data[i] = entry.second;
+        }
+      }
+      return Status::OK();
+    }
     for (size_t i = 0, end = vocabulary_.size(); i < end; ++i) {
       auto index = map->find(vocabulary_[i]);
       if (index != map->end()) {
@@ -34,8 +66,35 @@ class DictVectorizerOp final : public OpKernel {
   }
 
   std::vector<AttrType> vocabulary_;
+
+ private:
+  using PositionMap = typename std::conditional<std::is_same<AttrType, std::string>::value, FlatStringMap<size_t>,
+                                                std::unordered_map<AttrType, size_t>>::type;
+
+  static const size_t* FindPosition(const FlatStringMap<size_t>& positions, const std::string& key) {
+    return positions.Find(key);
+  }
+  static const size_t* FindPosition(const std::unordered_map<int64_t, size_t>& positions, int64_t key) {
+    auto it = positions.find(key);
+    return it == positions.end() ? nullptr : &it->second;
+  }
+  static void InsertPosition(FlatStringMap<size_t>& positions, const std::string& key, size_t position) {
+    positions.Insert(key, position);
+  }
+  static void InsertPosition(std::unordered_map<int64_t, size_t>& positions, int64_t key, size_t position) {
+    positions[key] = position;
+  }
+
+  static constexpr size_t kNoPosition = std::numeric_limits<size_t>::max();
+
+  // the first position of every key in vocabulary_, and the next position of the same key after every position
+  PositionMap first_positions_;
+  std::vector<size_t> next_positions_;
 };
 
+template <typename AttrType, typename TargetType>
+constexpr size_t DictVectorizerOp<AttrType, TargetType>::kNoPosition;
+
 }  // namespace ml
 
 }  // namespace onnxruntime
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace onnxruntime {
+namespace ml {
+
+/**
+  * A map of strings to values for the vocabularies of the ML ops, which are built once when the kernel is created
+  * and then only looked up. The keys are stored back to back in one buffer, and the table is open addressed with
+  * linear probing over slots that hold the hash, the location of the key and the value, so a lookup hashes the key
+  * once, compares the stored hashes of a few adjacent slots and compares the bytes of a key only on a hash match.
+  * Keys are looked up by their bytes, so no std::string has to be made for them.
+  */
+template <typename V>
+class FlatStringMap {
+ public:
+  // inserts key, or replaces its value if it is already in the map
+  void Insert(const std::string& key, const V& value) {
+    const uint64_t hash = Hash(key.data(), key.size());
+    const size_t index = FindSlot(hash, key.data(), key.size());
+    if (index != kNoSlot && slots_[index].offset != kNoSlot) {
+      slots_[index].value = value;
+      return;
+    }
+
+    // at most half of the slots are used so the runs of probed slots stay short
+    if ((size_ + 1) * 2 > slots_.size()) {
+      Rehash(slots_.empty() ? kMinSlots : slots_.size() * 2);
+    }
+
+    Slot& slot = slots_[FindSlot(hash, key.data(), key.size())];
+    slot.hash = hash;
+    slot.offset = keys_.size();
+    slot.size = key.size();
+    slot.value = value;
+    keys_.append(key);
+    ++size_;
+  }
+
+  // the value of the key of size bytes at data, or nullptr if it isn't in the map
+  const V* Find(const char* data, size_t size) const {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    const size_t index = FindSlot(Hash(data, size), data, size);
+    return slots_[index].offset == kNoSlot ? nullptr : &slots_[index].value;
+  }
+
+  const V* Find(const std::string& key) const { return Find(key.data(), key.size()); }
+
+  size_t Size() const { return size_; }
+
+ private:
+  struct Slot {
+    uint64_t hash;
+    // the key is keys_[offset, offset + size). offset is kNoSlot for an empty slot.
+    size_t offset = kNoSlot;
+    size_t size;
+    V value;
+  };
+
+  static constexpr size_t kNoSlot = std::numeric_limits<size_t>::max();
+  static constexpr size_t kMinSlots = 16;
+
+  // FNV-1a over 8 bytes at a time, with a final mix so the low bits that select the slot depend on every byte
+  static uint64_t Hash(const char* data, size_t size) {
+    const uint64_t kPrime = 0x100000001b3ULL;
+    uint64_t hash = 0xcbf29ce484222325ULL ^ size;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word;
+      std::memcpy(&word, data + i, sizeof(word));
+      hash = (hash ^ word) * kPrime;
+    }
+    for (; i < size; ++i) {
+      hash = (hash ^ static_cast<unsigned char>(data[i])) * kPrime;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  // the slot of the key, or the empty slot it would go to. kNoSlot if the table has no slots yet.
+  size_t FindSlot(uint64_t hash, const char* data, size_t size) const {
+    if (slots_.empty()) {
+      return kNoSlot;
+    }
+    const size_t mask = slots_.size() - 1;
+    for (size_t index = static_cast<size_t>(hash) & mask;; index = (index + 1) & mask) {
+      const Slot& slot = slots_[index];
+      if (slot.offset == kNoSlot ||
+          (slot.hash == hash && slot.size == size && std::memcmp(keys_.data() + slot.offset, data, size) == 0)) {
+        return index;
+      }
+    }
+  }
+
+  // the hashes are stored so the keys don't have to be hashed again
+  void Rehash(size_t num_slots) {
+    std::vector<Slot> slots(num_slots);
+    const size_t mask = num_slots - 1;
+    for (const Slot& slot : slots_) {
+      if (slot.offset == kNoSlot) {
+        continue;
+      }
+      size_t index = static_cast<size_t>(slot.hash) & mask;
+      while (slots[index].offset != kNoSlot) {
+        index = (index + 1) & mask;
+      }
+      slots[index] = slot;
+    }
+    slots_.swap(slots);
+  }
+
+  // the number of slots is a power of 2
+  std::vector<Slot> slots_;
+  std::string keys_;
+  size_t size_ = 0;
+};
+
+template <typename V>
+constexpr size_t FlatStringMap<V>::kNoSlot;
+
+template <typename V>
+constexpr size_t FlatStringMap<V>::kMinSlots;
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -50,6 +50,7 @@ LinearClassifier<T>::LinearClassifier(const OpKernelInfo& info) : OpKernel(info)
 
   using_strings_ = !classlabels_strings_.empty();
   class_count_ = static_cast<int64_t>(intercepts_.size());
+  PackLinearCoefficients(coefficients_, class_count_, info.GetAllocator(0, OrtMemTypeDefault), packed_coefficients_);
 }
 
 template <typename T>
@@ -73,36 +74,16 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
   }
   Tensor* Z = ctx->Output(1, TensorShape({N, output_classes}));
 
-  int64_t zindex = 0;
   const auto* x_data = X->template Data<T>();
 
   size_t class_count = static_cast<size_t>(class_count_);
-  std::vector<float> scores;
-  scores.reserve(class_count);
-  for (int64_t i = 0; i < N; i++)  //for each point
-  {
-    scores.clear();
-    size_t current_weight_0 = i * stride;
-    int maxclass = -1;
-    float maxweight = 0.f;
-    for (int j = 0; j < class_count; j++)  //for each class
-    {
-      size_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight += static_cast<float>(x_data[current_weight_0 + k] * coefficients_[current_coeff_0 + k]);
-      }
-      if (intercepts_.size() == class_count) {
-        weight += intercepts_[j];
-      }
-      scores.push_back(weight);
-      if (weight > maxweight || maxclass == -1) {
-        maxweight = weight;
-        maxclass = j;
-      }
-    }
-    //write top class
+  if (coefficients_.size() < class_count * static_cast<size_t>(stride)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input has more features than there are coefficients for.");
+  }
+
+  // writes the label of the class the scores of point i favour
+  auto write_label = [this, Y](int64_t i, int maxclass, float maxweight) {
     if (intercepts_.size() == 1)  //binary
     {
       if (using_strings_) {
@@ -135,16 +116,42 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
         Y->template MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
       }
     }
-    //write float values
-    if (add_second_class && maxweight > 0) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 0);
-    } else if (add_second_class) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 1);
-    } else {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, -1);
+  };
+
+  if (add_second_class) {
+    // the score of the single class is written with the score of the other
+    std::vector<float> all_scores(static_cast<size_t>(N));
+    ComputeLinearScores(x_data, N, stride, coefficients_, class_count_, stride, all_scores.data(),
+                        packed_coefficients_.get());
+    std::vector<float> scores;
+    for (int64_t i = 0; i < N; i++) {
+      const float weight = all_scores[i] + intercepts_[0];
+      write_label(i, 0, weight);
+      scores.assign(1, weight);
+      ::onnxruntime::ml::write_scores(scores, post_transform_, i * output_classes, Z, weight > 0 ? 0 : 1);
+    }
+    return Status::OK();
+  }
+
+  // the scores are computed, offset and transformed in the output, in parallel over the points
+  float* scores = Z->template MutableData<float>();
+  ComputeLinearScores(x_data, N, stride, coefficients_, class_count_, stride, scores, packed_coefficients_.get());
+  RunRowsInParallel(N, class_count_, kMinParallelLinearScores, [&](int64_t row_begin, int64_t row_end) {
+    for (int64_t i = row_begin; i < row_end; i++) {
+      float* row = scores + i * class_count_;
+      int maxclass = -1;
+      float maxweight = 0.f;
+      for (int j = 0; j < class_count_; j++) {
+        row[j] += intercepts_[j];
+        if (row[j] > maxweight || maxclass == -1) {
+          maxweight = row[j];
+          maxclass = j;
+        }
+      }
+      write_label(i, maxclass, maxweight);
     }
-    zindex += scores.size();
-  }  //for each point
+  });
+  ApplyPostTransform(scores, N, class_count_, post_transform_);
   return Status::OK();
 }
 
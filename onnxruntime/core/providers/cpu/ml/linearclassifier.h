@@ -26,6 +26,8 @@ class LinearClassifier final : public OpKernel {
   std::vector<float> intercepts_;
   std::vector<std::string> classlabels_strings_;
   std::vector<int64_t> classlabels_ints_;
+  // coefficients_ packed for MlasSgemmPacked
+  BufferUniquePtr packed_coefficients_;
 };
 
 }  // namespace ml
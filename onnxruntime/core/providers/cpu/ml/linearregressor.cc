@@ -18,6 +18,7 @@ LinearRegressor<T>::LinearRegressor(const OpKernelInfo& info) : OpKernel(info),
                                                                 post_transform_(MakeTransform(info.GetAttrOrDefault<std::string>("post_transform", "NONE"))) {
   ORT_ENFORCE(info.GetAttr<int64_t>("targets", &targets_).IsOK());
   ORT_ENFORCE(info.GetAttrs<float>("coefficients", coefficients_).IsOK());
+  PackLinearCoefficients(coefficients_, targets_, info.GetAllocator(0, OrtMemTypeDefault), packed_coefficients_);
 }
 
 template <>
@@ -32,29 +33,23 @@ Status LinearRegressor<float>::Compute(OpKernelContext* ctx) const {
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
   Tensor* Y = ctx->Output(0, TensorShape({N, targets_}));
   const auto* Xdata = X->template Data<float>();
-  int64_t yindex = 0;
-
-  bool useIntercepts = intercepts_.size() == static_cast<size_t>(targets_) ? true : false;
-  for (int64_t i = 0; i < N; i++)  //for each point
-  {
-    std::vector<float> scores;
-    int64_t current_weight_0 = i * stride;
-    for (int j = 0; j < targets_; j++)  //for each target
-    {
-      int64_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight = weight + Xdata[current_weight_0 + k] * coefficients_[current_coeff_0 + k];
-      }
-      if (useIntercepts) {
-        weight = weight + intercepts_[j];
+
+  if (coefficients_.size() < static_cast<size_t>(targets_ * stride)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input has more features than there are coefficients for.");
+  }
+
+  // the scores are computed, offset and transformed in the output
+  float* scores = Y->template MutableData<float>();
+  ComputeLinearScores(Xdata, N, stride, coefficients_, targets_, stride, scores, packed_coefficients_.get());
+  if (intercepts_.size() == static_cast<size_t>(targets_)) {
+    for (int64_t i = 0; i < N; i++) {
+      for (int64_t j = 0; j < targets_; j++) {
+        scores[i * targets_ + j] += intercepts_[j];
       }
-      scores.push_back(weight);
     }
-    ::onnxruntime::ml::write_scores(scores, post_transform_, yindex, Y, -1);
-    yindex += scores.size();
   }
+  ApplyPostTransform(scores, N, targets_, post_transform_);
   return Status::OK();
 }
 
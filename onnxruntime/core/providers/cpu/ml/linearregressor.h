@@ -22,6 +22,8 @@ class LinearRegressor final : public OpKernel {
   std::vector<float> coefficients_;
   std::vector<float> intercepts_;
   POST_EVAL_TRANSFORM post_transform_;
+  // coefficients_ packed for MlasSgemmPacked
+  BufferUniquePtr packed_coefficients_;
 };
 
 }  // namespace ml
@@ -2,8 +2,14 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 #include "core/common/common.h"
+#include "core/common/task_thread_pool.h"
+#include "core/framework/environment.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -280,6 +286,175 @@ static inline void compute_softmax_zero(std::vector<float>& values) {
   }
 }
 
+// the number of threads, including the calling thread, that a kernel may split work_items similar items of work
+// between on the intra-op thread pool, which is returned in pool. the thread limit of the Run applies as it does to
+// MLAS. 1 if there is no pool or fewer than min_work_items items.
+static inline int64_t GetIntraOpThreads(int64_t work_items, int64_t min_work_items, TaskThreadPool*& pool) {
+  pool = Environment::GetIntraOpThreadPool();
+  if (pool == nullptr || work_items < min_work_items) {
+    return 1;
+  }
+  int64_t num_threads = pool->NumThreads() + 1;
+  const int32_t thread_limit = MlasGetThreadLimit();
+  if (thread_limit > 0) {
+    num_threads = std::min<int64_t>(num_threads, thread_limit);
+  }
+  return num_threads;
+}
+
+// the fraction of features, as 1 in kSparseFeatureRatio, below which linear models multiply only the nonzero
+// features of a batch with their coefficients
+constexpr int64_t kSparseFeatureRatio = 16;
+// the multiply-adds below which linear models score a batch on the calling thread
+constexpr int64_t kMinParallelLinearScores = 1 << 16;
+
+// runs process_rows(row_begin, row_end) over the N rows of a batch, split between the threads of the intra-op thread
+// pool when the rows hold at least min_work_items items of work_per_row each.
+template <typename TFunc>
+void RunRowsInParallel(int64_t N, int64_t work_per_row, int64_t min_work_items, TFunc process_rows) {
+  TaskThreadPool* pool = nullptr;
+  const int64_t num_threads = std::min(GetIntraOpThreads(N * work_per_row, min_work_items, pool), N);
+  if (num_threads <= 1) {
+    process_rows(0, N);
+    return;
+  }
+  pool->ParallelFor(static_cast<int32_t>(num_threads), [&](int32_t i) {
+    process_rows(N * i / num_threads, N * (i + 1) / num_threads);
+  });
+}
+
+// packs the num_targets rows of coefficients, of coefficients.size() / num_targets features each, once for the SGEMM
+// of ComputeLinearScores. packed is left empty if they don't divide into rows.
+static inline void PackLinearCoefficients(const std::vector<float>& coefficients, int64_t num_targets,
+                                          const AllocatorPtr& alloc, BufferUniquePtr& packed) {
+  if (alloc == nullptr || num_targets <= 0 || coefficients.empty() ||
+      coefficients.size() % static_cast<size_t>(num_targets) != 0) {
+    return;
+  }
+  const size_t N = static_cast<size_t>(num_targets);
+  const size_t K = coefficients.size() / N;
+  void* buffer = alloc->Alloc(MlasSgemmPackBSize(N, K));
+  packed = BufferUniquePtr(buffer, BufferDeleter(alloc));
+  MlasSgemmPackB(CblasTrans, N, K, coefficients.data(), K, buffer);
+}
+
+// scores[n * num_targets + j] = x[n] . coefficients[j] for the N rows of x, which are stride apart, and the
+// num_targets rows of len coefficients. a batch of mostly zero features, as one-hot encoding or a DictVectorizer
+// over a large vocabulary produce, is multiplied by its nonzero features only, in parallel over rows. a denser
+// batch is multiplied with one SGEMM, of packed_coefficients from PackLinearCoefficients if given and the rows of
+// coefficients are of len.
+template <typename T>
+void ComputeLinearScores(const T* x, int64_t N, int64_t stride, const std::vector<float>& coefficients,
+                         int64_t num_targets, int64_t len, float* scores,
+                         const void* packed_coefficients = nullptr) {
+  if (N == 0 || num_targets == 0) {
+    return;
+  }
+  if (len == 0) {
+    std::fill_n(scores, N * num_targets, 0.f);
+    return;
+  }
+
+  int64_t nonzeros = 0;
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t i = 0; i < len; i++) {
+      nonzeros += x[n * stride + i] != 0 ? 1 : 0;
+    }
+  }
+
+  if (nonzeros * kSparseFeatureRatio <= N * len) {
+    const int64_t nonzeros_per_row = std::max<int64_t>(nonzeros / N, 1);
+    RunRowsInParallel(N, nonzeros_per_row * num_targets, kMinParallelLinearScores,
+                      [&](int64_t row_begin, int64_t row_end) {
+                        std::vector<int64_t> features;
+                        for (int64_t n = row_begin; n < row_end; n++) {
+                          const T* row = x + n * stride;
+                          features.clear();
+                          for (int64_t i = 0; i < len; i++) {
+                            if (row[i] != 0) {
+                              features.push_back(i);
+                            }
+                          }
+                          for (int64_t j = 0; j < num_targets; j++) {
+                            const float* target_coefficients = coefficients.data() + j * len;
+                            float score = 0.f;
+                            for (int64_t i : features) {
+                              score += static_cast<float>(row[i] * target_coefficients[i]);
+                            }
+                            scores[n * num_targets + j] = score;
+                          }
+                        }
+                      });
+    return;
+  }
+
+  const float* a = nullptr;
+  int64_t lda = stride;
+  std::vector<float> converted;
+  if (std::is_same<T, float>::value) {
+    a = reinterpret_cast<const float*>(x);
+  } else {
+    converted.resize(static_cast<size_t>(N * len));
+    for (int64_t n = 0; n < N; n++) {
+      for (int64_t i = 0; i < len; i++) {
+        converted[n * len + i] = static_cast<float>(x[n * stride + i]);
+      }
+    }
+    a = converted.data();
+    lda = len;
+  }
+  if (packed_coefficients != nullptr && static_cast<size_t>(num_targets * len) == coefficients.size()) {
+    MlasSgemmPacked(CblasNoTrans, static_cast<size_t>(N), static_cast<size_t>(num_targets),
+                    static_cast<size_t>(len), 1.f, a, static_cast<size_t>(lda), packed_coefficients, 0.f, scores,
+                    static_cast<size_t>(num_targets));
+    return;
+  }
+  MlasSgemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), static_cast<size_t>(num_targets),
+            static_cast<size_t>(len), 1.f, a, static_cast<size_t>(lda), coefficients.data(),
+            static_cast<size_t>(len), 0.f, scores, static_cast<size_t>(num_targets));
+}
+
+// applies post_transform in place to each of the N rows of num_scores scores, as write_scores does to the scores of
+// a row without a second class. the logistic and softmax of a batch are computed by MLAS.
+static inline void ApplyPostTransform(float* scores, int64_t N, int64_t num_scores,
+                                      POST_EVAL_TRANSFORM post_transform) {
+  if (N == 0 || num_scores == 0) {
+    return;
+  }
+  if (num_scores == 1) {
+    if (post_transform == POST_EVAL_TRANSFORM::PROBIT) {
+      for (int64_t n = 0; n < N; n++) {
+        scores[n] = ml_sqrt2 * ml_inv_erf(2 * scores[n] - 1);
+      }
+    }
+    return;
+  }
+
+  switch (post_transform) {
+    case POST_EVAL_TRANSFORM::LOGISTIC:
+      RunRowsInParallel(N, num_scores, kMinParallelLinearScores, [&](int64_t row_begin, int64_t row_end) {
+        MlasComputeLogistic(scores + row_begin * num_scores, scores + row_begin * num_scores,
+                            static_cast<size_t>((row_end - row_begin) * num_scores));
+      });
+      break;
+    case POST_EVAL_TRANSFORM::SOFTMAX:
+      MlasComputeSoftmax(scores, scores, static_cast<size_t>(N), static_cast<size_t>(num_scores), false);
+      break;
+    case POST_EVAL_TRANSFORM::SOFTMAX_ZERO:
+      RunRowsInParallel(N, num_scores, kMinParallelLinearScores, [&](int64_t row_begin, int64_t row_end) {
+        std::vector<float> row;
+        for (int64_t n = row_begin; n < row_end; n++) {
+          row.assign(scores + n * num_scores, scores + (n + 1) * num_scores);
+          compute_softmax_zero(row);
+          std::copy(row.begin(), row.end(), scores + n * num_scores);
+        }
+      });
+      break;
+    default:
+      break;
+  }
+}
+
 static inline void write_scores(std::vector<float>& scores, POST_EVAL_TRANSFORM post_transform, int64_t write_index, Tensor* Z, int add_second_class) {
   if (post_transform == POST_EVAL_TRANSFORM::PROBIT && scores.size() == 1) {
     scores[0] = ml_sqrt2 * ml_inv_erf(2 * scores[0] - 1);
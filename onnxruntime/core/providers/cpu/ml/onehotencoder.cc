@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/onehotencoder.h"
+#include <atomic>
+#include "core/providers/cpu/ml/ml_common.h"
 /**
 https://github.com/onnx/onnx/blob/master/onnx/defs/traditionalml/defs.cc
 ONNX_OPERATOR_SCHEMA(OneHotEncoder)
@@ -35,6 +37,11 @@ using namespace std;
 namespace onnxruntime {
 namespace ml {
 
+namespace {
+// the output values below which the inputs are encoded on one thread
+const int64_t kMinParallelEncodedValues = 64 * 1024;
+}  // namespace
+
 #define REG_KERNEL(TYPE)                                                           \
   ONNX_CPU_OPERATOR_TYPED_ML_KERNEL(                                               \
       OneHotEncoder,                                                               \
@@ -55,13 +62,17 @@ OneHotEncoderOp<T>::OneHotEncoderOp(const OpKernelInfo& info) : OpKernel(info),
   ORT_ENFORCE(tmp_cats_int64s.empty() || tmp_cats_strings.empty());
   if (!tmp_cats_int64s.empty()) {
     num_categories_ = tmp_cats_int64s.size();
+    consecutive_int64s_ = true;
+    cats_int64s_begin_ = tmp_cats_int64s[0];
     for (size_t idx = 0, end = tmp_cats_int64s.size(); idx < end; ++idx) {
       cats_int64s_[tmp_cats_int64s[idx]] = idx;
+      consecutive_int64s_ = consecutive_int64s_ &&
+                            tmp_cats_int64s[idx] == cats_int64s_begin_ + static_cast<int64_t>(idx);
     }
   } else {
     num_categories_ = tmp_cats_strings.size();
     for (size_t idx = 0, end = tmp_cats_strings.size(); idx < end; ++idx) {
-      cats_strings_[tmp_cats_strings[idx]] = idx;
+      cats_strings_.Insert(tmp_cats_strings[idx], idx);
     }
   }
   ORT_ENFORCE(num_categories_ > 0);
@@ -78,16 +89,35 @@ common::Status OneHotEncoderOp<T>::Compute(OpKernelContext* context) const {
 
   Tensor* Y = context->Output(0, TensorShape(output_shape));
   auto y_data = Y->template MutableData<float>();
-  std::fill_n(y_data, Y->Shape().Size(), 0.0f);
 
   auto x_data = X->template Data<T>();
-  std::unordered_map<int64_t, size_t>::const_iterator idx;
-  for (int64_t i = 0; i < input_shape.Size(); ++i) {
-    auto int_idx = cats_int64s_.find(static_cast<int64_t>(x_data[i]));
-    if (int_idx != cats_int64s_.cend())
-      y_data[i * num_categories_ + int_idx->second] = 1.0f;
-    else if (!zeros_)
-      return Status(ONNXRUNTIME, FAIL, "Unknown Category and zeros = 0.");
+  // each thread clears the rows of its inputs and sets the one of each
+  std::atomic<bool> unknown_category{false};
+  RunRowsInParallel(input_shape.Size(), num_categories_, kMinParallelEncodedValues,
+                    [&](int64_t begin, int64_t end) {
+                      std::fill(y_data + begin * num_categories_, y_data + end * num_categories_, 0.0f);
+                      for (int64_t i = begin; i < end; ++i) {
+                        const int64_t value = static_cast<int64_t>(x_data[i]);
+                        if (consecutive_int64s_) {
+                          const int64_t category = value - cats_int64s_begin_;
+                          if (category >= 0 && category < num_categories_) {
+                            y_data[i * num_categories_ + category] = 1.0f;
+                            continue;
+                          }
+                        } else {
+                          auto int_idx = cats_int64s_.find(value);
+                          if (int_idx != cats_int64s_.cend()) {
+                            y_data[i * num_categories_ + int_idx->second] = 1.0f;
+                            continue;
+                          }
+                        }
+                        if (!zeros_) {
+                          unknown_category = true;
+                        }
+                      }
+                    });
+  if (unknown_category) {
+    return Status(ONNXRUNTIME, FAIL, "Unknown Category and zeros = 0.");
   }
   return Status::OK();
 }
@@ -103,15 +133,23 @@ common::Status OneHotEncoderOp<std::string>::Compute(OpKernelContext* context) c
 
   Tensor* Y = context->Output(0, TensorShape(output_shape));
   auto y_data = Y->template MutableData<float>();
-  std::fill_n(y_data, Y->Shape().Size(), 0.0f);
 
   auto x_data = X->template Data<std::string>();
-  for (int64_t i = 0; i < input_shape.Size(); ++i) {
-    auto str_idx = cats_strings_.find(x_data[i]);
-    if (str_idx != cats_strings_.cend())
-      y_data[i * num_categories_ + str_idx->second] = 1.0f;
-    else if (!zeros_)
-      return Status(ONNXRUNTIME, FAIL, "Unknown Category and zeros = 0.");
+  std::atomic<bool> unknown_category{false};
+  RunRowsInParallel(input_shape.Size(), num_categories_, kMinParallelEncodedValues,
+                    [&](int64_t begin, int64_t end) {
+                      std::fill(y_data + begin * num_categories_, y_data + end * num_categories_, 0.0f);
+                      for (int64_t i = begin; i < end; ++i) {
+                        const size_t* str_idx = cats_strings_.Find(x_data[i]);
+                        if (str_idx != nullptr) {
+                          y_data[i * num_categories_ + *str_idx] = 1.0f;
+                        } else if (!zeros_) {
+                          unknown_category = true;
+                        }
+                      }
+                    });
+  if (unknown_category) {
+    return Status(ONNXRUNTIME, FAIL, "Unknown Category and zeros = 0.");
   }
   return Status::OK();
 }
@@ -4,6 +4,7 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/flat_string_map.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -15,7 +16,10 @@ class OneHotEncoderOp final : public OpKernel {
 
  private:
   std::unordered_map<int64_t, size_t> cats_int64s_;
-  std::unordered_map<std::string, size_t> cats_strings_;
+  // whether cats_int64s are consecutive from cats_int64s_begin_, so the category of a value is its offset from it
+  bool consecutive_int64s_{false};
+  int64_t cats_int64s_begin_{0};
+  FlatStringMap<size_t> cats_strings_;
   int64_t zeros_;
   int64_t num_categories_;
 };
@@ -95,21 +95,21 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
   const auto* x_data = X->template Data<T>();
   int64_t zindex = 0;
 
+  // the kernels of all examples with every support vector, or the linear scores of every class
+  const int64_t kernel_count = mode_ == SVM_TYPE::SVM_SVC ? vector_count_ : class_count_;
+  std::vector<float> kernels(static_cast<size_t>(N * kernel_count));
+  batched_kernel_dot(x_data, N, stride, mode_ == SVM_TYPE::SVM_SVC ? support_vectors_ : coefficients_, kernel_count,
+                     feature_count_, get_kernel_type(), kernels.data());
+
   for (int64_t n = 0; n < N; n++)  //for each example
   {
-    int64_t current_weight_0 = n * stride;
+    const float* row_kernels = kernels.data() + n * kernel_count;
     int64_t maxclass = -1;
     double maxweight = 0.f;
-    std::vector<float> decisions;
     std::vector<float> scores;
-    std::vector<float> kernels;
     std::vector<int64_t> votes;
 
     if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        kernels.push_back(val);
-      }
       for (int64_t j = 0; j < class_count_; j++) {
         votes.push_back(0);
       }
@@ -127,12 +127,12 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
           int64_t pos2 = (vector_count_) * (i);
           for (int64_t m = 0; m < class_i_support_count; m++) {
             float val1 = coefficients_[pos1 + start_index_i + m];
-            float val2 = kernels[start_index_i + m];
+            float val2 = row_kernels[start_index_i + m];
             sum += val1 * val2;
           }
           for (int64_t m = 0; m < class_j_support_count; m++) {
             float val1 = coefficients_[pos2 + start_index_j + m];
-            float val2 = kernels[start_index_j + m];
+            float val2 = row_kernels[start_index_j + m];
             sum += val1 * val2;
           }
 
@@ -148,8 +148,7 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
       }
     } else if (mode_ == SVM_TYPE::SVM_LINEAR) {     //liblinear
       for (int64_t j = 0; j < class_count_; j++) {  //for each class
-        float val = kernel_dot(x_data, current_weight_0, coefficients_, feature_count_ * j, feature_count_, get_kernel_type());
-        val += rho_[0];
+        float val = row_kernels[j] + rho_[0];
         scores.push_back(val);
       }
     }
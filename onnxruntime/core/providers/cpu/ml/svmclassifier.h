@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <type_traits>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
 
@@ -29,35 +33,96 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
-  float kernel_dot(const T* A, int64_t a, const std::vector<float>& B, int64_t b, int64_t len, KERNEL k) const {
-    float sum = 0.f;
-    if (k == KERNEL::POLY) {
-      for (int64_t i = 0; i < len; i++) {
-        sum += B[b + i] * static_cast<float>(A[a + i]);
-      }
-      sum = gamma_ * sum + coef0_;
-      sum = std::pow(sum, degree_);
-    } else if (k == KERNEL::SIGMOID) {
-      for (int64_t i = 0; i < len; i++) {
-        sum += B[b + i] * static_cast<float>(A[a + i]);
+  // the kernel of every row of x, whose rows are stride apart, with every vector of len floats in B, in
+  // kernels[n * num_vectors + j]: the dot product for LINEAR, (gamma * dot + coef0)^degree for POLY,
+  // tanh(gamma * dot + coef0) for SIGMOID and exp(-gamma * |x - b|^2) for RBF.
+  // the dot products of all rows and vectors are computed with one SGEMM, and RBF uses
+  // |x - b|^2 = |x|^2 - 2 x.b + |b|^2. the kernel functions are applied to the rows in parallel.
+  void batched_kernel_dot(const T* x, int64_t N, int64_t stride, const std::vector<float>& B, int64_t num_vectors,
+                          int64_t len, KERNEL k, float* kernels) const {
+    if (N == 0 || num_vectors == 0) {
+      return;
+    }
+
+    const float* a = nullptr;
+    int64_t lda = stride;
+    std::vector<float> converted;
+    if (std::is_same<T, float>::value && stride >= len) {
+      a = reinterpret_cast<const float*>(x);
+    } else {
+      converted.resize(static_cast<size_t>(N * len));
+      for (int64_t n = 0; n < N; n++) {
+        for (int64_t i = 0; i < len; i++) {
+          converted[n * len + i] = static_cast<float>(x[n * stride + i]);
+        }
       }
-      sum = gamma_ * sum + coef0_;
-      sum = std::tanh(sum);
-    } else if (k == KERNEL::RBF) {
-      for (int64_t i = 0; i < len; i++) {
-        float val = static_cast<float>(A[a + i]) - B[b + i];
-        sum += (val * val);
+      a = converted.data();
+      lda = len;
+    }
+
+    if (len == 0) {
+      std::fill_n(kernels, N * num_vectors, 0.f);
+    } else {
+      MlasSgemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), static_cast<size_t>(num_vectors),
+                static_cast<size_t>(len), k == KERNEL::RBF ? -2.f : 1.f, a, static_cast<size_t>(lda), B.data(),
+                static_cast<size_t>(len), 0.f, kernels, static_cast<size_t>(num_vectors));
+    }
+    if (k == KERNEL::LINEAR) {
+      return;
+    }
+
+    std::vector<float> vector_norms;
+    if (k == KERNEL::RBF) {
+      vector_norms.resize(static_cast<size_t>(num_vectors));
+      for (int64_t j = 0; j < num_vectors; j++) {
+        float norm = 0.f;
+        for (int64_t i = 0; i < len; i++) {
+          norm += B[j * len + i] * B[j * len + i];
+        }
+        vector_norms[j] = norm;
       }
-      sum = std::exp(-gamma_ * sum);
-    } else if (k == KERNEL::LINEAR) {
-      for (int64_t i = 0; i < len; i++) {
-        sum += B[b + i] * static_cast<float>(A[a + i]);
+    }
+
+    auto apply_kernel = [&](int64_t row_begin, int64_t row_end) {
+      for (int64_t n = row_begin; n < row_end; n++) {
+        float* row_kernels = kernels + n * num_vectors;
+        if (k == KERNEL::RBF) {
+          float row_norm = 0.f;
+          for (int64_t i = 0; i < len; i++) {
+            row_norm += a[n * lda + i] * a[n * lda + i];
+          }
+          for (int64_t j = 0; j < num_vectors; j++) {
+            // rounding can make the distance of a row to itself slightly negative
+            float sum = std::max(row_kernels[j] + row_norm + vector_norms[j], 0.f);
+            row_kernels[j] = std::exp(-gamma_ * sum);
+          }
+        } else if (k == KERNEL::POLY) {
+          for (int64_t j = 0; j < num_vectors; j++) {
+            row_kernels[j] = std::pow(gamma_ * row_kernels[j] + coef0_, degree_);
+          }
+        } else if (k == KERNEL::SIGMOID) {
+          for (int64_t j = 0; j < num_vectors; j++) {
+            row_kernels[j] = std::tanh(gamma_ * row_kernels[j] + coef0_);
+          }
+        }
       }
+    };
+
+    TaskThreadPool* pool = nullptr;
+    const int64_t num_threads = std::min(GetIntraOpThreads(N * num_vectors, kMinParallelKernels, pool), N);
+    if (num_threads == 1) {
+      apply_kernel(0, N);
+      return;
     }
-    return sum;
+    pool->ParallelFor(static_cast<int32_t>(num_threads), [&](int32_t i) {
+      apply_kernel(N * i / num_threads, N * (i + 1) / num_threads);
+    });
   }
 
  private:
+  // the kernel values computed below which the kernel functions are applied on the calling thread
+  static constexpr int64_t kMinParallelKernels = 4096;
+
   KERNEL kernel_type_;
   float gamma_;
   float coef0_;
@@ -66,7 +131,7 @@ class SVMCommon {
 
 template <typename T>
 class SVMClassifier final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::batched_kernel_dot;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -46,22 +46,23 @@ Status SVMRegressor<T>::Compute(OpKernelContext* ctx) const {
   Tensor* Y = ctx->Output(0, TensorShape({N, 1}));  // this op outputs for one target only
   const auto* x_data = X->template Data<T>();
 
+  // the kernels of all examples with every support vector, or the linear score of every example
+  const int64_t kernel_count = mode_ == SVM_TYPE::SVM_SVC ? vector_count_ : 1;
+  std::vector<float> kernels(static_cast<size_t>(N * kernel_count));
+  batched_kernel_dot(x_data, N, stride, mode_ == SVM_TYPE::SVM_SVC ? support_vectors_ : coefficients_, kernel_count,
+                     feature_count_, get_kernel_type(), kernels.data());
+
   for (int64_t n = 0; n < N; n++) {  //for each example
-    int64_t current_weight_0 = n * stride;
-    std::vector<float> scores;
+    const float* row_kernels = kernels.data() + n * kernel_count;
 
     float sum = 0.f;
     if (mode_ == SVM_TYPE::SVM_SVC) {
       for (int64_t j = 0; j < vector_count_; j++) {
-        float val1 = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        float val2 = coefficients_[j];
-        float val3 = val1 * val2;
-        sum += val3;
+        sum += row_kernels[j] * coefficients_[j];
       }
       sum += rho_[0];
     } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
-      sum = kernel_dot(x_data, current_weight_0, coefficients_, 0, feature_count_, get_kernel_type());
-      sum += rho_[0];
+      sum = row_kernels[0] + rho_[0];
     }
     if (one_class_ && sum > 0) {
       Y->template MutableData<float>()[n] = 1.f;
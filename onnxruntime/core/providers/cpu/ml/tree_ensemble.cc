@@ -0,0 +1,404 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/ml/tree_ensemble.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace onnxruntime {
+namespace ml {
+
+namespace {
+struct TreeNodeIdHash {
+  size_t operator()(const std::pair<int64_t, int64_t>& id) const {
+    return std::hash<int64_t>{}(id.first) ^ (std::hash<int64_t>{}(id.second) << 1);
+  }
+};
+
+// the rows that go down a tree together. their paths are walked in lockstep, so the loads of their nodes overlap
+// instead of every row waiting for the node it reads next.
+constexpr int64_t kRowBlockSize = 16;
+
+// the tree evaluations of a batch below which it is scored on the calling thread
+constexpr int64_t kMinParallelEvaluations = 4096;
+
+template <typename T>
+inline const TreeNodeElement* NextNode(const TreeNodeElement* nodes, const TreeNodeElement& node, const T* x) {
+  const T val = x[node.feature_id];
+  bool condition;
+  switch (node.mode) {
+    case NODE_MODE::BRANCH_LEQ:
+      condition = val <= node.value;
+      break;
+    case NODE_MODE::BRANCH_LT:
+      condition = val < node.value;
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      condition = val >= node.value;
+      break;
+    case NODE_MODE::BRANCH_GT:
+      condition = val > node.value;
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      condition = val == node.value;
+      break;
+    default:
+      condition = val != node.value;
+      break;
+  }
+  if (node.missing_tracks_true && std::isnan(static_cast<float>(val))) {
+    condition = true;
+  }
+  return nodes + (condition ? node.truenode : node.falsenode);
+}
+
+// the leaves of a tree evaluated with QuickScorer fit the bits of a uint64_t
+constexpr size_t kMaxQuickScorerLeaves = 64;
+
+inline int LowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, bits);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctzll(bits);
+#endif
+}
+
+// numbers the leaves under the node at index from left to right, and adds its branch nodes with the feature they
+// test. returns false if the subtree can't be evaluated with QuickScorer.
+bool AddQuickScorerNodes(const std::vector<TreeNodeElement>& nodes, int32_t index, int64_t depth, int64_t max_depth,
+                         uint32_t tree, std::vector<bool>& visited, std::vector<int32_t>& leaves,
+                         std::vector<std::pair<int32_t, QuickScorerNode>>& branches) {
+  // a node reached twice would need a bit per path
+  if (depth > max_depth || visited[index]) {
+    return false;
+  }
+  visited[index] = true;
+
+  const TreeNodeElement& node = nodes[index];
+  if (node.mode == NODE_MODE::LEAF) {
+    if (leaves.size() == kMaxQuickScorerLeaves) {
+      return false;
+    }
+    leaves.push_back(index);
+    return true;
+  }
+
+  // a row goes right for larger values, which puts the true child of >= and > nodes on the right
+  bool swapped;
+  switch (node.mode) {
+    case NODE_MODE::BRANCH_LEQ:
+    case NODE_MODE::BRANCH_LT:
+      swapped = false;
+      break;
+    case NODE_MODE::BRANCH_GTE:
+    case NODE_MODE::BRANCH_GT:
+      swapped = true;
+      break;
+    default:
+      return false;
+  }
+  if (node.feature_id < 0) {
+    return false;
+  }
+
+  const size_t first_left_leaf = leaves.size();
+  if (!AddQuickScorerNodes(nodes, swapped ? node.falsenode : node.truenode, depth + 1, max_depth, tree, visited,
+                           leaves, branches)) {
+    return false;
+  }
+  const size_t num_left_leaves = leaves.size() - first_left_leaf;
+  // the right child has leaves too
+  if (num_left_leaves >= kMaxQuickScorerLeaves) {
+    return false;
+  }
+
+  QuickScorerNode branch;
+  branch.mask = ~(((uint64_t{1} << num_left_leaves) - 1) << first_left_leaf);
+  branch.value = node.value;
+  branch.tree = tree;
+  branch.strict = node.mode == NODE_MODE::BRANCH_LT || node.mode == NODE_MODE::BRANCH_GTE;
+  // a comparison with NaN is false, so NaN goes to the false child unless it is tracked to the true one
+  branch.nan_goes_right = swapped ? node.missing_tracks_true : !node.missing_tracks_true;
+  branches.emplace_back(node.feature_id, branch);
+
+  return AddQuickScorerNodes(nodes, swapped ? node.truenode : node.falsenode, depth + 1, max_depth, tree, visited,
+                             leaves, branches);
+}
+}  // namespace
+
+TreeEnsemble::TreeEnsemble(const std::vector<int64_t>& nodes_treeids,
+                           const std::vector<int64_t>& nodes_nodeids,
+                           const std::vector<int64_t>& nodes_featureids,
+                           const std::vector<float>& nodes_values,
+                           const std::vector<NODE_MODE>& nodes_modes,
+                           const std::vector<int64_t>& nodes_truenodeids,
+                           const std::vector<int64_t>& nodes_falsenodeids,
+                           const std::vector<int64_t>& missing_tracks_true,
+                           const std::vector<int64_t>& weights_treeids,
+                           const std::vector<int64_t>& weights_nodeids,
+                           const std::vector<int64_t>& weights_classids,
+                           const std::vector<float>& weights_values)
+    : num_classes_(0) {
+  const size_t num_nodes = nodes_treeids.size();
+  ORT_ENFORCE(num_nodes < static_cast<size_t>(std::numeric_limits<int32_t>::max()), "Too many tree nodes.");
+  ORT_ENFORCE(weights_values.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max()),
+              "Too many leaf weights.");
+
+  // the index of every node. node ids may restart at zero in every tree.
+  std::unordered_map<std::pair<int64_t, int64_t>, int32_t, TreeNodeIdHash> indices;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    indices.emplace(std::make_pair(nodes_treeids[i], nodes_nodeids[i]), static_cast<int32_t>(i));
+  }
+
+  const bool has_missing_tracks = missing_tracks_true.size() == num_nodes;
+  std::vector<bool> has_parent(num_nodes, false);
+  nodes_.resize(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    TreeNodeElement& node = nodes_[i];
+    node.value = nodes_values[i];
+    node.feature_id = static_cast<int32_t>(nodes_featureids[i]);
+    node.mode = nodes_modes[i];
+    node.missing_tracks_true = has_missing_tracks && missing_tracks_true[i] != 0;
+    node.truenode = 0;
+    node.falsenode = 0;
+    if (node.mode == NODE_MODE::LEAF) {
+      continue;
+    }
+    // the children must be in the same tree
+    auto true_it = indices.find(std::make_pair(nodes_treeids[i], nodes_truenodeids[i]));
+    auto false_it = indices.find(std::make_pair(nodes_treeids[i], nodes_falsenodeids[i]));
+    ORT_ENFORCE(true_it != indices.end() && false_it != indices.end(),
+                "The children of node ", nodes_nodeids[i], " of tree ", nodes_treeids[i], " do not exist.");
+    node.truenode = true_it->second;
+    node.falsenode = false_it->second;
+    has_parent[node.truenode] = true;
+    has_parent[node.falsenode] = true;
+  }
+
+  // the weights of a leaf are stored contiguously, in the order of the attributes.
+  // weights of nodes that don't exist are never reached and are dropped.
+  std::vector<std::pair<int32_t, TreeLeafWeight>> node_weights;
+  node_weights.reserve(weights_values.size());
+  for (size_t i = 0; i < weights_values.size(); ++i) {
+    ORT_ENFORCE(weights_classids[i] >= 0 && weights_classids[i] < std::numeric_limits<int32_t>::max(),
+                "Invalid class id ", weights_classids[i]);
+    auto it = indices.find(std::make_pair(weights_treeids[i], weights_nodeids[i]));
+    if (it == indices.end() || nodes_[it->second].mode != NODE_MODE::LEAF) {
+      continue;
+    }
+    node_weights.emplace_back(it->second, TreeLeafWeight{static_cast<int32_t>(weights_classids[i]), weights_values[i]});
+    num_classes_ = std::max(num_classes_, weights_classids[i] + 1);
+  }
+  std::stable_sort(node_weights.begin(), node_weights.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  weights_.reserve(node_weights.size());
+  for (size_t i = 0; i < node_weights.size(); ++i) {
+    TreeNodeElement& leaf = nodes_[node_weights[i].first];
+    if (i == 0 || node_weights[i - 1].first != node_weights[i].first) {
+      leaf.truenode = static_cast<int32_t>(i);
+    }
+    leaf.falsenode = static_cast<int32_t>(i + 1);
+    weights_.push_back(node_weights[i].second);
+  }
+
+  // the roots are the nodes no other node points at
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (!has_parent[i]) {
+      roots_.push_back(static_cast<int32_t>(i));
+    }
+  }
+
+  use_quick_scorer_ = InitializeQuickScorer();
+}
+
+bool TreeEnsemble::InitializeQuickScorer() {
+  std::vector<bool> visited(nodes_.size(), false);
+  std::vector<int32_t> leaves;
+  std::vector<std::pair<int32_t, QuickScorerNode>> branches;
+  quick_scorer_leaves_.assign(roots_.size() * kMaxQuickScorerLeaves, 0);
+  for (size_t tree = 0; tree < roots_.size(); ++tree) {
+    leaves.clear();
+    if (!AddQuickScorerNodes(nodes_, roots_[tree], 0, kMaxQuickScorerDepth_, static_cast<uint32_t>(tree), visited,
+                             leaves, branches)) {
+      quick_scorer_leaves_.clear();
+      return false;
+    }
+    std::copy(leaves.begin(), leaves.end(), quick_scorer_leaves_.begin() + tree * kMaxQuickScorerLeaves);
+  }
+
+  // by feature and threshold. of the nodes with the same threshold, the ones a row equal to it goes right at are
+  // visited first, so a row stops at the first node it goes left at.
+  std::stable_sort(branches.begin(), branches.end(), [](const auto& a, const auto& b) {
+    if (a.first != b.first) {
+      return a.first < b.first;
+    }
+    if (a.second.value != b.second.value) {
+      return a.second.value < b.second.value;
+    }
+    return a.second.strict && !b.second.strict;
+  });
+
+  const int32_t num_features = branches.empty() ? 0 : branches.back().first + 1;
+  quick_scorer_features_.assign(num_features + 1, 0);
+  quick_scorer_nodes_.reserve(branches.size());
+  for (const auto& branch : branches) {
+    ++quick_scorer_features_[branch.first + 1];
+    quick_scorer_nodes_.push_back(branch.second);
+  }
+  for (int32_t feature = 0; feature < num_features; ++feature) {
+    quick_scorer_features_[feature + 1] += quick_scorer_features_[feature];
+  }
+  return true;
+}
+
+template <typename T>
+void TreeEnsemble::AddRowScores(const T* x, int64_t row_begin, int64_t row_end, int64_t stride, size_t tree_begin,
+                                size_t tree_end, int64_t num_scores, float* scores,
+                                unsigned char* has_scores) const {
+  // all features that nodes test are read, which the rows must have
+  if (use_quick_scorer_ && stride >= static_cast<int64_t>(quick_scorer_features_.size()) - 1) {
+    AddRowScoresQuickScorer(x, row_begin, row_end, stride, tree_begin, tree_end, num_scores, scores, has_scores);
+    return;
+  }
+
+  const TreeNodeElement* current[kRowBlockSize];
+  for (int64_t block = row_begin; block < row_end; block += kRowBlockSize) {
+    const int64_t block_size = std::min(kRowBlockSize, row_end - block);
+    const T* block_x = x + block * stride;
+    for (size_t tree = tree_begin; tree < tree_end; ++tree) {
+      for (int64_t r = 0; r < block_size; ++r) {
+        current[r] = &nodes_[roots_[tree]];
+      }
+      for (int64_t depth = 0; depth <= kMaxTreeDepth_; ++depth) {
+        bool at_leaves = true;
+        for (int64_t r = 0; r < block_size; ++r) {
+          if (current[r]->mode != NODE_MODE::LEAF) {
+            current[r] = NextNode(nodes_.data(), *current[r], block_x + r * stride);
+            at_leaves = false;
+          }
+        }
+        if (at_leaves) {
+          break;
+        }
+      }
+
+      for (int64_t r = 0; r < block_size; ++r) {
+        // rows that are still on a branch have gone past the maximum depth
+        if (current[r]->mode != NODE_MODE::LEAF) {
+          continue;
+        }
+        float* row_scores = scores + (block + r) * num_scores;
+        unsigned char* row_has_scores = has_scores + (block + r) * num_scores;
+        for (int32_t i = current[r]->truenode; i < current[r]->falsenode; ++i) {
+          row_scores[weights_[i].class_id] += weights_[i].weight;
+          row_has_scores[weights_[i].class_id] = 1;
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void TreeEnsemble::AddRowScoresQuickScorer(const T* x, int64_t row_begin, int64_t row_end, int64_t stride,
+                                           size_t tree_begin, size_t tree_end, int64_t num_scores, float* scores,
+                                           unsigned char* has_scores) const {
+  const size_t num_features = quick_scorer_features_.size() - 1;
+  // the leaves each tree can still exit at
+  std::vector<uint64_t> tree_leaves(tree_end - tree_begin);
+  for (int64_t row = row_begin; row < row_end; ++row) {
+    const T* row_x = x + row * stride;
+    std::fill(tree_leaves.begin(), tree_leaves.end(), ~uint64_t{0});
+    for (size_t feature = 0; feature < num_features; ++feature) {
+      const T val = row_x[feature];
+      const QuickScorerNode* node = quick_scorer_nodes_.data() + quick_scorer_features_[feature];
+      const QuickScorerNode* end = quick_scorer_nodes_.data() + quick_scorer_features_[feature + 1];
+      if (std::isnan(static_cast<float>(val))) {
+        for (; node != end; ++node) {
+          if (node->nan_goes_right && node->tree >= tree_begin && node->tree < tree_end) {
+            tree_leaves[node->tree - tree_begin] &= node->mask;
+          }
+        }
+        continue;
+      }
+      for (; node != end && (val > node->value || (node->strict && val == node->value)); ++node) {
+        if (node->tree >= tree_begin && node->tree < tree_end) {
+          tree_leaves[node->tree - tree_begin] &= node->mask;
+        }
+      }
+    }
+
+    float* row_scores = scores + row * num_scores;
+    unsigned char* row_has_scores = has_scores + row * num_scores;
+    for (size_t tree = tree_begin; tree < tree_end; ++tree) {
+      // the rightmost leaf is left of no node, so a bit is always left
+      const int leaf_index = LowestBit(tree_leaves[tree - tree_begin]);
+      const TreeNodeElement& leaf = nodes_[quick_scorer_leaves_[tree * kMaxQuickScorerLeaves + leaf_index]];
+      for (int32_t i = leaf.truenode; i < leaf.falsenode; ++i) {
+        row_scores[weights_[i].class_id] += weights_[i].weight;
+        row_has_scores[weights_[i].class_id] = 1;
+      }
+    }
+  }
+}
+
+template <typename T>
+void TreeEnsemble::AddScores(const T* x, int64_t N, int64_t stride, int64_t num_scores,
+                             float* scores, unsigned char* has_scores) const {
+  const int64_t num_trees = static_cast<int64_t>(roots_.size());
+  TaskThreadPool* pool = nullptr;
+  const int64_t num_threads = GetIntraOpThreads(N * num_trees, kMinParallelEvaluations, pool);
+
+  if (num_threads == 1) {
+    AddRowScores(x, 0, N, stride, 0, roots_.size(), num_scores, scores, has_scores);
+    return;
+  }
+
+  if (N >= num_threads * kRowBlockSize) {
+    // every thread evaluates all trees for its share of the rows
+    pool->ParallelFor(static_cast<int32_t>(num_threads), [&](int32_t i) {
+      AddRowScores(x, N * i / num_threads, N * (i + 1) / num_threads, stride, 0, roots_.size(), num_scores,
+                   scores, has_scores);
+    });
+    return;
+  }
+
+  // too few rows to share, so every thread evaluates its share of the trees into scores of its own, which are
+  // added up in a fixed order so the result doesn't depend on the scheduling
+  const int64_t num_chunks = std::min(num_threads, num_trees);
+  const size_t chunk_size = static_cast<size_t>(N * num_scores);
+  std::vector<float> chunk_scores((num_chunks - 1) * chunk_size, 0.f);
+  std::vector<unsigned char> chunk_has_scores((num_chunks - 1) * chunk_size, 0);
+  pool->ParallelFor(static_cast<int32_t>(num_chunks), [&](int32_t i) {
+    float* target_scores = i == 0 ? scores : chunk_scores.data() + (i - 1) * chunk_size;
+    unsigned char* target_has_scores = i == 0 ? has_scores : chunk_has_scores.data() + (i - 1) * chunk_size;
+    AddRowScores(x, 0, N, stride, static_cast<size_t>(num_trees * i / num_chunks),
+                 static_cast<size_t>(num_trees * (i + 1) / num_chunks), num_scores, target_scores, target_has_scores);
+  });
+  for (int64_t chunk = 1; chunk < num_chunks; ++chunk) {
+    const float* source_scores = chunk_scores.data() + (chunk - 1) * chunk_size;
+    const unsigned char* source_has_scores = chunk_has_scores.data() + (chunk - 1) * chunk_size;
+    for (size_t i = 0; i < chunk_size; ++i) {
+      scores[i] += source_scores[i];
+      has_scores[i] |= source_has_scores[i];
+    }
+  }
+}
+
+template void TreeEnsemble::AddScores<float>(const float*, int64_t, int64_t, int64_t, float*, unsigned char*) const;
+template void TreeEnsemble::AddScores<double>(const double*, int64_t, int64_t, int64_t, float*, unsigned char*) const;
+template void TreeEnsemble::AddScores<int64_t>(const int64_t*, int64_t, int64_t, int64_t, float*,
+                                               unsigned char*) const;
+template void TreeEnsemble::AddScores<int32_t>(const int32_t*, int64_t, int64_t, int64_t, float*,
+                                               unsigned char*) const;
+
+}  // namespace ml
+}  // namespace onnxruntime
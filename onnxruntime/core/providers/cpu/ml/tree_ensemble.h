@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/common/common.h"
+#include "ml_common.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// a node of a TreeEnsemble, small enough that the nodes of a path share few cache lines
+struct TreeNodeElement {
+  float value;
+  int32_t feature_id;
+  // branches: the indices of the nodes to go to when the condition is true or false.
+  // leaves: the range [truenode, falsenode) of their weights in the weights of the ensemble.
+  int32_t truenode;
+  int32_t falsenode;
+  NODE_MODE mode;
+  bool missing_tracks_true;
+};
+
+// the vote of a leaf for a class or target
+struct TreeLeafWeight {
+  int32_t class_id;
+  float weight;
+};
+
+// a branch node of a tree evaluated with QuickScorer. mask clears the bits of the leaves the node excludes when the
+// row goes to its right child.
+struct QuickScorerNode {
+  uint64_t mask;
+  float value;
+  uint32_t tree;
+  // whether the row goes right when it equals value
+  bool strict;
+  // whether a missing (NaN) value goes right
+  bool nan_goes_right;
+};
+
+/**
+  * The trees of TreeEnsembleClassifier and TreeEnsembleRegressor, built from the attributes that describe their
+  * nodes and leaf weights. The nodes of all trees are stored in one array, with the children of a node resolved to
+  * their indices, and the weights of a leaf are stored contiguously, so evaluating a tree does no lookups.
+  * The scores of a row are accumulated into a dense array of one score per class.
+  *
+  * Ensembles of shallow trees with at most 64 leaves and only ordering comparisons are evaluated with QuickScorer
+  * instead of walking the trees: the leaves of every tree are numbered from left to right, and the branch nodes
+  * are sorted by feature and threshold. For every feature, a row visits the nodes in the order of their thresholds
+  * and clears, for every node that sends it right, the bits of the leaves left of the node in a bitvector of its
+  * tree. The leaf a row reaches is the lowest bit left. This replaces the unpredictable branches of every level of
+  * every tree by a loop that mostly takes the same branch.
+  */
+class TreeEnsemble {
+ public:
+  // the weights are given by class_treeids/class_nodeids/class_ids/class_weights for the classifier and the
+  // target_ attributes for the regressor. missing_tracks_true may be empty.
+  TreeEnsemble(const std::vector<int64_t>& nodes_treeids,
+               const std::vector<int64_t>& nodes_nodeids,
+               const std::vector<int64_t>& nodes_featureids,
+               const std::vector<float>& nodes_values,
+               const std::vector<NODE_MODE>& nodes_modes,
+               const std::vector<int64_t>& nodes_truenodeids,
+               const std::vector<int64_t>& nodes_falsenodeids,
+               const std::vector<int64_t>& missing_tracks_true,
+               const std::vector<int64_t>& weights_treeids,
+               const std::vector<int64_t>& weights_nodeids,
+               const std::vector<int64_t>& weights_classids,
+               const std::vector<float>& weights_values);
+
+  size_t NumTrees() const { return roots_.size(); }
+
+  // one more than the largest class id of the weights, so a scores array of this size fits all of them
+  int64_t NumClasses() const { return num_classes_; }
+
+  // adds the weights of the leaves that every row of x reaches in every tree to the scores of the row, and sets
+  // has_scores for the classes a weight was added to. x has N rows of stride features, and scores and has_scores
+  // have N rows of num_scores.
+  // large batches are split between the threads of the intra-op thread pool by rows, small batches by trees.
+  template <typename T>
+  void AddScores(const T* x, int64_t N, int64_t stride, int64_t num_scores,
+                 float* scores, unsigned char* has_scores) const;
+
+ private:
+  // evaluates the trees [tree_begin, tree_end) for the rows [row_begin, row_end)
+  template <typename T>
+  void AddRowScores(const T* x, int64_t row_begin, int64_t row_end, int64_t stride, size_t tree_begin,
+                    size_t tree_end, int64_t num_scores, float* scores, unsigned char* has_scores) const;
+
+  template <typename T>
+  void AddRowScoresQuickScorer(const T* x, int64_t row_begin, int64_t row_end, int64_t stride, size_t tree_begin,
+                               size_t tree_end, int64_t num_scores, float* scores, unsigned char* has_scores) const;
+
+  // builds the QuickScorer nodes if every tree can be evaluated with them
+  bool InitializeQuickScorer();
+
+  std::vector<TreeNodeElement> nodes_;
+  std::vector<TreeLeafWeight> weights_;
+  std::vector<int32_t> roots_;
+  int64_t num_classes_;
+  const int64_t kMaxTreeDepth_ = 1000;
+
+  bool use_quick_scorer_;
+  // the nodes that test feature f are [quick_scorer_features_[f], quick_scorer_features_[f + 1])
+  std::vector<QuickScorerNode> quick_scorer_nodes_;
+  std::vector<size_t> quick_scorer_features_;
+  // the leaves of tree t from left to right, as indices of nodes_, start at quick_scorer_leaves_[64 * t]
+  std::vector<int32_t> quick_scorer_leaves_;
+  const int64_t kMaxQuickScorerDepth_ = 8;
+};
+
+}  // namespace ml
+}  // namespace onnxruntime
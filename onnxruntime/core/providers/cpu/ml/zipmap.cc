@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/zipmap.h"
+#include <algorithm>
+#include <numeric>
+#include "core/providers/cpu/ml/ml_common.h"
 #include "core/util/math_cpuonly.h"
 /**
 https://github.com/onnx/onnx/blob/master/onnx/defs/traditionalml/defs.cc
@@ -28,6 +31,10 @@ using namespace ::onnxruntime::common;
 using namespace std;
 namespace onnxruntime {
 namespace ml {
+
+// the values below which the maps of a batch are built on the calling thread
+static constexpr int64_t kMinParallelZipMapValues = 1 << 14;
+
 ONNX_CPU_OPERATOR_ML_KERNEL(
     ZipMap,
     1,
@@ -42,6 +49,52 @@ ZipMapOp::ZipMapOp(const OpKernelInfo& info)
   ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
   using_strings_ = !classlabels_strings_.empty();
+
+  // the labels are sorted once here, so the maps of the rows are built by appending to them
+  auto sort_labels = [this](const auto& labels) {
+    sorted_label_indices_.resize(labels.size());
+    std::iota(sorted_label_indices_.begin(), sorted_label_indices_.end(), size_t{0});
+    std::stable_sort(sorted_label_indices_.begin(), sorted_label_indices_.end(),
+                     [&labels](size_t a, size_t b) { return labels[a] < labels[b]; });
+    // keep the last of the indices of a repeated label
+    auto last = std::unique(sorted_label_indices_.rbegin(), sorted_label_indices_.rend(),
+                            [&labels](size_t a, size_t b) { return labels[a] == labels[b]; });
+    sorted_label_indices_.erase(sorted_label_indices_.begin(), last.base());
+  };
+  if (using_strings_) {
+    sort_labels(classlabels_strings_);
+  } else {
+    sort_labels(classlabels_int64s_);
+  }
+}
+
+template <typename TKey>
+void ZipMapOp::ZipRows(const std::vector<TKey>& labels, const float* x, int64_t batch_size,
+                       std::vector<std::map<TKey, float>>& y) const {
+  const int64_t features_per_batch = static_cast<int64_t>(labels.size());
+  y.resize(batch_size);
+  auto zip_rows = [&](int64_t row_begin, int64_t row_end) {
+    for (int64_t n = row_begin; n < row_end; n++) {
+      std::map<TKey, float>& row_map = y[n];
+      row_map.clear();
+      const float* row = x + n * features_per_batch;
+      // the labels are inserted in order, so every insertion goes to the end of the map without comparisons
+      for (size_t j : sorted_label_indices_) {
+        row_map.emplace_hint(row_map.end(), labels[j], row[j]);
+      }
+    }
+  };
+
+  TaskThreadPool* pool = nullptr;
+  const int64_t num_threads =
+      std::min(GetIntraOpThreads(batch_size * features_per_batch, kMinParallelZipMapValues, pool), batch_size);
+  if (num_threads <= 1) {
+    zip_rows(0, batch_size);
+    return;
+  }
+  pool->ParallelFor(static_cast<int32_t>(num_threads), [&](int32_t i) {
+    zip_rows(batch_size * i / num_threads, batch_size * (i + 1) / num_threads);
+  });
 }
 
 common::Status ZipMapOp::Compute(OpKernelContext* context) const {
@@ -78,17 +131,7 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     auto* y_data = context->Output<std::vector<std::map<std::string, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
 
-    //auto* y_data = Y->template MutableData<std::vector<std::map<std::string, float>>>();
-    y_data->resize(batch_size);
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
-      for (int j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map1);
-    }
+    ZipRows(classlabels_strings_, x_data, batch_size, *y_data);
   } else {
     if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
       return Status(ONNXRUNTIME,
@@ -98,17 +141,7 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     }
     auto* y_data = context->Output<std::vector<std::map<std::int64_t, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-    //auto* y_data = Y->template MutableData<std::vector<std::map<int64_t, float>>>();
-    y_data->resize(batch_size);
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
-      for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
-    }
+    ZipRows(classlabels_int64s_, x_data, batch_size, *y_data);
   }
   return common::Status::OK();
 }
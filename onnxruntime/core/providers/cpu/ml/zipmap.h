@@ -4,6 +4,7 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include <map>
 namespace onnxruntime {
 namespace ml {
 
@@ -13,9 +14,16 @@ class ZipMapOp final : public OpKernel {
   common::Status Compute(OpKernelContext* context) const override;
 
  private:
+  // fills the map of every row of x with the labels and the values of the row
+  template <typename TKey>
+  void ZipRows(const std::vector<TKey>& labels, const float* x, int64_t batch_size,
+               std::vector<std::map<TKey, float>>& y) const;
+
   bool using_strings_;
   std::vector<int64_t> classlabels_int64s_;
   std::vector<std::string> classlabels_strings_;
+  // the indices of the labels in the order of the maps. a repeated label is zipped with its last value.
+  std::vector<size_t> sorted_label_indices_;
 };
 
 }  // namespace ml
@@ -18,12 +18,18 @@
 #include "core/providers/cpu/nn/batch_norm.h"
 #include "core/providers/cpu/nn/batch_norm_helper.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
+
+// the elements each range of channels normalized in parallel holds at least
+constexpr int64_t kMinBatchNormElementsPerRange = 64 * 1024;
+
 // spec: https://github.com/onnx/onnx/blob/master/docs/Operators.md#BatchNormalization
 ONNX_CPU_OPERATOR_KERNEL(
     BatchNormalization,
     7,
-    KernelDefBuilder().TypeConstraint("X", DataTypeImpl::GetTensorType<float>()).TypeConstraint("scale", DataTypeImpl::GetTensorType<float>()).TypeConstraint("B", DataTypeImpl::GetTensorType<float>()).TypeConstraint("mean", DataTypeImpl::GetTensorType<float>()).TypeConstraint("var", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("X", DataTypeImpl::GetTensorType<float>()).TypeConstraint("scale", DataTypeImpl::GetTensorType<float>()).TypeConstraint("B", DataTypeImpl::GetTensorType<float>()).TypeConstraint("mean", DataTypeImpl::GetTensorType<float>()).TypeConstraint("var", DataTypeImpl::GetTensorType<float>()),
     BatchNorm<float>);
 
 template <>
@@ -40,38 +46,43 @@ Status BatchNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const {
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
 
   const auto& dims_vec = x_shape.GetDims();
-  const size_t N = dims_vec[0];
-  const size_t C = dims_vec[1];  // assume NCHW as per the spec
-
-  // calculate sample_size
-  size_t sample_size = 1;
-  for (size_t i = 2; i < dims_vec.size(); ++i) {
-    sample_size *= dims_vec[i];
-  }
-
-  ConstEigenVectorArrayMap<float> scale_arr(scale->template Data<float>(), C);
-  ConstEigenVectorArrayMap<float> bias_arr(B->template Data<float>(), C);
+  const int64_t N = dims_vec[0];
+  const int64_t C = dims_vec[1];  // assume NCHW as per the spec
+  const int64_t sample_size = x_shape.SizeFromDimension(2);
 
   // Regardless of training or testing, we will apply the estimated mean
   // and standard deviation to the input. For testing, they are
   // specified directly by the input, and for training, they are computed
   // by the op.
-  Eigen::Array<float, Eigen::Dynamic, 1> inv_std(C);
-  ConstEigenVectorArrayMap<float> var_arr(var->template Data<float>(), C);
-  inv_std = (var_arr + epsilon_).sqrt().inverse();
-  ConstEigenVectorArrayMap<float> mean_arr(mean->template Data<float>(), C);
-  // We can fuse the output computation as follows:
-  //   ((x - est_mean) * (inv_var) * scale + bias
-  // to
-  //   (x * inv_var * scale) + (bias - est_mean * inv_var * scale)
-  Eigen::Array<float, Eigen::Dynamic, 1> new_scale = inv_std * scale_arr;
-  Eigen::Array<float, Eigen::Dynamic, 1> new_bias = bias_arr - mean_arr * new_scale;
-  EigenArrayMap<float> Y_arr(Y->template MutableData<float>(), sample_size, N * C);
-  ConstEigenArrayMap<float> X_arr(X->template Data<float>(), sample_size, N * C);
-  for (size_t nc = 0; nc < N * C; ++nc) {
-    Y_arr.col(nc) = X_arr.col(nc) * new_scale(nc % C) + new_bias(nc % C);
+  std::vector<float> scale_buffer;
+  std::vector<float> shift_buffer;
+  const std::vector<float>* folded_scale = &folded_scale_;
+  const std::vector<float>* folded_shift = &folded_shift_;
+  if (folded_scale_.empty()) {
+    FoldScaleAndShift(scale->template Data<float>(), B->template Data<float>(), mean->template Data<float>(),
+                      var->template Data<float>(), C, scale_buffer, shift_buffer);
+    folded_scale = &scale_buffer;
+    folded_shift = &shift_buffer;
   }
 
+  const float* Xdata = X->template Data<float>();
+  float* Ydata = Y->template MutableData<float>();
+  auto normalize = [&](int64_t begin, int64_t end) {
+    for (int64_t nc = begin; nc < end; ++nc) {
+      const float channel_scale = (*folded_scale)[nc % C];
+      const float channel_shift = (*folded_shift)[nc % C];
+      const float* x = Xdata + nc * sample_size;
+      float* y = Ydata + nc * sample_size;
+      for (int64_t i = 0; i < sample_size; ++i) {
+        y[i] = x[i] * channel_scale + channel_shift;
+      }
+    }
+  };
+
+  // Channels are split between the threads of the intra-op thread pool when there are enough
+  const int64_t min_channels = std::max<int64_t>(1, kMinBatchNormElementsPerRange / std::max<int64_t>(1, sample_size));
+  p_op_kernel_context->ParallelFor(N * C, min_channels, normalize);
+
   return Status::OK();
 }
 }  // namespace onnxruntime
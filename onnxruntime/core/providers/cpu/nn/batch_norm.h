@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <cmath>
+#include <vector>
+
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
@@ -34,12 +37,41 @@ class BatchNorm : public OpKernel {
     if (op_kernel_info.GetAttr<float>("epsilon", &tmp_eplison).IsOK()) {
       epsilon_ = tmp_eplison;
     }
+
+    // fold the statistics into one scale and shift per channel once if they're initializers, as they are in inference
+    // models the ConvBNFusion transformer didn't fuse
+    const Tensor* scale;
+    const Tensor* B;
+    const Tensor* mean;
+    const Tensor* var;
+    if (op_kernel_info.TryGetConstantInput(1, &scale) && op_kernel_info.TryGetConstantInput(2, &B) &&
+        op_kernel_info.TryGetConstantInput(3, &mean) && op_kernel_info.TryGetConstantInput(4, &var) &&
+        scale->Shape().NumDimensions() == 1 && B->Shape() == scale->Shape() &&
+        mean->Shape() == scale->Shape() && var->Shape() == scale->Shape()) {
+      FoldScaleAndShift(scale->template Data<T>(), B->template Data<T>(), mean->template Data<T>(),
+                        var->template Data<T>(), scale->Shape()[0], folded_scale_, folded_shift_);
+    }
   }
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override;
 
   protected:
+  // y = x * scale + shift for each channel, which is
+  //   (x - mean) / sqrt(var + epsilon) * scale + B
+  void FoldScaleAndShift(const T* scale, const T* B, const T* mean, const T* var, int64_t C,
+                         std::vector<T>& folded_scale, std::vector<T>& folded_shift) const {
+    folded_scale.resize(C);
+    folded_shift.resize(C);
+    for (int64_t c = 0; c < C; ++c) {
+      folded_scale[c] = scale[c] / std::sqrt(var[c] + epsilon_);
+      folded_shift[c] = B[c] - mean[c] * folded_scale[c];
+    }
+  }
+
   float epsilon_ = 1e-5f;
   int64_t is_test_;  // ignored in this implementation since we're doing inferencing only.
+  // the folded scale and shift of constant statistics, or empty
+  std::vector<T> folded_scale_;
+  std::vector<T> folded_shift_;
 };
 }  // namespace onnxruntime
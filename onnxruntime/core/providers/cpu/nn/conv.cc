@@ -2,23 +2,59 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/conv_impl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "core/framework/kernel_tuning_cache.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 
 template <>
-Status Conv<float>::Compute(OpKernelContext* context) const {
-  size_t num_inputs = OpKernel::Node().InputDefs().size();
-  const Tensor* X = context->Input<Tensor>(0);
-  const Tensor* W = context->Input<Tensor>(1);
-  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
-  const int64_t N = X->Shape()[0];
-  const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(ValidateInputShape(X, W));
+void Conv<float>::PrePackWinogradFilter(const OpKernelInfo& info) {
+  const Tensor* W;
+  if (!info.TryGetConstantInput(1, &W) || W->Shape().NumDimensions() != 4 || group_ <= 0) {
+    return;
+  }
+
+  const auto& W_shape = W->Shape();
+  const int64_t M = W_shape[0];
+  if (M % group_ != 0) {
+    return;
+  }
+
+  const int64_t kernel_shape[] = {W_shape[2], W_shape[3]};
+  const size_t transformed_size = MlasConvWinogradGetTransformedFilterSize(2,
+                                                                           static_cast<size_t>(group_),
+                                                                           static_cast<size_t>(W_shape[1]),
+                                                                           kernel_shape,
+                                                                           static_cast<size_t>(M / group_));
+  if (transformed_size == 0) {
+    return;
+  }
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  winograd_W_ = BufferUniquePtr(alloc->Alloc(sizeof(float) * transformed_size), BufferDeleter(alloc));
+  MlasConvWinogradTransformFilter(static_cast<size_t>(W_shape[1]),
+                                  static_cast<size_t>(M),
+                                  W->Data<float>(),
+                                  static_cast<float*>(winograd_W_.get()));
+}
+
+template <>
+Status Conv<float>::PrepareMlasConv(const TensorShape& X_shape,
+                                    const TensorShape& W_shape,
+                                    std::vector<int64_t>& Y_dims,
+                                    MLAS_CONV_PARAMETERS& Parameters,
+                                    size_t& WorkingBufferSize) const {
+  const int64_t N = X_shape[0];
+  const int64_t C = X_shape[1];
+  const int64_t M = W_shape[0];
 
   std::vector<int64_t> kernel_shape;
-  ORT_RETURN_IF_ERROR(ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(ComputeKernelShape(W_shape, kernel_shape));
 
   std::vector<int64_t> pads(pads_);
   if (pads.empty()) {
@@ -33,20 +69,146 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
     strides.resize(kernel_shape.size(), 1);
   }
 
-  std::vector<int64_t> Y_dims;
+  Y_dims.clear();
   Y_dims.insert(Y_dims.begin(), {N, M});
-  TensorShape input_shape = X->Shape().Slice(2);
+  TensorShape input_shape = X_shape.Slice(2);
   ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
-  TensorShape output_shape = Y->Shape().Slice(2);
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  MlasConvPrepare(&Parameters,
+                  kernel_shape.size(),
+                  static_cast<size_t>(N),
+                  static_cast<size_t>(group_),
+                  static_cast<size_t>(C / group_),
+                  input_shape.GetDims().data(),
+                  kernel_shape.data(),
+                  dilations.data(),
+                  pads.data(),
+                  strides.data(),
+                  Y_dims.data() + 2,
+                  static_cast<size_t>(M / group_),
+                  nullptr,
+                  &WorkingBufferSize);
+  return Status::OK();
+}
 
-  const float* Xdata = X->template Data<float>();
-  float* Ydata = Y->template MutableData<float>();
+template <>
+void Conv<float>::PrepareStaticShape(const OpKernelInfo& info) {
+  const Tensor* W;
+  TensorShape X_shape;
+  if (!info.TryGetConstantInput(1, &W) || !info.TryGetStaticInputShape(0, X_shape)) {
+    return;
+  }
+
+  const auto& W_shape = W->Shape();
+  if (X_shape.NumDimensions() != W_shape.NumDimensions() || (W_shape.NumDimensions() != 4 &&
+                                                             W_shape.NumDimensions() != 5) ||
+      group_ <= 0 || X_shape[1] != W_shape[1] * group_ || W_shape[0] % group_ != 0) {
+    return;
+  }
+
+  auto static_shape = std::make_unique<StaticShape>();
+  if (PrepareMlasConv(X_shape, W_shape, static_shape->Y_dims, static_shape->Parameters,
+                      static_shape->WorkingBufferSize)
+          .IsOK()) {
+    static_shape->X_shape = X_shape;
+    static_shape->W_shape = W_shape;
+    static_shape_ = std::move(static_shape);
+    if (info.IsKernelAutotuningEnabled()) {
+      AutotuneStaticShape(info, *W);
+    }
+  }
+}
+
+template <>
+void Conv<float>::AutotuneStaticShape(const OpKernelInfo& info, const Tensor& W) {
+  auto& static_shape = *static_shape_;
+  const std::string key = KernelTuningCache::MakeKey("mlas_conv", {{"x", static_shape.X_shape.GetDims()},
+                                                                   {"w", static_shape.W_shape.GetDims()},
+                                                                   {"y", static_shape.Y_dims},
+                                                                   {"p", pads_},
+                                                                   {"s", strides_},
+                                                                   {"d", dilations_},
+                                                                   {"g", {group_}}});
+  int64_t decision;
+  if (KernelTuningCache::Instance().Find(key, decision)) {
+    // an algorithm that can't compute the shape leaves the one MlasConvPrepare selected
+    MlasConvPrepareAlgorithm(&static_shape.Parameters, static_cast<MLAS_CONV_ALGORITHM>(decision),
+                             &static_shape.WorkingBufferSize);
+    return;
+  }
 
-  const size_t kernel_rank = kernel_shape.size();
+  // the values don't change the time of the algorithms, so X is a constant
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  const size_t X_size = static_cast<size_t>(static_shape.X_shape.Size());
+  const size_t Y_size = static_cast<size_t>(TensorShape(static_shape.Y_dims).Size());
+  BufferUniquePtr X_buffer(alloc->Alloc(sizeof(float) * X_size), BufferDeleter(alloc));
+  BufferUniquePtr Y_buffer(alloc->Alloc(sizeof(float) * Y_size), BufferDeleter(alloc));
+  float* X_data = static_cast<float*>(X_buffer.get());
+  std::fill(X_data, X_data + X_size, 0.5f);
+
+  MLAS_ACTIVATION Activation;
+  Activation.ActivationKind = MlasIdentityActivation;
+
+  const MLAS_CONV_ALGORITHM candidates[] = {MlasConvAlgorithmGemmDirect, MlasConvAlgorithmExpandThenGemm,
+                                            MlasConvAlgorithmExpandThenGemmSegmented, MlasConvAlgorithmWinograd,
+                                            MlasConvAlgorithmDepthwise};
+  const int kTimedRuns = 3;
+  MLAS_CONV_PARAMETERS best_parameters = static_shape.Parameters;
+  size_t best_working_buffer_size = static_shape.WorkingBufferSize;
+  double best_time = std::numeric_limits<double>::max();
+  for (auto algorithm : candidates) {
+    MLAS_CONV_PARAMETERS Parameters = static_shape.Parameters;
+    size_t WorkingBufferSize;
+    if (!MlasConvPrepareAlgorithm(&Parameters, algorithm, &WorkingBufferSize)) {
+      continue;
+    }
+    // the Winograd algorithm consumes the filter transformed at construction
+    if (algorithm == MlasConvAlgorithmWinograd && !winograd_W_) {
+      continue;
+    }
+    const float* filter_data = algorithm == MlasConvAlgorithmWinograd ? static_cast<const float*>(winograd_W_.get())
+                                                                      : W.Data<float>();
+    Parameters.Activation = &Activation;
+    BufferUniquePtr working_buffer(alloc->Alloc(sizeof(float) * std::max<size_t>(WorkingBufferSize, 1)),
+                                   BufferDeleter(alloc));
+
+    // the first run warms the caches and the thread pool up, the fastest of the others is the time
+    double time = std::numeric_limits<double>::max();
+    for (int run = 0; run <= kTimedRuns; ++run) {
+      const auto start = std::chrono::high_resolution_clock::now();
+      MlasConv(&Parameters, X_data, filter_data, nullptr, static_cast<float*>(working_buffer.get()),
+               static_cast<float*>(Y_buffer.get()));
+      const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+      if (run > 0) {
+        time = std::min(time, elapsed.count());
+      }
+    }
+
+    if (time < best_time) {
+      best_time = time;
+      best_parameters = Parameters;
+      best_working_buffer_size = WorkingBufferSize;
+    }
+  }
+
+  best_parameters.Activation = nullptr;
+  static_shape.Parameters = best_parameters;
+  static_shape.WorkingBufferSize = best_working_buffer_size;
+  KernelTuningCache::Instance().Insert(key, static_cast<int64_t>(best_parameters.Algorithm));
+}
+
+template <>
+Status Conv<float>::Compute(OpKernelContext* context) const {
+  size_t num_inputs = OpKernel::Node().InputDefs().size();
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
+  const int64_t M = W->Shape()[0];
+  ORT_RETURN_IF_ERROR(ValidateInputShape(X, W));
+
+  const size_t kernel_rank = W->Shape().NumDimensions() - 2;
 
   if (kernel_rank == 2 || kernel_rank == 3) {
     MLAS_ACTIVATION Activation;
@@ -67,89 +229,134 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
 
     MLAS_CONV_PARAMETERS Parameters;
     size_t WorkingBufferSize;
-    MlasConvPrepare(&Parameters,
-                    kernel_rank,
-                    static_cast<size_t>(N),
-                    static_cast<size_t>(group_),
-                    static_cast<size_t>(C / group_),
-                    input_shape.GetDims().data(),
-                    kernel_shape.data(),
-                    dilations.data(),
-                    pads.data(),
-                    strides.data(),
-                    output_shape.GetDims().data(),
-                    static_cast<size_t>(M / group_),
-                    &Activation,
-                    &WorkingBufferSize);
-
-    auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * WorkingBufferSize) : nullptr;
-    BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
+    Tensor* Y;
+    if (static_shape_ != nullptr && X->Shape() == static_shape_->X_shape && W->Shape() == static_shape_->W_shape) {
+      Parameters = static_shape_->Parameters;
+      WorkingBufferSize = static_shape_->WorkingBufferSize;
+      Y = context->Output(0, TensorShape(static_shape_->Y_dims));
+    } else {
+      std::vector<int64_t> Y_dims;
+      ORT_RETURN_IF_ERROR(PrepareMlasConv(X->Shape(), W->Shape(), Y_dims, Parameters, WorkingBufferSize));
+      Y = context->Output(0, TensorShape(Y_dims));
+    }
+    Parameters.Activation = &Activation;
+
+    float* working_buffer = static_cast<float*>(context->GetScratchBuffer(sizeof(float) * WorkingBufferSize));
+
+    // The Winograd algorithm consumes the transformed filter. Transform W here
+    // if it wasn't constant at construction.
+    const float* filter_data = W->template Data<float>();
+    BufferUniquePtr transformed_filter;
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+      if (winograd_W_) {
+        filter_data = static_cast<const float*>(winograd_W_.get());
+      } else {
+        AllocatorPtr alloc;
+        ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+        const size_t transformed_size = MlasConvWinogradGetTransformedFilterSize(kernel_rank,
+                                                                                 static_cast<size_t>(group_),
+                                                                                 static_cast<size_t>(C / group_),
+                                                                                 W->Shape().GetDims().data() + 2,
+                                                                                 static_cast<size_t>(M / group_));
+        transformed_filter = BufferUniquePtr(alloc->Alloc(sizeof(float) * transformed_size), BufferDeleter(alloc));
+        MlasConvWinogradTransformFilter(static_cast<size_t>(C / group_),
+                                        static_cast<size_t>(M / group_),
+                                        filter_data,
+                                        static_cast<float*>(transformed_filter.get()));
+        filter_data = static_cast<const float*>(transformed_filter.get());
+      }
+    }
 
     MlasConv(&Parameters,
-             Xdata,
-             W->template Data<float>(),
+             X->template Data<float>(),
+             filter_data,
              B != nullptr ? B->template Data<float>() : nullptr,
-             static_cast<float*>(working_buffer.get()),
-             Ydata);
-  } else {
-    const int64_t input_image_size = input_shape.Size();
-    const int64_t output_image_size = output_shape.Size();
-    const int64_t kernel_size = TensorShape(kernel_shape).Size();
-    const int64_t X_offset = C / group_ * input_image_size;
-    const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / group_;
-    const int64_t W_offset = W->Shape().Size() / group_;
-    const int64_t kernel_dim = C / group_ * kernel_size;
-    const int64_t col_buffer_size = kernel_dim * output_image_size;
-
-    auto col_data = alloc->Alloc(sizeof(float) * col_buffer_size);
-    BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
-    float* col_buffer_data = static_cast<float*>(col_buffer.get());
-
-    TensorShape image_shape = X->Shape().Slice(1);
-    std::vector<int64_t> col_buffer_shape{kernel_dim};
-    col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
-                            output_shape.GetDims().end());
-
-    for (int image_id = 0; image_id < N; ++image_id) {
-      for (int group_id = 0; group_id < group_; ++group_id) {
-        math::Im2colNd<float, CPUMathUtil, StorageOrder::NCHW>()(
-            Xdata + group_id * X_offset,
-            image_shape.GetDims().data(),
-            col_buffer_shape.data(),
-            C * input_image_size,
-            col_buffer_size,
-            kernel_shape.data(),
-            strides.data(),
-            dilations.data(),
-            pads.data(),
-            static_cast<int>(kernel_shape.size()),
-            col_buffer_data,
-            &CPUMathUtil::Instance());
-        math::Gemm<float, CPUMathUtil>(
-            CblasNoTrans,
-            CblasNoTrans,
-            M / group_,
-            output_image_size,
-            kernel_dim,
-            1,
-            W->template Data<float>() + group_id * W_offset,
-            col_buffer_data,
-            0,
-            Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
-      }
+             working_buffer,
+             Y->template MutableData<float>());
+    return Status::OK();
+  }
 
-      if (B != nullptr) {
-        auto Ymatrix = EigenMatrixMap<float>(Ydata, output_image_size, M);
-        auto Bvec = ConstEigenVectorMap<float>(B->template Data<float>(), M);
-        Ymatrix.rowwise() += Bvec.transpose();
-      }
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(ComputeKernelShape(W->Shape(), kernel_shape));
+
+  std::vector<int64_t> pads(pads_);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  std::vector<int64_t> dilations(dilations_);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  std::vector<int64_t> strides(strides_);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  std::vector<int64_t> Y_dims;
+  Y_dims.insert(Y_dims.begin(), {N, M});
+  TensorShape input_shape = X->Shape().Slice(2);
+  ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  TensorShape output_shape = Y->Shape().Slice(2);
+
+  const float* Xdata = X->template Data<float>();
+  float* Ydata = Y->template MutableData<float>();
 
-      FuseActivation(activation_, Ydata, Y_offset * group_, alpha_);
+  const int64_t input_image_size = input_shape.Size();
+  const int64_t output_image_size = output_shape.Size();
+  const int64_t kernel_size = TensorShape(kernel_shape).Size();
+  const int64_t X_offset = C / group_ * input_image_size;
+  const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / group_;
+  const int64_t W_offset = W->Shape().Size() / group_;
+  const int64_t kernel_dim = C / group_ * kernel_size;
+  const int64_t col_buffer_size = kernel_dim * output_image_size;
 
-      Xdata += X_offset * group_;
-      Ydata += Y_offset * group_;
+  float* col_buffer_data = static_cast<float*>(context->GetScratchBuffer(sizeof(float) * col_buffer_size));
+
+  TensorShape image_shape = X->Shape().Slice(1);
+  std::vector<int64_t> col_buffer_shape{kernel_dim};
+  col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
+                          output_shape.GetDims().end());
+
+  for (int image_id = 0; image_id < N; ++image_id) {
+    for (int group_id = 0; group_id < group_; ++group_id) {
+      math::Im2colNd<float, CPUMathUtil, StorageOrder::NCHW>()(
+          Xdata + group_id * X_offset,
+          image_shape.GetDims().data(),
+          col_buffer_shape.data(),
+          C * input_image_size,
+          col_buffer_size,
+          kernel_shape.data(),
+          strides.data(),
+          dilations.data(),
+          pads.data(),
+          static_cast<int>(kernel_shape.size()),
+          col_buffer_data,
+          &CPUMathUtil::Instance());
+      math::Gemm<float, CPUMathUtil>(
+          CblasNoTrans,
+          CblasNoTrans,
+          M / group_,
+          output_image_size,
+          kernel_dim,
+          1,
+          W->template Data<float>() + group_id * W_offset,
+          col_buffer_data,
+          0,
+          Ydata + group_id * Y_offset,
+          &CPUMathUtil::Instance());
+    }
+
+    if (B != nullptr) {
+      auto Ymatrix = EigenMatrixMap<float>(Ydata, output_image_size, M);
+      auto Bvec = ConstEigenVectorMap<float>(B->template Data<float>(), M);
+      Ymatrix.rowwise() += Bvec.transpose();
     }
+
+    FuseActivation(activation_, Ydata, Y_offset * group_, alpha_);
+
+    Xdata += X_offset * group_;
+    Ydata += Y_offset * group_;
   }
 
   return Status::OK();
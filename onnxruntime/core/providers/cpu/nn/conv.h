@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/nn/conv_base.h"
 
 namespace onnxruntime {
@@ -25,9 +26,59 @@ template <typename T>
 class Conv : public OpKernel, public ConvBase {
  public:
   Conv(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
+    // transform a constant W once rather than on every Compute
+    PrePackWinogradFilter(info);
+    // the shapes of a session that freezes its input shapes are known, so prepare the MLAS convolution once
+    PrepareStaticShape(info);
   }
 
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  void PrePackWinogradFilter(const OpKernelInfo& /*info*/) {}
+  void PrepareStaticShape(const OpKernelInfo& /*info*/) {}
+
+  // times the MLAS convolution algorithms that can compute the static shape with the constant W, and prepares
+  // static_shape_ for the fastest. the decision is looked up in and recorded in KernelTuningCache.
+  void AutotuneStaticShape(const OpKernelInfo& info, const Tensor& W);
+
+  // the shapes derived from the shapes of X and W for a 2D or 3D convolution run by MLAS. Parameters.Activation
+  // isn't set as the activation of a FusedConv is set after Conv is constructed.
+  Status PrepareMlasConv(const TensorShape& X_shape,
+                         const TensorShape& W_shape,
+                         std::vector<int64_t>& Y_dims,
+                         MLAS_CONV_PARAMETERS& Parameters,
+                         size_t& WorkingBufferSize) const;
+
+  // W transformed for the MLAS Winograd algorithm if it's a constant initializer
+  // that the algorithm may be selected for
+  BufferUniquePtr winograd_W_;
+
+  // prepared from the static shape of X and the constant W if the session freezes its input shapes
+  struct StaticShape {
+    TensorShape X_shape;
+    TensorShape W_shape;
+    std::vector<int64_t> Y_dims;
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+  };
+  std::unique_ptr<StaticShape> static_shape_;
 };
 
+template <>
+void Conv<float>::PrePackWinogradFilter(const OpKernelInfo& info);
+
+template <>
+void Conv<float>::PrepareStaticShape(const OpKernelInfo& info);
+
+template <>
+void Conv<float>::AutotuneStaticShape(const OpKernelInfo& info, const Tensor& W);
+
+template <>
+Status Conv<float>::PrepareMlasConv(const TensorShape& X_shape,
+                                    const TensorShape& W_shape,
+                                    std::vector<int64_t>& Y_dims,
+                                    MLAS_CONV_PARAMETERS& Parameters,
+                                    size_t& WorkingBufferSize) const;
+
 }  // namespace onnxruntime
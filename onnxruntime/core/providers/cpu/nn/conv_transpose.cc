@@ -16,8 +16,9 @@
 /* Modifications Copyright (c) Microsoft. */
 
 #include "core/providers/cpu/nn/conv_transpose.h"
-#include "core/util/math.h"
-#include "core/util/math_cpuonly.h"
+
+#include <algorithm>
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -208,8 +209,64 @@ void ConvTransposeBase::ComputePadsAndOutputShape(
   output_shape->insert(output_shape->begin(), {N, output_channel, output_height, output_width});
 }
 
+namespace {
+
+// Accumulates the columns of one group, input_h * input_w values for each kernel position of each output channel,
+// into the output channels, which start at their bias or 0.
 template <typename T>
-Status ConvTranspose<T>::Compute(OpKernelContext* context) const {
+void Col2imWithBias(const T* col, int64_t channels, int64_t input_h, int64_t input_w,
+                    int64_t output_h, int64_t output_w, int64_t kernel_h, int64_t kernel_w,
+                    int64_t pad_t, int64_t pad_l, int64_t stride_h, int64_t stride_w,
+                    const T* bias, T* im) {
+  const int64_t output_image_size = output_h * output_w;
+  for (int64_t c = 0; c < channels; c++, im += output_image_size) {
+    std::fill_n(im, output_image_size, bias != nullptr ? bias[c] : T(0));
+    for (int64_t kh = 0; kh < kernel_h; kh++) {
+      for (int64_t kw = 0; kw < kernel_w; kw++) {
+        for (int64_t ih = 0; ih < input_h; ih++, col += input_w) {
+          const int64_t oh = ih * stride_h - pad_t + kh;
+          if (oh < 0 || oh >= output_h) {
+            continue;
+          }
+          T* row = im + oh * output_w;
+          int64_t ow = kw - pad_l;
+          for (int64_t iw = 0; iw < input_w; iw++, ow += stride_w) {
+            if (ow >= 0 && ow < output_w) {
+              row[ow] += col[iw];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Col2imWithBias when the output is tiled by the kernels, without padding, so that each column value is the only
+// one of its output and is stored rather than accumulated.
+template <typename T>
+void Col2imScatterWithBias(const T* col, int64_t channels, int64_t input_h, int64_t input_w,
+                           int64_t kernel_h, int64_t kernel_w, const T* bias, T* im) {
+  const int64_t output_w = input_w * kernel_w;
+  const int64_t output_image_size = input_h * kernel_h * output_w;
+  for (int64_t c = 0; c < channels; c++, im += output_image_size) {
+    const T b = bias != nullptr ? bias[c] : T(0);
+    for (int64_t kh = 0; kh < kernel_h; kh++) {
+      for (int64_t kw = 0; kw < kernel_w; kw++) {
+        for (int64_t ih = 0; ih < input_h; ih++, col += input_w) {
+          T* row = im + (ih * kernel_h + kh) * output_w + kw;
+          for (int64_t iw = 0; iw < input_w; iw++) {
+            row[iw * kernel_w] = col[iw] + b;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <>
+Status ConvTranspose<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   Prepare p;
   ORT_RETURN_IF_ERROR(PrepareForCompute(context, num_inputs == 3, p));
@@ -219,63 +276,80 @@ Status ConvTranspose<T>::Compute(OpKernelContext* context) const {
   const int64_t Y_offset = p.Y->Shape().Size() / p.Y->Shape()[0] / group_;
   const int64_t W_offset = p.F->Shape().Size() / group_;
   const int64_t kernel_dim = p.num_output_channels / group_ * p.kernel_shape[0] * p.kernel_shape[1];
-  const int64_t output_image_size = p.Y->Shape()[2] * p.Y->Shape()[3];
-
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
-  auto col_data = alloc->Alloc(sizeof(T) * kernel_dim * p.H * p.W);
-  BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
-  T* col_buffer_data = static_cast<T*>(col_buffer.get());
-
-  const T* Xdata = p.X->template Data<T>();
-  const T* filter_data = p.F->template Data<T>();
-  T* Ydata = p.Y->template MutableData<T>();
-
-  for (auto image_id = 0; image_id < p.N; ++image_id) {
-    for (int group_id = 0; group_id < group_; ++group_id) {
-      // Weight term
-      math::Gemm<T, CPUMathUtil>(
-          CblasTrans,
-          CblasNoTrans,
-          kernel_dim,
-          input_image_size,
-          p.num_input_channels / group_,
-          1,
-          filter_data + group_id * W_offset,
-          Xdata + group_id * X_offset,
-          0,
-          col_buffer_data,
-          &CPUMathUtil::Instance());
-
-      // Col2im
-      math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
-          col_buffer_data,
-          p.num_output_channels / group_,
-          p.Y->Shape()[2],
-          p.Y->Shape()[3],
-          p.kernel_shape[0],
-          p.kernel_shape[1],
-          1,
-          1,
-          p.pads[0],
-          p.pads[1],
-          p.pads[2],
-          p.pads[3],
-          p.strides[0],
-          p.strides[1],
-          Ydata + group_id * Y_offset,
-          &CPUMathUtil::Instance());
-    }
+  const int64_t col_size = kernel_dim * input_image_size;
+  const int64_t output_h = p.Y->Shape()[2];
+  const int64_t output_w = p.Y->Shape()[3];
+  const int64_t num_tasks = p.N * group_;
+  if (num_tasks == 0) {
+    return Status::OK();
+  }
 
-    if (p.B != nullptr) {
-      auto Ymatrix = EigenMatrixMap<T>(Ydata, output_image_size, p.num_output_channels);
-      auto Bvec = ConstEigenVectorMap<T>(p.B->template Data<T>(), p.num_output_channels);
-      Ymatrix.rowwise() += Bvec.transpose();
+  // each of the images and groups is a task, which are run a chunk of as many as there are threads at a time
+  const int64_t chunk_size = std::min<int64_t>(context->NumParallelRanges(), num_tasks);
+
+  float* col_buffer_data = static_cast<float*>(context->GetScratchBuffer(sizeof(float) * chunk_size * col_size));
+
+  const float* Xdata = p.X->template Data<float>();
+  const float* filter_data = p.F->template Data<float>();
+  const float* Bdata = p.B != nullptr ? p.B->template Data<float>() : nullptr;
+  float* Ydata = p.Y->template MutableData<float>();
+
+  const bool is_scatter = p.strides[0] == p.kernel_shape[0] && p.strides[1] == p.kernel_shape[1] &&
+                          p.pads[0] == 0 && p.pads[1] == 0 && p.pads[2] == 0 && p.pads[3] == 0 &&
+                          output_h == p.H * p.kernel_shape[0] && output_w == p.W * p.kernel_shape[1];
+
+  std::vector<size_t> filter_offsets(static_cast<size_t>(chunk_size));
+  std::vector<size_t> X_offsets(static_cast<size_t>(chunk_size));
+  std::vector<size_t> col_offsets(static_cast<size_t>(chunk_size));
+  for (int64_t start = 0; start < num_tasks; start += chunk_size) {
+    const int64_t count = std::min(chunk_size, num_tasks - start);
+    for (int64_t i = 0; i < count; i++) {
+      filter_offsets[i] = static_cast<size_t>((start + i) % group_ * W_offset);
+      X_offsets[i] = static_cast<size_t>((start + i) * X_offset);
+      col_offsets[i] = static_cast<size_t>(i * col_size);
     }
 
-    Xdata += X_offset * group_;
-    Ydata += Y_offset * group_;
+    // Weight term of every task of the chunk, threaded by MLAS
+    MlasSgemmBatch(
+        CblasTrans,
+        CblasNoTrans,
+        static_cast<size_t>(kernel_dim),
+        static_cast<size_t>(input_image_size),
+        static_cast<size_t>(p.num_input_channels / group_),
+        /* alpha */ 1.0f,
+        filter_data,
+        static_cast<size_t>(kernel_dim),
+        filter_offsets.data(),
+        Xdata,
+        static_cast<size_t>(input_image_size),
+        X_offsets.data(),
+        /* beta */ 0.0f,
+        col_buffer_data,
+        static_cast<size_t>(input_image_size),
+        col_offsets.data(),
+        static_cast<size_t>(count));
+
+    // Col2im of each task on its own thread, which writes the bias with the columns
+    auto col2im = [&](int64_t i) {
+      const int64_t task = start + i;
+      const int64_t group_id = task % group_;
+      const float* bias = Bdata != nullptr ? Bdata + group_id * (p.num_output_channels / group_) : nullptr;
+      const float* col = col_buffer_data + i * col_size;
+      float* Y = Ydata + task * Y_offset;
+      if (is_scatter) {
+        Col2imScatterWithBias(col, p.num_output_channels / group_, p.H, p.W,
+                              p.kernel_shape[0], p.kernel_shape[1], bias, Y);
+      } else {
+        Col2imWithBias(col, p.num_output_channels / group_, p.H, p.W, output_h, output_w,
+                       p.kernel_shape[0], p.kernel_shape[1], p.pads[0], p.pads[1],
+                       p.strides[0], p.strides[1], bias, Y);
+      }
+    };
+    context->ParallelFor(count, 1, [&col2im](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        col2im(i);
+      }
+    });
   }
 
   return Status::OK();
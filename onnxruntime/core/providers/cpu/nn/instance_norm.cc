@@ -3,7 +3,9 @@
 
 #include "core/providers/cpu/nn/instance_norm.h"
 #include "core/providers/cpu/nn/instance_norm_helper.h"
-#include "core/util/math_cpuonly.h"
+
+#include <algorithm>
+#include <cmath>
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -11,9 +13,57 @@ namespace onnxruntime {
 ONNX_CPU_OPERATOR_KERNEL(
     InstanceNormalization,
     6,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     InstanceNorm<float>);
 
+namespace {
+
+// the elements each range of channels normalized in parallel holds at least
+constexpr int64_t kMinInstanceNormElementsPerRange = 64 * 1024;
+// the interleaved lanes the statistics of a channel are accumulated in, which the compiler vectorizes
+constexpr int64_t kStatisticsLanes = 8;
+
+// merges the mean and sum of squared deviations of count_b values into those of count_a values (Chan et al.)
+void MergeStatistics(double count_b, double mean_b, double m2_b, double& count_a, double& mean_a, double& m2_a) {
+  const double count = count_a + count_b;
+  if (count == 0) {
+    return;
+  }
+  const double delta = mean_b - mean_a;
+  mean_a += delta * count_b / count;
+  m2_a += m2_b + delta * delta * count_a * count_b / count;
+  count_a = count;
+}
+
+// the mean and population variance of the n values of x in one pass, with Welford's update in each lane
+void ComputeMeanAndVariance(const float* x, int64_t n, float& mean, float& variance) {
+  float lane_mean[kStatisticsLanes] = {};
+  float lane_m2[kStatisticsLanes] = {};
+  const int64_t blocks = n / kStatisticsLanes;
+  for (int64_t b = 0; b < blocks; ++b, x += kStatisticsLanes) {
+    const float inv_count = 1.0f / static_cast<float>(b + 1);
+    for (int64_t l = 0; l < kStatisticsLanes; ++l) {
+      const float delta = x[l] - lane_mean[l];
+      lane_mean[l] += delta * inv_count;
+      lane_m2[l] += delta * (x[l] - lane_mean[l]);
+    }
+  }
+
+  double count = 0;
+  double total_mean = 0;
+  double total_m2 = 0;
+  for (int64_t l = 0; l < kStatisticsLanes; ++l) {
+    MergeStatistics(static_cast<double>(blocks), lane_mean[l], lane_m2[l], count, total_mean, total_m2);
+  }
+  for (int64_t i = 0; i < n % kStatisticsLanes; ++i) {
+    MergeStatistics(1, x[i], 0, count, total_mean, total_m2);
+  }
+  mean = static_cast<float>(total_mean);
+  variance = count > 0 ? static_cast<float>(total_m2 / count) : 0.0f;
+}
+
+}  // namespace
+
 template <>
 Status InstanceNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const {
   const Tensor* input = p_op_kernel_context->Input<Tensor>(0);
@@ -28,16 +78,29 @@ Status InstanceNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const
   const TensorShape& x_shape = input->Shape();
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
 
-  for (auto i = 0; i < N * C; ++i) {
-    ConstEigenVectorArrayMap<float> Xi(input->template Data<float>() + W * i, W);
-    const float Xi_mean = Xi.mean();
-    const float squared_norm = (Xi - Xi_mean).matrix().squaredNorm();
-    const float inv_stdev = 1.0f / std::sqrt(squared_norm / W + epsilon_);
-    EigenVectorArrayMap<float> Yi(Y->template MutableData<float>() + W * i, W);
-    const float channel_scale = inv_stdev * scale->template Data<float>()[i % C];
-    const float channel_shift = B->template Data<float>()[i % C] - Xi_mean * channel_scale;
-    Yi = Xi * channel_scale + channel_shift;
-  }
+  const float* Xdata = input->template Data<float>();
+  const float* scale_data = scale->template Data<float>();
+  const float* B_data = B->template Data<float>();
+  float* Ydata = Y->template MutableData<float>();
+  auto normalize = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const float* Xi = Xdata + W * i;
+      float Xi_mean;
+      float Xi_variance;
+      ComputeMeanAndVariance(Xi, W, Xi_mean, Xi_variance);
+      const float inv_stdev = 1.0f / std::sqrt(Xi_variance + epsilon_);
+      const float channel_scale = inv_stdev * scale_data[i % C];
+      const float channel_shift = B_data[i % C] - Xi_mean * channel_scale;
+      float* Yi = Ydata + W * i;
+      for (int64_t j = 0; j < W; ++j) {
+        Yi[j] = Xi[j] * channel_scale + channel_shift;
+      }
+    }
+  };
+
+  // Channels are split between the threads of the intra-op thread pool when there are enough
+  const int64_t min_channels = std::max<int64_t>(1, kMinInstanceNormElementsPerRange / std::max<int64_t>(1, W));
+  p_op_kernel_context->ParallelFor(N * C, min_channels, normalize);
 
   return Status::OK();
 }
@@ -8,7 +8,7 @@ namespace onnxruntime {
 ONNX_CPU_OPERATOR_KERNEL(
     LpNormalization,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     LpNorm<float>);
 
 using InnerStride = Eigen::InnerStride<Eigen::Dynamic>;
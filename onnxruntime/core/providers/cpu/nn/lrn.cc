@@ -16,11 +16,21 @@
 /* Modifications Copyright (c) Microsoft. */
 
 #include "core/providers/cpu/nn/lrn.h"
-#include "core/util/math.h"
-#include "core/util/math_cpuonly.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace onnxruntime {
 
+namespace {
+
+// the pixels of an image whose channels are normalized together, with their sums of squares on the stack
+constexpr int64_t kLRNBlockSize = 256;
+// the elements each range of blocks normalized in parallel holds at least
+constexpr int64_t kMinLRNElementsPerRange = 64 * 1024;
+
+}  // namespace
+
 template <>
 Status LRN<float>::Compute(OpKernelContext* context) const {
   const Tensor* X = context->Input<Tensor>(0);
@@ -30,62 +40,72 @@ Status LRN<float>::Compute(OpKernelContext* context) const {
 
   // Supports NCHW image format.
   ORT_ENFORCE(X->Shape().NumDimensions() == 4);
-  const int N = gsl::narrow_cast<int>(X->Shape()[0]);
-  const int C = gsl::narrow_cast<int>(X->Shape()[1]);
-  const int H = gsl::narrow_cast<int>(X->Shape()[2]);
-  const int W = gsl::narrow_cast<int>(X->Shape()[3]);
-  const int image_size = C * H * W;
-  const int pre_pad = (size_ - 1) / 2;
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
+  const int64_t image_area = X->Shape()[2] * X->Shape()[3];
+  const int64_t image_size = C * image_area;
+  const int64_t pre_pad = (size_ - 1) / 2;
+  const int64_t post_pad = size_ - 1 - pre_pad;
 
   const float* Xdata = X->template Data<float>();
   float* Ydata = Y->template MutableData<float>();
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
-  const int Xsize = gsl::narrow_cast<int>(X->Shape().Size());
-  auto sdata = alloc->Alloc(sizeof(float) * Xsize);
-  BufferUniquePtr scale_buffer(sdata, BufferDeleter(alloc));
-  float* scale_data = static_cast<float*>(scale_buffer.get());
-  math::Set<float, CPUMathUtil>(Xsize, bias_, scale_data, &CPUMathUtil::Instance());
-
-  const size_t padded_square_size = (C + size_ - 1) * H * W;
-  auto psdata = alloc->Alloc(sizeof(float) * padded_square_size);
-  BufferUniquePtr padded_square_buffer(psdata, BufferDeleter(alloc));
-  float* padded_square_data = static_cast<float*>(padded_square_buffer.get());
-  math::Set<float, CPUMathUtil>(padded_square_size, 0.0f, padded_square_data, &CPUMathUtil::Instance());
-
   const float alpha_over_size = alpha_ / size_;
-  // go through the images
-  for (int n = 0; n < N; ++n) {
-    // compute the padded square
-    math::Sqr<float, CPUMathUtil>(image_size, Xdata + image_size * n,
-                                  padded_square_data + pre_pad * H * W,
-                                  &CPUMathUtil::Instance());
-    // Create the first channel scale
-    for (int c = 0; c < size_; ++c) {
-      math::Axpy<float, CPUMathUtil>(
-          H * W, alpha_over_size, padded_square_data + c * H * W,
-          scale_data + image_size * n, &CPUMathUtil::Instance());
-    }
+  const float bias = bias_;
+  const float beta = beta_;
+  // each block of pixels slides the window of size_ channels over the channels, adding the square of the channel
+  // entering it and subtracting that of the one leaving it
+  const int64_t blocks_per_image = (image_area + kLRNBlockSize - 1) / kLRNBlockSize;
+  auto normalize = [&](int64_t begin, int64_t end) {
+    float square_sum[kLRNBlockSize];
+    for (int64_t block = begin; block < end; ++block) {
+      const int64_t n = block / blocks_per_image;
+      const int64_t offset = block % blocks_per_image * kLRNBlockSize;
+      const int64_t count = std::min(kLRNBlockSize, image_area - offset);
+      const float* x = Xdata + n * image_size + offset;
+      float* y = Ydata + n * image_size + offset;
 
-    for (int c = 1; c < C; ++c) {
-      float* this_scale_slice = scale_data + n * image_size + c * H * W;
-      // copy previous scale
-      memcpy(this_scale_slice, this_scale_slice - H * W, H * W * sizeof(float));
-      // add head
-      math::Axpy<float, CPUMathUtil>(
-          H * W, alpha_over_size, padded_square_data + (c + size_ - 1) * H * W,
-          this_scale_slice, &CPUMathUtil::Instance());
-      // subtract tail
-      math::Axpy<float, CPUMathUtil>(
-          H * W, -alpha_over_size, padded_square_data + (c - 1) * H * W,
-          this_scale_slice, &CPUMathUtil::Instance());
+      std::fill_n(square_sum, count, 0.0f);
+      for (int64_t c = 0; c < std::min(post_pad, C); ++c) {
+        const float* head = x + c * image_area;
+        for (int64_t i = 0; i < count; ++i) {
+          square_sum[i] += head[i] * head[i];
+        }
+      }
+      for (int64_t c = 0; c < C; ++c) {
+        if (c + post_pad < C) {
+          const float* head = x + (c + post_pad) * image_area;
+          for (int64_t i = 0; i < count; ++i) {
+            square_sum[i] += head[i] * head[i];
+          }
+        }
+        if (c - pre_pad - 1 >= 0) {
+          const float* tail = x + (c - pre_pad - 1) * image_area;
+          for (int64_t i = 0; i < count; ++i) {
+            square_sum[i] -= tail[i] * tail[i];
+          }
+        }
+        const float* xc = x + c * image_area;
+        float* yc = y + c * image_area;
+        if (beta == 0.75f) {
+          // scale^-0.75 = sqrt(r) * sqrt(sqrt(r)) of r = 1 / scale, without pow
+          for (int64_t i = 0; i < count; ++i) {
+            const float r = 1.0f / (bias + alpha_over_size * square_sum[i]);
+            const float sqrt_r = std::sqrt(r);
+            yc[i] = xc[i] * sqrt_r * std::sqrt(sqrt_r);
+          }
+        } else {
+          for (int64_t i = 0; i < count; ++i) {
+            yc[i] = xc[i] * std::pow(bias + alpha_over_size * square_sum[i], -beta);
+          }
+        }
+      }
     }
-  }
+  };
 
-  math::Powx<float, CPUMathUtil>(Xsize, scale_data, -beta_, Ydata, &CPUMathUtil::Instance());
-  math::Mul<float, CPUMathUtil>(Xsize, Ydata, Xdata, Ydata, &CPUMathUtil::Instance());
+  // Blocks are split between the threads of the intra-op thread pool when there are enough
+  const int64_t min_blocks = std::max<int64_t>(1, kMinLRNElementsPerRange / std::max<int64_t>(1, C * kLRNBlockSize));
+  context->ParallelFor(N * blocks_per_image, min_blocks, normalize);
 
   return Status::OK();
 }
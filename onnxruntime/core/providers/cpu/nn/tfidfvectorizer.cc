@@ -5,11 +5,11 @@
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/providers/cpu/ml/flat_string_map.h"
 
-#include <functional>
-#include <unordered_set>
-#include <ostream>
-#include <iterator>
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
 
 namespace onnxruntime {
 
@@ -42,146 +42,76 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
 
 namespace ngram_details {
 
-class NgramEntryBase {
-  size_t id_;  // Id in the pool
- protected:
-  NgramEntryBase(size_t id) : id_(id) {}
-  ~NgramEntryBase() = default;
-
+// The n-grams of the pool in a trie over the ids of their items, so the n-grams
+// that start at a position of the input are found in one walk, which stops as soon
+// as the items read are not the prefix of any n-gram. The nodes of the 1-grams are
+// the children of the root, one per item id, so they are found without a lookup.
+class NgramTrie {
  public:
-  size_t Id() const { return id_; }
-};
-
-template <class T>
-class NgramEntry;
-
-template <>
-class NgramEntry<int64_t> : public NgramEntryBase {
-  std::vector<int64_t> items_;
-  size_t hash_ = 0;
-
-  void RunningHash(int64_t v) {
-    std::hash<int64_t> hf{};
-    hash_ ^= hf(v) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+  void Reset(size_t num_items) {
+    ngram_ids_.assign(num_items + 1, kNoNgram);
+    children_.clear();
   }
 
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(*first);
-      ++first;
+  // Adds the n-gram of items, returns false if it is already in the trie
+  bool Add(const int32_t* items, size_t size, int32_t ngram_id) {
+    int32_t node = kRoot;
+    for (size_t i = 0; i < size; ++i) {
+      int32_t child = Child(node, items[i]);
+      if (child == kNoNode) {
+        child = static_cast<int32_t>(ngram_ids_.size());
+        ngram_ids_.push_back(kNoNgram);
+        children_.emplace(Key(node, items[i]), child);
+      }
+      node = child;
     }
-    assert(!items_.empty());
-  }
-  // For sampling
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(int64_t v) {
-    items_.push_back(v);
-    RunningHash(v);
-  }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<int64_t>(std::cout, ","));
-    std::cout << std::endl;
-  }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
+    if (ngram_ids_[node] != kNoNgram) {
+      return false;
+    }
+    ngram_ids_[node] = ngram_id;
+    return true;
   }
-  bool operator==(const NgramEntry& o) const {
-    return items_ == o.items_;
+
+  // The node of the n-gram that continues the n-gram of node with item, or kNoNode
+  int32_t Child(int32_t node, int32_t item) const {
+    if (node == kRoot) {
+      return item + 1;
+    }
+    auto hit = children_.find(Key(node, item));
+    return hit == children_.end() ? kNoNode : hit->second;
   }
-  size_t Hash() const {
-    return hash_;
+
+  // The id of the pool n-gram of node, or kNoNgram for the prefixes that are not one
+  int32_t NgramId(int32_t node) const {
+    return ngram_ids_[node];
   }
-};
 
-template <>
-class NgramEntry<int32_t> : public NgramEntry<int64_t> {
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntry<int64_t>(id, first, last) {}
-  explicit NgramEntry() = default;
-};
+  static const int32_t kRoot = 0;
+  static const int32_t kNoNode = -1;
+  static const int32_t kNoNgram = -1;
 
-template <>
-class NgramEntry<std::string> : public NgramEntryBase {
  private:
-  std::vector<std::reference_wrapper<const std::string>> items_;
-  size_t hash_ = 0;
-
-  void RunningHash(const std::string& s) {
-    std::hash<std::string> hf{};
-    hash_ ^= hf(s) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
-  }
-
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(std::cref(*first));
-      ++first;
-    }
-    assert(!items_.empty());
-  }
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(const std::string& s) {
-    items_.push_back(std::cref(s));
-    RunningHash(s);
-  }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<std::string>(std::cout, ","));
-    std::cout << std::endl;
-  }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
+  static uint64_t Key(int32_t node, int32_t item) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(node)) << 32) | static_cast<uint32_t>(item);
   }
 
-  bool operator==(const NgramEntry& o) const {
-    if (items_.size() == o.items_.size()) {
-      return std::equal(items_.cbegin(), items_.cend(),
-                        o.items_.cbegin(), o.items_.cend(),
-                        std::equal_to<std::string>());
-    }
-    return false;
-  }
-  size_t Hash() const {
-    return hash_;
-  }
+  std::vector<int32_t> ngram_ids_;
+  std::unordered_map<uint64_t, int32_t> children_;
 };
 
-using IntegerPoolSet = std::unordered_set<NgramEntry<int64_t>>;
-// Does not own strings, contains references to them. This helps
-// to search by string references that point to the current input.
-using StringPoolSet = std::unordered_set<NgramEntry<std::string>>;
-
-template <typename ForwardIter, typename Cont>
-inline void Emplace(ForwardIter first, size_t ngrams, size_t ngram_size, size_t& ngram_id, Cont& c) {
-  for (; ngrams > 0; --ngrams) {
-    c.emplace(ngram_id, first, first + ngram_size);
-    first += ngram_size;
-    ++ngram_id;
-  }
-}
+const int32_t NgramTrie::kRoot;
+const int32_t NgramTrie::kNoNode;
+const int32_t NgramTrie::kNoNgram;
 
-}  // namespace ngram_details
-}  // namespace onnxruntime
+// Items of the input that are not in any n-gram of the pool
+const int32_t kNoItem = -1;
 
-using namespace onnxruntime::ngram_details;
+// Input items times skip distances each range of rows counted in parallel holds at least
+const int64_t kMinItemsPerRange = 16 * 1024;
 
-namespace std {
-template <typename T>
-struct hash<NgramEntry<T>> {
-  typedef NgramEntry<T> argument_type;
-  typedef size_t result_type;
-  result_type operator()(const argument_type& a) const {
-    return a.Hash();
-  }
-};
-}  // namespace std
+}  // namespace ngram_details
+
+using namespace ngram_details;
 
 namespace onnxruntime {
 
@@ -219,12 +149,10 @@ struct TfIdfVectorizer::Impl {
   std::vector<int64_t> ngram_indexes_;
   std::vector<float> weights_;
 
-  std::vector<std::string> pool_strings_;
-  // This set contains references to pool_string_ entries
-  // of pool_strings attribute
-  StringPoolSet str_set_;
-  // This set contains pool_int64s entries
-  IntegerPoolSet int64_set_;
+  // The ids of the items of the pool n-grams, either strings or int64s
+  ml::FlatStringMap<int32_t> str_items_;
+  std::unordered_map<int64_t, int32_t> int64_items_;
+  NgramTrie trie_;
   size_t output_size_ = 0;
 
   Impl() = default;
@@ -233,48 +161,98 @@ struct TfIdfVectorizer::Impl {
   Impl& operator=(const Impl&) = delete;
 
   template <typename T>
-  auto PoolEnd() const;
+  int32_t ItemId(const T& item) const;
 
-  template <typename T>
-  auto PoolFind(const ngram_details::NgramEntry<T>&) const;
-
-  void IncrementCount(size_t ngram_id, size_t row_num,
-                      std::vector<uint32_t>& frequencies) const {
-    assert(ngram_id < ngram_indexes_.size());
-    auto output_idx = row_num * output_size_ + ngram_indexes_[ngram_id];
-    assert(static_cast<size_t>(output_idx) < frequencies.size());
-    ++frequencies[output_idx];
-  }
+  // Counts the n-grams of a row of items in frequencies, indexed by output index,
+  // and records in hits the output indexes that were 0 before
+  void CountRow(const int32_t* items, size_t C, std::vector<uint32_t>& frequencies,
+                std::vector<int64_t>& hits) const;
+
+  // Writes the weighted frequencies of the hits of a row to the output row, which is 0
+  // elsewhere, and resets them to 0
+  void OutputRow(std::vector<uint32_t>& frequencies, std::vector<int64_t>& hits, float* output) const;
 };
 
 template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int64_t>() const {
-  return int64_set_.cend();
+inline int32_t TfIdfVectorizer::Impl::ItemId<int64_t>(const int64_t& item) const {
+  auto hit = int64_items_.find(item);
+  return hit == int64_items_.end() ? kNoItem : hit->second;
 }
 
 template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int32_t>() const {
-  return PoolEnd<int64_t>();
+inline int32_t TfIdfVectorizer::Impl::ItemId<int32_t>(const int32_t& item) const {
+  return ItemId<int64_t>(item);
 }
 
 template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<std::string>() const {
-  return str_set_.cend();
+inline int32_t TfIdfVectorizer::Impl::ItemId<std::string>(const std::string& item) const {
+  const int32_t* hit = str_items_.Find(item);
+  return hit == nullptr ? kNoItem : *hit;
 }
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int64_t>(const NgramEntry<int64_t>& i) const {
-  return int64_set_.find(i);
-}
+void TfIdfVectorizer::Impl::CountRow(const int32_t* items, size_t C, std::vector<uint32_t>& frequencies,
+                                     std::vector<int64_t>& hits) const {
+  auto increment_count = [&](int32_t ngram_id) {
+    assert(static_cast<size_t>(ngram_id) < ngram_indexes_.size());
+    const int64_t output_idx = ngram_indexes_[ngram_id];
+    if (frequencies[output_idx]++ == 0) {
+      hits.push_back(output_idx);
+    }
+  };
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int32_t>(const NgramEntry<int32_t>& i) const {
-  return int64_set_.find(i);
+  const size_t max_gram_length = max_gram_length_;
+  const size_t max_skip_distance = max_skip_count_ + 1;  // Convert to distance
+  for (size_t ngram_start = 0; ngram_start < C; ++ngram_start) {
+    if (items[ngram_start] == kNoItem) {
+      continue;
+    }
+    // 1-grams are counted once, not once per skip distance
+    const int32_t unigram = trie_.Child(NgramTrie::kRoot, items[ngram_start]);
+    if (trie_.NgramId(unigram) != NgramTrie::kNoNgram) {
+      increment_count(trie_.NgramId(unigram));
+    }
+    for (size_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+      int32_t node = unigram;
+      for (size_t ngram_size = 2, ngram_item = ngram_start + skip_distance;
+           ngram_size <= max_gram_length && ngram_item < C;
+           ++ngram_size, ngram_item += skip_distance) {
+        if (items[ngram_item] == kNoItem) {
+          break;
+        }
+        node = trie_.Child(node, items[ngram_item]);
+        if (node == NgramTrie::kNoNode) {
+          break;
+        }
+        if (trie_.NgramId(node) != NgramTrie::kNoNgram) {
+          increment_count(trie_.NgramId(node));
+        }
+      }
+    }
+  }
 }
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<std::string>(const NgramEntry<std::string>& i) const {
-  return str_set_.find(i);
+void TfIdfVectorizer::Impl::OutputRow(std::vector<uint32_t>& frequencies, std::vector<int64_t>& hits,
+                                      float* output) const {
+  const auto& w = weights_;
+  for (int64_t i : hits) {
+    const uint32_t f = frequencies[i];
+    switch (weighting_criteria_) {
+      case kTF:
+        output[i] = static_cast<float>(f);
+        break;
+      case kIDF:
+        output[i] = w.empty() ? 1.0f : w[i];
+        break;
+      case kTFIDF:
+        output[i] = w.empty() ? static_cast<float>(f) : f * w[i];
+        break;
+      case kNone:  // fall-through
+      default:
+        assert(false);
+    }
+    frequencies[i] = 0;
+  }
+  hits.clear();
 }
 
 TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), impl_(new Impl) {
@@ -331,19 +309,48 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
                 "Got weights of size: ", std::to_string(impl_->weights_.size()),
                 " but ngram_indexes size: ", std::to_string(impl_->ngram_indexes_.size()),
                 " must be of equal size");
+    ORT_ENFORCE(impl_->output_size_ <= impl_->weights_.size(),
+                "Got weights of size: ", std::to_string(impl_->weights_.size()),
+                " but the greatest ngram_indexes value is: ", std::to_string(impl_->output_size_ - 1));
   }
 
+  std::vector<std::string> pool_strings;
   std::vector<int64_t> pool_int64s;
-  status = info.GetAttrs("pool_strings", impl_->pool_strings_);
+  status = info.GetAttrs("pool_strings", pool_strings);
   if (status.IsOK()) {
-    ORT_ENFORCE(!impl_->pool_strings_.empty(), "pool_strings must not be empty if specified");
+    ORT_ENFORCE(!pool_strings.empty(), "pool_strings must not be empty if specified");
   } else {
     status = info.GetAttrs("pool_int64s", pool_int64s);
     ORT_ENFORCE(status.IsOK() && !pool_int64s.empty(), "non-empty pool_int64s is required if pool_strings not provided");
   }
 
   // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
-  const auto total_items = (impl_->pool_strings_.empty()) ? pool_int64s.size() : impl_->pool_strings_.size();
+  const auto total_items = (pool_strings.empty()) ? pool_int64s.size() : pool_strings.size();
+  // The items of the loaded n-grams get ids in the order they are first seen
+  std::vector<int32_t> pool_items(total_items, kNoItem);
+  int32_t num_items = 0;
+  auto assign_item_id = [&](size_t idx) {
+    if (pool_strings.empty()) {
+      auto p = impl_->int64_items_.emplace(pool_int64s[idx], num_items);
+      num_items += p.second ? 1 : 0;
+      pool_items[idx] = p.first->second;
+    } else {
+      const int32_t* hit = impl_->str_items_.Find(pool_strings[idx]);
+      if (hit == nullptr) {
+        impl_->str_items_.Insert(pool_strings[idx], num_items);
+        pool_items[idx] = num_items++;
+      } else {
+        pool_items[idx] = *hit;
+      }
+    }
+  };
+  struct NgramRange {
+    size_t start_idx;
+    size_t ngrams;
+    size_t ngram_size;
+    size_t first_ngram_id;
+  };
+  std::vector<NgramRange> loaded_ranges;
   size_t ngram_id = 0;
   // Load into dictionary only required gram sizes
   const size_t min_gram_length = impl_->min_gram_length_;
@@ -359,84 +366,36 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       ORT_ENFORCE((items % ngram_size == 0),
                   "Number of items must compose whole ", std::to_string(ngram_size), "-grams");
       auto ngrams = items / ngram_size;
-      // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
+      // Skip loading into the trie ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
-        if (impl_->pool_strings_.empty()) {
-          auto before_insert = impl_->int64_set_.size();
-          Emplace(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->int64_set_.size(), "pool_int64s duplicate ", std::to_string(ngram_size), "-grams detected");
-        } else {
-          auto before_insert = impl_->str_set_.size();
-          Emplace(impl_->pool_strings_.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->str_set_.size(), "poll_strings duplicate ", std::to_string(ngram_size), "-grams detected");
+        for (size_t idx = start_idx; idx < end_idx; ++idx) {
+          assign_item_id(idx);
         }
-      } else {
-        ngram_id += ngrams;
+        loaded_ranges.push_back({start_idx, ngrams, ngram_size, ngram_id});
       }
+      ngram_id += ngrams;
     }
     ++ngram_size;
   }
+  ORT_ENFORCE(ngram_id <= static_cast<size_t>(std::numeric_limits<int32_t>::max()), "Too many n-grams in the pool");
+
+  impl_->trie_.Reset(num_items);
+  for (const auto& range : loaded_ranges) {
+    for (size_t n = 0; n < range.ngrams; ++n) {
+      bool added = impl_->trie_.Add(pool_items.data() + range.start_idx + n * range.ngram_size, range.ngram_size,
+                                    static_cast<int32_t>(range.first_ngram_id + n));
+      ORT_ENFORCE(added, pool_strings.empty() ? "pool_int64s duplicate " : "poll_strings duplicate ",
+                  std::to_string(range.ngram_size), "-grams detected");
+    }
+  }
 }
 
 TfIdfVectorizer::~TfIdfVectorizer() {
 }
 
-void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::vector<uint32_t>& frequences) const {
-  const Impl& impl = *impl_;
-  std::vector<int64_t> output_dims;
-  if (B == 0) {
-    output_dims.push_back(impl.output_size_);
-  } else {
-    output_dims.push_back(B);
-    output_dims.push_back(impl.output_size_);
-  }
-
-  TensorShape output_shape(output_dims);
-  assert(frequences.size() == static_cast<size_t>(output_shape.Size()));
-
-  auto Y = ctx->Output(0, output_shape);
-  auto output_data = Y->MutableData<float>();
-  const auto& w = impl.weights_;
-  switch (impl.weighting_criteria_) {
-    case kTF: {
-      for (auto f : frequences) {
-        *output_data++ = static_cast<float>(f);
-      }
-    } break;
-    case kIDF: {
-      if (!w.empty()) {
-        assert(frequences.size() == w.size());
-        for (size_t i = 0; i < frequences.size(); ++i) {
-          *output_data++ = (frequences[i] > 0) ? w[i] : 0;
-        }
-      } else {
-        for (auto f : frequences) {
-          *output_data++ = (f > 0) ? 1.0f : 0;
-        }
-      }
-    } break;
-    case kTFIDF: {
-      if (!w.empty()) {
-        assert(frequences.size() == w.size());
-        for (size_t i = 0; i < frequences.size(); ++i) {
-          *output_data++ = frequences[i] * w[i];
-        }
-      } else {
-        for (auto f : frequences) {
-          *output_data++ = static_cast<float>(f);
-        }
-      }
-    } break;
-    case kNone:  // fall-through
-    default:
-      assert(false);
-  }
-}
-
 template <typename T>
 Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
   const auto& impl = *impl_;
-  auto const set_end = impl.PoolEnd<T>();
 
   auto X = ctx->Input<Tensor>(0);
   auto& input_shape = X->Shape();
@@ -472,87 +431,39 @@ Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
 
   assert((b_dim * C) == total_items);
 
-  // Frequency holder allocate [B..output_size_]
-  // and init all to zero
-  std::vector<uint32_t> frequencies;
-  frequencies.resize(b_dim * impl.output_size_, 0);
-
-  const auto max_gram_length = impl.max_gram_length_;
-  const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
-  auto const input_data = X->template Data<T>();
-  auto const end_data = input_data + total_items;
-  NgramEntry<T> sample;
-
-  // Treat 1-grams in a special way
-  if (start_ngram_size == 1) {
-    size_t row_num = 0;
-    auto ngram_start = input_data;
-    while (ngram_start < end_data) {
-      auto const ngram_row_end = ngram_start + C;
-      while (ngram_start < ngram_row_end) {
-        sample.Clear();
-        sample.AddItem(*ngram_start);
-        auto hit = impl.PoolFind<T>(sample);
-        if (hit != set_end) {
-          // record frequency
-          auto ngram_id = hit->Id();
-          impl.IncrementCount(ngram_id, row_num, frequencies);
-        }
-        ++ngram_start;
-      }
-      ++row_num;
-      ngram_start = ngram_row_end;
-    }
-    if (++start_ngram_size > max_gram_length) {
-      OutputResult(ctx, B, frequencies);
-      return Status::OK();
-    }
+  std::vector<int64_t> output_dims;
+  if (B == 0) {
+    output_dims.push_back(impl.output_size_);
+  } else {
+    output_dims.push_back(B);
+    output_dims.push_back(impl.output_size_);
   }
+  TensorShape output_shape(output_dims);
+  auto Y = ctx->Output(0, output_shape);
+  auto output_data = Y->MutableData<float>();
+  auto const input_data = X->template Data<T>();
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = input_data;
-    size_t row_num = 0;
-    while (ngram_start < end_data) {
-      assert((B == 0) || (row_num < B));
-      auto const ngram_row_end = ngram_start + C;
-      assert(ngram_row_end <= end_data);
-      while (ngram_start < ngram_row_end) {
-        // Check if any n-gram size in [start_ngram_size..max_gram_length] range
-        // fit before the end of the row so we do not waste time adding [1..start_ngram_size)
-        // At least items of start_ngram_size should fit
-        // last row should match end_data
-        auto at_least_this = ngram_start + skip_distance * (start_ngram_size - 1);
-        if (at_least_this >= ngram_row_end) {
-          break;
-        }
-        sample.Clear();
-        auto ngram_item = ngram_start;
-        for (auto ngram_size = 1;
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item += skip_distance) {
-          sample.AddItem(*ngram_item);
-
-          // Do not test anything before start_ngram_size
-          if (ngram_size >= start_ngram_size) {
-            auto hit = impl.PoolFind<T>(sample);
-            if (hit != set_end) {
-              // record frequency
-              auto ngram_id = hit->Id();
-              impl.IncrementCount(ngram_id, row_num, frequencies);
-            }
-          }
-        }
-        // Sliding window shift
-        ++ngram_start;
+  // The rows get counts of their own, of which only the hits are written
+  // out and reset, so a row costs the same for any size of the pool
+  auto count_rows = [&](int64_t row_begin, int64_t row_end) {
+    std::vector<int32_t> items(C);
+    std::vector<uint32_t> frequencies(impl.output_size_, 0);
+    std::vector<int64_t> hits;
+    for (size_t row_num = static_cast<size_t>(row_begin); row_num < static_cast<size_t>(row_end); ++row_num) {
+      const T* row = input_data + row_num * C;
+      for (size_t i = 0; i < C; ++i) {
+        items[i] = impl.ItemId<T>(row[i]);
       }
-      // Next row
-      ngram_start = ngram_row_end;
-      ++row_num;
+      impl.CountRow(items.data(), C, frequencies, hits);
+      float* output_row = output_data + row_num * impl.output_size_;
+      std::fill(output_row, output_row + impl.output_size_, 0.0f);
+      impl.OutputRow(frequencies, hits, output_row);
     }
-  }
-  OutputResult(ctx, B, frequencies);
+  };
+
+  // Rows are split between the threads of the intra-op thread pool when there are enough
+  const int64_t row_items = static_cast<int64_t>(C) * (impl.max_skip_count_ + 1);
+  ctx->ParallelFor(static_cast<int64_t>(b_dim), std::max<int64_t>(1, kMinItemsPerRange / row_items), count_rows);
   return Status::OK();
 }
 
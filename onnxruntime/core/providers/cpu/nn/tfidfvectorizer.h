@@ -22,9 +22,6 @@ class TfIdfVectorizer final : public OpKernel {
   template <typename T>
   Status ComputeImpl(OpKernelContext* ctx) const;
 
-  // Apply weighing criteria and output
-  void OutputResult(OpKernelContext* ctx, size_t b_dim, const std::vector<uint32_t>& frequences) const;
-
   struct Impl;
   std::unique_ptr<Impl> impl_;
 };
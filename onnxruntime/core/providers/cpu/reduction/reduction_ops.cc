@@ -35,11 +35,50 @@ REGISTER_UNARY_ELEMENTWISE_KERNEL(ReduceSumSquare, 1);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMax, 1);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMin, 1);
 
-// When all reduce axises located at the tail of the dims, quite general cases, transpose and extra
-// copy could be skiped to improve performance, if required by check_no_transpose = true;
-// return value: true means transposedInputData is not created/copied, input tensor data could
-//               be direct use as row major matrix [block_size, blocks], where blocks is the
-//               size of each reduce.
+bool GetReduceView(const std::vector<int64_t>& dims, const std::vector<int64_t>& axes, ReduceView& view) {
+  std::vector<bool> reduce_axis(dims.size(), false);
+  for (auto axis : axes) {
+    reduce_axis[axis] = true;
+  }
+
+  // the first and last reduced dimension whose size isn't 1, between which only dimensions of size 1 may be kept
+  int64_t first = -1;
+  int64_t last = -1;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (reduce_axis[i] && dims[i] == 0) {
+      return false;
+    }
+    if (reduce_axis[i] && dims[i] != 1) {
+      if (first < 0) {
+        first = static_cast<int64_t>(i);
+      }
+      last = static_cast<int64_t>(i);
+    }
+  }
+
+  for (int64_t i = first + 1; i < last; ++i) {
+    if (!reduce_axis[i] && dims[i] != 1) {
+      return false;
+    }
+  }
+
+  view = ReduceView();
+  for (size_t i = 0; i < dims.size(); ++i) {
+    const auto index = static_cast<int64_t>(i);
+    if (first < 0 || index < first) {
+      view.outer *= dims[i];
+    } else if (index <= last) {
+      view.reduced *= dims[i];
+    } else {
+      view.inner *= dims[i];
+    }
+  }
+  return true;
+}
+
+// If view is given and the input can be reduced in place, sets it and returns true without transposing the input.
+// Otherwise transposes the input into transposedInputData, so that it's a column major matrix of
+// [block_size, blocks] where blocks is the size of each reduction.
 template <typename T>
 bool PrepareForReduce(OpKernelContext* ctx,
                       std::vector<T>& transposedInputData,
@@ -48,7 +87,7 @@ bool PrepareForReduce(OpKernelContext* ctx,
                       int64_t& blocks,
                       const std::vector<int64_t>& axes_,
                       bool keepdims_,
-                      bool check_no_transpose = false) {
+                      ReduceView* view = nullptr) {
   const Tensor* input_tensor_ptr = ctx->Input<Tensor>(0);
   ORT_ENFORCE(input_tensor_ptr != nullptr);
   const Tensor& input = *input_tensor_ptr;
@@ -67,13 +106,6 @@ bool PrepareForReduce(OpKernelContext* ctx,
 
   std::sort(axes.begin(), axes.end());
 
-  // If all reduced axes are located at the tail of the input shape, then copy could be skipped is required
-  bool need_copy = true;
-  if (axes.size() <= ndim && axes.front() == static_cast<int64_t>(ndim - axes.size()) 
-      && axes.back() == static_cast<int64_t>(ndim) - 1) {
-    need_copy = false;
-  }
-
   vector<bool> keep_axis(ndim, true);
   for (auto i : axes) {
     keep_axis[i] = false;
@@ -128,7 +160,7 @@ bool PrepareForReduce(OpKernelContext* ctx,
   block_size = input.Shape().Size() / first_dim;
   blocks = first_dim;
 
-  if (!need_copy && check_no_transpose) {
+  if (view != nullptr && GetReduceView(in_dims, axes, *view)) {
     return true;
   }
 
@@ -198,12 +230,191 @@ bool PrepareForReduce(OpKernelContext* ctx,
   return false;
 }
 
+// Reducers of the rows of a ReduceView. Reduce reduces a contiguous row, as when the inner size is 1. Otherwise
+// Init, Accumulate and Finish reduce the rows of the reduced axis elementwise into a row of the output.
+template <typename T>
+struct SumReducer {
+  static T Reduce(const ConstEigenVectorArrayMap<T>& row) { return row.sum(); }
+  static void Init(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out = row; }
+  static void Accumulate(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out += row; }
+  static void Finish(EigenVectorArrayMap<T>&, int64_t) {}
+};
+
+template <typename T>
+struct MeanReducer : SumReducer<T> {
+  static T Reduce(const ConstEigenVectorArrayMap<T>& row) { return row.mean(); }
+  static void Finish(EigenVectorArrayMap<T>& out, int64_t reduced) { out /= static_cast<T>(reduced); }
+};
+
+template <typename T>
+struct LogSumReducer : SumReducer<T> {
+  static T Reduce(const ConstEigenVectorArrayMap<T>& row) { return static_cast<T>(std::log(row.sum())); }
+  static void Finish(EigenVectorArrayMap<T>& out, int64_t) {
+    for (int64_t i = 0; i < out.size(); ++i) {
+      out(i) = static_cast<T>(std::log(out(i)));
+    }
+  }
+};
+
+template <typename T>
+struct SumSquareReducer {
+  static T Reduce(const ConstEigenVectorArrayMap<T>& row) { return row.square().sum(); }
+  static void Init(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out = row.square(); }
+  static void Accumulate(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out += row.square(); }
+  static void Finish(EigenVectorArrayMap<T>&, int64_t) {}
+};
+
+template <typename T>
+struct L2Reducer : SumSquareReducer<T> {
+  static T Reduce(const ConstEigenVectorArrayMap<T>& row) { return static_cast<T>(std::sqrt(row.square().sum())); }
+  static void Finish(EigenVectorArrayMap<T>& out, int64_t) {
+    for (int64_t i = 0; i < out.size(); ++i) {
+      out(i) = static_cast<T>(std::sqrt(out(i)));
+    }
+  }
+};
+
+template <typename T>
+struct L1Reducer {
+  static T Reduce(const ConstEigenVectorArrayMap<T>& row) { return row.abs().sum(); }
+  static void Init(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out = row.abs(); }
+  static void Accumulate(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out += row.abs(); }
+  static void Finish(EigenVectorArrayMap<T>&, int64_t) {}
+};
+
+template <typename T>
+struct ProdReducer {
+  static T Reduce(const ConstEigenVectorArrayMap<T>& row) { return row.prod(); }
+  static void Init(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out = row; }
+  static void Accumulate(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out *= row; }
+  static void Finish(EigenVectorArrayMap<T>&, int64_t) {}
+};
+
+template <typename T>
+struct MaxReducer {
+  static T Reduce(const ConstEigenVectorArrayMap<T>& row) { return row.maxCoeff(); }
+  static void Init(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out = row; }
+  static void Accumulate(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out = out.max(row); }
+  static void Finish(EigenVectorArrayMap<T>&, int64_t) {}
+};
+
+template <typename T>
+struct MinReducer {
+  static T Reduce(const ConstEigenVectorArrayMap<T>& row) { return row.minCoeff(); }
+  static void Init(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out = row; }
+  static void Accumulate(EigenVectorArrayMap<T>& out, const ConstEigenVectorArrayMap<T>& row) { out = out.min(row); }
+  static void Finish(EigenVectorArrayMap<T>&, int64_t) {}
+};
+
+// the number of elements of a row of the output that a thread reduces at once when the inner size isn't 1, which
+// keeps the row in the L1 cache and splits the work of a reduction over the leading axes among the threads
+static constexpr int64_t kReduceInnerBlockSize = 1024;
+
+// the number of input elements each range of outputs reduced in parallel reads at least
+static constexpr int64_t kMinReduceElementsPerRange = 16 * 1024;
+
+// Reduces the input of the shape [outer, reduced, inner] over its middle axis without copying it, in parallel over
+// the kept outer and inner positions on the intra-op pool of ctx. The reduced size must not be 0.
+template <typename T, typename Reducer>
+void ReduceInPlace(OpKernelContext* ctx, const T* input, T* output, const ReduceView& view) {
+  const int64_t outer = view.outer;
+  const int64_t reduced = view.reduced;
+  const int64_t inner = view.inner;
+
+  if (inner == 1) {
+    const int64_t min_rows = std::max<int64_t>(1, kMinReduceElementsPerRange / reduced);
+    ctx->ParallelFor(outer, min_rows, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        output[i] = Reducer::Reduce(ConstEigenVectorArrayMap<T>(input + i * reduced, reduced));
+      }
+    });
+    return;
+  }
+
+  // the rows of the reduced axis are read in order, each contiguous, rather than gathering a strided column per output
+  const int64_t inner_blocks = (inner + kReduceInnerBlockSize - 1) / kReduceInnerBlockSize;
+  const int64_t min_blocks = std::max<int64_t>(1, kMinReduceElementsPerRange / (reduced * kReduceInnerBlockSize));
+  ctx->ParallelFor(outer * inner_blocks, min_blocks, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const int64_t i = b / inner_blocks;
+      const int64_t j = (b % inner_blocks) * kReduceInnerBlockSize;
+      const int64_t n = std::min(kReduceInnerBlockSize, inner - j);
+      const T* rows = input + i * reduced * inner + j;
+
+      EigenVectorArrayMap<T> out(output + i * inner + j, n);
+      Reducer::Init(out, ConstEigenVectorArrayMap<T>(rows, n));
+      for (int64_t r = 1; r < reduced; ++r) {
+        Reducer::Accumulate(out, ConstEigenVectorArrayMap<T>(rows + r * inner, n));
+      }
+      Reducer::Finish(out, reduced);
+    }
+  });
+}
+
+template <typename T>
+void ComputeMeanAndVariance(OpKernelContext* ctx, const T* input, const ReduceView& view, T* mean, T* variance) {
+  ReduceInPlace<T, MeanReducer<T>>(ctx, input, mean, view);
+
+  // the variance is the mean of the squared deviations, which has no cancellation unlike E(x^2) - E(x)^2
+  const int64_t outer = view.outer;
+  const int64_t reduced = view.reduced;
+  const int64_t inner = view.inner;
+  if (inner == 1) {
+    const int64_t min_rows = std::max<int64_t>(1, kMinReduceElementsPerRange / reduced);
+    ctx->ParallelFor(outer, min_rows, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        variance[i] = (ConstEigenVectorArrayMap<T>(input + i * reduced, reduced) - mean[i]).square().mean();
+      }
+    });
+    return;
+  }
+
+  const int64_t inner_blocks = (inner + kReduceInnerBlockSize - 1) / kReduceInnerBlockSize;
+  const int64_t min_blocks = std::max<int64_t>(1, kMinReduceElementsPerRange / (reduced * kReduceInnerBlockSize));
+  ctx->ParallelFor(outer * inner_blocks, min_blocks, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const int64_t i = b / inner_blocks;
+      const int64_t j = (b % inner_blocks) * kReduceInnerBlockSize;
+      const int64_t n = std::min(kReduceInnerBlockSize, inner - j);
+      const T* rows = input + i * reduced * inner + j;
+
+      ConstEigenVectorArrayMap<T> row_mean(mean + i * inner + j, n);
+      EigenVectorArrayMap<T> out(variance + i * inner + j, n);
+      out = (ConstEigenVectorArrayMap<T>(rows, n) - row_mean).square();
+      for (int64_t r = 1; r < reduced; ++r) {
+        out += (ConstEigenVectorArrayMap<T>(rows + r * inner, n) - row_mean).square();
+      }
+      out /= static_cast<T>(reduced);
+    }
+  });
+}
+
+template void ComputeMeanAndVariance<float>(OpKernelContext* ctx, const float* input, const ReduceView& view,
+                                            float* mean, float* variance);
+
+// Reduces in place with Reducer if the reduced axes are adjacent, and returns false otherwise, in which case the
+// reduction is computed from transposedInputData, the transpose PrepareForReduce made.
+template <typename T, typename Reducer>
+bool TryReduceInPlace(OpKernelContext* ctx, const std::vector<int64_t>& axes, bool keepdims,
+                      std::vector<T>& transposedInputData, Tensor** reduced, int64_t& block_size, int64_t& blocks) {
+  ReduceView view;
+  if (!PrepareForReduce<T>(ctx, transposedInputData, reduced, block_size, blocks, axes, keepdims, &view)) {
+    return false;
+  }
+
+  ReduceInPlace<T, Reducer>(ctx, ctx->Input<Tensor>(0)->template Data<T>(), (*reduced)->template MutableData<T>(),
+                            view);
+  return true;
+}
+
 template <typename T>
 Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
   int64_t block_size, blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+  if (TryReduceInPlace<T, L1Reducer<T>>(ctx, axes_, keepdims_, transposedInputData, &reduced, block_size, blocks)) {
+    return Status::OK();
+  }
 
   T* output_data = reduced->template MutableData<T>();
 
@@ -218,7 +429,9 @@ Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
   int64_t block_size, blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+  if (TryReduceInPlace<T, L2Reducer<T>>(ctx, axes_, keepdims_, transposedInputData, &reduced, block_size, blocks)) {
+    return Status::OK();
+  }
 
   T* output_data = reduced->template MutableData<T>();
 
@@ -233,7 +446,9 @@ Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
   int64_t block_size, blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+  if (TryReduceInPlace<T, LogSumReducer<T>>(ctx, axes_, keepdims_, transposedInputData, &reduced, block_size, blocks)) {
+    return Status::OK();
+  }
 
   T* output_data = reduced->template MutableData<T>();
 
@@ -275,7 +490,9 @@ Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
   int64_t block_size, blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+  if (TryReduceInPlace<T, MaxReducer<T>>(ctx, axes_, keepdims_, transposedInputData, &reduced, block_size, blocks)) {
+    return Status::OK();
+  }
 
   T* output_data = reduced->template MutableData<T>();
 
@@ -290,24 +507,14 @@ Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
   int64_t block_size, blocks;
   Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+  if (TryReduceInPlace<T, MeanReducer<T>>(ctx, axes_, keepdims_, transposedInputData, &reduced, block_size, blocks)) {
+    return Status::OK();
+  }
 
   T* output_data = reduced->template MutableData<T>();
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).mean();
-    }
-  }
-  else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
-  }
+  EigenVectorMap<T> out_vec(output_data, block_size);
+  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
 
   return Status::OK();
 }
@@ -317,7 +524,9 @@ Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
   int64_t block_size, blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+  if (TryReduceInPlace<T, MinReducer<T>>(ctx, axes_, keepdims_, transposedInputData, &reduced, block_size, blocks)) {
+    return Status::OK();
+  }
 
   T* output_data = reduced->template MutableData<T>();
 
@@ -332,7 +541,9 @@ Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
   int64_t block_size, blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+  if (TryReduceInPlace<T, ProdReducer<T>>(ctx, axes_, keepdims_, transposedInputData, &reduced, block_size, blocks)) {
+    return Status::OK();
+  }
 
   T* output_data = reduced->template MutableData<T>();
 
@@ -347,24 +558,14 @@ Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
   int64_t block_size, blocks;
   Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+  if (TryReduceInPlace<T, SumReducer<T>>(ctx, axes_, keepdims_, transposedInputData, &reduced, block_size, blocks)) {
+    return Status::OK();
+  }
 
   T* output_data = reduced->template MutableData<T>();
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).sum();
-    }
-  }
-  else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  }
+  EigenVectorMap<T> out_vec(output_data, block_size);
+  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
 
   return Status::OK();
 }
@@ -374,7 +575,9 @@ Status ReduceSumSquare<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
   int64_t block_size, blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+  if (TryReduceInPlace<T, SumSquareReducer<T>>(ctx, axes_, keepdims_, transposedInputData, &reduced, block_size, blocks)) {
+    return Status::OK();
+  }
 
   T* output_data = reduced->template MutableData<T>();
 
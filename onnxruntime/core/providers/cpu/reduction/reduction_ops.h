@@ -9,6 +9,24 @@
 
 namespace onnxruntime {
 
+// The input of a reduction viewed as [outer, reduced, inner], which the reduction reads in place rather than
+// transposing it when the reduced axes are adjacent.
+struct ReduceView {
+  int64_t outer = 1;
+  int64_t reduced = 1;
+  int64_t inner = 1;
+};
+
+// Returns true and sets view if the axes, which must be sorted and non-negative, are adjacent once the dimensions of
+// size 1 are ignored, and none of them is empty.
+bool GetReduceView(const std::vector<int64_t>& dims, const std::vector<int64_t>& axes, ReduceView& view);
+
+// Computes the mean and the variance over the reduced axis of the view, for each of its outer * inner positions,
+// from the input in place on the intra-op pool of ctx, as normalizations of the MeanVarianceNormalization and LayerNorm
+// kind need.
+template <typename T>
+void ComputeMeanAndVariance(OpKernelContext* ctx, const T* input, const ReduceView& view, T* mean, T* variance);
+
 template <bool allow_multi_axes>
 class ReduceKernelBase {
  protected:
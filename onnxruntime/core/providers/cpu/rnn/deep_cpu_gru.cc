@@ -12,7 +12,6 @@
 #include "core/providers/cpu/rnn/deep_cpu_gru.h"
 
 #include <algorithm>
-#include <future>
 #include <stdexcept>
 
 #include "core/common/logging/logging.h"
@@ -165,7 +164,7 @@ template <typename T>
 class UniDirectionalGru {
  public:
   UniDirectionalGru(AllocatorPtr allocator,
-                    const logging::Logger& logger,
+                    const OpKernelContext& context,
                     const int seq_length,
                     const int batch_size,
                     const int input_size,
@@ -176,18 +175,16 @@ class UniDirectionalGru {
                     const gsl::span<const T>& initial_hidden_state,
                     const ActivationFuncs::Entry& activation_func_f,
                     const ActivationFuncs::Entry& activation_func_g,
-                    const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                    Eigen::NonBlockingThreadPool& ttp_);
-#else
-                    TaskThreadPool& ttp_);
-#endif
+                    const float clip);
 
   void Compute(const gsl::span<const T>& inputs,
                const gsl::span<const int>& sequence_lengths,
                const int num_directions,
                const gsl::span<const T>& input_weights,
                const gsl::span<const T>& recurrent_weights,
+               const void* packed_input_weights,
+               const void* packed_recurrent_weights_zr,
+               const void* packed_recurrent_weights_h,
                gsl::span<T>& outputs,
                gsl::span<T>& final_hidden_state);
 
@@ -195,14 +192,9 @@ class UniDirectionalGru {
 
  private:
   AllocatorPtr allocator_;
+  const OpKernelContext& context_;
   const logging::Logger& logger_;
 
-#ifdef USE_EIGEN_THREADPOOL
-  Eigen::NonBlockingThreadPool& ttp_;
-#else
-  TaskThreadPool& ttp_;
-#endif
-
   int seq_length_;
   int batch_size_;
   int input_size_;
@@ -383,84 +375,54 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
     gsl::span<T> hidden_output_2 = hidden_output.subspan(hidden_output_size_per_direction,
                                                          hidden_output_size_per_direction);
 
-#ifndef USE_MKLDNN
-
-#ifdef USE_EIGEN_THREADPOOL
-    auto fn =
-#else
-    std::packaged_task<void()> task_fw{
-#endif
+    ExecuteDirectionsInParallel(
+        context,
         [&]() {
-#endif  // ! USE_MKLDNN
           std::unique_ptr<detail::UniDirectionalGru<T>> fw = std::make_unique<detail::UniDirectionalGru<T>>(
-              alloc, logger,
+              alloc, context,
               seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kForward,
               bias_1, initial_hidden_1,
               activation_funcs_.Entries()[0],
               activation_funcs_.Entries()[1],
-              clip_, ttp_);
-          fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
-#ifndef USE_MKLDNN
-
-#ifndef USE_EIGEN_THREADPOOL
-        }
-  };
-  auto task_results_fw = task_fw.get_future();
-  ttp_.RunTask(std::move(task_fw));
-#else
-        };
-    OrtCondVar cv;
-    OrtMutex lock;
-    bool done = false;
-
-    ttp_.Schedule([&]() {
-      fn();
-      auto ul = std::unique_lock<OrtMutex>(lock);
-      done = true;
-      cv.notify_one();
-    });
-#endif  // USE_EIGEN_THREADPOOL
-
-#endif  // ! USE_MKLDNN
-
-  std::unique_ptr<detail::UniDirectionalGru<T>> bw = std::make_unique<detail::UniDirectionalGru<T>>(
-      alloc, logger,
-      seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kReverse,
-      bias_2, initial_hidden_2,
-      activation_funcs_.Entries()[2],
-      activation_funcs_.Entries()[3],
-      clip_, ttp_);
-  bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2, output_2, hidden_output_2);
-
-#ifndef USE_MKLDNN
-#ifdef USE_EIGEN_THREADPOOL
-  auto ul = std::unique_lock<OrtMutex>(lock);
-    if (!done) cv.wait(ul);
-#else
-    task_results_fw.get();
-#endif
-
-#endif  // ! USE_MKLDNN
-}  // namespace onnxruntime
-else {
-  std::unique_ptr<detail::UniDirectionalGru<T>> gru_p = std::make_unique<detail::UniDirectionalGru<T>>(
-      alloc, logger,
-      seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, direction_,
-      bias_1, initial_hidden_1,
-      activation_funcs_.Entries()[0],
-      activation_funcs_.Entries()[1],
-      clip_, ttp_);
-
-  gru_p->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
-}
+              clip_);
+          fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+                      packed_W_.Direction(0), packed_R_zr_.Direction(0), packed_R_h_.Direction(0),
+                      output_1, hidden_output_1);
+        },
+        [&]() {
+          std::unique_ptr<detail::UniDirectionalGru<T>> bw = std::make_unique<detail::UniDirectionalGru<T>>(
+              alloc, context,
+              seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kReverse,
+              bias_2, initial_hidden_2,
+              activation_funcs_.Entries()[2],
+              activation_funcs_.Entries()[3],
+              clip_);
+          bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
+                      packed_W_.Direction(1), packed_R_zr_.Direction(1), packed_R_h_.Direction(1),
+                      output_2, hidden_output_2);
+        },
+        logger);
+  } else {
+    std::unique_ptr<detail::UniDirectionalGru<T>> gru_p = std::make_unique<detail::UniDirectionalGru<T>>(
+        alloc, context,
+        seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, direction_,
+        bias_1, initial_hidden_1,
+        activation_funcs_.Entries()[0],
+        activation_funcs_.Entries()[1],
+        clip_);
+
+    gru_p->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+                   packed_W_.Direction(0), packed_R_zr_.Direction(0), packed_R_h_.Direction(0),
+                   output_1, hidden_output_1);
+  }
 
-if (!output.empty())
-  DumpMatrix("Y", output.data(), seq_length* num_directions_* batch_size, hidden_size_);
+  if (!output.empty())
+    DumpMatrix("Y", output.data(), seq_length * num_directions_ * batch_size, hidden_size_);
 
-DumpMatrix("Y_h", hidden_output.data(), num_directions_* batch_size, hidden_size_);
+  DumpMatrix("Y_h", hidden_output.data(), num_directions_ * batch_size, hidden_size_);
 
-return Status::OK();
-}  // namespace onnxruntime
+  return Status::OK();
+}
 
 //
 // Implementation of internal helper code
@@ -468,7 +430,7 @@ namespace detail {
 
 template <typename T>
 UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
-                                        const logging::Logger& logger,
+                                        const OpKernelContext& context,
                                         const int seq_length,
                                         const int batch_size,
                                         const int input_size,
@@ -479,15 +441,10 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
                                         const gsl::span<const T>& initial_hidden_state,
                                         const ActivationFuncs::Entry& activation_func_f,
                                         const ActivationFuncs::Entry& activation_func_g,
-                                        const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                                        Eigen::NonBlockingThreadPool& ttp)
-#else
-                                        TaskThreadPool& ttp)
-#endif
+                                        const float clip)
     : allocator_(allocator),
-      logger_(logger),
-      ttp_(ttp),
+      context_(context),
+      logger_(context.Logger()),
       seq_length_(seq_length),
       batch_size_(batch_size),
       input_size_(input_size),
@@ -561,6 +518,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const int num_directions,
                                    const gsl::span<const T>& input_weights,
                                    const gsl::span<const T>& recurrent_weights,
+                                   const void* packed_input_weights,
+                                   const void* packed_recurrent_weights_zr,
+                                   const void* packed_recurrent_weights_h,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -616,7 +576,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
               input_weights.cbegin(), input_weights.cend(),
               input_size_, beta,
               outputZRH_.begin(), outputZRH_.end(),
-              hidden_size_x3);
+              hidden_size_x3, packed_input_weights);
 
   DumpMatrix("inputs with weights applied", outputZRH_.data(), seq_length_ * batch_size_ * 3, hidden_size_);
 
@@ -645,7 +605,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
     if (batch_size_ % hidden_num_threads_ != 0)
       fused_hidden_rows++;
 
-    // lambda executed by Eigen::NonBlockingThreadPool
+    // lambda executed on the intra-op thread pool
     auto hidden_gemm_and_activations = [&](const int row) {
       //handling boundaries
       int local_fused_hidden_rows = fused_hidden_rows;
@@ -694,7 +654,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                     recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
                     hidden_size_, beta,
                     outputZRH_.begin() + out_added_offset, outputZRH_.end(),
-                    hidden_size_x3);
+                    hidden_size_x3, packed_recurrent_weights_zr);
 
         DumpMatrix("Xt*(W[zr]^T) + Ht-1 * R[zr]" + row_str,
                    outputZRH_.data() + out_added_offset, local_fused_hidden_rows, hidden_size_x2, 0, hidden_size_x3);
@@ -711,7 +671,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                       recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
                       hidden_size_, beta,
                       linear_output_local, linear_output_.end(),  // pre: Rbh, post:output
-                      hidden_size_);
+                      hidden_size_, packed_recurrent_weights_h);
 
           DumpMatrix("Ht-1 * (Rh^T) + Rbh " + row_str, &*linear_output_local, batch_size_, hidden_size_);
         }
@@ -774,7 +734,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                       recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),
                       hidden_size_, beta,
                       outputZRH_.begin() + out_added_offset + hidden_size_x2, outputZRH_.end(),
-                      hidden_size_x3);
+                      hidden_size_x3, packed_recurrent_weights_h);
         }
 
         DumpMatrix("Xt*(Wh^T) + (" + label + ")" + row_str,
@@ -857,7 +817,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       }
     };
 
-    ExecuteLambdaInParallel("Processing batch", hidden_gemm_and_activations, batch_size_, fused_hidden_rows, ttp_, logger_);
+    ExecuteLambdaInParallel(context_, "Processing batch", hidden_gemm_and_activations, batch_size_, fused_hidden_rows,
+                            logger_);
   } else {
     size_t out_added_offset;
 
@@ -900,7 +861,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                   recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
                   hidden_size_, beta,
                   outputZRH_.begin() + out_added_offset, outputZRH_.end(),
-                  hidden_size_x3);
+                  hidden_size_x3, packed_recurrent_weights_zr);
 
       DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
                  outputZRH_.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
@@ -916,7 +877,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                     recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
                     hidden_size_, beta,
                     linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
-                    hidden_size_);
+                    hidden_size_, packed_recurrent_weights_h);
 
         DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
       }
@@ -983,7 +944,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                     recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
                     hidden_size_, beta,
                     out_H, outputZRH_.end(),
-                    hidden_size_x3);
+                    hidden_size_x3, packed_recurrent_weights_h);
       }
 
       DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, outputZRH_.data() + out_added_offset,
@@ -1112,10 +1073,8 @@ void UniDirectionalGru<T>::AllocateBuffers() {
 
 template <typename T>
 void UniDirectionalGru<T>::SetNumThreads() {
-  int threads = std::thread::hardware_concurrency() - 1;
-
-  if (threads < 1)
-    threads = 1;
+  // the threads of the intra-op thread pool and the calling thread
+  int threads = context_.NumParallelRanges();
 
   hidden_num_threads_ = threads;
   batch_parallel_ = false;
@@ -50,6 +50,17 @@ class DeepCpuGruOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    // pack constant weights once rather than in every Compute, and every time step for R.
+    // R[zr] and Rh are multiplied separately so they are packed separately.
+    const Tensor* weights;
+    if (info.TryGetConstantInput(1, &weights)) {
+      packed_W_.Pack(*weights, 0, 3 * int64_t{hidden_size_}, info.GetAllocator(0, OrtMemTypeDefault));
+    }
+    if (info.TryGetConstantInput(2, &weights)) {
+      packed_R_zr_.Pack(*weights, 0, 2 * int64_t{hidden_size_}, info.GetAllocator(0, OrtMemTypeDefault));
+      packed_R_h_.Pack(*weights, 2 * int64_t{hidden_size_}, hidden_size_, info.GetAllocator(0, OrtMemTypeDefault));
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -66,15 +77,10 @@ class DeepCpuGruOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
-  // Threadpool for operator. If concurrent Compute calls are possible, it will be shared
-  // across them. mutable due to this.
-  // The alternative would be to create a threadpool in each call to Compute but that would incur thread creation
-  // cost on every call.
-#ifdef USE_EIGEN_THREADPOOL
-  mutable Eigen::NonBlockingThreadPool ttp_{static_cast<int>(std::thread::hardware_concurrency())};
-#else
-  mutable TaskThreadPool ttp_{std::thread::hardware_concurrency()};
-#endif
+  // W, R[zr] and Rh in the MLAS SGEMM layout if they are constant
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_zr_;
+  rnn::detail::PackedWeights packed_R_h_;
 
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
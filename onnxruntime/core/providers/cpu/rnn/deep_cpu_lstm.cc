@@ -188,7 +188,7 @@ template <typename T>
 class UniDirectionalLstm {
  public:
   UniDirectionalLstm(AllocatorPtr allocator,
-                     const logging::Logger& logger,
+                     const OpKernelContext& context,
                      const int seq_length,
                      const int batch_size,
                      const int input_size,
@@ -202,18 +202,15 @@ class UniDirectionalLstm {
                      const ActivationFuncs::Entry& activation_func_f,
                      const ActivationFuncs::Entry& activation_func_g,
                      const ActivationFuncs::Entry& activation_func_h,
-                     const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                     Eigen::NonBlockingThreadPool& ttp);
-#else
-                     TaskThreadPool& ttp);
-#endif
+                     const float clip);
 
   void Compute(const gsl::span<const T>& inputs,
                const gsl::span<const int>& sequence_lengths,
                const int num_directions,
                const gsl::span<const T>& input_weights,
                const gsl::span<const T>& recurrent_weights,
+               const void* packed_input_weights,
+               const void* packed_recurrent_weights,
                gsl::span<T>& outputs,
                gsl::span<T>& final_hidden_state,
                gsl::span<T>& final_cell_state);
@@ -246,6 +243,7 @@ class UniDirectionalLstm {
   void LoadBias(const gsl::span<const T>& WbRb_values);
 
   AllocatorPtr allocator_;
+  const OpKernelContext& context_;
   const logging::Logger& logger_;
 
   int seq_length_;
@@ -276,12 +274,11 @@ class UniDirectionalLstm {
   gsl::span<T> internal_memory_cur_, batched_internal_memory_cur_;
   gsl::span<T> batched_internal_memory_clipped_;
 
-  IAllocatorUniquePtr<T> bias_WRi_ptr_, bias_WRf_ptr_, bias_WRo_ptr_, bias_WRc_ptr_;
-  IAllocatorUniquePtr<T> batched_bias_WRi_ptr_, batched_bias_WRf_ptr_, batched_bias_WRo_ptr_, batched_bias_WRc_ptr_;
+  // Wb[iofc] + Rb[iofc], which the GEMM of the inputs adds to every row
+  IAllocatorUniquePtr<T> bias_WR_ptr_;
   IAllocatorUniquePtr<T> peephole_i_ptr_, peephole_f_ptr_, peephole_o_ptr_;
   IAllocatorUniquePtr<T> inputs_reverse_ptr_, outputs_reverse_ptr_;
-  gsl::span<T> bias_WRi_, bias_WRf_, bias_WRo_, bias_WRc_;
-  gsl::span<T> batched_bias_WRi_, batched_bias_WRf_, batched_bias_WRo_, *batched_bias_WRc_;
+  gsl::span<T> bias_WR_;
   gsl::span<T> inputs_reverse_, outputs_reverse_;
 
 #if defined(LSTM_NO_PEEPHOLE_COPY)
@@ -293,17 +290,9 @@ class UniDirectionalLstm {
   IAllocatorUniquePtr<int> sequence_lengths_ptr_;
   gsl::span<int> sequence_lengths_;
 
-  deepcpu::ClipWithBiasFuncPtr clip_with_bias_ptr_;
-
   ActivationInfo<deepcpu::ActivationFuncPtr> activation_f_;
   ActivationInfo<deepcpu::ActivationFuncPtr> activation_g_;
   ActivationInfo<deepcpu::LstmMergeGatesFuncPtr> activation_h_;
-
-#ifdef USE_EIGEN_THREADPOOL
-  Eigen::NonBlockingThreadPool& ttp_;
-#else
-  TaskThreadPool& ttp_;
-#endif
 };
 
 }  // namespace detail
@@ -466,37 +455,43 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
     gsl::span<T> last_cell_2 = last_cell.subspan(last_cell_size_per_direction,
                                                  last_cell_size_per_direction);
 
-    fw = std::make_unique<detail::UniDirectionalLstm<T>>(alloc, logger,
+    fw = std::make_unique<detail::UniDirectionalLstm<T>>(alloc, context,
                                                          seq_length, batch_size, input_size,
                                                          hidden_size_, Direction::kForward, input_forget_,
                                                          bias_1, peephole_weights_1, initial_hidden_1, initial_cell_1,
                                                          activation_funcs_.Entries()[0],
                                                          activation_funcs_.Entries()[1],
                                                          activation_funcs_.Entries()[2],
-                                                         clip_, ttp_);
+                                                         clip_);
 
-    bw = std::make_unique<detail::UniDirectionalLstm<T>>(alloc, logger,
+    bw = std::make_unique<detail::UniDirectionalLstm<T>>(alloc, context,
                                                          seq_length, batch_size, input_size,
                                                          hidden_size_, Direction::kReverse, input_forget_,
                                                          bias_2, peephole_weights_2, initial_hidden_2, initial_cell_2,
                                                          activation_funcs_.Entries()[3],
                                                          activation_funcs_.Entries()[4],
                                                          activation_funcs_.Entries()[5],
-                                                         clip_, ttp_);
-
-    fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
-    bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2, output_2, hidden_output_2, last_cell_2);
+                                                         clip_);
+
+    ExecuteDirectionsInParallel(
+        context,
+        [&]() { fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+                            packed_W_.Direction(0), packed_R_.Direction(0), output_1, hidden_output_1, last_cell_1); },
+        [&]() { bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2,
+                            packed_W_.Direction(1), packed_R_.Direction(1), output_2, hidden_output_2, last_cell_2); },
+        logger);
   } else {
-    fw = std::make_unique<detail::UniDirectionalLstm<T>>(alloc, logger,
+    fw = std::make_unique<detail::UniDirectionalLstm<T>>(alloc, context,
                                                          seq_length, batch_size, input_size,
                                                          hidden_size_, direction_, input_forget_,
                                                          bias_1, peephole_weights_1, initial_hidden_1, initial_cell_1,
                                                          activation_funcs_.Entries()[0],
                                                          activation_funcs_.Entries()[1],
                                                          activation_funcs_.Entries()[2],
-                                                         clip_, ttp_);
+                                                         clip_);
 
-    fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
+    fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+                packed_W_.Direction(0), packed_R_.Direction(0), output_1, hidden_output_1, last_cell_1);
   }
 
   if (!output.empty())
@@ -551,7 +546,7 @@ namespace detail {
 
 template <typename T>
 UniDirectionalLstm<T>::UniDirectionalLstm(AllocatorPtr allocator,
-                                          const logging::Logger& logger,
+                                          const OpKernelContext& context,
                                           const int seq_length,
                                           const int batch_size,
                                           const int input_size,
@@ -565,14 +560,10 @@ UniDirectionalLstm<T>::UniDirectionalLstm(AllocatorPtr allocator,
                                           const ActivationFuncs::Entry& activation_func_f,
                                           const ActivationFuncs::Entry& activation_func_g,
                                           const ActivationFuncs::Entry& activation_func_h,
-                                          const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                                          Eigen::NonBlockingThreadPool& ttp)
-#else
-                                          TaskThreadPool& ttp)
-#endif
+                                          const float clip)
     : allocator_(allocator),
-      logger_(logger),
+      context_(context),
+      logger_(context.Logger()),
       seq_length_(seq_length),
       batch_size_(batch_size),
       input_size_(input_size),
@@ -581,8 +572,7 @@ UniDirectionalLstm<T>::UniDirectionalLstm(AllocatorPtr allocator,
       input_forget_(input_forget),
       clip_(clip),
       use_bias_(!bias.empty()),
-      use_peepholes_(!peephole_weights.empty()),
-      ttp_(ttp) {
+      use_peepholes_(!peephole_weights.empty()) {
   activation_f_ = {deepcpu::ActivationFuncByName(activation_func_f.name),
                    activation_func_f.alpha,
                    activation_func_f.beta};
@@ -595,8 +585,6 @@ UniDirectionalLstm<T>::UniDirectionalLstm(AllocatorPtr allocator,
                    activation_func_h.alpha,
                    activation_func_h.beta};
 
-  clip_with_bias_ptr_ = use_bias_ ? deepcpu::clip_add_bias : deepcpu::clip_ignore_bias;
-
   SetNumThreads();
   AllocateBuffers();
   InitializeBuffers(initial_hidden_state, initial_cell_state);
@@ -626,10 +614,7 @@ void UniDirectionalLstm<T>::AllocateBuffers() {
   output_iofc_ = Allocate(allocator_, hidden_size_ * 4 * batch_size_ * seq_length_, output_iofc_ptr_, fill);
 
   if (use_bias_) {
-    bias_WRi_ = Allocate(allocator_, hidden_size_, bias_WRi_ptr_);
-    bias_WRf_ = Allocate(allocator_, hidden_size_, bias_WRf_ptr_);
-    bias_WRo_ = Allocate(allocator_, hidden_size_, bias_WRo_ptr_);
-    bias_WRc_ = Allocate(allocator_, hidden_size_, bias_WRc_ptr_);
+    bias_WR_ = Allocate(allocator_, 4 * hidden_size_, bias_WR_ptr_);
   }
 
   if (direction_ == kReverse) {
@@ -697,23 +682,13 @@ void UniDirectionalLstm<T>::LoadPeepholeWeights(const gsl::span<const T>& peepho
 
 template <typename T>
 void UniDirectionalLstm<T>::LoadBias(const gsl::span<const T>& WbRb_values) {
-  // add Wb and Rb
-  auto copy_fused_bias = [this, &WbRb_values](int offset, gsl::span<T>& out) {
-    // gap between Wb and Wb value for an entry
-    const int Wb_to_Rb_offset = 4 * hidden_size_;
-
-    for (int j = 0; j < hidden_size_; ++j)
-      out[j] = WbRb_values[j + offset] + WbRb_values[j + offset + Wb_to_Rb_offset];
-  };
-
-  int i = 0;
-  copy_fused_bias((i++) * hidden_size_, bias_WRi_);
-  copy_fused_bias((i++) * hidden_size_, bias_WRo_);
-  copy_fused_bias((i++) * hidden_size_, bias_WRf_);
-  copy_fused_bias((i++) * hidden_size_, bias_WRc_);
+  // add Wb and Rb. both are in iofc order, the same as the columns of the output of the GEMMs.
+  const int Wb_to_Rb_offset = 4 * hidden_size_;
+  for (int j = 0; j < 4 * hidden_size_; ++j)
+    bias_WR_[j] = WbRb_values[j] + WbRb_values[j + Wb_to_Rb_offset];
 
   /*
-  i = 0;
+  int i = 0;
   DumpMatrix("Wb[i]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
   DumpMatrix("Wb[o]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
   DumpMatrix("Wb[f]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
@@ -723,10 +698,7 @@ void UniDirectionalLstm<T>::LoadBias(const gsl::span<const T>& WbRb_values) {
   DumpMatrix("Rb[f]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
   DumpMatrix("Rb[c]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
 
-  DumpMatrix("Wb[i]+Rb[i]", bias_WRi_.data(), 1, hidden_size_);
-  DumpMatrix("Wb[o]+Rb[o]", bias_WRo_.data(), 1, hidden_size_);
-  DumpMatrix("Wb[f]+Rb[f]", bias_WRf_.data(), 1, hidden_size_);
-  DumpMatrix("Wb[c]+Rb[c]", bias_WRc_.data(), 1, hidden_size_);
+  DumpMatrix("Wb[iofc]+Rb[iofc]", bias_WR_.data(), 1, 4 * hidden_size_);
   */
 }
 
@@ -736,6 +708,8 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                                     const int num_directions,
                                     const gsl::span<const T>& input_weights,
                                     const gsl::span<const T>& recurrent_weights,
+                                    const void* packed_input_weights,
+                                    const void* packed_recurrent_weights,
                                     gsl::span<T>& outputs,
                                     gsl::span<T>& final_hidden_state,
                                     gsl::span<T>& final_cell_state) {
@@ -791,6 +765,11 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
   const int hidden_size_x4 = 4 * hidden_size_;
   const int total_rows = max_sequence_length * batch_size_;
 
+  // add the bias of every gate to every row as the GEMM computes it. the peepholes and the clip are applied after,
+  // the same as when the bias is added to the sum of all of them.
+  MLAS_SGEMM_EPILOGUE bias_epilogue{};
+  bias_epilogue.ColumnBias = use_bias_ ? bias_WR_.data() : nullptr;
+
   // apply the weights to all the inputs and save to output_IOFC
   ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
@@ -798,9 +777,10 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
               input_weights.cbegin(), input_weights.cend(),  // W[iofc]
               input_size_, beta,
               output_iofc_.begin(), output_iofc_.end(),
-              hidden_size_x4);
+              hidden_size_x4,
+              packed_input_weights, use_bias_ ? &bias_epilogue : nullptr);
 
-  DumpMatrix("Xt*(W[iofc]^T)", output_iofc_.data(), total_rows, hidden_size_x4);
+  DumpMatrix("Xt*(W[iofc]^T) + Wb[iofc] + Rb[iofc]", output_iofc_.data(), total_rows, hidden_size_x4);
 
   beta = 1.0f;  // calls to ComputeGemm now add to existing data
 
@@ -847,7 +827,7 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                     recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
                     hidden_size_, beta,
                     step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                    hidden_size_x4);
+                    hidden_size_x4, packed_recurrent_weights);
 
         DumpMatrix("Xt*(W[iofc]^T) + Ht-t*R[iofc]" + row_str,
                    &*step_out_IOFC, local_fused_hidden_rows, hidden_size_x4);
@@ -893,7 +873,8 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       }
     };
 
-    ExecuteLambdaInParallel("Processing batch", hidden_gemm_and_activations, batch_size_, fused_hidden_rows, ttp_, logger_);
+    ExecuteLambdaInParallel(context_, "Processing batch", hidden_gemm_and_activations, batch_size_, fused_hidden_rows,
+                            logger_);
 
   } else {
     span_T_iter c_prev = batched_internal_state_prev_one_step.begin();
@@ -920,7 +901,7 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                   recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
                   hidden_size_, beta,
                   step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                  hidden_size_x4);
+                  hidden_size_x4, packed_recurrent_weights);
 
       span_T_iter batched_output, batched_output_end;
       if (output_sequence) {
@@ -1025,8 +1006,7 @@ void UniDirectionalLstm<T>::GateComputations(span_T_iter& out, span_T_iter& out_
                                    pi, hidden_size_);
     }
 
-    const float* pBi = use_bias_ ? SafeRawConstPointer<T>(bias_WRi_, 0, hidden_size_) : nullptr;
-    clip_with_bias_ptr_(clip_, pBi, pi, hidden_size_);  // post: pi has input to f() to calculate i
+    deepcpu::clip(clip_, pi, hidden_size_);  // post: pi has input to f() to calculate i
     activation_f_.func(pi, hidden_size_, activation_f_.alpha, activation_f_.beta);
     // DumpMatrix("i" + row_str, pi, 1, hidden_size_);
 
@@ -1040,16 +1020,14 @@ void UniDirectionalLstm<T>::GateComputations(span_T_iter& out, span_T_iter& out_
                                      pf, hidden_size_);
       }
 
-      const float* pBf = use_bias_ ? SafeRawConstPointer<T>(bias_WRf_, 0, hidden_size_) : nullptr;
-      clip_with_bias_ptr_(clip_, pBf, pf, hidden_size_);
+      deepcpu::clip(clip_, pf, hidden_size_);
       activation_f_.func(pf, hidden_size_, activation_f_.alpha, activation_f_.beta);
     }
 
     // DumpMatrix("f" + row_str, pf, 1, hidden_size_);
 
     // Block Gate
-    const float* pBc = use_bias_ ? SafeRawConstPointer<T>(bias_WRc_, 0, hidden_size_) : nullptr;
-    clip_with_bias_ptr_(clip_, pBc, pc, hidden_size_);
+    deepcpu::clip(clip_, pc, hidden_size_);
     activation_g_.func(pc, hidden_size_, activation_g_.alpha, activation_g_.beta);
 
     // DumpMatrix("c" + row_str, pc, 1, hidden_size_);
@@ -1070,8 +1048,7 @@ void UniDirectionalLstm<T>::GateComputations(span_T_iter& out, span_T_iter& out_
                                    po, hidden_size_);
 
     // calculate 'ot'
-    const float* pBo = use_bias_ ? SafeRawConstPointer<T>(bias_WRo_, 0, hidden_size_) : nullptr;
-    clip_with_bias_ptr_(clip_, pBo, po, hidden_size_);
+    deepcpu::clip(clip_, po, hidden_size_);
     activation_f_.func(po, hidden_size_, activation_f_.alpha, activation_f_.beta);
     // DumpMatrix("o" + row_str, po, 1, hidden_size_);
 
@@ -1107,10 +1084,8 @@ void UniDirectionalLstm<T>::GateComputations(span_T_iter& out, span_T_iter& out_
 
 template <typename T>
 void UniDirectionalLstm<T>::SetNumThreads() {
-  int threads = std::thread::hardware_concurrency() - 1;
-
-  if (threads < 1)
-    threads = 1;
+  // the threads of the intra-op thread pool and the calling thread
+  int threads = context_.NumParallelRanges();
 
   hidden_num_threads_ = threads;
   batch_parallel_ = false;
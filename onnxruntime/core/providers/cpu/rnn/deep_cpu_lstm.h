@@ -8,10 +8,6 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
 
-#ifndef USE_EIGEN_THREADPOOL
-#include "core/common/task_thread_pool.h"
-#endif
-
 namespace onnxruntime {
 
 /// The class represents DeepCPU implementation of a long short term memory (LSTM) operator.
@@ -52,6 +48,15 @@ class DeepCpuLstmOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    // pack constant weights once rather than in every Compute, and every time step for R
+    const Tensor* weights;
+    if (info.TryGetConstantInput(1, &weights)) {
+      packed_W_.Pack(*weights, 0, 4 * int64_t{hidden_size_}, info.GetAllocator(0, OrtMemTypeDefault));
+    }
+    if (info.TryGetConstantInput(2, &weights)) {
+      packed_R_.Pack(*weights, 0, 4 * int64_t{hidden_size_}, info.GetAllocator(0, OrtMemTypeDefault));
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -81,16 +86,9 @@ class DeepCpuLstmOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
-  // Threadpool for operator. If concurrent Compute calls are possible, it will be shared
-  // across them. mutable due to this.
-  // The alternative would be to create a threadpool in each call to Compute but that would incur thread creation
-  // cost on every call.
-
-#ifdef USE_EIGEN_THREADPOOL
-  mutable Eigen::NonBlockingThreadPool ttp_{static_cast<int>(std::thread::hardware_concurrency())};
-#else
-  mutable TaskThreadPool ttp_{std::thread::hardware_concurrency()};
-#endif
+  // W and R in the MLAS SGEMM layout if they are constant
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_;
 };
 
 }  // namespace onnxruntime
@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include <cstring>
+#include <exception>
 #include <iomanip>
 #include <iostream>
 #include <stdlib.h>
@@ -13,6 +14,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/rnn/rnn_activation_functors.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
@@ -23,6 +25,59 @@ namespace detail {
 
 using namespace ::onnxruntime::common;
 
+void RunOnIntraOpThreadPool(const OpKernelContext& context, const std::string& name, int num_tasks,
+                            const std::function<void(int)>& fn, const ::onnxruntime::logging::Logger& logger) {
+  try {
+    context.ParallelFor(num_tasks, 1, [&fn](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        fn(static_cast<int>(i));
+      }
+    });
+  } catch (const std::exception& ex) {
+    LOGS(logger, ERROR) << name << " - exception running tasks: " << ex.what();
+    throw;
+  }
+}
+
+void PackedWeights::Pack(const Tensor& weights, int64_t row_begin, int64_t num_rows, const AllocatorPtr& alloc) {
+  const TensorShape& shape = weights.Shape();
+  if (alloc == nullptr ||
+      weights.DataType() != DataTypeImpl::GetType<float>() ||
+      strcmp(weights.Location().name, CPU) != 0 ||
+      shape.NumDimensions() != 3 ||
+      row_begin < 0 || num_rows <= 0 || row_begin + num_rows > shape[1] || shape[2] <= 0) {
+    return;
+  }
+
+  const size_t num_directions = static_cast<size_t>(shape[0]);
+  const size_t N = static_cast<size_t>(num_rows);
+  const size_t K = static_cast<size_t>(shape[2]);
+
+  // every direction starts on the 64 byte boundary MLAS requires of a packed buffer
+  size_per_direction_ = (MlasSgemmPackBSize(N, K) + 63) & ~size_t{63};
+  void* buffer = alloc->Alloc(size_per_direction_ * num_directions);
+  buffer_ = BufferUniquePtr(buffer, BufferDeleter(alloc));
+
+  const float* data = weights.Data<float>();
+  for (size_t direction = 0; direction < num_directions; ++direction) {
+    const float* B = data + (direction * static_cast<size_t>(shape[1]) + static_cast<size_t>(row_begin)) * K;
+    MlasSgemmPackB(CblasTrans, N, K, B, K, static_cast<char*>(buffer) + direction * size_per_direction_);
+  }
+}
+
+void ExecuteDirectionsInParallel(const OpKernelContext& context, const std::function<void()>& forward,
+                                 const std::function<void()>& reverse, const ::onnxruntime::logging::Logger& logger) {
+#ifdef USE_MKLDNN
+  ORT_UNUSED_PARAMETER(context);
+  ORT_UNUSED_PARAMETER(logger);
+  forward();
+  reverse();
+#else
+  RunOnIntraOpThreadPool(
+      context, "Processing directions", 2, [&](int i) { i == 0 ? forward() : reverse(); }, logger);
+#endif
+}
+
 Status ValidateCommonRnnInputs(const Tensor& X,
                                const Tensor& W,
                                const Tensor& R,
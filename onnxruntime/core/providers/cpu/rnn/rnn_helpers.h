@@ -19,15 +19,11 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
-#ifdef USE_EIGEN_THREADPOOL
-#include <unsupported/Eigen/CXX11/ThreadPool>
-#else
-#include "core/common/task_thread_pool.h"
-#endif
-
 namespace onnxruntime {
 class Tensor;
 class OpKernelContext;
@@ -148,8 +144,31 @@ void ReverseSequence(gsl::span<const T> inputs,
   }
 }
 
+/**
+  * The weights of every direction of an RNN, or a range of their rows, packed into the MLAS SGEMM layout when the
+  * kernel is created, so that the GEMMs of every Compute, and of every time step for the recurrent weights, don't
+  * repack constant weights. The weights have shape [num_directions, rows, K] and are multiplied transposed.
+  */
+class PackedWeights {
+ public:
+  // Pack the rows [row_begin, row_begin + num_rows) of every direction of weights.
+  // Nothing is packed if weights isn't a float tensor of that shape on the CPU.
+  void Pack(const Tensor& weights, int64_t row_begin, int64_t num_rows, const AllocatorPtr& alloc);
+
+  // the packed weights of a direction, or nullptr if the weights weren't packed
+  const void* Direction(int direction) const {
+    return buffer_ == nullptr ? nullptr : static_cast<const char*>(buffer_.get()) + direction * size_per_direction_;
+  }
+
+ private:
+  BufferUniquePtr buffer_;
+  size_t size_per_direction_ = 0;
+};
+
 // A has size M x K, B has size N x K (transposed), and C has size M x N
 // We check that A, B and C are large enough before calling the lower level GEMM implementation
+// packed_B is B packed by PackedWeights, which is multiplied in place of B if it's set.
+// The epilogue, such as a bias to add to every row, is applied to C as the blocks of C are computed.
 template <typename TSpanAIter, typename TSpanBIter, typename TSpanCIter>
 void ComputeGemm(const int M,
                  const int N,
@@ -164,7 +183,9 @@ void ComputeGemm(const int M,
                  const float beta,
                  TSpanCIter C,
                  TSpanCIter C_end,
-                 const int ldc) {
+                 const int ldc,
+                 const void* packed_B = nullptr,
+                 const MLAS_SGEMM_EPILOGUE* epilogue = nullptr) {
   // validate all the inputs
   // need to use the lda/ldb/ldc strides which should be >= the columns for the span
   ORT_ENFORCE(lda >= K && ldb >= K && ldc >= N);
@@ -172,12 +193,18 @@ void ComputeGemm(const int M,
   ORT_ENFORCE(B + (N * ldb - (ldb - K)) <= B_end);
   ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
 
-  ::onnxruntime::math::GemmEx<float, CPUMathUtil>(
-      CblasNoTrans, CblasTrans,
-      M, N, K, alpha,
-      &*A, lda,
-      &*B, ldb, beta,
-      &*C, ldc, &CPUMathUtil::Instance());
+  if (packed_B != nullptr) {
+    MlasSgemmPacked(CblasNoTrans, M, N, K, alpha, &*A, lda, packed_B, beta, &*C, ldc, epilogue);
+  } else if (epilogue != nullptr) {
+    MlasSgemm(CblasNoTrans, CblasTrans, M, N, K, alpha, &*A, lda, &*B, ldb, beta, &*C, ldc, epilogue);
+  } else {
+    ::onnxruntime::math::GemmEx<float, CPUMathUtil>(
+        CblasNoTrans, CblasTrans,
+        M, N, K, alpha,
+        &*A, lda,
+        &*B, ldb, beta,
+        &*C, ldc, &CPUMathUtil::Instance());
+  }
 }
 
 // helper to convert a span to a raw pointer
@@ -216,18 +243,23 @@ T* SafeRawPointer(typename gsl::span<T> span, size_t offset, size_t size) {
   return span.data() + offset;
 }
 
+// Run fn(i) for every i in [0, num_tasks) in the ranges of context.ParallelFor.
+// An exception thrown by a task is logged and rethrown once all tasks have completed.
+void RunOnIntraOpThreadPool(const OpKernelContext& context, const std::string& name, int num_tasks,
+                            const std::function<void(int)>& fn, const ::onnxruntime::logging::Logger& logger);
+
+// Run the forward and the reverse pass of a bidirectional RNN, at the same time if the intra-op thread pool has a
+// thread free as the passes are independent. With MKL-DNN they run one after the other.
+void ExecuteDirectionsInParallel(const OpKernelContext& context, const std::function<void()>& forward,
+                                 const std::function<void()>& reverse, const ::onnxruntime::logging::Logger& logger);
+
 template <typename TLambda>
-void ExecuteLambdaInParallel(const std::string& name, TLambda lambda, int max, int step,
-#ifdef USE_EIGEN_THREADPOOL
-                             Eigen::NonBlockingThreadPool& ttp,
-#else
-                             TaskThreadPool& ttp,
-#endif
+void ExecuteLambdaInParallel(const OpKernelContext& context, const std::string& name, TLambda lambda, int max, int step,
                              const ::onnxruntime::logging::Logger& logger) {
   // #define NOTHREADS to execute the lambdas directly and in order if you need to do that to debug
 
 #ifdef NOTHREADS
-  ORT_UNUSED_PARAMETER(ttp);
+  ORT_UNUSED_PARAMETER(context);
   ORT_UNUSED_PARAMETER(logger);
 
   for (int i = 0; i < max; i += step) {
@@ -235,40 +267,12 @@ void ExecuteLambdaInParallel(const std::string& name, TLambda lambda, int max, i
     std::bind(lambda, i)();
   }
 #else
-
-#ifdef USE_EIGEN_THREADPOOL
-  ORT_UNUSED_PARAMETER(name);
-  ORT_UNUSED_PARAMETER(logger);
-
-  std::atomic<int> done(0);
-  for (int i = 0; i < max; i += step) {
-    ttp.Schedule([lambda, i, &done]() {
-      lambda(i);
-      ++done;
-    });
-  }
-
-  int totalTasks = (int)max / (step > 0 ? step : 1) + (max % step > 0 ? 1 : 0);
-  while (done != totalTasks) {
-  }
-#else
-  std::vector<std::future<void> > task_results{};
-  task_results.reserve(static_cast<size_t>(std::ceil(max / step)));
-
-  for (int i = 0; i < max; i += step) {
-    std::packaged_task<void()> task{std::bind(lambda, i)};
-    task_results.emplace_back(task.get_future());
-    ttp.RunTask(std::move(task));
-  }
-  try {
-    // wait for all and propagate any exceptions
-    for (auto& future : task_results)
-      future.get();
-  } catch (const std::exception& ex) {
-    LOGS(logger, ERROR) << name << " - exception running tasks: " << ex.what();
-    throw;
+  if (max <= 0) {
+    return;
   }
-#endif  // else part of #ifdef USE_EIGEN_THREADPOOLs
+  step = std::max(step, 1);
+  RunOnIntraOpThreadPool(
+      context, name, (max + step - 1) / step, [&lambda, step](int i) { lambda(i * step); }, logger);
 #endif  // else part of #ifdef NOTHREADS
 }
 
@@ -2,7 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/cast_op.h"
-#include <sstream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
 #include "core/common/common.h"
 
 using namespace ONNX_NAMESPACE;
@@ -20,73 +23,198 @@ const std::vector<MLDataType> castOpTypeConstraints{
     DataTypeImpl::GetTensorType<int16_t>(),
     DataTypeImpl::GetTensorType<int32_t>(),
     DataTypeImpl::GetTensorType<int64_t>(),
-    DataTypeImpl::GetTensorType<MLFloat16>()};
-
-#define ADD_FROM_CAST_OP(in_type)                                                                                                  \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                                                                  \
-      Cast,                                                                                                                        \
-      6,                                                                                                                           \
-      in_type,                                                                                                                     \
-      KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>()).TypeConstraint("T2", castOpTypeConstraints), \
-      Cast<in_type>);                                                                                                              \
-                                                                                                                                   \
-  template <>                                                                                                                      \
-  Status Cast<in_type>::Compute(OpKernelContext* context) const {                                                                  \
-    const Tensor* X = context->Input<Tensor>(0);                                                                                   \
-    if (X == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");                                    \
-    const TensorShape& shape = X->Shape();                                                                                         \
-    Tensor* Y = context->Output(0, TensorShape(shape));                                                                            \
-                                                                                                                                   \
-    switch (to_) {                                                                                                                 \
-      case TensorProto_DataType_BOOL:                                                                                              \
-        CastData<in_type, bool>(X, Y, shape);                                                                                      \
-        break;                                                                                                                     \
-      case TensorProto_DataType_INT16:                                                                                             \
-        CastData<in_type, int16_t>(X, Y, shape);                                                                                   \
-        break;                                                                                                                     \
-      case TensorProto_DataType_INT32:                                                                                             \
-        CastData<in_type, int32_t>(X, Y, shape);                                                                                   \
-        break;                                                                                                                     \
-      case TensorProto_DataType_INT64:                                                                                             \
-        CastData<in_type, int64_t>(X, Y, shape);                                                                                   \
-        break;                                                                                                                     \
-      case TensorProto_DataType_UINT8:                                                                                             \
-        CastData<in_type, uint8_t>(X, Y, shape);                                                                                   \
-        break;                                                                                                                     \
-      case TensorProto_DataType_UINT16:                                                                                            \
-        CastData<in_type, uint16_t>(X, Y, shape);                                                                                  \
-        break;                                                                                                                     \
-      case TensorProto_DataType_UINT32:                                                                                            \
-        CastData<in_type, uint32_t>(X, Y, shape);                                                                                  \
-        break;                                                                                                                     \
-      case TensorProto_DataType_UINT64:                                                                                            \
-        CastData<in_type, uint64_t>(X, Y, shape);                                                                                  \
-        break;                                                                                                                     \
-      case TensorProto_DataType_FLOAT:                                                                                             \
-        CastData<in_type, float>(X, Y, shape);                                                                                     \
-        break;                                                                                                                     \
-      case TensorProto_DataType_DOUBLE:                                                                                            \
-        CastData<in_type, double>(X, Y, shape);                                                                                    \
-        break;                                                                                                                     \
-      case TensorProto_DataType_INT8:                                                                                              \
-        CastData<in_type, int8_t>(X, Y, shape);                                                                                    \
-        break;                                                                                                                     \
-      case TensorProto_DataType_FLOAT16:                                                                                           \
-        if (std::is_same<in_type, float>::value) {                                                                                 \
-          CastData<float, MLFloat16>(X, Y, shape);                                                                                 \
-        } else {                                                                                                                   \
-          auto st = CastFloat16Data<in_type, MLFloat16>(X, Y, shape, context);                                                     \
-          if (!st.IsOK()) return st;                                                                                               \
-        }                                                                                                                          \
-        break;                                                                                                                     \
-      case TensorProto_DataType_STRING:                                                                                            \
-        ORT_THROW("Casting to and from strings is not supported yet."); /*break;*/                                         \
-      case TensorProto_DataType_UNDEFINED:                                                                                         \
-        ORT_THROW("Cast op must have 'to' argument of type DataType"); /*break;*/                                          \
-      default:                                                                                                                     \
-        ORT_THROW("Unexpected 'to' argument value: ", to_);                                                                \
-    }                                                                                                                              \
-    return Status::OK();                                                                                                           \
+    DataTypeImpl::GetTensorType<MLFloat16>(),
+    DataTypeImpl::GetTensorType<std::string>()};
+
+namespace {
+
+// formats the numbers with enough digits that parsing the strings gives back the same values
+template <typename T>
+std::string FloatToString(T value) {
+  if (std::isnan(value)) return "NaN";
+  if (std::isinf(value)) return value < 0 ? "-INF" : "INF";
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*g", std::numeric_limits<T>::max_digits10, static_cast<double>(value));
+  return buffer;
+}
+
+template <typename SrcType>
+std::string NumberToString(SrcType value) {
+  return std::to_string(value);
+}
+
+template <>
+std::string NumberToString<bool>(bool value) {
+  return value ? "1" : "0";
+}
+
+template <>
+std::string NumberToString<float>(float value) {
+  return FloatToString(value);
+}
+
+template <>
+std::string NumberToString<double>(double value) {
+  return FloatToString(value);
+}
+
+template <>
+std::string NumberToString<MLFloat16>(MLFloat16 value) {
+  float float_value;
+  MlasConvertHalfToFloatBuffer(&value.val, &float_value, 1);
+  return FloatToString(float_value);
+}
+
+template <typename SrcType>
+void CastToString(const OpKernelContext* context, const Tensor* in, Tensor* out, const TensorShape& shape) {
+  const SrcType* in_data = in->template Data<SrcType>();
+  std::string* out_data = out->template MutableData<std::string>();
+  context->ParallelFor(shape.Size(), kCastChunkSize, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      out_data[i] = NumberToString(in_data[i]);
+    }
+  });
+}
+
+// parses the number at the start of the string, and returns false if there's none. the integers are parsed as the
+// widest integer of their signedness and then narrowed, as static_cast does.
+template <typename DstType>
+bool ParseNumber(const char* str, DstType& value) {
+  char* end;
+  if (std::is_signed<DstType>::value) {
+    value = static_cast<DstType>(std::strtoll(str, &end, 10));
+  } else {
+    value = static_cast<DstType>(std::strtoull(str, &end, 10));
+  }
+  return end != str;
+}
+
+template <>
+bool ParseNumber<float>(const char* str, float& value) {
+  char* end;
+  value = std::strtof(str, &end);
+  return end != str;
+}
+
+template <>
+bool ParseNumber<double>(const char* str, double& value) {
+  char* end;
+  value = std::strtod(str, &end);
+  return end != str;
+}
+
+template <>
+bool ParseNumber<bool>(const char* str, bool& value) {
+  double number;
+  const bool parsed = ParseNumber(str, number);
+  value = number != 0;
+  return parsed;
+}
+
+template <>
+bool ParseNumber<MLFloat16>(const char* str, MLFloat16& value) {
+  float number;
+  const bool parsed = ParseNumber(str, number);
+  MlasConvertFloatToHalfBuffer(&number, &value.val, 1);
+  return parsed;
+}
+
+// the chunks are parsed in parallel, each recording the index of its first string that isn't a number
+template <typename DstType>
+Status CastFromString(const OpKernelContext* context, const Tensor* in, Tensor* out, const TensorShape& shape) {
+  const int64_t shape_size = shape.Size();
+  const std::string* in_data = in->template Data<std::string>();
+  DstType* out_data = out->template MutableData<DstType>();
+  const int64_t chunk_count = (shape_size + kCastChunkSize - 1) / kCastChunkSize;
+  std::vector<int64_t> failed_indices(static_cast<size_t>(chunk_count), -1);
+  context->ParallelFor(chunk_count, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; ++chunk) {
+      const int64_t chunk_end = std::min(shape_size, (chunk + 1) * kCastChunkSize);
+      for (int64_t i = chunk * kCastChunkSize; i < chunk_end; ++i) {
+        if (!ParseNumber(in_data[i].c_str(), out_data[i]) && failed_indices[chunk] < 0) {
+          failed_indices[chunk] = i;
+        }
+      }
+    }
+  });
+
+  for (int64_t failed_index : failed_indices) {
+    if (failed_index >= 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Cast: the string '", in_data[failed_index],
+                             "' is not a number.");
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+#define ADD_FROM_CAST_OP(in_type)                                                                                                                   \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                                                                                   \
+      Cast,                                                                                                                                         \
+      6,                                                                                                                                            \
+      in_type,                                                                                                                                      \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>()).TypeConstraint("T2", castOpTypeConstraints), \
+      Cast<in_type>);                                                                                                                               \
+                                                                                                                                                    \
+  template <>                                                                                                                                       \
+  Status Cast<in_type>::Compute(OpKernelContext* context) const {                                                                                   \
+    const Tensor* X = context->Input<Tensor>(0);                                                                                                    \
+    if (X == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");                                                     \
+    const TensorShape& shape = X->Shape();                                                                                                          \
+    Tensor* Y = context->Output(0, TensorShape(shape));                                                                                             \
+                                                                                                                                                    \
+    switch (to_) {                                                                                                                                  \
+      case TensorProto_DataType_BOOL:                                                                                                               \
+        CastData<in_type, bool>(context, X, Y, shape);                                                                                              \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_INT16:                                                                                                              \
+        CastData<in_type, int16_t>(context, X, Y, shape);                                                                                           \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_INT32:                                                                                                              \
+        CastData<in_type, int32_t>(context, X, Y, shape);                                                                                           \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_INT64:                                                                                                              \
+        CastData<in_type, int64_t>(context, X, Y, shape);                                                                                           \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_UINT8:                                                                                                              \
+        CastData<in_type, uint8_t>(context, X, Y, shape);                                                                                           \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_UINT16:                                                                                                             \
+        CastData<in_type, uint16_t>(context, X, Y, shape);                                                                                          \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_UINT32:                                                                                                             \
+        CastData<in_type, uint32_t>(context, X, Y, shape);                                                                                          \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_UINT64:                                                                                                             \
+        CastData<in_type, uint64_t>(context, X, Y, shape);                                                                                          \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_FLOAT:                                                                                                              \
+        CastData<in_type, float>(context, X, Y, shape);                                                                                             \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_DOUBLE:                                                                                                             \
+        CastData<in_type, double>(context, X, Y, shape);                                                                                            \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_INT8:                                                                                                               \
+        CastData<in_type, int8_t>(context, X, Y, shape);                                                                                            \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_FLOAT16:                                                                                                            \
+        if (std::is_same<in_type, float>::value) {                                                                                                  \
+          CastData<float, MLFloat16>(context, X, Y, shape);                                                                                         \
+        } else {                                                                                                                                    \
+          auto st = CastFloat16Data<in_type, MLFloat16>(X, Y, shape, context);                                                                      \
+          if (!st.IsOK()) return st;                                                                                                                \
+        }                                                                                                                                           \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_STRING:                                                                                                             \
+        CastToString<in_type>(context, X, Y, shape);                                                                                                \
+        break;                                                                                                                                      \
+      case TensorProto_DataType_UNDEFINED:                                                                                                          \
+        ORT_THROW("Cast op must have 'to' argument of type DataType"); /*break;*/                                                                   \
+      default:                                                                                                                                      \
+        ORT_THROW("Unexpected 'to' argument value: ", to_);                                                                                         \
+    }                                                                                                                                               \
+    return Status::OK();                                                                                                                            \
   }
 
 ADD_FROM_CAST_OP(uint8_t);
@@ -105,7 +233,7 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Cast,
     6,
     MLFloat16,
-    KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<MLFloat16>()).TypeConstraint("T2", castOpTypeConstraints),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T1", DataTypeImpl::GetTensorType<MLFloat16>()).TypeConstraint("T2", castOpTypeConstraints),
     Cast<MLFloat16>);
 
 template <>
@@ -141,7 +269,7 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
       st = CastFloat16Data<MLFloat16, uint64_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_FLOAT:
-      CastData<MLFloat16, float>(X, Y, shape);
+      CastData<MLFloat16, float>(context, X, Y, shape);
       break;
     case TensorProto_DataType_FLOAT16: {
         auto X_type = X->DataType();
@@ -161,7 +289,8 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
       st = CastFloat16Data<MLFloat16, int8_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_STRING:
-      ORT_THROW("Casting to and from strings is not supported yet."); /*break;*/
+      CastToString<MLFloat16>(context, X, Y, shape);
+      break;
     case TensorProto_DataType_UNDEFINED:
       ORT_THROW("Cast op must have 'to' argument of type DataType"); /*break;*/
     default:
@@ -170,4 +299,54 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
   return st;
 }
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Cast,
+    6,
+    string,
+    KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<std::string>()).TypeConstraint("T2", castOpTypeConstraints),
+    Cast<std::string>);
+
+template <>
+Status Cast<std::string>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  if (X == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
+  const TensorShape& shape = X->Shape();
+  Tensor* Y = context->Output(0, TensorShape(shape));
+  switch (to_) {
+    case TensorProto_DataType_BOOL:
+      return CastFromString<bool>(context, X, Y, shape);
+    case TensorProto_DataType_INT16:
+      return CastFromString<int16_t>(context, X, Y, shape);
+    case TensorProto_DataType_INT32:
+      return CastFromString<int32_t>(context, X, Y, shape);
+    case TensorProto_DataType_INT64:
+      return CastFromString<int64_t>(context, X, Y, shape);
+    case TensorProto_DataType_UINT8:
+      return CastFromString<uint8_t>(context, X, Y, shape);
+    case TensorProto_DataType_UINT16:
+      return CastFromString<uint16_t>(context, X, Y, shape);
+    case TensorProto_DataType_UINT32:
+      return CastFromString<uint32_t>(context, X, Y, shape);
+    case TensorProto_DataType_UINT64:
+      return CastFromString<uint64_t>(context, X, Y, shape);
+    case TensorProto_DataType_FLOAT:
+      return CastFromString<float>(context, X, Y, shape);
+    case TensorProto_DataType_DOUBLE:
+      return CastFromString<double>(context, X, Y, shape);
+    case TensorProto_DataType_INT8:
+      return CastFromString<int8_t>(context, X, Y, shape);
+    case TensorProto_DataType_FLOAT16:
+      return CastFromString<MLFloat16>(context, X, Y, shape);
+    case TensorProto_DataType_STRING: {
+      const std::string* in_data = X->template Data<std::string>();
+      std::copy(in_data, in_data + shape.Size(), Y->template MutableData<std::string>());
+      return Status::OK();
+    }
+    case TensorProto_DataType_UNDEFINED:
+      ORT_THROW("Cast op must have 'to' argument of type DataType"); /*break;*/
+    default:
+      ORT_THROW("Unexpected 'to' argument value: ", to_);
+  }
+}
+
 }  //namespace onnxruntime
@@ -8,61 +8,75 @@
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "Eigen/src/Core/arch/CUDA/Half.h"
-
-#if defined(USE_MLAS) && defined(_M_AMD64)
 #include "core/mlas/inc/mlas.h"
-#endif
+
+#include <algorithm>
 
 namespace onnxruntime {
 
+// the number of elements that a thread casts at a time, which for a cast from or to half-precision is the span of
+// the float buffer that's converted while it's in the cache
+constexpr int64_t kCastChunkSize = 16 * 1024;
+
 template <typename SrcType,
           typename DstType>
-inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<SrcType>(in->template Data<SrcType>(), shape_size);
-  auto output_vector = EigenVectorMap<DstType>(out->template MutableData<DstType>(), shape_size);
+inline void CastSpan(const SrcType* in, DstType* out, int64_t count) {
+  auto in_vector = ConstEigenVectorMap<SrcType>(in, count);
+  auto output_vector = EigenVectorMap<DstType>(out, count);
   output_vector = in_vector.template cast<DstType>();
 }
 
 template <>
-inline void CastData<float, MLFloat16>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<MLFloat16>();
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<float>(in->template Data<float>(), shape_size);
-  auto output_vector = EigenVectorMap<Eigen::half>(static_cast<Eigen::half*>(static_cast<void*>(out_data)), shape_size);
-  output_vector = in_vector.template cast<Eigen::half>();
+inline void CastSpan<float, MLFloat16>(const float* in, MLFloat16* out, int64_t count) {
+  MlasConvertFloatToHalfBuffer(in, &out[0].val, static_cast<size_t>(count));
 }
 
 template <>
-inline void CastData<MLFloat16, float>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<float>();
-  auto in_data = in->template Data<MLFloat16>();
-  auto shape_size = shape.Size();
-#if defined(USE_MLAS) && defined(_M_AMD64)
-  MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
-#else
-  auto in_vector = ConstEigenVectorMap<Eigen::half>(static_cast<const Eigen::half*>(static_cast<const void*>(in_data)), shape_size);
-  auto output_vector = EigenVectorMap<float>(out_data, shape_size);
-  output_vector = in_vector.template cast<float>();
-#endif
+inline void CastSpan<MLFloat16, float>(const MLFloat16* in, float* out, int64_t count) {
+  MlasConvertHalfToFloatBuffer(&in[0].val, out, static_cast<size_t>(count));
 }
 
+// casts the chunks of the tensor in parallel on the intra-op pool of context
 template <typename SrcType,
           typename DstType>
-inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, const AllocatorPtr& allocator) {
+inline void CastData(const OpKernelContext* context, const Tensor* in, Tensor* out, const TensorShape& shape) {
+  const int64_t shape_size = shape.Size();
+  const SrcType* in_data = in->template Data<SrcType>();
+  DstType* out_data = out->template MutableData<DstType>();
+  const int64_t chunk_count = (shape_size + kCastChunkSize - 1) / kCastChunkSize;
+  context->ParallelFor(chunk_count, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; ++chunk) {
+      const int64_t offset = chunk * kCastChunkSize;
+      CastSpan(in_data + offset, out_data + offset, std::min(kCastChunkSize, shape_size - offset));
+    }
+  });
+}
+
+// casts from or to half-precision through float, a chunk at a time so that the float buffer of a chunk is still in
+// the cache when it's cast again
+template <typename SrcType,
+          typename DstType>
+inline void CastFloat16Data(const OpKernelContext* context, const Tensor* in, Tensor* out, const TensorShape& shape,
+                            const AllocatorPtr& allocator) {
   ORT_ENFORCE(allocator != nullptr);
   const int64_t len = shape.Size();
-  ORT_ENFORCE(len > 0);
+  if (len == 0) {
+    return;
+  }
   void* buffer = allocator->AllocArray(sizeof(float), len);
   ORT_ENFORCE(buffer);
-  Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, buffer, allocator->Info(), nullptr);
-  if (std::is_same<SrcType, MLFloat16>::value) {
-    CastData<MLFloat16, float>(in, &tmp_tensor, shape);  // first cast to float
-    CastData<float, DstType>(&tmp_tensor, out, shape);   // then cast to the destination type.
-  } else if (std::is_same<DstType, MLFloat16>::value) {
-    CastData<SrcType, float>(in, &tmp_tensor, shape);
-    CastData<float, MLFloat16>(&tmp_tensor, out, shape);
-  }
+  float* float_data = static_cast<float*>(buffer);
+  const SrcType* in_data = in->template Data<SrcType>();
+  DstType* out_data = out->template MutableData<DstType>();
+  const int64_t chunk_count = (len + kCastChunkSize - 1) / kCastChunkSize;
+  context->ParallelFor(chunk_count, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; ++chunk) {
+      const int64_t offset = chunk * kCastChunkSize;
+      const int64_t count = std::min(kCastChunkSize, len - offset);
+      CastSpan(in_data + offset, float_data + offset, count);
+      CastSpan(float_data + offset, out_data + offset, count);
+    }
+  });
   allocator->Free(buffer);
 }
 
@@ -81,8 +95,8 @@ class Cast final : public OpKernel {
  private:
   template <typename SrcType,
             typename DstType>
-  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) const {
-    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape);
+  void CastData(const OpKernelContext* context, const Tensor* in, Tensor* out, const TensorShape& shape) const {
+    ::onnxruntime::CastData<SrcType, DstType>(context, in, out, shape);
   }
 
   template <typename SrcType,
@@ -90,7 +104,7 @@ class Cast final : public OpKernel {
   Status CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, OpKernelContext* context) const {
     AllocatorPtr allocator;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
-    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, allocator);
+    ::onnxruntime::CastFloat16Data<SrcType, DstType>(context, in, out, shape, allocator);
     return Status::OK();
   }
 
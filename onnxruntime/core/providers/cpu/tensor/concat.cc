@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/concat.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
 
@@ -93,16 +94,15 @@ Status Concat::Compute(OpKernelContext* ctx) const {
 
     // Copy the data across. For every 'input_axis_pitch' values copied, we move over by the 'output_axis_pitch'
     uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
-    for (int idxCopy = 0; idxCopy < input_size / input_axis_pitch; ++idxCopy) {
-      if (is_string_type) {
-        for (int idxItem = 0; idxItem < input_axis_pitch; ++idxItem)
-          reinterpret_cast<std::string*>(output)[output_offset + idxCopy * p.output_axis_pitch + idxItem] =
-              reinterpret_cast<const std::string*>(input)[idxCopy * input_axis_pitch + idxItem];
-      } else
-        memcpy(
-            output + (output_offset + idxCopy * p.output_axis_pitch) * element_bytes,
-            input + idxCopy * input_axis_pitch * element_bytes,
-            input_axis_pitch * element_bytes);
+    const int64_t copy_count = input_axis_pitch > 0 ? input_size / input_axis_pitch : 0;
+    if (is_string_type) {
+      ParallelCopyBlocks(ctx, reinterpret_cast<std::string*>(output) + output_offset, p.output_axis_pitch,
+                         reinterpret_cast<const std::string*>(input), input_axis_pitch,
+                         input_axis_pitch, copy_count);
+    } else {
+      ParallelCopyBlocks(ctx, output + output_offset * element_bytes, p.output_axis_pitch * element_bytes,
+                         input, input_axis_pitch * element_bytes,
+                         input_axis_pitch * element_bytes, copy_count);
     }
     output_offset += input_axis_pitch;
   }
@@ -8,12 +8,12 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
   MeanVarianceNormalization,
   1,
   8,
-  KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+  KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
   MeanVarianceNormalization_0<float>);
 
 ONNX_CPU_OPERATOR_KERNEL(
   MeanVarianceNormalization,
   9,
-  KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+  KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
   MeanVarianceNormalization_1<float>);
 }
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/reduction/reduction_ops.h"
 #include "core/util/math_cpuonly.h"
 
 #include "gsl/gsl_util"
@@ -46,14 +47,22 @@ class MeanVarianceNormalization_0 : public OpKernel {
     var.setZero();
 
     ConstEigenArrayMap<T> X_arr(Xdata, sample_size, N * C);
-    for (int nc = 0; nc < N * C; ++nc) {
-      mean(nc % C) += X_arr.col(nc).sum();
-    }
-    mean /= gsl::narrow_cast<T>(N * sample_size);
-    for (int64_t nc = 0; nc < N * C; ++nc) {
-      var(nc % C) += (X_arr.col(nc) - mean(nc % C)).matrix().squaredNorm();
+    if (N == 1 && sample_size > 0) {
+      // each channel is a contiguous slice
+      ReduceView view;
+      view.outer = C;
+      view.reduced = sample_size;
+      ComputeMeanAndVariance(context, Xdata, view, mean.data(), var.data());
+    } else {
+      for (int nc = 0; nc < N * C; ++nc) {
+        mean(nc % C) += X_arr.col(nc).sum();
+      }
+      mean /= gsl::narrow_cast<T>(N * sample_size);
+      for (int64_t nc = 0; nc < N * C; ++nc) {
+        var(nc % C) += (X_arr.col(nc) - mean(nc % C)).matrix().squaredNorm();
+      }
+      var /= gsl::narrow_cast<T>(N * sample_size);
     }
-    var /= gsl::narrow_cast<T>(N * sample_size);
 
     Eigen::Array<T, Eigen::Dynamic, 1> inv_std;
     EigenArrayMap<T> Y_arr(Ydata, sample_size, N * C);
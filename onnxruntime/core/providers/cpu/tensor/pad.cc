@@ -8,6 +8,10 @@
 #pragma warning(disable : 4996)
 #endif
 #include "core/providers/cpu/tensor/pad.h"
+
+#include <algorithm>
+#include <cstring>
+
 #include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
@@ -18,14 +22,16 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Pad<float>);
 
-// This is the general padding method to n-dimensionally do edge or reflection padding (based on the inputDelta values)
+// rows of the outermost axis are padded in parallel with at least this many output elements in each range
+constexpr int64_t kMinPadElementsPerRange = 16 * 1024;
+
+// Copies block_count blocks of block_size contiguous elements to output, the input of each block input_pitch after
+// the input of the one before, which is how edge (0) and reflection (-block_size) padding repeat the outer axes
 template <typename T>
-static void PadAxis(T* output, T* input, ptrdiff_t input_delta, ptrdiff_t input_pitch, size_t block_size, size_t block_count) {
+static void PadAxis(T* output, const T* input, ptrdiff_t input_pitch, size_t block_size, size_t block_count) {
   for (size_t block_index = 0; block_index < block_count; block_index++) {
-    for (size_t i = 0; i < block_size; i++) {
-      *output++ = *input;
-      input += input_delta;
-    }
+    memcpy(output, input, block_size * sizeof(T));
+    output += block_size;
     input += input_pitch;
   }
 }
@@ -43,40 +49,19 @@ static void PadInnermostAxis(T* output, T* input, ptrdiff_t input_delta, size_t
 // For constant padding, there is no input, just a size to write the constant to
 template <typename T>
 static void PadAxisConstant(T* output, T constant, size_t size) {
-  for (size_t i = 0; i < size; i++)
-    *output++ = constant;
+  std::fill_n(output, size, constant);
 }
 
 template <>
-Status Pad<float>::Compute(OpKernelContext* ctx) const {
-  auto& input_tensor = *ctx->Input<Tensor>(0);
-  std::vector<int64_t> output_dims(input_tensor.Shape().GetDims());
-  size_t dimension_count = output_dims.size();
-
-  ORT_ENFORCE(dimension_count > 0, "Input tensor has no dimensions");
-  ORT_ENFORCE(dimension_count * 2 == pads_.size(), "'pads' attribute has wrong number of values");
-
-  std::vector<int64_t> input_starts;
-  std::vector<int64_t> input_extents;
-
-  // Calculate output dimensions, and handle any negative padding
-  for (size_t i = 0; i < dimension_count; i++) {
-    input_starts.push_back(slices_[i]);
-    input_extents.push_back(output_dims[i] + slices_[i] + slices_[i + dimension_count]);
-    output_dims[i] += pads_[i] + pads_[i + dimension_count] + slices_[i] + slices_[i + dimension_count];
-  }
-  TensorShape output_shape(output_dims);
-
-  SliceIterator<float> input(input_tensor, input_starts, input_extents);
-  auto& output_tensor = *ctx->Output(0, output_shape);
-  auto* output = output_tensor.template MutableData<float>();
-
-  TensorPitches output_pitches(output_tensor);
+void Pad<float>::PadSlice(SliceIterator<float>& input, gsl::span<const int64_t> input_extents,
+                          const std::vector<int64_t>& pads, const TensorPitches& output_pitches,
+                          float* output) const {
+  size_t dimension_count = input_extents.size();
   size_t alignSkip = 0;  // Amount to skip to align to where the next input tensor data needs to be written
 
   // Initial skip, sum up the begin padding on each axis
   for (size_t i = 0; i < dimension_count; i++)
-    alignSkip += pads_[i] * output_pitches[i];
+    alignSkip += pads[i] * output_pitches[i];
 
   size_t inner_axis = dimension_count - 1;
   ExtentAxisCounters input_counters(input_extents);
@@ -92,8 +77,8 @@ Status Pad<float>::Compute(OpKernelContext* ctx) const {
           float* axisStart = output;
           output = input.CopyInnermostAxis(output);
 
-          int64_t prePad = pads_[inner_axis];
-          int64_t postPad = pads_[inner_axis + dimension_count];
+          int64_t prePad = pads[inner_axis];
+          int64_t postPad = pads[inner_axis + dimension_count];
           PadAxisConstant(axisStart - prePad, value_, prePad);
           PadAxisConstant(output, value_, postPad);
           output += postPad;
@@ -103,8 +88,8 @@ Status Pad<float>::Compute(OpKernelContext* ctx) const {
         while (input_counters.Increment()) {
           ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
           float* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = pads_[input_counters.Axis()];
-          int64_t postPad = pads_[input_counters.Axis() + dimension_count];
+          int64_t prePad = pads[input_counters.Axis()];
+          int64_t postPad = pads[input_counters.Axis() + dimension_count];
           PadAxisConstant(axisStart - prePad * inner_pitch, value_, prePad * inner_pitch);
           PadAxisConstant(output, value_, postPad * inner_pitch);
           output += inner_pitch * postPad;
@@ -123,8 +108,8 @@ Status Pad<float>::Compute(OpKernelContext* ctx) const {
           float* axisStart = output;
           output = input.CopyInnermostAxis(output);
 
-          int64_t prePad = pads_[inner_axis];
-          int64_t postPad = pads_[inner_axis + dimension_count];
+          int64_t prePad = pads[inner_axis];
+          int64_t postPad = pads[inner_axis + dimension_count];
           PadAxisConstant(axisStart - prePad, *axisStart, prePad);
           PadAxisConstant(output, *(output - 1), postPad);
           output += postPad;
@@ -134,10 +119,10 @@ Status Pad<float>::Compute(OpKernelContext* ctx) const {
         while (input_counters.Increment()) {
           ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
           float* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = pads_[input_counters.Axis()];
-          int64_t postPad = pads_[input_counters.Axis() + dimension_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart, 1, -inner_pitch, inner_pitch, prePad);
-          PadAxis(output, output - inner_pitch, 1, -inner_pitch, inner_pitch, postPad);
+          int64_t prePad = pads[input_counters.Axis()];
+          int64_t postPad = pads[input_counters.Axis() + dimension_count];
+          PadAxis(axisStart - prePad * inner_pitch, axisStart, 0, inner_pitch, prePad);
+          PadAxis(output, output - inner_pitch, 0, inner_pitch, postPad);
           output += inner_pitch * postPad;
           alignSkip += inner_pitch * prePad;
         }
@@ -154,8 +139,8 @@ Status Pad<float>::Compute(OpKernelContext* ctx) const {
           float* axisStart = output;
           output = input.CopyInnermostAxis(output);
 
-          int64_t prePad = pads_[inner_axis];
-          int64_t postPad = pads_[inner_axis + dimension_count];
+          int64_t prePad = pads[inner_axis];
+          int64_t postPad = pads[inner_axis + dimension_count];
           PadInnermostAxis(axisStart - prePad, axisStart + prePad, -1 /* inputDelta */, prePad);
           PadInnermostAxis(output, output - 2, -1 /* inputDelta */, postPad);
           output += postPad;
@@ -165,16 +150,86 @@ Status Pad<float>::Compute(OpKernelContext* ctx) const {
         while (input_counters.Increment()) {
           ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
           float* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = pads_[input_counters.Axis()];
-          int64_t postPad = pads_[input_counters.Axis() + dimension_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, 1, -inner_pitch * 2, inner_pitch, prePad);
-          PadAxis(output, output - 2 * inner_pitch, 1, -inner_pitch * 2, inner_pitch, postPad);
+          int64_t prePad = pads[input_counters.Axis()];
+          int64_t postPad = pads[input_counters.Axis() + dimension_count];
+          PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, -inner_pitch, inner_pitch, prePad);
+          PadAxis(output, output - 2 * inner_pitch, -inner_pitch, inner_pitch, postPad);
           output += inner_pitch * postPad;
           alignSkip += inner_pitch * prePad;
         }
       }
       break;
   }
+}
+
+template <>
+Status Pad<float>::Compute(OpKernelContext* ctx) const {
+  auto& input_tensor = *ctx->Input<Tensor>(0);
+  std::vector<int64_t> output_dims(input_tensor.Shape().GetDims());
+  size_t dimension_count = output_dims.size();
+
+  ORT_ENFORCE(dimension_count > 0, "Input tensor has no dimensions");
+  ORT_ENFORCE(dimension_count * 2 == pads_.size(), "'pads' attribute has wrong number of values");
+
+  std::vector<int64_t> input_starts;
+  std::vector<int64_t> input_extents;
+
+  // Calculate output dimensions, and handle any negative padding
+  for (size_t i = 0; i < dimension_count; i++) {
+    input_starts.push_back(slices_[i]);
+    input_extents.push_back(output_dims[i] + slices_[i] + slices_[i + dimension_count]);
+    output_dims[i] += pads_[i] + pads_[i + dimension_count] + slices_[i] + slices_[i + dimension_count];
+  }
+  TensorShape output_shape(output_dims);
+
+  auto& output_tensor = *ctx->Output(0, output_shape);
+  auto* output = output_tensor.template MutableData<float>();
+  TensorPitches output_pitches(output_tensor);
+
+  // nothing is copied from an empty input
+  if (std::find(input_extents.cbegin(), input_extents.cend(), 0) != input_extents.cend()) {
+    return Status::OK();
+  }
+
+  if (dimension_count == 1) {
+    SliceIterator<float> input(input_tensor, input_starts, input_extents);
+    PadSlice(input, input_extents, pads_, output_pitches, output);
+    return Status::OK();
+  }
+
+  // Pad ranges of the rows of the outermost axis in the other axes in parallel, then pad the outermost axis
+  const int64_t rows = input_extents[0];
+  const int64_t row_size = output_pitches[0];
+  std::vector<int64_t> row_pads(pads_);
+  row_pads[0] = 0;
+  row_pads[dimension_count] = 0;
+  ctx->ParallelFor(rows, std::max<int64_t>(1, kMinPadElementsPerRange / row_size), [&](int64_t begin, int64_t end) {
+    std::vector<int64_t> starts(input_starts);
+    std::vector<int64_t> extents(input_extents);
+    starts[0] += begin;
+    extents[0] = end - begin;
+    SliceIterator<float> input(input_tensor, starts, extents);
+    PadSlice(input, extents, row_pads, output_pitches, output + (pads_[0] + begin) * row_size);
+  });
+
+  const int64_t prePad = pads_[0];
+  const int64_t postPad = pads_[dimension_count];
+  float* first = output + prePad * row_size;
+  float* end = first + rows * row_size;
+  switch (mode_) {
+    case Mode::Constant:
+      PadAxisConstant(output, value_, prePad * row_size);
+      PadAxisConstant(end, value_, postPad * row_size);
+      break;
+    case Mode::Edge:
+      PadAxis(output, first, 0, row_size, prePad);
+      PadAxis(end, end - row_size, 0, row_size, postPad);
+      break;
+    case Mode::Reflect:
+      PadAxis(output, first + prePad * row_size, -row_size, row_size, prePad);
+      PadAxis(end, end - 2 * row_size, -row_size, row_size, postPad);
+      break;
+  }
 
   return Status::OK();
 }
@@ -6,6 +6,10 @@
 
 namespace onnxruntime {
 
+struct TensorPitches;
+template <typename T>
+struct SliceIterator;
+
 class PadBase {
  protected:
   PadBase(const OpKernelInfo& info) : value_(info.GetAttrOrDefault("value", 0.f)) {
@@ -53,6 +57,12 @@ struct Pad final : public OpKernel, public PadBase {
   Pad(const OpKernelInfo& info) : OpKernel(info), PadBase(info) {}
 
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // pads the slice of the input in the axes with non zero pads into output, which is where the first element of
+  // the slice is to be padded to
+  void PadSlice(SliceIterator<T>& input, gsl::span<const int64_t> input_extents, const std::vector<int64_t>& pads,
+                const TensorPitches& output_pitches, T* output) const;
 };
 
 }  // namespace onnxruntime
@@ -75,6 +75,42 @@ const T& clamp(const T& v, const T& lo, const T& hi) {
   if (v > hi) return hi;
   return v;
 }
+
+// Copies the elements [first, last) of a slice of input to output. The slice is a run of extents.back() contiguous
+// elements of the input at each index of the outer axes.
+template <typename T>
+void CopySliceElements(const T* input, T* output, const std::vector<int64_t>& pitches,
+                       const std::vector<int64_t>& starts, const std::vector<int64_t>& extents,
+                       int64_t first, int64_t last) {
+  const size_t inner_axis = extents.size() - 1;
+  const int64_t run_size = extents[inner_axis];
+
+  // The index in each of the outer axes of the run that holds the first element
+  std::vector<int64_t> indices(inner_axis);
+  int64_t run = first / run_size;
+  for (size_t i = inner_axis; i-- > 0;) {
+    indices[i] = run % extents[i];
+    run /= extents[i];
+  }
+
+  int64_t offset = first % run_size;
+  while (first < last) {
+    int64_t input_offset = starts[inner_axis] + offset;
+    for (size_t i = 0; i < inner_axis; i++)
+      input_offset += (starts[i] + indices[i]) * pitches[i];
+
+    const int64_t count = std::min(run_size - offset, last - first);
+    std::copy(input + input_offset, input + input_offset + count, output + first);
+    first += count;
+    offset = 0;
+
+    for (size_t i = inner_axis; i-- > 0;) {
+      if (++indices[i] != extents[i])
+        break;
+      indices[i] = 0;
+    }
+  }
+}
 }  // namespace
 
 Status SliceBase::PrepareForCompute(const std::vector<int64_t>& raw_starts,
@@ -163,11 +199,38 @@ Status Slice<T, Tind, dynamic>::Compute(OpKernelContext* ctx) const {
   TensorShape output_shape(output_dims);
   auto& output_tensor = *ctx->Output(0, output_shape);
   auto* output = output_tensor.template MutableData<T>();
-  const auto* output_end = output + output_shape.Size();
 
-  SliceIterator<T> input_iterator(input_tensor, starts, output_dims);
-  while (output != output_end)
-    *output++ = *input_iterator++;
+  const int64_t output_size = output_shape.Size();
+  if (output_size == 0)
+    return Status::OK();
+
+  // The axes inside the innermost sliced axis are copied whole, so they are merged with the axes around them into
+  // runs of contiguous elements, e.g. a slice of the channels of NCHW data copies H*W elements at a time
+  std::vector<int64_t> dims(input_dimensions), extents(output_dims);
+  if (dims.empty()) {
+    dims.push_back(1);
+    starts.push_back(0);
+    extents.push_back(1);
+  }
+  while (dims.size() > 1 && starts.back() == 0 && extents.back() == dims.back()) {
+    const int64_t inner_dim = dims.back();
+    dims.pop_back();
+    starts.pop_back();
+    extents.pop_back();
+    dims.back() *= inner_dim;
+    starts.back() *= inner_dim;
+    extents.back() *= inner_dim;
+  }
+
+  std::vector<int64_t> pitches(dims.size(), 1);
+  for (size_t i = dims.size() - 1; i-- > 0;)
+    pitches[i] = pitches[i + 1] * dims[i + 1];
+
+  const T* input = input_tensor.template Data<T>();
+  const int64_t chunk_size = std::max<int64_t>(1, kParallelCopyChunkBytes / static_cast<int64_t>(sizeof(T)));
+  ctx->ParallelFor(output_size, chunk_size, [&](int64_t first, int64_t last) {
+    CopySliceElements(input, output, pitches, starts, extents, first, last);
+  });
 
   return Status::OK();
 }
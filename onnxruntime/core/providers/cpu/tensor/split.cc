@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/split.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/tensor/utils.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -28,11 +29,9 @@ Status Split::Compute(OpKernelContext* context) const {
 
   if (data_type == DataTypeImpl::GetType<float>())
     status = ComputeImpl<float>(*context, input);
-  else if (data_type == DataTypeImpl::GetType<double>()) {
-    /* Need to update CopyMatrix to support double...
-    status = ComputeImpl<double>(*context, input); */
-    ORT_NOT_IMPLEMENTED("Split operator does not support double yet");
-  } else
+  else if (data_type == DataTypeImpl::GetType<double>())
+    status = ComputeImpl<double>(*context, input);
+  else
     ORT_THROW("Invalid data type for Split operator of ", data_type);
 
   return status;
@@ -93,16 +92,9 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
     Tensor* output = context.Output(i, TensorShape{output_dimensions});
     T* output_data = output->template MutableData<T>();
 
-    ::onnxruntime::math::CopyMatrix<T>(
-        before_dims,                                       // M
-        split_size * after_dims_excluding_split,           // N
-        static_cast<const T*>(input_data + input_offset),  // A
-        after_dims_including_split_axis,                   // lda
-        static_cast<T*>(output_data),                      // B
-        split_size * after_dims_excluding_split,           // ldb
-        [](const T* src, T* dst, size_t count) {
-          memcpy(dst, src, count * sizeof(T));
-        });
+    ParallelCopyBlocks(&context, output_data, split_size * after_dims_excluding_split,
+                       input_data + input_offset, after_dims_including_split_axis,
+                       split_size * after_dims_excluding_split, before_dims);
 
     input_offset += split_size * after_dims_excluding_split;  // offset by the N data we used in this iteration
   }
@@ -9,6 +9,9 @@
 #pragma warning(disable : 4996)
 #endif
 
+#include <algorithm>
+#include <cstring>
+
 #include "gsl/gsl_algorithm"
 #include "core/providers/cpu/tensor/tile.h"
 #include "core/providers/cpu/tensor/utils.h"
@@ -27,6 +30,25 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Tile<float>);
 
+// rows are only tiled in parallel with at least this many output elements in each range
+constexpr int64_t kMinTileElementsPerRange = 16 * 1024;
+
+// tiles the input in the axes from axis on into output, and returns the end of the output written
+template <typename T>
+static T* TileAxes(const T* input, T* output, const std::vector<int64_t>& input_dims, const int64_t* repeats,
+                   const TensorPitches& input_pitches, size_t axis) {
+  if (axis == input_dims.size() - 1) {
+    memcpy(output, input, input_dims[axis] * sizeof(T));
+    return RepeatBlock(output, input_dims[axis], repeats[axis]);
+  }
+
+  T* block = output;
+  for (int64_t i = 0; i < input_dims[axis]; i++) {
+    output = TileAxes(input + i * input_pitches[axis], output, input_dims, repeats, input_pitches, axis + 1);
+  }
+  return RepeatBlock(block, output - block, repeats[axis]);
+}
+
 template <>
 Status Tile<float>::Compute(OpKernelContext* ctx) const {
   const Tensor* tensor_pointer = ctx->Input<Tensor>(0);
@@ -62,30 +84,31 @@ Status Tile<float>::Compute(OpKernelContext* ctx) const {
 
   auto* output = output_tensor.template MutableData<float>();
   auto* input = input_tensor.template Data<float>();
+  const auto& input_dims = input_tensor.Shape().GetDims();
+  if (dimension_count == 0) {
+    *output = *input;
+    return Status::OK();
+  }
+  if (dimension_count == 1) {
+    memcpy(output, input, input_dims[0] * sizeof(float));
+    RepeatBlock(output, input_dims[0], repeats[0]);
+    return Status::OK();
+  }
 
+  TensorPitches input_pitches(input_tensor);
   TensorPitches output_pitches(output_tensor);
-  TensorAxisCounters input_counters(input_tensor);
-
-  while (input_counters) {
-    // Copy the input data over
-    size_t input_pitch = input_tensor.Shape().GetDims().back();
-    for (size_t i = 0; i < input_pitch; i++)
-      *output++ = *input++;
-
-    // Tile it for the innermost axis
-    const auto* copy = output - input_tensor.Shape()[dimension_count - 1];
-    for (int64_t repeat = (repeats[dimension_count - 1] - 1) * input_pitch; repeat-- > 0;)
-      *output++ = *copy++;
-
-    // Tile it in the other axes
-    while (input_counters.Increment()) {
-      ptrdiff_t pitch = output_pitches[input_counters.Axis()] * input_tensor.Shape()[input_counters.Axis()];
-      copy = output - pitch;
-      for (int64_t repeat = (repeats[input_counters.Axis()] - 1) * pitch; repeat-- > 0;) {
-        *output++ = *copy++;
-      }
+
+  // the rows of the outermost axis are tiled in the other axes in parallel, each into its own block of the first
+  // repeat of the outermost axis, which is then repeated
+  const int64_t row_size = output_pitches[0];
+  const int64_t min_rows = std::max<int64_t>(1, kMinTileElementsPerRange / row_size);
+  ctx->ParallelFor(input_dims[0], min_rows, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      TileAxes(input + row * input_pitches[0], output + row * row_size, input_dims, repeats, input_pitches, 1);
     }
-  }
+  });
+  RepeatBlock(output, input_dims[0] * row_size, repeats[0]);
+
   return Status::OK();
 }
 }  // namespace onnxruntime
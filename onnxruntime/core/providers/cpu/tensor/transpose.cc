@@ -3,6 +3,10 @@
 
 #include "core/providers/cpu/tensor/transpose.h"
 #include "core/framework/utils.h"
+#include "core/mlas/inc/mlas.h"
+
+#include <algorithm>
+#include <utility>
 
 namespace onnxruntime {
 
@@ -39,7 +43,7 @@ template <typename T>
 static void DoTransposeImpl(int64_t num_axes, const std::vector<int64_t>& target_dims,
                             size_t num_blocks, size_t num_elts_in_block, const std::vector<size_t>& stride,
                             const T* source, T* target) {
-  size_t blocksize = num_elts_in_block * sizeof(float);
+  size_t blocksize = num_elts_in_block * sizeof(T);
   // index used to iterate over target iteration-space
   std::vector<int64_t> target_index(num_axes, 0);
   for (size_t i = 0; i < num_blocks; ++i) {
@@ -85,8 +89,136 @@ static void DoTransposeSingleBlock(size_t num_elts_in_block, const T* source, T*
   memcpy(target, source, blocksize);
 }
 
+void TransposeBase::SimplifyPermutation(const std::vector<int64_t>& input_dims, const std::vector<int64_t>& permutations,
+                                        std::vector<int64_t>& simplified_dims,
+                                        std::vector<int64_t>& simplified_permutations) {
+  const size_t rank = input_dims.size();
+
+  // the index of each input axis among the axes whose size isn't 1
+  std::vector<int64_t> compact_axis(rank, -1);
+  int64_t num_compact_axes = 0;
+  for (size_t i = 0; i < rank; ++i) {
+    if (input_dims[i] != 1) {
+      compact_axis[i] = num_compact_axes++;
+    }
+  }
+
+  // the runs of consecutive input axes in the order of the output, each a merged axis
+  std::vector<std::pair<int64_t, int64_t>> runs;  // first compact input axis, size
+  int64_t previous = -2;
+  for (size_t i = 0; i < rank; ++i) {
+    const int64_t axis = permutations[i];
+    if (compact_axis[axis] < 0) {
+      continue;
+    }
+    if (compact_axis[axis] == previous + 1) {
+      runs.back().second *= input_dims[axis];
+    } else {
+      runs.emplace_back(compact_axis[axis], input_dims[axis]);
+    }
+    previous = compact_axis[axis];
+  }
+
+  // the merged axes of the input are the runs in the order of their first axis
+  std::vector<size_t> order(runs.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&runs](size_t a, size_t b) { return runs[a].first < runs[b].first; });
+
+  simplified_dims.resize(runs.size());
+  simplified_permutations.resize(runs.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    simplified_dims[i] = runs[order[i]].second;
+    simplified_permutations[order[i]] = static_cast<int64_t>(i);
+  }
+}
+
+// the number of rows and columns of the tiles a batched 2D transpose copies, which fit in the L1 cache
+static constexpr int64_t kTransposeTileSize = 16;
+
+// the number of elements each range of tiles transposed in parallel copies at least
+static constexpr int64_t kMinTransposeElementsPerRange = 16 * 1024;
+
+// Transposes each of a batch of matrices of M rows and N columns tile by tile, in parallel over the tiles of rows on
+// the intra-op pool of ctx if it's given.
 template <typename T>
-static Status DoTypedTranspose(const std::vector<int64_t>& permutations, const Tensor& input, Tensor& output) {
+static void TransposeBatched2D(const OpKernelContext* ctx, int64_t batch_count, int64_t M, int64_t N, const T* source,
+                               T* target) {
+  const int64_t row_tiles = (M + kTransposeTileSize - 1) / kTransposeTileSize;
+  auto transpose_tiles = [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; ++t) {
+      const T* batch_source = source + (t / row_tiles) * M * N;
+      T* batch_target = target + (t / row_tiles) * M * N;
+      const int64_t row = (t % row_tiles) * kTransposeTileSize;
+      const int64_t row_end = std::min(row + kTransposeTileSize, M);
+
+      for (int64_t column = 0; column < N; column += kTransposeTileSize) {
+        const int64_t column_end = std::min(column + kTransposeTileSize, N);
+        for (int64_t i = row; i < row_end; ++i) {
+          for (int64_t j = column; j < column_end; ++j) {
+            batch_target[j * M + i] = batch_source[i * N + j];
+          }
+        }
+      }
+    }
+  };
+
+  if (ctx == nullptr) {
+    transpose_tiles(0, batch_count * row_tiles);
+  } else {
+    const int64_t min_tiles = std::max<int64_t>(1, kMinTransposeElementsPerRange / (kTransposeTileSize * N));
+    ctx->ParallelFor(batch_count * row_tiles, min_tiles, transpose_tiles);
+  }
+}
+
+// 32-bit elements are transposed by MLAS, with vector registers and its threading
+template <>
+void TransposeBatched2D<float>(const OpKernelContext*, int64_t batch_count, int64_t M, int64_t N, const float* source, float* target) {
+  MlasTranspose(reinterpret_cast<const uint32_t*>(source), reinterpret_cast<uint32_t*>(target),
+                static_cast<size_t>(batch_count), static_cast<size_t>(M), static_cast<size_t>(N));
+}
+
+template <>
+void TransposeBatched2D<int32_t>(const OpKernelContext*, int64_t batch_count, int64_t M, int64_t N, const int32_t* source, int32_t* target) {
+  MlasTranspose(reinterpret_cast<const uint32_t*>(source), reinterpret_cast<uint32_t*>(target),
+                static_cast<size_t>(batch_count), static_cast<size_t>(M), static_cast<size_t>(N));
+}
+
+template <>
+void TransposeBatched2D<uint32_t>(const OpKernelContext*, int64_t batch_count, int64_t M, int64_t N,
+                                  const uint32_t* source, uint32_t* target) {
+  MlasTranspose(source, target, static_cast<size_t>(batch_count), static_cast<size_t>(M), static_cast<size_t>(N));
+}
+
+// Returns true and transposes the input if the permutation is the identity or the transpose of a batch of matrices
+// once it's simplified, which covers 2D transposes and NCHW to NHWC and back.
+template <typename T>
+static bool TryTransposeBatched2D(const std::vector<int64_t>& permutations, const Tensor& input, Tensor& output,
+                                  const OpKernelContext* ctx) {
+  std::vector<int64_t> dims;
+  std::vector<int64_t> simplified_permutations;
+  TransposeBase::SimplifyPermutation(input.Shape().GetDims(), permutations, dims, simplified_permutations);
+
+  const T* input_data = input.Data<T>();
+  T* output_data = output.MutableData<T>();
+
+  if (dims.size() <= 1) {
+    memcpy(output_data, input_data, input.Shape().Size() * sizeof(T));
+  } else if (simplified_permutations == std::vector<int64_t>{1, 0}) {
+    TransposeBatched2D<T>(ctx, 1, dims[0], dims[1], input_data, output_data);
+  } else if (simplified_permutations == std::vector<int64_t>{0, 2, 1}) {
+    TransposeBatched2D<T>(ctx, dims[0], dims[1], dims[2], input_data, output_data);
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+template <typename T>
+static Status DoTypedTranspose(const std::vector<int64_t>& permutations, const Tensor& input, Tensor& output,
+                               const OpKernelContext* ctx) {
   const auto& input_shape = input.Shape();
   const auto& input_dims = input_shape.GetDims();
   auto rank = input_shape.NumDimensions();
@@ -118,6 +250,10 @@ static Status DoTypedTranspose(const std::vector<int64_t>& permutations, const T
     }
   }
 
+  if (TryTransposeBatched2D<T>(permutations, input, output, ctx)) {
+    return Status::OK();
+  }
+
   const T* input_data = input.Data<T>();
   T* output_data = output.MutableData<T>();
 
@@ -133,7 +269,8 @@ static Status DoTypedTranspose(const std::vector<int64_t>& permutations, const T
   return Status::OK();
 }
 
-Status TransposeBase::DoTranspose(const std::vector<int64_t>& permutations, const Tensor& input, Tensor& output) {
+Status TransposeBase::DoTranspose(const std::vector<int64_t>& permutations, const Tensor& input, Tensor& output,
+                                  const OpKernelContext* ctx) {
   Status status = Status::OK();
 
   auto input_type = input.DataType();
@@ -143,7 +280,7 @@ Status TransposeBase::DoTranspose(const std::vector<int64_t>& permutations, cons
     status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Mismatched data types between input and output Tensors. ",
                              input_type, " != ", output_type);
   } else {
-    DispatchOnTensorTypeWithReturn(input_type, status, DoTypedTranspose, permutations, input, output);
+    DispatchOnTensorTypeWithReturn(input_type, status, DoTypedTranspose, permutations, input, output, ctx);
   }
 
   return status;
@@ -167,7 +304,7 @@ Status Transpose<float>::Compute(OpKernelContext* ctx) const {
   TensorShape output_shape{output_dims};
   Tensor& Y = *ctx->Output(0, output_shape);
 
-  DoTypedTranspose<float>(*p_perm, X, Y);
+  DoTypedTranspose<float>(*p_perm, X, Y, ctx);
 
   return Status::OK();
 }
@@ -13,9 +13,18 @@ class TransposeBase {
  public:
   /**
   Transpose the input Tensor into the output Tensor using the provided permutations.
-  Both Tensors must have the same data type. 
+  Both Tensors must have the same data type. The intra-op pool of ctx, if given, copies in parallel.
   */
-  static Status DoTranspose(const std::vector<int64_t>& permutations, const Tensor& input, Tensor& output);
+  static Status DoTranspose(const std::vector<int64_t>& permutations, const Tensor& input, Tensor& output,
+                            const OpKernelContext* ctx = nullptr);
+
+  /**
+  Drop the axes of size 1 and merge the axes of the input that stay adjacent and in order in the output, so that
+  for example NCHW to NHWC becomes the transpose of a batch of matrices of C rows and H * W columns.
+  */
+  static void SimplifyPermutation(const std::vector<int64_t>& input_dims, const std::vector<int64_t>& permutations,
+                                  std::vector<int64_t>& simplified_dims,
+                                  std::vector<int64_t>& simplified_permutations);
 
  protected:
   TransposeBase(const OpKernelInfo& info) {
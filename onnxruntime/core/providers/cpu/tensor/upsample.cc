@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/upsample.h"
 #include <math.h>  //for fabs
+#include <algorithm>
 
 using namespace ::onnxruntime::common;
 using namespace std;
@@ -22,35 +23,57 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int32_t>()),
     Upsample<int32_t>);
 
+// the number of output elements each range of an upsample split across the threads writes at least
+constexpr int64_t kMinUpsampleElementsPerRange = 64 * 1024;
+
+// the input index of each output index of an upsampled axis, and the pitches of the axis. the output blocks of an
+// axis that are the same input block as the previous one are copies of the previous output block.
+struct NearestAxisTable {
+  std::vector<int64_t> input_indices;
+  int64_t input_pitch;
+  int64_t output_pitch;
+};
+
 template <typename T>
-void UpsampleNearest2x(
-    int64_t batch_size,
-    int64_t num_channels,
-    int64_t input_height,
-    int64_t input_width,
-    const T* input,
-    T* output) {
-  const int64_t output_height = input_height * 2;
-  const int64_t output_width = input_width * 2;
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        const int64_t in_y = y / 2;
-        for (int64_t x = 0; x < input_width; ++x) {
-          const T v = input[in_y * input_width + x];
-          const int64_t oidx = output_width * y + x * 2;
-          output[oidx + 0] = v;
-          output[oidx + 1] = v;
-        }
+void UpsampleNearestAxis(const T* input, T* output, const std::vector<NearestAxisTable>& tables, size_t axis,
+                         int64_t block_size, int64_t integer_scale) {
+  const NearestAxisTable& table = tables[axis];
+  const int64_t output_dim = static_cast<int64_t>(table.input_indices.size());
+
+  if (axis + 1 < tables.size()) {
+    for (int64_t i = 0; i < output_dim; ++i) {
+      T* output_block = output + i * table.output_pitch;
+      if (i > 0 && table.input_indices[i] == table.input_indices[i - 1]) {
+        memcpy(output_block, output_block - table.output_pitch, table.output_pitch * sizeof(T));
+      } else {
+        UpsampleNearestAxis(input + table.input_indices[i] * table.input_pitch, output_block, tables, axis + 1,
+                            block_size, integer_scale);
+      }
+    }
+    return;
+  }
+
+  // the innermost upsampled axis, whose pitches are the block size of the axes that aren't upsampled after it
+  if (block_size == 1) {
+    if (integer_scale > 1) {
+      for (int64_t i = 0, input_dim = output_dim / integer_scale; i < input_dim; ++i) {
+        std::fill_n(output + i * integer_scale, integer_scale, input[i]);
       }
-      input += input_height * input_width;
-      output += output_height * output_width;
+    } else {
+      for (int64_t i = 0; i < output_dim; ++i) {
+        output[i] = input[table.input_indices[i]];
+      }
+    }
+  } else {
+    for (int64_t i = 0; i < output_dim; ++i) {
+      memcpy(output + i * block_size, input + table.input_indices[i] * block_size, block_size * sizeof(T));
     }
   }
 }
 
 template <typename T>
-Status UpsampleNearest(const T* input,
+Status UpsampleNearest(const OpKernelContext* context,
+                       const T* input,
                        T* output,
                        const TensorShape& input_shape,
                        const TensorShape& output_shape,
@@ -60,24 +83,52 @@ Status UpsampleNearest(const T* input,
   if (input_shape.NumDimensions() != output_shape.NumDimensions())
     return Status(ONNXRUNTIME, FAIL, "Upsample: input/output value's dimension mismatch");
   auto n_dim = input_shape.NumDimensions();
-  if (scales.size() == 4 && scales[0] == 1 && scales[1] == 1 && scales[2] == 2 && scales[3] == 2) {
-    UpsampleNearest2x<T>(input_shape[0], input_shape[1], input_shape[2], input_shape[3], input, output);
-  } else {
-    for (size_t i = 0, size = output_shape.Size(); i < size; i++) {
-      size_t old_idx = 0;
-      size_t cur_idx = i;
+  if (output_shape.Size() == 0)
+    return Status::OK();
 
-      int64_t base = 1;
-      for (int64_t j = static_cast<int64_t>(n_dim - 1); j >= 0; j--) {
-        auto tmp = cur_idx % output_shape[j];
-        old_idx += (std::min(static_cast<int64_t>(tmp / scales[j]), input_shape[j] - 1)) * base;
-        base *= input_shape[j];
-        cur_idx /= output_shape[j];
-      }
+  // the leading axes that aren't upsampled are a batch of independent blocks, and the trailing ones are copied as
+  // blocks by the innermost upsampled axis
+  size_t begin_axis = 0;
+  while (begin_axis < n_dim && scales[begin_axis] == 1) {
+    ++begin_axis;
+  }
+  if (begin_axis == n_dim) {
+    memcpy(output, input, input_shape.Size() * sizeof(T));
+    return Status::OK();
+  }
+  size_t end_axis = n_dim;
+  while (scales[end_axis - 1] == 1) {
+    --end_axis;
+  }
 
-      output[i] = input[old_idx];
+  std::vector<NearestAxisTable> tables(end_axis - begin_axis);
+  for (size_t axis = begin_axis; axis < end_axis; ++axis) {
+    NearestAxisTable& table = tables[axis - begin_axis];
+    table.input_indices.resize(output_shape[axis]);
+    for (int64_t i = 0; i < output_shape[axis]; ++i) {
+      table.input_indices[i] = std::min(static_cast<int64_t>(i / scales[axis]), input_shape[axis] - 1);
     }
+    table.input_pitch = input_shape.SizeFromDimension(axis + 1);
+    table.output_pitch = output_shape.SizeFromDimension(axis + 1);
   }
+
+  // an integer scale of the innermost upsampled axis repeats each input element, which needs no table
+  const float inner_scale = scales[end_axis - 1];
+  const int64_t integer_scale = static_cast<int64_t>(inner_scale);
+  const bool is_integer_scale = integer_scale == inner_scale &&
+                                output_shape[end_axis - 1] == input_shape[end_axis - 1] * integer_scale;
+  const int64_t block_size = input_shape.SizeFromDimension(end_axis);
+
+  const int64_t batch_size = input_shape.SizeToDimension(begin_axis);
+  const int64_t input_batch_pitch = input_shape.SizeFromDimension(begin_axis);
+  const int64_t output_batch_pitch = output_shape.SizeFromDimension(begin_axis);
+  const int64_t min_batches = std::max<int64_t>(1, kMinUpsampleElementsPerRange / output_batch_pitch);
+  context->ParallelFor(batch_size, min_batches, [&](int64_t begin, int64_t end) {
+    for (int64_t n = begin; n < end; ++n) {
+      UpsampleNearestAxis(input + n * input_batch_pitch, output + n * output_batch_pitch, tables, 0,
+                          block_size, is_integer_scale ? integer_scale : 0);
+    }
+  });
   return Status::OK();
 }
 
@@ -137,8 +188,33 @@ Status upsampleLiner(const T* input,
   return Status::OK();
 }
 
+// the two input indices that each output index of an axis interpolates, and the weights of their elements
+struct LinearAxisTable {
+  std::vector<int64_t> index1;
+  std::vector<int64_t> index2;
+  std::vector<float> weight1;
+  std::vector<float> weight2;
+
+  LinearAxisTable(int64_t input_dim, int64_t output_dim, float scale)
+      : index1(output_dim), index2(output_dim), weight1(output_dim), weight2(output_dim) {
+    for (int64_t i = 0; i < output_dim; ++i) {
+      float in = std::min(i / scale, static_cast<float>(input_dim - 1));
+      index1[i] = std::min(static_cast<int64_t>(in), input_dim - 1);
+      index2[i] = std::min(index1[i] + 1, input_dim - 1);
+      if (index1[i] == index2[i]) {
+        weight1[i] = 0.5f;
+        weight2[i] = 0.5f;
+      } else {
+        weight1[i] = std::abs(in - index2[i]);
+        weight2[i] = std::abs(in - index1[i]);
+      }
+    }
+  }
+};
+
 template <typename T>
 void upsampleBilinear(
+    const OpKernelContext* context,
     int64_t batch_size,
     int64_t num_channels,
     int64_t input_height,
@@ -149,50 +225,87 @@ void upsampleBilinear(
     T* Ydata) {
   int64_t output_width = static_cast<int64_t>(input_width * width_scale);
   int64_t output_height = static_cast<int64_t>(input_height * height_scale);
+  const LinearAxisTable y_table(input_height, output_height, height_scale);
+  const LinearAxisTable x_table(input_width, output_width, width_scale);
+  const int64_t* in_x1 = x_table.index1.data();
+  const int64_t* in_x2 = x_table.index2.data();
+  const float* dx2 = x_table.weight1.data();
+  const float* dx1 = x_table.weight2.data();
 
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
+  const int64_t num_images = batch_size * num_channels;
+  const int64_t min_images = std::max<int64_t>(1, kMinUpsampleElementsPerRange /
+                                                        std::max<int64_t>(1, output_height * output_width));
+  context->ParallelFor(num_images, min_images, [&](int64_t begin, int64_t end) {
+    for (int64_t image = begin; image < end; ++image) {
+      const T* X = Xdata + image * input_height * input_width;
+      T* Y = Ydata + image * output_height * output_width;
       for (int64_t y = 0; y < output_height; ++y) {
-        float in_y = std::min(y / height_scale, static_cast<float>(input_height - 1));
-        const int64_t in_y1 = std::min(static_cast<int64_t>(in_y), input_height - 1);
-        const int64_t in_y2 = std::min(in_y1 + 1, input_height - 1);
-        float dy1 = fabs(in_y - in_y1);
-        float dy2 = fabs(in_y - in_y2);
-        if (in_y1 == in_y2) {
-          dy1 = 0.5f;
-          dy2 = 0.5f;
+        const T* X1 = X + input_width * y_table.index1[y];
+        const T* X2 = X + input_width * y_table.index2[y];
+        const float dy2 = y_table.weight1[y];
+        const float dy1 = y_table.weight2[y];
+        T* Yrow = Y + output_width * y;
+
+        // the tables leave no branches in the loop over the row, so that it's vectorized
+        for (int64_t x = 0; x < output_width; ++x) {
+          Yrow[x] = static_cast<T>(dx2[x] * dy2 * X1[in_x1[x]] +
+                                   dx1[x] * dy2 * X1[in_x2[x]] +
+                                   dx2[x] * dy1 * X2[in_x1[x]] +
+                                   dx1[x] * dy1 * X2[in_x2[x]]);
         }
+      }
+    }
+  });
+}
 
-        const int64_t input_width_mul_y1 = input_width * in_y1;
-        const int64_t input_width_mul_y2 = input_width * in_y2;
+// upsamples the H and W axes of an NHWC tensor. the channels of a pixel are contiguous, so the innermost loop
+// interpolates them with the same weights.
+template <typename T>
+void upsampleBilinearNhwc(
+    const OpKernelContext* context,
+    int64_t batch_size,
+    int64_t num_channels,
+    int64_t input_height,
+    int64_t input_width,
+    float height_scale,
+    float width_scale,
+    const T* Xdata,
+    T* Ydata) {
+  int64_t output_width = static_cast<int64_t>(input_width * width_scale);
+  int64_t output_height = static_cast<int64_t>(input_height * height_scale);
+  const LinearAxisTable y_table(input_height, output_height, height_scale);
+  const LinearAxisTable x_table(input_width, output_width, width_scale);
 
-        for (int64_t x = 0; x < output_width; ++x) {
-          float in_x = std::min(x / width_scale, static_cast<float>(input_width - 1));
-          const int64_t in_x1 = std::min(static_cast<int64_t>(in_x), input_width - 1);
-          const int64_t in_x2 = std::min(in_x1 + 1, input_width - 1);
-
-          float dx1 = std::abs(in_x - in_x1);
-          float dx2 = std::abs(in_x - in_x2);
-          if (in_x1 == in_x2) {
-            dx1 = 0.5f;
-            dx2 = 0.5f;
-          }
-
-          T X11 = Xdata[input_width_mul_y1 + in_x1];
-          T X21 = Xdata[input_width_mul_y1 + in_x2];
-          T X12 = Xdata[input_width_mul_y2 + in_x1];
-          T X22 = Xdata[input_width_mul_y2 + in_x2];
-
-          Ydata[output_width * y + x] = static_cast<T>(dx2 * dy2 * X11 +
-                                                       dx1 * dy2 * X21 +
-                                                       dx2 * dy1 * X12 +
-                                                       dx1 * dy1 * X22);
+  const int64_t num_rows = batch_size * output_height;
+  const int64_t min_rows = std::max<int64_t>(1, kMinUpsampleElementsPerRange /
+                                                      std::max<int64_t>(1, output_width * num_channels));
+  context->ParallelFor(num_rows, min_rows, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      const int64_t n = row / output_height;
+      const int64_t y = row % output_height;
+      const T* X = Xdata + n * input_height * input_width * num_channels;
+      const T* X1 = X + input_width * num_channels * y_table.index1[y];
+      const T* X2 = X + input_width * num_channels * y_table.index2[y];
+      const float dy2 = y_table.weight1[y];
+      const float dy1 = y_table.weight2[y];
+      T* Y = Ydata + row * output_width * num_channels;
+
+      for (int64_t x = 0; x < output_width; ++x) {
+        const T* X11 = X1 + x_table.index1[x] * num_channels;
+        const T* X21 = X1 + x_table.index2[x] * num_channels;
+        const T* X12 = X2 + x_table.index1[x] * num_channels;
+        const T* X22 = X2 + x_table.index2[x] * num_channels;
+        const float w11 = x_table.weight1[x] * dy2;
+        const float w21 = x_table.weight2[x] * dy2;
+        const float w12 = x_table.weight1[x] * dy1;
+        const float w22 = x_table.weight2[x] * dy1;
+        T* Ypixel = Y + x * num_channels;
+        for (int64_t c = 0; c < num_channels; ++c) {
+          Ypixel[c] = static_cast<T>(w11 * X11[c] + w21 * X21[c] + w12 * X12[c] + w22 * X22[c]);
         }
       }
-      Xdata += input_height * input_width;
-      Ydata += output_width * output_height;
     }
-  }
+  });
 }
 
 template <typename T>
@@ -213,17 +326,26 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
 
   switch (mode_) {
     case UpsampleMode::NN:
-      return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(), scales);
+      return UpsampleNearest<T>(context, X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(),
+                                scales);
     case UpsampleMode::LINEAR: {
       //What's the correct behavior of linear mode is not clear right now,
       //Only support bilinear with 4D tensor to keep consistent with previous behavior
       if (dims.size() != 4)
-        return Status(ONNXRUNTIME, FAIL, "Upsample: linear mode upsample only support 4-D tensor with NCHW layout");
+        return Status(ONNXRUNTIME, FAIL,
+                      "Upsample: linear mode upsample only support 4-D tensor with NCHW or NHWC layout");
+
+      // scales of {1, height, width, 1} upsample an NHWC tensor
+      if (scales[1] != 1) {
+        upsampleBilinearNhwc(context, dims[0], dims[3], dims[1], dims[2],
+                             scales[1], scales[2], X->template Data<T>(), Y->template MutableData<T>());
+        return Status::OK();
+      }
 
       const int64_t batch_size = dims[0], num_channels = dims[1];
       const int64_t input_height = dims[2], input_width = dims[3];
 
-      upsampleBilinear(batch_size, num_channels, input_height, input_width,
+      upsampleBilinear(context, batch_size, num_channels, input_height, input_width,
                        scales[2], scales[3], X->template Data<T>(), Y->template MutableData<T>());
       return Status::OK();
     }
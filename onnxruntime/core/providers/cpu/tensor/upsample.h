@@ -62,8 +62,9 @@ class UpsampleBase {
 
     if (UpsampleMode::LINEAR == mode) {
       ORT_ENFORCE(scales.size() == 4, "Upsample: linear mode upsample only support bilinear with 4 dimension.");
-      ORT_ENFORCE(((scales[0] == 1) && (scales[1] == 1)),
-                  "Upsample: linear mode upsample only support bilinear, the first 2 scales should be 1.");
+      ORT_ENFORCE(((scales[0] == 1) && (scales[1] == 1 || scales[3] == 1)),
+                  "Upsample: linear mode upsample only support bilinear, the first 2 scales (NCHW) or the first and "
+                  "last scales (NHWC) should be 1.");
     }
   }
 
@@ -3,17 +3,19 @@
 
 #pragma once
 #include "gsl/gsl_algorithm"
+#include "core/framework/op_kernel.h"
 namespace onnxruntime {
 
 struct TensorPitches : std::vector<int64_t> {
   TensorPitches(const Tensor& tensor, size_t rank = 0) : TensorPitches(tensor.Shape(), rank) {}
   TensorPitches(const TensorShape& shape, size_t rank = 0) : TensorPitches(shape.GetDims(), rank) {}
-  TensorPitches(const std::vector<int64_t>& dims, size_t rank = 0)
+  TensorPitches(const std::vector<int64_t>& dims, size_t rank = 0) : TensorPitches(TensorDims(dims), rank) {}
+  TensorPitches(const TensorDims& dims, size_t rank = 0)
       : std::vector<int64_t>(std::max(rank, dims.size()), 0) {
     Calculate(gsl::span<int64_t>(data(), size()), dims);
   }
 
-  static bool Calculate(gsl::span<int64_t> p, const std::vector<int64_t>& dims) {
+  static bool Calculate(gsl::span<int64_t> p, const TensorDims& dims) {
     // The pitches is the size of the next inner axis. Aka the amount to move by one of the next inner axis.
     // For a tensor with shape(2,3,4,5) the values would be: (3*4*5, 4*5, 5, 1)
     // Note that the outermost '2' is never used, as you never need to move by the entire size of the outermost axis
@@ -189,6 +191,45 @@ struct SliceIterator {
   std::vector<int64_t> indices_;  // There is no index for innermost axis since it's a special case
 };
 
+// Copies are split into ranges of at least this many bytes that are copied in parallel
+constexpr int64_t kParallelCopyChunkBytes = 64 * 1024;
+
+// Copies block_count blocks of block_size elements, the ith from src + i * src_pitch to dst + i * dst_pitch. Large
+// copies are split into ranges that are copied in parallel on the intra-op pool of ctx, regardless of where the blocks
+// start and end, so a few large blocks are split as well as many small ones are shared out.
+template <typename T>
+void ParallelCopyBlocks(const OpKernelContext* ctx, T* dst, int64_t dst_pitch, const T* src, int64_t src_pitch,
+                        int64_t block_size, int64_t block_count) {
+  const int64_t total = block_size * block_count;
+  const int64_t chunk_size = std::max<int64_t>(1, kParallelCopyChunkBytes / static_cast<int64_t>(sizeof(T)));
+
+  ctx->ParallelFor(total, chunk_size, [&](int64_t first, int64_t last) {
+    int64_t block = first / block_size;
+    int64_t offset = first % block_size;
+    while (first < last) {
+      const int64_t count = std::min(block_size - offset, last - first);
+      const T* block_src = src + block * src_pitch + offset;
+      std::copy(block_src, block_src + count, dst + block * dst_pitch + offset);
+      first += count;
+      offset = 0;
+      block++;
+    }
+  });
+}
+
+// Repeats the block of size elements at data so that it's there repeats times, doubling the copied block with each
+// memcpy rather than copying the block once per repeat. Returns the end of the repeated blocks.
+template <typename T>
+T* RepeatBlock(T* data, int64_t size, int64_t repeats) {
+  const int64_t total = size * repeats;
+  for (int64_t copied = size; copied < total;) {
+    const int64_t count = std::min(copied, total - copied);
+    memcpy(data + copied, data, count * sizeof(T));
+    copied += count;
+  }
+  return data + total;
+}
+
 inline void CopyCpuTensor(const Tensor* src, Tensor* tgt) {
   void* target = tgt->MutableDataRaw();
   const void* source = src->DataRaw();
@@ -6,10 +6,10 @@
 namespace onnxruntime {
 namespace cuda {
 
-#define REGISTER_ACTIVATION_KERNEL(x, ver, T)                    \
+#define REGISTER_ACTIVATION_KERNEL_EX(x, domain, ver, T)         \
   ONNX_OPERATOR_TYPED_KERNEL_EX(                                 \
       x,                                                         \
-      kOnnxDomain,                                               \
+      domain,                                                    \
       ver,                                                       \
       T,                                                         \
       kCudaExecutionProvider,                                    \
@@ -18,6 +18,8 @@ namespace cuda {
           .MayInplace(0, 0),                                     \
       x<T>);
 
+#define REGISTER_ACTIVATION_KERNEL(x, ver, T) REGISTER_ACTIVATION_KERNEL_EX(x, kOnnxDomain, ver, T)
+
 #define UNARY_ACTIVATION_COMPUTE(x, T)                                                                     \
   template <>                                                                                              \
   Status x<T>::ComputeInternal(OpKernelContext* context) const {                                           \
@@ -27,6 +29,7 @@ namespace cuda {
     if (!std::is_same<CtxNull, Ctx##x>::value)                                                             \
       ORT_RETURN_IF_ERROR(func_ctx.CopyToGpu());                                                   \
     Impl_##x<typename ToCudaType<T>::MappedType>(                                                          \
+        Stream(),                                                                                          \
         reinterpret_cast<const typename ToCudaType<T>::MappedType*>(p.input_tensor->template Data<T>()),   \
         reinterpret_cast<typename ToCudaType<T>::MappedType*>(p.output_tensor->template MutableData<T>()), \
         func_ctx.GpuPtr(),                                                                                 \
@@ -58,5 +61,9 @@ UNARY_ACTIVATION_OP_HFD(Softsign, 1);
 UNARY_ACTIVATION_OP_HFD(Tanh, 6);
 UNARY_ACTIVATION_OP_HFD(ThresholdedRelu, 1);
 
+// contrib op, only in float like the CPU kernel the fusion relies on
+REGISTER_ACTIVATION_KERNEL_EX(Gelu, kMSDomain, 1, float)
+UNARY_ACTIVATION_COMPUTE(Gelu, float)
+
 }  // namespace cuda
 }  // namespace onnxruntime
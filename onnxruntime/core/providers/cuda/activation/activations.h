@@ -72,6 +72,17 @@ class Elu final : public UnaryElementwise {
   float alpha_;
 };
 
+template <typename T>
+class Gelu final : public UnaryElementwise {
+ public:
+  Gelu(const OpKernelInfo& info) : UnaryElementwise(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  MAKE_FUNC_CTX_NULL()
+};
+
 template <typename T>
 class HardSigmoid final : public UnaryElementwise {
  public:
@@ -23,6 +23,14 @@ struct OP_Elu : public CtxElu {
   }
 };
 
+template <typename T>
+struct OP_Gelu : public CtxGelu {
+  __device__ __inline__ T operator()(const T& a) const {
+    // 0.5 * x * (1 + erf(x / sqrt(2)))
+    return (T)0.5 * a * ((T)1 + _Erf(a * (T)0.70710678118654752f));
+  }
+};
+
 template <typename T>
 struct OP_HardSigmoid : public CtxHardSigmoid {
   __device__ __inline__ T operator()(const T& a) const {
@@ -108,14 +116,15 @@ struct OP_ThresholdedRelu : public CtxThresholdedRelu {
 
 #define UNARY_ACTIVATION_IMPL(name)                                        \
   UNARY_ACTIVATION_IMPL_DECLARATION(name) {                                \
-    UnaryElementWiseImpl(input_data,                                       \
+    UnaryElementWiseImpl(stream,                                           \
+                         input_data,                                       \
                          output_data,                                      \
                          *reinterpret_cast<const OP_##name<T>*>(func_ctx), \
                          count);                                           \
   }
 
 #define SPECIALIZED_UNARY_ACTIVATION_IMPL(name, T) \
-  template void Impl_##name<T>(const T* input_data, T* output_data, const Ctx##name* func_ctx, size_t count);
+  template void Impl_##name<T>(cudaStream_t stream, const T* input_data, T* output_data, const Ctx##name* func_ctx, size_t count);
 
 #define SPECIALIZED_UNARY_ACTIVATIONL_HFD(name)  \
   SPECIALIZED_UNARY_ACTIVATION_IMPL(name, half)  \
@@ -25,6 +25,7 @@ struct CtxNull {
 
 typedef CtxAlphaBeta CtxAffine;
 typedef CtxAlpha CtxElu;
+typedef CtxNull CtxGelu;
 typedef CtxAlphaBeta CtxHardSigmoid;
 typedef CtxAlpha CtxLeakyRelu;
 typedef CtxAlphaBeta CtxParametricSoftplus;
@@ -40,6 +41,7 @@ typedef CtxAlpha CtxThresholdedRelu;
 #define UNARY_ACTIVATION_OPS()                 \
   UNARY_ACTIVATION_OP_NAME(Affine)             \
   UNARY_ACTIVATION_OP_NAME(Elu)                \
+  UNARY_ACTIVATION_OP_NAME(Gelu)               \
   UNARY_ACTIVATION_OP_NAME(HardSigmoid)        \
   UNARY_ACTIVATION_OP_NAME(LeakyRelu)          \
   UNARY_ACTIVATION_OP_NAME(ParametricSoftplus) \
@@ -55,6 +57,7 @@ typedef CtxAlpha CtxThresholdedRelu;
 #define UNARY_ACTIVATION_IMPL_DECLARATION(name) \
   template <typename T>                         \
   void Impl_##name(                             \
+      cudaStream_t stream,                      \
       const T* input_data,                      \
       T* output_data,                           \
       const Ctx##name* func_ctx,                \
@@ -141,6 +141,18 @@ __device__ __inline__ double _Tanh(double a) { return tanh(a); }
 template <>
 __device__ __inline__ half _Tanh(half a) { return half(tanhf((float)a)); }
 
+template <typename T>
+__device__ __inline__ T _Erf(T a);
+
+template <>
+__device__ __inline__ float _Erf(float a) { return erff(a); }
+
+template <>
+__device__ __inline__ double _Erf(double a) { return erf(a); }
+
+template <>
+__device__ __inline__ half _Erf(half a) { return half(erff((float)a)); }
+
 template <typename T>
 __device__ __inline__ T _Pow(T a, T b);
 
@@ -0,0 +1,197 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+#include "common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+// the type the exponentials of T are summed in, float for half
+template <typename T>
+struct SoftmaxAccumulator {
+  typedef float type;
+};
+
+template <>
+struct SoftmaxAccumulator<double> {
+  typedef double type;
+};
+
+constexpr int kSoftmaxWarpSize = 32;
+// rows of up to this many elements are computed by a warp each, which holds the row in its registers
+constexpr int kSoftmaxMaxWarpRowSize = 1024;
+// the rows of a block of the warp kernel
+constexpr int kSoftmaxWarpsPerBlock = 4;
+// the threads of a row of the block kernel
+constexpr int kSoftmaxThreadsPerBlock = 256;
+
+// loads the elements of the rows of a tensor
+template <typename T, typename AccT>
+struct SoftmaxInput {
+  const T* input;
+  int64_t row_size;
+
+  __device__ __inline__ AccT operator()(int64_t row, int64_t i) const {
+    return static_cast<AccT>(input[row * row_size + i]);
+  }
+};
+
+template <typename AccT>
+__device__ __inline__ AccT WarpAllReduceMax(AccT value) {
+#pragma unroll
+  for (int offset = kSoftmaxWarpSize / 2; offset > 0; offset /= 2) {
+    const AccT other = __shfl_xor_sync(0xffffffff, value, offset);
+    value = other > value ? other : value;
+  }
+  return value;
+}
+
+template <typename AccT>
+__device__ __inline__ AccT WarpAllReduceSum(AccT value) {
+#pragma unroll
+  for (int offset = kSoftmaxWarpSize / 2; offset > 0; offset /= 2) {
+    value += __shfl_xor_sync(0xffffffff, value, offset);
+  }
+  return value;
+}
+
+// the maximum or the sum of value over the block, returned to every thread
+template <typename AccT, bool is_max>
+__device__ __inline__ AccT BlockAllReduce(AccT value, AccT* shared) {
+  value = is_max ? WarpAllReduceMax(value) : WarpAllReduceSum(value);
+  const int lane = threadIdx.x % kSoftmaxWarpSize;
+  const int warp = threadIdx.x / kSoftmaxWarpSize;
+  if (lane == 0) {
+    shared[warp] = value;
+  }
+  __syncthreads();
+
+  AccT result = shared[0];
+#pragma unroll
+  for (int i = 1; i < kSoftmaxThreadsPerBlock / kSoftmaxWarpSize; ++i) {
+    result = is_max ? (shared[i] > result ? shared[i] : result) : result + shared[i];
+  }
+  // shared is reused by the next reduction
+  __syncthreads();
+  return result;
+}
+
+// a warp per row of up to kElements * kSoftmaxWarpSize elements, which are read once into registers
+template <typename T, typename AccT, int kElements, bool is_log_softmax, typename Load>
+__global__ void _WarpSoftmaxKernel(Load load, T* output, int64_t row_count, int row_size) {
+  const int64_t row = static_cast<int64_t>(blockIdx.x) * kSoftmaxWarpsPerBlock + threadIdx.y;
+  if (row >= row_count) {
+    return;
+  }
+
+  AccT values[kElements];
+  AccT max_value = -INFINITY;
+#pragma unroll
+  for (int k = 0; k < kElements; ++k) {
+    const int i = threadIdx.x + k * kSoftmaxWarpSize;
+    values[k] = i < row_size ? load(row, i) : static_cast<AccT>(-INFINITY);
+    max_value = values[k] > max_value ? values[k] : max_value;
+  }
+  max_value = WarpAllReduceMax(max_value);
+
+  AccT sum = 0;
+#pragma unroll
+  for (int k = 0; k < kElements; ++k) {
+    if (threadIdx.x + k * kSoftmaxWarpSize < row_size) {
+      const AccT value = _Exp(values[k] - max_value);
+      sum += value;
+      if (!is_log_softmax) {
+        values[k] = value;
+      }
+    }
+  }
+  sum = WarpAllReduceSum(sum);
+
+  T* row_output = output + row * row_size;
+  const AccT offset = max_value + _Log(sum);
+  const AccT scale = 1 / sum;
+#pragma unroll
+  for (int k = 0; k < kElements; ++k) {
+    const int i = threadIdx.x + k * kSoftmaxWarpSize;
+    if (i < row_size) {
+      row_output[i] = static_cast<T>(is_log_softmax ? values[k] - offset : values[k] * scale);
+    }
+  }
+}
+
+// a block per row, which is read twice: for its maximum together with the sum of its exponentials, rescaled
+// whenever the maximum grows, and to write the output
+template <typename T, typename AccT, bool is_log_softmax, typename Load>
+__global__ void _BlockSoftmaxKernel(Load load, T* output, int64_t row_size) {
+  __shared__ AccT shared[kSoftmaxThreadsPerBlock / kSoftmaxWarpSize];
+  const int64_t row = blockIdx.x;
+
+  AccT max_value = -INFINITY;
+  AccT sum = 0;
+  for (int64_t i = threadIdx.x; i < row_size; i += kSoftmaxThreadsPerBlock) {
+    const AccT value = load(row, i);
+    if (value > max_value) {
+      sum = sum * _Exp(max_value - value) + 1;
+      max_value = value;
+    } else if (value > static_cast<AccT>(-INFINITY)) {
+      sum += _Exp(value - max_value);
+    }
+  }
+  const AccT row_max = BlockAllReduce<AccT, true>(max_value, shared);
+  const AccT row_sum = BlockAllReduce<AccT, false>(sum == 0 ? sum : sum * _Exp(max_value - row_max), shared);
+
+  T* row_output = output + row * row_size;
+  const AccT offset = row_max + _Log(row_sum);
+  const AccT scale = 1 / row_sum;
+  for (int64_t i = threadIdx.x; i < row_size; i += kSoftmaxThreadsPerBlock) {
+    const AccT value = load(row, i);
+    row_output[i] = static_cast<T>(is_log_softmax ? value - offset : _Exp(value - row_max) * scale);
+  }
+}
+
+#define LAUNCH_WARP_SOFTMAX_KERNEL(elements)                                                                  \
+  _WarpSoftmaxKernel<T, AccT, elements, is_log_softmax, Load><<<blocks, threads, 0, stream>>>(load, output, \
+                                                                                              row_count,    \
+                                                                                              size)
+
+// the softmax of each of the row_count rows of row_size elements load reads, written to output, which may be the
+// input load reads. short rows are computed by a warp each and long ones by a block each.
+template <typename T, bool is_log_softmax, typename Load>
+void DispatchSoftmax(cudaStream_t stream, const Load& load, T* output, int64_t row_count, int64_t row_size) {
+  typedef typename SoftmaxAccumulator<T>::type AccT;
+  if (row_count == 0 || row_size == 0) {
+    return;
+  }
+
+  if (row_size <= kSoftmaxMaxWarpRowSize) {
+    const dim3 threads(kSoftmaxWarpSize, kSoftmaxWarpsPerBlock);
+    const unsigned int blocks = static_cast<unsigned int>((row_count + kSoftmaxWarpsPerBlock - 1) /
+                                                          kSoftmaxWarpsPerBlock);
+    const int size = static_cast<int>(row_size);
+    if (size <= 32) {
+      LAUNCH_WARP_SOFTMAX_KERNEL(1);
+    } else if (size <= 64) {
+      LAUNCH_WARP_SOFTMAX_KERNEL(2);
+    } else if (size <= 128) {
+      LAUNCH_WARP_SOFTMAX_KERNEL(4);
+    } else if (size <= 256) {
+      LAUNCH_WARP_SOFTMAX_KERNEL(8);
+    } else if (size <= 512) {
+      LAUNCH_WARP_SOFTMAX_KERNEL(16);
+    } else {
+      LAUNCH_WARP_SOFTMAX_KERNEL(32);
+    }
+  } else {
+    _BlockSoftmaxKernel<T, AccT, is_log_softmax, Load><<<static_cast<unsigned int>(row_count),
+                                                         kSoftmaxThreadsPerBlock, 0, stream>>>(load, output,
+                                                                                               row_size);
+  }
+}
+
+#undef LAUNCH_WARP_SOFTMAX_KERNEL
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -89,7 +89,7 @@ class CudaKernel : public OpKernel {
     Status CopyToGpu() {
       if (cpu_pinned_copy_) {
         gpu_copy_ = op_kernel_->GetScratchBuffer<T>(count_);
-        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(gpu_copy_.get(), cpu_pinned_copy_.get(), count_ * sizeof(T), cudaMemcpyHostToDevice));
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(gpu_copy_.get(), cpu_pinned_copy_.get(), count_ * sizeof(T), cudaMemcpyHostToDevice, op_kernel_->Stream()));
         op_kernel_->AddDeferredReleaseCPUPtr(cpu_pinned_copy_.release());
       }
       return Status::OK();
@@ -127,6 +127,24 @@ class CudaKernel : public OpKernel {
     return provider_->PerThreadCudnnHandle();
   }
 
+  // the stream the kernel launches on, that of the compute queue of its node, which cuBLAS and cuDNN handles are
+  // bound to
+  inline cudaStream_t Stream() const {
+    return provider_->GetComputeStream();
+  }
+
+  inline int GetDeviceId() const {
+    return provider_->GetDeviceId();
+  }
+
+  inline CudnnConvAlgoSearch GetCudnnConvAlgoSearch() const {
+    return provider_->GetCudnnConvAlgoSearch();
+  }
+
+  inline size_t GetCudnnConvWorkspaceLimit() const {
+    return provider_->GetCudnnConvWorkspaceLimit();
+  }
+
   template <typename T>
   inline const T* GetConstOnes(size_t count) const {
     return provider_->template GetConstOnes<T>(count);
@@ -160,7 +178,7 @@ class ToCudaType<MLFloat16> {
   }
 };
 
-inline bool CalculateFdmStrides(gsl::span<fast_divmod> p, const std::vector<int64_t>& dims) {
+inline bool CalculateFdmStrides(gsl::span<fast_divmod> p, const TensorDims& dims) {
   int stride = 1;
   if (dims.empty() || p.size() < gsl::narrow_cast<ptrdiff_t>(dims.size()))
     return false;
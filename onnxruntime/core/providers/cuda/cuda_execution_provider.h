@@ -8,15 +8,45 @@
 #include "core/framework/allocatormgr.h"
 #include "core/framework/execution_provider.h"
 #include "shared_inc/cuda_utils.h"
+#include <atomic>
 #include <deque>
+#include <vector>
 
 namespace onnxruntime {
 
+// How Conv and ConvTranspose choose a cuDNN algorithm for a problem that is not in the algorithm cache.
+enum CudnnConvAlgoSearch : int {
+  kCudnnConvAlgoSearchExhaustive = 0,  // benchmark the algorithms with cudnnFind*AlgorithmEx
+  kCudnnConvAlgoSearchHeuristic,       // take the best algorithm suggested by cudnnGet*Algorithm_v7
+};
+
 // Information needed to construct CUDA execution providers.
 struct CUDAExecutionProviderInfo {
   int device_id{0};
+  // stream to run kernels on. when null the provider creates its own non-blocking stream.
+  // a caller supplied stream is not destroyed by the provider.
+  cudaStream_t compute_stream{nullptr};
+  // capture the kernels of a Run into a CUDA graph and replay it on later Runs with the same
+  // feeds and fetches. requires CUDA 10.1 or later.
+  bool enable_cuda_graph{false};
+  CudnnConvAlgoSearch cudnn_conv_algo_search{kCudnnConvAlgoSearchExhaustive};
+  // upper bound of the workspace the chosen convolution algorithms may use
+  size_t cudnn_conv_workspace_limit{32 * 1024 * 1024};
+  // when set, the process wide cuDNN algorithm cache is loaded from this file when the provider is created and
+  // written back to it when the provider is destroyed
+  std::string cudnn_conv_algo_cache_file;
+  // number of streams kernels run on: the compute stream, and streams the provider creates that the parallel
+  // executor spreads the independent branches of a graph over. only the compute stream is used if enable_cuda_graph.
+  int num_compute_streams{1};
+  // contexts of cuBLAS and cuDNN handles bound to the compute stream that the provider creates up front, which Runs
+  // check out without taking a lock. Runs beyond them share contexts created on demand.
+  int context_pool_size{0};
+  // Runs that may execute on the device at once. the others wait in OnRunStart in the order they arrive rather than
+  // oversubscribe the device. 0 for no limit.
+  int max_concurrent_runs{0};
 };
 
+// the queue ids of the streams of a provider. the streams of num_compute_streams other than the compute stream follow.
 enum CUDAStreamType : int {
   kCudaStreamDefault = 0,
   kCudaStreamCopyIn,
@@ -32,6 +62,8 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   AllocatorPtr GetAllocator(int id, OrtMemType mem_type = OrtMemTypeDefault) const override;
 
+  void ReplaceAllocator(AllocatorPtr allocator) override;
+
   std::string Type() const override {
     return onnxruntime::kCudaExecutionProvider;
   }
@@ -42,10 +74,35 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   Status OnRunEnd() override;
 
+  bool IsGraphCaptureEnabled() const override;
+
+  Status BeginGraphCapture() override;
+
+  Status EndGraphCapture() override;
+
+  Status ReplayGraph() override;
+
+  Status ReleaseGraph() override;
+
+  std::unique_ptr<IDeviceTimer> CreateDeviceTimer(int queue_id) const override;
+
+  std::vector<int> GetComputeQueueIds() const override {
+    return compute_queue_ids_;
+  }
+
+  void SetComputeQueue(int queue_id) const override {
+    current_compute_queue_ = queue_id;
+  }
+
   Status CopyTensor(const Tensor& src, Tensor& dst) const override;
 
   Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const override;
 
+  Status CopyTensors(const std::vector<const Tensor*>& src, const std::vector<Tensor*>& dst,
+                     int exec_queue_id) const override;
+
+  Status CopyTensorFromHostAsync(const Tensor& src, Tensor& dst, IFence& dst_fence) const override;
+
   const void* GetExecutionHandle() const noexcept override {
     // The CUDA interface does not return anything interesting.
     return nullptr;
@@ -54,7 +111,8 @@ class CUDAExecutionProvider : public IExecutionProvider {
   cublasHandle_t PerThreadCublasHandle() {
     // Assure each thread has its TLS context.
     if (!per_thread_context_)
-      per_thread_context_ = std::make_shared<PerThreadContext>(device_id_);
+      per_thread_context_ = std::make_shared<PerThreadContext>(device_id_, streams_[kCudaStreamDefault]);
+    per_thread_context_->SetStream(GetComputeStream());
     return per_thread_context_->CublasHandle();
   }
 
@@ -62,20 +120,42 @@ class CUDAExecutionProvider : public IExecutionProvider {
     // Assure each thread has its TLS context.
     // TODO: improve its performance when calling cuda functions from multiple threads.
     if (!per_thread_context_)
-      per_thread_context_ = std::make_shared<PerThreadContext>(device_id_);
+      per_thread_context_ = std::make_shared<PerThreadContext>(device_id_, streams_[kCudaStreamDefault]);
+    per_thread_context_->SetStream(GetComputeStream());
     return per_thread_context_->CudnnHandle();
   }
 
+  CudnnConvAlgoSearch GetCudnnConvAlgoSearch() const {
+    return cudnn_conv_algo_search_;
+  }
+
+  size_t GetCudnnConvWorkspaceLimit() const {
+    return cudnn_conv_workspace_limit_;
+  }
+
+  int GetDeviceId() const {
+    return device_id_;
+  }
+
   cudaStream_t GetStream(int queue_id) const {
-    ORT_ENFORCE(queue_id >= 0 && queue_id < kTotalCudaStreams);
+    ORT_ENFORCE(queue_id >= 0 && queue_id < GetStreamCount());
     return streams_[queue_id];
   }
 
+  int GetStreamCount() const {
+    return static_cast<int>(streams_.size());
+  }
+
+  // the stream the kernel running on this thread launches on, that of the compute queue of its node
+  cudaStream_t GetComputeStream() const {
+    return streams_[current_compute_queue_];
+  }
+
   template <typename T>
   const T* GetConstOnes(size_t count) {
     // Assure each thread has its TLS context.
     if (!per_thread_context_)
-      per_thread_context_ = std::make_shared<PerThreadContext>(device_id_);
+      per_thread_context_ = std::make_shared<PerThreadContext>(device_id_, streams_[kCudaStreamDefault]);
     return per_thread_context_->template GetConstOnes<T>(count);
   }
 
@@ -95,9 +175,33 @@ class CUDAExecutionProvider : public IExecutionProvider {
   GetCapability(const onnxruntime::GraphViewer& graph,
                 const std::vector<const KernelRegistry*>& kernel_registries) const override;
  private:
-  cudaStream_t streams_[kTotalCudaStreams];
+  // indexed by queue id
+  std::vector<cudaStream_t> streams_;
+  // the queues of the compute streams, and the streams, the compute stream first
+  std::vector<int> compute_queue_ids_;
+  std::vector<cudaStream_t> compute_streams_;
+  // recorded on the copy-in stream at OnRunEnd so that the deferred release event covers staged input copies
+  cudaEvent_t copy_in_done_event_;
+  // recorded on the compute streams other than the compute stream at OnRunEnd, for the same
+  std::vector<cudaEvent_t> compute_done_events_;
+  bool owns_compute_stream_;
   int device_id_;
 
+  CudnnConvAlgoSearch cudnn_conv_algo_search_;
+  size_t cudnn_conv_workspace_limit_;
+  std::string cudnn_conv_algo_cache_file_;
+
+  // instantiated graph captured on the compute stream, the pinned CPU buffers its memcpy nodes read from, and the
+  // arena that holds the device buffers its kernels use. the buffers are released together with the graph instead
+  // of at OnRunEnd or when the capture Run frees them, as every replay uses the same addresses.
+  bool enable_cuda_graph_;
+  bool is_capturing_graph_ = false;
+#if CUDART_VERSION >= 10010
+  cudaGraphExec_t graph_exec_ = nullptr;
+#endif
+  std::vector<void*> graph_cpu_ptrs_;
+  AllocatorPtr graph_allocator_;
+
   struct DeferredReleaseCPUPtrs {
     bool recorded = false;
     std::vector<void*> cpu_ptrs;
@@ -107,7 +211,7 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   class PerThreadContext final {
    public:
-    PerThreadContext(int device_id);
+    PerThreadContext(int device_id, cudaStream_t stream);
     ~PerThreadContext();
 
     cublasHandle_t CublasHandle() const {
@@ -118,6 +222,13 @@ class CUDAExecutionProvider : public IExecutionProvider {
       return cudnn_handle_;
     }
 
+    // binds the handles to stream
+    void SetStream(cudaStream_t stream) {
+      if (stream != stream_) {
+        BindStream(stream);
+      }
+    }
+
     cudaEvent_t& GetCurrentDeferredReleaseEvent() {
       return current_deferred_release_event_;
     }
@@ -145,8 +256,11 @@ class CUDAExecutionProvider : public IExecutionProvider {
     }
 
    private:
+    void BindStream(cudaStream_t stream);
+
     cublasHandle_t cublas_handle_ = nullptr;
     cudnnHandle_t cudnn_handle_ = nullptr;
+    cudaStream_t stream_;
 
     // deferred release for temporary CPU pinned memory used in cudaMemcpyAsync
     // note that cudaEvent will be assigned at OnRunEnd() when PerThreadContext destory
@@ -164,6 +278,12 @@ class CUDAExecutionProvider : public IExecutionProvider {
   // thread local GPU memory allocator. could be used before execution
   static thread_local AllocatorPtr per_thread_default_allocator_;
 
+  // the compute queue of the node the thread runs, see SetComputeQueue
+  static thread_local int current_compute_queue_;
+
+  // the GPU memory allocator of the application, which the threads share in place of their own
+  AllocatorPtr replaced_default_allocator_;
+
   // reuse thread local GPU memory allocator for memory pattern
   mutable std::deque<AllocatorPtr> default_allocator_pool_;
   mutable OrtMutex default_allocator_pool_mutex_;
@@ -172,8 +292,40 @@ class CUDAExecutionProvider : public IExecutionProvider {
   mutable std::deque<std::shared_ptr<PerThreadContext>> context_pool_;
   mutable OrtMutex context_pool_mutex_;
 
+  // the contexts of context_pool_size, and whether each is checked out by a Run
+  std::vector<std::shared_ptr<PerThreadContext>> preallocated_contexts_;
+  std::unique_ptr<std::atomic<bool>[]> preallocated_context_in_use_;
+  // the index in preallocated_contexts_ of the context of the thread, or -1
+  static thread_local int per_thread_context_slot_;
+
+  // the Runs of max_concurrent_runs take a ticket in OnRunStart and start once fewer than max_concurrent_runs_ of
+  // the Runs with an earlier ticket are still running
+  int max_concurrent_runs_;
+  OrtMutex run_admission_mutex_;
+  OrtCondVar run_admission_cv_;
+  uint64_t next_run_ticket_ = 0;  // GUARDED_BY(run_admission_mutex_)
+  uint64_t finished_runs_ = 0;    // GUARDED_BY(run_admission_mutex_)
+  // whether the Run on the thread holds one of the max_concurrent_runs_
+  static thread_local bool per_thread_run_admitted_;
+
+  // makes one of the preallocated contexts the context of the thread, if one is free
+  bool CheckOutPreallocatedContext() const;
+
   void ReleasePerThreadStuffs() const;
 
+  // makes the compute stream wait for the work queued on the other compute streams so far
+  Status JoinComputeStreams() const;
+
+  // the arena of the device memory, stream ordered with the compute stream
+  AllocatorPtr CreateDefaultAllocator() const;
+
+  // makes the arenas of the device memory wait for the streams before they're destroyed
+  void ReleaseAllocatorStreams();
+
+  // records the use of the device memory p by a copy queued on the stream of exec_queue_id, so that the memory
+  // isn't reused until the copy is done
+  void RecordCopyStream(const void* p, int exec_queue_id) const;
+
   bool RNNNeedFallbackToCPU(const onnxruntime::Node& node, const std::vector<std::string> activations_supported, const std::string& op_type) const;
   bool ConvNeedFallbackToCPU(const onnxruntime::Node& node) const;
 };
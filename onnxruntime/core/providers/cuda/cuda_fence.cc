@@ -6,23 +6,35 @@
 
 namespace onnxruntime {
 
-CUDAFence::CUDAFence(const CUDAExecutionProvider* provider) : provider_(provider) {
-  // NOTE: cudaEventBlockingSync may leads to longer wait time because of thread yield/switching in kernel
-  // if lower CPU usage is more important than latency, we should use this flag to avoid spin-loop in WaitOnCPU
-  int event_flags = /*cudaEventBlockingSync |*/ cudaEventDisableTiming;
-  CUDA_CALL_THROW(cudaEventCreate(&read_event_, event_flags));
-  CUDA_CALL_THROW(cudaEventCreate(&write_event_, event_flags));
+namespace {
+// NOTE: cudaEventBlockingSync may leads to longer wait time because of thread yield/switching in kernel
+// if lower CPU usage is more important than latency, we should use this flag to avoid spin-loop in WaitOnCPU
+constexpr int kEventFlags = /*cudaEventBlockingSync |*/ cudaEventDisableTiming;
+}  // namespace
+
+CUDAFence::CUDAFence(const CUDAExecutionProvider* provider)
+    : read_events_(provider->GetStreamCount(), nullptr), provider_(provider) {
+  CUDA_CALL_THROW(cudaEventCreateWithFlags(&write_event_, kEventFlags));
 }
 
 CUDAFence::~CUDAFence() {
-  CUDA_CALL_THROW(cudaEventDestroy(read_event_));
+  for (auto event : read_events_) {
+    if (event != nullptr) {
+      CUDA_CALL_THROW(cudaEventDestroy(event));
+    }
+  }
   CUDA_CALL_THROW(cudaEventDestroy(write_event_));
 }
 
 void CUDAFence::BeforeUsingAsInput(onnxruntime::ProviderType provider_type, int async_queue_id) {
+  if (write_queue_id_ < 0) {
+    return;
+  }
   if (provider_type == onnxruntime::kCudaExecutionProvider) {
     // sync in GPU, the call is non-blocking on CPU
-    CUDA_CALL_THROW(cudaStreamWaitEvent(provider_->GetStream(async_queue_id), write_event_, 0));
+    if (write_queue_id_ != async_queue_id) {
+      CUDA_CALL_THROW(cudaStreamWaitEvent(provider_->GetStream(async_queue_id), write_event_, 0));
+    }
   } else {
     // sync on CPU for all other providers, this is blocking
     CUDA_CALL_THROW(cudaEventSynchronize(write_event_));
@@ -33,25 +45,42 @@ void CUDAFence::BeforeUsingAsOutput(onnxruntime::ProviderType provider_type, int
   if (provider_type == onnxruntime::kCudaExecutionProvider) {
     // sync in GPU, the call is non-blocking on CPU
     cudaStream_t stream = provider_->GetStream(queue_id);
-    CUDA_CALL_THROW(cudaStreamWaitEvent(stream, read_event_, 0));
-    CUDA_CALL_THROW(cudaStreamWaitEvent(stream, write_event_, 0));
+    for (int read_queue_id = 0, end = static_cast<int>(read_events_.size()); read_queue_id < end; ++read_queue_id) {
+      if (read_events_[read_queue_id] != nullptr && read_queue_id != queue_id) {
+        CUDA_CALL_THROW(cudaStreamWaitEvent(stream, read_events_[read_queue_id], 0));
+      }
+    }
+    if (write_queue_id_ >= 0 && write_queue_id_ != queue_id) {
+      CUDA_CALL_THROW(cudaStreamWaitEvent(stream, write_event_, 0));
+    }
   } else {
     // sync on CPU for all other providers, this is blocking
-    CUDA_CALL_THROW(cudaEventSynchronize(read_event_));
-    CUDA_CALL_THROW(cudaEventSynchronize(write_event_));
+    for (auto event : read_events_) {
+      if (event != nullptr) {
+        CUDA_CALL_THROW(cudaEventSynchronize(event));
+      }
+    }
+    if (write_queue_id_ >= 0) {
+      CUDA_CALL_THROW(cudaEventSynchronize(write_event_));
+    }
   }
 }
 
 void CUDAFence::AfterUsedAsInput(int queue_id) {
-  // update read fence
+  // update read fence of the queue
   cudaStream_t stream = provider_->GetStream(queue_id);
-  CUDA_CALL_THROW(cudaEventRecord(read_event_, stream));
+  auto& read_event = read_events_[queue_id];
+  if (read_event == nullptr) {
+    CUDA_CALL_THROW(cudaEventCreateWithFlags(&read_event, kEventFlags));
+  }
+  CUDA_CALL_THROW(cudaEventRecord(read_event, stream));
 }
 
 void CUDAFence::AfterUsedAsOutput(int queue_id) {
   // update write fence
   cudaStream_t stream = provider_->GetStream(queue_id);
   CUDA_CALL_THROW(cudaEventRecord(write_event_, stream));
+  write_queue_id_ = queue_id;
 }
 
 }  // namespace onnxruntime
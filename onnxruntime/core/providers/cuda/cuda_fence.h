@@ -6,6 +6,8 @@
 #include "cuda_execution_provider.h"
 namespace onnxruntime {
 
+// Orders the uses of a value on the streams of a provider. A use waits for the events of the uses it depends on
+// only if they were queued on another stream, as the work queued on a single stream runs in order.
 class CUDAFence : public IFence {
  public:
   CUDAFence(const CUDAExecutionProvider* provider);
@@ -16,8 +18,12 @@ class CUDAFence : public IFence {
   virtual void AfterUsedAsOutput(int queue_id) override;
 
  private:
-  cudaEvent_t read_event_;
+  // indexed by queue id: the event recorded after the last read on the queue, or null if there was none. a value is
+  // read by nodes that may run concurrently, on different queues, so a write waits for each of them.
+  std::vector<cudaEvent_t> read_events_;
   cudaEvent_t write_event_;
+  // the queue of the last write, or -1 if there was none
+  int write_queue_id_ = -1;
   const CUDAExecutionProvider* provider_;
 };
 
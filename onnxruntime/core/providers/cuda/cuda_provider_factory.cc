@@ -11,23 +11,34 @@ using namespace onnxruntime;
 namespace onnxruntime {
 
 struct CUDAProviderFactory : IExecutionProviderFactory {
-  CUDAProviderFactory(int device_id) : device_id_(device_id) {}
+  CUDAProviderFactory(const CUDAExecutionProviderInfo& info) : info_(info) {}
   ~CUDAProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
-  int device_id_;
+  CUDAExecutionProviderInfo info_;
 };
 
 std::unique_ptr<IExecutionProvider> CUDAProviderFactory::CreateProvider() {
-  CUDAExecutionProviderInfo info;
-  info.device_id = device_id_;
-  return std::make_unique<CUDAExecutionProvider>(info);
+  return std::make_unique<CUDAExecutionProvider>(info_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(const CUDAExecutionProviderInfo& info) {
+  return std::make_shared<onnxruntime::CUDAProviderFactory>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id) {
-  return std::make_shared<onnxruntime::CUDAProviderFactory>(device_id);
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  return CreateExecutionProviderFactory_CUDA(info);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id, cudaStream_t compute_stream) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.compute_stream = compute_stream;
+  return CreateExecutionProviderFactory_CUDA(info);
 }
 
 }  // namespace onnxruntime
@@ -36,3 +47,41 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessi
   options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(device_id));
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProviderWithStream_CUDA, _In_ OrtSessionOptions* options, int device_id, _In_opt_ void* compute_stream) {
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(device_id, static_cast<cudaStream_t>(compute_stream)));
+  return nullptr;
+}
+
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProviderWithGraphCapture_CUDA, _In_ OrtSessionOptions* options, int device_id, _In_opt_ void* compute_stream) {
+  onnxruntime::CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.compute_stream = static_cast<cudaStream_t>(compute_stream);
+  info.enable_cuda_graph = true;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProviderWithComputeStreams_CUDA, _In_ OrtSessionOptions* options, int device_id, int num_compute_streams) {
+  if (num_compute_streams < 1) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "num_compute_streams must be at least 1");
+  }
+  onnxruntime::CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.num_compute_streams = num_compute_streams;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProviderWithContextPool_CUDA, _In_ OrtSessionOptions* options, int device_id, int context_pool_size, int max_concurrent_runs) {
+  if (context_pool_size < 0 || max_concurrent_runs < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "context_pool_size and max_concurrent_runs must not be negative");
+  }
+  onnxruntime::CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.context_pool_size = context_pool_size;
+  info.max_concurrent_runs = max_concurrent_runs;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
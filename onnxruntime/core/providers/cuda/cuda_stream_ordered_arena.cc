@@ -0,0 +1,221 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "cuda_stream_ordered_arena.h"
+
+#include <algorithm>
+
+#include "shared_inc/cuda_call.h"
+
+namespace onnxruntime {
+
+CUDAStreamOrderedArena::CUDAStreamOrderedArena(ArenaPtr arena, const void* owner, std::vector<cudaStream_t> streams,
+                                               bool exclusive)
+    : arena_(std::move(arena)), owner_(owner), exclusive_(exclusive), streams_(std::move(streams)) {
+  ORT_ENFORCE(arena_ != nullptr && !streams_.empty());
+}
+
+CUDAStreamOrderedArena::~CUDAStreamOrderedArena() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  CompletePendingFrees(true);
+  for (auto event : free_events_) {
+    CUDA_CALL(cudaEventDestroy(event));
+  }
+}
+
+void* CUDAStreamOrderedArena::Track(void* p, size_t size) {
+  if (p != nullptr) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    allocations_[static_cast<char*>(p)] = Allocation{size, {}};
+  }
+  return p;
+}
+
+void* CUDAStreamOrderedArena::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  bool has_pending_frees;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    CompletePendingFrees(false);
+    has_pending_frees = !pending_frees_.empty();
+  }
+
+  void* p = nullptr;
+  try {
+    p = arena_->Alloc(size);
+  } catch (const OnnxRuntimeException&) {
+    if (!has_pending_frees) {
+      throw;
+    }
+  }
+
+  // the memory still in use by the streams may be enough once they're done with it
+  if (p == nullptr && has_pending_frees) {
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      CompletePendingFrees(true);
+    }
+    p = arena_->Alloc(size);
+  }
+  return Track(p, size);
+}
+
+void* CUDAStreamOrderedArena::Reserve(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+  return Track(arena_->Reserve(size), size);
+}
+
+void CUDAStreamOrderedArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = allocations_.find(static_cast<char*>(p));
+    ORT_ENFORCE(it != allocations_.end(), "The memory wasn't allocated by this arena.");
+    if (holding_thread_ == std::this_thread::get_id()) {
+      held_frees_.push_back(p);
+      return;
+    }
+    std::vector<cudaStream_t> streams = std::move(it->second.streams);
+    allocations_.erase(it);
+
+    if (!streams_released_ && (!exclusive_ || streams_.size() > 1 || !streams.empty())) {
+      PendingFree pending{p, {}};
+      streams.insert(streams.end(), streams_.begin(), streams_.end());
+      for (auto stream : streams) {
+        cudaEvent_t event = AcquireEvent();
+        CUDA_CALL_THROW(cudaEventRecord(event, stream));
+        pending.events.push_back(event);
+      }
+      pending_frees_.push_back(std::move(pending));
+      return;
+    }
+  }
+
+  arena_->Free(p);
+}
+
+bool CUDAStreamOrderedArena::RecordStream(const void* p, cudaStream_t stream) {
+  if (p == nullptr) {
+    return false;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  // the allocation that starts at or before p
+  auto it = allocations_.upper_bound(static_cast<char*>(const_cast<void*>(p)));
+  if (it == allocations_.begin()) {
+    return false;
+  }
+  --it;
+  if (static_cast<const char*>(p) >= it->first + it->second.size) {
+    return false;
+  }
+  auto& streams = it->second.streams;
+  if (std::find(streams_.begin(), streams_.end(), stream) == streams_.end() &&
+      std::find(streams.begin(), streams.end(), stream) == streams.end()) {
+    streams.push_back(stream);
+  }
+  return true;
+}
+
+void CUDAStreamOrderedArena::SetStreams(const void* owner, const std::vector<cudaStream_t>& streams) {
+  if (owner_ == owner) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (!streams_released_) {
+    // the event can be recorded again as soon as the waits for it are queued
+    cudaEvent_t event = AcquireEvent();
+    for (auto previous : streams_) {
+      CUDA_CALL_THROW(cudaEventRecord(event, previous));
+      for (auto stream : streams) {
+        CUDA_CALL_THROW(cudaStreamWaitEvent(stream, event, 0));
+      }
+    }
+    free_events_.push_back(event);
+  }
+  streams_released_ = false;
+  streams_ = streams;
+  owner_ = owner;
+}
+
+void CUDAStreamOrderedArena::HoldFrees() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  holding_thread_ = std::this_thread::get_id();
+}
+
+void CUDAStreamOrderedArena::StopHoldingFrees() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  holding_thread_ = std::thread::id();
+}
+
+void CUDAStreamOrderedArena::ReleaseHeldFrees() {
+  std::vector<void*> held;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    holding_thread_ = std::thread::id();
+    held.swap(held_frees_);
+  }
+  for (auto p : held) {
+    Free(p);
+  }
+}
+
+void CUDAStreamOrderedArena::ReleaseStreams() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  CompletePendingFrees(true);
+  streams_released_ = true;
+  for (auto& allocation : allocations_) {
+    allocation.second.streams.clear();
+  }
+}
+
+common::Status CUDAStreamOrderedArena::Shrink() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    CompletePendingFrees(true);
+  }
+  return arena_->Shrink();
+}
+
+void CUDAStreamOrderedArena::CompletePendingFrees(bool wait) {
+  // the frees still pending first
+  auto completed = std::stable_partition(pending_frees_.begin(), pending_frees_.end(),
+                                         [wait](const PendingFree& pending) {
+                                           for (auto event : pending.events) {
+                                             if (wait) {
+                                               CUDA_CALL(cudaEventSynchronize(event));
+                                             } else if (cudaEventQuery(event) != cudaSuccess) {
+                                               return true;
+                                             }
+                                           }
+                                           return false;
+                                         });
+
+  for (auto it = completed; it != pending_frees_.end(); ++it) {
+    arena_->Free(it->p);
+    free_events_.insert(free_events_.end(), it->events.begin(), it->events.end());
+  }
+  pending_frees_.erase(completed, pending_frees_.end());
+}
+
+cudaEvent_t CUDAStreamOrderedArena::AcquireEvent() {
+  if (free_events_.empty()) {
+    cudaEvent_t event;
+    CUDA_CALL_THROW(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    return event;
+  }
+  cudaEvent_t event = free_events_.back();
+  free_events_.pop_back();
+  return event;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "cuda_pch.h"
+#include "core/common/common.h"
+#include "core/framework/arena.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+  * An arena of the device memory of a CUDA execution provider that orders the reuse of the memory freed to it with
+  * the work on its streams, the compute streams of the provider, as cudaFreeAsync does.
+  *
+  * The memory freed to it is tagged with the streams that used it: its streams, and the streams RecordStream was
+  * called with for it, e.g. the copy streams. Memory goes back to the arena right away if the arena is exclusive to
+  * its only stream and no other stream used it, as the next work the memory is allocated for is queued after that
+  * use on the same stream. Otherwise an event is recorded on each of the streams, and the memory goes back to the
+  * arena once they've all completed, without blocking the host, so that another stream or another session sharing
+  * the arena doesn't write to the memory while it's still in use.
+  */
+class CUDAStreamOrderedArena : public IArenaAllocator {
+ public:
+  // exclusive is true if no stream other than streams allocates from arena. owner identifies the provider the
+  // streams are of.
+  CUDAStreamOrderedArena(ArenaPtr arena, const void* owner, std::vector<cudaStream_t> streams, bool exclusive);
+  ~CUDAStreamOrderedArena() override;
+
+  void* Alloc(size_t size) override;
+  void* Reserve(size_t size) override;
+  void Free(void* p) override;
+
+  // records that work queued on stream uses the allocation p points into. false if p isn't in an allocation of the
+  // arena.
+  bool RecordStream(const void* p, cudaStream_t stream);
+
+  // makes streams the streams of the arena, for a provider that takes over the arena of another. the work queued on
+  // them from then on waits for the work queued on the previous streams, which may still use the memory freed to
+  // the arena.
+  void SetStreams(const void* owner, const std::vector<cudaStream_t>& streams);
+
+  // keeps the memory the calling thread frees to the arena allocated until ReleaseHeldFrees, for the buffers that a
+  // CUDA graph captured on the streams refers to, which every replay of the graph uses again
+  void HoldFrees();
+
+  // stops holding the memory freed to the arena. what was held stays allocated until ReleaseHeldFrees.
+  void StopHoldingFrees();
+
+  // frees the memory held since HoldFrees, once the graph that uses it is destroyed
+  void ReleaseHeldFrees();
+
+  // waits for the streams to finish using the memory freed to the arena and lets it go back to the arena right
+  // away from then on, for when the provider destroys its streams
+  void ReleaseStreams();
+
+  size_t Used() const override { return arena_->Used(); }
+  size_t Max() const override { return arena_->Max(); }
+  common::Status Shrink() override;
+  void GetStats(AllocatorStats* stats) override { arena_->GetStats(stats); }
+
+  const OrtAllocatorInfo& Info() const override { return arena_->Info(); }
+
+  FencePtr CreateFence(const SessionState* session_state) override {
+    return arena_->CreateFence(session_state);
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CUDAStreamOrderedArena);
+
+  struct Allocation {
+    size_t size;
+    // the streams other than streams_ that used it
+    std::vector<cudaStream_t> streams;
+  };
+
+  // memory freed to the arena that is still in use by the streams the events were recorded on
+  struct PendingFree {
+    void* p;
+    std::vector<cudaEvent_t> events;
+  };
+
+  void* Track(void* p, size_t size);
+
+  // returns the pending frees whose events have completed to the arena, or all of them if wait. requires mutex_.
+  void CompletePendingFrees(bool wait);
+
+  cudaEvent_t AcquireEvent();
+
+  const ArenaPtr arena_;
+  std::atomic<const void*> owner_;
+  const bool exclusive_;
+
+  OrtMutex mutex_;
+  std::vector<cudaStream_t> streams_;              // GUARDED_BY(mutex_)
+  std::map<char*, Allocation> allocations_;       // GUARDED_BY(mutex_)
+  std::vector<PendingFree> pending_frees_;         // GUARDED_BY(mutex_)
+  std::vector<cudaEvent_t> free_events_;           // GUARDED_BY(mutex_)
+  bool streams_released_ = false;                  // GUARDED_BY(mutex_)
+  std::thread::id holding_thread_;                 // GUARDED_BY(mutex_)
+  std::vector<void*> held_frees_;                  // GUARDED_BY(mutex_)
+};
+
+}  // namespace onnxruntime
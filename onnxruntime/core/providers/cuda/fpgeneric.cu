@@ -113,22 +113,34 @@ __global__ void CopyVectorHalf(const half* x, int incx, half* y, int incy, int n
 
 }  // namespace
 
-cublasStatus_t cublasTransposeHelper(cublasHandle_t, cublasOperation_t, cublasOperation_t, int m, int n, half*, half* A, int, half*, half*, int, half* C, int) {
+cublasStatus_t cublasTransposeHelper(cublasHandle_t handle, cublasOperation_t, cublasOperation_t, int m, int n, half*, half* A, int, half*, half*, int, half* C, int) {
   if (C != A) {
+    // launch on the stream the cuBLAS handle is bound to
+    cudaStream_t stream;
+    cublasStatus_t status = cublasGetStream(handle, &stream);
+    if (status != CUBLAS_STATUS_SUCCESS)
+      return status;
+
     dim3 dimGrid((n + TRANS_TILE_DIM - 1) / TRANS_TILE_DIM, (m + TRANS_TILE_DIM - 1) / TRANS_TILE_DIM, 1);
     dim3 dimBlock(TRANS_TILE_DIM, BLOCK_ROWS, 1);
 
-    transposeNoOverlap<<<dimGrid, dimBlock>>>(C, A, n, m);
+    transposeNoOverlap<<<dimGrid, dimBlock, 0, stream>>>(C, A, n, m);
   } else {
     return CUBLAS_STATUS_NOT_SUPPORTED;
   }
   return CUBLAS_STATUS_SUCCESS;
 }
 
-cublasStatus_t cublasCopyHelper(cublasHandle_t, int n, const half* x, int incx, half* y, int incy) {
+cublasStatus_t cublasCopyHelper(cublasHandle_t handle, int n, const half* x, int incx, half* y, int incy) {
+  // launch on the stream the cuBLAS handle is bound to
+  cudaStream_t stream;
+  cublasStatus_t status = cublasGetStream(handle, &stream);
+  if (status != CUBLAS_STATUS_SUCCESS)
+    return status;
+
   dim3 dimGrid((unsigned int)(n + COPY_BLOCK_DIM - 1) / COPY_BLOCK_DIM, 1, 1);
   dim3 dimBlock(COPY_BLOCK_DIM, 1, 1);
-  CopyVectorHalf<<<dimGrid, dimBlock>>>(x, incx, y, incy, n);
+  CopyVectorHalf<<<dimGrid, dimBlock, 0, stream>>>(x, incx, y, incy, n);
   return CUBLAS_STATUS_SUCCESS;
 }
 
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/attention.h"
+#include "core/providers/cuda/math/attention_impl.h"
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      Attention,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      Attention<T>);
+
+REGISTER_KERNEL_TYPED(float)
+
+template <typename T>
+Status Attention<T>::MatMul(const MatMulComputeHelper& helper, float alpha, const CudaT* left, const CudaT* right,
+                            CudaT* output) const {
+  CudaT cuda_alpha = ToCudaType<T>::FromFloat(alpha);
+  CudaT zero = ToCudaType<T>::FromFloat(0.0f);
+
+  // note that onnxruntime MLValue is row major, while cublas is column major,
+  // so swap left/right operands
+  if (helper.OutputOffsets().size() == 1) {
+    CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
+        CublasHandle(),
+        CUBLAS_OP_N,
+        CUBLAS_OP_N,
+        static_cast<int>(helper.N()),
+        static_cast<int>(helper.M()),
+        static_cast<int>(helper.K()),
+        &cuda_alpha,
+        right,
+        static_cast<int>(helper.N()),
+        left,
+        static_cast<int>(helper.K()),
+        &zero,
+        output,
+        static_cast<int>(helper.N())));
+    return Status::OK();
+  }
+
+  int device_id = 0;
+  CudaAsyncBuffer<const CudaT*> left_arrays(this, device_id, helper.LeftOffsets().size());
+  CudaAsyncBuffer<const CudaT*> right_arrays(this, device_id, helper.RightOffsets().size());
+  CudaAsyncBuffer<CudaT*> output_arrays(this, device_id, helper.OutputOffsets().size());
+  MatMulComputeHelper::OffsetToArrays(left, helper.LeftOffsets(), left_arrays.CpuSpan());
+  MatMulComputeHelper::OffsetToArrays(right, helper.RightOffsets(), right_arrays.CpuSpan());
+  MatMulComputeHelper::OffsetToArrays(output, helper.OutputOffsets(), output_arrays.CpuSpan());
+  ORT_RETURN_IF_ERROR(left_arrays.CopyToGpu());
+  ORT_RETURN_IF_ERROR(right_arrays.CopyToGpu());
+  ORT_RETURN_IF_ERROR(output_arrays.CopyToGpu());
+
+  CUBLAS_RETURN_IF_ERROR(cublasGemmBatchedHelper(
+      CublasHandle(),
+      CUBLAS_OP_N,
+      CUBLAS_OP_N,
+      static_cast<int>(helper.N()),
+      static_cast<int>(helper.M()),
+      static_cast<int>(helper.K()),
+      &cuda_alpha,
+      right_arrays.GpuPtr(),
+      static_cast<int>(helper.N()),
+      left_arrays.GpuPtr(),
+      static_cast<int>(helper.K()),
+      &zero,
+      output_arrays.GpuPtr(),
+      static_cast<int>(helper.N()),
+      static_cast<int>(helper.OutputOffsets().size())));
+  return Status::OK();
+}
+
+template <typename T>
+Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* Q = context->Input<Tensor>(0);
+  const Tensor* K_transposed = context->Input<Tensor>(1);
+  const Tensor* V = context->Input<Tensor>(2);
+  const Tensor* mask = context->Input<Tensor>(3);
+
+  if (Q->Shape().NumDimensions() < 2 || K_transposed->Shape().NumDimensions() < 2 ||
+      V->Shape().NumDimensions() < 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Attention inputs must have at least 2 dimensions");
+  }
+
+  MatMulComputeHelper scores_helper;
+  ORT_RETURN_IF_ERROR(scores_helper.Compute(Q->Shape(), K_transposed->Shape()));
+  const TensorShape& scores_shape = scores_helper.OutputShape();
+  MatMulComputeHelper output_helper;
+  ORT_RETURN_IF_ERROR(output_helper.Compute(scores_shape, V->Shape()));
+
+  std::vector<int64_t> mask_offsets;
+  int64_t mask_column_stride = 0;
+  if (mask != nullptr) {
+    ORT_RETURN_IF_ERROR(ComputeMaskOffsets(scores_shape, mask->Shape(), mask_offsets, mask_column_stride));
+  }
+
+  Tensor* Y = context->Output(0, output_helper.OutputShape());
+  CudaT* y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+  if (scores_shape.Size() == 0) {
+    // the rows of the scores are empty, so are the sums of the output
+    CUDA_RETURN_IF_ERROR(cudaMemsetAsync(y_data, 0, Y->Size(), Stream()));
+    return Status::OK();
+  }
+
+  auto scores = GetScratchBuffer<CudaT>(static_cast<size_t>(scores_shape.Size()));
+  ORT_RETURN_IF_ERROR(MatMul(scores_helper, scale_, reinterpret_cast<const CudaT*>(Q->template Data<T>()),
+                             reinterpret_cast<const CudaT*>(K_transposed->template Data<T>()), scores.get()));
+
+  const int64_t row_size = scores_shape[scores_shape.NumDimensions() - 1];
+  const int64_t row_count = scores_shape.Size() / row_size;
+  CudaAsyncBuffer<int64_t> mask_row_offsets(this);
+  if (mask != nullptr) {
+    mask_row_offsets.AllocCpuPtr(0, mask_offsets.size());
+    memcpy(mask_row_offsets.CpuPtr(), mask_offsets.data(), mask_offsets.size() * sizeof(int64_t));
+    ORT_RETURN_IF_ERROR(mask_row_offsets.CopyToGpu());
+  }
+  MaskedSoftmaxImpl<CudaT>(
+      Stream(),
+      scores.get(),
+      mask == nullptr ? nullptr : reinterpret_cast<const CudaT*>(mask->template Data<T>()),
+      mask_row_offsets.GpuPtr(),
+      mask_column_stride,
+      row_count,
+      row_size);
+
+  return MatMul(output_helper, 1.0f, scores.get(), reinterpret_cast<const CudaT*>(V->template Data<T>()), y_data);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
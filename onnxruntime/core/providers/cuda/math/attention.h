@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "contrib_ops/cpu/attention.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+class Attention final : public CudaKernel, public contrib::AttentionBase {
+ public:
+  Attention(const OpKernelInfo& info) : CudaKernel(info), contrib::AttentionBase(info) {
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  // output = alpha * MatMul(left, right) over the slices of helper
+  Status MatMul(const MatMulComputeHelper& helper, float alpha, const CudaT* left, const CudaT* right,
+                CudaT* output) const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Attention);
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "attention_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/cu_inc/softmax_impl.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+// loads the scores with the mask added, so that the mask is fused into the softmax
+template <typename T, typename AccT>
+struct MaskedScores {
+  const T* scores;
+  const T* mask;
+  const int64_t* mask_row_offsets;
+  int64_t mask_column_stride;
+  int64_t row_size;
+
+  __device__ __inline__ AccT operator()(int64_t row, int64_t i) const {
+    AccT value = static_cast<AccT>(scores[row * row_size + i]);
+    if (mask != nullptr) {
+      value += static_cast<AccT>(mask[mask_row_offsets[row] + i * mask_column_stride]);
+    }
+    return value;
+  }
+};
+
+}  // namespace
+
+template <typename T>
+void MaskedSoftmaxImpl(
+    cudaStream_t stream,
+    T* scores,
+    const T* mask,
+    const int64_t* mask_row_offsets,
+    int64_t mask_column_stride,
+    int64_t row_count,
+    int64_t row_size) {
+  const MaskedScores<T, typename SoftmaxAccumulator<T>::type> load{scores, mask, mask_row_offsets,
+                                                                  mask_column_stride, row_size};
+  DispatchSoftmax<T, false>(stream, load, scores, row_count, row_size);
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void MaskedSoftmaxImpl<T>(cudaStream_t stream, T* scores, const T* mask, const int64_t* mask_row_offsets, int64_t mask_column_stride, int64_t row_count, int64_t row_size);
+
+SPECIALIZED_IMPL(float)
+
+}  // namespace cuda
+}  // namespace onnxruntime
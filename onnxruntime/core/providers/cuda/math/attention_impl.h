@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include <cuda_runtime.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// adds the mask to each of the row_count rows of row_size scores and replaces them with their softmax, in place.
+// row i reads the mask from mask_row_offsets[i] with a distance of mask_column_stride between its elements.
+// mask may be nullptr.
+template <typename T>
+void MaskedSoftmaxImpl(
+    cudaStream_t stream,
+    T* scores,
+    const T* mask,
+    const int64_t* mask_row_offsets,
+    int64_t mask_column_stride,
+    int64_t row_count,
+    int64_t row_size);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -108,6 +108,7 @@ Status BinaryElementwise<ShouldBroadcast>::Prepare(OpKernelContext* context, int
     Prepare(context, 0, &prepare);                                                                               \
     ORT_RETURN_IF_ERROR(prepare.CopyToGpu());                                                            \
     Impl_##x<typename ToCudaType<T>::MappedType>(                                                                \
+        Stream(),                                                                                                \
         prepare.output_rank_or_simple_broadcast,                                                                 \
         prepare.lhs_padded_strides.GpuPtr(),                                                                     \
         reinterpret_cast<const typename ToCudaType<T>::MappedType*>(prepare.lhs_tensor->template Data<T>()),     \
@@ -198,7 +199,7 @@ Status Sum<T>::ComputeInternal(OpKernelContext* context) const {
     auto input_tensor = context->Input<Tensor>(0);
     const auto& input_shape = input_tensor->Shape();
     auto output_tensor = context->Output(0, input_shape);
-    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor->MutableDataRaw(), input_tensor->DataRaw(), sizeof(CudaT) * input_shape.Size(), cudaMemcpyDeviceToDevice));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor->MutableDataRaw(), input_tensor->DataRaw(), sizeof(CudaT) * input_shape.Size(), cudaMemcpyDeviceToDevice, Stream()));
   } else {
     // compute output shape first, using broadcast rule
     TensorShape output_shape;
@@ -213,6 +214,7 @@ Status Sum<T>::ComputeInternal(OpKernelContext* context) const {
       // special case for 2 tensors to avoid memset zero
       ORT_RETURN_IF_ERROR(BinaryElementwiseBroadcastPrepare(0, context->Input<Tensor>(0), context->Input<Tensor>(1), output_tensor, &prepare));
       Impl_Add<CudaT>(
+          Stream(),
           prepare.output_rank_or_simple_broadcast,
           prepare.lhs_padded_strides.GpuPtr(),
           reinterpret_cast<const CudaT*>(prepare.lhs_tensor->template Data<T>()),
@@ -225,10 +227,11 @@ Status Sum<T>::ComputeInternal(OpKernelContext* context) const {
           prepare.output_tensor->Shape().Size());
     } else {
       // for more than 2 inputs, we need to accumulate into output tensor, as the shape from input0 + input1 might be different from output shape
-      CUDA_RETURN_IF_ERROR(cudaMemset(output_tensor->MutableDataRaw(), 0, output_shape.Size() * sizeof(CudaT)));
+      CUDA_RETURN_IF_ERROR(cudaMemsetAsync(output_tensor->MutableDataRaw(), 0, output_shape.Size() * sizeof(CudaT), Stream()));
       for (int index = 0; index < input_count; index++) {
         ORT_RETURN_IF_ERROR(BinaryElementwiseBroadcastPrepare(0, output_tensor, context->Input<Tensor>(index), output_tensor, &prepare));
         Impl_Add<CudaT>(
+            Stream(),
             prepare.output_rank_or_simple_broadcast,
             prepare.lhs_padded_strides.GpuPtr(),
             reinterpret_cast<const CudaT*>(prepare.lhs_tensor->template Data<T>()),
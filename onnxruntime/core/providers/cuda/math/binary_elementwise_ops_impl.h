@@ -32,6 +32,7 @@ namespace cuda {
 #define BINARY_ELEMENTWISE_IMPL_DECLARATION(name) \
   template <typename T>                           \
   void Impl_##name(                               \
+      cudaStream_t stream,                        \
       size_t output_rank_or_simple_broadcast,     \
       const int64_t* lhs_padded_strides,          \
       const T* lhs_data,                          \
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/fused_elementwise_ops.h"
+
+#include <unordered_map>
+
+using namespace onnxruntime::common;
+namespace onnxruntime {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                                \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                \
+      FusedElementwise,                                                         \
+      kMSDomain,                                                                \
+      1,                                                                        \
+      T,                                                                        \
+      kCudaExecutionProvider,                                                   \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedElementwise<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+
+// op type of each fused node and whether it takes a second operand
+const std::unordered_map<std::string, std::pair<FusedElementwiseOp, bool>>& FusedOps() {
+  static const std::unordered_map<std::string, std::pair<FusedElementwiseOp, bool>> ops = {
+      {"Add", {FusedElementwiseOp::Add, true}},
+      {"Sub", {FusedElementwiseOp::Sub, true}},
+      {"Mul", {FusedElementwiseOp::Mul, true}},
+      {"Div", {FusedElementwiseOp::Div, true}},
+      {"Abs", {FusedElementwiseOp::Abs, false}},
+      {"Neg", {FusedElementwiseOp::Neg, false}},
+      {"Reciprocal", {FusedElementwiseOp::Reciprocal, false}},
+      {"Sqrt", {FusedElementwiseOp::Sqrt, false}},
+      {"Exp", {FusedElementwiseOp::Exp, false}},
+      {"Log", {FusedElementwiseOp::Log, false}},
+      {"Relu", {FusedElementwiseOp::Relu, false}},
+      {"Sigmoid", {FusedElementwiseOp::Sigmoid, false}},
+      {"Tanh", {FusedElementwiseOp::Tanh, false}},
+  };
+  return ops;
+}
+
+}  // namespace
+
+template <typename T>
+FusedElementwise<T>::FusedElementwise(const OpKernelInfo& info) : CudaKernel(info) {
+  std::vector<std::string> ops;
+  std::vector<int64_t> operands;
+  ORT_ENFORCE(info.GetAttrs<std::string>("ops", ops).IsOK());
+  ORT_ENFORCE(info.GetAttrs<int64_t>("operands", operands).IsOK());
+
+  const int num_inputs = static_cast<int>(info.GetInputCount());
+  const int num_steps = static_cast<int>(ops.size());
+  ORT_ENFORCE(num_inputs >= 1 && num_inputs <= kFusedElementwiseMaxInputs,
+              "FusedElementwise supports 1 to ", kFusedElementwiseMaxInputs, " inputs. Got ", num_inputs);
+  ORT_ENFORCE(num_steps >= 1 && num_steps <= kFusedElementwiseMaxSteps,
+              "FusedElementwise supports 1 to ", kFusedElementwiseMaxSteps, " ops. Got ", num_steps);
+  ORT_ENFORCE(operands.size() == 2 * ops.size(), "FusedElementwise requires two operands per op");
+
+  program_.num_inputs = num_inputs;
+  program_.num_steps = num_steps;
+  for (int s = 0; s < num_steps; s++) {
+    auto it = FusedOps().find(ops[s]);
+    ORT_ENFORCE(it != FusedOps().end(), "FusedElementwise does not support ", ops[s]);
+    const bool is_binary = it->second.second;
+    const int64_t lhs = operands[2 * s];
+    const int64_t rhs = operands[2 * s + 1];
+    // operands refer to the inputs or to the results of earlier ops
+    ORT_ENFORCE(lhs >= 0 && lhs < num_inputs + s, "Invalid operand ", lhs, " for ", ops[s]);
+    ORT_ENFORCE(is_binary ? (rhs >= 0 && rhs < num_inputs + s) : rhs == -1, "Invalid operand ", rhs, " for ", ops[s]);
+    program_.ops[s] = it->second.first;
+    program_.lhs[s] = static_cast<int>(lhs);
+    program_.rhs[s] = static_cast<int>(rhs);
+  }
+}
+
+template <typename T>
+Status FusedElementwise<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const int num_inputs = program_.num_inputs;
+
+  // the output shape is the multidirectional broadcast of the input shapes
+  size_t output_rank = 0;
+  for (int i = 0; i < num_inputs; i++) {
+    output_rank = std::max(output_rank, context->Input<Tensor>(i)->Shape().NumDimensions());
+  }
+  ORT_RETURN_IF_NOT(output_rank <= static_cast<size_t>(kFusedElementwiseMaxRank),
+                    Node().Name(), ": FusedElementwise supports inputs of rank up to ", kFusedElementwiseMaxRank);
+
+  std::vector<int64_t> output_dims(output_rank, 1);
+  for (int i = 0; i < num_inputs; i++) {
+    const auto& shape = context->Input<Tensor>(i)->Shape();
+    const size_t offset = output_rank - shape.NumDimensions();
+    for (size_t dim = 0; dim < shape.NumDimensions(); dim++) {
+      int64_t& output_dim = output_dims[offset + dim];
+      if (shape[dim] != output_dim && shape[dim] != 1 && output_dim != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, Node().Name(), ": input ", i, " with shape ", shape.ToString(),
+                               " cannot be broadcast with the other inputs on dim ", offset + dim);
+      }
+      if (output_dim == 1)
+        output_dim = shape[dim];
+    }
+  }
+  TensorShape output_shape(output_dims);
+  Tensor* output = context->Output(0, output_shape);
+  const int64_t count = output_shape.Size();
+  if (count == 0)
+    return Status::OK();
+
+  FusedElementwiseInputs<CudaT> inputs;
+  bool broadcast = false;
+  for (int i = 0; i < num_inputs; i++) {
+    const Tensor* input = context->Input<Tensor>(i);
+    inputs.data[i] = reinterpret_cast<const CudaT*>(input->template Data<T>());
+    broadcast = broadcast || !(input->Shape() == output_shape);
+  }
+
+  inputs.output_rank = 0;
+  if (broadcast) {
+    inputs.output_rank = static_cast<int>(output_rank);
+    std::vector<int64_t> output_pitches(output_rank, 1);
+    for (size_t dim = output_rank; dim > 1; dim--) {
+      output_pitches[dim - 2] = output_pitches[dim - 1] * output_dims[dim - 1];
+    }
+    for (size_t dim = 0; dim < output_rank; dim++) {
+      inputs.fdm_output_strides[dim] = fast_divmod(gsl::narrow_cast<int>(output_pitches[dim]));
+    }
+
+    for (int i = 0; i < num_inputs; i++) {
+      const auto& shape = context->Input<Tensor>(i)->Shape();
+      const size_t offset = output_rank - shape.NumDimensions();
+      int64_t pitch = 1;
+      for (size_t dim = output_rank; dim > 0; dim--) {
+        const int64_t input_dim = dim - 1 >= offset ? shape[dim - 1 - offset] : 1;
+        inputs.strides[i][dim - 1] = input_dim == 1 ? 0 : gsl::narrow_cast<int>(pitch);
+        pitch *= input_dim;
+      }
+    }
+  }
+
+  FusedElementwiseImpl<CudaT>(
+      Stream(),
+      program_,
+      inputs,
+      reinterpret_cast<CudaT*>(output->template MutableData<T>()),
+      static_cast<size_t>(count));
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
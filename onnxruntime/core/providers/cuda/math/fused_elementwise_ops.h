@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/math/fused_elementwise_ops_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Evaluates a chain of element-wise ops created by ElementwiseFusionTransformer in a single kernel, so the
+// intermediate results never leave registers. The inputs are broadcast to a common shape.
+template <typename T>
+class FusedElementwise final : public CudaKernel {
+ public:
+  FusedElementwise(const OpKernelInfo& info);
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  FusedElementwiseProgram program_;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
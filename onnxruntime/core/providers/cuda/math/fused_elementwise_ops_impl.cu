@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cuda_runtime.h>
+#include "fused_elementwise_ops_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+// type the intermediate results are kept in. half is evaluated in float, so rounding only happens on the output.
+template <typename T>
+struct FusedElementwiseComputeType {
+  typedef T type;
+};
+
+template <>
+struct FusedElementwiseComputeType<half> {
+  typedef float type;
+};
+
+template <typename T>
+__device__ __inline__ T FusedElementwiseApply(FusedElementwiseOp op, T a, T b) {
+  switch (op) {
+    case FusedElementwiseOp::Add:
+      return a + b;
+    case FusedElementwiseOp::Sub:
+      return a - b;
+    case FusedElementwiseOp::Mul:
+      return a * b;
+    case FusedElementwiseOp::Div:
+      return a / b;
+    case FusedElementwiseOp::Abs:
+      return _Abs(a);
+    case FusedElementwiseOp::Neg:
+      return -a;
+    case FusedElementwiseOp::Reciprocal:
+      return T(1) / a;
+    case FusedElementwiseOp::Sqrt:
+      return _Sqrt(a);
+    case FusedElementwiseOp::Exp:
+      return _Exp(a);
+    case FusedElementwiseOp::Log:
+      return _Log(a);
+    case FusedElementwiseOp::Relu:
+      return a > T(0) ? a : T(0);
+    case FusedElementwiseOp::Sigmoid:
+      return T(1) / (T(1) + _Exp(-a));
+    case FusedElementwiseOp::Tanh:
+      return _Tanh(a);
+  }
+  return a;
+}
+
+// each thread reads every input once, evaluates the program in registers and writes the output once
+template <typename T>
+__global__ void _FusedElementwise(
+    const FusedElementwiseProgram program,
+    const FusedElementwiseInputs<T> inputs,
+    T* output_data,
+    CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  typedef typename FusedElementwiseComputeType<T>::type ComputeT;
+
+  CUDA_LONG input_indices[kFusedElementwiseMaxInputs];
+  for (int i = 0; i < program.num_inputs; i++) {
+    input_indices[i] = (inputs.output_rank == 0 ? id : 0);
+  }
+
+  // compute indexes with broadcasting rules: https://github.com/onnx/onnx/blob/master/docs/Broadcasting.md
+  CUDA_LONG offset = id;
+  for (int dim = 0; dim < inputs.output_rank; dim++) {
+    int q, r;
+    inputs.fdm_output_strides[dim].divmod(offset, q, r);
+    for (int i = 0; i < program.num_inputs; i++) {
+      input_indices[i] += inputs.strides[i][dim] * q;
+    }
+    offset = r;
+  }
+
+  ComputeT values[kFusedElementwiseMaxInputs + kFusedElementwiseMaxSteps];
+  for (int i = 0; i < program.num_inputs; i++) {
+    values[i] = static_cast<ComputeT>(inputs.data[i][input_indices[i]]);
+  }
+
+  for (int s = 0; s < program.num_steps; s++) {
+    ComputeT a = values[program.lhs[s]];
+    ComputeT b = (program.rhs[s] >= 0 ? values[program.rhs[s]] : ComputeT(0));
+    values[program.num_inputs + s] = FusedElementwiseApply(program.ops[s], a, b);
+  }
+
+  output_data[id] = static_cast<T>(values[program.num_inputs + program.num_steps - 1]);
+}
+
+template <typename T>
+void FusedElementwiseImpl(
+    cudaStream_t stream,
+    const FusedElementwiseProgram& program,
+    const FusedElementwiseInputs<T>& inputs,
+    T* output_data,
+    size_t count) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _FusedElementwise<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, stream>>>(program, inputs, output_data, N);
+}
+
+#define SPECIALIZED_FUSED_ELEMENTWISE_IMPL(T)                                                                  \
+  template void FusedElementwiseImpl<T>(cudaStream_t stream, const FusedElementwiseProgram& program,          \
+                                        const FusedElementwiseInputs<T>& inputs, T* output_data, size_t count);
+
+SPECIALIZED_FUSED_ELEMENTWISE_IMPL(half)
+SPECIALIZED_FUSED_ELEMENTWISE_IMPL(float)
+SPECIALIZED_FUSED_ELEMENTWISE_IMPL(double)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// limits of a FusedElementwise node. the program and the input descriptions are passed to the kernel by value,
+// so these bound the size of the kernel parameters.
+constexpr int kFusedElementwiseMaxInputs = 8;
+constexpr int kFusedElementwiseMaxSteps = 16;
+constexpr int kFusedElementwiseMaxRank = 8;
+
+enum class FusedElementwiseOp : int {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Abs,
+  Neg,
+  Reciprocal,
+  Sqrt,
+  Exp,
+  Log,
+  Relu,
+  Sigmoid,
+  Tanh,
+};
+
+// the sequence of ops a FusedElementwise node evaluates for each element.
+// operand i < num_inputs is input i, operand num_inputs + s is the result of step s.
+// rhs is -1 for unary ops. the result of the last step is the output.
+struct FusedElementwiseProgram {
+  int num_inputs;
+  int num_steps;
+  FusedElementwiseOp ops[kFusedElementwiseMaxSteps];
+  int lhs[kFusedElementwiseMaxSteps];
+  int rhs[kFusedElementwiseMaxSteps];
+};
+
+// NOTE that cu files are compiled with nvcc and should not refer to any onnxruntime headers
+template <typename T>
+struct FusedElementwiseInputs {
+  const T* data[kFusedElementwiseMaxInputs];
+  // element stride of each input for each output dimension, 0 for the dimensions the input is broadcast on
+  int strides[kFusedElementwiseMaxInputs][kFusedElementwiseMaxRank];
+  // output rank, or 0 when every input has the output shape and is indexed by the output offset
+  int output_rank;
+  fast_divmod fdm_output_strides[kFusedElementwiseMaxRank];
+};
+
+template <typename T>
+void FusedElementwiseImpl(
+    cudaStream_t stream,
+    const FusedElementwiseProgram& program,
+    const FusedElementwiseInputs<T>& inputs,
+    T* output_data,
+    size_t count);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,169 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/matmul_integer.h"
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
+#include "contrib_ops/cpu/quantize_linear_matmul.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// the zero points and scales are read on the host
+ONNX_OPERATOR_KERNEL_EX(
+    MatMulInteger,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(3)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
+    MatMulInteger);
+
+ONNX_OPERATOR_KERNEL_EX(
+    QLinearMatMul,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(1)
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(4)
+        .InputMemoryType<OrtMemTypeCPUInput>(5)
+        .InputMemoryType<OrtMemTypeCPUInput>(6)
+        .InputMemoryType<OrtMemTypeCPUInput>(7)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearMatMul);
+
+template <typename Output>
+Status QuantizedMatMulBase::ComputeGemms(const MatMulComputeHelper& helper, const Tensor& a, uint8_t a_zero_point,
+                                         const Tensor& b, uint8_t b_zero_point, const Output& output) const {
+  const int64_t M = helper.M();
+  const int64_t N = helper.N();
+  const int64_t K = helper.K();
+  const int64_t padded_N = PadInt8GemmDim(N);
+  // an empty depth is padded to zeros, whose product is zero
+  const int64_t padded_K = PadInt8GemmDim(std::max<int64_t>(K, 1));
+
+  auto left = GetScratchBuffer<int8_t>(static_cast<size_t>(M * padded_K));
+  auto left_row_sums = GetScratchBuffer<int32_t>(static_cast<size_t>(M));
+  auto right_transposed = GetScratchBuffer<int8_t>(static_cast<size_t>(padded_N * padded_K));
+  auto right_row_sums = GetScratchBuffer<int32_t>(static_cast<size_t>(padded_N));
+  auto product = GetScratchBuffer<int32_t>(static_cast<size_t>(M * padded_N));
+
+  const uint8_t* a_data = a.template Data<uint8_t>();
+  const uint8_t* b_data = b.template Data<uint8_t>();
+  const int32_t one = 1;
+  const int32_t zero = 0;
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+    // an operand broadcast over the batches is packed once
+    if (i == 0 || helper.LeftOffsets()[i] != helper.LeftOffsets()[i - 1]) {
+      PackInt8Rows(Stream(), a_data + helper.LeftOffsets()[i], M, K, K, 1, M, padded_K, left.get(),
+                   left_row_sums.get());
+    }
+    if (i == 0 || helper.RightOffsets()[i] != helper.RightOffsets()[i - 1]) {
+      PackInt8Rows(Stream(), b_data + helper.RightOffsets()[i], N, K, 1, N, padded_N, padded_K,
+                   right_transposed.get(), right_row_sums.get());
+    }
+
+    // the row major M x padded_N product is the column major product of the transposed operands
+    CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
+        CublasHandle(),
+        CUBLAS_OP_T,
+        CUBLAS_OP_N,
+        static_cast<int>(padded_N),
+        static_cast<int>(M),
+        static_cast<int>(padded_K),
+        &one,
+        right_transposed.get(),
+        static_cast<int>(padded_K),
+        left.get(),
+        static_cast<int>(padded_K),
+        &zero,
+        product.get(),
+        static_cast<int>(padded_N)));
+
+    output(i, Int8GemmProduct{product.get(), left_row_sums.get(), right_row_sums.get(), M, N, padded_N, K,
+                              a_zero_point, b_zero_point});
+  }
+  return Status::OK();
+}
+
+Status MatMulInteger::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+  if (y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  uint8_t a_zero_point = 0;
+  uint8_t b_zero_point = 0;
+  if (has_a_zero_point_) {
+    const Tensor* zero_point = ctx->Input<Tensor>(2);
+    ORT_RETURN_IF_NOT(zero_point->Shape().Size() == 1 && zero_point->Shape().NumDimensions() <= 1,
+                      "Currently only scalar zero_point is supported.");
+    a_zero_point = *zero_point->template Data<uint8_t>();
+  }
+  if (has_b_zero_point_) {
+    const Tensor* zero_point = ctx->Input<Tensor>(3);
+    ORT_RETURN_IF_NOT(zero_point->Shape().Size() == 1 && zero_point->Shape().NumDimensions() <= 1,
+                      "Currently only scalar zero_point is supported.");
+    b_zero_point = *zero_point->template Data<uint8_t>();
+  }
+
+  int32_t* y_data = y->template MutableData<int32_t>();
+  const int64_t N = helper.N();
+  return ComputeGemms(helper, *a, a_zero_point, *b, b_zero_point,
+                      [&](size_t i, const Int8GemmProduct& product) {
+                        Int8GemmOutput(Stream(), product, y_data + helper.OutputOffsets()[i], N);
+                      });
+}
+
+Status QLinearMatMul::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(3);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // validate scale and zero points
+  const Tensor* a_scale = ctx->Input<Tensor>(1);
+  const Tensor* a_zero_point = ctx->Input<Tensor>(2);
+  contrib::ScaleAndZeropointPairValidationHelper(a_scale, a_zero_point);
+  const Tensor* b_scale = ctx->Input<Tensor>(4);
+  const Tensor* b_zero_point = ctx->Input<Tensor>(5);
+  contrib::ScaleAndZeropointPairValidationHelper(b_scale, b_zero_point);
+  const Tensor* y_scale = ctx->Input<Tensor>(6);
+  const Tensor* y_zero_point = ctx->Input<Tensor>(7);
+  contrib::ScaleAndZeropointPairValidationHelper(y_scale, y_zero_point);
+  if (y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const float real_multiplier =
+      (*a_scale->template Data<float>() * *b_scale->template Data<float>()) / *y_scale->template Data<float>();
+  int32_t integer_multiplier;
+  int right_shift;
+  contrib::QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+
+  uint8_t* y_data = y->template MutableData<uint8_t>();
+  const uint8_t y_offset = *y_zero_point->template Data<uint8_t>();
+  const int64_t N = helper.N();
+  return ComputeGemms(helper, *a, *a_zero_point->template Data<uint8_t>(), *b, *b_zero_point->template Data<uint8_t>(),
+                      [&](size_t i, const Int8GemmProduct& product) {
+                        Int8GemmRequantizeOutput(Stream(), product, nullptr, integer_multiplier, right_shift,
+                                                 y_offset, y_data + helper.OutputOffsets()[i], N);
+                      });
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cuda/math/matmul_integer_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// the uint8 matmuls, computed by the int8 gemm of cublas on their operands shifted into int8, and corrected for
+// the zero points of the operands from the row sums of both
+class QuantizedMatMulBase : public CudaKernel {
+ protected:
+  QuantizedMatMulBase(const OpKernelInfo& info) : CudaKernel(info) {}
+
+  // computes the gemms of helper, calling output(i, product) with the product of the i-th gemm
+  template <typename Output>
+  Status ComputeGemms(const MatMulComputeHelper& helper, const Tensor& a, uint8_t a_zero_point, const Tensor& b,
+                      uint8_t b_zero_point, const Output& output) const;
+};
+
+class MatMulInteger final : public QuantizedMatMulBase {
+ public:
+  MatMulInteger(const OpKernelInfo& info) : QuantizedMatMulBase(info) {
+    has_a_zero_point_ = info.GetInputCount() > 2;
+    has_b_zero_point_ = info.GetInputCount() > 3;
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  bool has_a_zero_point_;
+  bool has_b_zero_point_;
+};
+
+class QLinearMatMul final : public QuantizedMatMulBase {
+ public:
+  QLinearMatMul(const OpKernelInfo& info) : QuantizedMatMulBase(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/shared_inc/fast_divmod.h"
+#include "matmul_integer_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+constexpr int kPackWarpSize = 32;
+// the rows a block of the pack kernel packs, a warp each
+constexpr int kPackRowsPerBlock = 8;
+
+__device__ __inline__ int8_t ShiftToInt8(uint8_t value) {
+  return static_cast<int8_t>(static_cast<int>(value) - 128);
+}
+
+// loads the elements of a strided matrix
+struct MatrixLoad {
+  const uint8_t* input;
+  int64_t row_stride;
+  int64_t depth_stride;
+
+  __device__ __inline__ int8_t operator()(int64_t row, int64_t k) const {
+    return ShiftToInt8(input[row * row_stride + k * depth_stride]);
+  }
+};
+
+// loads the elements of the window of an output pixel, whose k-th element is at the offset of the k % kernel_size
+// element of the kernel in channel k / kernel_size
+struct Im2RowLoad {
+  const uint8_t* image;
+  Im2RowParams params;
+  uint8_t zero_point;
+
+  __device__ __inline__ int8_t operator()(int64_t pixel, int64_t k) const {
+    int64_t kernel_offset = k % params.kernel_size;
+    int64_t input_offset = k / params.kernel_size * params.input_pitches[0] * params.input_dims[0];
+    for (int d = params.rank - 1; d >= 0; --d) {
+      const int64_t kernel_index = kernel_offset % params.kernel_dims[d];
+      kernel_offset /= params.kernel_dims[d];
+      const int64_t output_index = pixel % params.output_dims[d];
+      pixel /= params.output_dims[d];
+      const int64_t input_index = output_index * params.strides[d] - params.pads[d] +
+                                  kernel_index * params.dilations[d];
+      if (input_index < 0 || input_index >= params.input_dims[d]) {
+        return ShiftToInt8(zero_point);
+      }
+      input_offset += input_index * params.input_pitches[d];
+    }
+    return ShiftToInt8(image[input_offset]);
+  }
+};
+
+// a warp per row, which writes the row and reduces its sum
+template <typename Load>
+__global__ void _PackInt8RowsKernel(Load load, int64_t rows, int64_t depth, int64_t padded_rows, int64_t padded_depth,
+                                    int8_t* output, int32_t* row_sums) {
+  const int64_t row = static_cast<int64_t>(blockIdx.x) * kPackRowsPerBlock + threadIdx.y;
+  if (row >= padded_rows) {
+    return;
+  }
+
+  int8_t* row_output = output + row * padded_depth;
+  int32_t sum = 0;
+  for (int64_t k = threadIdx.x; k < padded_depth; k += kPackWarpSize) {
+    const int8_t value = row < rows && k < depth ? load(row, k) : static_cast<int8_t>(0);
+    row_output[k] = value;
+    sum += value;
+  }
+#pragma unroll
+  for (int offset = kPackWarpSize / 2; offset > 0; offset /= 2) {
+    sum += __shfl_xor_sync(0xffffffff, sum, offset);
+  }
+  if (threadIdx.x == 0) {
+    row_sums[row] = sum;
+  }
+}
+
+template <typename Load>
+void PackInt8(cudaStream_t stream, const Load& load, int64_t rows, int64_t depth, int64_t padded_rows,
+              int64_t padded_depth, int8_t* output, int32_t* row_sums) {
+  if (padded_rows == 0) {
+    return;
+  }
+  const dim3 threads(kPackWarpSize, kPackRowsPerBlock);
+  const unsigned int blocks = static_cast<unsigned int>((padded_rows + kPackRowsPerBlock - 1) / kPackRowsPerBlock);
+  _PackInt8RowsKernel<Load><<<blocks, threads, 0, stream>>>(load, rows, depth, padded_rows, padded_depth, output,
+                                                            row_sums);
+}
+
+void PackInt8Rows(
+    cudaStream_t stream,
+    const uint8_t* input,
+    int64_t rows,
+    int64_t depth,
+    int64_t row_stride,
+    int64_t depth_stride,
+    int64_t padded_rows,
+    int64_t padded_depth,
+    int8_t* output,
+    int32_t* row_sums) {
+  PackInt8(stream, MatrixLoad{input, row_stride, depth_stride}, rows, depth, padded_rows, padded_depth, output,
+           row_sums);
+}
+
+void PackInt8Im2Row(
+    cudaStream_t stream,
+    const uint8_t* image,
+    const Im2RowParams& params,
+    uint8_t zero_point,
+    int64_t output_size,
+    int64_t depth,
+    int64_t padded_rows,
+    int64_t padded_depth,
+    int8_t* output,
+    int32_t* row_sums) {
+  PackInt8(stream, Im2RowLoad{image, params, zero_point}, output_size, depth, padded_rows, padded_depth, output,
+           row_sums);
+}
+
+// the sum over k of (left[m, k] - left_zero_point) * (right[k, n] - right_zero_point), from the product and row
+// sums of the shifted operands, whose zero points are shifted the same way
+__device__ __inline__ int32_t Int8GemmValue(const Int8GemmProduct& product, int64_t m, int64_t n) {
+  const int32_t left_zero_point = static_cast<int32_t>(product.left_zero_point) - 128;
+  const int32_t right_zero_point = static_cast<int32_t>(product.right_zero_point) - 128;
+  return product.product[m * product.padded_N + n] - right_zero_point * product.left_row_sums[m] -
+         left_zero_point * product.right_row_sums[n] +
+         static_cast<int32_t>(product.depth) * left_zero_point * right_zero_point;
+}
+
+struct Int32Store {
+  int32_t* output;
+  int64_t ldo;
+
+  __device__ __inline__ void operator()(int64_t m, int64_t n, int32_t value) const {
+    output[m * ldo + n] = value;
+  }
+};
+
+// the fixed point requantization of MlasRequantizeOutput, so that the results match those of the cpu
+struct RequantizeStore {
+  uint8_t* output;
+  int64_t ldo;
+  const int32_t* bias;
+  int32_t multiplier;
+  int right_shift;
+  uint8_t zero_point;
+
+  __device__ __inline__ void operator()(int64_t m, int64_t n, int32_t value) const {
+    const int32_t left_shift = right_shift < 0 ? -right_shift : 0;
+    const int32_t shift = right_shift > 0 ? right_shift : 0;
+    const int32_t mask = static_cast<int32_t>((static_cast<int64_t>(1) << shift) - 1);
+    const int64_t nudge = static_cast<int64_t>(1) << 30;
+
+    int64_t biased = static_cast<int64_t>(value + (bias != nullptr ? bias[m] : 0)) *
+                     (static_cast<int64_t>(1) << left_shift);
+    biased = biased > INT32_MAX ? INT32_MAX : (biased < INT32_MIN ? INT32_MIN : biased);
+
+    // saturating rounding doubling high multiply
+    int32_t high_mul;
+    if (biased == INT32_MIN && multiplier == INT32_MIN) {
+      high_mul = INT32_MAX;
+    } else {
+      const int64_t product = biased * static_cast<int64_t>(multiplier);
+      const int64_t rounded = product + (product >= 0 ? nudge : 1 - nudge);
+      high_mul = static_cast<int32_t>(rounded / (static_cast<int64_t>(1) << 31));
+    }
+
+    // rounding divide by a power of two
+    const int32_t remainder = high_mul & mask;
+    const int32_t threshold = (mask >> 1) + (high_mul < 0 ? 1 : 0);
+    int32_t result = (high_mul >> shift) + (remainder > threshold ? 1 : 0) + static_cast<int32_t>(zero_point);
+    result = result < 0 ? 0 : (result > 255 ? 255 : result);
+    output[m * ldo + n] = static_cast<uint8_t>(result);
+  }
+};
+
+template <typename Store>
+__global__ void _Int8GemmOutputKernel(const Int8GemmProduct product, const Store store, const fast_divmod fdm_N,
+                                      const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int m, n;
+  fdm_N.divmod(id, m, n);
+  store(m, n, Int8GemmValue(product, m, n));
+}
+
+template <typename Store>
+void LaunchInt8GemmOutput(cudaStream_t stream, const Int8GemmProduct& product, const Store& store) {
+  const int64_t count = product.M * product.N;
+  if (count == 0) {
+    return;
+  }
+  const int blocksPerGrid = static_cast<int>((count + GridDim::maxThreadsPerBlock - 1) / GridDim::maxThreadsPerBlock);
+  _Int8GemmOutputKernel<Store><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, stream>>>(
+      product, store, fast_divmod(static_cast<int>(product.N)), static_cast<CUDA_LONG>(count));
+}
+
+void Int8GemmOutput(cudaStream_t stream, const Int8GemmProduct& product, int32_t* output, int64_t ldo) {
+  LaunchInt8GemmOutput(stream, product, Int32Store{output, ldo});
+}
+
+void Int8GemmRequantizeOutput(
+    cudaStream_t stream,
+    const Int8GemmProduct& product,
+    const int32_t* bias,
+    int32_t multiplier,
+    int right_shift,
+    uint8_t zero_point,
+    uint8_t* output,
+    int64_t ldo) {
+  LaunchInt8GemmOutput(stream, product, RequantizeStore{output, ldo, bias, multiplier, right_shift, zero_point});
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// the uint8 operands of a quantized gemm are shifted by -128 into the int8 operands of cublas, whose rows are
+// padded with zeros to a multiple of this many elements as the int8 gemm of cublas requires
+constexpr int64_t kInt8GemmAlignment = 4;
+
+inline int64_t PadInt8GemmDim(int64_t dim) {
+  return (dim + kInt8GemmAlignment - 1) / kInt8GemmAlignment * kInt8GemmAlignment;
+}
+
+// packs the rows x depth uint8 matrix whose element (r, k) is input[r * row_stride + k * depth_stride] into the
+// padded_rows x padded_depth int8 matrix output, padded with zeros, and writes the sums of the padded_rows rows of
+// output to row_sums
+void PackInt8Rows(
+    cudaStream_t stream,
+    const uint8_t* input,
+    int64_t rows,
+    int64_t depth,
+    int64_t row_stride,
+    int64_t depth_stride,
+    int64_t padded_rows,
+    int64_t padded_depth,
+    int8_t* output,
+    int32_t* row_sums);
+
+constexpr int kMaxIm2RowRank = 3;
+
+// the convolution windows of a group of an image
+struct Im2RowParams {
+  int rank;
+  int64_t kernel_size;
+  int64_t input_dims[kMaxIm2RowRank];
+  int64_t input_pitches[kMaxIm2RowRank];
+  int64_t output_dims[kMaxIm2RowRank];
+  int64_t kernel_dims[kMaxIm2RowRank];
+  int64_t strides[kMaxIm2RowRank];
+  int64_t dilations[kMaxIm2RowRank];
+  int64_t pads[kMaxIm2RowRank];  // at the start of each axis
+};
+
+// packs the window of each of the output_size pixels of the convolution of the channels x input image into a row
+// of the padded_rows x padded_depth int8 matrix output like PackInt8Rows, with the elements of the windows the pads
+// cover set to zero_point, and writes the sums of the rows to row_sums
+void PackInt8Im2Row(
+    cudaStream_t stream,
+    const uint8_t* image,
+    const Im2RowParams& params,
+    uint8_t zero_point,
+    int64_t output_size,
+    int64_t depth,
+    int64_t padded_rows,
+    int64_t padded_depth,
+    int8_t* output,
+    int32_t* row_sums);
+
+// the M x padded_N int32 product of the shifted left and right operands of a quantized gemm, and the row sums of
+// both, whose zero points computed the product of the operands with their zero points subtracted
+struct Int8GemmProduct {
+  const int32_t* product;
+  const int32_t* left_row_sums;
+  const int32_t* right_row_sums;
+  int64_t M;
+  int64_t N;
+  int64_t padded_N;
+  int64_t depth;
+  uint8_t left_zero_point;
+  uint8_t right_zero_point;
+};
+
+// output[m * ldo + n] = the product of the operands with their zero points subtracted
+void Int8GemmOutput(cudaStream_t stream, const Int8GemmProduct& product, int32_t* output, int64_t ldo);
+
+// output[m * ldo + n] = the product of the operands with their zero points subtracted plus the optional bias[m],
+// requantized like MlasRequantizeOutput
+void Int8GemmRequantizeOutput(
+    cudaStream_t stream,
+    const Int8GemmProduct& product,
+    const int32_t* bias,
+    int32_t multiplier,
+    int right_shift,
+    uint8_t zero_point,
+    uint8_t* output,
+    int64_t ldo);
+
+}  // namespace cuda
+}  // namespace onnxruntime
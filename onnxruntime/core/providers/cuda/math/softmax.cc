@@ -3,14 +3,14 @@
 
 #include "softmax.h"
 #include "core/providers/common.h"
-#include "core/providers/cuda/cudnn_common.h"
+#include "softmax_impl.h"
 
 namespace onnxruntime {
 namespace cuda {
 
-#define REGISTER_KERNEL_TYPED(T)                                                \
+#define REGISTER_KERNEL_TYPED(op_name, T)                                       \
   ONNX_OPERATOR_TYPED_KERNEL_EX(                                                \
-      Softmax,                                                                  \
+      op_name,                                                                  \
       kOnnxDomain,                                                              \
       1,                                                                        \
       T,                                                                        \
@@ -30,24 +30,19 @@ Status Softmax<T>::ComputeInternal(OpKernelContext* ctx) const {
 
   int64_t N = input_shape.SizeToDimension(axis);
   int64_t D = input_shape.SizeFromDimension(axis);
-  std::vector<int64_t> dims({N, 1, 1, D});  // cudnn expects 4D shape in NCHW format
 
   auto y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
   auto x_data = reinterpret_cast<const CudaT*>(X.template Data<T>());
 
-  const auto alpha = Consts<CudaT>::One;
-  const auto beta = Consts<CudaT>::Zero;
-  CudnnTensor input_tensor;
-  CudnnTensor output_tensor;
-  ORT_RETURN_IF_ERROR(input_tensor.Set(dims, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(output_tensor.Set(dims, CudnnTensor::GetDataType<CudaT>()));
-  CUDNN_RETURN_IF_ERROR(cudnnSoftmaxForward(CudnnHandle(), CUDNN_SOFTMAX_ACCURATE, CUDNN_SOFTMAX_MODE_INSTANCE, &alpha, input_tensor, x_data, &beta, output_tensor, y_data));
+  // rather than cudnnSoftmaxForward, which is slow for long rows and for many short ones
+  SoftmaxImpl(Stream(), x_data, y_data, N, D, log_softmax_);
 
   return Status::OK();
 }
 
-#define SPECIALIZED_COMPUTE(T) \
-  REGISTER_KERNEL_TYPED(T)     \
+#define SPECIALIZED_COMPUTE(T)         \
+  REGISTER_KERNEL_TYPED(Softmax, T)    \
+  REGISTER_KERNEL_TYPED(LogSoftmax, T) \
   template Status Softmax<T>::ComputeInternal(OpKernelContext* ctx) const;
 
 SPECIALIZED_COMPUTE(float)
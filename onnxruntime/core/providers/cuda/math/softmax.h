@@ -12,7 +12,8 @@ namespace cuda {
 template <typename T>
 class Softmax final : public CudaKernel {
  public:
-  Softmax(const OpKernelInfo& info) : CudaKernel{info} {
+  Softmax(const OpKernelInfo& info)
+      : CudaKernel{info}, log_softmax_{info.GetKernelDef().OpName() == "LogSoftmax"} {
     info.GetAttrOrDefault("axis", &axis_, static_cast<int64_t>(1));
   }
 
@@ -20,6 +21,8 @@ class Softmax final : public CudaKernel {
 
  private:
   int64_t axis_;
+  // the kernel of LogSoftmax as well
+  bool log_softmax_;
 };
 
 }  // namespace cuda
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "softmax_impl.h"
+#include "core/providers/cuda/cu_inc/softmax_impl.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+void SoftmaxImpl(
+    cudaStream_t stream,
+    const T* input,
+    T* output,
+    int64_t row_count,
+    int64_t row_size,
+    bool log_softmax) {
+  const SoftmaxInput<T, typename SoftmaxAccumulator<T>::type> load{input, row_size};
+  if (log_softmax) {
+    DispatchSoftmax<T, true>(stream, load, output, row_count, row_size);
+  } else {
+    DispatchSoftmax<T, false>(stream, load, output, row_count, row_size);
+  }
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void SoftmaxImpl<T>(cudaStream_t stream, const T* input, T* output, int64_t row_count, int64_t row_size, bool log_softmax);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace onnxruntime
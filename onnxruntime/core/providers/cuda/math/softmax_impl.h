@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include <cuda_runtime.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// writes the softmax, or log softmax, of each of the row_count rows of row_size elements of input to output.
+// half is accumulated in float.
+template <typename T>
+void SoftmaxImpl(
+    cudaStream_t stream,
+    const T* input,
+    T* output,
+    int64_t row_count,
+    int64_t row_size,
+    bool log_softmax);
+
+}  // namespace cuda
+}  // namespace onnxruntime
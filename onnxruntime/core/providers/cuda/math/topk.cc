@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/topk.h"
+#include "core/providers/common.h"
+#include "core/providers/cuda/math/topk_impl.h"
+
+#include <limits>
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    TopK,
+    kOnnxDomain,
+    1,
+    float,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("I", DataTypeImpl::GetTensorType<int64_t>()),
+    TopK<float>);
+
+template <typename T>
+TopK<T>::TopK(const OpKernelInfo& info) : CudaKernel(info) {
+  ORT_ENFORCE(info.GetAttr<int64_t>("k", &k_).IsOK());
+  ORT_ENFORCE(k_ > 0);
+  ORT_ENFORCE(info.GetAttr<int64_t>("axis", &axis_).IsOK());
+}
+
+template <typename T>
+Status TopK<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& input_shape = X->Shape();
+  const auto& input_dims = input_shape.GetDims();
+  const size_t axis = static_cast<size_t>(HandleNegativeAxis(axis_, static_cast<int64_t>(input_shape.NumDimensions())));
+  const int64_t axis_dim = input_dims[axis];
+  if (axis_dim < k_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "k argument [", k_, "] should not be greater than dim [", axis_dim,
+                           "] of axis ", axis);
+  }
+
+  std::vector<int64_t> output_dims = input_dims;
+  output_dims[axis] = k_;
+  Tensor* values = context->Output(0, TensorShape(output_dims));
+  Tensor* indices = context->Output(1, TensorShape(output_dims));
+
+  const int64_t inner = input_shape.SizeFromDimension(axis + 1);
+  const int64_t num_rows = input_shape.SizeToDimension(axis) * inner;
+  if (num_rows == 0)
+    return Status::OK();
+
+  const size_t buffer_bytes = TopKBufferBytes(num_rows, gsl::narrow<int>(k_));
+  ORT_RETURN_IF_NOT(buffer_bytes / sizeof(uint64_t) <= static_cast<size_t>(std::numeric_limits<int32_t>::max()),
+                    "TopK input of shape ", input_shape.ToString(), " is too large for the CUDA kernel");
+  auto buffer = GetScratchBuffer<void>(buffer_bytes);
+  TopKImpl(Stream(),
+           X->template Data<T>(),
+           values->template MutableData<T>(),
+           indices->template MutableData<int64_t>(),
+           gsl::narrow<int>(num_rows),
+           gsl::narrow<int>(axis_dim),
+           fast_divmod(gsl::narrow<int>(inner)),
+           gsl::narrow<int>(k_),
+           buffer.get());
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
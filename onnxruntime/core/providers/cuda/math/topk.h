@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Selects the k largest elements along axis on the device, so models with TopK in their post-processing don't
+// copy the tensor to the CPU and back.
+template <typename T>
+class TopK final : public CudaKernel {
+ public:
+  TopK(const OpKernelInfo& info);
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  int64_t axis_;
+  int64_t k_;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
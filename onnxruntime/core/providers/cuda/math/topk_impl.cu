@@ -0,0 +1,261 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cuda_runtime.h>
+#include "topk_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+constexpr int kWarpSize = 32;
+constexpr int kSelectThreadsPerBlock = 256;
+constexpr int kSelectWarpsPerBlock = kSelectThreadsPerBlock / kWarpSize;
+constexpr int kRadixBits = 8;
+constexpr int kRadixBins = 1 << kRadixBits;
+// selections of up to this many (padded) elements are sorted in shared memory by one block
+constexpr int kMaxSharedSortSize = 2048;
+constexpr int kMaxSortThreadsPerBlock = 1024;
+
+// number of elements each row is padded to for the bitonic sort
+int PaddedSize(int k) {
+  int size = 1;
+  while (size < k)
+    size *= 2;
+  return size;
+}
+
+}  // namespace
+
+// maps a float to an unsigned key with the same order, so keys can be selected digit by digit
+__device__ __inline__ uint32_t OrderedKey(float value) {
+  const uint32_t bits = __float_as_uint(value);
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+__device__ __inline__ float OrderedKeyToFloat(uint32_t key) {
+  return __uint_as_float((key & 0x80000000u) ? (key & 0x7fffffffu) : ~key);
+}
+
+// an element is sorted by its key and then by its position, with the lower position first on ties.
+// 0 sorts after every element, so it pads the rows.
+__device__ __inline__ uint64_t PackElement(uint32_t key, int position) {
+  return (static_cast<uint64_t>(key) << 32) | static_cast<uint32_t>(~static_cast<uint32_t>(position));
+}
+
+// each block selects the k largest elements of one row into selected[row * padded_k, (row + 1) * padded_k)
+__global__ void _TopKSelect(
+    const float* input,
+    uint64_t* selected,
+    const int axis_dim,
+    const fast_divmod fdm_inner,
+    const int k,
+    const int padded_k) {
+  __shared__ int histogram[kRadixBins];
+  __shared__ uint32_t kth_prefix;
+  __shared__ int kth_remaining;
+  __shared__ int num_greater;
+  __shared__ int warp_counts[kSelectWarpsPerBlock];
+
+  const int row = blockIdx.x;
+  int outer, inner_index;
+  fdm_inner.divmod(row, outer, inner_index);
+  const int inner = fdm_inner.d_;
+  const float* row_input = input + static_cast<int64_t>(outer) * axis_dim * inner + inner_index;
+  uint64_t* row_selected = selected + static_cast<int64_t>(row) * padded_k;
+
+  // find the key of the k-th largest element a digit at a time, from the most significant one.
+  // remaining is the number of elements still to select among those that match the digits found so far.
+  uint32_t prefix = 0;
+  uint32_t mask = 0;
+  int remaining = k;
+  for (int shift = 32 - kRadixBits; shift >= 0; shift -= kRadixBits) {
+    for (int i = threadIdx.x; i < kRadixBins; i += blockDim.x)
+      histogram[i] = 0;
+    __syncthreads();
+
+    for (int j = threadIdx.x; j < axis_dim; j += blockDim.x) {
+      const uint32_t key = OrderedKey(row_input[static_cast<int64_t>(j) * inner]);
+      if ((key & mask) == prefix)
+        atomicAdd(&histogram[(key >> shift) & (kRadixBins - 1)], 1);
+    }
+    __syncthreads();
+
+    if (threadIdx.x == 0) {
+      int count = 0;
+      for (int digit = kRadixBins - 1; digit >= 0; --digit) {
+        if (count + histogram[digit] >= remaining) {
+          kth_prefix = prefix | (static_cast<uint32_t>(digit) << shift);
+          kth_remaining = remaining - count;
+          break;
+        }
+        count += histogram[digit];
+      }
+      num_greater = 0;
+    }
+    __syncthreads();
+
+    prefix = kth_prefix;
+    remaining = kth_remaining;
+    mask |= static_cast<uint32_t>(kRadixBins - 1) << shift;
+  }
+
+  // every element with a greater key is selected, and the first remaining elements with the k-th key.
+  // the elements with the k-th key are counted in order of position across the block to find the first ones.
+  const int lane = threadIdx.x % kWarpSize;
+  const int warp = threadIdx.x / kWarpSize;
+  const int first_equal = k - remaining;
+  int equal_base = 0;
+  for (int start = 0; start < axis_dim; start += blockDim.x) {
+    const int j = start + threadIdx.x;
+    const uint32_t key = j < axis_dim ? OrderedKey(row_input[static_cast<int64_t>(j) * inner]) : 0;
+    const bool is_equal = j < axis_dim && key == prefix;
+    if (j < axis_dim && key > prefix) {
+      row_selected[atomicAdd(&num_greater, 1)] = PackElement(key, j);
+    }
+
+    const unsigned ballot = __ballot_sync(0xffffffff, is_equal);
+    if (lane == 0)
+      warp_counts[warp] = __popc(ballot);
+    __syncthreads();
+
+    int rank = equal_base + __popc(ballot & ((1u << lane) - 1));
+    for (int w = 0; w < kSelectWarpsPerBlock; ++w) {
+      if (w < warp)
+        rank += warp_counts[w];
+      equal_base += warp_counts[w];
+    }
+    if (is_equal && rank < remaining)
+      row_selected[first_equal + rank] = PackElement(key, j);
+    __syncthreads();
+  }
+
+  for (int p = k + threadIdx.x; p < padded_k; p += blockDim.x)
+    row_selected[p] = 0;
+}
+
+__device__ __inline__ void CompareAndSwap(uint64_t& a, uint64_t& b, bool descending) {
+  if ((a < b) == descending) {
+    const uint64_t t = a;
+    a = b;
+    b = t;
+  }
+}
+
+__device__ __inline__ void WriteTopK(
+    uint64_t element,
+    int row,
+    int position,
+    const fast_divmod& fdm_inner,
+    int k,
+    float* values,
+    int64_t* indices) {
+  int outer, inner_index;
+  fdm_inner.divmod(row, outer, inner_index);
+  const int64_t offset = (static_cast<int64_t>(outer) * k + position) * fdm_inner.d_ + inner_index;
+  values[offset] = OrderedKeyToFloat(static_cast<uint32_t>(element >> 32));
+  indices[offset] = static_cast<int64_t>(~static_cast<uint32_t>(element));
+}
+
+// each block sorts the selection of one row in shared memory and writes the first k elements
+__global__ void _TopKSortShared(
+    const uint64_t* selected,
+    float* values,
+    int64_t* indices,
+    const fast_divmod fdm_inner,
+    const int k,
+    const int padded_k) {
+  extern __shared__ uint64_t elements[];
+  const int row = blockIdx.x;
+  const uint64_t* row_selected = selected + static_cast<int64_t>(row) * padded_k;
+  for (int p = threadIdx.x; p < padded_k; p += blockDim.x)
+    elements[p] = row_selected[p];
+  __syncthreads();
+
+  for (int size = 2; size <= padded_k; size *= 2) {
+    for (int stride = size / 2; stride > 0; stride /= 2) {
+      for (int t = threadIdx.x; t < padded_k / 2; t += blockDim.x) {
+        const int i = 2 * t - (t & (stride - 1));
+        CompareAndSwap(elements[i], elements[i + stride], (i & size) == 0);
+      }
+      __syncthreads();
+    }
+  }
+
+  for (int p = threadIdx.x; p < k; p += blockDim.x)
+    WriteTopK(elements[p], row, p, fdm_inner, k, values, indices);
+}
+
+// one step of the bitonic sort of the selections in global memory, for selections too large for shared memory
+__global__ void _TopKSortStep(
+    uint64_t* selected,
+    const int padded_k,
+    const int size,
+    const int stride,
+    const CUDA_LONG num_pairs) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, num_pairs);
+  const int half_size = padded_k / 2;
+  const CUDA_LONG row = id / half_size;
+  const int t = id % half_size;
+  const int i = 2 * t - (t & (stride - 1));
+  uint64_t* row_selected = selected + static_cast<int64_t>(row) * padded_k;
+  CompareAndSwap(row_selected[i], row_selected[i + stride], (i & size) == 0);
+}
+
+__global__ void _TopKWrite(
+    const uint64_t* selected,
+    float* values,
+    int64_t* indices,
+    const fast_divmod fdm_inner,
+    const int k,
+    const int padded_k,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  const int row = static_cast<int>(id / k);
+  const int position = static_cast<int>(id % k);
+  WriteTopK(selected[static_cast<int64_t>(row) * padded_k + position], row, position, fdm_inner, k, values, indices);
+}
+
+size_t TopKBufferBytes(int64_t num_rows, int k) {
+  return static_cast<size_t>(num_rows) * PaddedSize(k) * sizeof(uint64_t);
+}
+
+void TopKImpl(
+    cudaStream_t stream,
+    const float* input,
+    float* values,
+    int64_t* indices,
+    int num_rows,
+    int axis_dim,
+    const fast_divmod& fdm_inner,
+    int k,
+    void* buffer) {
+  uint64_t* selected = reinterpret_cast<uint64_t*>(buffer);
+  const int padded_k = PaddedSize(k);
+  _TopKSelect<<<num_rows, kSelectThreadsPerBlock, 0, stream>>>(input, selected, axis_dim, fdm_inner, k, padded_k);
+
+  if (padded_k <= kMaxSharedSortSize) {
+    const int threads = std::max(1, std::min(padded_k / 2, kMaxSortThreadsPerBlock));
+    _TopKSortShared<<<num_rows, threads, padded_k * sizeof(uint64_t), stream>>>(
+        selected, values, indices, fdm_inner, k, padded_k);
+    return;
+  }
+
+  const CUDA_LONG num_pairs = static_cast<CUDA_LONG>(num_rows) * (padded_k / 2);
+  const int blocks = static_cast<int>(CeilDiv(num_pairs, GridDim::maxThreadsPerBlock));
+  for (int size = 2; size <= padded_k; size *= 2) {
+    for (int stride = size / 2; stride > 0; stride /= 2) {
+      _TopKSortStep<<<blocks, GridDim::maxThreadsPerBlock, 0, stream>>>(selected, padded_k, size, stride, num_pairs);
+    }
+  }
+
+  const CUDA_LONG N = static_cast<CUDA_LONG>(num_rows) * k;
+  _TopKWrite<<<static_cast<int>(CeilDiv(N, GridDim::maxThreadsPerBlock)), GridDim::maxThreadsPerBlock, 0, stream>>>(
+      selected, values, indices, fdm_inner, k, padded_k, N);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include <cuda_runtime.h>
+#include "core/providers/cuda/shared_inc/fast_divmod.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Bytes of the buffer TopKImpl needs to select and sort k elements of each of num_rows rows.
+size_t TopKBufferBytes(int64_t num_rows, int k);
+
+// Writes the k largest elements of each row of input to values, in descending order, and their positions in the
+// row to indices. Equal elements are ordered by position like the CPU kernel.
+// Row r starts at (r / inner) * axis_dim * inner + r % inner, and its elements are inner apart. values and
+// indices use the same layout with k in place of axis_dim.
+// The k-th largest key of each row is found with a radix select, so only the k selected elements are sorted.
+void TopKImpl(
+    cudaStream_t stream,
+    const float* input,
+    float* values,
+    int64_t* indices,
+    int num_rows,
+    int axis_dim,
+    const fast_divmod& fdm_inner,
+    int k,
+    void* buffer);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "core/providers/common.h"
 #include "core/providers/cuda/cuda_common.h"
 #include "core/providers/cuda/nn/conv.h"
+#include "core/providers/cuda/nn/conv_algo_cache.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
 
 namespace onnxruntime {
@@ -103,8 +104,6 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
       ORT_RETURN_IF_ERROR(s_.conv_desc.Set(kernel_shape.size(), pads, strides, dilations, mode, CudnnTensor::GetDataType<CudaT>()));
       CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionGroupCount(s_.conv_desc, gsl::narrow_cast<int>(group_)));
 
-      IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
-
       if (has_bias) {
         const Tensor* B = context->Input<Tensor>(2);
         const auto& b_shape = B->Shape();
@@ -125,25 +124,62 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
       if (std::is_same<T, MLFloat16>::value)
         CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
 
-      cudnnConvolutionFwdAlgoPerf_t perf;
-      int algo_count = 1;
-      CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
-          CudnnHandle(),
-          s_.x_tensor,
-          x_data,
-          s_.filter_desc,
-          w_data,
-          s_.conv_desc,
-          s_.y_tensor,
-          y_data,
-          1,
-          &algo_count,
-          &perf,
-          algo_search_workspace.get(),
-          AlgoSearchWorkspaceSize));
-      CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, perf.mathType));
-      s_.algo = perf.algo;
-      s_.workspace_bytes = perf.memory;
+      // the algorithm for a problem is shared by all sessions and may come from a file written by an earlier process
+      const size_t workspace_limit = GetCudnnConvWorkspaceLimit();
+      const std::string algo_key = CudnnConvAlgoCache::MakeKey("fwd", GetDeviceId(), CudnnTensor::GetDataType<CudaT>(),
+                                                               x_dims_cudnn, w_dims, y_dims_cudnn, pads, strides,
+                                                               dilations, group_, workspace_limit);
+      CudnnConvAlgoPerf algo_perf;
+      if (!CudnnConvAlgoCache::Instance().Find(algo_key, algo_perf)) {
+        cudnnConvolutionFwdAlgoPerf_t perf;
+        if (GetCudnnConvAlgoSearch() == kCudnnConvAlgoSearchHeuristic) {
+          cudnnConvolutionFwdAlgoPerf_t perfs[CUDNN_CONVOLUTION_FWD_ALGO_COUNT];
+          int algo_count = 0;
+          CUDNN_RETURN_IF_ERROR(cudnnGetConvolutionForwardAlgorithm_v7(
+              CudnnHandle(),
+              s_.x_tensor,
+              s_.filter_desc,
+              s_.conv_desc,
+              s_.y_tensor,
+              CUDNN_CONVOLUTION_FWD_ALGO_COUNT,
+              &algo_count,
+              perfs));
+          // implicit GEMM needs no workspace, so it is used when no suggestion fits in the limit
+          perf.algo = CUDNN_CONVOLUTION_FWD_ALGO_IMPLICIT_GEMM;
+          perf.memory = 0;
+          perf.mathType = CUDNN_DEFAULT_MATH;
+          for (int i = 0; i < algo_count; i++) {
+            if (perfs[i].status == CUDNN_STATUS_SUCCESS && perfs[i].memory <= workspace_limit) {
+              perf = perfs[i];
+              break;
+            }
+          }
+        } else {
+          IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(workspace_limit);
+          int algo_count = 1;
+          CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
+              CudnnHandle(),
+              s_.x_tensor,
+              x_data,
+              s_.filter_desc,
+              w_data,
+              s_.conv_desc,
+              s_.y_tensor,
+              y_data,
+              1,
+              &algo_count,
+              &perf,
+              algo_search_workspace.get(),
+              workspace_limit));
+        }
+        algo_perf.algo = static_cast<int>(perf.algo);
+        algo_perf.workspace_bytes = perf.memory;
+        algo_perf.math_type = static_cast<int>(perf.mathType);
+        CudnnConvAlgoCache::Instance().Insert(algo_key, algo_perf);
+      }
+      CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, static_cast<cudnnMathType_t>(algo_perf.math_type)));
+      s_.algo = static_cast<cudnnConvolutionFwdAlgo_t>(algo_perf.algo);
+      s_.workspace_bytes = algo_perf.workspace_bytes;
     }
   }
 
@@ -51,10 +51,6 @@ struct CudnnConvState {
   OrtMutex mutex;
 };
 
-enum : size_t {
-  AlgoSearchWorkspaceSize = 32 * 1024 * 1024,
-};
-
 template <typename T>
 class Conv : public CudaKernel, public ConvBase {
  public:
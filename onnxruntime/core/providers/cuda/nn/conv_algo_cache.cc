@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/nn/conv_algo_cache.h"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "core/providers/cuda/shared_inc/cuda_call.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+// first line of a cache file. bump the version if the line format changes.
+const char* const kCacheFileHeader = "cudnn_conv_algo_cache 1";
+
+void AppendDims(std::ostringstream& out, const char* name, const std::vector<int64_t>& dims) {
+  out << '|' << name << '=';
+  for (size_t i = 0; i < dims.size(); ++i) {
+    out << (i == 0 ? "" : ",") << dims[i];
+  }
+}
+
+// device model and compute capability, which unlike the device id are the same for identical GPUs in another process
+std::string GetDeviceKey(int device_id) {
+  static OrtMutex mutex;
+  static std::map<int, std::string> device_keys;
+
+  std::lock_guard<OrtMutex> lock(mutex);
+  auto it = device_keys.find(device_id);
+  if (it == device_keys.end()) {
+    cudaDeviceProp prop;
+    CUDA_CALL_THROW(cudaGetDeviceProperties(&prop, device_id));
+    std::ostringstream key;
+    key << prop.name << " sm_" << prop.major << prop.minor;
+    it = device_keys.emplace(device_id, key.str()).first;
+  }
+  return it->second;
+}
+
+}  // namespace
+
+CudnnConvAlgoCache& CudnnConvAlgoCache::Instance() {
+  static CudnnConvAlgoCache instance;
+  return instance;
+}
+
+std::string CudnnConvAlgoCache::MakeKey(const char* direction,
+                                        int device_id,
+                                        cudnnDataType_t data_type,
+                                        const std::vector<int64_t>& x_dims,
+                                        const std::vector<int64_t>& w_dims,
+                                        const std::vector<int64_t>& y_dims,
+                                        const std::vector<int64_t>& pads,
+                                        const std::vector<int64_t>& strides,
+                                        const std::vector<int64_t>& dilations,
+                                        int64_t group,
+                                        size_t workspace_limit) {
+  std::ostringstream key;
+  key << direction << "|cudnn" << cudnnGetVersion() << '|' << GetDeviceKey(device_id)
+      << "|t=" << static_cast<int>(data_type);
+  AppendDims(key, "x", x_dims);
+  AppendDims(key, "w", w_dims);
+  AppendDims(key, "y", y_dims);
+  AppendDims(key, "p", pads);
+  AppendDims(key, "s", strides);
+  AppendDims(key, "d", dilations);
+  key << "|g=" << group << "|ws=" << workspace_limit;
+  return key.str();
+}
+
+bool CudnnConvAlgoCache::Find(const std::string& key, CudnnConvAlgoPerf& perf) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  perf = it->second;
+  return true;
+}
+
+void CudnnConvAlgoCache::Insert(const std::string& key, const CudnnConvAlgoPerf& perf) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  entries_[key] = perf;
+}
+
+Status CudnnConvAlgoCache::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return Status::OK();
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != kCacheFileHeader) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unrecognized cuDNN algorithm cache file: ", path);
+  }
+
+  // each line holds the key followed by the algorithm, workspace size and math type, separated by tabs
+  std::unordered_map<std::string, CudnnConvAlgoPerf> entries;
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    auto separator = line.find('\t');
+    if (separator == std::string::npos) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Malformed entry in cuDNN algorithm cache file: ", path);
+    }
+    std::istringstream values(line.substr(separator + 1));
+    CudnnConvAlgoPerf perf;
+    if (!(values >> perf.algo >> perf.workspace_bytes >> perf.math_type)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Malformed entry in cuDNN algorithm cache file: ", path);
+    }
+    entries[line.substr(0, separator)] = perf;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& entry : entries) {
+    entries_.insert(entry);
+  }
+  return Status::OK();
+}
+
+Status CudnnConvAlgoCache::Save(const std::string& path) const {
+  std::ostringstream contents;
+  contents << kCacheFileHeader << '\n';
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    for (const auto& entry : entries_) {
+      contents << entry.first << '\t' << entry.second.algo << '\t' << entry.second.workspace_bytes << '\t'
+               << entry.second.math_type << '\n';
+    }
+  }
+
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  file << contents.str();
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write cuDNN algorithm cache file: ", path);
+  }
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
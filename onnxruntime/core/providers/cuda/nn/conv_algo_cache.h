@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_pch.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// cuDNN convolution algorithm chosen for a problem, with the workspace and math type it runs with
+struct CudnnConvAlgoPerf {
+  int algo;
+  size_t workspace_bytes;
+  int math_type;
+};
+
+// Process wide cache of the cuDNN convolution algorithms chosen by Conv and ConvTranspose, shared by all sessions.
+// A key describes the problem (direction, shapes, attributes and data type) together with the cuDNN version and the
+// device model, so entries loaded from a file written by another process are only used on matching hardware and
+// software.
+class CudnnConvAlgoCache final {
+ public:
+  static CudnnConvAlgoCache& Instance();
+
+  static std::string MakeKey(const char* direction,
+                             int device_id,
+                             cudnnDataType_t data_type,
+                             const std::vector<int64_t>& x_dims,
+                             const std::vector<int64_t>& w_dims,
+                             const std::vector<int64_t>& y_dims,
+                             const std::vector<int64_t>& pads,
+                             const std::vector<int64_t>& strides,
+                             const std::vector<int64_t>& dilations,
+                             int64_t group,
+                             size_t workspace_limit);
+
+  bool Find(const std::string& key, CudnnConvAlgoPerf& perf) const;
+
+  void Insert(const std::string& key, const CudnnConvAlgoPerf& perf);
+
+  // merges the entries of a file written by Save. a missing file is not an error.
+  Status Load(const std::string& path);
+
+  Status Save(const std::string& path) const;
+
+ private:
+  CudnnConvAlgoCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudnnConvAlgoCache);
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<std::string, CudnnConvAlgoPerf> entries_;  // GUARDED_BY(mutex_)
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,221 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/nn/conv_integer.h"
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
+#include "contrib_ops/cpu/quantize_linear_matmul.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// the zero points and scales are read on the host
+ONNX_OPERATOR_KERNEL_EX(
+    ConvInteger,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(3)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
+    ConvInteger);
+
+ONNX_OPERATOR_KERNEL_EX(
+    QLinearConv,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(1)
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(4)
+        .InputMemoryType<OrtMemTypeCPUInput>(5)
+        .InputMemoryType<OrtMemTypeCPUInput>(6)
+        .InputMemoryType<OrtMemTypeCPUInput>(7)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearConv);
+
+static Status GetZeroPoint(const Tensor* zero_point, uint8_t& value) {
+  if (zero_point != nullptr) {
+    if (zero_point->Shape().Size() != 1 || zero_point->Shape().NumDimensions() > 1) {
+      //TODO: Add support for per-channel quantization.
+      return Status(common::ONNXRUNTIME, common::FAIL, "Non per-tensor quantization is not supported now.");
+    }
+    value = *zero_point->template Data<uint8_t>();
+  }
+  return Status::OK();
+}
+
+template <typename T, typename Output>
+Status QuantizedConvBase::ComputeConv(OpKernelContext* context, const Tensor& X, uint8_t x_zero_point,
+                                      const Tensor& W, uint8_t w_zero_point, const Output& output) const {
+  const int64_t N = X.Shape()[0];
+  const int64_t C = X.Shape()[1];
+  const int64_t M = W.Shape()[0];
+  ORT_RETURN_IF_ERROR(ValidateInputShape(&X, &W));
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(ComputeKernelShape(W.Shape(), kernel_shape));
+  const size_t rank = kernel_shape.size();
+  if (rank > static_cast<size_t>(kMaxIm2RowRank)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Quantized convolutions of more than ", kMaxIm2RowRank,
+                           " spatial dimensions are not supported on CUDA");
+  }
+
+  std::vector<int64_t> pads(pads_);
+  if (pads.empty()) {
+    pads.resize(rank * 2, 0);
+  }
+  std::vector<int64_t> dilations(dilations_);
+  if (dilations.empty()) {
+    dilations.resize(rank, 1);
+  }
+  std::vector<int64_t> strides(strides_);
+  if (strides.empty()) {
+    strides.resize(rank, 1);
+  }
+
+  std::vector<int64_t> Y_dims;
+  Y_dims.insert(Y_dims.begin(), {N, M});
+  TensorShape input_shape = X.Shape().Slice(2);
+  ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+  TensorShape output_shape = Y->Shape().Slice(2);
+
+  Im2RowParams params;
+  params.rank = static_cast<int>(rank);
+  params.kernel_size = TensorShape(kernel_shape).Size();
+  int64_t input_pitch = 1;
+  for (int d = params.rank - 1; d >= 0; --d) {
+    params.input_dims[d] = input_shape[d];
+    params.input_pitches[d] = input_pitch;
+    input_pitch *= input_shape[d];
+    params.output_dims[d] = output_shape[d];
+    params.kernel_dims[d] = kernel_shape[d];
+    params.strides[d] = strides[d];
+    params.dilations[d] = dilations[d];
+    params.pads[d] = pads[d];
+  }
+
+  const int64_t input_image_size = input_shape.Size();
+  const int64_t output_image_size = output_shape.Size();
+  const int64_t group_input_channels = C / group_;
+  const int64_t group_output_channels = M / group_;
+  const int64_t kernel_dim = group_input_channels * params.kernel_size;
+  const int64_t padded_depth = PadInt8GemmDim(kernel_dim);
+  const int64_t padded_pixels = PadInt8GemmDim(output_image_size);
+
+  // the filters of all the groups are packed once, a row per output channel
+  auto filters = GetScratchBuffer<int8_t>(static_cast<size_t>(M * padded_depth));
+  auto filter_row_sums = GetScratchBuffer<int32_t>(static_cast<size_t>(M));
+  PackInt8Rows(Stream(), W.template Data<uint8_t>(), M, kernel_dim, kernel_dim, 1, M, padded_depth, filters.get(),
+               filter_row_sums.get());
+
+  auto windows = GetScratchBuffer<int8_t>(static_cast<size_t>(padded_pixels * padded_depth));
+  auto window_row_sums = GetScratchBuffer<int32_t>(static_cast<size_t>(padded_pixels));
+  auto product = GetScratchBuffer<int32_t>(static_cast<size_t>(group_output_channels * padded_pixels));
+
+  const uint8_t* x_data = X.template Data<uint8_t>();
+  T* y_data = Y->template MutableData<T>();
+  const int32_t one = 1;
+  const int32_t zero = 0;
+  for (int64_t image = 0; image < N; ++image) {
+    for (int64_t group = 0; group < group_; ++group) {
+      PackInt8Im2Row(Stream(), x_data + (image * C + group * group_input_channels) * input_image_size, params,
+                     x_zero_point, output_image_size, kernel_dim, padded_pixels, padded_depth, windows.get(),
+                     window_row_sums.get());
+
+      // the row major group_output_channels x padded_pixels product of the filters and the windows
+      CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
+          CublasHandle(),
+          CUBLAS_OP_T,
+          CUBLAS_OP_N,
+          static_cast<int>(padded_pixels),
+          static_cast<int>(group_output_channels),
+          static_cast<int>(padded_depth),
+          &one,
+          windows.get(),
+          static_cast<int>(padded_depth),
+          filters.get() + group * group_output_channels * padded_depth,
+          static_cast<int>(padded_depth),
+          &zero,
+          product.get(),
+          static_cast<int>(padded_pixels)));
+
+      output(group,
+             Int8GemmProduct{product.get(), filter_row_sums.get() + group * group_output_channels,
+                             window_row_sums.get(), group_output_channels, output_image_size, padded_pixels,
+                             kernel_dim, w_zero_point, x_zero_point},
+             y_data + (image * M + group * group_output_channels) * output_image_size);
+    }
+  }
+  return Status::OK();
+}
+
+Status ConvInteger::ComputeInternal(OpKernelContext* context) const {
+  const size_t num_inputs = OpKernel::Node().InputDefs().size();
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  uint8_t input_offset = 0;
+  uint8_t filter_offset = 0;
+  if (num_inputs >= 3) {
+    ORT_RETURN_IF_ERROR(GetZeroPoint(context->Input<Tensor>(2), input_offset));
+  }
+  if (num_inputs >= 4) {
+    ORT_RETURN_IF_ERROR(GetZeroPoint(context->Input<Tensor>(3), filter_offset));
+  }
+
+  return ComputeConv<int32_t>(context, *X, input_offset, *W, filter_offset,
+                              [&](int64_t, const Int8GemmProduct& product, int32_t* y) {
+                                Int8GemmOutput(Stream(), product, y, product.N);
+                              });
+}
+
+Status QLinearConv::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(3);
+
+  // validate scale and zero points
+  const Tensor* input_scale = context->Input<Tensor>(1);
+  const Tensor* input_offset = context->Input<Tensor>(2);
+  contrib::ScaleAndZeropointPairValidationHelper(input_scale, input_offset);
+  const Tensor* filter_scale = context->Input<Tensor>(4);
+  const Tensor* filter_offset = context->Input<Tensor>(5);
+  contrib::ScaleAndZeropointPairValidationHelper(filter_scale, filter_offset);
+  const Tensor* result_scale = context->Input<Tensor>(6);
+  const Tensor* result_offset = context->Input<Tensor>(7);
+  contrib::ScaleAndZeropointPairValidationHelper(result_scale, result_offset);
+
+  const float real_multiplier = (*input_scale->template Data<float>() * *filter_scale->template Data<float>()) /
+                                *result_scale->template Data<float>();
+  int32_t integer_multiplier;
+  int right_shift;
+  contrib::QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+
+  const Tensor* bias = nullptr;
+  if (OpKernel::Node().InputDefs().size() == 9) {
+    bias = context->Input<Tensor>(8);
+  }
+  const int32_t* bias_data = bias == nullptr ? nullptr : bias->template Data<int32_t>();
+  const int64_t group_output_channels = W->Shape()[0] / group_;
+  const uint8_t result_offset_data = *result_offset->template Data<uint8_t>();
+
+  return ComputeConv<uint8_t>(context, *X, *input_offset->template Data<uint8_t>(), *W,
+                              *filter_offset->template Data<uint8_t>(),
+                              [&](int64_t group, const Int8GemmProduct& product, uint8_t* y) {
+                                Int8GemmRequantizeOutput(
+                                    Stream(), product,
+                                    bias_data == nullptr ? nullptr : bias_data + group * group_output_channels,
+                                    integer_multiplier, right_shift, result_offset_data, y, product.N);
+                              });
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
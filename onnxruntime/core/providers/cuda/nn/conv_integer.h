@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cpu/nn/conv_base.h"
+#include "core/providers/cuda/math/matmul_integer_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// the uint8 convolutions, computed for each group of an image by the int8 gemm of cublas of the filters and the
+// windows of the output pixels, which are packed into rows, like the quantized matmuls
+class QuantizedConvBase : public CudaKernel, public ConvBase {
+ protected:
+  QuantizedConvBase(const OpKernelInfo& info) : CudaKernel(info), ConvBase(info) {}
+
+  // computes the convolution of X with W into the T output of the context, calling output(group, product, y) with
+  // the product of each group of each image and its output channels y
+  template <typename T, typename Output>
+  Status ComputeConv(OpKernelContext* context, const Tensor& X, uint8_t x_zero_point, const Tensor& W,
+                     uint8_t w_zero_point, const Output& output) const;
+};
+
+class ConvInteger final : public QuantizedConvBase {
+ public:
+  ConvInteger(const OpKernelInfo& info) : QuantizedConvBase(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+class QLinearConv final : public QuantizedConvBase {
+ public:
+  QLinearConv(const OpKernelInfo& info) : QuantizedConvBase(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
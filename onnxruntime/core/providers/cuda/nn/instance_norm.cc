@@ -3,6 +3,7 @@
 
 #include "instance_norm.h"
 #include "instance_norm_impl.h"
+#include "core/providers/cuda/reduction/reduction_impl.h"
 #include "core/providers/cpu/nn/instance_norm_helper.h"
 #include "core/providers/cpu/nn/batch_norm_helper.h"
 
@@ -87,60 +88,32 @@ Status InstanceNorm<T>::ComputeInternal(OpKernelContext* p_op_kernel_context) co
         nullptr,
         nullptr));
   } else {
-    // we use cudnnBatchNormalizationForwardTraining to compute mean/variance
-    // so collapsing NC into channel
+    // compute the mean and variance per-instance per-channel, each over a contiguous H * W row
 
     auto input_count = x_shape.Size();              // N * C * H * W
     auto stats_count = x_shape.SizeToDimension(2);  // N * C
     auto image_size = input_count / stats_count;
 
-    CudnnTensor data_desc;
-    ORT_RETURN_IF_ERROR(data_desc.Set({1, stats_count, image_size, 1}, CudnnTensor::GetDataType<CudaT>()));
-
-    CudnnTensor stats_desc;
-    ORT_RETURN_IF_ERROR(stats_desc.Set({1, stats_count, 1, 1}, CudnnTensor::GetDataType<CudaT>()));
-
     auto mean = GetScratchBuffer<CudaT>(stats_count);
     auto variance = GetScratchBuffer<CudaT>(stats_count);
-    auto unused_scale = GetScratchBuffer<CudaT>(stats_count);
-    auto unused_bias = GetScratchBuffer<CudaT>(stats_count);
-
-    // first, compute mean and variance per-instance per-channel using cudnnBatchNorm training
-    CUDNN_RETURN_IF_ERROR(cudnnBatchNormalizationForwardTraining(
-        CudnnHandle(),
-        CUDNN_BATCHNORM_SPATIAL,
-        &one,
-        &zero,
-        data_desc,
-        x_data,
-        data_desc,
-        y_data,  // use y temporarily, would be rewritten later
-        stats_desc,
-        unused_scale.get(),
-        unused_bias.get(),
-        1.0f,
-        mean.get(),
-        variance.get(),
-        CUDNN_BN_MIN_EPSILON,
-        nullptr,
-        nullptr));
+    MeanVarianceImpl<CudaT>(Stream(), x_data, mean.get(), variance.get(),
+                            gsl::narrow<int>(stats_count), gsl::narrow<int>(image_size));
 
     // Y = scale * (x - mean) / sqrt (variance + epsilon) + B
     // X/Y is (N,C,H,W)
     // scale/bias is (1,C,1,1)
     // mean/stddev is (N,C,1,1)
-    // NOTE cudnnBatchNormalization computes unbiased variance sum((Xi - mean)^2) / (count - 1)
-    // and it needs to be corrected with (count - 1) / count
     fast_divmod fdm_HW(gsl::narrow_cast<int>(image_size));
     fast_divmod fdm_C(gsl::narrow_cast<int>(C));
 
     InstanceNormImpl<CudaT>(
+        Stream(),
         x_data,
         scale_data,
         bias_data,
         mean.get(),
         variance.get(),
-        (image_size - 1.0) / image_size,
+        1.0,
         static_cast<double>(epsilon_),
         fdm_HW,
         fdm_C,
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/nn/layer_norm.h"
+#include "core/providers/cuda/nn/layer_norm_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      LayerNormalization,                                         \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      LayerNorm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+
+template <typename T>
+Status LayerNorm<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* scale = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+
+  int64_t slice_count = 0;
+  int64_t slice_size = 0;
+  ORT_RETURN_IF_ERROR(ComputeSliceSize(*X, *scale, bias, slice_count, slice_size));
+
+  Tensor* Y = context->Output(0, X->Shape());
+  if (slice_count == 0 || slice_size == 0) {
+    return Status::OK();
+  }
+
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  LayerNormImpl<CudaT>(
+      Stream(),
+      reinterpret_cast<const CudaT*>(X->template Data<T>()),
+      reinterpret_cast<const CudaT*>(scale->template Data<T>()),
+      bias == nullptr ? nullptr : reinterpret_cast<const CudaT*>(bias->template Data<T>()),
+      epsilon_,
+      slice_count,
+      slice_size,
+      reinterpret_cast<CudaT*>(Y->template MutableData<T>()));
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/layer_norm.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+class LayerNorm final : public CudaKernel, public contrib::LayerNormBase {
+ public:
+  LayerNorm(const OpKernelInfo& info) : CudaKernel(info), contrib::LayerNormBase(info) {
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LayerNorm);
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "layer_norm_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+constexpr int kWarpSize = 32;
+constexpr int kLayerNormThreadsPerBlock = 256;
+constexpr int kLayerNormWarpsPerBlock = kLayerNormThreadsPerBlock / kWarpSize;
+
+// the sum over the block, returned to every thread
+__device__ __inline__ float BlockSum(float value, float* shared) {
+#pragma unroll
+  for (int offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    value += __shfl_down_sync(0xffffffff, value, offset);
+  }
+
+  const int lane = threadIdx.x % kWarpSize;
+  const int warp = threadIdx.x / kWarpSize;
+  if (lane == 0) {
+    shared[warp] = value;
+  }
+  __syncthreads();
+
+  float sum = 0.0f;
+#pragma unroll
+  for (int i = 0; i < kLayerNormWarpsPerBlock; ++i) {
+    sum += shared[i];
+  }
+  // shared is reused by the next sum
+  __syncthreads();
+  return sum;
+}
+
+}  // namespace
+
+// one block per slice. the statistics are accumulated in float, and the variance from the deviations of the mean,
+// which has no cancellation unlike E(x^2) - E(x)^2
+template <typename T>
+__global__ void _LayerNormKernel(
+    const T* input_data,
+    const T* scale,
+    const T* bias,
+    float epsilon,
+    int64_t slice_size,
+    T* output_data) {
+  __shared__ float shared[kLayerNormWarpsPerBlock];
+  const T* x = input_data + blockIdx.x * slice_size;
+  T* y = output_data + blockIdx.x * slice_size;
+
+  float sum = 0.0f;
+  for (int64_t i = threadIdx.x; i < slice_size; i += kLayerNormThreadsPerBlock) {
+    sum += static_cast<float>(x[i]);
+  }
+  const float mean = BlockSum(sum, shared) / slice_size;
+
+  float square_sum = 0.0f;
+  for (int64_t i = threadIdx.x; i < slice_size; i += kLayerNormThreadsPerBlock) {
+    const float deviation = static_cast<float>(x[i]) - mean;
+    square_sum += deviation * deviation;
+  }
+  const float inv_std_dev = rsqrtf(BlockSum(square_sum, shared) / slice_size + epsilon);
+
+  for (int64_t i = threadIdx.x; i < slice_size; i += kLayerNormThreadsPerBlock) {
+    float value = (static_cast<float>(x[i]) - mean) * inv_std_dev * static_cast<float>(scale[i]);
+    if (bias != nullptr) {
+      value += static_cast<float>(bias[i]);
+    }
+    y[i] = static_cast<T>(value);
+  }
+}
+
+template <typename T>
+void LayerNormImpl(
+    cudaStream_t stream,
+    const T* input_data,
+    const T* scale,
+    const T* bias,
+    float epsilon,
+    int64_t slice_count,
+    int64_t slice_size,
+    T* output_data) {
+  _LayerNormKernel<T><<<static_cast<unsigned int>(slice_count), kLayerNormThreadsPerBlock, 0, stream>>>(
+      input_data, scale, bias, epsilon, slice_size, output_data);
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void LayerNormImpl<T>(cudaStream_t stream, const T* input_data, const T* scale, const T* bias, float epsilon, int64_t slice_count, int64_t slice_size, T* output_data);
+
+SPECIALIZED_IMPL(float)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include <cuda_runtime.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// normalizes each of the slice_count contiguous slices of slice_size elements. bias may be nullptr.
+template <typename T>
+void LayerNormImpl(
+    cudaStream_t stream,
+    const T* input_data,
+    const T* scale,
+    const T* bias,
+    float epsilon,
+    int64_t slice_count,
+    int64_t slice_size,
+    T* output_data);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -185,6 +185,7 @@ Status Pool<T, MaxPool<8>>::ComputeInternal(OpKernelContext* context) const {
   if (nullptr != I) {
     auto i_data = I->template MutableData<int64_t>();
     MaxPoolWithIndex<CudaT>(
+        Stream(),
         x_shape,
         TensorShape(y_dims),
         kernel_shape,
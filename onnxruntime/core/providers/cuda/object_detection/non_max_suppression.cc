@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/object_detection/non_max_suppression.h"
+#include "core/providers/cuda/math/topk_impl.h"
+#include "core/providers/cuda/object_detection/non_max_suppression_impl.h"
+
+using namespace onnxruntime::common;
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    NonMaxSuppression,
+    kMSDomain,
+    1,
+    float,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int32_t>()),
+    NonMaxSuppression<float>);
+
+template <typename T>
+Status NonMaxSuppression<T>::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* boxes = ctx->Input<Tensor>(0);
+  ORT_ENFORCE(boxes);
+  const Tensor* scores = ctx->Input<Tensor>(1);
+  ORT_ENFORCE(scores);
+
+  const TensorShape& boxes_shape = boxes->Shape();
+  auto boxes_dims = boxes_shape.GetDims();
+  ORT_RETURN_IF_NOT(boxes_shape.NumDimensions() == 2, "boxes must be a 2D tensor.");
+  int64_t num_boxes = boxes_dims[0];
+  ORT_RETURN_IF_NOT(boxes_dims[1] == 4, "boxes shape must be a 2D tensor with shape [num_boxes, 4].");
+
+  const TensorShape& scores_shape = scores->Shape();
+  ORT_RETURN_IF_NOT(scores_shape.NumDimensions() == 1, "boxes must be a 1D tensor.");
+  ORT_RETURN_IF_NOT(scores_shape.GetDims()[0] == num_boxes, "scores and boxes should have same num_boxes.");
+
+  if (max_output_size_ <= 0 || num_boxes == 0) {
+    TensorShape output_shape({0});
+    ctx->Output(0, output_shape);
+    return Status::OK();
+  }
+
+  // each block of the mask kernel covers 64 boxes in each grid dimension
+  ORT_RETURN_IF_NOT(num_boxes <= 65535 * kNmsBoxesPerMaskWord, "NonMaxSuppression supports up to ",
+                    65535 * kNmsBoxesPerMaskWord, " boxes on CUDA. Got ", num_boxes);
+  const int num_sorted = static_cast<int>(num_boxes);
+
+  // sort all the boxes by descending score, with the lower index first on ties
+  auto sorted_scores = GetScratchBuffer<float>(num_sorted);
+  auto sorted_indices = GetScratchBuffer<int64_t>(num_sorted);
+  auto sort_buffer = GetScratchBuffer<void>(TopKBufferBytes(1, num_sorted));
+  TopKImpl(Stream(), scores->template Data<T>(), sorted_scores.get(), sorted_indices.get(), 1, num_sorted,
+           fast_divmod(1), num_sorted, sort_buffer.get());
+
+  std::vector<float> host_scores(num_sorted);
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(host_scores.data(), sorted_scores.get(), num_sorted * sizeof(float),
+                                       cudaMemcpyDeviceToHost, Stream()));
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(Stream()));
+
+  // only the boxes up to the last one above score_threshold_ need to be compared
+  int num_candidates = num_sorted;
+  while (num_candidates > 0 && !(host_scores[num_candidates - 1] > score_threshold_))
+    --num_candidates;
+
+  std::vector<int32_t> selected_index(max_output_size_, 0);
+  int64_t num_of_selected = 0;
+  if (num_candidates > 0) {
+    const int col_blocks = static_cast<int>(CeilDiv(num_candidates, kNmsBoxesPerMaskWord));
+    const size_t mask_count = static_cast<size_t>(num_candidates) * col_blocks;
+    auto mask = GetScratchBuffer<uint64_t>(mask_count);
+    NonMaxSuppressionMaskImpl(Stream(), boxes->template Data<T>(), sorted_indices.get(), num_candidates,
+                              iou_threshold_, mask.get());
+
+    std::vector<uint64_t> host_mask(mask_count);
+    std::vector<int64_t> host_indices(num_candidates);
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(host_mask.data(), mask.get(), mask_count * sizeof(uint64_t),
+                                         cudaMemcpyDeviceToHost, Stream()));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(host_indices.data(), sorted_indices.get(), num_candidates * sizeof(int64_t),
+                                         cudaMemcpyDeviceToHost, Stream()));
+    CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(Stream()));
+
+    // visit the candidates by descending score and select each one that no selected box suppresses
+    std::vector<uint64_t> suppressed(col_blocks, 0);
+    for (int i = 0; i < num_candidates && num_of_selected < max_output_size_; ++i) {
+      const int word = i / kNmsBoxesPerMaskWord;
+      if (!(host_scores[i] > score_threshold_) || (suppressed[word] >> (i % kNmsBoxesPerMaskWord)) & 1)
+        continue;
+
+      selected_index[num_of_selected++] = static_cast<int32_t>(host_indices[i]);
+      const uint64_t* box_mask = host_mask.data() + static_cast<size_t>(i) * col_blocks;
+      for (int j = word; j < col_blocks; ++j)
+        suppressed[j] |= box_mask[j];
+    }
+  }
+
+  int64_t num_to_copy = pad_to_max_output_size_ == 1 ? max_output_size_ : num_of_selected;
+  TensorShape output_shape({num_to_copy});
+  Tensor* selected_indices = ctx->Output(0, output_shape);
+  // copies from pageable host memory return once the source has been read, so the host buffers can go out of scope
+  if (num_to_copy > 0) {
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(selected_indices->template MutableData<int32_t>(), selected_index.data(),
+                                         num_to_copy * sizeof(int32_t), cudaMemcpyHostToDevice, Stream()));
+  }
+
+  TensorShape valid_outputs_shape({1});
+  Tensor* valid_outputs = ctx->Output(1, valid_outputs_shape);
+  if (valid_outputs) {
+    const int32_t valid_count = static_cast<int32_t>(num_of_selected);
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(valid_outputs->template MutableData<int32_t>(), &valid_count,
+                                         sizeof(int32_t), cudaMemcpyHostToDevice, Stream()));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
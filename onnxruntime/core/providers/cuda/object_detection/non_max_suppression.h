@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/non_max_suppression.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Sorts the boxes by score and computes the IoU of every pair of candidates on the device. Only the bitmask of
+// the suppressed pairs is copied to the host for the greedy selection, which is sequential.
+template <typename T>
+class NonMaxSuppression final : public CudaKernel, public contrib::NonMaxSuppressionBase {
+ public:
+  NonMaxSuppression(const OpKernelInfo& info) : CudaKernel(info), contrib::NonMaxSuppressionBase(info) {
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cuda_runtime.h>
+#include "non_max_suppression_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+struct NmsBox {
+  float x_min;
+  float y_min;
+  float x_max;
+  float y_max;
+};
+
+__device__ __inline__ NmsBox LoadBox(const float* boxes, int64_t index) {
+  const float* box = boxes + 4 * index;
+  NmsBox result;
+  result.y_min = fminf(box[0], box[2]);
+  result.y_max = fmaxf(box[0], box[2]);
+  result.x_min = fminf(box[1], box[3]);
+  result.x_max = fmaxf(box[1], box[3]);
+  return result;
+}
+
+// same conditions as NonMaxSuppression<float>::SuppressByIOU on the CPU
+__device__ __inline__ bool SuppressByIOU(const NmsBox& a, const NmsBox& b, float iou_threshold) {
+  const float intersection_area = fmaxf(fminf(a.x_max, b.x_max) - fmaxf(a.x_min, b.x_min), 0.0f) *
+                                  fmaxf(fminf(a.y_max, b.y_max) - fmaxf(a.y_min, b.y_min), 0.0f);
+  if (intersection_area <= 0.0f)
+    return false;
+
+  const float area_a = (a.x_max - a.x_min) * (a.y_max - a.y_min);
+  const float area_b = (b.x_max - b.x_min) * (b.y_max - b.y_min);
+  const float union_area = area_a + area_b - intersection_area;
+  if (area_a <= 0.0f || area_b <= 0.0f || union_area <= 0.0f)
+    return false;
+
+  return intersection_area / union_area > iou_threshold;
+}
+
+// block (j, i) compares the boxes of row block i with those of column block j, a thread per row box
+__global__ void _NonMaxSuppressionMask(
+    const float* boxes,
+    const int64_t* sorted_indices,
+    const int num_sorted,
+    const float iou_threshold,
+    const int col_blocks,
+    uint64_t* mask) {
+  const int row_block = blockIdx.y;
+  const int col_block = blockIdx.x;
+  if (col_block < row_block)
+    return;
+
+  __shared__ NmsBox col_boxes[kNmsBoxesPerMaskWord];
+  const int col_start = col_block * kNmsBoxesPerMaskWord;
+  const int col_count = min(num_sorted - col_start, kNmsBoxesPerMaskWord);
+  if (threadIdx.x < col_count)
+    col_boxes[threadIdx.x] = LoadBox(boxes, sorted_indices[col_start + threadIdx.x]);
+  __syncthreads();
+
+  const int row = row_block * kNmsBoxesPerMaskWord + threadIdx.x;
+  if (row >= num_sorted)
+    return;
+
+  const NmsBox row_box = LoadBox(boxes, sorted_indices[row]);
+  uint64_t bits = 0;
+  for (int c = col_block == row_block ? threadIdx.x + 1 : 0; c < col_count; ++c) {
+    if (SuppressByIOU(row_box, col_boxes[c], iou_threshold))
+      bits |= 1ULL << c;
+  }
+  mask[static_cast<int64_t>(row) * col_blocks + col_block] = bits;
+}
+
+void NonMaxSuppressionMaskImpl(
+    cudaStream_t stream,
+    const float* boxes,
+    const int64_t* sorted_indices,
+    int num_sorted,
+    float iou_threshold,
+    uint64_t* mask) {
+  const int col_blocks = static_cast<int>(CeilDiv(num_sorted, kNmsBoxesPerMaskWord));
+  const dim3 blocks(col_blocks, col_blocks);
+  _NonMaxSuppressionMask<<<blocks, kNmsBoxesPerMaskWord, 0, stream>>>(
+      boxes, sorted_indices, num_sorted, iou_threshold, col_blocks, mask);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
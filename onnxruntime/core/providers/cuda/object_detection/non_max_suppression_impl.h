@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include <cuda_runtime.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+constexpr int kNmsBoxesPerMaskWord = 64;
+
+// For the num_sorted boxes in sorted_indices, sets bit b of mask[i * col_blocks + j] if box 64 * j + b comes after
+// box i and their IoU (intersection over union) is above iou_threshold, with col_blocks = ceil(num_sorted / 64).
+// Words for j < i / 64 are left unset.
+// Boxes are [y1, x1, y2, x2] with the corners in either order, like the CPU kernel.
+void NonMaxSuppressionMaskImpl(
+    cudaStream_t stream,
+    const float* boxes,
+    const int64_t* sorted_indices,
+    int num_sorted,
+    float iou_threshold,
+    uint64_t* mask);
+
+}  // namespace cuda
+}  // namespace onnxruntime
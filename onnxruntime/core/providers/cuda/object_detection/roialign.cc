@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/object_detection/roialign.h"
+#include "core/providers/cuda/object_detection/roialign_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      ROIAlign,                                                   \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      ROIAlign<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+
+template <typename T>
+Status ROIAlign<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X_ptr = context->Input<Tensor>(0);
+  if (!X_ptr) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Null input X ptr");
+  }
+
+  const Tensor* rois_ptr = context->Input<Tensor>(1);
+  if (!rois_ptr) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Null rois_ptr");
+  }
+
+  auto& x_dims = X_ptr->Shape();
+  auto& rois_dims = rois_ptr->Shape();
+
+  // validate rois_dims
+  if (rois_dims.NumDimensions() != 2) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Number of dimensions for rois should be exactly 2");
+  }
+  if (rois_dims[1] != 5) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Second dimension for rois should be exactly 5");
+  }
+
+  auto& Y = *context->Output(0, {rois_dims[0], x_dims[1], pooled_h_, pooled_w_});
+  int64_t output_size = Y.Shape().Size();
+  if (output_size == 0)
+    return Status::OK();
+
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  RoiAlignImpl<CudaT>(
+      Stream(),
+      output_size,
+      reinterpret_cast<const CudaT*>(X_ptr->template Data<T>()),
+      static_cast<CudaT>(spatial_scale_),
+      x_dims[1],
+      x_dims[2],
+      x_dims[3],
+      pooled_h_,
+      pooled_w_,
+      sampling_ratio_,
+      reinterpret_cast<const CudaT*>(rois_ptr->template Data<T>()),
+      rois_dims[1],
+      reinterpret_cast<CudaT*>(Y.template MutableData<T>()),
+      mode_ == "avg");
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/roialign.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+class ROIAlign final : public CudaKernel, public contrib::ROIAlignBase {
+ public:
+  ROIAlign(const OpKernelInfo& info) : CudaKernel(info), contrib::ROIAlignBase(info) {
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ROIAlign);
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
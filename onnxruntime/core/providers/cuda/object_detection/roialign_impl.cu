@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cuda_runtime.h>
+#include "roialign_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+__device__ __inline__ T _Max(T a, T b) {
+  return a > b ? a : b;
+}
+
+// bilinear interpolation weights and offsets of a sampling point, as in pre_calc_for_bilinear_interpolate on the CPU
+template <typename T>
+__device__ __inline__ void BilinearInterpolate(
+    T y,
+    T x,
+    const int64_t height,
+    const int64_t width,
+    T& w1, T& w2, T& w3, T& w4,
+    int64_t& pos1, int64_t& pos2, int64_t& pos3, int64_t& pos4) {
+  // deal with: inverse elements are out of feature map boundary
+  if (y < -1.0 || y > height || x < -1.0 || x > width) {
+    w1 = w2 = w3 = w4 = 0;
+    pos1 = pos2 = pos3 = pos4 = 0;
+    return;
+  }
+
+  if (y <= 0) {
+    y = 0;
+  }
+  if (x <= 0) {
+    x = 0;
+  }
+
+  int64_t y_low = static_cast<int64_t>(y);
+  int64_t x_low = static_cast<int64_t>(x);
+  int64_t y_high;
+  int64_t x_high;
+
+  if (y_low >= height - 1) {
+    y_high = y_low = height - 1;
+    y = (T)y_low;
+  } else {
+    y_high = y_low + 1;
+  }
+
+  if (x_low >= width - 1) {
+    x_high = x_low = width - 1;
+    x = (T)x_low;
+  } else {
+    x_high = x_low + 1;
+  }
+
+  T ly = y - y_low;
+  T lx = x - x_low;
+  T hy = static_cast<T>(1.) - ly, hx = static_cast<T>(1.) - lx;
+  w1 = hy * hx;
+  w2 = hy * lx;
+  w3 = ly * hx;
+  w4 = ly * lx;
+  pos1 = y_low * width + x_low;
+  pos2 = y_low * width + x_high;
+  pos3 = y_high * width + x_low;
+  pos4 = y_high * width + x_high;
+}
+
+template <typename T>
+__global__ void _RoiAlignKernel(
+    const int64_t nthreads,
+    const T* bottom_data,
+    const T spatial_scale,
+    const int64_t channels,
+    const int64_t height,
+    const int64_t width,
+    const int64_t pooled_height,
+    const int64_t pooled_width,
+    const int64_t sampling_ratio,
+    const T* bottom_rois,
+    const int64_t roi_cols,
+    T* top_data,
+    const bool is_mode_avg) {
+  for (int64_t index = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; index < nthreads;
+       index += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    // (n, c, ph, pw) is an element in the pooled output
+    const int64_t pw = index % pooled_width;
+    const int64_t ph = (index / pooled_width) % pooled_height;
+    const int64_t c = (index / pooled_width / pooled_height) % channels;
+    const int64_t n = index / pooled_width / pooled_height / channels;
+
+    const T* offset_bottom_rois = bottom_rois + n * roi_cols;
+    const int64_t roi_batch_ind = static_cast<int64_t>(offset_bottom_rois[0]);
+    offset_bottom_rois++;
+
+    // Do not using rounding; this implementation detail is critical
+    T roi_start_w = offset_bottom_rois[0] * spatial_scale;
+    T roi_start_h = offset_bottom_rois[1] * spatial_scale;
+    T roi_end_w = offset_bottom_rois[2] * spatial_scale;
+    T roi_end_h = offset_bottom_rois[3] * spatial_scale;
+
+    // Force malformed ROIs to be 1x1
+    T roi_width = _Max(roi_end_w - roi_start_w, (T)1.);
+    T roi_height = _Max(roi_end_h - roi_start_h, (T)1.);
+    T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
+    T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
+
+    const T* offset_bottom_data = bottom_data + (roi_batch_ind * channels + c) * height * width;
+
+    // We use roi_bin_grid to sample the grid and mimic integral
+    const int64_t roi_bin_grid_h = (sampling_ratio > 0)
+                                       ? sampling_ratio
+                                       : static_cast<int64_t>(_Ceil(roi_height / pooled_height));  // e.g., = 2
+    const int64_t roi_bin_grid_w =
+        (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(_Ceil(roi_width / pooled_width));
+
+    // We do average (integral) pooling inside a bin
+    const T count = static_cast<T>(roi_bin_grid_h * roi_bin_grid_w);  // e.g. = 4
+
+    T output_val = 0.;
+    bool max_flag = false;
+    for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
+      const T y = roi_start_h + ph * bin_size_h +
+                  static_cast<T>(iy + .5f) * bin_size_h / static_cast<T>(roi_bin_grid_h);  // e.g., 0.5, 1.5
+      for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
+        const T x = roi_start_w + pw * bin_size_w +
+                    static_cast<T>(ix + .5f) * bin_size_w / static_cast<T>(roi_bin_grid_w);
+
+        T w1, w2, w3, w4;
+        int64_t pos1, pos2, pos3, pos4;
+        BilinearInterpolate(y, x, height, width, w1, w2, w3, w4, pos1, pos2, pos3, pos4);
+
+        if (is_mode_avg) {
+          output_val += w1 * offset_bottom_data[pos1] + w2 * offset_bottom_data[pos2] +
+                        w3 * offset_bottom_data[pos3] + w4 * offset_bottom_data[pos4];
+        } else if (!max_flag) {
+          // max mode matches the CPU kernel, which starts from the first weighted corner of the first sample
+          output_val = w1 * offset_bottom_data[pos1];
+          max_flag = true;
+        } else {
+          output_val = _Max(_Max(_Max(output_val, w2 * offset_bottom_data[pos2]), w3 * offset_bottom_data[pos3]),
+                            w4 * offset_bottom_data[pos4]);
+        }
+      }
+    }
+    if (is_mode_avg)
+      output_val /= count;
+
+    top_data[index] = output_val;
+  }
+}
+
+template <typename T>
+void RoiAlignImpl(
+    cudaStream_t stream,
+    const int64_t nthreads,
+    const T* bottom_data,
+    const T spatial_scale,
+    const int64_t channels,
+    const int64_t height,
+    const int64_t width,
+    const int64_t pooled_height,
+    const int64_t pooled_width,
+    const int64_t sampling_ratio,
+    const T* bottom_rois,
+    int64_t roi_cols,
+    T* top_data,
+    const bool is_mode_avg) {
+  const int blocks = static_cast<int>(std::min<int64_t>(CeilDiv(nthreads, static_cast<int64_t>(GridDim::maxThreadsPerBlock)),
+                                                        GridDim::maxThreadsPerBlock * 64));
+  _RoiAlignKernel<T><<<blocks, GridDim::maxThreadsPerBlock, 0, stream>>>(
+      nthreads, bottom_data, spatial_scale, channels, height, width, pooled_height, pooled_width, sampling_ratio,
+      bottom_rois, roi_cols, top_data, is_mode_avg);
+}
+
+#define SPECIALIZED_IMPL(T)                                                                                     \
+  template void RoiAlignImpl<T>(cudaStream_t stream, const int64_t nthreads, const T* bottom_data,             \
+                                const T spatial_scale, const int64_t channels, const int64_t height,           \
+                                const int64_t width, const int64_t pooled_height, const int64_t pooled_width,  \
+                                const int64_t sampling_ratio, const T* bottom_rois, int64_t roi_cols,         \
+                                T* top_data, const bool is_mode_avg);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+
+}  // namespace cuda
+}  // namespace onnxruntime
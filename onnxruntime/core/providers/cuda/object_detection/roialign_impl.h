@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include <cuda_runtime.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// Computes each element of the [num_rois, channels, pooled_height, pooled_width] output in its own thread, with the
+// same sampling and bilinear interpolation as the CPU ROIAlign kernel.
+// rois are [batch_index, x1, y1, x2, y2] rows of roi_cols elements.
+template <typename T>
+void RoiAlignImpl(
+    cudaStream_t stream,
+    const int64_t nthreads,
+    const T* bottom_data,
+    const T spatial_scale,
+    const int64_t channels,
+    const int64_t height,
+    const int64_t width,
+    const int64_t pooled_height,
+    const int64_t pooled_width,
+    const int64_t sampling_ratio,
+    const T* bottom_rois,
+    int64_t roi_cols,
+    T* top_data,
+    const bool is_mode_avg);
+
+}  // namespace cuda
+}  // namespace onnxruntime
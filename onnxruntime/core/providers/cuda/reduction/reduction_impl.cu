@@ -0,0 +1,333 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cuda_runtime.h>
+#include "reduction_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+constexpr int kWarpSize = 32;
+constexpr int kReduceThreadsPerBlock = 256;
+constexpr int kReduceWarpsPerBlock = kReduceThreadsPerBlock / kWarpSize;
+// rows up to this size are reduced by a single warp
+constexpr int kMaxWarpRowSize = 512;
+// a row is only split across blocks if each block still gets this many elements
+constexpr int kMinElementsPerBlock = 8 * kReduceThreadsPerBlock;
+// rows are split across blocks until there are about this many blocks
+constexpr int kTargetBlocks = 512;
+
+int CeilDivInt(int a, int b) {
+  return (a + b - 1) / b;
+}
+
+// blocks each row is split into when rows are reduced by blocks
+int BlocksPerRow(int num_rows, int row_size) {
+  if (row_size <= kMaxWarpRowSize)
+    return 1;
+  const int max_blocks = std::max(1, CeilDivInt(row_size, kMinElementsPerBlock));
+  return std::max(1, std::min(max_blocks, kTargetBlocks / num_rows));
+}
+
+}  // namespace
+
+// type the reduction is accumulated in
+template <typename T>
+struct ReduceAccumulateType {
+  typedef T type;
+};
+
+template <>
+struct ReduceAccumulateType<half> {
+  typedef float type;
+};
+
+template <typename T>
+__device__ __inline__ T ShuffleDown(T value, int offset) {
+  return __shfl_down_sync(0xffffffff, value, offset);
+}
+
+template <typename T>
+struct ReduceCombine {
+  ReductionKind kind;
+
+  __device__ __inline__ T Identity() const {
+    switch (kind) {
+      case ReductionKind::Max:
+        return T(-INFINITY);
+      case ReductionKind::Min:
+        return T(INFINITY);
+      case ReductionKind::Prod:
+        return T(1);
+      default:
+        return T(0);
+    }
+  }
+
+  // applied to each input element before it is combined, on the first pass only
+  __device__ __inline__ T Transform(T a) const {
+    switch (kind) {
+      case ReductionKind::L1:
+        return _Abs(a);
+      case ReductionKind::L2:
+      case ReductionKind::SumSquare:
+        return a * a;
+      default:
+        return a;
+    }
+  }
+
+  __device__ __inline__ T operator()(T a, T b) const {
+    switch (kind) {
+      case ReductionKind::Max:
+        // a != a is true for NaN, which must win like in cudnnReduceTensor with CUDNN_PROPAGATE_NAN
+        return (a > b || a != a) ? a : b;
+      case ReductionKind::Min:
+        return (a < b || a != a) ? a : b;
+      case ReductionKind::Prod:
+        return a * b;
+      default:
+        return a + b;
+    }
+  }
+
+  // applied to the result of a row. scale is 1 / row_size.
+  __device__ __inline__ T Finalize(T a, T scale) const {
+    switch (kind) {
+      case ReductionKind::Mean:
+        return a * scale;
+      case ReductionKind::L2:
+        return _Sqrt(a);
+      case ReductionKind::LogSum:
+        return _Log(a);
+      default:
+        return a;
+    }
+  }
+};
+
+template <typename T, typename Combine>
+__device__ __inline__ T WarpReduce(T value, const Combine& combine) {
+#pragma unroll
+  for (int offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    value = combine(value, ShuffleDown(value, offset));
+  }
+  return value;
+}
+
+// the result is only valid in thread 0
+template <typename T, typename Combine>
+__device__ __inline__ T BlockReduce(T value, const Combine& combine, T identity) {
+  __shared__ T warp_results[kReduceWarpsPerBlock];
+  const int lane = threadIdx.x % kWarpSize;
+  const int warp = threadIdx.x / kWarpSize;
+
+  value = WarpReduce(value, combine);
+  if (lane == 0)
+    warp_results[warp] = value;
+  __syncthreads();
+
+  if (warp == 0) {
+    value = lane < kReduceWarpsPerBlock ? warp_results[lane] : identity;
+    value = WarpReduce(value, combine);
+  }
+  return value;
+}
+
+// each warp reduces one row
+template <typename TIn, typename TOut, typename TAcc>
+__global__ void _ReduceRowsWarpKernel(
+    const ReduceCombine<TAcc> combine,
+    const TIn* input,
+    TOut* output,
+    const int num_rows,
+    const int row_size,
+    const TAcc scale) {
+  const int row = blockIdx.x * kReduceWarpsPerBlock + threadIdx.x / kWarpSize;
+  // the whole warp leaves together, so the shuffles below always have every lane
+  if (row >= num_rows)
+    return;
+
+  const int lane = threadIdx.x % kWarpSize;
+  const TIn* row_input = input + static_cast<int64_t>(row) * row_size;
+  TAcc value = combine.Identity();
+  for (int i = lane; i < row_size; i += kWarpSize) {
+    value = combine(value, combine.Transform(TAcc(row_input[i])));
+  }
+  value = WarpReduce(value, combine);
+  if (lane == 0)
+    output[row] = TOut(combine.Finalize(value, scale));
+}
+
+// each block reduces a contiguous part of a row. with blocks_per_row > 1 the partial result of each
+// block is written to output[blockIdx.x], in the element type of the accumulation, for a second pass.
+template <typename TIn, typename TOut, typename TAcc>
+__global__ void _ReduceRowsBlockKernel(
+    const ReduceCombine<TAcc> combine,
+    const bool transform,
+    const bool finalize,
+    const TIn* input,
+    TOut* output,
+    const int row_size,
+    const int blocks_per_row,
+    const TAcc scale) {
+  const int row = blockIdx.x / blocks_per_row;
+  const int part = blockIdx.x % blocks_per_row;
+  const int part_size = (row_size + blocks_per_row - 1) / blocks_per_row;
+  const int begin = part * part_size;
+  const int end = min(row_size, begin + part_size);
+
+  const TIn* row_input = input + static_cast<int64_t>(row) * row_size;
+  const TAcc identity = combine.Identity();
+  TAcc value = identity;
+  for (int i = begin + threadIdx.x; i < end; i += blockDim.x) {
+    const TAcc element = TAcc(row_input[i]);
+    value = combine(value, transform ? combine.Transform(element) : element);
+  }
+  value = BlockReduce(value, combine, identity);
+  if (threadIdx.x == 0)
+    output[blockIdx.x] = TOut(finalize ? combine.Finalize(value, scale) : value);
+}
+
+template <typename T>
+size_t ReduceRowsBufferBytes(int num_rows, int row_size) {
+  typedef typename ReduceAccumulateType<T>::type TAcc;
+  const int blocks_per_row = BlocksPerRow(num_rows, row_size);
+  return blocks_per_row > 1 ? static_cast<size_t>(num_rows) * blocks_per_row * sizeof(TAcc) : 0;
+}
+
+template <typename T>
+void ReduceRowsImpl(
+    cudaStream_t stream,
+    ReductionKind kind,
+    const T* input,
+    T* output,
+    int num_rows,
+    int row_size,
+    void* buffer) {
+  typedef typename ReduceAccumulateType<T>::type TAcc;
+  const ReduceCombine<TAcc> combine{kind};
+  const TAcc scale = TAcc(1) / TAcc(row_size);
+
+  if (row_size <= kMaxWarpRowSize) {
+    const int blocks = CeilDivInt(num_rows, kReduceWarpsPerBlock);
+    _ReduceRowsWarpKernel<T, T, TAcc><<<blocks, kReduceThreadsPerBlock, 0, stream>>>(
+        combine, input, output, num_rows, row_size, scale);
+    return;
+  }
+
+  const int blocks_per_row = BlocksPerRow(num_rows, row_size);
+  if (blocks_per_row == 1) {
+    _ReduceRowsBlockKernel<T, T, TAcc><<<num_rows, kReduceThreadsPerBlock, 0, stream>>>(
+        combine, true, true, input, output, row_size, 1, scale);
+    return;
+  }
+
+  // reduce the parts of each row to one partial result per block, then the partial results of each row
+  TAcc* partials = reinterpret_cast<TAcc*>(buffer);
+  _ReduceRowsBlockKernel<T, TAcc, TAcc><<<num_rows * blocks_per_row, kReduceThreadsPerBlock, 0, stream>>>(
+      combine, true, false, input, partials, row_size, blocks_per_row, scale);
+  _ReduceRowsBlockKernel<TAcc, T, TAcc><<<num_rows, kReduceThreadsPerBlock, 0, stream>>>(
+      combine, false, true, partials, output, blocks_per_row, 1, scale);
+}
+
+// running count, mean and sum of squared differences from the mean of a set of elements
+template <typename T>
+struct WelfordState {
+  T count;
+  T mean;
+  T m2;
+};
+
+template <typename T>
+__device__ __inline__ WelfordState<T> ShuffleDown(WelfordState<T> state, int offset) {
+  return WelfordState<T>{ShuffleDown(state.count, offset), ShuffleDown(state.mean, offset),
+                         ShuffleDown(state.m2, offset)};
+}
+
+template <typename T>
+struct WelfordCombine {
+  // merges the statistics of two disjoint sets (Chan et al.)
+  __device__ __inline__ WelfordState<T> operator()(const WelfordState<T>& a, const WelfordState<T>& b) const {
+    const T count = a.count + b.count;
+    if (count == T(0))
+      return a;
+    const T delta = b.mean - a.mean;
+    const T b_fraction = b.count / count;
+    return WelfordState<T>{count, a.mean + delta * b_fraction, a.m2 + b.m2 + delta * delta * a.count * b_fraction};
+  }
+};
+
+template <typename T>
+__device__ __inline__ void WelfordAdd(WelfordState<T>& state, T value) {
+  state.count += T(1);
+  const T delta = value - state.mean;
+  state.mean += delta / state.count;
+  state.m2 += delta * (value - state.mean);
+}
+
+// each warp (use_block == false) or block (use_block == true) computes the statistics of one row
+template <typename TIn, typename TAcc, bool use_block>
+__global__ void _MeanVarianceKernel(
+    const TIn* input,
+    TIn* mean,
+    TIn* variance,
+    const int num_rows,
+    const int row_size) {
+  const int row = use_block ? blockIdx.x : blockIdx.x * kReduceWarpsPerBlock + threadIdx.x / kWarpSize;
+  if (row >= num_rows)
+    return;
+
+  const int first = use_block ? threadIdx.x : threadIdx.x % kWarpSize;
+  const int stride = use_block ? blockDim.x : kWarpSize;
+  const TIn* row_input = input + static_cast<int64_t>(row) * row_size;
+  WelfordState<TAcc> state{TAcc(0), TAcc(0), TAcc(0)};
+  for (int i = first; i < row_size; i += stride) {
+    WelfordAdd(state, TAcc(row_input[i]));
+  }
+
+  const WelfordCombine<TAcc> combine;
+  state = use_block ? BlockReduce(state, combine, WelfordState<TAcc>{TAcc(0), TAcc(0), TAcc(0)})
+                    : WarpReduce(state, combine);
+  if (first == 0) {
+    mean[row] = TIn(state.mean);
+    variance[row] = TIn(state.m2 / state.count);
+  }
+}
+
+template <typename T>
+void MeanVarianceImpl(
+    cudaStream_t stream,
+    const T* input,
+    T* mean,
+    T* variance,
+    int num_rows,
+    int row_size) {
+  typedef typename ReduceAccumulateType<T>::type TAcc;
+  if (row_size <= kMaxWarpRowSize) {
+    const int blocks = CeilDivInt(num_rows, kReduceWarpsPerBlock);
+    _MeanVarianceKernel<T, TAcc, false><<<blocks, kReduceThreadsPerBlock, 0, stream>>>(
+        input, mean, variance, num_rows, row_size);
+  } else {
+    _MeanVarianceKernel<T, TAcc, true><<<num_rows, kReduceThreadsPerBlock, 0, stream>>>(
+        input, mean, variance, num_rows, row_size);
+  }
+}
+
+#define SPECIALIZED_IMPL(T)                                                                                  \
+  template size_t ReduceRowsBufferBytes<T>(int num_rows, int row_size);                                      \
+  template void ReduceRowsImpl<T>(cudaStream_t stream, ReductionKind kind, const T* input, T* output,        \
+                                  int num_rows, int row_size, void* buffer);                                 \
+  template void MeanVarianceImpl<T>(cudaStream_t stream, const T* input, T* mean, T* variance, int num_rows, \
+                                    int row_size);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include <cuda_runtime.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+enum class ReductionKind {
+  Sum,
+  Mean,
+  Max,
+  Min,
+  Prod,
+  L1,
+  L2,
+  LogSum,
+  SumSquare,
+};
+
+// Bytes of the buffer ReduceRowsImpl needs for the partial results of rows that are split across blocks.
+// Returns 0 if no row is split.
+template <typename T>
+size_t ReduceRowsBufferBytes(int num_rows, int row_size);
+
+// Reduces each of the num_rows contiguous rows of row_size elements in input to output[row].
+// This covers reductions over the trailing axes, including over all axes with num_rows == 1.
+// Short rows are reduced by a warp each, longer ones by one or more blocks with warp shuffles.
+// Max and Min propagate NaN like CUDNN_PROPAGATE_NAN. half is accumulated in float.
+template <typename T>
+void ReduceRowsImpl(
+    cudaStream_t stream,
+    ReductionKind kind,
+    const T* input,
+    T* output,
+    int num_rows,
+    int row_size,
+    void* buffer);
+
+// Computes the mean and the biased variance of each of the num_rows contiguous rows of row_size elements
+// in one pass over the input, with Welford's algorithm so large means don't cancel the variance.
+template <typename T>
+void MeanVarianceImpl(
+    cudaStream_t stream,
+    const T* input,
+    T* mean,
+    T* variance,
+    int num_rows,
+    int row_size);
+
+}  // namespace cuda
+}  // namespace onnxruntime
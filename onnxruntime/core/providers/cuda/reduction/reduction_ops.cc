@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "reduction_ops.h"
+#include "reduction_impl.h"
 #include "core/providers/common.h"
 #include "core/providers/cuda/cudnn_common.h"
 #include "core/providers/cuda/math/unary_elementwise_ops_impl.h"
@@ -9,6 +10,8 @@
 #include "core/providers/cuda/math/binary_elementwise_ops.h"
 #include "core/providers/cpu/tensor/utils.h"
 
+#include <limits>
+
 using namespace onnxruntime::common;
 namespace onnxruntime {
 namespace cuda {
@@ -55,6 +58,63 @@ class CudnnReduceDescriptor final {
   cudnnReduceTensorDescriptor_t desc_;
 };
 
+namespace {
+// if only trailing axes are reduced, ignoring axes of size 1, the input is num_rows contiguous rows of
+// row_size elements that each reduce to one output element.
+bool GetContiguousRows(const std::vector<int64_t>& input_dims, const std::vector<bool>& reduced,
+                       int64_t& num_rows, int64_t& row_size) {
+  size_t split = input_dims.size();
+  while (split > 0 && (reduced[split - 1] || input_dims[split - 1] == 1))
+    --split;
+  for (size_t i = 0; i < split; ++i) {
+    if (reduced[i] && input_dims[i] != 1)
+      return false;
+  }
+
+  num_rows = 1;
+  row_size = 1;
+  for (size_t i = 0; i < input_dims.size(); ++i) {
+    (i < split ? num_rows : row_size) *= input_dims[i];
+  }
+  return true;
+}
+
+bool GetReductionKind(cudnnReduceTensorOp_t cudnn_reduce_op, bool calculate_log, bool calculate_sqt,
+                      ReductionKind& kind) {
+  if (cudnn_reduce_op == CUDNN_REDUCE_TENSOR_ADD) {
+    if (calculate_log && calculate_sqt)
+      return false;
+    kind = calculate_sqt ? ReductionKind::SumSquare : (calculate_log ? ReductionKind::LogSum : ReductionKind::Sum);
+    return true;
+  }
+
+  if (calculate_log || calculate_sqt)
+    return false;
+  switch (cudnn_reduce_op) {
+    case CUDNN_REDUCE_TENSOR_AVG:
+      kind = ReductionKind::Mean;
+      return true;
+    case CUDNN_REDUCE_TENSOR_MAX:
+      kind = ReductionKind::Max;
+      return true;
+    case CUDNN_REDUCE_TENSOR_MIN:
+      kind = ReductionKind::Min;
+      return true;
+    case CUDNN_REDUCE_TENSOR_MUL:
+      kind = ReductionKind::Prod;
+      return true;
+    case CUDNN_REDUCE_TENSOR_NORM1:
+      kind = ReductionKind::L1;
+      return true;
+    case CUDNN_REDUCE_TENSOR_NORM2:
+      kind = ReductionKind::L2;
+      return true;
+    default:
+      return false;
+  }
+}
+}  // namespace
+
 template <bool allow_multi_axes>
 template <typename T, cudnnReduceTensorIndices_t ReduceTensorIndices>
 Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnReduceTensorOp_t cudnnReduceOp) const {
@@ -64,13 +124,9 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
   const TensorShape input_shape{X->Shape()};
   const auto rank = input_shape.NumDimensions();
 
-  if (rank > 8) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "cuDNN only supports up to 8-D tensors in reduction");
-  }
-
   const auto& input_dims = input_shape.GetDims();
   std::vector<int64_t> output_dims;
-  std::vector<bool> reduced(rank, false);
+  std::vector<bool> reduced(rank, axes_.empty());
   std::vector<int64_t> squeezed_output_dims;
   if (axes_.size() > 0) {
     output_dims = input_dims;
@@ -95,13 +151,33 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
   Tensor* Y = ctx->Output(0, TensorShape(squeezed_output_dims));
 
   int64_t input_count = input_shape.Size();
+
+  // reductions of contiguous rows, which include reducing the last axes or all of them, don't need cuDNN
+  ReductionKind kind = ReductionKind::Sum;
+  int64_t num_rows = 0;
+  int64_t row_size = 0;
+  if (ReduceTensorIndices == CUDNN_REDUCE_TENSOR_NO_INDICES && !log_sum_exp_ && input_count > 0 &&
+      GetReductionKind(cudnnReduceOp, calculate_log_, calculate_sqt_, kind) &&
+      GetContiguousRows(input_dims, reduced, num_rows, row_size) &&
+      row_size <= std::numeric_limits<int>::max() && num_rows <= std::numeric_limits<int>::max()) {
+    const int rows = static_cast<int>(num_rows);
+    const int size = static_cast<int>(row_size);
+    auto buffer = GetScratchBuffer<void>(ReduceRowsBufferBytes<CudaT>(rows, size));
+    ReduceRowsImpl<CudaT>(Stream(), kind, reinterpret_cast<const CudaT*>(X->template Data<T>()),
+                          reinterpret_cast<CudaT*>(Y->template MutableData<T>()), rows, size, buffer.get());
+    return Status::OK();
+  }
+
+  if (rank > 8) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "cuDNN only supports up to 8-D tensors in reduction");
+  }
   IAllocatorUniquePtr<float> temp_X;
   cudnnDataType_t cudnn_type_X = CudnnTensor::GetDataType<CudaT>();
   if (ReduceTensorIndices == CUDNN_REDUCE_TENSOR_FLATTENED_INDICES && std::is_same<T, MLFloat16>::value) {
     // ArgMax/ArgMin with FP16 are not supported by cudnn, so convert input to fp32 then call cudnn
     temp_X = GetScratchBuffer<float>(input_count);
     cudnn_type_X = CUDNN_DATA_FLOAT;
-    Impl_Cast<CudaT, float>(reinterpret_cast<const CudaT*>(X->template Data<T>()), temp_X.get(), X->Shape().Size());
+    Impl_Cast<CudaT, float>(Stream(), reinterpret_cast<const CudaT*>(X->template Data<T>()), temp_X.get(), X->Shape().Size());
   }
 
   // CUDNN requires at least 3D input, so pad 1s if needed
@@ -133,7 +209,7 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
     if (calculate_sqt_) {
       input_data = reinterpret_cast<CudaT*>(GetScratchBuffer<T>(input_count).get());
       fast_divmod tmp_div;
-      Impl_Mul<CudaT>(static_cast<size_t>(SimpleBroadcast::NoBroadcast), nullptr,
+      Impl_Mul<CudaT>(Stream(), static_cast<size_t>(SimpleBroadcast::NoBroadcast), nullptr,
                       reinterpret_cast<const CudaT*>(X->template Data<T>()), nullptr,
                       reinterpret_cast<const CudaT*>(X->template Data<T>()), nullptr,
                       tmp_div, tmp_div,
@@ -154,7 +230,7 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
       BinaryElementwisePreparation prepare(this);
       prepare.BinaryElementwiseBroadcastPrepareHelper(0, input_shape, output_shape, input_shape);
       prepare.CopyToGpu();
-      Impl_Sub<CudaT>(prepare.output_rank_or_simple_broadcast,
+      Impl_Sub<CudaT>(Stream(), prepare.output_rank_or_simple_broadcast,
                       prepare.lhs_padded_strides.GpuPtr(),
                       reinterpret_cast<const CudaT*>(X->template Data<T>()),
                       prepare.rhs_padded_strides.GpuPtr(),
@@ -163,7 +239,7 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
                       prepare.fdm_H, prepare.fdm_C,
                       reinterpret_cast<CudaT*>(exp_result), input_count);
 
-      Impl_Exp<CudaT>(reinterpret_cast<CudaT*>(exp_result),
+      Impl_Exp<CudaT>(Stream(), reinterpret_cast<CudaT*>(exp_result),
                       reinterpret_cast<CudaT*>(exp_result),
                       input_count);
 
@@ -174,13 +250,13 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
           &zero, output_tensor, reinterpret_cast<CudaT*>(log_sum_result)));
 
       // Log(Sum)
-      Impl_Log<CudaT>(reinterpret_cast<CudaT*>(log_sum_result),
+      Impl_Log<CudaT>(Stream(), reinterpret_cast<CudaT*>(log_sum_result),
                       reinterpret_cast<CudaT*>(log_sum_result),
                       output_count);
 
       // Log + ReduceMax
       fast_divmod tmp_div;
-      Impl_Add<CudaT>(static_cast<size_t>(SimpleBroadcast::NoBroadcast), nullptr,
+      Impl_Add<CudaT>(Stream(), static_cast<size_t>(SimpleBroadcast::NoBroadcast), nullptr,
                       reinterpret_cast<CudaT*>(log_sum_result), nullptr,
                       reinterpret_cast<CudaT*>(Y->template MutableData<T>()), nullptr,
                       tmp_div, tmp_div,
@@ -213,11 +289,11 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
     }
 
     // CUDA reduction index is uint32_t for now, cast it to int64_t according to ONNX spec
-    Impl_Cast<uint32_t, int64_t>(reinterpret_cast<uint32_t*>(indices_cuda.get()), Y->template MutableData<int64_t>(), output_count);
+    Impl_Cast<uint32_t, int64_t>(Stream(), reinterpret_cast<uint32_t*>(indices_cuda.get()), Y->template MutableData<int64_t>(), output_count);
   }
 
   if (calculate_log_) {
-    Impl_Log<CudaT>(reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
+    Impl_Log<CudaT>(Stream(), reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
                     reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
                     output_count);
   }
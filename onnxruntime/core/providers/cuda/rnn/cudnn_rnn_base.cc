@@ -3,6 +3,8 @@
 
 #include "cudnn_rnn_base.h"
 #include "rnn_impl.h"
+#include "persistent_rnn_impl.h"
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
 
 namespace onnxruntime {
@@ -34,7 +36,7 @@ void CudnnRnnBase<T>::SetWeightBias(const cudnnHandle_t handle,
 
   cudnnGetFilterNdDescriptor(filter_desc, 3, &dt, &tf, &numDims, matDims.data());
   int count = matDims[0] * matDims[1] * matDims[2];
-  cudaMemcpyAsync(mem_offset, pos + offset, count * sizeof(T), cudaMemcpyDeviceToDevice);
+  cudaMemcpyAsync(mem_offset, pos + offset, count * sizeof(T), cudaMemcpyDeviceToDevice, Stream());
   offset += count;
 }
 template <typename T>
@@ -129,21 +131,117 @@ Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, cons
   return Status::OK();
 }
 
+template <typename T>
+void CudnnRnnBase<T>::TransposeWeights(const Tensor* R, IAllocatorUniquePtr<T>& target_r_data) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const int gate_size = gsl::narrow_cast<int>(W_lin_layer_id_.size() * hidden_size_);
+  target_r_data = GetScratchBuffer<T>(R->Shape().Size());
+  TransposeRecurrentWeights(Stream(),
+                            reinterpret_cast<const CudaT*>(R->template Data<T>()),
+                            reinterpret_cast<CudaT*>(target_r_data.get()),
+                            gsl::narrow_cast<int>(num_directions_),
+                            gate_size,
+                            gsl::narrow_cast<int>(hidden_size_));
+}
+
+template <typename T>
+bool CudnnRnnBase<T>::UsePersistentKernel(int64_t batch_size) const {
+  if ((rnn_mode_ != CUDNN_LSTM && rnn_mode_ != CUDNN_GRU) || num_layers_ != 1 ||
+      batch_size > kPersistentRnnMaxBatchSize) {
+    return false;
+  }
+
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  return CanRunPersistentRnn<CudaT>(rnn_mode_ == CUDNN_LSTM,
+                                    gsl::narrow_cast<int>(num_directions_),
+                                    gsl::narrow_cast<int>(batch_size),
+                                    gsl::narrow_cast<int>(hidden_size_));
+}
+
+template <typename T>
+Status CudnnRnnBase<T>::ComputePersistent(OpKernelContext* ctx, const T* x_data, int64_t seq_length,
+                                          int64_t batch_size, int64_t input_size, T* y_data, T* y_h_data,
+                                          T* y_c_data) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const Tensor& W = *ctx->Input<Tensor>(Input_Index::W);
+  const Tensor* B = ctx->Input<Tensor>(Input_Index::B);
+  const Tensor* initial_h = ctx->Input<Tensor>(Input_Index::initial_h);
+  const Tensor* initial_c = rnn_mode_ == CUDNN_LSTM ? ctx->Input<Tensor>(Input_Index::initial_c) : nullptr;
+
+  IAllocatorUniquePtr<T> r_transposed_data;
+  const T* r_transposed = r_transposed_cache_.get();
+  if (r_transposed == nullptr) {
+    TransposeWeights(ctx->Input<Tensor>(Input_Index::R), r_transposed_data);
+    r_transposed = r_transposed_data.get();
+  }
+
+  // the input projection of every time step and direction in one GEMM: xw = X * W^T
+  const int64_t gate_size = W_lin_layer_id_.size() * hidden_size_;
+  const int64_t xw_cols = num_directions_ * gate_size;
+  auto xw_data = GetScratchBuffer<T>(seq_length * batch_size * xw_cols);
+  CudaT one = ToCudaType<T>::FromFloat(1.0f);
+  CudaT zero = ToCudaType<T>::FromFloat(0.0f);
+  CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
+      CublasHandle(),
+      CUBLAS_OP_T,
+      CUBLAS_OP_N,
+      gsl::narrow<int>(xw_cols),
+      gsl::narrow<int>(seq_length * batch_size),
+      gsl::narrow<int>(input_size),
+      &one,
+      reinterpret_cast<const CudaT*>(W.template Data<T>()),
+      gsl::narrow<int>(input_size),
+      reinterpret_cast<const CudaT*>(x_data),
+      gsl::narrow<int>(input_size),
+      &zero,
+      reinterpret_cast<CudaT*>(xw_data.get()),
+      gsl::narrow<int>(xw_cols)));
+
+  auto buffer = GetScratchBuffer<void>(PersistentRnnBufferBytes<CudaT>(gsl::narrow_cast<int>(num_directions_),
+                                                                       gsl::narrow_cast<int>(batch_size),
+                                                                       gsl::narrow_cast<int>(hidden_size_)));
+  PersistentRnnImpl(Stream(),
+                    rnn_mode_ == CUDNN_LSTM,
+                    reverse_,
+                    gsl::narrow_cast<int>(num_directions_),
+                    gsl::narrow_cast<int>(seq_length),
+                    gsl::narrow_cast<int>(batch_size),
+                    gsl::narrow_cast<int>(hidden_size_),
+                    reinterpret_cast<const CudaT*>(xw_data.get()),
+                    reinterpret_cast<const CudaT*>(r_transposed),
+                    B == nullptr ? nullptr : reinterpret_cast<const CudaT*>(B->template Data<T>()),
+                    initial_h == nullptr ? nullptr : reinterpret_cast<const CudaT*>(initial_h->template Data<T>()),
+                    initial_c == nullptr ? nullptr : reinterpret_cast<const CudaT*>(initial_c->template Data<T>()),
+                    reinterpret_cast<CudaT*>(y_data),
+                    reinterpret_cast<CudaT*>(y_h_data),
+                    reinterpret_cast<CudaT*>(y_c_data),
+                    buffer.get());
+
+  return Status::OK();
+}
+
 template <typename T>
 Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   // Cache the weight
-  const Tensor* W;
-  const Tensor* R;
-  const Tensor* B;
+  const Tensor* W = nullptr;
+  const Tensor* R = nullptr;
+  const Tensor* B = nullptr;
   bool get_W = info.TryGetConstantInput(Input_Index::W, &W);
   bool get_R = info.TryGetConstantInput(Input_Index::R, &R);
+  // a B that is computed at run time can't be packed with the constant W and R
+  const auto& input_defs = info.node().InputDefs();
+  bool has_B = input_defs.size() > static_cast<size_t>(Input_Index::B) && input_defs[Input_Index::B]->Exists();
+  bool get_B = !has_B || info.TryGetConstantInput(Input_Index::B, &B);
 
-  if (get_W && get_R) {
-    info.TryGetConstantInput(Input_Index::B, &B);
+  if (get_W && get_R && get_B) {
     ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_));
     weight_cached_ = true;
   }
 
+  if (get_R && (rnn_mode_ == CUDNN_LSTM || rnn_mode_ == CUDNN_GRU)) {
+    TransposeWeights(R, r_transposed_cache_);
+  }
+
   return Status::OK();
 }
 
@@ -175,6 +273,29 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
   Tensor* Y_h = ctx->Output(Output_Index::Y_h, dims_hxy);
   Tensor* Y_c = ctx->Output(Output_Index::Y_c, dims_yc);
 
+  const T* hx_data = (initial_h == nullptr) ? nullptr : initial_h->template Data<T>();
+  const T* cx_data = (initial_c == nullptr) ? nullptr : initial_c->template Data<T>();
+  T* y_h_data = (Y_h == nullptr) ? nullptr : Y_h->template MutableData<T>();
+  T* y_c_data = (Y_c == nullptr) ? nullptr : Y_c->template MutableData<T>();
+  int64_t output_size = seq_length * num_directions_ * batch_size * hidden_size_;
+  T* y_data = nullptr;
+  IAllocatorUniquePtr<T> y_alloc_data;
+  if (Y != nullptr) {
+    y_data = Y->template MutableData<T>();
+  } else {
+    y_alloc_data = GetScratchBuffer<T>(output_size);
+    y_data = y_alloc_data.get();
+  }
+  const int32_t* sequence_lens_data = (sequence_lens == nullptr) ? nullptr : sequence_lens->template Data<int32_t>();
+
+  if (UsePersistentKernel(batch_size)) {
+    // the persistent kernel writes Y in the ONNX layout, so only the sequence lengths are left to apply
+    ORT_RETURN_IF_ERROR(ComputePersistent(ctx, X->template Data<T>(), seq_length, batch_size, input_size,
+                                          y_data, y_h_data, y_c_data));
+    ApplySequenceLengths(sequence_lens_data, seq_length, batch_size, output_size, y_data, y_h_data);
+    return Status::OK();
+  }
+
   std::vector<int64_t> dims_x({batch_size, input_size, 1});
   std::vector<int64_t> dims_y({batch_size, hidden_size_ * num_directions_, 1});
 
@@ -201,7 +322,7 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     const Tensor& W = *ctx->Input<Tensor>(Input_Index::W);
     const Tensor& R = *ctx->Input<Tensor>(Input_Index::R);
     const Tensor* B = ctx->Input<Tensor>(Input_Index::B);
-    ReorganizeWeights(&W, &R, B, w_data, w_desc);
+    ORT_RETURN_IF_ERROR(ReorganizeWeights(&W, &R, B, w_data, w_desc));
   }
 
   IAllocatorUniquePtr<T> x_reversed_data;
@@ -209,7 +330,8 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
   if (reverse_) {
     // reverse input data
     x_reversed_data = GetScratchBuffer<T>(seq_length * batch_size * input_size);
-    ReverseBySequence(gsl::narrow_cast<int32_t>(seq_length),
+    ReverseBySequence(Stream(),
+                      gsl::narrow_cast<int32_t>(seq_length),
                       gsl::narrow_cast<int32_t>(batch_size),
                       gsl::narrow_cast<int32_t>(input_size),
                       reinterpret_cast<CudaT*>(x_data),
@@ -218,21 +340,6 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     x_data = x_reversed_data.get();
   }
 
-  const T* hx_data = (initial_h == nullptr) ? nullptr : initial_h->template Data<T>();
-  const T* cx_data = (initial_c == nullptr) ? nullptr : initial_c->template Data<T>();
-  T* y_h_data = (Y_h == nullptr) ? nullptr : Y_h->template MutableData<T>();
-  T* y_c_data = (Y_c == nullptr) ? nullptr : Y_c->template MutableData<T>();
-  int64_t output_size = seq_length * num_directions_ * batch_size * hidden_size_;
-  T* y_data = nullptr;
-  IAllocatorUniquePtr<T> y_alloc_data;
-  if (Y != nullptr) {
-    y_data = Y->template MutableData<T>();
-  } else {
-    y_alloc_data = GetScratchBuffer<T>(output_size);
-    y_data = y_alloc_data.get();
-  }
-  const int32_t* sequence_lens_data = (sequence_lens == nullptr) ? nullptr : sequence_lens->template Data<int32_t>();
-
   size_t workspace_bytes;
   CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc_, gsl::narrow_cast<int>(seq_length), x_desc.data(), &workspace_bytes));
   workspace_bytes *= num_directions_;
@@ -263,14 +370,16 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     y_reorganized_data = GetScratchBuffer<T>(output_size);
     if (reverse_) {
       //reverse output data
-      ReverseBySequence(gsl::narrow_cast<int32_t>(seq_length),
+      ReverseBySequence(Stream(),
+                        gsl::narrow_cast<int32_t>(seq_length),
                         gsl::narrow_cast<int32_t>(batch_size),
                         gsl::narrow_cast<int32_t>(hidden_size_),
                         reinterpret_cast<CudaT*>(y_data),
                         reinterpret_cast<CudaT*>(y_reorganized_data.get()),
                         output_size);
     } else {
-      ReorderBidirectionalDataInSequence(gsl::narrow_cast<int32_t>(seq_length),
+      ReorderBidirectionalDataInSequence(Stream(),
+                                         gsl::narrow_cast<int32_t>(seq_length),
                                          gsl::narrow_cast<int32_t>(batch_size),
                                          gsl::narrow_cast<int32_t>(hidden_size_),
                                          reinterpret_cast<CudaT*>(y_data),
@@ -280,14 +389,25 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
 
     if (Y != nullptr) {
       // User specified this optional output, so need to copy the reversed data to orignial place
-      cudaMemcpyAsync(y_data, y_reorganized_data.get(), output_size * sizeof(T), cudaMemcpyDeviceToDevice);
+      cudaMemcpyAsync(y_data, y_reorganized_data.get(), output_size * sizeof(T), cudaMemcpyDeviceToDevice, Stream());
     } else {
       y_data = y_reorganized_data.get();
     }
   }
 
+  ApplySequenceLengths(sequence_lens_data, seq_length, batch_size, output_size, y_data, y_h_data);
+
+  return Status::OK();
+}
+
+template <typename T>
+void CudnnRnnBase<T>::ApplySequenceLengths(const int32_t* sequence_lens_data, int64_t seq_length,
+                                           int64_t batch_size, int64_t output_size, T* y_data,
+                                           T* y_h_data) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
   if (sequence_lens_data != nullptr && y_h_data != nullptr && y_data != nullptr) {
-    RnnMaskImpl(gsl::narrow_cast<int32_t>(num_directions_),
+    RnnMaskImpl(Stream(),
+                gsl::narrow_cast<int32_t>(num_directions_),
                 gsl::narrow_cast<int32_t>(seq_length),
                 gsl::narrow_cast<int32_t>(batch_size),
                 gsl::narrow_cast<int32_t>(hidden_size_),
@@ -296,8 +416,6 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
                 reinterpret_cast<CudaT*>(y_h_data),
                 output_size);
   }
-
-  return Status::OK();
 }
 
 template class CudnnRnnBase<float>;
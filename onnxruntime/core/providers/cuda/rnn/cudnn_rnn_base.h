@@ -104,6 +104,7 @@ class CudnnRnnBase : public CudaKernel {
     num_layers_ = 1;
     weight_cached_ = false;
     w_data_cache_ = nullptr;
+    r_transposed_cache_ = nullptr;
   }
 
   Status SetCudnnRnnDesc();
@@ -126,6 +127,19 @@ class CudnnRnnBase : public CudaKernel {
                            IAllocatorUniquePtr<void>& target_w_data,
                            CudnnFilterDescriptor& target_w_desc) const;
 
+  // lays R out for the persistent kernel, see TransposeRecurrentWeights
+  void TransposeWeights(const Tensor* R, IAllocatorUniquePtr<T>& target_r_data) const;
+
+  // LSTM and GRU with small batches run the whole sequence in one persistent kernel, as cuDNN is dominated
+  // by its per time step launches there
+  bool UsePersistentKernel(int64_t batch_size) const;
+  Status ComputePersistent(OpKernelContext* ctx, const T* x_data, int64_t seq_length, int64_t batch_size,
+                           int64_t input_size, T* y_data, T* y_h_data, T* y_c_data) const;
+
+  // masks Y and Y_h past the sequence length of each batch entry
+  void ApplySequenceLengths(const int32_t* sequence_lens_data, int64_t seq_length, int64_t batch_size,
+                            int64_t output_size, T* y_data, T* y_h_data) const;
+
   void SetWeightBias(const cudnnHandle_t handle,
                      const cudnnRNNDescriptor_t rnn_desc,
                      const int pseudo_layer,
@@ -155,6 +169,8 @@ class CudnnRnnBase : public CudaKernel {
   CudnnFilterDescriptor w_desc_cache_;
   IAllocatorUniquePtr<void> w_data_cache_;
   bool weight_cached_;
+  // R transposed for the persistent kernel, when R is a constant input
+  IAllocatorUniquePtr<T> r_transposed_cache_;
 
   enum Input_Index {
     X = 0,
@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cuda_runtime.h>
+#include "persistent_rnn_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+constexpr int kPersistentRnnThreadsPerBlock = 256;
+// the barrier counter is padded so the hidden states after it stay aligned
+constexpr size_t kBarrierBytes = 256;
+
+int PersistentRnnBlocks(int num_directions, int batch_size, int hidden_size) {
+  const int threads = num_directions * batch_size * hidden_size;
+  return (threads + kPersistentRnnThreadsPerBlock - 1) / kPersistentRnnThreadsPerBlock;
+}
+
+}  // namespace
+
+// type the gates and the hidden and cell states are computed in
+template <typename T>
+struct PersistentRnnAccumulateType {
+  typedef T type;
+};
+
+template <>
+struct PersistentRnnAccumulateType<half> {
+  typedef float type;
+};
+
+__device__ __inline__ float RnnTanh(float a) { return tanhf(a); }
+
+__device__ __inline__ double RnnTanh(double a) { return tanh(a); }
+
+template <typename T>
+__device__ __inline__ T RnnSigmoid(T a) {
+  return T(1) / (T(1) + _Exp(-a));
+}
+
+// waits until every block of the grid has arrived. all the blocks must be resident, and counter must start at 0.
+__device__ __inline__ void GridSync(unsigned int* counter, unsigned int& target) {
+  target += gridDim.x;
+  // make the hidden states written by this block visible to the other blocks before arriving
+  __threadfence();
+  __syncthreads();
+  if (threadIdx.x == 0) {
+    atomicAdd(counter, 1);
+    while (*reinterpret_cast<volatile unsigned int*>(counter) < target) {
+    }
+    __threadfence();
+  }
+  __syncthreads();
+}
+
+template <typename T>
+__global__ void _TransposeRecurrentWeights(
+    const T* R,
+    T* R_transposed,
+    const int gate_size,
+    const int hidden_size,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  // id indexes R_transposed[direction, k, row]
+  const CUDA_LONG matrix_size = static_cast<CUDA_LONG>(gate_size) * hidden_size;
+  const CUDA_LONG direction = id / matrix_size;
+  const CUDA_LONG k = (id % matrix_size) / gate_size;
+  const CUDA_LONG row = id % gate_size;
+  R_transposed[id] = R[direction * matrix_size + row * hidden_size + k];
+}
+
+// each thread computes one hidden unit of one batch entry and direction at every time step, and keeps its cell
+// state in a register. the hidden states of a time step are exchanged through state, double buffered by step.
+template <typename T, typename AccT, bool is_lstm>
+__global__ void _PersistentRnnKernel(
+    const bool reverse_first,
+    const int num_directions,
+    const int seq_length,
+    const int batch_size,
+    const int hidden_size,
+    const T* xw,
+    const T* R_transposed,
+    const T* bias,
+    const T* initial_h,
+    const T* initial_c,
+    T* y,
+    T* y_h,
+    T* y_c,
+    unsigned int* barrier,
+    AccT* state) {
+  constexpr int gates = is_lstm ? 4 : 3;
+  const int gate_size = gates * hidden_size;
+  const int units = batch_size * hidden_size;
+  const int id = blockIdx.x * blockDim.x + threadIdx.x;
+  // threads past the last unit still take part in the barriers
+  const bool active = id < num_directions * units;
+  const int direction = id / units;
+  const int b = (id % units) / hidden_size;
+  const int j = id % hidden_size;
+  const bool reverse = direction == 1 || reverse_first;
+  const T* direction_weights = R_transposed + static_cast<int64_t>(direction) * hidden_size * gate_size;
+  const T* w_bias = bias == nullptr ? nullptr : bias + static_cast<int64_t>(direction) * 2 * gate_size;
+  const T* r_bias = w_bias == nullptr ? nullptr : w_bias + gate_size;
+
+  AccT h = 0;
+  AccT c = 0;
+  if (active) {
+    if (initial_h != nullptr)
+      h = AccT(initial_h[id]);
+    if (is_lstm && initial_c != nullptr)
+      c = AccT(initial_c[id]);
+    state[id] = h;
+  }
+  unsigned int target = 0;
+  GridSync(barrier, target);
+
+  for (int step = 0; step < seq_length; ++step) {
+    if (active) {
+      const int t = reverse ? seq_length - 1 - step : step;
+      // the hidden states of the previous step are read from L2, as the L1 of this SM doesn't see other SMs' writes
+      const AccT* h_prev = state + (step & 1) * num_directions * units + direction * units + b * hidden_size;
+      AccT recurrence[gates];
+#pragma unroll
+      for (int g = 0; g < gates; ++g)
+        recurrence[g] = 0;
+      for (int k = 0; k < hidden_size; ++k) {
+        const AccT h_k = __ldcg(h_prev + k);
+        const T* weights = direction_weights + static_cast<int64_t>(k) * gate_size + j;
+#pragma unroll
+        for (int g = 0; g < gates; ++g)
+          recurrence[g] += AccT(weights[g * hidden_size]) * h_k;
+      }
+
+      const T* xw_t = xw + (static_cast<int64_t>(t) * batch_size + b) * num_directions * gate_size +
+                      direction * gate_size + j;
+      AccT input[gates];
+#pragma unroll
+      for (int g = 0; g < gates; ++g) {
+        input[g] = AccT(xw_t[g * hidden_size]);
+        if (w_bias != nullptr) {
+          input[g] += AccT(w_bias[g * hidden_size + j]);
+          recurrence[g] += AccT(r_bias[g * hidden_size + j]);
+        }
+      }
+
+      if (is_lstm) {
+        // ONNX gate order is i, o, f, c
+        const AccT i_gate = RnnSigmoid(input[0] + recurrence[0]);
+        const AccT o_gate = RnnSigmoid(input[1] + recurrence[1]);
+        const AccT f_gate = RnnSigmoid(input[2] + recurrence[2]);
+        const AccT c_gate = RnnTanh(input[3] + recurrence[3]);
+        c = f_gate * c + i_gate * c_gate;
+        h = o_gate * RnnTanh(c);
+      } else {
+        // ONNX gate order is z, r, h
+        const AccT z_gate = RnnSigmoid(input[0] + recurrence[0]);
+        const AccT r_gate = RnnSigmoid(input[1] + recurrence[1]);
+        const AccT h_gate = RnnTanh(input[2] + r_gate * recurrence[2]);
+        h = (AccT(1) - z_gate) * h_gate + z_gate * h;
+      }
+
+      state[((step + 1) & 1) * num_directions * units + id] = h;
+      if (y != nullptr)
+        y[(static_cast<int64_t>(t) * num_directions + direction) * units + b * hidden_size + j] = T(h);
+    }
+    GridSync(barrier, target);
+  }
+
+  if (active) {
+    if (y_h != nullptr)
+      y_h[id] = T(h);
+    if (is_lstm && y_c != nullptr)
+      y_c[id] = T(c);
+  }
+}
+
+template <typename T>
+void TransposeRecurrentWeights(
+    cudaStream_t stream,
+    const T* R,
+    T* R_transposed,
+    int num_directions,
+    int gate_size,
+    int hidden_size) {
+  const CUDA_LONG N = static_cast<CUDA_LONG>(num_directions) * gate_size * hidden_size;
+  const int blocks = static_cast<int>(CeilDiv(N, GridDim::maxThreadsPerBlock));
+  _TransposeRecurrentWeights<T><<<blocks, GridDim::maxThreadsPerBlock, 0, stream>>>(
+      R, R_transposed, gate_size, hidden_size, N);
+}
+
+template <typename T>
+bool CanRunPersistentRnn(bool is_lstm, int num_directions, int batch_size, int hidden_size) {
+  typedef typename PersistentRnnAccumulateType<T>::type AccT;
+  int blocks_per_sm = 0;
+  const cudaError_t result = is_lstm
+      ? cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blocks_per_sm, _PersistentRnnKernel<T, AccT, true>,
+                                                      kPersistentRnnThreadsPerBlock, 0)
+      : cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blocks_per_sm, _PersistentRnnKernel<T, AccT, false>,
+                                                      kPersistentRnnThreadsPerBlock, 0);
+  if (result != cudaSuccess)
+    return false;
+  const int resident_blocks = blocks_per_sm * GridDim::GetDeviceProps().multiProcessorCount;
+  return PersistentRnnBlocks(num_directions, batch_size, hidden_size) <= resident_blocks;
+}
+
+template <typename T>
+size_t PersistentRnnBufferBytes(int num_directions, int batch_size, int hidden_size) {
+  typedef typename PersistentRnnAccumulateType<T>::type AccT;
+  return kBarrierBytes + 2 * static_cast<size_t>(num_directions) * batch_size * hidden_size * sizeof(AccT);
+}
+
+template <typename T>
+void PersistentRnnImpl(
+    cudaStream_t stream,
+    bool is_lstm,
+    bool reverse_first,
+    int num_directions,
+    int seq_length,
+    int batch_size,
+    int hidden_size,
+    const T* xw,
+    const T* R_transposed,
+    const T* bias,
+    const T* initial_h,
+    const T* initial_c,
+    T* y,
+    T* y_h,
+    T* y_c,
+    void* buffer) {
+  typedef typename PersistentRnnAccumulateType<T>::type AccT;
+  unsigned int* barrier = reinterpret_cast<unsigned int*>(buffer);
+  AccT* state = reinterpret_cast<AccT*>(reinterpret_cast<char*>(buffer) + kBarrierBytes);
+  cudaMemsetAsync(barrier, 0, sizeof(unsigned int), stream);
+
+  const int blocks = PersistentRnnBlocks(num_directions, batch_size, hidden_size);
+  if (is_lstm) {
+    _PersistentRnnKernel<T, AccT, true><<<blocks, kPersistentRnnThreadsPerBlock, 0, stream>>>(
+        reverse_first, num_directions, seq_length, batch_size, hidden_size, xw, R_transposed, bias,
+        initial_h, initial_c, y, y_h, y_c, barrier, state);
+  } else {
+    _PersistentRnnKernel<T, AccT, false><<<blocks, kPersistentRnnThreadsPerBlock, 0, stream>>>(
+        reverse_first, num_directions, seq_length, batch_size, hidden_size, xw, R_transposed, bias,
+        initial_h, initial_c, y, y_h, y_c, barrier, state);
+  }
+}
+
+#define SPECIALIZED_IMPL(T)                                                                                        \
+  template void TransposeRecurrentWeights<T>(cudaStream_t stream, const T* R, T* R_transposed, int num_directions, \
+                                             int gate_size, int hidden_size);                                     \
+  template bool CanRunPersistentRnn<T>(bool is_lstm, int num_directions, int batch_size, int hidden_size);         \
+  template size_t PersistentRnnBufferBytes<T>(int num_directions, int batch_size, int hidden_size);                \
+  template void PersistentRnnImpl<T>(cudaStream_t stream, bool is_lstm, bool reverse_first, int num_directions,    \
+                                     int seq_length, int batch_size, int hidden_size, const T* xw,                 \
+                                     const T* R_transposed, const T* bias, const T* initial_h,                     \
+                                     const T* initial_c, T* y, T* y_h, T* y_c, void* buffer);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include <cuda_runtime.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// Batches up to this size run all the time steps of an LSTM or GRU in one persistent kernel instead of cuDNN.
+constexpr int64_t kPersistentRnnMaxBatchSize = 8;
+
+// Transposes the recurrence weights R[num_directions, gates * hidden_size, hidden_size] of each direction to
+// [num_directions, hidden_size, gates * hidden_size], so the threads of a time step read them coalesced.
+template <typename T>
+void TransposeRecurrentWeights(
+    cudaStream_t stream,
+    const T* R,
+    T* R_transposed,
+    int num_directions,
+    int gate_size,
+    int hidden_size);
+
+// Returns true if the persistent kernel can keep one thread per hidden unit resident on the device, which the
+// grid wide barrier between time steps relies on.
+template <typename T>
+bool CanRunPersistentRnn(bool is_lstm, int num_directions, int batch_size, int hidden_size);
+
+// Bytes of the buffer PersistentRnnImpl needs for the barrier and the hidden states of consecutive time steps.
+template <typename T>
+size_t PersistentRnnBufferBytes(int num_directions, int batch_size, int hidden_size);
+
+// Runs a single layer LSTM (is_lstm) or GRU over every time step in one kernel launch, with the semantics of the
+// cuDNN path: the default activations, and for GRU the reset gate applied after the recurrence (cuDNN's GRU).
+// xw[seq_length, batch_size, num_directions * gates * hidden_size] is the input projection X * W^T of all time
+// steps, R_transposed comes from TransposeRecurrentWeights, and bias is the ONNX B input or nullptr.
+// Direction 0 runs backwards if reverse_first; direction 1, if any, always runs backwards.
+// y[seq_length, num_directions, batch_size, hidden_size], y_h and y_c[num_directions, batch_size, hidden_size]
+// may each be nullptr, as may initial_h and initial_c for zero initial states.
+template <typename T>
+void PersistentRnnImpl(
+    cudaStream_t stream,
+    bool is_lstm,
+    bool reverse_first,
+    int num_directions,
+    int seq_length,
+    int batch_size,
+    int hidden_size,
+    const T* xw,
+    const T* R_transposed,
+    const T* bias,
+    const T* initial_h,
+    const T* initial_c,
+    T* y,
+    T* y_h,
+    T* y_c,
+    void* buffer);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 // as currently nvcc cannot compile all onnxruntime headers
 
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include "fast_divmod.h"
@@ -30,5 +31,14 @@ class IConstantBuffer {
 template <typename T>
 std::unique_ptr<IConstantBuffer<T>> CreateConstantOnes();
 
+// The kernels that move the elements of tensors without computing on them move vectors of up to 16 bytes at once,
+// the largest that divide the byte sizes and addresses of what they move. Halves bytes until it divides value.
+inline size_t AlignedBytes(size_t bytes, uint64_t value) {
+  while (bytes > 1 && value % bytes != 0) {
+    bytes /= 2;
+  }
+  return bytes;
+}
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -36,10 +36,11 @@ Status Compress::ComputeInternal(OpKernelContext* ctx) const {
   int64_t valid_condition_length = compress_input_length < condition_length ? compress_input_length : condition_length;
 
   auto condition_cumulative_sum = GetScratchBuffer<int32_t>(valid_condition_length).get();
-  PrefixSumImpl(reinterpret_cast<const int8_t*>(condition_data), condition_cumulative_sum, valid_condition_length);
+  PrefixSumImpl(Stream(), reinterpret_cast<const int8_t*>(condition_data), condition_cumulative_sum, valid_condition_length);
   
   int32_t positive_condition_count = 0;
-  CUDA_RETURN_IF_ERROR(cudaMemcpy(&positive_condition_count, condition_cumulative_sum + valid_condition_length - 1, sizeof(int32_t), cudaMemcpyDeviceToHost));
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(&positive_condition_count, condition_cumulative_sum + valid_condition_length - 1, sizeof(int32_t), cudaMemcpyDeviceToHost, Stream()));
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(Stream()));
 
   std::vector<int64_t> output_dims(input_dimensions);
   if (has_axis_) {
@@ -64,7 +65,8 @@ Status Compress::ComputeInternal(OpKernelContext* ctx) const {
     }
   }
 
-  ORT_RETURN_IF_ERROR(CompressImpl(element_bytes,
+  ORT_RETURN_IF_ERROR(CompressImpl(Stream(),
+                                           element_bytes,
                                            gsl::narrow_cast<int32_t>(valid_condition_length),
                                            gsl::narrow_cast<int32_t>(axis_right_stride),
                                            has_axis_ ? gsl::narrow_cast<int32_t>(input_dimensions[axis_]) : gsl::narrow_cast<int32_t>(input_size),
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "concat.h"
+#include "concat_impl.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -20,24 +21,45 @@ Status Concat::ComputeInternal(OpKernelContext* ctx) const {
   Prepare p;
   ORT_RETURN_IF_ERROR(PrepareForCompute(ctx, input_count, p));
 
-  int64_t output_offset = 0;
-  auto element_bytes = p.output_tensor->DataType()->Size();
+  const size_t output_size = p.output_tensor->Shape().Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  // copy all the inputs with one kernel, moving the widest vectors that divide the rows of every input
+  const size_t element_bytes = p.output_tensor->DataType()->Size();
+  void* output_data = p.output_tensor->MutableDataRaw();
+  size_t vector_bytes = AlignedBytes(sizeof(int4), element_bytes * p.output_axis_pitch);
+  vector_bytes = AlignedBytes(vector_bytes, reinterpret_cast<uint64_t>(output_data));
   for (int input_index = 0; input_index < input_count; input_index++) {
     const auto& prep = p.inputs[input_index];
+    vector_bytes = AlignedBytes(vector_bytes, element_bytes * prep.axis_pitch);
+    vector_bytes = AlignedBytes(vector_bytes, reinterpret_cast<uint64_t>(prep.tensor->DataRaw()));
+  }
 
-    // Copy the data across. For every 'input_axis_pitch' values copied, we move over by the 'output_axis_pitch'
-    CUDA_RETURN_IF_ERROR(cudaMemcpy2DAsync(
-        static_cast<uint8_t*>(p.output_tensor->MutableDataRaw()) + output_offset * element_bytes,
-        p.output_axis_pitch * element_bytes,
-        prep.tensor->DataRaw(),
-        prep.axis_pitch * element_bytes,
-        prep.axis_pitch * element_bytes,
-        prep.tensor->Shape().Size() / prep.axis_pitch,
-        cudaMemcpyDeviceToDevice));
-
-    output_offset += prep.axis_pitch;
+  CudaAsyncBuffer<const void*> input_ptrs(this, 0, input_count);
+  CudaAsyncBuffer<int64_t> axis_offsets(this, 0, input_count + 1);
+  auto input_ptrs_span = input_ptrs.CpuSpan();
+  auto axis_offsets_span = axis_offsets.CpuSpan();
+  int64_t output_offset = 0;
+  for (int input_index = 0; input_index < input_count; input_index++) {
+    const auto& prep = p.inputs[input_index];
+    input_ptrs_span[input_index] = prep.tensor->DataRaw();
+    axis_offsets_span[input_index] = output_offset;
+    output_offset += prep.axis_pitch * element_bytes / vector_bytes;
   }
-  return Status::OK();
+  axis_offsets_span[input_count] = output_offset;
+  ORT_RETURN_IF_ERROR(input_ptrs.CopyToGpu());
+  ORT_RETURN_IF_ERROR(axis_offsets.CopyToGpu());
+
+  return ConcatImpl(Stream(),
+                    vector_bytes,
+                    input_count,
+                    input_ptrs.GpuPtr(),
+                    axis_offsets.GpuPtr(),
+                    fast_divmod(gsl::narrow_cast<int>(p.output_axis_pitch * element_bytes / vector_bytes)),
+                    output_data,
+                    output_size * element_bytes / vector_bytes);
 }
 
 }  // namespace cuda
@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "concat_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+__global__ void _ConcatKernel(const int input_count,
+                              const void* const* input_ptrs,
+                              const int64_t* axis_offsets,
+                              const fast_divmod output_axis_pitch,
+                              T* output_data,
+                              const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int row, column;
+  output_axis_pitch.divmod(id, row, column);
+
+  // the last input whose columns start at or before the column, which skips the inputs without columns
+  int first = 0;
+  int last = input_count;
+  while (last - first > 1) {
+    int middle = (first + last) / 2;
+    if (axis_offsets[middle] <= column) {
+      first = middle;
+    } else {
+      last = middle;
+    }
+  }
+  const int64_t input_axis_pitch = axis_offsets[first + 1] - axis_offsets[first];
+  const T* input_data = reinterpret_cast<const T*>(input_ptrs[first]);
+  output_data[id] = input_data[row * input_axis_pitch + column - axis_offsets[first]];
+}
+
+template <typename T>
+void LaunchConcatKernel(cudaStream_t stream, const int input_count, const void* const* input_ptrs,
+                        const int64_t* axis_offsets, const fast_divmod& output_axis_pitch, void* output_data,
+                        const size_t N) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _ConcatKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, stream>>>(
+      input_count, input_ptrs, axis_offsets, output_axis_pitch, reinterpret_cast<T*>(output_data), (CUDA_LONG)N);
+}
+
+Status ConcatImpl(cudaStream_t stream,
+                  const size_t element_size,
+                  const int input_count,
+                  const void* const* input_ptrs,
+                  const int64_t* axis_offsets,
+                  const fast_divmod& output_axis_pitch,
+                  void* output_data,
+                  const size_t N) {
+  switch (element_size) {
+    case sizeof(int8_t):
+      LaunchConcatKernel<int8_t>(stream, input_count, input_ptrs, axis_offsets, output_axis_pitch, output_data, N);
+      break;
+    case sizeof(int16_t):
+      LaunchConcatKernel<int16_t>(stream, input_count, input_ptrs, axis_offsets, output_axis_pitch, output_data, N);
+      break;
+    case sizeof(int32_t):
+      LaunchConcatKernel<int32_t>(stream, input_count, input_ptrs, axis_offsets, output_axis_pitch, output_data, N);
+      break;
+    case sizeof(int64_t):
+      LaunchConcatKernel<int64_t>(stream, input_count, input_ptrs, axis_offsets, output_axis_pitch, output_data, N);
+      break;
+    case sizeof(int4):
+      LaunchConcatKernel<int4>(stream, input_count, input_ptrs, axis_offsets, output_axis_pitch, output_data, N);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Type not supported for Concat operator");
+  }
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
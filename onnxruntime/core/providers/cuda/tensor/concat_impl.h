@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Concatenates the inputs with one kernel. The output is viewed as rows of output_axis_pitch elements of
+// element_size bytes, of which input i fills the columns from axis_offsets[i] to axis_offsets[i + 1].
+// input_ptrs and axis_offsets, of input_count and input_count + 1 values, are in device memory.
+Status ConcatImpl(cudaStream_t stream,
+                  const size_t element_size,
+                  const int input_count,
+                  const void* const* input_ptrs,
+                  const int64_t* axis_offsets,
+                  const fast_divmod& output_axis_pitch,
+                  void* output_data,
+                  const size_t N);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -55,6 +55,7 @@ Status Crop<T>::ComputeInternal(OpKernelContext* context) const {
   fast_divmod fdm_YHW(gsl::narrow_cast<int>((bottomLimit - topBorder) * (rightLimit - leftBorder)));
 
   CropImpl<CudaT>(
+      Stream(),
       reinterpret_cast<const CudaT*>(X->template Data<T>()),
       gsl::narrow_cast<int>(leftBorder),
       gsl::narrow_cast<int>(topBorder),
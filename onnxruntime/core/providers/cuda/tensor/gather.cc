@@ -20,45 +20,52 @@ ONNX_OPERATOR_KERNEL_EX(
                                     DataTypeImpl::GetTensorType<int64_t>()}),
     Gather);
 
-#define TYPED_FUNCTION_CALL(T)                                                \
-  if (T_type == DataTypeImpl::GetType<T>()) {                                 \
-    T* output_data = p.output_tensor->template MutableData<T>();              \
-    const T* input_data = p.input_tensor->template Data<T>();                 \
-    if (Tin_type == DataTypeImpl::GetType<int32_t>()) {                       \
-      GatherImpl(                                                             \
-          input_block_size,                                                   \
-          indices_max,                                                        \
-          p.indices_tensor->template Data<int32_t>(),                         \
-          div_strides.GpuPtr(),                                               \
-          reinterpret_cast<const ToCudaType<T>::MappedType*>(input_data),     \
-          reinterpret_cast<typename ToCudaType<T>::MappedType*>(output_data), \
-          p.output_tensor->Shape().Size());                                   \
-      return Status::OK();                                                    \
-    }                                                                         \
-    if (Tin_type == DataTypeImpl::GetType<int64_t>()) {                       \
-      GatherImpl(                                                             \
-          input_block_size,                                                   \
-          indices_max,                                                        \
-          p.indices_tensor->template Data<int64_t>(),                         \
-          div_strides.GpuPtr(),                                               \
-          reinterpret_cast<const ToCudaType<T>::MappedType*>(input_data),     \
-          reinterpret_cast<typename ToCudaType<T>::MappedType*>(output_data), \
-          p.output_tensor->Shape().Size());                                   \
-      return Status::OK();                                                    \
-    }                                                                         \
+template <typename Tin>
+static Status GatherBytes(cudaStream_t stream, size_t vector_bytes, int64_t input_block_size, int64_t indices_max,
+                          const Tin* indices_data, const fast_divmod* div_strides, const void* input_data,
+                          void* output_data, size_t N) {
+  // the elements are moved without computing on them, so any type moves as the unsigned integers of its width
+#define BYTES_FUNCTION_CALL(T)                                                                                    \
+  case sizeof(T):                                                                                                 \
+    GatherImpl(stream, input_block_size, indices_max, indices_data, div_strides,                                  \
+               reinterpret_cast<const T*>(input_data), reinterpret_cast<T*>(output_data), N);                     \
+    return Status::OK();
+
+  switch (vector_bytes) {
+    BYTES_FUNCTION_CALL(uint8_t)
+    BYTES_FUNCTION_CALL(uint16_t)
+    BYTES_FUNCTION_CALL(uint32_t)
+    BYTES_FUNCTION_CALL(uint64_t)
+    BYTES_FUNCTION_CALL(int4)
   }
+#undef BYTES_FUNCTION_CALL
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for T not supported yet in Gather.");
+}
 
 Status Gather::ComputeInternal(OpKernelContext* context) const {
   Prepare p;
   ORT_RETURN_IF_ERROR(PrepareForCompute(context, p));
 
   const TensorShape& input_shape = p.input_tensor->Shape();
+  size_t output_size = p.output_tensor->Shape().Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
 
-  const int64_t block_size = input_shape.SizeFromDimension(p.axis + 1);
+  // the blocks the indices select are moved as the widest vectors that divide them
+  const size_t element_bytes = p.input_tensor->DataType()->Size();
+  const void* input_data = p.input_tensor->DataRaw();
+  void* output_data = p.output_tensor->MutableDataRaw();
+  const size_t block_bytes = element_bytes * input_shape.SizeFromDimension(p.axis + 1);
+  size_t vector_bytes = AlignedBytes(sizeof(int4), block_bytes);
+  vector_bytes = AlignedBytes(vector_bytes, reinterpret_cast<uint64_t>(input_data));
+  vector_bytes = AlignedBytes(vector_bytes, reinterpret_cast<uint64_t>(output_data));
+  const int64_t block_size = block_bytes / vector_bytes;
   size_t N = p.indices_tensor->Shape().Size();
-  const int64_t input_block_size = input_shape.SizeFromDimension(p.axis);
+  const int64_t input_block_size = input_shape.SizeFromDimension(p.axis) * element_bytes / vector_bytes;
   const int64_t output_block_size = N * block_size;
   const int64_t indices_max = input_shape[p.axis];
+  output_size = output_size * element_bytes / vector_bytes;
 
   // Put the output_block_size and block_size into div_strides
   // for divmod calling in _GatherKernel to calculate the input index
@@ -68,21 +75,17 @@ Status Gather::ComputeInternal(OpKernelContext* context) const {
   div_strides_span[1] = fast_divmod(gsl::narrow_cast<int>(block_size));
   ORT_RETURN_IF_ERROR(div_strides.CopyToGpu());
 
-  MLDataType T_type = p.input_tensor->DataType();
   MLDataType Tin_type = p.indices_tensor->DataType();
-
-  TYPED_FUNCTION_CALL(int8_t)
-  TYPED_FUNCTION_CALL(int16_t)
-  TYPED_FUNCTION_CALL(int32_t)
-  TYPED_FUNCTION_CALL(int64_t)
-  TYPED_FUNCTION_CALL(uint8_t)
-  TYPED_FUNCTION_CALL(uint16_t)
-  TYPED_FUNCTION_CALL(uint32_t)
-  TYPED_FUNCTION_CALL(uint64_t)
-  TYPED_FUNCTION_CALL(MLFloat16)
-  TYPED_FUNCTION_CALL(float)
-  TYPED_FUNCTION_CALL(double)
-  TYPED_FUNCTION_CALL(bool)
+  if (Tin_type == DataTypeImpl::GetType<int32_t>()) {
+    return GatherBytes(Stream(), vector_bytes, input_block_size, indices_max,
+                       p.indices_tensor->template Data<int32_t>(), div_strides.GpuPtr(), input_data, output_data,
+                       output_size);
+  }
+  if (Tin_type == DataTypeImpl::GetType<int64_t>()) {
+    return GatherBytes(Stream(), vector_bytes, input_block_size, indices_max,
+                       p.indices_tensor->template Data<int64_t>(), div_strides.GpuPtr(), input_data, output_data,
+                       output_size);
+  }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
 }
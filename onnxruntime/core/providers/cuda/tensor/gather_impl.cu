@@ -25,7 +25,7 @@ __global__ void _GatherKernel(
   int block_size = div_strides[1].d_;
   int64_t idx = indices_data[indices_index];
   if (idx < 0 || idx >= indices_max) {
-    output_data[id] = 0;
+    output_data[id] = T();
     return;
   }
 
@@ -35,6 +35,7 @@ __global__ void _GatherKernel(
 
 template <typename T, typename Tin>
 void GatherImpl(
+    cudaStream_t stream,
     const int64_t input_block_size,
     const int64_t indices_max,
     const Tin* indices_data,
@@ -43,26 +44,20 @@ void GatherImpl(
     T* output_data,
     const size_t N) {
   int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
-  _GatherKernel<T, Tin><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+  _GatherKernel<T, Tin><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, stream>>>(
       input_block_size, indices_max, indices_data, div_strides, input_data, output_data, (CUDA_LONG)N);
 }
 
 #define SPECIALIZED_IMPL(T)                                                                                                                                                                                          \
-  template void GatherImpl<T, int32_t>(const int64_t input_block_size, const int64_t indices_max, const int32_t* indices_data, const fast_divmod* div_strides, const T* input_data, T* output_data, const size_t N); \
-  template void GatherImpl<T, int64_t>(const int64_t input_block_size, const int64_t indices_max, const int64_t* indices_data, const fast_divmod* div_strides, const T* input_data, T* output_data, const size_t N);
+  template void GatherImpl<T, int32_t>(cudaStream_t stream, const int64_t input_block_size, const int64_t indices_max, const int32_t* indices_data, const fast_divmod* div_strides, const T* input_data, T* output_data, const size_t N); \
+  template void GatherImpl<T, int64_t>(cudaStream_t stream, const int64_t input_block_size, const int64_t indices_max, const int64_t* indices_data, const fast_divmod* div_strides, const T* input_data, T* output_data, const size_t N);
 
-SPECIALIZED_IMPL(int8_t)
-SPECIALIZED_IMPL(int16_t)
-SPECIALIZED_IMPL(int32_t)
-SPECIALIZED_IMPL(int64_t)
+// the elements are gathered as the unsigned integers or vectors of their width
 SPECIALIZED_IMPL(uint8_t)
 SPECIALIZED_IMPL(uint16_t)
 SPECIALIZED_IMPL(uint32_t)
 SPECIALIZED_IMPL(uint64_t)
-SPECIALIZED_IMPL(half)
-SPECIALIZED_IMPL(float)
-SPECIALIZED_IMPL(double)
-SPECIALIZED_IMPL(bool)
+SPECIALIZED_IMPL(int4)
 
 }  // namespace cuda
 }  // namespace onnxruntime
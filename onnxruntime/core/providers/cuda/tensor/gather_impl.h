@@ -10,6 +10,7 @@ namespace cuda {
 
 template <typename T, typename Tin>
 void GatherImpl(
+    cudaStream_t stream,
     const int64_t input_block_size,
     const int64_t indices_max,
     const Tin* indices_data,
@@ -26,7 +26,7 @@ class IdentityOp final : public CudaKernel {
     void* target = Y->MutableDataRaw(X_type);
     //If source and target pointers are not equal, we need to copy the data.
     if (target != source) {
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(target, source, X->Shape().Size() * X->DataType()->Size(), cudaMemcpyDeviceToDevice));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(target, source, X->Shape().Size() * X->DataType()->Size(), cudaMemcpyDeviceToDevice, Stream()));
     }
 
     if (is_dropout) {
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/tensor/image_preprocess.h"
+#include "core/providers/cuda/tensor/image_preprocess_impl.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    ImagePreprocess,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<float>()),
+    ImagePreprocess);
+
+ImagePreprocess::ImagePreprocess(const OpKernelInfo& info) : CudaKernel(info), contrib::ImagePreprocessBase(info) {
+  // the NCHWc format is only read by the kernels of the CPU execution provider, which runs such nodes
+  ORT_ENFORCE(!nchwc_, "ImagePreprocess on CUDA only writes the NCHW format.");
+
+  scale_bias_channels_ = static_cast<int64_t>(std::max(scale_.size(), bias_.size()));
+  std::vector<float> scale_bias(2 * scale_bias_channels_);
+  for (int64_t c = 0; c < scale_bias_channels_; ++c) {
+    scale_bias[c] = scale_[scale_.size() == 1 ? 0 : c];
+    scale_bias[scale_bias_channels_ + c] = bias_[bias_.size() == 1 ? 0 : c];
+  }
+  scale_bias_data_ = GetScratchBuffer<float>(scale_bias.size());
+  CUDA_CALL_THROW(cudaMemcpyAsync(scale_bias_data_.get(), scale_bias.data(), sizeof(float) * scale_bias.size(),
+                                  cudaMemcpyHostToDevice, Stream()));
+  CUDA_CALL_THROW(cudaStreamSynchronize(Stream()));
+}
+
+Status ImagePreprocess::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  Region region;
+  ORT_RETURN_IF_ERROR(ComputeRegion(*X, region));
+
+  Tensor* Y = context->Output(0, TensorShape({region.batch, region.channels, region.out_height, region.out_width}));
+  const int64_t count = Y->Shape().Size();
+  if (count == 0) {
+    return Status::OK();
+  }
+
+  ImagePreprocessImpl(
+      Stream(),
+      X->Data<uint8_t>(),
+      scale_bias_data_.get(),
+      scale_bias_channels_ == 1,
+      region.height,
+      region.width,
+      region.channels,
+      region.top,
+      region.left,
+      region.out_height,
+      region.out_width,
+      Y->MutableData<float>(),
+      static_cast<size_t>(count));
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
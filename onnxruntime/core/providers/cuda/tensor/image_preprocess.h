@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/image_preprocess.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+class ImagePreprocess final : public CudaKernel, public contrib::ImagePreprocessBase {
+ public:
+  ImagePreprocess(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  // the scale then the bias of each channel, or of all of them if there is a single one of each
+  IAllocatorUniquePtr<float> scale_bias_data_;
+  int64_t scale_bias_channels_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ImagePreprocess);
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "image_preprocess_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <bool shared_scale_bias>
+__global__ void _ImagePreprocessKernel(
+    const uint8_t* input_data,
+    const float* scale_bias,
+    const int channels,
+    const int input_width,
+    const int input_plane,
+    const int offset,
+    const fast_divmod fdm_out_width,
+    const fast_divmod fdm_out_height,
+    const fast_divmod fdm_channels,
+    float* output_data,
+    const size_t N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int q, w, h, n, c;
+  fdm_out_width.divmod(id, q, w);
+  fdm_out_height.divmod(q, q, h);
+  fdm_channels.divmod(q, n, c);
+  const uint8_t value = input_data[n * input_plane + ((h * input_width + w) + offset) * channels + c];
+  const int i = shared_scale_bias ? 0 : c;
+  output_data[id] = static_cast<float>(value) * scale_bias[i] + scale_bias[(shared_scale_bias ? 1 : channels) + i];
+}
+
+void ImagePreprocessImpl(
+    cudaStream_t stream,
+    const uint8_t* input_data,
+    const float* scale_bias,
+    bool shared_scale_bias,
+    int64_t height,
+    int64_t width,
+    int64_t channels,
+    int64_t top,
+    int64_t left,
+    int64_t out_height,
+    int64_t out_width,
+    float* output_data,
+    size_t count) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  const int input_plane = (int)(height * width * channels);
+  const int offset = (int)(top * width + left);
+  fast_divmod fdm_out_width((int)out_width);
+  fast_divmod fdm_out_height((int)out_height);
+  fast_divmod fdm_channels((int)channels);
+  if (shared_scale_bias) {
+    _ImagePreprocessKernel<true><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, stream>>>(
+        input_data, scale_bias, (int)channels, (int)width, input_plane, offset,
+        fdm_out_width, fdm_out_height, fdm_channels, output_data, count);
+  } else {
+    _ImagePreprocessKernel<false><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, stream>>>(
+        input_data, scale_bias, (int)channels, (int)width, input_plane, offset,
+        fdm_out_width, fdm_out_height, fdm_channels, output_data, count);
+  }
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// writes the region of the NHWC images from (top, left) of out_height x out_width pixels to output_data in the NCHW
+// format, scaled and shifted by the scales and then the biases in scale_bias, a single one of each if shared
+void ImagePreprocessImpl(
+    cudaStream_t stream,
+    const uint8_t* input_data,
+    const float* scale_bias,
+    bool shared_scale_bias,
+    int64_t height,
+    int64_t width,
+    int64_t channels,
+    int64_t top,
+    int64_t left,
+    int64_t out_height,
+    int64_t out_width,
+    float* output_data,
+    size_t count);
+
+}  // namespace cuda
+}  // namespace onnxruntime
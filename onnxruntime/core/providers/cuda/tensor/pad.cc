@@ -54,6 +54,7 @@ Status Pad<T>::ComputeInternal(OpKernelContext* ctx) const {
   ORT_RETURN_IF_ERROR(fdm_output_strides.CopyToGpu());
 
   PadImpl(
+      Stream(),
       dimension_count,
       input_dims.GpuPtr(),
       input_strides.GpuPtr(),
@@ -55,6 +55,24 @@ Status Slice<Tind, dynamic>::ComputeInternal(OpKernelContext* ctx) const {
   if (output_size == 0) {
     return Status::OK();
   }
+
+  // the innermost dimension is moved as the widest vectors that divide its start and extents
+  size_t element_size = input_tensor->DataType()->Size();
+  size_t vector_bytes = element_size;
+  std::vector<int64_t> input_vector_dims(input_dimensions);
+  if (dimension_count > 0) {
+    const size_t last = dimension_count - 1;
+    vector_bytes = AlignedBytes(sizeof(int4), element_size * starts[last]);
+    vector_bytes = AlignedBytes(vector_bytes, element_size * output_dims[last]);
+    vector_bytes = AlignedBytes(vector_bytes, element_size * input_dimensions[last]);
+    vector_bytes = AlignedBytes(vector_bytes, reinterpret_cast<uint64_t>(input_tensor->DataRaw()));
+    vector_bytes = AlignedBytes(vector_bytes, reinterpret_cast<uint64_t>(output_tensor->MutableDataRaw()));
+    starts[last] = starts[last] * element_size / vector_bytes;
+    output_dims[last] = output_dims[last] * element_size / vector_bytes;
+    input_vector_dims[last] = input_vector_dims[last] * element_size / vector_bytes;
+    output_size = output_size * element_size / vector_bytes;
+  }
+
   int device_id = 0;
   CudaAsyncBuffer<int64_t> starts_buffer(this, device_id, dimension_count);
   gsl::span<int64_t> starts_buffer_span = starts_buffer.CpuSpan();
@@ -64,7 +82,7 @@ Status Slice<Tind, dynamic>::ComputeInternal(OpKernelContext* ctx) const {
   starts_buffer.CopyToGpu();
 
   CudaAsyncBuffer<int64_t> input_strides(this, device_id, dimension_count);
-  ORT_ENFORCE(TensorPitches::Calculate(input_strides.CpuSpan(), input_dimensions));
+  ORT_ENFORCE(TensorPitches::Calculate(input_strides.CpuSpan(), input_vector_dims));
   input_strides.CopyToGpu();
 
   TensorPitches output_pitches(output_dims);
@@ -76,9 +94,8 @@ Status Slice<Tind, dynamic>::ComputeInternal(OpKernelContext* ctx) const {
   }
   div_strides.CopyToGpu();
 
-  size_t element_size = input_tensor->DataType()->Size();
-
-  ORT_RETURN_IF_ERROR(SliceImpl(element_size,
+  ORT_RETURN_IF_ERROR(SliceImpl(Stream(),
+                              vector_bytes,
                               gsl::narrow_cast<int32_t>(dimension_count),
                               starts_buffer.GpuPtr(),
                               input_strides.GpuPtr(),
@@ -9,7 +9,8 @@
 namespace onnxruntime {
 namespace cuda {
 
-Status SliceImpl(const size_t element_size,
+Status SliceImpl(cudaStream_t stream,
+                 const size_t element_size,
                  const int32_t dimension_count,
                  const int64_t* starts,
                  const int64_t* input_strides,
@@ -4,6 +4,7 @@
 #include "transpose.h"
 #include "transpose_impl.h"
 #include "core/providers/cpu/tensor/utils.h"
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -19,40 +20,107 @@ namespace cuda {
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
       Transpose<T>);
 
+// a single matrix is transposed by cuBLAS geam where it has one for the type. the row major input of rows x cols is
+// the column major matrix A of cols x rows, and the output is the column major matrix C = A^T of rows x cols.
+static Status TransposeMatrix(cublasHandle_t handle, cudaStream_t /*stream*/, int64_t rows, int64_t cols,
+                              const float* input_data, float* output_data) {
+  float alpha = 1.0f;
+  float beta = 0.0f;
+  const int m = gsl::narrow<int>(rows);
+  const int n = gsl::narrow<int>(cols);
+  CUBLAS_RETURN_IF_ERROR(cublasTransposeHelper(handle, CUBLAS_OP_T, CUBLAS_OP_N, m, n, &alpha,
+                                               const_cast<float*>(input_data), n, &beta, output_data, m,
+                                               output_data, m));
+  return Status::OK();
+}
+
+static Status TransposeMatrix(cublasHandle_t handle, cudaStream_t /*stream*/, int64_t rows, int64_t cols,
+                              const double* input_data, double* output_data) {
+  double alpha = 1.0;
+  double beta = 0.0;
+  const int m = gsl::narrow<int>(rows);
+  const int n = gsl::narrow<int>(cols);
+  CUBLAS_RETURN_IF_ERROR(cublasTransposeHelper(handle, CUBLAS_OP_T, CUBLAS_OP_N, m, n, &alpha,
+                                               const_cast<double*>(input_data), n, &beta, output_data, m,
+                                               output_data, m));
+  return Status::OK();
+}
+
+template <typename CudaT>
+static Status TransposeMatrix(cublasHandle_t /*handle*/, cudaStream_t stream, int64_t rows, int64_t cols,
+                              const CudaT* input_data, CudaT* output_data) {
+  TransposeBatched2DImpl(stream, 1, rows, cols, input_data, output_data);
+  return Status::OK();
+}
+
 template <typename T>
 Status Transpose<T>::ComputeInternal(OpKernelContext* ctx) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
   const Tensor* X_ptr = ctx->Input<Tensor>(0);
   if (X_ptr == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
   const Tensor& X = *X_ptr;
   const TensorShape& input_shape = X.Shape();
   const std::vector<int64_t>& input_dims = input_shape.GetDims();
-  size_t rank = input_dims.size();
 
-  std::vector<int64_t> output_dims(rank);
-  std::vector<int64_t> default_perm(rank);
+  std::vector<int64_t> output_dims(input_dims.size());
+  std::vector<int64_t> default_perm(input_dims.size());
   const std::vector<int64_t>* p_perm = nullptr;
   ComputeOutputShape(X, output_dims, default_perm, p_perm);
 
   TensorShape output_shape{output_dims};
   Tensor* Y = ctx->Output(0, output_shape);
+  if (output_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  const CudaT* input_data = reinterpret_cast<const CudaT*>(X.template Data<T>());
+  CudaT* output_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+
+  // the fewer the axes the fewer divisions the generic kernel does per element, and most of the permutations of
+  // models reduce to a copy or to the transpose of a batch of matrices, which are tiled through shared memory
+  std::vector<int64_t> dims;
+  std::vector<int64_t> perm_dims;
+  SimplifyPermutation(input_dims, *p_perm, dims, perm_dims);
+  const size_t rank = dims.size();
+
+  if (rank <= 1) {
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_data, input_data, output_shape.Size() * sizeof(CudaT),
+                                         cudaMemcpyDeviceToDevice, Stream()));
+    return Status::OK();
+  }
+  if (perm_dims == std::vector<int64_t>{1, 0} && CanDoTransposeBatched2D(1, dims[0], dims[1])) {
+    return TransposeMatrix(CublasHandle(), Stream(), dims[0], dims[1], input_data, output_data);
+  }
+  if (perm_dims == std::vector<int64_t>{0, 2, 1} && CanDoTransposeBatched2D(dims[0], dims[1], dims[2])) {
+    TransposeBatched2DImpl(Stream(), dims[0], dims[1], dims[2], input_data, output_data);
+    return Status::OK();
+  }
+
+  std::vector<int64_t> simplified_output_dims(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    simplified_output_dims[i] = dims[perm_dims[i]];
+  }
+
   int device_id = 0;
   CudaAsyncBuffer<int64_t> input_strides(this, device_id, rank);
-  CudaAsyncBuffer<int64_t> perm(this, device_id, *p_perm);
+  CudaAsyncBuffer<int64_t> perm(this, device_id, perm_dims);
   CudaAsyncBuffer<fast_divmod> fdm_output_strides(this, device_id, rank);
-  ORT_ENFORCE(TensorPitches::Calculate(input_strides.CpuSpan(), input_dims));
-  ORT_ENFORCE(CalculateFdmStrides(fdm_output_strides.CpuSpan(), output_dims));
+  ORT_ENFORCE(TensorPitches::Calculate(input_strides.CpuSpan(), dims));
+  ORT_ENFORCE(CalculateFdmStrides(fdm_output_strides.CpuSpan(), simplified_output_dims));
 
   ORT_RETURN_IF_ERROR(input_strides.CopyToGpu());
   ORT_RETURN_IF_ERROR(perm.CopyToGpu());
   ORT_RETURN_IF_ERROR(fdm_output_strides.CopyToGpu());
 
   TransposeImpl(
+      Stream(),
       rank,
       input_strides.GpuPtr(),
       perm.GpuPtr(),
-      reinterpret_cast<const typename ToCudaType<T>::MappedType*>(X.template Data<T>()),
+      input_data,
       fdm_output_strides.GpuPtr(),
-      reinterpret_cast<typename ToCudaType<T>::MappedType*>(Y->template MutableData<T>()),
+      output_data,
       output_shape.Size());
 
   return Status::OK();
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
 #include "core/providers/cuda/cu_inc/common.cuh"
 #include "transpose_impl.h"
 
@@ -31,6 +32,7 @@ __global__ void _TransposeKernel(
 
 template <typename T>
 void TransposeImpl(
+    cudaStream_t stream,
     const size_t shape_rank,
     const int64_t* input_strides,
     const int64_t* perm,
@@ -39,20 +41,88 @@ void TransposeImpl(
     T* output_data,
     const size_t N) {
   int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
-  _TransposeKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+  _TransposeKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, stream>>>(
       shape_rank, input_strides, perm, input_data,
       fdm_output_strides, output_data, N);
 }
 
+// the tiles of the batched 2D transpose, each loaded by a block of TILE_DIM x BLOCK_ROWS threads. the rows of the
+// tile in shared memory are padded by an element so that the threads reading a column hit different banks.
+constexpr int TILE_DIM = 32;
+constexpr int BLOCK_ROWS = 8;
+
+// reads a tile of a matrix of the batch with coalesced loads along its rows, and writes it transposed with
+// coalesced stores along the rows of the output
+template <typename T>
+__global__ void _TransposeBatched2DKernel(
+    const T* input_data,
+    T* output_data,
+    const int rows,
+    const int cols) {
+  __shared__ T tile[TILE_DIM][TILE_DIM + 1];
+
+  const int64_t batch_offset = static_cast<int64_t>(blockIdx.z) * rows * cols;
+  input_data += batch_offset;
+  output_data += batch_offset;
+
+  int x = blockIdx.x * TILE_DIM + threadIdx.x;
+  int y = blockIdx.y * TILE_DIM + threadIdx.y;
+  if (x < cols) {
+    for (int j = 0; j < TILE_DIM && y + j < rows; j += BLOCK_ROWS) {
+      tile[threadIdx.y + j][threadIdx.x] = input_data[static_cast<int64_t>(y + j) * cols + x];
+    }
+  }
+
+  __syncthreads();
+
+  x = blockIdx.y * TILE_DIM + threadIdx.x;
+  y = blockIdx.x * TILE_DIM + threadIdx.y;
+  if (x < rows) {
+    for (int j = 0; j < TILE_DIM && y + j < cols; j += BLOCK_ROWS) {
+      output_data[static_cast<int64_t>(y + j) * rows + x] = tile[threadIdx.x][threadIdx.y + j];
+    }
+  }
+}
+
+bool CanDoTransposeBatched2D(int64_t batch_count, int64_t rows, int64_t cols) {
+  // the tiles of the rows and of the batch are in the y and z dims of the grid
+  return rows <= std::numeric_limits<int>::max() && cols <= std::numeric_limits<int>::max() &&
+         (rows + TILE_DIM - 1) / TILE_DIM <= 65535 && batch_count <= 65535;
+}
+
+template <typename T>
+void TransposeBatched2DImpl(
+    cudaStream_t stream,
+    const int64_t batch_count,
+    const int64_t rows,
+    const int64_t cols,
+    const T* input_data,
+    T* output_data) {
+  const dim3 blocks(static_cast<unsigned int>((cols + TILE_DIM - 1) / TILE_DIM),
+                    static_cast<unsigned int>((rows + TILE_DIM - 1) / TILE_DIM),
+                    static_cast<unsigned int>(batch_count));
+  const dim3 threads(TILE_DIM, BLOCK_ROWS);
+  _TransposeBatched2DKernel<T><<<blocks, threads, 0, stream>>>(
+      input_data, output_data, static_cast<int>(rows), static_cast<int>(cols));
+}
+
 #define SPECIALIZED_IMPL(T)                  \
   template void TransposeImpl<T>(            \
+      cudaStream_t stream,                   \
       const size_t shape_rank,               \
       const int64_t* input_strides,          \
       const int64_t* perm,                   \
       const T* input_data,                   \
       const fast_divmod* fdm_output_strides, \
       T* output_data,                        \
-      const size_t N);
+      const size_t N);                       \
+  template void TransposeBatched2DImpl<T>(   \
+      cudaStream_t stream,                   \
+      const int64_t batch_count,             \
+      const int64_t rows,                    \
+      const int64_t cols,                    \
+      const T* input_data,                   \
+      T* output_data);
 
 SPECIALIZED_IMPL(float)
 SPECIALIZED_IMPL(double)
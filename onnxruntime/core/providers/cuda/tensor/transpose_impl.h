@@ -10,6 +10,7 @@ namespace cuda {
 
 template <typename T>
 void TransposeImpl(
+    cudaStream_t stream,
     const size_t shape_rank,
     const int64_t* input_strides,
     const int64_t* perm,
@@ -18,5 +19,19 @@ void TransposeImpl(
     T* output_data,
     const size_t N);
 
+// whether the grid of TransposeBatched2DImpl can hold the tiles of the matrices
+bool CanDoTransposeBatched2D(int64_t batch_count, int64_t rows, int64_t cols);
+
+// transposes each of the batch_count matrices of rows x cols in the input into a matrix of cols x rows, tile by
+// tile through shared memory
+template <typename T>
+void TransposeBatched2DImpl(
+    cudaStream_t stream,
+    const int64_t batch_count,
+    const int64_t rows,
+    const int64_t cols,
+    const T* input_data,
+    T* output_data);
+
 }  // namespace cuda
 }  // namespace onnxruntime
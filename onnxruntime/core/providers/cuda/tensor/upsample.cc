@@ -28,6 +28,61 @@ REGISTER_KERNEL_TYPED(double)
 REGISTER_KERNEL_TYPED(MLFloat16)
 REGISTER_KERNEL_TYPED(int32_t)
 
+namespace {
+// fills the output pitches and the axis entries of the output indices of an upsampling from input_dims to
+// output_dims by int_scales, the ceilings of the scales of the node, which the axis of each output index is
+// divided by
+void FillCoordinateTables(const std::vector<int64_t>& input_dims,
+                          const std::vector<int64_t>& output_dims,
+                          const std::vector<int>& int_scales,
+                          std::vector<fast_divmod>& output_div_pitches,
+                          std::vector<int>& table_starts,
+                          std::vector<UpsampleAxisEntry>& entries) {
+  const size_t rank = input_dims.size();
+  TensorPitches input_pitches(input_dims);
+  TensorPitches output_pitches(output_dims);
+  for (size_t dim = 0; dim < rank; ++dim) {
+    output_div_pitches.emplace_back(gsl::narrow_cast<int>(output_pitches[dim]));
+    table_starts.push_back(gsl::narrow_cast<int>(entries.size()));
+    const int scale = int_scales[dim];
+    const int64_t pitch = input_pitches[dim];
+    for (int64_t output_index = 0; output_index < output_dims[dim]; ++output_index) {
+      const int64_t input_index = output_index / scale;
+      UpsampleAxisEntry entry;
+      entry.input_offset = gsl::narrow_cast<int>(input_index * pitch);
+      entry.next_offset = input_index + 1 < input_dims[dim] ? gsl::narrow_cast<int>(pitch) : 0;
+      entry.remainder = static_cast<int>(output_index % scale);
+      entry.weight = static_cast<float>(entry.remainder) / static_cast<float>(scale);
+      entries.push_back(entry);
+    }
+  }
+}
+}  // namespace
+
+template <typename T>
+constexpr size_t Upsample<T>::kMaxCachedTables;
+
+template <typename T>
+const typename Upsample<T>::CoordinateTables* Upsample<T>::FindTables(const std::vector<int64_t>& input_dims,
+                                                                      const std::vector<int64_t>& output_dims,
+                                                                      const std::vector<int>& int_scales) const {
+  for (const auto& tables : tables_) {
+    if (tables->input_dims == input_dims && tables->output_dims == output_dims && tables->int_scales == int_scales) {
+      return tables.get();
+    }
+  }
+  return nullptr;
+}
+
+template <typename T>
+template <typename U>
+Status Upsample<T>::CopyToDevice(const std::vector<U>& values, IAllocatorUniquePtr<U>& device_values) const {
+  device_values = GetScratchBuffer<U>(values.size());
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(device_values.get(), values.data(), sizeof(U) * values.size(),
+                                       cudaMemcpyHostToDevice, Stream()));
+  return Status::OK();
+}
+
 template <typename T>
 Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<float>& scales) const {
   const Tensor* X = context->Input<Tensor>(0);
@@ -40,6 +95,12 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
   if (rank != scales.size())
     return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Upsample: input tensor's dimension does not match the scales.");
 
+  if (UpsampleMode::LINEAR == mode_) {
+    if (rank != 4 || scales[0] != 1 || (scales[1] != 1 && scales[3] != 1))
+      return Status(ONNXRUNTIME, FAIL,
+                    "Upsample: linear mode upsample only support 4-D tensor with NCHW or NHWC layout");
+  }
+
   std::vector<int64_t> Y_dims;
   for (std::size_t i = 0; i < rank; i++) {
     Y_dims.push_back(static_cast<int64_t>(scales[i] * X_dims[i]));
@@ -47,45 +108,97 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
   Tensor* Y = context->Output(0, Y_dims);
   typedef typename ToCudaType<T>::MappedType CudaT;
 
-  // kernel
-  int device_id = 0;
-  TensorPitches input_pitches(X_dims);
-  CudaAsyncBuffer<int64_t> input_strides(this, device_id, rank);
-  gsl::span<int64_t> input_stride_span = input_strides.CpuSpan();
+  size_t output_count = Y->Shape().Size();
+  if (output_count == 0) {
+    return Status::OK();
+  }
 
-  TensorPitches output_pitches(Y_dims);
-  CudaAsyncBuffer<fast_divmod> output_div_pitches(this, device_id, rank);
-  gsl::span<fast_divmod> div_strides_span = output_div_pitches.CpuSpan();
+  std::vector<int> int_scales(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    int_scales[i] = gsl::narrow_cast<int>(ceil(scales[i]));
+  }
 
-  CudaAsyncBuffer<fast_divmod> scales_div(this, device_id, rank);
-  gsl::span<fast_divmod> scales_div_span = scales_div.CpuSpan();
+  // the tables of a shape are computed on the host and copied to the device once, by the first Run of the shape
+  const CoordinateTables* tables = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(tables_mutex_);
+    tables = FindTables(X_dims, Y_dims, int_scales);
+  }
 
-  for (int i = 0; i < rank; ++i) {
-    input_stride_span[i] = input_pitches[i];
-    div_strides_span[i] = fast_divmod(gsl::narrow_cast<int>(output_pitches[i]));
-    scales_div_span[i] = fast_divmod(gsl::narrow_cast<int>(ceil(scales[i])));
+  int device_id = 0;
+  CudaAsyncBuffer<fast_divmod> output_div_pitches(this);
+  CudaAsyncBuffer<int> table_starts(this);
+  CudaAsyncBuffer<UpsampleAxisEntry> entries(this);
+  std::vector<int> host_table_starts;
+  if (tables == nullptr) {
+    std::vector<fast_divmod> host_output_div_pitches;
+    std::vector<UpsampleAxisEntry> host_entries;
+    FillCoordinateTables(X_dims, Y_dims, int_scales, host_output_div_pitches, host_table_starts, host_entries);
+
+    std::lock_guard<OrtMutex> lock(tables_mutex_);
+    tables = FindTables(X_dims, Y_dims, int_scales);
+    if (tables == nullptr && tables_.size() < kMaxCachedTables) {
+      auto new_tables = std::make_unique<CoordinateTables>();
+      new_tables->input_dims = X_dims;
+      new_tables->output_dims = Y_dims;
+      new_tables->int_scales = int_scales;
+      ORT_RETURN_IF_ERROR(CopyToDevice(host_output_div_pitches, new_tables->output_div_pitches));
+      ORT_RETURN_IF_ERROR(CopyToDevice(host_table_starts, new_tables->table_starts));
+      ORT_RETURN_IF_ERROR(CopyToDevice(host_entries, new_tables->entries));
+      // the Runs on other streams use the tables too, and the host copies are released on return
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(Stream()));
+      tables = new_tables.get();
+      tables_.push_back(std::move(new_tables));
+    } else if (tables == nullptr) {
+      output_div_pitches = CudaAsyncBuffer<fast_divmod>(this, device_id, host_output_div_pitches);
+      table_starts = CudaAsyncBuffer<int>(this, device_id, host_table_starts);
+      entries = CudaAsyncBuffer<UpsampleAxisEntry>(this, device_id, host_entries);
+      ORT_RETURN_IF_ERROR(output_div_pitches.CopyToGpu());
+      ORT_RETURN_IF_ERROR(table_starts.CopyToGpu());
+      ORT_RETURN_IF_ERROR(entries.CopyToGpu());
+    }
   }
-  input_strides.CopyToGpu();
-  output_div_pitches.CopyToGpu();
-  scales_div.CopyToGpu();
 
-  size_t output_count = Y->Shape().Size();
+  const fast_divmod* output_div_pitches_data = tables != nullptr ? tables->output_div_pitches.get()
+                                                                 : output_div_pitches.GpuPtr();
+  const int* table_starts_data = tables != nullptr ? tables->table_starts.get() : table_starts.GpuPtr();
+  const UpsampleAxisEntry* entries_data = tables != nullptr ? tables->entries.get() : entries.GpuPtr();
 
+  const auto* input_data = reinterpret_cast<const CudaT*>(X->template Data<T>());
+  auto* output_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
   if (UpsampleMode::LINEAR == mode_) {
-    if (rank != 4)
-      return Status(ONNXRUNTIME, FAIL, "Upsample: linear mode upsample only support 4-D tensor with NCHW layout");
+    // the axes of the rows and the columns, H and W of NCHW unless C is scaled, then those of NHWC
+    const size_t row_axis = scales[1] == 1 ? 2 : 1;
+    const size_t column_axis = row_axis + 1;
+    const int64_t inner = row_axis == 2 ? 1 : Y_dims[3];
+    const int64_t output_row = Y_dims[column_axis] * inner;
+    int64_t row_entries_start = 0;
+    for (size_t dim = 0; dim < row_axis; ++dim) {
+      row_entries_start += Y_dims[dim];
+    }
+    UpsampleBilinearImpl(Stream(),
+                         fast_divmod(gsl::narrow_cast<int>(Y_dims[row_axis] * output_row)),
+                         fast_divmod(gsl::narrow_cast<int>(output_row)),
+                         fast_divmod(gsl::narrow_cast<int>(inner)),
+                         gsl::narrow_cast<int>(X_dims[row_axis] * X_dims[column_axis] * inner),
+                         int_scales[row_axis],
+                         int_scales[column_axis],
+                         entries_data + row_entries_start,
+                         entries_data + row_entries_start + Y_dims[row_axis],
+                         input_data,
+                         output_data,
+                         output_count);
+  } else {
+    UpsampleNearestImpl(Stream(),
+                        rank,
+                        output_div_pitches_data,
+                        table_starts_data,
+                        entries_data,
+                        input_data,
+                        output_data,
+                        output_count);
   }
 
-  UpampleImpl(mode_,
-              rank,
-              (UpsampleMode::LINEAR == mode_) ? X_dims[2] : 0,
-              input_strides.GpuPtr(),
-              output_div_pitches.GpuPtr(),
-              scales_div.GpuPtr(),
-              reinterpret_cast<const CudaT*>(X->template Data<T>()),
-              reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
-              output_count);
-
   return Status::OK();
 }
 
@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
 #include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/tensor/upsample_impl.h"
 #include "core/providers/cpu/tensor/upsample.h"
 
 namespace onnxruntime {
@@ -18,6 +22,31 @@ class Upsample : public UpsampleBase, public CudaKernel {
 
   Status ComputeInternal(OpKernelContext* context) const override;
   Status BaseCompute(OpKernelContext* context, const std::vector<float>& scales) const;
+
+ private:
+  // the output pitches and the axis entries of the output indices of a shape, on the device
+  struct CoordinateTables {
+    std::vector<int64_t> input_dims;
+    std::vector<int64_t> output_dims;
+    std::vector<int> int_scales;
+    IAllocatorUniquePtr<fast_divmod> output_div_pitches;
+    IAllocatorUniquePtr<int> table_starts;
+    IAllocatorUniquePtr<UpsampleAxisEntry> entries;
+  };
+
+  // the tables of the shapes a Run may still be using are never released, so only those of the first few shapes are
+  // kept and the tables of the others are copied to the device by each Run
+  static constexpr size_t kMaxCachedTables = 8;
+
+  // the cached tables of the shape, if there are. the caller holds tables_mutex_.
+  const CoordinateTables* FindTables(const std::vector<int64_t>& input_dims, const std::vector<int64_t>& output_dims,
+                                     const std::vector<int>& int_scales) const;
+
+  template <typename U>
+  Status CopyToDevice(const std::vector<U>& values, IAllocatorUniquePtr<U>& device_values) const;
+
+  mutable OrtMutex tables_mutex_;
+  mutable std::vector<std::unique_ptr<CoordinateTables>> tables_;
 };
 
 }  // namespace cuda
@@ -7,14 +7,36 @@
 namespace onnxruntime {
 namespace cuda {
 
+// type the interpolation is computed in. half is interpolated in float, so rounding only happens on the output.
 template <typename T>
-__global__ void _UpampleNearestKernel(const size_t rank,
-                                      const int64_t* input_pitches,
-                                      const fast_divmod* output_div_pitches,
-                                      const fast_divmod* scales_div,
-                                      const T* input_data,
-                                      T* output_data,
-                                      const size_t N) {
+struct UpsampleComputeType {
+  typedef T type;
+};
+
+template <>
+struct UpsampleComputeType<half> {
+  typedef float type;
+};
+
+// a + (b - a) * remainder / scale, which float computes with the precomputed weight
+template <typename T>
+__device__ __inline__ T UpsampleLerp(T a, T b, const UpsampleAxisEntry& entry, int scale) {
+  return a + static_cast<T>(static_cast<T>(entry.remainder) * (b - a) / static_cast<T>(scale));
+}
+
+template <>
+__device__ __inline__ float UpsampleLerp<float>(float a, float b, const UpsampleAxisEntry& entry, int) {
+  return a + entry.weight * (b - a);
+}
+
+template <typename T>
+__global__ void _UpsampleNearestKernel(const size_t rank,
+                                       const fast_divmod* output_div_pitches,
+                                       const int* table_starts,
+                                       const UpsampleAxisEntry* entries,
+                                       const T* input_data,
+                                       T* output_data,
+                                       const size_t N) {
   CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
   CUDA_LONG input_index = 0;
   CUDA_LONG output_index = id;
@@ -23,105 +45,91 @@ __global__ void _UpampleNearestKernel(const size_t rank,
   for (int dim = 0; dim < rank; ++dim) {
     output_div_pitches[dim].divmod(output_index, div, mod);
     output_index = mod;
-    if (scales_div[dim].d_ != 1 && div > 0) {
-      scales_div[dim].divmod(div, div, mod); 
-    }
-    input_index += input_pitches[dim] * div;
+    input_index += entries[table_starts[dim] + div].input_offset;
   }
   output_data[id] = input_data[input_index];
 }
 
 template <typename T>
-__global__ void _UpampleBilinearKernel(const int64_t input_dim2,
-                                       const int64_t* input_pitches,
-                                       const fast_divmod* output_div_pitches,
-                                       const fast_divmod* scales_div,
-                                       const T* input_data,
-                                       T* output_data,
-                                       const size_t N) {
+__global__ void _UpsampleBilinearKernel(const fast_divmod output_div_plane,
+                                        const fast_divmod output_div_row,
+                                        const fast_divmod output_div_inner,
+                                        const int input_plane,
+                                        const int scale_height,
+                                        const int scale_width,
+                                        const UpsampleAxisEntry* row_entries,
+                                        const UpsampleAxisEntry* column_entries,
+                                        const T* input_data,
+                                        T* output_data,
+                                        const size_t N) {
   CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
-  CUDA_LONG input_index = 0;
+  typedef typename UpsampleComputeType<T>::type ComputeT;
 
-  // For bilinear mode, scales[0]=scales[1]=1
-  int mod;
-  int index_of_dim0, index_of_dim1, index_of_dim2, index_of_dim3;
-  output_div_pitches[0].divmod(id, index_of_dim0, mod);
-  output_div_pitches[1].divmod(mod, index_of_dim1, mod);
-  output_div_pitches[2].divmod(mod, index_of_dim2, mod);
-  index_of_dim3 = mod;
-  int index_of_input_dim2, index_of_input_dim3, x_offset, y_offset;
-  scales_div[2].divmod(index_of_dim2, index_of_input_dim2, y_offset);
-  scales_div[3].divmod(index_of_dim3, index_of_input_dim3, x_offset);
-
-  input_index = index_of_dim0 * input_pitches[0] +
-                index_of_dim1 * input_pitches[1] +
-                index_of_input_dim2 * input_pitches[2] +
-                index_of_input_dim3;
-  
-  T x00 = input_data[input_index];
-  T x10, x01, x11;
-
-  bool end_of_dim2 = false;
-  if (index_of_input_dim2 == (input_dim2 - 1)) {
-    // It's the end in dimension 2
-    x01 = x00;
-    end_of_dim2 = true;
-  } else {
-    x01 = input_data[input_index + input_pitches[2]];
-  }
+  // the axes around H and W aren't scaled, so the planes and the values of a pixel of the output map to those of
+  // the input one to one
+  int plane, row, column, inner, mod;
+  output_div_plane.divmod(id, plane, mod);
+  output_div_row.divmod(mod, row, mod);
+  output_div_inner.divmod(mod, column, inner);
+  const UpsampleAxisEntry row_entry = row_entries[row];
+  const UpsampleAxisEntry column_entry = column_entries[column];
 
-  if (index_of_input_dim3 == (input_pitches[2] - 1)) {
-    // It's the end in dimension 3
-    x10 = x00;
-    x11 = x01;
-  }
-  else {
-    x10 = input_data[input_index + 1];
-    x11 = end_of_dim2 ? x10 : input_data[input_index + input_pitches[2] + 1];
-  }
+  const T* input = input_data + plane * input_plane + row_entry.input_offset + column_entry.input_offset + inner;
+  const ComputeT x00 = static_cast<ComputeT>(input[0]);
+  const ComputeT x10 = static_cast<ComputeT>(input[column_entry.next_offset]);
+  const ComputeT x01 = static_cast<ComputeT>(input[row_entry.next_offset]);
+  const ComputeT x11 = static_cast<ComputeT>(input[row_entry.next_offset + column_entry.next_offset]);
 
-  T y_offset_T = static_cast<T>(y_offset);
-  T x_offset_T = static_cast<T>(x_offset);
-  T scales_div2_T = static_cast<T>(scales_div[2].d_);
-  T scales_div3_T = static_cast<T>(scales_div[3].d_);
-  T y0 = x00 + static_cast<T>(y_offset_T * (x01 - x00) / scales_div2_T);
-  T y1 = x10 + static_cast<T>(y_offset_T * (x11 - x10) / scales_div2_T);
+  const ComputeT y0 = UpsampleLerp(x00, x01, row_entry, scale_height);
+  const ComputeT y1 = UpsampleLerp(x10, x11, row_entry, scale_height);
+  output_data[id] = static_cast<T>(UpsampleLerp(y0, y1, column_entry, scale_width));
+}
 
-  output_data[id] = y0 + static_cast<T>(x_offset_T * (y1 - y0) / scales_div3_T);
+template <typename T>
+void UpsampleNearestImpl(cudaStream_t stream,
+                         const size_t rank,
+                         const fast_divmod* output_div_pitches,
+                         const int* table_starts,
+                         const UpsampleAxisEntry* entries,
+                         const T* input_data,
+                         T* output_data,
+                         const size_t N) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _UpsampleNearestKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, stream>>>(
+      rank, output_div_pitches, table_starts, entries, input_data, output_data, N);
 }
 
 template <typename T>
-void UpampleImpl(const onnxruntime::UpsampleMode upsample_mode,
-                 const size_t rank,
-                 const int64_t input_dim2,
-                 const int64_t* input_pitches,
-                 const fast_divmod* output_div_pitches,
-                 const fast_divmod* scales_div,
-                 const T* input_data,
-                 T* output_data,
-                 const size_t N) {
+void UpsampleBilinearImpl(cudaStream_t stream,
+                          const fast_divmod& output_div_plane,
+                          const fast_divmod& output_div_row,
+                          const fast_divmod& output_div_inner,
+                          const int input_plane,
+                          const int scale_height,
+                          const int scale_width,
+                          const UpsampleAxisEntry* row_entries,
+                          const UpsampleAxisEntry* column_entries,
+                          const T* input_data,
+                          T* output_data,
+                          const size_t N) {
   int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
-  if (onnxruntime::UpsampleMode::NN == upsample_mode) {
-    _UpampleNearestKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
-        rank, input_pitches, output_div_pitches, scales_div,
-        input_data, output_data, N);
-  } else if (onnxruntime::UpsampleMode::LINEAR == upsample_mode) {
-    _UpampleBilinearKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
-        input_dim2, input_pitches, output_div_pitches, scales_div,
-        input_data, output_data, N);
-  }
+  _UpsampleBilinearKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, stream>>>(
+      output_div_plane, output_div_row, output_div_inner, input_plane, scale_height, scale_width, row_entries,
+      column_entries, input_data, output_data, N);
 }
 
-#define SPECIALIZED_IMPL(T)                                                     \
-  template void UpampleImpl<T>(const onnxruntime::UpsampleMode upsample_mode,   \
-                               const size_t rank,                               \
-                               const int64_t input_dim2,                        \
-                               const int64_t* input_pitches,                    \
-                               const fast_divmod* output_div_pitches,           \
-                               const fast_divmod* scales_div,                   \
-                               const T* input_data,                             \
-                               T* output_data,                                  \
-                               const size_t N);
+#define SPECIALIZED_IMPL(T)                                                                                     \
+  template void UpsampleNearestImpl<T>(cudaStream_t stream, const size_t rank,                                  \
+                                       const fast_divmod* output_div_pitches, const int* table_starts,          \
+                                       const UpsampleAxisEntry* entries, const T* input_data, T* output_data,   \
+                                       const size_t N);                                                         \
+  template void UpsampleBilinearImpl<T>(cudaStream_t stream, const fast_divmod& output_div_plane,               \
+                                        const fast_divmod& output_div_row, const fast_divmod& output_div_inner, \
+                                        const int input_plane,                                                  \
+                                        const int scale_height, const int scale_width,                          \
+                                        const UpsampleAxisEntry* row_entries,                                   \
+                                        const UpsampleAxisEntry* column_entries, const T* input_data,           \
+                                        T* output_data, const size_t N);
 
 SPECIALIZED_IMPL(float)
 SPECIALIZED_IMPL(double)
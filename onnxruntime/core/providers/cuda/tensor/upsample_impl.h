@@ -10,16 +10,41 @@
 namespace onnxruntime {
 namespace cuda {
 
+// where the input values of an output index along an axis are, computed once per shape rather than by every thread
+struct UpsampleAxisEntry {
+  int input_offset;  // the input index along the axis times the input pitch of the axis
+  int next_offset;   // the offset of the next input value along the axis, 0 at its end, for the linear mode
+  int remainder;     // the output index modulo the scale of the axis
+  float weight;      // remainder divided by the scale, the weight of the next value in the linear mode
+};
+
+// nearest mode of any rank. the entries of the output indices of axis dim start at table_starts[dim].
+template <typename T>
+void UpsampleNearestImpl(cudaStream_t stream,
+                         const size_t rank,
+                         const fast_divmod* output_div_pitches,
+                         const int* table_starts,
+                         const UpsampleAxisEntry* entries,
+                         const T* input_data,
+                         T* output_data,
+                         const size_t N);
+
+// linear mode of 4-D tensors that are only scaled along two adjacent axes, H and W of NCHW or NHWC, with the entries
+// of the output rows and columns. inner is the number of values of a pixel, C for NHWC and 1 for NCHW, and a plane
+// has the values of the pixels of an image or of one of its channels. half is interpolated in float.
 template <typename T>
-void UpampleImpl(const onnxruntime::UpsampleMode upsample_mode,
-                 const size_t rank,
-                 const int64_t input_dim2,
-                 const int64_t* input_pitches,
-                 const fast_divmod* output_div_pitches,
-                 const fast_divmod* scales_div,
-                 const T* input_data,
-                 T* output_data,
-                 const size_t N);
+void UpsampleBilinearImpl(cudaStream_t stream,
+                          const fast_divmod& output_div_plane,
+                          const fast_divmod& output_div_row,
+                          const fast_divmod& output_div_inner,
+                          const int input_plane,
+                          const int scale_height,
+                          const int scale_width,
+                          const UpsampleAxisEntry* row_entries,
+                          const UpsampleAxisEntry* column_entries,
+                          const T* input_data,
+                          T* output_data,
+                          const size_t N);
 
 }  // namespace cuda
 }  // namespace onnxruntime
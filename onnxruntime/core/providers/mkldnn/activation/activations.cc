@@ -23,12 +23,10 @@ struct ReluParams {
         dst_dims(dst_dims) {}
 
   // Used as the key for Pool Primitive Reuse Pool.
-  std::string ToString() const {
-    std::string key;
-    key.reserve(64);
-    key.append("Relu_");
-    AddDimsToKey(key, src_dims);
-    AddDimsToKey(key, dst_dims);
+  PrimitiveKey GetKey() const {
+    PrimitiveKey key;
+    key.AppendDims(src_dims);
+    key.AppendDims(dst_dims);
     return key;
   }
 };
@@ -124,20 +122,21 @@ template <typename T>
 class ReluPrimitivePool : public PrimitivePool<T> {
  public:
   static ReluPrimitive<T>* Get(const ReluParams& params) {
+    const PrimitiveKey key = params.GetKey();
     ReluPrimitive<T>* primitive = dynamic_cast<ReluPrimitive<T>*>(
-        ReluPrimitivePool<T>::GetInstance().GetPrimitive(params.ToString()));
+        ReluPrimitivePool<T>::GetInstance().GetPrimitive(key));
 
     if (primitive == nullptr) {
       auto relu_primitive = std::make_unique<ReluPrimitive<T>>(params);
       primitive = relu_primitive.get();
-      ReluPrimitivePool<T>::GetInstance().SetPrimitive(params.ToString(), 
+      ReluPrimitivePool<T>::GetInstance().SetPrimitive(key, 
 		std::move(relu_primitive));
     }
     return primitive;
   }
 
  private:
-  ReluPrimitivePool() = default;
+  ReluPrimitivePool() : PrimitivePool<T>("Relu") {}
   ~ReluPrimitivePool() = default;
 
   static ReluPrimitivePool& GetInstance() {
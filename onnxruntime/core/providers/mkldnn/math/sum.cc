@@ -29,14 +29,13 @@ struct SumParams {
     num_dimensions(dimensions) {}
 
   // Used as the key for Sum Primitive Reuse Sum.
-  std::string ToString() const {
-    std::string key;
-    key.reserve(64);
-    key.append("sum_");
+  PrimitiveKey GetKey() const {
+    PrimitiveKey key;
+    key.Append(static_cast<int64_t>(src_dims.size()));
     for (size_t i = 0; i < src_dims.size(); i++) {
-      AddDimsToKey(key, src_dims[i]);
+      key.AppendDims(src_dims[i]);
     }
-    AddDimsToKey(key, dst_dim);
+    key.AppendDims(dst_dim);
     return key;
   }
 };
@@ -154,20 +153,21 @@ template <typename T>
 class SumPrimitivePool : public PrimitivePool<T> {
  public:
   static SumPrimitive<T>* Get(const SumParams& params) {
+    const PrimitiveKey key = params.GetKey();
     SumPrimitive<T>* primitive = dynamic_cast<SumPrimitive<T>*>(
-        SumPrimitivePool<T>::GetInstance().GetPrimitive(params.ToString()));
+        SumPrimitivePool<T>::GetInstance().GetPrimitive(key));
 
     if (primitive == nullptr) {
       auto sum_primitive = std::make_unique<SumPrimitive<T>>(params);
       primitive = sum_primitive.get();
       SumPrimitivePool<T>::GetInstance().SetPrimitive(
-        params.ToString(), std::move(sum_primitive));
+        key, std::move(sum_primitive));
     }
     return primitive;
   }
 
  private:
-  SumPrimitivePool() = default;
+  SumPrimitivePool() : PrimitivePool<T>("Sum") {}
   ~SumPrimitivePool() = default;
 
   static SumPrimitivePool& GetInstance() {
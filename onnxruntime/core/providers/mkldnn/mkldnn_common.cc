@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/mkldnn/mkldnn_common.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+namespace {
+std::atomic<size_t> default_pool_capacity{1024};
+
+struct PoolRegistry {
+  std::mutex mutex;
+  std::vector<const PrimitivePoolBase*> pools;
+};
+
+PoolRegistry& GetPoolRegistry() {
+  static PoolRegistry registry;
+  return registry;
+}
+}  // namespace
+
+void SetDefaultPrimitivePoolCapacity(size_t capacity) {
+  ORT_ENFORCE(capacity > 0, "The capacity of a primitive pool must be positive.");
+  default_pool_capacity = capacity;
+}
+
+size_t GetDefaultPrimitivePoolCapacity() {
+  return default_pool_capacity;
+}
+
+std::vector<PrimitivePoolStats> GetPrimitivePoolStats() {
+  auto& registry = GetPoolRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::vector<PrimitivePoolStats> stats;
+  for (const auto* pool : registry.pools) {
+    stats.push_back(pool->GetStats());
+  }
+  return stats;
+}
+
+PrimitivePoolBase::PrimitivePoolBase(const char* name) : name_(name) {
+  auto& registry = GetPoolRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.pools.push_back(this);
+}
+
+PrimitivePoolBase::~PrimitivePoolBase() {
+  auto& registry = GetPoolRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.pools.erase(std::remove(registry.pools.begin(), registry.pools.end(), this), registry.pools.end());
+}
+
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
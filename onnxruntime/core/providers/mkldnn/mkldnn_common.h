@@ -2,70 +2,238 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "core/common/common.h"
 #include "mkldnn.hpp"
-#include <unordered_map>
 
 namespace onnxruntime {
 namespace mkl_dnn {
 
 template <typename T>
-static mkldnn::memory::data_type MklDnnType();
+mkldnn::memory::data_type MklDnnType();
 
 // Add more types here as needed.
 template <>
-mkldnn::memory::data_type MklDnnType<float>() {
+inline mkldnn::memory::data_type MklDnnType<float>() {
   return mkldnn::memory::data_type::f32;
 }
 
-static mkldnn::engine& GetEngine() {
+template <>
+inline mkldnn::memory::data_type MklDnnType<uint8_t>() {
+  return mkldnn::memory::data_type::u8;
+}
+
+template <>
+inline mkldnn::memory::data_type MklDnnType<int8_t>() {
+  return mkldnn::memory::data_type::s8;
+}
+
+template <>
+inline mkldnn::memory::data_type MklDnnType<int32_t>() {
+  return mkldnn::memory::data_type::s32;
+}
+
+// Gets the eltwise algorithm of the activation a FusedConv applies, which is passed its alpha. Returns false if
+// MKLDNN has none.
+inline bool GetEltwiseAlgorithm(const std::string& activation, mkldnn::algorithm& algorithm) {
+  if (activation == "Relu" || activation == "LeakyRelu") {
+    algorithm = mkldnn::algorithm::eltwise_relu;
+  } else if (activation == "Tanh") {
+    algorithm = mkldnn::algorithm::eltwise_tanh;
+  } else if (activation == "Sigmoid") {
+    algorithm = mkldnn::algorithm::eltwise_logistic;
+  } else {
+    algorithm = mkldnn::algorithm::algorithm_undef;
+    return false;
+  }
+  return true;
+}
+
+inline mkldnn::engine& GetEngine() {
   static mkldnn::engine cpu_engine = mkldnn::engine(mkldnn::engine::cpu, 0);
   return cpu_engine;
 }
 
-static void AddDimsToKey(std::string& key, const mkldnn::memory::dims& dims) {
-  key.append(1, '#');
-  for (size_t i = 0; i < dims.size(); i++) {
-    key.append(std::to_string(dims[i]));
-    key.append(1, '_');
+// The key of a primitive in a pool. The integers describing the primitive are hashed as they are appended, so that
+// looking it up neither formats nor compares strings.
+class PrimitiveKey {
+ public:
+  PrimitiveKey() {
+    words_.reserve(64);
   }
-  key.append(1, '#');
-}
+
+  void Append(int64_t value) {
+    words_.push_back(value);
+    hash_ ^= std::hash<int64_t>()(value) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+  }
+
+  void AppendDims(const mkldnn::memory::dims& dims) {
+    Append(static_cast<int64_t>(dims.size()));
+    for (auto dim : dims) {
+      Append(dim);
+    }
+  }
+
+  void AppendFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    Append(bits);
+  }
+
+  void AppendString(const std::string& value) {
+    Append(static_cast<int64_t>(value.size()));
+    for (char c : value) {
+      Append(c);
+    }
+  }
+
+  size_t Hash() const {
+    return hash_;
+  }
+
+  bool operator==(const PrimitiveKey& other) const {
+    return hash_ == other.hash_ && words_ == other.words_;
+  }
+
+ private:
+  std::vector<int64_t> words_;
+  size_t hash_ = 0;
+};
+
+struct PrimitiveKeyHash {
+  size_t operator()(const PrimitiveKey& key) const {
+    return key.Hash();
+  }
+};
 
 class PrimitiveBase {
  public:
   virtual ~PrimitiveBase() = default;
 };
 
+// The lookups and evictions of a primitive pool over all threads.
+struct PrimitivePoolStats {
+  std::string name;
+  size_t capacity;
+  size_t size;
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+};
+
+// Sets the number of primitives each pool keeps per thread, for the pools whose capacity is not set. The pools are
+// shared by the sessions of the process.
+void SetDefaultPrimitivePoolCapacity(size_t capacity);
+size_t GetDefaultPrimitivePoolCapacity();
+
+// Gets the stats of the pools created so far.
+std::vector<PrimitivePoolStats> GetPrimitivePoolStats();
+
+// The capacity and the stats of a pool, whose primitives are held by the thread that created them.
+class PrimitivePoolBase {
+ public:
+  void SetCapacity(size_t capacity) {
+    ORT_ENFORCE(capacity > 0, "The capacity of a primitive pool must be positive.");
+    capacity_ = capacity;
+  }
+
+  size_t GetCapacity() const {
+    size_t capacity = capacity_;
+    return capacity != 0 ? capacity : GetDefaultPrimitivePoolCapacity();
+  }
+
+  PrimitivePoolStats GetStats() const {
+    return {name_, GetCapacity(), size_, hits_, misses_, evictions_};
+  }
+
+ protected:
+  explicit PrimitivePoolBase(const char* name);
+  ~PrimitivePoolBase();
+
+  std::atomic<size_t> size_{0};
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+  std::atomic<size_t> evictions_{0};
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrimitivePoolBase);
+
+  const char* name_;
+  std::atomic<size_t> capacity_{0};
+};
+
+// Keeps the primitives built for a kernel per thread, as an MKL-DNN primitive is bound to the memory it computes
+// on and so can't run on several threads at once. The least recently used primitive of a thread is evicted when the
+// thread holds more than the capacity of the pool, so a pointer got from the pool is valid until the thread next
+// adds to the same pool.
 template <typename T>
-class PrimitivePool {
+class PrimitivePool : public PrimitivePoolBase {
  public:
-  PrimitivePool() = default;
+  explicit PrimitivePool(const char* name) : PrimitivePoolBase(name) {}
   ~PrimitivePool() = default;
 
-  void SetPrimitive(const std::string& key, std::unique_ptr<PrimitiveBase> primitive) {
-    auto& map = PrimitivePool<T>::GetMap();
-    auto iter = map.find(key);
+  void SetPrimitive(const PrimitiveKey& key, std::unique_ptr<PrimitiveBase> primitive) {
+    auto& cache = GetCache();
+    auto result = cache.entries.emplace(key, Entry{std::move(primitive), cache.lru.end()});
     // We should not find a primitive already using this key.
-    ORT_ENFORCE(iter == map.end(), "duplicate key: " + key);
-    map.insert(std::make_pair(key, std::move(primitive)));
+    ORT_ENFORCE(result.second, "duplicate primitive key");
+    cache.lru.push_front(&result.first->first);
+    result.first->second.lru = cache.lru.begin();
+    size_++;
+
+    const size_t capacity = GetCapacity();
+    while (cache.entries.size() > capacity) {
+      auto evicted = cache.entries.find(*cache.lru.back());
+      cache.lru.pop_back();
+      cache.entries.erase(evicted);
+      size_--;
+      evictions_++;
+    }
   }
 
-  PrimitiveBase* GetPrimitive(const std::string& key) {
-    const auto& map = PrimitivePool<T>::GetMap();
-    auto iter = map.find(key);
-    if (iter != map.end()) {
-      return iter->second.get();
-    } else {
+  PrimitiveBase* GetPrimitive(const PrimitiveKey& key) {
+    auto& cache = GetCache();
+    auto iter = cache.entries.find(key);
+    if (iter == cache.entries.end()) {
+      misses_++;
       return nullptr;
     }
+    hits_++;
+    cache.lru.splice(cache.lru.begin(), cache.lru, iter->second.lru);
+    return iter->second.primitive.get();
   }
 
  private:
-  // For thread safety, the map needs to be kept in thread local storage.
-  static inline std::unordered_map<std::string, std::unique_ptr<PrimitiveBase>>& GetMap() {
-    static thread_local std::unordered_map<std::string, std::unique_ptr<PrimitiveBase>> map;
-    return map;
+  struct Entry {
+    std::unique_ptr<PrimitiveBase> primitive;
+    std::list<const PrimitiveKey*>::iterator lru;
+  };
+
+  struct Cache {
+    std::atomic<size_t>* size = nullptr;
+    std::unordered_map<PrimitiveKey, Entry, PrimitiveKeyHash> entries;
+    // the keys of the entries, the most recently used first
+    std::list<const PrimitiveKey*> lru;
+
+    ~Cache() {
+      if (size != nullptr) {
+        *size -= entries.size();
+      }
+    }
+  };
+
+  // For thread safety, the primitives are kept in thread local storage.
+  Cache& GetCache() {
+    static thread_local std::unordered_map<const PrimitivePool*, Cache> caches;
+    auto& cache = caches[this];
+    cache.size = &size_;
+    return cache;
   }
 };
 
@@ -77,22 +245,16 @@ struct MemoryReorderParams {
   MemoryReorderParams(const mkldnn::memory& src, const mkldnn::memory& dst) : src(src), dst(dst) {}
 
   // Used as the key for MemoryReorder primitive reuse pool.
-  std::string ToString() const {
-    std::string key;
-    key.reserve(64);
-    key.append("reorder_");
+  PrimitiveKey GetKey() const {
+    PrimitiveKey key;
     const auto& src_desc = src.get_primitive_desc().desc().data;
     const auto& dst_desc = dst.get_primitive_desc().desc().data;
-    mkldnn::memory::dims src_dims(src_desc.dims, &src_desc.dims[src_desc.ndims]);
-    mkldnn::memory::dims dst_dims(dst_desc.dims, &dst_desc.dims[dst_desc.ndims]);
-    key.append(std::to_string(src_desc.format));
-    key.append(1, '_');
-    key.append(std::to_string(dst_desc.data_type));
-    AddDimsToKey(key, src_dims);
-    key.append(std::to_string(dst_desc.format));
-    key.append(1, '_');
-    key.append(std::to_string(dst_desc.data_type));
-    AddDimsToKey(key, dst_dims);
+    key.Append(src_desc.format);
+    key.Append(src_desc.data_type);
+    key.AppendDims(mkldnn::memory::dims(src_desc.dims, &src_desc.dims[src_desc.ndims]));
+    key.Append(dst_desc.format);
+    key.Append(dst_desc.data_type);
+    key.AppendDims(mkldnn::memory::dims(dst_desc.dims, &dst_desc.dims[dst_desc.ndims]));
     return key;
   }
 };
@@ -148,19 +310,20 @@ class MemoryReorderPrimitivePool : public PrimitivePool<T> {
   }
 
   static MemoryReorderPrimitive* Get(const MemoryReorderParams& params) {
+    const PrimitiveKey key = params.GetKey();
     MemoryReorderPrimitive* primitive = static_cast<MemoryReorderPrimitive*>(
-        MemoryReorderPrimitivePool<T>::GetInstance().GetPrimitive(params.ToString()));
+        MemoryReorderPrimitivePool<T>::GetInstance().GetPrimitive(key));
     if (primitive == nullptr) {
       auto reorder_primitive = std::make_unique<MemoryReorderPrimitive>(params);
       primitive = reorder_primitive.get();
-      MemoryReorderPrimitivePool<T>::GetInstance().SetPrimitive(params.ToString(), std::move(reorder_primitive));
+      MemoryReorderPrimitivePool<T>::GetInstance().SetPrimitive(key, std::move(reorder_primitive));
     }
     primitive->SetMemory(params);
     return primitive;
   }
 
  private:
-  MemoryReorderPrimitivePool() = default;
+  MemoryReorderPrimitivePool() : PrimitivePool<T>("MemoryReorder") {}
   ~MemoryReorderPrimitivePool() = default;
 };
 
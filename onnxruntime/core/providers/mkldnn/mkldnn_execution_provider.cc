@@ -3,10 +3,19 @@
 
 #include "mkldnn_allocator.h"
 #include "mkldnn_execution_provider.h"
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/framework/compute_capability.h"
 #include "core/framework/transformer_memcpy.h"
 #include "core/framework/memcpy.h"
 #include "core/framework/kernel_registry.h"
+#include "core/graph/graph_viewer.h"
+#include "core/providers/mkldnn/mkldnn_common.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_subgraph_primitive.h"
 #include "mkldnn_fwd.h"
 
 namespace onnxruntime {
@@ -17,7 +26,9 @@ ONNX_OPERATOR_KERNEL_EX(
     kOnnxDomain,
     1,
     kMklDnnExecutionProvider,
-    KernelDefBuilder().InputMemoryType<OrtMemTypeCPUInput>(0).TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    KernelDefBuilder()
+        .SetDefaultInputsMemoryType(OrtMemTypeCPUInput)
+        .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Memcpy);
 
 ONNX_OPERATOR_KERNEL_EX(
@@ -25,12 +36,18 @@ ONNX_OPERATOR_KERNEL_EX(
     kOnnxDomain,
     1,
     kMklDnnExecutionProvider,
-    KernelDefBuilder().OutputMemoryType<OrtMemTypeCPUOutput>(0).TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    KernelDefBuilder()
+        .SetDefaultOutputMemoryType(OrtMemTypeCPUOutput)
+        .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Memcpy);
 
 }  // namespace mkl_dnn
 
-MKLDNNExecutionProvider::MKLDNNExecutionProvider(const MKLDNNExecutionProviderInfo& /*info*/) {
+MKLDNNExecutionProvider::MKLDNNExecutionProvider(const MKLDNNExecutionProviderInfo& info) {
+  if (info.primitive_pool_capacity != 0) {
+    mkl_dnn::SetDefaultPrimitivePoolCapacity(info.primitive_pool_capacity);
+  }
+
   DeviceAllocatorRegistrationInfo default_allocator_info({OrtMemTypeDefault,
                                                           [](int) { return std::make_unique<MKLDNNAllocator>(); }, std::numeric_limits<size_t>::max()});
   InsertAllocator(CreateAllocator(default_allocator_info));
@@ -74,21 +91,27 @@ class ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider,
 class ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 8, 8, float, MaxPool);
 class ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, 8, float, GlobalMaxPool);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, float, LRN);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kMSDomain, 1, FusedConv);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kMSDomain, 1, ConvInteger);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kMSDomain, 1, QLinearConv);
 
 void RegisterMKLDNNKernels(KernelRegistry& kernel_registry) {
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, Conv)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 7, Gemm)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, MemcpyFromHost)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, MemcpyToHost)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 6, Relu)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 6, Sum)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 7, BatchNormalization)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 7, 8, float, AveragePool)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, 8, float, GlobalAveragePool)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, 7, float, MaxPool)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 8, 8, float, MaxPool)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, 8, float, GlobalMaxPool)>());
-  kernel_registry.Register(BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, float, LRN)>());
+  kernel_registry.Register("Conv", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, Conv)>);
+  kernel_registry.Register("Gemm", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 7, Gemm)>);
+  kernel_registry.Register("MemcpyFromHost", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, MemcpyFromHost)>);
+  kernel_registry.Register("MemcpyToHost", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, MemcpyToHost)>);
+  kernel_registry.Register("Relu", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 6, Relu)>);
+  kernel_registry.Register("Sum", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 6, Sum)>);
+  kernel_registry.Register("BatchNormalization", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 7, BatchNormalization)>);
+  kernel_registry.Register("AveragePool", BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 7, 8, float, AveragePool)>);
+  kernel_registry.Register("GlobalAveragePool", BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, 8, float, GlobalAveragePool)>);
+  kernel_registry.Register("MaxPool", BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, 7, float, MaxPool)>);
+  kernel_registry.Register("MaxPool", BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 8, 8, float, MaxPool)>);
+  kernel_registry.Register("GlobalMaxPool", BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, 8, float, GlobalMaxPool)>);
+  kernel_registry.Register("LRN", BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kOnnxDomain, 1, float, LRN)>);
+  kernel_registry.Register("FusedConv", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kMSDomain, 1, FusedConv)>);
+  kernel_registry.Register("ConvInteger", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kMSDomain, 1, ConvInteger)>);
+  kernel_registry.Register("QLinearConv", BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kMklDnnExecutionProvider, kMSDomain, 1, QLinearConv)>);
 }
 
 std::shared_ptr<KernelRegistry> GetMklDnnKernelRegistry() {
@@ -104,4 +127,250 @@ std::shared_ptr<KernelRegistry> MKLDNNExecutionProvider::GetKernelRegistry() con
   static std::shared_ptr<KernelRegistry> kernel_registry = onnxruntime::mkl_dnn::GetMklDnnKernelRegistry();
   return kernel_registry;
 }
+
+namespace {
+
+bool IsInitializer(const GraphViewer& graph_viewer, const NodeArg* arg) {
+  const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+  return arg->Exists() && graph_viewer.GetInitializedTensor(arg->Name(), tensor_proto);
+}
+
+const NodeAttributes::mapped_type* GetAttribute(const Node& node, const std::string& name) {
+  auto it = node.GetAttributes().find(name);
+  return it != node.GetAttributes().end() ? &it->second : nullptr;
+}
+
+bool HasDefaultAutoPad(const Node& node) {
+  const auto* auto_pad = GetAttribute(node, "auto_pad");
+  return auto_pad == nullptr || auto_pad->s() == "NOTSET";
+}
+
+bool IsFloatImage(const NodeArg* arg) {
+  const auto* type = arg->TypeAsProto();
+  const auto* shape = arg->Shape();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+         shape != nullptr && shape->dim_size() == 4;
+}
+
+// Whether the subgraph primitive composes the node, which takes a float NCHW image and, but for the image, only
+// constant inputs whose layouts are prepared once. An Add or a Sum takes two images of the same shape instead.
+bool IsSubgraphNode(const GraphViewer& graph_viewer, const Node& node) {
+  const auto& input_defs = node.InputDefs();
+  const auto& output_defs = node.OutputDefs();
+  const auto& op_type = node.OpType();
+  if (node.Domain() == kMSDomain) {
+    if (op_type != "FusedConv") {
+      return false;
+    }
+    const auto* activation = GetAttribute(node, "activation");
+    mkldnn::algorithm algorithm;
+    if (activation != nullptr && !mkl_dnn::GetEltwiseAlgorithm(activation->s(), algorithm)) {
+      return false;
+    }
+  } else if (node.Domain() != kOnnxDomain && node.Domain() != kOnnxDomainAlias) {
+    return false;
+  }
+  for (size_t i = 1; i < output_defs.size(); i++) {
+    if (output_defs[i]->Exists()) {
+      return false;
+    }
+  }
+  if (!IsFloatImage(input_defs[0])) {
+    return false;
+  }
+
+  if (op_type == "Add" || op_type == "Sum") {
+    if (input_defs.size() != 2 || !IsFloatImage(input_defs[1]) || input_defs[0] == input_defs[1]) {
+      return false;
+    }
+    const auto& shape = *input_defs[0]->Shape();
+    const auto& other_shape = *input_defs[1]->Shape();
+    for (int i = 0; i < shape.dim_size(); i++) {
+      if (!shape.dim(i).has_dim_value() || !other_shape.dim(i).has_dim_value() ||
+          shape.dim(i).dim_value() != other_shape.dim(i).dim_value()) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (op_type == "Conv" || op_type == "FusedConv") {
+    const ONNX_NAMESPACE::TensorProto* weights = nullptr;
+    return graph_viewer.GetInitializedTensor(input_defs[1]->Name(), weights) && weights->dims_size() == 4 &&
+           (input_defs.size() < 3 || !input_defs[2]->Exists() || IsInitializer(graph_viewer, input_defs[2])) &&
+           HasDefaultAutoPad(node);
+  }
+  if (op_type == "BatchNormalization") {
+    const auto* spatial = GetAttribute(node, "spatial");
+    return input_defs.size() == 5 && IsInitializer(graph_viewer, input_defs[1]) &&
+           IsInitializer(graph_viewer, input_defs[2]) && IsInitializer(graph_viewer, input_defs[3]) &&
+           IsInitializer(graph_viewer, input_defs[4]) && (spatial == nullptr || spatial->i() == 1);
+  }
+  if (op_type == "MaxPool" || op_type == "AveragePool") {
+    const auto* kernel_shape = GetAttribute(node, "kernel_shape");
+    return kernel_shape != nullptr && kernel_shape->ints_size() == 2 && HasDefaultAutoPad(node);
+  }
+  return op_type == "GlobalMaxPool" || op_type == "GlobalAveragePool" || op_type == "Relu" || op_type == "LRN";
+}
+
+bool IsGraphOutput(const GraphViewer& graph_viewer, const NodeArg* arg) {
+  const auto& outputs = graph_viewer.GetOutputs();
+  return std::find(outputs.begin(), outputs.end(), arg) != outputs.end();
+}
+
+// The state of a compiled subgraph, which allocates the outputs for the FunctionKernel.
+struct SubgraphState {
+  std::shared_ptr<mkl_dnn::MklDnnSubgraph> subgraph;
+  AllocateFunc allocate_func;
+  AllocatorHandle allocator;
+};
+
+}  // namespace
+
+std::vector<std::unique_ptr<ComputeCapability>>
+MKLDNNExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph_viewer,
+                                       const std::vector<const KernelRegistry*>& kernel_registries) const {
+  // the nodes there is a kernel of this provider for
+  std::vector<std::unique_ptr<ComputeCapability>> kernel_capabilities =
+      IExecutionProvider::GetCapability(graph_viewer, kernel_registries);
+  std::unordered_set<NodeIndex> kernel_nodes;
+  for (const auto& capability : kernel_capabilities) {
+    kernel_nodes.insert(capability->sub_graph->nodes[0]);
+  }
+
+  // Group the supported nodes in topological order, a node joining the group of the nodes producing its inputs if
+  // they're all in the same group. Only the first node of a group consumes values of nodes outside of it, so the
+  // fused node never depends on its own outputs. An Add is only run in a subgraph, where it's fused with a
+  // convolution, as there is no kernel of it; a group of it alone is left to another provider.
+  std::vector<std::vector<NodeIndex>> groups;
+  std::unordered_map<NodeIndex, size_t> node_groups;
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    const Node* node = graph_viewer.GetNode(index);
+    if ((kernel_nodes.count(index) == 0 && node->OpType() != "Add") || !node->GetExecutionProviderType().empty() ||
+        !IsSubgraphNode(graph_viewer, *node)) {
+      continue;
+    }
+    size_t group = groups.size();
+    for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+      auto producer_group = node_groups.find((*it).Index());
+      if (producer_group == node_groups.end() || (it != node->InputNodesBegin() && producer_group->second != group)) {
+        group = groups.size();
+        break;
+      }
+      group = producer_group->second;
+    }
+    if (group == groups.size()) {
+      groups.emplace_back();
+    }
+    groups[group].push_back(index);
+    node_groups[index] = group;
+  }
+
+  std::vector<std::unique_ptr<ComputeCapability>> result;
+  std::unordered_set<NodeIndex> fused_nodes;
+  for (const auto& group : groups) {
+    // a single node runs by its kernel
+    if (group.size() < 2) {
+      continue;
+    }
+
+    auto meta_def = std::make_unique<IndexedSubGraph::MetaDef>();
+    meta_def->name = "MklDnnSubgraph";
+    meta_def->domain = kMSDomain;
+    meta_def->since_version = 1;
+    meta_def->status = ONNX_NAMESPACE::EXPERIMENTAL;
+
+    std::unordered_set<std::string> fused_inputs;
+    std::unordered_set<std::string> produced;
+    for (auto index : group) {
+      const Node* node = graph_viewer.GetNode(index);
+      for (const auto* input : node->InputDefs()) {
+        if (input->Exists() && produced.count(input->Name()) == 0 && fused_inputs.insert(input->Name()).second) {
+          meta_def->inputs.push_back(input->Name());
+        }
+      }
+      const NodeArg* output = node->OutputDefs()[0];
+      produced.insert(output->Name());
+      bool consumed_outside = IsGraphOutput(graph_viewer, output);
+      for (auto it = node->OutputNodesBegin(); it != node->OutputNodesEnd(); ++it) {
+        if (node_groups.count((*it).Index()) == 0 || node_groups[(*it).Index()] != node_groups[index]) {
+          consumed_outside = true;
+        }
+      }
+      if (consumed_outside) {
+        meta_def->outputs.push_back(output->Name());
+      }
+    }
+
+    std::unique_ptr<IndexedSubGraph> sub_graph = std::make_unique<IndexedSubGraph>();
+    sub_graph->nodes = group;
+    sub_graph->SetMetaDef(meta_def);
+    result.push_back(std::make_unique<ComputeCapability>(std::move(sub_graph)));
+    fused_nodes.insert(group.begin(), group.end());
+  }
+
+  for (auto& capability : kernel_capabilities) {
+    if (fused_nodes.count(capability->sub_graph->nodes[0]) == 0) {
+      result.push_back(std::move(capability));
+    }
+  }
+  return result;
+}
+
+common::Status MKLDNNExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
+                                                std::vector<NodeComputeInfo>& node_compute_funcs) {
+  static std::atomic<int> next_subgraph_id{0};
+
+  for (const auto* fused_node : fused_nodes) {
+    const auto* func_body = fused_node->GetFunctionBody();
+    if (func_body == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Function body is empty");
+    }
+
+    auto subgraph = std::make_shared<mkl_dnn::MklDnnSubgraph>();
+    subgraph->id = next_subgraph_id++;
+    for (const auto* input : fused_node->InputDefs()) {
+      subgraph->inputs.push_back(input->Name());
+    }
+    for (const auto* output : fused_node->OutputDefs()) {
+      subgraph->outputs.push_back(output->Name());
+    }
+    const GraphViewer body_viewer(func_body->Body());
+    for (auto index : body_viewer.GetNodesInTopologicalOrder()) {
+      const Node* node = body_viewer.GetNode(index);
+      mkl_dnn::MklDnnNode subgraph_node;
+      subgraph_node.op_type = node->OpType();
+      subgraph_node.attributes = node->GetAttributes();
+      for (const auto* input : node->InputDefs()) {
+        subgraph_node.inputs.push_back(input->Exists() ? input->Name() : std::string());
+      }
+      subgraph_node.output = node->OutputDefs()[0]->Name();
+      subgraph->nodes.push_back(std::move(subgraph_node));
+    }
+
+    NodeComputeInfo compute_info;
+    compute_info.create_state_func = [subgraph](ComputeContext* context, FunctionState* state) {
+      *state = new SubgraphState{subgraph, context->allocate_func, context->allocator_handle};
+      return 0;
+    };
+    compute_info.release_state_func = [](FunctionState state) {
+      delete static_cast<SubgraphState*>(state);
+    };
+    compute_info.compute_func = [](FunctionState state, ONNXRunTimeTensor* input_tensors, size_t num_inputs,
+                                   ONNXRunTimeTensor* output_tensors, size_t num_outputs) {
+      const auto* subgraph_state = static_cast<SubgraphState*>(state);
+      Status status = mkl_dnn::RunMklDnnSubgraph(*subgraph_state->subgraph, input_tensors, num_inputs,
+                                                 output_tensors, num_outputs, subgraph_state->allocate_func,
+                                                 subgraph_state->allocator);
+      if (!status.IsOK()) {
+        LOGS_DEFAULT(ERROR) << status.ErrorMessage();
+        return 1;
+      }
+      return 0;
+    };
+    node_compute_funcs.push_back(compute_info);
+  }
+
+  return Status::OK();
+}
 }  // namespace onnxruntime
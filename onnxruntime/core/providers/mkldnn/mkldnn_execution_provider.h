@@ -22,6 +22,9 @@ namespace onnxruntime {
 // Information needed to construct MKL-DNN execution providers.
 struct MKLDNNExecutionProviderInfo {
   bool create_arena{true};
+  // The number of primitives each kernel keeps per thread, over the sessions of the process. Zero keeps the current
+  // capacity.
+  size_t primitive_pool_capacity{0};
 
   explicit MKLDNNExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -46,6 +49,15 @@ class MKLDNNExecutionProvider : public IExecutionProvider {
 
   virtual std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
 
+  // Fuses the connected nodes the subgraph primitive supports, so that the values between them stay in the blocked
+  // layouts of MKL-DNN. The other nodes run by the kernels of this provider.
+  std::vector<std::unique_ptr<ComputeCapability>>
+  GetCapability(const onnxruntime::GraphViewer& graph_viewer,
+                const std::vector<const KernelRegistry*>& kernel_registries) const override;
+
+  common::Status Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
+                         std::vector<NodeComputeInfo>& node_compute_funcs) override;
+
   std::shared_ptr<mkldnn::memory> GetWeightsMemoryBuffer(const std::string& weight_key) {
     auto iter = weights_mem_map_.find(weight_key);
     if (iter != weights_mem_map_.end())
@@ -39,16 +39,16 @@ struct BatchNormParams {
     epsilon(eps) {}
 
   // Used as the key for BatchNorm Primitive Reuse Pool.
-  std::string ToString() const {
-    std::string key;
-    key.reserve(128);
-    key.append("BatchNorm_");
-    AddDimsToKey(key, src_dims);
-    AddDimsToKey(key, scale_dims);
-    AddDimsToKey(key, b_dims);
-    AddDimsToKey(key, mean_dims);
-    AddDimsToKey(key, var_dims);
-    AddDimsToKey(key, dst_dims);
+  PrimitiveKey GetKey() const {
+    PrimitiveKey key;
+    key.AppendDims(src_dims);
+    key.AppendDims(scale_dims);
+    key.AppendDims(b_dims);
+    key.AppendDims(mean_dims);
+    key.AppendDims(var_dims);
+    key.AppendDims(dst_dims);
+    // the primitive is built for the epsilon
+    key.AppendFloat(epsilon);
     return key;
   }
 };
@@ -187,21 +187,22 @@ template <typename T>
 class BatchNormPrimitivePool : public PrimitivePool<T> {
  public:
   static BatchNormPrimitive<T>* Get(const BatchNormParams& params) {
+    const PrimitiveKey key = params.GetKey();
     BatchNormPrimitive<T>* primitive = 
       dynamic_cast<BatchNormPrimitive<T>*>(
-        BatchNormPrimitivePool<T>::GetInstance().GetPrimitive(params.ToString()));
+        BatchNormPrimitivePool<T>::GetInstance().GetPrimitive(key));
 
     if (primitive == nullptr) {
       auto BatchNorm_primitive = std::make_unique<BatchNormPrimitive<T>>(params);
       primitive = BatchNorm_primitive.get();
       BatchNormPrimitivePool<T>::GetInstance().SetPrimitive(
-        params.ToString(), std::move(BatchNorm_primitive));
+        key, std::move(BatchNorm_primitive));
     }
     return primitive;
   }
 
  private:
-  BatchNormPrimitivePool() = default;
+  BatchNormPrimitivePool() : PrimitivePool<T>("BatchNormalization") {}
   ~BatchNormPrimitivePool() = default;
 
   static BatchNormPrimitivePool& GetInstance() {
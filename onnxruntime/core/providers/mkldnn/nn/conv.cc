@@ -25,11 +25,16 @@ struct ConvParams {
   const mkldnn::memory::dims& dilations;
   const mkldnn::memory::dims& padding_left;
   const mkldnn::memory::dims& padding_right;
+  // the activation of a FusedConv, applied by a post-op of the convolution
+  const bool has_activation;
+  const mkldnn::algorithm activation;
+  const float alpha;
 
   ConvParams(const mkldnn::memory::dims& src_dims, const mkldnn::memory::dims& filter_dims,
              const mkldnn::memory::dims& bias_dims, const mkldnn::memory::dims& dst_dims,
              const mkldnn::memory::dims& strides, const mkldnn::memory::dims& dilations,
-             const mkldnn::memory::dims& padding_left, const mkldnn::memory::dims& padding_right)
+             const mkldnn::memory::dims& padding_left, const mkldnn::memory::dims& padding_right,
+             bool has_activation, mkldnn::algorithm activation, float alpha)
       : src_dims(src_dims),
         filter_dims(filter_dims),
         bias_dims(bias_dims),
@@ -37,21 +42,27 @@ struct ConvParams {
         strides(strides),
         dilations(dilations),
         padding_left(padding_left),
-        padding_right(padding_right) {}
+        padding_right(padding_right),
+        has_activation(has_activation),
+        activation(activation),
+        alpha(alpha) {}
 
   // Used as the key for Conv Primitive Reuse Pool.
-  std::string ToString() const {
-    std::string key;
-    key.reserve(128);
-    key.append("conv_");
-    AddDimsToKey(key, src_dims);
-    AddDimsToKey(key, filter_dims);
-    AddDimsToKey(key, bias_dims);
-    AddDimsToKey(key, dst_dims);
-    AddDimsToKey(key, strides);
-    AddDimsToKey(key, dilations);
-    AddDimsToKey(key, padding_left);
-    AddDimsToKey(key, padding_right);
+  PrimitiveKey GetKey() const {
+    PrimitiveKey key;
+    key.AppendDims(src_dims);
+    key.AppendDims(filter_dims);
+    key.AppendDims(bias_dims);
+    key.AppendDims(dst_dims);
+    key.AppendDims(strides);
+    key.AppendDims(dilations);
+    key.AppendDims(padding_left);
+    key.AppendDims(padding_right);
+    key.Append(has_activation);
+    if (has_activation) {
+      key.Append(activation);
+      key.AppendFloat(alpha);
+    }
     return key;
   }
 };
@@ -183,8 +194,14 @@ class ConvPrimitive : public PrimitiveBase {
           params.padding_right, mkldnn::padding_kind::zero));
     }
 
+    mkldnn::primitive_attr attr;
+    if (params.has_activation) {
+      mkldnn::post_ops ops;
+      ops.append_eltwise(1.0f, params.activation, params.alpha, 0.0f);
+      attr.set_post_ops(ops);
+    }
     context_.conv_fwd_pd.reset(new mkldnn::convolution_forward::primitive_desc(
-        *context_.fwd_desc, cpu_engine_));
+        *context_.fwd_desc, attr, cpu_engine_));
 
     context_.src_fmt = static_cast<mkldnn::memory::format>(
         context_.conv_fwd_pd.get()->src_primitive_desc().desc().data.format);
@@ -234,19 +251,20 @@ template <typename T>
 class ConvPrimitivePool : public PrimitivePool<T> {
  public:
   static ConvPrimitive<T>* Get(const ConvParams& params) {
+    const PrimitiveKey key = params.GetKey();
     ConvPrimitive<T>* primitive = dynamic_cast<ConvPrimitive<T>*>(
-        ConvPrimitivePool<T>::GetInstance().GetPrimitive(params.ToString()));
+        ConvPrimitivePool<T>::GetInstance().GetPrimitive(key));
 
     if (primitive == nullptr) {
       auto conv_primitive = std::make_unique<ConvPrimitive<T>>(params);
       primitive = conv_primitive.get();
-      ConvPrimitivePool<T>::GetInstance().SetPrimitive(params.ToString(), std::move(conv_primitive));
+      ConvPrimitivePool<T>::GetInstance().SetPrimitive(key, std::move(conv_primitive));
     }
     return primitive;
   }
 
  private:
-  ConvPrimitivePool() = default;
+  ConvPrimitivePool() : PrimitivePool<T>("Conv") {}
   ~ConvPrimitivePool() = default;
 
   static ConvPrimitivePool& GetInstance() {
@@ -352,7 +370,8 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   try {
     ConvParams conv_params(src_dims_mkl, filter_dims_mkl, bias_dims_mkl,
                            dst_dims_mkl, strides_mkl, dilations_mkl,
-                           padding_left_mkl, padding_right_mkl);
+                           padding_left_mkl, padding_right_mkl,
+                           has_activation_, activation_algorithm_, activation_alpha_);
     ConvPrimitive<T>* conv_primitive = ConvPrimitivePool<T>::Get(conv_params);
     auto conv_fwd_pd = conv_primitive->GetPrimitiveDesc();
 
@@ -468,5 +487,13 @@ ONNX_OPERATOR_KERNEL_EX(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Conv<float>);
 
+ONNX_OPERATOR_KERNEL_EX(
+    FusedConv,
+    kMSDomain,
+    1,
+    kMklDnnExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Conv<float>);
+
 }  // namespace mkl_dnn
 }  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #pragma once
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv.h"
+#include "core/providers/mkldnn/mkldnn_common.h"
 #include "core/providers/mkldnn/mkldnn_execution_provider.h"
 
 namespace onnxruntime {
@@ -15,12 +16,25 @@ class Conv final : public onnxruntime::Conv<T> {
   explicit Conv(const OpKernelInfo& info) : onnxruntime::Conv<T>(info) {
     provider_ = (const_cast<MKLDNNExecutionProvider*>(
         dynamic_cast<const MKLDNNExecutionProvider*>(info.GetExecutionProvider())));
+
+    // A FusedConv applies its activation by a post-op of the convolution, and so does the CPU implementation it
+    // falls back to.
+    ConvBase::activation_ = info.GetAttrOrDefault<std::string>("activation", "");
+    ConvBase::alpha_ = info.GetAttrOrDefault("alpha", 0.01f);
+    has_activation_ = GetEltwiseAlgorithm(ConvBase::activation_, activation_algorithm_);
+    ORT_ENFORCE(has_activation_ || ConvBase::activation_.empty(),
+                "Not implemented fused activation: ", ConvBase::activation_);
+    // the negative slope of the eltwise relu
+    activation_alpha_ = ConvBase::activation_ == "LeakyRelu" ? ConvBase::alpha_ : 0.0f;
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
   MKLDNNExecutionProvider* provider_;
+  bool has_activation_;
+  mkldnn::algorithm activation_algorithm_;
+  float activation_alpha_;
 };
 }  // namespace mkl_dnn
 }  // namespace onnxruntime
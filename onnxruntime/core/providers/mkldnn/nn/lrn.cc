@@ -34,16 +34,13 @@ struct LRNParams {
       : dims_(dims), alpha_(alpha), beta_(beta), bias_(bias), size_(size) {}
 
   // Used as the key for LRN Primitive Reuse LRN.
-  std::string ToString() const {
-    std::string key;
-    key.reserve(128);
-    key.append("lrn");
-    AddDimsToKey(key, dims_);
-    key.append('#' + std::to_string(alpha_) + '#');
-    key.append('#' + std::to_string(beta_) + '#');
-    key.append('#' + std::to_string(bias_) + '#');
-    key.append('#' + std::to_string(size_) + '#');
-
+  PrimitiveKey GetKey() const {
+    PrimitiveKey key;
+    key.AppendDims(dims_);
+    key.AppendFloat(alpha_);
+    key.AppendFloat(beta_);
+    key.AppendFloat(bias_);
+    key.Append(size_);
     return key;
   }
 };
@@ -146,18 +143,19 @@ template <typename T>
 class LRNPrimitivePool : public PrimitivePool<T> {
  public:
   static LRNPrimitive<T>* Get(const LRNParams& params) {
+    const PrimitiveKey key = params.GetKey();
     LRNPrimitive<T>* primitive = dynamic_cast<LRNPrimitive<T>*>(
-        LRNPrimitivePool<T>::GetInstance().GetPrimitive(params.ToString()));
+        LRNPrimitivePool<T>::GetInstance().GetPrimitive(key));
     if (primitive == nullptr) {
       auto pool_primitive = std::make_unique<LRNPrimitive<T>>(params);
       primitive = pool_primitive.get();
-      LRNPrimitivePool<T>::GetInstance().SetPrimitive(params.ToString(), std::move(pool_primitive));
+      LRNPrimitivePool<T>::GetInstance().SetPrimitive(key, std::move(pool_primitive));
     }
     return primitive;
   }
 
  private:
-  LRNPrimitivePool() = default;
+  LRNPrimitivePool() : PrimitivePool<T>("LRN") {}
   ~LRNPrimitivePool() = default;
 
   static LRNPrimitivePool& GetInstance() {
@@ -61,18 +61,17 @@ struct PoolParams {
         count_include_pad(count_include_pad) {}
 
   // Used as the key for Pool Primitive Reuse Pool.
-  std::string ToString() const {
-    std::string key;
-    key.reserve(128);
-    key.append(op_name);
-    key.append(version);
-    AddDimsToKey(key, src_dims);
-    AddDimsToKey(key, dst_dims);
-    AddDimsToKey(key, kernel);
-    AddDimsToKey(key, strides);
-    AddDimsToKey(key, padding_left);
-    AddDimsToKey(key, padding_right);
-    key.append(count_include_pad ? "true" : "false");
+  PrimitiveKey GetKey() const {
+    PrimitiveKey key;
+    key.AppendString(op_name);
+    key.AppendString(version);
+    key.AppendDims(src_dims);
+    key.AppendDims(dst_dims);
+    key.AppendDims(kernel);
+    key.AppendDims(strides);
+    key.AppendDims(padding_left);
+    key.AppendDims(padding_right);
+    key.Append(count_include_pad);
     return key;
   }
 };
@@ -208,18 +207,20 @@ template <typename T, typename PoolType>
 class PoolPrimitivePool : public PrimitivePool<T> {
  public:
   static PoolPrimitive<T, PoolType>* Get(const PoolParams& params) {
+    const PrimitiveKey key = params.GetKey();
     PoolPrimitive<T, PoolType>* primitive = dynamic_cast<PoolPrimitive<T, PoolType>*>(
-        PoolPrimitivePool<T, PoolType>::GetInstance().GetPrimitive(params.ToString()));
+        PoolPrimitivePool<T, PoolType>::GetInstance().GetPrimitive(key));
     if (primitive == nullptr) {
       auto pool_primitive = std::make_unique<PoolPrimitive<T, PoolType>>(params);
       primitive = pool_primitive.get();
-      PoolPrimitivePool<T, PoolType>::GetInstance().SetPrimitive(params.ToString(), std::move(pool_primitive));
+      PoolPrimitivePool<T, PoolType>::GetInstance().SetPrimitive(key, std::move(pool_primitive));
     }
     return primitive;
   }
 
  private:
-  PoolPrimitivePool() = default;
+  PoolPrimitivePool()
+      : PrimitivePool<T>(PoolType::type == onnxruntime::PoolType::kAveragePool ? "AveragePool" : "MaxPool") {}
   ~PoolPrimitivePool() = default;
 
   static PoolPrimitivePool& GetInstance() {
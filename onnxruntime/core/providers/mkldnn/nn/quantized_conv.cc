@@ -0,0 +1,481 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifdef _WIN32
+#pragma warning(disable : 4244)
+#endif
+
+#include "core/providers/mkldnn/nn/quantized_conv.h"
+
+#include <algorithm>
+
+#include "core/providers/mkldnn/mkldnn_common.h"
+#include "core/providers/mkldnn/mkldnn_fwd.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+ONNX_OPERATOR_KERNEL_EX(
+    ConvInteger,
+    kMSDomain,
+    1,
+    kMklDnnExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
+    ConvInteger);
+
+ONNX_OPERATOR_KERNEL_EX(
+    QLinearConv,
+    kMSDomain,
+    1,
+    kMklDnnExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearConv);
+
+namespace {
+// Struct which encapsulates parameters for MKLDNN int8 Conv primitive.
+struct QuantizedConvParams {
+  const mkldnn::memory::dims& src_dims;
+  const mkldnn::memory::dims& filter_dims;
+  const mkldnn::memory::dims& dst_dims;
+  const mkldnn::memory::dims& strides;
+  const mkldnn::memory::dims& dilations;
+  const mkldnn::memory::dims& padding_left;
+  const mkldnn::memory::dims& padding_right;
+  // the bias is float if the output is quantized and int32 otherwise
+  const bool has_bias;
+  const bool quantize_output;
+  const float output_scale;
+
+  QuantizedConvParams(const mkldnn::memory::dims& src_dims, const mkldnn::memory::dims& filter_dims,
+                      const mkldnn::memory::dims& dst_dims, const mkldnn::memory::dims& strides,
+                      const mkldnn::memory::dims& dilations, const mkldnn::memory::dims& padding_left,
+                      const mkldnn::memory::dims& padding_right, bool has_bias, bool quantize_output,
+                      float output_scale)
+      : src_dims(src_dims),
+        filter_dims(filter_dims),
+        dst_dims(dst_dims),
+        strides(strides),
+        dilations(dilations),
+        padding_left(padding_left),
+        padding_right(padding_right),
+        has_bias(has_bias),
+        quantize_output(quantize_output),
+        output_scale(output_scale) {}
+
+  // Used as the key for int8 Conv Primitive Reuse Pool.
+  PrimitiveKey GetKey() const {
+    PrimitiveKey key;
+    key.AppendDims(src_dims);
+    key.AppendDims(filter_dims);
+    key.AppendDims(dst_dims);
+    key.AppendDims(strides);
+    key.AppendDims(dilations);
+    key.AppendDims(padding_left);
+    key.AppendDims(padding_right);
+    key.Append(has_bias);
+    key.Append(quantize_output);
+    key.AppendFloat(output_scale);
+    return key;
+  }
+};
+
+class QuantizedConvPrimitive : public PrimitiveBase {
+ public:
+  explicit QuantizedConvPrimitive(const QuantizedConvParams& params)
+      : cpu_engine_(GetEngine()) {
+    context_.stream.reset(new mkldnn::stream(mkldnn::stream::kind::eager));
+    Initialize(params);
+  }
+
+  ~QuantizedConvPrimitive() = default;
+
+  void Compute(const void* src_data, const void* filter_data, const void* bias_data, void* dst_data) {
+    context_.src_mem->set_data_handle(const_cast<void*>(src_data));
+    context_.filter_mem->set_data_handle(const_cast<void*>(filter_data));
+    if (bias_data != nullptr) {
+      context_.bias_mem->set_data_handle(const_cast<void*>(bias_data));
+    }
+    context_.dst_mem->set_data_handle(dst_data);
+    context_.stream->submit(context_.net);
+
+    context_.src_mem->set_data_handle(nullptr);
+    context_.filter_mem->set_data_handle(nullptr);
+    if (bias_data != nullptr) {
+      context_.bias_mem->set_data_handle(nullptr);
+    }
+    context_.dst_mem->set_data_handle(nullptr);
+  }
+
+  mkldnn::convolution_forward::primitive_desc* GetPrimitiveDesc() const {
+    return context_.conv_fwd_pd.get();
+  }
+
+ private:
+  struct QuantizedConvContext {
+    std::unique_ptr<mkldnn::memory> src_mem;
+    std::unique_ptr<mkldnn::memory> filter_mem;
+    std::unique_ptr<mkldnn::memory> bias_mem;
+    std::unique_ptr<mkldnn::memory> dst_mem;
+
+    std::unique_ptr<mkldnn::convolution_forward::primitive_desc> conv_fwd_pd;
+    std::unique_ptr<mkldnn::primitive> conv_fwd;
+
+    std::unique_ptr<mkldnn::stream> stream;
+    std::vector<mkldnn::primitive> net;
+  };
+
+  void Initialize(const QuantizedConvParams& params) {
+    const auto dst_type = params.quantize_output ? MklDnnType<uint8_t>() : MklDnnType<int32_t>();
+    const auto bias_type = params.quantize_output ? MklDnnType<float>() : MklDnnType<int32_t>();
+
+    // Set the memory descriptors to format::any to allow MKLDNN to decide what the optimal memory layout should be
+    // for the computation given the input params.
+    auto src_md = mkldnn::memory::desc({params.src_dims}, MklDnnType<uint8_t>(), mkldnn::memory::format::any);
+    auto filter_md = mkldnn::memory::desc({params.filter_dims}, MklDnnType<int8_t>(), mkldnn::memory::format::any);
+    auto bias_md = mkldnn::memory::desc({params.dst_dims[1]}, bias_type, mkldnn::memory::format::any);
+    auto dst_md = mkldnn::memory::desc({params.dst_dims}, dst_type, mkldnn::memory::format::any);
+
+    std::unique_ptr<mkldnn::convolution_forward::desc> fwd_desc;
+    if (params.has_bias) {
+      fwd_desc.reset(new mkldnn::convolution_forward::desc(
+          mkldnn::prop_kind::forward_inference, mkldnn::convolution_direct, src_md, filter_md, bias_md, dst_md,
+          params.strides, params.dilations, params.padding_left, params.padding_right, mkldnn::padding_kind::zero));
+    } else {
+      fwd_desc.reset(new mkldnn::convolution_forward::desc(
+          mkldnn::prop_kind::forward_inference, mkldnn::convolution_direct, src_md, filter_md, dst_md,
+          params.strides, params.dilations, params.padding_left, params.padding_right, mkldnn::padding_kind::zero));
+    }
+
+    // The bias is added to the sums of the products before they're scaled, and the scaled sums are rounded to
+    // nearest as they're converted to uint8.
+    mkldnn::primitive_attr attr;
+    if (params.quantize_output) {
+      attr.set_output_scales(0, {params.output_scale});
+      attr.set_int_output_round_mode(mkldnn::round_mode::round_nearest);
+    }
+    context_.conv_fwd_pd.reset(new mkldnn::convolution_forward::primitive_desc(*fwd_desc, attr, cpu_engine_));
+
+    context_.src_mem.reset(new mkldnn::memory(context_.conv_fwd_pd->src_primitive_desc(), nullptr));
+    context_.filter_mem.reset(new mkldnn::memory(context_.conv_fwd_pd->weights_primitive_desc(), nullptr));
+    context_.dst_mem.reset(new mkldnn::memory(context_.conv_fwd_pd->dst_primitive_desc(), nullptr));
+    if (params.has_bias) {
+      context_.bias_mem.reset(new mkldnn::memory(context_.conv_fwd_pd->bias_primitive_desc(), nullptr));
+      context_.conv_fwd.reset(new mkldnn::convolution_forward(
+          *context_.conv_fwd_pd, *context_.src_mem, *context_.filter_mem, *context_.bias_mem, *context_.dst_mem));
+    } else {
+      context_.conv_fwd.reset(new mkldnn::convolution_forward(
+          *context_.conv_fwd_pd, *context_.src_mem, *context_.filter_mem, *context_.dst_mem));
+    }
+    context_.net.push_back(*context_.conv_fwd);
+  }
+
+  QuantizedConvContext context_;
+  mkldnn::engine& cpu_engine_;
+};
+
+// Pool which allows for reuse of MKLDNN int8 Conv primitives which are expensive to instantiate.
+// To address thread safety, the primitives are stored in a map on thread local storage.
+class QuantizedConvPrimitivePool : public PrimitivePool<uint8_t> {
+ public:
+  static QuantizedConvPrimitive* Get(const QuantizedConvParams& params) {
+    const PrimitiveKey key = params.GetKey();
+    QuantizedConvPrimitive* primitive = dynamic_cast<QuantizedConvPrimitive*>(GetInstance().GetPrimitive(key));
+    if (primitive == nullptr) {
+      auto conv_primitive = std::make_unique<QuantizedConvPrimitive>(params);
+      primitive = conv_primitive.get();
+      GetInstance().SetPrimitive(key, std::move(conv_primitive));
+    }
+    return primitive;
+  }
+
+ private:
+  QuantizedConvPrimitivePool() : PrimitivePool<uint8_t>("QuantizedConv") {}
+  ~QuantizedConvPrimitivePool() = default;
+
+  static QuantizedConvPrimitivePool& GetInstance() {
+    static QuantizedConvPrimitivePool pool;
+    return pool;
+  }
+};
+
+// Gets the zero point of a quantized input, which is a scalar.
+Status GetZeroPoint(const Tensor* zero_point, uint8_t& value) {
+  ORT_RETURN_IF_NOT(zero_point->Shape().Size() == 1, "Non per-tensor quantization is not supported now.");
+  value = *zero_point->template Data<uint8_t>();
+  return Status::OK();
+}
+
+Status GetScale(const Tensor* scale, float& value) {
+  ORT_RETURN_IF_NOT(scale->Shape().Size() == 1, "scale must be a scalar");
+  value = *scale->template Data<float>();
+  return Status::OK();
+}
+}  // namespace
+
+template <typename ConvKernel>
+std::shared_ptr<const QuantizedConvWeights> QuantizedConv<ConvKernel>::GetWeights(const Tensor* W,
+                                                                                  uint8_t zero_point) const {
+  std::unique_lock<OrtMutex> lock(weights_mutex_, std::defer_lock);
+  if (weights_are_constant_) {
+    lock.lock();
+    if (weights_ != nullptr && weights_->zero_point == zero_point) {
+      return weights_;
+    }
+  }
+
+  auto weights = std::make_shared<QuantizedConvWeights>();
+  weights->zero_point = zero_point;
+  weights->supported = true;
+  const int64_t M = W->Shape()[0];
+  const int64_t channel_size = W->Shape().SizeFromDimension(1);
+  const uint8_t* W_data = W->template Data<uint8_t>();
+  weights->data.resize(static_cast<size_t>(M * channel_size));
+  weights->sums.resize(static_cast<size_t>(M));
+  for (int64_t m = 0; m < M; m++) {
+    int32_t sum = 0;
+    for (int64_t i = 0; i < channel_size; i++) {
+      const int32_t value = static_cast<int32_t>(W_data[m * channel_size + i]) - zero_point;
+      if (value < -128 || value > 127) {
+        weights->supported = false;
+      }
+      weights->data[static_cast<size_t>(m * channel_size + i)] = static_cast<int8_t>(value);
+      sum += value;
+    }
+    weights->sums[static_cast<size_t>(m)] = sum;
+  }
+
+  if (weights_are_constant_) {
+    weights_ = weights;
+  }
+  return weights;
+}
+
+template <typename ConvKernel>
+Status QuantizedConv<ConvKernel>::ComputeInt8(OpKernelContext* context, const Tensor* X, const Tensor* W,
+                                              uint8_t input_zero_point, uint8_t filter_zero_point, const Tensor* B,
+                                              bool quantize_output, float output_scale, uint8_t output_zero_point,
+                                              bool& computed) const {
+  computed = false;
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
+  const int64_t M = W->Shape()[0];
+  ORT_RETURN_IF_ERROR(this->ValidateInputShape(X, W));
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(this->ComputeKernelShape(W->Shape(), kernel_shape));
+  if (kernel_shape.size() != 2) {
+    return Status::OK();
+  }
+  std::shared_ptr<const QuantizedConvWeights> weights = GetWeights(W, filter_zero_point);
+  if (!weights->supported) {
+    return Status::OK();
+  }
+
+  std::vector<int64_t> pads(this->pads_);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  std::vector<int64_t> dilations(this->dilations_);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  std::vector<int64_t> strides(this->strides_);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  std::vector<int64_t> Y_dims;
+  Y_dims.insert(Y_dims.begin(), {N, M});
+  TensorShape input_shape = X->Shape().Slice(2);
+  ORT_RETURN_IF_ERROR(this->InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  computed = true;
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // MKLDNN pads the input with zeros, so an input with a zero point is padded with it here.
+  const uint8_t* src_data = X->template Data<uint8_t>();
+  mkldnn::memory::dims src_dims_mkl(X->Shape().GetDims().begin(), X->Shape().GetDims().end());
+  IAllocatorUniquePtr<uint8_t> padded_src_buffer;
+  if (input_zero_point != 0 && std::any_of(pads.begin(), pads.end(), [](int64_t pad) { return pad != 0; })) {
+    const int64_t input_height = input_shape[0];
+    const int64_t input_width = input_shape[1];
+    const int64_t padded_height = input_height + pads[0] + pads[2];
+    const int64_t padded_width = input_width + pads[1] + pads[3];
+    padded_src_buffer = IAllocator::MakeUniquePtr<uint8_t>(alloc, static_cast<size_t>(N * C * padded_height * padded_width));
+    uint8_t* padded = padded_src_buffer.get();
+    std::fill_n(padded, N * C * padded_height * padded_width, input_zero_point);
+    for (int64_t image = 0; image < N * C; image++) {
+      for (int64_t h = 0; h < input_height; h++) {
+        std::copy_n(src_data + (image * input_height + h) * input_width, input_width,
+                    padded + (image * padded_height + h + pads[0]) * padded_width + pads[1]);
+      }
+    }
+    src_data = padded;
+    src_dims_mkl[2] = static_cast<int>(padded_height);
+    src_dims_mkl[3] = static_cast<int>(padded_width);
+    std::fill(pads.begin(), pads.end(), 0);
+  }
+
+  // The input zero point times the sum of the weights is subtracted by the bias, which also adds the output zero
+  // point divided by the scale as the bias is added before the scale is applied.
+  const bool has_bias = quantize_output || B != nullptr || input_zero_point != 0;
+  IAllocatorUniquePtr<void> bias_buffer;
+  if (has_bias) {
+    const int32_t* B_data = B != nullptr ? B->template Data<int32_t>() : nullptr;
+    if (quantize_output) {
+      bias_buffer = IAllocator::MakeUniquePtr<void>(alloc, sizeof(float) * M);
+      float* bias = static_cast<float*>(bias_buffer.get());
+      const float output_offset = static_cast<float>(output_zero_point) / output_scale;
+      for (int64_t m = 0; m < M; m++) {
+        const int32_t sum = (B_data != nullptr ? B_data[m] : 0) - input_zero_point * weights->sums[m];
+        bias[m] = static_cast<float>(sum) + output_offset;
+      }
+    } else {
+      bias_buffer = IAllocator::MakeUniquePtr<void>(alloc, sizeof(int32_t) * M);
+      int32_t* bias = static_cast<int32_t*>(bias_buffer.get());
+      for (int64_t m = 0; m < M; m++) {
+        bias[m] = (B_data != nullptr ? B_data[m] : 0) - input_zero_point * weights->sums[m];
+      }
+    }
+  }
+
+  const int group_mkl = static_cast<int>(this->group_);
+  mkldnn::memory::dims filter_dims_mkl;
+  if (group_mkl == 1) {
+    filter_dims_mkl.assign(W->Shape().GetDims().begin(), W->Shape().GetDims().end());
+  } else {
+    filter_dims_mkl.assign({group_mkl, static_cast<int>(M / group_mkl)});
+    filter_dims_mkl.insert(filter_dims_mkl.end(), W->Shape().GetDims().begin() + 1, W->Shape().GetDims().end());
+  }
+  mkldnn::memory::dims strides_mkl(strides.begin(), strides.end());
+  mkldnn::memory::dims dilations_mkl(dilations.begin(), dilations.end());
+  // mkldnn dilations start from 0 so we need to subtract 1 from each dim.
+  for (auto& dilation : dilations_mkl) {
+    dilation -= 1;
+  }
+  mkldnn::memory::dims padding_left_mkl(pads.begin(), pads.begin() + 2);
+  mkldnn::memory::dims padding_right_mkl(pads.begin() + 2, pads.end());
+  mkldnn::memory::dims dst_dims_mkl(Y_dims.begin(), Y_dims.end());
+
+  const auto dst_type = quantize_output ? MklDnnType<uint8_t>() : MklDnnType<int32_t>();
+  IAllocatorUniquePtr<void> src_reorder_buffer;
+  IAllocatorUniquePtr<void> filter_reorder_buffer;
+  IAllocatorUniquePtr<void> dst_reorder_buffer;
+
+  try {
+    QuantizedConvParams conv_params(src_dims_mkl, filter_dims_mkl, dst_dims_mkl, strides_mkl, dilations_mkl,
+                                    padding_left_mkl, padding_right_mkl, has_bias, quantize_output, output_scale);
+    QuantizedConvPrimitive* conv_primitive = QuantizedConvPrimitivePool::Get(conv_params);
+    auto conv_fwd_pd = conv_primitive->GetPrimitiveDesc();
+    mkldnn::engine& cpu_engine = GetEngine();
+
+    // Reorder src memory layout if necessary.
+    const void* src = src_data;
+    auto src_pd = mkldnn::memory::primitive_desc(
+        mkldnn::memory::desc(src_dims_mkl, MklDnnType<uint8_t>(), mkldnn::memory::format::nchw), cpu_engine);
+    if (src_pd != conv_fwd_pd->src_primitive_desc()) {
+      src_reorder_buffer = IAllocator::MakeUniquePtr<void>(alloc, conv_fwd_pd->src_primitive_desc().get_size());
+      mkldnn::memory user_src(src_pd, const_cast<uint8_t*>(src_data));
+      mkldnn::memory reordered_src(conv_fwd_pd->src_primitive_desc(), src_reorder_buffer.get());
+      DoReorder<uint8_t>(MemoryReorderParams(user_src, reordered_src));
+      src = src_reorder_buffer.get();
+    }
+
+    // Reorder filter memory layout if necessary.
+    const void* filter = weights->data.data();
+    auto filter_pd = mkldnn::memory::primitive_desc(
+        mkldnn::memory::desc(filter_dims_mkl, MklDnnType<int8_t>(),
+                             group_mkl == 1 ? mkldnn::memory::format::oihw : mkldnn::memory::format::goihw),
+        cpu_engine);
+    if (filter_pd != conv_fwd_pd->weights_primitive_desc()) {
+      filter_reorder_buffer =
+          IAllocator::MakeUniquePtr<void>(alloc, conv_fwd_pd->weights_primitive_desc().get_size());
+      mkldnn::memory user_filter(filter_pd, const_cast<int8_t*>(weights->data.data()));
+      mkldnn::memory reordered_filter(conv_fwd_pd->weights_primitive_desc(), filter_reorder_buffer.get());
+      DoReorder<uint8_t>(MemoryReorderParams(user_filter, reordered_filter));
+      filter = filter_reorder_buffer.get();
+    }
+
+    // Allocate dst buffer if reorder is necessary.
+    void* dst = Y->MutableDataRaw();
+    auto dst_pd = mkldnn::memory::primitive_desc(
+        mkldnn::memory::desc(dst_dims_mkl, dst_type, mkldnn::memory::format::nchw), cpu_engine);
+    if (dst_pd != conv_fwd_pd->dst_primitive_desc()) {
+      dst_reorder_buffer = IAllocator::MakeUniquePtr<void>(alloc, conv_fwd_pd->dst_primitive_desc().get_size());
+      dst = dst_reorder_buffer.get();
+    }
+
+    conv_primitive->Compute(src, filter, bias_buffer.get(), dst);
+
+    // Reorder dst memory layout if necessary.
+    if (dst != Y->MutableDataRaw()) {
+      mkldnn::memory conv_dst(conv_fwd_pd->dst_primitive_desc(), dst);
+      mkldnn::memory user_dst(dst_pd, Y->MutableDataRaw());
+      DoReorder<uint8_t>(MemoryReorderParams(conv_dst, user_dst));
+    }
+  } catch (const mkldnn::error& e) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Status: ", e.status, ", message: ", e.message.c_str());
+  }
+
+  return Status::OK();
+}
+
+Status ConvInteger::Compute(OpKernelContext* context) const {
+  const size_t num_inputs = OpKernel::Node().InputDefs().size();
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  uint8_t input_zero_point = 0;
+  uint8_t filter_zero_point = 0;
+  if (num_inputs >= 3) {
+    ORT_RETURN_IF_ERROR(GetZeroPoint(context->Input<Tensor>(2), input_zero_point));
+  }
+  if (num_inputs >= 4) {
+    ORT_RETURN_IF_ERROR(GetZeroPoint(context->Input<Tensor>(3), filter_zero_point));
+  }
+
+  bool computed = false;
+  ORT_RETURN_IF_ERROR(ComputeInt8(context, X, W, input_zero_point, filter_zero_point, nullptr, false, 1.0f, 0,
+                                  computed));
+  if (!computed) {
+    // Fall Back to CPU implementation.
+    return onnxruntime::contrib::ConvInteger::Compute(context);
+  }
+  return Status::OK();
+}
+
+Status QLinearConv::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(3);
+  float input_scale, filter_scale, output_scale;
+  uint8_t input_zero_point, filter_zero_point, output_zero_point;
+  ORT_RETURN_IF_ERROR(GetScale(context->Input<Tensor>(1), input_scale));
+  ORT_RETURN_IF_ERROR(GetZeroPoint(context->Input<Tensor>(2), input_zero_point));
+  ORT_RETURN_IF_ERROR(GetScale(context->Input<Tensor>(4), filter_scale));
+  ORT_RETURN_IF_ERROR(GetZeroPoint(context->Input<Tensor>(5), filter_zero_point));
+  ORT_RETURN_IF_ERROR(GetScale(context->Input<Tensor>(6), output_scale));
+  ORT_RETURN_IF_ERROR(GetZeroPoint(context->Input<Tensor>(7), output_zero_point));
+  const Tensor* B = OpKernel::Node().InputDefs().size() == 9 ? context->Input<Tensor>(8) : nullptr;
+
+  bool computed = false;
+  ORT_RETURN_IF_ERROR(ComputeInt8(context, X, W, input_zero_point, filter_zero_point, B, true,
+                                  input_scale * filter_scale / output_scale, output_zero_point, computed));
+  if (!computed) {
+    // Fall Back to CPU implementation.
+    return onnxruntime::contrib::QLinearConv::Compute(context);
+  }
+  return Status::OK();
+}
+
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
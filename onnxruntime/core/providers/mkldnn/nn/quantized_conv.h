@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cpu/nn/conv_integer.h"
+#include "core/providers/cpu/nn/qlinearconv.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+// The weights of a quantized convolution as the signed 8-bit integers MKLDNN multiplies, which are the weights less
+// their zero point, and the sum of the weights of each output channel.
+struct QuantizedConvWeights {
+  std::vector<int8_t> data;
+  std::vector<int32_t> sums;
+  uint8_t zero_point;
+  // false if a weight less the zero point doesn't fit in int8
+  bool supported;
+};
+
+// Runs a 2D quantized convolution by an MKLDNN int8 convolution, which multiplies the uint8 input by int8 weights.
+// The input zero point is applied by padding the input with it and by the bias, and the output zero point by the
+// bias, as MKLDNN has no zero points.
+template <typename ConvKernel>
+class QuantizedConv : public ConvKernel {
+ public:
+  QuantizedConv(const OpKernelInfo& info, int weights_index) : ConvKernel(info) {
+    const Tensor* W = nullptr;
+    weights_are_constant_ = info.TryGetConstantInput(weights_index, &W);
+  }
+
+ protected:
+  // Computes Y as the int32 sums of the products, or as those sums scaled and quantized to uint8. Sets computed to
+  // false, for the kernel to fall back to the CPU implementation, if the convolution isn't 2D or a weight less its
+  // zero point doesn't fit in int8.
+  Status ComputeInt8(OpKernelContext* context, const Tensor* X, const Tensor* W, uint8_t input_zero_point,
+                     uint8_t filter_zero_point, const Tensor* B, bool quantize_output, float output_scale,
+                     uint8_t output_zero_point, bool& computed) const;
+
+ private:
+  std::shared_ptr<const QuantizedConvWeights> GetWeights(const Tensor* W, uint8_t zero_point) const;
+
+  bool weights_are_constant_;
+  // the weights converted once if they're an initializer
+  mutable OrtMutex weights_mutex_;
+  mutable std::shared_ptr<const QuantizedConvWeights> weights_;
+};
+
+class ConvInteger final : public QuantizedConv<onnxruntime::contrib::ConvInteger> {
+ public:
+  explicit ConvInteger(const OpKernelInfo& info) : QuantizedConv<onnxruntime::contrib::ConvInteger>(info, 1) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class QLinearConv final : public QuantizedConv<onnxruntime::contrib::QLinearConv> {
+ public:
+  explicit QLinearConv(const OpKernelInfo& info) : QuantizedConv<onnxruntime::contrib::QLinearConv>(info, 3) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+// A node of a subgraph compiled to a chain of MKL-DNN primitives.
+struct MklDnnNode {
+  std::string op_type;
+  NodeAttributes attributes;
+  // the names of the inputs, of which the first is the image the node computes on and the others are initializers,
+  // but for an Add or a Sum of two images
+  std::vector<std::string> inputs;
+  std::string output;
+};
+
+// Connected nodes the MKL-DNN execution provider runs as one fused node, so that the values passed between them
+// stay in the layouts the MKL-DNN primitives choose and are only reordered from and to NCHW at the boundaries.
+struct MklDnnSubgraph {
+  // the nodes in topological order
+  std::vector<MklDnnNode> nodes;
+  // the names of the inputs and the outputs of the fused node, in order
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+  // unique over the process so that the primitives built for the subgraph are cached by it
+  int id;
+};
+
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
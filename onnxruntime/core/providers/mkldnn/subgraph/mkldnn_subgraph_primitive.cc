@@ -0,0 +1,571 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifdef _WIN32
+#pragma warning(disable : 4244)
+#endif
+
+#include "core/providers/mkldnn/subgraph/mkldnn_subgraph_primitive.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/providers/mkldnn/mkldnn_common.h"
+#include "core/providers/mkldnn/memcpy_s.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+namespace {
+
+int64_t GetIntAttribute(const NodeAttributes& attributes, const std::string& name, int64_t default_value) {
+  auto it = attributes.find(name);
+  return it != attributes.end() ? it->second.i() : default_value;
+}
+
+std::string GetStringAttribute(const NodeAttributes& attributes, const std::string& name,
+                               const std::string& default_value) {
+  auto it = attributes.find(name);
+  return it != attributes.end() ? it->second.s() : default_value;
+}
+
+float GetFloatAttribute(const NodeAttributes& attributes, const std::string& name, float default_value) {
+  auto it = attributes.find(name);
+  return it != attributes.end() ? it->second.f() : default_value;
+}
+
+mkldnn::memory::dims GetIntsAttribute(const NodeAttributes& attributes, const std::string& name, size_t size,
+                                      int default_value) {
+  auto it = attributes.find(name);
+  if (it == attributes.end() || it->second.ints_size() == 0) {
+    return mkldnn::memory::dims(size, default_value);
+  }
+  return mkldnn::memory::dims(it->second.ints().begin(), it->second.ints().end());
+}
+
+// The primitives of a subgraph for the shapes of its inputs. Each value computed in the subgraph has the layout its
+// producer chose, and is only reordered for a consumer that chose another one. The inputs are reordered from NCHW
+// and the outputs to NCHW.
+class SubgraphPrimitive : public PrimitiveBase {
+ public:
+  SubgraphPrimitive(const MklDnnSubgraph& subgraph, const std::vector<mkldnn::memory::dims>& input_dims)
+      : cpu_engine_(GetEngine()) {
+    context_.stream.reset(new mkldnn::stream(mkldnn::stream::kind::eager));
+    Initialize(subgraph, input_dims);
+  }
+
+  ~SubgraphPrimitive() = default;
+
+  const std::vector<mkldnn::memory::dims>& GetOutputDims() const { return context_.output_dims; }
+
+  void Compute(const std::vector<void*>& inputs, const std::vector<void*>& outputs) {
+    for (auto& binding : context_.input_bindings) {
+      binding.memory->set_data_handle(inputs[binding.index]);
+    }
+    for (auto& binding : context_.output_bindings) {
+      binding.memory->set_data_handle(outputs[binding.index]);
+    }
+
+    // The weights are initializers, so they're reordered into the layouts of the primitives by the first run only.
+    if (!context_.weights_prepared) {
+      for (const auto& scale_shift : context_.scale_shifts) {
+        float* scale_shift_buf = static_cast<float*>(scale_shift.memory->get_data_handle());
+        size_t bytes = sizeof(float) * scale_shift.channels;
+        MEMCPY_S(scale_shift_buf, inputs[scale_shift.scale_index], bytes, bytes);
+        MEMCPY_S(&scale_shift_buf[scale_shift.channels], inputs[scale_shift.bias_index], bytes, bytes);
+      }
+      if (!context_.weights_net.empty()) {
+        mkldnn::stream(mkldnn::stream::kind::eager).submit(context_.weights_net).wait();
+      }
+      context_.weights_prepared = true;
+    }
+
+    context_.stream->submit(context_.net).wait();
+
+    for (auto& binding : context_.input_bindings) {
+      binding.memory->set_data_handle(nullptr);
+    }
+    for (auto& binding : context_.output_bindings) {
+      binding.memory->set_data_handle(nullptr);
+    }
+  }
+
+ private:
+  // A memory whose data is an input or an output of the fused node.
+  struct Binding {
+    std::shared_ptr<mkldnn::memory> memory;
+    size_t index;
+  };
+
+  // The scale and shift of a batch normalization, which are copied from two inputs.
+  struct ScaleShift {
+    std::shared_ptr<mkldnn::memory> memory;
+    size_t scale_index;
+    size_t bias_index;
+    size_t channels;
+  };
+
+  // A value computed in the subgraph.
+  struct Value {
+    std::shared_ptr<mkldnn::memory> memory;
+    mkldnn::memory::dims dims;
+  };
+
+  struct SubgraphContext {
+    std::unordered_map<std::string, Value> values;
+    std::vector<Binding> input_bindings;
+    std::vector<Binding> output_bindings;
+    std::vector<ScaleShift> scale_shifts;
+    std::vector<mkldnn::memory::dims> output_dims;
+
+    // keeps the memories in scope for the primitives
+    std::vector<std::shared_ptr<mkldnn::memory>> memories;
+
+    std::vector<mkldnn::primitive> weights_net;
+    bool weights_prepared = false;
+
+    std::unique_ptr<mkldnn::stream> stream;
+    std::vector<mkldnn::primitive> net;
+  };
+
+  std::shared_ptr<mkldnn::memory> NewMemory(const mkldnn::memory::primitive_desc& pd) {
+    auto memory = std::make_shared<mkldnn::memory>(pd);
+    context_.memories.push_back(memory);
+    return memory;
+  }
+
+  // a memory of the data of input index, which is bound by every run
+  std::shared_ptr<mkldnn::memory> BindInput(size_t index, const mkldnn::memory::dims& dims,
+                                            mkldnn::memory::format format) {
+    auto memory = std::make_shared<mkldnn::memory>(
+        mkldnn::memory::primitive_desc(mkldnn::memory::desc(dims, MklDnnType<float>(), format), cpu_engine_),
+        nullptr);
+    context_.input_bindings.push_back({memory, index});
+    return memory;
+  }
+
+  // the value in the layout the primitive desc requires, reordered if it's in another one
+  std::shared_ptr<mkldnn::memory> GetSource(const Value& value, const mkldnn::memory::primitive_desc& pd) {
+    if (value.memory->get_primitive_desc() == pd) {
+      return value.memory;
+    }
+    auto reordered = NewMemory(pd);
+    context_.net.push_back(mkldnn::reorder(*value.memory, *reordered));
+    return reordered;
+  }
+
+  // the destination of a primitive, which is allocated unless it's an output of the subgraph in NCHW
+  std::shared_ptr<mkldnn::memory> NewDestination(const std::string& name, const mkldnn::memory::dims& dims,
+                                                 const mkldnn::memory::primitive_desc& pd) {
+    std::shared_ptr<mkldnn::memory> memory;
+    auto nchw_pd = mkldnn::memory::primitive_desc(
+        mkldnn::memory::desc(dims, MklDnnType<float>(), mkldnn::memory::format::nchw), cpu_engine_);
+    auto output = output_indices_.find(name);
+    if (output != output_indices_.end() && pd == nchw_pd) {
+      memory = std::make_shared<mkldnn::memory>(pd, nullptr);
+      context_.output_bindings.push_back({memory, output->second});
+      bound_outputs_.insert(output->second);
+    } else {
+      memory = NewMemory(pd);
+    }
+    context_.values[name] = Value{memory, dims};
+    return memory;
+  }
+
+  // A convolution, adding sum_src to its output if it's not null and then applying the activation if it's not
+  // algorithm_undef, as post-ops of the primitive.
+  void AddConv(const MklDnnNode& node, const Value& src, const std::string& dst_name, const Value* sum_src,
+               mkldnn::algorithm activation, float alpha) {
+    const mkldnn::memory::dims& filter_dims = input_dims_.at(node.inputs[1]);
+    ORT_ENFORCE(filter_dims.size() == 4 && src.dims[1] % filter_dims[1] == 0, "Invalid Conv weights.");
+    const int group = static_cast<int>(GetIntAttribute(node.attributes, "group", 1));
+    mkldnn::memory::dims strides = GetIntsAttribute(node.attributes, "strides", 2, 1);
+    mkldnn::memory::dims dilations = GetIntsAttribute(node.attributes, "dilations", 2, 1);
+    mkldnn::memory::dims pads = GetIntsAttribute(node.attributes, "pads", 4, 0);
+
+    mkldnn::memory::dims dst_dims{src.dims[0], filter_dims[0]};
+    for (size_t i = 0; i < 2; i++) {
+      const int kernel_extent = (filter_dims[i + 2] - 1) * dilations[i] + 1;
+      dst_dims.push_back((src.dims[i + 2] + pads[i] + pads[i + 2] - kernel_extent) / strides[i] + 1);
+      // mkldnn dilations start from 0
+      dilations[i] -= 1;
+    }
+    mkldnn::memory::dims padding_left(pads.begin(), pads.begin() + 2);
+    mkldnn::memory::dims padding_right(pads.begin() + 2, pads.end());
+
+    mkldnn::memory::dims filter_dims_mkl = filter_dims;
+    if (group != 1) {
+      filter_dims_mkl = {group, filter_dims[0] / group};
+      filter_dims_mkl.insert(filter_dims_mkl.end(), filter_dims.begin() + 1, filter_dims.end());
+    }
+    const bool has_bias = node.inputs.size() > 2 && !node.inputs[2].empty();
+
+    // Let MKLDNN decide the layouts of the convolution.
+    auto src_md = mkldnn::memory::desc(src.dims, MklDnnType<float>(), mkldnn::memory::format::any);
+    auto filter_md = mkldnn::memory::desc(filter_dims_mkl, MklDnnType<float>(), mkldnn::memory::format::any);
+    auto bias_md = mkldnn::memory::desc({filter_dims[0]}, MklDnnType<float>(), mkldnn::memory::format::any);
+    auto dst_md = mkldnn::memory::desc(dst_dims, MklDnnType<float>(), mkldnn::memory::format::any);
+    std::unique_ptr<mkldnn::convolution_forward::desc> fwd_desc;
+    if (has_bias) {
+      fwd_desc.reset(new mkldnn::convolution_forward::desc(
+          mkldnn::prop_kind::forward_inference, mkldnn::convolution_direct, src_md, filter_md, bias_md, dst_md,
+          strides, dilations, padding_left, padding_right, mkldnn::padding_kind::zero));
+    } else {
+      fwd_desc.reset(new mkldnn::convolution_forward::desc(
+          mkldnn::prop_kind::forward_inference, mkldnn::convolution_direct, src_md, filter_md, dst_md,
+          strides, dilations, padding_left, padding_right, mkldnn::padding_kind::zero));
+    }
+
+    mkldnn::primitive_attr attr;
+    mkldnn::post_ops ops;
+    if (sum_src != nullptr) {
+      ORT_ENFORCE(sum_src->dims == dst_dims, "The value added to the Conv output has another shape.");
+      ops.append_sum(1.0f);
+    }
+    if (activation != mkldnn::algorithm::algorithm_undef) {
+      ops.append_eltwise(1.0f, activation, alpha, 0.0f);
+    }
+    attr.set_post_ops(ops);
+    auto conv_fwd_pd = mkldnn::convolution_forward::primitive_desc(*fwd_desc, attr, cpu_engine_);
+
+    auto src_mem = GetSource(src, conv_fwd_pd.src_primitive_desc());
+
+    auto filter_mem = NewMemory(conv_fwd_pd.weights_primitive_desc());
+    auto user_filter_mem = BindInput(input_indices_.at(node.inputs[1]), filter_dims_mkl,
+                                     group == 1 ? mkldnn::memory::format::oihw : mkldnn::memory::format::goihw);
+    context_.weights_net.push_back(mkldnn::reorder(*user_filter_mem, *filter_mem));
+
+    auto dst_mem = NewDestination(dst_name, dst_dims, conv_fwd_pd.dst_primitive_desc());
+    if (sum_src != nullptr) {
+      // the sum post-op adds the convolution to what the destination holds
+      context_.net.push_back(mkldnn::reorder(*sum_src->memory, *dst_mem));
+    }
+    if (has_bias) {
+      auto bias_mem = std::make_shared<mkldnn::memory>(conv_fwd_pd.bias_primitive_desc(), nullptr);
+      context_.input_bindings.push_back({bias_mem, input_indices_.at(node.inputs[2])});
+      context_.net.push_back(mkldnn::convolution_forward(conv_fwd_pd, *src_mem, *filter_mem, *bias_mem, *dst_mem));
+    } else {
+      context_.net.push_back(mkldnn::convolution_forward(conv_fwd_pd, *src_mem, *filter_mem, *dst_mem));
+    }
+  }
+
+  void AddRelu(const MklDnnNode& node, const Value& src) {
+    auto fwd_desc = mkldnn::eltwise_forward::desc(mkldnn::prop_kind::forward_inference,
+                                                  mkldnn::algorithm::eltwise_relu,
+                                                  src.memory->get_primitive_desc().desc(), 0.0f, 0.0f);
+    auto relu_fwd_pd = mkldnn::eltwise_forward::primitive_desc(fwd_desc, cpu_engine_);
+    auto dst_mem = NewDestination(node.output, src.dims, relu_fwd_pd.dst_primitive_desc());
+    context_.net.push_back(mkldnn::eltwise_forward(relu_fwd_pd, *src.memory, *dst_mem));
+  }
+
+  void AddSum(const MklDnnNode& node, const Value& a, const Value& b) {
+    ORT_ENFORCE(a.dims == b.dims, "The MKLDNN subgraph adds values of the same shape only.");
+    const auto& a_pd = a.memory->get_primitive_desc();
+    auto b_mem = GetSource(b, a_pd);
+    auto sum_pd = mkldnn::sum::primitive_desc(a_pd.desc(), std::vector<float>{1.0f, 1.0f},
+                                              std::vector<mkldnn::memory::primitive_desc>{a_pd, a_pd});
+    auto dst_mem = NewDestination(node.output, a.dims, sum_pd.dst_primitive_desc());
+    std::vector<mkldnn::primitive::at> inputs{*a.memory, *b_mem};
+    context_.net.push_back(mkldnn::sum(sum_pd, inputs, *dst_mem));
+  }
+
+  void AddBatchNorm(const MklDnnNode& node, const Value& src) {
+    const mkldnn::memory::dims channel_dims{src.dims[1]};
+    const float epsilon = GetFloatAttribute(node.attributes, "epsilon", 1e-5f);
+    auto fwd_desc = mkldnn::batch_normalization_forward::desc(
+        mkldnn::prop_kind::forward_inference, src.memory->get_primitive_desc().desc(), epsilon,
+        mkldnn::batch_normalization_flag::use_scale_shift | mkldnn::batch_normalization_flag::use_global_stats);
+    auto batchnorm_fwd_pd = mkldnn::batch_normalization_forward::primitive_desc(fwd_desc, cpu_engine_);
+
+    // scale_shift_mem holds the 2*C values of the scale followed by the bias
+    auto scale_shift_mem = NewMemory(mkldnn::memory::primitive_desc(
+        mkldnn::memory::desc({2, src.dims[1]}, MklDnnType<float>(), mkldnn::memory::format::nc), cpu_engine_));
+    context_.scale_shifts.push_back({scale_shift_mem, input_indices_.at(node.inputs[1]),
+                                     input_indices_.at(node.inputs[2]), static_cast<size_t>(src.dims[1])});
+    auto mean_mem = BindInput(input_indices_.at(node.inputs[3]), channel_dims, mkldnn::memory::format::x);
+    auto var_mem = BindInput(input_indices_.at(node.inputs[4]), channel_dims, mkldnn::memory::format::x);
+
+    auto dst_mem = NewDestination(node.output, src.dims, batchnorm_fwd_pd.dst_primitive_desc());
+    context_.net.push_back(mkldnn::batch_normalization_forward(
+        batchnorm_fwd_pd,
+        (const mkldnn::primitive::at)*src.memory,
+        (const mkldnn::primitive::at)*mean_mem,
+        (const mkldnn::primitive::at)*var_mem,
+        (const mkldnn::memory)*scale_shift_mem,
+        (const mkldnn::memory)*dst_mem));
+  }
+
+  void AddPool(const MklDnnNode& node, const Value& src) {
+    const bool global_pooling = node.op_type == "GlobalAveragePool" || node.op_type == "GlobalMaxPool";
+    const bool max_pooling = node.op_type == "MaxPool" || node.op_type == "GlobalMaxPool";
+    mkldnn::memory::dims kernel;
+    mkldnn::memory::dims strides(2, 1);
+    mkldnn::memory::dims pads(4, 0);
+    if (global_pooling) {
+      kernel.assign(src.dims.begin() + 2, src.dims.end());
+    } else {
+      kernel = GetIntsAttribute(node.attributes, "kernel_shape", 2, 1);
+      strides = GetIntsAttribute(node.attributes, "strides", 2, 1);
+      pads = GetIntsAttribute(node.attributes, "pads", 4, 0);
+    }
+
+    mkldnn::memory::dims dst_dims{src.dims[0], src.dims[1]};
+    for (size_t i = 0; i < 2; i++) {
+      dst_dims.push_back((src.dims[i + 2] + pads[i] + pads[i + 2] - kernel[i]) / strides[i] + 1);
+    }
+    mkldnn::memory::dims padding_left(pads.begin(), pads.begin() + 2);
+    mkldnn::memory::dims padding_right(pads.begin() + 2, pads.end());
+
+    mkldnn::algorithm algo = mkldnn::algorithm::pooling_max;
+    if (!max_pooling) {
+      algo = GetIntAttribute(node.attributes, "count_include_pad", 0) != 0
+                 ? mkldnn::algorithm::pooling_avg_include_padding
+                 : mkldnn::algorithm::pooling_avg_exclude_padding;
+    }
+    auto dst_md = mkldnn::memory::desc(dst_dims, MklDnnType<float>(), mkldnn::memory::format::any);
+    auto fwd_desc = mkldnn::pooling_forward::desc(mkldnn::prop_kind::forward_inference, algo,
+                                                  src.memory->get_primitive_desc().desc(), dst_md,
+                                                  strides, kernel, padding_left, padding_right,
+                                                  mkldnn::padding_kind::zero);
+    auto pool_fwd_pd = mkldnn::pooling_forward::primitive_desc(fwd_desc, cpu_engine_);
+    auto src_mem = GetSource(src, pool_fwd_pd.src_primitive_desc());
+    auto dst_mem = NewDestination(node.output, dst_dims, pool_fwd_pd.dst_primitive_desc());
+    context_.net.push_back(mkldnn::pooling_forward(pool_fwd_pd, *src_mem, *dst_mem));
+  }
+
+  void AddLRN(const MklDnnNode& node, const Value& src) {
+    const int size = static_cast<int>(GetIntAttribute(node.attributes, "size", 1));
+    const float alpha = GetFloatAttribute(node.attributes, "alpha", 0.0001f);
+    const float beta = GetFloatAttribute(node.attributes, "beta", 0.75f);
+    const float bias = GetFloatAttribute(node.attributes, "bias", 1.0f);
+    auto fwd_desc = mkldnn::lrn_forward::desc(mkldnn::prop_kind::forward_scoring,
+                                              mkldnn::algorithm::lrn_across_channels,
+                                              src.memory->get_primitive_desc().desc(), size, alpha, beta, bias);
+    auto lrn_fwd_pd = mkldnn::lrn_forward::primitive_desc(fwd_desc, cpu_engine_);
+    auto src_mem = GetSource(src, lrn_fwd_pd.src_primitive_desc());
+    auto dst_mem = NewDestination(node.output, src.dims, lrn_fwd_pd.dst_primitive_desc());
+    context_.net.push_back(mkldnn::lrn_forward(lrn_fwd_pd, *src_mem, *dst_mem));
+  }
+
+  void Initialize(const MklDnnSubgraph& subgraph, const std::vector<mkldnn::memory::dims>& input_dims) {
+    for (size_t i = 0; i < subgraph.inputs.size(); i++) {
+      input_indices_[subgraph.inputs[i]] = i;
+      input_dims_[subgraph.inputs[i]] = input_dims[i];
+    }
+    for (size_t i = 0; i < subgraph.outputs.size(); i++) {
+      output_indices_[subgraph.outputs[i]] = i;
+    }
+
+    // The number of inputs of nodes each value is, to find the values only one node consumes.
+    std::unordered_map<std::string, int> num_consumers;
+    std::unordered_map<std::string, size_t> producers;
+    for (size_t n = 0; n < subgraph.nodes.size(); n++) {
+      for (const auto& input : subgraph.nodes[n].inputs) {
+        ++num_consumers[input];
+      }
+      producers[subgraph.nodes[n].output] = n;
+    }
+    auto is_only_consumed_by = [&](const std::string& value, const MklDnnNode* consumer) {
+      return consumer != nullptr && num_consumers[value] == 1 && output_indices_.count(value) == 0 &&
+             std::find(consumer->inputs.begin(), consumer->inputs.end(), value) != consumer->inputs.end();
+    };
+
+    // The convolutions computed by the Add consuming their output, which they're fused with.
+    std::unordered_set<std::string> deferred_convs;
+    std::unordered_set<std::string> fused_relus;
+    for (size_t n = 0; n < subgraph.nodes.size(); n++) {
+      const MklDnnNode& node = subgraph.nodes[n];
+      const MklDnnNode* next = n + 1 < subgraph.nodes.size() ? &subgraph.nodes[n + 1] : nullptr;
+      const bool fuse_relu = next != nullptr && next->op_type == "Relu" && is_only_consumed_by(node.output, next);
+
+      if (node.op_type == "Conv" || node.op_type == "FusedConv") {
+        mkldnn::algorithm activation = mkldnn::algorithm::algorithm_undef;
+        float alpha = 0.0f;
+        if (node.op_type == "FusedConv") {
+          const std::string activation_name = GetStringAttribute(node.attributes, "activation", "");
+          ORT_ENFORCE(GetEltwiseAlgorithm(activation_name, activation) || activation_name.empty(),
+                      "The MKLDNN subgraph doesn't support the activation ", activation_name);
+          if (activation_name == "LeakyRelu") {
+            alpha = GetFloatAttribute(node.attributes, "alpha", 0.01f);
+          }
+        }
+
+        // A convolution only an Add of another value consumes is computed by the Add, which adds that value to its
+        // output as it's written.
+        const MklDnnNode* consumer = nullptr;
+        for (size_t c = n + 1; c < subgraph.nodes.size() && consumer == nullptr; c++) {
+          if (std::find(subgraph.nodes[c].inputs.begin(), subgraph.nodes[c].inputs.end(), node.output) !=
+              subgraph.nodes[c].inputs.end()) {
+            consumer = &subgraph.nodes[c];
+          }
+        }
+        if (activation == mkldnn::algorithm::algorithm_undef && consumer != nullptr &&
+            (consumer->op_type == "Add" || consumer->op_type == "Sum") && is_only_consumed_by(node.output, consumer)) {
+          deferred_convs.insert(node.output);
+          continue;
+        }
+
+        // A Relu consuming only the convolution is applied to its output as it's written.
+        const bool relu_fused = activation == mkldnn::algorithm::algorithm_undef && fuse_relu;
+        if (relu_fused) {
+          activation = mkldnn::algorithm::eltwise_relu;
+          fused_relus.insert(next->output);
+        }
+        AddConv(node, GetValue(node.inputs[0]), relu_fused ? next->output : node.output, nullptr, activation, alpha);
+      } else if (node.op_type == "Add" || node.op_type == "Sum") {
+        std::string conv_output = node.inputs[0];
+        std::string other = node.inputs[1];
+        if (deferred_convs.count(conv_output) == 0) {
+          std::swap(conv_output, other);
+        }
+        if (deferred_convs.count(conv_output) == 0) {
+          AddSum(node, GetValue(node.inputs[0]), GetValue(node.inputs[1]));
+          continue;
+        }
+        if (deferred_convs.count(other) != 0) {
+          // both operands are convolutions, of which the first is computed on its own
+          const MklDnnNode& other_conv = subgraph.nodes[producers.at(other)];
+          AddConv(other_conv, GetValue(other_conv.inputs[0]), other, nullptr, mkldnn::algorithm::algorithm_undef,
+                  0.0f);
+          deferred_convs.erase(other);
+        }
+        const MklDnnNode& conv = subgraph.nodes[producers.at(conv_output)];
+        const Value sum_src = GetValue(other);
+        if (fuse_relu) {
+          fused_relus.insert(next->output);
+        }
+        AddConv(conv, GetValue(conv.inputs[0]), fuse_relu ? next->output : node.output, &sum_src,
+                fuse_relu ? mkldnn::algorithm::eltwise_relu : mkldnn::algorithm::algorithm_undef, 0.0f);
+      } else if (node.op_type == "Relu") {
+        if (fused_relus.count(node.output) == 0) {
+          AddRelu(node, GetValue(node.inputs[0]));
+        }
+      } else if (node.op_type == "BatchNormalization") {
+        AddBatchNorm(node, GetValue(node.inputs[0]));
+      } else if (node.op_type == "MaxPool" || node.op_type == "AveragePool" ||
+                 node.op_type == "GlobalMaxPool" || node.op_type == "GlobalAveragePool") {
+        AddPool(node, GetValue(node.inputs[0]));
+      } else if (node.op_type == "LRN") {
+        AddLRN(node, GetValue(node.inputs[0]));
+      } else {
+        ORT_THROW("The MKLDNN subgraph doesn't support ", node.op_type);
+      }
+    }
+
+    // The outputs that aren't written by their producers are reordered to NCHW once the subgraph has run.
+    for (size_t i = 0; i < subgraph.outputs.size(); i++) {
+      const Value& value = context_.values.at(subgraph.outputs[i]);
+      context_.output_dims.push_back(value.dims);
+      if (bound_outputs_.count(i) == 0) {
+        auto output_mem = std::make_shared<mkldnn::memory>(
+            mkldnn::memory::primitive_desc(
+                mkldnn::memory::desc(value.dims, MklDnnType<float>(), mkldnn::memory::format::nchw), cpu_engine_),
+            nullptr);
+        context_.output_bindings.push_back({output_mem, i});
+        context_.net.push_back(mkldnn::reorder(*value.memory, *output_mem));
+      }
+    }
+  }
+
+  // the value of the name, which is bound to the NCHW input of the subgraph if no node computes it
+  Value GetValue(const std::string& name) {
+    auto it = context_.values.find(name);
+    if (it != context_.values.end()) {
+      return it->second;
+    }
+    const auto& dims = input_dims_.at(name);
+    ORT_ENFORCE(dims.size() == 4, "The MKLDNN subgraph supports NCHW images only.");
+    Value value{BindInput(input_indices_.at(name), dims, mkldnn::memory::format::nchw), dims};
+    context_.values[name] = value;
+    return value;
+  }
+
+  SubgraphContext context_;
+  mkldnn::engine& cpu_engine_;
+
+  // used while the primitives are created
+  std::unordered_map<std::string, size_t> input_indices_;
+  std::unordered_map<std::string, mkldnn::memory::dims> input_dims_;
+  std::unordered_map<std::string, size_t> output_indices_;
+  std::unordered_set<size_t> bound_outputs_;
+};
+
+// Pool which allows for reuse of the MKLDNN primitives of a subgraph which are expensive to instantiate.
+// To address thread safety, the primitives are stored in a map on thread local storage.
+class SubgraphPrimitivePool : public PrimitivePool<float> {
+ public:
+  static SubgraphPrimitive* Get(const MklDnnSubgraph& subgraph, const std::vector<mkldnn::memory::dims>& input_dims) {
+    PrimitiveKey key;
+    key.Append(subgraph.id);
+    for (const auto& dims : input_dims) {
+      key.AppendDims(dims);
+    }
+
+    SubgraphPrimitive* primitive = dynamic_cast<SubgraphPrimitive*>(GetInstance().GetPrimitive(key));
+    if (primitive == nullptr) {
+      auto subgraph_primitive = std::make_unique<SubgraphPrimitive>(subgraph, input_dims);
+      primitive = subgraph_primitive.get();
+      GetInstance().SetPrimitive(key, std::move(subgraph_primitive));
+    }
+    return primitive;
+  }
+
+ private:
+  SubgraphPrimitivePool() : PrimitivePool<float>("MklDnnSubgraph") {}
+  ~SubgraphPrimitivePool() = default;
+
+  static SubgraphPrimitivePool& GetInstance() {
+    static SubgraphPrimitivePool pool;
+    return pool;
+  }
+};
+}  // namespace
+
+Status RunMklDnnSubgraph(const MklDnnSubgraph& subgraph,
+                         const ONNXRunTimeTensor* inputs, size_t num_inputs,
+                         ONNXRunTimeTensor* outputs, size_t num_outputs,
+                         AllocateFunc allocate_func, AllocatorHandle allocator) {
+  ORT_RETURN_IF_NOT(num_inputs == subgraph.inputs.size() && num_outputs == subgraph.outputs.size(),
+                    "The MKLDNN subgraph has ", subgraph.inputs.size(), " inputs and ", subgraph.outputs.size(),
+                    " outputs.");
+
+  std::vector<mkldnn::memory::dims> input_dims;
+  std::vector<void*> input_data;
+  for (size_t i = 0; i < num_inputs; i++) {
+    ORT_RETURN_IF_NOT(inputs[i].dtype == DType::TFloat32, "The MKLDNN subgraph supports float tensors only.");
+    input_dims.emplace_back(inputs[i].shape, inputs[i].shape + inputs[i].ndim);
+    input_data.push_back(inputs[i].data);
+  }
+
+  try {
+    SubgraphPrimitive* subgraph_primitive = SubgraphPrimitivePool::Get(subgraph, input_dims);
+
+    std::vector<void*> output_data;
+    const auto& output_dims = subgraph_primitive->GetOutputDims();
+    for (size_t i = 0; i < num_outputs; i++) {
+      const auto& dims = output_dims[i];
+      size_t size = 1;
+      outputs[i].dtype = DType::TFloat32;
+      outputs[i].ndim = dims.size();
+      outputs[i].shape = new int64_t[dims.size()];
+      for (size_t d = 0; d < dims.size(); d++) {
+        outputs[i].shape[d] = dims[d];
+        size *= static_cast<size_t>(dims[d]);
+      }
+      outputs[i].data = allocate_func(allocator, 64, size * sizeof(float));
+      output_data.push_back(outputs[i].data);
+    }
+
+    subgraph_primitive->Compute(input_data, output_data);
+  } catch (const mkldnn::error& e) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Status: ", e.status, ", message: ", e.message.c_str());
+  } catch (const std::exception& e) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, e.what());
+  }
+
+  return Status::OK();
+}
+
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/status.h"
+#include "core/framework/func_api.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_subgraph.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+// Runs the subgraph on the float inputs of the fused node. The outputs are allocated with allocate_func, and their
+// shapes with new[], as the FunctionKernel running the fused node frees them.
+Status RunMklDnnSubgraph(const MklDnnSubgraph& subgraph,
+                         const ONNXRunTimeTensor* inputs, size_t num_inputs,
+                         ONNXRunTimeTensor* outputs, size_t num_outputs,
+                         AllocateFunc allocate_func, AllocatorHandle allocator);
+
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
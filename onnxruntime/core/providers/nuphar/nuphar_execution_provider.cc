@@ -0,0 +1,470 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/nuphar/nuphar_execution_provider.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <tvm/tvm.h>
+#include <tvm/build_module.h>
+#include <tvm/ir.h>
+
+#include "core/codegen/tvm/tvm_op_lowering.h"
+#include "core/common/cpuid_info.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/allocator.h"
+#include "core/framework/compute_capability.h"
+#include "core/framework/kernel_registry.h"
+#include "core/graph/graph_viewer.h"
+#include "core/providers/nuphar/nuphar_module_cache.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// the dims of a float tensor whose shape is known, or false
+bool GetStaticDims(const NodeArg* arg, std::vector<int64_t>& dims) {
+  const auto* type = arg->TypeAsProto();
+  const auto* shape = arg->Shape();
+  if (!arg->Exists() || type == nullptr || !type->has_tensor_type() ||
+      type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT || shape == nullptr) {
+    return false;
+  }
+  dims.clear();
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+    dims.push_back(dim.dim_value());
+  }
+  return true;
+}
+
+bool IsFusibleNode(const Node& node) {
+  if (!tvm_codegen::CanLowerToTVM(node) || node.OutputDefs().size() != 1) {
+    return false;
+  }
+  std::vector<int64_t> dims;
+  for (const auto* input : node.InputDefs()) {
+    if (!GetStaticDims(input, dims)) {
+      return false;
+    }
+  }
+  return GetStaticDims(node.OutputDefs()[0], dims);
+}
+
+bool IsGraphOutput(const GraphViewer& graph_viewer, const NodeArg* arg) {
+  const auto& outputs = graph_viewer.GetOutputs();
+  return std::find(outputs.begin(), outputs.end(), arg) != outputs.end();
+}
+
+std::string Trim(const std::string& s) {
+  const auto begin = s.find_first_not_of(" \t");
+  if (begin == std::string::npos) {
+    return std::string();
+  }
+  return s.substr(begin, s.find_last_not_of(" \t") - begin + 1);
+}
+
+// FNV-1a, which is the same in every process, unlike std::hash
+uint64_t HashString(const std::string& s) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : s) {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+tvm::Array<tvm::Expr> ToTvmShape(const std::vector<int64_t>& dims) {
+  tvm::Array<tvm::Expr> shape;
+  for (auto dim : dims) {
+    shape.push_back(tvm::make_const(tvm::Int(32), dim));
+  }
+  return shape;
+}
+
+// Inlines the elementwise expressions into their consumers, so that every output is computed by one loop nest reading
+// the inputs. The loops of the outputs of elementwise expressions are fused, split by the vector width of the target
+// to vectorize the inner loop, and run in parallel by the outer one. Reductions run their outer loops in parallel.
+tvm::Schedule CreateSchedule(const tvm::Array<tvm::Tensor>& outputs, int vector_width) {
+  tvm::Array<tvm::Operation> output_ops;
+  for (const auto& output : outputs) {
+    output_ops.push_back(output->op);
+  }
+  tvm::Schedule schedule = tvm::create_schedule(output_ops);
+
+  for (auto stage : schedule->stages) {
+    const auto* op = stage->op.as<tvm::ComputeOpNode>();
+    if (op == nullptr) {
+      continue;
+    }
+    const bool is_output = std::any_of(output_ops.begin(), output_ops.end(),
+                                       [&stage](const tvm::Operation& output) { return output.same_as(stage->op); });
+    if (!is_output && op->reduce_axis.empty()) {
+      stage.compute_inline();
+      continue;
+    }
+    if (op->axis.empty()) {
+      continue;
+    }
+
+    tvm::IterVar fused = op->axis[0];
+    int64_t extent = 1;
+    for (size_t i = 0; i < op->axis.size(); i++) {
+      const auto* dim = op->axis[i]->dom->extent.as<tvm::ir::IntImm>();
+      extent *= dim != nullptr ? dim->value : 0;
+      if (i > 0) {
+        tvm::IterVar next;
+        stage.fuse(fused, op->axis[i], &next);
+        fused = next;
+      }
+    }
+    if (op->reduce_axis.empty() && extent > vector_width && extent % vector_width == 0) {
+      tvm::IterVar outer, inner;
+      stage.split(fused, tvm::make_const(tvm::Int(32), vector_width), &outer, &inner);
+      stage.vectorize(inner);
+      stage.parallel(outer);
+    } else {
+      stage.parallel(fused);
+    }
+  }
+  return schedule;
+}
+
+// A subgraph compiled to a TVM function taking its inputs then its outputs.
+struct NupharFunction {
+  tvm::runtime::Module module;
+  tvm::runtime::PackedFunc func;
+  std::vector<std::vector<int64_t>> input_dims;
+  std::vector<std::vector<int64_t>> output_dims;
+};
+
+// The state of a compiled subgraph, which allocates the outputs for the FunctionKernel.
+struct NupharFuncState {
+  std::shared_ptr<const NupharFunction> function;
+  AllocateFunc allocate_func;
+  AllocatorHandle allocator;
+};
+
+DLTensor MakeDLTensor(void* data, std::vector<int64_t>& dims) {
+  DLTensor tensor;
+  tensor.data = data;
+  tensor.ctx = {kDLCPU, 0};
+  tensor.ndim = static_cast<int>(dims.size());
+  tensor.dtype = {kDLFloat, 32, 1};
+  tensor.shape = dims.empty() ? nullptr : dims.data();
+  tensor.strides = nullptr;
+  tensor.byte_offset = 0;
+  return tensor;
+}
+
+Status RunNupharFunction(const NupharFuncState& state, const ONNXRunTimeTensor* inputs, size_t num_inputs,
+                         ONNXRunTimeTensor* outputs, size_t num_outputs) {
+  const NupharFunction& function = *state.function;
+  ORT_RETURN_IF_NOT(num_inputs == function.input_dims.size() && num_outputs == function.output_dims.size(),
+                    "The Nuphar function has ", function.input_dims.size(), " inputs and ",
+                    function.output_dims.size(), " outputs.");
+
+  // the shapes, which are compiled into the function, are copied as DLTensor takes mutable ones
+  std::vector<std::vector<int64_t>> dims(function.input_dims);
+  dims.insert(dims.end(), function.output_dims.begin(), function.output_dims.end());
+  std::vector<DLTensor> dl_tensors;
+  for (size_t i = 0; i < num_inputs; i++) {
+    ORT_RETURN_IF_NOT(inputs[i].dtype == DType::TFloat32 &&
+                          std::vector<int64_t>(inputs[i].shape, inputs[i].shape + inputs[i].ndim) == dims[i],
+                      "Input ", i, " of the Nuphar function isn't the float tensor of the shape it's compiled for.");
+    dl_tensors.push_back(MakeDLTensor(inputs[i].data, dims[i]));
+  }
+  for (size_t i = 0; i < num_outputs; i++) {
+    const auto& output_dims = function.output_dims[i];
+    size_t size = 1;
+    outputs[i].dtype = DType::TFloat32;
+    outputs[i].ndim = output_dims.size();
+    outputs[i].shape = new int64_t[output_dims.size()];
+    for (size_t d = 0; d < output_dims.size(); d++) {
+      outputs[i].shape[d] = output_dims[d];
+      size *= static_cast<size_t>(output_dims[d]);
+    }
+    outputs[i].data = state.allocate_func(state.allocator, 64, size * sizeof(float));
+    dl_tensors.push_back(MakeDLTensor(outputs[i].data, dims[num_inputs + i]));
+  }
+
+  std::vector<TVMValue> values(dl_tensors.size());
+  std::vector<int> type_codes(dl_tensors.size(), kNDArrayContainer);
+  for (size_t i = 0; i < dl_tensors.size(); i++) {
+    values[i].v_handle = &dl_tensors[i];
+  }
+  tvm::TVMRetValue result;
+  try {
+    function.func.CallPacked(tvm::TVMArgs(values.data(), type_codes.data(), static_cast<int>(values.size())), &result);
+  } catch (const std::exception& ex) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The Nuphar function failed: ", ex.what());
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+Status ParseNupharSettings(const std::string& settings, NupharExecutionProviderInfo& info) {
+  std::istringstream pairs(settings);
+  std::string pair;
+  while (std::getline(pairs, pair, ',')) {
+    if (Trim(pair).empty()) {
+      continue;
+    }
+    // split by the first colon only, which leaves the drives of Windows paths in the values
+    const auto colon = pair.find(':');
+    ORT_RETURN_IF_NOT(colon != std::string::npos, "The Nuphar setting '", pair, "' isn't a key:value pair.");
+    const std::string key = Trim(pair.substr(0, colon));
+    const std::string value = Trim(pair.substr(colon + 1));
+    if (key == "nuphar_cache_path") {
+      info.cache_path = value;
+    } else if (key == "nuphar_target") {
+      info.target = value;
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unknown Nuphar setting ", key);
+    }
+  }
+  return Status::OK();
+}
+
+NupharExecutionProvider::NupharExecutionProvider(const NupharExecutionProviderInfo& info)
+    : cache_path_(info.cache_path), target_(info.target) {
+  DeviceAllocatorRegistrationInfo device_info({OrtMemTypeDefault,
+                                               [](int) { return std::make_unique<CPUAllocator>(); },
+                                               std::numeric_limits<size_t>::max()});
+  InsertAllocator(CreateAllocator(device_info, info.device_id));
+
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  if (target_.empty()) {
+    if (cpuid_info.HasAVX512f()) {
+      target_ = "llvm -mcpu=skylake-avx512";
+    } else if (cpuid_info.HasAVX2()) {
+      target_ = "llvm -mcpu=core-avx2";
+    } else {
+      target_ = "llvm";
+    }
+  }
+  if (target_.find("avx512") != std::string::npos) {
+    vector_width_ = 16;
+  } else if (target_.find("avx2") != std::string::npos || target_.find("haswell") != std::string::npos ||
+             target_.find("skylake") != std::string::npos) {
+    vector_width_ = 8;
+  } else {
+    vector_width_ = 4;
+  }
+}
+
+Status NupharExecutionProvider::CopyTensor(const Tensor& src, Tensor& dst) const {
+  if (strcmp(src.Location().name, CPU) != 0 || strcmp(dst.Location().name, CPU) != 0) {
+    ORT_NOT_IMPLEMENTED(src.Location().name, " copy to ", dst.Location().name, " is not implemented");
+  }
+  memcpy(dst.MutableDataRaw(), src.DataRaw(), src.DataType()->Size() * src.Shape().Size());
+  return Status::OK();
+}
+
+std::shared_ptr<KernelRegistry> NupharExecutionProvider::GetKernelRegistry() const {
+  // the nodes only run in the fused nodes this provider compiles
+  static std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  return kernel_registry;
+}
+
+std::vector<std::unique_ptr<ComputeCapability>>
+NupharExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph_viewer,
+                                       const std::vector<const KernelRegistry*>& /*kernel_registries*/) const {
+  // Group the fusible nodes in topological order, a node joining the group of the nodes producing its inputs if
+  // they're all in the same group. Only the first node of a group consumes values of nodes outside of it, so the
+  // fused node never depends on its own outputs.
+  std::vector<std::vector<NodeIndex>> groups;
+  std::unordered_map<NodeIndex, size_t> node_groups;
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    const Node* node = graph_viewer.GetNode(index);
+    if (!node->GetExecutionProviderType().empty() || !IsFusibleNode(*node)) {
+      continue;
+    }
+    size_t group = groups.size();
+    for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+      auto producer_group = node_groups.find((*it).Index());
+      if (producer_group == node_groups.end() || (it != node->InputNodesBegin() && producer_group->second != group)) {
+        group = groups.size();
+        break;
+      }
+      group = producer_group->second;
+    }
+    if (group == groups.size()) {
+      groups.emplace_back();
+    }
+    groups[group].push_back(index);
+    node_groups[index] = group;
+  }
+
+  std::vector<std::unique_ptr<ComputeCapability>> result;
+  for (const auto& group : groups) {
+    // a single node gains nothing from being fused, so it's left to the other providers
+    if (group.size() < 2) {
+      continue;
+    }
+
+    auto meta_def = std::make_unique<IndexedSubGraph::MetaDef>();
+    meta_def->name = "NupharSubgraph";
+    meta_def->domain = kMSDomain;
+    meta_def->since_version = 1;
+    meta_def->status = ONNX_NAMESPACE::EXPERIMENTAL;
+
+    std::unordered_set<std::string> fused_inputs;
+    std::unordered_set<std::string> produced;
+    for (auto index : group) {
+      const Node* node = graph_viewer.GetNode(index);
+      for (const auto* input : node->InputDefs()) {
+        if (produced.count(input->Name()) == 0 && fused_inputs.insert(input->Name()).second) {
+          meta_def->inputs.push_back(input->Name());
+        }
+      }
+      const NodeArg* output = node->OutputDefs()[0];
+      produced.insert(output->Name());
+      bool consumed_outside = IsGraphOutput(graph_viewer, output);
+      for (auto it = node->OutputNodesBegin(); it != node->OutputNodesEnd(); ++it) {
+        if (node_groups.count((*it).Index()) == 0 || node_groups[(*it).Index()] != node_groups[index]) {
+          consumed_outside = true;
+        }
+      }
+      if (consumed_outside) {
+        meta_def->outputs.push_back(output->Name());
+      }
+    }
+
+    std::unique_ptr<IndexedSubGraph> sub_graph = std::make_unique<IndexedSubGraph>();
+    sub_graph->nodes = group;
+    sub_graph->SetMetaDef(meta_def);
+    result.push_back(std::make_unique<ComputeCapability>(std::move(sub_graph)));
+  }
+  return result;
+}
+
+common::Status NupharExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
+                                                std::vector<NodeComputeInfo>& node_compute_funcs) {
+  for (const auto* fused_node : fused_nodes) {
+    const auto* func_body = fused_node->GetFunctionBody();
+    if (func_body == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Function body is empty");
+    }
+    const GraphViewer body_viewer(func_body->Body());
+
+    // The key of the module describes the subgraph by its structure, leaving out the names of its values, so that
+    // the subgraphs of different models share the modules compiled for them.
+    auto function = std::make_shared<NupharFunction>();
+    std::unordered_map<std::string, std::string> value_ids;
+    std::ostringstream description;
+    description << target_ << "\n";
+    for (const auto* input : fused_node->InputDefs()) {
+      std::vector<int64_t> dims;
+      ORT_RETURN_IF_NOT(GetStaticDims(input, dims), "Input ", input->Name(), " of ", fused_node->Name(),
+                        " has no static shape.");
+      value_ids[input->Name()] = "i" + std::to_string(function->input_dims.size());
+      description << value_ids[input->Name()] << ":";
+      for (auto dim : dims) {
+        description << dim << ",";
+      }
+      description << "\n";
+      function->input_dims.push_back(dims);
+    }
+    const auto& order = body_viewer.GetNodesInTopologicalOrder();
+    for (auto index : order) {
+      const Node* node = body_viewer.GetNode(index);
+      description << node->Domain() << "." << node->OpType() << "(";
+      for (const auto* input : node->InputDefs()) {
+        description << value_ids.at(input->Name()) << ",";
+      }
+      description << ")";
+      // sorted by name, as the attributes are in a hash map
+      std::map<std::string, std::string> attributes;
+      for (const auto& attribute : node->GetAttributes()) {
+        attributes[attribute.first] = attribute.second.SerializeAsString();
+      }
+      for (const auto& attribute : attributes) {
+        description << attribute.first << "=" << attribute.second.size() << ":" << attribute.second << ";";
+      }
+      value_ids[node->OutputDefs()[0]->Name()] = "v" + std::to_string(value_ids.size());
+      description << "->" << value_ids[node->OutputDefs()[0]->Name()] << "\n";
+    }
+    for (const auto* output : fused_node->OutputDefs()) {
+      std::vector<int64_t> dims;
+      ORT_RETURN_IF_NOT(GetStaticDims(output, dims), "Output ", output->Name(), " of ", fused_node->Name(),
+                        " has no static shape.");
+      description << "o:" << value_ids.at(output->Name()) << "\n";
+      function->output_dims.push_back(dims);
+    }
+    std::ostringstream key;
+    key << "nuphar_" << std::hex << std::setw(16) << std::setfill('0') << HashString(description.str());
+    const std::string func_name = key.str();
+
+    auto build = [&]() {
+      std::unordered_map<std::string, tvm::Tensor> tensors;
+      tvm::Array<tvm::Tensor> args;
+      for (size_t i = 0; i < function->input_dims.size(); i++) {
+        tvm::Tensor input = tvm::placeholder(ToTvmShape(function->input_dims[i]), tvm::Float(32),
+                                             "input" + std::to_string(i));
+        tensors[fused_node->InputDefs()[i]->Name()] = input;
+        args.push_back(input);
+      }
+      for (auto index : order) {
+        const Node* node = body_viewer.GetNode(index);
+        std::vector<tvm::Tensor> inputs;
+        for (const auto* input : node->InputDefs()) {
+          inputs.push_back(tensors.at(input->Name()));
+        }
+        tensors[node->OutputDefs()[0]->Name()] = tvm_codegen::LowerToTVM(*node, inputs);
+      }
+      tvm::Array<tvm::Tensor> outputs;
+      for (const auto* output : fused_node->OutputDefs()) {
+        outputs.push_back(tensors.at(output->Name()));
+        args.push_back(tensors.at(output->Name()));
+      }
+
+      tvm::Schedule schedule = CreateSchedule(outputs, vector_width_);
+      auto config = tvm::build_config();
+      std::unordered_map<tvm::Tensor, tvm::Buffer> binds;
+      auto lowered = tvm::lower(schedule, args, func_name, binds, config);
+      return tvm::build(lowered, tvm::Target::create(target_), tvm::Target(), config);
+    };
+
+    try {
+      function->module = nuphar::NupharModuleCache::Instance().GetModule(func_name, cache_path_, build);
+      function->func = function->module.GetFunction(func_name);
+    } catch (const std::exception& ex) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to compile ", fused_node->Name(), " with TVM: ", ex.what());
+    }
+    ORT_RETURN_IF_NOT(function->func != nullptr, "The TVM module of ", fused_node->Name(), " has no function ",
+                      func_name);
+
+    NodeComputeInfo compute_info;
+    std::shared_ptr<const NupharFunction> compiled = function;
+    compute_info.create_state_func = [compiled](ComputeContext* context, FunctionState* state) {
+      *state = new NupharFuncState{compiled, context->allocate_func, context->allocator_handle};
+      return 0;
+    };
+    compute_info.release_state_func = [](FunctionState state) {
+      delete static_cast<NupharFuncState*>(state);
+    };
+    compute_info.compute_func = [](FunctionState state, ONNXRunTimeTensor* input_tensors, size_t num_inputs,
+                                   ONNXRunTimeTensor* output_tensors, size_t num_outputs) {
+      Status status = RunNupharFunction(*static_cast<NupharFuncState*>(state), input_tensors, num_inputs,
+                                        output_tensors, num_outputs);
+      if (!status.IsOK()) {
+        LOGS_DEFAULT(ERROR) << status.ErrorMessage();
+        return -1;
+      }
+      return 0;
+    };
+    node_compute_funcs.push_back(compute_info);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/framework/allocatormgr.h"
+#include "core/framework/execution_provider.h"
+#include "core/graph/constants.h"
+
+namespace onnxruntime {
+
+// Information needed to construct Nuphar execution providers.
+struct NupharExecutionProviderInfo {
+  int device_id{0};
+  // The folder the compiled subgraphs are cached in, so that later processes load them instead of compiling them
+  // again. Empty caches them in memory only.
+  std::string cache_path;
+  // The TVM target the subgraphs are compiled for. Empty chooses an LLVM target of the host ISA.
+  std::string target;
+
+  explicit NupharExecutionProviderInfo(int id) : device_id(id) {}
+  NupharExecutionProviderInfo() = default;
+};
+
+// Parses the settings of a Nuphar execution provider into info, which are comma separated "key:value" pairs of
+//   nuphar_cache_path: the folder of info.cache_path, which must exist
+//   nuphar_target: info.target, such as "llvm -mcpu=skylake-avx512"
+Status ParseNupharSettings(const std::string& settings, NupharExecutionProviderInfo& info);
+
+// Compiles the connected elementwise and reduction nodes of float tensors of static shapes to TVM functions, each run
+// by one fused node. The functions are scheduled for the vector width of the target, and cached by the subgraph and
+// the target they're compiled for.
+class NupharExecutionProvider : public IExecutionProvider {
+ public:
+  explicit NupharExecutionProvider(const NupharExecutionProviderInfo& info);
+
+  std::string Type() const override {
+    return onnxruntime::kNupharExecutionProvider;
+  }
+
+  Status CopyTensor(const Tensor& src, Tensor& dst) const override;
+
+  const void* GetExecutionHandle() const noexcept override {
+    return nullptr;
+  }
+
+  std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
+
+  std::vector<std::unique_ptr<ComputeCapability>>
+  GetCapability(const onnxruntime::GraphViewer& graph_viewer,
+                const std::vector<const KernelRegistry*>& kernel_registries) const override;
+
+  common::Status Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
+                         std::vector<NodeComputeInfo>& node_compute_funcs) override;
+
+ private:
+  std::string cache_path_;
+  std::string target_;
+  // the number of floats the target computes at once
+  int vector_width_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/nuphar/nuphar_module_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+#include "core/common/logging/logging.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace nuphar {
+
+namespace {
+bool FileExists(const std::string& path) {
+  std::ifstream file(path);
+  return file.good();
+}
+}  // namespace
+
+NupharModuleCache& NupharModuleCache::Instance() {
+  static NupharModuleCache cache;
+  return cache;
+}
+
+tvm::runtime::Module NupharModuleCache::GetModule(const std::string& key, const std::string& cache_path,
+                                                  const std::function<tvm::runtime::Module()>& build) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = modules_.find(key);
+    if (it != modules_.end()) {
+      return it->second;
+    }
+  }
+
+  // The IR is saved after LLVM optimized it, so loading it only generates the machine code. Modules are built
+  // without the lock, so that sessions compile different subgraphs concurrently.
+  tvm::runtime::Module module;
+  const std::string file_path = cache_path.empty() ? std::string() : cache_path + "/" + key + ".ll";
+  if (!file_path.empty() && FileExists(file_path)) {
+    module = tvm::runtime::Module::LoadFromFile(file_path, "ll");
+  } else {
+    module = build();
+    if (!file_path.empty()) {
+      // written to a file of this process first, so that other processes never load a partial file
+      const std::string temp_path = file_path + "." + std::to_string(Env::Default().GetSelfPid()) + ".tmp";
+      try {
+        module->SaveToFile(temp_path, "ll");
+        if (std::rename(temp_path.c_str(), file_path.c_str()) != 0) {
+          std::remove(temp_path.c_str());
+        }
+      } catch (const std::exception& ex) {
+        LOGS_DEFAULT(WARNING) << "Failed to save the TVM module " << key << " to " << cache_path << ": " << ex.what();
+      }
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return modules_.emplace(key, module).first->second;
+}
+
+}  // namespace nuphar
+}  // namespace onnxruntime
@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <tvm/runtime/module.h>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace nuphar {
+
+// The TVM modules compiled for fused subgraphs, which are kept in memory over the sessions of the process and, if
+// there is a cache path, as LLVM IR files in it, so that later processes load them instead of lowering, scheduling
+// and optimizing the subgraphs again. The key of a module names the subgraph and the target it's compiled for.
+class NupharModuleCache {
+ public:
+  static NupharModuleCache& Instance();
+
+  // The module of the key, which is loaded from the cache path or, if it's not there, built and saved to it. The
+  // cache path is an existing folder, or empty to keep the modules in memory only.
+  tvm::runtime::Module GetModule(const std::string& key, const std::string& cache_path,
+                                 const std::function<tvm::runtime::Module()>& build);
+
+ private:
+  NupharModuleCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NupharModuleCache);
+
+  OrtMutex mutex_;
+  std::unordered_map<std::string, tvm::runtime::Module> modules_;
+};
+
+}  // namespace nuphar
+}  // namespace onnxruntime
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/nuphar/nuphar_provider_factory.h"
+#include "nuphar_execution_provider.h"
+#include "core/session/abi_session_options_impl.h"
+
+using namespace onnxruntime;
+
+namespace onnxruntime {
+struct NupharProviderFactory : IExecutionProviderFactory {
+  NupharProviderFactory(const NupharExecutionProviderInfo& info) : info_(info) {}
+  ~NupharProviderFactory() override {}
+
+  std::unique_ptr<IExecutionProvider> CreateProvider() override;
+
+ private:
+  NupharExecutionProviderInfo info_;
+};
+
+std::unique_ptr<IExecutionProvider> NupharProviderFactory::CreateProvider() {
+  return std::make_unique<NupharExecutionProvider>(info_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nuphar(int device_id, const char* settings) {
+  NupharExecutionProviderInfo info(device_id);
+  Status status = ParseNupharSettings(settings == nullptr ? "" : settings, info);
+  ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+  return std::make_shared<onnxruntime::NupharProviderFactory>(info);
+}
+
+}  // namespace onnxruntime
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_Nuphar, _In_ OrtSessionOptions* options, int device_id,
+                    _In_ const char* settings) {
+  NupharExecutionProviderInfo info(device_id);
+  Status status = ParseNupharSettings(settings == nullptr ? "" : settings, info);
+  if (!status.IsOK()) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, status.ErrorMessage().c_str());
+  }
+  options->provider_factories.push_back(std::make_shared<onnxruntime::NupharProviderFactory>(info));
+  return nullptr;
+}
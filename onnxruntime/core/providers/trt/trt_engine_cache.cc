@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/trt/trt_engine_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "core/common/logging/logging.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace trt {
+
+bool TRTEngineCache::Load(const std::string& key, std::string& data) const {
+  if (cache_path_.empty()) {
+    return false;
+  }
+  std::ifstream file(Path(key), std::ios::binary);
+  if (!file.good()) {
+    return false;
+  }
+  data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad() && !data.empty();
+}
+
+void TRTEngineCache::Save(const std::string& key, const void* data, size_t size) const {
+  if (cache_path_.empty()) {
+    return;
+  }
+  // written to a file of this process first, so that other processes never load a partial engine
+  const std::string file_path = Path(key);
+  const std::string temp_path = file_path + "." + std::to_string(Env::Default().GetSelfPid()) + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::binary);
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!file.good()) {
+      LOGS_DEFAULT(WARNING) << "Failed to save the TensorRT engine " << key << " to " << cache_path_;
+      file.close();
+      std::remove(temp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(temp_path.c_str(), file_path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+  }
+}
+
+}  // namespace trt
+}  // namespace onnxruntime
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+namespace onnxruntime {
+namespace trt {
+
+// The serialized TensorRT engines of the shape profiles of fused subgraphs, kept as files in a cache path, so that
+// later processes deserialize them instead of building them again, which takes from seconds to minutes for a model.
+// The key of an engine describes everything it's built from: the subgraph, the shapes, the precision and the GPU.
+class TRTEngineCache {
+ public:
+  // cache_path is an existing folder, or empty to cache nothing
+  explicit TRTEngineCache(std::string cache_path) : cache_path_(std::move(cache_path)) {}
+
+  // reads the engine of the key into data, false if it isn't cached
+  bool Load(const std::string& key, std::string& data) const;
+
+  // saves the engine of the key, logging a warning if it fails
+  void Save(const std::string& key, const void* data, size_t size) const;
+
+ private:
+  std::string Path(const std::string& key) const { return cache_path_ + "/" + key + ".engine"; }
+
+  const std::string cache_path_;
+};
+
+}  // namespace trt
+}  // namespace onnxruntime
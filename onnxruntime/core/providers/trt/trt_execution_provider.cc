@@ -0,0 +1,699 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/trt/trt_execution_provider.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <cuda_runtime.h>
+#include <NvOnnxParser.h>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/allocator.h"
+#include "core/framework/compute_capability.h"
+#include "core/framework/kernel_registry.h"
+#include "core/graph/graph_viewer.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/trt/trt_engine_cache.h"
+
+#define TRT_CUDA_RETURN_IF_ERROR(expr)                                                                \
+  do {                                                                                                \
+    cudaError_t _cuda_error = (expr);                                                                 \
+    if (_cuda_error != cudaSuccess) {                                                                 \
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, #expr, " failed: ", cudaGetErrorString(_cuda_error)); \
+    }                                                                                                 \
+  } while (0)
+
+namespace onnxruntime {
+
+namespace {
+
+class TRTLogger : public nvinfer1::ILogger {
+ public:
+  void log(Severity severity, const char* msg) override {
+    switch (severity) {
+      case Severity::kINTERNAL_ERROR:
+      case Severity::kERROR:
+        LOGS_DEFAULT(ERROR) << "TensorRT: " << msg;
+        break;
+      case Severity::kWARNING:
+        LOGS_DEFAULT(WARNING) << "TensorRT: " << msg;
+        break;
+      default:
+        LOGS_DEFAULT(VERBOSE) << "TensorRT: " << msg;
+        break;
+    }
+  }
+};
+
+TRTLogger& GetTRTLogger() {
+  static TRTLogger logger;
+  return logger;
+}
+
+// Reads the int8 scales from the calibration table TensorRT wrote when the model was calibrated, instead of
+// calibrating with batches of data.
+class TRTCalibrationTable : public nvinfer1::IInt8EntropyCalibrator2 {
+ public:
+  explicit TRTCalibrationTable(const std::string& table) : table_(table) {}
+
+  int getBatchSize() const override { return 1; }
+  bool getBatch(void* /*bindings*/[], const char* /*names*/[], int /*nbBindings*/) override { return false; }
+  const void* readCalibrationCache(size_t& length) override {
+    length = table_.size();
+    return table_.data();
+  }
+  void writeCalibrationCache(const void* /*ptr*/, size_t /*length*/) override {}
+
+ private:
+  const std::string& table_;
+};
+
+// the operators of the ONNX domain the TensorRT ONNX parser builds layers for
+const std::unordered_set<std::string>& SupportedOps() {
+  static const std::unordered_set<std::string> ops = {
+      "Abs", "Acos", "Acosh", "Add", "ArgMax", "ArgMin", "Asin", "Asinh", "Atan", "Atanh", "AveragePool",
+      "BatchNormalization", "Ceil", "Clip", "Concat", "Conv", "ConvTranspose", "Cos", "Cosh", "DepthToSpace", "Div",
+      "Dropout", "Elu", "Exp", "Flatten", "Floor", "Gemm", "GlobalAveragePool", "GlobalMaxPool", "HardSigmoid",
+      "Identity", "InstanceNormalization", "LRN", "LeakyRelu", "Log", "LogSoftmax", "MatMul", "Max", "MaxPool",
+      "Mean", "Min", "Mul", "Neg", "PRelu", "Pad", "Pow", "Reciprocal", "ReduceL1", "ReduceL2", "ReduceLogSum",
+      "ReduceLogSumExp", "ReduceMax", "ReduceMean", "ReduceMin", "ReduceProd", "ReduceSum", "ReduceSumSquare",
+      "Relu", "Reshape", "Resize", "Selu", "Sigmoid", "Sin", "Sinh", "Slice", "Softmax", "Softplus", "Softsign",
+      "SpaceToDepth", "Split", "Sqrt", "Squeeze", "Sub", "Sum", "Tan", "Tanh", "ThresholdedRelu", "Transpose",
+      "Unsqueeze", "Upsample"};
+  return ops;
+}
+
+// the operators whose inputs after the first are weights or shapes, which TensorRT needs at build time
+const std::unordered_set<std::string>& ConstantParameterOps() {
+  static const std::unordered_set<std::string> ops = {
+      "BatchNormalization", "Clip", "Conv", "ConvTranspose", "InstanceNormalization", "Pad", "Reshape", "Resize",
+      "Slice", "Split", "Squeeze", "Unsqueeze", "Upsample"};
+  return ops;
+}
+
+bool IsFloatTensor(const NodeArg* arg) {
+  const auto* type = arg->TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
+}
+
+// The inputs of the network TensorRT builds from a subgraph are float tensors of known ranks, and so are its
+// outputs and the values between its layers. The weights may be initializers of any type the parser converts.
+bool IsSupportedNode(const GraphViewer& graph_viewer, const Node& node) {
+  if ((node.Domain() != kOnnxDomain && node.Domain() != kOnnxDomainAlias) || SupportedOps().count(node.OpType()) == 0) {
+    return false;
+  }
+  const bool constant_parameters = ConstantParameterOps().count(node.OpType()) > 0;
+  const auto& initializers = graph_viewer.GetAllInitializedTensors();
+  const auto& inputs = node.InputDefs();
+  for (size_t i = 0; i < inputs.size(); i++) {
+    if (!inputs[i]->Exists()) {
+      continue;
+    }
+    const bool is_initializer = initializers.count(inputs[i]->Name()) > 0;
+    if (i > 0 && constant_parameters && !is_initializer) {
+      return false;
+    }
+    if (!is_initializer && (!IsFloatTensor(inputs[i]) || inputs[i]->Shape() == nullptr)) {
+      return false;
+    }
+  }
+  for (const auto* output : node.OutputDefs()) {
+    if (output->Exists() && (!IsFloatTensor(output) || output->Shape() == nullptr)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsGraphOutput(const GraphViewer& graph_viewer, const NodeArg* arg) {
+  const auto& outputs = graph_viewer.GetOutputs();
+  return std::find(outputs.begin(), outputs.end(), arg) != outputs.end();
+}
+
+std::string Trim(const std::string& s) {
+  const auto begin = s.find_first_not_of(" \t");
+  if (begin == std::string::npos) {
+    return std::string();
+  }
+  return s.substr(begin, s.find_last_not_of(" \t") - begin + 1);
+}
+
+bool ParseUnsigned(const std::string& value, size_t& result) {
+  std::istringstream stream(value);
+  unsigned long long parsed = 0;
+  if (value.empty() || value[0] == '-' || !(stream >> parsed) || !stream.eof()) {
+    return false;
+  }
+  result = static_cast<size_t>(parsed);
+  return true;
+}
+
+// FNV-1a, which is the same in every process, unlike std::hash
+uint64_t HashString(const std::string& s) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : s) {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string ToHex(uint64_t value) {
+  std::ostringstream hex;
+  hex << std::hex << std::setw(16) << std::setfill('0') << value;
+  return hex.str();
+}
+
+// The ONNX model of a fused node, which TensorRT parses. The initializers of the subgraph are its weights, the other
+// inputs of the fused node become the inputs of the network. Everything is written in a fixed order, so that the
+// same subgraph serializes to the same key of its engines in every process.
+std::string SerializeSubgraph(const Node& fused_node, const Graph& body) {
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  model.set_producer_name("onnxruntime");
+  for (const auto& domain : body.DomainToVersionMap()) {
+    if (domain.first == kOnnxDomain || domain.first == kOnnxDomainAlias) {
+      auto* opset = model.add_opset_import();
+      opset->set_domain(kOnnxDomain);
+      opset->set_version(domain.second);
+      break;
+    }
+  }
+
+  auto* graph = model.mutable_graph();
+  graph->set_name(fused_node.Name());
+  const GraphViewer body_viewer(body);
+  for (auto index : body_viewer.GetNodesInTopologicalOrder()) {
+    auto* node = graph->add_node();
+    body_viewer.GetNode(index)->ToProto(*node);
+    // sorted by name, as the attributes are in a hash map
+    std::sort(node->mutable_attribute()->begin(), node->mutable_attribute()->end(),
+              [](const ONNX_NAMESPACE::AttributeProto& a, const ONNX_NAMESPACE::AttributeProto& b) {
+                return a.name() < b.name();
+              });
+  }
+  const auto& initializers = body.GetAllInitializedTensors();
+  for (const auto* input : fused_node.InputDefs()) {
+    *graph->add_input() = input->ToProto();
+    auto initializer = initializers.find(input->Name());
+    if (initializer != initializers.end()) {
+      *graph->add_initializer() = *initializer->second;
+    }
+  }
+  for (const auto* output : fused_node.OutputDefs()) {
+    *graph->add_output() = output->ToProto();
+  }
+  return model.SerializeAsString();
+}
+
+Status ToTRTDims(const std::vector<int64_t>& shape, nvinfer1::Dims& dims) {
+  ORT_RETURN_IF_NOT(shape.size() <= static_cast<size_t>(nvinfer1::Dims::MAX_DIMS), "TensorRT takes tensors of up to ",
+                    static_cast<int>(nvinfer1::Dims::MAX_DIMS), " dimensions.");
+  dims.nbDims = static_cast<int>(shape.size());
+  for (size_t i = 0; i < shape.size(); i++) {
+    dims.d[i] = static_cast<int>(shape[i]);
+  }
+  return Status::OK();
+}
+
+size_t ElementSize(nvinfer1::DataType type) {
+  switch (type) {
+    case nvinfer1::DataType::kHALF:
+      return 2;
+    case nvinfer1::DataType::kINT8:
+    case nvinfer1::DataType::kBOOL:
+      return 1;
+    default:
+      return 4;
+  }
+}
+
+// A fused subgraph, whose engines are built the first time each shape of its inputs is run.
+struct TRTFunction {
+  std::string name;
+  // the serialized ONNX model of the subgraph
+  std::string model;
+  // hashes the model, the precision and the GPU, which the keys of the engines of the shapes add to
+  std::string key;
+  std::vector<std::string> input_names;
+  std::vector<std::string> output_names;
+  TRTExecutionProviderInfo info;
+  std::string calibration_table;
+  std::shared_ptr<nvinfer1::IRuntime> runtime;
+};
+
+// The engine of a shape profile, with the device memory of its bindings.
+struct TRTEngine {
+  TRTUniquePtr<nvinfer1::ICudaEngine> engine;
+  TRTUniquePtr<nvinfer1::IExecutionContext> context;
+  std::vector<void*> buffers;
+  std::vector<size_t> buffer_sizes;
+  // the bindings of the inputs and outputs of the fused node, -1 for the inputs that are weights of the engine
+  std::vector<int> input_bindings;
+  std::vector<int> output_bindings;
+  std::vector<std::vector<int64_t>> output_dims;
+
+  ~TRTEngine() {
+    for (void* buffer : buffers) {
+      cudaFree(buffer);
+    }
+  }
+};
+
+// The state of a fused node, which allocates the outputs for the FunctionKernel.
+struct TRTFuncState {
+  std::shared_ptr<const TRTFunction> function;
+  AllocateFunc allocate_func;
+  AllocatorHandle allocator;
+  cudaStream_t stream;
+
+  // the engines of the shapes of the inputs, which the runs of the node take turns to use
+  OrtMutex mutex;
+  std::map<std::vector<std::vector<int64_t>>, std::unique_ptr<TRTEngine>> engines;  // GUARDED_BY(mutex)
+
+  ~TRTFuncState() {
+    engines.clear();
+    cudaStreamDestroy(stream);
+  }
+};
+
+// deserializes the engine of the shapes from the engine cache or, if it isn't there, builds and saves it
+Status LoadOrBuildEngine(const TRTFunction& function, const std::vector<std::vector<int64_t>>& shapes,
+                         TRTUniquePtr<nvinfer1::ICudaEngine>& engine) {
+  std::ostringstream description;
+  description << function.key;
+  for (const auto& shape : shapes) {
+    description << "\n";
+    for (auto dim : shape) {
+      description << dim << ",";
+    }
+  }
+  const std::string key = "trt_" + ToHex(HashString(description.str()));
+
+  trt::TRTEngineCache cache(function.info.engine_cache_path);
+  std::string serialized;
+  if (cache.Load(key, serialized)) {
+    engine.reset(function.runtime->deserializeCudaEngine(serialized.data(), serialized.size(), nullptr));
+    if (engine != nullptr) {
+      return Status::OK();
+    }
+    LOGS_DEFAULT(WARNING) << "Failed to deserialize the TensorRT engine " << key << ", which is built again.";
+  }
+
+  TRTUniquePtr<nvinfer1::IBuilder> builder(nvinfer1::createInferBuilder(GetTRTLogger()));
+  ORT_RETURN_IF_NOT(builder != nullptr, "Failed to create a TensorRT builder.");
+  const auto flags = 1U << static_cast<uint32_t>(nvinfer1::NetworkDefinitionCreationFlag::kEXPLICIT_BATCH);
+  TRTUniquePtr<nvinfer1::INetworkDefinition> network(builder->createNetworkV2(flags));
+  TRTUniquePtr<nvinfer1::IBuilderConfig> config(builder->createBuilderConfig());
+  ORT_RETURN_IF_NOT(network != nullptr && config != nullptr, "Failed to create a TensorRT network.");
+  TRTUniquePtr<nvonnxparser::IParser> parser(nvonnxparser::createParser(*network, GetTRTLogger()));
+  ORT_RETURN_IF_NOT(parser != nullptr, "Failed to create a TensorRT ONNX parser.");
+  if (!parser->parse(function.model.data(), function.model.size())) {
+    std::string errors;
+    for (int i = 0; i < parser->getNbErrors(); i++) {
+      errors += std::string(i > 0 ? "; " : "") + parser->getError(i)->desc();
+    }
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "TensorRT failed to parse ", function.name, ": ", errors);
+  }
+
+  config->setMaxWorkspaceSize(function.info.max_workspace_size);
+  if (function.info.fp16_enable && builder->platformHasFastFp16()) {
+    config->setFlag(nvinfer1::BuilderFlag::kFP16);
+  }
+  std::unique_ptr<TRTCalibrationTable> calibrator;
+  if (function.info.int8_enable && builder->platformHasFastInt8()) {
+    calibrator = std::make_unique<TRTCalibrationTable>(function.calibration_table);
+    config->setFlag(nvinfer1::BuilderFlag::kINT8);
+    config->setInt8Calibrator(calibrator.get());
+  }
+
+  // the profile of the engine is the shapes it runs
+  auto* profile = builder->createOptimizationProfile();
+  ORT_RETURN_IF_NOT(profile != nullptr, "Failed to create a TensorRT optimization profile.");
+  for (int i = 0; i < network->getNbInputs(); i++) {
+    const char* name = network->getInput(i)->getName();
+    auto input = std::find(function.input_names.begin(), function.input_names.end(), name);
+    ORT_RETURN_IF_NOT(input != function.input_names.end(), "The TensorRT network of ", function.name,
+                      " has an unknown input ", name);
+    nvinfer1::Dims dims;
+    ORT_RETURN_IF_ERROR(ToTRTDims(shapes[input - function.input_names.begin()], dims));
+    profile->setDimensions(name, nvinfer1::OptProfileSelector::kMIN, dims);
+    profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT, dims);
+    profile->setDimensions(name, nvinfer1::OptProfileSelector::kMAX, dims);
+  }
+  config->addOptimizationProfile(profile);
+
+  engine.reset(builder->buildEngineWithConfig(*network, *config));
+  ORT_RETURN_IF_NOT(engine != nullptr, "TensorRT failed to build an engine for ", function.name);
+  TRTUniquePtr<nvinfer1::IHostMemory> serialized_engine(engine->serialize());
+  if (serialized_engine != nullptr) {
+    cache.Save(key, serialized_engine->data(), serialized_engine->size());
+  }
+  return Status::OK();
+}
+
+Status CreateEngine(const TRTFunction& function, const std::vector<std::vector<int64_t>>& shapes,
+                    std::unique_ptr<TRTEngine>& result) {
+  auto trt_engine = std::make_unique<TRTEngine>();
+  ORT_RETURN_IF_ERROR(LoadOrBuildEngine(function, shapes, trt_engine->engine));
+  auto& engine = *trt_engine->engine;
+  trt_engine->context.reset(engine.createExecutionContext());
+  ORT_RETURN_IF_NOT(trt_engine->context != nullptr, "Failed to create a TensorRT execution context for ",
+                    function.name);
+  auto& context = *trt_engine->context;
+
+  for (size_t i = 0; i < function.input_names.size(); i++) {
+    const int binding = engine.getBindingIndex(function.input_names[i].c_str());
+    trt_engine->input_bindings.push_back(binding);
+    if (binding >= 0) {
+      nvinfer1::Dims dims;
+      ORT_RETURN_IF_ERROR(ToTRTDims(shapes[i], dims));
+      ORT_RETURN_IF_NOT(context.setBindingDimensions(binding, dims), "The TensorRT engine of ", function.name,
+                        " doesn't take the shape of input ", function.input_names[i]);
+    }
+  }
+  ORT_RETURN_IF_NOT(context.allInputDimensionsSpecified(), "The TensorRT engine of ", function.name,
+                    " has inputs the fused node doesn't have.");
+  for (const auto& output_name : function.output_names) {
+    const int binding = engine.getBindingIndex(output_name.c_str());
+    ORT_RETURN_IF_NOT(binding >= 0 && engine.getBindingDataType(binding) == nvinfer1::DataType::kFLOAT,
+                      "The TensorRT engine of ", function.name, " has no float output ", output_name);
+    const nvinfer1::Dims dims = context.getBindingDimensions(binding);
+    trt_engine->output_bindings.push_back(binding);
+    trt_engine->output_dims.emplace_back(dims.d, dims.d + dims.nbDims);
+  }
+
+  const int num_bindings = engine.getNbBindings();
+  trt_engine->buffers.assign(static_cast<size_t>(num_bindings), nullptr);
+  trt_engine->buffer_sizes.assign(static_cast<size_t>(num_bindings), 0);
+  for (int binding = 0; binding < num_bindings; binding++) {
+    const nvinfer1::Dims dims = context.getBindingDimensions(binding);
+    size_t size = ElementSize(engine.getBindingDataType(binding));
+    for (int d = 0; d < dims.nbDims; d++) {
+      size *= static_cast<size_t>(dims.d[d]);
+    }
+    trt_engine->buffer_sizes[binding] = size;
+    TRT_CUDA_RETURN_IF_ERROR(cudaMalloc(&trt_engine->buffers[binding], std::max<size_t>(size, 1)));
+  }
+  result = std::move(trt_engine);
+  return Status::OK();
+}
+
+Status RunTRTFunction(TRTFuncState& state, const ONNXRunTimeTensor* inputs, size_t num_inputs,
+                      ONNXRunTimeTensor* outputs, size_t num_outputs) {
+  const TRTFunction& function = *state.function;
+  ORT_RETURN_IF_NOT(num_inputs == function.input_names.size() && num_outputs == function.output_names.size(),
+                    "The TensorRT function has ", function.input_names.size(), " inputs and ",
+                    function.output_names.size(), " outputs.");
+  std::vector<std::vector<int64_t>> shapes;
+  for (size_t i = 0; i < num_inputs; i++) {
+    shapes.emplace_back(inputs[i].shape, inputs[i].shape + inputs[i].ndim);
+  }
+
+  TRT_CUDA_RETURN_IF_ERROR(cudaSetDevice(function.info.device_id));
+  std::lock_guard<OrtMutex> lock(state.mutex);
+  auto& trt_engine = state.engines[shapes];
+  if (trt_engine == nullptr) {
+    ORT_RETURN_IF_ERROR(CreateEngine(function, shapes, trt_engine));
+  }
+
+  for (size_t i = 0; i < num_inputs; i++) {
+    const int binding = trt_engine->input_bindings[i];
+    if (binding < 0) {
+      continue;
+    }
+    ORT_RETURN_IF_NOT(inputs[i].dtype == DType::TFloat32, "Input ", function.input_names[i], " of ", function.name,
+                      " isn't a float tensor.");
+    TRT_CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(trt_engine->buffers[binding], inputs[i].data,
+                                             trt_engine->buffer_sizes[binding], cudaMemcpyHostToDevice,
+                                             state.stream));
+  }
+  ORT_RETURN_IF_NOT(trt_engine->context->enqueueV2(trt_engine->buffers.data(), state.stream, nullptr),
+                    "TensorRT failed to run ", function.name);
+  for (size_t i = 0; i < num_outputs; i++) {
+    const int binding = trt_engine->output_bindings[i];
+    const auto& output_dims = trt_engine->output_dims[i];
+    outputs[i].dtype = DType::TFloat32;
+    outputs[i].ndim = output_dims.size();
+    outputs[i].shape = new int64_t[output_dims.size()];
+    std::copy(output_dims.begin(), output_dims.end(), outputs[i].shape);
+    outputs[i].data = state.allocate_func(state.allocator, 64, trt_engine->buffer_sizes[binding]);
+    TRT_CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(outputs[i].data, trt_engine->buffers[binding],
+                                             trt_engine->buffer_sizes[binding], cudaMemcpyDeviceToHost,
+                                             state.stream));
+  }
+  TRT_CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(state.stream));
+  return Status::OK();
+}
+
+}  // namespace
+
+Status ParseTRTSettings(const std::string& settings, TRTExecutionProviderInfo& info) {
+  std::istringstream pairs(settings);
+  std::string pair;
+  while (std::getline(pairs, pair, ',')) {
+    if (Trim(pair).empty()) {
+      continue;
+    }
+    // split by the first colon only, which leaves the drives of Windows paths in the values
+    const auto colon = pair.find(':');
+    ORT_RETURN_IF_NOT(colon != std::string::npos, "The TensorRT setting '", pair, "' isn't a key:value pair.");
+    const std::string key = Trim(pair.substr(0, colon));
+    const std::string value = Trim(pair.substr(colon + 1));
+    if (key == "trt_engine_cache_path") {
+      info.engine_cache_path = value;
+    } else if (key == "trt_fp16_enable") {
+      ORT_RETURN_IF_NOT(value == "0" || value == "1", "The TensorRT setting ", key, " is 0 or 1.");
+      info.fp16_enable = value == "1";
+    } else if (key == "trt_int8_enable") {
+      ORT_RETURN_IF_NOT(value == "0" || value == "1", "The TensorRT setting ", key, " is 0 or 1.");
+      info.int8_enable = value == "1";
+    } else if (key == "trt_int8_calibration_table") {
+      info.int8_calibration_table = value;
+    } else if (key == "trt_max_workspace_size") {
+      ORT_RETURN_IF_NOT(ParseUnsigned(value, info.max_workspace_size), "The TensorRT setting ", key,
+                        " is a number of bytes.");
+    } else if (key == "trt_min_subgraph_size") {
+      ORT_RETURN_IF_NOT(ParseUnsigned(value, info.min_subgraph_size), "The TensorRT setting ", key, " is a number.");
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unknown TensorRT setting ", key);
+    }
+  }
+  ORT_RETURN_IF_NOT(!info.int8_enable || !info.int8_calibration_table.empty(),
+                    "trt_int8_enable requires trt_int8_calibration_table.");
+  return Status::OK();
+}
+
+TRTExecutionProvider::TRTExecutionProvider(const TRTExecutionProviderInfo& info) : info_(info) {
+  // the inputs and outputs of the fused nodes are in CPU memory, and copied to the device by the nodes
+  DeviceAllocatorRegistrationInfo device_info({OrtMemTypeDefault,
+                                               [](int) { return std::make_unique<CPUAllocator>(); },
+                                               std::numeric_limits<size_t>::max()});
+  InsertAllocator(CreateAllocator(device_info, 0));
+
+  cudaDeviceProp prop;
+  ORT_ENFORCE(cudaGetDeviceProperties(&prop, info_.device_id) == cudaSuccess,
+              "Failed to get the properties of CUDA device ", info_.device_id);
+  device_description_ = std::string(prop.name) + " sm_" + std::to_string(prop.major) + std::to_string(prop.minor) +
+                        " TensorRT " + std::to_string(getInferLibVersion());
+  ORT_ENFORCE(cudaSetDevice(info_.device_id) == cudaSuccess, "Failed to set CUDA device ", info_.device_id);
+  runtime_ = std::shared_ptr<nvinfer1::IRuntime>(nvinfer1::createInferRuntime(GetTRTLogger()), TRTDestroy());
+  ORT_ENFORCE(runtime_ != nullptr, "Failed to create a TensorRT runtime.");
+
+  if (info_.int8_enable) {
+    std::ifstream table(info_.int8_calibration_table, std::ios::binary);
+    ORT_ENFORCE(table.good(), "Failed to read the TensorRT calibration table ", info_.int8_calibration_table);
+    calibration_table_.assign(std::istreambuf_iterator<char>(table), std::istreambuf_iterator<char>());
+  }
+}
+
+Status TRTExecutionProvider::CopyTensor(const Tensor& src, Tensor& dst) const {
+  if (strcmp(src.Location().name, CPU) != 0 || strcmp(dst.Location().name, CPU) != 0) {
+    ORT_NOT_IMPLEMENTED(src.Location().name, " copy to ", dst.Location().name, " is not implemented");
+  }
+  memcpy(dst.MutableDataRaw(), src.DataRaw(), src.DataType()->Size() * src.Shape().Size());
+  return Status::OK();
+}
+
+std::shared_ptr<KernelRegistry> TRTExecutionProvider::GetKernelRegistry() const {
+  // the nodes only run in the fused nodes this provider compiles
+  static std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  return kernel_registry;
+}
+
+std::vector<std::unique_ptr<ComputeCapability>>
+TRTExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph_viewer,
+                                    const std::vector<const KernelRegistry*>& /*kernel_registries*/) const {
+  // Group the supported nodes in topological order, a node joining the largest group of the nodes producing its
+  // inputs that it doesn't also depend on through a node outside of it, which would make the fused node depend on
+  // its own outputs. So the connected supported nodes are one group unless fusing them would make a cycle.
+  std::vector<std::vector<NodeIndex>> groups;
+  std::unordered_map<NodeIndex, size_t> node_groups;
+  // the groups a node depends on through a node outside of them
+  std::unordered_map<NodeIndex, std::set<size_t>> indirect_groups;
+  std::unordered_map<std::string, std::vector<NodeIndex>> consumers;
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    const Node* node = graph_viewer.GetNode(index);
+    for (const auto* input : node->InputDefs()) {
+      consumers[input->Name()].push_back(index);
+    }
+    for (const auto* input : node->ImplicitInputDefs()) {
+      consumers[input->Name()].push_back(index);
+    }
+
+    std::set<size_t> direct;
+    std::set<size_t>& indirect = indirect_groups[index];
+    for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+      const auto& producer_indirect = indirect_groups[(*it).Index()];
+      indirect.insert(producer_indirect.begin(), producer_indirect.end());
+      auto producer_group = node_groups.find((*it).Index());
+      if (producer_group != node_groups.end()) {
+        direct.insert(producer_group->second);
+      }
+    }
+
+    size_t group = groups.size();
+    if (node->GetExecutionProviderType().empty() && IsSupportedNode(graph_viewer, *node)) {
+      for (auto candidate : direct) {
+        if (indirect.count(candidate) == 0 &&
+            (group == groups.size() || groups[candidate].size() > groups[group].size())) {
+          group = candidate;
+        }
+      }
+      if (group == groups.size()) {
+        groups.emplace_back();
+      }
+      groups[group].push_back(index);
+      node_groups[index] = group;
+    }
+    for (auto producer_group : direct) {
+      if (producer_group != group) {
+        indirect.insert(producer_group);
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<ComputeCapability>> result;
+  for (size_t group_index = 0; group_index < groups.size(); group_index++) {
+    const auto& group = groups[group_index];
+    if (group.size() < info_.min_subgraph_size) {
+      continue;
+    }
+
+    auto meta_def = std::make_unique<IndexedSubGraph::MetaDef>();
+    meta_def->name = "TRTSubgraph";
+    meta_def->domain = kMSDomain;
+    meta_def->since_version = 1;
+    meta_def->status = ONNX_NAMESPACE::EXPERIMENTAL;
+
+    std::unordered_set<std::string> fused_inputs;
+    std::unordered_set<std::string> produced;
+    for (auto index : group) {
+      const Node* node = graph_viewer.GetNode(index);
+      for (const auto* input : node->InputDefs()) {
+        if (input->Exists() && produced.count(input->Name()) == 0 && fused_inputs.insert(input->Name()).second) {
+          meta_def->inputs.push_back(input->Name());
+        }
+      }
+      for (const auto* output : node->OutputDefs()) {
+        if (!output->Exists()) {
+          continue;
+        }
+        produced.insert(output->Name());
+        bool consumed_outside = IsGraphOutput(graph_viewer, output);
+        for (auto consumer : consumers[output->Name()]) {
+          auto consumer_group = node_groups.find(consumer);
+          if (consumer_group == node_groups.end() || consumer_group->second != group_index) {
+            consumed_outside = true;
+          }
+        }
+        if (consumed_outside) {
+          meta_def->outputs.push_back(output->Name());
+        }
+      }
+    }
+
+    std::unique_ptr<IndexedSubGraph> sub_graph = std::make_unique<IndexedSubGraph>();
+    sub_graph->nodes = group;
+    sub_graph->SetMetaDef(meta_def);
+    result.push_back(std::make_unique<ComputeCapability>(std::move(sub_graph)));
+  }
+  return result;
+}
+
+common::Status TRTExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
+                                             std::vector<NodeComputeInfo>& node_compute_funcs) {
+  for (const auto* fused_node : fused_nodes) {
+    const auto* func_body = fused_node->GetFunctionBody();
+    if (func_body == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Function body is empty");
+    }
+
+    auto function = std::make_shared<TRTFunction>();
+    function->name = fused_node->Name();
+    function->model = SerializeSubgraph(*fused_node, func_body->Body());
+    for (const auto* input : fused_node->InputDefs()) {
+      function->input_names.push_back(input->Name());
+    }
+    for (const auto* output : fused_node->OutputDefs()) {
+      function->output_names.push_back(output->Name());
+    }
+    function->info = info_;
+    function->calibration_table = calibration_table_;
+    function->runtime = runtime_;
+
+    std::ostringstream description;
+    description << device_description_ << "\nfp16:" << info_.fp16_enable << " int8:" << info_.int8_enable
+                << " workspace:" << info_.max_workspace_size << "\n"
+                << calibration_table_ << "\n"
+                << function->model;
+    function->key = ToHex(HashString(description.str()));
+
+    NodeComputeInfo compute_info;
+    std::shared_ptr<const TRTFunction> compiled = function;
+    compute_info.create_state_func = [compiled](ComputeContext* context, FunctionState* state) {
+      cudaStream_t stream;
+      if (cudaSetDevice(compiled->info.device_id) != cudaSuccess ||
+          cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking) != cudaSuccess) {
+        LOGS_DEFAULT(ERROR) << "Failed to create the CUDA stream of " << compiled->name;
+        return -1;
+      }
+      auto* trt_state = new TRTFuncState();
+      trt_state->function = compiled;
+      trt_state->allocate_func = context->allocate_func;
+      trt_state->allocator = context->allocator_handle;
+      trt_state->stream = stream;
+      *state = trt_state;
+      return 0;
+    };
+    compute_info.release_state_func = [](FunctionState state) {
+      delete static_cast<TRTFuncState*>(state);
+    };
+    compute_info.compute_func = [](FunctionState state, ONNXRunTimeTensor* input_tensors, size_t num_inputs,
+                                   ONNXRunTimeTensor* output_tensors, size_t num_outputs) {
+      Status status = RunTRTFunction(*static_cast<TRTFuncState*>(state), input_tensors, num_inputs, output_tensors,
+                                     num_outputs);
+      if (!status.IsOK()) {
+        LOGS_DEFAULT(ERROR) << status.ErrorMessage();
+        return -1;
+      }
+      return 0;
+    };
+    node_compute_funcs.push_back(compute_info);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <NvInfer.h>
+
+#include "core/framework/allocatormgr.h"
+#include "core/framework/execution_provider.h"
+#include "core/graph/constants.h"
+
+namespace onnxruntime {
+
+// Information needed to construct TensorRT execution providers.
+struct TRTExecutionProviderInfo {
+  int device_id{0};
+  // The folder the engines are cached in, so that later processes deserialize them instead of building them again.
+  // Empty caches them in memory only.
+  std::string engine_cache_path;
+  // Lets TensorRT choose fp16 kernels where the GPU runs them fast.
+  bool fp16_enable{false};
+  // Lets TensorRT choose int8 kernels, with the scales of the calibration table TensorRT wrote for the model.
+  bool int8_enable{false};
+  std::string int8_calibration_table;
+  // The device memory TensorRT may use for the scratch space of a layer.
+  size_t max_workspace_size{1 << 30};
+  // Subgraphs of fewer nodes are left to the other providers.
+  size_t min_subgraph_size{1};
+
+  explicit TRTExecutionProviderInfo(int id) : device_id(id) {}
+  TRTExecutionProviderInfo() = default;
+};
+
+// Parses the settings of a TensorRT execution provider into info, which are comma separated "key:value" pairs of
+//   trt_engine_cache_path: the folder of info.engine_cache_path, which must exist
+//   trt_fp16_enable, trt_int8_enable: 0 or 1
+//   trt_int8_calibration_table: the file of info.int8_calibration_table, required by trt_int8_enable
+//   trt_max_workspace_size: info.max_workspace_size in bytes
+//   trt_min_subgraph_size: info.min_subgraph_size
+Status ParseTRTSettings(const std::string& settings, TRTExecutionProviderInfo& info);
+
+struct TRTDestroy {
+  template <typename T>
+  void operator()(T* obj) const {
+    if (obj != nullptr) {
+      obj->destroy();
+    }
+  }
+};
+
+template <typename T>
+using TRTUniquePtr = std::unique_ptr<T, TRTDestroy>;
+
+// Runs the largest connected subgraphs of the operators the TensorRT ONNX parser supports as fused nodes, each a
+// TensorRT engine built for the shapes of its inputs. Every shape the inputs of a fused node take gets its own
+// engine, whose optimization profile is that shape, and which is cached by the subgraph, the shapes, the precision
+// and the GPU it's built for. The inputs and outputs of the fused nodes are in CPU memory, so the nodes TensorRT
+// doesn't support fall back to the providers registered after this one, the CUDA provider on a GPU machine.
+class TRTExecutionProvider : public IExecutionProvider {
+ public:
+  explicit TRTExecutionProvider(const TRTExecutionProviderInfo& info = TRTExecutionProviderInfo());
+
+  std::string Type() const override {
+    return onnxruntime::kTRTExecutionProvider;
+  }
+
+  Status CopyTensor(const Tensor& src, Tensor& dst) const override;
+
+  const void* GetExecutionHandle() const noexcept override {
+    return nullptr;
+  }
+
+  std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
+
+  std::vector<std::unique_ptr<ComputeCapability>>
+  GetCapability(const onnxruntime::GraphViewer& graph_viewer,
+                const std::vector<const KernelRegistry*>& kernel_registries) const override;
+
+  common::Status Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
+                         std::vector<NodeComputeInfo>& node_compute_funcs) override;
+
+ private:
+  TRTExecutionProviderInfo info_;
+  // the contents of info_.int8_calibration_table
+  std::string calibration_table_;
+  // the GPU and the TensorRT version, which the engines are only valid for
+  std::string device_description_;
+  std::shared_ptr<nvinfer1::IRuntime> runtime_;
+};
+
+}  // namespace onnxruntime
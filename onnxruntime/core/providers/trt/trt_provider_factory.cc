@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/trt/trt_provider_factory.h"
+#include "trt_execution_provider.h"
+#include "core/session/abi_session_options_impl.h"
+
+using namespace onnxruntime;
+
+namespace onnxruntime {
+struct TRTProviderFactory : IExecutionProviderFactory {
+  TRTProviderFactory(const TRTExecutionProviderInfo& info) : info_(info) {}
+  ~TRTProviderFactory() override {}
+
+  std::unique_ptr<IExecutionProvider> CreateProvider() override;
+
+ private:
+  TRTExecutionProviderInfo info_;
+};
+
+std::unique_ptr<IExecutionProvider> TRTProviderFactory::CreateProvider() {
+  return std::make_unique<TRTExecutionProvider>(info_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_TRT(int device_id, const char* settings) {
+  TRTExecutionProviderInfo info(device_id);
+  Status status = ParseTRTSettings(settings == nullptr ? "" : settings, info);
+  ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+  return std::make_shared<onnxruntime::TRTProviderFactory>(info);
+}
+
+}  // namespace onnxruntime
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_TRT, _In_ OrtSessionOptions* options, int device_id,
+                    _In_ const char* settings) {
+  TRTExecutionProviderInfo info(device_id);
+  Status status = ParseTRTSettings(settings == nullptr ? "" : settings, info);
+  if (!status.IsOK()) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, status.ErrorMessage().c_str());
+  }
+  options->provider_factories.push_back(std::make_shared<onnxruntime::TRTProviderFactory>(info));
+  return nullptr;
+}
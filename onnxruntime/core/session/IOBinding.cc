@@ -2,9 +2,13 @@
 // Licensed under the MIT License.
 
 #include "core/session/IOBinding.h"
+
+#include <cstring>
 #include "core/common/logging/logging.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/framework/tensor.h"
 #include "core/framework/utils.h"
 
 namespace onnxruntime {
@@ -66,11 +70,108 @@ common::Status IOBinding::BindOutput(const std::string& name, const MLValue& ml_
   auto rc = Contains(output_names_, name);
   if (rc.first) {
     outputs_[rc.second] = ml_value;
+    output_allocators_[rc.second] = nullptr;
     return Status::OK();
   }
 
   output_names_.push_back(name);
   outputs_.push_back(ml_value);
+  output_allocators_.push_back(nullptr);
+  return Status::OK();
+}
+
+common::Status IOBinding::BindOutput(const std::string& name, const OrtAllocatorInfo& location) {
+  auto allocator = utils::GetAllocator(session_state_, location);
+  if (allocator == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The session has no allocator for ", location.ToString(),
+                           " to bind output ", name, " to.");
+  }
+
+  auto rc = Contains(output_names_, name);
+  if (rc.first) {
+    outputs_[rc.second] = MLValue();
+    output_allocators_[rc.second] = allocator;
+    return Status::OK();
+  }
+
+  output_names_.push_back(name);
+  outputs_.emplace_back();
+  output_allocators_.push_back(allocator);
+  return Status::OK();
+}
+
+static MLValue AllocateTensor(MLDataType element_type, const TensorShape& shape, const AllocatorPtr& allocator) {
+  const auto size = shape.Size() * element_type->Size();
+  void* buffer = size == 0 ? nullptr : allocator->Alloc(size);
+  auto tensor = std::make_unique<Tensor>(element_type, shape, buffer, allocator->Info(), allocator);
+  return MLValue{tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+common::Status IOBinding::CreateOutputAllocators(
+    std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  const auto& execution_providers = session_state_.GetExecutionProviders();
+  const auto& alloc_plan = session_state_.GetExecutionPlan()->allocation_plan;
+
+  for (size_t i = 0, end = output_names_.size(); i < end; ++i) {
+    const AllocatorPtr& allocator = output_allocators_[i];
+    if (allocator == nullptr) {
+      continue;
+    }
+
+    // a new value for every Run. the caller may still hold the previous one.
+    outputs_[i] = MLValue();
+
+    int mlvalue_idx;
+    ORT_RETURN_IF_ERROR(session_state_.GetMLValueNameIdxMap().GetIdx(output_names_[i], mlvalue_idx));
+    const auto& per_alloc_plan = alloc_plan[mlvalue_idx];
+    if (per_alloc_plan.value_type == nullptr || !per_alloc_plan.value_type->IsTensorType()) {
+      continue;
+    }
+
+    // the node writes the output where its provider expects it, so only an output planned on the bound device
+    // can be allocated there
+    const auto& bound_location = allocator->Info();
+    if (execution_providers.Get(per_alloc_plan.location) != execution_providers.Get(bound_location) ||
+        per_alloc_plan.location.mem_type != bound_location.mem_type) {
+      continue;
+    }
+
+    MLDataType element_type = static_cast<const TensorTypeBase*>(per_alloc_plan.value_type)->GetElementType();
+    MLValue& output = outputs_[i];
+    fetch_allocators[i] = [element_type, allocator, &output](const TensorShape& shape, MLValue& mlvalue) {
+      mlvalue = AllocateTensor(element_type, shape, allocator);
+      // the output is preallocated on the device as far as copying the fetches back is concerned, so it is
+      // handed to the caller as is
+      output = mlvalue;
+      return Status::OK();
+    };
+  }
+
+  return Status::OK();
+}
+
+common::Status IOBinding::CopyOutputsToBoundDevices() {
+  const auto& execution_providers = session_state_.GetExecutionProviders();
+
+  for (size_t i = 0, end = output_names_.size(); i < end; ++i) {
+    const AllocatorPtr& allocator = output_allocators_[i];
+    if (allocator == nullptr || !outputs_[i].IsTensor()) {
+      continue;
+    }
+
+    const auto& tensor = outputs_[i].Get<Tensor>();
+    auto* bound_provider = execution_providers.Get(allocator->Info());
+    if (execution_providers.Get(tensor.Location()) == bound_provider) {
+      continue;
+    }
+
+    // only the device provider copies between the host and the device
+    ORT_ENFORCE(bound_provider);
+    MLValue output = AllocateTensor(tensor.DataType(), tensor.Shape(), allocator);
+    ORT_RETURN_IF_ERROR(bound_provider->CopyTensor(tensor, *output.GetMutable<Tensor>()));
+    outputs_[i] = output;
+  }
+
   return Status::OK();
 }
 
@@ -100,4 +201,46 @@ AllocatorPtr IOBinding::GetCPUAllocator(int id, onnxruntime::ProviderType provid
   return cpu_provider->GetAllocator(0, OrtMemTypeDefault);
 }
 
+AllocatorPtr IOBinding::GetAllocator(const char* location_name, int id, OrtMemType mem_type) const {
+  for (const auto& provider : session_state_.GetExecutionProviders()) {
+    auto allocator = provider->GetAllocator(id, mem_type);
+    if (allocator != nullptr && strcmp(allocator->Info().name, location_name) == 0 && allocator->Info().id == id) {
+      return allocator;
+    }
+  }
+  return nullptr;
+}
+
+common::Status IOBinding::CopyOutputsToCpu(std::vector<MLValue>& cpu_outputs) const {
+  const auto& execution_providers = session_state_.GetExecutionProviders();
+  cpu_outputs.clear();
+  cpu_outputs.reserve(outputs_.size());
+  for (const auto& output : outputs_) {
+    if (!output.IsTensor()) {
+      cpu_outputs.push_back(output);
+      continue;
+    }
+
+    const auto& tensor = output.Get<Tensor>();
+    const auto& location = tensor.Location();
+    if (strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput) {
+      cpu_outputs.push_back(output);
+      continue;
+    }
+
+    // only the device provider copies between the device and the host
+    auto* provider = execution_providers.Get(location);
+    if (provider == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "No provider of the session copies from ", location.ToString());
+    }
+    auto* cpu_provider = execution_providers.Get(onnxruntime::kCpuExecutionProvider);
+    ORT_ENFORCE(cpu_provider);
+    MLValue cpu_output = AllocateTensor(tensor.DataType(), tensor.Shape(),
+                                        cpu_provider->GetAllocator(0, OrtMemTypeDefault));
+    ORT_RETURN_IF_ERROR(provider->CopyTensor(tensor, *cpu_output.GetMutable<Tensor>()));
+    cpu_outputs.push_back(std::move(cpu_output));
+  }
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
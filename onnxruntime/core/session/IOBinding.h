@@ -7,6 +7,7 @@
 #include <unordered_map>
 
 #include "core/framework/execution_provider.h"
+#include "core/framework/iexecutor.h"
 #include "core/common/status.h"
 #include "core/graph/basic_types.h"
 #include "core/framework/ml_value.h"
@@ -62,6 +63,16 @@ class IOBinding {
     */
   common::Status BindOutput(const std::string& name, const MLValue& ml_value);
 
+  /**
+    * Bind an output to a device instead of a value. Every Run() allocates the output with the session's allocator
+    * for location and leaves it there, rather than copying it to CPU memory, so it can be fed to the next Run on
+    * the device without a round trip through the host.
+    * The output is allocated directly by the node that produces it if the node runs on the device of location,
+    * and copied to the device after the Run otherwise.
+    * @return INVALID_ARGUMENT if the session has no allocator for location.
+    */
+  common::Status BindOutput(const std::string& name, const OrtAllocatorInfo& location);
+
   /**
     * This simply collects the outputs obtained after calling Run() inside the @param outputs.
     */
@@ -77,14 +88,37 @@ class IOBinding {
     */
   AllocatorPtr GetCPUAllocator(int id, onnxruntime::ProviderType provider_type) const;
 
+  /**
+    * Get the allocator of the session's providers for the memory named location_name, e.g. "Cuda", whatever the
+    * allocator type, to bind outputs to the device or to place values created over its memory.
+    * \return nullptr if the session has no allocator for it
+    */
+  AllocatorPtr GetAllocator(const char* location_name, int id, OrtMemType mem_type) const;
+
+  /**
+    * Get the outputs of the last Run in CPU memory, copying the ones on a device with the provider of the device and
+    * sharing the others.
+    */
+  common::Status CopyOutputsToCpu(std::vector<MLValue>& cpu_outputs) const;
+
  private:
   friend InferenceSession;
 
   IOBinding(const SessionState& session_state);
+
+  // the allocators for the executor that allocate the outputs bound to a device where the node producing them
+  // writes them. the values a previous Run allocated for those outputs are released from the binding.
+  common::Status CreateOutputAllocators(std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  // copy the outputs bound to a device that the Run produced elsewhere to the device
+  common::Status CopyOutputsToBoundDevices();
+
   const SessionState& session_state_;
   std::unordered_map<std::string, MLValue> feeds_;
   std::vector<std::string> output_names_;
   std::vector<MLValue> outputs_;
+  // in the order of output_names_. nullptr for an output bound to a value.
+  std::vector<AllocatorPtr> output_allocators_;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 };
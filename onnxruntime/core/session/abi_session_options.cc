@@ -4,6 +4,8 @@
 #include "core/session/onnxruntime_c_api.h"
 #include <cstring>
 #include <cassert>
+#include "core/framework/environment.h"
+#include "core/framework/error_code_helper.h"
 #include "core/session/inference_session.h"
 #include "abi_session_options_impl.h"
 
@@ -73,6 +75,175 @@ ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options) {
   options->value.enable_cpu_mem_arena = false;
 }
 
+ORT_API(void, OrtEnableCpuHugePages, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_huge_pages = true;
+}
+
+ORT_API(void, OrtDisableCpuHugePages, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_huge_pages = false;
+}
+
+ORT_API(void, OrtAppendSessionAllocator, _In_ OrtSessionOptions* options, _In_ OrtAllocator* allocator) {
+  options->value.custom_allocators.push_back(allocator);
+}
+
+ORT_API(void, OrtEnableCostBasedPlacement, _In_ OrtSessionOptions* options, _In_opt_ const char* profile_file) {
+  options->value.enable_cost_based_placement = true;
+  options->value.placement_profile_file = profile_file == nullptr ? "" : profile_file;
+}
+
+ORT_API(void, OrtDisableCostBasedPlacement, _In_ OrtSessionOptions* options) {
+  options->value.enable_cost_based_placement = false;
+}
+
+ORT_API(void, OrtEnableMetrics, _In_ OrtSessionOptions* options) {
+  options->value.enable_metrics = true;
+}
+
+ORT_API(void, OrtDisableMetrics, _In_ OrtSessionOptions* options) {
+  options->value.enable_metrics = false;
+}
+
+ORT_API(void, OrtEnableHardwareCounters, _In_ OrtSessionOptions* options) {
+  options->value.enable_hardware_counters = true;
+}
+
+ORT_API(void, OrtDisableHardwareCounters, _In_ OrtSessionOptions* options) {
+  options->value.enable_hardware_counters = false;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableResultCache, _In_ OrtSessionOptions* options, size_t max_entries, size_t max_bytes,
+                    int64_t ttl_ms) {
+  if (ttl_ms < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "ttl_ms must not be negative");
+  }
+  options->value.enable_result_cache = true;
+  options->value.result_cache_config.max_entries = max_entries;
+  options->value.result_cache_config.max_bytes = max_bytes;
+  options->value.result_cache_config.ttl_ms = ttl_ms;
+  return nullptr;
+}
+
+ORT_API(void, OrtDisableResultCache, _In_ OrtSessionOptions* options) {
+  options->value.enable_result_cache = false;
+}
+
+ORT_API_STATUS_IMPL(OrtAddConstantInput, _In_ OrtSessionOptions* options, _In_ const char* input_name,
+                    _In_ const OrtValue* value) {
+  auto v = reinterpret_cast<const ::onnxruntime::MLValue*>(value);
+  if (!v->IsTensor()) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "the value of a constant input must be a tensor");
+  }
+  options->value.constant_inputs[input_name] = *v;
+  return nullptr;
+}
+
+// run the float MatMul/Gemm/Conv regions assigned to the CUDA execution provider in float16
+ORT_API(void, OrtEnableFp16MixedPrecision, _In_ OrtSessionOptions* options) {
+  options->value.enable_fp16_mixed_precision = true;
+}
+
+ORT_API(void, OrtDisableFp16MixedPrecision, _In_ OrtSessionOptions* options) {
+  options->value.enable_fp16_mixed_precision = false;
+}
+
+// fuse the chains of element-wise nodes assigned to the CUDA execution provider
+ORT_API(void, OrtEnableElementwiseFusion, _In_ OrtSessionOptions* options) {
+  options->value.enable_elementwise_fusion = true;
+}
+
+ORT_API(void, OrtDisableElementwiseFusion, _In_ OrtSessionOptions* options) {
+  options->value.enable_elementwise_fusion = false;
+}
+
+namespace {
+OrtStatus* CreateArenaConfig(size_t max_mem, OrtArenaExtendStrategy extend_strategy, size_t initial_chunk_size_bytes,
+                             size_t extend_increment_bytes, onnxruntime::ArenaConfig& config) {
+  switch (extend_strategy) {
+    case ORT_ARENA_EXTEND_NEXT_POWER_OF_TWO:
+      config.extend_strategy = onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo;
+      break;
+    case ORT_ARENA_EXTEND_SAME_AS_REQUESTED:
+      config.extend_strategy = onnxruntime::ArenaExtendStrategy::kSameAsRequested;
+      break;
+    case ORT_ARENA_EXTEND_FIXED_INCREMENT:
+      if (extend_increment_bytes == 0) {
+        return OrtCreateStatus(ORT_INVALID_ARGUMENT, "extend_increment_bytes must be greater than 0");
+      }
+      config.extend_strategy = onnxruntime::ArenaExtendStrategy::kFixedIncrement;
+      break;
+    default:
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "invalid extend_strategy");
+  }
+
+  if (initial_chunk_size_bytes == 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "initial_chunk_size_bytes must be greater than 0");
+  }
+
+  config.max_mem = max_mem;
+  config.initial_chunk_size_bytes = initial_chunk_size_bytes;
+  if (extend_increment_bytes != 0) {
+    config.extend_increment_bytes = extend_increment_bytes;
+  }
+
+  return nullptr;
+}
+}  // namespace
+
+ORT_API_STATUS_IMPL(OrtSetSessionCpuArenaConfig, _In_ OrtSessionOptions* options, size_t max_mem,
+                    OrtArenaExtendStrategy extend_strategy, size_t initial_chunk_size_bytes,
+                    size_t extend_increment_bytes) {
+  onnxruntime::ArenaConfig config;
+  OrtStatus* status = CreateArenaConfig(max_mem, extend_strategy, initial_chunk_size_bytes, extend_increment_bytes,
+                                        config);
+  if (status != nullptr) {
+    return status;
+  }
+
+  options->value.cpu_arena_config = config;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSharedCpuArenaConfig, _Inout_ OrtEnv* env, size_t max_mem,
+                    OrtArenaExtendStrategy extend_strategy, size_t initial_chunk_size_bytes,
+                    size_t extend_increment_bytes) {
+  ORT_UNUSED_PARAMETER(env);  // the arena is process-wide, as is the OrtEnv
+  onnxruntime::ArenaConfig config;
+  OrtStatus* status = CreateArenaConfig(max_mem, extend_strategy, initial_chunk_size_bytes, extend_increment_bytes,
+                                        config);
+  if (status != nullptr) {
+    return status;
+  }
+
+  return onnxruntime::ToOrtStatus(onnxruntime::Environment::SetSharedCpuArenaConfig(config));
+}
+
+ORT_API(void, OrtEnableSharedCpuArena, _In_ OrtSessionOptions* options, size_t session_max_mem) {
+  options->value.use_shared_cpu_arena = true;
+  options->value.shared_cpu_arena_max_mem = session_max_mem;
+}
+
+ORT_API(void, OrtDisableSharedCpuArena, _In_ OrtSessionOptions* options) {
+  options->value.use_shared_cpu_arena = false;
+}
+
+ORT_API(void, OrtEnableLazySessionInitialization, _In_ OrtSessionOptions* options) {
+  options->value.lazy_initialization = true;
+}
+
+ORT_API(void, OrtDisableLazySessionInitialization, _In_ OrtSessionOptions* options) {
+  options->value.lazy_initialization = false;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionAllocatorStatsLogInterval, _In_ OrtSessionOptions* options, int num_runs) {
+  if (num_runs < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "num_runs must not be negative");
+  }
+
+  options->value.allocator_stats_log_interval = num_runs;
+  return nullptr;
+}
+
 ///< logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid) {
   options->value.session_logid = logid;
@@ -90,6 +261,40 @@ ORT_API(int, OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options, int s
   return 0;
 }
 
+ORT_API(int, OrtSetSessionNumaNode, _In_ OrtSessionOptions* options, int numa_node) {
+  if (numa_node < 0) return -1;
+  options->value.numa_node = numa_node;
+  return 0;
+}
+
+ORT_API(int, OrtSetSessionGraphOptimizationLevel, _In_ OrtSessionOptions* options, uint32_t graph_optimization_level) {
+  if (graph_optimization_level > static_cast<uint32_t>(onnxruntime::TransformerLevel::All)) return -1;
+  options->value.graph_optimization_level = static_cast<onnxruntime::TransformerLevel>(graph_optimization_level);
+  return 0;
+}
+
+ORT_API_STATUS_IMPL(OrtSetWeightCompression, _In_ OrtSessionOptions* options, OrtWeightCompression compression) {
+  switch (compression) {
+    case ORT_WEIGHT_COMPRESSION_NONE:
+      options->value.weight_compression = onnxruntime::WeightCompression::kNone;
+      break;
+    case ORT_WEIGHT_COMPRESSION_FLOAT16:
+      options->value.weight_compression = onnxruntime::WeightCompression::kFloat16;
+      break;
+    case ORT_WEIGHT_COMPRESSION_INT8:
+      options->value.weight_compression = onnxruntime::WeightCompression::kInt8;
+      break;
+    default:
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "unknown weight compression");
+  }
+  return nullptr;
+}
+
+ORT_API(void, OrtSetOptimizedModelFilePath, _In_ OrtSessionOptions* options,
+        _In_ const char* optimized_model_filepath) {
+  options->value.optimized_model_filepath = optimized_model_filepath;
+}
+
 ORT_API(void, OrtAppendCustomOpLibPath, _In_ OrtSessionOptions* options, const char* lib_path) {
   options->custom_op_paths.emplace_back(lib_path);
 }
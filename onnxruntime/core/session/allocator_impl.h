@@ -22,4 +22,25 @@ class AllocatorWrapper : public IAllocator {
  private:
   OrtAllocator* impl_;
 };
+
+// An OrtAllocator of an application as the device allocator beneath an arena.
+class DeviceAllocatorWrapper : public IDeviceAllocator {
+ public:
+  explicit DeviceAllocatorWrapper(OrtAllocator* impl)
+      : impl_(impl),
+        info_(impl->Info(impl)->name, OrtDeviceAllocator, impl->Info(impl)->id, impl->Info(impl)->mem_type) {}
+  void* Alloc(size_t size) override {
+    return impl_->Alloc(impl_, size);
+  }
+  void Free(void* p) override {
+    return impl_->Free(impl_, p);
+  }
+  const OrtAllocatorInfo& Info() const override {
+    return info_;
+  }
+
+ private:
+  OrtAllocator* impl_;
+  const OrtAllocatorInfo info_;
+};
 }  // namespace onnxruntime
@@ -0,0 +1,312 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_session.h"
+
+#include <cstring>
+
+#include "core/framework/data_types.h"
+#include "core/framework/mlvalue_tensor_slicer.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+namespace {
+MLValue AllocateTensorInMLValue(const MLDataType data_type, const TensorShape& shape, AllocatorPtr& allocator) {
+  auto new_tensor = std::make_unique<Tensor>(data_type,
+                                             shape,
+                                             allocator->Alloc(shape.Size() * data_type->Size()),
+                                             allocator->Info(),
+                                             allocator);
+
+  return MLValue{new_tensor.release(),
+                 DataTypeImpl::GetType<Tensor>(),
+                 DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+// batched tensors are concatenated and split with memcpy so must be fixed size types in CPU memory.
+bool IsBatchableTensor(const Tensor& tensor) {
+  return tensor.Shape().NumDimensions() > 0 &&
+         strcmp(tensor.Location().name, CPU) == 0 &&
+         tensor.DataType() != DataTypeImpl::GetType<std::string>();
+}
+
+Status CheckLeadingDimensionIsDynamic(const char* kind, const NodeArg& node_arg) {
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr) {
+    // shape is unknown so it may or may not be batched. any problem is reported when a batch is run.
+    return Status::OK();
+  }
+
+  if (shape->dim_size() == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Model ", kind, " '", node_arg.Name(),
+                           "' is a scalar so requests can't be batched.");
+  }
+
+  if (shape->dim(0).has_dim_value()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Model ", kind, " '", node_arg.Name(),
+                           "' has a fixed leading dimension of ", shape->dim(0).dim_value(),
+                           " so requests can't be batched.");
+  }
+
+  return Status::OK();
+}
+}  // namespace
+
+BatchingSession::BatchingSession(InferenceSession& session, const BatchingOptions& options)
+    : session_{session}, options_{options}, allocator_{std::make_shared<CPUAllocator>()} {
+}
+
+Status BatchingSession::Create(InferenceSession& session, const BatchingOptions& options,
+                               std::unique_ptr<BatchingSession>& batching_session) {
+  if (options.max_batch_size < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid max_batch_size: ", options.max_batch_size);
+  }
+
+  if (options.max_queue_delay.count() < 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid max_queue_delay: ",
+                           options.max_queue_delay.count(), "us");
+  }
+
+  auto inputs = session.GetModelInputs();
+  ORT_RETURN_IF_ERROR(inputs.first);
+  for (const auto* input : *inputs.second) {
+    ORT_RETURN_IF_ERROR(CheckLeadingDimensionIsDynamic("input", *input));
+  }
+
+  auto outputs = session.GetModelOutputs();
+  ORT_RETURN_IF_ERROR(outputs.first);
+  for (const auto* output : *outputs.second) {
+    ORT_RETURN_IF_ERROR(CheckLeadingDimensionIsDynamic("output", *output));
+  }
+
+  batching_session = std::unique_ptr<BatchingSession>(new BatchingSession(session, options));
+  return Status::OK();
+}
+
+int64_t BatchingSession::GetBatchSize(const NameMLValMap& feeds, const std::vector<MLValue>& fetches) const {
+  // preallocated outputs would need to be copied into rather than replaced
+  if (feeds.empty() || !fetches.empty()) {
+    return -1;
+  }
+
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.second.IsTensor()) {
+      return -1;
+    }
+
+    const auto& tensor = feed.second.Get<Tensor>();
+    if (!IsBatchableTensor(tensor)) {
+      return -1;
+    }
+
+    const int64_t dim0 = tensor.Shape()[0];
+    if (batch_size == -1) {
+      batch_size = dim0;
+    } else if (dim0 != batch_size) {
+      return -1;
+    }
+  }
+
+  if (batch_size < 1 || batch_size > options_.max_batch_size) {
+    return -1;
+  }
+
+  return batch_size;
+}
+
+bool BatchingSession::CanBatchTogether(const Request& a, const Request& b) {
+  if (*a.output_names != *b.output_names || a.feeds->size() != b.feeds->size()) {
+    return false;
+  }
+
+  for (const auto& feed : *a.feeds) {
+    auto entry = b.feeds->find(feed.first);
+    if (entry == b.feeds->cend()) {
+      return false;
+    }
+
+    const auto& a_tensor = feed.second.Get<Tensor>();
+    const auto& b_tensor = entry->second.Get<Tensor>();
+    if (a_tensor.DataType() != b_tensor.DataType() ||
+        a_tensor.Shape().Slice(1) != b_tensor.Shape().Slice(1)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::vector<BatchingSession::Request*> BatchingSession::TakeBatch() {
+  std::vector<Request*> batch;
+  int64_t rows = 0;
+
+  for (auto iter = pending_.begin(); iter != pending_.end();) {
+    Request* request = *iter;
+    if (rows + request->batch_size <= options_.max_batch_size &&
+        (batch.empty() || CanBatchTogether(*batch.front(), *request))) {
+      batch.push_back(request);
+      rows += request->batch_size;
+      pending_rows_ -= request->batch_size;
+      iter = pending_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  return batch;
+}
+
+Status BatchingSession::Run(const RunOptions& run_options,
+                            const NameMLValMap& feeds,
+                            const std::vector<std::string>& output_names,
+                            std::vector<MLValue>* p_fetches) {
+  const int64_t batch_size = GetBatchSize(feeds, *p_fetches);
+  if (batch_size < 0) {
+    return session_.Run(run_options, feeds, output_names, p_fetches);
+  }
+
+  Request request{&run_options, &feeds, &output_names, p_fetches, batch_size};
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+  pending_.push_back(&request);
+  pending_rows_ += batch_size;
+  if (pending_rows_ >= options_.max_batch_size) {
+    // wake the caller collecting a batch
+    cv_.notify_all();
+  }
+
+  while (!request.done) {
+    // wait if another caller is collecting a batch, or our request has been taken by another caller's batch
+    if (collecting_ || pending_.empty()) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    collecting_ = true;
+    const auto deadline = std::chrono::steady_clock::now() + options_.max_queue_delay;
+    while (pending_rows_ < options_.max_batch_size) {
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        break;
+      }
+
+      cv_.wait_for(lock, deadline - now);
+    }
+
+    std::vector<Request*> batch = TakeBatch();
+    collecting_ = false;
+
+    // let another caller start collecting the requests that didn't make it into this batch
+    cv_.notify_all();
+
+    lock.unlock();
+    RunBatch(batch);
+    lock.lock();
+
+    // a request may be destroyed by its caller as soon as it's marked done, so this must be the last access.
+    for (auto* batched_request : batch) {
+      batched_request->done = true;
+    }
+
+    cv_.notify_all();
+  }
+
+  return request.status;
+}
+
+void BatchingSession::RunBatch(const std::vector<Request*>& batch) {
+  if (batch.size() == 1) {
+    auto& request = *batch.front();
+    request.status = session_.Run(*request.run_options, *request.feeds, *request.output_names, request.fetches);
+    return;
+  }
+
+  int64_t total_batch_size = 0;
+  for (const auto* request : batch) {
+    total_batch_size += request->batch_size;
+  }
+
+  Status status;
+  try {
+    status = RunBatchInternal(batch, total_batch_size);
+  } catch (const std::exception& ex) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+  }
+
+  for (auto* request : batch) {
+    request->status = status;
+    if (!status.IsOK()) {
+      request->fetches->clear();
+    }
+  }
+}
+
+Status BatchingSession::RunBatchInternal(const std::vector<Request*>& batch, int64_t total_batch_size) {
+  const Request& first = *batch.front();
+
+  // concatenate the feeds along the leading dimension
+  NameMLValMap batched_feeds;
+  for (const auto& feed : *first.feeds) {
+    const auto& tensor = feed.second.Get<Tensor>();
+    std::vector<int64_t> dims = tensor.Shape().GetDims();
+    dims[0] = total_batch_size;
+
+    MLValue batched_value = AllocateTensorInMLValue(tensor.DataType(), TensorShape(dims), allocator_);
+    auto* dst = static_cast<char*>(batched_value.GetMutable<Tensor>()->MutableDataRaw());
+    for (const auto* request : batch) {
+      const auto& src = request->feeds->at(feed.first).Get<Tensor>();
+      memcpy(dst, src.DataRaw(), src.Size());
+      dst += src.Size();
+    }
+
+    batched_feeds.insert(std::make_pair(feed.first, batched_value));
+  }
+
+  std::vector<MLValue> batched_fetches;
+  ORT_RETURN_IF_ERROR(session_.Run(*first.run_options, batched_feeds, *first.output_names, &batched_fetches));
+
+  const auto& output_names = *first.output_names;
+  for (size_t i = 0, end = batched_fetches.size(); i < end; ++i) {
+    const auto& fetch = batched_fetches[i];
+    if (!fetch.IsTensor() || !IsBatchableTensor(fetch.Get<Tensor>()) ||
+        fetch.Get<Tensor>().Shape()[0] != total_batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Output '", output_names[i],
+                             "' of a batched Run is not a CPU tensor with the batch size of ", total_batch_size,
+                             " as its leading dimension.");
+    }
+  }
+
+  for (auto* request : batch) {
+    request->fetches->resize(batched_fetches.size());
+  }
+
+  // split each fetch back into the requests, a row at a time
+  for (size_t i = 0, end = batched_fetches.size(); i < end; ++i) {
+    const MLValue& fetch = batched_fetches[i];
+    const auto& tensor = fetch.Get<Tensor>();
+    std::vector<int64_t> dims = tensor.Shape().GetDims();
+
+    auto slicer = MLValueTensorSlicer<const MLValue>::Create(fetch);
+    auto row = slicer.begin();
+    for (auto* request : batch) {
+      dims[0] = request->batch_size;
+      MLValue value = AllocateTensorInMLValue(tensor.DataType(), TensorShape(dims), allocator_);
+      auto* dst = static_cast<char*>(value.GetMutable<Tensor>()->MutableDataRaw());
+      for (int64_t r = 0; r < request->batch_size; ++r, ++row) {
+        const auto& row_tensor = (*row).Get<Tensor>();
+        memcpy(dst, row_tensor.DataRaw(), row_tensor.Size());
+        dst += row_tensor.Size();
+      }
+
+      (*request->fetches)[i] = value;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ml_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+/**
+  * Configuration for a BatchingSession.
+  */
+struct BatchingOptions {
+  /// maximum number of rows (the sum of the leading dimension of the requests) that are run together.
+  int64_t max_batch_size = 8;
+
+  /// maximum time a request waits for others to batch with before it is run.
+  std::chrono::microseconds max_queue_delay{1000};
+};
+
+/**
+  * Coalesces concurrent Run calls into a single InferenceSession::Run.
+  *
+  * Every model input and output must have a dynamic leading (batch) dimension. Concurrent requests whose inputs
+  * have the same names, types and shapes apart from the leading dimension are concatenated along it, run once,
+  * and the outputs split back into the individual requests.
+  *
+  * There is no batching thread. The first caller to find no other caller collecting a batch waits for up to
+  * max_queue_delay for more requests and then runs the batch on its own thread.
+  *
+  * Requests that can't be batched (non-tensor or non-CPU inputs, strings, preallocated outputs, or more rows than
+  * max_batch_size) are passed straight to the InferenceSession.
+  *
+  * Usage:
+  *   std::unique_ptr<BatchingSession> batching_session;
+  *   ORT_RETURN_IF_ERROR(BatchingSession::Create(session, options, batching_session));
+  *   // on many threads concurrently
+  *   ORT_RETURN_IF_ERROR(batching_session->Run(run_options, feeds, output_names, &fetches));
+  */
+class BatchingSession {
+ public:
+  /**
+    * Create a BatchingSession over an initialized InferenceSession.
+    * @param session must outlive the BatchingSession.
+    * @return INVALID_ARGUMENT if the options are invalid or a model input or output doesn't have a dynamic
+    *         leading dimension.
+    */
+  static common::Status Create(InferenceSession& session, const BatchingOptions& options,
+                               std::unique_ptr<BatchingSession>& batching_session);
+
+  /**
+    * Run the request, possibly as part of a batch with other concurrent requests.
+    * Batched requests are run with the RunOptions of one of the requests in the batch, so setting terminate on
+    * one request's RunOptions may cancel the others in its batch.
+    * @see InferenceSession::Run
+    */
+  common::Status Run(const RunOptions& run_options,
+                     const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<MLValue>* p_fetches);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BatchingSession);
+
+  struct Request {
+    const RunOptions* run_options;
+    const NameMLValMap* feeds;
+    const std::vector<std::string>* output_names;
+    std::vector<MLValue>* fetches;
+    int64_t batch_size;
+    common::Status status;
+    bool done = false;
+  };
+
+  BatchingSession(InferenceSession& session, const BatchingOptions& options);
+
+  // returns the leading dimension shared by all the feeds, or -1 if the request can't be batched.
+  int64_t GetBatchSize(const NameMLValMap& feeds, const std::vector<MLValue>& fetches) const;
+
+  static bool CanBatchTogether(const Request& a, const Request& b);
+
+  // remove the first pending request plus every later one that it can be batched with.
+  std::vector<Request*> TakeBatch();  // REQUIRES(mutex_)
+
+  void RunBatch(const std::vector<Request*>& batch);
+
+  common::Status RunBatchInternal(const std::vector<Request*>& batch, int64_t total_batch_size);
+
+  InferenceSession& session_;
+  const BatchingOptions options_;
+  AllocatorPtr allocator_;
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::deque<Request*> pending_;  // GUARDED_BY(mutex_)
+  int64_t pending_rows_ = 0;      // GUARDED_BY(mutex_)
+  bool collecting_ = false;       // GUARDED_BY(mutex_) true while a caller is waiting for a batch to fill
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,259 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/constant_folding.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/framework/kernel_registry.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/initializer.h"
+#include "core/session/inference_session.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+namespace {
+
+// makes the ModelProto overloads of Load available to ConstantFolding
+class FoldingSession : public InferenceSession {
+ public:
+  using InferenceSession::InferenceSession;
+  using InferenceSession::Load;
+};
+
+// ops whose outputs differ from run to run even for the same inputs
+const std::unordered_set<std::string> kNondeterministicOps = {
+    "RandomNormal", "RandomUniform", "RandomNormalLike", "RandomUniformLike", "Multinomial"};
+
+bool IsOnnxDomain(const std::string& domain) {
+  return domain == kOnnxDomain || domain == kOnnxDomainAlias;
+}
+
+// a folded output must be a tensor of a known element type that can be stored as raw data
+bool IsFoldableOutput(const NodeArg& arg) {
+  const TypeProto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return false;
+  }
+  const int elem_type = type->tensor_type().elem_type();
+  return elem_type != TensorProto_DataType_UNDEFINED && elem_type != TensorProto_DataType_STRING;
+}
+
+// the dims of arg if every one of them is known
+bool GetStaticDims(const NodeArg& arg, std::vector<int64_t>& dims) {
+  const TensorShapeProto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+    dims.push_back(dim.dim_value());
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ConstantFolding::HasCpuKernel(const onnxruntime::Node& node) const {
+  for (auto* registry : kernels_registries_) {
+    if (registry->TryFindKernel(node, kCpuExecutionProvider) != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Status ConstantFolding::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  GraphViewer graph_viewer(graph);
+
+  // the values known before the graph runs: initializers and the outputs of the nodes folded so far
+  std::unordered_set<std::string> constant_values;
+  for (const auto& entry : graph.GetAllInitializedTensors()) {
+    // the folding session has no model path to read external data from
+    if (!utils::HasExternalData(*entry.second)) {
+      constant_values.insert(entry.first);
+    }
+  }
+
+  // in topological order
+  std::vector<NodeIndex> folded_nodes;
+  std::unordered_set<NodeIndex> folded_set;
+  // the folded nodes that have to be run, the others are Shape nodes of known input shapes
+  std::vector<const Node*> evaluated_nodes;
+  std::unordered_map<std::string, TensorProto> shape_values;
+
+  for (NodeIndex index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto node = graph.GetNode(index);
+    if (!node || !IsOnnxDomain(node->Domain()) || kNondeterministicOps.count(node->OpType()) != 0 ||
+        !node->GetAttributeNameToMutableSubgraphMap().empty() || graph.IsNodeOutputsInGraphOutputs(*node)) {
+      continue;
+    }
+
+    bool foldable_outputs = true;
+    for (const NodeArg* output_def : node->OutputDefs()) {
+      if (output_def->Exists() && !IsFoldableOutput(*output_def)) {
+        foldable_outputs = false;
+      }
+    }
+    if (!foldable_outputs) {
+      continue;
+    }
+
+    std::vector<int64_t> dims;
+    if (node->OpType() == "Shape" && GetStaticDims(*node->InputDefs()[0], dims) && !dims.empty()) {
+      const std::string& output_name = node->OutputDefs()[0]->Name();
+      TensorProto shape_proto;
+      Initializer(TensorProto_DataType_INT64, output_name, {static_cast<int64_t>(dims.size())},
+                  dims.data(), dims.size() * sizeof(int64_t))
+          .ToProto(&shape_proto);
+      shape_values[output_name] = shape_proto;
+    } else {
+      bool constant_inputs = true;
+      for (const NodeArg* input_def : node->InputDefs()) {
+        if (input_def->Exists() && constant_values.count(input_def->Name()) == 0) {
+          constant_inputs = false;
+        }
+      }
+      if (!constant_inputs || !HasCpuKernel(*node)) {
+        continue;
+      }
+      evaluated_nodes.push_back(node);
+    }
+
+    for (const NodeArg* output_def : node->OutputDefs()) {
+      if (output_def->Exists()) {
+        constant_values.insert(output_def->Name());
+      }
+    }
+    folded_nodes.push_back(index);
+    folded_set.insert(index);
+  }
+
+  if (folded_nodes.empty()) {
+    return Status::OK();
+  }
+
+  // the folded values read by the nodes that stay. the others are dropped with their producers.
+  std::vector<std::string> needed_values;
+  std::unordered_set<std::string> needed_set;
+  for (NodeIndex index : folded_nodes) {
+    auto node = graph.GetNode(index);
+    for (auto it = node->OutputEdgesBegin(); it != node->OutputEdgesEnd(); ++it) {
+      if (folded_set.count(it->GetNode().Index()) != 0) {
+        continue;
+      }
+      const std::string& name = node->OutputDefs()[it->GetSrcArgIndex()]->Name();
+      if (needed_set.insert(name).second) {
+        needed_values.push_back(name);
+      }
+    }
+  }
+
+  std::vector<std::string> fetch_names;
+  for (const auto& name : needed_values) {
+    if (shape_values.count(name) == 0) {
+      fetch_names.push_back(name);
+    }
+  }
+
+  std::vector<TensorProto> folded_tensors;
+  if (!fetch_names.empty()) {
+    // the evaluated nodes with the initializers they read form a model without inputs that is run once
+    auto model_proto = std::make_unique<ModelProto>();
+    model_proto->set_ir_version(graph.IrVersion());
+    for (const auto& entry : graph.DomainToVersionMap()) {
+      if (IsOnnxDomain(entry.first)) {
+        auto* opset = model_proto->add_opset_import();
+        opset->set_domain(entry.first);
+        opset->set_version(entry.second);
+      }
+    }
+
+    GraphProto* graph_proto = model_proto->mutable_graph();
+    graph_proto->set_name("ConstantFolding");
+    std::unordered_set<std::string> copied_initializers;
+    for (const Node* node : evaluated_nodes) {
+      node->ToProto(*graph_proto->add_node());
+      for (const NodeArg* input_def : node->InputDefs()) {
+        const std::string& name = input_def->Name();
+        if (!input_def->Exists() || !copied_initializers.insert(name).second) {
+          continue;
+        }
+        const TensorProto* tensor_proto = nullptr;
+        auto shape_value = shape_values.find(name);
+        if (shape_value != shape_values.end()) {
+          *graph_proto->add_initializer() = shape_value->second;
+        } else if (graph.GetInitializedTensor(name, tensor_proto)) {
+          *graph_proto->add_initializer() = *tensor_proto;
+        }
+      }
+    }
+    for (const auto& name : fetch_names) {
+      *graph_proto->add_output() = graph.GetNodeArg(name)->ToProto();
+    }
+
+    SessionOptions so;
+    so.session_logid = "ConstantFolding";
+    // the nodes are run as they are, so folding doesn't recurse into this session
+    so.graph_optimization_level = TransformerLevel::None;
+    FoldingSession session{so, logging_manager_};
+
+    std::vector<MLValue> fetches;
+    Status status = session.Load(std::move(model_proto));
+    if (status.IsOK()) {
+      status = session.Initialize();
+    }
+    if (status.IsOK()) {
+      status = session.Run(NameMLValMap{}, fetch_names, &fetches);
+    }
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Constant folding skipped as the constant nodes failed to run: "
+                            << status.ErrorMessage();
+      return Status::OK();
+    }
+
+    for (size_t i = 0; i < fetch_names.size(); ++i) {
+      const Tensor& tensor = fetches[i].Get<Tensor>();
+      const size_t bytes = static_cast<size_t>(tensor.Shape().Size()) * tensor.DataType()->Size();
+      // empty tensors have no raw data to store
+      if (bytes == 0) {
+        return Status::OK();
+      }
+      folded_tensors.emplace_back();
+      Initializer(utils::GetTensorProtoType(tensor), fetch_names[i], tensor.Shape().GetDims(),
+                  tensor.DataRaw(), bytes)
+          .ToProto(&folded_tensors.back());
+    }
+  }
+
+  for (const auto& name : needed_values) {
+    auto shape_value = shape_values.find(name);
+    if (shape_value != shape_values.end()) {
+      graph.AddInitializedTensor(shape_value->second);
+    }
+  }
+  for (const auto& tensor_proto : folded_tensors) {
+    graph.AddInitializedTensor(tensor_proto);
+  }
+
+  // consumers go first, so the only edges left to remove are the ones to the nodes that stay
+  for (auto it = folded_nodes.rbegin(); it != folded_nodes.rend(); ++it) {
+    auto node = graph.GetNode(*it);
+    std::vector<Node::EdgeEnd> output_edges(node->OutputEdgesBegin(), node->OutputEdgesEnd());
+    for (const auto& edge : output_edges) {
+      graph.RemoveEdge(*it, edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+    }
+    graph.RemoveNode(*it);
+  }
+
+  modified = true;
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+  return Status::OK();
+}
+}  // namespace onnxruntime
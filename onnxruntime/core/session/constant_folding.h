@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/graph/graph_transformer.h"
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+// Replaces the nodes whose inputs are all initializers with initializers holding their outputs, e.g. Cast or
+// Transpose of a weight, and Shape -> Gather -> Unsqueeze -> Concat chains that compute the target of a Reshape.
+// The nodes are run once with the CPU kernels, in a session of their own, when the graph is transformed.
+// Shape nodes whose input has a fully known shape are folded too, without running them.
+// Nondeterministic ops, nodes with subgraphs and nodes that produce graph outputs are never folded.
+class ConstantFolding : public onnxruntime::GraphTransformer {
+ public:
+  explicit ConstantFolding(logging::LoggingManager* logging_manager)
+      : onnxruntime::GraphTransformer("ConstantFolding", "Transformer to precompute the nodes of constant inputs"),
+        logging_manager_(logging_manager) {
+  }
+
+  void AddKernelRegistries(const std::vector<const KernelRegistry*>& kernels) {
+    for (auto* kernel : kernels) {
+      if (kernel)
+        kernels_registries_.push_back(kernel);
+    }
+  }
+
+  void AddKernelRegistry(const KernelRegistry& kernel) {
+    kernels_registries_.push_back(&kernel);
+  }
+
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+
+ private:
+  bool HasCpuKernel(const onnxruntime::Node& node) const;
+
+  logging::LoggingManager* logging_manager_;
+  std::vector<const KernelRegistry*> kernels_registries_;
+};
+}  // namespace onnxruntime
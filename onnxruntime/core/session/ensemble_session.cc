@@ -0,0 +1,237 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/ensemble_session.h"
+
+#include <algorithm>
+
+#include "core/graph/graph.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+// the results of the members of a Run, which is done when every member has completed or been skipped
+struct EnsembleSession::EnsembleRun {
+  const RunOptions* run_options;
+  const NameMLValMap* feeds;
+  std::vector<std::vector<MLValue>> fetches;    // GUARDED_BY(mutex)
+  std::vector<common::Status> statuses;         // GUARDED_BY(mutex)
+  std::vector<bool> skipped;                    // GUARDED_BY(mutex)
+  std::vector<size_t> pending_producers;        // GUARDED_BY(mutex)
+  size_t remaining;                             // GUARDED_BY(mutex)
+  OrtMutex mutex;
+  OrtCondVar done_cv;
+};
+
+EnsembleSession::~EnsembleSession() = default;
+
+Status EnsembleSession::Create(std::vector<EnsembleMember> members,
+                               const std::vector<EnsembleConnection>& connections,
+                               std::unique_ptr<EnsembleSession>& ensemble_session) {
+  if (members.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "At least one member is required.");
+  }
+
+  std::unique_ptr<EnsembleSession> session{new EnsembleSession()};
+  for (size_t i = 0; i < members.size(); ++i) {
+    auto& member = members[i];
+    if (member.session == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Member ", i, " has no session.");
+    }
+
+    auto inputs = member.session->GetModelInputs();
+    if (!inputs.first.IsOK()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Member ", i, ": ", inputs.first.ErrorMessage());
+    }
+    auto outputs = member.session->GetModelOutputs();
+    if (!outputs.first.IsOK()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Member ", i, ": ", outputs.first.ErrorMessage());
+    }
+
+    Member entry;
+    for (const auto* output : *outputs.second) {
+      entry.output_names.push_back(output->Name());
+    }
+    if (!member.output_names.empty()) {
+      for (const auto& output_name : member.output_names) {
+        if (std::find(entry.output_names.begin(), entry.output_names.end(), output_name) == entry.output_names.end()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Member ", i, " has no output named ", output_name);
+        }
+      }
+      entry.output_names = member.output_names;
+    }
+    for (const auto* input : *inputs.second) {
+      entry.feed_names.push_back(input->Name());
+    }
+    entry.session = std::move(member.session);
+    entry.num_producers = 0;
+    session->members_.push_back(std::move(entry));
+  }
+
+  auto& session_members = session->members_;
+  for (const auto& connection : connections) {
+    if (connection.producer >= session_members.size() || connection.consumer >= session_members.size() ||
+        connection.producer == connection.consumer) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid connection from member ", connection.producer,
+                             " to member ", connection.consumer, " of an ensemble of ", session_members.size());
+    }
+
+    auto& producer = session_members[connection.producer];
+    auto& consumer = session_members[connection.consumer];
+    auto output = std::find(producer.output_names.begin(), producer.output_names.end(), connection.output_name);
+    if (output == producer.output_names.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Member ", connection.producer, " doesn't fetch ",
+                             connection.output_name);
+    }
+
+    auto input = std::find(consumer.feed_names.begin(), consumer.feed_names.end(), connection.input_name);
+    if (input == consumer.feed_names.end()) {
+      const bool connected = std::any_of(consumer.connected_inputs.begin(), consumer.connected_inputs.end(),
+                                         [&connection](const std::pair<std::string, std::pair<size_t, size_t>>& c) {
+                                           return c.first == connection.input_name;
+                                         });
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", connection.input_name, " of member ",
+                             connection.consumer, connected ? " is connected more than once." : " doesn't exist.");
+    }
+    consumer.feed_names.erase(input);
+    consumer.connected_inputs.push_back(
+        {connection.input_name,
+         {connection.producer, static_cast<size_t>(output - producer.output_names.begin())}});
+
+    if (std::find(producer.consumers.begin(), producer.consumers.end(), connection.consumer) ==
+        producer.consumers.end()) {
+      producer.consumers.push_back(connection.consumer);
+      ++consumer.num_producers;
+    }
+  }
+
+  // the members left once those without producers are removed, repeatedly, are in a cycle
+  std::vector<size_t> pending_producers;
+  std::vector<size_t> ready;
+  for (size_t i = 0; i < session_members.size(); ++i) {
+    pending_producers.push_back(session_members[i].num_producers);
+    if (session_members[i].num_producers == 0) {
+      ready.push_back(i);
+    }
+  }
+  size_t num_ordered = 0;
+  while (!ready.empty()) {
+    const size_t index = ready.back();
+    ready.pop_back();
+    ++num_ordered;
+    for (size_t consumer : session_members[index].consumers) {
+      if (--pending_producers[consumer] == 0) {
+        ready.push_back(consumer);
+      }
+    }
+  }
+  if (num_ordered != session_members.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The connections of the ensemble form a cycle.");
+  }
+
+  ensemble_session = std::move(session);
+  return Status::OK();
+}
+
+Status EnsembleSession::Run(const RunOptions& run_options,
+                            const NameMLValMap& feeds,
+                            std::vector<std::vector<MLValue>>* p_fetches) {
+  const size_t num_members = members_.size();
+  EnsembleRun run;
+  run.run_options = &run_options;
+  run.feeds = &feeds;
+  run.fetches.resize(num_members);
+  run.statuses.resize(num_members);
+  run.skipped.assign(num_members, false);
+  run.remaining = num_members;
+
+  std::vector<size_t> ready;
+  for (size_t i = 0; i < num_members; ++i) {
+    run.pending_producers.push_back(members_[i].num_producers);
+    if (members_[i].num_producers == 0) {
+      ready.push_back(i);
+    }
+  }
+
+  for (size_t index : ready) {
+    Launch(run, index);
+  }
+
+  {
+    std::unique_lock<OrtMutex> lock(run.mutex);
+    while (run.remaining > 0) {
+      run.done_cv.wait(lock);
+    }
+  }
+
+  for (const auto& status : run.statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  *p_fetches = std::move(run.fetches);
+  return Status::OK();
+}
+
+void EnsembleSession::Launch(EnsembleRun& run, size_t index) {
+  const Member& member = members_[index];
+
+  // the producers have completed, so their fetches are no longer written
+  NameMLValMap feeds;
+  for (const auto& feed_name : member.feed_names) {
+    auto feed = run.feeds->find(feed_name);
+    if (feed != run.feeds->end()) {
+      feeds.insert(*feed);
+    }
+  }
+  for (const auto& input : member.connected_inputs) {
+    feeds.insert({input.first, run.fetches[input.second.first][input.second.second]});
+  }
+
+  auto status = member.session->RunAsync(*run.run_options, feeds, member.output_names,
+                                         [this, &run, index](const Status& run_status, std::vector<MLValue>& fetches) {
+                                           Complete(run, index, run_status, &fetches);
+                                         });
+  if (!status.IsOK()) {
+    Complete(run, index, status, nullptr);
+  }
+}
+
+void EnsembleSession::Complete(EnsembleRun& run, size_t index, const Status& status, std::vector<MLValue>* fetches) {
+  std::vector<size_t> ready;
+  {
+    std::lock_guard<OrtMutex> lock(run.mutex);
+    run.statuses[index] = status;
+    if (status.IsOK()) {
+      run.fetches[index] = std::move(*fetches);
+    }
+
+    // the consumers of a member that failed or was skipped are skipped once their other producers are done
+    std::vector<size_t> done{index};
+    while (!done.empty()) {
+      const size_t member = done.back();
+      done.pop_back();
+      --run.remaining;
+      const bool failed = !run.statuses[member].IsOK() || run.skipped[member];
+      for (size_t consumer : members_[member].consumers) {
+        if (failed) {
+          run.skipped[consumer] = true;
+        }
+        if (--run.pending_producers[consumer] == 0) {
+          (run.skipped[consumer] ? done : ready).push_back(consumer);
+        }
+      }
+    }
+
+    // Run returns, and run is destroyed, once the lock is released
+    if (run.remaining == 0) {
+      run.done_cv.notify_all();
+      return;
+    }
+  }
+
+  for (size_t consumer : ready) {
+    Launch(run, consumer);
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ml_value.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+/**
+  * A model of an EnsembleSession.
+  */
+struct EnsembleMember {
+  /// a loaded and initialized session, owned by the ensemble once it's created
+  std::unique_ptr<InferenceSession> session;
+  /// the outputs fetched from the model, in the order of the fetches of the member. empty for all its outputs.
+  std::vector<std::string> output_names;
+};
+
+/**
+  * Feeds an output of a member of an EnsembleSession to an input of another, in place of a feed of the Run.
+  */
+struct EnsembleConnection {
+  size_t producer;
+  std::string output_name;
+  size_t consumer;
+  std::string input_name;
+};
+
+/**
+  * Runs several models, such as those of an ensemble, as a DAG of InferenceSessions that read the same feeds.
+  *
+  * Each Run feeds a member the feeds of the Run named as the inputs of its model, as GetModelInputs lists them, less
+  * those that are connected to the output of another member. The MLValues are shared by the members rather than
+  * copied; a member whose nodes run on a device copies them there as a Run of its session would. A member is run
+  * once the members it reads from have completed, with InferenceSession::RunAsync, so the members that don't depend
+  * on each other run at the same time on the thread pool of their session, or the intra-op thread pool of the
+  * Environment if they have none.
+  *
+  * A member that fails fails the Run, and the members that read from it aren't run.
+  *
+  * Usage:
+  *   std::vector<EnsembleMember> members(2);
+  *   members[0].session = std::move(features_session);
+  *   members[1].session = std::move(scoring_session);
+  *   // the scoring model reads the embedding of the features model together with the feeds
+  *   std::unique_ptr<EnsembleSession> ensemble_session;
+  *   ORT_RETURN_IF_ERROR(EnsembleSession::Create(std::move(members), {{0, "embedding", 1, "embedding"}},
+  *                                               ensemble_session));
+  *   ORT_RETURN_IF_ERROR(ensemble_session->Run(run_options, feeds, &fetches));
+  */
+class EnsembleSession {
+ public:
+  /**
+    * Take the sessions of the members and check the connections between them.
+    * @return INVALID_ARGUMENT if there are no members, a session is missing or not loaded, an output name isn't an
+    *         output of its model, a connection doesn't name an output fetched from the producer and an input of the
+    *         consumer, an input is connected more than once, or the connections form a cycle.
+    */
+  static common::Status Create(std::vector<EnsembleMember> members,
+                               const std::vector<EnsembleConnection>& connections,
+                               std::unique_ptr<EnsembleSession>& ensemble_session);
+
+  ~EnsembleSession();
+
+  /**
+    * Run the members with the shared feeds and wait for them to complete. It must not be called from a thread of
+    * the pool that runs the members, as it blocks it.
+    * @param run_options the options of the Run of every member. Setting terminate cancels those in progress.
+    * @param p_fetches set to the fetches of each member, in the order of its output_names.
+    */
+  common::Status Run(const RunOptions& run_options,
+                     const NameMLValMap& feeds,
+                     std::vector<std::vector<MLValue>>* p_fetches);
+
+  size_t NumMembers() const { return members_.size(); }
+
+  InferenceSession& GetMember(size_t index) const { return *members_.at(index).session; }
+
+  const std::vector<std::string>& GetMemberOutputNames(size_t index) const { return members_.at(index).output_names; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(EnsembleSession);
+
+  struct EnsembleRun;
+
+  struct Member {
+    std::unique_ptr<InferenceSession> session;
+    std::vector<std::string> output_names;
+    // the inputs of the model read from the feeds of the Run
+    std::vector<std::string> feed_names;
+    // the inputs of the model connected to a fetch of another member, with the member and the index of the fetch
+    std::vector<std::pair<std::string, std::pair<size_t, size_t>>> connected_inputs;
+    // the members connected to an output of this one, once each
+    std::vector<size_t> consumers;
+    size_t num_producers;
+  };
+
+  EnsembleSession() = default;
+
+  // run the member with RunAsync, or fail it if it can't be scheduled
+  void Launch(EnsembleRun& run, size_t index);
+
+  // record the result of the member and run the members that read from it whose producers are all done
+  void Complete(EnsembleRun& run, size_t index, const common::Status& status, std::vector<MLValue>* fetches);
+
+  std::vector<Member> members_;
+};
+
+}  // namespace onnxruntime
@@ -7,7 +7,13 @@
 
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include "core/platform/ort_mutex.h"
 #include <sstream>
 #include <unordered_set>
@@ -20,29 +26,41 @@
 #include "core/graph/graph_transformer_mgr.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
+#include "core/graph/quantization_transformer.h"
 #include "core/framework/allocatormgr.h"
 #include "core/framework/customregistry.h"
+#include "core/framework/cost_based_placement_transformer.h"
+#include "core/framework/kernel_tuning_cache.h"
+#include "core/framework/elementwise_fusion_transformer.h"
 #include "core/framework/environment.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/insert_cast_transformer.h"
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry.h"
+#include "core/framework/mixed_precision_transformer.h"
 #include "core/framework/ml_value_patterns_planner.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/mlvalue_name_idx_map.h"
+#include "core/framework/output_ready_notifier.h"
 #include "core/framework/sequential_executor.h"
 #include "core/framework/parallel_executor.h"
 #include "core/framework/session_state.h"
 #include "core/framework/session_state_initializer.h"
+#include "core/framework/shared_arena.h"
+#include "core/framework/static_mem_pattern_planner.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensorutils.h"
 #include "core/framework/transformer_memcpy.h"
 #include "core/framework/utils.h"
+#include "core/platform/hardware_counters.h"
 #include "core/platform/notification.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/session/constant_folding.h"
 #include "core/session/CustomOpsLoader.h"
 #include "core/session/IOBinding.h"
+#include "core/session/allocator_impl.h"
+#include "core/session/prepared_run.h"
 
 #ifdef USE_EIGEN_THREADPOOL
 #include <unsupported/Eigen/CXX11/ThreadPool>
@@ -52,11 +70,32 @@ using namespace ONNX_NAMESPACE;
 
 namespace onnxruntime {
 
+// the metadata of a model saved with SessionOptions::optimized_model_filepath: the execution provider of each node,
+// comma separated, in the order of the nodes in the saved graph
+static const char* const kNodeExecutionProvidersKey = "onnxruntime.node_execution_providers";
+
+// the directory of a model file, which the locations of external initializer data are relative to
+static std::string GetModelDirectory(const std::string& model_uri) {
+  const auto separator = model_uri.find_last_of("/\\");
+  return separator == std::string::npos ? std::string{} : model_uri.substr(0, separator);
+}
+
+// Env maps files by narrow paths, so a directory that isn't ASCII is left to the current directory
+static std::string GetModelDirectory(const std::wstring& model_uri) {
+  const auto separator = model_uri.find_last_of(L"/\\");
+  if (separator == std::wstring::npos ||
+      std::any_of(model_uri.cbegin(), model_uri.cbegin() + separator, [](wchar_t c) { return c > 0x7f; })) {
+    return {};
+  }
+  return std::string(model_uri.cbegin(), model_uri.cbegin() + separator);
+}
+
 class InferenceSession::Impl {
  public:
   Impl(const SessionOptions& session_options, logging::LoggingManager* logging_manager)
       : session_options_{session_options},
-        graph_transformation_mgr_{session_options_.max_num_graph_transformation_steps},
+        graph_transformation_mgr_{session_options_.max_num_graph_transformation_steps,
+                                  session_options_.graph_optimization_level},
         logging_manager_{logging_manager},
         session_state_{execution_providers_},
         insert_cast_transformer_{"CastFloat16Transformer"} {
@@ -65,22 +104,40 @@ class InferenceSession::Impl {
 
     InitLogger(logging_manager);
 
-    // currently the threadpool is used by the parallel executor only and hence
+    if (session_options_.numa_node >= 0) {
+      numa_thread_pool_ = Environment::CreateNumaIntraOpThreadPool(session_options_.numa_node);
+    }
+
+    // currently the session threadpool is used by the parallel executor only and hence
     // there is no point creating it when only sequential execution is enabled.
+    // unless a specific size is requested the executor shares the Environment's intra-op pool with MLAS
+    // so that multiple sessions in the process don't oversubscribe the cores.
     if (!session_options.enable_sequential_execution) {
+#ifdef USE_EIGEN_THREADPOOL
       int pool_size = session_options_.session_thread_pool_size == 0
                           ? std::thread::hardware_concurrency() / 2
                           : session_options_.session_thread_pool_size;
 
-#ifdef USE_EIGEN_THREADPOOL
       thread_pool_ = std::make_unique<Eigen::NonBlockingThreadPool>(pool_size);
+      session_state_.SetThreadPool(thread_pool_.get());
 #else
-      thread_pool_ = std::make_unique<TaskThreadPool>(pool_size);
+      if (session_options_.session_thread_pool_size == 0) {
+        session_state_.SetThreadPool(numa_thread_pool_ != nullptr ? numa_thread_pool_.get()
+                                                                  : Environment::GetIntraOpThreadPool());
+      } else {
+        thread_pool_ = std::make_unique<TaskThreadPool>(session_options_.session_thread_pool_size);
+        thread_pool_->SetSpinDuration(std::chrono::microseconds(Environment::GetIntraOpThreadPoolSpinDuration()));
+        session_state_.SetThreadPool(thread_pool_.get());
+      }
 #endif
     }
 
-    session_state_.SetThreadPool(thread_pool_.get());
     session_state_.SetEnableMemoryPattern(session_options.enable_mem_pattern);
+    session_state_.SetMemoryPatternCacheOptions(session_options.mem_pattern_cache_capacity,
+                                                session_options.mem_pattern_dim_buckets);
+    if (session_options_.enable_result_cache) {
+      result_cache_ = std::make_unique<ResultCache>(session_options_.result_cache_config);
+    }
     session_profiler_.Initialize(session_logger_);
     session_state_.SetProfiler(session_profiler_);
     if (session_options.enable_profiling) {
@@ -88,6 +145,12 @@ class InferenceSession::Impl {
     }
   }
 
+  ~Impl() {
+    // async runs still reference this session so wait for them before tearing anything down.
+    std::unique_lock<OrtMutex> lock(async_runs_mutex_);
+    while (num_async_runs_ > 0) async_runs_cv_.wait(lock);
+  }
+
   common::Status RegisterExecutionProvider(std::unique_ptr<IExecutionProvider> p_exec_provider) {
     if (p_exec_provider == nullptr) {
       return Status(common::ONNXRUNTIME, common::FAIL, "Received nullptr for exec provider");
@@ -172,10 +235,15 @@ class InferenceSession::Impl {
   template <typename T>
   common::Status Load(const T& model_uri) {
     auto loader = [this, &model_uri](std::shared_ptr<onnxruntime::Model>& model) {
+      model_dir_ = GetModelDirectory(model_uri);
       return onnxruntime::Model::Load(model_uri, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
     };
 
-    return Load(loader, "model_loading_uri");
+    auto status = Load(loader, "model_loading_uri");
+    if (status.IsOK()) {
+      reload_model_ = [model_uri](InferenceSession& session) { return session.Load(model_uri); };
+    }
+    return status;
   }
 
   common::Status Load(const ModelProto& model_proto) {
@@ -215,13 +283,15 @@ class InferenceSession::Impl {
                                        const ExecutionProviders& providers,
                                        KernelRegistryManager& kernel_registry_manager,
                                        const InsertCastTransformer& insert_cast_transformer,
+                                       const std::vector<std::unique_ptr<GraphTransformer>>& provider_transformers,
                                        const SessionState& session_state) {
     // The transformer order:
     // 1. built-in graph rewriter
     // 2. each execution provider's transformer
     // 3. do node placement according to kernel definition
-    // 4. insert copy nodes
-    // 5. insert cast nodes.
+    // 4. execution provider specific transformers such as float16 conversion and element-wise fusion
+    // 5. insert cast nodes
+    // 6. insert copy nodes
 
     // first apply the default/system/basic graph to graph optimizations.
     ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyAll(graph));
@@ -232,8 +302,12 @@ class InferenceSession::Impl {
     GraphPartitioner partitioner(kernel_registry_manager, providers);
     ORT_RETURN_IF_ERROR(partitioner.Partition(graph, session_state.ExportDll(), const_cast<FuncManager*>(session_state.GetFuncMgr())));
 
-    // Insert cast node/s.
     bool modified = false;
+    for (const auto& transformer : provider_transformers) {
+      ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified));
+    }
+
+    // Insert cast node/s.
     ORT_RETURN_IF_ERROR(insert_cast_transformer.Apply(graph, modified));
 
     // Insert copy nodes after all graph transformer.
@@ -250,6 +324,224 @@ class InferenceSession::Impl {
     return common::Status::OK();
   }
 
+  // replaces the allocators of the execution providers with the ones of the application in custom_allocators
+  common::Status ReplaceAllocators() {
+    for (OrtAllocator* custom_allocator : session_options_.custom_allocators) {
+      if (custom_allocator == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "A custom allocator is null.");
+      }
+      const OrtAllocatorInfo& info = *custom_allocator->Info(custom_allocator);
+      AllocatorPtr allocator;
+      if (info.type == OrtArenaAllocator) {
+        DeviceAllocatorRegistrationInfo device_info{
+            info.mem_type,
+            [custom_allocator](int) { return std::make_unique<DeviceAllocatorWrapper>(custom_allocator); },
+            std::numeric_limits<size_t>::max()};
+        allocator = CreateAllocator(device_info, info.id,
+                                    strcmp(info.name, CPU) == 0 ? session_options_.cpu_arena_config : ArenaConfig());
+      } else {
+        allocator = std::make_shared<AllocatorWrapper>(custom_allocator);
+      }
+      ORT_RETURN_IF_ERROR(execution_providers_.ReplaceAllocator(allocator));
+      LOGS(*session_logger_, INFO) << "Allocating at " << info << " with a custom allocator.";
+    }
+    return Status::OK();
+  }
+
+  // makes the inputs in constant_inputs initializers of the graph, and removes them from the inputs Runs may feed
+  common::Status BindConstantInputs(onnxruntime::Graph& graph) {
+    for (const auto& entry : session_options_.constant_inputs) {
+      const auto& name = entry.first;
+      auto input = std::find_if(input_def_list_.cbegin(), input_def_list_.cend(),
+                                [&name](const NodeArg* arg) { return arg->Name() == name; });
+      if (input == input_def_list_.cend()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Can not bind ", name,
+                               " to a constant as it's not an input of the model.");
+      }
+      if (!entry.second.IsTensor()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The constant bound to ", name, " is not a tensor.");
+      }
+
+      ONNX_NAMESPACE::TensorProto tensor_proto;
+      ORT_RETURN_IF_ERROR(utils::TensorToTensorProto(entry.second.Get<Tensor>(), name, tensor_proto));
+
+      const auto* type = (*input)->TypeAsProto();
+      if (type == nullptr || !type->has_tensor_type() || type->tensor_type().elem_type() != tensor_proto.data_type()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The constant bound to ", name,
+                               " doesn't have the type of the input.");
+      }
+      const auto* declared_shape = (*input)->Shape();
+      if (declared_shape != nullptr) {
+        bool matches = declared_shape->dim_size() == tensor_proto.dims_size();
+        for (int i = 0; matches && i < declared_shape->dim_size(); ++i) {
+          const auto& dim = declared_shape->dim(i);
+          matches = !dim.has_dim_value() || dim.dim_value() == tensor_proto.dims(i);
+        }
+        if (!matches) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The shape of the constant bound to ", name,
+                                 " doesn't match the shape of the input.");
+        }
+      }
+
+      // replaces the default value of an input that has one
+      graph.RemoveInitializedTensor(name);
+      graph.AddInitializedTensor(tensor_proto);
+
+      const NodeArg* arg = *input;
+      input_def_list_.erase(input);
+      required_input_def_list_.erase(
+          std::remove(required_input_def_list_.begin(), required_input_def_list_.end(), arg),
+          required_input_def_list_.end());
+      model_input_names_.erase(name);
+      required_model_input_names_.erase(name);
+    }
+
+    return Status::OK();
+  }
+
+  common::Status Specialize(const NameMLValMap& constant_inputs, std::unique_ptr<InferenceSession>& specialized) const {
+    if (!reload_model_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                             "Only a session with a model loaded from a file can be specialized.");
+    }
+
+    SessionOptions options = session_options_;
+    for (const auto& entry : constant_inputs) {
+      options.constant_inputs[entry.first] = entry.second;
+    }
+
+    auto session = std::make_unique<InferenceSession>(options, logging_manager_);
+    ORT_RETURN_IF_ERROR(reload_model_(*session));
+    specialized = std::move(session);
+    return Status::OK();
+  }
+
+  // sets the shapes of the graph inputs that every Run feeds, which are the fixed shapes the model declares or the
+  // ones in frozen_input_shapes, so that Resolve propagates them through the graph
+  common::Status FreezeInputShapes(onnxruntime::Graph& graph) {
+    const auto& shapes = session_options_.frozen_input_shapes;
+    for (const auto& entry : shapes) {
+      if (required_model_input_names_.find(entry.first) == required_model_input_names_.end()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Can not freeze the shape of ", entry.first,
+                               " as it's not a required input of the model.");
+      }
+    }
+
+    frozen_input_shapes_.clear();
+    for (const auto* input : graph.GetInputs()) {
+      const auto* declared_shape = input->Shape();
+      auto frozen = shapes.find(input->Name());
+      if (frozen == shapes.end()) {
+        if (declared_shape == nullptr) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Can not freeze the shape of input ", input->Name(),
+                                 " as the model doesn't declare it.");
+        }
+        for (const auto& dim : declared_shape->dim()) {
+          if (!dim.has_dim_value()) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Can not freeze the shape of input ",
+                                   input->Name(), " as it has symbolic dimensions. Set it in frozen_input_shapes.");
+          }
+        }
+        frozen_input_shapes_[input->Name()] = TensorShape(utils::GetTensorShapeFromTensorShapeProto(*declared_shape));
+        continue;
+      }
+
+      const auto& dims = frozen->second;
+      if (declared_shape != nullptr) {
+        bool matches = declared_shape->dim_size() == static_cast<int>(dims.size());
+        for (int i = 0; matches && i < declared_shape->dim_size(); ++i) {
+          const auto& dim = declared_shape->dim(i);
+          matches = !dim.has_dim_value() || dim.dim_value() == dims[i];
+        }
+        if (!matches) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The frozen shape ", TensorShape(dims),
+                                 " of input ", input->Name(), " doesn't match the shape the model declares.");
+        }
+      }
+
+      ONNX_NAMESPACE::TensorShapeProto shape_proto;
+      for (auto dim : dims) {
+        shape_proto.add_dim()->set_dim_value(dim);
+      }
+      graph.GetNodeArg(input->Name())->SetShape(shape_proto);
+      frozen_input_shapes_[input->Name()] = TensorShape(dims);
+    }
+
+    graph.SetGraphResolveNeeded();
+    session_state_.SetInputShapesFrozen(true);
+    return Status::OK();
+  }
+
+  // writes the transformed and partitioned graph, with the execution provider of each node in the metadata, so that
+  // a session that loads the file can skip the transformations
+  common::Status SaveOptimizedModel(onnxruntime::Graph& graph) {
+    std::ostringstream providers;
+    // in the order the nodes are serialized in
+    GraphViewer graph_viewer(graph);
+    for (NodeIndex index : graph_viewer.GetNodesInTopologicalOrder()) {
+      Node& node = *graph.GetNode(index);
+      if (node.NodeType() == Node::Type::Fused) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Can not save the optimized model as node ",
+                               node.Name(), " was compiled by ", node.GetExecutionProviderType());
+      }
+      if (!node.GetAttributeNameToMutableSubgraphMap().empty()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Can not save the optimized model as node ",
+                               node.Name(), " has subgraphs");
+      }
+      if (providers.tellp() > 0) {
+        providers << ',';
+      }
+      providers << node.GetExecutionProviderType();
+    }
+
+    ModelProto model_proto = model_->ToProto();
+    StringStringEntryProto* providers_prop = nullptr;
+    for (auto& prop : *model_proto.mutable_metadata_props()) {
+      if (prop.key() == kNodeExecutionProvidersKey) {
+        providers_prop = &prop;
+      }
+    }
+    if (providers_prop == nullptr) {
+      providers_prop = model_proto.add_metadata_props();
+      providers_prop->set_key(kNodeExecutionProvidersKey);
+    }
+    providers_prop->set_value(providers.str());
+
+    std::ofstream model_ostream(session_options_.optimized_model_filepath, std::ios::binary | std::ios::trunc);
+    if (!model_ostream || !model_proto.SerializeToOstream(&model_ostream)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to save the optimized model to ",
+                             session_options_.optimized_model_filepath);
+    }
+    LOGS(*session_logger_, INFO) << "Saved the optimized model to " << session_options_.optimized_model_filepath;
+    return common::Status::OK();
+  }
+
+  // assigns the nodes of a model saved with SaveOptimizedModel to the providers they were assigned before.
+  // a loaded graph numbers its nodes in the order they are stored in.
+  common::Status AssignSavedExecutionProviders(onnxruntime::Graph& graph, const std::string& providers) {
+    std::vector<std::string> node_providers;
+    std::istringstream providers_istream(providers);
+    std::string provider;
+    while (std::getline(providers_istream, provider, ',')) {
+      node_providers.push_back(provider);
+    }
+    if (node_providers.size() != static_cast<size_t>(graph.NumberOfNodes())) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The optimized model has ", graph.NumberOfNodes(),
+                             " nodes but execution providers for ", node_providers.size());
+    }
+
+    size_t i = 0;
+    for (auto& node : graph.Nodes()) {
+      if (execution_providers_.Get(node_providers[i]) == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The optimized model assigns node ", node.Name(),
+                               " to ", node_providers[i], ", which is not registered with the session");
+      }
+      node.SetExecutionProviderType(node_providers[i]);
+      ++i;
+    }
+    return common::Status::OK();
+  }
+
   // memory allocations for a subgraph that are owned by InferenceSession
   struct SubgraphMemory {
     std::unique_ptr<SessionState> session_state;
@@ -276,20 +568,31 @@ class InferenceSession::Impl {
           subgraph_info.session_state = std::make_unique<SessionState>(execution_providers_);
           subgraph_info.session_state->SetProfiler(session_profiler_);
           subgraph_info.session_state->SetLogger(*session_logger_);
+          subgraph_info.session_state->SetWeightCompression(session_options_.weight_compression);
 
           // setup everything required to execute the subgraph and save it in subgraph_session_state
           SessionStateInitializer initializer{*subgraph, *subgraph_info.session_state,
-                                              execution_providers_, kernel_registry_manager_};
+                                              execution_providers_, kernel_registry_manager_, model_dir_};
 
           ORT_RETURN_IF_ERROR(initializer.CreatePlan(node.ImplicitInputDefs(),
                                                      session_options_.enable_sequential_execution));
 
           ORT_RETURN_IF_ERROR(initializer.InitializeAndSave(session_state_.GetEnableMemoryPattern(),
                                                             subgraph_info.weights_buffers,
-                                                            &node.ImplicitInputDefs()));
+                                                            &node.ImplicitInputDefs(),
+                                                            session_options_.share_initializers,
+                                                            session_options_.enable_parallel_initialization));
 
           // add the subgraph SessionState instance to the parent graph SessionState so it can be retrieved
           // by Compute() via OpKernelContextInternal.
+          if (session_options_.enable_metrics) {
+            subgraph_info.session_state->SetMetrics(session_metrics_);
+          }
+          subgraph_info.session_state->SetEnableHardwareCounters(session_state_.GetEnableHardwareCounters());
+          if (session_options_.enable_quantization_calibration) {
+            subgraph_info.session_state->SetCalibration(quantization_calibration_);
+          }
+
           session_state.AddSubgraphSessionState(node.Index(), name, *subgraph_info.session_state);
 
           // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
@@ -309,6 +612,35 @@ class InferenceSession::Impl {
   }
 
   common::Status Initialize() {
+    if (session_options_.lazy_initialization) {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_model_loaded_) {
+        LOGS(*session_logger_, ERROR) << "Model was not loaded";
+        return common::Status(common::ONNXRUNTIME, common::FAIL, "Model was not loaded.");
+      }
+      if (!is_inited_) {
+        LOGS(*session_logger_, INFO) << "Deferring the initialization of the session to its first Run.";
+        is_initialization_deferred_ = true;
+        return common::Status::OK();
+      }
+    }
+
+    return InitializeNow();
+  }
+
+  // initializes the session if Initialize deferred it
+  common::Status InitializeIfDeferred() {
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_initialization_deferred_ || is_inited_) {
+        return common::Status::OK();
+      }
+    }
+
+    return InitializeNow();
+  }
+
+  common::Status InitializeNow() {
     Status status = Status::OK();
     auto tp = session_profiler_.StartTime();
 
@@ -325,16 +657,57 @@ class InferenceSession::Impl {
         return common::Status::OK();
       }
 
+      if (session_options_.numa_node >= 0 && numa_thread_pool_ == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The CPUs of NUMA node ", session_options_.numa_node,
+                               " can't be determined.");
+      }
+
+      // the kernels prepared on this thread, e.g. the weights MLAS packs, use the threads of the node
+      utils::ScopedIntraOpThreadPool numa_thread_pool(numa_thread_pool_.get());
+
       // Register default CPUExecutionProvider if user didn't provide it through the Register() calls
       if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
         LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
-        CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+        CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena, session_options_.cpu_arena_config};
+        epi.numa_node = session_options_.numa_node;
+        epi.use_huge_pages = session_options_.enable_cpu_huge_pages;
         execution_providers_.Add(onnxruntime::kCpuExecutionProvider,
                                  std::make_unique<CPUExecutionProvider>(epi));
       }
 
+      // before the kernels are created, which may allocate from them
+      if (session_options_.use_shared_cpu_arena) {
+        ORT_RETURN_IF_ERROR(execution_providers_.ReplaceAllocator(std::make_shared<SharedArenaAllocator>(
+            Environment::GetSharedCpuArena(), session_options_.shared_cpu_arena_max_mem)));
+      }
+      ORT_RETURN_IF_ERROR(ReplaceAllocators());
+
       onnxruntime::Graph& graph = model_->MainGraph();
 
+      // before the shapes are frozen and the graph is transformed, so that constant folding sees the constants
+      if (!session_options_.constant_inputs.empty()) {
+        ORT_RETURN_IF_ERROR(BindConstantInputs(graph));
+        ORT_RETURN_IF_ERROR(graph.Resolve());
+      }
+
+      // before the transformations, so that they see the shapes too
+      if (session_options_.freeze_input_shapes) {
+        ORT_RETURN_IF_ERROR(FreezeInputShapes(graph));
+        ORT_RETURN_IF_ERROR(graph.Resolve());
+      }
+
+      session_state_.SetWeightCompression(session_options_.weight_compression);
+
+      if (session_options_.enable_kernel_autotuning) {
+        session_state_.SetEnableKernelAutotuning(true);
+        if (!session_options_.kernel_tuning_cache_file.empty()) {
+          auto status = KernelTuningCache::Instance().Load(session_options_.kernel_tuning_cache_file);
+          if (!status.IsOK()) {
+            LOGS(*session_logger_, WARNING) << "Ignoring the kernel tuning cache: " << status.ErrorMessage();
+          }
+        }
+      }
+
       // Collect the kernel registries from execution provider instances;
       // There are 2 kinds of kernel registries with priority from high to low as below,
       // 1. Custom execution provider type specific kernel registries.
@@ -347,32 +720,140 @@ class InferenceSession::Impl {
 
       insert_cast_transformer_.AddKernelRegistries(kernel_registry_manager_.GetAllKernelRegistries());
 
-      SessionStateInitializer session_initializer{graph, session_state_, execution_providers_,
-                                                  kernel_registry_manager_};
+      // constant folding runs the CPU kernels, so it is registered once they are known
+      if (session_options_.graph_optimization_level >= TransformerLevel::Basic) {
+        auto constant_folding = std::make_unique<ConstantFolding>(logging_manager_);
+        constant_folding->AddKernelRegistries(kernel_registry_manager_.GetAllKernelRegistries());
+        ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(std::move(constant_folding)));
+      }
 
-      // apply any transformations to the main graph and any subgraphs
-      ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
-                                         execution_providers_, kernel_registry_manager_,
-                                         insert_cast_transformer_,
-                                         session_state_));
+      // quantize before partitioning so that the QLinear nodes are assigned to an execution provider
+      if (!session_options_.quantization_ranges.empty()) {
+        ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(
+            std::make_unique<QuantizationTransformer>(session_options_.quantization_ranges)));
+      }
 
-      ORT_RETURN_IF_ERROR(utils::ForAllMutableSubgraphs(graph, [this](Graph& subgraph) {
-        return TransformGraph(subgraph, graph_transformation_mgr_,
-                              execution_providers_, kernel_registry_manager_,
-                              insert_cast_transformer_,
-                              session_state_);
-      }));
+      provider_transformers_.clear();
+      if (execution_providers_.Get(kCudaExecutionProvider)) {
+        // place first, so that the nodes moved to CPU aren't converted or fused
+        if (session_options_.enable_cost_based_placement) {
+          PlacementCostModel cost_model;
+          if (!session_options_.placement_profile_file.empty()) {
+            ORT_RETURN_IF_ERROR(cost_model.LoadProfile(session_options_.placement_profile_file));
+          }
+          auto placement_transformer = std::make_unique<CostBasedPlacementTransformer>(
+              "CostBasedPlacementTransformer", kCudaExecutionProvider, std::move(cost_model));
+          placement_transformer->AddKernelRegistries(kernel_registry_manager_.GetAllKernelRegistries());
+          provider_transformers_.push_back(std::move(placement_transformer));
+        }
+        // convert to float16 first so that the converted element-wise nodes are fused too
+        if (session_options_.enable_fp16_mixed_precision) {
+          auto mixed_precision_transformer = std::make_unique<MixedPrecisionTransformer>("MixedPrecisionTransformer",
+                                                                                         kCudaExecutionProvider);
+          mixed_precision_transformer->AddKernelRegistries(kernel_registry_manager_.GetAllKernelRegistries());
+          provider_transformers_.push_back(std::move(mixed_precision_transformer));
+        }
+        if (session_options_.enable_elementwise_fusion) {
+          provider_transformers_.push_back(std::make_unique<ElementwiseFusionTransformer>(
+              "ElementwiseFusionTransformer", kCudaExecutionProvider));
+        }
+      }
+
+      SessionStateInitializer session_initializer{graph, session_state_, execution_providers_,
+                                                  kernel_registry_manager_, model_dir_};
+
+      // a model saved with optimized_model_filepath is already transformed and partitioned, including by the
+      // transformers registered with RegisterGraphTransformer
+      const auto& metadata = model_->MetaData();
+      auto saved_providers = metadata.find(kNodeExecutionProvidersKey);
+      if (saved_providers != metadata.end()) {
+        LOGS(*session_logger_, INFO) << "Loading an optimized model, the graph transformations are skipped.";
+        ORT_RETURN_IF_ERROR(AssignSavedExecutionProviders(graph, saved_providers->second));
+      } else {
+        auto transform_tp = session_profiler_.StartTime();
+        // apply any transformations to the main graph and any subgraphs
+        ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
+                                           execution_providers_, kernel_registry_manager_,
+                                           insert_cast_transformer_,
+                                           provider_transformers_,
+                                           session_state_));
+
+        ORT_RETURN_IF_ERROR(utils::ForAllMutableSubgraphs(graph, [this](Graph& subgraph) {
+          return TransformGraph(subgraph, graph_transformation_mgr_,
+                                execution_providers_, kernel_registry_manager_,
+                                insert_cast_transformer_,
+                                provider_transformers_,
+                                session_state_);
+        }));
+        if (session_profiler_.FEnabled()) {
+          // includes the partitioning
+          session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_transformation", transform_tp);
+        }
+      }
 
       // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
       ORT_RETURN_IF_ERROR(graph.Resolve());
 
+      if (!session_options_.optimized_model_filepath.empty()) {
+        ORT_RETURN_IF_ERROR(SaveOptimizedModel(graph));
+      }
+
+      auto plan_tp = session_profiler_.StartTime();
       ORT_RETURN_IF_ERROR(session_initializer.CreatePlan({}, session_options_.enable_sequential_execution));
+      if (session_profiler_.FEnabled()) {
+        session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "plan_creation", plan_tp);
+      }
       ORT_RETURN_IF_ERROR(session_initializer.InitializeAndSave(session_state_.GetEnableMemoryPattern(),
-                                                                weights_buffers_));
+                                                                weights_buffers_, nullptr,
+                                                                session_options_.share_initializers,
+                                                                session_options_.enable_parallel_initialization));
+
+      // the parallel executor frees the values as their uses are done rather than by the steps of the plan
+      if (session_state_.GetEnableMemoryPattern() && session_options_.enable_sequential_execution) {
+        ORT_RETURN_IF_ERROR(PlanStaticMemoryPatterns(graph));
+      }
+
+      // the parallel executor dispatches the ready nodes on the longest path to the end of the graph first, and runs
+      // the clusters of cheap nodes without a round trip through the thread pool for each
+      if (!session_options_.enable_sequential_execution) {
+        PlacementCostModel cost_model;
+        if (!session_options_.placement_profile_file.empty()) {
+          ORT_RETURN_IF_ERROR(cost_model.LoadProfile(session_options_.placement_profile_file));
+        }
+        session_state_.SetNodePriorities(
+            ParallelExecutor::ComputeNodePriorities(*session_state_.GetGraphViewer(), cost_model));
+        session_state_.SetNodeClusters(
+            ParallelExecutor::ComputeNodeClusters(*session_state_.GetGraphViewer(), cost_model));
+      }
+
+      if (session_options_.enable_metrics) {
+        session_state_.SetMetrics(session_metrics_);
+      }
+      if (session_options_.enable_hardware_counters) {
+        if (HardwareCounters::ForCurrentThread().Available()) {
+          session_state_.SetEnableHardwareCounters(true);
+        } else {
+          LOGS(*session_logger_, WARNING) << "Hardware counters are not available, e.g. due to perf_event_paranoid. "
+                                          << "The nodes are profiled without them.";
+        }
+      }
+      if (session_options_.enable_quantization_calibration) {
+        session_state_.SetCalibration(quantization_calibration_);
+      }
 
       // handle any subgraphs
       ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(graph, session_state_));
 
+      // all the kernels have been created, so the decisions of their autotuning are known
+      if (session_options_.enable_kernel_autotuning && !session_options_.kernel_tuning_cache_file.empty()) {
+        auto status = KernelTuningCache::Instance().Save(session_options_.kernel_tuning_cache_file);
+        if (!status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << status.ErrorMessage();
+        }
+      }
+
+      SelectGraphCaptureProvider(graph);
+
       is_inited_ = true;
 
       LOGS(*session_logger_, INFO) << "Session successfully initialized.";
@@ -393,10 +874,378 @@ class InferenceSession::Impl {
     return status;
   }
 
+  // Graph capture replays the device work of a whole Run, so it is only used when a single provider that
+  // supports it runs every node and no node copies to or from the host.
+  void SelectGraphCaptureProvider(const onnxruntime::Graph& graph) {
+    graph_capture_provider_ = nullptr;
+    for (auto& xp : execution_providers_) {
+      if (!xp->IsGraphCaptureEnabled()) {
+        continue;
+      }
+
+      const auto& provider_type = xp->Type();
+      bool all_nodes_on_provider = true;
+      for (const auto& node : graph.Nodes()) {
+        if (node.GetExecutionProviderType() != provider_type ||
+            node.OpType() == "MemcpyFromHost" || node.OpType() == "MemcpyToHost") {
+          all_nodes_on_provider = false;
+          break;
+        }
+      }
+
+      if (all_nodes_on_provider) {
+        graph_capture_provider_ = xp.get();
+        LOGS(*session_logger_, INFO) << "Graph capture enabled for " << provider_type;
+      } else {
+        LOGS(*session_logger_, WARNING) << "Graph capture is enabled for " << provider_type
+                                        << " but not all nodes are assigned to it. Graph capture is disabled.";
+      }
+      break;
+    }
+  }
+
+  // Plans the memory patterns of a graph whose inputs and values have static shapes ahead of the first Run, which
+  // then doesn't need to trace them. They are cached for the shapes of the graph inputs in their order.
+  common::Status PlanStaticMemoryPatterns(const onnxruntime::Graph& graph) {
+    std::vector<TensorShape> input_shapes;
+    for (const auto* input : graph.GetInputs()) {
+      const auto* shape = input->Shape();
+      if (shape == nullptr) {
+        return Status::OK();
+      }
+      std::vector<int64_t> dims;
+      for (const auto& dim : shape->dim()) {
+        if (!dim.has_dim_value()) {
+          return Status::OK();
+        }
+        dims.push_back(dim.dim_value());
+      }
+      input_shapes.emplace_back(dims);
+    }
+
+    std::unique_ptr<MemoryPatternGroup> mem_patterns;
+    ORT_RETURN_IF_ERROR(GenerateStaticMemPatterns(GraphViewer(graph), *session_state_.GetExecutionPlan(),
+                                                  session_state_.GetMLValueNameIdxMap(), mem_patterns));
+    if (mem_patterns == nullptr) {
+      return Status::OK();
+    }
+
+    for (size_t i = 0; i < mem_patterns->locations.size(); i++) {
+      LOGS(*session_logger_, INFO) << "Planned a memory pattern of " << mem_patterns->patterns[i].PeakSize()
+                                   << " bytes for " << mem_patterns->locations[i].ToString();
+    }
+    return session_state_.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns));
+  }
+
+  // Builds a key from the data addresses and shapes of the feeds and fetches. Returns false if the Run can not
+  // be captured because a feed is not a device tensor of the graph capture provider or a fetch is not
+  // preallocated on that device.
+  bool GetGraphCaptureKey(const NameMLValMap& feeds, const std::vector<MLValue>& fetches,
+                          std::vector<int64_t>& key) const {
+    const OrtAllocatorInfo& device_info = graph_capture_provider_->GetAllocator(0, OrtMemTypeDefault)->Info();
+
+    auto append_tensor = [&key, &device_info](const MLValue& value) {
+      if (!value.IsAllocated() || !value.IsTensor()) {
+        return false;
+      }
+      const auto& tensor = value.Get<Tensor>();
+      if (!(tensor.Location() == device_info)) {
+        return false;
+      }
+      key.push_back(reinterpret_cast<int64_t>(tensor.DataRaw()));
+      const auto& dims = tensor.Shape().GetDims();
+      key.push_back(static_cast<int64_t>(dims.size()));
+      key.insert(key.end(), dims.begin(), dims.end());
+      return true;
+    };
+
+    key.clear();
+    std::map<std::string, const MLValue*> sorted_feeds;
+    for (const auto& feed : feeds) {
+      sorted_feeds[feed.first] = &feed.second;
+    }
+    for (const auto& feed : sorted_feeds) {
+      if (!append_tensor(*feed.second)) {
+        return false;
+      }
+    }
+
+    if (fetches.empty()) {
+      return false;
+    }
+    for (const auto& fetch : fetches) {
+      if (!append_tensor(fetch)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Runs the graph through the graph capture provider. The first Run with a set of feed and fetch buffers
+  // executes normally, which lets kernels finish any one-off setup such as allocating workspace or choosing
+  // algorithms. The second Run with the same buffers is captured, and later Runs with those buffers replay the
+  // captured graph without executing the nodes.
+  common::Status RunWithGraphCapture(const NameMLValMap& feeds,
+                                     const std::vector<std::string>& output_names,
+                                     std::vector<MLValue>& fetches,
+                                     const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                     const RunOptions& run_options,
+                                     const RunTermination& termination,
+                                     const logging::Logger& run_logger) {
+    auto execute_graph = [&](bool sequential_execution) {
+      return utils::ExecuteGraph(session_state_, feeds, output_names, fetches, fetch_allocators,
+                                 sequential_execution, termination, run_logger, run_options.intra_op_thread_limit);
+    };
+    const bool sequential_execution = session_options_.enable_sequential_execution;
+
+    std::lock_guard<OrtMutex> lock(graph_capture_mutex_);
+
+    std::vector<int64_t> key;
+    if (graph_capture_failed_ || !GetGraphCaptureKey(feeds, fetches, key)) {
+      return execute_graph(sequential_execution);
+    }
+
+    if (!graph_captured_key_.empty() && key == graph_captured_key_) {
+      return graph_capture_provider_->ReplayGraph();
+    }
+
+    if (key != graph_warmup_key_) {
+      graph_warmup_key_ = key;
+      return execute_graph(sequential_execution);
+    }
+
+    graph_captured_key_.clear();
+    Status status = graph_capture_provider_->BeginGraphCapture();
+    if (status.IsOK()) {
+      // the nodes run on this thread, whose frees of the device buffers the provider holds for the replays
+      status = execute_graph(true);
+      Status end_status = graph_capture_provider_->EndGraphCapture();
+      if (status.IsOK() && end_status.IsOK()) {
+        graph_captured_key_ = key;
+        return Status::OK();
+      }
+      if (status.IsOK()) {
+        status = end_status;
+      }
+    }
+
+    // nothing was executed while capturing, so run the graph again without capturing
+    LOGS(*session_logger_, WARNING) << "Graph capture failed and is disabled for this session: "
+                                    << status.ErrorMessage();
+    graph_capture_failed_ = true;
+    // a graph that was captured before the Run failed keeps its buffers for replays that won't happen
+    ORT_IGNORE_RETURN_VALUE(graph_capture_provider_->ReleaseGraph());
+    return execute_graph(sequential_execution);
+  }
+
   int GetCurrentNumRuns() const {
     return current_num_runs_.load();
   }
 
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const {
+    return session_state_.GetMemoryPatternCacheStats();
+  }
+
+  common::Status ShrinkMemoryArenas() {
+    // the frames cached for later Runs keep the memory pattern buffers they allocated from the arenas
+    session_state_.ReleaseCachedExecutionFrames();
+    for (const auto& provider : execution_providers_) {
+      if (provider.get() == graph_capture_provider_) {
+        // the captured graph keeps the buffers it uses allocated, so it's released and captured again on a later Run
+        std::lock_guard<OrtMutex> lock(graph_capture_mutex_);
+        graph_captured_key_.clear();
+        graph_warmup_key_.clear();
+        ORT_RETURN_IF_ERROR(provider->ReleaseGraph());
+      }
+      for (const auto& allocator : provider->GetAllocatorMap()) {
+        auto* arena = dynamic_cast<IArenaAllocator*>(allocator.get());
+        if (arena != nullptr) {
+          ORT_RETURN_IF_ERROR(arena->Shrink());
+        }
+      }
+    }
+
+    return Status::OK();
+  }
+
+  common::Status Evict() {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+    if (is_evicted_) {
+      return Status::OK();
+    }
+    if (current_num_runs_ > 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The session can't be evicted while it runs.");
+    }
+
+    ORT_RETURN_IF_ERROR(EvictInitializers(session_state_, weights_buffers_));
+    for (auto& subgraph : subgraph_memory_) {
+      ORT_RETURN_IF_ERROR(EvictInitializers(*subgraph.session_state, subgraph.weights_buffers));
+    }
+    is_evicted_ = true;
+    LOGS(*session_logger_, INFO) << "Evicted " << evicted_initializers_.size() << " device initializers.";
+
+    return ShrinkMemoryArenas();
+  }
+
+  common::Status Restore() {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    return RestoreEvictedInitializers();
+  }
+
+  // copies the evicted initializers back to their devices. the caller holds session_mutex_.
+  common::Status RestoreEvictedInitializers() {
+    if (!is_evicted_) {
+      return Status::OK();
+    }
+
+    // from the back, so that a failure leaves the initializers not restored yet to a later call
+    while (!evicted_initializers_.empty()) {
+      auto& evicted = evicted_initializers_.back();
+      const IExecutionProvider* provider = execution_providers_.Get(evicted.location);
+      auto allocator = utils::GetAllocator(execution_providers_, evicted.location);
+      if (provider == nullptr || allocator == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "No execution provider allocates at ", evicted.location);
+      }
+      const Tensor& host_copy = *evicted.host_copy;
+      void* buffer = host_copy.Size() != 0 ? allocator->Alloc(host_copy.Size()) : nullptr;
+      Tensor device_tensor(host_copy.DataType(), host_copy.Shape(), buffer, evicted.location, allocator);
+      ORT_RETURN_IF_ERROR(provider->CopyTensor(host_copy, device_tensor));
+      *evicted.tensor = std::move(device_tensor);
+      evicted_initializers_.pop_back();
+    }
+    // the copies read the host memory freed once they're done
+    for (const auto& provider : execution_providers_) {
+      ORT_RETURN_IF_ERROR(provider->Sync());
+    }
+
+    is_evicted_ = false;
+    return Status::OK();
+  }
+
+  // copies the initializers of session_state on devices to host memory and frees them on the devices
+  common::Status EvictInitializers(const SessionState& session_state,
+                                   std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers) {
+    const size_t first_evicted = evicted_initializers_.size();
+    for (const auto& entry : session_state.GetInitializedTensors()) {
+      // the copy of the MLValue shares its tensor with the session state, which the kernels read
+      MLValue value = entry.second;
+      if (!value.IsTensor()) {
+        continue;
+      }
+      Tensor& tensor = *value.GetMutable<Tensor>();
+      const OrtAllocatorInfo& location = tensor.Location();
+      if (strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput) {
+        continue;
+      }
+      const IExecutionProvider* provider = execution_providers_.Get(location);
+      if (provider == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "No execution provider allocates at ", location);
+      }
+      void* buffer = tensor.Size() != 0 ? eviction_allocator_->Alloc(tensor.Size()) : nullptr;
+      auto host_copy = std::make_unique<Tensor>(tensor.DataType(), tensor.Shape(), buffer,
+                                                eviction_allocator_->Info(), eviction_allocator_);
+      ORT_RETURN_IF_ERROR(provider->CopyTensor(tensor, *host_copy));
+      evicted_initializers_.push_back({&tensor, location, std::move(host_copy)});
+    }
+    for (const auto& provider : execution_providers_) {
+      ORT_RETURN_IF_ERROR(provider->Sync());
+    }
+
+    // the tensors stay where the kernels look for them, without their memory
+    for (size_t i = first_evicted; i < evicted_initializers_.size(); ++i) {
+      auto& evicted = evicted_initializers_[i];
+      *evicted.tensor = Tensor(evicted.host_copy->DataType(), evicted.host_copy->Shape(), nullptr, evicted.location);
+    }
+    for (auto it = weights_buffers.begin(); it != weights_buffers.end();) {
+      const OrtAllocatorInfo& location = it->first;
+      if (strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput) {
+        ++it;
+      } else {
+        it = weights_buffers.erase(it);
+      }
+    }
+
+    return Status::OK();
+  }
+
+  common::Status GetAllocatorStats(const OrtAllocatorInfo& info, AllocatorStats& stats) const {
+    const auto* provider = execution_providers_.Get(info);
+    IArenaAllocator* arena = nullptr;
+    if (provider != nullptr) {
+      arena = dynamic_cast<IArenaAllocator*>(provider->GetAllocator(info.id, info.mem_type).get());
+    }
+
+    if (arena == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "No arena allocator found for ", info.ToString());
+    }
+
+    arena->GetStats(&stats);
+    return Status::OK();
+  }
+
+  AllocatorPtr GetAllocator(const OrtAllocatorInfo& info) const {
+    const auto* provider = execution_providers_.Get(info);
+    return provider != nullptr ? provider->GetAllocator(info.id, info.mem_type) : nullptr;
+  }
+
+  common::Status GetQuantizationRanges(QuantizationRanges& ranges) const {
+    if (!session_options_.enable_quantization_calibration) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Quantization calibration is not enabled in the session options.");
+    }
+
+    ranges = quantization_calibration_.GetRanges();
+    return Status::OK();
+  }
+
+  common::Status GetResultCacheStats(ResultCache::Stats& stats) const {
+    if (result_cache_ == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The result cache is not enabled in the session options.");
+    }
+
+    stats = result_cache_->GetStats();
+    return Status::OK();
+  }
+
+  common::Status GetMetrics(std::vector<SessionMetrics::OpMetrics>& op_metrics, int64_t& num_arena_extends) const {
+    if (!session_options_.enable_metrics) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Metrics are not enabled in the session options.");
+    }
+
+    op_metrics = session_metrics_.GetOpMetrics();
+    num_arena_extends = 0;
+    for (const auto& provider : execution_providers_) {
+      for (const auto& allocator : provider->GetAllocatorMap()) {
+        auto* arena = dynamic_cast<IArenaAllocator*>(allocator.get());
+        if (arena != nullptr) {
+          AllocatorStats stats;
+          arena->GetStats(&stats);
+          num_arena_extends += stats.num_extends;
+        }
+      }
+    }
+
+    return Status::OK();
+  }
+
+  void LogAllocatorStats() const {
+    for (const auto& provider : execution_providers_) {
+      for (const auto& allocator : provider->GetAllocatorMap()) {
+        auto* arena = dynamic_cast<IArenaAllocator*>(allocator.get());
+        if (arena != nullptr) {
+          AllocatorStats stats;
+          arena->GetStats(&stats);
+          LOGS(*session_logger_, INFO) << "Stats for " << allocator->Info().ToString() << ":\n"
+                                       << stats.DebugString();
+        }
+      }
+    }
+  }
+
   common::Status Run(const NameMLValMap& feeds,
                      const std::vector<std::string>& output_names,
                      std::vector<MLValue>* p_fetches) {
@@ -485,10 +1334,27 @@ class InferenceSession::Impl {
     return Status::OK();
   }
 
+  // the feeds of a session that freezes its input shapes must have the shapes the kernels prepared for
+  common::Status ValidateFrozenInputShapes(const NameMLValMap& feeds) {
+    for (const auto& frozen : frozen_input_shapes_) {
+      auto feed = feeds.find(frozen.first);
+      if (feed == feeds.end() || !feed->second.IsTensor()) {
+        continue;
+      }
+      const auto& shape = feed->second.Get<Tensor>().Shape();
+      if (shape != frozen.second) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The shape ", shape, " of input ", frozen.first,
+                               " is not its frozen shape ", frozen.second);
+      }
+    }
+    return Status::OK();
+  }
+
   common::Status ValidateInputs(const NameMLValMap& feeds) {
     ORT_RETURN_IF_ERROR(ValidateInputNames(feeds));
     //TODO: It should also validate the input shapes?
     ORT_RETURN_IF_ERROR(ValidateInputTypes(feeds));
+    ORT_RETURN_IF_ERROR(ValidateFrozenInputShapes(feeds));
     return Status::OK();
   }
 
@@ -541,36 +1407,254 @@ class InferenceSession::Impl {
   Status Run(const RunOptions& run_options,
              const NameMLValMap& feeds,
              const std::vector<std::string>& output_names,
+             std::vector<MLValue>* p_fetches,
+             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators = {}) {
+    auto validate = [&]() {
+      ORT_RETURN_IF_ERROR(ValidateInputs(feeds));
+      // if the output vector is non-empty, ensure that its the same size as the output_names
+      return ValidateOutputs(output_names, p_fetches);
+    };
+
+    std::unique_ptr<OutputReadyNotifier> output_ready;
+    if (run_options.output_ready_callback) {
+      output_ready = std::make_unique<OutputReadyNotifier>(run_options.output_ready_callback, output_names.size());
+    }
+
+    auto execute = [&](const RunTermination& termination, const logging::Logger& run_logger,
+                       profiling::Profiler* run_profiler) {
+      if (graph_capture_provider_ != nullptr) {
+        return RunWithGraphCapture(feeds, output_names, *p_fetches, fetch_allocators, run_options, termination,
+                                   run_logger);
+      }
+      return utils::ExecuteGraph(session_state_, feeds, output_names, *p_fetches, fetch_allocators,
+                                 session_options_.enable_sequential_execution, termination, run_logger,
+                                 run_options.intra_op_thread_limit, run_profiler, output_ready.get());
+    };
+
+    // the feeds are appended to the key of the result cache in the order of their names
+    std::string cache_key;
+    bool cacheable = IsResultCacheable(p_fetches, fetch_allocators);
+    if (cacheable) {
+      using Feed = NameMLValMap::value_type;
+      std::vector<const Feed*> sorted_feeds;
+      sorted_feeds.reserve(feeds.size());
+      for (const auto& feed : feeds) {
+        sorted_feeds.push_back(&feed);
+      }
+      std::sort(sorted_feeds.begin(), sorted_feeds.end(),
+                [](const Feed* a, const Feed* b) { return a->first < b->first; });
+      for (size_t i = 0; cacheable && i < sorted_feeds.size(); ++i) {
+        cacheable = result_cache_->AppendFeed(sorted_feeds[i]->first, sorted_feeds[i]->second, cache_key);
+      }
+    }
+
+    ORT_RETURN_IF_ERROR(RunWithResultCache(cacheable, cache_key, output_names, *p_fetches,
+                                           [&]() { return RunImpl(run_options, validate, execute); }));
+    // the outputs that weren't final as their nodes finished, and all of those of a cache hit
+    if (output_ready != nullptr) {
+      output_ready->NotifyRemaining(*p_fetches);
+    }
+    return Status::OK();
+  }
+
+  common::Status PrepareRun(const std::vector<std::string>& feed_names,
+                            const std::vector<std::string>& output_names,
+                            std::unique_ptr<PreparedRun>& prepared_run) {
+    ORT_RETURN_IF_ERROR(InitializeIfDeferred());
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_inited_) {
+        LOGS(*session_logger_, ERROR) << "Session was not initialized";
+        return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+      }
+    }
+
+    // the names are validated as a Run with them would validate them
+    NameMLValMap feeds_by_name;
+    for (const auto& name : feed_names) {
+      if (!feeds_by_name.emplace(name, MLValue()).second) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Duplicated input name ", name);
+      }
+    }
+    ORT_RETURN_IF_ERROR(ValidateInputNames(feeds_by_name));
+    std::vector<MLValue> no_fetches;
+    ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, &no_fetches));
+
+    // private constructor, can't use make_unique
+    std::unique_ptr<PreparedRun> prepared{new PreparedRun()};
+    ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names, session_state_,
+                                                    prepared->feeds_fetches_manager_));
+    prepared->feed_types_.reserve(feed_names.size());
+    prepared->frozen_feed_shapes_.reserve(feed_names.size());
+    for (const auto& name : feed_names) {
+      auto arg = std::find_if(input_def_list_.cbegin(), input_def_list_.cend(),
+                              [&name](const NodeArg* input) { return input->Name() == name; });
+      prepared->feed_types_.push_back(utils::GetMLDataType(**arg));
+      auto frozen = frozen_input_shapes_.find(name);
+      prepared->frozen_feed_shapes_.push_back(frozen == frozen_input_shapes_.end() ? nullptr : &frozen->second);
+    }
+
+    prepared_run = std::move(prepared);
+    return Status::OK();
+  }
+
+  Status Run(const RunOptions& run_options,
+             const PreparedRun& prepared_run,
+             const std::vector<MLValue>& feeds,
              std::vector<MLValue>* p_fetches) {
-    auto tp = session_profiler_.StartTime();
-    Status retval = Status::OK();
+    const auto& feeds_fetches_manager = *prepared_run.feeds_fetches_manager_;
 
-    try {
-      {
-        std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
-        if (!is_inited_) {
-          LOGS(*session_logger_, ERROR) << "Session was not initialized";
-          retval = Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    // the names were validated by PrepareRun, which leaves the values
+    auto validate = [&]() {
+      if (feeds.size() != prepared_run.feed_types_.size()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected ", prepared_run.feed_types_.size(),
+                               " feeds. Got ", feeds.size());
+      }
+      if (p_fetches == nullptr) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
+      }
+      const auto& output_names = feeds_fetches_manager.GetOutputNames();
+      if (!p_fetches->empty() && p_fetches->size() != output_names.size()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output vector incorrectly sized: ",
+                               output_names.size(), " outputs were prepared. p_fetches->size(): ",
+                               p_fetches->size());
+      }
+
+      for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+        const auto& feed = feeds[i];
+        const auto expected_type = prepared_run.feed_types_[i];
+        if (!feed.IsTensor()) {
+          ORT_RETURN_IF_ERROR(CheckTypes(feed.Type(), expected_type));
+          continue;
+        }
+
+        const auto& tensor = feed.Get<Tensor>();
+        ORT_RETURN_IF_ERROR(CheckTypes(tensor.DataType(), expected_type->AsTensorType()->GetElementType()));
+        const auto* frozen_shape = prepared_run.frozen_feed_shapes_[i];
+        if (frozen_shape != nullptr && tensor.Shape() != *frozen_shape) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The shape ", tensor.Shape(), " of input ",
+                                 feeds_fetches_manager.GetFeedNames()[i], " is not its frozen shape ",
+                                 *frozen_shape);
         }
       }
+      return Status::OK();
+    };
 
-      ORT_CHECK_AND_SET_RETVAL(ValidateInputs(feeds));
+    std::unique_ptr<OutputReadyNotifier> output_ready;
+    if (run_options.output_ready_callback) {
+      output_ready = std::make_unique<OutputReadyNotifier>(run_options.output_ready_callback,
+                                                           feeds_fetches_manager.GetOutputNames().size());
+    }
 
-      // if the output vector is non-empty, ensure that its the same size as the output_names
-      ORT_CHECK_AND_SET_RETVAL(ValidateOutputs(output_names, p_fetches));
+    auto execute = [&](const RunTermination& termination, const logging::Logger& run_logger,
+                       profiling::Profiler* run_profiler) {
+      const std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+      if (graph_capture_provider_ != nullptr) {
+        NameMLValMap feeds_by_name;
+        const auto& feed_names = feeds_fetches_manager.GetFeedNames();
+        for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+          feeds_by_name[feed_names[i]] = feeds[i];
+        }
+        return RunWithGraphCapture(feeds_by_name, feeds_fetches_manager.GetOutputNames(), *p_fetches,
+                                   fetch_allocators, run_options, termination, run_logger);
+      }
+      return utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, *p_fetches, fetch_allocators,
+                                 session_options_.enable_sequential_execution, termination, run_logger,
+                                 run_options.intra_op_thread_limit, run_profiler, output_ready.get());
+    };
+
+    // the feeds are appended to the key of the result cache in the order they were prepared in
+    std::string cache_key;
+    bool cacheable = IsResultCacheable(p_fetches, {}) && feeds.size() == prepared_run.feed_types_.size();
+    const auto& feed_names = feeds_fetches_manager.GetFeedNames();
+    for (size_t i = 0; cacheable && i < feeds.size(); ++i) {
+      cacheable = result_cache_->AppendFeed(feed_names[i], feeds[i], cache_key);
+    }
+
+    ORT_RETURN_IF_ERROR(RunWithResultCache(cacheable, cache_key, feeds_fetches_manager.GetOutputNames(), *p_fetches,
+                                           [&]() { return RunImpl(run_options, validate, execute); }));
+    if (output_ready != nullptr) {
+      output_ready->NotifyRemaining(*p_fetches);
+    }
+    return Status::OK();
+  }
+
+  // whether a Run that outputs to fetches may be looked up in the result cache. the fetches of a hit are allocated
+  // by the cache, so not when the caller provides them.
+  bool IsResultCacheable(const std::vector<MLValue>* p_fetches,
+                         const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const {
+    return result_cache_ != nullptr && p_fetches != nullptr && p_fetches->empty() && fetch_allocators.empty();
+  }
+
+  // a Run that returns the cached fetches of the key, if there are, instead of calling run(), whose fetches are
+  // cached if it succeeds. a Run whose key is cached succeeded with the same feeds, so they are valid.
+  template <typename TRun>
+  Status RunWithResultCache(bool cacheable, std::string& cache_key, const std::vector<std::string>& output_names,
+                            std::vector<MLValue>& fetches, TRun run) {
+    if (!cacheable) {
+      return run();
+    }
 
+    ResultCache::AppendOutputNames(output_names, cache_key);
+    if (result_cache_->Find(cache_key, fetches)) {
+      return Status::OK();
+    }
+
+    ORT_RETURN_IF_ERROR(run());
+    result_cache_->Insert(cache_key, fetches);
+    return Status::OK();
+  }
+
+  // a Run around the calls to validate() its arguments and to execute(termination, run_logger, run_profiler) the
+  // graph, which return the Status of each
+  template <typename TValidate, typename TExecute>
+  Status RunImpl(const RunOptions& run_options, TValidate validate, TExecute execute) {
+    // the deadline of the Run counts from its start, including any initialization it does
+    const RunTermination termination(run_options.terminate, run_options.timeout_ms);
+    ORT_RETURN_IF_ERROR(InitializeIfDeferred());
+    // the Run is counted under the lock Evict checks the count with, so the session isn't evicted until it ends
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_inited_) {
+        LOGS(*session_logger_, ERROR) << "Session was not initialized";
+        return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+      }
+      ORT_RETURN_IF_ERROR(RestoreEvictedInitializers());
+      ++current_num_runs_;
+    }
+
+    auto tp = session_profiler_.StartTime();
+    Status retval = Status::OK();
+
+    // a sampled Run is profiled on its own, to a file named after the Run
+    std::unique_ptr<profiling::Profiler> run_profiler;
+    const auto run_number = ++num_runs_;
+    if (run_options.profiling_sampling_interval > 0 && run_number % run_options.profiling_sampling_interval == 0) {
+      std::ostringstream ss;
+      ss << run_options.profile_file_prefix << "_";
       if (!run_options.run_tag.empty()) {
-        LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
+        ss << run_options.run_tag << "_";
       }
+      ss << run_number << ".json";
+      run_profiler = std::make_unique<profiling::Profiler>();
+      run_profiler->Initialize(session_logger_);
+      run_profiler->StartProfiling(ss.str());
+      tp = run_profiler->StartTime();
+    }
 
-      ++current_num_runs_;
+    try {
+      ORT_CHECK_AND_SET_RETVAL(validate());
+
+      if (!run_options.run_tag.empty()) {
+        LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
+      }
 
       // TODO should we add this exec to the list of executors? i guess its not needed now?
 
       // scope of owned_run_logger is just the call to Execute.
       // If Execute ever becomes async we need a different approach
       std::unique_ptr<logging::Logger> owned_run_logger;
-      auto run_logger = CreateLoggerForRun(run_options, owned_run_logger);
+      const auto& run_logger = CreateLoggerForRun(run_options, owned_run_logger);
 
       // info all execution providers InferenceSession:Run started
       // TODO: only call OnRunStart for all providers in-use
@@ -578,9 +1662,14 @@ class InferenceSession::Impl {
         ORT_CHECK_AND_SET_RETVAL(xp->OnRunStart());
       }
 
-      ORT_CHECK_AND_SET_RETVAL(
-          utils::ExecuteGraph(session_state_, feeds, output_names, *p_fetches, {},
-                              session_options_.enable_sequential_execution, run_options.terminate, run_logger));
+      // cap the intra-op threads used by kernels run on this thread. the parallel executor applies the same
+      // limit to the nodes it runs on the thread pool.
+      utils::ScopedIntraOpThreadLimit thread_limit(run_options.intra_op_thread_limit);
+      utils::ScopedIntraOpThreadPool numa_thread_pool(numa_thread_pool_.get());
+      // the thread pool tasks of the Run, and the tasks they submit in turn, are queued with its priority
+      TaskThreadPool::ScopedPriority priority(run_options.priority);
+
+      ORT_CHECK_AND_SET_RETVAL(execute(termination, run_logger, run_profiler.get()));
     } catch (const std::exception& e) {
       retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
     } catch (...) {
@@ -595,9 +1684,134 @@ class InferenceSession::Impl {
     if (session_profiler_.FEnabled()) {
       session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
     }
+
+    if (run_profiler != nullptr) {
+      run_profiler->EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp,
+                                          {{"run_tag", run_options.run_tag}});
+      LOGS(*session_logger_, INFO) << "Wrote the profile of the Run to " << run_profiler->EndProfiling();
+    }
+
+    if (session_options_.allocator_stats_log_interval > 0 &&
+        ++num_runs_since_stats_logged_ % session_options_.allocator_stats_log_interval == 0) {
+      LogAllocatorStats();
+    }
+
     return retval;
   }
 
+  common::Status RunAsync(const RunOptions& run_options,
+                          const NameMLValMap& feeds,
+                          const std::vector<std::string>& output_names,
+                          InferenceSession::RunAsyncCallback callback) {
+    if (!callback) {
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "RunAsync requires a callback.");
+    }
+
+    TaskThreadPool* thread_pool = nullptr;
+#ifndef USE_EIGEN_THREADPOOL
+    thread_pool = session_state_.GetThreadPool();
+#endif
+    if (thread_pool == nullptr) {
+      thread_pool = Environment::GetIntraOpThreadPool();
+    }
+
+    if (thread_pool == nullptr) {
+      return Status(common::ONNXRUNTIME, common::FAIL, "No thread pool is available to run the session on.");
+    }
+
+    // owned by the scheduled task
+    struct AsyncRun {
+      NameMLValMap feeds;
+      std::vector<std::string> output_names;
+      std::vector<MLValue> fetches;
+      InferenceSession::RunAsyncCallback callback;
+    };
+
+    auto async_run = std::make_shared<AsyncRun>();
+    async_run->feeds = feeds;
+    async_run->output_names = output_names;
+    async_run->callback = std::move(callback);
+
+    {
+      std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+      ++num_async_runs_;
+    }
+
+    thread_pool->Schedule([this, &run_options, async_run]() {
+      Status status = Run(run_options, async_run->feeds, async_run->output_names, &async_run->fetches);
+      if (!status.IsOK()) {
+        async_run->fetches.clear();
+      }
+
+      async_run->callback(status, async_run->fetches);
+
+      std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+      if (--num_async_runs_ == 0) {
+        async_runs_cv_.notify_all();
+      }
+    });
+
+    return Status::OK();
+  }
+
+  common::Status Warmup(bool in_background) {
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_model_loaded_) {
+        LOGS(*session_logger_, ERROR) << "Model was not loaded";
+        return common::Status(common::ONNXRUNTIME, common::FAIL, "Model was not loaded.");
+      }
+    }
+
+    // on the CPU, from where Run copies them to the devices of the nodes
+    auto allocator = std::make_shared<CPUAllocator>();
+    NameMLValMap feeds;
+    for (const auto* input : required_input_def_list_) {
+      const auto* type = input->TypeAsProto();
+      if (type == nullptr || !type->has_tensor_type()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Can not warm up the session with a value for input ",
+                               input->Name(), " as it isn't a tensor.");
+      }
+      std::vector<int64_t> dims;
+      const auto* shape = input->Shape();
+      if (shape != nullptr) {
+        for (const auto& dim : shape->dim()) {
+          dims.push_back(dim.has_dim_value() ? dim.dim_value() : 1);
+        }
+      }
+      auto element_type = DataTypeImpl::TypeFromProto(*type)->AsTensorType()->GetElementType();
+      TensorShape tensor_shape(dims);
+      const size_t size = static_cast<size_t>(tensor_shape.Size()) * element_type->Size();
+      void* buffer = size != 0 ? allocator->Alloc(size) : nullptr;
+      // the Tensor constructs the strings of a string tensor
+      if (buffer != nullptr && element_type != DataTypeImpl::GetType<std::string>()) {
+        memset(buffer, 0, size);
+      }
+      auto tensor = std::make_unique<Tensor>(element_type, tensor_shape, buffer, allocator->Info(), allocator);
+      MLValue value;
+      value.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+      feeds.insert({input->Name(), value});
+    }
+
+    std::vector<std::string> output_names;
+    for (const auto* output : output_def_list_) {
+      output_names.push_back(output->Name());
+    }
+
+    if (!in_background) {
+      std::vector<MLValue> fetches;
+      return Run(warmup_run_options_, feeds, output_names, &fetches);
+    }
+
+    const auto* logger = session_logger_;
+    return RunAsync(warmup_run_options_, feeds, output_names,
+                    [logger](const common::Status& status, std::vector<MLValue>&) {
+                      if (!status.IsOK()) {
+                        LOGS(*logger, WARNING) << "The warm-up of the session failed: " << status.ErrorMessage();
+                      }
+                    });
+  }
+
   std::pair<common::Status, const ModelMetadata*> GetModelMetadata() const {
     {
       std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
@@ -638,6 +1852,7 @@ class InferenceSession::Impl {
   }
 
   common::Status NewIOBinding(std::unique_ptr<IOBinding>* io_binding) {
+    ORT_RETURN_IF_ERROR(InitializeIfDeferred());
     {
       std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
       if (!is_inited_) {
@@ -654,7 +1869,11 @@ class InferenceSession::Impl {
   common::Status Run(const RunOptions& run_options, IOBinding& io_binding) {
     // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
     // io_binding.SynchronizeInputs();
-    return Run(run_options, io_binding.feeds_, io_binding.output_names_, &io_binding.outputs_);
+    std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+    ORT_RETURN_IF_ERROR(io_binding.CreateOutputAllocators(fetch_allocators));
+    ORT_RETURN_IF_ERROR(Run(run_options, io_binding.feeds_, io_binding.output_names_, &io_binding.outputs_,
+                            fetch_allocators));
+    return io_binding.CopyOutputsToBoundDevices();
   }
 
   common::Status Run(IOBinding& io_binding) {
@@ -744,6 +1963,15 @@ class InferenceSession::Impl {
                                             std::unique_ptr<logging::Logger>& new_run_logger) {
     const logging::Logger* run_logger;
 
+    // the logger of the runs without a tag or a verbosity of their own is the same for every run, so it's created
+    // once rather than per run
+    if (logging_manager_ != nullptr && run_options.run_tag.empty() && run_options.run_log_verbosity_level <= 0) {
+      std::call_once(untagged_run_logger_flag_, [this]() {
+        untagged_run_logger_ = logging_manager_->CreateLogger(session_options_.session_logid);
+      });
+      return *untagged_run_logger_;
+    }
+
     // create a per-run logger if we can
     if (logging_manager_ != nullptr) {
       std::string run_log_id{session_options_.session_logid};
@@ -821,9 +2049,22 @@ class InferenceSession::Impl {
   /// convenience pointer to logger. should always be the same as session_state_.Logger();
   const logging::Logger* session_logger_;
 
+  /// Logger of the runs without a run tag or verbosity, created by the first of them.
+  std::unique_ptr<logging::Logger> untagged_run_logger_;
+  std::once_flag untagged_run_logger_flag_;
+
   // Profiler for this session.
   profiling::Profiler session_profiler_;
 
+  // The counters the executors update when SessionOptions::enable_metrics is set.
+  SessionMetrics session_metrics_;
+
+  // The ranges the executors record when SessionOptions::enable_quantization_calibration is set.
+  QuantizationCalibration quantization_calibration_;
+
+  // The fetches of the recent Runs when SessionOptions::enable_result_cache is set.
+  std::unique_ptr<ResultCache> result_cache_;
+
   ExecutionProviders execution_providers_;
 
   KernelRegistryManager kernel_registry_manager_;
@@ -835,6 +2076,10 @@ class InferenceSession::Impl {
   // unique_ptr for maximum flexibility. Client can always upgrade it to shared_ptr
   // if they need.
   std::shared_ptr<onnxruntime::Model> model_;
+  // the directory of the model file, empty for models loaded from a proto or a stream
+  std::string model_dir_;
+  // loads the model file of this session into another one, empty for models loaded from a proto or a stream
+  std::function<common::Status(InferenceSession&)> reload_model_;
 
   // A set of executors that can run in parallel.
   std::vector<std::unique_ptr<IExecutor>> executors_;  // TODO do we need this vector?
@@ -852,13 +2097,19 @@ class InferenceSession::Impl {
   std::unordered_set<std::string> model_input_names_;
   std::unordered_set<std::string> model_output_names_;
 
+  // the shapes every Run must feed the required inputs with if the session freezes its input shapes
+  std::unordered_map<std::string, TensorShape> frozen_input_shapes_;
+
   // Environment for this session
   // not used now; we'll need it when we introduce threadpool
   // statically allocated pointer, no need to manage its lifetime.
   //Env* env_;
 
-  // Threadpool for this session
-  //thread::ThreadPool thread_pool_; // not used for now; will add it later when implementing RunAsync
+  // The intra-op thread pool pinned to SessionOptions::numa_node, which is used in place of the Environment's pool.
+  std::unique_ptr<TaskThreadPool> numa_thread_pool_;
+
+  // Threadpool owned by this session if one was requested via session_thread_pool_size.
+  // Otherwise the session uses the Environment's intra-op thread pool.
 #ifdef USE_EIGEN_THREADPOOL
   std::unique_ptr<Eigen::NonBlockingThreadPool> thread_pool_;
 #else
@@ -869,15 +2120,52 @@ class InferenceSession::Impl {
   std::atomic<int>
       current_num_runs_;
 
+  // Number of started Runs, for RunOptions::profiling_sampling_interval
+  std::atomic<uint64_t> num_runs_{0};
+
+  // Number of completed Runs, for SessionOptions::allocator_stats_log_interval
+  std::atomic<int64_t> num_runs_since_stats_logged_{0};
+
+  // Number of RunAsync calls that have been scheduled but not yet completed
+  OrtMutex async_runs_mutex_;
+  OrtCondVar async_runs_cv_;
+  int num_async_runs_ = 0;  // GUARDED_BY(async_runs_mutex_)
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
+  // whether Initialize left the initialization to the first Run, for SessionOptions::lazy_initialization
+  bool is_initialization_deferred_ = false;  // GUARDED_BY(session_mutex_)
+
+  // the Runs of Warmup, which outlive the RunAsync it schedules
+  RunOptions warmup_run_options_;
+
+  // the initializers on devices of an evicted session, whose memory is freed, and their copies in host memory
+  struct EvictedInitializer {
+    // the tensor of the session state, which the kernels read
+    Tensor* tensor;
+    OrtAllocatorInfo location;
+    std::unique_ptr<Tensor> host_copy;
+  };
+  std::vector<EvictedInitializer> evicted_initializers_;  // GUARDED_BY(session_mutex_)
+  std::atomic<bool> is_evicted_{false};
+  // not the CPU arena, which the eviction shrinks
+  AllocatorPtr eviction_allocator_ = std::make_shared<CPUAllocator>();
 
   std::map<OrtAllocatorInfo, BufferUniquePtr> weights_buffers_;
   InsertCastTransformer insert_cast_transformer_;
+  // transformers for the nodes assigned to a specific execution provider, applied in order after partitioning
+  std::vector<std::unique_ptr<GraphTransformer>> provider_transformers_;
 
   // memory allocations for any subgraphs
   std::vector<SubgraphMemory> subgraph_memory_;
+
+  // provider that captures and replays the device work of a Run. null when graph capture is not used.
+  IExecutionProvider* graph_capture_provider_ = nullptr;
+  OrtMutex graph_capture_mutex_;
+  std::vector<int64_t> graph_warmup_key_;    // GUARDED_BY(graph_capture_mutex_)
+  std::vector<int64_t> graph_captured_key_;  // GUARDED_BY(graph_capture_mutex_)
+  bool graph_capture_failed_ = false;        // GUARDED_BY(graph_capture_mutex_)
 };  // namespace onnxruntime
 
 //
@@ -919,6 +2207,31 @@ common::Status InferenceSession::Run(const RunOptions& run_options,
   return impl_->Run(run_options, feeds, output_names, p_fetches);
 }
 
+common::Status InferenceSession::PrepareRun(const std::vector<std::string>& feed_names,
+                                            const std::vector<std::string>& output_names,
+                                            std::unique_ptr<PreparedRun>& prepared_run) {
+  ORT_RETURN_IF_ERROR(impl_->PrepareRun(feed_names, output_names, prepared_run));
+  prepared_run->session_ = this;
+  return Status::OK();
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options,
+                                     const PreparedRun& prepared_run,
+                                     const std::vector<MLValue>& feeds,
+                                     std::vector<MLValue>* p_fetches) {
+  if (prepared_run.session_ != this) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "The run was prepared by another session.");
+  }
+  return impl_->Run(run_options, prepared_run, feeds, p_fetches);
+}
+
+common::Status InferenceSession::RunAsync(const RunOptions& run_options,
+                                          const NameMLValMap& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          RunAsyncCallback callback) {
+  return impl_->RunAsync(run_options, feeds, output_names, std::move(callback));
+}
+
 std::pair<common::Status, const ModelMetadata*> InferenceSession::GetModelMetadata() const {
   return impl_->GetModelMetadata();
 }
@@ -935,6 +2248,48 @@ int InferenceSession::GetCurrentNumRuns() {
   return impl_->GetCurrentNumRuns();
 }
 
+MemoryPatternCacheStats InferenceSession::GetMemoryPatternCacheStats() const {
+  return impl_->GetMemoryPatternCacheStats();
+}
+
+common::Status InferenceSession::Evict() {
+  return impl_->Evict();
+}
+
+common::Status InferenceSession::Restore() {
+  return impl_->Restore();
+}
+
+common::Status InferenceSession::ShrinkMemoryArenas() {
+  return impl_->ShrinkMemoryArenas();
+}
+
+common::Status InferenceSession::GetAllocatorStats(const OrtAllocatorInfo& info, AllocatorStats& stats) const {
+  return impl_->GetAllocatorStats(info, stats);
+}
+
+common::Status InferenceSession::GetMetrics(std::vector<SessionMetrics::OpMetrics>& op_metrics,
+                                            int64_t& num_arena_extends) const {
+  return impl_->GetMetrics(op_metrics, num_arena_extends);
+}
+
+common::Status InferenceSession::GetResultCacheStats(ResultCache::Stats& stats) const {
+  return impl_->GetResultCacheStats(stats);
+}
+
+common::Status InferenceSession::Specialize(const NameMLValMap& constant_inputs,
+                                            std::unique_ptr<InferenceSession>& specialized) const {
+  return impl_->Specialize(constant_inputs, specialized);
+}
+
+common::Status InferenceSession::GetQuantizationRanges(QuantizationRanges& ranges) const {
+  return impl_->GetQuantizationRanges(ranges);
+}
+
+AllocatorPtr InferenceSession::GetAllocator(const OrtAllocatorInfo& info) const {
+  return impl_->GetAllocator(info);
+}
+
 void InferenceSession::StartProfiling(const std::string& file_prefix) {
   impl_->StartProfiling(file_prefix);
 }
@@ -967,6 +2322,10 @@ common::Status InferenceSession::Load(std::unique_ptr<ModelProto> p_model_proto)
   return impl_->Load(std::move(p_model_proto));
 }
 
+common::Status InferenceSession::Warmup(bool in_background) {
+  return impl_->Warmup(in_background);
+}
+
 common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_binding) {
   return impl_->NewIOBinding(io_binding);
 }
@@ -3,13 +3,20 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
 #include "core/common/common.h"
 #include "core/common/status.h"
+#include "core/framework/arena.h"
 #include "core/framework/framework_common.h"
+#include "core/framework/quantization_calibration.h"
+#include "core/framework/result_cache.h"
+#include "core/framework/session_metrics.h"
+#include "core/framework/weight_compression.h"
 #include "core/graph/basic_types.h"
+#include "core/graph/transformer_level.h"
 #include "core/common/logging/logging.h"
 
 namespace onnxruntime {  // forward declarations
@@ -23,6 +30,7 @@ class ModelProto;
 namespace onnxruntime {
 class IExecutionProvider;  // forward decl
 class IOBinding;
+class PreparedRun;
 
 class CustomRegistry;
 
@@ -46,11 +54,51 @@ struct SessionOptions {
   // with a big chunk for all the internal memory allocation.
   bool enable_mem_pattern = true;
 
+  // maximum number of memory patterns to cache. the least recently used pattern is evicted when the cache is full.
+  // 0 for no limit.
+  size_t mem_pattern_cache_capacity = 0;
+
+  // ascending boundaries each input dimension is rounded up to when caching memory patterns, so that inputs with
+  // similar shapes (e.g. variable sequence lengths) share a pattern. dimensions larger than the last boundary are
+  // used as is. empty to cache a pattern for each distinct set of input shapes.
+  std::vector<int64_t> mem_pattern_dim_buckets;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // growth and size limits of the CPU memory arena.
+  // applies to the CPU execution provider the session creates if one isn't registered.
+  ArenaConfig cpu_arena_config;
+
+  // log the statistics of every memory arena used by the session at INFO level after this many Runs.
+  // 0 to disable.
+  int allocator_stats_log_interval = 0;
+
+  // count the calls and the time of the nodes of each op type for every Run, to be read with
+  // InferenceSession::GetMetrics.
+  bool enable_metrics = false;
+
+  // count the cycles, instructions, last level cache misses and data TLB misses of the thread that computes each
+  // node, with perf_event on Linux, and add them to its kernel event in the profile and to the metrics.
+  // the work a kernel hands to the threads of a thread pool is not counted.
+  bool enable_hardware_counters = false;
+
+  // return the fetches of a recent Run with the same feeds and outputs instead of running the graph again, for
+  // models whose outputs only depend on their inputs. see ResultCache for the Runs that are cached.
+  bool enable_result_cache = false;
+  ResultCacheConfig result_cache_config;
+
+  // record the range of the float inputs and outputs of the Conv, MatMul and Gemm nodes over every Run, to be read
+  // with InferenceSession::GetQuantizationRanges once the session has run on representative sample data.
+  bool enable_quantization_calibration = false;
+
+  // if not empty, rewrite the Conv, MatMul and Gemm nodes whose input and output have a range into QLinearConv and
+  // QLinearMatMul nodes that run on uint8 values quantized from the ranges, e.g. the ranges of a calibration session.
+  // the calibration session must use the same graph_optimization_level, so the nodes keep their names.
+  QuantizationRanges quantization_ranges;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::string profile_file_prefix = "onnxruntime_profile_";
 
@@ -59,8 +107,98 @@ struct SessionOptions {
 
   unsigned max_num_graph_transformation_steps = 5;  // TODO choose a good default here?
 
-  // How many threads in the session thread pool.
+  // the built-in graph transformations applied before the ones registered with RegisterGraphTransformer.
+  // see TransformerLevel for what each level does.
+  TransformerLevel graph_optimization_level = TransformerLevel::Extended;
+
+  // if not empty, Initialize writes the model to this file once it is transformed and partitioned, with the
+  // execution provider of each node. a session that loads the file assigns the nodes to the same providers, which
+  // must be registered with it, and skips the graph transformations.
+  // models with subgraphs or with nodes compiled by an execution provider can not be saved.
+  std::string optimized_model_filepath;
+
+  // run the float MatMul, Gemm and Conv nodes assigned to the CUDA execution provider, and the element-wise ops
+  // that follow them, in float16. numerically sensitive ops such as Softmax and reductions stay in float.
+  bool enable_fp16_mixed_precision = false;
+
+  // move the nodes assigned to the CUDA execution provider to CPU where a cost model of their kernels and of the
+  // copies between CPU and device memory estimates that it saves time, e.g. the small shape computations of a graph.
+  bool enable_cost_based_placement = false;
+
+  // a profile a session of the same model wrote with enable_profiling, to calibrate the kernel times of the cost
+  // model with, which the placement and the priorities of the nodes of the parallel executor use. empty for the
+  // default costs.
+  std::string placement_profile_file;
+
+  // replace chains of element-wise nodes assigned to the CUDA execution provider with a single fused kernel,
+  // so that the intermediate tensors are not written to and read back from device memory.
+  bool enable_elementwise_fusion = false;
+
+  // share the CPU buffers of the initializers with the other sessions in the process that enable this and load the
+  // same initializer data, e.g. replicas of a model per NUMA node. the buffers are freed with the last session that
+  // uses them. the CPU kernels must not write to their initializers.
+  bool share_initializers = false;
+
+  // deserialize the initializers and create the kernels on the session thread pool when the session is initialized.
+  // the constructors of the kernels, including the ones of custom ops, run concurrently and must be thread-safe.
+  bool enable_parallel_initialization = false;
+
+  // every Run feeds the graph inputs with fixed shapes: the shapes the model declares, or the ones in
+  // frozen_input_shapes for the inputs the model declares with symbolic dimensions. shape inference propagates them
+  // through the graph when the session is initialized, so that the kernels prepare for the shapes of their inputs
+  // once, e.g. Conv prepares its MLAS convolution. Run fails for feeds of other shapes.
+  bool freeze_input_shapes = false;
+  std::unordered_map<std::string, std::vector<int64_t>> frozen_input_shapes;
+
+  // inputs of the model bound to fixed values when the session is initialized, which become initializers of the
+  // graph. constant folding then computes the nodes that only depend on them and the initializers once, and the plan
+  // and the kernels are made for the rest. Runs can't feed them, and GetModelInputs no longer lists them.
+  // the values must be tensors in CPU memory, and are copied.
+  NameMLValMap constant_inputs;
+
+  // how the float MatMul and Gemm kernels store a constant B: as float16, or as int8 with a scale for each output
+  // channel. they convert each panel of B to float as MLAS packs it, which reads fewer bytes of memory for B at the
+  // cost of approximating the product. see WeightCompression.
+  WeightCompression weight_compression = WeightCompression::kNone;
+
+  // the kernels that have several implementations for the frozen shapes of their inputs time them when they are
+  // created and keep the fastest, e.g. Conv times the MLAS convolution algorithms. the decisions are kept for the
+  // process in KernelTuningCache, keyed by the problem and the CPU, so later sessions don't time them again.
+  bool enable_kernel_autotuning = false;
+
+  // a file the decisions of enable_kernel_autotuning are loaded from when the session is initialized and saved to
+  // once its kernels are created, so that later processes on the same host reuse them. empty for the process only.
+  std::string kernel_tuning_cache_file;
+
+  // How many threads in the session thread pool used by the parallel executor.
+  // 0 shares the process-wide intra-op thread pool owned by the Environment.
   int session_thread_pool_size = 0;
+
+  // the NUMA node the session runs on, or -1 for any. the session runs its intra-op work, and its nodes unless
+  // session_thread_pool_size is set, on a pool of its own with a thread pinned to each CPU of the node, in place of
+  // the process-wide intra-op pool. the arena of the default CPU execution provider is allocated on the node.
+  int numa_node = -1;
+
+  // whether the default CPU execution provider allocates the regions of its arena, and so the initializers and
+  // tensors in them, on huge pages. the regions are allocated on regular pages if the OS has no huge pages to give.
+  bool enable_cpu_huge_pages = false;
+
+  // allocators of the application, e.g. memory pools it shares with other sessions and frameworks, which the
+  // execution providers allocate from in place of their own allocators at the name, id and mem_type of their Info().
+  // the session puts an arena over those of type OrtArenaAllocator and uses those of type OrtDeviceAllocator as they
+  // are. they, and their Info(), must outlive the session.
+  std::vector<OrtAllocator*> custom_allocators;
+
+  // whether the CPU memory of the session is allocated from the process-wide CPU arena of the Environment, in place
+  // of an arena of its own, so that the memory the idle sessions of a process have freed is used by the others.
+  // shared_cpu_arena_max_mem limits the bytes the session has in use in it, unless it's 0.
+  bool use_shared_cpu_arena = false;
+  size_t shared_cpu_arena_max_mem = 0;
+
+  // whether Initialize leaves the partitioning, the creation of the kernels and the loading of the initializers to
+  // the first Run, Warmup or NewIOBinding, e.g. for the rarely used models of a host of many. Initialize then
+  // succeeds for a model the session can't run, and the first Run fails.
+  bool lazy_initialization = false;
 };
 
 /**
@@ -196,6 +334,59 @@ class InferenceSession {
                      const std::vector<std::string>& output_names,
                      std::vector<MLValue>* p_fetches);
 
+  /**
+    * Validate feed_names and output_names and resolve them once, for Runs that always feed and fetch the same
+    * names, such as those of a server. See PreparedRun.
+    * @param prepared_run set to the prepared names. It must not outlive this session.
+    * @return OK if success, INVALID_ARGUMENT if a name isn't valid for a Run or a required input is missing.
+    */
+  common::Status PrepareRun(const std::vector<std::string>& feed_names,
+                            const std::vector<std::string>& output_names,
+                            std::unique_ptr<PreparedRun>& prepared_run);
+
+  /**
+    * Run with the names of prepared_run, without looking up or validating them by name.
+    * @param feeds in the order of the feed names of prepared_run.
+    * @param p_fetches output values in the order of the output names of prepared_run. Empty to allocate them.
+    */
+  common::Status Run(const RunOptions& run_options,
+                     const PreparedRun& prepared_run,
+                     const std::vector<MLValue>& feeds,
+                     std::vector<MLValue>* p_fetches);
+
+  /**
+    * Callback invoked when a RunAsync call completes.
+    * @param status the result of the Run.
+    * @param fetches output values in the order specified by output_names. Empty if status is not OK.
+    */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<MLValue>& fetches)>;
+
+  /**
+    * Schedule a Run on the session's thread pool (or the Environment's intra-op thread pool if the session has
+    * none) and return without waiting for it to complete. callback is invoked on a pool thread once it has.
+    * @param run_options must remain valid until callback is invoked. Setting terminate cancels the Run.
+    * @param feeds named inputs. The buffers they reference must remain valid until callback is invoked.
+    * @param output_names output names
+    * @param callback must not throw, and must not destroy this session.
+    * @return OK if the Run was scheduled. Errors from the Run itself are reported to callback.
+    * @note the destructor waits for any RunAsync calls that are still in progress.
+    */
+  common::Status RunAsync(const RunOptions& run_options,
+                          const NameMLValMap& feeds,
+                          const std::vector<std::string>& output_names,
+                          RunAsyncCallback callback);
+
+  /**
+    * Run the session once with inputs of zeros, of the shapes the model declares with 1 for their symbolic
+    * dimensions and on all its outputs, so that the first Run of a request doesn't pay for the initialization
+    * deferred by SessionOptions::lazy_initialization, the growth of the arenas or the creation of the device
+    * primitives the kernels cache.
+    * @param in_background schedule the Run as RunAsync does and return without waiting for it. Its failure, e.g.
+    *        for an input of zeros the model doesn't accept, is logged.
+    * @return the result of the Run, or if in_background whether it was scheduled.
+    */
+  common::Status Warmup(bool in_background = false);
+
   /**
   * Creates a new binding object for binding inputs and outputs.
   * @param provider_type specifies the location where the inputs need to be potentially copied. 
@@ -232,6 +423,79 @@ class InferenceSession {
     */
   int GetCurrentNumRuns();
 
+  /**
+    * Get the hit, miss and eviction counts for the memory pattern cache of the main graph.
+    */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
+  /**
+    * Return the memory held by the arenas of the session's execution providers that isn't in use
+    * to the devices. The arenas grow again if later Runs need the memory.
+    * Note that execution providers may be shared with other sessions, in which case their arenas are too.
+    */
+  common::Status ShrinkMemoryArenas();
+
+  /**
+    * Free the memory of an idle session, e.g. one of the many a host keeps registered but rarely runs, keeping its
+    * optimized graph, plan and kernels. The initializers on devices are copied to host memory and freed on the
+    * devices, and the arenas are shrunk. The initializers on the CPU stay where they are; those with external data
+    * are read from the mapped files, whose pages the OS can reclaim.
+    * Must not be called while the session runs.
+    */
+  common::Status Evict();
+
+  /**
+    * Copy the initializers of an evicted session back to their devices. The first Run of an evicted session does
+    * so if this isn't called before.
+    */
+  common::Status Restore();
+
+  /**
+    * Get the statistics of the memory arena for an allocator used by the session.
+    * @param info location of the arena, e.g. OrtAllocatorInfo(CPU, OrtArenaAllocator) for the CPU arena.
+    * @return INVALID_ARGUMENT if no execution provider of the session has an arena allocator for info.
+    */
+  common::Status GetAllocatorStats(const OrtAllocatorInfo& info, AllocatorStats& stats) const;
+
+  /**
+    * Get a snapshot of the metrics of the session, which may be taken while it runs.
+    * @param op_metrics the counters of the nodes of each op type the session has run.
+    * @param num_arena_extends the number of regions the memory arenas of the session have allocated from the device.
+    * @return FAIL if SessionOptions::enable_metrics isn't set.
+    */
+  common::Status GetMetrics(std::vector<SessionMetrics::OpMetrics>& op_metrics, int64_t& num_arena_extends) const;
+
+  /**
+    * Get the hits and misses of the result cache of the session, and what it holds.
+    * @return FAIL if SessionOptions::enable_result_cache isn't set.
+    */
+  common::Status GetResultCacheStats(ResultCache::Stats& stats) const;
+
+  /**
+    * Create a new session for the model of this one, with its session options and some more of the inputs of the
+    * model bound to fixed values, e.g. for a Run of many feeds that share the values of some of the inputs.
+    * The execution providers have to be registered with the new session before it's initialized, and the custom
+    * registries and ops of this session are not carried over.
+    * @param constant_inputs the values bound to the inputs, added to SessionOptions::constant_inputs.
+    * @param specialized the new session, with the model loaded but not initialized.
+    * @return NOT_IMPLEMENTED if the model of this session wasn't loaded from a file.
+    */
+  common::Status Specialize(const NameMLValMap& constant_inputs, std::unique_ptr<InferenceSession>& specialized) const;
+
+  /**
+    * Get the ranges the session has recorded so far, which may be passed as SessionOptions::quantization_ranges.
+    * @param ranges the minimum and the maximum of each value recorded, by the name of the value.
+    * @return FAIL if SessionOptions::enable_quantization_calibration isn't set.
+    */
+  common::Status GetQuantizationRanges(QuantizationRanges& ranges) const;
+
+  /**
+    * Get the allocator of the session's execution providers for a location, e.g. to allocate a tensor on a device
+    * that is passed to Run as a preallocated output.
+    * @return nullptr if no execution provider of the session allocates for info.
+    */
+  AllocatorPtr GetAllocator(const OrtAllocatorInfo& info) const;
+
   /**
     * Start profiling on this inference session. This simply turns on profiling events to be 
     * recorded. A corresponding EndProfiling has to follow to write profiling data to a file.
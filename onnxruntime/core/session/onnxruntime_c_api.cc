@@ -16,11 +16,14 @@
 #include "core/graph/graph.h"
 #include "core/framework/allocator.h"
 #include "core/framework/tensor.h"
+#include "core/framework/tensor_seq.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/environment.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 
 #include "abi_session_options_impl.h"
 
@@ -44,6 +47,11 @@ using onnxruntime::common::Status;
     if (_status) return _status;      \
   } while (0)
 
+struct OrtSessionMetrics {
+  std::vector<onnxruntime::SessionMetrics::OpMetrics> op_metrics;
+  int64_t num_arena_extends = 0;
+};
+
 struct OrtEnv {
  public:
   Environment* value;
@@ -130,6 +138,27 @@ ORT_API_STATUS_IMPL(OrtInitialize, OrtLoggingLevel default_warning_level,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtSetIntraOpThreadPoolSize, _Inout_ OrtEnv* env, int num_threads) {
+  API_IMPL_BEGIN
+  ORT_UNUSED_PARAMETER(env);  // the pool is process-wide, as is the OrtEnv
+  return ToOrtStatus(Environment::SetIntraOpThreadPoolSize(num_threads));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSetIntraOpThreadPoolSpinDuration, _Inout_ OrtEnv* env, int spin_us) {
+  API_IMPL_BEGIN
+  ORT_UNUSED_PARAMETER(env);
+  return ToOrtStatus(Environment::SetIntraOpThreadPoolSpinDuration(spin_us));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtKeepIntraOpThreadPoolHot, _Inout_ OrtEnv* env, int duration_us) {
+  API_IMPL_BEGIN
+  ORT_UNUSED_PARAMETER(env);
+  return ToOrtStatus(Environment::KeepIntraOpThreadPoolHot(duration_us));
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtGetStringTensorDataLength, _In_ const OrtValue* value, _Out_ size_t* out) {
   TENSOR_READ_API_BEGIN
   const auto* src = tensor.Data<std::string>();
@@ -161,6 +190,27 @@ ORT_API_STATUS_IMPL(OrtFillStringTensor, _In_ OrtValue* value, _In_ const char*
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtFillStringTensorFromContent, _In_ OrtValue* value, _In_ const void* s, size_t s_len,
+                    _In_ const size_t* offsets, size_t offsets_len) {
+  TENSOR_READWRITE_API_BEGIN
+  auto* dst = tensor->MutableData<std::string>();
+  auto len = static_cast<size_t>(tensor->Shape().Size());
+  if (offsets_len < len) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "offsets array is too short");
+  }
+  const char* p = static_cast<const char*>(s);
+  for (size_t i = 0; i != len; ++i) {
+    const size_t end = i + 1 == len ? s_len : offsets[i + 1];
+    if (offsets[i] > end || end > s_len) {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "offsets are out of order or out of range");
+    }
+    // one copy from the caller's buffer, without looking for the end of the string
+    dst[i].assign(p + offsets[i], end - offsets[i]);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 template <typename T>
 OrtStatus* CreateTensorImpl(const size_t* shape, size_t shape_len, OrtAllocator* allocator,
                             std::unique_ptr<Tensor>* out) {
@@ -397,13 +447,11 @@ ORT_API_STATUS_IMPL(OrtCreateSession, _In_ OrtEnv* env, _In_ const char* model_p
 }
 #endif
 
-ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
-                    _In_ OrtRunOptions* run_options,
-                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
-                    _In_ const char* const* output_names1, size_t output_names_len, _Out_ OrtValue** output) {
-  API_IMPL_BEGIN
-  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
-  ::onnxruntime::NameMLValMap in;
+namespace {
+// Create the feeds and output names shared by OrtRun and OrtRunAsync.
+OrtStatus* CreateRunFeeds(_In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                          _In_ const char* const* output_names1, size_t output_names_len,
+                          ::onnxruntime::NameMLValMap& in, std::vector<std::string>& output_names) {
   const int queue_id = 0;
   for (size_t i = 0; i != input_len; ++i) {
     auto kvp = in.insert(std::make_pair(std::string(input_names[i]),
@@ -416,13 +464,31 @@ ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
       value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
   }
   // Create output feed
-  std::vector<std::string> output_names(output_names_len);
+  output_names.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
       return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
     }
     output_names[i] = output_names1[i];
   }
+  return nullptr;
+}
+}  // namespace
+
+ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
+                    _In_ OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Out_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  ::onnxruntime::NameMLValMap in;
+  std::vector<std::string> output_names;
+  const int queue_id = 0;
+  OrtStatus* feeds_status = CreateRunFeeds(input_names, input, input_len, output_names1, output_names_len,
+                                           in, output_names);
+  if (feeds_status != nullptr) {
+    return feeds_status;
+  }
 
   std::vector<MLValue> fetches(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
@@ -455,6 +521,213 @@ ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtPrepareRun, _Inout_ OrtSession* sess,
+                    _In_ const char* const* input_names, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Out_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::vector<std::string> feed_names(input_names, input_names + input_len);
+  std::vector<std::string> output_names;
+  output_names.reserve(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names.emplace_back(output_names1[i]);
+  }
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  auto status = session->PrepareRun(feed_names, output_names, prepared_run);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtPreparedRun*>(prepared_run.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunPrepared, _Inout_ OrtSession* sess, _In_opt_ OrtRunOptions* run_options,
+                    _In_ const OrtPreparedRun* prepared_run1, _In_ const OrtValue* const* input, size_t input_len,
+                    _Inout_ OrtValue** output, size_t output_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const auto& prepared_run = *reinterpret_cast<const ::onnxruntime::PreparedRun*>(prepared_run1);
+  if (output_len != prepared_run.GetOutputNames().size()) {
+    std::ostringstream ostr;
+    ostr << "output_len " << output_len << " doesn't match the number of prepared outputs "
+         << prepared_run.GetOutputNames().size();
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, ostr.str().c_str());
+  }
+
+  const int queue_id = 0;
+  std::vector<MLValue> feeds;
+  feeds.reserve(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    feeds.push_back(*reinterpret_cast<const ::onnxruntime::MLValue*>(input[i]));
+    ::onnxruntime::MLValue& value = feeds.back();
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<MLValue> fetches(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output[i] != nullptr) {
+      ::onnxruntime::MLValue& value = *reinterpret_cast<::onnxruntime::MLValue*>(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, prepared_run, feeds, &fetches);
+  } else {
+    status = session->Run(*run_options, prepared_run, feeds, &fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t i = 0; i != output_len; ++i) {
+    ::onnxruntime::MLValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = reinterpret_cast<OrtValue*>(new MLValue(value));
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunAsync, _Inout_ OrtSession* sess,
+                    _In_opt_ OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len,
+                    _In_ OrtRunAsyncCallbackFn callback, _Inout_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  if (callback == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be null");
+  }
+
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  ::onnxruntime::NameMLValMap in;
+  std::vector<std::string> output_names;
+  OrtStatus* feeds_status = CreateRunFeeds(input_names, input, input_len, output_names1, output_names_len,
+                                           in, output_names);
+  if (feeds_status != nullptr) {
+    return feeds_status;
+  }
+
+  // the Run outlives this call so it can't use a temporary OrtRunOptions
+  static const OrtRunOptions default_run_options;
+  const OrtRunOptions& options = run_options == nullptr ? default_run_options : *run_options;
+
+  auto status = session->RunAsync(
+      options, in, output_names,
+      [callback, user_data](const Status& run_status, std::vector<MLValue>& fetches) {
+        if (!run_status.IsOK()) {
+          callback(user_data, nullptr, 0, ToOrtStatus(run_status));
+          return;
+        }
+
+        const int queue_id = 0;
+        std::vector<OrtValue*> outputs(fetches.size());
+        for (size_t i = 0; i != fetches.size(); ++i) {
+          ::onnxruntime::MLValue& value = fetches[i];
+          if (value.Fence())
+            value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+          outputs[i] = reinterpret_cast<OrtValue*>(new MLValue(value));
+        }
+        callback(user_data, outputs.data(), outputs.size(), nullptr);
+      });
+
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtCreateIoBinding, _Inout_ OrtSession* sess, _Out_ OrtIoBinding** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::IOBinding> binding;
+  auto status = session->NewIOBinding(&binding);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtIoBinding*>(binding.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtBindInput, _Inout_ OrtIoBinding* binding, _In_ const char* name, _In_ const OrtValue* value) {
+  API_IMPL_BEGIN
+  auto io_binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+  return ToOrtStatus(io_binding->BindInput(name, *reinterpret_cast<const MLValue*>(value)));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtBindOutput, _Inout_ OrtIoBinding* binding, _In_ const char* name, _In_ const OrtValue* value) {
+  API_IMPL_BEGIN
+  auto io_binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+  return ToOrtStatus(io_binding->BindOutput(name, *reinterpret_cast<const MLValue*>(value)));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtBindOutputToDevice, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+                    _In_ const OrtAllocatorInfo* info) {
+  API_IMPL_BEGIN
+  auto io_binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+  return ToOrtStatus(io_binding->BindOutput(name, *info));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSynchronizeBoundInputs, _Inout_ OrtIoBinding* binding) {
+  API_IMPL_BEGIN
+  return ToOrtStatus(reinterpret_cast<::onnxruntime::IOBinding*>(binding)->SynchronizeInputs());
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSynchronizeBoundOutputs, _Inout_ OrtIoBinding* binding) {
+  API_IMPL_BEGIN
+  return ToOrtStatus(reinterpret_cast<::onnxruntime::IOBinding*>(binding)->SynchronizeOutputs());
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunWithBinding, _Inout_ OrtSession* sess, _In_opt_ OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto io_binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, *io_binding);
+  } else {
+    status = session->Run(*run_options, *io_binding);
+  }
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtGetBoundOutputs, _In_ OrtIoBinding* binding, _Out_ OrtValue** output, size_t output_len) {
+  API_IMPL_BEGIN
+  auto io_binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+  auto& outputs = io_binding->GetOutputs();
+  if (output_len != outputs.size()) {
+    std::ostringstream ostr;
+    ostr << "output_len " << output_len << " doesn't match the number of bound outputs " << outputs.size();
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, ostr.str().c_str());
+  }
+
+  const int queue_id = 0;
+  for (size_t i = 0; i != output_len; ++i) {
+    ::onnxruntime::MLValue& value = outputs[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    output[i] = reinterpret_cast<OrtValue*>(new MLValue(value));
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtGetTensorMutableData, _In_ OrtValue* value, _Out_ void** output) {
   TENSOR_READWRITE_API_BEGIN
   //TODO: test if it's a string tensor
@@ -482,7 +755,7 @@ ORT_API_STATUS_IMPL(OrtGetStringTensorContent, _In_ const OrtValue* value,
   }
   size_t f = 0;
   char* p = static_cast<char*>(s);
-  for (size_t i = 0; i != offsets_len; ++i, ++offsets) {
+  for (size_t i = 0; i != len; ++i, ++offsets) {
     memcpy(p, input[i].data(), input[i].size());
     p += input[i].size();
     *offsets = f;
@@ -541,6 +814,117 @@ ORT_API_STATUS_IMPL(OrtSessionGetOutputCount, _In_ const OrtSession* sess, _Out_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtSessionShrinkMemoryArenas, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  return ToOrtStatus(session->ShrinkMemoryArenas());
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionWarmup, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  return ToOrtStatus(session->Warmup(true));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionEvict, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  return ToOrtStatus(session->Evict());
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionRestore, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  return ToOrtStatus(session->Restore());
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtGetAllocatorStats, _In_ const OrtSession* sess, _In_ const OrtAllocatorInfo* info,
+                    _Out_ OrtAllocatorStats* out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  onnxruntime::AllocatorStats stats;
+  auto status = session->GetAllocatorStats(*info, stats);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  out->num_allocs = stats.num_allocs;
+  out->bytes_in_use = stats.bytes_in_use;
+  out->max_bytes_in_use = stats.max_bytes_in_use;
+  out->total_allocated_bytes = stats.total_allocated_bytes;
+  out->max_alloc_size = stats.max_alloc_size;
+  out->bytes_limit = stats.bytes_limit;
+  out->free_bytes_in_bins = stats.free_bytes_in_bins;
+  out->largest_free_chunk = stats.largest_free_chunk;
+  out->num_extends = stats.num_extends;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtGetResultCacheStats, _In_ const OrtSession* sess, _Out_ OrtResultCacheStats* out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  onnxruntime::ResultCache::Stats stats;
+  auto status = session->GetResultCacheStats(stats);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  out->num_hits = stats.num_hits;
+  out->num_misses = stats.num_misses;
+  out->num_evictions = stats.num_evictions;
+  out->num_entries = stats.num_entries;
+  out->num_bytes = stats.num_bytes;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtGetSessionMetrics, _In_ const OrtSession* sess, _Out_ OrtSessionMetrics** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  auto metrics = std::make_unique<OrtSessionMetrics>();
+  auto status = session->GetMetrics(metrics->op_metrics, metrics->num_arena_extends);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  *out = metrics.release();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionMetricsGetOpCount, _In_ const OrtSessionMetrics* metrics, _Out_ size_t* out) {
+  *out = metrics->op_metrics.size();
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionMetricsGetOp, _In_ const OrtSessionMetrics* metrics, size_t index,
+                    _Out_ OrtOpMetrics* out) {
+  if (index >= metrics->op_metrics.size()) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "op index is out of range");
+  }
+
+  const auto& op_metrics = metrics->op_metrics[index];
+  out->op_type = op_metrics.op_type.c_str();
+  out->num_calls = op_metrics.num_calls;
+  out->total_time_us = op_metrics.total_time_us;
+  out->p50_time_us = op_metrics.p50_time_us;
+  out->p99_time_us = op_metrics.p99_time_us;
+  out->output_bytes = op_metrics.output_bytes;
+  out->cycles = op_metrics.cycles;
+  out->instructions = op_metrics.instructions;
+  out->llc_misses = op_metrics.llc_misses;
+  out->dtlb_misses = op_metrics.dtlb_misses;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionMetricsGetArenaExtendCount, _In_ const OrtSessionMetrics* metrics,
+                    _Out_ int64_t* out) {
+  *out = metrics->num_arena_extends;
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(OrtSessionGetInputTypeInfo, _In_ const OrtSession* sess, size_t index, _Out_ struct OrtTypeInfo** out) {
   API_IMPL_BEGIN
   auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
@@ -594,6 +978,146 @@ ORT_API(int, OrtIsTensor, _In_ const OrtValue* value) {
   return v->IsTensor() ? 1 : 0;
 }
 
+namespace {
+// the number of elements of a value of one of the container types
+template <typename... Types>
+struct ContainerSize;
+
+template <>
+struct ContainerSize<> {
+  static bool Get(const MLValue&, size_t&) { return false; }
+};
+
+template <typename T, typename... Rest>
+struct ContainerSize<T, Rest...> {
+  static bool Get(const MLValue& value, size_t& size) {
+    if (value.Type() != DataTypeImpl::GetType<T>())
+      return ContainerSize<Rest...>::Get(value, size);
+    size = value.Get<T>().size();
+    return true;
+  }
+};
+
+using MapSizes = ContainerSize<onnxruntime::MapStringToString, onnxruntime::MapStringToInt64,
+                               onnxruntime::MapStringToFloat, onnxruntime::MapStringToDouble,
+                               onnxruntime::MapInt64ToString, onnxruntime::MapInt64ToInt64,
+                               onnxruntime::MapInt64ToFloat, onnxruntime::MapInt64ToDouble>;
+
+using SequenceSizes = ContainerSize<onnxruntime::VectorString, onnxruntime::VectorFloat, onnxruntime::VectorInt64,
+                                    onnxruntime::VectorDouble, onnxruntime::VectorMapStringToFloat,
+                                    onnxruntime::VectorMapInt64ToFloat>;
+
+// the keys or values of a map are stored as themselves, strings as pointers to their characters
+template <typename T>
+void StoreMapElement(const T& element, void* out, size_t i) {
+  static_cast<T*>(out)[i] = element;
+}
+
+void StoreMapElement(const std::string& element, void* out, size_t i) {
+  static_cast<const char**>(out)[i] = element.c_str();
+}
+
+template <typename... Types>
+struct MapEntries;
+
+template <>
+struct MapEntries<> {
+  static bool Get(const MLValue&, void*, void*) { return false; }
+};
+
+template <typename T, typename... Rest>
+struct MapEntries<T, Rest...> {
+  static bool Get(const MLValue& value, void* keys, void* values) {
+    if (value.Type() != DataTypeImpl::GetType<T>())
+      return MapEntries<Rest...>::Get(value, keys, values);
+    size_t i = 0;
+    for (const auto& entry : value.Get<T>()) {
+      if (keys != nullptr)
+        StoreMapElement(entry.first, keys, i);
+      if (values != nullptr)
+        StoreMapElement(entry.second, values, i);
+      ++i;
+    }
+    return true;
+  }
+};
+
+using AllMaps = MapEntries<onnxruntime::MapStringToString, onnxruntime::MapStringToInt64,
+                           onnxruntime::MapStringToFloat, onnxruntime::MapStringToDouble,
+                           onnxruntime::MapInt64ToString, onnxruntime::MapInt64ToInt64,
+                           onnxruntime::MapInt64ToFloat, onnxruntime::MapInt64ToDouble>;
+
+// a view of the element at index of a sequence of maps
+template <typename Seq>
+bool GetMapView(const MLValue& value, size_t index, MLValue& view) {
+  if (value.Type() != DataTypeImpl::GetType<Seq>())
+    return false;
+  const auto& seq = value.Get<Seq>();
+  ORT_ENFORCE(index < seq.size(), "index ", index, " is out of the range of a sequence of ", seq.size());
+  using Map = typename Seq::value_type;
+  view = value.MakeView(const_cast<Map*>(&seq[index]), DataTypeImpl::GetType<Map>());
+  return true;
+}
+}  // namespace
+
+ORT_API_STATUS_IMPL(OrtGetValueCount, _In_ const OrtValue* value, _Out_ size_t* out) {
+  API_IMPL_BEGIN
+  const auto& v = *reinterpret_cast<const MLValue*>(value);
+  if (v.Type() == DataTypeImpl::GetType<onnxruntime::TensorSeq>()) {
+    *out = v.Get<onnxruntime::TensorSeq>().Size();
+    return nullptr;
+  }
+  if (!MapSizes::Get(v, *out) && !SequenceSizes::Get(v, *out))
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "value is not a sequence or a map");
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtGetValue, _In_ const OrtValue* value, size_t index, _Out_ OrtValue** out) {
+  API_IMPL_BEGIN
+  const auto& v = *reinterpret_cast<const MLValue*>(value);
+  MLValue view;
+  if (v.Type() == DataTypeImpl::GetType<onnxruntime::TensorSeq>()) {
+    view = v.Get<onnxruntime::TensorSeq>().GetValue(index);
+  } else if (!GetMapView<onnxruntime::VectorMapStringToFloat>(v, index, view) &&
+             !GetMapView<onnxruntime::VectorMapInt64ToFloat>(v, index, view)) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "value is not a sequence of tensors or of maps");
+  }
+  *out = reinterpret_cast<OrtValue*>(new MLValue(std::move(view)));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtGetSequenceData, _In_ const OrtValue* value, _Out_ const void** out) {
+  API_IMPL_BEGIN
+  const auto& v = *reinterpret_cast<const MLValue*>(value);
+  if (v.Type() == DataTypeImpl::GetType<onnxruntime::VectorFloat>()) {
+    *out = v.Get<onnxruntime::VectorFloat>().data();
+  } else if (v.Type() == DataTypeImpl::GetType<onnxruntime::VectorInt64>()) {
+    *out = v.Get<onnxruntime::VectorInt64>().data();
+  } else if (v.Type() == DataTypeImpl::GetType<onnxruntime::VectorDouble>()) {
+    *out = v.Get<onnxruntime::VectorDouble>().data();
+  } else {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "value is not a sequence of float, int64 or double");
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtGetMapEntries, _In_ const OrtValue* value, _Out_ void* keys, _Out_ void* values,
+                    size_t count) {
+  API_IMPL_BEGIN
+  const auto& v = *reinterpret_cast<const MLValue*>(value);
+  size_t size = 0;
+  if (!MapSizes::Get(v, size))
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "value is not a map");
+  if (size > count)
+    return OrtCreateStatus(ORT_FAIL, "space is not enough");
+  AllMaps::Get(v, keys, values);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API(void*, OrtAllocatorAlloc, _Inout_ OrtAllocator* ptr, size_t size) {
   try {
     return ptr->Alloc(ptr, size);
@@ -635,4 +1159,7 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Env, OrtEnv)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, MLValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(IoBinding, ::onnxruntime::IOBinding)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(SessionMetrics, OrtSessionMetrics)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, ::onnxruntime::PreparedRun)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION_FOR_ARRAY(Status, char)
@@ -0,0 +1,409 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/pipeline_session.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/framework/cost_based_placement_transformer.h"
+#include "core/framework/data_types.h"
+#include "core/framework/graph_partitioner.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/model.h"
+#include "core/platform/env.h"
+#include "core/session/inference_session.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+// makes the ModelProto overloads of Load available to PipelineSession
+class StageSession : public InferenceSession {
+ public:
+  using InferenceSession::InferenceSession;
+  using InferenceSession::Load;
+};
+
+MLValue AllocateTensorInMLValue(const MLDataType data_type, const TensorShape& shape, AllocatorPtr& allocator) {
+  auto new_tensor = std::make_unique<Tensor>(data_type,
+                                             shape,
+                                             allocator->Alloc(shape.Size() * data_type->Size()),
+                                             allocator->Info(),
+                                             allocator);
+
+  return MLValue{new_tensor.release(),
+                 DataTypeImpl::GetType<Tensor>(),
+                 DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+// the micro-batches view the rows of the feeds and their outputs are concatenated with memcpy, so must be fixed
+// size types in CPU memory
+bool IsSplittableTensor(const Tensor& tensor) {
+  return tensor.Shape().NumDimensions() > 0 &&
+         strcmp(tensor.Location().name, CPU) == 0 &&
+         tensor.DataType() != DataTypeImpl::GetType<std::string>();
+}
+
+void AddInputs(const Node& node, std::vector<const NodeArg*>& inputs) {
+  for (const auto* arg : node.InputDefs()) {
+    inputs.push_back(arg);
+  }
+  for (const auto* arg : node.ImplicitInputDefs()) {
+    inputs.push_back(arg);
+  }
+}
+}  // namespace
+
+PipelineSession::PipelineSession(const PipelineOptions& options)
+    : options_(options), allocator_(std::make_shared<CPUAllocator>()) {
+}
+
+PipelineSession::~PipelineSession() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    shutdown_ = true;
+    for (auto& stage : stages_) {
+      stage->queue_cv.notify_all();
+    }
+  }
+
+  // join the threads before the sessions they run are destroyed
+  for (auto& stage : stages_) {
+    stage->thread.reset();
+  }
+}
+
+Status PipelineSession::Create(const SessionOptions& session_options,
+                               const std::string& model_uri,
+                               const std::vector<int>& device_ids,
+                               const ReplicaProviderFactory& provider_factory,
+                               const PipelineOptions& options,
+                               logging::LoggingManager* logging_manager,
+                               std::unique_ptr<PipelineSession>& pipeline_session) {
+  if (device_ids.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "At least one device id is required.");
+  }
+
+  if (options.num_micro_batches < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid num_micro_batches: ", options.num_micro_batches);
+  }
+
+  std::ifstream model_stream(model_uri, std::ios::in | std::ios::binary);
+  if (!model_stream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Failed to open model file ", model_uri);
+  }
+
+  auto model_proto = std::make_unique<ModelProto>();
+  ORT_RETURN_IF_ERROR(Model::Load(model_stream, model_proto.get()));
+
+  // the stages have the metadata and opsets of the model, with a graph of their own
+  auto* graph_proto = model_proto->release_graph();
+  const ModelProto stage_template = *model_proto;
+  model_proto->set_allocated_graph(graph_proto);
+
+  std::shared_ptr<Model> model;
+  ORT_RETURN_IF_ERROR(Model::Load(std::move(model_proto), model));
+  const Graph& graph = model->MainGraph();
+
+  PlacementCostModel cost_model;
+  if (!session_options.placement_profile_file.empty()) {
+    ORT_RETURN_IF_ERROR(cost_model.LoadProfile(session_options.placement_profile_file));
+  }
+  GraphViewer graph_viewer(graph);
+  std::vector<std::vector<NodeIndex>> stage_nodes;
+  ORT_RETURN_IF_ERROR(GraphPartitioner::PartitionIntoStages(graph_viewer, device_ids.size(), cost_model,
+                                                            stage_nodes));
+
+  // the stage that writes each value, and the last stage that reads it
+  std::unordered_map<std::string, size_t> producer_stages;
+  std::unordered_map<std::string, size_t> last_consumer_stages;
+  for (size_t s = 0; s < stage_nodes.size(); ++s) {
+    for (auto index : stage_nodes[s]) {
+      const Node& node = *graph.GetNode(index);
+      for (const auto* arg : node.OutputDefs()) {
+        if (arg->Exists())
+          producer_stages[arg->Name()] = s;
+      }
+      std::vector<const NodeArg*> inputs;
+      AddInputs(node, inputs);
+      for (const auto* arg : inputs) {
+        if (arg->Exists())
+          last_consumer_stages[arg->Name()] = s;
+      }
+    }
+  }
+
+  std::unordered_set<std::string> graph_inputs;
+  for (const auto* arg : graph.GetInputsIncludingInitializers()) {
+    graph_inputs.insert(arg->Name());
+  }
+  std::unordered_set<std::string> graph_outputs;
+  for (const auto* arg : graph.GetOutputs()) {
+    graph_outputs.insert(arg->Name());
+  }
+
+  std::unique_ptr<PipelineSession> session{new PipelineSession(options)};
+  for (size_t s = 0; s < stage_nodes.size(); ++s) {
+    auto stage = std::make_unique<Stage>();
+    stage->index = s;
+    stage->device_id = device_ids[s];
+
+    auto stage_proto = std::make_unique<ModelProto>(stage_template);
+    auto* stage_graph = stage_proto->mutable_graph();
+    stage_graph->set_name(graph.Name() + "_stage" + std::to_string(s));
+
+    std::unordered_set<std::string> stage_values;
+    for (auto index : stage_nodes[s]) {
+      const Node& node = *graph.GetNode(index);
+      node.ToProto(*stage_graph->add_node());
+
+      std::vector<const NodeArg*> inputs;
+      AddInputs(node, inputs);
+      for (const auto* arg : inputs) {
+        const auto& name = arg->Name();
+        if (!arg->Exists() || !stage_values.insert(name).second)
+          continue;
+        auto producer = producer_stages.find(name);
+        if (producer != producer_stages.end() && producer->second == s)
+          continue;
+
+        const TensorProto* initializer = nullptr;
+        if (graph.GetInitializedTensor(name, initializer)) {
+          *stage_graph->add_initializer() = *initializer;
+          // an initializer the model declares as an input may be overridden by a feed
+          if (graph_inputs.count(name) == 0)
+            continue;
+        }
+        *stage_graph->add_input() = arg->ToProto();
+        stage->input_names.push_back(name);
+      }
+
+      for (const auto* arg : node.OutputDefs()) {
+        const auto& name = arg->Name();
+        if (!arg->Exists())
+          continue;
+        stage_values.insert(name);
+        auto consumer = last_consumer_stages.find(name);
+        if (graph_outputs.count(name) != 0 || (consumer != last_consumer_stages.end() && consumer->second > s)) {
+          *stage_graph->add_output() = arg->ToProto();
+          stage->output_names.push_back(name);
+        }
+      }
+    }
+
+    SessionOptions stage_options = session_options;
+    if (!stage_options.session_logid.empty()) {
+      stage_options.session_logid += "_stage" + std::to_string(s);
+    }
+
+    auto stage_session = std::make_unique<StageSession>(stage_options, logging_manager);
+    for (auto& provider : provider_factory(stage->device_id)) {
+      ORT_RETURN_IF_ERROR(stage_session->RegisterExecutionProvider(std::move(provider)));
+    }
+    ORT_RETURN_IF_ERROR(stage_session->Load(std::move(stage_proto)));
+    ORT_RETURN_IF_ERROR(stage_session->Initialize());
+    stage->session = std::move(stage_session);
+
+    session->stages_.push_back(std::move(stage));
+  }
+
+  for (auto& stage : session->stages_) {
+    auto* pipeline = session.get();
+    Stage* stage_ptr = stage.get();
+    stage->thread.reset(Env::Default().StartThread(ThreadOptions(), "pipeline_stage" + std::to_string(stage->index),
+                                                   [pipeline, stage_ptr]() { pipeline->RunStage(*stage_ptr); }));
+  }
+
+  pipeline_session = std::move(session);
+  return Status::OK();
+}
+
+void PipelineSession::SplitFeeds(const NameMLValMap& feeds, std::vector<MicroBatch>& micro_batches) const {
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.second.IsTensor() || !IsSplittableTensor(feed.second.Get<Tensor>())) {
+      batch_size = -1;
+      break;
+    }
+
+    const int64_t dim0 = feed.second.Get<Tensor>().Shape()[0];
+    if (batch_size != -1 && dim0 != batch_size) {
+      batch_size = -1;
+      break;
+    }
+    batch_size = dim0;
+  }
+
+  const int64_t num_micro_batches = std::min(options_.num_micro_batches, batch_size);
+  if (num_micro_batches < 2) {
+    micro_batches.resize(1);
+    micro_batches[0].rows = -1;
+    micro_batches[0].values = feeds;
+    return;
+  }
+
+  micro_batches.resize(num_micro_batches);
+  int64_t first_row = 0;
+  for (int64_t m = 0; m < num_micro_batches; ++m) {
+    auto& micro_batch = micro_batches[m];
+    // the rows that don't divide evenly go to the first micro-batches
+    micro_batch.rows = batch_size / num_micro_batches + (m < batch_size % num_micro_batches ? 1 : 0);
+
+    for (const auto& feed : feeds) {
+      const auto& tensor = feed.second.Get<Tensor>();
+      const size_t row_bytes = tensor.Size() / static_cast<size_t>(batch_size);
+      std::vector<int64_t> dims = tensor.Shape().GetDims();
+      dims[0] = micro_batch.rows;
+
+      // the feeds outlive the Run, so the rows of a micro-batch are viewed rather than copied
+      auto* data = static_cast<char*>(const_cast<void*>(tensor.DataRaw())) +
+                   static_cast<size_t>(first_row) * row_bytes;
+      auto view = std::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), data, tensor.Location());
+      micro_batch.values.insert(std::make_pair(
+          feed.first,
+          MLValue{view.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()}));
+    }
+    first_row += micro_batch.rows;
+  }
+}
+
+Status PipelineSession::Run(const RunOptions& run_options,
+                            const NameMLValMap& feeds,
+                            const std::vector<std::string>& output_names,
+                            std::vector<MLValue>* p_fetches) {
+  if (!p_fetches->empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "A PipelineSession doesn't support preallocated fetches.");
+  }
+
+  PipelineRun run;
+  run.run_options = &run_options;
+  SplitFeeds(feeds, run.micro_batches);
+  for (auto& micro_batch : run.micro_batches) {
+    micro_batch.run = &run;
+  }
+
+  {
+    std::unique_lock<OrtMutex> lock(mutex_);
+    run.remaining = run.micro_batches.size();
+    for (auto& micro_batch : run.micro_batches) {
+      Forward(0, micro_batch);
+    }
+    while (run.remaining > 0) {
+      run.done_cv.wait(lock);
+    }
+  }
+
+  for (const auto& micro_batch : run.micro_batches) {
+    ORT_RETURN_IF_ERROR(micro_batch.status);
+  }
+
+  std::vector<MLValue> fetches(output_names.size());
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    ORT_RETURN_IF_ERROR(FetchOutput(run.micro_batches, output_names[i], fetches[i]));
+  }
+  *p_fetches = std::move(fetches);
+  return Status::OK();
+}
+
+Status PipelineSession::FetchOutput(const std::vector<MicroBatch>& micro_batches, const std::string& output_name,
+                                    MLValue& fetch) const {
+  std::vector<const MLValue*> values;
+  for (const auto& micro_batch : micro_batches) {
+    auto entry = micro_batch.values.find(output_name);
+    if (entry == micro_batch.values.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid output name: ", output_name);
+    }
+    values.push_back(&entry->second);
+  }
+
+  if (micro_batches.front().rows < 0) {
+    fetch = *values.front();
+    return Status::OK();
+  }
+
+  // concatenate the outputs of the micro-batches along the leading dimension, which must be their rows
+  int64_t total_rows = 0;
+  for (size_t m = 0; m < values.size(); ++m) {
+    const auto& value = *values[m];
+    if (!value.IsTensor() || !IsSplittableTensor(value.Get<Tensor>()) ||
+        value.Get<Tensor>().Shape()[0] != micro_batches[m].rows ||
+        value.Get<Tensor>().DataType() != values.front()->Get<Tensor>().DataType() ||
+        value.Get<Tensor>().Shape().Slice(1) != values.front()->Get<Tensor>().Shape().Slice(1)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Output '", output_name,
+                             "' of a micro-batch is not a CPU tensor with the rows of the micro-batch as its leading "
+                             "dimension, so the micro-batches can't be concatenated.");
+    }
+    total_rows += micro_batches[m].rows;
+  }
+
+  const auto& first = values.front()->Get<Tensor>();
+  std::vector<int64_t> dims = first.Shape().GetDims();
+  dims[0] = total_rows;
+  AllocatorPtr allocator = allocator_;
+  fetch = AllocateTensorInMLValue(first.DataType(), TensorShape(dims), allocator);
+  auto* dst = static_cast<char*>(fetch.GetMutable<Tensor>()->MutableDataRaw());
+  for (const auto* value : values) {
+    const auto& tensor = value->Get<Tensor>();
+    memcpy(dst, tensor.DataRaw(), tensor.Size());
+    dst += tensor.Size();
+  }
+  return Status::OK();
+}
+
+void PipelineSession::Forward(size_t stage_index, MicroBatch& micro_batch) {
+  if (micro_batch.status.IsOK() && stage_index < stages_.size()) {
+    auto& stage = *stages_[stage_index];
+    stage.queue.push_back(&micro_batch);
+    stage.queue_cv.notify_one();
+    return;
+  }
+
+  if (--micro_batch.run->remaining == 0) {
+    micro_batch.run->done_cv.notify_all();
+  }
+}
+
+void PipelineSession::RunStage(Stage& stage) {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  for (;;) {
+    while (!shutdown_ && stage.queue.empty()) {
+      stage.queue_cv.wait(lock);
+    }
+    if (stage.queue.empty()) {
+      return;
+    }
+
+    MicroBatch& micro_batch = *stage.queue.front();
+    stage.queue.pop_front();
+    lock.unlock();
+
+    // a micro-batch is only used by the stage it's queued for, so its values are accessed without the lock
+    NameMLValMap stage_feeds;
+    for (const auto& name : stage.input_names) {
+      auto entry = micro_batch.values.find(name);
+      if (entry != micro_batch.values.end()) {
+        stage_feeds.insert(*entry);
+      }
+    }
+
+    std::vector<MLValue> stage_fetches;
+    auto status = stage.session->Run(*micro_batch.run->run_options, stage_feeds, stage.output_names, &stage_fetches);
+    if (status.IsOK()) {
+      for (size_t i = 0; i < stage_fetches.size(); ++i) {
+        micro_batch.values[stage.output_names[i]] = stage_fetches[i];
+      }
+    }
+
+    lock.lock();
+    micro_batch.status = status;
+    Forward(stage.index + 1, micro_batch);
+  }
+}
+
+}  // namespace onnxruntime
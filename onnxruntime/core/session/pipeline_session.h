@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ml_value.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/replicated_session.h"
+
+namespace onnxruntime {
+class Thread;
+
+/**
+  * Configuration for a PipelineSession.
+  */
+struct PipelineOptions {
+  /// number of micro-batches the batch of a Run is split into along the leading dimension of the feeds.
+  /// a batch of fewer rows is split into a micro-batch per row.
+  int64_t num_micro_batches = 4;
+};
+
+/**
+  * Runs a model split into stages on several devices, with an InferenceSession per stage, so that a model that
+  * doesn't fit on one device can use the memory and compute of several.
+  *
+  * The graph is split into a stage per device id by GraphPartitioner::PartitionIntoStages, with about the same
+  * estimated time in each, using the kernel times of SessionOptions::placement_profile_file if it's set. A stage
+  * reads the graph inputs and the outputs of the stages before it and holds the initializers its nodes use.
+  *
+  * Each Run splits its feeds into micro-batches along their leading dimension, which flow through the stages with a
+  * thread per stage, so the stages work on different micro-batches at the same time, each on the streams of its
+  * own execution providers. The outputs of the micro-batches are concatenated along the leading dimension. Feeds
+  * that can't be split, such as scalars, tensors in device memory or batches of different sizes, are run as one
+  * micro-batch. The rows of a batch must be computed independently of each other, as they are by the inference of
+  * most models. Concurrent Runs share the stages, whose queues take the micro-batches in the order they arrive.
+  *
+  * The values passed between the stages are fetched to and fed from CPU memory. Models with custom ops or
+  * functions of local schema registries can't be split.
+  *
+  * Usage:
+  *   std::unique_ptr<PipelineSession> pipeline_session;
+  *   ORT_RETURN_IF_ERROR(PipelineSession::Create(so, model_uri, {0, 1}, cuda_providers, PipelineOptions(),
+  *                                               &logging_manager, pipeline_session));
+  *   ORT_RETURN_IF_ERROR(pipeline_session->Run(run_options, feeds, output_names, &fetches));
+  */
+class PipelineSession {
+ public:
+  /**
+    * Split the model into a stage per device id, and load and initialize the session of each stage with the
+    * providers of provider_factory for its device.
+    * @param logging_manager see InferenceSession::InferenceSession.
+    * @return INVALID_ARGUMENT if device_ids is empty, the options are invalid or the graph has fewer nodes than
+    *         stages, or the error of the first stage that fails to initialize.
+    */
+  static common::Status Create(const SessionOptions& session_options,
+                               const std::string& model_uri,
+                               const std::vector<int>& device_ids,
+                               const ReplicaProviderFactory& provider_factory,
+                               const PipelineOptions& options,
+                               logging::LoggingManager* logging_manager,
+                               std::unique_ptr<PipelineSession>& pipeline_session);
+
+  ~PipelineSession();
+
+  /**
+    * Run the micro-batches of the feeds through the stages.
+    * Preallocated fetches are not supported.
+    * @see InferenceSession::Run
+    */
+  common::Status Run(const RunOptions& run_options,
+                     const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<MLValue>* p_fetches);
+
+  size_t NumStages() const { return stages_.size(); }
+
+  /**
+    * The session of the stage on device_ids[index], e.g. to query the values it reads and writes.
+    */
+  InferenceSession& GetStage(size_t index) const { return *stages_.at(index)->session; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PipelineSession);
+
+  struct PipelineRun;
+
+  struct MicroBatch {
+    PipelineRun* run;
+    // the rows of the feeds in the micro-batch, or -1 if the feeds weren't split
+    int64_t rows;
+    // the feeds and the outputs of the stages that have run
+    NameMLValMap values;
+    common::Status status;
+  };
+
+  // the micro-batches of a Run, which is done when no micro-batch is left to pass through the stages
+  struct PipelineRun {
+    const RunOptions* run_options;
+    std::vector<MicroBatch> micro_batches;
+    size_t remaining;  // GUARDED_BY(mutex_)
+    OrtCondVar done_cv;
+  };
+
+  struct Stage {
+    size_t index;
+    int device_id;
+    std::unique_ptr<InferenceSession> session;
+    // the values the stage reads from the feeds and the stages before it, and those it writes for the stages
+    // after it and the outputs of the model
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+    std::deque<MicroBatch*> queue;  // GUARDED_BY(mutex_)
+    OrtCondVar queue_cv;
+    std::unique_ptr<Thread> thread;
+  };
+
+  explicit PipelineSession(const PipelineOptions& options);
+
+  // splits the feeds into micro-batches that view their rows, or a single one that holds the feeds if they can't
+  // be split
+  void SplitFeeds(const NameMLValMap& feeds, std::vector<MicroBatch>& micro_batches) const;
+
+  // the output of the Run of the micro-batches, concatenating the outputs of the micro-batches if they were split
+  common::Status FetchOutput(const std::vector<MicroBatch>& micro_batches, const std::string& output_name,
+                             MLValue& fetch) const;
+
+  // the loop of the thread of a stage
+  void RunStage(Stage& stage);
+
+  // queue the micro-batch for the stage, or finish it if it failed or went through the last stage
+  void Forward(size_t stage_index, MicroBatch& micro_batch);  // REQUIRES(mutex_)
+
+  const PipelineOptions options_;
+  AllocatorPtr allocator_;
+  std::vector<std::unique_ptr<Stage>> stages_;
+
+  OrtMutex mutex_;
+  bool shutdown_ = false;  // GUARDED_BY(mutex_)
+};
+
+}  // namespace onnxruntime
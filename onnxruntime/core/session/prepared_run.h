@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/data_types.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+/**
+  * The feed and output names of Runs of a session, which InferenceSession::PrepareRun validates and resolves to
+  * their MLValue indices once. A Run with it takes the feeds and fetches in the order of the names, and only checks
+  * the types and frozen shapes of the feeds, by index.
+  * It's only valid with the session that prepared it, and must not outlive it.
+  *
+  * Usage is as follows:
+  *
+  * std::unique_ptr<PreparedRun> prepared_run;
+  * session.PrepareRun({"X"}, {"Y"}, prepared_run);
+  * std::vector<MLValue> fetches;
+  * session.Run(run_options, *prepared_run, {x}, &fetches);
+  */
+class PreparedRun {
+ public:
+  const std::vector<std::string>& GetFeedNames() const { return feeds_fetches_manager_->GetFeedNames(); }
+  const std::vector<std::string>& GetOutputNames() const { return feeds_fetches_manager_->GetOutputNames(); }
+
+ private:
+  friend class InferenceSession;
+
+  PreparedRun() = default;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+
+  const InferenceSession* session_ = nullptr;
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+  // in the order of the feed names, the type the model declares for each
+  std::vector<MLDataType> feed_types_;
+  // in the order of the feed names, the frozen shape of each, or nullptr if it isn't frozen
+  std::vector<const TensorShape*> frozen_feed_shapes_;
+};
+
+}  // namespace onnxruntime
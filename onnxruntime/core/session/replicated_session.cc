@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/replicated_session.h"
+
+#include <fstream>
+#include <limits>
+
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+// makes the ModelProto overloads of Load available to ReplicatedSession
+class ReplicaSession : public InferenceSession {
+ public:
+  using InferenceSession::InferenceSession;
+  using InferenceSession::Load;
+};
+}  // namespace
+
+ReplicatedSession::~ReplicatedSession() = default;
+
+Status ReplicatedSession::Create(const SessionOptions& session_options,
+                                 const std::string& model_uri,
+                                 const std::vector<int>& device_ids,
+                                 const ReplicaProviderFactory& provider_factory,
+                                 logging::LoggingManager* logging_manager,
+                                 std::unique_ptr<ReplicatedSession>& replicated_session) {
+  if (device_ids.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "At least one device id is required.");
+  }
+
+  std::ifstream model_stream(model_uri, std::ios::in | std::ios::binary);
+  if (!model_stream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Failed to open model file ", model_uri);
+  }
+
+  auto model_proto = std::make_unique<ModelProto>();
+  ORT_RETURN_IF_ERROR(Model::Load(model_stream, model_proto.get()));
+
+  std::unique_ptr<ReplicatedSession> session{new ReplicatedSession()};
+  for (size_t i = 0; i < device_ids.size(); ++i) {
+    const int device_id = device_ids[i];
+    SessionOptions replica_options = session_options;
+    if (!replica_options.session_logid.empty()) {
+      replica_options.session_logid += "_device" + std::to_string(device_id);
+    }
+
+    auto replica = std::make_unique<ReplicaSession>(replica_options, logging_manager);
+    for (auto& provider : provider_factory(device_id)) {
+      ORT_RETURN_IF_ERROR(replica->RegisterExecutionProvider(std::move(provider)));
+    }
+
+    // the last replica takes the parsed model instead of copying it
+    if (i + 1 == device_ids.size()) {
+      ORT_RETURN_IF_ERROR(replica->Load(std::move(model_proto)));
+    } else {
+      ORT_RETURN_IF_ERROR(replica->Load(*model_proto));
+    }
+    ORT_RETURN_IF_ERROR(replica->Initialize());
+
+    session->replicas_.push_back(Replica{device_id, std::move(replica), std::make_unique<std::atomic<int>>(0)});
+  }
+
+  replicated_session = std::move(session);
+  return Status::OK();
+}
+
+ReplicatedSession::Replica& ReplicatedSession::PickReplica() {
+  const size_t num_replicas = replicas_.size();
+  const size_t first = next_replica_++ % num_replicas;
+
+  size_t best = first;
+  int best_load = std::numeric_limits<int>::max();
+  for (size_t n = 0; n < num_replicas; ++n) {
+    const size_t i = (first + n) % num_replicas;
+    const int load = replicas_[i].num_runs->load();
+    if (load < best_load) {
+      best = i;
+      best_load = load;
+    }
+  }
+
+  return replicas_[best];
+}
+
+Status ReplicatedSession::Run(const RunOptions& run_options,
+                              const NameMLValMap& feeds,
+                              const std::vector<std::string>& output_names,
+                              std::vector<MLValue>* p_fetches) {
+  Replica& replica = PickReplica();
+  ++*replica.num_runs;
+  auto status = replica.session->Run(run_options, feeds, output_names, p_fetches);
+  --*replica.num_runs;
+  return status;
+}
+
+std::vector<int> ReplicatedSession::GetReplicaLoads() const {
+  std::vector<int> loads;
+  loads.reserve(replicas_.size());
+  for (const auto& replica : replicas_) {
+    loads.push_back(replica.num_runs->load());
+  }
+  return loads;
+}
+
+}  // namespace onnxruntime
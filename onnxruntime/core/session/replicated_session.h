@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/execution_provider.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ml_value.h"
+
+namespace onnxruntime {
+class InferenceSession;
+struct SessionOptions;
+namespace logging {
+class LoggingManager;
+}
+
+/**
+  * Creates the execution providers for the replica on one device id.
+  * The providers are registered in the order they are returned, so the most preferred one comes first.
+  */
+using ReplicaProviderFactory = std::function<std::vector<std::unique_ptr<IExecutionProvider>>(int device_id)>;
+
+/**
+  * Runs a model on several devices, with an InferenceSession per device.
+  *
+  * The model file is read and parsed once and each replica is loaded from the parsed ModelProto. The graph is partitioned and planned for each replica because
+  * execution providers, and so kernels and allocation plans, are bound to a single device.
+  * Each replica frees its host copy of the initializers once they are in device memory.
+  *
+  * Each Run is dispatched to the replica with the fewest Run calls in progress.
+  *
+  * Usage:
+  *   auto cuda_providers = [](int device_id) {
+  *     std::vector<std::unique_ptr<IExecutionProvider>> providers;
+  *     providers.push_back(std::make_unique<CUDAExecutionProvider>(CUDAExecutionProviderInfo{device_id}));
+  *     return providers;
+  *   };
+  *   std::unique_ptr<ReplicatedSession> replicated_session;
+  *   ORT_RETURN_IF_ERROR(ReplicatedSession::Create(so, model_uri, {0, 1, 2, 3}, cuda_providers,
+  *                                                 &logging_manager, replicated_session));
+  *   // on many threads concurrently
+  *   ORT_RETURN_IF_ERROR(replicated_session->Run(run_options, feeds, output_names, &fetches));
+  */
+class ReplicatedSession {
+ public:
+  /**
+    * Load and initialize a replica of the model for each device id.
+    * @param logging_manager see InferenceSession::InferenceSession.
+    * @return INVALID_ARGUMENT if device_ids is empty, or the error of the first replica that fails to initialize.
+    */
+  static common::Status Create(const SessionOptions& session_options,
+                               const std::string& model_uri,
+                               const std::vector<int>& device_ids,
+                               const ReplicaProviderFactory& provider_factory,
+                               logging::LoggingManager* logging_manager,
+                               std::unique_ptr<ReplicatedSession>& replicated_session);
+
+  ~ReplicatedSession();
+
+  /**
+    * Run the model on the least loaded replica.
+    * @see InferenceSession::Run
+    */
+  common::Status Run(const RunOptions& run_options,
+                     const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<MLValue>* p_fetches);
+
+  size_t NumReplicas() const { return replicas_.size(); }
+
+  /**
+    * The session on device_ids[index], e.g. to query its inputs and outputs.
+    * Runs called on the session directly aren't seen by the load balancing of ReplicatedSession::Run.
+    */
+  InferenceSession& GetReplica(size_t index) const { return *replicas_.at(index).session; }
+
+  /**
+    * Get the number of Run calls in progress on each replica.
+    */
+  std::vector<int> GetReplicaLoads() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ReplicatedSession);
+
+  struct Replica {
+    int device_id;
+    std::unique_ptr<InferenceSession> session;
+    // Run calls dispatched and not yet returned. Counted here rather than with InferenceSession::GetCurrentNumRuns
+    // so that a replica is seen as busy as soon as a Run is dispatched to it.
+    std::unique_ptr<std::atomic<int>> num_runs;
+  };
+
+  ReplicatedSession() = default;
+
+  Replica& PickReplica();
+
+  std::vector<Replica> replicas_;
+  // rotates the replica checked first so that idle replicas share the work
+  std::atomic<size_t> next_replica_{0};
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/streaming_session.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "core/framework/tensor.h"
+#include "core/graph/graph_viewer.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+template <typename DefList>
+static bool HasDef(const DefList& defs, const std::string& name) {
+  return std::any_of(defs.cbegin(), defs.cend(), [&name](const NodeArg* def) { return def->Name() == name; });
+}
+
+// a tensor of the type and shape of tensor, in a buffer from allocator
+static MLValue AllocateLike(const Tensor& tensor, const AllocatorPtr& allocator) {
+  const auto& shape = tensor.Shape();
+  auto new_tensor = std::make_unique<Tensor>(tensor.DataType(), shape,
+                                             allocator->Alloc(shape.Size() * tensor.DataType()->Size()),
+                                             allocator->Info(), allocator);
+
+  return MLValue{new_tensor.release(),
+                 DataTypeImpl::GetType<Tensor>(),
+                 DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+Status StreamingSession::Create(InferenceSession& session, const std::vector<StateBinding>& state_bindings,
+                                std::unique_ptr<StreamingSession>& streaming_session) {
+  if (state_bindings.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "At least one state binding is required.");
+  }
+
+  auto inputs = session.GetModelInputs();
+  ORT_RETURN_IF_ERROR(inputs.first);
+  auto outputs = session.GetModelOutputs();
+  ORT_RETURN_IF_ERROR(outputs.first);
+
+  std::unordered_set<std::string> bound_inputs;
+  std::unordered_set<std::string> bound_outputs;
+  for (const auto& binding : state_bindings) {
+    if (!HasDef(*outputs.second, binding.output_name)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The model has no output named ", binding.output_name);
+    }
+
+    if (!HasDef(*inputs.second, binding.input_name)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The model has no input named ", binding.input_name);
+    }
+
+    if (!bound_outputs.insert(binding.output_name).second || !bound_inputs.insert(binding.input_name).second) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The state binding of ", binding.output_name, " to ",
+                             binding.input_name, " binds an output or input that is already bound.");
+    }
+  }
+
+  streaming_session.reset(new StreamingSession(session, state_bindings));
+  return Status::OK();
+}
+
+Status StreamingSession::OpenStream(const NameMLValMap& initial_state, StreamId& stream_id) {
+  auto stream = std::make_shared<Stream>();
+  stream->states.reserve(state_bindings_.size());
+
+  for (const auto& binding : state_bindings_) {
+    auto entry = initial_state.find(binding.input_name);
+    if (entry == initial_state.cend() || !entry->second.IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The initial state has no tensor for ",
+                             binding.input_name);
+    }
+
+    const auto& tensor = entry->second.Get<Tensor>();
+    if (tensor.DataType() == DataTypeImpl::GetType<std::string>()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The state of ", binding.input_name,
+                             " is a string tensor, which isn't supported.");
+    }
+
+    // the state is kept where the caller created it
+    auto allocator = session_.GetAllocator(tensor.Location());
+    if (allocator == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The session has no allocator for the state of ",
+                             binding.input_name, " at ", tensor.Location().ToString());
+    }
+
+    stream->states.push_back(State{entry->second, MLValue(), false, allocator});
+  }
+
+  stream_id = next_stream_id_++;
+
+  std::lock_guard<OrtMutex> lock(streams_mutex_);
+  streams_[stream_id] = std::move(stream);
+  return Status::OK();
+}
+
+std::shared_ptr<StreamingSession::Stream> StreamingSession::FindStream(StreamId stream_id) const {
+  std::lock_guard<OrtMutex> lock(streams_mutex_);
+  auto entry = streams_.find(stream_id);
+  return entry == streams_.cend() ? nullptr : entry->second;
+}
+
+Status StreamingSession::Run(const RunOptions& run_options,
+                             StreamId stream_id,
+                             const NameMLValMap& feeds,
+                             const std::vector<std::string>& output_names,
+                             std::vector<MLValue>* p_fetches) {
+  ORT_RETURN_IF_NOT(p_fetches != nullptr, "Output vector pointer is NULL");
+
+  auto stream = FindStream(stream_id);
+  if (stream == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Stream ", stream_id, " is not open.");
+  }
+
+  std::lock_guard<OrtMutex> lock(stream->mutex);
+
+  NameMLValMap run_feeds{feeds};
+  std::vector<std::string> run_output_names{output_names};
+  std::vector<MLValue> run_fetches;
+  if (p_fetches->empty()) {
+    run_fetches.resize(output_names.size());
+  } else {
+    ORT_RETURN_IF_NOT(p_fetches->size() == output_names.size(), "The number of preallocated fetches ",
+                      p_fetches->size(), " doesn't match the number of output names ", output_names.size());
+    run_fetches = *p_fetches;
+  }
+
+  // the index of every bound output in run_fetches
+  std::vector<size_t> state_fetch_idxs;
+  state_fetch_idxs.reserve(state_bindings_.size());
+
+  for (size_t i = 0, end = state_bindings_.size(); i < end; ++i) {
+    const auto& binding = state_bindings_[i];
+    auto& state = stream->states[i];
+
+    if (feeds.count(binding.input_name)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", binding.input_name,
+                             " is fed with the state of the stream.");
+    }
+
+    run_feeds[binding.input_name] = state.current;
+
+    if (!state.spare.IsAllocated()) {
+      state.spare = AllocateLike(state.current.Get<Tensor>(), state.allocator);
+    }
+
+    auto requested = std::find(output_names.cbegin(), output_names.cend(), binding.output_name);
+    if (requested == output_names.cend()) {
+      state_fetch_idxs.push_back(run_output_names.size());
+      run_output_names.push_back(binding.output_name);
+      run_fetches.push_back(state.spare);
+    } else {
+      const size_t idx = requested - output_names.cbegin();
+      state_fetch_idxs.push_back(idx);
+      // a fetch the caller preallocated is written as well, and becomes the state. the state fetched by a
+      // previous Run is what this Run reads, so it is replaced like a missing fetch.
+      const MLValue& fetch = run_fetches[idx];
+      if (!fetch.IsAllocated() || (fetch.IsTensor() && &fetch.Get<Tensor>() == &state.current.Get<Tensor>())) {
+        run_fetches[idx] = state.spare;
+      }
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(session_.Run(run_options, run_feeds, run_output_names, &run_fetches));
+
+  for (size_t i = 0, end = state_bindings_.size(); i < end; ++i) {
+    auto& state = stream->states[i];
+    const MLValue& produced = run_fetches[state_fetch_idxs[i]];
+
+    const bool produced_in_spare = produced.IsTensor() && &produced.Get<Tensor>() == &state.spare.Get<Tensor>();
+    if (produced_in_spare) {
+      // the buffer the state was read from is written by the next Run, unless it belongs to the caller
+      MLValue previous = state.current;
+      state.current = produced;
+      state.spare = state.current_is_owned ? previous : MLValue();
+      state.current_is_owned = true;
+    } else {
+      // a fetch the caller preallocated. the spare buffer is still free.
+      state.current = produced;
+      state.current_is_owned = false;
+    }
+  }
+
+  p_fetches->assign(run_fetches.begin(), run_fetches.begin() + output_names.size());
+  return Status::OK();
+}
+
+Status StreamingSession::CloseStream(StreamId stream_id) {
+  std::shared_ptr<Stream> stream;
+  {
+    std::lock_guard<OrtMutex> lock(streams_mutex_);
+    auto entry = streams_.find(stream_id);
+    if (entry == streams_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Stream ", stream_id, " is not open.");
+    }
+
+    stream = std::move(entry->second);
+    streams_.erase(entry);
+  }
+
+  // wait for a Run of the stream in progress
+  std::lock_guard<OrtMutex> lock(stream->mutex);
+  return Status::OK();
+}
+
+size_t StreamingSession::NumStreams() const {
+  std::lock_guard<OrtMutex> lock(streams_mutex_);
+  return streams_.size();
+}
+
+}  // namespace onnxruntime
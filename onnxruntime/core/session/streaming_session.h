@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ml_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+/**
+  * A model output that is fed back to a model input on the next Run of a stream, e.g. the hidden or cell state
+  * of an LSTM. The output must have the same type and shape as the input.
+  */
+struct StateBinding {
+  std::string output_name;
+  std::string input_name;
+};
+
+/**
+  * Runs a model over many independent streams, such as the chunks of audio of concurrent speech recognition
+  * requests, with the recurrent state of each stream kept in the session between Run calls.
+  *
+  * Every Run of a stream feeds the bound inputs with the state the previous Run of the stream produced, and the
+  * state the Run produces is kept for the next one. The state stays where it was created: a stream opened with
+  * its initial state on a device keeps the state in two buffers on that device, and each Run writes the new state
+  * to the buffer the previous Run didn't, so no state is copied to or from the host or allocated per Run.
+  *
+  * Runs of different streams can be called concurrently. Runs of the same stream are run one after the other.
+  *
+  * Usage:
+  *   std::unique_ptr<StreamingSession> streaming_session;
+  *   ORT_RETURN_IF_ERROR(StreamingSession::Create(session, {{"Y_h", "initial_h"}, {"Y_c", "initial_c"}},
+  *                                                streaming_session));
+  *   StreamingSession::StreamId stream;
+  *   ORT_RETURN_IF_ERROR(streaming_session->OpenStream({{"initial_h", h0}, {"initial_c", c0}}, stream));
+  *   // for every chunk of the stream
+  *   ORT_RETURN_IF_ERROR(streaming_session->Run(run_options, stream, {{"X", chunk}}, {"Y"}, &fetches));
+  *   ORT_RETURN_IF_ERROR(streaming_session->CloseStream(stream));
+  */
+class StreamingSession {
+ public:
+  using StreamId = int64_t;
+
+  /**
+    * Create a StreamingSession over an initialized InferenceSession.
+    * @param session must outlive the StreamingSession.
+    * @return INVALID_ARGUMENT if there are no state bindings, or a binding names an output or input the model
+    *         doesn't have, or an input or output is bound twice.
+    */
+  static common::Status Create(InferenceSession& session, const std::vector<StateBinding>& state_bindings,
+                               std::unique_ptr<StreamingSession>& streaming_session);
+
+  /**
+    * Open a stream.
+    * @param initial_state the value of every bound input for the first Run of the stream, by input name.
+    *        The values aren't written to. String tensors aren't supported.
+    * @param stream_id set to the id of the new stream.
+    */
+  common::Status OpenStream(const NameMLValMap& initial_state, StreamId& stream_id);
+
+  /**
+    * Run the model for the next chunk of a stream.
+    * @param feeds the model inputs apart from the bound ones.
+    * @param output_names may include bound outputs. The fetched state is only valid until the next Run of the
+    *        stream, which writes the state after it to a buffer that may be shared with the fetched value.
+    * @return INVALID_ARGUMENT if the stream isn't open or feeds contains a bound input.
+    * @see InferenceSession::Run
+    */
+  common::Status Run(const RunOptions& run_options,
+                     StreamId stream_id,
+                     const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<MLValue>* p_fetches);
+
+  /**
+    * Close a stream and release its state. A Run of the stream in progress completes first.
+    * @return INVALID_ARGUMENT if the stream isn't open.
+    */
+  common::Status CloseStream(StreamId stream_id);
+
+  size_t NumStreams() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(StreamingSession);
+
+  // the state of one binding in a stream
+  struct State {
+    // fed to the bound input by the next Run
+    MLValue current;
+    // the buffer the next Run writes the bound output to, empty if it is yet to be allocated
+    MLValue spare;
+    // false while current is the initial state, which belongs to the caller and is never written
+    bool current_is_owned;
+    AllocatorPtr allocator;
+  };
+
+  struct Stream {
+    // runs of the stream are serialized
+    OrtMutex mutex;
+    // in the order of state_bindings_
+    std::vector<State> states;
+  };
+
+  StreamingSession(InferenceSession& session, const std::vector<StateBinding>& state_bindings)
+      : session_{session}, state_bindings_{state_bindings} {}
+
+  std::shared_ptr<Stream> FindStream(StreamId stream_id) const;
+
+  InferenceSession& session_;
+  const std::vector<StateBinding> state_bindings_;
+
+  mutable OrtMutex streams_mutex_;
+  std::unordered_map<StreamId, std::shared_ptr<Stream>> streams_;
+  std::atomic<StreamId> next_stream_id_{0};
+};
+
+}  // namespace onnxruntime
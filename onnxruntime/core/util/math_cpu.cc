@@ -33,6 +33,7 @@
 #include <chrono>
 #include <random>
 #include <unordered_set>
+#include <vector>
 #include "core/platform/env.h"
 #include "core/common/logging/logging.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
@@ -241,6 +242,9 @@ void Gemv<float, CPUMathUtil>(
     float* y,
     CPUMathUtil* /*provider*/,
     MLDataType /*math_type*/) {
+#if defined(USE_MLAS)
+  MlasSgemv(TransA, M, N, alpha, A, N, x, beta, y);
+#else
   EigenVectorMap<float> y_vec(y, TransA == CblasNoTrans ? M : N);
   if (beta == 0) {
     // In Caffe2 we often do a lazy initialization, which may contain NaNs in
@@ -263,6 +267,7 @@ void Gemv<float, CPUMathUtil>(
     default:
       ORT_THROW("Gemv float found an unexpected CBLAS_TRANSPOSE input of", TransA);
   }
+#endif
 }
 
 #define SPECIALIZED_SCALE(T)                                                         \
@@ -458,6 +463,20 @@ void GemmBatched<float, CPUMathUtil>(
   auto a_offset = A_size / A_batches;
   auto b_offset = B_size / B_batches;
   auto y_offset = M * N;
+#if defined(USE_MLAS) && !defined(USE_MKLDNN) && !defined(USE_MKLML_FOR_BLAS)
+  // a single dispatch threaded across the batch rather than a Gemm per matrix
+  std::vector<size_t> offsets_a(A_batches);
+  std::vector<size_t> offsets_b(A_batches);
+  std::vector<size_t> offsets_c(A_batches);
+  for (int i = 0; i < A_batches; ++i) {
+    offsets_a[i] = static_cast<size_t>(a_offset) * i;
+    offsets_b[i] = static_cast<size_t>(b_offset) * i;
+    offsets_c[i] = static_cast<size_t>(y_offset) * i;
+  }
+  MlasSgemmBatch(TransA, TransB, M, N, K, 1.0f, A, TransA == CblasNoTrans ? K : M, offsets_a.data(),
+                 B, TransB == CblasNoTrans ? N : K, offsets_b.data(), 0.0f, C, N, offsets_c.data(), A_batches);
+  ORT_UNUSED_PARAMETER(provider);
+#else
   // loop over matrices in the batch
   for (int i = 0; i < A_batches; ++i) {
     math::Gemm<float, CPUMathUtil>(
@@ -473,6 +492,7 @@ void GemmBatched<float, CPUMathUtil>(
         C + y_offset * i,
         provider);
   }
+#endif
 }
 
   // MKL will be implmenet as an execution provider
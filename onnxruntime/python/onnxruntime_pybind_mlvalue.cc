@@ -8,6 +8,8 @@
 #define PY_ARRAY_UNIQUE_SYMBOL onnxruntime_python_ARRAY_API
 #include <numpy/arrayobject.h>
 
+#include <dlpack/dlpack.h>
+
 #include "core/graph/graph.h"
 #include "core/framework/tensor_shape.h"
 #include "core/framework/tensor.h"
@@ -75,7 +77,68 @@ bool PyObjectCheck_Array(PyObject* o) {
   return PyObject_HasAttrString(o, "__array_finalize__");
 }
 
+static std::vector<int64_t> GetArrayShape(PyArrayObject* pyObject) {
+  // numpy requires long int as its dims.
+  int ndim = PyArray_NDIM(pyObject);
+  npy_intp* npy_dims = PyArray_DIMS(pyObject);
+  std::vector<int64_t> dims(ndim);
+  for (int i = 0; i < ndim; ++i) {
+    dims[i] = npy_dims[i];
+  }
+  return dims;
+}
+
+// The deleter of a tensor that borrows the buffer of a numpy array. It keeps the array alive until the tensor is
+// released, which may happen after the call that created it returned, e.g. if a fetch refers to the feed.
+class NumpyArrayBuffer : public IAllocator {
+ public:
+  NumpyArrayBuffer(PyArrayObject* array, const OrtAllocatorInfo& info) : array_(array), info_(info) {
+    Py_INCREF(array_);
+  }
+
+  ~NumpyArrayBuffer() override {
+    py::gil_scoped_acquire gil;
+    Py_DECREF(array_);
+  }
+
+  void* Alloc(size_t) override {
+    throw std::runtime_error("The buffer of a numpy array can't allocate.");
+  }
+
+  // the buffer belongs to the array
+  void Free(void*) override {}
+
+  const OrtAllocatorInfo& Info() const override {
+    return info_;
+  }
+
+ private:
+  PyArrayObject* array_;
+  const OrtAllocatorInfo info_;
+};
+
+// Whether a tensor can use the buffer of the array rather than a copy of it, which requires the elements of the
+// array to be laid out as they are in a tensor.
+static bool CanBorrowBuffer(PyArrayObject* pyObject, int npy_type) {
+  return npy_type != NPY_UNICODE && npy_type != NPY_STRING && npy_type != NPY_VOID && npy_type != NPY_OBJECT &&
+         PyArray_IS_C_CONTIGUOUS(pyObject) && PyArray_ISALIGNED(pyObject) && PyArray_ISNOTSWAPPED(pyObject);
+}
+
 void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyArrayObject* pyObject, MLValue* p_mlvalue) {
+  const int input_type = PyArray_TYPE(pyObject);
+  if (CanBorrowBuffer(pyObject, input_type)) {
+    auto element_type = NumpyToOnnxRuntimeTensorType(input_type);
+    if (static_cast<size_t>(PyArray_ITEMSIZE(pyObject)) == element_type->Size()) {
+      auto buffer = std::make_shared<NumpyArrayBuffer>(pyObject, alloc->Info());
+      std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type, TensorShape(GetArrayShape(pyObject)),
+                                                                  PyArray_DATA(pyObject), buffer->Info(), buffer);
+      p_mlvalue->Init(p_tensor.release(),
+                      DataTypeImpl::GetType<Tensor>(),
+                      DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+      return;
+    }
+  }
+
   PyArrayObject* darray = PyArray_GETCONTIGUOUS(pyObject);
   if (darray == NULL) {
     throw std::runtime_error(std::string("The object must be a contiguous array for input '") + name_input + std::string("'."));
@@ -83,16 +146,7 @@ void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyAr
   bool dref = false;
   try {
     const int npy_type = PyArray_TYPE(darray);
-
-    // numpy requires long int as its dims.
-    int ndim = PyArray_NDIM(darray);
-    npy_intp* npy_dims = PyArray_DIMS(darray);
-    std::vector<int64_t> dims(ndim);
-    for (int i = 0; i < ndim; ++i) {
-      dims[i] = npy_dims[i];
-    }
-
-    TensorShape shape(dims);
+    TensorShape shape(GetArrayShape(darray));
     auto element_type = NumpyToOnnxRuntimeTensorType(npy_type);
     void* buffer = alloc->Alloc(element_type->Size() * shape.Size());
 
@@ -413,5 +467,220 @@ void CreateGenericMLValue(AllocatorPtr alloc, const std::string& name_input, py:
   }
 }
 
+namespace {
+const char* const kDLTensorName = "dltensor";
+// the name a consumer renames a capsule to once it owns its DLManagedTensor
+const char* const kUsedDLTensorName = "used_dltensor";
+
+MLDataType DLDataTypeToOnnxRuntime(const DLDataType& dtype) {
+  if (dtype.lanes == 1) {
+    switch (dtype.code) {
+      case kDLFloat:
+        switch (dtype.bits) {
+          case 16:
+            return DataTypeImpl::GetType<MLFloat16>();
+          case 32:
+            return DataTypeImpl::GetType<float>();
+          case 64:
+            return DataTypeImpl::GetType<double>();
+        }
+        break;
+      case kDLInt:
+        switch (dtype.bits) {
+          case 8:
+            return DataTypeImpl::GetType<int8_t>();
+          case 16:
+            return DataTypeImpl::GetType<int16_t>();
+          case 32:
+            return DataTypeImpl::GetType<int32_t>();
+          case 64:
+            return DataTypeImpl::GetType<int64_t>();
+        }
+        break;
+      case kDLUInt:
+        switch (dtype.bits) {
+          case 8:
+            return DataTypeImpl::GetType<uint8_t>();
+          case 16:
+            return DataTypeImpl::GetType<uint16_t>();
+          case 32:
+            return DataTypeImpl::GetType<uint32_t>();
+          case 64:
+            return DataTypeImpl::GetType<uint64_t>();
+        }
+        break;
+    }
+  }
+  throw std::runtime_error("Unsupported DLPack data type code " + std::to_string(dtype.code) + " of " +
+                           std::to_string(dtype.bits) + " bits and " + std::to_string(dtype.lanes) + " lanes.");
+}
+
+DLDataType OnnxRuntimeToDLDataType(MLDataType type) {
+  static const std::map<MLDataType, DLDataType> type_map{
+      {DataTypeImpl::GetType<MLFloat16>(), {kDLFloat, 16, 1}},
+      {DataTypeImpl::GetType<float>(), {kDLFloat, 32, 1}},
+      {DataTypeImpl::GetType<double>(), {kDLFloat, 64, 1}},
+      {DataTypeImpl::GetType<int8_t>(), {kDLInt, 8, 1}},
+      {DataTypeImpl::GetType<int16_t>(), {kDLInt, 16, 1}},
+      {DataTypeImpl::GetType<int32_t>(), {kDLInt, 32, 1}},
+      {DataTypeImpl::GetType<int64_t>(), {kDLInt, 64, 1}},
+      {DataTypeImpl::GetType<uint8_t>(), {kDLUInt, 8, 1}},
+      {DataTypeImpl::GetType<uint16_t>(), {kDLUInt, 16, 1}},
+      {DataTypeImpl::GetType<uint32_t>(), {kDLUInt, 32, 1}},
+      {DataTypeImpl::GetType<uint64_t>(), {kDLUInt, 64, 1}},
+  };
+  const auto it = type_map.find(type);
+  if (it == type_map.end()) {
+    throw std::runtime_error("No corresponding DLPack data type for Tensor Type.");
+  }
+  return it->second;
+}
+
+// the DLPack device type name of a location, and back
+std::string DLDeviceTypeName(DLDeviceType device_type) {
+  switch (device_type) {
+    case kDLCPU:
+      return "cpu";
+    case kDLGPU:
+      return "cuda";
+    case kDLCPUPinned:
+      return "cuda_pinned";
+    default:
+      throw std::runtime_error("Unsupported DLPack device type " + std::to_string(device_type) + ".");
+  }
+}
+
+DLContext LocationToDLContext(const OrtAllocatorInfo& location) {
+  if (strcmp(location.name, CPU) == 0) {
+    return {kDLCPU, 0};
+  }
+  if (strcmp(location.name, "Cuda") == 0) {
+    return {kDLGPU, location.id};
+  }
+  if (strcmp(location.name, "CudaPinned") == 0) {
+    return {kDLCPUPinned, 0};
+  }
+  throw std::runtime_error(std::string("No DLPack device for the memory of ") + location.name + ".");
+}
+
+// The deleter of a tensor over the memory of a DLManagedTensor, which it releases with the tensor.
+class DLPackBuffer : public IAllocator {
+ public:
+  DLPackBuffer(DLManagedTensor* dl_managed, const OrtAllocatorInfo& info) : dl_managed_(dl_managed), info_(info) {}
+
+  ~DLPackBuffer() override {
+    // the deleter of the producer may release a Python object, e.g. a PyTorch tensor
+    py::gil_scoped_acquire gil;
+    if (dl_managed_->deleter != nullptr) {
+      dl_managed_->deleter(dl_managed_);
+    }
+  }
+
+  void* Alloc(size_t) override {
+    throw std::runtime_error("The buffer of a DLPack tensor can't allocate.");
+  }
+
+  // the buffer belongs to the DLManagedTensor
+  void Free(void*) override {}
+
+  const OrtAllocatorInfo& Info() const override {
+    return info_;
+  }
+
+ private:
+  DLManagedTensor* dl_managed_;
+  const OrtAllocatorInfo info_;
+};
+
+// the value a DLPack capsule of an ONNX Runtime tensor owns
+struct DLPackExport {
+  MLValue value;
+  std::vector<int64_t> shape;
+  DLManagedTensor dl_managed;
+};
+
+void DeleteDLPackExport(DLManagedTensor* dl_managed) {
+  delete static_cast<DLPackExport*>(dl_managed->manager_ctx);
+}
+
+void DeleteUnusedDLPackCapsule(PyObject* capsule) {
+  // a consumer renamed the capsule if it took the tensor
+  if (PyCapsule_IsValid(capsule, kDLTensorName)) {
+    auto* dl_managed = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule, kDLTensorName));
+    dl_managed->deleter(dl_managed);
+  }
+}
+}  // namespace
+
+bool IsDLPack(const py::object& value) {
+  return PyCapsule_IsValid(value.ptr(), kDLTensorName) || py::hasattr(value, "__dlpack__");
+}
+
+void CreateMLValueFromDLPack(py::object& value,
+                             const std::function<OrtAllocatorInfo(const std::string&, int)>& get_location,
+                             MLValue* p_mlvalue) {
+  py::object capsule = PyCapsule_IsValid(value.ptr(), kDLTensorName) ? value : value.attr("__dlpack__")();
+  if (!PyCapsule_IsValid(capsule.ptr(), kDLTensorName)) {
+    throw std::runtime_error("The DLPack capsule was already consumed.");
+  }
+  auto* dl_managed = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule.ptr(), kDLTensorName));
+  const DLTensor& dl_tensor = dl_managed->dl_tensor;
+
+  std::vector<int64_t> dims(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  // a tensor is laid out in row-major order without gaps, strides of dimensions of 1 element don't matter
+  if (dl_tensor.strides != nullptr) {
+    int64_t expected_stride = 1;
+    for (int i = dl_tensor.ndim - 1; i >= 0; --i) {
+      if (dims[i] != 1 && dl_tensor.strides[i] != expected_stride) {
+        throw std::runtime_error("A DLPack tensor must be contiguous to be fed, e.g. torch.Tensor.contiguous().");
+      }
+      expected_stride *= dims[i];
+    }
+  }
+
+  MLDataType element_type = DLDataTypeToOnnxRuntime(dl_tensor.dtype);
+  OrtAllocatorInfo location = get_location(DLDeviceTypeName(dl_tensor.ctx.device_type), dl_tensor.ctx.device_id);
+  void* data = static_cast<char*>(dl_tensor.data) + dl_tensor.byte_offset;
+
+  // the tensor owns the DLManagedTensor from here on
+  auto buffer = std::make_shared<DLPackBuffer>(dl_managed, location);
+  if (PyCapsule_SetName(capsule.ptr(), kUsedDLTensorName) != 0) {
+    throw py::error_already_set();
+  }
+  auto p_tensor = std::make_unique<Tensor>(element_type, TensorShape(dims), data, buffer->Info(), buffer);
+  p_mlvalue->Init(p_tensor.release(),
+                  DataTypeImpl::GetType<Tensor>(),
+                  DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+}
+
+py::object ToDLPack(const MLValue& value) {
+  if (!value.IsTensor()) {
+    throw std::runtime_error("Only a tensor can be exported as DLPack.");
+  }
+  const Tensor& tensor = value.Get<Tensor>();
+  auto exported = std::make_unique<DLPackExport>();
+  exported->value = value;
+  exported->shape = tensor.Shape().GetDims();
+
+  DLTensor& dl_tensor = exported->dl_managed.dl_tensor;
+  dl_tensor.data = const_cast<void*>(tensor.DataRaw());
+  dl_tensor.ctx = LocationToDLContext(tensor.Location());
+  dl_tensor.ndim = static_cast<int>(exported->shape.size());
+  dl_tensor.dtype = OnnxRuntimeToDLDataType(tensor.DataType());
+  dl_tensor.shape = exported->shape.data();
+  // compact row-major
+  dl_tensor.strides = nullptr;
+  dl_tensor.byte_offset = 0;
+  exported->dl_managed.manager_ctx = exported.get();
+  exported->dl_managed.deleter = DeleteDLPackExport;
+
+  PyObject* capsule = PyCapsule_New(&exported->dl_managed, kDLTensorName, DeleteUnusedDLPackCapsule);
+  if (capsule == nullptr) {
+    throw py::error_already_set();
+  }
+  exported.release();
+  return py::reinterpret_steal<py::object>(capsule);
+}
+
 }  // namespace python
 }  // namespace onnxruntime
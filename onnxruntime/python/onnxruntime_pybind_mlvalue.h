@@ -7,6 +7,8 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <functional>
+
 #include "core/common/logging/logging.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/sinks/cerr_sink.h"
@@ -26,5 +28,18 @@ int OnnxRuntimeTensorToNumpyType(const DataTypeImpl* tensor_type);
 
 void CreateGenericMLValue(AllocatorPtr alloc, const std::string& name_input, py::object& value, MLValue* p_mlvalue);
 
+// Whether value is a DLPack capsule or an object of the DLPack protocol, e.g. a PyTorch or CuPy tensor.
+bool IsDLPack(const py::object& value);
+
+// Creates a tensor MLValue over the memory of a DLPack capsule, or of the capsule value.__dlpack__() returns, without
+// copying it. The tensor takes the ownership of the DLManagedTensor from the capsule. get_location returns the
+// location of the session for a DLPack device type name ("cpu", "cuda" or "cuda_pinned") and device id.
+void CreateMLValueFromDLPack(py::object& value,
+                             const std::function<OrtAllocatorInfo(const std::string&, int)>& get_location,
+                             MLValue* p_mlvalue);
+
+// Exports the tensor of value as a DLPack capsule that shares its buffer and keeps it alive.
+py::object ToDLPack(const MLValue& value);
+
 }  // namespace python
 }  // namespace onnxruntime
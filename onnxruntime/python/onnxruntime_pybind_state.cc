@@ -8,6 +8,7 @@
 #include <numpy/arrayobject.h>
 
 #include "core/graph/graph_viewer.h"
+#include "core/session/IOBinding.h"
 
 #if USE_CUDA
 #define BACKEND_PROC "GPU"
@@ -55,12 +56,16 @@
 #ifdef USE_NUPHAR
 #include "core/providers/nuphar/nuphar_provider_factory.h"
 #endif
+#ifdef USE_TRT
+#include "core/providers/trt/trt_provider_factory.h"
+#endif
 
 namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Mkldnn(int use_arena);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nuphar(int device_id, const char*);
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_TRT(int device_id, const char*);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_BrainSlice(int id, bool f, const char*, const char*, const char*);
 }  // namespace onnxruntime
 
@@ -68,6 +73,8 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_BrainS
 #pragma warning(disable : 4267 4996 4503 4003)
 #endif  // _MSC_VER
 
+#include <cstring>
+#include <iostream>
 #include <iterator>
 
 #if defined(_MSC_VER)
@@ -142,6 +149,21 @@ void AddTensorAsPyObj(onnxruntime::MLValue& val, vector<py::object>& pyobjs) {
 
   MLDataType dtype = rtensor.DataType();
   const int numpy_type = OnnxRuntimeTensorToNumpyType(dtype);
+
+  // The array takes the buffer of an output no other value refers to, keeping it alive through a capsule that
+  // owns the MLValue, instead of a copy of it.
+  if (numpy_type != NPY_OBJECT && strcmp(rtensor.Location().name, CPU) == 0 && !val.IsShared()) {
+    void* data = const_cast<void*>(rtensor.DataRaw(dtype));
+    py::capsule owner(new MLValue(std::move(val)), [](void* p) { delete static_cast<MLValue*>(p); });
+    py::object obj = py::reinterpret_steal<py::object>(PyArray_SimpleNewFromData(
+        shape.NumDimensions(), npy_dims.data(), numpy_type, data));
+    if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(obj.ptr()), owner.release().ptr()) != 0) {
+      throw std::runtime_error("Failed to set the owner of the buffer of an output.");
+    }
+    pyobjs.push_back(obj);
+    return;
+  }
+
   py::object obj = py::reinterpret_steal<py::object>(PyArray_SimpleNew(
       shape.NumDimensions(), npy_dims.data(), numpy_type));
 
@@ -182,6 +204,69 @@ class SessionObjectInitializer {
   }
 };
 
+// Redirects std::cout and std::cerr to sys.stdout and sys.stderr while it's entered. The redirected streams write
+// through Python, so the calls into a session keep the GIL held while a redirect is entered.
+class OstreamRedirect {
+ public:
+  OstreamRedirect(bool redirect_stdout, bool redirect_stderr)
+      : redirect_stdout_(redirect_stdout), redirect_stderr_(redirect_stderr) {}
+
+  void Enter() {
+    if (entered_) {
+      return;
+    }
+
+    if (redirect_stdout_) {
+      stdout_ = std::make_unique<py::scoped_ostream_redirect>(std::cout, py::module::import("sys").attr("stdout"));
+    }
+    if (redirect_stderr_) {
+      stderr_ = std::make_unique<py::scoped_estream_redirect>(std::cerr, py::module::import("sys").attr("stderr"));
+    }
+    entered_ = true;
+    ++num_entered_;
+  }
+
+  void Exit() {
+    if (!entered_) {
+      return;
+    }
+
+    stdout_.reset();
+    stderr_.reset();
+    entered_ = false;
+    --num_entered_;
+  }
+
+  // only called with the GIL held, which also guards num_entered_
+  static bool AnyEntered() {
+    return num_entered_ > 0;
+  }
+
+ private:
+  const bool redirect_stdout_;
+  const bool redirect_stderr_;
+  bool entered_ = false;
+  std::unique_ptr<py::scoped_ostream_redirect> stdout_;
+  std::unique_ptr<py::scoped_estream_redirect> stderr_;
+  static int num_entered_;
+};
+
+int OstreamRedirect::num_entered_ = 0;
+
+// Releases the GIL for its scope so that other Python threads, including ones using the same session, run meanwhile.
+// Anything that touches a Python object must happen before or after the scope.
+class ScopedGilRelease {
+ public:
+  ScopedGilRelease() {
+    if (!OstreamRedirect::AnyEntered()) {
+      release_ = std::make_unique<py::gil_scoped_release>();
+    }
+  }
+
+ private:
+  std::unique_ptr<py::gil_scoped_release> release_;
+};
+
 inline void RegisterExecutionProvider(InferenceSession* sess, onnxruntime::IExecutionProviderFactory& f) {
   auto p = f.CreateProvider();
   auto status = sess->RegisterExecutionProvider(std::move(p));
@@ -193,6 +278,13 @@ inline void RegisterExecutionProvider(InferenceSession* sess, onnxruntime::IExec
 void InitializeSession(InferenceSession* sess) {
   onnxruntime::common::Status status;
 
+#ifdef USE_TRT
+  // before CUDA, which runs the nodes TensorRT doesn't support
+  {
+    RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_TRT(0, ""));
+  }
+#endif
+
 #ifdef USE_CUDA
   {
     RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CUDA(0));
@@ -217,6 +309,39 @@ void InitializeSession(InferenceSession* sess) {
   }
 }  // namespace python
 
+// the memory a DLPack device type name and device id refer to
+static const char* DLDeviceLocationName(const std::string& device_type, OrtMemType& mem_type) {
+  mem_type = OrtMemTypeDefault;
+  if (device_type == "cpu") {
+    return CPU;
+  }
+  if (device_type == "cuda") {
+    return "Cuda";
+  }
+  if (device_type == "cuda_pinned") {
+    mem_type = OrtMemTypeCPUOutput;
+    return "CudaPinned";
+  }
+  throw std::runtime_error("Unknown device type " + device_type + ", which is one of cpu, cuda and cuda_pinned.");
+}
+
+static AllocatorPtr GetDeviceAllocator(const IOBinding& io_binding, const std::string& device_type, int device_id) {
+  OrtMemType mem_type;
+  const char* name = DLDeviceLocationName(device_type, mem_type);
+  auto allocator = io_binding.GetAllocator(name, device_type == "cuda" ? device_id : 0, mem_type);
+  if (allocator == nullptr) {
+    throw std::runtime_error("The session has no provider for device " + device_type + " " +
+                             std::to_string(device_id) + ".");
+  }
+  return allocator;
+}
+
+static void ThrowIfFailed(const common::Status& status, const char* what) {
+  if (!status.IsOK()) {
+    throw std::runtime_error(std::string(what) + " failed due to: " + status.ToString());
+  }
+}
+
 void addGlobalMethods(py::module& m) {
   m.def("get_session_initializer", &SessionObjectInitializer::Get, "Return a default session object initializer.");
   m.def(
@@ -226,7 +351,20 @@ void addGlobalMethods(py::module& m) {
 
 void addObjectMethods(py::module& m) {
   // allow unit tests to redirect std::cout and std::cerr to sys.stdout and sys.stderr
-  py::add_ostream_redirect(m, "onnxruntime_ostream_redirect");
+  py::class_<OstreamRedirect>(m, "onnxruntime_ostream_redirect")
+      .def(py::init<bool, bool>(), py::arg("stdout") = true, py::arg("stderr") = true)
+      .def("__enter__", [](OstreamRedirect& redirect) { redirect.Enter(); })
+      .def("__exit__", [](OstreamRedirect& redirect, py::args) { redirect.Exit(); });
+  py::enum_<TransformerLevel>(m, "GraphOptimizationLevel", R"pbdoc(Tiers of the built-in graph transformations.)pbdoc")
+      .value("NONE", TransformerLevel::None)
+      .value("BASIC", TransformerLevel::Basic,
+             "Removes redundant nodes such as Identity, merges duplicate nodes and folds constant nodes.")
+      .value("EXTENDED", TransformerLevel::Extended,
+             "Also folds BatchNormalization, Mul and Add into Conv, and MatMul and Add into Gemm.")
+      .value("ALL", TransformerLevel::All,
+             "Also fuses activations into Conv and Gemm and uses the NCHWc layout, which only run on CPU, and "
+             "fuses LayerNormalization, Gelu and Attention.");
+
   py::class_<SessionOptions>(m, "SessionOptions", R"pbdoc(Configuration information for a session.)pbdoc")
       .def(py::init())
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
@@ -234,22 +372,60 @@ void addObjectMethods(py::module& m) {
 The idea is if the input shapes are the same, we could trace the internal memory allocation
 and generate a memory pattern for future request. So next time we could just do one allocation
 with a big chunk for all the internal memory allocation. Default is true.)pbdoc")
+      .def_readwrite("mem_pattern_cache_capacity", &SessionOptions::mem_pattern_cache_capacity,
+                     R"pbdoc(Maximum number of memory patterns to cache. The least recently used pattern is evicted
+when the cache is full. Default is 0 for no limit.)pbdoc")
+      .def_readwrite("mem_pattern_dim_buckets", &SessionOptions::mem_pattern_dim_buckets,
+                     R"pbdoc(Ascending boundaries that input dimensions are rounded up to when caching memory patterns,
+so inputs with similar shapes share a pattern. Default is empty to cache a pattern per distinct input shape.)pbdoc")
       .def_readwrite("enable_cpu_mem_arena", &SessionOptions::enable_cpu_mem_arena,
                      R"pbdoc(Enables the memory arena on CPU. Arena may pre-allocate memory for future usage.
 Set this option to false if you don't want it. Default is True.)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
+      .def_readwrite("enable_elementwise_fusion", &SessionOptions::enable_elementwise_fusion,
+                     R"pbdoc(Replaces chains of element-wise nodes assigned to the CUDA execution provider with a single
+fused kernel. Default is false.)pbdoc")
+      .def_readwrite("enable_cost_based_placement", &SessionOptions::enable_cost_based_placement,
+                     R"pbdoc(Moves the nodes assigned to the CUDA execution provider to CPU where a cost model estimates
+that it saves time, e.g. small shape computations. Default is false.)pbdoc")
+      .def_readwrite("placement_profile_file", &SessionOptions::placement_profile_file,
+                     R"pbdoc(Profile of a session of the same model that calibrates the cost model of
+*enable_cost_based_placement*. Default is empty for the default costs.)pbdoc")
+      .def_readwrite("enable_fp16_mixed_precision", &SessionOptions::enable_fp16_mixed_precision,
+                     R"pbdoc(Runs the float MatMul, Gemm and Conv nodes assigned to the CUDA execution provider, and the
+element-wise ops that follow them, in float16. Softmax, reductions and normalizations stay in float. Default is false.)pbdoc")
       .def_readwrite("enable_sequential_execution", &SessionOptions::enable_sequential_execution,
                      R"pbdoc(Enables sequential execution, disables parallel execution. Default is true.)pbdoc")
       .def_readwrite("max_num_graph_transformation_steps", &SessionOptions::max_num_graph_transformation_steps,
                      R"pbdoc(Runs optimization steps on the execution graph. Default is 5.)pbdoc")
+      .def_readwrite("graph_optimization_level", &SessionOptions::graph_optimization_level,
+                     R"pbdoc(Built-in graph transformations applied before partitioning. Default is
+*GraphOptimizationLevel.EXTENDED*.)pbdoc")
+      .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
+                     R"pbdoc(File the model is written to once it is transformed and partitioned. A session created
+from that file skips the graph transformations. Default is empty to not write it.)pbdoc")
       .def_readwrite("session_logid", &SessionOptions::session_logid,
                      R"pbdoc(Logger id to use for session output.)pbdoc")
       .def_readwrite("session_log_verbosity_level", &SessionOptions::session_log_verbosity_level,
                      R"pbdoc(Applies to session load, initialization, etc. Default is 0.)pbdoc")
       .def_readwrite("session_thread_pool_size", &SessionOptions::session_thread_pool_size,
                      R"pbdoc(How many threads in the session thread pool. Default is 0 to let onnxruntime choose.
-This parameter is unused unless *enable_sequential_execution* is false.)pbdoc");
+This parameter is unused unless *enable_sequential_execution* is false.)pbdoc")
+      .def_readwrite("numa_node", &SessionOptions::numa_node,
+                     R"pbdoc(The NUMA node the session runs on, whose CPUs its intra-op threads are pinned to and whose
+memory its CPU arena is allocated on. Default is -1 for any.)pbdoc")
+      .def_readwrite("enable_cpu_huge_pages", &SessionOptions::enable_cpu_huge_pages,
+                     R"pbdoc(Enables the CPU memory arena on huge pages, if the OS has any. Default is false.)pbdoc")
+      .def_readwrite("use_shared_cpu_arena", &SessionOptions::use_shared_cpu_arena,
+                     R"pbdoc(Allocates the CPU memory of the session from the CPU memory arena the sessions of the
+process share instead of an arena of its own. Default is false.)pbdoc")
+      .def_readwrite("shared_cpu_arena_max_mem", &SessionOptions::shared_cpu_arena_max_mem,
+                     R"pbdoc(Upper limit on the bytes the session has in use in the shared CPU memory arena. Default is
+0 for no limit.)pbdoc")
+      .def_readwrite("lazy_initialization", &SessionOptions::lazy_initialization,
+                     R"pbdoc(Leaves the partitioning and the creation of the kernels to the first run. Default is
+false.)pbdoc");
 
   py::class_<RunOptions>(m, "RunOptions", R"pbdoc(Configuration information for a single Run.)pbdoc")
       .def(py::init())
@@ -259,7 +435,14 @@ This parameter is unused unless *enable_sequential_execution* is false.)pbdoc");
                      "To identify logs generated by a particular Run() invocation.")
       .def_readwrite("terminate", &RunOptions::terminate,
                      R"pbdoc(Set to True to terminate any currently executing calls that are using this
-RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc");
+RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc")
+      .def_readwrite("intra_op_thread_limit", &RunOptions::intra_op_thread_limit,
+                     R"pbdoc(Maximum number of intra-op threads a Run() with this RunOptions instance may use.
+Default is 0 for no limit.)pbdoc")
+      .def_readwrite("priority", &RunOptions::priority,
+                     R"pbdoc(Priority of a Run() with this RunOptions instance on the thread pools it shares with other
+Runs. Greater than 0 for latency-critical requests, which are served first, less than 0 for background work.
+Default is 0.)pbdoc");
 
   py::class_<ModelMetadata>(m, "ModelMetadata", R"pbdoc(Pre-defined and custom metadata about the model.
 It is usually used to identify the model used to run the prediction and
@@ -326,12 +509,71 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           },
           "node shape (assuming the node holds a tensor)");
 
+  py::class_<IOBinding>(m, "SessionIOBinding", R"pbdoc(Binds the inputs and outputs of a session to values and devices.)pbdoc")
+      .def(py::init([](InferenceSession* sess) {
+             std::unique_ptr<IOBinding> io_binding;
+             ThrowIfFailed(sess->NewIOBinding(&io_binding), "NewIOBinding");
+             return io_binding;
+           }),
+           py::keep_alive<1, 2>())
+      .def(
+          "bind_input", [](IOBinding* io_binding, const std::string& name, py::object value) {
+            MLValue ml_value;
+            if (IsDLPack(value)) {
+              auto get_location = [io_binding](const std::string& device_type, int device_id) {
+                return GetDeviceAllocator(*io_binding, device_type, device_id)->Info();
+              };
+              CreateMLValueFromDLPack(value, get_location, &ml_value);
+            } else {
+              CreateGenericMLValue(GetAllocator(), name, value, &ml_value);
+            }
+            ThrowIfFailed(io_binding->BindInput(name, ml_value), "BindInput");
+          },
+          R"pbdoc(Bind an input to a numpy array or to a DLPack tensor, which is fed without a copy where it is.)pbdoc")
+      .def(
+          "bind_output", [](IOBinding* io_binding, const std::string& name, const std::string& device_type, int device_id) {
+            auto allocator = GetDeviceAllocator(*io_binding, device_type, device_id);
+            ThrowIfFailed(io_binding->BindOutput(name, allocator->Info()), "BindOutput");
+          },
+          py::arg("name"), py::arg("device_type") = "cpu", py::arg("device_id") = 0,
+          R"pbdoc(Bind an output to a device, "cpu", "cuda" or "cuda_pinned", where every run leaves it.)pbdoc")
+      .def(
+          "synchronize_inputs", [](IOBinding* io_binding) {
+            ThrowIfFailed(io_binding->SynchronizeInputs(), "SynchronizeInputs");
+          })
+      .def(
+          "get_outputs_as_dlpack", [](IOBinding* io_binding) -> std::vector<py::object> {
+            std::vector<py::object> outputs;
+            for (const auto& output : io_binding->GetOutputs()) {
+              outputs.push_back(ToDLPack(output));
+            }
+            return outputs;
+          },
+          R"pbdoc(The outputs of the last run as DLPack capsules sharing their memory, e.g. for torch.utils.dlpack.from_dlpack.)pbdoc")
+      .def(
+          "copy_outputs_to_cpu", [](IOBinding* io_binding) -> std::vector<py::object> {
+            std::vector<MLValue> cpu_outputs;
+            ThrowIfFailed(io_binding->CopyOutputsToCpu(cpu_outputs), "CopyOutputsToCpu");
+            std::vector<py::object> outputs;
+            outputs.reserve(cpu_outputs.size());
+            for (auto& output : cpu_outputs) {
+              if (output.IsTensor()) {
+                AddTensorAsPyObj(output, outputs);
+              } else {
+                AddNonTensorAsPyObj(output, outputs);
+              }
+            }
+            return outputs;
+          },
+          R"pbdoc(The outputs of the last run as numpy arrays, copied from the devices they were bound to.)pbdoc");
+
   py::class_<SessionObjectInitializer>(m, "SessionObjectInitializer");
   py::class_<InferenceSession>(m, "InferenceSession", R"pbdoc(This is the main class used to run a model.)pbdoc")
       .def(py::init<SessionObjectInitializer, SessionObjectInitializer>())
       .def(py::init<SessionOptions, SessionObjectInitializer>())
       .def(
           "load_model", [](InferenceSession* sess, const std::string& path) {
+            ScopedGilRelease gil_release;
             auto status = sess->Load(path);
             if (!status.IsOK()) {
               throw std::runtime_error(status.ToString().c_str());
@@ -342,6 +584,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
       .def(
           "read_bytes", [](InferenceSession* sess, const py::bytes& serializedModel) {
             std::istringstream buffer(serializedModel);
+            ScopedGilRelease gil_release;
             auto status = sess->Load(buffer);
             if (!status.IsOK()) {
               throw std::runtime_error(status.ToString().c_str());
@@ -373,10 +616,14 @@ including arg name, arg type (contains both type and shape).)pbdoc")
         std::vector<MLValue> fetches;
         common::Status status;
 
-        if (run_options != nullptr) {
-          status = sess->Run(*run_options, feeds, output_names, &fetches);
-        } else {
-          status = sess->Run(feeds, output_names, &fetches);
+        // the feeds were converted with the GIL held and the fetches are converted once it's held again
+        {
+          ScopedGilRelease gil_release;
+          if (run_options != nullptr) {
+            status = sess->Run(*run_options, feeds, output_names, &fetches);
+          } else {
+            status = sess->Run(feeds, output_names, &fetches);
+          }
         }
 
         if (!status.IsOK()) {
@@ -386,7 +633,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
 
         std::vector<py::object> rfetch;
         rfetch.reserve(fetches.size());
-        for (auto _ : fetches) {
+        for (auto& _ : fetches) {
           if (_.IsTensor()) {
             AddTensorAsPyObj(_, rfetch);
           } else {
@@ -395,6 +642,16 @@ including arg name, arg type (contains both type and shape).)pbdoc")
         }
         return rfetch;
       })
+      .def(
+          "run_with_iobinding", [](InferenceSession* sess, IOBinding& io_binding, RunOptions* run_options = nullptr) {
+            common::Status status;
+            {
+              ScopedGilRelease gil_release;
+              status = run_options != nullptr ? sess->Run(*run_options, io_binding) : sess->Run(io_binding);
+            }
+            ThrowIfFailed(status, "Method run_with_iobinding");
+          },
+          py::arg("io_binding"), py::arg("run_options") = nullptr)
       .def("end_profiling", [](InferenceSession* sess) -> std::string {
         return sess->EndProfiling();
       })
@@ -71,6 +71,19 @@ class InferenceSession:
             output_names = [output.name for output in self._outputs_meta]
         return self._sess.run(output_names, input_feed, run_options)
 
+    def io_binding(self):
+        "Return a new :class:`onnxruntime.IOBinding` of the inputs and outputs of the session."
+        return IOBinding(self)
+
+    def run_with_iobinding(self, iobinding, run_options=None):
+        """
+        Compute the predictions of the inputs bound to iobinding into its outputs.
+
+        :param iobinding: See :class:`onnxruntime.IOBinding`.
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        """
+        self._sess.run_with_iobinding(iobinding._iobinding, run_options)
+
     def end_profiling(self):
         """
         End profiling and return results in a file.
@@ -79,3 +92,49 @@ class InferenceSession:
         :meth:`onnxruntime.SessionOptions.enable_profiling`.
         """
         return self._sess.end_profiling()
+
+
+class IOBinding:
+    """
+    Binds the inputs and outputs of a session to values and devices. DLPack tensors, e.g. PyTorch or CuPy tensors on
+    a GPU, are fed where they are, and outputs bound to a device stay there, so that a pipeline on the GPU doesn't
+    copy through the host.
+
+    ::
+
+        binding = sess.io_binding()
+        binding.bind_input("X", torch.utils.dlpack.to_dlpack(x_cuda))
+        binding.bind_output("Y", "cuda")
+        sess.run_with_iobinding(binding)
+        y_cuda = torch.utils.dlpack.from_dlpack(binding.get_outputs_as_dlpack()[0])
+    """
+    def __init__(self, session):
+        self._iobinding = C.SessionIOBinding(session._sess)
+
+    def bind_input(self, name, value):
+        """
+        :param name: input name
+        :param value: a numpy array, or a DLPack capsule or an object with a ``__dlpack__`` method, whose memory
+            is fed without a copy
+        """
+        self._iobinding.bind_input(name, value)
+
+    def bind_output(self, name, device_type="cpu", device_id=0):
+        """
+        :param name: output name
+        :param device_type: "cpu", "cuda" or "cuda_pinned", the memory every run leaves the output in
+        :param device_id: the device of "cuda"
+        """
+        self._iobinding.bind_output(name, device_type, device_id)
+
+    def synchronize_inputs(self):
+        "Wait for the copies of the bound inputs to the devices of their nodes."
+        self._iobinding.synchronize_inputs()
+
+    def get_outputs_as_dlpack(self):
+        "Return the outputs of the last run as DLPack capsules that share their memory."
+        return self._iobinding.get_outputs_as_dlpack()
+
+    def copy_outputs_to_cpu(self):
+        "Return the outputs of the last run as numpy arrays, copied from the devices they are on."
+        return self._iobinding.copy_outputs_to_cpu()
@@ -3,6 +3,7 @@
 
 #include "core/common/logging/capture.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_file_sink.h"
 #include "core/common/logging/sinks/cerr_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/sinks/composite_sink.h"
@@ -122,6 +123,42 @@ TEST(LoggingTests, TestFileSink) {
   DeleteFile(filename);
 }
 
+/// <summary>
+/// Tests that the async_file_sink writes the messages buffered when it's destroyed, and counts the dropped ones.
+/// </summary>
+TEST(LoggingTests, TestAsyncFileSink) {
+  const std::string filename{"TestAsyncFileSink.out"};
+  const std::string logid{"AsyncFileSink"};
+  const Severity min_log_level = Severity::kWARNING;
+
+  {
+    LoggingManager manager{std::unique_ptr<ISink>{new AsyncFileSink{filename, false, false}},
+                           min_log_level, false, InstanceType::Temporal};
+
+    auto logger = manager.CreateLogger(logid);
+
+    for (int i = 0; i < 100; ++i) {
+      LOGS(*logger, WARNING) << "Test message " << i;
+    }
+  }
+
+  CheckStringInFile(filename, "Test message 0");
+  CheckStringInFile(filename, "Test message 99");
+  DeleteFile(filename);
+
+  {
+    LoggingManager manager{std::unique_ptr<ISink>{new AsyncFileSink{filename, false, false, 0}},
+                           min_log_level, false, InstanceType::Temporal};
+
+    auto logger = manager.CreateLogger(logid);
+
+    LOGS(*logger, WARNING) << "Dropped message";
+  }
+
+  CheckStringInFile(filename, "1 log messages were dropped");
+  DeleteFile(filename);
+}
+
 /// <summary>
 /// Tests that a composite_sink works correctly.
 /// </summary>
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/profiler.h"
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::vector<std::string> ReadLines(const std::string& file_name) {
+  std::ifstream file(file_name);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+TEST(ProfilerTest, MergesEventsOfThreads) {
+  profiling::Profiler profiler;
+  profiler.StartProfiling("profiler_test_merge.json");
+  ASSERT_TRUE(profiler.FEnabled());
+
+  const int num_threads = 4;
+  const int num_events = 100;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&profiler, t]() {
+      for (int i = 0; i < num_events; ++i) {
+        auto start_time = profiler.StartTime();
+        profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT, "thread" + std::to_string(t) + "_" + std::to_string(i),
+                                       start_time, {{"op_name", "Op" + std::to_string(t)}});
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto lines = ReadLines(profiler.EndProfiling());
+  ASSERT_EQ(lines.size(), static_cast<size_t>(num_threads * num_events + 2));
+  EXPECT_EQ(lines.front(), "[");
+  EXPECT_EQ(lines.back(), "]");
+
+  // every event is written once with its args, and the events of a thread in the order it recorded them
+  std::vector<int> next_event(num_threads, 0);
+  for (size_t l = 1; l + 1 < lines.size(); ++l) {
+    const auto& line = lines[l];
+    auto name = line.find("\"name\" :\"thread");
+    ASSERT_NE(name, std::string::npos) << line;
+    const int t = line[name + 15] - '0';
+    ASSERT_TRUE(t >= 0 && t < num_threads) << line;
+    EXPECT_NE(line.find("\"thread" + std::to_string(t) + "_" + std::to_string(next_event[t]) + "\""),
+              std::string::npos)
+        << line;
+    EXPECT_NE(line.find("\"op_name\" : \"Op" + std::to_string(t) + "\""), std::string::npos) << line;
+    ++next_event[t];
+  }
+  EXPECT_EQ(next_event, std::vector<int>(num_threads, num_events));
+  EXPECT_FALSE(profiler.FEnabled());
+}
+
+TEST(ProfilerTest, RestartsWithNoEvents) {
+  profiling::Profiler profiler;
+  profiler.StartProfiling("profiler_test_restart.json");
+  auto start_time = profiler.StartTime();
+  profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "first", start_time);
+  EXPECT_EQ(ReadLines(profiler.EndProfiling()).size(), 3u);
+
+  // the events of the first profile aren't written again
+  profiler.StartProfiling("profiler_test_restart.json");
+  start_time = profiler.StartTime();
+  profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "second", start_time);
+  auto lines = ReadLines(profiler.EndProfiling());
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_NE(lines[1].find("\"second\""), std::string::npos);
+}
+
+TEST(ProfilerTest, RecordsEventWithGivenDuration) {
+  profiling::Profiler profiler;
+  profiler.StartProfiling("profiler_test_duration.json");
+  auto start_time = profiler.StartTime();
+  profiler.RecordEvent(profiling::NODE_EVENT, "node_device_time", start_time, 12345, {{"provider", "Device"}});
+  auto lines = ReadLines(profiler.EndProfiling());
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_NE(lines[1].find("\"dur\" :12345,"), std::string::npos) << lines[1];
+  EXPECT_NE(lines[1].find("\"provider\" : \"Device\""), std::string::npos) << lines[1];
+}
+
+}  // namespace test
+}  // namespace onnxruntime
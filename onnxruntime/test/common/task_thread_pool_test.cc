@@ -0,0 +1,295 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/task_thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(TaskThreadPoolTest, RunTaskPropagatesResult) {
+  TaskThreadPool pool(4);
+  std::vector<std::future<void>> results;
+  std::atomic<int> count{0};
+
+  for (int i = 0; i < 100; ++i) {
+    std::packaged_task<void()> task{[&count]() { ++count; }};
+    results.push_back(task.get_future());
+    pool.RunTask(std::move(task));
+  }
+
+  for (auto& result : results) {
+    result.get();
+  }
+
+  EXPECT_EQ(count, 100);
+}
+
+TEST(TaskThreadPoolTest, ScheduleAndWaitWorkComplete) {
+  TaskThreadPool pool(4);
+  std::atomic<int> count{0};
+
+  for (int i = 0; i < 1000; ++i) {
+    pool.Schedule([&count]() { ++count; });
+  }
+
+  pool.WaitWorkComplete();
+  EXPECT_EQ(count, 1000);
+}
+
+// tasks scheduled from a worker go to that worker's deque and must still be run (or stolen) to completion.
+TEST(TaskThreadPoolTest, NestedScheduleFromWorker) {
+  TaskThreadPool pool(4);
+  std::atomic<int> count{0};
+  std::vector<int> thread_ids(16, -2);
+
+  for (int i = 0; i < 16; ++i) {
+    pool.Schedule([&pool, &count, &thread_ids, i]() {
+      thread_ids[i] = pool.CurrentThreadId();
+      for (int j = 0; j < 64; ++j) {
+        pool.Schedule([&count]() { ++count; });
+      }
+    });
+  }
+
+  pool.WaitWorkComplete();
+  EXPECT_EQ(count, 16 * 64);
+  EXPECT_EQ(pool.CurrentThreadId(), -1);
+  for (auto id : thread_ids) {
+    EXPECT_GE(id, 0);
+    EXPECT_LT(id, pool.NumThreads());
+  }
+}
+
+TEST(TaskThreadPoolTest, RunTaskWithID) {
+  TaskThreadPool pool(3);
+  std::vector<std::future<void>> results;
+  std::atomic<bool> valid_ids{true};
+
+  for (int i = 0; i < 30; ++i) {
+    std::packaged_task<void(std::size_t)> task{[&valid_ids](std::size_t id) {
+      if (id >= 3) valid_ids = false;
+    }};
+    results.push_back(task.get_future());
+    pool.RunTaskWithID(std::move(task));
+  }
+
+  for (auto& result : results) {
+    result.get();
+  }
+
+  EXPECT_TRUE(valid_ids);
+}
+
+TEST(TaskThreadPoolTest, ParallelFor) {
+  TaskThreadPool pool(4);
+  std::vector<int> values(1000, 0);
+
+  pool.ParallelFor(static_cast<int32_t>(values.size()), [&values](int32_t i) { values[i] = i; });
+
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+// ParallelFor from a worker must not deadlock even when every worker is doing the same.
+TEST(TaskThreadPoolTest, NestedParallelFor) {
+  TaskThreadPool pool(2);
+  std::atomic<int> count{0};
+
+  pool.ParallelFor(8, [&pool, &count](int32_t) {
+    pool.ParallelFor(16, [&count](int32_t) { ++count; });
+  });
+
+  EXPECT_EQ(count, 8 * 16);
+}
+
+// with a single worker, a task waiting for work it scheduled can only finish by running that work itself.
+TEST(TaskThreadPoolTest, RunPendingTaskFromWorker) {
+  TaskThreadPool pool(1);
+  std::atomic<int> count{0};
+  std::atomic<bool> done{false};
+
+  EXPECT_FALSE(pool.RunPendingTask());
+
+  pool.Schedule([&pool, &count, &done]() {
+    for (int i = 0; i < 10; ++i) {
+      pool.Schedule([&count]() { ++count; });
+    }
+
+    while (count < 10) {
+      pool.RunPendingTask();
+    }
+
+    done = true;
+  });
+
+  pool.WaitWorkComplete();
+  EXPECT_TRUE(done);
+  EXPECT_EQ(count, 10);
+}
+
+TEST(TaskThreadPoolTest, ScopedPriority) {
+  EXPECT_EQ(TaskThreadPool::CurrentPriority(), 0);
+  {
+    TaskThreadPool::ScopedPriority priority(5);
+    EXPECT_EQ(TaskThreadPool::CurrentPriority(), 5);
+    {
+      TaskThreadPool::ScopedPriority background(-1);
+      EXPECT_EQ(TaskThreadPool::CurrentPriority(), -1);
+    }
+    EXPECT_EQ(TaskThreadPool::CurrentPriority(), 5);
+  }
+  EXPECT_EQ(TaskThreadPool::CurrentPriority(), 0);
+}
+
+// the tasks a task submits are queued with its priority.
+TEST(TaskThreadPoolTest, NestedTasksInheritPriority) {
+  TaskThreadPool pool(2);
+  std::atomic<int> outer_priority{0};
+  std::atomic<int> inner_priority{0};
+
+  {
+    TaskThreadPool::ScopedPriority priority(-3);
+    pool.Schedule([&pool, &outer_priority, &inner_priority]() {
+      outer_priority = TaskThreadPool::CurrentPriority();
+      pool.Schedule([&inner_priority]() { inner_priority = TaskThreadPool::CurrentPriority(); });
+    });
+  }
+
+  pool.WaitWorkComplete();
+  EXPECT_EQ(outer_priority, -3);
+  EXPECT_EQ(inner_priority, -3);
+}
+
+// with the only worker busy, the tasks queued meanwhile run latency-critical first and background last, whatever
+// the order they were submitted in.
+TEST(TaskThreadPoolTest, HigherPriorityTasksRunFirst) {
+  TaskThreadPool pool(1);
+  std::atomic<bool> release{false};
+  std::atomic<bool> started{false};
+  pool.Schedule([&release, &started]() {
+    started = true;
+    while (!release) std::this_thread::yield();
+  });
+  while (!started) std::this_thread::yield();
+
+  OrtMutex mutex;
+  std::vector<int> order;
+  auto record = [&mutex, &order](int value) {
+    return [&mutex, &order, value]() {
+      std::lock_guard<OrtMutex> lock(mutex);
+      order.push_back(value);
+    };
+  };
+
+  for (int priority : {-1, 0, 1, -1, 0, 1}) {
+    TaskThreadPool::ScopedPriority scoped_priority(priority);
+    pool.Schedule(record(priority));
+  }
+
+  EXPECT_TRUE(pool.HasHigherPriorityTasks(0));
+  EXPECT_TRUE(pool.HasHigherPriorityTasks(-1));
+  EXPECT_FALSE(pool.HasHigherPriorityTasks(1));
+
+  release = true;
+  pool.WaitWorkComplete();
+  EXPECT_EQ(order, (std::vector<int>{1, 1, 0, 0, -1, -1}));
+}
+
+// a thread outside the pool only helps with the latency-critical tasks.
+TEST(TaskThreadPoolTest, RunHigherPriorityTasksFromOutside) {
+  TaskThreadPool pool(1);
+  std::atomic<bool> release{false};
+  std::atomic<bool> started{false};
+  pool.Schedule([&release, &started]() {
+    started = true;
+    while (!release) std::this_thread::yield();
+  });
+  while (!started) std::this_thread::yield();
+
+  std::atomic<int> high{0};
+  std::atomic<int> normal{0};
+  pool.Schedule([&normal]() { ++normal; });
+  {
+    TaskThreadPool::ScopedPriority priority(1);
+    pool.Schedule([&high]() { ++high; });
+    pool.Schedule([&high]() { ++high; });
+  }
+
+  {
+    TaskThreadPool::ScopedPriority priority(1);
+    EXPECT_EQ(pool.RunHigherPriorityTasks(), 0u);
+  }
+  {
+    TaskThreadPool::ScopedPriority priority(-1);
+    EXPECT_EQ(pool.RunHigherPriorityTasks(), 2u);
+  }
+  EXPECT_EQ(high, 2);
+  EXPECT_EQ(normal, 0);
+
+  release = true;
+  pool.WaitWorkComplete();
+  EXPECT_EQ(normal, 1);
+}
+
+// idle workers spin for the spin duration before they block, and pick up the tasks submitted meanwhile.
+TEST(TaskThreadPoolTest, SpinBeforeBlocking) {
+  TaskThreadPool pool(2);
+  EXPECT_EQ(pool.GetSpinDuration().count(), 0);
+  pool.SetSpinDuration(std::chrono::microseconds(200));
+  EXPECT_EQ(pool.GetSpinDuration().count(), 200);
+
+  std::atomic<int> count{0};
+  for (int i = 0; i < 100; ++i) {
+    pool.Schedule([&count]() { ++count; });
+    if (i % 10 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  pool.WaitWorkComplete();
+  EXPECT_EQ(count, 100);
+}
+
+// workers kept hot neither block the tasks they pick up nor the destruction of the pool.
+TEST(TaskThreadPoolTest, KeepWorkersHot) {
+  const auto start = std::chrono::steady_clock::now();
+  {
+    TaskThreadPool pool(2);
+    // let the workers block first, so keeping them hot has to wake them
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    pool.KeepWorkersHot(std::chrono::seconds(60));
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 10; ++i) {
+      pool.Schedule([&count]() { ++count; });
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    pool.WaitWorkComplete();
+    EXPECT_EQ(count, 10);
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(30));
+}
+
+TEST(TaskThreadPoolTest, EmptyPoolRunsInline) {
+  TaskThreadPool pool(0);
+  int count = 0;
+  pool.Schedule([&count]() { ++count; });
+  pool.WaitWorkComplete();
+  EXPECT_EQ(count, 1);
+
+  pool.ParallelFor(3, [&count](int32_t) { ++count; });
+  EXPECT_EQ(count, 4);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, Attention) {
+  OpTester test("Attention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<float>("scale", 0.5f);
+  test.AddInput<float>("Q", {1, 2, 2}, {2.0f, 0.0f, 0.0f, 2.0f});
+  test.AddInput<float>("K_transposed", {1, 2, 2}, {1.0f, 0.0f, 0.0f, 1.0f});
+  test.AddInput<float>("V", {1, 2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  // the scores are [[1, 0], [0, 1]], whose softmax is [[0.7310586, 0.2689414], [0.2689414, 0.7310586]]
+  test.AddOutput<float>("Y", {1, 2, 2}, {1.5378828f, 2.5378828f, 2.4621172f, 3.4621172f});
+  test.Run();
+}
+
+TEST(ContribOpTest, AttentionWithMask) {
+  OpTester test("Attention", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("Q", {2, 1, 2}, {1.0f, 0.0f, 0.0f, 1.0f});
+  test.AddInput<float>("K_transposed", {2, 2}, {0.0f, 0.0f, 0.0f, 0.0f});
+  test.AddInput<float>("V", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  // the second key is masked for the first batch, the scores of the second batch are equal
+  test.AddInput<float>("mask", {2, 1, 2}, {0.0f, -10000.0f, 0.0f, 0.0f});
+  test.AddOutput<float>("Y", {2, 1, 2}, {1.0f, 2.0f, 2.0f, 3.0f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
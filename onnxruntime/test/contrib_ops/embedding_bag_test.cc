@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+#include "core/util/math.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(EmbeddingBagTest, SumOfLastAxis) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {4, 2},
+                       {0.0f, 1.0f,
+                        10.0f, 11.0f,
+                        20.0f, 21.0f,
+                        30.0f, 31.0f});
+  test.AddInput<int64_t>("indices", {3, 2},
+                         {0, 3,
+                          2, 2,
+                          1, 0});
+  test.AddOutput<float>("output", {3, 2},
+                        {30.0f, 32.0f,
+                         40.0f, 42.0f,
+                         10.0f, 12.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, MeanWithLengths) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("mode", std::string("mean"));
+  test.AddInput<float>("data", {3, 1, 2},
+                       {0.0f, 1.0f,
+                        10.0f, 11.0f,
+                        20.0f, 21.0f});
+  test.AddInput<int32_t>("indices", {5}, {0, 1, 2, 2, 1});
+  test.AddInput<int32_t>("lengths", {3}, {3, 0, 2});
+  // the mean of the empty bag is 0
+  test.AddOutput<float>("output", {3, 1, 2},
+                        {10.0f, 11.0f,
+                         0.0f, 0.0f,
+                         15.0f, 16.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, Float16Table) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  std::vector<MLFloat16> data;
+  for (float value : {0.5f, 1.0f, 2.0f, -4.0f, 8.0f, 0.25f}) {
+    data.push_back(MLFloat16(math::floatToHalf(value)));
+  }
+  test.AddInput<MLFloat16>("data", {3, 2}, data);
+  test.AddInput<int64_t>("indices", {2, 2}, {0, 1, 2, 2});
+  test.AddOutput<float>("output", {2, 2}, {2.5f, -3.0f, 16.0f, 0.5f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, QuantizedTable) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<uint8_t>("data", {2, 3}, {0, 1, 2, 10, 20, 30});
+  test.AddInput<int64_t>("indices", {3}, {1, 0, 1});
+  test.AddInput<int64_t>("lengths", {2}, {1, 2});
+  test.AddInput<float>("scales", {2}, {0.5f, 0.1f});
+  test.AddInput<float>("biases", {2}, {-1.0f, 1.0f});
+  // 0.1 * row 1 + 1, then that plus 0.5 * row 0 - 1
+  test.AddOutput<float>("output", {2, 3}, {2.0f, 3.0f, 4.0f, 1.0f, 2.5f, 4.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, InvalidIndex) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {2, 1}, {1.0f, 2.0f});
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 2});
+  test.AddOutput<float>("output", {1, 1}, {0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds, idx=2 data_dim=2");
+}
+
+TEST(EmbeddingBagTest, LengthsNotMatchingIndices) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {2, 1}, {1.0f, 2.0f});
+  test.AddInput<int64_t>("indices", {3}, {0, 1, 1});
+  test.AddInput<int64_t>("lengths", {2}, {1, 1});
+  test.AddOutput<float>("output", {2, 1}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "EmbeddingBag lengths sum to 2 instead of the number of indices 3");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <limits>
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Imputer(0 -> per feature values), Scaler((x - 1) * 0.5) and L1 Normalizer
+TEST(FeaturePipelineTest, ImputeScaleNormalize) {
+  OpTester test("FeaturePipeline", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("steps", std::vector<std::string>{"Imputer", "Scaler", "Normalizer"});
+  test.AddAttribute("step_values", std::vector<float>{0.f, 10.f, 20.f, 30.f, 1.f, 0.5f});
+  test.AddAttribute("step_value_counts", std::vector<int64_t>{4, 2, 0});
+  test.AddAttribute("norms", std::vector<std::string>{"L1"});
+  test.AddInput<float>("X", {2, 3}, {1.f, 0.f, 3.f, -1.f, 2.f, 0.f});
+  test.AddOutput<float>("Y", {2, 3}, {0.f, 0.9047619f, 0.0952381f, -0.0625f, 0.03125f, 0.90625f});
+  test.Run();
+}
+
+// the rows of two inputs concatenated as by a FeatureVectorizer, with the second padded, then Scaler(x * 2) and MAX
+// Normalizer
+TEST(FeaturePipelineTest, VectorizeScaleNormalize) {
+  OpTester test("FeaturePipeline", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("inputdimensions", std::vector<int64_t>{2, 2});
+  test.AddAttribute("steps", std::vector<std::string>{"Scaler", "Normalizer"});
+  test.AddAttribute("step_values", std::vector<float>{0.f, 2.f});
+  test.AddAttribute("step_value_counts", std::vector<int64_t>{2, 0});
+  test.AddAttribute("norms", std::vector<std::string>{"MAX"});
+  test.AddInput<float>("A", {2, 2}, {1.f, 2.f, 3.f, 4.f});
+  test.AddInput<float>("B", {2, 1}, {5.f, 6.f});
+  test.AddOutput<float>("Y", {2, 4}, {0.2f, 0.4f, 1.f, 0.f, 0.5f, 0.6666667f, 1.f, 0.f});
+  test.Run();
+}
+
+// Imputer(NaN -> 0) and Binarizer(x > 0.5), with enough values to run the rows in parallel
+TEST(FeaturePipelineTest, ImputeBinarize) {
+  const int64_t rows = 1024;
+  const int64_t features = 32;
+  std::vector<float> x(rows * features);
+  std::vector<float> y(rows * features);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = i % 3 == 0 ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>(i % 5) * 0.25f;
+    y[i] = i % 3 != 0 && i % 5 > 2 ? 1.f : 0.f;
+  }
+  OpTester test("FeaturePipeline", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("steps", std::vector<std::string>{"Imputer", "Binarizer"});
+  test.AddAttribute("step_values", std::vector<float>{std::numeric_limits<float>::quiet_NaN(), 0.f, 0.5f});
+  test.AddAttribute("step_value_counts", std::vector<int64_t>{2, 1});
+  test.AddInput<float>("X", {rows, features}, x);
+  test.AddOutput<float>("Y", {rows, features}, y);
+  test.Run();
+}
+
+TEST(FeaturePipelineTest, InvalidScale) {
+  OpTester test("FeaturePipeline", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("steps", std::vector<std::string>{"Scaler"});
+  test.AddAttribute("step_values", std::vector<float>{0.f, 1.f, 2.f, 3.f});
+  test.AddAttribute("step_value_counts", std::vector<int64_t>{4});
+  test.AddInput<float>("X", {1, 3}, {1.f, 2.f, 3.f});
+  test.AddOutput<float>("Y", {1, 3}, {0.f, 0.f, 0.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Either both scale and offset can be of feature size (3) or 1");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
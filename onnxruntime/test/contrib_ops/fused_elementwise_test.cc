@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// FusedElementwise is only implemented by the CUDA execution provider
+#ifdef USE_CUDA
+
+TEST(ContribOpTest, FusedElementwise_Chain) {
+  // Y = Sigmoid((A + B) * C)
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Mul", "Sigmoid"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, 2, 4, -1});
+  std::vector<float> a{-1.0f, 0.0f, 1.0f, 2.0f};
+  std::vector<float> b{0.5f, 0.5f, -0.5f, -3.0f};
+  std::vector<float> c{2.0f, 1.0f, 3.0f, 0.25f};
+  std::vector<float> y;
+  for (size_t i = 0; i < a.size(); ++i) {
+    y.push_back(1.0f / (1.0f + std::exp(-(a[i] + b[i]) * c[i])));
+  }
+  test.AddInput<float>("A", {2, 2}, a);
+  test.AddInput<float>("B", {2, 2}, b);
+  test.AddInput<float>("C", {2, 2}, c);
+  test.AddOutput<float>("Y", {2, 2}, y);
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedElementwise_Broadcast) {
+  // Y = X * Sigmoid(X) - Bias, with Bias broadcast over the rows and a scalar scale
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Sigmoid", "Mul", "Sub", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, -1, 0, 3, 4, 1, 5, 2});
+  std::vector<float> x{-2.0f, -1.0f, 0.0f, 1.0f, 2.0f, 3.0f};
+  std::vector<float> bias{0.5f, -1.0f, 2.0f};
+  const float scale = 3.0f;
+  std::vector<float> y;
+  for (size_t i = 0; i < x.size(); ++i) {
+    y.push_back((x[i] / (1.0f + std::exp(-x[i])) - bias[i % 3]) * scale);
+  }
+  test.AddInput<float>("X", {2, 3}, x);
+  test.AddInput<float>("Bias", {3}, bias);
+  test.AddInput<float>("Scale", {}, {scale});
+  test.AddOutput<float>("Y", {2, 3}, y);
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedElementwise_BroadcastInputs) {
+  // the output shape combines the shapes of two broadcast inputs
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Sub", "Relu"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1});
+  test.AddInput<float>("A", {2, 1}, {1.0f, 4.0f});
+  test.AddInput<float>("B", {1, 3}, {0.0f, 2.0f, 5.0f});
+  test.AddOutput<float>("Y", {2, 3}, {1.0f, 0.0f, 0.0f, 4.0f, 2.0f, 0.0f});
+  test.Run();
+}
+
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -153,5 +153,34 @@ TEST(GatherNDOpTest, GatherND_batched_3tensor_int64) {
   test3.Run();
 }
 
+// enough rows to copy them in parallel, in reverse order
+TEST(GatherNDOpTest, GatherND_many_slices_float_int64) {
+  const int64_t rows = 1024;
+  const int64_t columns = 32;
+  std::vector<float> data(rows * columns);
+  std::vector<int64_t> indices(rows);
+  std::vector<float> output(rows * columns);
+  for (int64_t r = 0; r < rows; ++r) {
+    indices[r] = rows - 1 - r;
+    for (int64_t c = 0; c < columns; ++c) {
+      data[r * columns + c] = static_cast<float>(r * columns + c);
+      output[(rows - 1 - r) * columns + c] = static_cast<float>(r * columns + c);
+    }
+  }
+  OpTester test("GatherND", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {rows, columns}, data);
+  test.AddInput<int64_t>("indices", {rows, 1}, indices);
+  test.AddOutput<float>("output", {rows, columns}, output);
+  test.Run();
+}
+
+TEST(GatherNDOpTest, GatherND_invalid_index_int32) {
+  OpTester test("GatherND", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {2,2}, {0.f,1.f,2.f,3.f});
+  test.AddInput<int32_t>("indices", {3,2}, {0,1,1,2,1,0});
+  test.AddOutput<float>("output", {3}, {1.f,0.f,2.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "invalid indice found, indice = 2");
+}
+
 }  // namespace test
 }  // namespace onnxruntime
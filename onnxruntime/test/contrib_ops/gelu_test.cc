@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, Gelu) {
+  OpTester test("Gelu", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {2, 3}, {-3.0f, -1.0f, -0.5f, 0.0f, 1.0f, 2.0f});
+  // 0.5 * x * (1 + erf(x / sqrt(2)))
+  test.AddOutput<float>("Y", {2, 3}, {-0.00404969f, -0.15865525f, -0.15426877f, 0.0f, 0.84134475f, 1.95449974f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "core/mlas/inc/mlas.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// the pixels of an NHWC image with the values 10 * pixel + channel, scaled and shifted per channel into NCHW planes
+TEST(ImagePreprocessTest, PerChannelScaleAndBias) {
+  OpTester test("ImagePreprocess", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("scale", std::vector<float>{1.f, 2.f, 0.5f});
+  test.AddAttribute("bias", std::vector<float>{0.f, -1.f, 10.f});
+  test.AddInput<uint8_t>("X", {1, 2, 2, 3}, {0, 1, 2, 10, 11, 12, 20, 21, 22, 30, 31, 32});
+  test.AddOutput<float>("Y", {1, 3, 2, 2}, {0.f, 10.f, 20.f, 30.f, 1.f, 21.f, 41.f, 61.f, 11.f, 16.f, 21.f, 26.f});
+  test.Run();
+}
+
+// the 1x2 region below the top-left pixel of a 3x3 image
+TEST(ImagePreprocessTest, BorderAndCropSize) {
+  OpTester test("ImagePreprocess", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("scale", std::vector<float>{2.f});
+  test.AddAttribute("border", std::vector<int64_t>{1, 1, 0, 0});
+  test.AddAttribute("crop_size", std::vector<int64_t>{1, 2});
+  test.AddInput<uint8_t>("X", {2, 3, 3, 1}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 11, 12, 13, 14, 15, 16, 17, 18});
+  test.AddOutput<float>("Y", {2, 1, 1, 2}, {8.f, 10.f, 28.f, 30.f});
+  test.Run();
+}
+
+// two channels written to one block of the NCHWc format, with the padding channels zero
+TEST(ImagePreprocessTest, Nchwc) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  std::vector<float> y(4 * block_size, 0.f);
+  for (int64_t pixel = 0; pixel < 4; ++pixel) {
+    y[pixel * block_size] = static_cast<float>(2 * pixel);
+    y[pixel * block_size + 1] = static_cast<float>(2 * pixel + 2);
+  }
+  OpTester test("ImagePreprocess", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("bias", std::vector<float>{0.f, 1.f});
+  test.AddAttribute("nchwc", static_cast<int64_t>(1));
+  test.AddInput<uint8_t>("X", {1, 2, 2, 2}, {0, 1, 2, 3, 4, 5, 6, 7});
+  test.AddOutput<float>("Y", {1, block_size, 2, 2}, y);
+  // only the CPU kernels read the NCHWc format
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider});
+}
+
+TEST(ImagePreprocessTest, InvalidScale) {
+  OpTester test("ImagePreprocess", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("scale", std::vector<float>{1.f, 2.f});
+  test.AddInput<uint8_t>("X", {1, 1, 1, 3}, {0, 1, 2});
+  test.AddOutput<float>("Y", {1, 3, 1, 1}, {0.f, 1.f, 2.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "ImagePreprocess scale and bias must have one element");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, LayerNormalization) {
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<float>("epsilon", 0.0f);
+  test.AddInput<float>("X", {2, 4}, {1.0f, 2.0f, 3.0f, 4.0f, -2.0f, -2.0f, 2.0f, 2.0f});
+  test.AddInput<float>("Scale", {4}, {1.0f, 1.0f, 2.0f, 2.0f});
+  test.AddInput<float>("B", {4}, {0.0f, 0.5f, 0.0f, 0.5f});
+  // the first row has a variance of 1.25, the second one of 4
+  test.AddOutput<float>("Y", {2, 4},
+                        {-1.3416408f, 0.0527864f, 0.8944272f, 3.1832816f, -1.0f, -0.5f, 2.0f, 2.5f});
+  test.Run();
+}
+
+TEST(ContribOpTest, LayerNormalizationWithoutBias) {
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {1, 2, 2}, {1.0f, 3.0f, 5.0f, 5.0f});
+  test.AddInput<float>("Scale", {2}, {1.0f, 1.0f});
+  // the variance of the second row is 0, so its deviations of 0 stay 0 with the default epsilon
+  test.AddOutput<float>("Y", {1, 2, 2}, {-0.99999499f, 0.99999499f, 0.0f, 0.0f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -30,5 +30,37 @@ TEST(MatmulIntegerOpTest, MatMulInteger) {
   test.AddOutput<int32_t>("T3", {1, 1}, {-1});
   test.Run();
 }
+
+// a batch of depths and columns that aren't multiples of 4, with the right operand broadcast over the batch
+TEST(MatmulIntegerOpTest, MatMulIntegerBatchedUnaligned) {
+  const int64_t batch = 2, M = 3, K = 5, N = 7;
+  const uint8_t a_zero_point = 130, b_zero_point = 3;
+  std::vector<uint8_t> a(batch * M * K);
+  std::vector<uint8_t> b(K * N);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<uint8_t>(i * 37 % 256);
+  }
+  for (size_t i = 0; i < b.size(); i++) {
+    b[i] = static_cast<uint8_t>(i * 53 % 256);
+  }
+  std::vector<int32_t> y(batch * M * N, 0);
+  for (int64_t i = 0; i < batch; i++) {
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        for (int64_t k = 0; k < K; k++) {
+          y[(i * M + m) * N + n] += (a[(i * M + m) * K + k] - a_zero_point) * (b[k * N + n] - b_zero_point);
+        }
+      }
+    }
+  }
+
+  OpTester test("MatMulInteger", 1, onnxruntime::kMSDomain);
+  test.AddInput<uint8_t>("T1", {batch, M, K}, a);
+  test.AddInput<uint8_t>("T2", {K, N}, b);
+  test.AddInput<uint8_t>("a_zero_point", {}, {a_zero_point});
+  test.AddInput<uint8_t>("b_zero_point", {}, {b_zero_point});
+  test.AddOutput<int32_t>("T3", {batch, M, N}, y);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
\ No newline at end of file
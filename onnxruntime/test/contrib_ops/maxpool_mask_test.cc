@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -80,5 +81,52 @@ TEST(ContribOpTest, MaxPoolWithMask) {
   test.Run();
 }
 
+// the masked elements of each row are at its end, so they are skipped, and a window of masked elements only keeps
+// the lowest value. the mask offsets of both channels are 0.
+TEST(ContribOpTest, MaxPoolWithTrailingMask1D) {
+  OpTester test("MaxpoolWithMask", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("auto_pad", "");
+  test.AddAttribute("strides", std::vector<int64_t>{1});
+  test.AddAttribute("pads", std::vector<int64_t>{0, 0});
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{2});
+
+  const float lowest = std::numeric_limits<float>::lowest();
+  test.AddInput<float>("X", {1, 2, 6}, {3.f, 1.f, 4.f, 1.f, 5.f, 9.f, 2.f, 7.f, 1.f, 8.f, 2.f, 8.f});
+  test.AddInput<int32_t>("M", {1, 2, 6}, {1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 0, 0});
+  test.AddOutput<float>("Y", {1, 2, 5}, {3.f, 4.f, 4.f, 1.f, lowest, 7.f, 7.f, 8.f, 8.f, lowest});
+  test.Run();
+}
+
+TEST(ContribOpTest, MaxPoolWithTrailingMask2D) {
+  OpTester test("MaxpoolWithMask", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("auto_pad", "");
+  test.AddAttribute("strides", std::vector<int64_t>{1, 1});
+  test.AddAttribute("pads", std::vector<int64_t>{0, 0, 0, 0});
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+
+  test.AddInput<float>("X", {1, 1, 3, 3}, {1.f, 2.f, 30.f, 4.f, 5.f, 60.f, 7.f, 80.f, 90.f});
+  test.AddInput<int32_t>("M", {1, 1, 3, 3}, {1, 1, 0, 1, 1, 0, 1, 0, 0});
+  test.AddOutput<float>("Y", {1, 1, 2, 2}, {5.f, 5.f, 7.f, 5.f});
+  test.Run();
+}
+
+// a masked element before unmasked ones stops the rows of the windows there, so the larger elements after it are
+// skipped too. the first element of a channel is never checked.
+TEST(ContribOpTest, MaxPoolWithLeadingMask2D) {
+  OpTester test("MaxpoolWithMask", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("auto_pad", "");
+  test.AddAttribute("strides", std::vector<int64_t>{1, 1});
+  test.AddAttribute("pads", std::vector<int64_t>{0, 0, 0, 0});
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+
+  test.AddInput<float>("X", {1, 1, 3, 3}, {1.f, 20.f, 30.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f});
+  test.AddInput<int32_t>("M", {1, 1, 3, 3}, {0, 0, 1, 1, 1, 1, 1, 1, 1});
+  test.AddOutput<float>("Y", {1, 1, 2, 2}, {5.f, 6.f, 8.f, 9.f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
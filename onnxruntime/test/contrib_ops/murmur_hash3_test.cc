@@ -94,5 +94,29 @@ TEST(MurmurHash3OpTest, StringKeyUIntWithSeed42) {
   test.Run();
 }
 
+TEST(MurmurHash3OpTest, StringKeysUIntResult) {
+  OpTester test("MurmurHash3", 1, onnxruntime::kMSDomain);
+  test.AddInput<std::string>("X", {3}, {"foo", "foo", "foo"});
+  test.AddAttribute<int64_t>("seed", 0LL);
+  test.AddOutput<uint32_t>("Y", {3}, {4138058784L, 4138058784L, 4138058784L});
+  test.Run();
+}
+
+// enough keys to be hashed on several threads
+TEST(MurmurHash3OpTest, ManyKeys) {
+  const int64_t count = 100 * 1000;
+  std::vector<int32_t> keys(count);
+  std::vector<uint32_t> hashes(count);
+  for (int64_t i = 0; i < count; i++) {
+    keys[i] = (i % 2 == 0) ? 3 : 4;
+    hashes[i] = (i % 2 == 0) ? 847579505L : 1889779975L;
+  }
+  OpTester test("MurmurHash3", 1, onnxruntime::kMSDomain);
+  test.AddInput<int32_t>("X", {count}, keys);
+  test.AddAttribute<int64_t>("seed", 0LL);
+  test.AddOutput<uint32_t>("Y", {count}, hashes);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
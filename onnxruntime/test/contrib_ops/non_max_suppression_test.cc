@@ -239,5 +239,28 @@ TEST(NonMaxSuppressionOpTest, WithScoreThresholdPadToSixOutput) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, SuppressedBySecondBlockOfSelected) {
+  // 20 disjoint boxes are selected, then a copy of the 18th one is suppressed by it
+  std::vector<float> boxes;
+  std::vector<float> scores;
+  std::vector<int32_t> selected;
+  for (int i = 0; i < 20; i++) {
+    boxes.insert(boxes.end(), {0.0f, 2.0f * i, 1.0f, 2.0f * i + 1.0f});
+    scores.push_back(0.99f - 0.01f * i);
+    selected.push_back(i);
+  }
+  boxes.insert(boxes.end(), {0.0f, 34.0f, 1.0f, 35.0f});
+  scores.push_back(0.5f);
+
+  OpTester test("NonMaxSuppression", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("boxes", {21, 4}, boxes);
+  test.AddInput<float>("scores", {21}, scores);
+  test.AddAttribute<int64_t>("max_output_size", 25LL);
+  test.AddAttribute<float>("iou_threshold", 0.5f);
+  test.AddAttribute<float>("score_threshold", 0.0f);
+  test.AddOutput<int32_t>("selected_indices", {20}, selected);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -188,6 +190,72 @@ TEST(QuantizeLinearOpTest, QuantizeLinear_2) {
   test.Run();
 }
 
+// the reference quantization of a value, rounding halfway cases away from zero
+static uint8_t QuantizeValue(float x, float scale, uint8_t zero_point) {
+  const float value = std::round(x / scale) + zero_point;
+  return static_cast<uint8_t>(value < 0.f ? 0.f : (value > 255.f ? 255.f : value));
+}
+
+// quantize a tensor larger than the vector width per tensor, with halfway cases of both signs and saturation
+TEST(QuantizeLinearOpTest, QuantizeLinear_Large) {
+  OpTester test("QuantizeLinear", 1, onnxruntime::kMSDomain);
+  const float scale = 0.5f;
+  const uint8_t zero_point = 100;
+  std::vector<float> x(1003);
+  std::vector<uint8_t> y(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = (static_cast<float>(i) - 500.f) * 0.125f;
+    y[i] = QuantizeValue(x[i], scale, zero_point);
+  }
+  test.AddInput<float>("x", {static_cast<int64_t>(x.size())}, x);
+  test.AddInput<float>("y_scale", {}, {scale});
+  test.AddInput<uint8_t>("y_zero_point", {}, {zero_point});
+  test.AddOutput<uint8_t>("y", {static_cast<int64_t>(y.size())}, y);
+  test.Run();
+}
+
+// quantize per axis, with blocks larger than the vector width
+TEST(QuantizeLinearOpTest, QuantizeLinear_AxisLarge) {
+  OpTester test("QuantizeLinear", 1, onnxruntime::kMSDomain);
+  const std::vector<int64_t> dims{2, 3, 37};
+  const std::vector<float> scale{0.25f, 1.f, 3.f};
+  const std::vector<uint8_t> zero_point{0, 128, 255};
+  std::vector<float> x(2 * 3 * 37);
+  std::vector<uint8_t> y(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    const size_t channel = (i / 37) % 3;
+    x[i] = static_cast<float>(static_cast<int>(i % 37) - 18) * 1.5f * scale[channel];
+    y[i] = QuantizeValue(x[i], scale[channel], zero_point[channel]);
+  }
+  test.AddInput<float>("x", dims, x);
+  test.AddAttribute<int64_t>("axis", 1);
+  test.AddInput<float>("y_scale", {3}, scale);
+  test.AddInput<uint8_t>("y_zero_point", {3}, zero_point);
+  test.AddOutput<uint8_t>("y", dims, y);
+  test.Run();
+}
+
+// dequantize per axis, with blocks larger than the vector width
+TEST(DequantizeLinearOpTest, DequantizeLinear_AxisLarge) {
+  OpTester test("DequantizeLinear", 1, onnxruntime::kMSDomain);
+  const std::vector<int64_t> dims{3, 41};
+  const std::vector<float> scale{0.5f, 2.f, -1.f};
+  const std::vector<int8_t> zero_point{0, -100, 100};
+  std::vector<int8_t> x(3 * 41);
+  std::vector<float> y(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    const size_t channel = i / 41;
+    x[i] = static_cast<int8_t>(static_cast<int>(i * 37 % 256) - 128);
+    y[i] = static_cast<float>(x[i] - zero_point[channel]) * scale[channel];
+  }
+  test.AddInput<int8_t>("x", dims, x);
+  test.AddAttribute<int64_t>("axis", 0);
+  test.AddInput<float>("x_scale", {3}, scale);
+  test.AddInput<int8_t>("x_zero_point", {3}, zero_point);
+  test.AddOutput<float>("y", dims, y);
+  test.Run();
+}
+
 TEST(ConvIntegerTest, ConvIntegerTest) {
   OpTester test("ConvInteger", 1, onnxruntime::kMSDomain);
   std::vector<int64_t> x_dims{1, 1, 3, 3};
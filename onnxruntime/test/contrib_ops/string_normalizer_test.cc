@@ -214,5 +214,47 @@ TEST(ContribOpTest, StringNormalizerTest) {
   }
 }
 
+TEST(ContribOpTest, StringNormalizerAsciiCaseChange) {
+  // - case-INSENSETIVE approach en_US locale
+  // - ASCII strings change case without a conversion to wide chars,
+  //   others with one
+  // - filter out monday in any case
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", false, {u8"MonDay", u8"École"}, test_locale);
+    std::vector<int64_t> dims{6};
+    std::vector<std::string> input = {std::string(u8"monday"),
+                                      std::string(u8"TUESDAY"),
+                                      std::string(u8"MONDAY"),
+                                      std::string(u8"Wed-Nes_day 42!"),
+                                      std::string(u8"éCOLE"),
+                                      std::string(u8"Besançon")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string(u8"tuesday"),
+                                       std::string(u8"wed-nes_day 42!"),
+                                       std::string(u8"besançon")};
+    test.AddOutput<std::string>("Y", {3}, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  // - case-SENSETIVE approach en_US locale
+  // - no stopwords
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "UPPER", true, {}, test_locale);
+    std::vector<int64_t> dims{1, 3};
+    std::vector<std::string> input = {std::string(u8"[a-z]{0,9}"),
+                                      std::string(u8"a long string of more than 8 chars"),
+                                      std::string(u8"grüßen")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string(u8"[A-Z]{0,9}"),
+                                       std::string(u8"A LONG STRING OF MORE THAN 8 CHARS"),
+                                       std::string(u8"GRÜßEN")};
+    test.AddOutput<std::string>("Y", {1, 3}, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
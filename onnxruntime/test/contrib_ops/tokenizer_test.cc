@@ -704,5 +704,36 @@ TEST(ContribOpTest, TokenizerWithSeparators_MixCharCommonPrefixC) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(ContribOpTest, TokenizerSeparatorsManyAsciiAndUtf8Rows) {
+  // Single char separators, with ASCII rows tokenized without
+  // a conversion and rows of other utf8 chars with one, and enough
+  // rows to be split between threads
+  // [N][C] dimensions
+  // Output [N][C][D]
+  for (const auto& separators : {std::vector<std::string>{u8" ", u8","},
+                                 std::vector<std::string>{u8" ", u8",", u8", "}}) {
+    OpTester test("Tokenizer", opset_ver, domain);
+    InitTestAttr(test, false, separators, 2);
+
+    const int64_t N = 1000;
+    std::vector<int64_t> dims{N, 2};
+    std::vector<std::string> input;
+    std::vector<std::string> output;
+    for (int64_t i = 0; i < N; ++i) {
+      const std::string n = std::to_string(i);
+      input.push_back("first" + n + " second, third x" + n);
+      output.insert(output.end(), {"first" + n, "second", "third", "x" + n});
+      input.push_back(u8"Абсу" + n + u8",中文 y");
+      output.insert(output.end(), {u8"Абсу" + n, u8"中文", u8"y", padval});
+    }
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<int64_t> output_dims(dims);
+    output_dims.push_back(int64_t(4));
+    test.AddOutput<std::string>("Y", output_dims, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
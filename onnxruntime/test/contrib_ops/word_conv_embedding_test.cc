@@ -1,6 +1,8 @@
 ﻿// Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
 #include <codecvt>
 #include <vector>
 #include "gtest/gtest.h"
@@ -127,5 +129,60 @@ TEST(ContribOpTest, WordConvEmbedding_char_embedding_shape_conv_shape_not_match)
   test.Run(OpTester::ExpectResult::kExpectFailure);
 }
 
+// enough words of different lengths to be pooled in parallel, checked against a direct convolution of each word
+TEST(ContribOpTest, WordConvEmbedding_many_words) {
+  OpTester test("WordConvEmbedding", 1, onnxruntime::kMSDomain);
+
+  const int64_t seq_len = 200, word_len = 10, chars = 30, char_embedding_size = 8;
+  const int64_t num_filters = 16, filter_width = 3;
+  std::vector<int> seq_words(seq_len * word_len, 0);
+  std::vector<int> word_lengths(seq_len);
+  for (int64_t w = 0; w < seq_len; w++) {
+    word_lengths[w] = 1 + static_cast<int>(w % word_len);
+    for (int c = 0; c < word_lengths[w]; c++) {
+      seq_words[w * word_len + c] = 1 + static_cast<int>((w * 7 + c * 3) % (chars - 1));
+    }
+  }
+  std::vector<float> W_char_embedding(chars * char_embedding_size);
+  for (size_t i = 0; i < W_char_embedding.size(); i++) {
+    W_char_embedding[i] = static_cast<float>((i * 37) % 19) / 19.0f - 0.5f;
+  }
+  std::vector<float> W_conv(num_filters * filter_width * char_embedding_size);
+  for (size_t i = 0; i < W_conv.size(); i++) {
+    W_conv[i] = static_cast<float>((i * 13) % 23) / 23.0f - 0.5f;
+  }
+  std::vector<float> B_conv(num_filters);
+  for (int64_t f = 0; f < num_filters; f++) {
+    B_conv[f] = 0.05f * static_cast<float>(f) - 0.4f;
+  }
+
+  std::vector<float> output(seq_len * num_filters);
+  for (int64_t w = 0; w < seq_len; w++) {
+    const int64_t windows = std::max<int64_t>(1, word_lengths[w] - filter_width + 1);
+    for (int64_t f = 0; f < num_filters; f++) {
+      float max_value = -1e12f;
+      for (int64_t u = 0; u < windows; u++) {
+        float value = B_conv[f];
+        for (int64_t k = 0; k < filter_width; k++) {
+          const int c = seq_words[w * word_len + u + k];
+          for (int64_t e = 0; e < char_embedding_size; e++) {
+            value += W_char_embedding[c * char_embedding_size + e] *
+                     W_conv[(f * filter_width + k) * char_embedding_size + e];
+          }
+        }
+        max_value = std::max(max_value, std::tanh(value));
+      }
+      output[w * num_filters + f] = max_value;
+    }
+  }
+
+  test.AddInput<int>("Sequence", {seq_len, word_len}, seq_words);
+  test.AddInput<float>("W", {num_filters, 1, filter_width, char_embedding_size}, W_conv);
+  test.AddInput<float>("B", {num_filters}, B_conv);
+  test.AddInput<float>("C", {chars, char_embedding_size}, W_char_embedding);
+  test.AddOutput<float>("Y", {seq_len, num_filters}, output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -23,9 +23,11 @@ class FooKernel : public OpKernel {
     Tensor* Y = ctx->Output(0, X->Shape());
     auto* Y_data = Y->template MutableData<float>();
 
-    for (int64_t i = 0; i < X->Shape().Size(); i++) {
-      Y_data[i] = X_data[i] + W_data[i];
-    }
+    ctx->ParallelFor(X->Shape().Size(), 16 * 1024, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        Y_data[i] = X_data[i] + W_data[i];
+      }
+    });
 
     return Status::OK();
   }
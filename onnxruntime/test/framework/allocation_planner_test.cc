@@ -11,6 +11,7 @@
 #include "core/framework/op_kernel.h"
 #include "test/framework/model_builder_utils.h"
 #include "core/framework/allocation_planner.h"
+#include "core/framework/kernel_registry.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 using namespace ONNX_NAMESPACE;
 
@@ -124,15 +125,31 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool enable_parallel_execution = false)
+      : shape_map_(shape_map), enable_parallel_execution_(enable_parallel_execution) {}
 
   virtual TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool EnableParallelExecution() const override { return enable_parallel_execution_; }
+
  private:
   ShapeMap* shape_map_;
+  bool enable_parallel_execution_;
+};
+
+// a CPU provider with more than one compute queue, whose nodes a parallel execution spreads over its queues
+class MultiQueueCPUExecutionProvider : public CPUExecutionProvider {
+ public:
+  explicit MultiQueueCPUExecutionProvider(std::vector<int> compute_queue_ids)
+      : CPUExecutionProvider(CPUExecutionProviderInfo()), compute_queue_ids_(std::move(compute_queue_ids)) {}
+
+  std::vector<int> GetComputeQueueIds() const override { return compute_queue_ids_; }
+
+ private:
+  std::vector<int> compute_queue_ids_;
 };
 
 class PlannerTest : public ::testing::Test {
@@ -149,6 +166,9 @@ class PlannerTest : public ::testing::Test {
 
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;       // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;  // a unary kernel with in-place
+  std::unique_ptr<::onnxruntime::KernelDef> alias_kernel_;     // a unary kernel that aliases its input to its output
+  std::unique_ptr<::onnxruntime::KernelDef> queue_kernel_;     // a unary kernel that runs on queue 1
+  std::shared_ptr<KernelRegistry> queue_kernel_registry_;
 
   std::unordered_map<std::string, onnxruntime::NodeArg*> name_to_arg_;
   std::vector<std::unique_ptr<UnaryNode>> nodes_;
@@ -163,6 +183,19 @@ class PlannerTest : public ::testing::Test {
   PlannerTest() : model_("test"), graph_{model_.MainGraph()}, state_{execution_providers_} {
     std_kernel_ = KernelDefBuilder().SetName("Transpose").Build();
     in_place_kernel_ = KernelDefBuilder().SetName("Clip").MayInplace(0, 0).Build();
+    alias_kernel_ = KernelDefBuilder().SetName("Identity").Alias(0, 0).Build();
+    queue_kernel_ = KernelDefBuilder().SetName("Relu").ExecQueueId(1).Build();
+    // the planner looks the kernels up in the registries, which have no kernel of another queue
+    KernelDefBuilder queue_kernel_def;
+    queue_kernel_def.SetName("Relu")
+        .SetDomain(kOnnxDomain)
+        .SinceVersion(6)
+        .Provider(kCpuExecutionProvider)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .ExecQueueId(1);
+    queue_kernel_registry_ = std::make_shared<KernelRegistry>();
+    queue_kernel_registry_->Register(queue_kernel_def,
+                                     [](const OpKernelInfo& info) -> OpKernel* { return new DummyOpKernel(info); });
     CPUExecutionProviderInfo epi;
     auto execution_provider = std::make_unique<CPUExecutionProvider>(epi);
     execution_providers_.Add("CPUExecutionProvider", std::move(execution_provider));
@@ -193,6 +226,14 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*in_place_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddAliasNode(std::string& input, std::string& output) {
+    return AddNode(*alias_kernel_, input, output);
+  }
+
+  onnxruntime::Node* AddQueueNode(std::string& input, std::string& output) {
+    return AddNode(*queue_kernel_, input, output);
+  }
+
   void BindKernel(onnxruntime::Node* p_node, ::onnxruntime::KernelDef& kernel_def) {
     auto info = std::make_unique<OpKernelInfo>(*p_node, kernel_def, *execution_providers_.Get(*p_node), state_);
     auto dummy = std::make_unique<DummyOpKernel>(*info);
@@ -210,7 +251,8 @@ class PlannerTest : public ::testing::Test {
     }
   }
 
-  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}) {
+  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {},
+                  bool enable_parallel_execution = false, const std::vector<int>& compute_queue_ids = {0}) {
     EXPECT_EQ(graph_.Resolve(), Status::OK());
     state_.SetGraphViewer(std::make_unique<GraphViewer>(graph_));
 
@@ -225,14 +267,15 @@ class PlannerTest : public ::testing::Test {
       BindKernel(binding.first, binding.second);
     }
 
-    auto cpu_execution_provider = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+    auto cpu_execution_provider = std::make_unique<MultiQueueCPUExecutionProvider>(compute_queue_ids);
     KernelRegistryManager kernel_registry_manager;
     kernel_registry_manager.RegisterKernelRegistry(cpu_execution_provider->GetKernelRegistry(), KernelRegistryPriority::LowPriority);
+    kernel_registry_manager.RegisterKernelRegistry(queue_kernel_registry_, KernelRegistryPriority::HighPriority);
 
     ExecutionProviders execution_providers;
     execution_providers.Add(onnxruntime::kCpuExecutionProvider, std::move(cpu_execution_provider));
 
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, enable_parallel_execution);
     auto status = SequentialPlanner::CreatePlan(
         GraphViewer(graph_), outer_scope_node_args, execution_providers, kernel_registry_manager,
         mlvalue_name_idx_map, test_context, plan_);
@@ -247,6 +290,35 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+  // output_name empty if the value is not written to the buffer of a graph output
+  void CheckAliasedOutput(const std::string& name, const std::string& output_name) {
+    int id;
+    index(name, id);
+    int output_id = -1;
+    if (!output_name.empty()) {
+      index(output_name, output_id);
+    }
+    EXPECT_EQ(plan_->allocation_plan[id].aliased_output, output_id) << "Error in aliased output for " << name;
+  }
+
+  void CheckFence(const std::string& name, bool create_fence) {
+    int id;
+    index(name, id);
+    EXPECT_EQ(plan_->allocation_plan[id].create_fence_if_async, create_fence) << "Error in fence for " << name;
+  }
+
+  int NodeQueue(const onnxruntime::Node* p_node) {
+    const auto& queue_ids = plan_->node_exec_queue_ids;
+    return queue_ids.empty() ? 0 : queue_ids.at(p_node->Index());
+  }
+
+  void CheckBufferUseCount(const std::string& name, int count) {
+    int id;
+    index(name, id);
+    ASSERT_EQ(plan_->buffer_use_counts.size(), plan_->allocation_plan.size());
+    EXPECT_EQ(plan_->buffer_use_counts[id], count) << "Error in buffer use count for " << name;
+  }
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // create set and check equality
     std::unordered_set<int> expected;
@@ -307,6 +379,124 @@ TEST_F(PlannerTest, ChainTest) {
   CheckFreed(3, {"X"});
 }
 
+// FenceTest: Check that only the values used on more than one queue get a fence, so that a run on one queue has none
+TEST_F(PlannerTest, FenceTest) {
+  std::string X("X"), A("A"), B("B"), C("C"), Y("Y");
+
+  AddNormalNode(X, A);
+  AddQueueNode(A, B);
+  AddQueueNode(B, C);
+  AddNormalNode(C, Y);
+
+  CreatePlan();
+
+  // A and C cross between the queues, B stays on queue 1, X and Y stay on the default queue
+  CheckFence(X, false);
+  CheckFence(A, true);
+  CheckFence(B, false);
+  CheckFence(C, true);
+  CheckFence(Y, false);
+}
+
+// ParallelChainTest: Check that a parallel execution reuses a dead buffer if the nodes that used it run before,
+// and that the uses of each buffer are counted for the parallel executor to release it.
+TEST_F(PlannerTest, ParallelChainTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // X1: input; X2: temporary
+  AddNormalNode(X2, X3);  // X3: temporary
+  AddNormalNode(X3, X4);  // X4: temporary, may reuse X2's buffer as the nodes that used it are ancestors
+  AddNormalNode(X4, X5);  // X5: output
+
+  // simulate shape-inference results:
+  Shape shape1{50, 100};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}});
+
+  CreatePlan({}, true);
+
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kReuse);
+  CheckAllocKind(X5, AllocKind::kAllocateOutput);
+
+  // X2's buffer is used by the nodes X2 and X4 are inputs and outputs of. X1 and X5 are never released.
+  CheckBufferUseCount(X1, 0);
+  CheckBufferUseCount(X2, 4);
+  CheckBufferUseCount(X3, 2);
+  CheckBufferUseCount(X5, 0);
+}
+
+// ParallelBranchesTest: Check that a parallel execution doesn't reuse a buffer of a node that may run concurrently.
+TEST_F(PlannerTest, ParallelBranchesTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), X7("X7");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // X1: input; X2: temporary
+  AddInplaceNode(X2, X3);  // may-in-place operator; X3: temporary
+  AddNormalNode(X3, X4);   // X4: output
+  AddNormalNode(X2, X5);   // X5: temporary, on a branch independent of the node of X3
+  AddNormalNode(X5, X6);   // X6: temporary, on a branch independent of the node of X4
+  AddNormalNode(X6, X7);   // X7: output
+
+  // simulate shape-inference results:
+  Shape shape1{50, 100};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape}, {X7, shape}});
+
+  CreatePlan({}, true);
+
+  // whatever order the plan has, X2 can't be updated in place while the other branch may still read it, and no
+  // buffer of one branch can be reused by the other.
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X5, AllocKind::kAllocate);
+  CheckAllocKind(X6, AllocKind::kAllocate);
+}
+
+// ParallelComputeQueuesTest: Check that a parallel execution keeps a chain of nodes on a compute queue, puts the
+// branch that forks off on another one, and creates fences only for the values passed between the queues.
+TEST_F(PlannerTest, ParallelComputeQueuesTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure:
+  auto* n1 = AddNormalNode(X1, X2);  // X1: input; X2: temporary, read by both branches
+  auto* n2 = AddNormalNode(X2, X3);  // X3: temporary
+  auto* n3 = AddNormalNode(X3, X4);  // X4: output
+  auto* n4 = AddNormalNode(X2, X5);  // X5: temporary, on the other branch
+  auto* n5 = AddNormalNode(X5, X6);  // X6: output
+
+  CreatePlan({}, true, {0, 2});
+
+  ASSERT_FALSE(GetPlan().node_exec_queue_ids.empty());
+  EXPECT_EQ(NodeQueue(n1), 0);
+  EXPECT_NE(NodeQueue(n2), NodeQueue(n4));
+  EXPECT_EQ(NodeQueue(n3), NodeQueue(n2));
+  EXPECT_EQ(NodeQueue(n5), NodeQueue(n4));
+
+  CheckFence(X2, true);
+  CheckFence(X3, false);
+  CheckFence(X5, false);
+}
+
+// a provider with a single compute queue runs the nodes on the queues of their kernels
+TEST_F(PlannerTest, ParallelSingleComputeQueueTest) {
+  std::string X1("X1"), X2("X2"), X3("X3");
+
+  AddNormalNode(X1, X2);
+  AddNormalNode(X1, X3);
+
+  CreatePlan({}, true);
+
+  EXPECT_TRUE(GetPlan().node_exec_queue_ids.empty());
+  CheckFence(X1, false);
+}
+
 /* InputOutputTest: Test that:
 (a) All inputs are classified as kPreExisting,
 (b) All outer scope node args are classified as kPreExisting,
@@ -409,6 +599,198 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+// InPlaceUnknownShapeTest: Check that Inplace reuse of a value with an unknown shape is planned to be checked
+// when the graph is run, and that the value is freed with the buffer it reuses.
+TEST_F(PlannerTest, InPlaceUnknownShapeTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // no in-place operator; X1: input; X2: temporary
+  AddInplaceNode(X2, X3);  // may-in-place operator; X3: temporary
+  AddNormalNode(X3, X4);   // no in-place operator; X4: output
+
+  // simulate shape-inference results, with no shape for X3:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X4, shape}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kReuse);
+  int x3_id;
+  ASSERT_TRUE(GetState().GetMLValueNameIdxMap().GetIdx(X3, x3_id).IsOK());
+  EXPECT_TRUE(GetPlan().allocation_plan[x3_id].reuse_if_same_size);
+
+  // check each ml-value is freed at appropriate step
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X2, X3});
+}
+
+// ChainedUnknownShapeReuseTest: Check that values which reuse the buffer of a value that only reuses it if it has
+// its size are checked too, even when their own shapes are known to match, as the value may have a buffer of its own.
+TEST_F(PlannerTest, ChainedUnknownShapeReuseTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // no in-place operator; X1: input; X2: temporary of unknown shape
+  AddInplaceNode(X2, X3);  // may-in-place operator; X3: temporary
+  AddAliasNode(X3, X4);    // aliasing operator; X4: temporary
+  AddInplaceNode(X4, X5);  // may-in-place operator; X5: temporary
+  AddNormalNode(X5, X6);   // no in-place operator; X6: output
+
+  // simulate shape-inference results, with no shape for X2:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kReuse);
+  CheckAllocKind(X4, AllocKind::kReuse);
+  CheckAllocKind(X5, AllocKind::kReuse);
+  int x2_id;
+  ASSERT_TRUE(GetState().GetMLValueNameIdxMap().GetIdx(X2, x2_id).IsOK());
+  for (auto name : {X3, X4, X5}) {
+    int id;
+    ASSERT_TRUE(GetState().GetMLValueNameIdxMap().GetIdx(name, id).IsOK());
+    EXPECT_EQ(GetPlan().allocation_plan[id].reused_buffer, x2_id) << name;
+    EXPECT_TRUE(GetPlan().allocation_plan[id].reuse_if_same_size) << name;
+  }
+
+  // check each ml-value is freed at appropriate step
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {});
+  CheckFreed(3, {});
+  CheckFreed(4, {X2, X3, X4, X5});
+}
+
+// BestFitReuseTest: Check that a value reuses the smallest free buffer it is known to fit in, whatever value the
+// dimension parameter takes, and that a buffer of another parameter isn't reused.
+TEST_F(PlannerTest, BestFitReuseTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), X7("X7");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // X2: (M, 8)
+  AddNormalNode(X2, X3);  // X3: (M, 4)
+  AddNormalNode(X3, X4);  // X4: (M, 16), which fits neither of the free buffers
+  AddNormalNode(X4, X5);  // X5: (M, 3), which fits both free buffers
+  AddNormalNode(X5, X6);  // X6: (N, 2), which fits no buffer
+  AddNormalNode(X6, X7);  // X7: output
+
+  // simulate shape-inference results:
+  auto shape = [](const std::string& param, int64_t value) {
+    Shape result{param};
+    result.value.add_dim()->set_dim_value(value);
+    return result;
+  };
+  Shape shape2 = shape("M", 8), shape3 = shape("M", 4), shape4 = shape("M", 16), shape5 = shape("M", 3),
+        shape6 = shape("N", 2), shape7 = shape("N", 2);
+  SetShape({{X2, &shape2.value}, {X3, &shape3.value}, {X4, &shape4.value}, {X5, &shape5.value},
+            {X6, &shape6.value}, {X7, &shape7.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+  CheckAllocKind(X5, AllocKind::kReuse);
+  CheckAllocKind(X6, AllocKind::kAllocate);
+
+  int x3_id, x5_id;
+  ASSERT_TRUE(GetState().GetMLValueNameIdxMap().GetIdx(X3, x3_id).IsOK());
+  ASSERT_TRUE(GetState().GetMLValueNameIdxMap().GetIdx(X5, x5_id).IsOK());
+  EXPECT_EQ(GetPlan().allocation_plan[x5_id].reused_buffer, x3_id);
+  EXPECT_FALSE(GetPlan().allocation_plan[x5_id].reuse_if_same_size);
+}
+
+// InPlaceTransposedShapeTest: Check that Inplace reuse is allowed for shapes with the same number of elements
+TEST_F(PlannerTest, InPlaceTransposedShapeTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // no in-place operator; X1: input; X2: temporary
+  AddInplaceNode(X2, X3);  // may-in-place operator; X3: temporary
+  AddNormalNode(X3, X4);   // no in-place operator; X4: output
+
+  // simulate shape-inference results:
+  Shape shape1w{"M", "N"};
+  auto shape1 = &shape1w.value;
+  Shape shape2w{"N", "M"};
+  auto shape2 = &shape2w.value;
+  SetShape({{X1, shape1}, {X2, shape1}, {X3, shape2}, {X4, shape2}});
+
+  CreatePlan();
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kReuse);
+  int x3_id;
+  ASSERT_TRUE(GetState().GetMLValueNameIdxMap().GetIdx(X3, x3_id).IsOK());
+  EXPECT_FALSE(GetPlan().allocation_plan[x3_id].reuse_if_same_size);
+}
+
+// AliasedOutputTest: Check that a value only an aliasing node consumes is written to the buffer of the graph
+// output the node produces, and that its buffer is not reused.
+TEST_F(PlannerTest, AliasedOutputTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // X2: temporary, only consumed by the aliasing node
+  AddAliasNode(X2, X3);   // X3: output
+  AddNormalNode(X3, X4);  // X4: temporary, computed once X2 is dead
+  AddNormalNode(X4, X5);  // X5: output
+  GetGraph().SetOutputOrder({Arg(X3)});
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}});
+
+  CreatePlan();
+
+  CheckAliasedOutput(X2, X3);
+  CheckAliasedOutput(X4, "");
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocateOutput);
+
+  // the buffer of X2 may be the one of X3, so X4 can't reuse it
+  CheckAllocKind(X4, AllocKind::kAllocate);
+}
+
+// AliasedOutputWithOtherConsumerTest: Check that a value is not written to the buffer of a graph output when a node
+// other than the aliasing node consumes it.
+TEST_F(PlannerTest, AliasedOutputWithOtherConsumerTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // X2: temporary
+  AddAliasNode(X2, X3);   // X3: output
+  AddNormalNode(X2, X4);  // X4: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}});
+
+  CreatePlan();
+
+  CheckAliasedOutput(X2, "");
+  CheckAllocKind(X3, AllocKind::kAllocateOutput);
+  CheckAllocKind(X4, AllocKind::kAllocateOutput);
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
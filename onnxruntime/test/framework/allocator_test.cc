@@ -26,6 +26,19 @@ TEST(AllocatorTest, CPUAllocatorTest) {
   //todo: test the used / max api.
 }
 
+TEST(AllocatorTest, HugePageCPUAllocatorTest) {
+  HugePageCPUAllocator allocator;
+  // on huge pages if the OS has any, and on regular ones otherwise
+  for (size_t size : {static_cast<size_t>(1024), static_cast<size_t>(3 * 1024 * 1024)}) {
+    auto bytes = static_cast<char*>(allocator.Alloc(size));
+    ASSERT_TRUE(bytes != nullptr);
+    memset(bytes, -1, size);
+    EXPECT_EQ(bytes[0], -1);
+    EXPECT_EQ(bytes[size - 1], -1);
+    allocator.Free(bytes);
+  }
+}
+
 // helper class to validate values in Alloc and Free calls made via IAllocator::MakeUniquePtr
 class TestAllocator : public IAllocator {
  public:
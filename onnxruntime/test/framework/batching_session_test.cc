@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_session.h"
+
+#include <thread>
+
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+#include "test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Y = X * X with X of shape {batch, 2}, batch being symbolic or 1
+static void LoadMulModel(InferenceSession& session, bool dynamic_batch) {
+  auto status = LoadSingleNodeModel(session, "Mul", {"X", "X"}, "Y",
+                                    MakeFloatTensorType({dynamic_batch ? -1 : 1, 2}, "batch"));
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+TEST(BatchingSessionTest, RejectsFixedBatchDimension) {
+  SessionOptions so;
+  InferenceSession session{so, &DefaultLoggingManager()};
+  LoadMulModel(session, false);
+
+  std::unique_ptr<BatchingSession> batching_session;
+  auto status = BatchingSession::Create(session, BatchingOptions{}, batching_session);
+  EXPECT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("fixed leading dimension"), std::string::npos) << status.ErrorMessage();
+}
+
+TEST(BatchingSessionTest, ConcurrentRequests) {
+  SessionOptions so;
+  InferenceSession session{so, &DefaultLoggingManager()};
+  LoadMulModel(session, true);
+
+  BatchingOptions options;
+  options.max_batch_size = 6;
+  options.max_queue_delay = std::chrono::milliseconds(5);
+
+  std::unique_ptr<BatchingSession> batching_session;
+  auto status = BatchingSession::Create(session, options, batching_session);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // requests of 1 to 3 rows. row values are unique per request so any mixup between requests is detected.
+  const int num_requests = 16;
+  std::vector<std::thread> threads;
+  std::vector<Status> statuses(num_requests);
+  std::vector<std::vector<MLValue>> fetches(num_requests);
+  std::vector<std::vector<float>> inputs(num_requests);
+
+  for (int i = 0; i < num_requests; ++i) {
+    const int64_t rows = 1 + i % 3;
+    for (int64_t j = 0; j < rows * 2; ++j) {
+      inputs[i].push_back(static_cast<float>(i * 10 + j));
+    }
+
+    threads.emplace_back([&, i, rows]() {
+      NameMLValMap feeds{{"X", CreateFloatValue({rows, 2}, inputs[i])}};
+      RunOptions run_options;
+      statuses[i] = batching_session->Run(run_options, feeds, {"Y"}, &fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i].ErrorMessage();
+    ASSERT_EQ(fetches[i].size(), 1u);
+    const auto& output = fetches[i][0].Get<Tensor>();
+    EXPECT_EQ(output.Shape(), TensorShape({static_cast<int64_t>(inputs[i].size() / 2), 2}));
+
+    const float* data = output.Data<float>();
+    for (size_t j = 0; j < inputs[i].size(); ++j) {
+      EXPECT_EQ(data[j], inputs[i][j] * inputs[i][j]);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
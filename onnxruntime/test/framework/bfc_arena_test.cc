@@ -4,6 +4,8 @@
 #include "core/framework/bfc_arena.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <cstring>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -234,5 +236,142 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, SmallAllocationCache) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  void* t1 = a.Alloc(1000);
+  void* t2 = a.Alloc(1000);
+  a.Free(t1);
+
+  // freed small chunks stay in the cache and are reused for the same rounded size
+  CheckStats(&a, 2, 1024, 2048, 1024);
+  void* t3 = a.Alloc(900);
+  EXPECT_EQ(t1, t3);
+  CheckStats(&a, 3, 2048, 2048, 1024);
+
+  a.Free(t2);
+  a.Free(t3);
+  CheckStats(&a, 3, 0, 2048, 1024);
+
+  // once released the chunks are coalesced, so the start of the region is available for a larger allocation
+  a.ReleaseCachedChunks();
+  void* t4 = a.Alloc(4096);
+  EXPECT_EQ(std::min(t1, t2), t4);
+  a.Free(t4);
+}
+
+TEST(BFCArenaTest, SmallAllocationCacheConcurrent) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  // chunks allocated on one thread and freed on another
+  std::vector<void*> ptrs(256);
+  std::thread producer([&]() {
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+      ptrs[i] = a.Alloc(256 * (1 + i % 8));
+    }
+  });
+  producer.join();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&a, &ptrs, t]() {
+      for (size_t i = t; i < ptrs.size(); i += 8) {
+        a.Free(ptrs[i]);
+      }
+
+      std::vector<void*> local;
+      for (int iter = 0; iter < 100; ++iter) {
+        for (int i = 0; i < 16; ++i) {
+          local.push_back(a.Alloc(64 * (1 + (iter + i) % 64)));
+          // the chunk is ours until freed
+          memset(local.back(), t, 64);
+        }
+        for (void* p : local) {
+          EXPECT_EQ(*static_cast<char*>(p), static_cast<char>(t));
+          a.Free(p);
+        }
+        local.clear();
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_allocs, 256 + 8 * 100 * 16);
+}
+
+TEST(BFCArenaTest, Shrink) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  void* small = a.Alloc(1024);
+  void* large = a.Alloc(16 << 20);
+  a.Free(large);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (16 << 20));
+  EXPECT_EQ(stats.largest_free_chunk, 16 << 20);
+  EXPECT_EQ(stats.free_bytes_in_bins, (1 << 20) - 1024 + (16 << 20));
+
+  // only the region of the large allocation has no chunks in use
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+
+  a.Free(small);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+
+  // regions start from the initial size again
+  void* p = a.Alloc(1024);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+  a.Free(p);
+}
+
+TEST(BFCArenaTest, ExtendStrategies) {
+  auto total_allocated_bytes = [](const ArenaConfig& config) {
+    BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, config);
+    std::vector<void*> ptrs;
+    ptrs.push_back(a.Alloc(1024));
+    ptrs.push_back(a.Alloc(3 << 20));
+    ptrs.push_back(a.Alloc(1 << 20));
+
+    AllocatorStats stats;
+    a.GetStats(&stats);
+    for (void* p : ptrs) {
+      a.Free(p);
+    }
+
+    return stats.total_allocated_bytes;
+  };
+
+  ArenaConfig config;
+  config.initial_chunk_size_bytes = 1 << 20;
+
+  // 1MB, then 4MB for the 3MB allocation, which isn't split, and another 4MB for the 1MB allocation
+  config.extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo;
+  EXPECT_EQ(total_allocated_bytes(config), (1 << 20) + (4 << 20) + (4 << 20));
+
+  config.extend_strategy = ArenaExtendStrategy::kSameAsRequested;
+  EXPECT_EQ(total_allocated_bytes(config), (1 << 20) + (3 << 20) + (1 << 20));
+
+  config.extend_strategy = ArenaExtendStrategy::kFixedIncrement;
+  config.extend_increment_bytes = 2 << 20;
+  EXPECT_EQ(total_allocated_bytes(config), (1 << 20) + (3 << 20) + (2 << 20));
+
+  // the hard limit applies on top of the limit given to the arena
+  config.max_mem = 2 << 20;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, config);
+  EXPECT_EQ(a.Max(), static_cast<size_t>(2 << 20));
+  EXPECT_EQ(a.Alloc(3 << 20), nullptr);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <fstream>
+
+#include "core/framework/cost_based_placement_transformer.h"
+#include "core/framework/kernel_registry.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+typedef std::vector<onnxruntime::NodeArg*> ArgMap;
+
+static TypeProto TensorType(TensorProto_DataType elem_type, const std::vector<int64_t>& dims) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (auto dim : dims) {
+    shape->add_dim()->set_dim_value(dim);
+  }
+  return type;
+}
+
+// a chain of two Adds of a small int64 tensor next to a Relu of a large float tensor, all on the device
+static void BuildGraph(Graph& graph) {
+  TypeProto small_type = TensorType(TensorProto_DataType_INT64, {4});
+  TypeProto large_type = TensorType(TensorProto_DataType_FLOAT, {16, 1024});
+  auto& y_def = graph.GetOrCreateNodeArg("Y", &small_type);
+  auto& y1_def = graph.GetOrCreateNodeArg("Y1", &small_type);
+  auto& y2_def = graph.GetOrCreateNodeArg("Y2", &small_type);
+  auto& x_def = graph.GetOrCreateNodeArg("X", &large_type);
+  auto& r_def = graph.GetOrCreateNodeArg("R", &large_type);
+
+  graph.AddNode("add1", "Add", "small add", ArgMap{&y_def, &y_def}, ArgMap{&y1_def})
+      .SetExecutionProviderType(kCudaExecutionProvider);
+  graph.AddNode("add2", "Add", "small add", ArgMap{&y1_def, &y_def}, ArgMap{&y2_def})
+      .SetExecutionProviderType(kCudaExecutionProvider);
+  graph.AddNode("relu", "Relu", "large relu", ArgMap{&x_def}, ArgMap{&r_def})
+      .SetExecutionProviderType(kCudaExecutionProvider);
+}
+
+static const Node* FindNode(const Graph& graph, const std::string& name) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.Name() == name)
+      return &node;
+  }
+  return nullptr;
+}
+
+TEST(CostBasedPlacementTest, SmallNodesMovedToCpu) {
+  auto model = std::make_shared<onnxruntime::Model>("test");
+  onnxruntime::Graph& graph = model->MainGraph();
+  BuildGraph(graph);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  CostBasedPlacementTransformer transformer("Test", kCudaExecutionProvider, PlacementCostModel());
+  transformer.AddKernelRegistry(*TestCPUExecutionProvider()->GetKernelRegistry().get());
+  bool modified = false;
+  auto status = transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  // the copies of the small tensors take longer than their Adds on the device
+  EXPECT_EQ(FindNode(graph, "add1")->GetExecutionProviderType(), kCpuExecutionProvider);
+  EXPECT_EQ(FindNode(graph, "add2")->GetExecutionProviderType(), kCpuExecutionProvider);
+  EXPECT_EQ(FindNode(graph, "relu")->GetExecutionProviderType(), kCudaExecutionProvider);
+}
+
+TEST(CostBasedPlacementTest, MeasuredTimeKeepsNodesOnDevice) {
+  auto model = std::make_shared<onnxruntime::Model>("test");
+  onnxruntime::Graph& graph = model->MainGraph();
+  BuildGraph(graph);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  PlacementCostModel cost_model;
+  cost_model.op_times_us[PlacementCostModel::TimeKey(kCpuExecutionProvider, "Add")] = 1000.0;
+  CostBasedPlacementTransformer transformer("Test", kCudaExecutionProvider, std::move(cost_model));
+  transformer.AddKernelRegistry(*TestCPUExecutionProvider()->GetKernelRegistry().get());
+  bool modified = false;
+  auto status = transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_FALSE(modified);
+
+  for (const auto& node : graph.Nodes()) {
+    EXPECT_EQ(node.GetExecutionProviderType(), kCudaExecutionProvider);
+  }
+}
+
+TEST(CostBasedPlacementTest, LoadProfile) {
+  const std::string profile_file = "cost_based_placement_test_profile.json";
+  {
+    std::ofstream profile(profile_file);
+    profile << "[\n"
+            << R"({"cat" : "Session","pid" :1,"tid" :1,"dur" :500,"ts" :0,"ph" : "X","name" :"model_run","args" : {}},)"
+            << "\n"
+            << R"({"cat" : "Node","pid" :1,"tid" :1,"dur" :30,"ts" :1,"ph" : "X","name" :"add_kernel_time",)"
+            << R"("args" : {"op_name" : "Add"}},)" << "\n"
+            << R"({"cat" : "Node","pid" :1,"tid" :1,"dur" :10,"ts" :2,"ph" : "X","name" :"add_kernel_time",)"
+            << R"("args" : {"op_name" : "Add"}},)" << "\n"
+            << R"({"cat" : "Node","pid" :1,"tid" :1,"dur" :5,"ts" :3,"ph" : "X","name" :"relu_kernel_time",)"
+            << R"("args" : {"op_name" : "Relu"}},)" << "\n"
+            << R"({"cat" : "Node","pid" :1,"tid" :1,"dur" :40,"ts" :3,"ph" : "X","name" :"relu_device_time",)"
+            << R"("args" : {"op_name" : "Relu","provider" : "CUDAExecutionProvider"}})" << "\n"
+            << "]\n";
+  }
+
+  PlacementCostModel cost_model;
+  auto status = cost_model.LoadProfile(profile_file);
+  std::remove(profile_file.c_str());
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // the kernel time of a node with a device time is the time of its launch
+  EXPECT_EQ(cost_model.node_times_us.size(), 2u);
+  EXPECT_EQ(cost_model.node_times_us[PlacementCostModel::TimeKey(kCpuExecutionProvider, "add")], 20.0);
+  EXPECT_EQ(cost_model.node_times_us[PlacementCostModel::TimeKey(kCudaExecutionProvider, "relu")], 40.0);
+  EXPECT_EQ(cost_model.op_times_us.size(), 2u);
+  EXPECT_EQ(cost_model.op_times_us[PlacementCostModel::TimeKey(kCpuExecutionProvider, "Add")], 20.0);
+  EXPECT_EQ(cost_model.op_times_us[PlacementCostModel::TimeKey(kCudaExecutionProvider, "Relu")], 40.0);
+
+  EXPECT_FALSE(cost_model.LoadProfile("no_such_profile.json").IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
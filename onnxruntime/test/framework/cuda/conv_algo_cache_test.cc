@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "core/providers/cuda/nn/conv_algo_cache.h"
+
+namespace onnxruntime {
+namespace test {
+
+using cuda::CudnnConvAlgoCache;
+using cuda::CudnnConvAlgoPerf;
+
+static std::string MakeTestKey(const std::vector<int64_t>& x_dims) {
+  return CudnnConvAlgoCache::MakeKey("fwd", 0, CUDNN_DATA_FLOAT, x_dims, {8, 3, 3, 3}, {}, {1, 1, 1, 1}, {1, 1},
+                                     {1, 1}, 1, 1024);
+}
+
+TEST(CudnnConvAlgoCacheTest, KeyDependsOnProblem) {
+  EXPECT_EQ(MakeTestKey({1, 3, 32, 32}), MakeTestKey({1, 3, 32, 32}));
+  EXPECT_NE(MakeTestKey({1, 3, 32, 32}), MakeTestKey({2, 3, 32, 32}));
+  EXPECT_NE(MakeTestKey({1, 3, 32, 32}),
+            CudnnConvAlgoCache::MakeKey("fwd", 0, CUDNN_DATA_HALF, {1, 3, 32, 32}, {8, 3, 3, 3}, {},
+                                        {1, 1, 1, 1}, {1, 1}, {1, 1}, 1, 1024));
+}
+
+TEST(CudnnConvAlgoCacheTest, SaveAndLoad) {
+  auto& cache = CudnnConvAlgoCache::Instance();
+  const std::string saved_key = MakeTestKey({3, 3, 17, 19});
+  cache.Insert(saved_key, CudnnConvAlgoPerf{2, 4096, 1});
+
+  const std::string path = "cudnn_conv_algo_cache_test.txt";
+  ASSERT_TRUE(cache.Save(path).IsOK());
+
+  // add an entry that is only in the file, as if another process had found it
+  const std::string loaded_key = MakeTestKey({5, 3, 23, 29});
+  {
+    std::ofstream file(path, std::ios::app);
+    file << loaded_key << "\t1\t512\t0\n";
+  }
+
+  // loading does not replace entries found in this process
+  cache.Insert(saved_key, CudnnConvAlgoPerf{0, 0, 0});
+  ASSERT_TRUE(cache.Load(path).IsOK());
+  std::remove(path.c_str());
+
+  CudnnConvAlgoPerf perf;
+  ASSERT_TRUE(cache.Find(saved_key, perf));
+  EXPECT_EQ(perf.algo, 0);
+
+  ASSERT_TRUE(cache.Find(loaded_key, perf));
+  EXPECT_EQ(perf.algo, 1);
+  EXPECT_EQ(perf.workspace_bytes, 512u);
+  EXPECT_EQ(perf.math_type, 0);
+
+  // a missing file is not an error
+  EXPECT_TRUE(cache.Load(path).IsOK());
+}
+
+TEST(CudnnConvAlgoCacheTest, LoadRejectsUnknownFile) {
+  const std::string path = "cudnn_conv_algo_cache_bad.txt";
+  {
+    std::ofstream file(path);
+    file << "not a cache file\n";
+  }
+  EXPECT_FALSE(CudnnConvAlgoCache::Instance().Load(path).IsOK());
+  std::remove(path.c_str());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
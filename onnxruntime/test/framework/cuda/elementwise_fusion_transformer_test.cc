@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/elementwise_fusion_transformer.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+typedef std::vector<onnxruntime::NodeArg*> ArgMap;
+
+TEST(TransformerTest, ElementwiseFusionTest) {
+  auto model = std::make_shared<onnxruntime::Model>("test");
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg a_def("A", &tensor_float),
+      b_def("B", &tensor_float),
+      c_def("C", &tensor_float),
+      sum_def("Sum", &tensor_float),
+      product_def("Product", &tensor_float),
+      sigmoid_def("Sigmoid", &tensor_float),
+      swish_def("Swish", &tensor_float),
+      y_def("Y", &tensor_float);
+
+  // Swish = Product * Sigmoid(Product) reads Product twice inside the chain.
+  // Softmax is not element-wise and stays a separate node.
+  graph.AddNode("add", "Add", "", ArgMap{&a_def, &b_def}, ArgMap{&sum_def});
+  graph.AddNode("mul", "Mul", "", ArgMap{&sum_def, &c_def}, ArgMap{&product_def});
+  graph.AddNode("sigmoid", "Sigmoid", "", ArgMap{&product_def}, ArgMap{&sigmoid_def});
+  graph.AddNode("swish", "Mul", "", ArgMap{&product_def, &sigmoid_def}, ArgMap{&swish_def});
+  graph.AddNode("softmax", "Softmax", "", ArgMap{&swish_def}, ArgMap{&y_def});
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+  }
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  ElementwiseFusionTransformer transformer("Test", onnxruntime::kCudaExecutionProvider);
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(graph.NumberOfNodes(), 2);
+
+  const Node* fused = nullptr;
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "FusedElementwise")
+      fused = &node;
+  }
+  ASSERT_NE(fused, nullptr);
+  EXPECT_EQ(fused->GetExecutionProviderType(), onnxruntime::kCudaExecutionProvider);
+  EXPECT_EQ(fused->InputDefs().size(), 3u);
+  EXPECT_EQ(fused->OutputDefs()[0]->Name(), "Swish");
+  EXPECT_EQ(fused->OutputNodesBegin()->OpType(), "Softmax");
+
+  const auto& ops = fused->GetAttributes().at("ops");
+  ASSERT_EQ(ops.strings_size(), 4);
+  EXPECT_EQ(ops.strings(0), "Add");
+  EXPECT_EQ(ops.strings(3), "Mul");
+  const auto& operands = fused->GetAttributes().at("operands");
+  ASSERT_EQ(operands.ints_size(), 8);
+  // the last Mul reads the results of the first Mul and the Sigmoid
+  EXPECT_EQ(operands.ints(6), 3 + 1);
+  EXPECT_EQ(operands.ints(7), 3 + 2);
+}
+
+TEST(TransformerTest, ElementwiseFusionKeepsSharedOutputsTest) {
+  auto model = std::make_shared<onnxruntime::Model>("test");
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg a_def("A", &tensor_float),
+      b_def("B", &tensor_float),
+      sum_def("Sum", &tensor_float),
+      relu_def("Relu", &tensor_float),
+      y_def("Y", &tensor_float);
+
+  // Sum is also read by the Softmax, so the Add can't be fused into the Relu
+  graph.AddNode("add", "Add", "", ArgMap{&a_def, &b_def}, ArgMap{&sum_def});
+  graph.AddNode("relu", "Relu", "", ArgMap{&sum_def}, ArgMap{&relu_def});
+  graph.AddNode("softmax", "Softmax", "", ArgMap{&sum_def}, ArgMap{&y_def});
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+  }
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  ElementwiseFusionTransformer transformer("Test", onnxruntime::kCudaExecutionProvider);
+  bool modified = false;
+  ASSERT_TRUE(transformer.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+  EXPECT_EQ(graph.NumberOfNodes(), 3);
+}
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mixed_precision_transformer.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+typedef std::vector<onnxruntime::NodeArg*> ArgMap;
+
+static int32_t ElemType(const NodeArg* arg) {
+  return arg->TypeAsProto()->tensor_type().elem_type();
+}
+
+TEST(TransformerTest, MixedPrecisionCudaTest) {
+  auto model = std::make_shared<onnxruntime::Model>("test");
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg x_def("X", &tensor_float),
+      w_def("W", &tensor_float),
+      m_def("M", &tensor_float),
+      r_def("R", &tensor_float),
+      y_def("Y", &tensor_float);
+
+  TensorProto w_tensor;
+  w_tensor.set_name("W");
+  w_tensor.set_data_type(TensorProto_DataType_FLOAT);
+  w_tensor.add_dims(2);
+  w_tensor.add_dims(2);
+  for (float value : {1.0f, -2.0f, 0.5f, 4.0f}) {
+    w_tensor.add_float_data(value);
+  }
+  graph.AddInitializedTensor(w_tensor);
+
+  auto& matmul = graph.AddNode("matmul", "MatMul", "converted", ArgMap{&x_def, &w_def}, ArgMap{&m_def});
+  auto& relu = graph.AddNode("relu", "Relu", "follows the converted matmul", ArgMap{&m_def}, ArgMap{&r_def});
+  auto& softmax = graph.AddNode("softmax", "Softmax", "stays in float", ArgMap{&r_def}, ArgMap{&y_def});
+  for (auto* node : {&matmul, &relu, &softmax}) {
+    node->SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+  }
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto cuda_execution_provider = TestCudaExecutionProvider();
+  MixedPrecisionTransformer transformer("Test", onnxruntime::kCudaExecutionProvider);
+  transformer.AddKernelRegistry(*cuda_execution_provider->GetKernelRegistry().get());
+
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  // a Cast for X in front of the MatMul and one after the Relu feeding the Softmax
+  EXPECT_EQ(graph.NumberOfNodes(), 5);
+
+  EXPECT_EQ(ElemType(matmul.InputDefs()[0]), TensorProto_DataType_FLOAT16);
+  EXPECT_EQ(matmul.InputNodesBegin()->OpType(), "Cast");
+  EXPECT_EQ(ElemType(relu.InputDefs()[0]), TensorProto_DataType_FLOAT16);
+  EXPECT_EQ(ElemType(relu.OutputDefs()[0]), TensorProto_DataType_FLOAT16);
+  EXPECT_EQ(ElemType(softmax.InputDefs()[0]), TensorProto_DataType_FLOAT);
+  EXPECT_EQ(softmax.InputNodesBegin()->OpType(), "Cast");
+
+  // the weight is converted in place instead of being cast on every Run
+  const TensorProto* tensor = nullptr;
+  EXPECT_FALSE(graph.GetInitializedTensor("W", tensor));
+  ASSERT_TRUE(graph.GetInitializedTensor(matmul.InputDefs()[1]->Name(), tensor));
+  EXPECT_EQ(tensor->data_type(), TensorProto_DataType_FLOAT16);
+  EXPECT_EQ(tensor->int32_data_size(), 4);
+}
+
+TEST(TransformerTest, MixedPrecisionSkipsOtherProvidersTest) {
+  auto model = std::make_shared<onnxruntime::Model>("test");
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg a_def("A", &tensor_float),
+      b_def("B", &tensor_float),
+      c_def("C", &tensor_float);
+
+  auto& matmul = graph.AddNode("matmul", "MatMul", "cpu node", ArgMap{&a_def, &b_def}, ArgMap{&c_def});
+  matmul.SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto cuda_execution_provider = TestCudaExecutionProvider();
+  MixedPrecisionTransformer transformer("Test", onnxruntime::kCudaExecutionProvider);
+  transformer.AddKernelRegistry(*cuda_execution_provider->GetKernelRegistry().get());
+
+  bool modified = false;
+  ASSERT_TRUE(transformer.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+  EXPECT_EQ(graph.NumberOfNodes(), 1);
+  EXPECT_EQ(ElemType(matmul.InputDefs()[0]), TensorProto_DataType_FLOAT);
+}
+}  // namespace test
+}  // namespace onnxruntime
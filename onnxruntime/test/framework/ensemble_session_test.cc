@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/ensemble_session.h"
+
+#include <thread>
+
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+#include "test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// a model of one node of op_type over float tensors of shape {2}, loaded into session
+static void CreateSession(const std::string& op_type, const std::vector<std::string>& input_names,
+                          const std::string& output_name, std::unique_ptr<InferenceSession>& session) {
+  SessionOptions so;
+  so.session_logid = "EnsembleSessionTest." + op_type;
+  session = std::make_unique<InferenceSession>(so, &DefaultLoggingManager());
+  auto status = LoadSingleNodeModel(*session, op_type, input_names, output_name, MakeFloatTensorType({2}));
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+// Y = X * X, N = -X and S = Y + X, with Y of the first member connected to the last
+static void CreateMembers(std::vector<EnsembleMember>& members) {
+  members.resize(3);
+  CreateSession("Mul", {"X", "X"}, "Y", members[0].session);
+  CreateSession("Neg", {"X"}, "N", members[1].session);
+  CreateSession("Add", {"Y", "X"}, "S", members[2].session);
+}
+
+static MLValue CreateFeed(float x0, float x1) {
+  return CreateFloatValue({2}, {x0, x1});
+}
+
+TEST(EnsembleSessionTest, SharedFeedsAndConnections) {
+  std::vector<EnsembleMember> members;
+  CreateMembers(members);
+
+  std::unique_ptr<EnsembleSession> ensemble_session;
+  auto status = EnsembleSession::Create(std::move(members), {{0, "Y", 2, "Y"}}, ensemble_session);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(ensemble_session->NumMembers(), 3u);
+  EXPECT_EQ(ensemble_session->GetMemberOutputNames(1), (std::vector<std::string>{"N"}));
+
+  NameMLValMap feeds{{"X", CreateFeed(2.0f, 3.0f)}};
+  RunOptions run_options;
+  std::vector<std::vector<MLValue>> fetches;
+  status = ensemble_session->Run(run_options, feeds, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(fetches.size(), 3u);
+
+  const float* y = fetches[0].at(0).Get<Tensor>().Data<float>();
+  EXPECT_EQ(y[0], 4.0f);
+  EXPECT_EQ(y[1], 9.0f);
+  const float* n = fetches[1].at(0).Get<Tensor>().Data<float>();
+  EXPECT_EQ(n[0], -2.0f);
+  EXPECT_EQ(n[1], -3.0f);
+  const float* s = fetches[2].at(0).Get<Tensor>().Data<float>();
+  EXPECT_EQ(s[0], 6.0f);
+  EXPECT_EQ(s[1], 12.0f);
+}
+
+TEST(EnsembleSessionTest, ConcurrentRuns) {
+  std::vector<EnsembleMember> members;
+  CreateMembers(members);
+  std::unique_ptr<EnsembleSession> ensemble_session;
+  ASSERT_TRUE(EnsembleSession::Create(std::move(members), {{0, "Y", 2, "Y"}}, ensemble_session).IsOK());
+
+  const int num_requests = 8;
+  std::vector<std::thread> threads;
+  std::vector<Status> statuses(num_requests);
+  std::vector<std::vector<std::vector<MLValue>>> fetches(num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&, i]() {
+      NameMLValMap feeds{{"X", CreateFeed(static_cast<float>(i), 1.0f)}};
+      RunOptions run_options;
+      statuses[i] = ensemble_session->Run(run_options, feeds, &fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i].ErrorMessage();
+    const float* s = fetches[i][2].at(0).Get<Tensor>().Data<float>();
+    EXPECT_EQ(s[0], static_cast<float>(i * i + i));
+    EXPECT_EQ(s[1], 2.0f);
+  }
+}
+
+TEST(EnsembleSessionTest, FailedMember) {
+  std::vector<EnsembleMember> members;
+  CreateMembers(members);
+  std::unique_ptr<EnsembleSession> ensemble_session;
+  ASSERT_TRUE(EnsembleSession::Create(std::move(members), {{0, "Y", 2, "Y"}}, ensemble_session).IsOK());
+
+  // without X no member can run, and the Add member that reads from the Mul one is skipped
+  NameMLValMap feeds{{"W", CreateFeed(1.0f, 1.0f)}};
+  RunOptions run_options;
+  std::vector<std::vector<MLValue>> fetches;
+  EXPECT_FALSE(ensemble_session->Run(run_options, feeds, &fetches).IsOK());
+  EXPECT_TRUE(fetches.empty());
+}
+
+TEST(EnsembleSessionTest, InvalidConnections) {
+  const std::vector<std::vector<EnsembleConnection>> invalid_connections{
+      {{0, "Y", 3, "Y"}},                    // no such member
+      {{0, "Z", 2, "Y"}},                    // no such output
+      {{0, "Y", 2, "Z"}},                    // no such input
+      {{0, "Y", 2, "Y"}, {1, "N", 2, "Y"}},  // connected twice
+      {{0, "Y", 2, "Y"}, {2, "S", 0, "X"}},  // a cycle
+  };
+
+  for (const auto& connections : invalid_connections) {
+    std::vector<EnsembleMember> members;
+    CreateMembers(members);
+    std::unique_ptr<EnsembleSession> ensemble_session;
+    EXPECT_FALSE(EnsembleSession::Create(std::move(members), connections, ensemble_session).IsOK());
+    EXPECT_EQ(ensemble_session, nullptr);
+  }
+
+  std::vector<EnsembleMember> members;
+  CreateMembers(members);
+  members[1].output_names = {"Y"};
+  std::unique_ptr<EnsembleSession> ensemble_session;
+  EXPECT_FALSE(EnsembleSession::Create(std::move(members), {}, ensemble_session).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
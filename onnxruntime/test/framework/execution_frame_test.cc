@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/execution_frame.h"
+#include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/graph/model.h"
@@ -156,6 +157,58 @@ TEST(ExecutionFrameTest, FeedInDataTest) {
   EXPECT_EQ(p_tensor_arg_0->template MutableData<float>(), buffer);
 }
 
+TEST(ExecutionFrameTest, FeedInDataByIndexTest) {
+  onnxruntime::Model model("test");
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), output_def("Y", &tensor_float);
+
+  graph.AddNode("node1", "Clip", "Clip operator", ArgMap{&input_def}, ArgMap{&output_def});
+  graph.Resolve();
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  auto element_type = DataTypeImpl::GetType<float>();
+  TensorShape shape({3, 2});
+  void* buffer = cpu_allocator->Alloc(element_type->Size() * shape.Size());
+  std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type,
+                                                              shape,
+                                                              buffer,
+                                                              cpu_allocator->Info(),
+                                                              cpu_allocator);
+  MLValue value;
+  value.Init(p_tensor.release(),
+             DataTypeImpl::GetType<Tensor>(),
+             DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+
+  auto cpu_xp = CreateCPUExecutionProvider();
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add("", std::move(cpu_xp));
+
+  SessionState state{execution_providers};
+  state.SetGraphViewer(std::make_unique<GraphViewer>(graph));
+
+  MLValueNameIdxMap& mlvalue_name_idx_map{state.GetMLValueNameIdxMap()};
+  mlvalue_name_idx_map.Add("Y");
+  int x_idx = mlvalue_name_idx_map.Add("X");
+
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+  ASSERT_TRUE(FeedsFetchesManager::Create({"X"}, {"Y"}, state, feeds_fetches_manager).IsOK());
+  EXPECT_EQ(feeds_fetches_manager->GetFeedsMLValueIdxs(), std::vector<int>{x_idx});
+  // only the CPU execution provider is registered
+  EXPECT_FALSE(feeds_fetches_manager->DeviceCopiesMayBeNeeded());
+
+  vector<MLValue> outputs;
+  ExecutionFrame frame(feeds_fetches_manager->GetFeedsMLValueIdxs(), {value},
+                       feeds_fetches_manager->GetFetchesMLValueIdxs(), outputs, {}, state);
+
+  EXPECT_EQ(frame.GetMLValue(x_idx).Get<Tensor>().template Data<float>(), buffer);
+
+  // unknown names are an error
+  std::unique_ptr<FeedsFetchesManager> invalid_manager;
+  EXPECT_FALSE(FeedsFetchesManager::Create({"Z"}, {"Y"}, state, invalid_manager).IsOK());
+}
+
 TEST(ExecutionFrameTest, MemPatternTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
   auto xp_type = cpu_xp->Type();
@@ -253,6 +306,147 @@ TEST(ExecutionFrameTest, MemPatternTest) {
   EXPECT_EQ(p->PeakSize(), 2 * 64); // each allocation is 64-byte aligned
   EXPECT_EQ(p->GetBlock(3)->offset_, 0);
   EXPECT_EQ(p->GetBlock(4)->offset_, 64);
+
+  // frames acquired from the session state are reused, along with their memory pattern buffer,
+  // by later Runs with the same input shapes.
+  std::unordered_map<std::string, MLValue> feeds{{"X1", v1}, {"X2", v2}, {"X3", v3}};
+  std::vector<TensorShape> input_shapes;
+  for (const auto& feed : feeds) {
+    input_shapes.push_back(feed.second.Get<Tensor>().Shape());
+  }
+
+  status = state.UpdateMemoryPatternGroupCache(input_shapes, std::make_unique<MemoryPatternGroup>(pattern));
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const ExecutionFrame* first_frame = nullptr;
+  const void* first_buffer = nullptr;
+  {
+    auto cached_frame = state.AcquireExecutionFrame(feeds, std::vector<std::string>{"T3"}, outputs, {});
+    EXPECT_FALSE(cached_frame->HasPlan());  // the cached pattern is used so nothing is traced
+    status = cached_frame->AllocateMLValueTensorSelfOwnBuffer(3,
+                                                              DataTypeImpl::GetType<float>(),
+                                                              cpu_allocator->Info(),
+                                                              TensorShape(std::vector<int64_t>{2, 2}));
+    EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+    first_frame = cached_frame.get();
+    first_buffer = cached_frame->GetMLValue(3).Get<Tensor>().DataRaw();
+  }
+
+  {
+    auto cached_frame = state.AcquireExecutionFrame(feeds, std::vector<std::string>{"T3"}, outputs, {});
+    EXPECT_EQ(cached_frame.get(), first_frame);
+    EXPECT_FALSE(cached_frame->GetMLValue(3).IsAllocated());
+    status = cached_frame->AllocateMLValueTensorSelfOwnBuffer(3,
+                                                              DataTypeImpl::GetType<float>(),
+                                                              cpu_allocator->Info(),
+                                                              TensorShape(std::vector<int64_t>{2, 2}));
+    EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+    EXPECT_EQ(cached_frame->GetMLValue(3).Get<Tensor>().DataRaw(), first_buffer);
+  }
+}
+
+TEST(ExecutionFrameTest, ScratchBufferPatternTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X1", &tensor_float),
+      clip1_out_def("T1", &tensor_float),
+      clip2_out_def("T2", &tensor_float);
+
+  auto& clip1 = graph.AddNode("node1", "Clip", "clip1", ArgMap{&input_def}, ArgMap{&clip1_out_def});
+  clip1.SetExecutionProviderType(xp_type);
+  auto& clip2 = graph.AddNode("node2", "Clip", "clip2", ArgMap{&clip1_out_def}, ArgMap{&clip2_out_def});
+  clip2.SetExecutionProviderType(xp_type);
+
+  auto status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  KernelRegistryManager kernel_registry_manager;
+  kernel_registry_manager.RegisterKernelRegistry(cpu_xp->GetKernelRegistry(), KernelRegistryPriority::LowPriority);
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_type, std::move(cpu_xp));
+
+  SessionState state{execution_providers};
+  state.SetGraphViewer(std::make_unique<GraphViewer>(graph));
+
+  MLValueNameIdxMap& mlvalue_name_idx_map{state.GetMLValueNameIdxMap()};
+  mlvalue_name_idx_map.Add("X1");
+  mlvalue_name_idx_map.Add("T1");
+  mlvalue_name_idx_map.Add("T2");
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->GetAllocator(0, OrtMemTypeDefault);
+  const auto& location = cpu_allocator->Info();
+
+  MLValue v1;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v1);
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan = std::make_unique<SequentialExecutionPlan>();
+  status = SequentialPlanner::CreatePlan(GraphViewer(graph), {}, execution_providers, kernel_registry_manager,
+                                         mlvalue_name_idx_map, p_seq_exec_plan);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  state.SetExecutionPlan(std::move(p_seq_exec_plan));
+
+  std::unordered_map<std::string, MLValue> feeds{{"X1", v1}};
+  vector<MLValue> outputs;
+  MemoryPatternGroup pattern;
+  {
+    ExecutionFrame frame(feeds, std::vector<std::string>{"T2"}, outputs, {}, state);
+    ASSERT_TRUE(frame.HasPlan());
+
+    // T1, then a scratch buffer for each node, the first being released before the second is allocated
+    status = frame.AllocateMLValueTensorSelfOwnBuffer(1, DataTypeImpl::GetType<float>(), location,
+                                                      TensorShape(std::vector<int64_t>{2, 2}));
+    EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+    BufferUniquePtr scratch;
+    status = frame.AllocateScratchBuffer(clip1.Index(), location, 100, scratch);
+    EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+    EXPECT_NE(scratch.get(), nullptr);
+    scratch.reset();
+    frame.TraceScratchBufferFree(clip1.Index(), location);
+    status = frame.AllocateScratchBuffer(clip2.Index(), location, 64, scratch);
+    EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    status = frame.GeneratePatterns(&pattern);
+    EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
+  auto p = pattern.GetPatterns(location);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(p->PeakSize(), 64 + 128);  // the scratch buffers are 64-byte aligned as the tensors
+
+  std::vector<TensorShape> input_shapes{v1.Get<Tensor>().Shape()};
+  status = state.UpdateMemoryPatternGroupCache(input_shapes, std::make_unique<MemoryPatternGroup>(std::move(pattern)));
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // a later Run gets the scratch buffers from the memory pattern buffer
+  ExecutionFrame frame(feeds, std::vector<std::string>{"T2"}, outputs, {}, state);
+  EXPECT_FALSE(frame.HasPlan());
+  status = frame.AllocateMLValueTensorSelfOwnBuffer(1, DataTypeImpl::GetType<float>(), location,
+                                                    TensorShape(std::vector<int64_t>{2, 2}));
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  const char* base = static_cast<const char*>(frame.GetMLValue(1).Get<Tensor>().DataRaw());
+
+  BufferUniquePtr scratch1, scratch2;
+  status = frame.AllocateScratchBuffer(clip1.Index(), location, 100, scratch1);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_EQ(scratch1.get(), base + 64);
+  status = frame.AllocateScratchBuffer(clip2.Index(), location, 64, scratch2);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_EQ(scratch2.get(), base + 64);
+  EXPECT_FALSE(frame.MemoryPatternOverflowed());
+
+  // more than the pattern reserved is allocated separately
+  BufferUniquePtr large_scratch;
+  status = frame.AllocateScratchBuffer(clip2.Index(), location, 1024, large_scratch);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_NE(large_scratch.get(), nullptr);
+  EXPECT_TRUE(frame.MemoryPatternOverflowed());
 }
 }  // namespace test
 }  // namespace onnxruntime
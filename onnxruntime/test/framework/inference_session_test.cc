@@ -5,27 +5,38 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <cstring>
+#include <cstdio>
 #include <functional>
+#include <future>
 #include <iterator>
+#include <map>
+#include <atomic>
+#include <mutex>
 #include <thread>
 #include <fstream>
+#include <sstream>
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include "core/platform/env.h"
+#include "core/platform/hardware_counters.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
 #include "core/framework/execution_provider.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_cache.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/compute_capability.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 #include "test/capturing_sink.h"
 #include "test/test_environment.h"
 #include "test/providers/provider_test_utils.h"
@@ -325,6 +336,911 @@ TEST(InferenceSessionTests, NoTimeout) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, IntraOpThreadLimit) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.IntraOpThreadLimit";
+  so.enable_sequential_execution = false;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "IntraOpThreadLimit";
+  run_options.intra_op_thread_limit = 1;
+  RunModel(session_object, run_options);
+
+  // the limit only applies for the duration of the Run call
+  EXPECT_EQ(MlasGetThreadLimit(), 0);
+}
+
+TEST(InferenceSessionTests, AllocatorStatsAndShrink) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.AllocatorStatsAndShrink";
+  so.allocator_stats_log_interval = 1;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  AllocatorStats stats;
+  auto status = session_object.GetAllocatorStats(OrtAllocatorInfo(CPU, OrtArenaAllocator), stats);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_GT(stats.num_allocs, 0);
+  EXPECT_GT(stats.max_bytes_in_use, 0);
+  EXPECT_GT(stats.total_allocated_bytes, 0);
+  EXPECT_LE(stats.largest_free_chunk, stats.free_bytes_in_bins);
+
+  // the initializers stay allocated
+  ASSERT_TRUE(session_object.ShrinkMemoryArenas().IsOK());
+  RunModel(session_object, run_options);
+
+  EXPECT_FALSE(session_object.GetAllocatorStats(OrtAllocatorInfo("NoDevice", OrtArenaAllocator), stats).IsOK());
+}
+
+TEST(InferenceSessionTests, ShrinkReleasesCachedFrames) {
+  // Z = (X * X) * X, the intermediate being placed by the memory pattern from the second Run on
+  Model model("ShrinkReleasesCachedFrames");
+  auto& graph = model.MainGraph();
+  const TypeProto float_tensor = MakeFloatTensorType({1024});
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+  graph.AddNode("mul_0", "Mul", "", {&x, &x}, {&y});
+  graph.AddNode("mul_1", "Mul", "", {&y, &x}, {&z});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ShrinkReleasesCachedFrames";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  auto status = LoadModel(session_object, model);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  for (int i = 0; i < 2; ++i) {
+    std::vector<MLValue> fetches;
+    NameMLValMap feeds{{"X", CreateFloatValue({1024}, std::vector<float>(1024, 2.f))}};
+    status = session_object.Run(RunOptions(), feeds, {"Z"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    EXPECT_EQ(fetches.at(0).Get<Tensor>().Data<float>()[0], 8.f);
+  }
+
+  // the frame cached by the second Run holds the memory pattern buffer
+  AllocatorStats before;
+  ASSERT_TRUE(session_object.GetAllocatorStats(OrtAllocatorInfo(CPU, OrtArenaAllocator), before).IsOK());
+  ASSERT_TRUE(session_object.ShrinkMemoryArenas().IsOK());
+  AllocatorStats after;
+  ASSERT_TRUE(session_object.GetAllocatorStats(OrtAllocatorInfo(CPU, OrtArenaAllocator), after).IsOK());
+  EXPECT_LT(after.bytes_in_use, before.bytes_in_use);
+}
+
+TEST(InferenceSessionTests, SaveOptimizedModel) {
+  const std::string optimized_model_path = "mul_1_optimized.onnx";
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SaveOptimizedModel";
+  so.optimized_model_filepath = optimized_model_path;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  auto status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  // the saved model records the provider of each node and runs without being transformed again
+  SessionOptions optimized_so;
+  optimized_so.session_logid = "InferenceSessionTests.SaveOptimizedModel.Load";
+  InferenceSession optimized_session{optimized_so, &DefaultLoggingManager()};
+  ASSERT_TRUE(optimized_session.Load(optimized_model_path).IsOK());
+  status = optimized_session.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto metadata = optimized_session.GetModelMetadata();
+  ASSERT_TRUE(metadata.first.IsOK());
+  auto providers = metadata.second->custom_metadata_map.find("onnxruntime.node_execution_providers");
+  ASSERT_NE(providers, metadata.second->custom_metadata_map.end());
+  EXPECT_EQ(providers->second, kCpuExecutionProvider);
+  RunModel(optimized_session, run_options);
+
+  std::remove(optimized_model_path.c_str());
+}
+
+static void AddExternalInitializer(Graph& graph, const std::string& name, const std::string& location,
+                                   size_t offset, size_t length) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  tensor_proto.add_dims(2);
+  tensor_proto.set_data_location(TensorProto_DataLocation_EXTERNAL);
+  auto* entry = tensor_proto.add_external_data();
+  entry->set_key("location");
+  entry->set_value(location);
+  entry = tensor_proto.add_external_data();
+  entry->set_key("offset");
+  entry->set_value(std::to_string(offset));
+  entry = tensor_proto.add_external_data();
+  entry->set_key("length");
+  entry->set_value(std::to_string(length));
+  graph.AddInitializedTensor(tensor_proto);
+}
+
+TEST(InferenceSessionTests, ExternalInitializerData) {
+  const std::string data_path = "external_initializers.bin";
+  const std::string model_path = "external_initializers.onnx";
+
+  // addend at offset 8, which is read in place, and factor at offset 26, which isn't aligned to a float and is copied
+  const float addend[] = {1.f, 2.f};
+  const float factor[] = {3.f, 4.f};
+  std::vector<char> data(34, 0);
+  std::memcpy(data.data() + 8, addend, sizeof(addend));
+  std::memcpy(data.data() + 26, factor, sizeof(factor));
+  {
+    std::ofstream data_stream(data_path, std::ios::binary | std::ios::trunc);
+    data_stream.write(data.data(), data.size());
+  }
+
+  Model model("ExternalInitializerData");
+  auto& graph = model.MainGraph();
+  AddExternalInitializer(graph, "addend", data_path, 8, sizeof(addend));
+  AddExternalInitializer(graph, "factor", data_path, 26, sizeof(factor));
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input = graph.GetOrCreateNodeArg("input", &float_tensor);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("output", &float_tensor);
+  graph.AddNode("add", "Add", "", {&input, graph.GetNodeArg("addend")}, {&sum});
+  graph.AddNode("mul", "Mul", "", {&sum, graph.GetNodeArg("factor")}, {&output});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  {
+    std::ofstream model_stream(model_path, std::ios::binary | std::ios::trunc);
+    ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+  }
+
+  for (bool enable_mem_pattern : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.ExternalInitializerData";
+    so.enable_mem_pattern = enable_mem_pattern;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    // the location of the data is relative to the directory of the model
+    ASSERT_TRUE(session_object.Load("./" + model_path).IsOK());
+    status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    MLValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {1.f, 1.f},
+                         &input_value);
+    std::vector<MLValue> fetches;
+    status = session_object.Run(RunOptions{}, NameMLValMap{{"input", input_value}}, {"output"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const float* result = fetches[0].Get<Tensor>().Data<float>();
+    EXPECT_EQ(result[0], 6.f);
+    EXPECT_EQ(result[1], 12.f);
+  }
+
+  std::remove(model_path.c_str());
+  std::remove(data_path.c_str());
+}
+
+TEST(InferenceSessionTests, ShareInitializers) {
+  Model model("ShareInitializers");
+  auto& graph = model.MainGraph();
+  const float addend[] = {1.f, 2.f};
+  TensorProto addend_proto;
+  addend_proto.set_name("shared_addend");
+  addend_proto.set_data_type(TensorProto_DataType_FLOAT);
+  addend_proto.add_dims(2);
+  addend_proto.set_raw_data(addend, sizeof(addend));
+  graph.AddInitializedTensor(addend_proto);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input = graph.GetOrCreateNodeArg("input", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("output", &float_tensor);
+  graph.AddNode("add", "Add", "", {&input, graph.GetNodeArg("shared_addend")}, {&output});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  const auto model_proto = model.ToProto();
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ShareInitializers";
+  so.share_initializers = true;
+  std::vector<std::unique_ptr<InferenceSession>> sessions;
+  for (int i = 0; i < 2; ++i) {
+    sessions.push_back(std::make_unique<InferenceSession>(so, &DefaultLoggingManager()));
+    std::stringstream model_stream;
+    model_proto.SerializeToOstream(&model_stream);
+    ASSERT_TRUE(sessions.back()->Load(model_stream).IsOK());
+    status = sessions.back()->Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
+  // the sessions hold the cached tensor
+  std::shared_ptr<const Tensor> shared_tensor;
+  ASSERT_TRUE(SharedInitializerCache::Instance().GetTensor(addend_proto, shared_tensor).IsOK());
+  EXPECT_EQ(shared_tensor.use_count(), 3);
+
+  for (auto& session : sessions) {
+    MLValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {1.f, 1.f},
+                         &input_value);
+    std::vector<MLValue> fetches;
+    status = session->Run(RunOptions{}, NameMLValMap{{"input", input_value}}, {"output"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const float* result = fetches[0].Get<Tensor>().Data<float>();
+    EXPECT_EQ(result[0], 2.f);
+    EXPECT_EQ(result[1], 3.f);
+  }
+
+  sessions.clear();
+  EXPECT_EQ(shared_tensor.use_count(), 1);
+}
+
+TEST(InferenceSessionTests, SharedInitializersReleaseTheirKeys) {
+  Model model("SharedInitializersReleaseTheirKeys");
+  auto& graph = model.MainGraph();
+  const float addend[] = {3.f, 4.f};
+  TensorProto addend_proto;
+  addend_proto.set_name("released_addend");
+  addend_proto.set_data_type(TensorProto_DataType_FLOAT);
+  addend_proto.add_dims(2);
+  addend_proto.set_raw_data(addend, sizeof(addend));
+  graph.AddInitializedTensor(addend_proto);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input = graph.GetOrCreateNodeArg("input", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("output", &float_tensor);
+  graph.AddNode("add", "Add", "", {&input, graph.GetNodeArg("released_addend")}, {&output});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SharedInitializersReleaseTheirKeys";
+  so.share_initializers = true;
+  auto& cache = SharedInitializerCache::Instance();
+  const size_t keys_before = cache.NumKeys();
+  std::vector<std::unique_ptr<InferenceSession>> sessions;
+  for (int i = 0; i < 2; ++i) {
+    sessions.push_back(std::make_unique<InferenceSession>(so, &DefaultLoggingManager()));
+    status = LoadModel(*sessions.back(), model);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+  EXPECT_EQ(cache.NumKeys(), keys_before + 1);
+
+  // the key is gone with the last session that held its tensor
+  sessions.pop_back();
+  EXPECT_EQ(cache.NumKeys(), keys_before + 1);
+  sessions.clear();
+  EXPECT_EQ(cache.NumKeys(), keys_before);
+}
+
+TEST(InferenceSessionTests, FreezeInputShapes) {
+  Model model("FreezeInputShapes");
+  auto& graph = model.MainGraph();
+  const std::vector<float> filter(9, 1.f);
+  TensorProto filter_proto;
+  filter_proto.set_name("W");
+  filter_proto.set_data_type(TensorProto_DataType_FLOAT);
+  for (auto dim : {1, 1, 3, 3}) {
+    filter_proto.add_dims(dim);
+  }
+  filter_proto.set_raw_data(filter.data(), filter.size() * sizeof(float));
+  graph.AddInitializedTensor(filter_proto);
+
+  // the batch of X is symbolic
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* input_shape = input_type.mutable_tensor_type()->mutable_shape();
+  input_shape->add_dim()->set_dim_param("N");
+  for (auto dim : {1, 3, 3}) {
+    input_shape->add_dim()->set_dim_value(dim);
+  }
+  TypeProto output_type;
+  output_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &input_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &output_type);
+  auto& conv = graph.AddNode("conv", "Conv", "", {&x, graph.GetNodeArg("W")}, {&y});
+  conv.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+
+  // X has a symbolic dimension, so its shape must be given
+  {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.FreezeInputShapes.Symbolic";
+    so.freeze_input_shapes = true;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::stringstream model_copy(model_stream.str());
+    ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+    EXPECT_FALSE(session_object.Initialize().IsOK());
+  }
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.FreezeInputShapes";
+  so.freeze_input_shapes = true;
+  so.frozen_input_shapes["X"] = {1, 1, 3, 3};
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::stringstream model_copy(model_stream.str());
+  ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+  status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // propagated to the output
+  auto outputs = session_object.GetModelOutputs();
+  ASSERT_TRUE(outputs.first.IsOK());
+  const auto* output_shape = outputs.second->at(0)->Shape();
+  ASSERT_NE(output_shape, nullptr);
+  EXPECT_EQ(utils::GetTensorShapeFromTensorShapeProto(*output_shape), std::vector<int64_t>({1, 1, 3, 3}));
+
+  MLValue input_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 1, 3, 3},
+                       std::vector<float>(9, 1.f), &input_value);
+  for (int i = 0; i < 2; i++) {
+    std::vector<MLValue> fetches;
+    status = session_object.Run(RunOptions{}, NameMLValMap{{"X", input_value}}, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const Tensor& result = fetches[0].Get<Tensor>();
+    ASSERT_EQ(result.Shape(), TensorShape({1, 1, 3, 3}));
+    const std::vector<float> expected{4.f, 6.f, 4.f, 6.f, 9.f, 6.f, 4.f, 6.f, 4.f};
+    for (size_t j = 0; j < expected.size(); j++) {
+      EXPECT_EQ(result.Data<float>()[j], expected[j]);
+    }
+  }
+
+  // another batch size is not the frozen shape
+  MLValue batch_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 1, 3, 3},
+                       std::vector<float>(18, 1.f), &batch_value);
+  std::vector<MLValue> fetches;
+  EXPECT_FALSE(session_object.Run(RunOptions{}, NameMLValMap{{"X", batch_value}}, {"Y"}, &fetches).IsOK());
+}
+
+TEST(InferenceSessionTests, KernelAutotuning) {
+  Model model("KernelAutotuning");
+  auto& graph = model.MainGraph();
+  const std::vector<float> filter(2 * 3 * 3 * 3, 1.f);
+  TensorProto filter_proto;
+  filter_proto.set_name("W");
+  filter_proto.set_data_type(TensorProto_DataType_FLOAT);
+  for (auto dim : {2, 3, 3, 3}) {
+    filter_proto.add_dims(dim);
+  }
+  filter_proto.set_raw_data(filter.data(), filter.size() * sizeof(float));
+  graph.AddInitializedTensor(filter_proto);
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (auto dim : {1, 3, 8, 8}) {
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  TypeProto output_type;
+  output_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &input_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &output_type);
+  graph.AddNode("conv", "Conv", "", {&x, graph.GetNodeArg("W")}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+
+  const std::string cache_file = "kernel_tuning_cache_test.txt";
+  std::remove(cache_file.c_str());
+
+  MLValue input_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 3, 8, 8},
+                       std::vector<float>(3 * 8 * 8, 1.f), &input_value);
+
+  // the first session times the algorithms and saves its decision, the second one reads it
+  for (int i = 0; i < 2; i++) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.KernelAutotuning";
+    so.freeze_input_shapes = true;
+    so.enable_kernel_autotuning = true;
+    so.kernel_tuning_cache_file = cache_file;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::stringstream model_copy(model_stream.str());
+    ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+    status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    std::vector<MLValue> fetches;
+    status = session_object.Run(RunOptions{}, NameMLValMap{{"X", input_value}}, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const Tensor& result = fetches[0].Get<Tensor>();
+    ASSERT_EQ(result.Shape(), TensorShape({1, 2, 6, 6}));
+    for (int64_t j = 0; j < result.Shape().Size(); j++) {
+      EXPECT_EQ(result.Data<float>()[j], 27.f);
+    }
+  }
+
+  std::ifstream cache(cache_file);
+  std::string line;
+  ASSERT_TRUE(std::getline(cache, line));
+  EXPECT_EQ(line, "kernel_tuning_cache 1");
+  ASSERT_TRUE(std::getline(cache, line));
+  EXPECT_EQ(line.compare(0, 9, "mlas_conv"), 0);
+  cache.close();
+  std::remove(cache_file.c_str());
+}
+
+TEST(InferenceSessionTests, NumaNode) {
+  Model model("NumaNode");
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input = graph.GetOrCreateNodeArg("input", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("output", &float_tensor);
+  graph.AddNode("add", "Add", "", {&input, &input}, {&output});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+
+  // a node the host doesn't have
+  {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.NumaNode.Invalid";
+    so.numa_node = Env::Default().GetNumaNodeCount();
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::stringstream model_copy(model_stream.str());
+    ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+    EXPECT_FALSE(session_object.Initialize().IsOK());
+  }
+
+  // hosts without the NUMA topology, e.g. some containers, report no CPUs for any node
+  if (Env::Default().GetNumaNodeCpus(0).empty()) {
+    return;
+  }
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.NumaNode";
+  so.numa_node = 0;
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::stringstream model_copy(model_stream.str());
+  ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+  status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  MLValue input_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {1.f, 2.f},
+                       &input_value);
+  std::vector<MLValue> fetches;
+  status = session_object.Run(RunOptions{}, NameMLValMap{{"input", input_value}}, {"output"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  const float* result = fetches[0].Get<Tensor>().Data<float>();
+  EXPECT_EQ(result[0], 2.f);
+  EXPECT_EQ(result[1], 4.f);
+}
+
+// an allocator of the application that counts its allocations
+struct CountingOrtAllocator : OrtAllocator {
+  explicit CountingOrtAllocator(OrtAllocatorType type) : info(CPU, type) {
+    OrtAllocator::Alloc = [](OrtAllocator* this_, size_t size) {
+      ++static_cast<CountingOrtAllocator*>(this_)->num_allocs;
+      return static_cast<CountingOrtAllocator*>(this_)->cpu_allocator.Alloc(size);
+    };
+    OrtAllocator::Free = [](OrtAllocator* this_, void* p) {
+      ++static_cast<CountingOrtAllocator*>(this_)->num_frees;
+      static_cast<CountingOrtAllocator*>(this_)->cpu_allocator.Free(p);
+    };
+    OrtAllocator::Info = [](const OrtAllocator* this_) -> const OrtAllocatorInfo* {
+      return &static_cast<const CountingOrtAllocator*>(this_)->info;
+    };
+  }
+
+  OrtAllocatorInfo info;
+  CPUAllocator cpu_allocator;
+  int num_allocs = 0;
+  int num_frees = 0;
+};
+
+TEST(InferenceSessionTests, CustomAllocator) {
+  Model model("CustomAllocator");
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input = graph.GetOrCreateNodeArg("input", &float_tensor);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("output", &float_tensor);
+  graph.AddNode("add", "Add", "", {&input, &input}, {&sum});
+  graph.AddNode("mul", "Mul", "", {&sum, &input}, {&output});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+
+  // beneath an arena, and in place of it
+  for (auto type : {OrtArenaAllocator, OrtDeviceAllocator}) {
+    CountingOrtAllocator allocator(type);
+    {
+      SessionOptions so;
+      so.session_logid = "InferenceSessionTests.CustomAllocator";
+      so.custom_allocators.push_back(&allocator);
+      InferenceSession session_object{so, &DefaultLoggingManager()};
+      std::stringstream model_copy(model_stream.str());
+      ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+      status = session_object.Initialize();
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+      MLValue input_value;
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {1.f, 2.f},
+                           &input_value);
+      std::vector<MLValue> fetches;
+      status = session_object.Run(RunOptions{}, NameMLValMap{{"input", input_value}}, {"output"}, &fetches);
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      const float* result = fetches[0].Get<Tensor>().Data<float>();
+      EXPECT_EQ(result[0], 2.f);
+      EXPECT_EQ(result[1], 8.f);
+      EXPECT_GT(allocator.num_allocs, 0);
+    }
+    EXPECT_EQ(allocator.num_frees, allocator.num_allocs);
+  }
+
+  // a location no execution provider allocates at
+  CountingOrtAllocator allocator(OrtDeviceAllocator);
+  allocator.info.id = 1;
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.CustomAllocator.Invalid";
+  so.custom_allocators.push_back(&allocator);
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::stringstream model_copy(model_stream.str());
+  ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+  EXPECT_FALSE(session_object.Initialize().IsOK());
+}
+
+TEST(InferenceSessionTests, SharedCpuArena) {
+  Model model("SharedCpuArena");
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input = graph.GetOrCreateNodeArg("input", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("output", &float_tensor);
+  graph.AddNode("add", "Add", "", {&input, &input}, {&output});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+
+  std::vector<std::unique_ptr<InferenceSession>> sessions;
+  for (int i = 0; i < 2; i++) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.SharedCpuArena";
+    so.use_shared_cpu_arena = true;
+    sessions.push_back(std::make_unique<InferenceSession>(so, &DefaultLoggingManager()));
+    std::stringstream model_copy(model_stream.str());
+    ASSERT_TRUE(sessions.back()->Load(model_copy).IsOK());
+    status = sessions.back()->Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
+  for (auto& session : sessions) {
+    MLValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {1.f, 2.f},
+                         &input_value);
+    std::vector<MLValue> fetches;
+    status = session->Run(RunOptions{}, NameMLValMap{{"input", input_value}}, {"output"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const float* result = fetches[0].Get<Tensor>().Data<float>();
+    EXPECT_EQ(result[0], 2.f);
+    EXPECT_EQ(result[1], 4.f);
+
+    // the session accounts for its own allocations
+    AllocatorStats stats;
+    ASSERT_TRUE(session->GetAllocatorStats(OrtAllocatorInfo(CPU, OrtArenaAllocator), stats).IsOK());
+    EXPECT_GT(stats.num_allocs, 0);
+  }
+
+  // the sessions allocate from the same arena
+  AllocatorStats first_stats;
+  AllocatorStats second_stats;
+  ASSERT_TRUE(sessions[0]->GetAllocatorStats(OrtAllocatorInfo(CPU, OrtArenaAllocator), first_stats).IsOK());
+  ASSERT_TRUE(sessions[1]->GetAllocatorStats(OrtAllocatorInfo(CPU, OrtArenaAllocator), second_stats).IsOK());
+  EXPECT_EQ(first_stats.total_allocated_bytes, second_stats.total_allocated_bytes);
+  EXPECT_EQ(first_stats.num_extends, second_stats.num_extends);
+}
+
+TEST(InferenceSessionTests, LazyInitializationAndWarmup) {
+  Model model("LazyInitializationAndWarmup");
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  auto& input = graph.GetOrCreateNodeArg("input", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("output", &float_tensor);
+  graph.AddNode("add", "Add", "", {&input, &input}, {&output});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.LazyInitializationAndWarmup";
+  so.lazy_initialization = true;
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::stringstream model_copy(model_stream.str());
+    ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    // the warm-up initializes the session
+    status = session_object.Warmup();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    MLValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3},
+                         {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, &input_value);
+    std::vector<MLValue> fetches;
+    status = session_object.Run(RunOptions{}, NameMLValMap{{"input", input_value}}, {"output"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const float* result = fetches[0].Get<Tensor>().Data<float>();
+    EXPECT_EQ(result[0], 2.f);
+    EXPECT_EQ(result[5], 12.f);
+  }
+
+  // in the background, which the session waits for when it's destroyed
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::stringstream model_copy(model_stream.str());
+    ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    status = session_object.Warmup(true);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+}
+
+// Y = X + W, where W is an initializer
+static void CreateAddInitializerModel(std::stringstream& model_stream) {
+  Model model("AddInitializer");
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& weights = graph.GetOrCreateNodeArg("W", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  TensorProto weights_proto;
+  weights_proto.set_name("W");
+  weights_proto.set_data_type(TensorProto_DataType_FLOAT);
+  weights_proto.add_dims(2);
+  weights_proto.add_float_data(10.f);
+  weights_proto.add_float_data(20.f);
+  graph.AddInitializedTensor(weights_proto);
+  graph.AddNode("add", "Add", "", {&input, &weights}, {&output});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+}
+
+static void RunAddInitializerModel(InferenceSession& session_object) {
+  MLValue input_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {1.f, 2.f},
+                       &input_value);
+  std::vector<MLValue> fetches;
+  auto status = session_object.Run(RunOptions{}, NameMLValMap{{"X", input_value}}, {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, {2}, {11.f, 22.f});
+}
+
+TEST(InferenceSessionTests, EvictAndRestore) {
+  std::stringstream model_stream;
+  CreateAddInitializerModel(model_stream);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.EvictAndRestore";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  EXPECT_FALSE(session_object.Evict().IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  RunAddInitializerModel(session_object);
+
+  // the next Run restores the session
+  ASSERT_TRUE(session_object.Evict().IsOK());
+  RunAddInitializerModel(session_object);
+
+  ASSERT_TRUE(session_object.Evict().IsOK());
+  ASSERT_TRUE(session_object.Restore().IsOK());
+  RunAddInitializerModel(session_object);
+}
+
+TEST(InferenceSessionTests, StaticMemoryPatterns) {
+  // Y = X + W + W + W, of which all the shapes are static
+  Model model("StaticMemoryPatterns");
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& weights = graph.GetOrCreateNodeArg("W", &float_tensor);
+  TensorProto weights_proto;
+  weights_proto.set_name("W");
+  weights_proto.set_data_type(TensorProto_DataType_FLOAT);
+  weights_proto.add_dims(2);
+  weights_proto.add_float_data(10.f);
+  weights_proto.add_float_data(20.f);
+  graph.AddInitializedTensor(weights_proto);
+  NodeArg* previous = &graph.GetOrCreateNodeArg("X", &float_tensor);
+  for (const char* name : {"A", "B", "Y"}) {
+    auto& output = graph.GetOrCreateNodeArg(name, &float_tensor);
+    graph.AddNode(std::string("add_") + name, "Add", "", {previous, &weights}, {&output});
+    previous = &output;
+  }
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.StaticMemoryPatterns";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  EXPECT_EQ(session_object.GetMemoryPatternCacheStats().entries, 1u);
+
+  // the first Run finds the patterns planned by Initialize
+  MLValue input_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {1.f, 2.f},
+                       &input_value);
+  std::vector<MLValue> fetches;
+  auto status = session_object.Run(RunOptions{}, NameMLValMap{{"X", input_value}}, {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, {2}, {31.f, 62.f});
+  auto stats = session_object.GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 0u);
+}
+
+TEST(InferenceSessionTests, ParallelInitialization) {
+  // a chain of Add nodes, each with an initializer of its own
+  const int num_nodes = 32;
+  Model model("ParallelInitialization");
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  NodeArg* previous = &graph.GetOrCreateNodeArg("input", &float_tensor);
+  for (int i = 0; i < num_nodes; ++i) {
+    const std::string index = std::to_string(i);
+    const float addend[] = {static_cast<float>(i), 1.f};
+    TensorProto addend_proto;
+    addend_proto.set_name("addend_" + index);
+    addend_proto.set_data_type(TensorProto_DataType_FLOAT);
+    addend_proto.add_dims(2);
+    addend_proto.set_raw_data(addend, sizeof(addend));
+    graph.AddInitializedTensor(addend_proto);
+
+    auto& sum = graph.GetOrCreateNodeArg(i + 1 == num_nodes ? "output" : "sum_" + index, &float_tensor);
+    graph.AddNode("add_" + index, "Add", "", {previous, graph.GetNodeArg("addend_" + index)}, {&sum});
+    previous = &sum;
+  }
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::stringstream model_stream;
+  model.ToProto().SerializeToOstream(&model_stream);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ParallelInitialization";
+  so.enable_parallel_initialization = true;
+  so.session_thread_pool_size = 4;
+  so.enable_profiling = true;
+  so.profile_file_prefix = "onnxprofile_parallel_initialization";
+  // keep the Add nodes
+  so.graph_optimization_level = TransformerLevel::None;
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  MLValue input_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {0.f, 0.f},
+                       &input_value);
+  std::vector<MLValue> fetches;
+  status = session_object.Run(RunOptions{}, NameMLValMap{{"input", input_value}}, {"output"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  const float* result = fetches[0].Get<Tensor>().Data<float>();
+  EXPECT_EQ(result[0], static_cast<float>(num_nodes * (num_nodes - 1) / 2));
+  EXPECT_EQ(result[1], static_cast<float>(num_nodes));
+
+  // the phases of the initialization are profiled
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  const std::string contents((std::istreambuf_iterator<char>(profile)), std::istreambuf_iterator<char>());
+  EXPECT_NE(contents.find("plan_creation"), std::string::npos);
+  EXPECT_NE(contents.find("initializer_loading"), std::string::npos);
+  EXPECT_NE(contents.find("kernel_creation"), std::string::npos);
+}
+
+// a parallel session runs the async Run and its nodes on the same pool
+TEST(InferenceSessionTests, RunAsync) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RunAsync";
+  so.enable_sequential_execution = false;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &ml_value);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value));
+  std::vector<std::string> output_names{"Y"};
+
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  RunOptions run_options;
+  const int num_runs = 32;
+  std::vector<std::promise<std::vector<MLValue>>> results(num_runs);
+  for (auto& result : results) {
+    auto st = session_object.RunAsync(run_options, feeds, output_names,
+                                      [&result](const Status& status, std::vector<MLValue>& fetches) {
+                                        EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+                                        result.set_value(fetches);
+                                      });
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  }
+
+  for (auto& result : results) {
+    VerifyOutputs(result.get_future().get(), expected_dims_mul_y, expected_values_mul_y);
+  }
+}
+
+TEST(InferenceSessionTests, PreparedRun) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PreparedRun";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the names are validated when the run is prepared
+  std::unique_ptr<PreparedRun> prepared_run;
+  EXPECT_FALSE(session_object.PrepareRun({"X"}, {"Z"}, prepared_run).IsOK());
+  EXPECT_FALSE(session_object.PrepareRun({}, {"Y"}, prepared_run).IsOK());
+  EXPECT_FALSE(session_object.PrepareRun({"X", "X"}, {"Y"}, prepared_run).IsOK());
+  auto status = session_object.PrepareRun({"X"}, {"Y"}, prepared_run);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value);
+  for (int i = 0; i < 2; ++i) {
+    std::vector<MLValue> fetches;
+    status = session_object.Run(RunOptions{}, *prepared_run, {ml_value}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    VerifyOutputs(fetches, {3, 2}, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+  }
+
+  // the values are still checked on every run
+  std::vector<MLValue> fetches;
+  EXPECT_FALSE(session_object.Run(RunOptions{}, *prepared_run, {}, &fetches).IsOK());
+  MLValue int_value;
+  CreateMLValue<int32_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1}, {1}, &int_value);
+  EXPECT_FALSE(session_object.Run(RunOptions{}, *prepared_run, {int_value}, &fetches).IsOK());
+
+  // a prepared run is only valid with its session
+  InferenceSession other_session{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(other_session.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(other_session.Initialize().IsOK());
+  EXPECT_FALSE(other_session.Run(RunOptions{}, *prepared_run, {ml_value}, &fetches).IsOK());
+}
+
 TEST(InferenceSessionTests, DisableCPUArena) {
   SessionOptions so;
 
@@ -543,6 +1459,325 @@ TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   }
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerWithRunOptions) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithRunOptions";
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // one in two Runs is profiled, each to a file of its own
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  run_options.profiling_sampling_interval = 2;
+  run_options.profile_file_prefix = "onnxruntime_run_profile_test";
+  for (int i = 0; i < 4; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  EXPECT_FALSE(std::ifstream("onnxruntime_run_profile_test_RunTag_1.json"));
+  EXPECT_FALSE(std::ifstream("onnxruntime_run_profile_test_RunTag_3.json"));
+  for (const auto* profile_file : {"onnxruntime_run_profile_test_RunTag_2.json",
+                                   "onnxruntime_run_profile_test_RunTag_4.json"}) {
+    std::ifstream profile(profile_file);
+    ASSERT_TRUE(profile) << profile_file;
+    const std::string contents((std::istreambuf_iterator<char>(profile)), std::istreambuf_iterator<char>());
+    EXPECT_NE(contents.find("mul_1_kernel_time"), std::string::npos);
+    EXPECT_NE(contents.find(R"("run_tag" : "RunTag")"), std::string::npos);
+  }
+
+  // the session doesn't profile its Runs
+  EXPECT_EQ(session_object.EndProfiling(), std::string());
+}
+
+TEST(InferenceSessionTests, CheckMetrics) {
+  SessionOptions so;
+
+  so.session_logid = "CheckMetrics";
+  so.enable_metrics = true;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  std::vector<SessionMetrics::OpMetrics> op_metrics;
+  int64_t num_arena_extends = -1;
+  ASSERT_TRUE(session_object.GetMetrics(op_metrics, num_arena_extends).IsOK());
+  ASSERT_EQ(op_metrics.size(), 1u);
+  EXPECT_EQ(op_metrics[0].op_type, "Mul");
+  EXPECT_EQ(op_metrics[0].num_calls, 3u);
+  EXPECT_LE(op_metrics[0].p50_time_us, op_metrics[0].p99_time_us);
+  // the 3x2 float output of each Run
+  EXPECT_EQ(op_metrics[0].output_bytes, 3u * 6 * sizeof(float));
+  EXPECT_GE(num_arena_extends, 0);
+
+  // there are no metrics unless they're enabled
+  InferenceSession session_without_metrics(SessionOptions{});
+  ASSERT_TRUE(session_without_metrics.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_without_metrics.Initialize().IsOK());
+  EXPECT_FALSE(session_without_metrics.GetMetrics(op_metrics, num_arena_extends).IsOK());
+}
+
+TEST(InferenceSessionTests, CheckMetricsWithHardwareCounters) {
+  SessionOptions so;
+
+  so.session_logid = "CheckMetricsWithHardwareCounters";
+  so.enable_metrics = true;
+  so.enable_hardware_counters = true;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  RunModel(session_object, run_options);
+
+  std::vector<SessionMetrics::OpMetrics> op_metrics;
+  int64_t num_arena_extends = -1;
+  ASSERT_TRUE(session_object.GetMetrics(op_metrics, num_arena_extends).IsOK());
+  ASSERT_EQ(op_metrics.size(), 1u);
+  EXPECT_EQ(op_metrics[0].num_calls, 1u);
+  // the counters may not be allowed where the test runs, in which case the session runs without them
+  if (HardwareCounters::ForCurrentThread().Available()) {
+    EXPECT_GT(op_metrics[0].instructions, 0u);
+  } else {
+    EXPECT_EQ(op_metrics[0].instructions, 0u);
+  }
+}
+
+TEST(InferenceSessionTests, CheckResultCache) {
+  SessionOptions so;
+
+  so.session_logid = "CheckResultCache";
+  so.enable_result_cache = true;
+  so.enable_metrics = true;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  ResultCache::Stats stats;
+  ASSERT_TRUE(session_object.GetResultCacheStats(stats).IsOK());
+  EXPECT_EQ(stats.num_misses, 1u);
+  EXPECT_EQ(stats.num_hits, 2u);
+  EXPECT_EQ(stats.num_entries, 1u);
+
+  // only the first Run ran the graph
+  std::vector<SessionMetrics::OpMetrics> op_metrics;
+  int64_t num_arena_extends = -1;
+  ASSERT_TRUE(session_object.GetMetrics(op_metrics, num_arena_extends).IsOK());
+  ASSERT_EQ(op_metrics.size(), 1u);
+  EXPECT_EQ(op_metrics[0].num_calls, 1u);
+
+  // the fetches provided by the caller are output to by the graph
+  RunModel(session_object, run_options, true);
+  ASSERT_TRUE(session_object.GetResultCacheStats(stats).IsOK());
+  EXPECT_EQ(stats.num_hits, 2u);
+
+  InferenceSession session_without_cache(SessionOptions{});
+  ASSERT_TRUE(session_without_cache.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_without_cache.Initialize().IsOK());
+  EXPECT_FALSE(session_without_cache.GetResultCacheStats(stats).IsOK());
+}
+
+TEST(InferenceSessionTests, OutputReadyCallback) {
+  Model model("OutputReadyCallback");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& abs = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& neg = graph.GetOrCreateNodeArg("B", &float_tensor);
+  graph.AddNode("abs", "Abs", "", {&input}, {&abs});
+  graph.AddNode("neg", "Neg", "", {&input}, {&neg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::stringstream model_stream;
+  model.ToProto().SerializeToOstream(&model_stream);
+  const std::string model_data = model_stream.str();
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  MLValue input_value;
+  CreateMLValue<float>(allocator, {3}, {-1.f, 2.f, -3.f}, &input_value);
+
+  for (bool sequential : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.OutputReadyCallback";
+    so.enable_sequential_execution = sequential;
+    so.enable_result_cache = true;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::istringstream model_istream(model_data);
+    ASSERT_TRUE(session_object.Load(model_istream).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    // the outputs by index, with their data and whether the Run had returned its fetches yet when they were reported
+    std::mutex mutex;
+    std::map<size_t, std::vector<float>> reported;
+    int num_reported = 0;
+    int num_reported_early = 0;
+    std::vector<MLValue> fetches;
+    RunOptions run_options;
+    run_options.output_ready_callback = [&](size_t output_index, const MLValue& value) {
+      const auto& tensor = value.Get<Tensor>();
+      std::lock_guard<std::mutex> lock(mutex);
+      reported[output_index].assign(tensor.Data<float>(), tensor.Data<float>() + tensor.Shape().Size());
+      ++num_reported;
+      if (fetches.empty()) {
+        ++num_reported_early;
+      }
+    };
+
+    auto status = session_object.Run(run_options, NameMLValMap{{"X", input_value}}, {"B", "A"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    // the CPU nodes report their outputs as they finish
+    EXPECT_EQ(num_reported, 2);
+    EXPECT_EQ(num_reported_early, 2);
+    EXPECT_EQ(reported[0], std::vector<float>({1.f, -2.f, 3.f}));
+    EXPECT_EQ(reported[1], std::vector<float>({1.f, 2.f, 3.f}));
+
+    // a Run served by the result cache reports its outputs once it has them
+    reported.clear();
+    num_reported = num_reported_early = 0;
+    fetches.clear();
+    status = session_object.Run(run_options, NameMLValMap{{"X", input_value}}, {"B", "A"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    EXPECT_EQ(num_reported, 2);
+    EXPECT_EQ(num_reported_early, 0);
+    EXPECT_EQ(reported[0], std::vector<float>({1.f, -2.f, 3.f}));
+    EXPECT_EQ(reported[1], std::vector<float>({1.f, 2.f, 3.f}));
+  }
+}
+
+TEST(InferenceSessionTests, SpecializeWithConstantInputs) {
+  // M = (X + Y) + Z of 3x2 inputs
+  onnxruntime::Model model("graph_1");
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+  auto& t = graph.GetOrCreateNodeArg("T", &float_tensor);
+  auto& m = graph.GetOrCreateNodeArg("M", &float_tensor);
+  graph.AddNode("node_1", "Add", "node 1.", {&x, &y}, {&t});
+  graph.AddNode("node_2", "Add", "node 2.", {&t, &z}, {&m});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  const std::string model_file_name = "specialize_with_constant_inputs.onnx";
+  ASSERT_TRUE(onnxruntime::Model::Save(model, model_file_name).IsOK());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<float> values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  MLValue ml_value;
+  CreateMLValue<float>(allocator, {3, 2}, values, &ml_value);
+
+  SessionOptions so;
+  so.session_logid = "SpecializeWithConstantInputs";
+  so.enable_metrics = true;
+  InferenceSession session_object{so};
+  ASSERT_TRUE(session_object.Load(model_file_name).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::unique_ptr<InferenceSession> specialized;
+  ASSERT_TRUE(session_object.Specialize({{"X", ml_value}, {"Y", ml_value}}, specialized).IsOK());
+  ASSERT_TRUE(specialized->Initialize().IsOK());
+
+  auto inputs = specialized->GetModelInputs();
+  ASSERT_TRUE(inputs.first.IsOK());
+  ASSERT_EQ(inputs.second->size(), 1u);
+  EXPECT_EQ(inputs.second->front()->Name(), "Z");
+
+  NameMLValMap feeds{{"Z", ml_value}};
+  std::vector<std::string> output_names{"M"};
+  std::vector<MLValue> fetches;
+  ASSERT_TRUE(specialized->Run(RunOptions{}, feeds, output_names, &fetches).IsOK());
+  VerifyOutputs(fetches, {3, 2}, {3.0f, 6.0f, 9.0f, 12.0f, 15.0f, 18.0f});
+
+  // the Add of the constants was folded
+  std::vector<SessionMetrics::OpMetrics> op_metrics;
+  int64_t num_arena_extends = -1;
+  ASSERT_TRUE(specialized->GetMetrics(op_metrics, num_arena_extends).IsOK());
+  ASSERT_EQ(op_metrics.size(), 1u);
+  EXPECT_EQ(op_metrics[0].num_calls, 1u);
+
+  // the bound inputs can't be fed
+  feeds["X"] = ml_value;
+  auto status = specialized->Run(RunOptions{}, feeds, output_names, &fetches);
+  EXPECT_FALSE(status.IsOK());
+
+  SessionOptions unknown_so;
+  unknown_so.constant_inputs["unknown_input"] = ml_value;
+  InferenceSession unknown_session{unknown_so};
+  ASSERT_TRUE(unknown_session.Load(model_file_name).IsOK());
+  status = unknown_session.Initialize();
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("it's not an input of the model"));
+}
+
+TEST(InferenceSessionTests, CalibrateAndQuantize) {
+  // Y = X * W of a 3x2 X and the 2x1 W initializer {1, 2}
+  const std::string model_uri = "testdata/matmul_1.pb";
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2}, values_x, &ml_value);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value));
+  std::vector<std::string> output_names{"Y"};
+
+  SessionOptions so;
+  so.session_logid = "CalibrateAndQuantize";
+  so.enable_quantization_calibration = true;
+  InferenceSession calibration_session(so);
+  ASSERT_TRUE(calibration_session.Load(model_uri).IsOK());
+  ASSERT_TRUE(calibration_session.Initialize().IsOK());
+  std::vector<MLValue> fetches;
+  ASSERT_TRUE(calibration_session.Run(RunOptions{}, feeds, output_names, &fetches).IsOK());
+
+  QuantizationRanges ranges;
+  ASSERT_TRUE(calibration_session.GetQuantizationRanges(ranges).IsOK());
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges["X"], std::make_pair(1.0f, 6.0f));
+  EXPECT_EQ(ranges["Y"], std::make_pair(5.0f, 17.0f));
+
+  SessionOptions quantize_so;
+  quantize_so.session_logid = "CalibrateAndQuantize";
+  quantize_so.quantization_ranges = ranges;
+  InferenceSession quantized_session(quantize_so);
+  ASSERT_TRUE(quantized_session.Load(model_uri).IsOK());
+  ASSERT_TRUE(quantized_session.Initialize().IsOK());
+  fetches.clear();
+  ASSERT_TRUE(quantized_session.Run(RunOptions{}, feeds, output_names, &fetches).IsOK());
+
+  // within a few steps of the scales of X, W and Y
+  const Tensor& y = fetches[0].Get<Tensor>();
+  ASSERT_EQ(y.Shape(), TensorShape({3, 1}));
+  const std::vector<float> expected_y = {5.0f, 11.0f, 17.0f};
+  for (size_t i = 0; i < expected_y.size(); ++i) {
+    EXPECT_NEAR(y.Data<float>()[i], expected_y[i], 0.25f);
+  }
+
+  // there are no ranges unless calibration is enabled
+  EXPECT_FALSE(quantized_session.GetQuantizationRanges(ranges).IsOK());
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -582,6 +1817,105 @@ TEST(InferenceSessionTests, PreAllocateOutputVector) {
   RunModel(session_object, run_options, is_preallocate_output_vec);
 }
 
+// the Abs node writes its output to the preallocated fetch of the graph output the Identity node produces from it
+TEST(InferenceSessionTests, PreAllocatedOutputOfAliasingNode) {
+  Model model("PreAllocatedOutputOfAliasingNode");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& abs = graph.GetOrCreateNodeArg("abs", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("abs", "Abs", "", {&input}, {&abs});
+  graph.AddNode("identity", "Identity", "", {&abs}, {&output});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::stringstream model_stream;
+  model.ToProto().SerializeToOstream(&model_stream);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PreAllocatedOutputOfAliasingNode";
+  // keep the Identity node
+  so.graph_optimization_level = TransformerLevel::None;
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  MLValue input_value;
+  CreateMLValue<float>(allocator, {3}, {-1.f, 2.f, -3.f}, &input_value);
+
+  for (bool preallocate : {true, false}) {
+    std::vector<MLValue> fetches;
+    const float* buffer = nullptr;
+    if (preallocate) {
+      fetches.resize(1);
+      CreateMLValue<float>(allocator, {3}, {0.f, 0.f, 0.f}, &fetches[0]);
+      buffer = fetches[0].Get<Tensor>().Data<float>();
+    }
+
+    auto status = session_object.Run(RunOptions{}, NameMLValMap{{"X", input_value}}, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    VerifyOutputs(fetches, {3}, {1.f, 2.f, 3.f});
+    if (preallocate) {
+      EXPECT_EQ(fetches[0].Get<Tensor>().Data<float>(), buffer);
+    }
+  }
+
+  // a fetch of another shape than the output is still rejected
+  std::vector<MLValue> fetches(1);
+  CreateMLValue<float>(allocator, {2}, {0.f, 0.f}, &fetches[0]);
+  EXPECT_FALSE(session_object.Run(RunOptions{}, NameMLValMap{{"X", input_value}}, {"Y"}, &fetches).IsOK());
+}
+
+// the planner can't tell whether the sum has the size of the value it is to update in place, so the run decides
+TEST(InferenceSessionTests, InPlaceUpdateOfValueWithUnknownShape) {
+  Model model("InPlaceUpdateOfValueWithUnknownShape");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& bias = graph.GetOrCreateNodeArg("B", &float_tensor);
+  auto& abs = graph.GetOrCreateNodeArg("abs", &float_tensor);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("abs", "Abs", "", {&input}, {&abs});
+  graph.AddNode("add", "Add", "", {&abs, &bias}, {&sum});
+  graph.AddNode("neg", "Neg", "", {&sum}, {&output});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::stringstream model_stream;
+  model.ToProto().SerializeToOstream(&model_stream);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.InPlaceUpdateOfValueWithUnknownShape";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  MLValue small_value;
+  CreateMLValue<float>(allocator, {3}, {-1.f, 2.f, -3.f}, &small_value);
+  MLValue large_value;
+  CreateMLValue<float>(allocator, {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, &large_value);
+
+  // the sum is larger than abs, so the sum gets a buffer of its own
+  std::vector<MLValue> fetches;
+  auto status = session_object.Run(RunOptions{}, NameMLValMap{{"X", small_value}, {"B", large_value}}, {"Y"},
+                                   &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, {2, 3}, {-2.f, -4.f, -6.f, -5.f, -7.f, -9.f});
+
+  // the sum has the size of abs, and is written over it
+  fetches.clear();
+  status = session_object.Run(RunOptions{}, NameMLValMap{{"X", large_value}, {"B", small_value}}, {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, {2, 3}, {0.f, -4.f, 0.f, -3.f, -7.f, -3.f});
+}
+
 TEST(InferenceSessionTests, ConfigureVerbosityLevel) {
   SessionOptions so;
 
@@ -816,6 +2150,286 @@ TEST(InferenceSessionTests, TestBindCudaPreallocateOutputOnCpu2) {
                  kCpuExecutionProvider);
 }
 
+TEST(InferenceSessionTests, TestBindCudaUserComputeStream) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.TestBindCudaUserComputeStream";
+
+  cudaStream_t compute_stream;
+  ASSERT_EQ(cudaStreamCreateWithFlags(&compute_stream, cudaStreamNonBlocking), cudaSuccess);
+
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+
+    CUDAExecutionProviderInfo epi;
+    epi.device_id = 0;
+    epi.compute_stream = compute_stream;
+    auto provider = std::make_unique<CUDAExecutionProvider>(epi);
+    EXPECT_EQ(provider->GetStream(kCudaStreamDefault), compute_stream);
+    EXPECT_TRUE(session_object.RegisterExecutionProvider(std::move(provider)).IsOK());
+
+    std::unique_ptr<Model> p_model;
+    CreateMatMulModel(p_model, kCudaExecutionProvider);
+
+    std::stringstream s1;
+    p_model->ToProto().SerializeToOstream(&s1);
+    ASSERT_TRUE(session_object.Load(s1).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    RunOptions run_options;
+    run_options.run_tag = so.session_logid;
+    RunModelWithBindingMatMul(session_object,
+                              run_options,
+                              kCudaExecutionProvider,
+                              true /* preallocate output on CPU */,
+                              kCpuExecutionProvider);
+  }
+
+  // the session does not own the stream, so it remains usable after the session is gone
+  EXPECT_EQ(cudaStreamSynchronize(compute_stream), cudaSuccess);
+  EXPECT_EQ(cudaStreamDestroy(compute_stream), cudaSuccess);
+}
+
+TEST(InferenceSessionTests, TestCudaRunWithHostFeeds) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.TestCudaRunWithHostFeeds";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CUDAExecutionProvider>(epi)).IsOK());
+
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCudaExecutionProvider);
+
+  std::stringstream s1;
+  p_model->ToProto().SerializeToOstream(&s1);
+  ASSERT_TRUE(session_object.Load(s1).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+
+  // the host feeds are staged through pinned memory and copied to CUDA asynchronously during Run.
+  // overwrite the feeds between Runs to check that each Run reads its own inputs.
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  for (int i = 1; i <= 3; ++i) {
+    std::vector<float> values_mul_x;
+    for (int j = 0; j < 12; ++j) {
+      values_mul_x.push_back(static_cast<float>(i * j));
+    }
+
+    MLValue input_ml_value_A;
+    CreateMLValue<float>(cpu_allocator, {3, 4}, values_mul_x, &input_ml_value_A);
+    MLValue input_ml_value_B;
+    CreateMLValue<float>(cpu_allocator, {4, 3}, values_mul_x, &input_ml_value_B);
+    NameMLValMap feeds{{"A", input_ml_value_A}, {"B", input_ml_value_B}};
+
+    std::vector<MLValue> fetches;
+    ASSERT_TRUE(session_object.Run(run_options, feeds, {"Y"}, &fetches).IsOK());
+
+    std::vector<float> expected_values_mul_y = {42, 48, 54, 114, 136, 158, 186, 224, 262};
+    for (auto& value : expected_values_mul_y) {
+      value *= static_cast<float>(i * i);
+    }
+    VerifyOutputs(fetches, {3, 3}, expected_values_mul_y);
+  }
+}
+
+// more threads than contexts and admitted Runs, so Runs wait for one another and share the preallocated contexts
+TEST(InferenceSessionTests, TestCudaContextPoolConcurrentRuns) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.TestCudaContextPoolConcurrentRuns";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  epi.context_pool_size = 2;
+  epi.max_concurrent_runs = 2;
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CUDAExecutionProvider>(epi)).IsOK());
+
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCudaExecutionProvider);
+
+  std::stringstream s1;
+  p_model->ToProto().SerializeToOstream(&s1);
+  ASSERT_TRUE(session_object.Load(s1).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<float> values_mul_x = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f};
+  MLValue input_ml_value_A;
+  CreateMLValue<float>(cpu_allocator, {3, 4}, values_mul_x, &input_ml_value_A);
+  MLValue input_ml_value_B;
+  CreateMLValue<float>(cpu_allocator, {4, 3}, values_mul_x, &input_ml_value_B);
+  NameMLValMap feeds{{"A", input_ml_value_A}, {"B", input_ml_value_B}};
+
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 6; ++t) {
+    threads.emplace_back([&session_object, &feeds, &failures]() {
+      RunOptions run_options;
+      for (int i = 0; i < 5; ++i) {
+        std::vector<MLValue> fetches;
+        if (!session_object.Run(run_options, feeds, {"Y"}, &fetches).IsOK() || fetches.size() != 1 ||
+            fetches[0].Get<Tensor>().Data<float>()[8] != 262.0f) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(failures, 0);
+}
+
+TEST(InferenceSessionTests, TestCudaEvictAndRestore) {
+  std::stringstream model_stream;
+  CreateAddInitializerModel(model_stream);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestCudaEvictAndRestore";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CUDAExecutionProvider>(epi)).IsOK());
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  RunAddInitializerModel(session_object);
+
+  // W is copied to host memory and back to the device
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(session_object.Evict().IsOK());
+    RunAddInitializerModel(session_object);
+  }
+}
+
+TEST(InferenceSessionTests, TestCudaParallelComputeStreams) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& input_arg_a = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& input_arg_b = graph.GetOrCreateNodeArg("B", &tensor_float);
+  auto& y1_arg = graph.GetOrCreateNodeArg("Y1", &tensor_float);
+  auto& y2_arg = graph.GetOrCreateNodeArg("Y2", &tensor_float);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &tensor_float);
+
+  // two independent branches, which run on different compute streams, joined by the Add
+  graph.AddNode("matmul1", "MatMul", "MatMul", {&input_arg_a, &input_arg_b}, {&y1_arg})
+      .SetExecutionProviderType(kCudaExecutionProvider);
+  graph.AddNode("matmul2", "MatMul", "MatMul", {&input_arg_a, &input_arg_b}, {&y2_arg})
+      .SetExecutionProviderType(kCudaExecutionProvider);
+  graph.AddNode("add", "Add", "Add", {&y1_arg, &y2_arg}, {&output_arg})
+      .SetExecutionProviderType(kCudaExecutionProvider);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestCudaParallelComputeStreams";
+  so.enable_sequential_execution = false;
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  epi.num_compute_streams = 2;
+  auto provider = std::make_unique<CUDAExecutionProvider>(epi);
+  EXPECT_EQ(provider->GetComputeQueueIds(), std::vector<int>({kCudaStreamDefault, kTotalCudaStreams}));
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::move(provider)).IsOK());
+
+  std::stringstream s1;
+  model.ToProto().SerializeToOstream(&s1);
+  ASSERT_TRUE(session_object.Load(s1).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<float> values_mul_x = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f};
+  MLValue input_ml_value_A;
+  CreateMLValue<float>(cpu_allocator, {3, 4}, values_mul_x, &input_ml_value_A);
+  MLValue input_ml_value_B;
+  CreateMLValue<float>(cpu_allocator, {4, 3}, values_mul_x, &input_ml_value_B);
+  NameMLValMap feeds{{"A", input_ml_value_A}, {"B", input_ml_value_B}};
+
+  // the Add waits for the MatMul on the other stream through the fence of its input
+  for (int i = 0; i < 3; ++i) {
+    std::vector<MLValue> fetches;
+    ASSERT_TRUE(session_object.Run(run_options, feeds, {"Y"}, &fetches).IsOK());
+    VerifyOutputs(fetches, {3, 3}, {84, 96, 108, 228, 272, 316, 372, 448, 524});
+  }
+}
+
+TEST(InferenceSessionTests, TestBindCudaGraphCapture) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.TestBindCudaGraphCapture";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  epi.enable_cuda_graph = true;
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CUDAExecutionProvider>(epi)).IsOK());
+
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCudaExecutionProvider);
+
+  std::stringstream s1;
+  p_model->ToProto().SerializeToOstream(&s1);
+  ASSERT_TRUE(session_object.Load(s1).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_TRUE(session_object.NewIOBinding(&io_binding).IsOK());
+
+  // the inputs are copied to CUDA once when bound, and the output is preallocated on CUDA, so every Run uses
+  // the same device buffers
+  std::vector<float> values_mul_x = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f};
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  MLValue input_ml_value_A;
+  CreateMLValue<float>(cpu_allocator, {3, 4}, values_mul_x, &input_ml_value_A);
+  MLValue input_ml_value_B;
+  CreateMLValue<float>(cpu_allocator, {4, 3}, values_mul_x, &input_ml_value_B);
+  ASSERT_TRUE(io_binding->BindInput("A", input_ml_value_A).IsOK());
+  ASSERT_TRUE(io_binding->BindInput("B", input_ml_value_B).IsOK());
+
+  std::vector<int64_t> expected_output_dims = {3, 3};
+  MLValue output_ml_value;
+  AllocateMLValue<float>(TestCudaExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), expected_output_dims,
+                         &output_ml_value);
+  ASSERT_TRUE(io_binding->BindOutput("Y", output_ml_value).IsOK());
+  ASSERT_TRUE(io_binding->SynchronizeInputs().IsOK());
+
+  std::vector<float> expected_values_mul_y = {42, 48, 54, 114, 136, 158, 186, 224, 262};
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+
+  // the first Run warms up, the second is captured and the rest replay the captured graph. shrinking the arenas
+  // releases the graph and the buffers held for it, so the Runs after that warm up and capture again.
+  for (int i = 0; i < 8; ++i) {
+    if (i == 4) {
+      ASSERT_TRUE(session_object.ShrinkMemoryArenas().IsOK());
+    }
+    auto& output = io_binding->GetOutputs().front().Get<Tensor>();
+    // clear the output so that a replay that does not write it is detected
+    ASSERT_EQ(cudaMemset(const_cast<void*>(output.DataRaw()), 0, output.Size()), cudaSuccess);
+    ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+
+    ASSERT_TRUE(session_object.Run(run_options, *io_binding.get()).IsOK());
+    ASSERT_TRUE(io_binding->SynchronizeOutputs().IsOK());
+
+    MLValue cpu_output;
+    AllocateMLValue<float>(cpu_allocator, expected_output_dims, &cpu_output);
+    ASSERT_TRUE(TestCudaExecutionProvider()->CopyTensor(output, *cpu_output.GetMutable<Tensor>()).IsOK());
+    VerifyOutputs({cpu_output}, expected_output_dims, expected_values_mul_y);
+  }
+}
+
 #endif
 
 TEST(InferenceSessionTests, ModelWithoutOpset) {
@@ -4,6 +4,7 @@
 #include "core/session/inference_session.h"
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <iterator>
 #include <thread>
@@ -61,6 +62,47 @@ class FooKernel : public OpKernel {
   }
 };
 
+// Foo kernel doing Add in ranges of one element on the intra-op threads, through a scratch buffer
+class ParallelFooKernel : public OpKernel {
+ public:
+  ParallelFooKernel(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const {
+    const auto* X = context->Input<Tensor>(0);
+    const auto* W = context->Input<Tensor>(1);
+    const int64_t size = X->Shape().Size();
+    auto* sums = static_cast<float*>(context->GetScratchBuffer(size * sizeof(float)));
+    context->ParallelFor(size, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        sums[i] = X->Data<float>()[i] + W->Data<float>()[i];
+      }
+    });
+    auto* Y = context->Output(0, X->Shape());
+    std::copy(sums, sums + size, Y->MutableData<float>());
+
+    // an exception in a range is rethrown on the calling thread
+    auto fail_first_range = [](int64_t begin, int64_t) {
+      if (begin == 0) {
+        ORT_THROW("the first range failed");
+      }
+    };
+    EXPECT_THROW(context->ParallelFor(size, 1, fail_first_range), OnnxRuntimeException);
+    return Status::OK();
+  }
+};
+
+// Foo kernel that takes longer than the deadline of the Run, like one whose MLAS operations stopped once the Run
+// terminated, and returns OK all the same
+class SlowFooKernel : public FooKernel<float> {
+ public:
+  SlowFooKernel(const OpKernelInfo& info) : FooKernel<float>(info) {}
+
+  Status Compute(OpKernelContext* context) const {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    return FooKernel<float>::Compute(context);
+  }
+};
+
 ONNX_NAMESPACE::OpSchema GetFooSchema() {
   ONNX_NAMESPACE::OpSchema schema("Foo", "unknown", 0);
   schema.Input(0,
@@ -289,6 +331,74 @@ TEST(CustomKernelTests, CustomKernelWithCustomSchema) {
   RunSession(session_object, run_options, dims_x, values_x, expected_dims_y, expected_values_y);
 }
 
+TEST(CustomKernelTests, CustomKernelParallelFor) {
+  SessionOptions so;
+  so.session_logid = "CustomKernelTests.CustomKernelParallelFor";
+
+  std::shared_ptr<CustomRegistry> registry = std::make_shared<CustomRegistry>();
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  EXPECT_TRUE(session_object.RegisterCustomRegistry(registry).IsOK());
+  std::vector<OpSchema> schemas = {GetFooSchema()};
+  EXPECT_TRUE(registry->RegisterOpSet(schemas, onnxruntime::kOnnxDomain, 5, 7).IsOK());
+  auto def = FooKernelDef("Foo");
+  EXPECT_TRUE(registry->RegisterCustomKernel(def, [](const OpKernelInfo& info) -> OpKernel* {
+                        return new ParallelFooKernel(info);
+                      })
+                  .IsOK());
+  EXPECT_TRUE(session_object.Load(FOO_MODEL_URI).IsOK());
+  EXPECT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+  RunSession(session_object, run_options, dims_x, values_x, expected_dims_y, expected_values_y);
+}
+
+// the Run fails if its deadline passes while the last node computes, rather than returning the outputs
+TEST(CustomKernelTests, DeadlineDuringLastNode) {
+  for (bool sequential_execution : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "CustomKernelTests.DeadlineDuringLastNode";
+    so.enable_sequential_execution = sequential_execution;
+
+    std::shared_ptr<CustomRegistry> registry = std::make_shared<CustomRegistry>();
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    EXPECT_TRUE(session_object.RegisterCustomRegistry(registry).IsOK());
+    std::vector<OpSchema> schemas = {GetFooSchema()};
+    EXPECT_TRUE(registry->RegisterOpSet(schemas, onnxruntime::kOnnxDomain, 5, 7).IsOK());
+    auto def = FooKernelDef("Foo");
+    EXPECT_TRUE(registry->RegisterCustomKernel(def, [](const OpKernelInfo& info) -> OpKernel* {
+                          return new SlowFooKernel(info);
+                        })
+                    .IsOK());
+    EXPECT_TRUE(session_object.Load(FOO_MODEL_URI).IsOK());
+    EXPECT_TRUE(session_object.Initialize().IsOK());
+
+    MLValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2},
+                         {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value);
+    NameMLValMap feeds{{"X", ml_value}};
+    std::vector<std::string> output_names{"Y"};
+    std::vector<MLValue> fetches;
+
+    RunOptions run_options;
+    run_options.timeout_ms = 50;
+    auto st = session_object.Run(run_options, feeds, output_names, &fetches);
+    EXPECT_FALSE(st.IsOK()) << "sequential execution: " << sequential_execution;
+    EXPECT_NE(st.ErrorMessage().find("deadline"), std::string::npos) << st.ErrorMessage();
+
+    // without the deadline the same session runs to completion
+    run_options.timeout_ms = 0;
+    fetches.clear();
+    st = session_object.Run(run_options, feeds, output_names, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    ASSERT_EQ(fetches.size(), 1u);
+    EXPECT_EQ(fetches[0].Get<Tensor>().Data<float>()[5], 12.0f);
+  }
+}
+
 TEST(CustomKernelTests, CustomKernelWithOptionalOutput) {
   SessionOptions so;
 
@@ -325,5 +435,84 @@ TEST(CustomKernelTests, CustomKernelWithOptionalOutput) {
   // Now run
   RunSession(session_object, run_options, dims_x, values_x, expected_dims_y, expected_values_y);
 }
+
+TEST(CustomKernelTests, KernelLookupCachedBySignature) {
+  onnxruntime::Model model("KernelLookupCachedBySignature");
+  auto& graph = model.MainGraph();
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto int_type;
+  int_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_type);
+  auto& w = graph.GetOrCreateNodeArg("W", &float_type);
+  auto& i = graph.GetOrCreateNodeArg("I", &int_type);
+  auto& j = graph.GetOrCreateNodeArg("J", &int_type);
+  auto& float_mul = graph.AddNode("float_mul", "Mul", "", {&x, &y}, {&z});
+  auto& other_float_mul = graph.AddNode("other_float_mul", "Mul", "", {&z, &y}, {&w});
+  auto& int_mul = graph.AddNode("int_mul", "Mul", "", {&i, &i}, {&j});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  KernelRegistry registry;
+  EXPECT_EQ(registry.TryFindKernel(float_mul, kCpuExecutionProvider), nullptr);
+
+  // the miss is forgotten once a kernel is registered
+  auto def = FooKernelDef("Mul");
+  ASSERT_TRUE(registry.Register(def, CreateFooKernel).IsOK());
+  const KernelCreateInfo* kernel = registry.TryFindKernel(float_mul, kCpuExecutionProvider);
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(registry.TryFindKernel(other_float_mul, kCpuExecutionProvider), kernel);
+  EXPECT_EQ(registry.TryFindKernel(float_mul, kCpuExecutionProvider), kernel);
+
+  // the types and the provider are part of the signature
+  EXPECT_EQ(registry.TryFindKernel(int_mul, kCpuExecutionProvider), nullptr);
+  EXPECT_EQ(registry.TryFindKernel(float_mul, kCudaExecutionProvider), nullptr);
+  EXPECT_EQ(registry.TryFindKernel(float_mul, kCpuExecutionProvider), kernel);
+}
+
+static int num_deferred_foo_kernel_builds = 0;
+
+static KernelCreateInfo BuildDeferredFooKernelCreateInfo() {
+  ++num_deferred_foo_kernel_builds;
+  return KernelCreateInfo(FooKernelDef("Mul").Build(), CreateFooKernel);
+}
+
+TEST(CustomKernelTests, DeferredKernelBuiltOnLookup) {
+  onnxruntime::Model model("DeferredKernelBuiltOnLookup");
+  auto& graph = model.MainGraph();
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_type);
+  auto& w = graph.GetOrCreateNodeArg("W", &float_type);
+  auto& mul = graph.AddNode("mul", "Mul", "", {&x, &y}, {&z});
+  auto& add = graph.AddNode("add", "Add", "", {&z, &y}, {&w});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  num_deferred_foo_kernel_builds = 0;
+  KernelRegistry registry;
+  registry.Register("Mul", BuildDeferredFooKernelCreateInfo);
+  auto op_names = registry.GetAllRegisteredOpNames();
+  EXPECT_NE(std::find(op_names.begin(), op_names.end(), "Mul"), op_names.end());
+
+  // the lookup of another op doesn't build the kernel
+  EXPECT_EQ(registry.TryFindKernel(add, kCpuExecutionProvider), nullptr);
+  EXPECT_EQ(num_deferred_foo_kernel_builds, 0);
+
+  const KernelCreateInfo* kernel = registry.TryFindKernel(mul, kCpuExecutionProvider);
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(kernel->kernel_def->OpName(), "Mul");
+  EXPECT_EQ(num_deferred_foo_kernel_builds, 1);
+
+  // nor does a later lookup build it again, and a kernel of the same versions conflicts with it
+  EXPECT_EQ(registry.TryFindKernel(mul, kCpuExecutionProvider), kernel);
+  EXPECT_EQ(num_deferred_foo_kernel_builds, 1);
+  auto def = FooKernelDef("Mul");
+  EXPECT_FALSE(registry.Register(def, CreateFooKernel).IsOK());
+}
 }  // namespace test
 }  // namespace onnxruntime
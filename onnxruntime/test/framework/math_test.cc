@@ -108,6 +108,24 @@ TEST(MathTest, GemmNoTransTrans) {
   }
 }
 
+TEST(MathTest, GemmBatched) {
+  auto& provider = CPUMathUtil::Instance();
+  std::vector<float> X(3 * 50);  // 3 * 5 * 10
+  std::vector<float> W(3 * 60);  // 3 * 10 * 6
+  std::vector<float> Y(3 * 30);  // 3 * 5 * 6
+  for (int i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>(i / 50 + 1);
+  }
+  math::Set<float, CPUMathUtil>(W.size(), 1, VECTOR_HEAD(W), &provider);
+
+  math::GemmBatched<float, CPUMathUtil>(CblasNoTrans, CblasNoTrans, static_cast<int>(X.size()), 3,
+                                        static_cast<int>(W.size()), 3, 5, 6, 10, 1.0f,
+                                        VECTOR_HEAD(X), VECTOR_HEAD(W), 0.0f, VECTOR_HEAD(Y), &provider);
+  for (int i = 0; i < Y.size(); ++i) {
+    EXPECT_EQ(Y[i], 10 * (i / 30 + 1)) << i;
+  }
+}
+
 TEST(MathTest, GemvNoTrans) {
   auto& provider = CPUMathUtil::Instance();
   std::vector<float> A(50);  // 5 * 10
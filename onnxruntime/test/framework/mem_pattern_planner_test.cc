@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/mem_pattern_planner.h"
+#include "core/framework/static_mem_pattern_planner.h"
 #include "gtest/gtest.h"
 
 namespace onnxruntime {
@@ -34,5 +35,30 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
   EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024 + 256 + 512);
   EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024);
 }
+
+TEST(MemPatternPlannerTest, StaticPlanTest) {
+  // 0 is freed after step 1 and 1 lives to the end, so in the order of execution 2 doesn't fit where 0 was
+  MemPatternPlanner traced;
+  traced.TraceAllocation(0, 256);
+  traced.TraceAllocation(1, 256);
+  traced.TraceFree(0);
+  traced.TraceAllocation(2, 512);
+  EXPECT_EQ(traced.GenerateMemPattern().PeakSize(), 256 + 256 + 512);
+
+  // placing the largest first, 0 takes the space 2 doesn't use while 0 is alive
+  StaticMemPatternPlanner planner;
+  planner.AddValue(0, 256, 0, 1);
+  planner.AddValue(1, 256, 0, 3);
+  planner.AddValue(2, 512, 2, 3);
+  planner.AddValue(3, 0, 1, 2);
+
+  auto pattern = planner.GenerateMemPattern();
+
+  EXPECT_EQ(pattern.PeakSize(), 512 + 256);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 512);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(3)->size_, 0);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -161,5 +161,99 @@ TEST(TransformerTest, MemcpyTransformerTestCudaFirst) {
   ExpectSame(node2, node4, 1);
 }
 
+TEST(TransformerTest, MemcpyTransformerBatchesCopiesOfNodeOutputs) {
+  auto model = std::make_shared<onnxruntime::Model>("test");
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float_type;
+  tensor_float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg i1_def("I1", &tensor_float_type),
+      o1_def("O1", &tensor_float_type),
+      o2_def("O2", &tensor_float_type),
+      o3_def("O3", &tensor_float_type),
+      o4_def("O4", &tensor_float_type);
+
+  auto& node1 = graph.AddNode("node1", "Split", "cpu operator1", ArgMap{&i1_def}, ArgMap{&o1_def, &o2_def});
+  node1.SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+  auto& node2 = graph.AddNode("node2", "MatMul", "gpu operator1", ArgMap{&o1_def, &o2_def}, ArgMap{&o3_def});
+  node2.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+  auto& node3 = graph.AddNode("node3", "Relu", "gpu operator2", ArgMap{&o1_def}, ArgMap{&o4_def});
+  node3.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto cpu_execution_provider = TestCPUExecutionProvider();
+  KernelRegistryManager test_registry_manager;
+  test_registry_manager.RegisterKernelRegistry(cpu_execution_provider->GetKernelRegistry(),
+                                               KernelRegistryPriority::LowPriority);
+
+  TransformerMemcpyImpl transformer(graph, onnxruntime::kCudaExecutionProvider);
+  EXPECT_TRUE(transformer.ModifyGraph(test_registry_manager));
+
+  status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // Expect: one copy of O1 and O2 from cpu to gpu, which both gpu nodes read
+  int num_copies = 0;
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() != "MemcpyFromHost")
+      continue;
+    ++num_copies;
+    ASSERT_EQ(node.InputDefs().size(), 2u);
+    EXPECT_EQ(node.InputDefs()[0]->Name(), "O1");
+    EXPECT_EQ(node.InputDefs()[1]->Name(), "O2");
+    EXPECT_EQ(node2.InputDefs()[0], node.OutputDefs()[0]);
+    EXPECT_EQ(node2.InputDefs()[1], node.OutputDefs()[1]);
+    EXPECT_EQ(node3.InputDefs()[0], node.OutputDefs()[0]);
+  }
+  EXPECT_EQ(num_copies, 1);
+}
+
+TEST(TransformerTest, MemcpyTransformerHoistsConstants) {
+  auto model = std::make_shared<onnxruntime::Model>("test");
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float_type;
+  tensor_float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg i1_def("I1", &tensor_float_type),
+      c1_def("C1", &tensor_float_type),
+      o1_def("O1", &tensor_float_type);
+
+  TensorProto value;
+  value.set_data_type(TensorProto_DataType_FLOAT);
+  value.add_dims(2);
+  value.add_float_data(1.f);
+  value.add_float_data(2.f);
+  auto& node1 = graph.AddNode("node1", "Constant", "cpu constant", ArgMap{}, ArgMap{&c1_def});
+  node1.AddAttribute("value", value);
+  node1.SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+  auto& node2 = graph.AddNode("node2", "Add", "gpu operator1", ArgMap{&i1_def, &c1_def}, ArgMap{&o1_def});
+  node2.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto cpu_execution_provider = TestCPUExecutionProvider();
+  KernelRegistryManager test_registry_manager;
+  test_registry_manager.RegisterKernelRegistry(cpu_execution_provider->GetKernelRegistry(),
+                                               KernelRegistryPriority::LowPriority);
+
+  TransformerMemcpyImpl transformer(graph, onnxruntime::kCudaExecutionProvider);
+  EXPECT_TRUE(transformer.ModifyGraph(test_registry_manager));
+
+  status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // Expect: the constant is an initializer the gpu node reads, which is copied when the session is initialized
+  const TensorProto* initializer = nullptr;
+  EXPECT_TRUE(graph.GetInitializedTensor("C1", initializer));
+  EXPECT_EQ(node2.InputDefs()[1]->Name(), "C1");
+  for (const auto& node : graph.Nodes()) {
+    EXPECT_NE(node.OpType(), "Constant");
+    EXPECT_NE(node.OpType(), "MemcpyFromHost");
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
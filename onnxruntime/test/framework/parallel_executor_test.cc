@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/cost_based_placement_transformer.h"
+#include "core/framework/parallel_executor.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+typedef std::vector<onnxruntime::NodeArg*> ArgMap;
+
+// Y = Add(Relu(Relu(X)), Relu(X)), where the first branch is the longer path to Y
+static void BuildGraph(Graph& graph) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1024);
+  auto& x_def = graph.GetOrCreateNodeArg("X", &type);
+  auto& a1_def = graph.GetOrCreateNodeArg("A1", &type);
+  auto& a2_def = graph.GetOrCreateNodeArg("A2", &type);
+  auto& b_def = graph.GetOrCreateNodeArg("B", &type);
+  auto& y_def = graph.GetOrCreateNodeArg("Y", &type);
+
+  graph.AddNode("relu_a1", "Relu", "", ArgMap{&x_def}, ArgMap{&a1_def});
+  graph.AddNode("relu_a2", "Relu", "", ArgMap{&a1_def}, ArgMap{&a2_def});
+  graph.AddNode("relu_b", "Relu", "", ArgMap{&x_def}, ArgMap{&b_def});
+  graph.AddNode("add", "Add", "", ArgMap{&a2_def, &b_def}, ArgMap{&y_def});
+}
+
+static const Node& FindNode(const Graph& graph, const std::string& name) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.Name() == name)
+      return node;
+  }
+  ORT_THROW("No node ", name);
+}
+
+TEST(ParallelExecutorTest, CriticalPathPriorities) {
+  onnxruntime::Model model("test");
+  onnxruntime::Graph& graph = model.MainGraph();
+  BuildGraph(graph);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  PlacementCostModel cost_model;
+  GraphViewer graph_viewer(graph);
+  auto priorities = ParallelExecutor::ComputeNodePriorities(graph_viewer, cost_model);
+  ASSERT_EQ(priorities.size(), graph_viewer.MaxNodeIndex());
+
+  const auto& relu_a1 = FindNode(graph, "relu_a1");
+  const auto& relu_a2 = FindNode(graph, "relu_a2");
+  const auto& relu_b = FindNode(graph, "relu_b");
+  const auto& add = FindNode(graph, "add");
+  // the rank of a node is its time plus the largest rank of its successors
+  EXPECT_DOUBLE_EQ(priorities[add.Index()], cost_model.NodeTime(add));
+  EXPECT_DOUBLE_EQ(priorities[relu_a2.Index()], cost_model.NodeTime(relu_a2) + priorities[add.Index()]);
+  EXPECT_DOUBLE_EQ(priorities[relu_a1.Index()], cost_model.NodeTime(relu_a1) + priorities[relu_a2.Index()]);
+  EXPECT_GT(priorities[relu_a1.Index()], priorities[relu_b.Index()]);
+
+  // a measured time makes the other branch the critical path
+  cost_model.node_times_us[PlacementCostModel::TimeKey(kCpuExecutionProvider, "relu_b")] = 1000.0;
+  priorities = ParallelExecutor::ComputeNodePriorities(graph_viewer, cost_model);
+  EXPECT_DOUBLE_EQ(priorities[relu_b.Index()], 1000.0 + priorities[add.Index()]);
+  EXPECT_GT(priorities[relu_b.Index()], priorities[relu_a1.Index()]);
+}
+
+// cheap nodes join the cluster of a producer until the cluster is full, nodes of unknown times stay on their own
+TEST(ParallelExecutorTest, CheapNodeClusters) {
+  onnxruntime::Model model("test");
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  TypeProto dynamic_type;
+  dynamic_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  dynamic_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+
+  // heavy feeds the cheap b and c, whose sum feeds a chain of cheap nodes, the heavy other and the dynamic node of
+  // an input of unknown size
+  auto& x_def = graph.GetOrCreateNodeArg("X", &type);
+  auto& h_def = graph.GetOrCreateNodeArg("H", &type);
+  auto& b_def = graph.GetOrCreateNodeArg("B", &type);
+  auto& c_def = graph.GetOrCreateNodeArg("C", &type);
+  auto& o_def = graph.GetOrCreateNodeArg("O", &type);
+  auto& y_def = graph.GetOrCreateNodeArg("Y", &dynamic_type);
+  auto& z_def = graph.GetOrCreateNodeArg("Z", &dynamic_type);
+  graph.AddNode("heavy", "Relu", "", ArgMap{&x_def}, ArgMap{&h_def});
+  graph.AddNode("b", "Relu", "", ArgMap{&h_def}, ArgMap{&b_def});
+  graph.AddNode("c", "Relu", "", ArgMap{&h_def}, ArgMap{&c_def});
+  graph.AddNode("other", "Relu", "", ArgMap{&h_def}, ArgMap{&o_def});
+  graph.AddNode("dynamic", "Add", "", ArgMap{&h_def, &y_def}, ArgMap{&z_def});
+  auto* chain_def = &graph.GetOrCreateNodeArg("S", &type);
+  graph.AddNode("sum", "Add", "", ArgMap{&b_def, &c_def}, ArgMap{chain_def});
+  for (int i = 0; i < 6; ++i) {
+    auto* next_def = &graph.GetOrCreateNodeArg("S" + std::to_string(i), &type);
+    graph.AddNode("chain" + std::to_string(i), "Relu", "", ArgMap{chain_def}, ArgMap{next_def});
+    chain_def = next_def;
+  }
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  PlacementCostModel cost_model;
+  cost_model.node_times_us[PlacementCostModel::TimeKey(kCpuExecutionProvider, "heavy")] = 100.0;
+  cost_model.node_times_us[PlacementCostModel::TimeKey(kCpuExecutionProvider, "other")] = 100.0;
+  for (int i = 0; i < 6; ++i) {
+    cost_model.node_times_us[PlacementCostModel::TimeKey(kCpuExecutionProvider, "chain" + std::to_string(i))] = 4.0;
+  }
+
+  GraphViewer graph_viewer(graph);
+  auto clusters = ParallelExecutor::ComputeNodeClusters(graph_viewer, cost_model);
+  ASSERT_EQ(clusters.size(), graph_viewer.MaxNodeIndex());
+  auto cluster_of = [&](const std::string& name) { return clusters[FindNode(graph, name).Index()]; };
+
+  const auto heavy = FindNode(graph, "heavy").Index();
+  EXPECT_EQ(cluster_of("heavy"), heavy);
+  EXPECT_EQ(cluster_of("b"), heavy);
+  EXPECT_EQ(cluster_of("c"), heavy);
+  EXPECT_EQ(cluster_of("sum"), heavy);
+  EXPECT_EQ(cluster_of("other"), FindNode(graph, "other").Index());
+  EXPECT_EQ(cluster_of("dynamic"), FindNode(graph, "dynamic").Index());
+
+  // the chain fills the cluster of heavy up to kMaxClusterUs, and the rest of it starts a cluster of its own
+  double cluster_time = cost_model.NodeTime(FindNode(graph, "b")) + cost_model.NodeTime(FindNode(graph, "c")) +
+                        cost_model.NodeTime(FindNode(graph, "sum"));
+  int i = 0;
+  for (; i < 6 && cluster_time + 4.0 <= ParallelExecutor::kMaxClusterUs; ++i) {
+    EXPECT_EQ(cluster_of("chain" + std::to_string(i)), heavy);
+    cluster_time += 4.0;
+  }
+  ASSERT_LT(i, 6);
+  const auto rest = FindNode(graph, "chain" + std::to_string(i)).Index();
+  for (; i < 6; ++i) {
+    EXPECT_EQ(cluster_of("chain" + std::to_string(i)), rest);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
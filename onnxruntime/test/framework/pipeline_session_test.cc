@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/pipeline_session.h"
+
+#include <algorithm>
+
+#include "core/framework/cost_based_placement_transformer.h"
+#include "core/framework/graph_partitioner.h"
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Y = Relu(X) * W + X with X of shape {N, 2} and the initializer W of shape {2}
+static void SaveModel(const std::string& model_file_name) {
+  Model model("PipelineSessionTest");
+  auto& graph = model.MainGraph();
+
+  const TypeProto batch_tensor = MakeFloatTensorType({-1, 2});
+  const TypeProto weight_tensor = MakeFloatTensorType({2});
+
+  TensorProto weight;
+  weight.set_name("W");
+  weight.set_data_type(TensorProto_DataType_FLOAT);
+  weight.add_dims(2);
+  weight.add_float_data(2.f);
+  weight.add_float_data(3.f);
+  graph.AddInitializedTensor(weight);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &batch_tensor);
+  auto& w = graph.GetOrCreateNodeArg("W", &weight_tensor);
+  auto& a = graph.GetOrCreateNodeArg("A", &batch_tensor);
+  auto& b = graph.GetOrCreateNodeArg("B", &batch_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &batch_tensor);
+  graph.AddNode("relu", "Relu", "", {&x}, {&a});
+  graph.AddNode("mul", "Mul", "", {&a, &w}, {&b});
+  graph.AddNode("add", "Add", "", {&b, &x}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  ASSERT_TRUE(Model::Save(model, model_file_name).IsOK());
+}
+
+TEST(PipelineSessionTest, PartitionIntoStages) {
+  const std::string model_file_name = "pipeline_session_test_partition.onnx";
+  SaveModel(model_file_name);
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(model_file_name, model).IsOK());
+  GraphViewer graph_viewer(model->MainGraph());
+
+  std::vector<std::vector<NodeIndex>> stages;
+  auto status = GraphPartitioner::PartitionIntoStages(graph_viewer, 3, PlacementCostModel(), stages);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(stages.size(), 3u);
+  for (size_t s = 0; s < stages.size(); ++s) {
+    ASSERT_EQ(stages[s].size(), 1u);
+    EXPECT_EQ(stages[s][0], graph_viewer.GetNodesInTopologicalOrder()[s]);
+  }
+
+  EXPECT_FALSE(GraphPartitioner::PartitionIntoStages(graph_viewer, 4, PlacementCostModel(), stages).IsOK());
+}
+
+TEST(PipelineSessionTest, RejectsNoDevices) {
+  const std::string model_file_name = "pipeline_session_test_no_devices.onnx";
+  SaveModel(model_file_name);
+
+  SessionOptions so;
+  std::unique_ptr<PipelineSession> pipeline_session;
+  auto status = PipelineSession::Create(so, model_file_name, {}, CreateCpuProviders, PipelineOptions(),
+                                        &DefaultLoggingManager(), pipeline_session);
+  EXPECT_FALSE(status.IsOK());
+  EXPECT_EQ(pipeline_session, nullptr);
+}
+
+TEST(PipelineSessionTest, MicroBatches) {
+  const std::string model_file_name = "pipeline_session_test_micro_batches.onnx";
+  SaveModel(model_file_name);
+
+  SessionOptions so;
+  so.session_logid = "PipelineSessionTest.MicroBatches";
+  PipelineOptions options;
+  options.num_micro_batches = 2;
+  std::unique_ptr<PipelineSession> pipeline_session;
+  auto status = PipelineSession::Create(so, model_file_name, {0, 1}, CreateCpuProviders, options,
+                                        &DefaultLoggingManager(), pipeline_session);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(pipeline_session->NumStages(), 2u);
+
+  // the second stage reads the graph input X as well as the output of the first
+  auto inputs = pipeline_session->GetStage(1).GetModelInputs();
+  ASSERT_TRUE(inputs.first.IsOK());
+  std::vector<std::string> input_names;
+  for (const auto* input : *inputs.second) {
+    input_names.push_back(input->Name());
+  }
+  EXPECT_NE(std::find(input_names.begin(), input_names.end(), "X"), input_names.end());
+
+  // 3 rows are split into micro-batches of 2 and 1
+  for (int64_t rows : {3, 1}) {
+    std::vector<float> values;
+    for (int64_t i = 0; i < rows * 2; ++i) {
+      values.push_back(static_cast<float>(i - 2));
+    }
+    std::vector<MLValue> fetches;
+    status = pipeline_session->Run(RunOptions(), NameMLValMap{{"X", CreateFloatValue({rows, 2}, values)}}, {"Y"},
+                                   &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_EQ(fetches.size(), 1u);
+    const auto& y = fetches[0].Get<Tensor>();
+    ASSERT_EQ(y.Shape(), TensorShape({rows, 2}));
+    for (int64_t i = 0; i < rows * 2; ++i) {
+      const float x = values[i];
+      EXPECT_EQ(y.Data<float>()[i], std::max(x, 0.f) * (i % 2 == 0 ? 2.f : 3.f) + x);
+    }
+  }
+
+  std::vector<MLValue> fetches;
+  EXPECT_FALSE(
+      pipeline_session->Run(RunOptions(), NameMLValMap{{"X", CreateFloatValue({1, 2}, {1.f, 2.f})}}, {"Z"}, &fetches)
+          .IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
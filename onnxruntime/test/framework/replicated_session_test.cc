@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/replicated_session.h"
+
+#include <thread>
+
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+#include "test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Y = X * X with X of shape {2}
+static void SaveMulModel(const std::string& model_file_name) {
+  ASSERT_TRUE(SaveSingleNodeModel(model_file_name, "Mul", {"X", "X"}, "Y", MakeFloatTensorType({2})).IsOK());
+}
+
+TEST(ReplicatedSessionTest, RejectsNoDevices) {
+  const std::string model_file_name = "replicated_session_test_no_devices.onnx";
+  SaveMulModel(model_file_name);
+
+  SessionOptions so;
+  std::unique_ptr<ReplicatedSession> replicated_session;
+  auto status = ReplicatedSession::Create(so, model_file_name, {}, CreateCpuProviders, &DefaultLoggingManager(),
+                                          replicated_session);
+  EXPECT_FALSE(status.IsOK());
+  EXPECT_EQ(replicated_session, nullptr);
+}
+
+TEST(ReplicatedSessionTest, ConcurrentRuns) {
+  const std::string model_file_name = "replicated_session_test_concurrent_runs.onnx";
+  SaveMulModel(model_file_name);
+
+  SessionOptions so;
+  so.session_logid = "ReplicatedSessionTest.ConcurrentRuns";
+  std::vector<int> created_devices;
+  auto provider_factory = [&created_devices](int device_id) {
+    created_devices.push_back(device_id);
+    return CreateCpuProviders(device_id);
+  };
+
+  std::unique_ptr<ReplicatedSession> replicated_session;
+  auto status = ReplicatedSession::Create(so, model_file_name, {0, 1, 2}, provider_factory,
+                                          &DefaultLoggingManager(), replicated_session);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(replicated_session->NumReplicas(), 3u);
+  EXPECT_EQ(created_devices, (std::vector<int>{0, 1, 2}));
+
+  auto inputs = replicated_session->GetReplica(2).GetModelInputs();
+  ASSERT_TRUE(inputs.first.IsOK());
+  ASSERT_EQ(inputs.second->size(), 1u);
+  EXPECT_EQ((*inputs.second)[0]->Name(), "X");
+
+  const int num_requests = 12;
+  std::vector<std::thread> threads;
+  std::vector<Status> statuses(num_requests);
+  std::vector<std::vector<MLValue>> fetches(num_requests);
+
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&, i]() {
+      NameMLValMap feeds{{"X", CreateFloatValue({2}, {static_cast<float>(i), static_cast<float>(i + 1)})}};
+      RunOptions run_options;
+      statuses[i] = replicated_session->Run(run_options, feeds, {"Y"}, &fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i].ErrorMessage();
+    ASSERT_EQ(fetches[i].size(), 1u);
+    const float* data = fetches[i][0].Get<Tensor>().Data<float>();
+    EXPECT_EQ(data[0], static_cast<float>(i * i));
+    EXPECT_EQ(data[1], static_cast<float>((i + 1) * (i + 1)));
+  }
+
+  EXPECT_EQ(replicated_session->GetReplicaLoads(), (std::vector<int>{0, 0, 0}));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
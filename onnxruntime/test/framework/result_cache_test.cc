@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/result_cache.h"
+
+#include <thread>
+
+#include "test/framework/test_utils.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::string MakeKey(const ResultCache& cache, const MLValue& feed) {
+  std::string key;
+  EXPECT_TRUE(cache.AppendFeed("X", feed, key));
+  ResultCache::AppendOutputNames({"Y"}, key);
+  return key;
+}
+
+TEST(ResultCacheTest, ReturnsCopiesOfTheFetchesOfTheSameFeeds) {
+  ResultCache cache(ResultCacheConfig{});
+  const std::string key = MakeKey(cache, CreateFloatValue({2}, {1.f, 2.f}));
+
+  std::vector<MLValue> fetches;
+  EXPECT_FALSE(cache.Find(key, fetches));
+  cache.Insert(key, {CreateFloatValue({2}, {3.f, 4.f})});
+
+  // equal feeds in another tensor have the same key
+  EXPECT_EQ(MakeKey(cache, CreateFloatValue({2}, {1.f, 2.f})), key);
+  ASSERT_TRUE(cache.Find(key, fetches));
+  ASSERT_EQ(fetches.size(), 1u);
+  auto* data = fetches[0].GetMutable<Tensor>()->MutableData<float>();
+  EXPECT_EQ(data[0], 3.f);
+  EXPECT_EQ(data[1], 4.f);
+
+  // writing to a fetch leaves the cached one
+  data[0] = 0.f;
+  std::vector<MLValue> other_fetches;
+  ASSERT_TRUE(cache.Find(key, other_fetches));
+  EXPECT_EQ(other_fetches[0].Get<Tensor>().Data<float>()[0], 3.f);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.num_hits, 2u);
+  EXPECT_EQ(stats.num_misses, 1u);
+  EXPECT_EQ(stats.num_entries, 1u);
+  EXPECT_GT(stats.num_bytes, 2 * sizeof(float));
+}
+
+TEST(ResultCacheTest, KeysDifferByShapeDataAndOutputs) {
+  ResultCache cache(ResultCacheConfig{});
+  const std::string key = MakeKey(cache, CreateFloatValue({2}, {1.f, 2.f}));
+  EXPECT_NE(MakeKey(cache, CreateFloatValue({1, 2}, {1.f, 2.f})), key);
+  EXPECT_NE(MakeKey(cache, CreateFloatValue({2}, {1.f, 3.f})), key);
+
+  std::string other_outputs;
+  EXPECT_TRUE(cache.AppendFeed("X", CreateFloatValue({2}, {1.f, 2.f}), other_outputs));
+  ResultCache::AppendOutputNames({"Z"}, other_outputs);
+  EXPECT_NE(other_outputs, key);
+}
+
+TEST(ResultCacheTest, EvictsTheLeastRecentlyUsed) {
+  ResultCacheConfig config;
+  config.max_entries = 2;
+  ResultCache cache(config);
+  const std::string key_1 = MakeKey(cache, CreateFloatValue({1}, {1.f}));
+  const std::string key_2 = MakeKey(cache, CreateFloatValue({1}, {2.f}));
+  const std::string key_3 = MakeKey(cache, CreateFloatValue({1}, {3.f}));
+
+  std::vector<MLValue> fetches;
+  cache.Insert(key_1, {CreateFloatValue({1}, {1.f})});
+  cache.Insert(key_2, {CreateFloatValue({1}, {2.f})});
+  ASSERT_TRUE(cache.Find(key_1, fetches));
+  cache.Insert(key_3, {CreateFloatValue({1}, {3.f})});
+
+  EXPECT_TRUE(cache.Find(key_1, fetches));
+  EXPECT_FALSE(cache.Find(key_2, fetches));
+  EXPECT_TRUE(cache.Find(key_3, fetches));
+  EXPECT_EQ(cache.GetStats().num_evictions, 1u);
+  EXPECT_EQ(cache.GetStats().num_entries, 2u);
+}
+
+TEST(ResultCacheTest, KeepsRunsWithinMaxBytes) {
+  ResultCacheConfig config;
+  config.max_bytes = 256;
+  ResultCache cache(config);
+
+  // a feed over the limit can't be cached
+  std::string key;
+  EXPECT_FALSE(cache.AppendFeed("X", CreateFloatValue({128}, std::vector<float>(128, 1.f)), key));
+
+  // nor can fetches that take the Run over it
+  key = MakeKey(cache, CreateFloatValue({1}, {1.f}));
+  cache.Insert(key, {CreateFloatValue({64}, std::vector<float>(64, 1.f))});
+  std::vector<MLValue> fetches;
+  EXPECT_FALSE(cache.Find(key, fetches));
+  EXPECT_EQ(cache.GetStats().num_entries, 0u);
+
+  cache.Insert(key, {CreateFloatValue({1}, {1.f})});
+  EXPECT_TRUE(cache.Find(key, fetches));
+  EXPECT_LE(cache.GetStats().num_bytes, config.max_bytes);
+}
+
+TEST(ResultCacheTest, ExpiresRunsAfterTheirTtl) {
+  ResultCacheConfig config;
+  config.ttl_ms = 10;
+  ResultCache cache(config);
+  const std::string key = MakeKey(cache, CreateFloatValue({1}, {1.f}));
+  cache.Insert(key, {CreateFloatValue({1}, {1.f})});
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  std::vector<MLValue> fetches;
+  EXPECT_FALSE(cache.Find(key, fetches));
+  EXPECT_EQ(cache.GetStats().num_evictions, 1u);
+  EXPECT_EQ(cache.GetStats().num_entries, 0u);
+}
+
+TEST(ResultCacheTest, SharesTheCachedFetches) {
+  ResultCacheConfig config;
+  config.share_fetches = true;
+  ResultCache cache(config);
+  const std::string key = MakeKey(cache, CreateFloatValue({1}, {1.f}));
+  const MLValue fetch = CreateFloatValue({1}, {2.f});
+  cache.Insert(key, {fetch});
+
+  std::vector<MLValue> fetches;
+  ASSERT_TRUE(cache.Find(key, fetches));
+  EXPECT_EQ(&fetches[0].Get<Tensor>(), &fetch.Get<Tensor>());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
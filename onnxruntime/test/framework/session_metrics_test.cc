@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/session_metrics.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(SessionMetricsTest, CountsCallsOfOpTypes) {
+  SessionMetrics metrics;
+  auto& add = metrics.RegisterOpType("Add");
+  auto& mul = metrics.RegisterOpType("Mul");
+  EXPECT_EQ(&metrics.RegisterOpType("Add"), &add);
+
+  add.Record(10, 100);
+  add.Record(20, 200);
+  mul.Record(5, 8);
+
+  auto op_metrics = metrics.GetOpMetrics();
+  ASSERT_EQ(op_metrics.size(), 2u);
+  EXPECT_EQ(op_metrics[0].op_type, "Add");
+  EXPECT_EQ(op_metrics[0].num_calls, 2u);
+  EXPECT_EQ(op_metrics[0].total_time_us, 30u);
+  EXPECT_EQ(op_metrics[0].output_bytes, 300u);
+  EXPECT_EQ(op_metrics[1].op_type, "Mul");
+  EXPECT_EQ(op_metrics[1].num_calls, 1u);
+  EXPECT_EQ(op_metrics[1].p50_time_us, 5u);
+  EXPECT_EQ(op_metrics[1].p99_time_us, 5u);
+}
+
+TEST(SessionMetricsTest, SumsHardwareEvents) {
+  SessionMetrics metrics;
+  auto& op = metrics.RegisterOpType("Op");
+
+  HardwareCounterValues hardware_events;
+  hardware_events.cycles = 1000;
+  hardware_events.instructions = 2000;
+  hardware_events.llc_misses = 3;
+  hardware_events.dtlb_misses = 4;
+  op.Record(10, 0, hardware_events);
+  op.Record(10, 0, hardware_events);
+  // a call without the counters adds nothing to them
+  op.Record(10, 0);
+
+  auto op_metrics = metrics.GetOpMetrics();
+  ASSERT_EQ(op_metrics.size(), 1u);
+  EXPECT_EQ(op_metrics[0].num_calls, 3u);
+  EXPECT_EQ(op_metrics[0].cycles, 2000u);
+  EXPECT_EQ(op_metrics[0].instructions, 4000u);
+  EXPECT_EQ(op_metrics[0].llc_misses, 6u);
+  EXPECT_EQ(op_metrics[0].dtlb_misses, 8u);
+}
+
+TEST(SessionMetricsTest, EstimatesPercentilesWithin25Percent) {
+  SessionMetrics metrics;
+  auto& op = metrics.RegisterOpType("Op");
+  // 1..1000us
+  for (int duration = 1; duration <= 1000; ++duration) {
+    op.Record(duration, 0);
+  }
+
+  auto op_metrics = metrics.GetOpMetrics();
+  ASSERT_EQ(op_metrics.size(), 1u);
+  EXPECT_GE(op_metrics[0].p50_time_us, 500u);
+  EXPECT_LE(op_metrics[0].p50_time_us, 625u);
+  EXPECT_GE(op_metrics[0].p99_time_us, 990u);
+  EXPECT_LE(op_metrics[0].p99_time_us, 1238u);
+  EXPECT_LE(op_metrics[0].p50_time_us, op_metrics[0].p99_time_us);
+}
+
+TEST(SessionMetricsTest, RecordsFromThreads) {
+  SessionMetrics metrics;
+  auto& op = metrics.RegisterOpType("Op");
+
+  const int num_threads = 4;
+  const int num_calls = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&op]() {
+      for (int i = 0; i < num_calls; ++i) {
+        op.Record(1, 4);
+      }
+    });
+  }
+
+  // a snapshot may be taken while the nodes are recorded
+  metrics.GetOpMetrics();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto op_metrics = metrics.GetOpMetrics();
+  EXPECT_EQ(op_metrics[0].num_calls, static_cast<uint64_t>(num_threads * num_calls));
+  EXPECT_EQ(op_metrics[0].output_bytes, static_cast<uint64_t>(num_threads * num_calls * 4));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
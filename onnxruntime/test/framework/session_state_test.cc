@@ -3,7 +3,9 @@
 
 #include <iostream>
 
+#include "core/framework/allocation_planner.h"
 #include "core/framework/execution_providers.h"
+#include "core/framework/kernel_registry_manager.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/graph/graph_viewer.h"
@@ -65,5 +67,106 @@ TEST(SessionStateTest, AddGetKernelTest) {
   std::cout << "orig: " << orig_num_outputs << " new: " << test_kernel->Node().OutputDefs().size() << std::endl;
   EXPECT_EQ(orig_num_outputs, test_kernel->Node().OutputDefs().size());
 }
+
+TEST(SessionStateTest, MemoryPatternCacheBucketsAndEviction) {
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers};
+  s.SetMemoryPatternCacheOptions(2, {16, 64});
+
+  auto shapes = [](int64_t seq_len) { return std::vector<TensorShape>{TensorShape({1, seq_len})}; };
+
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(10)), nullptr);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes(10), std::make_unique<MemoryPatternGroup>()).IsOK());
+
+  // 10 and 12 are both rounded up to 16 so share a pattern
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes(12)), nullptr);
+  // different rank
+  EXPECT_EQ(s.GetMemoryPatternGroup({TensorShape({1, 1, 12})}), nullptr);
+
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes(40), std::make_unique<MemoryPatternGroup>()).IsOK());
+  // use the 16 bucket so the 64 bucket is least recently used
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes(16)), nullptr);
+  // dims beyond the last bucket are used as is
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes(100), std::make_unique<MemoryPatternGroup>()).IsOK());
+
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes(100)), nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(101)), nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(40)), nullptr);
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes(1)), nullptr);
+
+  // invalidated patterns are misses until replaced
+  s.InvalidateMemoryPatternGroup(shapes(3));
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes(5)), nullptr);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes(5), std::make_unique<MemoryPatternGroup>()).IsOK());
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes(5)), nullptr);
+
+  auto stats = s.GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.hits, 5u);
+  EXPECT_EQ(stats.misses, 5u);
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.entries, 2u);
+}
+
+// X -> Clip -> T1 -> Clip -> T2 -> Clip -> Y, of which only the values of the second node can't have fences
+TEST(SessionStateTest, NodeExecutionSteps) {
+  onnxruntime::Model model("graph_1");
+  auto& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& t1 = graph.GetOrCreateNodeArg("T1", &tensor_float);
+  auto& t2 = graph.GetOrCreateNodeArg("T2", &tensor_float);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("node_1", "Clip", "", {&x}, {&t1});
+  graph.AddNode("node_2", "Clip", "", {&t1}, {&t2});
+  graph.AddNode("node_3", "Clip", "", {&t2}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto cpu_xp = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo{});
+  const IExecutionProvider* cpu_xp_ptr = cpu_xp.get();
+  KernelRegistryManager kernel_registry_manager;
+  kernel_registry_manager.RegisterKernelRegistry(cpu_xp->GetKernelRegistry(), KernelRegistryPriority::LowPriority);
+  ExecutionProviders execution_providers;
+  ASSERT_TRUE(execution_providers.Add(kCpuExecutionProvider, std::move(cpu_xp)).IsOK());
+
+  SessionState s{execution_providers};
+  s.SetGraphViewer(std::make_unique<GraphViewer>(graph));
+  for (const char* name : {"X", "T1", "T2", "Y"}) {
+    s.GetMLValueNameIdxMap().Add(name);
+  }
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+    std::unique_ptr<OpKernel> kernel;
+    ASSERT_TRUE(kernel_registry_manager.CreateKernel(node, *cpu_xp_ptr, s, kernel).IsOK());
+    s.AddKernel(node.Index(), std::move(kernel));
+  }
+
+  std::unique_ptr<SequentialExecutionPlan> plan;
+  status = SequentialPlanner::CreatePlan(GraphViewer(graph), {}, execution_providers, kernel_registry_manager,
+                                         s.GetMLValueNameIdxMap(), plan);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  s.SetExecutionPlan(std::move(plan));
+
+  const auto& exec_plan = s.GetExecutionPlan()->execution_plan;
+  const auto& steps = s.GetNodeExecutionSteps();
+  ASSERT_EQ(steps.size(), exec_plan.size());
+  ASSERT_EQ(steps.size(), 3u);
+  for (size_t i = 0; i < steps.size(); i++) {
+    EXPECT_EQ(steps[i].node_index, exec_plan[i].node_index);
+    EXPECT_EQ(steps[i].kernel, s.GetKernel(exec_plan[i].node_index));
+    EXPECT_EQ(steps[i].provider, cpu_xp_ptr);
+    EXPECT_EQ(steps[i].exec_queue_id, 0);
+    EXPECT_EQ(steps[i].free_from_index, exec_plan[i].free_from_index);
+    EXPECT_EQ(steps[i].free_to_index, exec_plan[i].free_to_index);
+  }
+  // X is fed and Y is fetched by the caller
+  EXPECT_TRUE(steps[0].may_have_fences);
+  EXPECT_FALSE(steps[1].may_have_fences);
+  EXPECT_TRUE(steps[2].may_have_fences);
+
+  // resolved once
+  EXPECT_EQ(&s.GetNodeExecutionSteps(), &steps);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_arena.h"
+#include "core/framework/bfc_arena.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(SharedArenaAllocatorTest, AccountsPerSession) {
+  auto arena = std::make_shared<BFCArena>(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  SharedArenaAllocator first(arena, 0);
+  SharedArenaAllocator second(arena, 0);
+
+  void* a = first.Alloc(1 << 20);
+  void* b = second.Alloc(1024);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(first.Used(), static_cast<size_t>(1 << 20));
+  EXPECT_EQ(second.Used(), static_cast<size_t>(1024));
+
+  AllocatorStats stats;
+  first.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 1);
+  EXPECT_EQ(stats.max_alloc_size, 1 << 20);
+
+  // the memory the first session frees is reused by the second, without the arena growing
+  first.Free(a);
+  AllocatorStats arena_stats;
+  arena->GetStats(&arena_stats);
+  const int64_t num_extends = arena_stats.num_extends;
+  void* c = second.Alloc(1 << 20);
+  ASSERT_NE(c, nullptr);
+  arena->GetStats(&arena_stats);
+  EXPECT_EQ(arena_stats.num_extends, num_extends);
+  EXPECT_EQ(first.Used(), static_cast<size_t>(0));
+  EXPECT_EQ(second.Used(), static_cast<size_t>((1 << 20) + 1024));
+
+  second.Free(b);
+  second.Free(c);
+  EXPECT_EQ(second.Used(), static_cast<size_t>(0));
+}
+
+TEST(SharedArenaAllocatorTest, SessionLimit) {
+  auto arena = std::make_shared<BFCArena>(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  SharedArenaAllocator allocator(arena, 4096);
+  EXPECT_EQ(allocator.Max(), static_cast<size_t>(4096));
+
+  void* a = allocator.Alloc(3072);
+  ASSERT_NE(a, nullptr);
+  EXPECT_EQ(allocator.Alloc(2048), nullptr);
+  EXPECT_EQ(allocator.Used(), static_cast<size_t>(3072));
+
+  allocator.Free(a);
+  a = allocator.Alloc(4096);
+  EXPECT_NE(a, nullptr);
+  allocator.Free(a);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
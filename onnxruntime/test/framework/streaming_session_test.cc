@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/streaming_session.h"
+
+#include <thread>
+
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Y = X * S and S_out = X + S with X and S of shape {2}
+static void LoadStatefulModel(InferenceSession& session) {
+  Model model("StreamingSessionTest");
+  auto& graph = model.MainGraph();
+
+  const TypeProto float_tensor = MakeFloatTensorType({2});
+
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& state = graph.GetOrCreateNodeArg("S", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& state_out = graph.GetOrCreateNodeArg("S_out", &float_tensor);
+  graph.AddNode("mul", "Mul", "scale the input by the state", {&input, &state}, {&output});
+  graph.AddNode("add", "Add", "accumulate the input in the state", {&input, &state}, {&state_out});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  auto status = LoadModel(session, model);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+static MLValue CreateValue(const std::vector<float>& values) {
+  return CreateFloatValue({2}, values);
+}
+
+static std::vector<float> GetValues(const MLValue& value) {
+  const float* data = value.Get<Tensor>().Data<float>();
+  return {data[0], data[1]};
+}
+
+TEST(StreamingSessionTest, RejectsUnknownBinding) {
+  SessionOptions so;
+  InferenceSession session{so, &DefaultLoggingManager()};
+  LoadStatefulModel(session);
+
+  std::unique_ptr<StreamingSession> streaming_session;
+  EXPECT_FALSE(StreamingSession::Create(session, {{"S_out", "T"}}, streaming_session).IsOK());
+  EXPECT_FALSE(StreamingSession::Create(session, {{"Z", "S"}}, streaming_session).IsOK());
+  EXPECT_FALSE(StreamingSession::Create(session, {}, streaming_session).IsOK());
+  EXPECT_EQ(streaming_session, nullptr);
+}
+
+TEST(StreamingSessionTest, StateIsCarriedBetweenRuns) {
+  SessionOptions so;
+  InferenceSession session{so, &DefaultLoggingManager()};
+  LoadStatefulModel(session);
+
+  std::unique_ptr<StreamingSession> streaming_session;
+  auto status = StreamingSession::Create(session, {{"S_out", "S"}}, streaming_session);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  MLValue initial_state = CreateValue({1.f, 1.f});
+  StreamingSession::StreamId stream;
+  ASSERT_TRUE(streaming_session->OpenStream({{"S", initial_state}}, stream).IsOK());
+  EXPECT_EQ(streaming_session->NumStreams(), 1u);
+
+  // the state after chunk n is 1 + n * X, which takes the state through both of its buffers a few times
+  RunOptions run_options;
+  for (int chunk = 0; chunk < 5; ++chunk) {
+    std::vector<MLValue> fetches;
+    status = streaming_session->Run(run_options, stream, {{"X", CreateValue({1.f, 2.f})}}, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_EQ(fetches.size(), 1u);
+    EXPECT_EQ(GetValues(fetches[0]), (std::vector<float>{1.f * (1 + chunk), 2.f * (1 + 2 * chunk)}));
+  }
+
+  // the state output can be fetched too
+  std::vector<MLValue> fetches;
+  status = streaming_session->Run(run_options, stream, {{"X", CreateValue({1.f, 2.f})}}, {"S_out", "Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(fetches.size(), 2u);
+  EXPECT_EQ(GetValues(fetches[0]), (std::vector<float>{7.f, 13.f}));
+
+  // the initial state belongs to the caller and isn't written
+  EXPECT_EQ(GetValues(initial_state), (std::vector<float>{1.f, 1.f}));
+
+  // the bound input can't be fed
+  status = streaming_session->Run(run_options, stream, {{"X", CreateValue({1.f, 2.f})}, {"S", initial_state}},
+                                  {"Y"}, &fetches);
+  EXPECT_FALSE(status.IsOK());
+
+  ASSERT_TRUE(streaming_session->CloseStream(stream).IsOK());
+  EXPECT_EQ(streaming_session->NumStreams(), 0u);
+  EXPECT_FALSE(streaming_session->Run(run_options, stream, {{"X", CreateValue({1.f, 2.f})}}, {"Y"}, &fetches).IsOK());
+  EXPECT_FALSE(streaming_session->CloseStream(stream).IsOK());
+}
+
+TEST(StreamingSessionTest, ConcurrentStreams) {
+  SessionOptions so;
+  InferenceSession session{so, &DefaultLoggingManager()};
+  LoadStatefulModel(session);
+
+  std::unique_ptr<StreamingSession> streaming_session;
+  ASSERT_TRUE(StreamingSession::Create(session, {{"S_out", "S"}}, streaming_session).IsOK());
+
+  const int num_streams = 8;
+  const int num_chunks = 10;
+  std::vector<StreamingSession::StreamId> streams(num_streams);
+  for (int i = 0; i < num_streams; ++i) {
+    ASSERT_TRUE(streaming_session->OpenStream({{"S", CreateValue({0.f, static_cast<float>(i)})}}, streams[i]).IsOK());
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<Status> statuses(num_streams);
+  std::vector<std::vector<MLValue>> fetches(num_streams);
+
+  for (int i = 0; i < num_streams; ++i) {
+    threads.emplace_back([&, i]() {
+      RunOptions run_options;
+      // the fetches of a Run are passed to the next one, where the state they hold is not written to
+      for (int chunk = 0; chunk < num_chunks && statuses[i].IsOK(); ++chunk) {
+        statuses[i] = streaming_session->Run(run_options, streams[i], {{"X", CreateValue({1.f, 1.f})}}, {"S_out"},
+                                             &fetches[i]);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_streams; ++i) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i].ErrorMessage();
+    EXPECT_EQ(GetValues(fetches[i][0]), (std::vector<float>{static_cast<float>(num_chunks),
+                                                            static_cast<float>(i + num_chunks)}));
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
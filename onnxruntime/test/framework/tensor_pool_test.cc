@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/tensor_pool.h"
+
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(TensorPoolTest, ReuseSlots) {
+  auto pool = std::make_shared<TensorPool>();
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  float data[4] = {1.f, 2.f, 3.f, 4.f};
+
+  std::vector<std::shared_ptr<Tensor>> tensors;
+  for (int i = 0; i < 3; ++i) {
+    tensors.push_back(pool->MakeTensor(DataTypeImpl::GetType<float>(), TensorShape({2, 2}), data,
+                                       cpu_allocator->Info()));
+  }
+  EXPECT_EQ(pool->NumSlotsInUse(), 3u);
+  const size_t num_slots = pool->NumSlots();
+  EXPECT_GE(num_slots, 3u);
+  EXPECT_EQ(tensors[2]->Data<float>()[3], 4.f);
+
+  // the slot of a released tensor is taken by the next one
+  const Tensor* released = tensors[1].get();
+  tensors[1].reset();
+  EXPECT_EQ(pool->NumSlotsInUse(), 2u);
+  tensors[1] = pool->MakeTensor(DataTypeImpl::GetType<float>(), TensorShape({4}), data, cpu_allocator->Info());
+  EXPECT_EQ(tensors[1].get(), released);
+  EXPECT_EQ(pool->NumSlots(), num_slots);
+}
+
+TEST(TensorPoolTest, TensorOutlivesPool) {
+  auto pool = std::make_shared<TensorPool>();
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  void* buffer = cpu_allocator->Alloc(sizeof(float) * 6);
+
+  // the tensor owns its buffer and keeps the pool its slot is in
+  MLValue value;
+  value.Init(pool->MakeTensor(DataTypeImpl::GetType<float>(), TensorShape({2, 3}), buffer, cpu_allocator->Info(),
+                              cpu_allocator),
+             DataTypeImpl::GetType<Tensor>());
+  std::weak_ptr<TensorPool> weak_pool = pool;
+  pool.reset();
+  EXPECT_FALSE(weak_pool.expired());
+  EXPECT_EQ(value.Get<Tensor>().Shape(), TensorShape({2, 3}));
+
+  value = MLValue();
+  EXPECT_TRUE(weak_pool.expired());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/tensor_seq.h"
+#include "core/session/onnxruntime_c_api.h"
+#include "test_utils.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static MLValue SeqValue(TensorSeq* seq) {
+  auto seq_type = DataTypeImpl::GetType<TensorSeq>();
+  return MLValue(seq, seq_type, seq_type->GetDeleteFunc());
+}
+
+TEST(TensorSeqTest, TensorsShareOneBuffer) {
+  auto alloc = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  TensorSeq seq(DataTypeImpl::GetType<float>());
+  seq.AddTensors({TensorShape({2, 3}), TensorShape({1}), TensorShape({0}), TensorShape({4})}, alloc);
+  ASSERT_EQ(seq.Size(), 4u);
+
+  const char* first = static_cast<const char*>(seq.Get(0).DataRaw());
+  for (size_t i = 0; i < seq.Size(); ++i) {
+    EXPECT_EQ(seq.Get(i).DataType(), DataTypeImpl::GetType<float>());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(seq.Get(i).DataRaw()) % 64, 0u);
+  }
+  EXPECT_EQ(static_cast<const char*>(seq.Get(1).DataRaw()), first + 64);
+  EXPECT_EQ(static_cast<const char*>(seq.Get(3).DataRaw()), first + 128);
+
+  // an element outlives the sequence
+  MLValue element = seq.GetValue(3);
+  seq.GetMutable(3).MutableData<float>()[3] = 5.f;
+  seq = TensorSeq();
+  EXPECT_EQ(element.Get<Tensor>().Data<float>()[3], 5.f);
+
+  MLValue tensor;
+  CreateMLValue<int64_t>(alloc, {2}, {1, 2}, &tensor);
+  EXPECT_THROW(TensorSeq(DataTypeImpl::GetType<float>()).Add(tensor), OnnxRuntimeException);
+}
+
+TEST(TensorSeqTest, StringTensors) {
+  auto alloc = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  TensorSeq seq(DataTypeImpl::GetType<std::string>());
+  seq.AddTensors({TensorShape({2}), TensorShape({3})}, alloc);
+  seq.GetMutable(1).MutableData<std::string>()[2] = "a string longer than the small string buffer";
+  EXPECT_EQ(seq.Get(0).Data<std::string>()[1], "");
+  EXPECT_EQ(seq.Get(1).Data<std::string>()[2], "a string longer than the small string buffer");
+}
+
+TEST(TensorSeqTest, CApiViews) {
+  auto alloc = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  MLValue tensor;
+  CreateMLValue<float>(alloc, {3}, {1.f, 2.f, 3.f}, &tensor);
+  auto* seq = new TensorSeq();
+  seq->Add(tensor);
+  MLValue* seq_value = new MLValue(SeqValue(seq));
+  auto* value = reinterpret_cast<OrtValue*>(seq_value);
+  EXPECT_EQ(OrtGetValueType(value), ONNX_TYPE_SEQUENCE);
+
+  size_t count = 0;
+  ASSERT_EQ(OrtGetValueCount(value, &count), nullptr);
+  EXPECT_EQ(count, 1u);
+  OrtValue* element = nullptr;
+  ASSERT_EQ(OrtGetValue(value, 0, &element), nullptr);
+  OrtReleaseValue(value);
+  // the element is the tensor that was added, not a copy of it
+  void* data = nullptr;
+  ASSERT_EQ(OrtGetTensorMutableData(element, &data), nullptr);
+  EXPECT_EQ(data, tensor.Get<Tensor>().DataRaw());
+  OrtReleaseValue(element);
+
+  // maps of a sequence of maps
+  auto maps_type = DataTypeImpl::GetType<VectorMapInt64ToFloat>();
+  auto* maps = new VectorMapInt64ToFloat{{{3, 0.5f}, {1, 1.5f}}, {}};
+  value = reinterpret_cast<OrtValue*>(new MLValue(maps, maps_type, maps_type->GetDeleteFunc()));
+  ASSERT_EQ(OrtGetValueCount(value, &count), nullptr);
+  EXPECT_EQ(count, 2u);
+  OrtStatus* status = OrtGetValue(value, 2, &element);
+  ASSERT_NE(status, nullptr);
+  OrtReleaseStatus(status);
+  ASSERT_EQ(OrtGetValue(value, 0, &element), nullptr);
+  OrtReleaseValue(value);
+  EXPECT_EQ(OrtGetValueType(element), ONNX_TYPE_MAP);
+  ASSERT_EQ(OrtGetValueCount(element, &count), nullptr);
+  ASSERT_EQ(count, 2u);
+  std::vector<int64_t> keys(count);
+  std::vector<float> values(count);
+  ASSERT_EQ(OrtGetMapEntries(element, keys.data(), values.data(), count), nullptr);
+  EXPECT_EQ(keys, (std::vector<int64_t>{1, 3}));
+  EXPECT_EQ(values, (std::vector<float>{1.5f, 0.5f}));
+  status = OrtGetMapEntries(element, keys.data(), values.data(), 1);
+  ASSERT_NE(status, nullptr);
+  OrtReleaseStatus(status);
+  OrtReleaseValue(element);
+
+  // string keys are pointers into the map
+  auto map_type = DataTypeImpl::GetType<MapStringToFloat>();
+  auto* map = new MapStringToFloat{{"b", 2.f}, {"a", 1.f}};
+  value = reinterpret_cast<OrtValue*>(new MLValue(map, map_type, map_type->GetDeleteFunc()));
+  const char* string_keys[2];
+  ASSERT_EQ(OrtGetMapEntries(value, string_keys, nullptr, 2), nullptr);
+  EXPECT_EQ(string_keys[0], map->begin()->first.c_str());
+  EXPECT_STREQ(string_keys[1], "b");
+  OrtReleaseValue(value);
+
+  auto floats_type = DataTypeImpl::GetType<VectorFloat>();
+  auto* floats = new VectorFloat{1.f, 2.f};
+  value = reinterpret_cast<OrtValue*>(new MLValue(floats, floats_type, floats_type->GetDeleteFunc()));
+  const void* floats_data = nullptr;
+  ASSERT_EQ(OrtGetSequenceData(value, &floats_data), nullptr);
+  EXPECT_EQ(floats_data, floats->data());
+  status = OrtGetMapEntries(value, nullptr, nullptr, 2);
+  ASSERT_NE(status, nullptr);
+  OrtReleaseStatus(status);
+  OrtReleaseValue(value);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
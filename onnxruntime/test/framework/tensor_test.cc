@@ -216,5 +216,37 @@ TEST(TensorTest, Int64PtrConstructor) {
   EXPECT_THAT(shape.GetDims(), testing::ElementsAre(2, 3));
 }
 
+TEST(TensorTest, ShapeCopyAndMove) {
+  // up to TensorShape::kSmallBufferSize dimensions are stored inline, and more on the heap
+  for (size_t rank : {size_t{3}, TensorShape::kSmallBufferSize + 2}) {
+    std::vector<int64_t> dims(rank, 2);
+    TensorShape shape(dims);
+    TensorShape copy(shape);
+    EXPECT_EQ(copy, shape);
+    EXPECT_NE(copy.GetDims().data(), shape.GetDims().data());
+
+    copy[0] = 5;
+    EXPECT_EQ(shape[0], 2);
+    EXPECT_EQ(copy.Size(), shape.Size() / 2 * 5);
+
+    TensorShape moved(std::move(copy));
+    EXPECT_EQ(moved.NumDimensions(), rank);
+    EXPECT_EQ(moved[0], 5);
+    EXPECT_EQ(copy.NumDimensions(), 0u);
+
+    moved = shape;
+    EXPECT_EQ(moved, shape);
+    EXPECT_EQ(moved.GetDimsAsVector(), dims);
+    EXPECT_EQ(moved.Slice(1), TensorShape(std::vector<int64_t>(rank - 1, 2)));
+  }
+
+  // a shorter shape assigned to a longer one, and the other way around
+  TensorShape shape(std::vector<int64_t>(TensorShape::kSmallBufferSize + 1, 3));
+  shape = TensorShape({1, 2});
+  EXPECT_THAT(shape.GetDims(), testing::ElementsAre(1, 2));
+  shape = TensorShape(std::vector<int64_t>(TensorShape::kSmallBufferSize + 1, 3));
+  EXPECT_EQ(shape.Size(), 2187);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,6 +2,12 @@
 // Licensed under the MIT License.
 
 #include "test_utils.h"
+
+#include <sstream>
+
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+
 namespace onnxruntime {
 namespace test {
 IExecutionProvider* TestCPUExecutionProvider() {
@@ -24,5 +30,71 @@ IExecutionProvider* TestTRTExecutionProvider() {
   return &trt_provider;
 }
 #endif
+
+ONNX_NAMESPACE::TypeProto MakeFloatTensorType(const std::vector<int64_t>& dims, const std::string& dim_param) {
+  ONNX_NAMESPACE::TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (auto dim : dims) {
+    if (dim < 0) {
+      shape->add_dim()->set_dim_param(dim_param);
+    } else {
+      shape->add_dim()->set_dim_value(dim);
+    }
+  }
+  return type;
+}
+
+Status CreateSingleNodeModel(const std::string& op_type, const std::vector<std::string>& input_names,
+                             const std::string& output_name, const ONNX_NAMESPACE::TypeProto& type,
+                             std::unique_ptr<Model>& model) {
+  model = std::make_unique<Model>(op_type + "Model");
+  auto& graph = model->MainGraph();
+
+  std::vector<NodeArg*> inputs;
+  for (const auto& input_name : input_names) {
+    inputs.push_back(&graph.GetOrCreateNodeArg(input_name, &type));
+  }
+  auto& output = graph.GetOrCreateNodeArg(output_name, &type);
+  graph.AddNode(op_type, op_type, op_type, inputs, {&output});
+  return graph.Resolve();
+}
+
+Status SaveSingleNodeModel(const std::string& model_file_name, const std::string& op_type,
+                           const std::vector<std::string>& input_names, const std::string& output_name,
+                           const ONNX_NAMESPACE::TypeProto& type) {
+  std::unique_ptr<Model> model;
+  ORT_RETURN_IF_ERROR(CreateSingleNodeModel(op_type, input_names, output_name, type, model));
+  return Model::Save(*model, model_file_name);
+}
+
+Status LoadModel(InferenceSession& session, Model& model) {
+  std::stringstream model_stream;
+  if (!model.ToProto().SerializeToOstream(&model_stream)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to serialize the model");
+  }
+  ORT_RETURN_IF_ERROR(session.Load(model_stream));
+  return session.Initialize();
+}
+
+Status LoadSingleNodeModel(InferenceSession& session, const std::string& op_type,
+                           const std::vector<std::string>& input_names, const std::string& output_name,
+                           const ONNX_NAMESPACE::TypeProto& type) {
+  std::unique_ptr<Model> model;
+  ORT_RETURN_IF_ERROR(CreateSingleNodeModel(op_type, input_names, output_name, type, model));
+  return LoadModel(session, *model);
+}
+
+std::vector<std::unique_ptr<IExecutionProvider>> CreateCpuProviders(int) {
+  std::vector<std::unique_ptr<IExecutionProvider>> providers;
+  providers.push_back(std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo()));
+  return providers;
+}
+
+MLValue CreateFloatValue(const std::vector<int64_t>& dims, const std::vector<float>& values) {
+  MLValue value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims, values, &value);
+  return value;
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include "core/framework/execution_provider.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/framework/ml_value.h"
+#include "core/graph/onnx_protobuf.h"
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_execution_provider.h"
 #endif
@@ -14,6 +15,9 @@
 #endif
 
 namespace onnxruntime {
+class InferenceSession;
+class Model;
+
 namespace test {
 IExecutionProvider* TestCPUExecutionProvider();
 
@@ -65,5 +69,33 @@ void AllocateMLValue(AllocatorPtr alloc,
                   DataTypeImpl::GetType<Tensor>(),
                   DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
 }
+
+// a float tensor type of dims, a negative dimension being the symbolic dimension dim_param
+ONNX_NAMESPACE::TypeProto MakeFloatTensorType(const std::vector<int64_t>& dims, const std::string& dim_param = "N");
+
+// a resolved model of one node of op_type whose inputs and output are all of type
+Status CreateSingleNodeModel(const std::string& op_type, const std::vector<std::string>& input_names,
+                             const std::string& output_name, const ONNX_NAMESPACE::TypeProto& type,
+                             std::unique_ptr<Model>& model);
+
+// CreateSingleNodeModel saved to model_file_name
+Status SaveSingleNodeModel(const std::string& model_file_name, const std::string& op_type,
+                           const std::vector<std::string>& input_names, const std::string& output_name,
+                           const ONNX_NAMESPACE::TypeProto& type);
+
+// load model into session and initialize it
+Status LoadModel(InferenceSession& session, Model& model);
+
+// CreateSingleNodeModel loaded into session and initialized
+Status LoadSingleNodeModel(InferenceSession& session, const std::string& op_type,
+                           const std::vector<std::string>& input_names, const std::string& output_name,
+                           const ONNX_NAMESPACE::TypeProto& type);
+
+// the providers of a device for the replicated and pipeline sessions. the CPU stands in for every device, as the
+// dispatching to devices is the same
+std::vector<std::unique_ptr<IExecutionProvider>> CreateCpuProviders(int device_id);
+
+// a float tensor of dims holding values, allocated by TestCPUExecutionProvider
+MLValue CreateFloatValue(const std::vector<int64_t>& dims, const std::vector<float>& values);
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstring>
 #include <iostream>
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -861,5 +862,129 @@ TEST(NameResolutionTest, DuplicateName) {
   bool duplicate_error_found = status.ErrorMessage().find("Duplicate") != std::string::npos;
   EXPECT_TRUE(duplicate_error_found);
 }
+
+// Resolve infers the outputs of the nodes whose inputs changed since the last Resolve, and those downstream of them
+TEST(ResolvingGraphTest, ResolveInfersChangedNodes) {
+  Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& a = graph.GetOrCreateNodeArg("A", nullptr);
+  auto& b = graph.GetOrCreateNodeArg("B", nullptr);
+  graph.AddNode("relu_1", "Relu", "", {&x}, {&a});
+  auto& relu_2 = graph.AddNode("relu_2", "Relu", "", {&a}, {&b});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_NE(b.Shape(), nullptr);
+  EXPECT_EQ(b.Shape()->dim(0).dim_param(), "batch");
+
+  // the shape of the input reaches the output through both nodes
+  TensorShapeProto shape;
+  shape.add_dim()->set_dim_value(2);
+  shape.add_dim()->set_dim_value(3);
+  x.SetShape(shape);
+  graph.SetGraphResolveNeeded();
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_EQ(b.Shape()->dim(0).dim_value(), 2);
+
+  // the node whose input was replaced is checked against its new input
+  TypeProto tensor_string;
+  tensor_string.mutable_tensor_type()->set_elem_type(TensorProto_DataType_STRING);
+  auto& s = graph.GetOrCreateNodeArg("S", &tensor_string);
+  relu_2.MutableInputDefs()[0] = &s;
+  graph.SetGraphResolveNeeded();
+  EXPECT_FALSE(graph.Resolve().IsOK());
+}
+// the values of Constant nodes become initializers, and the attributes of the other nodes are kept, when loading
+TEST(ResolvingGraphTest, LoadConstantAsInitializer) {
+  ModelProto model_proto;
+  model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  model_proto.add_opset_import()->set_version(9);
+  auto* graph_proto = model_proto.mutable_graph();
+  graph_proto->set_name("graph_1");
+
+  auto* constant = graph_proto->add_node();
+  constant->set_op_type("Constant");
+  constant->add_output("C");
+  auto* value = constant->add_attribute();
+  value->set_name("value");
+  value->set_type(AttributeProto_AttributeType_TENSOR);
+  value->mutable_t()->set_data_type(TensorProto_DataType_FLOAT);
+  value->mutable_t()->add_dims(4);
+  const std::vector<float> data{1.f, 2.f, 3.f, 4.f};
+  value->mutable_t()->set_raw_data(data.data(), data.size() * sizeof(float));
+
+  auto* transpose = graph_proto->add_node();
+  transpose->set_op_type("Transpose");
+  transpose->add_input("C");
+  transpose->add_output("Y");
+  auto* perm = transpose->add_attribute();
+  perm->set_name("perm");
+  perm->set_type(AttributeProto_AttributeType_INTS);
+  perm->add_ints(0);
+
+  auto* output = graph_proto->add_output();
+  output->set_name("Y");
+  output->mutable_type()->mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  std::shared_ptr<Model> model;
+  auto status = Model::Load(model_proto, model);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  const auto& graph = model->MainGraph();
+  EXPECT_EQ(graph.NumberOfNodes(), 1);
+
+  const TensorProto* initializer = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("C", initializer));
+  ASSERT_EQ(initializer->raw_data().size(), data.size() * sizeof(float));
+  EXPECT_EQ(std::memcmp(initializer->raw_data().data(), data.data(), initializer->raw_data().size()), 0);
+
+  const auto& loaded_transpose = *graph.Nodes().begin();
+  ASSERT_EQ(loaded_transpose.GetAttributes().count("perm"), 1u);
+  EXPECT_EQ(loaded_transpose.GetAttributes().at("perm").ints_size(), 1);
+}
+
+// replacing an initializer with one of the same name, as transformers like ConvBNFusion do, has its consumers
+// inferred again on Resolve, wherever the replacement is allocated
+TEST(ResolvingGraphTest, ResolveInfersConsumersOfReplacedInitializer) {
+  Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("size");
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+
+  auto make_shape = [](int64_t dim0, int64_t dim1) {
+    TensorProto shape;
+    shape.set_name("shape");
+    shape.set_data_type(TensorProto_DataType_INT64);
+    shape.add_dims(2);
+    shape.add_int64_data(dim0);
+    shape.add_int64_data(dim1);
+    return shape;
+  };
+  // the first dimension is inferred from the size of X, which is unknown
+  graph.AddInitializedTensor(make_shape(-1, 4));
+  auto& shape = *graph.GetNodeArg("shape");
+  graph.AddNode("reshape", "Reshape", "", {&x, &shape}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_NE(y.Shape(), nullptr);
+  ASSERT_EQ(y.Shape()->dim_size(), 2);
+  EXPECT_FALSE(y.Shape()->dim(0).has_dim_value());
+
+  graph.RemoveInitializedTensor("shape");
+  graph.AddInitializedTensor(make_shape(3, 4));
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_NE(y.Shape(), nullptr);
+  EXPECT_EQ(y.Shape()->dim(0).dim_value(), 3);
+}
 }  // namespace test
 }  // namespace onnxruntime
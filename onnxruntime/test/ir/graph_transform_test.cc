@@ -5,7 +5,9 @@
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/graph_transformer.h"
+#include "core/graph/graph_transformer_mgr.h"
 #include "core/graph/identity_elimination.h"
+#include "core/graph/image_preprocess_fusion.h"
 #include "core/graph/unsqueeze_elimination.h"
 #include "core/graph/conv_bn_fusion.h"
 #include "core/graph/conv_mul_fusion.h"
@@ -13,7 +15,21 @@
 #include "core/graph/conv_activation_fusion.h"
 #include "core/graph/matmul_add_fusion.h"
 #include "core/graph/gemm_activation_fusion.h"
+#include "core/graph/transpose_optimizer.h"
+#include "core/graph/common_subexpression_elimination.h"
+#include "core/graph/layer_norm_fusion.h"
+#include "core/graph/loop_unrolling.h"
+#include "core/graph/gelu_fusion.h"
+#include "core/graph/attention_fusion.h"
+#include "core/graph/embedding_bag_fusion.h"
+#include "core/graph/feature_pipeline_fusion.h"
+#include "core/graph/qlinear_fusion.h"
+#include "core/graph/quantization_transformer.h"
+#include "core/graph/symbolic_shape_folding.h"
+#include "core/graph/initializer.h"
 #include "core/platform/env.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/session/constant_folding.h"
 
 #include "test/capturing_sink.h"
 #include "test/test_environment.h"
@@ -253,6 +269,1017 @@ TEST(GraphTransformationTests, Gemm_Relu_three_input) {
   ASSERT_TRUE(session_object.Initialize().IsOK());
 }
 
+static int CountOpType(const Graph& graph, const std::string& op_type) {
+  int count = 0;
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == op_type) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+TEST(GraphTransformationTests, DefaultTransformerLevels) {
+  string model_uri = MODEL_FOLDER + "abs-2id-max.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+  ASSERT_EQ(CountOpType(graph, "Identity"), 2);
+
+  GraphTransformerManager no_transformers{5, TransformerLevel::None};
+  ASSERT_TRUE(no_transformers.ApplyAll(graph).IsOK());
+  EXPECT_EQ(CountOpType(graph, "Identity"), 2);
+
+  GraphTransformerManager basic_transformers{5, TransformerLevel::Basic};
+  ASSERT_TRUE(basic_transformers.ApplyAll(graph).IsOK());
+  EXPECT_EQ(CountOpType(graph, "Identity"), 0);
+}
+
+// an Identity that produces a graph output must stay
+TEST(GraphTransformationTests, IdentityEliminationKeepsGraphOutput) {
+  string model_uri = MODEL_FOLDER + "abs-id.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+  const int identity_count = CountOpType(graph, "Identity");
+  ASSERT_GT(identity_count, 0);
+
+  GraphTransformerManager basic_transformers{5, TransformerLevel::Basic};
+  ASSERT_TRUE(basic_transformers.ApplyAll(graph).IsOK());
+  EXPECT_EQ(CountOpType(graph, "Identity"), identity_count);
+  EXPECT_TRUE(graph.Resolve().IsOK());
+}
+
+TEST(GraphTransformationTests, SessionGraphOptimizationLevels) {
+  string model_uri = MODEL_FOLDER + "fusion/fuse-conv-bn-mul-add-unsqueeze.onnx";
+
+  for (auto level : {TransformerLevel::None, TransformerLevel::Basic, TransformerLevel::Extended,
+                     TransformerLevel::All}) {
+    SessionOptions so;
+    so.session_logid = "GraphTransformationTests.SessionGraphOptimizationLevels";
+    so.graph_optimization_level = level;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(model_uri).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+  }
+}
+
+// Y = Reshape(MatMul(X, Transpose(W)), Shape(...)), where the Transpose of the initializer W and the Shape of the
+// statically shaped MatMul output are folded
+TEST(GraphTransformationTests, ConstantFolding) {
+  Model model("ConstantFoldingTest");
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  TypeProto w_type;
+  w_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  w_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  w_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  TensorProto w;
+  w.set_name("W");
+  w.set_data_type(TensorProto_DataType_FLOAT);
+  w.add_dims(2);
+  w.add_dims(3);
+  for (int i = 1; i <= 6; ++i) {
+    w.add_float_data(static_cast<float>(i));
+  }
+  graph.AddInitializedTensor(w);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w_arg = graph.GetOrCreateNodeArg("W", &w_type);
+  auto& w_transposed = graph.GetOrCreateNodeArg("WT", nullptr);
+  auto& product = graph.GetOrCreateNodeArg("M", nullptr);
+  auto& shape = graph.GetOrCreateNodeArg("S", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("transpose", "Transpose", "transpose the weight", {&w_arg}, {&w_transposed});
+  graph.AddNode("matmul", "MatMul", "multiply by the weight", {&x, &w_transposed}, {&product});
+  graph.AddNode("shape", "Shape", "shape of the product", {&product}, {&shape});
+  graph.AddNode("reshape", "Reshape", "reshape to the same shape", {&product, &shape}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  CPUExecutionProvider cpu_provider{CPUExecutionProviderInfo()};
+  ConstantFolding constant_folding{&DefaultLoggingManager()};
+  constant_folding.AddKernelRegistry(*cpu_provider.GetKernelRegistry());
+
+  bool modified = false;
+  ASSERT_TRUE(constant_folding.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(CountOpType(graph, "Transpose"), 0);
+  EXPECT_EQ(CountOpType(graph, "Shape"), 0);
+  EXPECT_EQ(graph.NumberOfNodes(), 2);
+
+  const TensorProto* folded = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("WT", folded));
+  Initializer folded_transpose{folded};
+  EXPECT_EQ(folded_transpose.dims(), (std::vector<int64_t>{3, 2}));
+  EXPECT_EQ(std::vector<float>(folded_transpose.data<float>(), folded_transpose.data<float>() + 6),
+            (std::vector<float>{1, 4, 2, 5, 3, 6}));
+
+  ASSERT_TRUE(graph.GetInitializedTensor("S", folded));
+  Initializer folded_shape{folded};
+  EXPECT_EQ(std::vector<int64_t>(folded_shape.data<int64_t>(), folded_shape.data<int64_t>() + 2),
+            (std::vector<int64_t>{1, 2}));
+
+  // nothing is left to fold
+  modified = false;
+  ASSERT_TRUE(constant_folding.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+}
+
+static TypeProto FloatTensorType(const std::vector<int64_t>& dims) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (auto dim : dims) {
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  return type;
+}
+
+// X -> Identity -> Identity -> Identity -> Relu -> Y. the rules revisit the consumers of what they removed, so a
+// single Apply removes the whole chain, also when another rule is registered for Identity after it
+TEST(GraphTransformationTests, RuleBasedTransformerReachesFixedPoint) {
+  Model model("RuleBasedTransformerTest");
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type = FloatTensorType({2, 3});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& id1 = graph.GetOrCreateNodeArg("id1", nullptr);
+  auto& id2 = graph.GetOrCreateNodeArg("id2", nullptr);
+  auto& id3 = graph.GetOrCreateNodeArg("id3", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("identity1", "Identity", "first identity", {&x}, {&id1});
+  graph.AddNode("identity2", "Identity", "second identity", {&id1}, {&id2});
+  graph.AddNode("identity3", "Identity", "third identity", {&id2}, {&id3});
+  graph.AddNode("relu", "Relu", "relu", {&id3}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TopDownRuleBasedTransformer rule_transformer{"RuleTransformer", "Test rule transformer"};
+  ASSERT_TRUE(rule_transformer.Register("Identity", std::make_unique<EliminateIdentity>()).IsOK());
+  ASSERT_TRUE(rule_transformer.Register("Identity", std::make_unique<EliminateUnsqueeze>()).IsOK());
+
+  bool modified = false;
+  ASSERT_TRUE(rule_transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(CountOpType(graph, "Identity"), 0);
+  ASSERT_EQ(graph.NumberOfNodes(), 1);
+  for (auto& node : graph.Nodes()) {
+    EXPECT_EQ(node.InputDefs()[0]->Name(), "X");
+    EXPECT_EQ(node.GetInputEdgesCount(), 0u);
+  }
+
+  modified = false;
+  ASSERT_TRUE(rule_transformer.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+}
+
+// NCHW -> NHWC -> Relu -> Add of a scalar -> NCHW, then two Reshapes. only the last Reshape is left after Relu and Add.
+TEST(GraphTransformationTests, TransposeOptimizer) {
+  Model model("TransposeOptimizerTest");
+  auto& graph = model.MainGraph();
+
+  TensorProto bias;
+  bias.set_name("bias");
+  bias.set_data_type(TensorProto_DataType_FLOAT);
+  bias.add_float_data(1.0f);
+  graph.AddInitializedTensor(bias);
+  TensorProto flat_shape;
+  flat_shape.set_name("flat_shape");
+  flat_shape.set_data_type(TensorProto_DataType_INT64);
+  flat_shape.add_dims(2);
+  flat_shape.add_int64_data(1);
+  flat_shape.add_int64_data(-1);
+  graph.AddInitializedTensor(flat_shape);
+  TensorProto final_shape;
+  final_shape.set_name("final_shape");
+  final_shape.set_data_type(TensorProto_DataType_INT64);
+  final_shape.add_dims(3);
+  final_shape.add_int64_data(1);
+  final_shape.add_int64_data(6);
+  final_shape.add_int64_data(4);
+  graph.AddInitializedTensor(final_shape);
+
+  TypeProto x_type = FloatTensorType({1, 2, 3, 4});
+  TypeProto bias_type = FloatTensorType({});
+  TypeProto shape_type;
+  shape_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& bias_arg = graph.GetOrCreateNodeArg("bias", &bias_type);
+  auto& flat_shape_arg = graph.GetOrCreateNodeArg("flat_shape", &shape_type);
+  auto& final_shape_arg = graph.GetOrCreateNodeArg("final_shape", &shape_type);
+  auto& nhwc = graph.GetOrCreateNodeArg("nhwc", nullptr);
+  auto& relu = graph.GetOrCreateNodeArg("relu", nullptr);
+  auto& add = graph.GetOrCreateNodeArg("add", nullptr);
+  auto& nchw = graph.GetOrCreateNodeArg("nchw", nullptr);
+  auto& flat = graph.GetOrCreateNodeArg("flat", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+
+  graph.AddNode("to_nhwc", "Transpose", "NCHW to NHWC", {&x}, {&nhwc})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  graph.AddNode("relu", "Relu", "relu in NHWC", {&nhwc}, {&relu});
+  graph.AddNode("add", "Add", "add a scalar in NHWC", {&relu, &bias_arg}, {&add});
+  graph.AddNode("to_nchw", "Transpose", "NHWC to NCHW", {&add}, {&nchw})
+      .AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  graph.AddNode("flatten", "Reshape", "flatten", {&nchw, &flat_shape_arg}, {&flat});
+  graph.AddNode("reshape", "Reshape", "reshape the flattened tensor", {&flat, &final_shape_arg}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TransposeOptimizer transpose_optimizer;
+  bool modified = false;
+  ASSERT_TRUE(transpose_optimizer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(CountOpType(graph, "Transpose"), 0);
+  EXPECT_EQ(CountOpType(graph, "Reshape"), 1);
+  EXPECT_EQ(graph.NumberOfNodes(), 3);
+
+  // Relu and Add now run in NCHW
+  const TensorShapeProto* relu_shape = graph.GetNodeArg("relu")->Shape();
+  ASSERT_NE(relu_shape, nullptr);
+  ASSERT_EQ(relu_shape->dim_size(), 4);
+  EXPECT_EQ(relu_shape->dim(1).dim_value(), 2);
+  EXPECT_EQ(relu_shape->dim(3).dim_value(), 4);
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Reshape") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "add");
+    }
+  }
+}
+
+// a Transpose of a tensor whose other consumer needs it transposed stays, and the second one reads the input
+TEST(GraphTransformationTests, TransposeOptimizerKeepsSharedTranspose) {
+  Model model("TransposeOptimizerTest");
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type = FloatTensorType({2, 3});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& transposed = graph.GetOrCreateNodeArg("XT", nullptr);
+  auto& back = graph.GetOrCreateNodeArg("XTT", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("transpose", "Transpose", "transpose", {&x}, {&transposed});
+  graph.AddNode("transpose_back", "Transpose", "transpose back", {&transposed}, {&back});
+  graph.AddNode("abs", "Abs", "abs of the transpose", {&transposed}, {&y});
+  graph.AddNode("neg", "Neg", "neg of the input", {&back}, {&z});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TransposeOptimizer transpose_optimizer;
+  bool modified = false;
+  ASSERT_TRUE(transpose_optimizer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(CountOpType(graph, "Transpose"), 1);
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Neg") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "X");
+    }
+  }
+}
+
+static NodeArg& AddInt64Initializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                                    const std::vector<int64_t>& values) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  for (auto dim : dims) {
+    tensor_proto.add_dims(dim);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  for (auto value : values) {
+    tensor_proto.add_int64_data(value);
+  }
+  graph.AddInitializedTensor(tensor_proto);
+  return graph.GetOrCreateNodeArg(name, &type);
+}
+
+// Reshape(X, Concat(Unsqueeze(Gather(Shape(X), 0)), Unsqueeze(Mul(Gather(Shape(X), 1), Gather(Shape(X), 2))))),
+// which flattens the dims after the first one as exported from a model with a dynamic batch size
+static void AddFlattenChain(Graph& graph, NodeArg& x) {
+  auto& index0 = AddInt64Initializer(graph, "index0", {}, {0});
+  auto& index1 = AddInt64Initializer(graph, "index1", {}, {1});
+  auto& index2 = AddInt64Initializer(graph, "index2", {}, {2});
+  auto& shape = graph.GetOrCreateNodeArg("shape", nullptr);
+  auto& dim0 = graph.GetOrCreateNodeArg("dim0", nullptr);
+  auto& dim1 = graph.GetOrCreateNodeArg("dim1", nullptr);
+  auto& dim2 = graph.GetOrCreateNodeArg("dim2", nullptr);
+  auto& product = graph.GetOrCreateNodeArg("product", nullptr);
+  auto& dim0_vector = graph.GetOrCreateNodeArg("dim0_vector", nullptr);
+  auto& product_vector = graph.GetOrCreateNodeArg("product_vector", nullptr);
+  auto& target = graph.GetOrCreateNodeArg("target", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("shape", "Shape", "shape of X", {&x}, {&shape});
+  graph.AddNode("gather0", "Gather", "dim 0", {&shape, &index0}, {&dim0});
+  graph.AddNode("gather1", "Gather", "dim 1", {&shape, &index1}, {&dim1});
+  graph.AddNode("gather2", "Gather", "dim 2", {&shape, &index2}, {&dim2});
+  graph.AddNode("mul", "Mul", "flattened dim", {&dim1, &dim2}, {&product});
+  graph.AddNode("unsqueeze0", "Unsqueeze", "dim 0 as vector", {&dim0}, {&dim0_vector})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("unsqueeze1", "Unsqueeze", "flattened dim as vector", {&product}, {&product_vector})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("concat", "Concat", "target shape", {&dim0_vector, &product_vector}, {&target})
+      .AddAttribute("axis", int64_t{0});
+  graph.AddNode("reshape", "Reshape", "flatten", {&x, &target}, {&y});
+}
+
+static std::vector<int64_t> GetReshapeTarget(const Graph& graph) {
+  std::vector<int64_t> target;
+  for (auto& node : graph.Nodes()) {
+    const TensorProto* tensor_proto = nullptr;
+    if (node.OpType() == "Reshape" && graph.GetInitializedTensor(node.InputDefs()[1]->Name(), tensor_proto)) {
+      target.assign(tensor_proto->int64_data().cbegin(), tensor_proto->int64_data().cend());
+    }
+  }
+  return target;
+}
+
+// the batch dim of X is symbolic, so the Reshape copies it with 0, while the product of the known dims is folded
+TEST(GraphTransformationTests, SymbolicShapeFolding) {
+  Model model("SymbolicShapeFoldingTest");
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type = FloatTensorType({1, 4, 6});
+  x_type.mutable_tensor_type()->mutable_shape()->mutable_dim(0)->set_dim_param("batch");
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  AddFlattenChain(graph, x);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  SymbolicShapeFolding symbolic_shape_folding;
+  bool modified = false;
+  ASSERT_TRUE(symbolic_shape_folding.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  ASSERT_EQ(graph.NumberOfNodes(), 1);
+  EXPECT_EQ(GetReshapeTarget(graph), (std::vector<int64_t>{0, 24}));
+
+  const TensorShapeProto* y_shape = graph.GetNodeArg("Y")->Shape();
+  ASSERT_NE(y_shape, nullptr);
+  ASSERT_EQ(y_shape->dim_size(), 2);
+  EXPECT_EQ(y_shape->dim(0).dim_param(), "batch");
+  EXPECT_EQ(y_shape->dim(1).dim_value(), 24);
+}
+
+// the product of two symbolic dims is inferred with -1, and a shape of known dims is folded as it is
+TEST(GraphTransformationTests, SymbolicShapeFoldingInfersDim) {
+  for (bool is_dynamic : {true, false}) {
+    Model model("SymbolicShapeFoldingTest");
+    auto& graph = model.MainGraph();
+
+    TypeProto x_type = FloatTensorType({2, 3, 4});
+    if (is_dynamic) {
+      x_type.mutable_tensor_type()->mutable_shape()->mutable_dim(0)->set_dim_param("batch");
+      x_type.mutable_tensor_type()->mutable_shape()->mutable_dim(1)->set_dim_param("sequence");
+    }
+    auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+    AddFlattenChain(graph, x);
+    ASSERT_TRUE(graph.Resolve().IsOK());
+
+    SymbolicShapeFolding symbolic_shape_folding;
+    bool modified = false;
+    ASSERT_TRUE(symbolic_shape_folding.Apply(graph, modified).IsOK());
+    EXPECT_TRUE(modified);
+    ASSERT_EQ(graph.NumberOfNodes(), 1);
+    EXPECT_EQ(GetReshapeTarget(graph), is_dynamic ? (std::vector<int64_t>{0, -1}) : (std::vector<int64_t>{2, 12}));
+  }
+}
+
+// Add(Neg(Relu(X)), Neg(Relu(X))) + Add(RandomUniformLike(X), RandomUniformLike(X)). the Neg nodes are duplicates once
+// the Relu nodes are merged, while the random values stay distinct.
+TEST(GraphTransformationTests, CommonSubexpressionElimination) {
+  Model model("CommonSubexpressionEliminationTest");
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type = FloatTensorType({2, 3});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& relu1 = graph.GetOrCreateNodeArg("relu1", nullptr);
+  auto& relu2 = graph.GetOrCreateNodeArg("relu2", nullptr);
+  auto& neg1 = graph.GetOrCreateNodeArg("neg1", nullptr);
+  auto& neg2 = graph.GetOrCreateNodeArg("neg2", nullptr);
+  auto& random1 = graph.GetOrCreateNodeArg("random1", nullptr);
+  auto& random2 = graph.GetOrCreateNodeArg("random2", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("relu1", "Relu", "first relu", {&x}, {&relu1});
+  graph.AddNode("relu2", "Relu", "second relu", {&x}, {&relu2});
+  graph.AddNode("neg1", "Neg", "first neg", {&relu1}, {&neg1});
+  graph.AddNode("neg2", "Neg", "second neg", {&relu2}, {&neg2});
+  graph.AddNode("add", "Add", "add the negs", {&neg1, &neg2}, {&y});
+  graph.AddNode("random1", "RandomUniformLike", "first random", {&x}, {&random1});
+  graph.AddNode("random2", "RandomUniformLike", "second random", {&x}, {&random2});
+  graph.AddNode("add_random", "Add", "add the random values", {&random1, &random2}, {&z});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  CommonSubexpressionElimination cse;
+  bool modified = false;
+  ASSERT_TRUE(cse.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(CountOpType(graph, "Relu"), 1);
+  EXPECT_EQ(CountOpType(graph, "Neg"), 1);
+  EXPECT_EQ(CountOpType(graph, "RandomUniformLike"), 2);
+  for (auto& node : graph.Nodes()) {
+    if (node.Name() == "add") {
+      EXPECT_EQ(node.InputDefs()[0], node.InputDefs()[1]);
+      EXPECT_EQ(node.GetInputEdgesCount(), 2u);
+    }
+  }
+
+  modified = false;
+  ASSERT_TRUE(cse.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+}
+
+static NodeArg& AddFloatInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                                    const std::vector<float>& values) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  for (auto dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+  for (auto value : values) {
+    tensor_proto.add_float_data(value);
+  }
+  graph.AddInitializedTensor(tensor_proto);
+  TypeProto type = FloatTensorType(dims);
+  return graph.GetOrCreateNodeArg(name, &type);
+}
+
+static bool HasSingleNodeOfType(const Graph& graph, const std::string& op_type, const Node*& node) {
+  if (graph.NumberOfNodes() != 1) {
+    return false;
+  }
+  node = &*graph.Nodes().begin();
+  return node->OpType() == op_type && node->Domain() == kMSDomain;
+}
+
+// the body of a Loop that adds an initializer to its loop carried value and outputs its iteration number as float
+static GraphProto CreateAccumulatingLoopBody() {
+  Model model("LoopBody");
+  auto& graph = model.MainGraph();
+
+  TypeProto int64_type;
+  int64_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  TypeProto bool_type;
+  bool_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  TypeProto x_type = FloatTensorType({2});
+  auto& iteration = graph.GetOrCreateNodeArg("iteration", &int64_type);
+  auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_type);
+  auto& x_in = graph.GetOrCreateNodeArg("x_in", &x_type);
+  auto& step = AddFloatInitializer(graph, "step", {2}, {1.0f, 2.0f});
+  auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_type);
+  auto& x_out = graph.GetOrCreateNodeArg("x_out", &x_type);
+  auto& iteration_float = graph.GetOrCreateNodeArg("iteration_float", nullptr);
+  graph.AddNode("cond", "Identity", "pass the condition through", {&cond_in}, {&cond_out});
+  graph.AddNode("add", "Add", "accumulate", {&x_in, &step}, {&x_out});
+  graph.AddNode("cast", "Cast", "iteration as float", {&iteration}, {&iteration_float})
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.SetInputOrder({&iteration, &cond_in, &x_in});
+  graph.SetOutputOrder({&cond_out, &x_out, &iteration_float});
+  EXPECT_TRUE(graph.Resolve().IsOK());
+  return graph.ToGraphProto();
+}
+
+static void AddAccumulatingLoop(Graph& graph, int64_t trip_count) {
+  TensorProto trip_count_proto;
+  trip_count_proto.set_name("M");
+  trip_count_proto.set_data_type(TensorProto_DataType_INT64);
+  trip_count_proto.add_int64_data(trip_count);
+  graph.AddInitializedTensor(trip_count_proto);
+
+  TypeProto trip_count_type;
+  trip_count_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  TypeProto x_type = FloatTensorType({2});
+  auto& m = graph.GetOrCreateNodeArg("M", &trip_count_type);
+  auto& no_cond = graph.GetOrCreateNodeArg("", nullptr);
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& iterations = graph.GetOrCreateNodeArg("iterations", nullptr);
+  graph.AddNode("loop", "Loop", "accumulate", {&m, &no_cond, &x}, {&y, &iterations})
+      .AddAttribute("body", CreateAccumulatingLoopBody());
+}
+
+// a Loop of 3 iterations is replaced by 3 copies of its body, whose scan outputs are concatenated
+TEST(GraphTransformationTests, LoopUnrolling) {
+  Model model("LoopUnrollingTest");
+  auto& graph = model.MainGraph();
+  AddAccumulatingLoop(graph, 3);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  LoopUnrolling loop_unrolling;
+  bool modified = false;
+  ASSERT_TRUE(loop_unrolling.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(CountOpType(graph, "Loop"), 0);
+  EXPECT_EQ(CountOpType(graph, "Add"), 3);
+  EXPECT_EQ(CountOpType(graph, "Cast"), 3);
+  EXPECT_EQ(CountOpType(graph, "Unsqueeze"), 3);
+  EXPECT_EQ(CountOpType(graph, "Concat"), 1);
+
+  // each Add reads the output of the previous iteration
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Add") {
+      EXPECT_EQ(node.GetInputEdgesCount(), node.InputDefs()[0]->Name() == "X" ? 0u : 1u);
+    }
+  }
+  const TensorShapeProto* iterations_shape = graph.GetNodeArg("iterations")->Shape();
+  ASSERT_NE(iterations_shape, nullptr);
+  ASSERT_EQ(iterations_shape->dim_size(), 2);
+  EXPECT_EQ(iterations_shape->dim(0).dim_value(), 3);
+  EXPECT_EQ(iterations_shape->dim(1).dim_value(), 1);
+}
+
+TEST(GraphTransformationTests, LoopUnrollingKeepsLargeLoop) {
+  Model model("LoopUnrollingTest");
+  auto& graph = model.MainGraph();
+  AddAccumulatingLoop(graph, 3);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  // the body has 3 nodes, so 3 iterations exceed 8 nodes
+  LoopUnrolling loop_unrolling{8};
+  bool modified = false;
+  ASSERT_TRUE(loop_unrolling.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+  EXPECT_EQ(CountOpType(graph, "Loop"), 1);
+}
+
+TEST(GraphTransformationTests, LayerNormFusion) {
+  Model model("LayerNormFusionTest");
+  auto& graph = model.MainGraph();
+
+  auto& two = AddFloatInitializer(graph, "two", {}, {2.0f});
+  auto& epsilon = AddFloatInitializer(graph, "epsilon", {}, {1e-5f});
+  auto& scale = AddFloatInitializer(graph, "scale", {4}, {1.0f, 2.0f, 3.0f, 4.0f});
+  auto& bias = AddFloatInitializer(graph, "bias", {4}, {0.1f, 0.2f, 0.3f, 0.4f});
+  TypeProto x_type = FloatTensorType({2, 4});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& mean = graph.GetOrCreateNodeArg("mean", nullptr);
+  auto& deviation = graph.GetOrCreateNodeArg("deviation", nullptr);
+  auto& square = graph.GetOrCreateNodeArg("square", nullptr);
+  auto& variance = graph.GetOrCreateNodeArg("variance", nullptr);
+  auto& variance_epsilon = graph.GetOrCreateNodeArg("variance_epsilon", nullptr);
+  auto& stddev = graph.GetOrCreateNodeArg("stddev", nullptr);
+  auto& normalized = graph.GetOrCreateNodeArg("normalized", nullptr);
+  auto& scaled = graph.GetOrCreateNodeArg("scaled", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("mean", "ReduceMean", "mean", {&x}, {&mean}).AddAttribute("axes", std::vector<int64_t>{-1});
+  graph.AddNode("deviation", "Sub", "deviation", {&x, &mean}, {&deviation});
+  graph.AddNode("square", "Pow", "square", {&deviation, &two}, {&square});
+  graph.AddNode("variance", "ReduceMean", "variance", {&square}, {&variance})
+      .AddAttribute("axes", std::vector<int64_t>{-1});
+  graph.AddNode("add_epsilon", "Add", "add epsilon", {&variance, &epsilon}, {&variance_epsilon});
+  graph.AddNode("stddev", "Sqrt", "stddev", {&variance_epsilon}, {&stddev});
+  graph.AddNode("normalize", "Div", "normalize", {&deviation, &stddev}, {&normalized});
+  graph.AddNode("scale", "Mul", "scale", {&normalized, &scale}, {&scaled});
+  graph.AddNode("bias", "Add", "bias", {&scaled, &bias}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TopDownRuleBasedTransformer rule_transformer{"RuleTransformer", "Test rule transformer"};
+  ASSERT_TRUE(rule_transformer.Register("ReduceMean", std::make_unique<FuseLayerNorm>()).IsOK());
+  bool modified = false;
+  ASSERT_TRUE(rule_transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+
+  const Node* layer_norm = nullptr;
+  ASSERT_TRUE(HasSingleNodeOfType(graph, "LayerNormalization", layer_norm));
+  ASSERT_EQ(layer_norm->InputDefs().size(), 3u);
+  EXPECT_EQ(layer_norm->InputDefs()[0]->Name(), "X");
+  EXPECT_EQ(layer_norm->InputDefs()[1]->Name(), "scale");
+  EXPECT_EQ(layer_norm->InputDefs()[2]->Name(), "bias");
+  EXPECT_EQ(layer_norm->OutputDefs()[0]->Name(), "Y");
+  EXPECT_EQ(layer_norm->GetAttributes().at("epsilon").f(), 1e-5f);
+}
+
+TEST(GraphTransformationTests, GeluFusion) {
+  Model model("GeluFusionTest");
+  auto& graph = model.MainGraph();
+
+  auto& sqrt_two = AddFloatInitializer(graph, "sqrt_two", {}, {1.4142135f});
+  auto& one = AddFloatInitializer(graph, "one", {}, {1.0f});
+  auto& half = AddFloatInitializer(graph, "half", {}, {0.5f});
+  TypeProto x_type = FloatTensorType({2, 3});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& scaled = graph.GetOrCreateNodeArg("scaled", nullptr);
+  auto& erf = graph.GetOrCreateNodeArg("erf", nullptr);
+  auto& erf_one = graph.GetOrCreateNodeArg("erf_one", nullptr);
+  auto& product = graph.GetOrCreateNodeArg("product", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("scale", "Div", "scale", {&x, &sqrt_two}, {&scaled});
+  graph.AddNode("erf", "Erf", "erf", {&scaled}, {&erf});
+  graph.AddNode("add_one", "Add", "add one", {&erf, &one}, {&erf_one});
+  graph.AddNode("product", "Mul", "product", {&x, &erf_one}, {&product});
+  graph.AddNode("half", "Mul", "half", {&product, &half}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TopDownRuleBasedTransformer rule_transformer{"RuleTransformer", "Test rule transformer"};
+  ASSERT_TRUE(rule_transformer.Register("Erf", std::make_unique<FuseGelu>()).IsOK());
+  bool modified = false;
+  ASSERT_TRUE(rule_transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+
+  const Node* gelu = nullptr;
+  ASSERT_TRUE(HasSingleNodeOfType(graph, "Gelu", gelu));
+  EXPECT_EQ(gelu->InputDefs()[0]->Name(), "X");
+  EXPECT_EQ(gelu->OutputDefs()[0]->Name(), "Y");
+}
+
+TEST(GraphTransformationTests, AttentionFusion) {
+  Model model("AttentionFusionTest");
+  auto& graph = model.MainGraph();
+
+  auto& divisor = AddFloatInitializer(graph, "divisor", {}, {2.0f});
+  TypeProto q_type = FloatTensorType({2, 3, 4});
+  TypeProto k_type = FloatTensorType({2, 4, 5});
+  TypeProto v_type = FloatTensorType({2, 5, 4});
+  TypeProto mask_type = FloatTensorType({2, 1, 5});
+  auto& q = graph.GetOrCreateNodeArg("Q", &q_type);
+  auto& k = graph.GetOrCreateNodeArg("K_transposed", &k_type);
+  auto& v = graph.GetOrCreateNodeArg("V", &v_type);
+  auto& mask = graph.GetOrCreateNodeArg("mask", &mask_type);
+  auto& scores = graph.GetOrCreateNodeArg("scores", nullptr);
+  auto& scaled = graph.GetOrCreateNodeArg("scaled", nullptr);
+  auto& masked = graph.GetOrCreateNodeArg("masked", nullptr);
+  auto& probs = graph.GetOrCreateNodeArg("probs", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("scores", "MatMul", "scores", {&q, &k}, {&scores});
+  graph.AddNode("scale", "Div", "scale", {&scores, &divisor}, {&scaled});
+  graph.AddNode("mask", "Add", "mask", {&mask, &scaled}, {&masked});
+  graph.AddNode("softmax", "Softmax", "softmax", {&masked}, {&probs}).AddAttribute("axis", static_cast<int64_t>(-1));
+  graph.AddNode("output", "MatMul", "output", {&probs, &v}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TopDownRuleBasedTransformer rule_transformer{"RuleTransformer", "Test rule transformer"};
+  ASSERT_TRUE(rule_transformer.Register("Softmax", std::make_unique<FuseAttention>()).IsOK());
+  bool modified = false;
+  ASSERT_TRUE(rule_transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+
+  const Node* attention = nullptr;
+  ASSERT_TRUE(HasSingleNodeOfType(graph, "Attention", attention));
+  ASSERT_EQ(attention->InputDefs().size(), 4u);
+  EXPECT_EQ(attention->InputDefs()[0]->Name(), "Q");
+  EXPECT_EQ(attention->InputDefs()[1]->Name(), "K_transposed");
+  EXPECT_EQ(attention->InputDefs()[2]->Name(), "V");
+  EXPECT_EQ(attention->InputDefs()[3]->Name(), "mask");
+  EXPECT_EQ(attention->GetAttributes().at("scale").f(), 0.5f);
+}
+
+// Gather(table, indices) -> ReduceMean over the last axis of the indices, and a ReduceSum that keeps the dim, which is
+// left alone
+TEST(GraphTransformationTests, EmbeddingBagFusion) {
+  Model model("EmbeddingBagFusionTest");
+  auto& graph = model.MainGraph();
+
+  TypeProto table_type = FloatTensorType({100, 16});
+  TypeProto indices_type;
+  indices_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  indices_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(8);
+  indices_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  auto& table = graph.GetOrCreateNodeArg("table", &table_type);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &indices_type);
+  auto& rows = graph.GetOrCreateNodeArg("rows", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& kept_rows = graph.GetOrCreateNodeArg("kept_rows", nullptr);
+  auto& kept_y = graph.GetOrCreateNodeArg("kept_Y", nullptr);
+  graph.AddNode("gather", "Gather", "gather", {&table, &indices}, {&rows});
+  auto& mean = graph.AddNode("mean", "ReduceMean", "mean", {&rows}, {&y});
+  mean.AddAttribute("axes", std::vector<int64_t>{1});
+  mean.AddAttribute("keepdims", static_cast<int64_t>(0));
+  graph.AddNode("kept_gather", "Gather", "kept gather", {&table, &indices}, {&kept_rows});
+  graph.AddNode("kept_sum", "ReduceSum", "kept sum", {&kept_rows}, {&kept_y})
+      .AddAttribute("axes", std::vector<int64_t>{-2});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TopDownRuleBasedTransformer rule_transformer{"RuleTransformer", "Test rule transformer"};
+  ASSERT_TRUE(rule_transformer.Register("ReduceSum", std::make_unique<FuseEmbeddingBag>()).IsOK());
+  ASSERT_TRUE(rule_transformer.Register("ReduceMean", std::make_unique<FuseEmbeddingBag>()).IsOK());
+  bool modified = false;
+  ASSERT_TRUE(rule_transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+
+  ASSERT_EQ(graph.NumberOfNodes(), 3);
+  const Node* bag = nullptr;
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "EmbeddingBag") {
+      bag = &node;
+    } else {
+      EXPECT_TRUE(node.Name() == "kept_gather" || node.Name() == "kept_sum") << node.Name();
+    }
+  }
+  ASSERT_NE(bag, nullptr);
+  EXPECT_EQ(bag->Domain(), kMSDomain);
+  ASSERT_EQ(bag->InputDefs().size(), 2u);
+  EXPECT_EQ(bag->InputDefs()[0]->Name(), "table");
+  EXPECT_EQ(bag->InputDefs()[1]->Name(), "indices");
+  EXPECT_EQ(bag->OutputDefs()[0]->Name(), "Y");
+  EXPECT_EQ(bag->GetAttributes().at("mode").s(), "mean");
+}
+
+
+// Imputer -> Scaler -> Normalizer, which are fused, and a Binarizer of X alone, which is left alone
+TEST(GraphTransformationTests, FeaturePipelineFusion) {
+  Model model("FeaturePipelineFusionTest");
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type = FloatTensorType({4, 3});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& imputed = graph.GetOrCreateNodeArg("imputed", nullptr);
+  auto& scaled = graph.GetOrCreateNodeArg("scaled", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& binary = graph.GetOrCreateNodeArg("binary", nullptr);
+  auto& imputer = graph.AddNode("imputer", "Imputer", "imputer", {&x}, {&imputed}, nullptr, kMLDomain);
+  imputer.AddAttribute("imputed_value_floats", std::vector<float>{1.f, 2.f, 3.f});
+  imputer.AddAttribute("replaced_value_float", -1.f);
+  auto& scaler = graph.AddNode("scaler", "Scaler", "scaler", {&imputed}, {&scaled}, nullptr, kMLDomain);
+  scaler.AddAttribute("offset", std::vector<float>{0.5f});
+  scaler.AddAttribute("scale", std::vector<float>{2.f});
+  graph.AddNode("normalizer", "Normalizer", "normalizer", {&scaled}, {&y}, nullptr, kMLDomain)
+      .AddAttribute("norm", std::string("L2"));
+  graph.AddNode("binarizer", "Binarizer", "binarizer", {&x}, {&binary}, nullptr, kMLDomain);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TopDownRuleBasedTransformer rule_transformer{"RuleTransformer", "Test rule transformer"};
+  for (const char* op_type : {"FeatureVectorizer", "Imputer", "Scaler", "Normalizer", "Binarizer"}) {
+    ASSERT_TRUE(rule_transformer.Register(op_type, std::make_unique<FuseFeaturePipeline>()).IsOK());
+  }
+  bool modified = false;
+  ASSERT_TRUE(rule_transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  ASSERT_EQ(graph.NumberOfNodes(), 2);
+  const Node* pipeline = nullptr;
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "FeaturePipeline") {
+      pipeline = &node;
+    } else {
+      EXPECT_EQ(node.Name(), "binarizer");
+    }
+  }
+  ASSERT_NE(pipeline, nullptr);
+  EXPECT_EQ(pipeline->Domain(), kMSDomain);
+  EXPECT_EQ(pipeline->InputDefs()[0]->Name(), "X");
+  EXPECT_EQ(pipeline->OutputDefs()[0]->Name(), "Y");
+  auto& attributes = pipeline->GetAttributes();
+  ASSERT_EQ(attributes.at("steps").strings_size(), 3);
+  EXPECT_EQ(attributes.at("steps").strings(1), "Scaler");
+  EXPECT_EQ(attributes.at("norms").strings(0), "L2");
+  const std::vector<float> step_values(attributes.at("step_values").floats().begin(),
+                                       attributes.at("step_values").floats().end());
+  EXPECT_EQ(step_values, (std::vector<float>{-1.f, 1.f, 2.f, 3.f, 0.5f, 2.f}));
+  const std::vector<int64_t> counts(attributes.at("step_value_counts").ints().begin(),
+                                    attributes.at("step_value_counts").ints().end());
+  EXPECT_EQ(counts, (std::vector<int64_t>{4, 2, 0}));
+}
+
+// Cast(X) -> Sub(mean) -> Div(std) -> Transpose to NCHW -> Crop of uint8 NHWC images, which become an
+// ImagePreprocess that computes (x - mean) / std as x * (1 / std) - mean / std
+TEST(GraphTransformationTests, ImagePreprocessFusion) {
+  Model model("ImagePreprocessFusionTest");
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  for (int64_t dim : {1, 8, 8, 3}) {
+    x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& mean = AddFloatInitializer(graph, "mean", {3}, {1.f, 2.f, 3.f});
+  auto& std_dev = AddFloatInitializer(graph, "std", {1, 1, 1, 3}, {2.f, 4.f, 8.f});
+  auto& converted = graph.GetOrCreateNodeArg("converted", nullptr);
+  auto& centered = graph.GetOrCreateNodeArg("centered", nullptr);
+  auto& normalized = graph.GetOrCreateNodeArg("normalized", nullptr);
+  auto& transposed = graph.GetOrCreateNodeArg("transposed", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("cast", "Cast", "cast", {&x}, {&converted})
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.AddNode("center", "Sub", "center", {&converted, &mean}, {&centered});
+  graph.AddNode("normalize", "Div", "normalize", {&centered, &std_dev}, {&normalized});
+  graph.AddNode("transpose", "Transpose", "transpose", {&normalized}, {&transposed})
+      .AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  graph.AddNode("crop", "Crop", "crop", {&transposed}, {&y}).AddAttribute("border", std::vector<int64_t>{1, 2, 1, 2});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TopDownRuleBasedTransformer rule_transformer{"RuleTransformer", "Test rule transformer"};
+  ASSERT_TRUE(rule_transformer.Register("Cast", std::make_unique<FuseImagePreprocess>()).IsOK());
+  bool modified = false;
+  ASSERT_TRUE(rule_transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  const Node* preprocess = nullptr;
+  ASSERT_TRUE(HasSingleNodeOfType(graph, "ImagePreprocess", preprocess));
+  EXPECT_EQ(preprocess->InputDefs()[0]->Name(), "X");
+  EXPECT_EQ(preprocess->OutputDefs()[0]->Name(), "Y");
+  auto& attributes = preprocess->GetAttributes();
+  const std::vector<float> scale(attributes.at("scale").floats().begin(), attributes.at("scale").floats().end());
+  const std::vector<float> bias(attributes.at("bias").floats().begin(), attributes.at("bias").floats().end());
+  EXPECT_EQ(scale, (std::vector<float>{0.5f, 0.25f, 0.125f}));
+  EXPECT_EQ(bias, (std::vector<float>{-0.5f, -0.5f, -0.375f}));
+  const std::vector<int64_t> border(attributes.at("border").ints().begin(), attributes.at("border").ints().end());
+  EXPECT_EQ(border, (std::vector<int64_t>{1, 2, 1, 2}));
+  EXPECT_EQ(attributes.count("crop_size"), 0u);
+
+  // the channels stay where they are and the crop removes the border from H and W
+  const TensorShapeProto* y_shape = preprocess->OutputDefs()[0]->Shape();
+  ASSERT_NE(y_shape, nullptr);
+  ASSERT_EQ(y_shape->dim_size(), 4);
+  EXPECT_EQ(y_shape->dim(1).dim_value(), 3);
+  EXPECT_EQ(y_shape->dim(2).dim_value(), 4);
+  EXPECT_EQ(y_shape->dim(3).dim_value(), 6);
+}
+
+// Q(Conv(DQ(X), DQ(W), B)) and Q(MatMul(DQ(A), DQ(W))), which become a QLinearConv with a bias quantized by the
+// product of the input and weight scales and a QLinearMatMul
+TEST(GraphTransformationTests, QLinearFusion) {
+  Model model("QLinearFusionTest");
+  auto& graph = model.MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, TensorProto_DataType data_type,
+                                  const std::vector<int64_t>& dims, const std::vector<float>& values) {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(data_type);
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+    }
+    for (auto value : values) {
+      if (data_type == TensorProto_DataType_FLOAT) {
+        tensor.add_float_data(value);
+      } else {
+        tensor.add_int32_data(static_cast<int32_t>(value));
+      }
+    }
+    graph.AddInitializedTensor(tensor);
+
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(data_type);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return &graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  for (auto dim : {1, 2, 4, 4}) {
+    x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto* scale = add_initializer("scale", TensorProto_DataType_FLOAT, {}, {0.5f});
+  auto* w_scale = add_initializer("w_scale", TensorProto_DataType_FLOAT, {}, {0.25f});
+  auto* zero_point = add_initializer("zero_point", TensorProto_DataType_UINT8, {}, {128});
+  auto* w = add_initializer("W", TensorProto_DataType_UINT8, {3, 2, 1, 1}, {1, 2, 3, 4, 5, 6});
+  auto* b = add_initializer("B", TensorProto_DataType_FLOAT, {3}, {1.f, -0.5f, 0.2f});
+
+  auto& x_float = graph.GetOrCreateNodeArg("x_float", nullptr);
+  auto& w_float = graph.GetOrCreateNodeArg("w_float", nullptr);
+  auto& conv_output = graph.GetOrCreateNodeArg("conv_output", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("dequantize_x", "DequantizeLinear", "dequantize x", {&x, scale, zero_point}, {&x_float}, nullptr,
+                kMSDomain);
+  graph.AddNode("dequantize_w", "DequantizeLinear", "dequantize w", {w, w_scale, zero_point}, {&w_float}, nullptr,
+                kMSDomain);
+  graph.AddNode("conv", "Conv", "conv", {&x_float, &w_float, b}, {&conv_output})
+      .AddAttribute("kernel_shape", std::vector<int64_t>{1, 1});
+  graph.AddNode("quantize", "QuantizeLinear", "quantize y", {&conv_output, scale, zero_point}, {&y}, nullptr,
+                kMSDomain);
+
+  TypeProto a_type;
+  a_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  auto& a = graph.GetOrCreateNodeArg("A", &a_type);
+  auto* matmul_w = add_initializer("matmul_W", TensorProto_DataType_UINT8, {3, 2}, {1, 2, 3, 4, 5, 6});
+  auto& a_float = graph.GetOrCreateNodeArg("a_float", nullptr);
+  auto& matmul_w_float = graph.GetOrCreateNodeArg("matmul_w_float", nullptr);
+  auto& product = graph.GetOrCreateNodeArg("product", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("dequantize_a", "DequantizeLinear", "dequantize a", {&a, scale, zero_point}, {&a_float}, nullptr,
+                kMSDomain);
+  graph.AddNode("dequantize_matmul_w", "DequantizeLinear", "dequantize w", {matmul_w, w_scale, zero_point},
+                {&matmul_w_float}, nullptr, kMSDomain);
+  graph.AddNode("matmul", "MatMul", "matmul", {&a_float, &matmul_w_float}, {&product});
+  graph.AddNode("quantize_product", "QuantizeLinear", "quantize z", {&product, scale, zero_point}, {&z}, nullptr,
+                kMSDomain);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  TopDownRuleBasedTransformer rule_transformer{"RuleTransformer", "Test rule transformer"};
+  ASSERT_TRUE(rule_transformer.Register("QuantizeLinear", std::make_unique<FuseQLinear>()).IsOK());
+  bool modified = false;
+  ASSERT_TRUE(rule_transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  ASSERT_EQ(graph.NumberOfNodes(), 2);
+  const Node* qlinear_conv = nullptr;
+  const Node* qlinear_matmul = nullptr;
+  for (auto& node : graph.Nodes()) {
+    EXPECT_EQ(node.Domain(), kMSDomain);
+    if (node.OpType() == "QLinearConv") {
+      qlinear_conv = &node;
+    } else if (node.OpType() == "QLinearMatMul") {
+      qlinear_matmul = &node;
+    }
+  }
+  ASSERT_NE(qlinear_conv, nullptr);
+  ASSERT_NE(qlinear_matmul, nullptr);
+
+  const std::vector<std::string> conv_inputs{"X", "scale", "zero_point", "W", "w_scale", "zero_point", "scale",
+                                             "zero_point"};
+  ASSERT_EQ(qlinear_conv->InputDefs().size(), 9u);
+  for (size_t i = 0; i < conv_inputs.size(); ++i) {
+    EXPECT_EQ(qlinear_conv->InputDefs()[i]->Name(), conv_inputs[i]);
+  }
+  EXPECT_EQ(qlinear_conv->OutputDefs()[0]->Name(), "Y");
+  EXPECT_EQ(qlinear_conv->GetAttributes().at("kernel_shape").ints_size(), 2);
+
+  const TensorProto* quantized_bias = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor(qlinear_conv->InputDefs()[8]->Name(), quantized_bias));
+  ASSERT_EQ(quantized_bias->data_type(), TensorProto_DataType_INT32);
+  EXPECT_EQ(std::vector<int32_t>(quantized_bias->int32_data().begin(), quantized_bias->int32_data().end()),
+            (std::vector<int32_t>{8, -4, 2}));
+
+  ASSERT_EQ(qlinear_matmul->InputDefs().size(), 8u);
+  EXPECT_EQ(qlinear_matmul->InputDefs()[0]->Name(), "A");
+  EXPECT_EQ(qlinear_matmul->InputDefs()[3]->Name(), "matmul_W");
+  EXPECT_EQ(qlinear_matmul->OutputDefs()[0]->Name(), "Z");
+}
+
+TEST(GraphTransformationTests, QuantizationTransformer) {
+  Model model("QuantizationTransformerTest");
+  auto& graph = model.MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims,
+                                  const std::vector<float>& values) {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+    }
+    for (auto value : values) {
+      tensor.add_float_data(value);
+    }
+    graph.AddInitializedTensor(tensor);
+
+    TypeProto type = FloatTensorType(dims);
+    return &graph.GetOrCreateNodeArg(name, &type);
+  };
+  auto add_input = [&graph](const std::string& name, const std::vector<int64_t>& dims) {
+    TypeProto type = FloatTensorType(dims);
+    return &graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  // X -> Conv -> Conv -> Y, whose intermediate value stays quantized
+  auto* x = add_input("X", {1, 2, 4, 4});
+  auto* w1 = add_initializer("W1", {2, 2, 1, 1}, {1.f, -1.f, 0.5f, 2.f});
+  auto* b1 = add_initializer("B1", {2}, {0.5f, -0.5f});
+  auto* w2 = add_initializer("W2", {1, 2, 1, 1}, {1.f, 1.f});
+  auto& conv1_output = graph.GetOrCreateNodeArg("conv1_output", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("conv1", "Conv", "conv1", {x, w1, b1}, {&conv1_output});
+  graph.AddNode("conv2", "Conv", "conv2", {&conv1_output, w2}, {&y});
+
+  // Z = A * W3 + B3 with a [3, 2] weight
+  auto* a = add_input("A", {4, 3});
+  auto* w3 = add_initializer("W3", {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  auto* b3 = add_initializer("B3", {2}, {1.f, -1.f});
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("gemm", "Gemm", "gemm", {a, w3, b3}, {&z});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  QuantizationRanges ranges{{"X", {-1.f, 1.f}}, {"conv1_output", {-3.f, 3.f}}, {"Y", {-6.f, 6.f}},
+                            {"A", {0.f, 2.f}}, {"Z", {-10.f, 50.f}}};
+  QuantizationTransformer transformer(ranges);
+  bool modified = false;
+  ASSERT_TRUE(transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+
+  EXPECT_EQ(CountOpType(graph, "Conv"), 0);
+  EXPECT_EQ(CountOpType(graph, "Gemm"), 0);
+  EXPECT_EQ(CountOpType(graph, "QLinearConv"), 3);
+  EXPECT_EQ(CountOpType(graph, "Reshape"), 2);
+  // X and A are quantized and Y and Z dequantized, conv1_output is passed between the convolutions in uint8
+  EXPECT_EQ(CountOpType(graph, "QuantizeLinear"), 2);
+  EXPECT_EQ(CountOpType(graph, "DequantizeLinear"), 2);
+
+  int num_biases = 0;
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "QLinearConv" && node.InputDefs().size() > 8) {
+      const TensorProto* bias = nullptr;
+      ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[8]->Name(), bias));
+      EXPECT_EQ(bias->data_type(), TensorProto_DataType_INT32);
+      ++num_biases;
+    }
+  }
+  // the bias of conv1 and of the Gemm
+  EXPECT_EQ(num_biases, 2);
+}
 
 }  // namespace test
 }  // namespace onnxruntime
@@ -17,7 +17,10 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
+#include <type_traits>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -249,6 +252,27 @@ TrialSgemm(
             printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
         }
     }
+
+    //
+    // Repeat the operation using a prepacked matrix B.
+    //
+
+    std::vector<unsigned char> PackedBuffer(MlasSgemmPackBSize(N, K) + 64);
+    void* PackedB = (void*)(((uintptr_t)PackedBuffer.data() + 63) & ~uintptr_t(63));
+
+    MlasSgemmPackB(TransB, N, K, B, ldb, PackedB);
+
+    for (size_t f = 0; f < M * N; f++) {
+        C[f] = -0.5f;
+    }
+
+    MlasSgemmPacked(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc);
+
+    for (size_t f = 0; f < M * N; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch packed TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+        }
+    }
 }
 
 void
@@ -367,6 +391,608 @@ ExecuteSgemmTests(
     }
 }
 
+void
+ExecuteSgemmBatchTests(
+    void
+    )
+{
+    constexpr size_t MaximumBatch = 12;
+    constexpr size_t MaximumDimension = 64;
+
+    MatrixGuardBuffer BufferA(MaximumBatch * MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferB(MaximumBatch * MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferC(MaximumBatch * MaximumDimension * MaximumDimension, false);
+    MatrixGuardBuffer BufferCReference(MaximumBatch * MaximumDimension * MaximumDimension, false);
+
+    for (size_t BatchCount : { 1, 2, 5, 12 }) {
+        for (size_t M : { 1, 7, 64 }) {
+            for (size_t N : { 1, 17, 64 }) {
+                for (size_t K : { 1, 33, 64 }) {
+
+                    const float* A = BufferA.GetBuffer(BatchCount * M * K);
+                    const float* B = BufferB.GetBuffer(N * K);
+                    float* C = BufferC.GetBuffer(BatchCount * M * N);
+                    float* CReference = BufferCReference.GetBuffer(BatchCount * M * N);
+
+                    //
+                    // Share a single matrix B across the batch like a MatMul
+                    // with a broadcast operand.
+                    //
+
+                    std::vector<size_t> OffsetsA(BatchCount);
+                    std::vector<size_t> OffsetsB(BatchCount, 0);
+                    std::vector<size_t> OffsetsC(BatchCount);
+
+                    for (size_t b = 0; b < BatchCount; b++) {
+                        OffsetsA[b] = b * M * K;
+                        OffsetsC[b] = b * M * N;
+                    }
+
+                    for (size_t f = 0; f < BatchCount * M * N; f++) {
+                        C[f] = -0.5f;
+                        CReference[f] = -0.5f;
+                    }
+
+                    MlasSgemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, OffsetsA.data(),
+                        B, N, OffsetsB.data(), 0.0f, C, N, OffsetsC.data(), BatchCount);
+
+                    for (size_t b = 0; b < BatchCount; b++) {
+                        ReferenceSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A + OffsetsA[b], K,
+                            B + OffsetsB[b], N, 0.0f, CReference + OffsetsC[b], N);
+                    }
+
+                    for (size_t f = 0; f < BatchCount * M * N; f++) {
+                        if (C[f] != CReference[f]) {
+                            printf("mismatch SgemmBatch BatchCount=%zd, M=%zd, N=%zd, K=%zd!\n", BatchCount, M, N, K);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+ExecuteSgemvTests(
+    void
+    )
+{
+    constexpr size_t MaximumDimension = 700;
+
+    MatrixGuardBuffer BufferA(MaximumDimension * (MaximumDimension + 3), true);
+    MatrixGuardBuffer BufferX(MaximumDimension, true);
+    MatrixGuardBuffer BufferY(MaximumDimension, false);
+
+    std::vector<float> YReference(MaximumDimension);
+
+    for (size_t M : { 1, 3, 16, 111, 700 }) {
+        for (size_t N : { 1, 7, 64, 333, 700 }) {
+
+            //
+            // Pad the rows of matrix A to check the leading dimension.
+            //
+
+            const size_t lda = N + 3;
+
+            const float* A = BufferA.GetBuffer(M * lda);
+
+            for (CBLAS_TRANSPOSE TransA : { CblasNoTrans, CblasTrans }) {
+
+                const size_t CountX = (TransA == CblasNoTrans) ? N : M;
+                const size_t CountY = (TransA == CblasNoTrans) ? M : N;
+
+                const float* x = BufferX.GetBuffer(CountX);
+                float* y = BufferY.GetBuffer(CountY);
+
+                for (float alpha : { 1.0f, -0.5f }) {
+                    for (float beta : { 0.0f, 1.0f, 0.25f }) {
+
+                        for (size_t i = 0; i < CountY; i++) {
+                            y[i] = float(i % 5) - 2.0f;
+                        }
+
+                        for (size_t i = 0; i < CountY; i++) {
+                            double sum = 0.0;
+                            for (size_t j = 0; j < CountX; j++) {
+                                const float a = (TransA == CblasNoTrans) ? A[i * lda + j] : A[j * lda + i];
+                                sum += double(a) * double(x[j]);
+                            }
+                            YReference[i] = float(alpha * sum + (beta == 0.0f ? 0.0 : double(beta) * y[i]));
+                        }
+
+                        MlasSgemv(TransA, M, N, alpha, A, lda, x, beta, y);
+
+                        for (size_t i = 0; i < CountY; i++) {
+                            if (std::fabs(y[i] - YReference[i]) > 1e-3f * (1.0f + std::fabs(YReference[i]))) {
+                                printf("mismatch Sgemv TransA=%d, M=%zd, N=%zd, alpha=%f, beta=%f!\n",
+                                    TransA, M, N, alpha, beta);
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+ExecuteSgemmEpilogueTests(
+    void
+    )
+{
+    constexpr size_t MaximumDimension = 320;
+
+    MatrixGuardBuffer BufferA(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferB(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferAddend(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferRowBias(MaximumDimension, true);
+    MatrixGuardBuffer BufferColumnBias(MaximumDimension, true);
+    MatrixGuardBuffer BufferC(MaximumDimension * MaximumDimension, false);
+    MatrixGuardBuffer BufferCReference(MaximumDimension * MaximumDimension, false);
+
+    MLAS_ACTIVATION Activations[2];
+    Activations[0].ActivationKind = MlasReluActivation;
+    Activations[1].ActivationKind = MlasLeakyReluActivation;
+    Activations[1].alpha = 0.2f;
+
+    for (size_t M : { 1, 5, 16, 67, 160 }) {
+        for (size_t N : { 1, 9, 64, 137, 320 }) {
+            for (size_t K : { 1, 31, 128, 300 }) {
+                for (const MLAS_ACTIVATION& Activation : Activations) {
+
+                    const float* A = BufferA.GetBuffer(M * K);
+                    const float* B = BufferB.GetBuffer(K * N);
+                    const float* Addend = BufferAddend.GetBuffer(M * N);
+                    const float* RowBias = BufferRowBias.GetBuffer(M);
+                    const float* ColumnBias = BufferColumnBias.GetBuffer(N);
+                    float* C = BufferC.GetBuffer(M * N);
+                    float* CReference = BufferCReference.GetBuffer(M * N);
+
+                    //
+                    // Compute the reference with the output stage applied as
+                    // separate passes in the same order as the epilogue.
+                    //
+
+                    MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f,
+                        CReference, N);
+
+                    for (size_t m = 0; m < M; m++) {
+                        for (size_t n = 0; n < N; n++) {
+                            CReference[m * N + n] += Addend[m * N + n];
+                            CReference[m * N + n] += ColumnBias[n];
+                        }
+                    }
+
+                    MlasActivation(&Activation, CReference, RowBias, M, CReference, N, N);
+
+                    MLAS_SGEMM_EPILOGUE Epilogue = { &Activation, RowBias, ColumnBias, Addend, N };
+
+                    MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f,
+                        C, N, &Epilogue);
+
+                    for (size_t f = 0; f < M * N; f++) {
+                        if (C[f] != CReference[f]) {
+                            printf("mismatch SgemmEpilogue M=%zd, N=%zd, K=%zd!\n", M, N, K);
+                            break;
+                        }
+                    }
+
+                    //
+                    // Repeat the operation using a prepacked matrix B.
+                    //
+
+                    std::vector<unsigned char> PackedBuffer(MlasSgemmPackBSize(N, K) + 64);
+                    void* PackedB = (void*)(((uintptr_t)PackedBuffer.data() + 63) & ~uintptr_t(63));
+
+                    MlasSgemmPackB(CblasNoTrans, N, K, B, N, PackedB);
+
+                    MlasSgemmPacked(CblasNoTrans, M, N, K, 1.0f, A, K, PackedB, 0.0f, C, N,
+                        &Epilogue);
+
+                    for (size_t f = 0; f < M * N; f++) {
+                        if (C[f] != CReference[f]) {
+                            printf("mismatch packed SgemmEpilogue M=%zd, N=%zd, K=%zd!\n", M, N, K);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+ExecuteSgemmHalfTests(
+    void
+    )
+{
+    constexpr size_t MaximumDimension = 320;
+
+    MatrixGuardBuffer BufferA(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferB(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferC(MaximumDimension * MaximumDimension, false);
+    MatrixGuardBuffer BufferCReference(MaximumDimension * MaximumDimension, false);
+
+    std::vector<unsigned short> BHalf(MaximumDimension * MaximumDimension);
+    std::vector<float> BFloat(MaximumDimension * MaximumDimension);
+
+    for (size_t M : { 1, 5, 16, 67, 160 }) {
+        for (size_t N : { 1, 9, 64, 137, 320 }) {
+            for (size_t K : { 1, 31, 128, 300 }) {
+
+                const float* A = BufferA.GetBuffer(M * K);
+                const float* B = BufferB.GetBuffer(K * N);
+                float* C = BufferC.GetBuffer(M * N);
+                float* CReference = BufferCReference.GetBuffer(M * N);
+
+                //
+                // Round matrix B to half precision and compare against the
+                // single precision SGEMM using the rounded values, which must
+                // produce identical results.
+                //
+
+                MlasConvertFloatToHalfBuffer(B, BHalf.data(), K * N);
+                MlasConvertHalfToFloatBuffer(BHalf.data(), BFloat.data(), K * N);
+
+                for (CBLAS_TRANSPOSE TransB : { CblasNoTrans, CblasTrans }) {
+
+                    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+                    MlasSgemm(CblasNoTrans, TransB, M, N, K, 1.0f, A, K, BFloat.data(), ldb,
+                        0.0f, CReference, N);
+                    MlasSgemm(CblasNoTrans, TransB, M, N, K, 1.0f, A, K, BHalf.data(), ldb,
+                        0.0f, C, N);
+
+                    for (size_t f = 0; f < M * N; f++) {
+                        if (C[f] != CReference[f]) {
+                            printf("mismatch SgemmHalf TransB=%d, M=%zd, N=%zd, K=%zd!\n", TransB, M, N, K);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //
+    // Verify that every half-precision value survives a round trip through
+    // single precision and that the midpoints between adjacent values round
+    // to the even value. The values are also converted as a single buffer to
+    // cover any vectorized paths.
+    //
+
+    std::vector<unsigned short> AllHalf(0x10000);
+    std::vector<float> AllFloat(0x10000);
+
+    for (uint32_t h = 0; h < 0x10000; h++) {
+        AllHalf[h] = (unsigned short)h;
+    }
+
+    MlasConvertHalfToFloatBuffer(AllHalf.data(), AllFloat.data(), AllHalf.size());
+
+    std::vector<unsigned short> AllRoundTrip(0x10000);
+
+    MlasConvertFloatToHalfBuffer(AllFloat.data(), AllRoundTrip.data(), AllFloat.size());
+
+    for (uint32_t h = 0; h < 0x10000; h++) {
+
+        unsigned short Half = (unsigned short)h;
+        float Float;
+        unsigned short RoundTrip;
+
+        MlasConvertHalfToFloatBuffer(&Half, &Float, 1);
+        MlasConvertFloatToHalfBuffer(&Float, &RoundTrip, 1);
+
+        if (memcmp(&Float, &AllFloat[h], sizeof(float)) != 0) {
+            printf("mismatch ConvertHalfBuffer value=%04x!\n", h);
+        }
+
+        if (std::isnan(Float) ? ((RoundTrip & 0x7FFF) <= 0x7C00) : (RoundTrip != Half)) {
+            printf("mismatch ConvertHalf value=%04x!\n", h);
+        }
+
+        if (std::isnan(Float) ? ((AllRoundTrip[h] & 0x7FFF) <= 0x7C00) : (AllRoundTrip[h] != Half)) {
+            printf("mismatch ConvertFloatBuffer value=%04x!\n", h);
+        }
+
+        if ((h & 0x7FFF) < 0x7BFF) {
+
+            unsigned short NextHalf = (unsigned short)(h + 1);
+            float NextFloat;
+
+            MlasConvertHalfToFloatBuffer(&NextHalf, &NextFloat, 1);
+
+            float Midpoint = float((double(Float) + double(NextFloat)) / 2.0);
+            unsigned short Rounded;
+
+            MlasConvertFloatToHalfBuffer(&Midpoint, &Rounded, 1);
+
+            if (Rounded != (((h & 1) == 0) ? Half : NextHalf)) {
+                printf("mismatch ConvertHalf midpoint=%04x!\n", h);
+            }
+        }
+    }
+}
+
+void
+ExecuteSgemmInt8Tests(
+    void
+    )
+{
+    constexpr size_t MaximumDimension = 320;
+
+    MatrixGuardBuffer BufferA(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferC(MaximumDimension * MaximumDimension, false);
+    MatrixGuardBuffer BufferCReference(MaximumDimension * MaximumDimension, false);
+
+    std::vector<int8_t> BInt8(MaximumDimension * MaximumDimension);
+    std::vector<float> BFloat(MaximumDimension * MaximumDimension);
+    std::vector<float> ScaleB(MaximumDimension);
+
+    for (size_t M : { 1, 5, 16, 67, 160 }) {
+        for (size_t N : { 1, 9, 64, 137, 320 }) {
+            for (size_t K : { 1, 31, 128, 300 }) {
+
+                const float* A = BufferA.GetBuffer(M * K);
+                float* C = BufferC.GetBuffer(M * N);
+                float* CReference = BufferCReference.GetBuffer(M * N);
+
+                for (size_t n = 0; n < N; n++) {
+                    ScaleB[n] = float((n % 7) + 1) / 64.0f;
+                }
+
+                for (CBLAS_TRANSPOSE TransB : { CblasNoTrans, CblasTrans }) {
+
+                    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+                    //
+                    // Dequantize matrix B with the scale of each column of
+                    // matrix C and compare against the single precision SGEMM
+                    // using the dequantized values, which must produce
+                    // identical results.
+                    //
+
+                    for (size_t k = 0; k < K; k++) {
+                        for (size_t n = 0; n < N; n++) {
+                            const size_t f = (TransB == CblasNoTrans) ? k * ldb + n : n * ldb + k;
+                            BInt8[f] = int8_t(int((k * 31 + n * 17) % 255) - 127);
+                            BFloat[f] = float(BInt8[f]) * ScaleB[n];
+                        }
+                    }
+
+                    MlasSgemm(CblasNoTrans, TransB, M, N, K, 1.0f, A, K, BFloat.data(), ldb,
+                        0.0f, CReference, N);
+                    MlasSgemm(CblasNoTrans, TransB, M, N, K, 1.0f, A, K, BInt8.data(), ldb,
+                        ScaleB.data(), 0.0f, C, N);
+
+                    for (size_t f = 0; f < M * N; f++) {
+                        if (C[f] != CReference[f]) {
+                            printf("mismatch SgemmInt8 TransB=%d, M=%zd, N=%zd, K=%zd!\n", TransB, M, N, K);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+ExecuteSgemmBlockSparseTests(
+    void
+    )
+{
+    constexpr size_t MaximumDimension = 320;
+
+    MatrixGuardBuffer BufferA(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferB(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferC(MaximumDimension * MaximumDimension, false);
+    MatrixGuardBuffer BufferCReference(MaximumDimension * MaximumDimension, false);
+
+    std::vector<float> BSparse(MaximumDimension * MaximumDimension);
+    std::vector<float> Bias(MaximumDimension);
+
+    for (size_t n = 0; n < MaximumDimension; n++) {
+        Bias[n] = float(n % 5) - 2.0f;
+    }
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+
+    MLAS_SGEMM_EPILOGUE Epilogue;
+    Epilogue.Activation = &Activation;
+    Epilogue.RowBias = nullptr;
+    Epilogue.ColumnBias = Bias.data();
+    Epilogue.Addend = nullptr;
+    Epilogue.ldaddend = 0;
+
+    for (size_t M : { 1, 5, 16, 67, 160 }) {
+        for (size_t N : { 1, 9, 64, 137, 320 }) {
+            for (size_t K : { 1, 31, 128, 300 }) {
+
+                const float* A = BufferA.GetBuffer(M * K);
+                const float* B = BufferB.GetBuffer(K * N);
+                float* C = BufferC.GetBuffer(M * N);
+                float* CReference = BufferCReference.GetBuffer(M * N);
+
+                for (CBLAS_TRANSPOSE TransB : { CblasNoTrans, CblasTrans }) {
+
+                    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+                    //
+                    // Zero about two thirds of the 16x16 blocks of matrix B,
+                    // including whole strips and runs longer than a packed
+                    // panel, and compare against the dense SGEMM.
+                    //
+
+                    for (size_t k = 0; k < K; k++) {
+                        for (size_t n = 0; n < N; n++) {
+                            const size_t f = (TransB == CblasNoTrans) ? k * ldb + n : n * ldb + k;
+                            const bool IsZeroBlock = ((k / 16) * 7 + (n / 16) * 3) % 3 != 0 || (n / 16) == 2;
+                            BSparse[f] = IsZeroBlock ? 0.0f : B[f];
+                        }
+                    }
+
+                    std::vector<uint8_t> PackedBuffer(MlasSgemmPackBlockSparseBSize(TransB, N, K,
+                        BSparse.data(), ldb) + 64);
+                    void* PackedB = (void*)(((uintptr_t)PackedBuffer.data() + 63) & ~uintptr_t(63));
+
+                    MlasSgemmPackBlockSparseB(TransB, N, K, BSparse.data(), ldb, PackedB);
+
+                    for (float beta : { 0.0f, 1.0f, 0.5f }) {
+
+                        for (size_t f = 0; f < M * N; f++) {
+                            C[f] = CReference[f] = float(f % 3);
+                        }
+
+                        MlasSgemm(CblasNoTrans, TransB, M, N, K, 1.0f, A, K, BSparse.data(), ldb,
+                            beta, CReference, N);
+                        MlasSgemmBlockSparse(CblasNoTrans, M, N, K, 1.0f, A, K, PackedB, beta, C, N);
+
+                        for (size_t f = 0; f < M * N; f++) {
+                            // Sensitive to comparing positive/negative zero.
+                            if (C[f] != CReference[f] && std::fabs(C[f] - CReference[f]) > 1e-3f) {
+                                printf("mismatch SgemmBlockSparse TransB=%d, M=%zd, N=%zd, K=%zd, beta=%f!\n",
+                                    TransB, M, N, K, beta);
+                                break;
+                            }
+                        }
+                    }
+
+                    MlasSgemm(CblasNoTrans, TransB, M, N, K, 1.0f, A, K, BSparse.data(), ldb,
+                        0.0f, CReference, N, &Epilogue);
+                    MlasSgemmBlockSparse(CblasNoTrans, M, N, K, 1.0f, A, K, PackedB, 0.0f, C, N, &Epilogue);
+
+                    for (size_t f = 0; f < M * N; f++) {
+                        if (C[f] != CReference[f] && std::fabs(C[f] - CReference[f]) > 1e-3f) {
+                            printf("mismatch SgemmBlockSparse epilogue TransB=%d, M=%zd, N=%zd, K=%zd!\n",
+                                TransB, M, N, K);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<typename BType>
+void
+ReferenceQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const BType* B,
+    size_t ldb,
+    BType offb,
+    int32_t* C,
+    size_t ldc
+    )
+{
+    for (size_t m = 0; m < M; m++) {
+
+        for (size_t n = 0; n < N; n++) {
+
+            int32_t sum = 0;
+
+            for (size_t k = 0; k < K; k++) {
+                sum += (int32_t(A[m * lda + k]) - int32_t(offa)) * (int32_t(B[k * ldb + n]) - int32_t(offb));
+            }
+
+            C[m * ldc + n] = sum;
+        }
+    }
+}
+
+template<typename BType>
+void
+TrialQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    uint8_t offa,
+    BType offb
+    )
+{
+    std::vector<uint8_t> A(M * K);
+    std::vector<BType> B(K * N);
+    std::vector<int32_t> C(M * N + 1, -7);
+    std::vector<int32_t> CReference(M * N + 1, -7);
+
+    for (size_t f = 0; f < A.size(); f++) {
+        A[f] = uint8_t(f * 7 + 3);
+    }
+
+    for (size_t f = 0; f < B.size(); f++) {
+        B[f] = BType(f * 13 + 5);
+    }
+
+    MlasQgemm(M, N, K, A.data(), K, offa, B.data(), N, offb, C.data(), N);
+    ReferenceQgemm(M, N, K, A.data(), K, offa, B.data(), N, offb, CReference.data(), N);
+
+    for (size_t f = 0; f < M * N + 1; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch Qgemm(%s): M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n",
+                std::is_signed<BType>::value ? "u8s8" : "u8u8", M, N, K, int(offa), int(offb));
+            break;
+        }
+    }
+}
+
+void
+ExecuteQgemmTests(
+    void
+    )
+{
+    for (size_t M : { 1, 3, 4, 8, 9, 16, 17, 33 }) {
+        for (size_t N : { 1, 15, 16, 17, 31, 129 }) {
+            for (size_t K : { 0, 1, 2, 3, 16, 257, 600 }) {
+                TrialQgemm<uint8_t>(M, N, K, 0, 0);
+                TrialQgemm<uint8_t>(M, N, K, 128, 77);
+                TrialQgemm<uint8_t>(M, N, K, 255, 255);
+                TrialQgemm<int8_t>(M, N, K, 3, -5);
+                TrialQgemm<int8_t>(M, N, K, 255, -128);
+            }
+        }
+    }
+
+    TrialQgemm<uint8_t>(160, 300, 700, 12, 200);
+    TrialQgemm<int8_t>(300, 90, 500, 1, 127);
+
+    //
+    // Check the requantization against known values: a multiplier of 0.5 in
+    // Q31 format with a right shift of 1 scales by 0.25 with rounding half
+    // away from zero and then offsets by the zero point.
+    //
+
+    static const int32_t RequantizeInput[] = { 0, 4, -4, 6, -6, 600, -1000, 2000 };
+    static const int32_t RequantizeBias[] = { 1 };
+    static const uint8_t RequantizeExpected[] = { 100, 101, 99, 102, 98, 250, 0, 255 };
+    uint8_t RequantizeOutput[_countof(RequantizeInput)];
+
+    MlasRequantizeOutput(RequantizeInput, RequantizeOutput, nullptr, 1, _countof(RequantizeInput),
+        int32_t(1) << 30, 1, 100);
+
+    for (size_t f = 0; f < _countof(RequantizeInput); f++) {
+        if (RequantizeOutput[f] != RequantizeExpected[f]) {
+            printf("mismatch RequantizeOutput: index=%zd, output=%d, expected=%d!\n",
+                f, int(RequantizeOutput[f]), int(RequantizeExpected[f]));
+            break;
+        }
+    }
+
+    MlasRequantizeOutput(RequantizeInput, RequantizeOutput, RequantizeBias, 1, 1, int32_t(1) << 30, 0, 0);
+
+    if (RequantizeOutput[0] != 1) {
+        printf("mismatch RequantizeOutput with bias: output=%d, expected=1!\n", int(RequantizeOutput[0]));
+    }
+}
+
 void
 ReferenceConv2D(
     size_t BatchCount,
@@ -542,11 +1168,31 @@ TrialConv2D(
     float* Output = BufferOutput.GetBuffer(OutputBufferElements);
     float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
 
-    MatrixGuardBuffer BufferWorking(WorkingBufferSize, false);
+    MatrixGuardBuffer BufferWorking(WorkingBufferSize, false);
+
+    //
+    // The Winograd algorithm consumes a transformed filter.
+    //
+
+    const float* ConvFilter = Filter;
+    size_t TransformedFilterElements = 0;
+
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+        TransformedFilterElements = MlasConvWinogradGetTransformedFilterSize(2,
+            GroupCount, InputChannels, KernelShape, FilterCount);
+    }
+
+    MatrixGuardBuffer BufferTransformedFilter(TransformedFilterElements, false);
+
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+        float* TransformedFilter = BufferTransformedFilter.GetBuffer(TransformedFilterElements);
+        MlasConvWinogradTransformFilter(InputChannels, FilterCount, Filter, TransformedFilter);
+        ConvFilter = TransformedFilter;
+    }
 
     MlasConv(&Parameters,
              Input,
-             Filter,
+             ConvFilter,
              Bias,
              BufferWorking.GetBuffer(WorkingBufferSize),
              Output);
@@ -566,7 +1212,31 @@ TrialConv2D(
                     Bias,
                     OutputReference);
 
-    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+    //
+    // The Winograd transforms don't preserve the exact integer results, so
+    // compare relative to the largest possible magnitude of an output.
+    //
+
+    bool Mismatch;
+
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+
+        const float Tolerance = 1e-6f * float(InputChannels * KernelSize) * 23.0f * 23.0f;
+
+        Mismatch = false;
+
+        for (size_t i = 0; i < OutputBufferElements; i++) {
+            if (std::fabs(Output[i] - OutputReference[i]) > Tolerance) {
+                Mismatch = true;
+                break;
+            }
+        }
+
+    } else {
+        Mismatch = memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0;
+    }
+
+    if (Mismatch) {
         printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
             BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
             KernelHeight, KernelWidth);
@@ -601,6 +1271,21 @@ ExecuteConvTests(
         TrialConv2D(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
     }
 
+    for (unsigned c = 16; c <= 64; c += 16) {
+        TrialConv2D(1, 1, c, 28, 28, c, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+        TrialConv2D(3, 1, c, 19, 23, c + 8, 3, 3, 1, 0, 2, 1, 1, 1, 1, 1);
+    }
+
+    for (unsigned k = 3; k <= 5; k += 2) {
+        for (unsigned s = 1; s <= 2; s++) {
+            for (unsigned i = 1; i <= 19; i += 3) {
+                TrialConv2D(1, 32, 1, i, i + 4, 1, k, k, 0, 0, 0, 0, 1, 1, s, s);
+                TrialConv2D(2, 24, 1, i + 4, i, 1, k, k, k / 2, k / 2, k / 2, k / 2, 1, 1, s, s);
+                TrialConv2D(3, 8, 1, i, i, 1, k, k, 1, 0, k - 1, 2, 1, 1, s, s);
+            }
+        }
+    }
+
     for (unsigned ic = 0; ic < _countof(cs); ic++) {
         for (unsigned ih = 0; ih < _countof(is); ih++) {
             for (unsigned iw = 0; iw < _countof(is); iw++) {
@@ -1152,6 +1837,423 @@ ExecutePool3DTests(
     }
 }
 
+void
+TrialNchwcConv2D(
+    size_t BatchCount,
+    size_t InputChannels,
+    size_t InputHeight,
+    size_t InputWidth,
+    size_t FilterCount,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t PaddingLeftHeight,
+    size_t PaddingLeftWidth,
+    size_t PaddingRightHeight,
+    size_t PaddingRightWidth,
+    size_t DilationHeight,
+    size_t DilationWidth,
+    size_t StrideHeight,
+    size_t StrideWidth
+    )
+{
+    int64_t OutputHeight64 =
+        ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+        (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+    int64_t OutputWidth64 =
+        ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+        (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+    if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+        return;
+    }
+
+    size_t OutputHeight = size_t(OutputHeight64);
+    size_t OutputWidth = size_t(OutputWidth64);
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t NchwcInputChannels = (InputChannels + BlockSize - 1) & ~(BlockSize - 1);
+    const size_t NchwcFilterCount = (FilterCount + BlockSize - 1) & ~(BlockSize - 1);
+
+    int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t FilterShape[] = { int64_t(FilterCount), int64_t(InputChannels), int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t OutputShape[] = { int64_t(BatchCount), int64_t(FilterCount), OutputHeight64, OutputWidth64 };
+
+    int64_t NchwcInputShape[] = { int64_t(BatchCount), int64_t(NchwcInputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(NchwcFilterCount), OutputHeight64, OutputWidth64 };
+
+    int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+    int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+    int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+
+    size_t InputSize = InputHeight * InputWidth;
+    size_t KernelSize = KernelHeight * KernelWidth;
+    size_t OutputSize = OutputHeight * OutputWidth;
+
+    size_t InputBufferElements = BatchCount * InputChannels * InputSize;
+    size_t FilterBufferElements = FilterCount * InputChannels * KernelSize;
+    size_t BiasBufferElements = FilterCount;
+    size_t OutputBufferElements = BatchCount * FilterCount * OutputSize;
+
+    size_t NchwcInputBufferElements = BatchCount * NchwcInputChannels * InputSize;
+    size_t NchwcFilterBufferElements = NchwcFilterCount * NchwcInputChannels * KernelSize;
+    size_t NchwcOutputBufferElements = BatchCount * NchwcFilterCount * OutputSize;
+
+    MatrixGuardBuffer BufferInput(InputBufferElements, true);
+    MatrixGuardBuffer BufferFilter(FilterBufferElements, true);
+    MatrixGuardBuffer BufferBias(BiasBufferElements, true);
+    MatrixGuardBuffer BufferOutput(OutputBufferElements, false);
+    MatrixGuardBuffer BufferOutputReference(OutputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcInput(NchwcInputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcFilter(NchwcFilterBufferElements, false);
+    MatrixGuardBuffer BufferNchwcBias(NchwcFilterCount, false);
+    MatrixGuardBuffer BufferNchwcOutput(NchwcOutputBufferElements, false);
+
+    const float* Input = BufferInput.GetBuffer(InputBufferElements);
+    const float* Filter = BufferFilter.GetBuffer(FilterBufferElements);
+    const float* Bias = BufferBias.GetBuffer(BiasBufferElements);
+    float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+    float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputBufferElements);
+    float* NchwcFilter = BufferNchwcFilter.GetBuffer(NchwcFilterBufferElements);
+    float* NchwcBias = BufferNchwcBias.GetBuffer(NchwcFilterCount);
+    float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputBufferElements);
+
+    ReferenceConv2D(BatchCount,
+                    1,
+                    InputChannels,
+                    InputHeight, InputWidth,
+                    FilterCount,
+                    KernelHeight, KernelWidth,
+                    PaddingLeftHeight, PaddingLeftWidth,
+                    DilationHeight, DilationWidth,
+                    StrideHeight, StrideWidth,
+                    OutputHeight, OutputWidth,
+                    Input,
+                    Filter,
+                    Bias,
+                    OutputReference);
+
+    MlasReorderInput(InputShape, Input, NchwcInput);
+    MlasReorderFilter(FilterShape, Filter, NchwcFilter);
+
+    std::fill_n(NchwcBias, NchwcFilterCount, 0.0f);
+    std::copy_n(Bias, FilterCount, NchwcBias);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    MlasNchwcConv(NchwcInputShape,
+                  KernelShape,
+                  DilationShape,
+                  Padding,
+                  StrideShape,
+                  NchwcOutputShape,
+                  NchwcInput,
+                  NchwcFilter,
+                  NchwcBias,
+                  NchwcOutput,
+                  &Activation);
+
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc batch=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
+            BatchCount, InputChannels, InputHeight, InputWidth, FilterCount,
+            KernelHeight, KernelWidth);
+    }
+}
+
+void
+TrialNchwcPool2D(
+    MLAS_POOLING_KIND PoolingKind,
+    size_t BatchCount,
+    size_t InputChannels,
+    size_t InputHeight,
+    size_t InputWidth,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t PaddingLeftHeight,
+    size_t PaddingLeftWidth,
+    size_t PaddingRightHeight,
+    size_t PaddingRightWidth,
+    size_t StrideHeight,
+    size_t StrideWidth
+    )
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t NchwcChannels = (InputChannels + BlockSize - 1) & ~(BlockSize - 1);
+
+    int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+    int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+    int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), 0, 0 };
+
+    OutputShape[2] = (InputShape[2] + Padding[0] + Padding[2] - KernelShape[0]) / StrideShape[0] + 1;
+    OutputShape[3] = (InputShape[3] + Padding[1] + Padding[3] - KernelShape[1]) / StrideShape[1] + 1;
+
+    int64_t NchwcInputShape[] = { int64_t(BatchCount), int64_t(NchwcChannels), InputShape[2], InputShape[3] };
+    int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(NchwcChannels), OutputShape[2], OutputShape[3] };
+
+    size_t InputSize = size_t(InputShape[2] * InputShape[3]);
+    size_t OutputSize = size_t(OutputShape[2] * OutputShape[3]);
+
+    size_t InputBufferElements = BatchCount * InputChannels * InputSize;
+    size_t OutputBufferElements = BatchCount * InputChannels * OutputSize;
+    size_t NchwcInputBufferElements = BatchCount * NchwcChannels * InputSize;
+    size_t NchwcOutputBufferElements = BatchCount * NchwcChannels * OutputSize;
+
+    MatrixGuardBuffer BufferInput(InputBufferElements, true);
+    MatrixGuardBuffer BufferOutput(OutputBufferElements, false);
+    MatrixGuardBuffer BufferOutputReference(OutputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcInput(NchwcInputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcOutput(NchwcOutputBufferElements, false);
+
+    const float* Input = BufferInput.GetBuffer(InputBufferElements);
+    float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+    float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputBufferElements);
+    float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputBufferElements);
+
+    MlasPool(PoolingKind, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, OutputReference);
+
+    MlasReorderInput(InputShape, Input, NchwcInput);
+    MlasNchwcPool(PoolingKind, NchwcInputShape, KernelShape, nullptr, Padding, StrideShape,
+        NchwcOutputShape, NchwcInput, NchwcOutput);
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+
+    //
+    // The averages are computed as a scaled sum, so allow for rounding.
+    //
+
+    for (size_t i = 0; i < OutputBufferElements; i++) {
+        if (std::fabs(Output[i] - OutputReference[i]) > 1e-5f * (1.0f + std::fabs(OutputReference[i]))) {
+            printf("mismatch: nchwc pool kind=%d,input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+                int(PoolingKind), InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+            break;
+        }
+    }
+}
+
+void
+ExecuteNchwcTests(
+    void
+    )
+{
+    static const unsigned cs[] = { 64, 17, 8, 3 };
+    static const unsigned is[] = { 28, 11, 5, 1 };
+
+    for (unsigned ic = 0; ic < _countof(cs); ic++) {
+        for (unsigned fc = 0; fc < _countof(cs); fc++) {
+            for (unsigned ih = 0; ih < _countof(is); ih++) {
+                fprintf(stderr, "Handling nchwc %dx%dx%d\n", cs[ic], is[ih], is[ih]);
+                for (unsigned k = 1; k <= 5; k += 2) {
+                    for (unsigned p = 0; p < k; p++) {
+                        for (unsigned s = 1; s <= 2; s++) {
+                            TrialNchwcConv2D(1, cs[ic], is[ih], is[ih], cs[fc], k, k, p, p, p, p, 1, 1, s, s);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    TrialNchwcConv2D(2, 16, 20, 23, 24, 3, 3, 2, 2, 2, 2, 2, 2, 1, 1);
+    TrialNchwcConv2D(1, 16, 20, 23, 24, 3, 5, 1, 2, 0, 1, 1, 1, 2, 1);
+    TrialNchwcConv2D(1, 3, 56, 56, 64, 7, 7, 3, 3, 3, 3, 1, 1, 2, 2);
+
+    static const MLAS_POOLING_KIND kinds[] = { MlasMaximumPooling, MlasAveragePoolingExcludePad, MlasAveragePoolingIncludePad };
+
+    for (unsigned kind = 0; kind < _countof(kinds); kind++) {
+        for (unsigned ic = 0; ic < _countof(cs); ic++) {
+            for (unsigned ih = 0; ih < _countof(is); ih++) {
+                for (unsigned k = 1; k <= 3; k++) {
+                    if (k > is[ih]) break;
+                    for (unsigned p = 0; p < k; p++) {
+                        for (unsigned s = 1; s <= 2; s++) {
+                            TrialNchwcPool2D(kinds[kind], 2, cs[ic], is[ih], is[ih], k, k, p, p, p, p, s, s);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+TrialComputeUnary(
+    const char* Name,
+    void (MLASCALL *Function)(const float*, float*, size_t),
+    double (*Reference)(double),
+    float MinimumValue,
+    float MaximumValue,
+    double AbsoluteTolerance,
+    double RelativeTolerance,
+    MatrixGuardBuffer& BufferInput,
+    MatrixGuardBuffer& BufferOutput
+    )
+{
+    for (size_t N : { 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 64, 1000, 4095 }) {
+
+        float* Input = BufferInput.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
+
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = MinimumValue + (MaximumValue - MinimumValue) * float(n) / float(N);
+        }
+
+        Function(Input, Output, N);
+
+        for (size_t n = 0; n < N; n++) {
+            double Expected = Reference(Input[n]);
+            double Tolerance = AbsoluteTolerance + RelativeTolerance * std::fabs(Expected);
+            if (!(std::fabs(Output[n] - Expected) <= Tolerance)) {
+                printf("mismatch %s N=%zd x=%f (%f vs %f)!\n", Name, N, Input[n], Output[n], Expected);
+                break;
+            }
+        }
+    }
+}
+
+double
+ReferenceExp(
+    double x
+    )
+{
+    return std::exp(x);
+}
+
+double
+ReferenceErf(
+    double x
+    )
+{
+    return std::erf(x);
+}
+
+double
+ReferenceGelu(
+    double x
+    )
+{
+    return x * 0.5 * (1.0 + std::erf(x / std::sqrt(2.0)));
+}
+
+void
+TrialSoftmax(
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MatrixGuardBuffer& BufferInput,
+    MatrixGuardBuffer& BufferOutput
+    )
+{
+    const float* Input = BufferInput.GetBuffer(N * D);
+    float* Output = BufferOutput.GetBuffer(N * D);
+
+    MlasComputeSoftmax(Input, Output, N, D, LogSoftmax);
+
+    for (size_t n = 0; n < N; n++) {
+
+        const float* x = Input + n * D;
+        const float* y = Output + n * D;
+
+        double Maximum = *std::max_element(x, x + D);
+        double Sum = 0.0;
+
+        for (size_t d = 0; d < D; d++) {
+            Sum += std::exp(x[d] - Maximum);
+        }
+
+        for (size_t d = 0; d < D; d++) {
+
+            double Expected;
+
+            if (LogSoftmax) {
+                Expected = x[d] - Maximum - std::log(Sum);
+            } else {
+                Expected = std::exp(x[d] - Maximum) / Sum;
+            }
+
+            if (!(std::fabs(y[d] - Expected) <= 1e-6 + 1e-5 * std::fabs(Expected))) {
+                printf("mismatch Softmax N=%zd D=%zd LogSoftmax=%d (%f vs %f)!\n", N, D, int(LogSoftmax), y[d], Expected);
+                return;
+            }
+        }
+    }
+}
+
+void
+ExecuteComputeTests(
+    void
+    )
+{
+    MatrixGuardBuffer BufferInput(64 * 1024, false);
+    MatrixGuardBuffer BufferSoftmaxInput(64 * 1024, true);
+    MatrixGuardBuffer BufferOutput(64 * 1024, false);
+
+    TrialComputeUnary("Exp", MlasComputeExp, ReferenceExp, -87.0f, 88.0f, 0.0, 1e-6, BufferInput, BufferOutput);
+    TrialComputeUnary("Erf", MlasComputeErf, ReferenceErf, -5.0f, 5.0f, 1e-6, 0.0, BufferInput, BufferOutput);
+    TrialComputeUnary("Gelu", MlasComputeGelu, ReferenceGelu, -8.0f, 8.0f, 1e-6, 1e-6, BufferInput, BufferOutput);
+
+    for (size_t N : { 1, 3, 64 }) {
+        for (size_t D : { 1, 2, 7, 8, 16, 29, 64, 100, 1000 }) {
+            TrialSoftmax(N, D, false, BufferSoftmaxInput, BufferOutput);
+            TrialSoftmax(N, D, true, BufferSoftmaxInput, BufferOutput);
+        }
+    }
+}
+
+void
+TrialTranspose(
+    size_t BatchCount,
+    size_t M,
+    size_t N
+    )
+{
+    std::vector<uint32_t> Input(BatchCount * M * N);
+    std::vector<uint32_t> Output(BatchCount * M * N + 1, 0xFFFFFFFF);
+
+    for (size_t i = 0; i < Input.size(); i++) {
+        Input[i] = uint32_t(i);
+    }
+
+    MlasTranspose(Input.data(), Output.data(), BatchCount, M, N);
+
+    for (size_t b = 0; b < BatchCount; b++) {
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                if (Output[b * M * N + n * M + m] != Input[b * M * N + m * N + n]) {
+                    printf("mismatch Transpose BatchCount=%zd M=%zd N=%zd (%zd,%zd,%zd)!\n", BatchCount, M, N, b, m, n);
+                    return;
+                }
+            }
+        }
+    }
+
+    if (Output.back() != 0xFFFFFFFF) {
+        printf("overrun Transpose BatchCount=%zd M=%zd N=%zd!\n", BatchCount, M, N);
+    }
+}
+
+void
+ExecuteTransposeTests(
+    void
+    )
+{
+    for (size_t BatchCount : { 1, 3 }) {
+        for (size_t M : { 1, 3, 4, 15, 16, 17, 64, 100 }) {
+            for (size_t N : { 1, 2, 4, 7, 16, 33, 256 }) {
+                TrialTranspose(BatchCount, M, N);
+            }
+        }
+    }
+
+    TrialTranspose(1, 1024, 1024);
+    TrialTranspose(2, 64, 3136);
+}
+
 #if 0
 #if defined(_WIN32)
 
@@ -1239,7 +2341,17 @@ main(
     )
 {
 //    ExecuteSgemmTests();
+    ExecuteSgemmBatchTests();
+    ExecuteSgemvTests();
+    ExecuteSgemmEpilogueTests();
+    ExecuteSgemmHalfTests();
+    ExecuteSgemmInt8Tests();
+    ExecuteSgemmBlockSparseTests();
+    ExecuteQgemmTests();
     ExecuteConvTests();
+    ExecuteNchwcTests();
+    ExecuteComputeTests();
+    ExecuteTransposeTests();
 //    ExecutePool2DTests();
 //    ExecutePool3DTests();
 //    EvaluateThreadingPerformance();
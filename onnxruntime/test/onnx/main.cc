@@ -227,10 +227,9 @@ int real_main(int argc, char* argv[]) {
     }
     if (enable_trt) {
 #ifdef USE_TRT
-      OrtProviderFactoryInterface** f;
-      ORT_THROW_ON_ERROR(OrtCreateTRTExecutionProviderFactory(0, &f));
-      sf.AppendExecutionProvider(f);
-      OrtReleaseObject(f);
+      // the nodes TensorRT doesn't support fall back to CUDA
+      ORT_THROW_ON_ERROR(OrtSessionOptionsAppendExecutionProvider_TRT(sf, 0, ""));
+      ORT_THROW_ON_ERROR(OrtSessionOptionsAppendExecutionProvider_CUDA(sf, 0));
 #else
       fprintf(stderr, "TensorRT is not supported in this build");
       return -1;
@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/framework/allocator.h>
+#include <core/framework/tensor.h>
+#include <core/graph/model.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/session/inference_session.h>
+
+#include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Benchmarks of CPU kernels, each run by a session of a model of a single node so that they're measured the way a
+// model runs them. The items processed are the elements of the output.
+
+using namespace onnxruntime;
+using namespace ONNX_NAMESPACE;
+
+namespace {
+
+// an input of the node. the values of an index input are in [0, index_bound), and random floats otherwise.
+struct NodeInput {
+  std::vector<int64_t> dims;
+  int64_t index_bound = 0;
+};
+
+class SingleNodeSession {
+ public:
+  // the attributes are added to the node by set_attributes
+  Status Create(const std::string& op_type, const std::vector<NodeInput>& inputs,
+                const std::function<void(Node&)>& set_attributes) {
+    Model model(op_type);
+    auto& graph = model.MainGraph();
+
+    std::vector<NodeArg*> input_args;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      TypeProto type;
+      type.mutable_tensor_type()->set_elem_type(inputs[i].index_bound > 0 ? TensorProto_DataType_INT64
+                                                                          : TensorProto_DataType_FLOAT);
+      for (auto dim : inputs[i].dims) {
+        type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+      }
+
+      const std::string name = "input" + std::to_string(i);
+      input_args.push_back(&graph.GetOrCreateNodeArg(name, &type));
+      feeds_[name] = inputs[i].index_bound > 0 ? RandomIndices(inputs[i].dims, inputs[i].index_bound)
+                                               : RandomFloats(inputs[i].dims);
+    }
+
+    TypeProto output_type;
+    output_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    auto& output = graph.GetOrCreateNodeArg("output", &output_type);
+    output_names_.push_back(output.Name());
+
+    auto& node = graph.AddNode("node", op_type, "", input_args, {&output});
+    set_attributes(node);
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+
+    std::stringstream model_stream;
+    model.ToProto().SerializeToOstream(&model_stream);
+
+    SessionOptions so;
+    so.session_logid = op_type;
+    session_ = std::make_unique<InferenceSession>(so);
+    ORT_RETURN_IF_ERROR(session_->Load(model_stream));
+    return session_->Initialize();
+  }
+
+  Status Run() {
+    fetches_.clear();
+    return session_->Run(feeds_, output_names_, &fetches_);
+  }
+
+  int64_t OutputSize() const {
+    return fetches_.empty() ? 0 : fetches_[0].Get<Tensor>().Shape().Size();
+  }
+
+ private:
+  template <typename T>
+  MLValue NewTensor(const std::vector<int64_t>& dims, const std::function<T()>& generate) {
+    const TensorShape shape(dims);
+    auto tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<T>(), shape,
+                                           allocator_->Alloc(shape.Size() * sizeof(T)), allocator_->Info(),
+                                           allocator_);
+    T* data = tensor->template MutableData<T>();
+    for (int64_t i = 0, end = shape.Size(); i < end; ++i) {
+      data[i] = generate();
+    }
+
+    return MLValue{tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+  }
+
+  MLValue RandomFloats(const std::vector<int64_t>& dims) {
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+    return NewTensor<float>(dims, [&]() { return distribution(engine_); });
+  }
+
+  MLValue RandomIndices(const std::vector<int64_t>& dims, int64_t bound) {
+    std::uniform_int_distribution<int64_t> distribution(0, bound - 1);
+    return NewTensor<int64_t>(dims, [&]() { return distribution(engine_); });
+  }
+
+  AllocatorPtr allocator_ = std::make_shared<CPUAllocator>();
+  std::default_random_engine engine_;
+  std::unique_ptr<InferenceSession> session_;
+  NameMLValMap feeds_;
+  std::vector<std::string> output_names_;
+  std::vector<MLValue> fetches_;
+};
+
+void RunSingleNode(benchmark::State& state, const std::string& op_type, const std::vector<NodeInput>& inputs,
+                   const std::function<void(Node&)>& set_attributes = [](Node&) {}) {
+  SingleNodeSession session;
+  auto status = session.Create(op_type, inputs, set_attributes);
+  if (status.IsOK()) {
+    status = session.Run();
+  }
+
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  for (auto _ : state) {
+    status = session.Run();
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * session.OutputSize());
+}
+
+}  // namespace
+
+static void BM_Transpose(benchmark::State& state, std::vector<int64_t> dims, std::vector<int64_t> perm) {
+  RunSingleNode(state, "Transpose", {{dims}}, [&perm](Node& node) { node.AddAttribute("perm", perm); });
+}
+
+BENCHMARK_CAPTURE(BM_Transpose, NCHW_to_NHWC, {1, 64, 112, 112}, {0, 2, 3, 1})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Transpose, NHWC_to_NCHW, {1, 112, 112, 64}, {0, 3, 1, 2})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Transpose, matrix, {1024, 1024}, {1, 0})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Transpose, attention_heads, {8, 128, 12, 64}, {0, 2, 1, 3})->Unit(benchmark::kMicrosecond);
+
+// args: number of inputs, axis. the inputs are 1x64x56x56.
+static void BM_Concat(benchmark::State& state) {
+  const std::vector<NodeInput> inputs(static_cast<size_t>(state.range(0)), NodeInput{{1, 64, 56, 56}});
+  const int64_t axis = state.range(1);
+  RunSingleNode(state, "Concat", inputs, [axis](Node& node) { node.AddAttribute("axis", axis); });
+}
+
+BENCHMARK(BM_Concat)->Args({2, 1})->Args({4, 1})->Args({2, 3})->Args({8, 0})->Unit(benchmark::kMicrosecond);
+
+// args: number of rows of the data, width of a row, number of indices. gathers rows, as an embedding lookup does.
+static void BM_Gather(benchmark::State& state) {
+  const int64_t rows = state.range(0);
+  RunSingleNode(state, "Gather", {{{rows, state.range(1)}}, {{state.range(2)}, rows}},
+                [](Node& node) { node.AddAttribute("axis", int64_t{0}); });
+}
+
+BENCHMARK(BM_Gather)->Args({30522, 768, 128})->Args({30522, 768, 4096})->Args({1000, 64, 1})->Unit(
+    benchmark::kMicrosecond);
+
+// args: rows, columns. the softmax of each row.
+static void BM_Softmax(benchmark::State& state) {
+  RunSingleNode(state, "Softmax", {{{state.range(0), state.range(1)}}},
+                [](Node& node) { node.AddAttribute("axis", int64_t{1}); });
+}
+
+BENCHMARK(BM_Softmax)->Args({1, 1000})->Args({128, 128})->Args({1536, 128})->Args({128, 30522})->Unit(
+    benchmark::kMicrosecond);
+
+static void BM_Reduce(benchmark::State& state, std::string op_type, std::vector<int64_t> dims,
+                      std::vector<int64_t> axes) {
+  RunSingleNode(state, op_type, {{dims}}, [&axes](Node& node) { node.AddAttribute("axes", axes); });
+}
+
+BENCHMARK_CAPTURE(BM_Reduce, ReduceSum_inner, "ReduceSum", {256, 4096}, {1})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Reduce, ReduceSum_outer, "ReduceSum", {4096, 256}, {0})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Reduce, ReduceMean_spatial, "ReduceMean", {8, 256, 28, 28}, {2, 3})->Unit(
+    benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Reduce, ReduceMax_inner, "ReduceMax", {256, 4096}, {1})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Reduce, ReduceMin_inner, "ReduceMin", {256, 4096}, {1})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Reduce, ReduceProd_inner, "ReduceProd", {256, 4096}, {1})->Unit(benchmark::kMicrosecond);
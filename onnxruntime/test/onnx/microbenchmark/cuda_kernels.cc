@@ -0,0 +1,575 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <cuda_fp16.h>
+#include <cuda_runtime.h>
+#include <cudnn.h>
+
+#include <core/common/common.h>
+#include <core/providers/cuda/math/binary_elementwise_ops_impl.h>
+#include <core/providers/cuda/reduction/reduction_impl.h>
+#include <core/providers/cuda/tensor/gather_impl.h>
+#include <core/providers/cuda/tensor/transpose_impl.h>
+#include <core/util/math.h>
+
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Benchmarks of the CUDA kernels, each launched directly on the device buffers it reads and writes so that no copy
+// between the host and the device is measured. Every launch is timed with CUDA events, and each result reports the
+// bandwidth and the FLOPs achieved as counters, along with their percentage of the peak of the device.
+
+using namespace onnxruntime;
+using namespace onnxruntime::cuda;
+
+namespace {
+
+int Fp32CoresPerMultiprocessor(int major, int minor) {
+  switch (major) {
+    case 3:
+      return 192;
+    case 5:
+      return 128;
+    case 6:
+      return minor == 0 ? 64 : 128;
+    case 7:
+      return 64;
+    default:
+      return major >= 8 && minor > 0 ? 128 : 64;
+  }
+}
+
+// the theoretical memory bandwidth and fp32 FLOPs of the current device. 0 if its properties aren't available.
+struct DevicePeak {
+  double bytes_per_second = 0;
+  double flops = 0;
+};
+
+const DevicePeak& GetDevicePeak() {
+  static const DevicePeak peak = []() {
+    DevicePeak p;
+    int device = 0;
+    cudaDeviceProp prop;
+    if (cudaGetDevice(&device) == cudaSuccess && cudaGetDeviceProperties(&prop, device) == cudaSuccess) {
+      // the clock rates are in kHz. the memory transfers twice per clock, and each core does an FMA per clock.
+      p.bytes_per_second = 2.0 * prop.memoryClockRate * 1e3 * (prop.memoryBusWidth / 8);
+      p.flops = 2.0 * prop.clockRate * 1e3 * prop.multiProcessorCount *
+                Fp32CoresPerMultiprocessor(prop.major, prop.minor);
+    }
+    return p;
+  }();
+  return peak;
+}
+
+bool Succeeded(benchmark::State& state, cudaError_t error) {
+  if (error != cudaSuccess) {
+    state.SkipWithError(cudaGetErrorString(error));
+    return false;
+  }
+  return true;
+}
+
+bool Succeeded(benchmark::State& state, cudnnStatus_t status) {
+  if (status != CUDNN_STATUS_SUCCESS) {
+    state.SkipWithError(cudnnGetErrorString(status));
+    return false;
+  }
+  return true;
+}
+
+class DeviceBuffer {
+ public:
+  explicit DeviceBuffer(size_t bytes) {
+    if (bytes > 0) {
+      error_ = cudaMalloc(&data_, bytes);
+    }
+  }
+
+  ~DeviceBuffer() {
+    cudaFree(data_);
+  }
+
+  template <typename T>
+  T* Get() const { return static_cast<T*>(data_); }
+
+  cudaError_t Error() const { return error_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DeviceBuffer);
+
+  void* data_ = nullptr;
+  cudaError_t error_ = cudaSuccess;
+};
+
+bool Allocated(benchmark::State& state, std::initializer_list<const DeviceBuffer*> buffers) {
+  for (const auto* buffer : buffers) {
+    if (!Succeeded(state, buffer->Error())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the host representation of the elements of a device type
+template <typename T>
+struct HostType {
+  using type = T;
+  static T From(float value) { return static_cast<T>(value); }
+};
+
+template <>
+struct HostType<half> {
+  using type = uint16_t;
+  static uint16_t From(float value) { return math::floatToHalf(value); }
+};
+
+template <typename T>
+bool UploadRandom(benchmark::State& state, const DeviceBuffer& buffer, size_t count) {
+  std::default_random_engine engine;
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  std::vector<typename HostType<T>::type> values(count);
+  for (auto& value : values) {
+    value = HostType<T>::From(distribution(engine));
+  }
+  return Succeeded(state, cudaMemcpy(buffer.Get<void>(), values.data(), count * sizeof(T), cudaMemcpyHostToDevice));
+}
+
+template <typename T>
+bool Upload(benchmark::State& state, const DeviceBuffer& buffer, const std::vector<T>& values) {
+  return Succeeded(state, cudaMemcpy(buffer.Get<void>(), values.data(), values.size() * sizeof(T),
+                                     cudaMemcpyHostToDevice));
+}
+
+// times each call of launch on the default stream with CUDA events. bytes and flops are those of a single call.
+template <typename Launch>
+void TimeKernel(benchmark::State& state, const Launch& launch, double bytes, double flops) {
+  cudaEvent_t start;
+  cudaEvent_t stop;
+  if (!Succeeded(state, cudaEventCreate(&start))) {
+    return;
+  }
+  if (!Succeeded(state, cudaEventCreate(&stop))) {
+    cudaEventDestroy(start);
+    return;
+  }
+
+  // the first launch loads the module of the kernel
+  launch();
+  double seconds = 0;
+  if (Succeeded(state, cudaGetLastError()) && Succeeded(state, cudaDeviceSynchronize())) {
+    for (auto _ : state) {
+      cudaEventRecord(start, nullptr);
+      launch();
+      cudaEventRecord(stop, nullptr);
+      if (!Succeeded(state, cudaEventSynchronize(stop))) {
+        break;
+      }
+      float milliseconds = 0;
+      cudaEventElapsedTime(&milliseconds, start, stop);
+      state.SetIterationTime(milliseconds / 1e3);
+      seconds += milliseconds / 1e3;
+    }
+  }
+
+  cudaEventDestroy(start);
+  cudaEventDestroy(stop);
+
+  if (seconds <= 0) {
+    return;
+  }
+
+  // the rates of Google Benchmark are per second of CPU time, which doesn't count the time on the device
+  const DevicePeak& peak = GetDevicePeak();
+  const double iterations = static_cast<double>(state.iterations());
+  if (bytes > 0) {
+    const double bytes_per_second = bytes * iterations / seconds;
+    state.counters["GB/s"] = bytes_per_second / 1e9;
+    if (peak.bytes_per_second > 0) {
+      state.counters["bw_peak_pct"] = 100.0 * bytes_per_second / peak.bytes_per_second;
+    }
+  }
+  if (flops > 0) {
+    const double flops_per_second = flops * iterations / seconds;
+    state.counters["GFLOP/s"] = flops_per_second / 1e9;
+    if (peak.flops > 0) {
+      state.counters["fp32_peak_pct"] = 100.0 * flops_per_second / peak.flops;
+    }
+  }
+}
+
+// the element strides of a row major tensor of dims
+std::vector<int64_t> Pitches(const std::vector<int64_t>& dims) {
+  std::vector<int64_t> pitches(dims.size(), 1);
+  for (size_t i = dims.size() - 1; i > 0; --i) {
+    pitches[i - 1] = pitches[i] * dims[i];
+  }
+  return pitches;
+}
+
+}  // namespace
+
+// args: number of elements, whether B is a scalar. C = A + B.
+template <typename T>
+static void BM_CudaAdd(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  const bool scalar = state.range(1) != 0;
+  const size_t rhs_count = scalar ? 1 : count;
+
+  DeviceBuffer lhs(count * sizeof(T));
+  DeviceBuffer rhs(rhs_count * sizeof(T));
+  DeviceBuffer output(count * sizeof(T));
+  if (!Allocated(state, {&lhs, &rhs, &output}) ||
+      !UploadRandom<T>(state, lhs, count) ||
+      !UploadRandom<T>(state, rhs, rhs_count)) {
+    return;
+  }
+
+  const auto broadcast = static_cast<size_t>(scalar ? SimpleBroadcast::RightScalar : SimpleBroadcast::NoBroadcast);
+  const fast_divmod fdm_unused;
+  auto launch = [&]() {
+    Impl_Add<T>(nullptr, broadcast, nullptr, lhs.Get<T>(), nullptr, rhs.Get<T>(), nullptr, fdm_unused, fdm_unused,
+                output.Get<T>(), count);
+  };
+  TimeKernel(state, launch, static_cast<double>((2 * count + rhs_count) * sizeof(T)), static_cast<double>(count));
+}
+
+#define CUDA_ADD_ARGS Args({1 << 16, 0})->Args({1 << 24, 0})->Args({1 << 24, 1})
+
+BENCHMARK_TEMPLATE(BM_CudaAdd, float)->CUDA_ADD_ARGS->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CudaAdd, half)->CUDA_ADD_ARGS->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+#undef CUDA_ADD_ARGS
+
+// args: the 4 dims of the input, which is transposed by perm {0, 2, 1, 3} with the generic kernel, as the heads of
+// an attention are
+template <typename T>
+static void BM_CudaTranspose(benchmark::State& state) {
+  const std::vector<int64_t> dims{state.range(0), state.range(1), state.range(2), state.range(3)};
+  const std::vector<int64_t> perm{0, 2, 1, 3};
+  const size_t count = static_cast<size_t>(dims[0] * dims[1] * dims[2] * dims[3]);
+
+  std::vector<int64_t> output_dims(dims.size());
+  for (size_t i = 0; i < dims.size(); ++i) {
+    output_dims[i] = dims[perm[i]];
+  }
+  std::vector<fast_divmod> output_strides;
+  for (auto pitch : Pitches(output_dims)) {
+    output_strides.emplace_back(static_cast<int>(pitch));
+  }
+
+  DeviceBuffer input(count * sizeof(T));
+  DeviceBuffer output(count * sizeof(T));
+  DeviceBuffer input_strides_buffer(dims.size() * sizeof(int64_t));
+  DeviceBuffer perm_buffer(dims.size() * sizeof(int64_t));
+  DeviceBuffer output_strides_buffer(dims.size() * sizeof(fast_divmod));
+  if (!Allocated(state, {&input, &output, &input_strides_buffer, &perm_buffer, &output_strides_buffer}) ||
+      !UploadRandom<T>(state, input, count) ||
+      !Upload(state, input_strides_buffer, Pitches(dims)) ||
+      !Upload(state, perm_buffer, perm) ||
+      !Upload(state, output_strides_buffer, output_strides)) {
+    return;
+  }
+
+  auto launch = [&]() {
+    TransposeImpl<T>(nullptr, dims.size(), input_strides_buffer.Get<int64_t>(), perm_buffer.Get<int64_t>(),
+                     input.Get<T>(), output_strides_buffer.Get<fast_divmod>(), output.Get<T>(), count);
+  };
+  TimeKernel(state, launch, static_cast<double>(2 * count * sizeof(T)), 0);
+}
+
+#define CUDA_TRANSPOSE_ARGS Args({8, 128, 12, 64})->Args({1, 512, 16, 64})
+
+BENCHMARK_TEMPLATE(BM_CudaTranspose, float)->CUDA_TRANSPOSE_ARGS->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CudaTranspose, half)->CUDA_TRANSPOSE_ARGS->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+#undef CUDA_TRANSPOSE_ARGS
+
+// args: batch, rows and columns of the matrices transposed through shared memory, as NCHW to NHWC is
+template <typename T>
+static void BM_CudaTransposeBatched2D(benchmark::State& state) {
+  const int64_t batch_count = state.range(0);
+  const int64_t rows = state.range(1);
+  const int64_t cols = state.range(2);
+  const size_t count = static_cast<size_t>(batch_count * rows * cols);
+  if (!CanDoTransposeBatched2D(batch_count, rows, cols)) {
+    state.SkipWithError("the matrices don't fit the grid of TransposeBatched2DImpl");
+    return;
+  }
+
+  DeviceBuffer input(count * sizeof(T));
+  DeviceBuffer output(count * sizeof(T));
+  if (!Allocated(state, {&input, &output}) || !UploadRandom<T>(state, input, count)) {
+    return;
+  }
+
+  auto launch = [&]() {
+    TransposeBatched2DImpl<T>(nullptr, batch_count, rows, cols, input.Get<T>(), output.Get<T>());
+  };
+  TimeKernel(state, launch, static_cast<double>(2 * count * sizeof(T)), 0);
+}
+
+#define CUDA_TRANSPOSE_BATCHED_2D_ARGS Args({1, 64, 112 * 112})->Args({32, 256, 56 * 56})->Args({1, 4096, 4096})
+
+BENCHMARK_TEMPLATE(BM_CudaTransposeBatched2D, float)->CUDA_TRANSPOSE_BATCHED_2D_ARGS->UseManualTime()->Unit(
+    benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CudaTransposeBatched2D, half)->CUDA_TRANSPOSE_BATCHED_2D_ARGS->UseManualTime()->Unit(
+    benchmark::kMicrosecond);
+
+#undef CUDA_TRANSPOSE_BATCHED_2D_ARGS
+
+namespace {
+
+template <typename TVector>
+void GatherVectors(const int64_t* indices, const fast_divmod* div_strides, int64_t input_block_size,
+                   int64_t indices_max, const void* input, void* output, size_t N) {
+  GatherImpl(nullptr, input_block_size, indices_max, indices, div_strides, static_cast<const TVector*>(input),
+             static_cast<TVector*>(output), N);
+}
+
+}  // namespace
+
+// args: number of rows of the data, width of a row, number of indices. gathers rows, as an embedding lookup does,
+// moving them as the widest vectors that divide a row like the Gather kernel. the vector width is the label.
+template <typename T>
+static void BM_CudaGather(benchmark::State& state) {
+  const int64_t rows = state.range(0);
+  const int64_t width = state.range(1);
+  const int64_t num_indices = state.range(2);
+
+  const size_t row_bytes = static_cast<size_t>(width) * sizeof(T);
+  const size_t vector_bytes = AlignedBytes(sizeof(int4), row_bytes);
+  const int64_t block_size = static_cast<int64_t>(row_bytes / vector_bytes);
+  const size_t N = static_cast<size_t>(num_indices * block_size);
+  const std::vector<fast_divmod> div_strides{fast_divmod(static_cast<int>(N)),
+                                             fast_divmod(static_cast<int>(block_size))};
+
+  std::default_random_engine engine;
+  std::uniform_int_distribution<int64_t> distribution(0, rows - 1);
+  std::vector<int64_t> indices(static_cast<size_t>(num_indices));
+  for (auto& index : indices) {
+    index = distribution(engine);
+  }
+
+  DeviceBuffer input(static_cast<size_t>(rows) * row_bytes);
+  DeviceBuffer output(static_cast<size_t>(num_indices) * row_bytes);
+  DeviceBuffer indices_buffer(indices.size() * sizeof(int64_t));
+  DeviceBuffer div_strides_buffer(div_strides.size() * sizeof(fast_divmod));
+  if (!Allocated(state, {&input, &output, &indices_buffer, &div_strides_buffer}) ||
+      !UploadRandom<T>(state, input, static_cast<size_t>(rows * width)) ||
+      !Upload(state, indices_buffer, indices) ||
+      !Upload(state, div_strides_buffer, div_strides)) {
+    return;
+  }
+
+  auto gather = &GatherVectors<uint8_t>;
+  switch (vector_bytes) {
+    case sizeof(int4):
+      gather = &GatherVectors<int4>;
+      break;
+    case sizeof(uint64_t):
+      gather = &GatherVectors<uint64_t>;
+      break;
+    case sizeof(uint32_t):
+      gather = &GatherVectors<uint32_t>;
+      break;
+    case sizeof(uint16_t):
+      gather = &GatherVectors<uint16_t>;
+      break;
+  }
+  state.SetLabel("vector_bytes=" + std::to_string(vector_bytes));
+
+  auto launch = [&]() {
+    gather(indices_buffer.Get<int64_t>(), div_strides_buffer.Get<fast_divmod>(), rows * block_size, rows,
+           input.Get<void>(), output.Get<void>(), N);
+  };
+  TimeKernel(state, launch, static_cast<double>(num_indices * (2 * row_bytes + sizeof(int64_t))), 0);
+}
+
+#define CUDA_GATHER_ARGS Args({30522, 768, 128})->Args({30522, 768, 4096})->Args({1000, 3, 4096})
+
+BENCHMARK_TEMPLATE(BM_CudaGather, float)->CUDA_GATHER_ARGS->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CudaGather, half)->CUDA_GATHER_ARGS->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+#undef CUDA_GATHER_ARGS
+
+// args: number of rows, elements of a row. the sum of each row, which covers the reductions over the trailing axes.
+template <typename T>
+static void BM_CudaReduceRows(benchmark::State& state) {
+  const int num_rows = static_cast<int>(state.range(0));
+  const int row_size = static_cast<int>(state.range(1));
+  const size_t count = static_cast<size_t>(num_rows) * row_size;
+
+  DeviceBuffer input(count * sizeof(T));
+  DeviceBuffer output(static_cast<size_t>(num_rows) * sizeof(T));
+  DeviceBuffer buffer(ReduceRowsBufferBytes<T>(num_rows, row_size));
+  if (!Allocated(state, {&input, &output, &buffer}) || !UploadRandom<T>(state, input, count)) {
+    return;
+  }
+
+  auto launch = [&]() {
+    ReduceRowsImpl<T>(nullptr, ReductionKind::Sum, input.Get<T>(), output.Get<T>(), num_rows, row_size,
+                      buffer.Get<void>());
+  };
+  TimeKernel(state, launch, static_cast<double>((count + num_rows) * sizeof(T)), static_cast<double>(count));
+}
+
+#define CUDA_REDUCE_ROWS_ARGS Args({256, 4096})->Args({65536, 64})->Args({1, 1 << 24})
+
+BENCHMARK_TEMPLATE(BM_CudaReduceRows, float)->CUDA_REDUCE_ROWS_ARGS->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CudaReduceRows, half)->CUDA_REDUCE_ROWS_ARGS->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+#undef CUDA_REDUCE_ROWS_ARGS
+
+namespace {
+
+template <typename T>
+cudnnDataType_t CudnnDataType();
+
+template <>
+cudnnDataType_t CudnnDataType<float>() { return CUDNN_DATA_FLOAT; }
+
+template <>
+cudnnDataType_t CudnnDataType<half>() { return CUDNN_DATA_HALF; }
+
+// the default workspace limit of the CUDA execution provider
+constexpr size_t kConvWorkspaceLimit = 32 * 1024 * 1024;
+
+struct CudnnConv {
+  cudnnHandle_t handle = nullptr;
+  cudnnTensorDescriptor_t x_desc = nullptr;
+  cudnnFilterDescriptor_t w_desc = nullptr;
+  cudnnConvolutionDescriptor_t conv_desc = nullptr;
+  cudnnTensorDescriptor_t y_desc = nullptr;
+
+  ~CudnnConv() {
+    cudnnDestroyTensorDescriptor(y_desc);
+    cudnnDestroyConvolutionDescriptor(conv_desc);
+    cudnnDestroyFilterDescriptor(w_desc);
+    cudnnDestroyTensorDescriptor(x_desc);
+    if (handle != nullptr) {
+      cudnnDestroy(handle);
+    }
+  }
+};
+
+}  // namespace
+
+// args: N, C, H, W of the input, K, R of the R x R filters, stride, pad, and whether the algorithm is searched
+// exhaustively. the algorithm is chosen like the Conv kernel does, either as the first heuristic suggestion that
+// fits in its workspace limit or as the fastest one cudnnFindConvolutionForwardAlgorithmEx measures. its number is
+// the label, so a change of the choice shows next to a change of the time.
+template <typename T>
+static void BM_CudnnConv(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const int c = static_cast<int>(state.range(1));
+  const int h = static_cast<int>(state.range(2));
+  const int w = static_cast<int>(state.range(3));
+  const int k = static_cast<int>(state.range(4));
+  const int r = static_cast<int>(state.range(5));
+  const int stride = static_cast<int>(state.range(6));
+  const int pad = static_cast<int>(state.range(7));
+  const bool exhaustive = state.range(8) != 0;
+  const cudnnDataType_t data_type = CudnnDataType<T>();
+  const cudnnMathType_t math_type = std::is_same<T, half>::value ? CUDNN_TENSOR_OP_MATH : CUDNN_DEFAULT_MATH;
+
+  CudnnConv conv;
+  int out_n = 0, out_c = 0, out_h = 0, out_w = 0;
+  if (!Succeeded(state, cudnnCreate(&conv.handle)) ||
+      !Succeeded(state, cudnnCreateTensorDescriptor(&conv.x_desc)) ||
+      !Succeeded(state, cudnnCreateFilterDescriptor(&conv.w_desc)) ||
+      !Succeeded(state, cudnnCreateConvolutionDescriptor(&conv.conv_desc)) ||
+      !Succeeded(state, cudnnCreateTensorDescriptor(&conv.y_desc)) ||
+      !Succeeded(state, cudnnSetTensor4dDescriptor(conv.x_desc, CUDNN_TENSOR_NCHW, data_type, n, c, h, w)) ||
+      !Succeeded(state, cudnnSetFilter4dDescriptor(conv.w_desc, data_type, CUDNN_TENSOR_NCHW, k, c, r, r)) ||
+      !Succeeded(state, cudnnSetConvolution2dDescriptor(conv.conv_desc, pad, pad, stride, stride, 1, 1,
+                                                        CUDNN_CROSS_CORRELATION, data_type)) ||
+      !Succeeded(state, cudnnSetConvolutionMathType(conv.conv_desc, math_type)) ||
+      !Succeeded(state, cudnnGetConvolution2dForwardOutputDim(conv.conv_desc, conv.x_desc, conv.w_desc,
+                                                              &out_n, &out_c, &out_h, &out_w)) ||
+      !Succeeded(state, cudnnSetTensor4dDescriptor(conv.y_desc, CUDNN_TENSOR_NCHW, data_type,
+                                                   out_n, out_c, out_h, out_w))) {
+    return;
+  }
+
+  const size_t x_count = static_cast<size_t>(n) * c * h * w;
+  const size_t w_count = static_cast<size_t>(k) * c * r * r;
+  const size_t y_count = static_cast<size_t>(out_n) * out_c * out_h * out_w;
+  DeviceBuffer x(x_count * sizeof(T));
+  DeviceBuffer weights(w_count * sizeof(T));
+  DeviceBuffer y(y_count * sizeof(T));
+  if (!Allocated(state, {&x, &weights, &y}) ||
+      !UploadRandom<T>(state, x, x_count) ||
+      !UploadRandom<T>(state, weights, w_count)) {
+    return;
+  }
+
+  cudnnConvolutionFwdAlgoPerf_t perf;
+  perf.algo = CUDNN_CONVOLUTION_FWD_ALGO_IMPLICIT_GEMM;
+  perf.memory = 0;
+  perf.mathType = CUDNN_DEFAULT_MATH;
+  if (exhaustive) {
+    DeviceBuffer search_workspace(kConvWorkspaceLimit);
+    int algo_count = 1;
+    if (!Allocated(state, {&search_workspace}) ||
+        !Succeeded(state, cudnnFindConvolutionForwardAlgorithmEx(
+                              conv.handle, conv.x_desc, x.Get<void>(), conv.w_desc, weights.Get<void>(),
+                              conv.conv_desc, conv.y_desc, y.Get<void>(), 1, &algo_count, &perf,
+                              search_workspace.Get<void>(), kConvWorkspaceLimit))) {
+      return;
+    }
+  } else {
+    cudnnConvolutionFwdAlgoPerf_t perfs[CUDNN_CONVOLUTION_FWD_ALGO_COUNT];
+    int algo_count = 0;
+    if (!Succeeded(state, cudnnGetConvolutionForwardAlgorithm_v7(conv.handle, conv.x_desc, conv.w_desc,
+                                                                 conv.conv_desc, conv.y_desc,
+                                                                 CUDNN_CONVOLUTION_FWD_ALGO_COUNT, &algo_count,
+                                                                 perfs))) {
+      return;
+    }
+    // implicit GEMM needs no workspace, so it is used when no suggestion fits in the limit
+    for (int i = 0; i < algo_count; i++) {
+      if (perfs[i].status == CUDNN_STATUS_SUCCESS && perfs[i].memory <= kConvWorkspaceLimit) {
+        perf = perfs[i];
+        break;
+      }
+    }
+  }
+
+  DeviceBuffer workspace(perf.memory);
+  if (!Allocated(state, {&workspace}) ||
+      !Succeeded(state, cudnnSetConvolutionMathType(conv.conv_desc, perf.mathType))) {
+    return;
+  }
+  state.SetLabel("algo=" + std::to_string(static_cast<int>(perf.algo)));
+
+  // the scaling factors of half data are float
+  const float alpha = 1.0f;
+  const float beta = 0.0f;
+  cudnnStatus_t status = CUDNN_STATUS_SUCCESS;
+  auto launch = [&]() {
+    status = cudnnConvolutionForward(conv.handle, &alpha, conv.x_desc, x.Get<void>(), conv.w_desc,
+                                     weights.Get<void>(), conv.conv_desc, perf.algo, workspace.Get<void>(),
+                                     perf.memory, &beta, conv.y_desc, y.Get<void>());
+  };
+  TimeKernel(state, launch, static_cast<double>((x_count + w_count + y_count) * sizeof(T)),
+             2.0 * static_cast<double>(y_count) * c * r * r);
+  Succeeded(state, status);
+}
+
+// a 7x7 stem, a 3x3 and a 1x1 of a residual block, and a 3x3 deep in a network
+#define CUDNN_CONV_ARGS(search)                      \
+  Args({1, 3, 224, 224, 64, 7, 2, 3, search})        \
+      ->Args({32, 64, 56, 56, 64, 3, 1, 1, search})  \
+      ->Args({32, 256, 56, 56, 64, 1, 1, 0, search}) \
+      ->Args({8, 512, 14, 14, 512, 3, 1, 1, search})
+
+BENCHMARK_TEMPLATE(BM_CudnnConv, float)->CUDNN_CONV_ARGS(0)->CUDNN_CONV_ARGS(1)->UseManualTime()->Unit(
+    benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CudnnConv, half)->CUDNN_CONV_ARGS(0)->CUDNN_CONV_ARGS(1)->UseManualTime()->Unit(
+    benchmark::kMicrosecond);
+
+#undef CUDNN_CONV_ARGS
@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/mlas/inc/mlas.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Benchmarks of the MLAS routines the CPU kernels spend most of their time in. The items processed are the
+// floating point operations for GEMM and convolution and the elements otherwise.
+
+static std::vector<float> RandomBuffer(size_t size) {
+  std::default_random_engine engine;
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  std::vector<float> buffer(size);
+  for (auto& value : buffer) {
+    value = distribution(engine);
+  }
+  return buffer;
+}
+
+// args: trans_a, trans_b, M, N, K
+static void BM_MlasSgemm(benchmark::State& state) {
+  const bool trans_a = state.range(0) != 0;
+  const bool trans_b = state.range(1) != 0;
+  const auto M = static_cast<size_t>(state.range(2));
+  const auto N = static_cast<size_t>(state.range(3));
+  const auto K = static_cast<size_t>(state.range(4));
+
+  auto A = RandomBuffer(M * K);
+  auto B = RandomBuffer(K * N);
+  std::vector<float> C(M * N);
+
+  for (auto _ : state) {
+    MlasSgemm(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans, M, N, K, 1.f,
+              A.data(), trans_a ? M : K, B.data(), trans_b ? K : N, 0.f, C.data(), N);
+    benchmark::DoNotOptimize(C.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2 * M * N * K);
+}
+
+static void SgemmArgs(benchmark::internal::Benchmark* b) {
+  const std::vector<std::vector<int64_t>> shapes{
+      {1, 1024, 1024}, {64, 64, 64}, {256, 256, 256}, {1024, 1024, 1024}, {128, 4096, 1024}, {4096, 128, 1024}};
+  for (int64_t trans_a : {0, 1}) {
+    for (int64_t trans_b : {0, 1}) {
+      for (const auto& shape : shapes) {
+        b->Args({trans_a, trans_b, shape[0], shape[1], shape[2]});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_MlasSgemm)->Apply(SgemmArgs)->Unit(benchmark::kMicrosecond);
+
+// the shapes of a 2D convolution, chosen so that MlasConvPrepare selects each of its algorithms on most machines
+struct ConvShape {
+  int64_t batch;
+  int64_t channels;
+  int64_t height_width;
+  int64_t filters;
+  int64_t kernel;
+  int64_t stride;
+};
+
+static const ConvShape kConvShapes[] = {
+    {1, 64, 56, 64, 1, 1},    // pointwise: GEMM direct
+    {1, 256, 14, 512, 3, 2},  // more filters than outputs: expand then GEMM
+    {1, 32, 112, 32, 3, 2},   // many outputs: expand then GEMM segmented
+    {1, 64, 56, 64, 3, 1},    // 3x3 with unit strides: Winograd
+    {8, 64, 28, 64, 3, 1},
+};
+
+static const char* ConvAlgorithmName(MLAS_CONV_ALGORITHM algorithm) {
+  switch (algorithm) {
+    case MlasConvAlgorithmGemmDirect:
+      return "GemmDirect";
+    case MlasConvAlgorithmExpandThenGemm:
+      return "ExpandThenGemm";
+    case MlasConvAlgorithmExpandThenGemmSegmented:
+      return "ExpandThenGemmSegmented";
+    case MlasConvAlgorithmWinograd:
+      return "Winograd";
+  }
+  return "Unknown";
+}
+
+// args: index into kConvShapes
+static void BM_MlasConv(benchmark::State& state) {
+  const ConvShape& shape = kConvShapes[state.range(0)];
+  const int64_t pad = shape.kernel / 2;
+  const int64_t output_height_width = (shape.height_width + 2 * pad - shape.kernel) / shape.stride + 1;
+
+  const int64_t input_shape[] = {shape.height_width, shape.height_width};
+  const int64_t kernel_shape[] = {shape.kernel, shape.kernel};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {pad, pad, pad, pad};
+  const int64_t stride_shape[] = {shape.stride, shape.stride};
+  const int64_t output_shape[] = {output_height_width, output_height_width};
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size;
+  MlasConvPrepare(&parameters, 2, static_cast<size_t>(shape.batch), 1, static_cast<size_t>(shape.channels),
+                  input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape,
+                  static_cast<size_t>(shape.filters), &activation, &working_buffer_size);
+  state.SetLabel(ConvAlgorithmName(parameters.Algorithm));
+
+  auto input = RandomBuffer(static_cast<size_t>(shape.batch * shape.channels * shape.height_width *
+                                                shape.height_width));
+  auto filter = RandomBuffer(static_cast<size_t>(shape.filters * shape.channels * shape.kernel * shape.kernel));
+  auto bias = RandomBuffer(static_cast<size_t>(shape.filters));
+  std::vector<float> working_buffer(working_buffer_size);
+  std::vector<float> output(static_cast<size_t>(shape.batch * shape.filters * output_height_width *
+                                                output_height_width));
+
+  if (parameters.Algorithm == MlasConvAlgorithmWinograd) {
+    std::vector<float> transformed_filter(MlasConvWinogradGetTransformedFilterSize(
+        2, 1, static_cast<size_t>(shape.channels), kernel_shape, static_cast<size_t>(shape.filters)));
+    MlasConvWinogradTransformFilter(static_cast<size_t>(shape.channels), static_cast<size_t>(shape.filters),
+                                    filter.data(), transformed_filter.data());
+    filter = std::move(transformed_filter);
+  }
+
+  for (auto _ : state) {
+    MlasConv(&parameters, input.data(), filter.data(), bias.data(), working_buffer.data(), output.data());
+    benchmark::DoNotOptimize(output.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2 * shape.batch * shape.filters * output_height_width *
+                          output_height_width * shape.channels * shape.kernel * shape.kernel);
+}
+
+BENCHMARK(BM_MlasConv)->DenseRange(0, sizeof(kConvShapes) / sizeof(kConvShapes[0]) - 1)->Unit(benchmark::kMicrosecond);
+
+// args: pooling kind, channels, height and width. a 3x3 window with stride 2, as in the stem of a CNN.
+static void BM_MlasPool(benchmark::State& state) {
+  const auto kind = static_cast<MLAS_POOLING_KIND>(state.range(0));
+  const int64_t channels = state.range(1);
+  const int64_t height_width = state.range(2);
+  const int64_t output_height_width = (height_width + 2 - 3) / 2 + 1;
+
+  const int64_t input_shape[] = {1, channels, height_width, height_width};
+  const int64_t kernel_shape[] = {3, 3};
+  const int64_t padding[] = {1, 1, 1, 1};
+  const int64_t stride_shape[] = {2, 2};
+  const int64_t output_shape[] = {1, channels, output_height_width, output_height_width};
+
+  auto input = RandomBuffer(static_cast<size_t>(channels * height_width * height_width));
+  std::vector<float> output(static_cast<size_t>(channels * output_height_width * output_height_width));
+
+  for (auto _ : state) {
+    MlasPool(kind, 2, input_shape, kernel_shape, padding, stride_shape, output_shape, input.data(), output.data());
+    benchmark::DoNotOptimize(output.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(output.size()));
+}
+
+BENCHMARK(BM_MlasPool)
+    ->Args({MlasMaximumPooling, 64, 112})
+    ->Args({MlasAveragePoolingExcludePad, 64, 112})
+    ->Args({MlasAveragePoolingIncludePad, 64, 112})
+    ->Args({MlasMaximumPooling, 256, 28})
+    ->Unit(benchmark::kMicrosecond);
+
+// args: number of elements
+static void BM_MlasComputeLogistic(benchmark::State& state) {
+  const auto N = static_cast<size_t>(state.range(0));
+  auto input = RandomBuffer(N);
+  std::vector<float> output(N);
+
+  for (auto _ : state) {
+    MlasComputeLogistic(input.data(), output.data(), N);
+    benchmark::DoNotOptimize(output.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(N));
+}
+
+BENCHMARK(BM_MlasComputeLogistic)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void BM_MlasComputeTanh(benchmark::State& state) {
+  const auto N = static_cast<size_t>(state.range(0));
+  auto input = RandomBuffer(N);
+  std::vector<float> output(N);
+
+  for (auto _ : state) {
+    MlasComputeTanh(input.data(), output.data(), N);
+    benchmark::DoNotOptimize(output.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(N));
+}
+
+BENCHMARK(BM_MlasComputeTanh)->RangeMultiplier(16)->Range(64, 1 << 20);
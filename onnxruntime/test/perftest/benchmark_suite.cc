@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "benchmark_suite.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <experimental/filesystem>
+#ifdef _MSC_VER
+#include <filesystem>
+#endif
+
+#include "command_args_parser.h"
+#include "performance_runner.h"
+
+using onnxruntime::common::Status;
+
+namespace onnxruntime {
+namespace perftest {
+
+Status LoadBenchmarkSuite(const std::string& suite_file, const std::string& models_dir,
+                          const PerformanceTestConfig& base_config, std::vector<BenchmarkCase>& cases) {
+  std::ifstream suite(suite_file);
+  if (!suite) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Failed to open the benchmark suite ", suite_file);
+  }
+
+  std::string line;
+  for (int line_number = 1; std::getline(suite, line); ++line_number) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string name, model_dir, provider, executor;
+    int threads;
+    int64_t runs;
+    if (!(fields >> name)) {
+      continue;
+    }
+
+    BenchmarkCase benchmark_case{name, base_config};
+    auto& config = benchmark_case.config;
+    std::string extra;
+    if (!(fields >> model_dir >> provider >> executor >> threads >> runs) || (fields >> extra) ||
+        !CommandLineParser::ParseProviderName(provider.c_str(), config.machine_config.provider_type_name) ||
+        (executor != "sequential" && executor != "parallel") || threads < 0 || runs <= 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid case at line ", line_number, " of ", suite_file,
+                             ": ", line);
+    }
+
+    const auto model_path = std::experimental::filesystem::v1::path(models_dir) / model_dir / "model.onnx";
+    config.model_info.model_file_path = model_path.string();
+    config.run_config.test_mode = TestMode::KFixRepeatedTimesMode;
+    config.run_config.repeated_times = static_cast<size_t>(runs);
+    config.run_config.enable_sequential_execution = executor == "sequential";
+    config.run_config.session_thread_pool_size = threads;
+    config.run_config.free_dim_sweeps.clear();
+    cases.push_back(std::move(benchmark_case));
+  }
+
+  if (cases.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The benchmark suite ", suite_file, " has no cases.");
+  }
+  return Status::OK();
+}
+
+BenchmarkRecord MakeBenchmarkRecord(const std::string& name, const PerformanceResult& result) {
+  BenchmarkRecord record;
+  record.name = name;
+  if (!result.time_costs.empty()) {
+    std::vector<double> sorted_time = result.time_costs;
+    std::sort(sorted_time.begin(), sorted_time.end());
+    const size_t total = sorted_time.size();
+    record.p50_latency = sorted_time[static_cast<size_t>(total * 0.5)];
+    record.p90_latency = sorted_time[static_cast<size_t>(total * 0.9)];
+    record.p99_latency = sorted_time[static_cast<size_t>(total * 0.99)];
+    if (result.elapsed_time > 0) {
+      record.throughput = total / result.elapsed_time;
+    }
+  }
+  record.session_creation_time = result.session_creation_time;
+  record.peak_workingset_size = result.peak_workingset_size;
+  record.arena_peak_bytes = result.arena_peak_bytes;
+  return record;
+}
+
+static void WriteJsonString(std::ostream& out, const std::string& value) {
+  out << '"';
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+Status WriteBenchmarkRecords(const std::string& path, const std::vector<BenchmarkRecord>& records) {
+  std::ofstream out(path);
+  if (!out) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open ", path, " for writing.");
+  }
+
+  out.precision(9);
+  out << "[";
+  for (size_t i = 0; i < records.size(); ++i) {
+    const auto& record = records[i];
+    out << (i == 0 ? "\n" : ",\n") << "  {\"name\": ";
+    WriteJsonString(out, record.name);
+    out << ", \"p50_latency\": " << record.p50_latency
+        << ", \"p90_latency\": " << record.p90_latency
+        << ", \"p99_latency\": " << record.p99_latency
+        << ", \"throughput\": " << record.throughput
+        << ", \"session_creation_time\": " << record.session_creation_time
+        << ", \"peak_workingset_size\": " << record.peak_workingset_size
+        << ", \"arena_peak_bytes\": " << record.arena_peak_bytes << "}";
+  }
+  out << "\n]\n";
+
+  if (!out) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write ", path);
+  }
+  return Status::OK();
+}
+
+namespace {
+// reads the array of flat objects of strings and numbers that WriteBenchmarkRecords writes
+class BenchmarkRecordReader {
+ public:
+  explicit BenchmarkRecordReader(const std::string& text) : text_(text) {}
+
+  bool Read(std::vector<BenchmarkRecord>& records) {
+    if (!Accept('[')) {
+      return false;
+    }
+    if (Accept(']')) {
+      return AtEnd();
+    }
+    do {
+      BenchmarkRecord record;
+      if (!ReadRecord(record)) {
+        return false;
+      }
+      records.push_back(std::move(record));
+    } while (Accept(','));
+    return Accept(']') && AtEnd();
+  }
+
+ private:
+  bool ReadRecord(BenchmarkRecord& record) {
+    if (!Accept('{')) {
+      return false;
+    }
+    if (Accept('}')) {
+      return true;
+    }
+    do {
+      std::string key;
+      if (!ReadString(key) || !Accept(':')) {
+        return false;
+      }
+      if (key == "name") {
+        if (!ReadString(record.name)) {
+          return false;
+        }
+        continue;
+      }
+
+      double value;
+      if (!ReadNumber(value)) {
+        return false;
+      }
+      if (key == "p50_latency") {
+        record.p50_latency = value;
+      } else if (key == "p90_latency") {
+        record.p90_latency = value;
+      } else if (key == "p99_latency") {
+        record.p99_latency = value;
+      } else if (key == "throughput") {
+        record.throughput = value;
+      } else if (key == "session_creation_time") {
+        record.session_creation_time = value;
+      } else if (key == "peak_workingset_size") {
+        record.peak_workingset_size = static_cast<size_t>(value);
+      } else if (key == "arena_peak_bytes") {
+        record.arena_peak_bytes = static_cast<int64_t>(value);
+      }
+      // other keys are ignored, so that baselines with more measurements can still be read
+    } while (Accept(','));
+    return Accept('}');
+  }
+
+  bool ReadString(std::string& value) {
+    if (!Accept('"')) {
+      return false;
+    }
+    value.clear();
+    while (pos_ < text_.size() && text_[pos_] != '"') {
+      if (text_[pos_] == '\\' && pos_ + 1 < text_.size()) {
+        ++pos_;
+      }
+      value += text_[pos_++];
+    }
+    return Accept('"');
+  }
+
+  bool ReadNumber(double& value) {
+    SkipSpaces();
+    const char* start = text_.c_str() + pos_;
+    char* end;
+    value = strtod(start, &end);
+    if (end == start) {
+      return false;
+    }
+    pos_ += end - start;
+    return true;
+  }
+
+  void SkipSpaces() {
+    while (pos_ < text_.size() && isspace(static_cast<unsigned char>(text_[pos_]))) {
+      ++pos_;
+    }
+  }
+
+  bool Accept(char c) {
+    SkipSpaces();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  bool AtEnd() {
+    SkipSpaces();
+    return pos_ == text_.size();
+  }
+
+  const std::string& text_;
+  size_t pos_ = 0;
+};
+}  // namespace
+
+Status ReadBenchmarkRecords(const std::string& path, std::vector<BenchmarkRecord>& records) {
+  std::ifstream in(path);
+  if (!in) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Failed to open the benchmark results ", path);
+  }
+
+  std::stringstream text;
+  text << in.rdbuf();
+  records.clear();
+  if (!BenchmarkRecordReader(text.str()).Read(records)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid benchmark results in ", path);
+  }
+  return Status::OK();
+}
+
+size_t CompareBenchmarkRecords(const std::vector<BenchmarkRecord>& records,
+                               const std::vector<BenchmarkRecord>& baseline,
+                               double tolerance,
+                               std::ostream& out) {
+  size_t num_regressions = 0;
+  for (const auto& expected : baseline) {
+    auto record = std::find_if(records.begin(), records.end(),
+                               [&expected](const BenchmarkRecord& r) { return r.name == expected.name; });
+    if (record == records.end()) {
+      out << expected.name << ": missing from the results" << std::endl;
+      ++num_regressions;
+      continue;
+    }
+
+    // the measurements that regress when they grow, and the throughput, which regresses when it falls
+    const std::pair<const char*, std::pair<double, double>> costs[] = {
+        {"p50_latency", {record->p50_latency, expected.p50_latency}},
+        {"p90_latency", {record->p90_latency, expected.p90_latency}},
+        {"p99_latency", {record->p99_latency, expected.p99_latency}},
+        {"session_creation_time", {record->session_creation_time, expected.session_creation_time}},
+        {"arena_peak_bytes",
+         {static_cast<double>(record->arena_peak_bytes), static_cast<double>(expected.arena_peak_bytes)}}};
+    for (const auto& cost : costs) {
+      if (cost.second.first > cost.second.second * (1 + tolerance)) {
+        out << expected.name << ": " << cost.first << " regressed from " << cost.second.second << " to "
+            << cost.second.first << std::endl;
+        ++num_regressions;
+      }
+    }
+    if (record->throughput < expected.throughput * (1 - tolerance)) {
+      out << expected.name << ": throughput regressed from " << expected.throughput << " to " << record->throughput
+          << std::endl;
+      ++num_regressions;
+    }
+
+    out << expected.name << ": peak working set " << record->peak_workingset_size << " bytes, baseline "
+        << expected.peak_workingset_size << " bytes" << std::endl;
+  }
+  return num_regressions;
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
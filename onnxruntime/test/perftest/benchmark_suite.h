@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <core/common/status.h>
+
+#include "test_configuration.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+struct PerformanceResult;
+
+/**
+  * A model of a benchmark suite under one configuration.
+  *
+  * A suite file has a case per line, with '#' starting a comment:
+  *   name model_dir provider executor threads runs
+  * e.g.
+  *   cnn_parallel cnn cpu parallel 4 200
+  * model_dir is relative to the models directory of the suite, and holds a model.onnx and the test data sets of
+  * the directory tree of onnx_test_runner. provider is cpu, cuda or mkldnn, executor sequential or parallel, and
+  * threads the size of the session thread pool, 0 for the intra-op thread pool of the process.
+  */
+struct BenchmarkCase {
+  std::string name;
+  PerformanceTestConfig config;
+};
+
+/**
+  * The measurements of a case, as written to and read from the JSON results of a suite.
+  */
+struct BenchmarkRecord {
+  std::string name;
+  // seconds
+  double p50_latency{0};
+  double p90_latency{0};
+  double p99_latency{0};
+  // runs per second
+  double throughput{0};
+  // seconds
+  double session_creation_time{0};
+  // the peak working set of the process, which includes the cases run before, and the peak usage of the arenas of
+  // the session of the case
+  size_t peak_workingset_size{0};
+  int64_t arena_peak_bytes{0};
+};
+
+// the cases of the suite file, configured from base_config with their models under models_dir
+common::Status LoadBenchmarkSuite(const std::string& suite_file, const std::string& models_dir,
+                                  const PerformanceTestConfig& base_config, std::vector<BenchmarkCase>& cases);
+
+BenchmarkRecord MakeBenchmarkRecord(const std::string& name, const PerformanceResult& result);
+
+common::Status WriteBenchmarkRecords(const std::string& path, const std::vector<BenchmarkRecord>& records);
+
+// reads the records of a file written by WriteBenchmarkRecords
+common::Status ReadBenchmarkRecords(const std::string& path, std::vector<BenchmarkRecord>& records);
+
+/**
+  * Report to out the measurements of the records that regress from those of the baseline record of the same name
+  * by more than the relative tolerance: higher latencies, session creation time and arena usage, or a lower
+  * throughput. The peak working set is reported but not compared, as it depends on the cases run before.
+  * @return the number of regressions. A case of the baseline that is missing from records counts as one.
+  */
+size_t CompareBenchmarkRecords(const std::vector<BenchmarkRecord>& records,
+                               const std::vector<BenchmarkRecord>& baseline,
+                               double tolerance,
+                               std::ostream& out);
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -5,6 +5,8 @@
 
 #include <string.h>
 #include <iostream>
+#include <string>
+#include <vector>
 
 // Windows Specific
 #ifdef _WIN32
@@ -31,15 +33,73 @@ namespace perftest {
       "\t-r [repeated_times]: Specifies the repeated times if running in 'times' test mode.Default:1000.\n"
       "\t-t [seconds_to_run]: Specifies the seconds to run for 'duration' mode. Default:600.\n"
       "\t-p [profile_file]: Specifies the profile name to enable profiling and dump the profile data to the file.\n"
+      "\t-g: Generate random inputs from the types and shapes of the model inputs instead of loading the test data.\n"
+      "\t-d [dim_name=values]: Run the test with generated inputs whose symbolic dimension dim_name takes each of the\n"
+      "\t\tcomma separated values in turn, e.g. 'batch=1,2,4'. Every combination of the values of repeated -d options\n"
+      "\t\tis tested with a session of its own. Unknown dimensions of the generated inputs are 1 otherwise.\n"
       "\t-s: Show statistics result, like P75, P90.\n"
       "\t-v: Show verbose information.\n"
       "\t-x: Use parallel executor, default (without -x): sequential executor.\n"
+      "\t-c [concurrent_runs]: Specifies the number of client threads that run the session concurrently. Default:1.\n"
+      "\t-q [target_qps]: Issue the runs at this rate, whether or not the previous ones have finished, and count the\n"
+      "\t\tlatency of a run from the time it was due. Default: issue a run as soon as a client is free.\n"
+      "\t-i [threads]: Specifies the size of the session thread pool, 0 for the intra-op thread pool of the process.\n"
+      "\t\tDefault:6.\n"
+      "\t-S [suite_file]: Run the cases of a benchmark suite, each a model under a fixed provider, executor, thread\n"
+      "\t\tpool size and number of runs, instead of a model. model_path is then the directory of the models of the\n"
+      "\t\tsuite, and the latency percentiles, throughput, session creation time and peak memory of the cases are\n"
+      "\t\twritten to result_file as JSON.\n"
+      "\t-b [baseline_file]: Compare the results of the suite with those of a previous run, and exit with 1 if any\n"
+      "\t\tregressed by more than the tolerance.\n"
+      "\t-T [tolerance]: Specifies the relative change of a measurement that counts as a regression. Default:0.1.\n"
       "\t-h: help\n");
 }
 
+// dim_name=value[,value...]
+static bool ParseFreeDimSweep(const char* arg, RunConfig& run_config) {
+  const char* equals = strchr(arg, '=');
+  if (equals == nullptr || equals == arg) {
+    return false;
+  }
+
+  std::vector<int64_t> values;
+  for (const char* value = equals + 1; *value != '\0';) {
+    char* end;
+    values.push_back(strtoll(value, &end, 10));
+    if (end == value || values.back() <= 0 || (*end != ',' && *end != '\0')) {
+      return false;
+    }
+    value = *end == ',' ? end + 1 : end;
+  }
+
+  if (values.empty()) {
+    return false;
+  }
+
+  run_config.free_dim_sweeps.emplace_back(std::string(arg, equals), std::move(values));
+  return true;
+}
+
+/*static*/ bool CommandLineParser::ParseProviderName(const char* name, std::string& provider_type_name) {
+  if (!strcmp(name, "cpu")) {
+    provider_type_name = onnxruntime::kCpuExecutionProvider;
+  } else if (!strcmp(name, "cuda")) {
+    provider_type_name = onnxruntime::kCudaExecutionProvider;
+  } else if (!strcmp(name, "mkldnn")) {
+    provider_type_name = onnxruntime::kMklDnnExecutionProvider;
+  } else if (!strcmp(name, "brainslice")) {
+    provider_type_name = onnxruntime::kBrainSliceExecutionProvider;
+  } else if (!strcmp(name, "trt")) {
+    provider_type_name = onnxruntime::kTRTExecutionProvider;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, char* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, "m:e:r:t:p:xvhs")) != -1) {
+  while ((ch = getopt(argc, argv, "m:e:r:t:p:c:q:d:i:S:b:T:gxvhs")) != -1) {
     switch (ch) {
       case 'm':
         if (!strcmp(optarg, "duration")) {
@@ -54,17 +114,7 @@ namespace perftest {
         test_config.run_config.profile_file = optarg;
         break;
       case 'e':
-        if (!strcmp(optarg, "cpu")) {
-          test_config.machine_config.provider_type_name = onnxruntime::kCpuExecutionProvider;
-        } else if (!strcmp(optarg, "cuda")) {
-          test_config.machine_config.provider_type_name = onnxruntime::kCudaExecutionProvider;
-        } else if (!strcmp(optarg, "mkldnn")) {
-          test_config.machine_config.provider_type_name = onnxruntime::kMklDnnExecutionProvider;
-        } else if (!strcmp(optarg, "brainslice")) {
-          test_config.machine_config.provider_type_name = onnxruntime::kBrainSliceExecutionProvider;
-        } else if (!strcmp(optarg, "trt")) {
-          test_config.machine_config.provider_type_name = onnxruntime::kTRTExecutionProvider;
-        } else {
+        if (!ParseProviderName(optarg, test_config.machine_config.provider_type_name)) {
           return false;
         }
         break;
@@ -80,6 +130,45 @@ namespace perftest {
           return false;
         }
         break;
+      case 'c':
+        test_config.run_config.concurrent_session_runs = static_cast<size_t>(strtol(optarg, nullptr, 10));
+        if (test_config.run_config.concurrent_session_runs <= 0) {
+          return false;
+        }
+        break;
+      case 'q':
+        test_config.run_config.target_qps = strtod(optarg, nullptr);
+        if (test_config.run_config.target_qps <= 0) {
+          return false;
+        }
+        break;
+      case 'i':
+        test_config.run_config.session_thread_pool_size = static_cast<int>(strtol(optarg, nullptr, 10));
+        if (test_config.run_config.session_thread_pool_size < 0) {
+          return false;
+        }
+        break;
+      case 'S':
+        test_config.run_config.suite_file = optarg;
+        break;
+      case 'b':
+        test_config.run_config.baseline_file = optarg;
+        break;
+      case 'T':
+        test_config.run_config.regression_tolerance = strtod(optarg, nullptr);
+        if (test_config.run_config.regression_tolerance < 0) {
+          return false;
+        }
+        break;
+      case 'g':
+        test_config.run_config.generate_inputs = true;
+        break;
+      case 'd':
+        if (!ParseFreeDimSweep(optarg, test_config.run_config)) {
+          return false;
+        }
+        test_config.run_config.generate_inputs = true;
+        break;
       case 's':
         test_config.run_config.f_dump_statistics = true;
         break;
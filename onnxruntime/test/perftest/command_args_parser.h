@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <string>
+
 namespace onnxruntime {
 namespace perftest {
 
@@ -13,6 +15,9 @@ class CommandLineParser {
   static void ShowUsage();
 
   static bool ParseArguments(PerformanceTestConfig& test_config, int argc, char* argv[]);
+
+  // the provider type of a provider name of the -e option, e.g. cpu
+  static bool ParseProviderName(const char* name, std::string& provider_type_name);
 };
 
 }  // namespace perftest
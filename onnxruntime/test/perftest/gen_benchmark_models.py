@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+
+# Generates the models of benchmark_suite.txt, with the directory tree of onnx_test_runner: a model.onnx and the
+# inputs of a test data set. The weights are random with a fixed seed, so the models are the same on every machine.
+
+import argparse
+import os
+
+import numpy as np
+import onnx
+from onnx import helper
+from onnx import numpy_helper
+from onnx import TensorProto
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--output_dir", required=True, help="Path to the directory of the models of the suite.")
+    parser.add_argument("--force", action="store_true", help="Regenerate the models that already exist.")
+    return parser.parse_args()
+
+
+class GraphBuilder:
+    def __init__(self, rng):
+        self.rng = rng
+        self.nodes = []
+        self.initializers = []
+        self.count = 0
+
+    def name(self, prefix):
+        self.count += 1
+        return '%s_%d' % (prefix, self.count)
+
+    def constant(self, value, prefix='const'):
+        name = self.name(prefix)
+        self.initializers.append(numpy_helper.from_array(np.asarray(value), name))
+        return name
+
+    def weight(self, shape, prefix='weight'):
+        scale = 1.0 / np.sqrt(np.prod(shape[1:]) if len(shape) > 1 else shape[0])
+        return self.constant((self.rng.standard_normal(shape) * scale).astype(np.float32), prefix)
+
+    def node(self, op_type, inputs, output=None, **attributes):
+        output = output or self.name(op_type.lower())
+        self.nodes.append(helper.make_node(op_type, inputs, [output], **attributes))
+        return output
+
+    def linear(self, x, in_features, out_features, output=None):
+        y = self.node('MatMul', [x, self.weight([in_features, out_features])])
+        return self.node('Add', [y, self.weight([out_features], 'bias')], output)
+
+    def layer_norm(self, x, features, axis, output=None):
+        mean = self.node('ReduceMean', [x], axes=[axis])
+        centered = self.node('Sub', [x, mean])
+        variance = self.node('ReduceMean', [self.node('Mul', [centered, centered])], axes=[axis])
+        std = self.node('Sqrt', [self.node('Add', [variance, self.constant(np.float32(1e-5))])])
+        normalized = self.node('Div', [centered, std])
+        scaled = self.node('Mul', [normalized, self.constant(np.ones(features, np.float32), 'gamma')])
+        return self.node('Add', [scaled, self.constant(np.zeros(features, np.float32), 'beta')], output)
+
+
+def save_model(model_dir, builder, inputs, outputs, feeds, opset_imports):
+    graph = helper.make_graph(builder.nodes, os.path.basename(model_dir), inputs, outputs, builder.initializers)
+    model = helper.make_model(graph, producer_name='gen_benchmark_models', opset_imports=opset_imports)
+    onnx.checker.check_model(model)
+
+    data_dir = os.path.join(model_dir, 'test_data_set_0')
+    os.makedirs(data_dir, exist_ok=True)
+    onnx.save(model, os.path.join(model_dir, 'model.onnx'))
+    for i, (name, value) in enumerate(feeds):
+        with open(os.path.join(data_dir, 'input_%d.pb' % i), 'wb') as f:
+            f.write(numpy_helper.from_array(value, name).SerializeToString())
+
+
+ONNX_OPSET = [helper.make_opsetid('', 9)]
+ML_OPSET = [helper.make_opsetid('', 9), helper.make_opsetid('ai.onnx.ml', 1)]
+
+
+# conv, relu and max pool blocks followed by a classifier
+def generate_cnn(model_dir, rng):
+    builder = GraphBuilder(rng)
+    x = 'input'
+    channels = [3, 32, 64, 128]
+    for in_channels, out_channels in zip(channels[:-1], channels[1:]):
+        conv = builder.node('Conv', [x, builder.weight([out_channels, in_channels, 3, 3]),
+                                     builder.weight([out_channels], 'bias')],
+                            kernel_shape=[3, 3], pads=[1, 1, 1, 1])
+        x = builder.node('MaxPool', [builder.node('Relu', [conv])], kernel_shape=[2, 2], strides=[2, 2])
+    features = builder.node('Flatten', [builder.node('GlobalAveragePool', [x])], axis=1)
+    builder.node('Gemm', [features, builder.weight([channels[-1], 10]), builder.weight([10], 'bias')], 'output')
+
+    shape = [1, 3, 112, 112]
+    save_model(model_dir, builder,
+               [helper.make_tensor_value_info('input', TensorProto.FLOAT, shape)],
+               [helper.make_tensor_value_info('output', TensorProto.FLOAT, [1, 10])],
+               [('input', rng.standard_normal(shape).astype(np.float32))], ONNX_OPSET)
+
+
+# an encoder layer of multi-head self-attention and a feed-forward network
+def generate_transformer(model_dir, rng):
+    seq_len, hidden, heads, ffn = 128, 256, 4, 1024
+    head_size = hidden // heads
+    builder = GraphBuilder(rng)
+
+    def split_heads(x, perm):
+        reshaped = builder.node('Reshape', [x, builder.constant(np.array([1, seq_len, heads, head_size], np.int64))])
+        return builder.node('Transpose', [reshaped], perm=perm)
+
+    q = split_heads(builder.linear('input', hidden, hidden), [0, 2, 1, 3])
+    k = split_heads(builder.linear('input', hidden, hidden), [0, 2, 3, 1])
+    v = split_heads(builder.linear('input', hidden, hidden), [0, 2, 1, 3])
+    scores = builder.node('Mul', [builder.node('MatMul', [q, k]), builder.constant(np.float32(1 / np.sqrt(head_size)))])
+    context = builder.node('MatMul', [builder.node('Softmax', [scores], axis=3), v])
+    context = builder.node('Transpose', [context], perm=[0, 2, 1, 3])
+    context = builder.node('Reshape', [context, builder.constant(np.array([1, seq_len, hidden], np.int64))])
+    attention = builder.layer_norm(builder.node('Add', ['input', builder.linear(context, hidden, hidden)]), hidden, 2)
+
+    intermediate = builder.node('Relu', [builder.linear(attention, hidden, ffn)])
+    builder.layer_norm(builder.node('Add', [attention, builder.linear(intermediate, ffn, hidden)]), hidden, 2,
+                       'output')
+
+    shape = [1, seq_len, hidden]
+    save_model(model_dir, builder,
+               [helper.make_tensor_value_info('input', TensorProto.FLOAT, shape)],
+               [helper.make_tensor_value_info('output', TensorProto.FLOAT, shape)],
+               [('input', rng.standard_normal(shape).astype(np.float32))], ONNX_OPSET)
+
+
+# two stacked LSTMs
+def generate_rnn(model_dir, rng):
+    seq_len, batch, input_size, hidden = 32, 4, 64, 128
+    builder = GraphBuilder(rng)
+    x = 'input'
+    for layer, layer_input in enumerate([input_size, hidden]):
+        y = builder.node('LSTM', [x, builder.weight([1, 4 * hidden, layer_input]),
+                                  builder.weight([1, 4 * hidden, hidden]), builder.weight([1, 8 * hidden], 'bias')],
+                         hidden_size=hidden)
+        # Y is [seq_len, num_directions, batch, hidden]
+        x = builder.node('Squeeze', [y], 'output' if layer == 1 else None, axes=[1])
+
+    shape = [seq_len, batch, input_size]
+    save_model(model_dir, builder,
+               [helper.make_tensor_value_info('input', TensorProto.FLOAT, shape)],
+               [helper.make_tensor_value_info('output', TensorProto.FLOAT, [seq_len, batch, hidden])],
+               [('input', rng.standard_normal(shape).astype(np.float32))], ONNX_OPSET)
+
+
+# a regressor of complete binary trees, as gradient boosting exports them
+def generate_tree_ensemble(model_dir, rng):
+    batch, features, trees, depth = 100, 20, 100, 6
+    num_branches = 2 ** depth - 1
+    num_nodes = 2 ** (depth + 1) - 1
+    attributes = {key: [] for key in ['nodes_treeids', 'nodes_nodeids', 'nodes_featureids', 'nodes_values',
+                                      'nodes_modes', 'nodes_truenodeids', 'nodes_falsenodeids', 'target_treeids',
+                                      'target_nodeids', 'target_ids', 'target_weights']}
+    for tree in range(trees):
+        for node in range(num_nodes):
+            branch = node < num_branches
+            attributes['nodes_treeids'].append(tree)
+            attributes['nodes_nodeids'].append(node)
+            attributes['nodes_featureids'].append(int(rng.randint(features)) if branch else 0)
+            attributes['nodes_values'].append(float(rng.standard_normal()) if branch else 0.0)
+            attributes['nodes_modes'].append('BRANCH_LEQ' if branch else 'LEAF')
+            attributes['nodes_truenodeids'].append(2 * node + 1 if branch else 0)
+            attributes['nodes_falsenodeids'].append(2 * node + 2 if branch else 0)
+            if not branch:
+                attributes['target_treeids'].append(tree)
+                attributes['target_nodeids'].append(node)
+                attributes['target_ids'].append(0)
+                attributes['target_weights'].append(float(rng.standard_normal()) / trees)
+
+    builder = GraphBuilder(rng)
+    builder.node('TreeEnsembleRegressor', ['input'], 'output', domain='ai.onnx.ml', n_targets=1,
+                 aggregate_function='SUM', post_transform='NONE', **attributes)
+
+    shape = [batch, features]
+    save_model(model_dir, builder,
+               [helper.make_tensor_value_info('input', TensorProto.FLOAT, shape)],
+               [helper.make_tensor_value_info('output', TensorProto.FLOAT, [batch, 1])],
+               [('input', rng.standard_normal(shape).astype(np.float32))], ML_OPSET)
+
+
+# a scaler, a normalizer and a linear classifier, as a scikit-learn pipeline exports them
+def generate_sklearn_pipeline(model_dir, rng):
+    batch, features, classes = 100, 50, 5
+    builder = GraphBuilder(rng)
+    scaled = builder.node('Scaler', ['input'], domain='ai.onnx.ml',
+                          offset=rng.standard_normal(features).astype(np.float32).tolist(),
+                          scale=(rng.random_sample(features) + 0.5).astype(np.float32).tolist())
+    normalized = builder.node('Normalizer', [scaled], domain='ai.onnx.ml', norm='L2')
+    builder.nodes.append(helper.make_node(
+        'LinearClassifier', [normalized], ['label', 'probabilities'], domain='ai.onnx.ml',
+        coefficients=rng.standard_normal(classes * features).astype(np.float32).tolist(),
+        intercepts=rng.standard_normal(classes).astype(np.float32).tolist(),
+        classlabels_ints=list(range(classes)), post_transform='SOFTMAX'))
+
+    shape = [batch, features]
+    save_model(model_dir, builder,
+               [helper.make_tensor_value_info('input', TensorProto.FLOAT, shape)],
+               [helper.make_tensor_value_info('label', TensorProto.INT64, [batch]),
+                helper.make_tensor_value_info('probabilities', TensorProto.FLOAT, [batch, classes])],
+               [('input', rng.standard_normal(shape).astype(np.float32))], ML_OPSET)
+
+
+GENERATORS = [
+    ('cnn', generate_cnn),
+    ('transformer', generate_transformer),
+    ('rnn', generate_rnn),
+    ('tree_ensemble', generate_tree_ensemble),
+    ('sklearn_pipeline', generate_sklearn_pipeline),
+]
+
+
+def main():
+    args = parse_arguments()
+    for name, generate in GENERATORS:
+        model_dir = os.path.join(args.output_dir, name)
+        if os.path.exists(os.path.join(model_dir, 'model.onnx')) and not args.force:
+            continue
+        print('generating %s' % model_dir)
+        generate(model_dir, np.random.RandomState(0))
+
+
+if __name__ == "__main__":
+    main()
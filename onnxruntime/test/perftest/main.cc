@@ -7,11 +7,65 @@
 #include <core/framework/environment.h>
 #include <core/platform/env.h>
 
+#include <iostream>
+#include <vector>
+
+#include "benchmark_suite.h"
 #include "command_args_parser.h"
 #include "performance_runner.h"
 
 using namespace onnxruntime;
 
+// runs the cases of the suite, writes their results and compares them with the baseline if there is one
+static int RunBenchmarkSuite(const perftest::PerformanceTestConfig& test_config) {
+  const auto& run_config = test_config.run_config;
+  std::vector<perftest::BenchmarkCase> cases;
+  auto status = perftest::LoadBenchmarkSuite(run_config.suite_file, test_config.model_info.model_file_path,
+                                             test_config, cases);
+  if (!status.IsOK()) {
+    LOGF_DEFAULT(ERROR, "failed to load the benchmark suite:%s", status.ErrorMessage().c_str());
+    return -1;
+  }
+
+  std::vector<perftest::BenchmarkRecord> records;
+  for (const auto& benchmark_case : cases) {
+    std::cout << "Benchmark case " << benchmark_case.name << std::endl;
+    perftest::PerformanceRunner perf_runner(benchmark_case.config);
+    status = perf_runner.Run();
+    if (!status.IsOK()) {
+      LOGF_DEFAULT(ERROR, "Run of %s failed:%s", benchmark_case.name.c_str(), status.ErrorMessage().c_str());
+      return -1;
+    }
+    records.push_back(perftest::MakeBenchmarkRecord(benchmark_case.name, perf_runner.GetResult()));
+  }
+
+  status = perftest::WriteBenchmarkRecords(test_config.model_info.result_file_path, records);
+  if (!status.IsOK()) {
+    LOGF_DEFAULT(ERROR, "failed to write the benchmark results:%s", status.ErrorMessage().c_str());
+    return -1;
+  }
+
+  if (run_config.baseline_file.empty()) {
+    return 0;
+  }
+
+  std::vector<perftest::BenchmarkRecord> baseline;
+  status = perftest::ReadBenchmarkRecords(run_config.baseline_file, baseline);
+  if (!status.IsOK()) {
+    LOGF_DEFAULT(ERROR, "failed to read the benchmark baseline:%s", status.ErrorMessage().c_str());
+    return -1;
+  }
+
+  const size_t num_regressions =
+      perftest::CompareBenchmarkRecords(records, baseline, run_config.regression_tolerance, std::cout);
+  if (num_regressions > 0) {
+    std::cout << num_regressions << " regressions from the baseline " << run_config.baseline_file << std::endl;
+    return 1;
+  }
+  std::cout << "No regressions from the baseline " << run_config.baseline_file << std::endl;
+  return 0;
+}
+
 int main(int argc, char* args[]) {
   std::string default_logger_id{"Default"};
   logging::LoggingManager default_logging_manager{std::unique_ptr<logging::ISink>{new logging::CLogSink{}},
@@ -32,14 +86,40 @@ int main(int argc, char* args[]) {
     return -1;
   }
 
-  ::onnxruntime::perftest::PerformanceRunner perf_runner(test_config);
-  status = perf_runner.Run();
-  if (!status.IsOK()) {
-    LOGF_DEFAULT(ERROR, "Run failed:%s", status.ErrorMessage().c_str());
-    return -1;
+  if (!test_config.run_config.suite_file.empty()) {
+    return RunBenchmarkSuite(test_config);
+  }
+
+  // a test of each combination of the values of the swept dimensions
+  std::vector<::onnxruntime::perftest::PerformanceTestConfig> configs{test_config};
+  for (const auto& sweep : test_config.run_config.free_dim_sweeps) {
+    std::vector<::onnxruntime::perftest::PerformanceTestConfig> swept_configs;
+    for (const auto& config : configs) {
+      for (int64_t value : sweep.second) {
+        swept_configs.push_back(config);
+        swept_configs.back().run_config.free_dim_values[sweep.first] = value;
+      }
+    }
+    configs = std::move(swept_configs);
   }
 
-  perf_runner.SerializeResult();
+  for (const auto& config : configs) {
+    for (const auto& dim : config.run_config.free_dim_values) {
+      std::cout << dim.first << "=" << dim.second << " ";
+    }
+    if (!config.run_config.free_dim_values.empty()) {
+      std::cout << std::endl;
+    }
+
+    ::onnxruntime::perftest::PerformanceRunner perf_runner(config);
+    status = perf_runner.Run();
+    if (!status.IsOK()) {
+      LOGF_DEFAULT(ERROR, "Run failed:%s", status.ErrorMessage().c_str());
+      return -1;
+    }
+
+    perf_runner.SerializeResult();
+  }
 
   return 0;
 }
@@ -2,11 +2,16 @@
 // Licensed under the MIT License.
 
 #include "performance_runner.h"
+#include <atomic>
+#include <limits>
+#include <random>
+#include <thread>
 #include "TestCase.h"
 #include <experimental/filesystem>
 #ifdef _MSC_VER
 #include <filesystem>
 #endif
+#include "core/framework/tensor.h"
 #include "core/graph/graph_viewer.h"  //for onnxruntime::NodeArg
 #include "utils.h"
 #include "testenv.h"
@@ -29,18 +34,32 @@ Status PerformanceRunner::Run() {
     session_object_->StartProfiling(performance_test_config_.run_config.profile_file);
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(RunFixDuration());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RunRepeatedTimes());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  auto start = std::chrono::high_resolution_clock::now();
+  if (io_bindings_.size() > 1 || performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunConcurrently());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(RunFixDuration());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RunRepeatedTimes());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
+  std::chrono::duration<double> elapsed_seconds = std::chrono::high_resolution_clock::now() - start;
+  performance_result_.elapsed_time = elapsed_seconds.count();
   performance_result_.average_CPU_usage = p_ICPUUsage->GetUsage();
   performance_result_.peak_workingset_size = utils::GetPeakWorkingSetSize();
+  // the arenas of the CPU and CUDA execution providers
+  for (const char* device : {CPU, "Cuda"}) {
+    AllocatorStats stats;
+    if (session_object_->GetAllocatorStats(OrtAllocatorInfo(device, OrtArenaAllocator), stats).IsOK()) {
+      performance_result_.arena_peak_bytes += stats.max_bytes_in_use;
+    }
+  }
 
   if (!performance_test_config_.run_config.profile_file.empty())
     session_object_->EndProfiling();
@@ -48,6 +67,163 @@ Status PerformanceRunner::Run() {
   std::cout << "Total time cost:" << performance_result_.total_time_cost << std::endl
             << "Total iterations:" << performance_result_.time_costs.size() << std::endl
             << "Average time cost:" << performance_result_.total_time_cost / performance_result_.time_costs.size() * 1000 << " ms" << std::endl;
+  performance_result_.DumpStatistics(std::cout);
+  return Status::OK();
+}
+
+Status PerformanceRunner::RunConcurrently() {
+  const auto& run_config = performance_test_config_.run_config;
+  const bool fixed_duration = run_config.test_mode == TestMode::kFixDurationMode;
+  if (!fixed_duration && run_config.test_mode != TestMode::KFixRepeatedTimesMode) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  }
+
+  using Clock = std::chrono::high_resolution_clock;
+  const std::chrono::duration<double> duration(static_cast<double>(run_config.duration_in_seconds));
+  const size_t num_runs = fixed_duration ? std::numeric_limits<size_t>::max() : run_config.repeated_times;
+
+  std::atomic<size_t> next_run{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::vector<double>> client_time_costs(io_bindings_.size());
+  std::vector<Status> client_statuses(io_bindings_.size());
+  const auto start = Clock::now();
+
+  auto run_client = [&](size_t client) {
+    for (size_t run = next_run++; run < num_runs && !failed; run = next_run++) {
+      auto issue_time = Clock::now();
+      if (run_config.target_qps > 0) {
+        issue_time = start + std::chrono::duration_cast<Clock::duration>(
+                                 std::chrono::duration<double>(run / run_config.target_qps));
+        std::this_thread::sleep_until(issue_time);
+      }
+
+      if (fixed_duration && issue_time - start >= duration) {
+        break;
+      }
+
+      auto status = session_object_->Run(*io_bindings_[client]);
+      if (!status.IsOK()) {
+        client_statuses[client] = status;
+        failed = true;
+        break;
+      }
+
+      std::chrono::duration<double> latency = Clock::now() - issue_time;
+      client_time_costs[client].push_back(latency.count());
+    }
+  };
+
+  std::vector<std::thread> clients;
+  for (size_t client = 1; client < io_bindings_.size(); ++client) {
+    clients.emplace_back(run_client, client);
+  }
+  run_client(0);
+  for (auto& client : clients) {
+    client.join();
+  }
+
+  for (size_t client = 0; client < io_bindings_.size(); ++client) {
+    ORT_RETURN_IF_ERROR(client_statuses[client]);
+    for (double time_cost : client_time_costs[client]) {
+      performance_result_.time_costs.push_back(time_cost);
+      performance_result_.total_time_cost += time_cost;
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+static void FillRandom(Tensor& tensor, std::default_random_engine& engine) {
+  std::uniform_real_distribution<double> distribution(0, 1);
+  T* data = tensor.MutableData<T>();
+  for (int64_t i = 0, end = tensor.Shape().Size(); i < end; ++i) {
+    data[i] = static_cast<T>(distribution(engine));
+  }
+}
+
+template <typename T>
+static void FillRandomIntegers(Tensor& tensor, std::default_random_engine& engine) {
+  // small values, which are valid indices of most of the inputs that are indices
+  std::uniform_int_distribution<int> distribution(0, 1);
+  T* data = tensor.MutableData<T>();
+  for (int64_t i = 0, end = tensor.Shape().Size(); i < end; ++i) {
+    data[i] = static_cast<T>(distribution(engine));
+  }
+}
+
+Status PerformanceRunner::GenerateFeeds(const AllocatorPtr& allocator,
+                                        std::unordered_map<std::string, MLValue>& feeds) const {
+  auto inputs = session_object_->GetModelInputs();
+  ORT_RETURN_IF_ERROR(inputs.first);
+
+  std::default_random_engine engine;
+  for (const auto* input : *inputs.second) {
+    const auto* type = input->TypeAsProto();
+    if (type == nullptr || !type->has_tensor_type()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", input->Name(), " is not a tensor.");
+    }
+
+    std::vector<int64_t> dims;
+    const auto* shape = input->Shape();
+    for (int i = 0, end = shape != nullptr ? shape->dim_size() : 0; i < end; ++i) {
+      const auto& dim = shape->dim(i);
+      if (dim.has_dim_value()) {
+        dims.push_back(dim.dim_value());
+      } else {
+        auto value = performance_test_config_.run_config.free_dim_values.find(dim.dim_param());
+        dims.push_back(value != performance_test_config_.run_config.free_dim_values.cend() ? value->second : 1);
+      }
+    }
+
+    const auto element_type = type->tensor_type().elem_type();
+    MLDataType data_type = DataTypeImpl::TypeFromProto(*type);
+    const auto* tensor_type = data_type->AsTensorType();
+    if (tensor_type == nullptr || element_type == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", input->Name(), " has an element type ",
+                             "that can't be generated.");
+    }
+
+    const TensorShape tensor_shape(dims);
+    MLDataType element_data_type = tensor_type->GetElementType();
+    auto tensor = std::make_unique<Tensor>(element_data_type, tensor_shape,
+                                           allocator->Alloc(tensor_shape.Size() * element_data_type->Size()),
+                                           allocator->Info(), allocator);
+
+    switch (element_type) {
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+        FillRandom<float>(*tensor, engine);
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+        FillRandom<double>(*tensor, engine);
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+        FillRandomIntegers<int8_t>(*tensor, engine);
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+        FillRandomIntegers<uint8_t>(*tensor, engine);
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+        FillRandomIntegers<int16_t>(*tensor, engine);
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+        FillRandomIntegers<int32_t>(*tensor, engine);
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+        FillRandomIntegers<int64_t>(*tensor, engine);
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+        FillRandomIntegers<bool>(*tensor, engine);
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", input->Name(), " has an element type ",
+                               "that can't be generated.");
+    }
+
+    feeds[input->Name()] = MLValue{tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                                   DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+  }
+
   return Status::OK();
 }
 
@@ -62,6 +238,14 @@ bool PerformanceRunner::Initialize() {
   std::string model_name = model_path.parent_path().filename().string();
   if (model_name.compare(0, 5, "test_") == 0) model_name = model_name.substr(5);
   performance_result_.model_name = model_name;
+  if (!performance_test_config_.run_config.free_dim_sweeps.empty()) {
+    // the CSV lines of each shape of a sweep are told apart by the model name
+    std::string shape;
+    for (const auto& dim : performance_test_config_.run_config.free_dim_values) {
+      shape += (shape.empty() ? "" : ";") + dim.first + "=" + std::to_string(dim.second);
+    }
+    performance_result_.model_name += "(" + shape + ")";
+  }
 
   // TO DO: remove depedency on OnnxTestCase.
   std::unique_ptr<ITestCase> test_case(CreateOnnxTestCase(model_name));
@@ -78,34 +262,54 @@ bool PerformanceRunner::Initialize() {
   provider_types = {performance_test_config_.machine_config.provider_type_name};
   SessionFactory sf(provider_types, true, true);
   sf.enable_sequential_execution = performance_test_config_.run_config.enable_sequential_execution;
-  sf.session_thread_pool_size = 6;
-
-  sf.create(session_object_, test_case->GetModelUrl(), test_case->GetTestCaseName());
+  sf.session_thread_pool_size = performance_test_config_.run_config.session_thread_pool_size;
 
-  // Initialize IO Binding
-  if (!session_object_->NewIOBinding(&io_binding_).IsOK()) {
-    LOGF_DEFAULT(ERROR, "Failed to init session and IO binding");
+  auto creation_start = std::chrono::high_resolution_clock::now();
+  auto create_status = sf.create(session_object_, test_case->GetModelUrl(), test_case->GetTestCaseName());
+  std::chrono::duration<double> creation_seconds = std::chrono::high_resolution_clock::now() - creation_start;
+  performance_result_.session_creation_time = creation_seconds.count();
+  if (!create_status.IsOK()) {
+    LOGF_DEFAULT(ERROR, "create session failed:%s", create_status.ErrorMessage().c_str());
     return false;
   }
 
+  // Initialize an IO Binding for each client
+  io_bindings_.resize(std::max<size_t>(performance_test_config_.run_config.concurrent_session_runs, 1));
+  for (auto& io_binding : io_bindings_) {
+    if (!session_object_->NewIOBinding(&io_binding).IsOK()) {
+      LOGF_DEFAULT(ERROR, "Failed to init session and IO binding");
+      return false;
+    }
+  }
+
   auto provider_type = performance_test_config_.machine_config.provider_type_name;
   // Place input tensor on cpu memory if mkldnn provider type to avoid CopyTensor logic in CopyInputAcrossDevices
   // TODO: find a better way to do this.
   if (provider_type == onnxruntime::kMklDnnExecutionProvider) {
     provider_type = onnxruntime::kCpuExecutionProvider;
   }
-  AllocatorPtr cpu_allocator = io_binding_->GetCPUAllocator(0, provider_type);
+  AllocatorPtr cpu_allocator = io_bindings_.front()->GetCPUAllocator(0, provider_type);
   test_case->SetAllocator(cpu_allocator);
 
-  if (test_case->GetDataCount() <= 0) {
-    LOGF_DEFAULT(ERROR, "there is no test data for model %s", test_case->GetTestCaseName().c_str());
-    return false;
-  }
-
   std::unordered_map<std::string, ::onnxruntime::MLValue> feeds;
-  test_case->LoadTestData(0 /* id */, feeds, true);
-  for (auto feed : feeds) {
-    io_binding_->BindInput(feed.first, feed.second);
+  if (performance_test_config_.run_config.generate_inputs) {
+    auto generate_status = GenerateFeeds(cpu_allocator, feeds);
+    if (!generate_status.IsOK()) {
+      LOGF_DEFAULT(ERROR, "failed to generate the inputs:%s", generate_status.ErrorMessage().c_str());
+      return false;
+    }
+  } else {
+    if (test_case->GetDataCount() <= 0) {
+      LOGF_DEFAULT(ERROR, "there is no test data for model %s", test_case->GetTestCaseName().c_str());
+      return false;
+    }
+
+    test_case->LoadTestData(0 /* id */, feeds, true);
+  }
+  for (auto& io_binding : io_bindings_) {
+    for (auto feed : feeds) {
+      io_binding->BindInput(feed.first, feed.second);
+    }
   }
   auto outputs = session_object_->GetModelOutputs();
   auto status = outputs.first;
@@ -116,11 +320,13 @@ bool PerformanceRunner::Initialize() {
     return false;
   }
 
-  std::vector<MLValue> output_mlvalues(outputs.second->size());
-  for (size_t i_output = 0; i_output < outputs.second->size(); ++i_output) {
-    auto output = outputs.second->at(i_output);
-    if (!output) continue;
-    io_binding_->BindOutput(output->Name(), output_mlvalues[i_output]);
+  for (auto& io_binding : io_bindings_) {
+    std::vector<MLValue> output_mlvalues(outputs.second->size());
+    for (size_t i_output = 0; i_output < outputs.second->size(); ++i_output) {
+      auto output = outputs.second->at(i_output);
+      if (!output) continue;
+      io_binding->BindOutput(output->Name(), output_mlvalues[i_output]);
+    }
   }
 
   return true;
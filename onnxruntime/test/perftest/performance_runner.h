@@ -4,6 +4,7 @@
 #pragma once
 
 #include <fstream>
+#include <ostream>
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -27,6 +28,11 @@ struct PerformanceResult {
   size_t peak_workingset_size{0};
   short average_CPU_usage{0};
   double total_time_cost{0};
+  // wall-clock time of the test, which is less than total_time_cost when Runs are concurrent
+  double elapsed_time{0};
+  double session_creation_time{0};
+  // peak bytes in use of the memory arenas of the session
+  int64_t arena_peak_bytes{0};
   std::vector<double> time_costs;
   std::string model_name;
 
@@ -43,26 +49,37 @@ struct PerformanceResult {
     }
 
     if (time_costs.size() > 0 && f_include_statistics) {
-      std::vector<double> sorted_time = time_costs;
+      outfile << std::endl;
+      DumpStatistics(outfile);
+    }
 
-      size_t total = sorted_time.size();
-      size_t n50 = static_cast<size_t>(total * 0.5);
-      size_t n90 = static_cast<size_t>(total * 0.9);
-      size_t n95 = static_cast<size_t>(total * 0.95);
-      size_t n99 = static_cast<size_t>(total * 0.99);
-      size_t n999 = static_cast<size_t>(total * 0.999);
+    outfile.close();
+  }
 
-      std::sort(sorted_time.begin(), sorted_time.end());
+  // the latency percentiles and the throughput of the Runs
+  void DumpStatistics(std::ostream& out) const {
+    if (time_costs.empty()) {
+      return;
+    }
 
-      outfile << std::endl;
-      outfile << "P50 Latency is " << sorted_time[n50] << "sec" << std::endl;
-      outfile << "P90 Latency is " << sorted_time[n90] << "sec" << std::endl;
-      outfile << "P95 Latency is " << sorted_time[n95] << "sec" << std::endl;
-      outfile << "P99 Latency is " << sorted_time[n99] << "sec" << std::endl;
-      outfile << "P999 Latency is " << sorted_time[n999] << "sec" << std::endl;
+    std::vector<double> sorted_time = time_costs;
+    std::sort(sorted_time.begin(), sorted_time.end());
+
+    const size_t total = sorted_time.size();
+    const std::pair<const char*, double> percentiles[] = {
+        {"P50", 0.5}, {"P90", 0.9}, {"P95", 0.95}, {"P99", 0.99}, {"P999", 0.999}};
+    for (const auto& percentile : percentiles) {
+      out << percentile.first << " Latency is " << sorted_time[static_cast<size_t>(total * percentile.second)]
+          << "sec" << std::endl;
     }
 
-    outfile.close();
+    if (elapsed_time > 0) {
+      out << "Throughput is " << total / elapsed_time << " runs/sec" << std::endl;
+    }
+
+    out << "Session creation time is " << session_creation_time << "sec" << std::endl
+        << "Peak working set size is " << peak_workingset_size << " bytes" << std::endl
+        << "Arena peak usage is " << arena_peak_bytes << " bytes" << std::endl;
   }
 };
 
@@ -81,7 +98,7 @@ class PerformanceRunner {
 
   inline Status RunOneIteration(bool isWarmup = false) {
     auto start = std::chrono::high_resolution_clock::now();
-    ORT_RETURN_IF_ERROR(session_object_->Run(*io_binding_));
+    ORT_RETURN_IF_ERROR(session_object_->Run(*io_bindings_.front()));
     auto end = std::chrono::high_resolution_clock::now();
 
     if (!isWarmup) {
@@ -110,12 +127,21 @@ class PerformanceRunner {
     return Status::OK();
   }
 
+  // issue the Runs of the test mode from a client thread per IOBinding, which share the session. with a target QPS,
+  // Run i is issued i / target_qps seconds after the start, and its latency counts from then so that the time it
+  // waited for a free client is included.
+  Status RunConcurrently();
+
+  // random feeds of the types and shapes of the model inputs, with the symbolic dimensions set from run_config
+  Status GenerateFeeds(const AllocatorPtr& allocator, std::unordered_map<std::string, MLValue>& feeds) const;
+
  private:
   PerformanceResult performance_result_;
   PerformanceTestConfig performance_test_config_;
 
   std::shared_ptr<::onnxruntime::InferenceSession> session_object_;
-  std::unique_ptr<IOBinding> io_binding_;
+  // one per client thread
+  std::vector<std::unique_ptr<IOBinding>> io_bindings_;
 };
 }  // namespace perftest
 }  // namespace onnxruntime
@@ -4,7 +4,10 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "core/graph/constants.h"
 
@@ -41,6 +44,26 @@ struct RunConfig {
   bool f_dump_statistics{false};
   bool f_verbose{false};
   bool enable_sequential_execution{true};
+  // number of client threads that issue Runs of the session concurrently
+  size_t concurrent_session_runs{1};
+  // rate at which the Runs are issued regardless of when the previous ones finish. 0 to issue a Run as soon as a
+  // client is free.
+  double target_qps{0};
+  // generate random inputs from the types and shapes of the model inputs instead of loading the test data
+  bool generate_inputs{false};
+  // the values of the symbolic dimensions of the generated inputs. other unknown dimensions are 1.
+  std::map<std::string, int64_t> free_dim_values;
+  // the values a symbolic dimension takes in turn. the test is run for every combination of them, with a session
+  // of its own.
+  std::vector<std::pair<std::string, std::vector<int64_t>>> free_dim_sweeps;
+  // the size of the session thread pool, 0 for the intra-op thread pool of the process
+  int session_thread_pool_size{6};
+  // run the cases of this benchmark suite instead of a model. see BenchmarkCase.
+  std::string suite_file;
+  // the results of a suite to compare those of the run with, and the relative change of a measurement that
+  // counts as a regression
+  std::string baseline_file;
+  double regression_tolerance{0.1};
 };
 
 struct PerformanceTestConfig {
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/env.h"
+
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(EnvTest, NumaNodes) {
+  const Env& env = Env::Default();
+  EXPECT_GE(env.GetNumaNodeCount(), 1);
+  EXPECT_TRUE(env.GetNumaNodeCpus(-1).empty());
+  EXPECT_TRUE(env.GetNumaNodeCpus(env.GetNumaNodeCount()).empty());
+
+  // hosts without the NUMA topology, e.g. some containers, report no CPUs
+  std::vector<int> cpus = env.GetNumaNodeCpus(0);
+  for (int cpu : cpus) {
+    EXPECT_GE(cpu, 0);
+  }
+
+#ifdef __linux__
+  if (!cpus.empty()) {
+    // on a thread of its own so that the affinity of the test thread doesn't change
+    std::thread thread([&env, &cpus]() {
+      auto status = env.SetCurrentThreadAffinity(cpus);
+      EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+    });
+    thread.join();
+  }
+#endif
+}
+
+TEST(EnvTest, HugePages) {
+  const Env& env = Env::Default();
+  const size_t size = 3 * 1024 * 1024;
+  auto bytes = static_cast<char*>(env.AllocateHugePages(size));
+  // platforms without huge pages have none to give
+  if (bytes != nullptr) {
+    EXPECT_EQ(bytes[0], 0);
+    memset(bytes, -1, size);
+    EXPECT_EQ(bytes[size - 1], -1);
+    env.FreeHugePages(bytes, size);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -21,6 +21,8 @@ struct RunOptions {
   int symbolic_dim_value_in_main_graph = -1;
   bool include_dim_values_in_subgraph = true;
   bool mixed_execution_providers = false;
+  // the else branch outputs an initializer with the value the Add would produce
+  bool constant_else_branch = false;
 };
 
 static const ONNX_NAMESPACE::GraphProto CreateSubgraph(bool then_branch, const RunOptions& options);
@@ -150,7 +152,20 @@ static const ONNX_NAMESPACE::GraphProto CreateSubgraph(bool then_branch, const R
   graph.AddOuterScopeNodeArg("split_out_" + suffix);
   graph.AddOuterScopeNodeArg("if_input_0");
 
-  {
+  if (!then_branch && options.constant_else_branch) {
+    TensorProto constant;
+    constant.set_name("add_out_1");
+    constant.set_data_type(TensorProto_DataType_FLOAT);
+    constant.add_dims(1);
+    constant.add_float_data(11.f);
+    graph.AddInitializedTensor(constant);
+
+    TypeProto constant_type;
+    constant_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    constant_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+    auto& constant_out = graph.GetOrCreateNodeArg("add_out_1", &constant_type);
+    graph.SetOutputOrder({&constant_out});
+  } else {
     // Add
 
     // graph output has to have type and shape
@@ -260,6 +275,15 @@ TEST(If, MixedExecutionProviders) {
 }
 #endif  // USE_CUDA
 
+// the If output shares the initializer the else branch outputs
+TEST(If, ConstantOutputInBranch) {
+  RunOptions options{};
+  options.constant_else_branch = true;
+
+  RunTest(false, options);
+  RunTest(true, options);
+}
+
 TEST(If, SymbolicShapeInMainGraph_NoShapeInSubgraph_True) {
   RunOptions options;
   options.include_dim_values_in_main_graph = true;
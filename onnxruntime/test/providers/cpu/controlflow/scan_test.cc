@@ -688,6 +688,42 @@ TEST(Scan8, MixedSequenceLensReverse) {
              iteration_count_out, output_0, output_1, output_2, output_3);
 }
 
+// the batch entries after the first one are processed concurrently, each writing to its own slice of the outputs
+TEST(Scan8, ManyInBatchMixedSequenceLens) {
+  const int64_t batch_size = 4;
+  const int64_t max_sequence_len = 3;
+  const int64_t input_size = 2;
+
+  std::vector<int64_t> sequence_lens{3, 1, 2, 3};
+
+  std::vector<float> iteration_count_in{0.f, 10.f, 20.f, 30.f};
+
+  // batch_size, max_sequence_len, input_size
+  std::vector<float> input_0{10.f, 10.5f, 11.f, 11.5f, 12.f, 12.5f,
+                             20.f, 20.5f, 21.f, 21.5f, 22.f, 22.5f,
+                             30.f, 30.5f, 31.f, 31.5f, 32.f, 32.5f,
+                             40.f, 40.5f, 41.f, 41.5f, 42.f, 42.5f};
+
+  std::vector<float> input_1{-10.f, -10.5f, -11.f, -11.5f, -12.f, -12.5f,
+                             -20.f, -20.5f, -21.f, -21.5f, -22.f, -22.5f,
+                             -30.f, -30.5f, -31.f, -31.5f, -32.f, -32.5f,
+                             -40.f, -40.5f, -41.f, -41.5f, -42.f, -42.5f};
+
+  // iteration_count_in + sequence_len of each item in the batch
+  std::vector<float> iteration_count_out{3.f, 11.f, 22.f, 33.f};
+
+  // batch_size, max_sequence_len, 1. zeros past the sequence_len of each item in the batch.
+  std::vector<float> output_0{10.f, 11.f, 12.f, 20.f, 0.f, 0.f, 30.f, 31.f, 0.f, 40.f, 41.f, 42.f};
+  std::vector<float> output_1{10.5f, 11.5f, 12.5f, 20.5f, 0.f, 0.f, 30.5f, 31.5f, 0.f, 40.5f, 41.5f, 42.5f};
+  std::vector<float> output_2{-10.f, -11.f, -12.f, -20.f, 0.f, 0.f, -30.f, -31.f, 0.f, -40.f, -41.f, -42.f};
+  std::vector<float> output_3{-10.5f, -11.5f, -12.5f, -20.5f, 0.f, 0.f, -30.5f, -31.5f, 0.f, -40.5f, -41.5f, -42.5f};
+
+  RunTest_v8("ManyInBatchMixedSequenceLens", batch_size, max_sequence_len, input_size,
+             nullptr, &sequence_lens,
+             iteration_count_in, input_0, input_1,
+             iteration_count_out, output_0, output_1, output_2, output_3);
+}
+
 TEST(Scan8, ShortSequenceTwoInBatchOneLoopStateVarReverseFirstInput) {
   const int64_t batch_size = 2;
   const int64_t sequence_len = 2;
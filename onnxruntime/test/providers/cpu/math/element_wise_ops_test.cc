@@ -155,6 +155,101 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
   test.Run();
 }
 
+// The outputs of these are large enough to be split into blocks that are computed in parallel
+TEST(MathOpTest, Add_Broadcast_Large_Row) {
+  OpTester test("Add");
+
+  const int64_t rows = 70, columns = 1000;
+  std::vector<float> a(rows * columns), b(columns), c(rows * columns);
+  for (int64_t i = 0; i < rows; i++) {
+    for (int64_t j = 0; j < columns; j++) {
+      a[i * columns + j] = static_cast<float>(i);
+      b[j] = static_cast<float>(j) * 1000.0f;
+      c[i * columns + j] = a[i * columns + j] + b[j];
+    }
+  }
+
+  test.AddInput<float>("A", {rows, columns}, a);
+  test.AddInput<float>("B", {columns}, b);
+  test.AddOutput<float>("C", {rows, columns}, c);
+  test.Run();
+}
+
+TEST(MathOpTest, Sub_Broadcast_Large_Column) {
+  OpTester test("Sub");
+
+  const int64_t rows = 600, columns = 50;
+  std::vector<int32_t> a(rows * columns), b(rows), c(rows * columns);
+  for (int64_t i = 0; i < rows; i++) {
+    b[i] = static_cast<int32_t>(i * 7);
+    for (int64_t j = 0; j < columns; j++) {
+      a[i * columns + j] = static_cast<int32_t>(i * columns + j);
+      c[i * columns + j] = a[i * columns + j] - b[i];
+    }
+  }
+
+  test.AddInput<int32_t>("A", {rows, columns}, a);
+  test.AddInput<int32_t>("B", {rows, 1}, b);
+  test.AddOutput<int32_t>("C", {rows, columns}, c);
+  test.Run();
+}
+
+TEST(MathOpTest, Mul_Large) {
+  OpTester test("Mul");
+
+  // not a multiple of the block size, so the last block is partial
+  const int64_t size = 40001;
+  std::vector<float> a(size), b(size), c(size);
+  for (int64_t i = 0; i < size; i++) {
+    a[i] = static_cast<float>(i % 101);
+    b[i] = static_cast<float>(i % 7) - 3.0f;
+    c[i] = a[i] * b[i];
+  }
+
+  test.AddInput<float>("A", {size}, a);
+  test.AddInput<float>("B", {size}, b);
+  test.AddOutput<float>("C", {size}, c);
+  test.Run();
+}
+
+TEST(MathOpTest, Div_Broadcast_Large_Scalar0) {
+  OpTester test("Div");
+
+  const int64_t size = 40001;
+  std::vector<float> b(size), c(size);
+  for (int64_t i = 0; i < size; i++) {
+    b[i] = static_cast<float>(1 << (i % 8));
+    c[i] = 256.0f / b[i];
+  }
+
+  test.AddInput<float>("A", {}, {256.0f});
+  test.AddInput<float>("B", {size}, b);
+  test.AddOutput<float>("C", {size}, c);
+  test.Run();
+}
+
+TEST(MathOpTest, Add_Broadcast_Large_Outer) {
+  OpTester test("Add");
+
+  // a span is shorter than a block, so blocks are runs of several spans of a broadcast over the middle axis
+  const int64_t outer = 20, middle = 30, inner = 40;
+  std::vector<float> a(outer * inner), b(middle * inner), c(outer * middle * inner);
+  for (int64_t i = 0; i < outer; i++) {
+    for (int64_t j = 0; j < middle; j++) {
+      for (int64_t k = 0; k < inner; k++) {
+        a[i * inner + k] = static_cast<float>(i * inner + k);
+        b[j * inner + k] = static_cast<float>(j) * 10000.0f;
+        c[(i * middle + j) * inner + k] = a[i * inner + k] + b[j * inner + k];
+      }
+    }
+  }
+
+  test.AddInput<float>("A", {outer, 1, inner}, a);
+  test.AddInput<float>("B", {middle, inner}, b);
+  test.AddOutput<float>("C", {outer, middle, inner}, c);
+  test.Run();
+}
+
 TEST(MathOpTest, Sub_int32) {
   OpTester test("Sub");
   test.AddInput<int32_t>("A", {3}, {1, 4, 3});
@@ -977,6 +1072,27 @@ TEST(MathOpTest, Expand_8_1x3_float16) {
   test.Run();
 }
 
+// the shape has fewer dims than the input, and the input is expanded in an inner and the outermost axis
+TEST(MathOpTest, Expand_8_3D_Large) {
+  const int64_t D1 = 33, D2 = 64;
+  std::vector<float> input(D1);
+  for (size_t i = 0; i < input.size(); i++) {
+    input[i] = static_cast<float>(i);
+  }
+  std::vector<float> output;
+  for (int64_t i = 0; i < 4; i++) {
+    for (int64_t j = 0; j < D1; j++) {
+      output.insert(output.end(), D2, input[j]);
+    }
+  }
+
+  OpTester test("Expand", 8);
+  test.AddInput<float>("data_0", {1, D1, 1}, input);
+  test.AddInput<int64_t>("data_1", {3}, {4, 1, D2});
+  test.AddOutput<float>("result", {4, D1, D2}, output);
+  test.Run();
+}
+
 TEST(MathOpTest, Scale) {
   OpTester test("Scale");
   std::vector<int64_t> dims{2, 2};
@@ -66,6 +66,142 @@ TEST(MathOpTest, GemmTrans) {
   test.Run();
 }
 
+// a constant B is prepacked by the kernel
+TEST(MathOpTest, GemmInitializerB) {
+  for (int64_t trans_b : {0, 1}) {
+    OpTester test("Gemm");
+
+    test.AddAttribute("transA", (int64_t)0);
+    test.AddAttribute("transB", trans_b);
+    test.AddAttribute("alpha", 2.0f);
+    test.AddAttribute("beta", 1.0f);
+
+    test.AddInput<float>("A", {2, 4},
+                         {1.0f, 2.0f, 3.0f, 4.0f,
+                          -1.0f, -2.0f, -3.0f, -4.0f});
+    if (trans_b == 0) {
+      test.AddInput<float>("B", {4, 3},
+                           {1.0f, 0.0f, 1.0f,
+                            1.0f, 0.0f, 2.0f,
+                            1.0f, 1.0f, 3.0f,
+                            1.0f, 1.0f, 4.0f},
+                           true);
+    } else {
+      test.AddInput<float>("B", {3, 4},
+                           {1.0f, 1.0f, 1.0f, 1.0f,
+                            0.0f, 0.0f, 1.0f, 1.0f,
+                            1.0f, 2.0f, 3.0f, 4.0f},
+                           true);
+    }
+    test.AddInput<float>("C", {3}, std::vector<float>{1.0f, 2.0f, 3.0f});
+    test.AddOutput<float>("Y", {2, 3},
+                          {21.0f, 16.0f, 63.0f,
+                           -19.0f, -12.0f, -57.0f});
+    test.Run();
+  }
+}
+
+TEST(MathOpTest, GemmBlockSparseInitializerB) {
+  // only two of the six 16x16 blocks of the product in B are nonzero, so the kernel packs it as block sparse.
+  // a beta of 1 applies C in the output stage of the SGEMM.
+  constexpr int64_t M = 5, K = 32, N = 48;
+  std::vector<float> a(M * K);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+  std::vector<float> b(K * N, 0.0f);
+  for (int64_t k = 0; k < K; ++k) {
+    for (int64_t n = 0; n < N; ++n) {
+      if ((k < 16 && n >= 16 && n < 32) || (k >= 16 && n >= 32)) {
+        b[k * N + n] = static_cast<float>((k + 2 * n) % 5) - 2.0f;
+      }
+    }
+  }
+  std::vector<float> b_trans(N * K);
+  for (int64_t k = 0; k < K; ++k) {
+    for (int64_t n = 0; n < N; ++n) {
+      b_trans[n * K + k] = b[k * N + n];
+    }
+  }
+  std::vector<float> c(N);
+  for (int64_t n = 0; n < N; ++n) {
+    c[n] = static_cast<float>(n % 3);
+  }
+
+  for (int64_t trans_b : {0, 1}) {
+    for (float beta : {1.0f, 0.5f}) {
+      std::vector<float> y(M * N);
+      for (int64_t m = 0; m < M; ++m) {
+        for (int64_t n = 0; n < N; ++n) {
+          float sum = 0.0f;
+          for (int64_t k = 0; k < K; ++k) {
+            sum += a[m * K + k] * b[k * N + n];
+          }
+          y[m * N + n] = 2.0f * sum + beta * c[n];
+        }
+      }
+
+      OpTester test("Gemm");
+
+      test.AddAttribute("transA", (int64_t)0);
+      test.AddAttribute("transB", trans_b);
+      test.AddAttribute("alpha", 2.0f);
+      test.AddAttribute("beta", beta);
+
+      test.AddInput<float>("A", {M, K}, a);
+      if (trans_b == 0) {
+        test.AddInput<float>("B", {K, N}, b, true);
+      } else {
+        test.AddInput<float>("B", {N, K}, b_trans, true);
+      }
+      test.AddInput<float>("C", {N}, c);
+      test.AddOutput<float>("Y", {M, N}, y);
+      test.Run();
+    }
+  }
+}
+
+TEST(MathOpTest, GemmCompressedInitializerB) {
+  // the largest magnitude of each column of the product in B is 127, so its int8 scales are 1 and the products are
+  // exact. a beta of 1 applies C in the output stage of the SGEMM.
+  for (auto compression : {WeightCompression::kFloat16, WeightCompression::kInt8}) {
+    for (int64_t trans_b : {0, 1}) {
+      for (float beta : {1.0f, 0.5f}) {
+        OpTester test("Gemm");
+        test.SetWeightCompression(compression);
+
+        test.AddAttribute("transA", (int64_t)0);
+        test.AddAttribute("transB", trans_b);
+        test.AddAttribute("alpha", 2.0f);
+        test.AddAttribute("beta", beta);
+
+        test.AddInput<float>("A", {2, 3}, {1.0f, 2.0f, 3.0f, -1.0f, -2.0f, -3.0f});
+        if (trans_b == 0) {
+          test.AddInput<float>("B", {3, 4},
+                               {127.0f, 2.0f, -5.0f, 1.0f,
+                                1.0f, -127.0f, 4.0f, 3.0f,
+                                -3.0f, 6.0f, 127.0f, -127.0f},
+                               true);
+        } else {
+          test.AddInput<float>("B", {4, 3},
+                               {127.0f, 1.0f, -3.0f,
+                                2.0f, -127.0f, 6.0f,
+                                -5.0f, 4.0f, 127.0f,
+                                1.0f, 3.0f, -127.0f},
+                               true);
+        }
+        test.AddInput<float>("C", {4}, std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f});
+        if (beta == 1.0f) {
+          test.AddOutput<float>("Y", {2, 4}, {241.0f, -466.0f, 771.0f, -744.0f, -239.0f, 470.0f, -765.0f, 752.0f});
+        } else {
+          test.AddOutput<float>("Y", {2, 4}, {240.5f, -467.0f, 769.5f, -746.0f, -239.5f, 469.0f, -766.5f, 750.0f});
+        }
+        test.Run();
+      }
+    }
+  }
+}
+
 TEST(MathOpTest, GemmAlphaBeta) {
   OpTester test("Gemm");
 
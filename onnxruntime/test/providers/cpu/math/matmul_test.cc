@@ -61,21 +61,76 @@ TEST(MathOpTest, MatMul) {
        {20, 23, 26, 29, 56, 68, 80, 92, 92, 113, 134, 155, 128, 158, 188, 218}},
   };
 
-  for (auto t : testcases) {
-    OpTester test("MatMul");
+  // a constant B is prepacked by the kernel
+  for (bool is_b_initializer : {false, true}) {
+    for (auto t : testcases) {
+      OpTester test("MatMul");
+
+      int64_t size0 = TensorShape::ReinterpretBaseType(t.input0_dims).SizeHelper(0, t.input0_dims.size());
+      std::vector<float> input0_vals(vals.cbegin(), vals.cbegin() + size0);
+      test.AddInput<float>("A", t.input0_dims, input0_vals);
+
+      int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
+      std::vector<float> input1_vals(vals.cbegin(), vals.cbegin() + size1);
+      test.AddInput<float>("B", t.input1_dims, input1_vals, is_b_initializer);
 
-    int64_t size0 = TensorShape::ReinterpretBaseType(t.input0_dims).SizeHelper(0, t.input0_dims.size());
-    std::vector<float> input0_vals(vals.cbegin(), vals.cbegin() + size0);
-    test.AddInput<float>("A", t.input0_dims, input0_vals);
+      test.AddOutput<float>("Y", t.expected_dims, t.expected_vals);
+      test.Run();
+    }
+  }
+}
 
-    int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
-    std::vector<float> input1_vals(vals.cbegin(), vals.cbegin() + size1);
-    test.AddInput<float>("B", t.input1_dims, input1_vals);
+TEST(MathOpTest, MatMulCompressedInitializerB) {
+  // the largest magnitude of each column of B is 127, so its int8 scales are 1 and the products are exact
+  for (auto compression : {WeightCompression::kFloat16, WeightCompression::kInt8}) {
+    OpTester test("MatMul");
+    test.SetWeightCompression(compression);
 
-    test.AddOutput<float>("Y", t.expected_dims, t.expected_vals);
+    test.AddInput<float>("A", {2, 2, 3}, {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f});
+    test.AddInput<float>("B", {3, 4},
+                         {127.0f, 2.0f, -5.0f, 1.0f,
+                          1.0f, -127.0f, 4.0f, 3.0f,
+                          -3.0f, 6.0f, 127.0f, -127.0f},
+                         true);
+    test.AddOutput<float>("Y", {2, 2, 4},
+                          {-5.0f, -115.0f, 258.0f, -251.0f,
+                           370.0f, -472.0f, 636.0f, -620.0f,
+                           745.0f, -829.0f, 1014.0f, -989.0f,
+                           1120.0f, -1186.0f, 1392.0f, -1358.0f});
     test.Run();
   }
 }
 
+TEST(MathOpTest, MatMulBlockSparseInitializerB) {
+  // only two of the six 16x16 blocks of B are nonzero, so the kernel packs it as block sparse
+  constexpr int64_t M = 3, K = 32, N = 48;
+  std::vector<float> a(2 * M * K);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+  std::vector<float> b(K * N, 0.0f);
+  for (int64_t k = 0; k < K; ++k) {
+    for (int64_t n = 0; n < N; ++n) {
+      if ((k < 16 && n >= 16 && n < 32) || (k >= 16 && n >= 32)) {
+        b[k * N + n] = static_cast<float>((k + 2 * n) % 5) - 2.0f;
+      }
+    }
+  }
+  std::vector<float> y(2 * M * N, 0.0f);
+  for (int64_t m = 0; m < 2 * M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        y[m * N + n] += a[m * K + k] * b[k * N + n];
+      }
+    }
+  }
+
+  OpTester test("MatMul");
+  test.AddInput<float>("A", {2, M, K}, a);
+  test.AddInput<float>("B", {K, N}, b, true);
+  test.AddOutput<float>("Y", {2, M, N}, y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
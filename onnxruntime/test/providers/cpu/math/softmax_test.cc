@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/softmax_shared.h"
+#include <algorithm>
+#include <cmath>
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -174,6 +176,38 @@ TEST(SoftmaxOperator, ThreeDimsNegativeAxis) {
   RunTest(x_vals_3dims, expected_vals, three_dimensions, /*axis*/ -1);
 }
 
+// the softmax of rows of repeating values, computed in double
+static void RunRowsTest(int64_t rows, int64_t row_size) {
+  std::vector<float> x_vals;
+  std::vector<float> expected_vals;
+  for (int64_t i = 0; i < rows; ++i) {
+    std::vector<double> x;
+    for (int64_t j = 0; j < row_size; ++j) {
+      x.push_back(((i + j) % 13) * 0.25 - 1.0);
+    }
+    const double max_value = *std::max_element(x.begin(), x.end());
+    double sum = 0;
+    for (auto value : x) {
+      sum += std::exp(value - max_value);
+    }
+    for (int64_t j = 0; j < row_size; ++j) {
+      x_vals.push_back(static_cast<float>(x[j]));
+      expected_vals.push_back(static_cast<float>(std::exp(x[j] - max_value) / sum));
+    }
+  }
+  RunTest(x_vals, expected_vals, {rows, row_size});
+}
+
+// many short rows and a few long ones, like attention scores and vocabulary projections
+TEST(SoftmaxOperator, ShortRows) {
+  RunRowsTest(67, 33);
+  RunRowsTest(5, 1000);
+}
+
+TEST(SoftmaxOperator, LongRows) {
+  RunRowsTest(3, 30001);
+}
+
 TEST(SoftmaxOperator, InvalidAxis) {
   std::vector<float> x_vals = {-1.0f, 0.0f, 1.0f};
   std::vector<float> expected_vals = {0.0f, 0.0f, 0.0f};
@@ -193,19 +227,19 @@ TEST(SoftmaxOperator, TestInputTooLarge) {
   // N > INT32_MAX
   int64_t N = int64_t(INT32_MAX) + 1;
   int64_t D = 1;
-  auto status = SoftmaxCPU(N, D, ignored, ignored, ignored, ignored, true, ignored);
+  auto status = SoftmaxCPU(N, D, ignored, ignored, true);
   EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
 
   // D > INT32_MAX
   N = 1;
   D = int64_t(INT32_MAX) + 1;
-  status = SoftmaxCPU(N, D, ignored, ignored, ignored, ignored, true, ignored);
+  status = SoftmaxCPU(N, D, ignored, ignored, true);
   EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
 
   // N * D > INT32_MAX
   N = int64_t(INT32_MAX) / 2;
   D = 3;
-  status = SoftmaxCPU(N, D, ignored, ignored, ignored, ignored, true, ignored);
+  status = SoftmaxCPU(N, D, ignored, ignored, true);
   EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
 
   /*
@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <numeric>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -82,5 +85,82 @@ TEST(TopKOperator, InvalidK) {
           "Invalid value for attribute k");
 }
 
+// rows long enough for the CUDA kernel to sort the selection in global memory
+TEST(TopKOperator, TopKLargeRows) {
+  const int64_t rows = 2;
+  const int64_t cols = 3000;
+  const int64_t k = 2500;
+  std::vector<float> input_vals(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    // distinct values in a scrambled order
+    input_vals[i] = static_cast<float>((i * 7919) % (rows * cols)) - 1000.0f;
+  }
+
+  std::vector<float> expected_vals;
+  std::vector<int64_t> expected_indices;
+  for (int64_t r = 0; r < rows; ++r) {
+    std::vector<int64_t> order(cols);
+    std::iota(order.begin(), order.end(), 0);
+    const float* row = input_vals.data() + r * cols;
+    std::sort(order.begin(), order.end(), [row](int64_t a, int64_t b) { return row[a] > row[b]; });
+    for (int64_t j = 0; j < k; ++j) {
+      expected_vals.push_back(row[order[j]]);
+      expected_indices.push_back(order[j]);
+    }
+  }
+
+  RunTest(k, input_vals, {rows, cols}, expected_vals, expected_indices, {rows, k});
+}
+
+// rows that are much wider than k, which are selected by a heap
+TEST(TopKOperator, TopKWideRows) {
+  const int64_t rows = 3;
+  const int64_t cols = 1000;
+  const int64_t k = 10;
+  std::vector<float> input_vals(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    // repeated values, of which the smaller indices are selected first
+    input_vals[i] = static_cast<float>((i * 7919) % 97);
+  }
+
+  std::vector<float> expected_vals;
+  std::vector<int64_t> expected_indices;
+  for (int64_t r = 0; r < rows; ++r) {
+    std::vector<int64_t> order(cols);
+    std::iota(order.begin(), order.end(), 0);
+    const float* row = input_vals.data() + r * cols;
+    std::stable_sort(order.begin(), order.end(), [row](int64_t a, int64_t b) { return row[a] > row[b]; });
+    for (int64_t j = 0; j < k; ++j) {
+      expected_vals.push_back(row[order[j]]);
+      expected_indices.push_back(order[j]);
+    }
+  }
+
+  RunTest(k, input_vals, {rows, cols}, expected_vals, expected_indices, {rows, k});
+}
+
+TEST(TopKOperator, Top1Ties) {
+  std::vector<float> input_vals = {0.1f, 0.4f, 0.2f, 0.4f, -0.3f, -0.1f, -0.3f, -0.2f};
+  std::vector<int64_t> input_dimensions = {2, 4};
+  std::vector<float> expected_vals = {0.4f, -0.1f};
+  std::vector<int64_t> expected_indices = {1, 1};
+  std::vector<int64_t> expected_dimensions = {2, 1};
+  RunTest(1, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions);
+}
+
+#ifdef USE_CUDA
+// the CPU kernel only supports the last axis
+TEST(TopKOperator, TopKMiddleAxis) {
+  OpTester test("TopK");
+  test.AddAttribute("k", int64_t(2));
+  test.AddAttribute("axis", int64_t(1));
+  // shape {2, 3, 2}
+  test.AddInput<float>("X", {2, 3, 2}, {0.1f, 0.6f, 0.5f, 0.2f, 0.3f, 0.2f, -1.0f, 4.0f, 2.0f, 4.0f, 3.0f, 1.0f});
+  test.AddOutput<float>("Values", {2, 2, 2}, {0.5f, 0.6f, 0.3f, 0.2f, 3.0f, 4.0f, 2.0f, 4.0f});
+  test.AddOutput<int64_t>("Indices", {2, 2, 2}, {1, 0, 2, 1, 2, 0, 1, 1});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCpuExecutionProvider});
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
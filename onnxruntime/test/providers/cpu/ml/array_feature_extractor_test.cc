@@ -81,6 +81,28 @@ TEST_F(ArrayFeatureExtractorTest, HigherDimensionalX) {
   test_.Run();
 }
 
+// enough rows to gather them in parallel, with consecutive indices copied as a block
+TEST_F(ArrayFeatureExtractorTest, ManyRowsConsecutiveY) {
+  const int64_t N = 4096;
+  const int64_t kCols = 8;
+  std::vector<float> X(N * kCols);
+  std::iota(X.begin(), X.end(), 0.f);
+  test_.AddInput<float>("X", {N, kCols}, X);
+
+  const std::vector<int64_t> Y = {2L, 3L, 4L, 5L};
+  test_.AddInput<int64_t>("Y", {1, 4}, Y);
+
+  vector<float> expected_output;
+  for (int64_t i = 0; i < N; ++i) {
+    for (int64_t y : Y) {
+      expected_output.push_back(X[i * kCols + y]);
+    }
+  }
+  test_.AddOutput<float>("Z", {N, 4}, expected_output);
+
+  test_.Run();
+}
+
 TEST_F(ArrayFeatureExtractorTest, OneDimensionalX) {
   test_.AddInput<int32_t>("X", {1}, {42});
   test_.AddInput<int64_t>("Y", {1, 3}, {0, 0, 0});
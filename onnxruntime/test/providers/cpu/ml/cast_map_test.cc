@@ -60,6 +60,26 @@ TEST(CastMap, SparseFloatToFloat) {
   RunTest(map, output, "TO_FLOAT", 4);
 }
 
+// maps large enough to cast their entries in parallel
+TEST(CastMap, LargeMaps) {
+  std::map<int64_t, std::string> dense;
+  std::vector<float> dense_output;
+  std::map<int64_t, float> sparse;
+  std::vector<float> sparse_output(20000, 0.0f);
+  for (int64_t i = 0; i < 10000; ++i) {
+    dense[i] = std::to_string(i) + ".5";
+    dense_output.push_back(static_cast<float>(i) + 0.5f);
+    sparse[i * 3] = static_cast<float>(i);
+    if (i * 3 < 20000) {
+      sparse_output[i * 3] = static_cast<float>(i);
+    }
+  }
+
+  RunTest(dense, dense_output, "TO_FLOAT");
+  // the entries past max_map are dropped
+  RunTest(sparse, sparse_output, "TO_FLOAT", 20000);
+}
+
 /*
 Cast to Tensor<int64_t>
 */
@@ -42,5 +42,39 @@ TEST(MLOpTest, DictVectorizerInt64Input) {
   test.Run();
 }
 
+TEST(MLOpTest, DictVectorizerDuplicatedVocabulary) {
+  OpTester test("DictVectorizer", 1, onnxruntime::kMLDomain);
+
+  test.AddAttribute("string_vocabulary", std::vector<std::string>{"a", "b", "a", "c", "a", "d"});
+
+  std::map<std::string, int64_t> map;
+  map["a"] = 1;
+  map["d"] = 3;
+
+  test.AddInput<std::string, int64_t>("X", map);
+
+  std::vector<int64_t> dims{1, 6};
+  test.AddOutput<int64_t>("Y", dims, {1, 0, 1, 0, 1, 3});
+  test.Run();
+}
+
+TEST(MLOpTest, DictVectorizerMoreKeysThanVocabulary) {
+  OpTester test("DictVectorizer", 1, onnxruntime::kMLDomain);
+
+  test.AddAttribute("int64_vocabulary", std::vector<int64_t>{4, 2, 4});
+
+  std::map<int64_t, std::string> map;
+  map[1] = "a";
+  map[2] = "b";
+  map[3] = "c";
+  map[4] = "d";
+
+  test.AddInput<int64_t, std::string>("X", map);
+
+  std::vector<int64_t> dims{1, 3};
+  test.AddOutput<std::string>("Y", dims, {"d", "b", "d"});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -80,6 +81,49 @@ TEST(MLOpTest, LinearClassifierMulticlassProbSigmoid) {
   test.Run();
 }
 
+// enough points to score and transform them in parallel, with the softmax of each point's scores
+TEST(MLOpTest, LinearClassifierMulticlassSoftmaxManyPoints) {
+  OpTester test("LinearClassifier", 1, onnxruntime::kMLDomain);
+
+  std::vector<float> coefficients = {-0.22562418f, 0.34188559f, 0.68346153f, -0.68051993f, -0.1975279f, 0.03748541f};
+  std::vector<float> intercepts = {-3.91601811f, 0.42575697f, 0.13731251f};
+  std::vector<int64_t> classes = {1, 2, 3};
+  const int64_t points = 32 * 1024;
+  std::vector<float> X;
+  std::vector<int64_t> predicted_class;
+  std::vector<float> probabilities;
+  for (int64_t i = 0; i < points; i++) {
+    const float x[2] = {static_cast<float>(i % 17) - 8.f, static_cast<float>(i % 5) * 2.5f};
+    X.insert(X.end(), x, x + 2);
+    float scores[3];
+    int best = 0;
+    for (int j = 0; j < 3; j++) {
+      scores[j] = x[0] * coefficients[j * 2] + x[1] * coefficients[j * 2 + 1] + intercepts[j];
+      best = scores[j] > scores[best] ? j : best;
+    }
+    predicted_class.push_back(classes[best]);
+    float sum = 0.f;
+    for (float& score : scores) {
+      score = std::exp(score - scores[best]);
+      sum += score;
+    }
+    for (float score : scores) {
+      probabilities.push_back(score / sum);
+    }
+  }
+
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("intercepts", intercepts);
+  test.AddAttribute("classlabels_ints", classes);
+  test.AddAttribute("post_transform", std::string("SOFTMAX"));
+
+  test.AddInput<float>("X", {points, 2}, X);
+  test.AddOutput<int64_t>("Y", {points}, predicted_class);
+  test.AddOutput<float>("Z", {points, 3}, probabilities);
+  test.SetOutputAbsErr("Z", 0.0001f);
+  test.Run();
+}
+
 TEST(MLOpTest, LinearClassifierBinary) {
   OpTester test("LinearClassifier", 1, onnxruntime::kMLDomain);
 
@@ -66,5 +66,28 @@ TEST(MLOpTest, LinearRegressorMultiTarget) {
   test.Run();
 }
 
+TEST(MLOpTest, LinearRegressorSparseFeatures) {
+  // few nonzero features, as a one-hot encoding produces, score with the nonzero features only
+  const int64_t num_features = 64;
+  OpTester test("LinearRegressor", 1, onnxruntime::kMLDomain);
+  std::vector<float> coefficients(2 * num_features);
+  for (int64_t i = 0; i < num_features; i++) {
+    coefficients[i] = static_cast<float>(i);
+    coefficients[num_features + i] = static_cast<float>(-2 * i);
+  }
+  std::vector<float> intercepts = {1.f, 0.5f};
+  test.AddAttribute("intercepts", intercepts);
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("targets", int64_t{2});
+
+  std::vector<float> X(3 * num_features, 0.f);
+  X[3] = 1.f;
+  X[num_features + 10] = 2.f;
+  X[num_features + 63] = -1.f;
+  test.AddInput<float>("X", {3, num_features}, X);
+  test.AddOutput<float>("Y", {3, 2}, {4.f, -5.5f, -42.f, 86.5f, 1.f, 0.5f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
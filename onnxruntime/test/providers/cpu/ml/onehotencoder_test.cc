@@ -48,6 +48,26 @@ TEST(OneHotEncoderOpTest, IntegerWithInt64) {
   TestIntCategory<int64_t>(input);
 }
 
+// categories that aren't consecutive are looked up, here for enough values to encode them in parallel
+TEST(OneHotEncoderOpTest, SparseCategoriesManyValues) {
+  std::vector<int64_t> categories{9, 2, 5};
+  std::vector<int64_t> input;
+  std::vector<float> expected_output;
+  for (int64_t i = 0; i < 32 * 1024; ++i) {
+    input.push_back(i % 11);
+    for (int64_t category : categories) {
+      expected_output.push_back(i % 11 == category ? 1.0f : 0.0f);
+    }
+  }
+
+  OpTester test("OneHotEncoder", 1, onnxruntime::kMLDomain);
+  test.AddAttribute("cats_int64s", categories);
+  test.AddAttribute("zeros", int64_t{1});
+  test.AddInput<int64_t>("X", {static_cast<int64_t>(input.size())}, input);
+  test.AddOutput<float>("Y", {static_cast<int64_t>(input.size()), 3}, expected_output);
+  test.Run();
+}
+
 /*
 TEST(OneHotEncoderOpTest, IntegerWithInt32) {
   vector<int> input{ 8, 1, 0, 0, 3, 7, 4 };
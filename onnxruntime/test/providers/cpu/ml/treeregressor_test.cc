@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -50,5 +52,137 @@ TEST(MLOpTest, TreeRegressorMultiTarget) {
   test.Run();
 }
 
+TEST(MLOpTest, TreeRegressorSumMissingValues) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  //node ids of the first tree don't start at 0
+  std::vector<int64_t> lefts = {11, -1, -1, 1, -1, -1};
+  std::vector<int64_t> rights = {12, -1, -1, 2, -1, -1};
+  std::vector<int64_t> treeids = {0, 0, 0, 1, 1, 1};
+  std::vector<int64_t> nodeids = {10, 11, 12, 0, 1, 2};
+  std::vector<int64_t> featureids = {0, -2, -2, 1, -2, -2};
+  std::vector<float> thresholds = {0.5f, -2.f, -2.f, 3.f, -2.f, -2.f};
+  std::vector<std::string> modes = {"BRANCH_LT", "LEAF", "LEAF", "BRANCH_GTE", "LEAF", "LEAF"};
+  std::vector<int64_t> missing_tracks_true = {1, 0, 0, 0, 0, 0};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1};
+  std::vector<int64_t> target_nodeids = {11, 12, 1, 2};
+  std::vector<int64_t> target_ids = {0, 0, 0, 0};
+  std::vector<float> target_weights = {1.f, 2.f, 10.f, 20.f};
+
+  std::vector<float> X = {0.f, 5.f, 1.f, 0.f, std::numeric_limits<float>::quiet_NaN(), 3.f};
+  std::vector<float> results = {111.f, 122.f, 111.f};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("nodes_missing_value_tracks_true", missing_tracks_true);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("base_values", std::vector<float>{100.f});
+
+  test.AddAttribute("n_targets", (int64_t)1);
+  test.AddAttribute("aggregate_function", "SUM");
+  test.AddInput<float>("X", {3, 2}, X);
+  test.AddOutput<float>("Y", {3, 1}, results);
+  test.Run();
+}
+
+//equality branches can't be evaluated with QuickScorer, so the trees are walked
+TEST(MLOpTest, TreeRegressorEqualityBranches) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> lefts = {1, -1, -1, 1, -1, -1};
+  std::vector<int64_t> rights = {2, -1, -1, 2, -1, -1};
+  std::vector<int64_t> treeids = {0, 0, 0, 1, 1, 1};
+  std::vector<int64_t> nodeids = {0, 1, 2, 0, 1, 2};
+  std::vector<int64_t> featureids = {0, -2, -2, 1, -2, -2};
+  std::vector<float> thresholds = {1.f, -2.f, -2.f, 3.f, -2.f, -2.f};
+  std::vector<std::string> modes = {"BRANCH_EQ", "LEAF", "LEAF", "BRANCH_NEQ", "LEAF", "LEAF"};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1};
+  std::vector<int64_t> target_nodeids = {1, 2, 1, 2};
+  std::vector<int64_t> target_ids = {0, 0, 0, 0};
+  std::vector<float> target_weights = {1.f, 2.f, 10.f, 20.f};
+
+  std::vector<float> X = {1.f, 3.f, 0.f, 0.f};
+  std::vector<float> results = {21.f, 12.f};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+
+  test.AddAttribute("n_targets", (int64_t)1);
+  test.AddAttribute("aggregate_function", "SUM");
+  test.AddInput<float>("X", {2, 2}, X);
+  test.AddOutput<float>("Y", {2, 1}, results);
+  test.Run();
+}
+
+//enough trees and rows for the batch to be split between threads, by rows or by trees
+TEST(MLOpTest, TreeRegressorManyTrees) {
+  const int64_t num_trees = 300;
+  std::vector<int64_t> lefts, rights, treeids, nodeids, featureids;
+  std::vector<float> thresholds;
+  std::vector<std::string> modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_ids;
+  std::vector<float> target_weights;
+  for (int64_t tree = 0; tree < num_trees; ++tree) {
+    lefts.insert(lefts.end(), {1, -1, -1});
+    rights.insert(rights.end(), {2, -1, -1});
+    treeids.insert(treeids.end(), {tree, tree, tree});
+    nodeids.insert(nodeids.end(), {0, 1, 2});
+    featureids.insert(featureids.end(), {0, -2, -2});
+    thresholds.insert(thresholds.end(), {0.5f, -2.f, -2.f});
+    modes.insert(modes.end(), {"BRANCH_LEQ", "LEAF", "LEAF"});
+    target_treeids.insert(target_treeids.end(), {tree, tree});
+    target_nodeids.insert(target_nodeids.end(), {1, 2});
+    target_ids.insert(target_ids.end(), {0, 0});
+    target_weights.insert(target_weights.end(), {1.f, 2.f});
+  }
+
+  for (int64_t N : {3, 200}) {
+    OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+    std::vector<float> X;
+    std::vector<float> results;
+    for (int64_t i = 0; i < N; ++i) {
+      X.push_back(static_cast<float>(i % 2));
+      results.push_back(i % 2 == 0 ? 300.f : 600.f);
+    }
+
+    test.AddAttribute("nodes_truenodeids", lefts);
+    test.AddAttribute("nodes_falsenodeids", rights);
+    test.AddAttribute("nodes_treeids", treeids);
+    test.AddAttribute("nodes_nodeids", nodeids);
+    test.AddAttribute("nodes_featureids", featureids);
+    test.AddAttribute("nodes_values", thresholds);
+    test.AddAttribute("nodes_modes", modes);
+    test.AddAttribute("target_treeids", target_treeids);
+    test.AddAttribute("target_nodeids", target_nodeids);
+    test.AddAttribute("target_ids", target_ids);
+    test.AddAttribute("target_weights", target_weights);
+
+    test.AddAttribute("n_targets", (int64_t)1);
+    test.AddAttribute("aggregate_function", "SUM");
+    test.AddInput<float>("X", {N, 1}, X);
+    test.AddOutput<float>("Y", {N, 1}, results);
+    test.Run();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -345,6 +345,21 @@ TEST(BatchNormTest, BatchNorm3d_Pytorch) {
   TestBatchNorm(input_data_map, input_shapes_map, epsilon, expected_output, input_shape);
 }
 
+// the statistics are initializers, which the kernel folds into a scale and shift per channel once
+TEST(BatchNormTest, ConstantStatistics) {
+  OpTester test("BatchNormalization");
+  vector<int64_t> input_shape{2, 2, 3};
+  test.AddInput<float>("X", input_shape, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, -1.f, -2.f, -3.f, 0.5f, 1.5f, 2.5f});
+  test.AddInput<float>("scale", {2}, {2.f, 0.5f}, true);
+  test.AddInput<float>("B", {2}, {0.1f, -0.2f}, true);
+  test.AddInput<float>("mean", {2}, {1.f, 3.f}, true);
+  test.AddInput<float>("var", {2}, {4.f, 0.25f}, true);
+  test.AddOutput<float>("output", input_shape,
+                        {0.1f, 1.099999f, 2.099998f, 0.79998f, 1.79996f, 2.79994f,
+                         -1.899998f, -2.899996f, -3.899995f, -2.69995f, -1.69997f, -0.69999f});
+  test.Run();
+}
+
 TEST(BatchNormTest, InvalidScaleDim) {
   vector<float> X{0.329876f, -0.287158f, -0.411425f, 0.473621f, 0.18156f, -0.170596f, -0.329516f, -0.170733f, -0.121664f, 0.4372f,
                   -0.485668f, 0.218049f, -0.360263f, 0.107016f, 0.45358f, 0.325056f, 0.15995f, 0.098852f, -0.283453f, -0.373051f,
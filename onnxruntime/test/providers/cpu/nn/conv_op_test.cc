@@ -542,5 +542,38 @@ TEST(ConvTest, Conv2D_group) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
 }
 
+// group equal to the channels, which MLAS computes with its depthwise algorithm
+TEST(ConvTest, Conv2D_Depthwise_Bias) {
+  ConvOpAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      3,                            // group
+      vector<int64_t>{3, 3},        // kernel_shape
+      vector<int64_t>{1, 1, 1, 1},  // pads
+      vector<int64_t>{1, 1}         // strides
+  };
+  vector<float> X;
+  for (int i = 0; i < 3 * 4 * 5; i++) {
+    X.push_back(static_cast<float>((i * 3) % 7 - 3));
+  }
+  vector<int64_t> X_shape = {1, 3, 4, 5};
+  vector<float> W;
+  for (int i = 0; i < 3 * 9; i++) {
+    W.push_back(static_cast<float>((i * 5) % 9 - 4) * 0.5f);
+  }
+  vector<int64_t> W_shape = {3, 1, 3, 3};
+  vector<float> B = {1.0f, -0.5f, 0.25f};
+  vector<int64_t> B_shape = {3};
+  vector<int64_t> Y_shape = {1, 3, 4, 5};
+  auto expected_vals = {0.0f, 5.5f, -10.0f, 9.5f, 4.0f, 1.0f, -0.5f, 3.0f, -4.0f, -5.5f,
+                        2.5f, 10.0f, -0.5f, -0.5f, 1.5f, 2.0f, 2.5f, 1.5f, 4.0f, 1.5f,
+                        -2.0f, -1.5f, 4.0f, -11.5f, 5.0f, 5.5f, -2.0f, -2.0f, 1.5f, -7.0f,
+                        -7.0f, 1.5f, 8.5f, -2.0f, 7.0f, 5.5f, -8.5f, 1.0f, 0.0f, 1.0f,
+                        1.75f, -2.75f, -0.75f, 4.75f, -9.25f, 1.75f, 9.25f, -1.25f, -1.25f, 0.75f,
+                        3.25f, -4.75f, 2.25f, 9.25f, -2.75f, -9.75f, 7.25f, -7.75f, 1.75f, -0.75f};
+
+  TestConvOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -112,5 +112,31 @@ TEST(InstanceNormalizationOpTest, InstanceNorm_2) {
   test.Run();
 }
 
+TEST(InstanceNormalizationOpTest, InstanceNorm_Unaligned) {
+  OpTester test("InstanceNormalization");
+  test.AddAttribute("epsilon", 1e-5F);
+
+  // 19 values a channel, which aren't a multiple of the statistics lanes
+  vector<float> input = {-5.0F, 2.25F, -1.5F, 5.75F, 2.0F, -1.75F, 5.5F, 1.75F, -2.0F, 5.25F,
+                         1.5F, -2.25F, 5.0F, 1.25F, 8.5F, 4.75F, 1.0F, 8.25F, 4.5F,
+
+                         0.75F, 8.0F, 4.25F, 0.5F, 7.75F, 4.0F, 11.25F, 7.5F, 3.75F, 11.0F,
+                         7.25F, 3.5F, 10.75F, 7.0F, 3.25F, 10.5F, 6.75F, 14.0F, 10.25F};
+  vector<int64_t> input_dims = {1, 2, 19};
+  test.AddInput<float>("input", input_dims, input);
+  test.AddInput<float>("scale", {2}, {0.5F, 2.0F});
+  test.AddInput<float>("B", {2}, {1.0F, -1.0F});
+
+  vector<float> expected_output = {-0.014026F, 0.985488F, 0.468498F, 1.468012F, 0.951022F, 0.434032F, 1.433546F,
+                                   0.916556F, 0.399566F, 1.399080F, 0.882090F, 0.365100F, 1.364614F, 0.847624F,
+                                   1.847138F, 1.330148F, 0.813158F, 1.812672F, 1.295682F,
+
+                                   -4.372943F, -0.427101F, -2.468054F, -4.509007F, -0.563164F, -2.604117F, 1.341725F,
+                                   -0.699228F, -2.740181F, 1.205661F, -0.835292F, -2.876244F, 1.069598F, -0.971355F,
+                                   -3.012308F, 0.933534F, -1.107419F, 2.838424F, 0.797471F};
+  test.AddOutput<float>("Y", input_dims, expected_output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
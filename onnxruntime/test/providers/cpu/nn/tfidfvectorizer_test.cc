@@ -555,5 +555,39 @@ TEST(TfIdfVectorizerTest, String_TFIDFWeights_onlyBigrams_Skip5) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(TfIdfVectorizerTest, Int32_TFIDFWeights_ManyBatches_Skip5) {
+  OpTester test("TfIdfVectorizer", opset_ver, domain);
+  // s=5, Min=1, Max=2, weights specified, int32
+  // Enough rows to be counted on several threads, and the
+  // weights apply to the columns of every row
+  InitTestAttr(test, "TFIDF", 1, 2, 5,
+               {0, 4},
+               {0, 1, 2, 3, 4, 5, 6},                //7 output indexes
+               {2.0, 2.0, 2.0, 2.0, 2.0, 3.0, 2.0},  // weights
+               {2, 3, 5, 4,                          //1-grams
+                5, 6, 7, 8, 6, 7},                   //bi-grams
+               {});
+
+  const int64_t B = 2048;
+  std::vector<int64_t> dims{B, 12};
+  std::vector<int32_t> input;
+  std::vector<float> output;
+  for (int64_t b = 0; b < B; ++b) {
+    if (b % 2 == 0) {
+      input.insert(input.end(), {1, 1, 3, 3, 3, 7, 8, 6, 7, 5, 6, 8});
+      output.insert(output.end(), {0, 6, 2, 0, 2, 9, 2});
+    } else {
+      input.insert(input.end(), {2, 2, 2, 2, 2, 2, 9, 9, 9, 9, 9, 9});
+      output.insert(output.end(), {12, 0, 0, 0, 0, 0, 0});
+    }
+  }
+  test.AddInput<int32_t>("T", dims, input);
+
+  std::vector<int64_t> out_dims{B, 7};
+  test.AddOutput<float>("Y", out_dims, output);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/reduction/reduction_ops.h"
+
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/cpu/reduction/reduction_test_cases.h"
@@ -1103,5 +1106,146 @@ TEST(ReductionOpTest, ArgMin_int32) {
   test.Run();
 }
 
+// rows longer than a warp's share are reduced by several blocks on CUDA
+TEST(ReductionOpTest, ReduceMean_last_axis_long_rows) {
+  const int64_t rows = 2, row_size = 3000;
+  std::vector<float> data;
+  std::vector<float> expected;
+  for (int64_t r = 0; r < rows; ++r) {
+    float sum = 0.0f;
+    for (int64_t i = 0; i < row_size; ++i) {
+      data.push_back(static_cast<float>((i + r) % 7));
+      sum += data.back();
+    }
+    expected.push_back(sum / row_size);
+  }
+
+  OpTester test("ReduceMean");
+  test.AddAttribute("axes", std::vector<int64_t>{-1});
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddInput<float>("data", {rows, row_size}, data);
+  test.AddOutput<float>("reduced", {rows, 1}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceSum_default_axes_large) {
+  std::vector<float> data;
+  float sum = 0.0f;
+  for (int i = 0; i < 5 * 4000; ++i) {
+    data.push_back(static_cast<float>(i % 5));
+    sum += data.back();
+  }
+
+  OpTester test("ReduceSum");
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddInput<float>("data", {5, 4000}, data);
+  test.AddOutput<float>("reduced", {1, 1}, {sum});
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceL2_trailing_axes) {
+  // the unit middle axis doesn't stop the reduced axes being contiguous
+  std::vector<float> data;
+  std::vector<float> expected;
+  for (int r = 0; r < 4; ++r) {
+    float sum_square = 0.0f;
+    for (int i = 0; i < 6; ++i) {
+      data.push_back(static_cast<float>(r - i));
+      sum_square += data.back() * data.back();
+    }
+    expected.push_back(std::sqrt(sum_square));
+  }
+
+  OpTester test("ReduceL2");
+  test.AddAttribute("axes", std::vector<int64_t>{2, 3});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", {4, 1, 2, 3}, data);
+  test.AddOutput<float>("reduced", {4, 1}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceMax_middle_axis) {
+  // reducing an axis that isn't trailing falls back to cuDNN on CUDA
+  OpTester test("ReduceMax");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", {2, 3, 2},
+                       {1.0f, 8.0f,
+                        5.0f, -2.0f,
+                        3.0f, 4.0f,
+
+                        -1.0f, 0.0f,
+                        -7.0f, 6.0f,
+                        2.0f, 9.0f});
+  test.AddOutput<float>("reduced", {2, 2}, {5.0f, 8.0f, 2.0f, 9.0f});
+  test.Run();
+}
+
+// the leading axis is reduced in place, with the rows of the output split in blocks
+TEST(ReductionOpTest, ReduceSum_leading_axis_long_rows) {
+  const int64_t rows = 3, row_size = 2500;
+  std::vector<float> data;
+  std::vector<float> expected(row_size, 0.0f);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t i = 0; i < row_size; ++i) {
+      data.push_back(static_cast<float>((i * (r + 1)) % 11));
+      expected[i] += data.back();
+    }
+  }
+
+  OpTester test("ReduceSum");
+  test.AddAttribute("axes", std::vector<int64_t>{0});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", {rows, row_size}, data);
+  test.AddOutput<float>("reduced", {row_size}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceMean_middle_axes) {
+  // [2, 3, 2, 2] reduced over the adjacent axes 1 and 2
+  std::vector<float> data;
+  for (int i = 0; i < 24; ++i) {
+    data.push_back(static_cast<float>(i));
+  }
+
+  OpTester test("ReduceMean");
+  test.AddAttribute("axes", std::vector<int64_t>{1, 2});
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddInput<float>("data", {2, 3, 2, 2}, data);
+  test.AddOutput<float>("reduced", {2, 1, 1, 2}, {5.0f, 6.0f, 17.0f, 18.0f});
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceMin_int32_leading_axes) {
+  OpTester test("ReduceMin");
+  test.AddAttribute("axes", std::vector<int64_t>{0, 1});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<int32_t>("data", {2, 2, 3},
+                         {5, 1, 9,
+                          4, 7, 2,
+
+                          8, 3, 6,
+                          0, 10, 11});
+  test.AddOutput<int32_t>("reduced", {3}, {0, 1, 2});
+  test.Run();
+}
+
+TEST(ReductionOpTest, GetReduceView) {
+  ReduceView view;
+  ASSERT_TRUE(GetReduceView({2, 3, 4}, {1}, view));
+  EXPECT_EQ(view.outer, 2);
+  EXPECT_EQ(view.reduced, 3);
+  EXPECT_EQ(view.inner, 4);
+
+  // the kept axis of size 1 between the reduced ones doesn't stop them being adjacent
+  ASSERT_TRUE(GetReduceView({2, 3, 1, 4, 5}, {1, 3}, view));
+  EXPECT_EQ(view.outer, 2);
+  EXPECT_EQ(view.reduced, 12);
+  EXPECT_EQ(view.inner, 5);
+
+  EXPECT_FALSE(GetReduceView({2, 3, 4}, {0, 2}, view));
+  EXPECT_FALSE(GetReduceView({2, 0, 4}, {1}, view));
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -208,5 +208,55 @@ TEST(MathOpTest, Concat3D_3) {
   test.Run();
 }
 
+// large enough to be copied in parallel, with each input one large block per row
+TEST(MathOpTest, Concat2D_Large) {
+  OpTester test("Concat");
+  test.AddAttribute("axis", int64_t{1});
+
+  const int64_t rows = 30, columns1 = 1000, columns2 = 1500;
+  std::vector<float> input1(rows * columns1), input2(rows * columns2), output;
+  for (int64_t i = 0; i < rows; i++) {
+    for (int64_t j = 0; j < columns1; j++) {
+      input1[i * columns1 + j] = static_cast<float>(i * 10000 + j);
+      output.push_back(input1[i * columns1 + j]);
+    }
+    for (int64_t j = 0; j < columns2; j++) {
+      input2[i * columns2 + j] = -static_cast<float>(i * 10000 + j);
+      output.push_back(input2[i * columns2 + j]);
+    }
+  }
+
+  test.AddInput<float>("input1", {rows, columns1}, input1);
+  test.AddInput<float>("input2", {rows, columns2}, input2);
+  test.AddOutput<float>("concat_result", {rows, columns1 + columns2}, output);
+  test.Run();
+}
+
+// many inputs of different widths along the axis, one of them empty, copied by one kernel on the GPU
+TEST(MathOpTest, Concat2D_ManyInputs) {
+  OpTester test("Concat");
+  test.AddAttribute("axis", int64_t{1});
+
+  const int64_t rows = 3;
+  const std::vector<int64_t> columns{4, 1, 0, 8, 3, 4, 2, 6};
+  int64_t total_columns = 0;
+  std::vector<std::vector<int16_t>> inputs(columns.size());
+  for (size_t k = 0; k < columns.size(); k++) {
+    for (int64_t i = 0; i < rows * columns[k]; i++) {
+      inputs[k].push_back(static_cast<int16_t>(k * 100 + i));
+    }
+    test.AddInput<int16_t>(("input" + std::to_string(k)).c_str(), {rows, columns[k]}, inputs[k]);
+    total_columns += columns[k];
+  }
+  std::vector<int16_t> output;
+  for (int64_t i = 0; i < rows; i++) {
+    for (size_t k = 0; k < columns.size(); k++) {
+      output.insert(output.end(), inputs[k].begin() + i * columns[k], inputs[k].begin() + (i + 1) * columns[k]);
+    }
+  }
+  test.AddOutput<int16_t>("concat_result", {rows, total_columns}, output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -271,6 +271,21 @@ TEST(GatherOpTest, Gather_axis1_indices2d_string) {
   test.Run();
 }
 
+TEST(GatherOpTest, Gather_axis0_string_rows) {
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<std::string>("data", {3, 2},
+                             {"0", "1",
+                              "10", "11",
+                              "20", "21"});
+  test.AddInput<int64_t>("indices", {3}, {2, 0, 2});
+  test.AddOutput<std::string>("output", {3, 2},
+                              {"20", "21",
+                               "0", "1",
+                               "20", "21"});
+  test.Run();
+}
+
 TEST(GatherOpTest, Gather_axis1_indices2d_bool) {
   OpTester test("Gather");
   test.AddAttribute<int64_t>("axis", 1LL);
@@ -302,5 +317,27 @@ TEST(GatherOpTest, Gather_perf) {
   test.AddOutput<int32_t>("output", {800, 1, 100}, output);
   test.Run();
 }
+// an embedding lookup large enough to be gathered in parallel
+TEST(GatherOpTest, Gather_axis0_embedding) {
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 0LL);
+
+  const int64_t rows = 1000, width = 256, count = 500;
+  std::vector<float> data(rows * width);
+  for (int64_t i = 0; i < static_cast<int64_t>(data.size()); i++)
+    data[i] = static_cast<float>(i);
+
+  std::vector<int64_t> indices(count);
+  std::vector<float> output;
+  for (int64_t i = 0; i < count; i++) {
+    indices[i] = (i * 37) % rows;
+    output.insert(output.end(), data.begin() + indices[i] * width, data.begin() + (indices[i] + 1) * width);
+  }
+
+  test.AddInput<float>("data", {rows, width}, data);
+  test.AddInput<int64_t>("indices", {count}, indices);
+  test.AddOutput<float>("output", {count, width}, output);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
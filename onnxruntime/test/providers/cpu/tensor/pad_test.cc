@@ -160,5 +160,37 @@ TEST(TensorOpTest, Pad_Reflect_2D) {
   test.Run();
 }
 
+// large enough for the rows of the outermost axis to be padded in parallel
+TEST(TensorOpTest, Pad_Reflect_3D_Large) {
+  const int64_t D0 = 64, D1 = 16, D2 = 32;
+  const int64_t pads[] = {2, 1, 3, 1, 2, 2};
+  std::vector<float> input(D0 * D1 * D2);
+  for (size_t i = 0; i < input.size(); i++) {
+    input[i] = static_cast<float>(i);
+  }
+
+  // reflect an output index into the input, which mode edge would clamp instead
+  auto reflect = [](int64_t index, int64_t dim) {
+    return index < 0 ? -index : index >= dim ? 2 * (dim - 1) - index : index;
+  };
+  const int64_t O0 = D0 + pads[0] + pads[3], O1 = D1 + pads[1] + pads[4], O2 = D2 + pads[2] + pads[5];
+  std::vector<float> output;
+  for (int64_t i = 0; i < O0; i++) {
+    for (int64_t j = 0; j < O1; j++) {
+      for (int64_t k = 0; k < O2; k++) {
+        const int64_t x = reflect(i - pads[0], D0), y = reflect(j - pads[1], D1), z = reflect(k - pads[2], D2);
+        output.push_back(input[(x * D1 + y) * D2 + z]);
+      }
+    }
+  }
+
+  OpTester test("Pad");
+  test.AddAttribute("pads", std::vector<int64_t>(pads, pads + 6));
+  test.AddAttribute("mode", "reflect");
+  test.AddInput<float>("data", {D0, D1, D2}, input);
+  test.AddOutput<float>("output", {O0, O1, O2}, output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -158,5 +158,67 @@ TEST(SliceTest, Slice1D_String) {
   test.Run();
 }
 
+// slices the channels of NCHW data, which copies runs of H*W elements, in parallel as there are many of them
+TEST(SliceTest, Slice4D_Channels_Large) {
+  OpTester test("Slice");
+
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("starts", std::vector<int64_t>{3});
+  test.AddAttribute("ends", std::vector<int64_t>{13});
+
+  const int64_t batch = 2, channels = 16, spatial = 56 * 56;
+  std::vector<float> input(batch * channels * spatial), output;
+  for (int64_t i = 0; i < static_cast<int64_t>(input.size()); i++)
+    input[i] = static_cast<float>(i);
+  for (int64_t n = 0; n < batch; n++)
+    for (int64_t c = 3; c < 13; c++)
+      for (int64_t s = 0; s < spatial; s++)
+        output.push_back(input[(n * channels + c) * spatial + s]);
+
+  test.AddInput<float>("data", {batch, channels, 56, 56}, input);
+  test.AddOutput<float>("output", {batch, 10, 56, 56}, output);
+  test.Run();
+}
+
+// slices the innermost axis, so each run is shorter than the chunks copied in parallel
+TEST(SliceTest, Slice2D_Inner_Large) {
+  OpTester test("Slice");
+
+  test.AddAttribute("starts", std::vector<int64_t>{1, 5});
+  test.AddAttribute("ends", std::vector<int64_t>{1000, 12});
+
+  const int64_t rows = 1000, columns = 64;
+  std::vector<int32_t> input(rows * columns), output;
+  for (int64_t i = 0; i < static_cast<int64_t>(input.size()); i++)
+    input[i] = static_cast<int32_t>(i);
+  for (int64_t i = 1; i < rows; i++)
+    for (int64_t j = 5; j < 12; j++)
+      output.push_back(input[i * columns + j]);
+
+  test.AddInput<int32_t>("data", {rows, columns}, input);
+  test.AddOutput<int32_t>("output", {rows - 1, 7}, output);
+  test.Run();
+}
+
+// slices the innermost axis at a start and width of four floats, which the GPU copies as 16 byte vectors
+TEST(SliceTest, Slice2D_Inner_Aligned) {
+  OpTester test("Slice");
+
+  test.AddAttribute("starts", std::vector<int64_t>{2, 4});
+  test.AddAttribute("ends", std::vector<int64_t>{30, 12});
+
+  const int64_t rows = 32, columns = 16;
+  std::vector<float> input(rows * columns), output;
+  for (int64_t i = 0; i < static_cast<int64_t>(input.size()); i++)
+    input[i] = static_cast<float>(i);
+  for (int64_t i = 2; i < 30; i++)
+    for (int64_t j = 4; j < 12; j++)
+      output.push_back(input[i * columns + j]);
+
+  test.AddInput<float>("data", {rows, columns}, input);
+  test.AddOutput<float>("output", {28, 8}, output);
+  test.Run();
+}
+
 }  // namespace Test
 }  // namespace onnxruntime
@@ -266,6 +266,36 @@ TEST(SplitOperatorTest, NegativeAxis) {
   RunTest(axis, {}, input, outputs);
 }
 
+// large enough for the rows of each output to be copied in parallel
+TEST(SplitOperatorTest, Axis1UnequalSplitLarge) {
+  const int64_t axis = 1;
+  const int64_t rows = 40, columns = 1000;
+  std::vector<int64_t> splits{300, 700};
+
+  std::vector<float> input(rows * columns), output1, output2;
+  for (int64_t i = 0; i < rows; i++) {
+    for (int64_t j = 0; j < columns; j++) {
+      input[i * columns + j] = static_cast<float>(i * columns + j);
+      (j < splits[0] ? output1 : output2).push_back(input[i * columns + j]);
+    }
+  }
+
+  std::vector<ShapeAndData> outputs;
+  outputs.push_back({{rows, splits[0]}, output1});
+  outputs.push_back({{rows, splits[1]}, output2});
+
+  RunTest(axis, splits, {{rows, columns}, input}, outputs);
+}
+
+TEST(SplitOperatorTest, Axis0EqualSplitDouble) {
+  OpTester test("Split");
+  test.AddAttribute("axis", int64_t{0});
+  test.AddInput<double>("input", {4, 2}, {1., 2., 3., 4., 5., 6., 7., 8.});
+  test.AddOutput<double>("output0", {2, 2}, {1., 2., 3., 4.});
+  test.AddOutput<double>("output1", {2, 2}, {5., 6., 7., 8.});
+  test.Run();
+}
+
 TEST(SplitOperatorTest, InvalidAxis) {
   const int64_t axis = 2;
   std::vector<ShapeAndData> outputs;
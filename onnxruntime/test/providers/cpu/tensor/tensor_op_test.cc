@@ -7,6 +7,8 @@
 #include "core/providers/cpu/tensor/crop.h"
 #include "core/util/math.h"
 
+#include <limits>
+
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 namespace test {
@@ -277,6 +279,64 @@ TEST(TensorOpTest, CastFromFloat16) {
   TestCastOp(input, int64_t_data, shape, TensorProto::INT64);
 }
 
+// large enough to be cast in several chunks, through the float buffer of each chunk
+TEST(TensorOpTest, CastFromFloat16Large) {
+  const int64_t size = 40000;
+  std::vector<MLFloat16> input;
+  std::vector<int32_t> output;
+  for (int64_t i = 0; i < size; ++i) {
+    const int32_t value = static_cast<int32_t>(i % 2048) - 1024;
+    input.push_back(MLFloat16(math::floatToHalf(static_cast<float>(value))));
+    output.push_back(value);
+  }
+
+  OpTester test("Cast");
+  test.AddAttribute("to", int64_t{TensorProto::INT32});
+  test.AddInput<MLFloat16>("input", {size}, input);
+  test.AddOutput<int32_t>("output", {size}, output);
+  test.Run();
+}
+
+TEST(TensorOpTest, CastToString) {
+  OpTester test("Cast", 9);
+  test.AddAttribute("to", int64_t{TensorProto::STRING});
+  test.AddInput<float>("input", {2, 3}, {0.0f, -1.25f, 3.0f, 0.5f, std::numeric_limits<float>::infinity(), 1e20f});
+  test.AddOutput<std::string>("output", {2, 3}, {"0", "-1.25", "3", "0.5", "INF", "1.00000002e+20"});
+  test.Run();
+}
+
+TEST(TensorOpTest, CastIntToString) {
+  OpTester test("Cast", 9);
+  test.AddAttribute("to", int64_t{TensorProto::STRING});
+  test.AddInput<int64_t>("input", {4}, {0, -7, 42, std::numeric_limits<int64_t>::max()});
+  test.AddOutput<std::string>("output", {4}, {"0", "-7", "42", "9223372036854775807"});
+  test.Run();
+}
+
+TEST(TensorOpTest, CastFromString) {
+  OpTester test("Cast", 9);
+  test.AddAttribute("to", int64_t{TensorProto::FLOAT});
+  test.AddInput<std::string>("input", {2, 2}, {"0", "-1.25", " 3e2", "-INF"});
+  test.AddOutput<float>("output", {2, 2}, {0.0f, -1.25f, 300.0f, -std::numeric_limits<float>::infinity()});
+  test.Run();
+}
+
+TEST(TensorOpTest, CastStringToInt) {
+  OpTester test("Cast", 9);
+  test.AddAttribute("to", int64_t{TensorProto::INT32});
+  test.AddInput<std::string>("input", {3}, {"12", "-5", "2147483647"});
+  test.AddOutput<int32_t>("output", {3}, {12, -5, 2147483647});
+  test.Run();
+}
+
+TEST(TensorOpTest, CastFromInvalidString) {
+  OpTester test("Cast", 9);
+  test.AddAttribute("to", int64_t{TensorProto::FLOAT});
+  test.AddInput<std::string>("input", {2}, {"1", "one"});
+  test.AddOutput<float>("output", {2}, {1.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Cast: the string 'one' is not a number.");
+}
+
 TEST(TensorOpTest, CropBorderOnly) {
   const int N = 2, C = 1, H = 3, W = 4;
   std::vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f,
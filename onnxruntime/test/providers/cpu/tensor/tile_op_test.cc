@@ -84,5 +84,30 @@ TEST(TensorOpTest, Tile3D) {
   test.Run();
 }
 
+// large enough for the rows of the outermost axis to be tiled in parallel
+TEST(TensorOpTest, Tile3D_Large) {
+  const int64_t D0 = 32, D1 = 8, D2 = 17;
+  const int64_t repeats[] = {3, 5, 7};
+  std::vector<float> input(D0 * D1 * D2);
+  for (size_t i = 0; i < input.size(); i++) {
+    input[i] = static_cast<float>(i);
+  }
+
+  std::vector<float> output;
+  for (int64_t i = 0; i < D0 * repeats[0]; i++) {
+    for (int64_t j = 0; j < D1 * repeats[1]; j++) {
+      for (int64_t k = 0; k < D2 * repeats[2]; k++) {
+        output.push_back(input[((i % D0) * D1 + j % D1) * D2 + k % D2]);
+      }
+    }
+  }
+
+  OpTester test("Tile");
+  test.AddInput<float>("input", {D0, D1, D2}, input);
+  test.AddInput<int64_t>("repeats", {3}, std::vector<int64_t>(repeats, repeats + 3));
+  test.AddOutput<float>("output", {D0 * repeats[0], D1 * repeats[1], D2 * repeats[2]}, output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
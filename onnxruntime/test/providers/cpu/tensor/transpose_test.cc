@@ -105,5 +105,79 @@ TEST(TransposeOpTest, ThreeDim) {
   TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals);
 }
 
+// Transposes an input of consecutive values by its permutation, computing the expected output element by element
+static void TransposeByIndexTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+
+  std::vector<int64_t> expected_shape(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    expected_shape[i] = input_shape[perm[i]];
+  }
+
+  const int64_t size = input_strides[0] * input_shape[0];
+  std::vector<float> input_vals(size);
+  for (int64_t i = 0; i < size; ++i) {
+    input_vals[i] = static_cast<float>(i);
+  }
+
+  std::vector<float> expected_vals;
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t i = 0; i < size; ++i) {
+    int64_t offset = 0;
+    for (size_t j = 0; j < rank; ++j) {
+      offset += index[j] * input_strides[perm[j]];
+    }
+    expected_vals.push_back(input_vals[offset]);
+
+    for (size_t j = rank; j-- > 0;) {
+      if (++index[j] < expected_shape[j]) {
+        break;
+      }
+      index[j] = 0;
+    }
+  }
+
+  OpTester test("Transpose");
+  test.AddAttribute("perm", perm);
+  test.AddInput<float>("X", input_shape, input_vals);
+  test.AddOutput<float>("Y", expected_shape, expected_vals);
+  test.Run();
+}
+
+// the permutations that reduce to the transpose of a batch of matrices, with tiles that don't divide the matrices
+TEST(TransposeOpTest, NCHWToNHWC) {
+  TransposeByIndexTest({1, 19, 17, 5}, {0, 2, 3, 1});
+  TransposeByIndexTest({3, 6, 5, 7}, {0, 2, 3, 1});
+}
+
+TEST(TransposeOpTest, NHWCToNCHW) {
+  TransposeByIndexTest({1, 5, 17, 19}, {0, 3, 1, 2});
+  TransposeByIndexTest({2, 7, 3, 33}, {0, 3, 1, 2});
+}
+
+TEST(TransposeOpTest, LargeTwoDim) {
+  TransposeByIndexTest({67, 130}, {1, 0});
+}
+
+TEST(TransposeOpTest, BatchedTwoDim) {
+  // more tiles than a block of threads copies in each dim, and an attention score layout of four dims
+  TransposeByIndexTest({3, 70, 45}, {0, 2, 1});
+  TransposeByIndexTest({2, 3, 33, 40}, {0, 1, 3, 2});
+}
+
+TEST(TransposeOpTest, UnitAxes) {
+  // the axes of size 1 don't stop the others being merged into a 2D transpose
+  TransposeByIndexTest({4, 1, 6, 1}, {3, 2, 1, 0});
+  TransposeByIndexTest({2, 3, 1, 4}, {2, 0, 1, 3});
+}
+
+TEST(TransposeOpTest, AttentionHeads) {
+  TransposeByIndexTest({2, 5, 3, 4}, {0, 2, 1, 3});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
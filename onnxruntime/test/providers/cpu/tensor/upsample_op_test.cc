@@ -350,5 +350,85 @@ TEST(UpsampleOpTest, UpsampleOpNearest2XTest_opset9) {
   test.AddOutput<int32_t>("Y", {N, C, (int64_t)(H * scales[2]), (int64_t)(W * scales[3])}, Y);
   test.Run();
 }
+
+TEST(UpsampleOpTest, UpsampleOpBilinearTest_NHWC) {
+  OpTester test("Upsample");
+
+  std::vector<float> scales{1.0f, 2.0f, 4.0f, 1.0f};
+  test.AddAttribute("mode", "linear");
+  test.AddAttribute("scales", scales);
+
+  // the channels of UpsampleOpBilinearTest's batch, interleaved
+  const int64_t N = 1, H = 2, W = 2, C = 2;
+  std::vector<float> X = {1.0f, 3.0f, 3.0f, 5.0f,
+                          3.0f, 7.0f, 5.0f, 9.0f};
+
+  test.AddInput<float>("X", {N, H, W, C}, X);
+
+  std::vector<float> Y = {
+      1.0f, 3.0f, 1.5f, 3.5f, 2.0f, 4.0f, 2.5f, 4.5f, 3.0f, 5.0f, 3.0f, 5.0f, 3.0f, 5.0f, 3.0f, 5.0f,
+      2.0f, 5.0f, 2.5f, 5.5f, 3.0f, 6.0f, 3.5f, 6.5f, 4.0f, 7.0f, 4.0f, 7.0f, 4.0f, 7.0f, 4.0f, 7.0f,
+      3.0f, 7.0f, 3.5f, 7.5f, 4.0f, 8.0f, 4.5f, 8.5f, 5.0f, 9.0f, 5.0f, 9.0f, 5.0f, 9.0f, 5.0f, 9.0f,
+      3.0f, 7.0f, 3.5f, 7.5f, 4.0f, 8.0f, 4.5f, 8.5f, 5.0f, 9.0f, 5.0f, 9.0f, 5.0f, 9.0f, 5.0f, 9.0f};
+
+  test.AddOutput<float>("Y", {N, (int64_t)(H * scales[1]), (int64_t)(W * scales[2]), C}, Y);
+  test.Run();
+}
+
+TEST(UpsampleOpTest, UpsampleOpNearestTest_Channels) {
+  OpTester test("Upsample");
+
+  std::vector<float> scales{1.0f, 2.0f, 1.0f, 1.0f};
+  test.AddAttribute("mode", "nearest");
+  test.AddAttribute("scales", scales);
+
+  const int64_t N = 2, C = 1, H = 2, W = 2;
+  std::vector<float> X = {1.0f, 3.0f,
+                          3.0f, 5.0f,
+
+                          3.0f, 5.0f,
+                          7.0f, 9.0f};
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+
+  std::vector<float> Y = {
+      1.0f, 3.0f, 3.0f, 5.0f,
+      1.0f, 3.0f, 3.0f, 5.0f,
+
+      3.0f, 5.0f, 7.0f, 9.0f,
+      3.0f, 5.0f, 7.0f, 9.0f};
+
+  test.AddOutput<float>("Y", {N, (int64_t)(C * scales[1]), H, W}, Y);
+  test.Run();
+}
+
+TEST(UpsampleOpTest, UpsampleOpNearestTest_Large) {
+  OpTester test("Upsample");
+
+  std::vector<float> scales{1.0f, 1.0f, 2.0f, 3.0f};
+  test.AddAttribute("mode", "nearest");
+  test.AddAttribute("scales", scales);
+
+  const int64_t N = 2, C = 16, H = 40, W = 50;
+  const int64_t output_height = H * 2, output_width = W * 3;
+  std::vector<float> X(N * C * H * W);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>(i);
+  }
+
+  std::vector<float> Y;
+  for (int64_t image = 0; image < N * C; ++image) {
+    for (int64_t y = 0; y < output_height; ++y) {
+      for (int64_t x = 0; x < output_width; ++x) {
+        Y.push_back(X[(image * H + y / 2) * W + x / 3]);
+      }
+    }
+  }
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddOutput<float>("Y", {N, C, output_height, output_width}, Y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -376,6 +376,7 @@ void OpTester::Run(ExpectResult expect_result,
     SessionOptions so;
     so.session_logid = op_;
     so.session_log_verbosity_level = 1;
+    so.weight_compression = weight_compression_;
 
     static const std::string all_provider_types[] = {
         kCpuExecutionProvider,
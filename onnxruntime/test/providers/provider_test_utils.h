@@ -226,6 +226,9 @@ class OpTester {
   void SetOutputAbsErr(const char* name, float v);
   void SetOutputRelErr(const char* name, float v);
 
+  // how the kernels store the constant matrices they multiply by, for the session the test runs in
+  void SetWeightCompression(WeightCompression compression) { weight_compression_ = compression; }
+
   template <typename T>
   void AddAttribute(std::string name, T value) {
     // Generate a the proper AddAttribute call for later
@@ -323,6 +326,7 @@ class OpTester {
   int opset_version_;
   bool add_shape_to_tensor_data_ = true;
   int add_symbolic_dim_to_tensor_data_ = -1;
+  WeightCompression weight_compression_ = WeightCompression::kNone;
   std::vector<Data> input_data_;
   std::vector<Data> output_data_;
   std::vector<size_t> initializer_index_;
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifdef USE_TRT
+
+#include <algorithm>
+#include <cstdio>
+#include "gtest/gtest.h"
+#include "core/framework/compute_capability.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/model.h"
+#include "core/providers/trt/trt_engine_cache.h"
+#include "core/providers/trt/trt_execution_provider.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/default_providers.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+static TypeProto FloatTensorType(const std::vector<int64_t>& dims) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (auto dim : dims) {
+    auto* shape_dim = type.mutable_tensor_type()->mutable_shape()->add_dim();
+    if (dim < 0) {
+      shape_dim->set_dim_param("N");
+    } else {
+      shape_dim->set_dim_value(dim);
+    }
+  }
+  return type;
+}
+
+TEST(TRTExecutionProviderTest, ParseSettings) {
+  TRTExecutionProviderInfo info;
+  ASSERT_TRUE(ParseTRTSettings("trt_engine_cache_path: C:\\cache, trt_fp16_enable:1, trt_max_workspace_size:1024,"
+                               " trt_min_subgraph_size:3",
+                               info)
+                  .IsOK());
+  EXPECT_EQ(info.engine_cache_path, "C:\\cache");
+  EXPECT_TRUE(info.fp16_enable);
+  EXPECT_FALSE(info.int8_enable);
+  EXPECT_EQ(info.max_workspace_size, 1024u);
+  EXPECT_EQ(info.min_subgraph_size, 3u);
+
+  EXPECT_TRUE(ParseTRTSettings("", info).IsOK());
+  EXPECT_FALSE(ParseTRTSettings("trt_fp16_enable:yes", info).IsOK());
+  EXPECT_FALSE(ParseTRTSettings("trt_max_workspace_size:-1", info).IsOK());
+  // int8 needs the scales of a calibration table
+  EXPECT_FALSE(ParseTRTSettings("trt_int8_enable:1", info).IsOK());
+  EXPECT_FALSE(ParseTRTSettings("unknown:1", info).IsOK());
+}
+
+TEST(TRTExecutionProviderTest, EngineCacheFile) {
+  const std::string key = "trt_engine_cache_test";
+  const std::string file_path = "./" + key + ".engine";
+  std::remove(file_path.c_str());
+
+  trt::TRTEngineCache cache(".");
+  std::string data;
+  EXPECT_FALSE(cache.Load(key, data));
+  const std::string engine("serialized\0engine", 17);
+  cache.Save(key, engine.data(), engine.size());
+  ASSERT_TRUE(cache.Load(key, data));
+  EXPECT_EQ(data, engine);
+  std::remove(file_path.c_str());
+
+  // nothing is cached without a cache path
+  trt::TRTEngineCache no_cache("");
+  no_cache.Save(key, engine.data(), engine.size());
+  EXPECT_FALSE(no_cache.Load(key, data));
+}
+
+// A = Relu(X), B = Affine(A), C = Add(A, B), where fusing Relu and Add into one node would make it depend on its
+// own output through the Affine TensorRT doesn't support
+TEST(TRTExecutionProviderTest, SubgraphsWithoutCycles) {
+  Model model("TRTSubgraphsWithoutCycles");
+  auto& graph = model.MainGraph();
+  TypeProto type = FloatTensorType({2, 3});
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& a = graph.GetOrCreateNodeArg("A", &type);
+  auto& b = graph.GetOrCreateNodeArg("B", &type);
+  auto& c = graph.GetOrCreateNodeArg("C", &type);
+  auto& d = graph.GetOrCreateNodeArg("D", &type);
+  graph.AddNode("relu", "Relu", "", {&x}, {&a});
+  graph.AddNode("affine", "Affine", "", {&a}, {&b});
+  graph.AddNode("add", "Add", "", {&a, &b}, {&c});
+  graph.AddNode("sigmoid", "Sigmoid", "", {&c}, {&d});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  TRTExecutionProvider provider;
+  GraphViewer graph_viewer(graph);
+  auto capabilities = provider.GetCapability(graph_viewer, {});
+  ASSERT_EQ(capabilities.size(), 2u);
+  EXPECT_EQ(capabilities[0]->sub_graph->nodes.size(), 1u);
+  EXPECT_EQ(capabilities[0]->sub_graph->GetMetaDef()->outputs, std::vector<std::string>{"A"});
+  // Add and Sigmoid are fused, only the output of Sigmoid is used outside of them
+  EXPECT_EQ(capabilities[1]->sub_graph->nodes.size(), 2u);
+  EXPECT_EQ(capabilities[1]->sub_graph->GetMetaDef()->inputs, (std::vector<std::string>{"A", "B"}));
+  EXPECT_EQ(capabilities[1]->sub_graph->GetMetaDef()->outputs, std::vector<std::string>{"D"});
+}
+
+// Y = Affine(Relu(X + X)), with TensorRT running Add and Relu for each batch size, and CUDA running Affine
+TEST(TRTExecutionProviderTest, FallBackToCuda) {
+  Model model("TRTFallBackToCuda");
+  auto& graph = model.MainGraph();
+  TypeProto type = FloatTensorType({-1, 4});
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &type);
+  auto& relu = graph.GetOrCreateNodeArg("relu", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+  graph.AddNode("add", "Add", "", {&x, &x}, {&sum});
+  graph.AddNode("relu", "Relu", "", {&sum}, {&relu});
+  auto& affine = graph.AddNode("affine", "Affine", "", {&relu}, {&y});
+  affine.AddAttribute("alpha", 2.f);
+  affine.AddAttribute("beta", 1.f);
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+
+  SessionOptions so;
+  so.session_logid = "TRTExecutionProviderTest.FallBackToCuda";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(DefaultTRTExecutionProvider()).IsOK());
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(DefaultCudaExecutionProvider()).IsOK());
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  for (int64_t batch : {1, 3, 1}) {
+    std::vector<float> values;
+    for (int64_t v = 0; v < batch * 4; v++) {
+      values.push_back(static_cast<float>(v - 2));
+    }
+    MLValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {batch, 4}, values,
+                         &input_value);
+    std::vector<MLValue> fetches;
+    status = session_object.Run(RunOptions{}, NameMLValMap{{"X", input_value}}, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const Tensor& result = fetches[0].Get<Tensor>();
+    ASSERT_EQ(result.Shape(), TensorShape({batch, 4}));
+    for (int64_t v = 0; v < batch * 4; v++) {
+      EXPECT_FLOAT_EQ(result.Data<float>()[v], 2.f * std::max(0.f, 2.f * (v - 2)) + 1.f);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
+
+#endif  // USE_TRT
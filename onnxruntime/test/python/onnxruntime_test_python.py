@@ -5,6 +5,7 @@
 import unittest
 import os
 import sys
+import threading
 import numpy as np
 import onnxruntime as onnxrt
 from onnxruntime.capi._pybind_state import onnxruntime_ostream_redirect
@@ -40,6 +41,26 @@ class TestInferenceSession(unittest.TestCase):
         output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
         np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunModelWithIOBinding(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.pb"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        binding = sess.io_binding()
+        binding.bind_input("X", x)
+        binding.bind_output("Y")
+        sess.run_with_iobinding(binding)
+        output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        np.testing.assert_allclose(output_expected, binding.copy_outputs_to_cpu()[0], rtol=1e-05, atol=1e-08)
+
+        # the output is fed back as a DLPack capsule sharing its memory
+        capsules = binding.get_outputs_as_dlpack()
+        self.assertEqual(len(capsules), 1)
+        binding.bind_input("X", capsules[0])
+        sess.run_with_iobinding(binding)
+        np.testing.assert_allclose(output_expected * output_expected, binding.copy_outputs_to_cpu()[0],
+                                   rtol=1e-05, atol=1e-08)
+        # a capsule is consumed once
+        self.assertRaises(RuntimeError, binding.bind_input, "X", capsules[0])
+
     def testRunModelFromBytes(self):
         with open(self.get_name("mul_1.pb"), "rb") as f:
             content = f.read()
@@ -57,6 +78,44 @@ class TestInferenceSession(unittest.TestCase):
         output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
         np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunModelNonContiguousInput(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.pb"))
+        x = np.array([[1.0, 3.0, 5.0], [2.0, 4.0, 6.0]], dtype=np.float32).T
+        self.assertFalse(x.flags['C_CONTIGUOUS'])
+        res = sess.run(["Y"], {"X": x})
+        output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+    def testOutputOutlivesSession(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.pb"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        res = sess.run(["Y"], {"X": x})
+        del sess
+        x[:] = 0
+        output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+    def testRunModelConcurrently(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.pb"))
+        output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        errors = []
+
+        def run():
+            try:
+                for i in range(100):
+                    x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+                    res = sess.run(["Y"], {"X": x})
+                    np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+            except Exception as e:
+                errors.append(e)
+
+        threads = [threading.Thread(target=run) for i in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual([], errors)
+
     def testRunModel2(self):
         sess = onnxrt.InferenceSession(self.get_name("matmul_1.pb"))
         x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
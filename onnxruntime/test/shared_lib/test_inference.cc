@@ -167,6 +167,35 @@ TEST_F(CApiTest, create_tensor) {
     std::string result(data_len, '\0');
     std::vector<size_t> offsets(len);
     ORT_THROW_ON_ERROR(OrtGetStringTensorContent(tensor.get(), (void*)result.data(), data_len, offsets.data(), offsets.size()));
+    ASSERT_EQ(result, "abckmp");
+    ASSERT_EQ(offsets, (std::vector<size_t>{0, 3}));
+  }
+}
+
+TEST_F(CApiTest, fill_string_tensor_from_content) {
+  // the strings "ab", "", "c\0d"
+  const char content[] = {'a', 'b', 'c', '\0', 'd'};
+  const size_t content_offsets[] = {0, 2, 2};
+  size_t expected_len = 3;
+  std::unique_ptr<MockedOrtAllocator> default_allocator(std::make_unique<MockedOrtAllocator>());
+  {
+    std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> tensor(
+        OrtCreateTensorAsOrtValue(default_allocator.get(), {expected_len}, ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING), OrtReleaseValue);
+    ORT_THROW_ON_ERROR(OrtFillStringTensorFromContent(tensor.get(), content, sizeof(content), content_offsets, expected_len));
+
+    size_t data_len;
+    ORT_THROW_ON_ERROR(OrtGetStringTensorDataLength(tensor.get(), &data_len));
+    ASSERT_EQ(data_len, sizeof(content));
+    std::string result(data_len, '\0');
+    std::vector<size_t> offsets(expected_len);
+    ORT_THROW_ON_ERROR(OrtGetStringTensorContent(tensor.get(), (void*)result.data(), data_len, offsets.data(), offsets.size()));
+    ASSERT_EQ(result, std::string(content, sizeof(content)));
+    ASSERT_EQ(offsets, (std::vector<size_t>{0, 2, 2}));
+
+    const size_t bad_offsets[] = {0, 3, 2};
+    OrtStatus* status = OrtFillStringTensorFromContent(tensor.get(), content, sizeof(content), bad_offsets, expected_len);
+    ASSERT_NE(status, nullptr);
+    OrtReleaseStatus(status);
   }
 }
 
@@ -190,6 +219,61 @@ TEST_F(CApiTest, create_tensor_with_data) {
   OrtReleaseTypeInfo(type_info);
 }
 
+TEST_F(CApiTest, run_with_io_binding) {
+  SessionOptionsWrapper sf(env);
+  std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)> session(sf.OrtCreateSession(MODEL_URI), OrtReleaseSession);
+
+  OrtIoBinding* binding_ptr;
+  ORT_THROW_ON_ERROR(OrtCreateIoBinding(session.get(), &binding_ptr));
+  std::unique_ptr<OrtIoBinding, decltype(&OrtReleaseIoBinding)> binding(binding_ptr, OrtReleaseIoBinding);
+
+  float values_x[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  constexpr size_t values_x_length = sizeof(values_x) / sizeof(values_x[0]);
+  OrtAllocatorInfo* info;
+  ORT_THROW_ON_ERROR(OrtCreateAllocatorInfo("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault, &info));
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> x(
+      OrtCreateTensorWithDataAsOrtValue(info, values_x, values_x_length * sizeof(float), {3, 2}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT), OrtReleaseValue);
+  OrtReleaseAllocatorInfo(info);
+  ORT_THROW_ON_ERROR(OrtBindInput(binding.get(), "X", x.get()));
+
+  // the session has no allocator for this location
+  ORT_THROW_ON_ERROR(OrtCreateAllocatorInfo("Cpu", OrtDeviceAllocator, 7, OrtMemTypeDefault, &info));
+  OrtStatus* status = OrtBindOutputToDevice(binding.get(), "Y", info);
+  OrtReleaseAllocatorInfo(info);
+  ASSERT_NE(status, nullptr);
+  ASSERT_EQ(OrtGetErrorCode(status), ORT_INVALID_ARGUMENT);
+  OrtReleaseStatus(status);
+
+  ORT_THROW_ON_ERROR(OrtCreateCpuAllocatorInfo(OrtArenaAllocator, OrtMemTypeDefault, &info));
+  ORT_THROW_ON_ERROR(OrtBindOutputToDevice(binding.get(), "Y", info));
+  OrtReleaseAllocatorInfo(info);
+  ORT_THROW_ON_ERROR(OrtSynchronizeBoundInputs(binding.get()));
+
+  // the bound input shares the buffer of values_x, so the second run reads the values written to it
+  for (int run = 0; run < 2; ++run) {
+    ORT_THROW_ON_ERROR(OrtRunWithBinding(session.get(), nullptr, binding.get()));
+    ORT_THROW_ON_ERROR(OrtSynchronizeBoundOutputs(binding.get()));
+
+    OrtValue* y;
+    ORT_THROW_ON_ERROR(OrtGetBoundOutputs(binding.get(), &y, 1));
+    std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> y_holder(y, OrtReleaseValue);
+    float* values_y;
+    ORT_THROW_ON_ERROR(OrtGetTensorMutableData(y, (void**)&values_y));
+    for (size_t i = 0; i != values_x_length; ++i) {
+      ASSERT_EQ(values_x[i] * values_x[i], values_y[i]);
+    }
+
+    for (size_t i = 0; i != values_x_length; ++i) {
+      values_x[i] += 1.0f;
+    }
+  }
+
+  OrtValue* outputs[2];
+  status = OrtGetBoundOutputs(binding.get(), outputs, 2);
+  ASSERT_NE(status, nullptr);
+  OrtReleaseStatus(status);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifdef USE_NUPHAR
+
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include <tvm/tvm.h>
+#include <tvm/build_module.h>
+#include "core/graph/model.h"
+#include "core/providers/nuphar/nuphar_execution_provider.h"
+#include "core/providers/nuphar/nuphar_module_cache.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+TEST(NupharExecutionProviderTest, ParseSettings) {
+  NupharExecutionProviderInfo info;
+  ASSERT_TRUE(ParseNupharSettings("nuphar_cache_path: C:\\cache, nuphar_target:llvm -mcpu=core-avx2", info).IsOK());
+  EXPECT_EQ(info.cache_path, "C:\\cache");
+  EXPECT_EQ(info.target, "llvm -mcpu=core-avx2");
+
+  EXPECT_TRUE(ParseNupharSettings("", info).IsOK());
+  EXPECT_FALSE(ParseNupharSettings("nuphar_cache_path", info).IsOK());
+  EXPECT_FALSE(ParseNupharSettings("unknown:1", info).IsOK());
+}
+
+// Y = ReduceSum(Relu(X + X), axes=[1]), which the provider compiles to one function
+TEST(NupharExecutionProviderTest, FusedElementwiseReduction) {
+  Model model("NupharFusedElementwiseReduction");
+  auto& graph = model.MainGraph();
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(8);
+  TypeProto output_type;
+  output_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  output_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& x = graph.GetOrCreateNodeArg("X", &input_type);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &input_type);
+  auto& relu = graph.GetOrCreateNodeArg("relu", &input_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &output_type);
+  graph.AddNode("add", "Add", "", {&x, &x}, {&sum});
+  graph.AddNode("relu", "Relu", "", {&sum}, {&relu});
+  auto& reduce = graph.AddNode("reduce", "ReduceSum", "", {&relu}, {&y});
+  reduce.AddAttribute("axes", std::vector<int64_t>{1});
+  reduce.AddAttribute("keepdims", static_cast<int64_t>(0));
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  std::stringstream model_stream;
+  ASSERT_TRUE(model.ToProto().SerializeToOstream(&model_stream));
+
+  // the second session reuses the module the first compiled
+  for (int i = 0; i < 2; i++) {
+    SessionOptions so;
+    so.session_logid = "NupharExecutionProviderTest.FusedElementwiseReduction";
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.RegisterExecutionProvider(
+                                  std::make_unique<NupharExecutionProvider>(NupharExecutionProviderInfo(0)))
+                    .IsOK());
+    std::stringstream model_copy(model_stream.str());
+    ASSERT_TRUE(session_object.Load(model_copy).IsOK());
+    status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    std::vector<float> values;
+    for (int v = 0; v < 16; v++) {
+      values.push_back(static_cast<float>(v - 4));
+    }
+    MLValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 8}, values,
+                         &input_value);
+    std::vector<MLValue> fetches;
+    status = session_object.Run(RunOptions{}, NameMLValMap{{"X", input_value}}, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const Tensor& result = fetches[0].Get<Tensor>();
+    ASSERT_EQ(result.Shape(), TensorShape({2}));
+    // 2 * (1 + 2 + 3) and 2 * (4 + 5 + ... + 11)
+    EXPECT_FLOAT_EQ(result.Data<float>()[0], 12.f);
+    EXPECT_FLOAT_EQ(result.Data<float>()[1], 120.f);
+  }
+}
+
+TEST(NupharExecutionProviderTest, ModuleCacheFile) {
+  const std::string key = "nuphar_module_cache_test";
+  const std::string file_path = "./" + key + ".ll";
+  std::remove(file_path.c_str());
+
+  int builds = 0;
+  auto build = [&builds, &key]() {
+    ++builds;
+    auto n = tvm::var("n");
+    auto a = tvm::placeholder({n}, tvm::Float(32), "A");
+    auto b = tvm::compute(a->shape, [&a](tvm::Expr i) { return a[i] + 1.0f; }, "B");
+    auto config = tvm::build_config();
+    std::unordered_map<tvm::Tensor, tvm::Buffer> binds;
+    auto lowered = tvm::lower(tvm::create_schedule({b->op}), {a, b}, key, binds, config);
+    return tvm::build(lowered, tvm::Target::create("llvm"), tvm::Target(), config);
+  };
+
+  auto module = nuphar::NupharModuleCache::Instance().GetModule(key, ".", build);
+  EXPECT_EQ(builds, 1);
+  EXPECT_TRUE(module.GetFunction(key) != nullptr);
+  EXPECT_TRUE(std::ifstream(file_path).good());
+
+  // kept in memory by the first call
+  nuphar::NupharModuleCache::Instance().GetModule(key, ".", build);
+  EXPECT_EQ(builds, 1);
+
+  // loaded from the file by another process
+  auto loaded = tvm::runtime::Module::LoadFromFile(file_path, "ll");
+  EXPECT_TRUE(loaded.GetFunction(key) != nullptr);
+  std::remove(file_path.c_str());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
+
+#endif  // USE_NUPHAR
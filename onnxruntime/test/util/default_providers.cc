@@ -12,6 +12,7 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(in
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Mkldnn(int use_arena);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nuphar(int device_id, const char*);
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_TRT(int device_id, const char*);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_BrainSlice(int id, bool f, const char*, const char*, const char*);
 
 namespace test {
@@ -55,12 +56,7 @@ std::unique_ptr<IExecutionProvider> DefaultBrainSliceExecutionProvider() {
 
 std::unique_ptr<IExecutionProvider> DefaultTRTExecutionProvider() {
 #ifdef USE_TRT
-  OrtProviderFactoryInterface** f;
-  ORT_THROW_ON_ERROR(OrtCreateTRTExecutionProviderFactory(0, &f));
-  FACTORY_PTR_HOLDER;
-  OrtProvider* out;
-  ORT_THROW_ON_ERROR((*f)->CreateProvider(f, &out));
-  return std::unique_ptr<IExecutionProvider>((IExecutionProvider*)out);
+  return CreateExecutionProviderFactory_TRT(0, "")->CreateProvider();
 #else
   return nullptr;
 #endif